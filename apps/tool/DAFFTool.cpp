@@ -28,16 +28,25 @@
  */
 
 #include <DAFF.h>
+#include <DAFFTransformerIR2DFT.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <vector>
 
 #if defined(WIN32)
 #include <windows.h>
 #else
+#include <dirent.h>
 #include <sys/stat.h>
 #endif
 
@@ -79,10 +88,18 @@ std::string sPathSeparator = "\\";
 // Global variables
 DAFFReader* g_pDAFFReader = NULL;
 
+// Maximum number of directions resolved at once in the batch query mode
+static const int BATCH_BLOCK_SIZE = 1024;
+
 // Forward declaration of mode-dependent main functions
 int main_info(int argc, char* argv[]);
 int main_dump(int argc, char* argv[]);
 int main_query(int argc, char* argv[]);
+int main_convert(int argc, char* argv[]);
+int main_bench(int argc, char* argv[]);
+int main_stats(int argc, char* argv[]);
+int main_optimize(int argc, char* argv[]);
+int main_verify(int argc, char* argv[]);
 
 /* +-----------------------------------------------+
    |                                               |
@@ -159,14 +176,24 @@ void help()
 
 	printf("Modes:   \tinfo \tDisplay information\n");
 	printf("         \tdump \tDump complete contents\n");
-	printf("         \tquery\tQuery single records\n\n");
+	printf("         \tquery\tQuery single records\n");
+	printf("         \tconvert\tConvert into a new DAFF file\n");
+	printf("         \tbench\tMeasure the access performance\n");
+	printf("         \tstats\tAnalyze levels, lengths and duplicates\n");
+	printf("         \toptimize\tRepack for the fastest loading\n");
+	printf("         \tverify\tVerify the embedded checksums of files and directories\n\n");
 
 	printf("Options: \t-h   \tDisplay this information\n");
 	printf("         \t-v   \tDisplay the program version\n\n\n");
 
 	printf("Examples:\t%s info trombone.daff\n", EXECUTABLE_NAME);
 	printf("         \t%s dump hrir.daff\n", EXECUTABLE_NAME);
-	printf("         \t%s query loudspeaker.daff P10 T-84\n\n\n", EXECUTABLE_NAME);
+	printf("         \t%s query loudspeaker.daff P10 T-84\n", EXECUTABLE_NAME);
+	printf("         \t%s convert -b int16 -s 48000 hrir.daff hrir_48k.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s bench hrir.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s stats hrir.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s optimize hrir.daff hrir_optimized.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s verify -j 8 /data/hrtf\n\n\n", EXECUTABLE_NAME);
 
 	printf("Version: \tThis is %s %s\n\n", PROGRAM_NAME, VERSION);
 
@@ -194,14 +221,23 @@ void help_query()
 	printf(" Query mode - Query a single record from a DAFF file\n");
 	printf("%s\n\n", SEPARATOR);
 
-	printf("Syntax:  \t%s query [OPTIONS] DAFFFILENAME DIRECTION\n\n", EXECUTABLE_NAME);
+	printf("Syntax:  \t%s query [OPTIONS] DAFFFILENAME DIRECTION\n", EXECUTABLE_NAME);
+	printf("         \t%s query -b [-c] [-i] [-q] DAFFFILENAME [DIRECTIONFILE]\n\n", EXECUTABLE_NAME);
 
 	printf("Directions:\tA### B###\tData view direction (alpha and beta)\n");
 	printf("           \tP### T###\tObject view direction (azimuth and elevation)\n\n");
 
-	printf("Options: \t-c	     \tPrint data (discards -d, -o, -p, -r)\n");
+	printf("Batch:   \tReads one direction per line from DIRECTIONFILE or stdin (space, comma\n");
+	printf("         \tor semicolon separated, object view without flags, '#' comments) and\n");
+	printf("         \twrites CSV lines (view, angles, record index, out of bounds flag, record\n");
+	printf("         \tangles, data) in blocks of up to %i directions. An empty line flushes.\n\n",
+		   BATCH_BLOCK_SIZE);
+
+	printf("Options: \t-b, --batch\tBatch mode, load once and query many directions\n");
+	printf("         \t-c	     \tPrint data (discards -d, -o, -p, -r)\n");
 	printf("         \t-d DIR    \tOutput target directory\n");
 	printf("         \t-f        \tForce mode, overwrite without prompt\n");
+	printf("         \t-i        \tBatch mode: print interpolated instead of nearest data\n");
 	printf("         \t-o        \tOutput file name (discards -p, -r)\n");
 	printf("         \t-p PREFIX \tSet output prefix\n");
 	printf("         \t-q        \tQuiet output (discards -v)\n");
@@ -213,6 +249,7 @@ void help_query()
 	printf("         \t%s query -rf -d HRIRNearFront -p NF hrir_near.daff A0 B90\n", EXECUTABLE_NAME);
 	printf("         \t%s query -qf -o HRIRNearFront.wav hrir_near.daff P0 T0\n", EXECUTABLE_NAME);
 	printf("         \t%s query -qc trombone.daff P0 T0\n", EXECUTABLE_NAME);
+	printf("         \t%s query --batch -c hrir.daff directions.csv > records.csv\n", EXECUTABLE_NAME);
 }
 
 void help_dump()
@@ -223,9 +260,11 @@ void help_dump()
 
 	printf("Syntax:  \t%s dump [OPTIONS] DAFFFILENAME\n\n", EXECUTABLE_NAME);
 
-	printf("Options: \t-c        \tUse object view angles for filenames\n");
+	printf("Options: \t-b FORMAT \tBulk export of all records into a single file (wav, npy)\n");
+	printf("         \t-c        \tUse object view angles for filenames\n");
 	printf("         \t-d DIR	 \tSet output target directory\n");
 	printf("         \t-f        \tForce mode, overwrite without prompt\n");
+	printf("         \t-j THREADS\tNumber of export worker threads (default: all cores)\n");
 	printf("         \t-p PREFIX \tSet output prefix\n");
 	printf("         \t-q        \tQuiet output (discards -v)\n");
 	printf("         \t-r        \tReverse angle order of output filenames\n");
@@ -234,6 +273,124 @@ void help_dump()
 
 	printf("Examples:\t%s dump -d TromboneDirectivity -p TRBN -v trombone.daff\n", EXECUTABLE_NAME);
 	printf("         \t%s dump -cqrw hrir_near.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s dump -j 8 -qf hrir_dense.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s dump -b npy -d HRIR hrir_dense.daff\n", EXECUTABLE_NAME);
+}
+
+void help_convert()
+{
+	printf("\n%s\n", SEPARATOR);
+	printf(" Convert mode - Convert a DAFF file into a new DAFF file\n");
+	printf("%s\n\n", SEPARATOR);
+
+	printf("Syntax:  \t%s convert [OPTIONS] DAFFFILENAME OUTPUTFILENAME\n\n", EXECUTABLE_NAME);
+
+	printf("Options: \t-a BYTES  \tAlignment of the record data (16, 32, 64)\n");
+	printf("         \t-b QUANT  \tOutput quantization (int16, int24, int16_bfp, float16, bfloat16, float32)\n");
+	printf("         \t-c        \tCompress the record data losslessly\n");
+	printf("         \t-d        \tTransform impulse responses into DFT spectra\n");
+	printf("         \t-f        \tForce mode, overwrite without prompt\n");
+	printf("         \t-j THREADS\tNumber of worker threads (default: all cores)\n");
+	printf("         \t-k        \tEmbed checksums of the file blocks (see verify mode)\n");
+	printf("         \t-l LENGTH \tTrim impulse responses to a maximum length\n");
+	printf("         \t-q        \tQuiet output (discards -v)\n");
+	printf("         \t-s RATE   \tResample impulse responses [Hz]\n");
+	printf("         \t-u        \tStore identical record channels only once\n");
+	printf("         \t-v        \tVerbose output\n");
+	printf("         \t-y SYM    \tStore a symmetric grid (none, axial, mirror)\n");
+	printf("         \t-z DB     \tOmit leading and trailing values below a threshold [dB]\n\n");
+
+	printf("Examples:\t%s convert -b int16 hrir.daff hrir_int16.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s convert -s 48000 -l 256 -z -90 hrir.daff hrir_48k.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s convert -df trombone_ir.daff trombone_dft.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s convert -c -b int24 hrir.daff hrir_compressed.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s convert -a 64 hrir.daff hrir_aligned.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s convert -cu speaker.daff speaker_small.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s convert -y axial loudspeaker.daff loudspeaker_axial.daff\n", EXECUTABLE_NAME);
+}
+
+void help_bench()
+{
+	printf("\n%s\n", SEPARATOR);
+	printf(" Bench mode - Measure the access performance of a DAFF file\n");
+	printf("%s\n\n", SEPARATOR);
+
+	printf("Syntax:  \t%s bench [OPTIONS] DAFFFILENAME\n\n", EXECUTABLE_NAME);
+
+	printf("Measures:\tOpen time, nearest neighbour lookups (both views), record fetch\n");
+	printf("         \tper channel, interpolation and IR2DFT transformation\n\n");
+
+	printf("Options: \t-t SECONDS\tMinimum measurement time per benchmark (default: 0.5)\n\n");
+
+	printf("Examples:\t%s bench hrir.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s bench -t 2 loudspeaker.daff\n", EXECUTABLE_NAME);
+}
+
+void help_stats()
+{
+	printf("\n%s\n", SEPARATOR);
+	printf(" Stats mode - Analyze the record data of a DAFF file\n");
+	printf("%s\n\n", SEPARATOR);
+
+	printf("Syntax:  \t%s stats [OPTIONS] DAFFFILENAME\n\n", EXECUTABLE_NAME);
+
+	printf("Reports: \tPeak, RMS, energy and onset distributions per channel (IR, MS),\n");
+	printf("         \teffective length histogram (IR) and identical payloads\n\n");
+
+	printf("Options: \t-j THREADS\tNumber of scan worker threads (default: all cores)\n\n");
+
+	printf("Examples:\t%s stats hrir.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s stats -j 4 loudspeaker.daff\n", EXECUTABLE_NAME);
+}
+
+void help_optimize()
+{
+	printf("\n%s\n", SEPARATOR);
+	printf(" Optimize mode - Repack a DAFF file for the fastest loading and queries\n");
+	printf("%s\n\n", SEPARATOR);
+
+	printf("Syntax:  \t%s optimize [OPTIONS] DAFFFILENAME OUTPUTFILENAME\n\n", EXECUTABLE_NAME);
+
+	printf("Applies: \tTrimming to the effective bounds, deduplication of identical\n");
+	printf("         \trecord channels, aligned record data, embedded record statistics,\n");
+	printf("         \tan embedded nearest neighbour index and record data stored along\n");
+	printf("         \ta Hilbert curve over the directions\n\n");
+
+	printf("Options: \t-a BYTES  \tAlignment of the record data (16, 32, 64, default: 32)\n");
+	printf("         \t-b QUANT  \tOutput quantization (int16, int24, int16_bfp, float16, bfloat16, float32)\n");
+	printf("         \t-c        \tCompress the record data losslessly (smaller, but slower to open)\n");
+	printf("         \t-f        \tForce mode, overwrite without prompt\n");
+	printf("         \t-j THREADS\tNumber of worker threads (default: all cores)\n");
+	printf("         \t-k        \tEmbed checksums of the file blocks (see verify mode)\n");
+	printf("         \t-o ORDER  \tRecord order of the data (index, morton, hilbert, default: hilbert)\n");
+	printf("         \t-q        \tQuiet output (discards -v)\n");
+	printf("         \t-v        \tVerbose output\n");
+	printf("         \t-z DB     \tOmit leading and trailing values below a threshold [dB]\n");
+	printf("         \t          \t(default: exact zeros only)\n\n");
+
+	printf("Examples:\t%s optimize hrir.daff hrir_optimized.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s optimize -b int16 -z -100 hrir.daff hrir_small.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s optimize -c -a 16 loudspeaker.daff loudspeaker_archive.daff\n", EXECUTABLE_NAME);
+}
+
+void help_verify()
+{
+	printf("\n%s\n", SEPARATOR);
+	printf(" Verify mode - Verify the integrity of DAFF files\n");
+	printf("%s\n\n", SEPARATOR);
+
+	printf("Syntax:  \t%s verify [OPTIONS] PATH [PATH ...]\n\n", EXECUTABLE_NAME);
+
+	printf("Checks:  \tOpens every file (all *.daff files of directories, recursively) and\n");
+	printf("         \tcompares the embedded checksums of all file blocks. Files without\n");
+	printf("         \tchecksums are only checked for consistency. Exits with 1 on failures.\n\n");
+
+	printf("Options: \t-j THREADS\tNumber of worker threads (default: all cores)\n");
+	printf("         \t-q        \tQuiet output, exit code only (discards -v)\n");
+	printf("         \t-v        \tVerbose output, report every file\n\n");
+
+	printf("Examples:\t%s verify hrir.daff\n", EXECUTABLE_NAME);
+	printf("         \t%s verify -j 8 -v /data/hrtf /data/directivities\n", EXECUTABLE_NAME);
 }
 
 // Closes all open or allocated resources (memory, files, etc.)
@@ -293,6 +450,16 @@ int main(int argc, char* argv[])
 		return main_dump(argc, argv);
 	else if (sMode == "QUERY")
 		return main_query(argc, argv);
+	else if (sMode == "CONVERT")
+		return main_convert(argc, argv);
+	else if (sMode == "BENCH")
+		return main_bench(argc, argv);
+	else if (sMode == "STATS")
+		return main_stats(argc, argv);
+	else if (sMode == "OPTIMIZE")
+		return main_optimize(argc, argv);
+	else if (sMode == "VERIFY")
+		return main_verify(argc, argv);
 	else
 		syntax();
 
@@ -355,7 +522,18 @@ int main_info(int argc, char* argv[])
 
 	printf("File format version: %d\n", iVersion, 3);
 	printf("Content type:        %s\n", DAFFUtils::StrContentType(pProps->getContentType()).c_str());
-	printf("Quantization:        %s\n\n", DAFFUtils::StrQuantizationType(pProps->getQuantization()).c_str());
+	printf("Quantization:        %s\n", DAFFUtils::StrQuantizationType(pProps->getQuantization()).c_str());
+	printf("Compressed data:     %s\n", (g_pDAFFReader->isCompressed() ? "yes" : "no"));
+	printf("Data alignment:      %d Bytes\n", g_pDAFFReader->getDataAlignment());
+	printf("Shared channels:     %d\n", g_pDAFFReader->getNumSharedRecordChannels());
+	printf("Record order:        %s\n", DAFFUtils::StrRecordOrder(g_pDAFFReader->getRecordOrder()).c_str());
+	DAFFMemoryFootprint oFootprint;
+	g_pDAFFReader->getMemoryFootprint(oFootprint);
+	printf("Memory footprint:    %llu Bytes\n", (unsigned long long)oFootprint.ui64Total);
+	printf("Symmetry:            %s", DAFFUtils::StrSymmetry(g_pDAFFReader->getSymmetry()).c_str());
+	if (g_pDAFFReader->getSymmetry() != DAFF_SYMMETRY_NONE)
+		printf(" (%d stored records)", g_pDAFFReader->getNumStoredRecords());
+	printf("\n\n");
 	printf("Number of channels:  %i\n", pProps->getNumberOfChannels());
 	printf("Number of records:   %i\n\n", pProps->getNumberOfRecords());
 	printf("Alpha points:        %i\n", pProps->getAlphaPoints());
@@ -366,7 +544,8 @@ int main_info(int argc, char* argv[])
 	printf("Beta range:          [%s\xF8, %s\xF8]\n",
 		   DAFFUtils::Float2StrNice(pProps->getBetaStart(), 3, false).c_str(),
 		   DAFFUtils::Float2StrNice(pProps->getBetaEnd(), 3, false).c_str());
-	printf("Full sphere:         %s\n\n", pProps->coversFullSphere() ? "yes" : "no");
+	printf("Full sphere:         %s\n", pProps->coversFullSphere() ? "yes" : "no");
+	printf("Regular grid:        %s\n\n", pProps->isRegularGrid() ? "yes" : "no");
 	printf("Orientation:         %s\n\n", o.toString().c_str());
 
 	DAFFContentIR* pContentIR;
@@ -433,11 +612,21 @@ int main_info(int argc, char* argv[])
 int main_dump(int argc, char* argv[])
 {
 	bool bForce = false, bObjectView = false, bQuiet = false, bReverseAngles = false, bVerbose = false;
-	std::string sFilePrefix, sTargetDirectory;
+	int iNumThreads = 0;
+	std::string sBulkFormat, sFilePrefix, sTargetDirectory;
 
 	int c;
-	while ((c = getopt(argc, argv, "cd:fhp:qrv")) != -1)
+	while ((c = getopt(argc, argv, "b:cd:fhj:p:qrv")) != -1)
 		switch (c) {
+		case 'b':
+			sBulkFormat = optarg;
+			std::transform(sBulkFormat.begin(), sBulkFormat.end(), sBulkFormat.begin(), ::tolower);
+			if ((sBulkFormat != "wav") && (sBulkFormat != "npy")) {
+				fprintf(stderr, "Error: Unknown bulk export format \"%s\"\n", optarg);
+				return 255;
+			}
+			break;
+
 		case 'c':
 			bObjectView = true;
 			break;
@@ -454,6 +643,10 @@ int main_dump(int argc, char* argv[])
 			help_dump();
 			return 0;
 
+		case 'j':
+			iNumThreads = atoi(optarg);
+			break;
+
 		case 'p':
 			sFilePrefix = optarg;
 			break;
@@ -546,6 +739,7 @@ int main_dump(int argc, char* argv[])
 
 	// OUTFILE
 	std::string sOutFileName;
+	std::vector<std::string> vsOutFileNames;
 	stringstream ssOutFileName;
 
 	DAFFContentIR* pContentIR;
@@ -556,6 +750,47 @@ int main_dump(int argc, char* argv[])
 
 	int iResult = 0;
 
+	// Bulk export into a single file (plus a coordinates file for NumPy)
+	if (!sBulkFormat.empty()) {
+		if ((sBulkFormat == "wav") && (g_pDAFFReader->getContentType() != DAFF_IMPULSE_RESPONSE)) {
+			fprintf(stderr, "Error: Bulk export into an audiofile requires impulse responses\n");
+			tidyup();
+			return 255;
+		}
+
+		ssOutFileName.str("");
+		ssOutFileName << sTargetDirectory << sPathSeparator;
+		if (sFilePrefix.length() > 0)
+			ssOutFileName << sFilePrefix;
+		else
+			ssOutFileName << stripFilename(g_pDAFFReader->getFilename());
+
+		std::string sCoordsFileName = ssOutFileName.str() + "_coords.npy";
+		sOutFileName = ssOutFileName.str() + "." + sBulkFormat;
+
+		if (doesPathExist(sOutFileName) && !bForce) {
+			std::string sInput;
+			printf("File \"%s\" already exists, overwrite? [y,N]: ", sOutFileName.c_str());
+			std::cin >> sInput;
+			std::transform(sInput.begin(), sInput.end(), sInput.begin(), ::toupper);
+			if (sInput.compare("Y") != 0) {
+				printf("Leaving ...\n");
+				tidyup();
+				return 0;
+			}
+		}
+
+		if (sBulkFormat == "wav")
+			iResult = exportBulkWAV(dynamic_cast<DAFFContentIR*>(g_pDAFFReader->getContent()), sOutFileName,
+									iNumThreads, bQuiet, bVerbose);
+		else
+			iResult = exportBulkNPY(g_pDAFFReader->getContent(), sOutFileName, sCoordsFileName, iView, iNumThreads,
+									bQuiet, bVerbose);
+
+		tidyup();
+		return iResult;
+	}
+
 	switch (g_pDAFFReader->getContentType()) {
 		/* ************************************** IMPULSE RESPONSE ************************************** */
 
@@ -576,6 +811,8 @@ int main_dump(int argc, char* argv[])
 			}
 		}
 
+		// Output filenames of all records (prompting for existing files), then the parallel export
+		vsOutFileNames.clear();
 		for (iRecordIndex = 0; iRecordIndex < g_pDAFFReader->getProperties()->getNumberOfRecords(); iRecordIndex++) {
 			// Derive angles
 			pContentIR->getRecordCoords(iRecordIndex, iView, fAngle1, fAngle2);
@@ -611,11 +848,13 @@ int main_dump(int argc, char* argv[])
 				if (sInput.compare("A") == 0)
 					bForce = true;
 			}
-			iResult = exportIR(pContentIR, iRecordIndex, sOutFileName, iView, bQuiet, bVerbose);
-			if (iResult != 0) {
-				tidyup();
-				return iResult;
-			}
+			vsOutFileNames.push_back(sOutFileName);
+		}
+
+		iResult = exportIRFiles(pContentIR, vsOutFileNames, iView, iNumThreads, bQuiet, bVerbose);
+		if (iResult != 0) {
+			tidyup();
+			return iResult;
 		}
 
 		break;
@@ -799,14 +1038,192 @@ int main_dump(int argc, char* argv[])
    |                                               |
    +-----------------------------------------------+ */
 
+// Parses a direction of the batch query mode ("P10 T-84", "A0,B90" or "10;-84" for the object view)
+static bool parseBatchDirection(const std::string& sLine, int& iView, float& fAngle1, float& fAngle2)
+{
+	std::string s = sLine;
+	std::replace(s.begin(), s.end(), ',', ' ');
+	std::replace(s.begin(), s.end(), ';', ' ');
+	std::replace(s.begin(), s.end(), '\t', ' ');
+
+	std::istringstream ss(s);
+	std::string sToken[2], sRest;
+	if (!(ss >> sToken[0] >> sToken[1]) || (ss >> sRest))
+		return false;
+
+	char cFlag[2] = {0, 0};
+	float fAngle[2];
+	for (int i = 0; i < 2; i++) {
+		const char* pcNumber = sToken[i].c_str();
+		if (isalpha((unsigned char)*pcNumber))
+			cFlag[i] = (char)toupper((unsigned char)*pcNumber++);
+
+		char* pcEnd;
+		fAngle[i] = (float)strtod(pcNumber, &pcEnd);
+		if ((pcEnd == pcNumber) || (*pcEnd != '\0'))
+			return false;
+	}
+
+	if (((cFlag[0] == 'P') && (cFlag[1] == 'T')) || ((cFlag[0] == 0) && (cFlag[1] == 0)))
+		iView = DAFF_OBJECT_VIEW;
+	else if ((cFlag[0] == 'A') && (cFlag[1] == 'B'))
+		iView = DAFF_DATA_VIEW;
+	else
+		return false;
+
+	fAngle1 = fAngle[0];
+	fAngle2 = fAngle[1];
+	return true;
+}
+
+// Resolves and prints a block of directions of the batch query mode (consecutive runs of the same view at once)
+static int resolveBatchBlock(const DAFFContent* pContent, const DAFFInterpolator* pInterpolator, bool bData,
+							 const std::vector<int>& viViews, const std::vector<float>& vfAngles1,
+							 const std::vector<float>& vfAngles2)
+{
+	size_t n = viViews.size();
+	std::vector<int> viRecordIndices(n);
+	bool* pbOutOfBounds = new bool[std::max(n, (size_t)1)];
+
+	for (size_t i = 0; i < n;) {
+		size_t j = i + 1;
+		while ((j < n) && (viViews[j] == viViews[i]))
+			j++;
+		pContent->getNearestNeighbours(viViews[i], &vfAngles1[i], &vfAngles2[i], &viRecordIndices[i],
+									   pbOutOfBounds + i, j - i);
+		i = j;
+	}
+
+	int iChannels = pContent->getProperties()->getNumberOfChannels();
+	int iLength = pInterpolator ? pInterpolator->getDataLength() : getRecordChannelLength(pContent);
+	std::vector<float> vfData(std::max(iLength, 1));
+
+	int iError = DAFF_NO_ERROR;
+	for (size_t i = 0; (i < n) && (iError == DAFF_NO_ERROR); i++) {
+		float fRecordAngle1, fRecordAngle2;
+		pContent->getRecordCoords(viRecordIndices[i], viViews[i], fRecordAngle1, fRecordAngle2);
+		printf("%c,%g,%g,%i,%i,%g,%g", (viViews[i] == DAFF_OBJECT_VIEW ? 'P' : 'A'), vfAngles1[i], vfAngles2[i],
+			   viRecordIndices[i], (pbOutOfBounds[i] ? 1 : 0), fRecordAngle1, fRecordAngle2);
+
+		for (int iChannel = 0; bData && (iChannel < iChannels) && (iError == DAFF_NO_ERROR); iChannel++) {
+			if (pInterpolator)
+				iError = pInterpolator->interpolate(viViews[i], vfAngles1[i], vfAngles2[i], iChannel, &vfData[0]);
+			else
+				iError = fetchRecordChannel(pContent, viRecordIndices[i], iChannel, &vfData[0]);
+
+			for (int k = 0; (k < iLength) && (iError == DAFF_NO_ERROR); k++)
+				printf(",%.9g", vfData[k]);
+		}
+		printf("\n");
+	}
+
+	delete[] pbOutOfBounds;
+	fflush(stdout);
+
+	return iError;
+}
+
+// Batch query mode: resolves directions read line by line from a file or stdin
+static int queryBatch(const std::string& sInputFile, const std::string& sDirectionFile, bool bData, bool bInterpolate,
+					  bool bQuiet)
+{
+	g_pDAFFReader = DAFFReader::create();
+	int iError = g_pDAFFReader->openFile(sInputFile);
+	if (iError != 0) {
+		if (iError == DAFF_FILE_NOT_FOUND)
+			fprintf(stderr, "Error: %s (\"%s\")\n", DAFFUtils::StrError(iError).c_str(), sInputFile.c_str());
+		else
+			fprintf(stderr, "Error: %s\n", DAFFUtils::StrError(iError).c_str());
+		tidyup();
+		return iError;
+	}
+
+	const DAFFContent* pContent = g_pDAFFReader->getContent();
+	DAFFInterpolator oInterpolator(pContent);
+	if (bInterpolate && (oInterpolator.getDataLength() == 0)) {
+		fprintf(stderr, "Error: Interpolation requires impulse responses, magnitude or DFT spectra\n");
+		tidyup();
+		return 255;
+	}
+
+	std::ifstream ifsDirections;
+	if (!sDirectionFile.empty() && (sDirectionFile != "-")) {
+		ifsDirections.open(sDirectionFile.c_str());
+		if (!ifsDirections) {
+			fprintf(stderr, "Error: Could not open file \"%s\" for reading\n", sDirectionFile.c_str());
+			tidyup();
+			return 255;
+		}
+	}
+	std::istream& isDirections = (ifsDirections.is_open() ? (std::istream&)ifsDirections : std::cin);
+
+	if (!bQuiet)
+		printf("view,angle1,angle2,record,out_of_bounds,record_angle1,record_angle2%s\n", (bData ? ",data" : ""));
+
+	// Blocks end after BATCH_BLOCK_SIZE directions, at an empty line and at the end of the input
+	std::vector<int> viViews;
+	std::vector<float> vfAngles1, vfAngles2;
+	std::string sLine;
+	int iLine = 0, iResult = 0;
+	bool bEnd = false;
+	while (!bEnd) {
+		bEnd = !std::getline(isDirections, sLine);
+		if (!bEnd) {
+			iLine++;
+			if (!sLine.empty() && (sLine[sLine.size() - 1] == '\r'))
+				sLine.erase(sLine.size() - 1);
+
+			int iView;
+			float fAngle1, fAngle2;
+			if (!sLine.empty() && (sLine[0] != '#')) {
+				if (parseBatchDirection(sLine, iView, fAngle1, fAngle2)) {
+					viViews.push_back(iView);
+					vfAngles1.push_back(fAngle1);
+					vfAngles2.push_back(fAngle2);
+				} else if (iLine > 1) {
+					// The first line may be a CSV header
+					fprintf(stderr, "Error: Invalid direction \"%s\" in line %i\n", sLine.c_str(), iLine);
+					iResult = 255;
+				}
+			}
+
+			if (!sLine.empty() && ((int)viViews.size() < BATCH_BLOCK_SIZE))
+				continue;
+		}
+
+		iError = resolveBatchBlock(pContent, bInterpolate ? &oInterpolator : NULL, bData, viViews, vfAngles1,
+								   vfAngles2);
+		if (iError != DAFF_NO_ERROR) {
+			fprintf(stderr, "Error: %s\n", DAFFUtils::StrError(iError).c_str());
+			tidyup();
+			return iError;
+		}
+
+		viViews.clear();
+		vfAngles1.clear();
+		vfAngles2.clear();
+	}
+
+	tidyup();
+
+	return iResult;
+}
+
 int main_query(int argc, char* argv[])
 {
-	bool bConsoleOutput = false, bForce = false, bReverseAngles = false, bQuiet = false, bVerbose = false;
+	bool bBatch = false, bConsoleOutput = false, bForce = false, bInterpolate = false, bReverseAngles = false,
+		 bQuiet = false, bVerbose = false;
 	std::string sFilePrefix, sFilename, sTargetDirectory;
 
+	static const struct option pLongOptions[] = {{"batch", no_argument, NULL, 'b'}, {NULL, 0, NULL, 0}};
+
 	int c;
-	while ((c = getopt(argc, argv, "cd:fho:p:qrv")) != -1)
+	while ((c = getopt_long(argc, argv, "bcd:fhio:p:qrv", pLongOptions, NULL)) != -1)
 		switch (c) {
+		case 'b':
+			bBatch = true;
+			break;
+
 		case 'c':
 			bConsoleOutput = true;
 			break;
@@ -824,6 +1241,10 @@ int main_query(int argc, char* argv[])
 
 			return 0;
 
+		case 'i':
+			bInterpolate = true;
+			break;
+
 		case 'o':
 			sFilename = optarg;
 			break;
@@ -856,6 +1277,16 @@ int main_query(int argc, char* argv[])
 	// Remaining number of non-option parameters
 	int iArgs = argc - optind - 1;
 
+	if (bBatch) {
+		if ((iArgs != 1) && (iArgs != 2)) {
+			syntax();
+			return 255;
+		}
+
+		return queryBatch(argv[optind + 1], (iArgs == 2 ? argv[optind + 2] : ""), bConsoleOutput, bInterpolate,
+						  bQuiet);
+	}
+
 	if (iArgs != 3) {
 		syntax();
 
@@ -1259,3 +1690,1109 @@ int main_query(int argc, char* argv[])
 
 	return 0;
 }
+
+/* +-----------------------------------------------+
+   |                                               |
+   |    Convert mode                               |
+   |                                               |
+   +-----------------------------------------------+ */
+
+int main_convert(int argc, char* argv[])
+{
+	bool bDFT = false, bForce = false, bQuiet = false, bVerbose = false;
+	DAFFConverter oConverter;
+	std::string sQuantization, sSymmetry;
+
+	int c;
+	while ((c = getopt(argc, argv, "a:b:cdfhj:kl:qs:uvy:z:")) != -1)
+		switch (c) {
+		case 'a':
+			oConverter.setDataAlignment(atoi(optarg));
+			break;
+
+		case 'b':
+			sQuantization = optarg;
+			std::transform(sQuantization.begin(), sQuantization.end(), sQuantization.begin(), ::toupper);
+			if (sQuantization == "INT16")
+				oConverter.setQuantization(DAFF_INT16);
+			else if (sQuantization == "INT24")
+				oConverter.setQuantization(DAFF_INT24);
+			else if (sQuantization == "FLOAT16")
+				oConverter.setQuantization(DAFF_FLOAT16);
+			else if (sQuantization == "BFLOAT16")
+				oConverter.setQuantization(DAFF_BFLOAT16);
+			else if (sQuantization == "INT16_BFP")
+				oConverter.setQuantization(DAFF_INT16_BFP);
+			else if (sQuantization == "FLOAT32")
+				oConverter.setQuantization(DAFF_FLOAT32);
+			else {
+				fprintf(stderr, "Error: Unknown quantization \"%s\"\n", optarg);
+				return 255;
+			}
+			break;
+
+		case 'c':
+			oConverter.setCompression(true);
+			break;
+
+		case 'd':
+			bDFT = true;
+			break;
+
+		case 'f':
+			bForce = true;
+			break;
+
+		case 'h':
+			help_convert();
+			return 0;
+
+		case 'j':
+			oConverter.setNumThreads(atoi(optarg));
+			break;
+
+		case 'k':
+			oConverter.setChecksums(true);
+			break;
+
+		case 'l':
+			oConverter.setMaxFilterLength(atoi(optarg));
+			break;
+
+		case 'q':
+			bQuiet = true;
+			break;
+
+		case 's':
+			oConverter.setSamplerate((float)atof(optarg));
+			break;
+
+		case 'u':
+			oConverter.setDeduplication(true);
+			break;
+
+		case 'v':
+			bVerbose = true;
+			break;
+
+		case 'y':
+			sSymmetry = optarg;
+			std::transform(sSymmetry.begin(), sSymmetry.end(), sSymmetry.begin(), ::toupper);
+			if (sSymmetry == "NONE")
+				oConverter.setSymmetry(DAFF_SYMMETRY_NONE);
+			else if (sSymmetry == "AXIAL")
+				oConverter.setSymmetry(DAFF_SYMMETRY_AXIAL);
+			else if (sSymmetry == "MIRROR")
+				oConverter.setSymmetry(DAFF_SYMMETRY_MIRROR);
+			else {
+				fprintf(stderr, "Error: Unknown symmetry \"%s\"\n", optarg);
+				return 255;
+			}
+			break;
+
+		case 'z':
+			oConverter.setZeroThreshold((float)atof(optarg));
+			break;
+
+		case '?':
+			fprintf(stderr, "Error: Unknown option. Use '%s convert -h' for help\n", EXECUTABLE_NAME);
+			return 255;
+
+		default:
+			fprintf(stderr, "Error: Internal error\n");
+			return 255;
+		}
+
+	// Remaining number of non-option parameters
+	int iArgs = argc - optind - 1;
+
+	if (iArgs != 2) {
+		syntax();
+		return 255;
+	}
+
+	string sInputFile = argv[optind + 1];
+	string sOutputFile = argv[optind + 2];
+
+	if (doesPathExist(sOutputFile) && !bForce) {
+		std::string sInput;
+		printf("File \"%s\" already exists, overwrite? [y,N]: ", sOutputFile.c_str());
+		std::cin >> sInput;
+		std::transform(sInput.begin(), sInput.end(), sInput.begin(), ::toupper);
+		if (sInput.compare("Y") != 0)
+			return 0;
+	}
+
+	g_pDAFFReader = DAFFReader::create();
+	int iError = g_pDAFFReader->openFile(sInputFile);
+	if (iError != 0) {
+		if (iError == DAFF_FILE_NOT_FOUND)
+			fprintf(stderr, "Error: %s (\"%s\")\n", DAFFUtils::StrError(iError).c_str(), sInputFile.c_str());
+		else
+			fprintf(stderr, "Error: %s\n", DAFFUtils::StrError(iError).c_str());
+		tidyup();
+		return iError;
+	}
+
+	if (bVerbose && !bQuiet)
+		printf("Converting \"%s\" (%s, %i records) into \"%s\"\n", sInputFile.c_str(),
+			   DAFFUtils::StrContentType(g_pDAFFReader->getContentType()).c_str(),
+			   g_pDAFFReader->getProperties()->getNumberOfRecords(), sOutputFile.c_str());
+
+	// DFT spectra are transformed on first access by the worker threads of the converter
+	DAFFTransformerIR2DFT oTransformer;
+	const DAFFContent* pContent = g_pDAFFReader->getContent();
+	if (bDFT) {
+		if (g_pDAFFReader->getContentType() != DAFF_IMPULSE_RESPONSE) {
+			fprintf(stderr, "Error: DFT transformation requires impulse responses\n");
+			tidyup();
+			return 255;
+		}
+
+		oTransformer.setLazy(true, false);
+		oTransformer.setInputContent(dynamic_cast<const DAFFContentIR*>(pContent));
+		pContent = oTransformer.getOutputContent();
+	}
+
+	iError = oConverter.convert(pContent, sOutputFile, g_pDAFFReader->getMetadata());
+	if (iError != 0) {
+		fprintf(stderr, "Error: %s\n", DAFFUtils::StrError(iError).c_str());
+		tidyup();
+		return iError;
+	}
+
+	if (!bQuiet)
+		printf("Converted \"%s\" into \"%s\"\n", sInputFile.c_str(), sOutputFile.c_str());
+
+	tidyup();
+
+	return 0;
+}
+
+/* +-----------------------------------------------+
+   |                                               |
+   |    Bench mode                                 |
+   |                                               |
+   +-----------------------------------------------+ */
+
+typedef std::chrono::steady_clock BenchClock;
+
+static const int BENCH_NUM_QUERIES = 4096;  // Length of the random query sequences (power of two)
+static const int BENCH_BATCH_SIZE = 64;     // Calls per timed batch
+static const int BENCH_NUM_OPENS = 5;       // Number of timed file openings
+
+static volatile float g_fBenchSink = 0;  // Defeats the elimination of unused results
+
+//! Random queries of the bench mode (deterministic, identical on every run)
+struct BenchQueries {
+	std::vector<float> vfPhi;    //!@ Azimuth angles [degrees]
+	std::vector<float> vfTheta;  //!@ Elevation angles [degrees]
+	std::vector<float> vfAlpha;  //!@ Alpha angles [degrees]
+	std::vector<float> vfBeta;   //!@ Beta angles [degrees]
+	std::vector<int> viRecord;   //!@ Record indices
+
+	BenchQueries(int iNumRecords)
+	{
+		unsigned int uiState = 12345u;
+		for (int i = 0; i < BENCH_NUM_QUERIES; i++) {
+			vfPhi.push_back(360 * benchRandom(uiState) - 180);
+			vfTheta.push_back(180 * benchRandom(uiState) - 90);
+			vfAlpha.push_back(360 * benchRandom(uiState));
+			vfBeta.push_back(180 * benchRandom(uiState));
+			viRecord.push_back(std::min(int(benchRandom(uiState) * iNumRecords), iNumRecords - 1));
+		}
+	}
+
+	// Linear congruential generator, uniform in [0, 1)
+	static float benchRandom(unsigned int& uiState)
+	{
+		uiState = uiState * 1664525u + 1013904223u;
+		return float(uiState >> 8) / float(1 << 24);
+	}
+};
+
+//! Times an operation and returns the mean time per call [ns]
+/**
+ * The operation is a functor with a member 'float operator()(int iCall)'. It is
+ * called in batches until the minimum measurement time has elapsed.
+ */
+template <class TOperation>
+static double benchMeasure(TOperation& oOperation, double dMinSeconds)
+{
+	float fSink = 0;
+
+	// Warm up caches and branch predictors
+	for (int i = 0; i < BENCH_NUM_QUERIES; i++)
+		fSink += oOperation(i);
+
+	long lCalls = 0;
+	BenchClock::time_point t0 = BenchClock::now();
+	BenchClock::time_point t1 = t0;
+	while ((t1 - t0) < std::chrono::duration<double>(dMinSeconds)) {
+		for (int i = 0; i < BENCH_BATCH_SIZE; i++)
+			fSink += oOperation(int(lCalls++));
+		t1 = BenchClock::now();
+	}
+
+	g_fBenchSink = g_fBenchSink + fSink;
+
+	return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / lCalls;
+}
+
+//! Nearest neighbour lookup of random directions
+struct BenchNearestNeighbour {
+	const DAFFContent* pContent;   //!@ Content
+	const BenchQueries* pQueries;  //!@ Queries
+	int iView;                     //!@ View, one of #DAFF_VIEWS
+
+	float operator()(int iCall) const
+	{
+		int i = iCall & (BENCH_NUM_QUERIES - 1);
+		int iRecordIndex;
+		if (iView == DAFF_OBJECT_VIEW)
+			pContent->getNearestNeighbour(iView, pQueries->vfPhi[i], pQueries->vfTheta[i], iRecordIndex);
+		else
+			pContent->getNearestNeighbour(iView, pQueries->vfAlpha[i], pQueries->vfBeta[i], iRecordIndex);
+		return float(iRecordIndex);
+	}
+};
+
+//! Fetch of the data of random records of a channel
+struct BenchFetch {
+	const DAFFContent* pContent;   //!@ Content
+	const BenchQueries* pQueries;  //!@ Queries
+	int iChannel;                  //!@ Channel index
+	float* pfDest;                 //!@ Destination buffer
+
+	float operator()(int iCall) const
+	{
+		fetchRecordChannel(pContent, pQueries->viRecord[iCall & (BENCH_NUM_QUERIES - 1)], iChannel, pfDest);
+		return pfDest[0];
+	}
+};
+
+//! Interpolation of the data of random directions (first channel, object view)
+struct BenchInterpolate {
+	const DAFFInterpolator* pInterpolator;  //!@ Interpolator
+	const BenchQueries* pQueries;           //!@ Queries
+	float* pfDest;                          //!@ Destination buffer
+
+	float operator()(int iCall) const
+	{
+		int i = iCall & (BENCH_NUM_QUERIES - 1);
+		pInterpolator->interpolate(DAFF_OBJECT_VIEW, pQueries->vfPhi[i], pQueries->vfTheta[i], 0, pfDest);
+		return pfDest[0];
+	}
+};
+
+// Prints a report line of a throughput measurement
+static void benchPrint(const char* pszName, double dNsPerCall, size_t nBytesPerCall)
+{
+	printf("%-26s %10.1f ns  %12.0f /s", pszName, dNsPerCall, 1e9 / dNsPerCall);
+	if (nBytesPerCall > 0)
+		printf("  %8.1f MB/s", (double)nBytesPerCall / dNsPerCall * 1e3);
+	printf("\n");
+}
+
+int main_bench(int argc, char* argv[])
+{
+	double dMinSeconds = 0.5;
+
+	int c;
+	while ((c = getopt(argc, argv, "ht:")) != -1) {
+		switch (c) {
+		case 'h':
+			help_bench();
+			return 0;
+
+		case 't':
+			dMinSeconds = atof(optarg);
+			if (dMinSeconds <= 0) {
+				fprintf(stderr, "Error: Invalid measurement time \"%s\"\n", optarg);
+				return 255;
+			}
+			break;
+
+		case '?':
+			fprintf(stderr, "Error: Unknown option. Use '%s bench -h' for help\n", EXECUTABLE_NAME);
+			return 255;
+
+		default:
+			fprintf(stderr, "Error: Internal error\n");
+			return 255;
+		}
+	}
+
+	// Remaining number of non-option parameters
+	int iArgs = argc - optind - 1;
+
+	if (iArgs != 1) {
+		syntax();
+		return 255;
+	}
+
+	string sInputFile = argv[optind + 1];
+
+	// Open time (median of repeated openings, the first one may read from disk)
+	std::vector<double> vdOpenSeconds;
+	for (int i = 0; i < BENCH_NUM_OPENS; i++) {
+		tidyup();
+		g_pDAFFReader = DAFFReader::create();
+
+		BenchClock::time_point t0 = BenchClock::now();
+		int iError = g_pDAFFReader->openFile(sInputFile);
+		BenchClock::time_point t1 = BenchClock::now();
+
+		if (iError != 0) {
+			if (iError == DAFF_FILE_NOT_FOUND)
+				fprintf(stderr, "Error: %s (\"%s\")\n", DAFFUtils::StrError(iError).c_str(), sInputFile.c_str());
+			else
+				fprintf(stderr, "Error: %s\n", DAFFUtils::StrError(iError).c_str());
+			tidyup();
+			g_pDAFFReader = NULL;
+			return iError;
+		}
+
+		vdOpenSeconds.push_back(std::chrono::duration<double>(t1 - t0).count());
+	}
+	std::sort(vdOpenSeconds.begin(), vdOpenSeconds.end());
+
+	const DAFFContent* pContent = g_pDAFFReader->getContent();
+	const DAFFProperties* pProps = g_pDAFFReader->getProperties();
+	int iNumChannels = pProps->getNumberOfChannels();
+	BenchQueries oQueries(pProps->getNumberOfRecords());
+
+	printf("\n--= Benchmark =--\n\n");
+	printf("File:                %s\n", sInputFile.c_str());
+	printf("Content type:        %s\n", DAFFUtils::StrContentType(pProps->getContentType()).c_str());
+	printf("Quantization:        %s\n", DAFFUtils::StrQuantizationType(pProps->getQuantization()).c_str());
+	printf("Records:             %i (%i channels)\n\n", pProps->getNumberOfRecords(), iNumChannels);
+
+	printf("%-26s %10.3f ms  (first %.3f ms, median of %i)\n", "Open", vdOpenSeconds[BENCH_NUM_OPENS / 2] * 1e3,
+		   vdOpenSeconds.front() * 1e3, BENCH_NUM_OPENS);
+
+	BenchNearestNeighbour oNearestNeighbour = {pContent, &oQueries, DAFF_OBJECT_VIEW};
+	benchPrint("Nearest neighbour (object)", benchMeasure(oNearestNeighbour, dMinSeconds), 0);
+	oNearestNeighbour.iView = DAFF_DATA_VIEW;
+	benchPrint("Nearest neighbour (data)", benchMeasure(oNearestNeighbour, dMinSeconds), 0);
+
+	int iLength = getRecordChannelLength(pContent);
+	std::vector<float> vfDest(std::max(iLength, 1));
+	for (int iChannel = 0; (iLength > 0) && (iChannel < iNumChannels); iChannel++) {
+		BenchFetch oFetch = {pContent, &oQueries, iChannel, &vfDest[0]};
+		char szName[48];
+		snprintf(szName, sizeof(szName), "Record fetch (channel %i)", iChannel);
+		benchPrint(szName, benchMeasure(oFetch, dMinSeconds), iLength * sizeof(float));
+	}
+
+	DAFFInterpolator oInterpolator(pContent);
+	float fWeights[4];
+	DAFFQuad qIndices;
+	if ((oInterpolator.getDataLength() > 0) &&
+		(oInterpolator.getWeights(DAFF_OBJECT_VIEW, 0, 0, qIndices, fWeights) == DAFF_NO_ERROR)) {
+		BenchInterpolate oInterpolate = {&oInterpolator, &oQueries, &vfDest[0]};
+		benchPrint("Interpolation", benchMeasure(oInterpolate, dMinSeconds),
+				   oInterpolator.getDataLength() * sizeof(float));
+	} else
+		printf("%-26s %10s\n", "Interpolation", "n/a");
+
+	// Complete transformation of all records, repeated until the minimum time has elapsed
+	if (pProps->getContentType() == DAFF_IMPULSE_RESPONSE) {
+		DAFFTransformerIR2DFT oTransformer;
+		oTransformer.setInputContent(dynamic_cast<const DAFFContentIR*>(pContent), false);
+
+		int iRuns = 0;
+		BenchClock::time_point t0 = BenchClock::now();
+		BenchClock::time_point t1 = t0;
+		do {
+			oTransformer.transform();
+			iRuns++;
+			t1 = BenchClock::now();
+		} while ((t1 - t0) < std::chrono::duration<double>(dMinSeconds));
+
+		double dSeconds = std::chrono::duration<double>(t1 - t0).count() / iRuns;
+		printf("%-26s %10.3f ms  (%.1f us per record)\n", "IR2DFT transform", dSeconds * 1e3,
+			   dSeconds * 1e6 / pProps->getNumberOfRecords());
+	} else
+		printf("%-26s %10s\n", "IR2DFT transform", "n/a");
+
+	printf("\n");
+
+	tidyup();
+
+	return 0;
+}
+
+/* +-----------------------------------------------+
+   |                                               |
+   |    Stats mode                                 |
+   |                                               |
+   +-----------------------------------------------+ */
+
+static const int STATS_HISTOGRAM_BINS = 10;  // Number of bins of the effective length histogram
+
+//! Record range of a worker of the stats mode scan
+struct StatsTask {
+	const DAFFContent* pContent;  //!@ Content
+	int iBegin;                   //!@ First record channel (index record * channels + channel)
+	int iEnd;                     //!@ Record channel behind the range
+	uint64_t* pui64Hashes;        //!@ Hashes of the record channel data
+	int* piEffectiveLengths;      //!@ Effective filter lengths (impulse responses only, otherwise NULL)
+	int* piEffectiveEnds;         //!@ Ends of the effective filters (impulse responses only, otherwise NULL)
+	int iResult;                  //!@ Result of the worker
+};
+
+// FNV-1a hash of the bytes of a float array
+static uint64_t statsHash(const float* pfData, int iLength)
+{
+	const unsigned char* p = (const unsigned char*)pfData;
+	uint64_t ui64Hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < iLength * sizeof(float); i++)
+		ui64Hash = (ui64Hash ^ p[i]) * 1099511628211ULL;
+	return ui64Hash;
+}
+
+static void statsWorker(StatsTask* pTask)
+{
+	int iChannels = pTask->pContent->getProperties()->getNumberOfChannels();
+	int iLength = getRecordChannelLength(pTask->pContent);
+	const DAFFContentIR* pContentIR = dynamic_cast<const DAFFContentIR*>(pTask->pContent);
+	std::vector<float> vfData(std::max(iLength, 1));
+
+	pTask->iResult = DAFF_NO_ERROR;
+	for (int i = pTask->iBegin; (i < pTask->iEnd) && (pTask->iResult == DAFF_NO_ERROR); i++) {
+		pTask->iResult = fetchRecordChannel(pTask->pContent, i / iChannels, i % iChannels, &vfData[0]);
+		pTask->pui64Hashes[i] = statsHash(&vfData[0], iLength);
+
+		if (pTask->piEffectiveLengths) {
+			int iOffset, iEffectiveLength;
+			pContentIR->getEffectiveFilterBounds(i / iChannels, i % iChannels, iOffset, iEffectiveLength);
+			pTask->piEffectiveLengths[i] = iEffectiveLength;
+			pTask->piEffectiveEnds[i] = iOffset + iEffectiveLength;
+		}
+	}
+}
+
+// Value of a sorted vector at a fraction of its size (0: minimum, 0.5: median, 1: maximum)
+static float statsQuantile(const std::vector<float>& vfSorted, double dFraction)
+{
+	return vfSorted[(size_t)(dFraction * (vfSorted.size() - 1) + 0.5)];
+}
+
+// Prints minimum, median and maximum of values (power ratios in decibels for bDecibel, zeros are excluded)
+static void statsPrintDistribution(const char* pszName, std::vector<float> vfValues, bool bDecibel, int iPrecision,
+								   const char* pszUnit)
+{
+	size_t nZeros = 0;
+	if (bDecibel) {
+		std::vector<float> vfLevels;
+		for (size_t i = 0; i < vfValues.size(); i++) {
+			if (vfValues[i] > 0)
+				vfLevels.push_back((float)(10 * log10(vfValues[i])));
+			else
+				nZeros++;
+		}
+		vfValues.swap(vfLevels);
+	}
+
+	printf("  %-8s", pszName);
+	if (vfValues.empty()) {
+		printf(" n/a\n");
+		return;
+	}
+
+	std::sort(vfValues.begin(), vfValues.end());
+	printf(" min %9.*f   median %9.*f   max %9.*f %s", iPrecision, statsQuantile(vfValues, 0), iPrecision,
+		   statsQuantile(vfValues, 0.5), iPrecision, statsQuantile(vfValues, 1), pszUnit);
+	if (nZeros > 0)
+		printf("   (%i silent)", (int)nZeros);
+	printf("\n");
+}
+
+int main_stats(int argc, char* argv[])
+{
+	int iNumThreads = 0;
+
+	int c;
+	while ((c = getopt(argc, argv, "hj:")) != -1) {
+		switch (c) {
+		case 'h':
+			help_stats();
+			return 0;
+
+		case 'j':
+			iNumThreads = atoi(optarg);
+			break;
+
+		case '?':
+			fprintf(stderr, "Error: Unknown option. Use '%s stats -h' for help\n", EXECUTABLE_NAME);
+			return 255;
+
+		default:
+			fprintf(stderr, "Error: Internal error\n");
+			return 255;
+		}
+	}
+
+	// Remaining number of non-option parameters
+	int iArgs = argc - optind - 1;
+
+	if (iArgs != 1) {
+		syntax();
+		return 255;
+	}
+
+	string sInputFile = argv[optind + 1];
+
+	g_pDAFFReader = DAFFReader::create();
+	int iError = g_pDAFFReader->openFile(sInputFile);
+	if (iError != 0) {
+		if (iError == DAFF_FILE_NOT_FOUND)
+			fprintf(stderr, "Error: %s (\"%s\")\n", DAFFUtils::StrError(iError).c_str(), sInputFile.c_str());
+		else
+			fprintf(stderr, "Error: %s\n", DAFFUtils::StrError(iError).c_str());
+		tidyup();
+		return iError;
+	}
+
+	const DAFFContent* pContent = g_pDAFFReader->getContent();
+	const DAFFProperties* pProps = g_pDAFFReader->getProperties();
+	int iContentType = pProps->getContentType();
+	int iChannels = pProps->getNumberOfChannels();
+	int iNumRecords = pProps->getNumberOfRecords();
+	int iNumRecordChannels = iNumRecords * iChannels;
+	bool bIR = (iContentType == DAFF_IMPULSE_RESPONSE);
+
+	// Parallel scan of the data of all record channels (payload hashes and effective bounds)
+	std::vector<uint64_t> vui64Hashes(iNumRecordChannels);
+	std::vector<int> viEffectiveLengths(bIR ? iNumRecordChannels : 0);
+	std::vector<int> viEffectiveEnds(bIR ? iNumRecordChannels : 0);
+	if (iNumThreads <= 0)
+		iNumThreads = (int)std::max(std::thread::hardware_concurrency(), 1u);
+	iNumThreads = std::max(std::min(iNumThreads, iNumRecordChannels), 1);
+
+	std::vector<StatsTask> vTasks(iNumThreads);
+	for (int i = 0; i < iNumThreads; i++) {
+		StatsTask& oTask = vTasks[i];
+		oTask.pContent = pContent;
+		oTask.iBegin = (int)((long long)iNumRecordChannels * i / iNumThreads);
+		oTask.iEnd = (int)((long long)iNumRecordChannels * (i + 1) / iNumThreads);
+		oTask.pui64Hashes = &vui64Hashes[0];
+		oTask.piEffectiveLengths = bIR ? &viEffectiveLengths[0] : NULL;
+		oTask.piEffectiveEnds = bIR ? &viEffectiveEnds[0] : NULL;
+		oTask.iResult = DAFF_NO_ERROR;
+	}
+
+	std::vector<std::thread> vThreads;
+	for (int i = 1; i < iNumThreads; i++) {
+		try {
+			vThreads.push_back(std::thread(&statsWorker, &vTasks[i]));
+		} catch (const std::system_error&) {
+			statsWorker(&vTasks[i]);  // No more threads available
+		}
+	}
+	statsWorker(&vTasks[0]);
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	for (int i = 0; i < iNumThreads; i++) {
+		if (vTasks[i].iResult != DAFF_NO_ERROR) {
+			fprintf(stderr, "Error: %s\n", DAFFUtils::StrError(vTasks[i].iResult).c_str());
+			tidyup();
+			return vTasks[i].iResult;
+		}
+	}
+
+	// Identical payloads: record channels whose data equals that of a record channel with a smaller index
+	std::vector<std::pair<uint64_t, int> > vHashIndices(iNumRecordChannels);
+	for (int i = 0; i < iNumRecordChannels; i++)
+		vHashIndices[i] = std::make_pair(vui64Hashes[i], i);
+	std::sort(vHashIndices.begin(), vHashIndices.end());
+
+	int iLength = getRecordChannelLength(pContent);
+	std::vector<float> vfFirst(std::max(iLength, 1)), vfData(std::max(iLength, 1));
+	int iNumDuplicates = 0;
+	for (int i = 0; i < iNumRecordChannels;) {
+		int j = i + 1;
+		while ((j < iNumRecordChannels) && (vHashIndices[j].first == vHashIndices[i].first))
+			j++;
+
+		// Confirm hash matches by comparing the data with the first record channel of the group
+		if (j - i > 1) {
+			int iFirst = vHashIndices[i].second;
+			fetchRecordChannel(pContent, iFirst / iChannels, iFirst % iChannels, &vfFirst[0]);
+			for (int k = i + 1; k < j; k++) {
+				int iIndex = vHashIndices[k].second;
+				fetchRecordChannel(pContent, iIndex / iChannels, iIndex % iChannels, &vfData[0]);
+				if (memcmp(&vfFirst[0], &vfData[0], iLength * sizeof(float)) == 0)
+					iNumDuplicates++;
+			}
+		}
+		i = j;
+	}
+
+	printf("\n--= Statistics =--\n\n");
+	printf("File:                %s\n", sInputFile.c_str());
+	printf("Content type:        %s\n", DAFFUtils::StrContentType(iContentType).c_str());
+	printf("Quantization:        %s\n", DAFFUtils::StrQuantizationType(pProps->getQuantization()).c_str());
+	printf("Records:             %i (%i channels)\n\n", iNumRecords, iChannels);
+
+	// Peak, RMS, energy and onset distributions from the record statistics
+	if (bIR || (iContentType == DAFF_MAGNITUDE_SPECTRUM)) {
+		const DAFFContentIR* pContentIR = dynamic_cast<const DAFFContentIR*>(pContent);
+		const DAFFContentMS* pContentMS = dynamic_cast<const DAFFContentMS*>(pContent);
+		const char* pszOnsetUnit = (bIR ? "samples" : "(frequency index)");
+
+		for (int iChannel = 0; iChannel < iChannels; iChannel++) {
+			std::vector<float> vfPeaks, vfRMS, vfEnergies, vfOnsets;
+			for (int iRecord = 0; iRecord < iNumRecords; iRecord++) {
+				DAFFRecordStatistics oStats;
+				if (bIR)
+					iError = pContentIR->getRecordStatistics(iRecord, iChannel, oStats);
+				else
+					iError = pContentMS->getRecordStatistics(iRecord, iChannel, oStats);
+				if (iError != DAFF_NO_ERROR) {
+					fprintf(stderr, "Error: %s\n", DAFFUtils::StrError(iError).c_str());
+					tidyup();
+					return iError;
+				}
+
+				// Levels as power ratios
+				vfPeaks.push_back(oStats.fPeak * oStats.fPeak);
+				vfRMS.push_back(oStats.fRMS * oStats.fRMS);
+				vfEnergies.push_back(oStats.fEnergy);
+				if (oStats.iOnset >= 0)
+					vfOnsets.push_back((float)oStats.iOnset);
+			}
+
+			std::string sLabel = pProps->getChannelLabel(iChannel);
+			printf("Channel %i%s\n", iChannel + 1, (sLabel.empty() ? "" : (" (" + sLabel + ")").c_str()));
+			statsPrintDistribution("Peak", vfPeaks, true, 2, "dB");
+			statsPrintDistribution("RMS", vfRMS, true, 2, "dB");
+			statsPrintDistribution("Energy", vfEnergies, true, 2, "dB");
+			statsPrintDistribution("Onset", vfOnsets, false, 0, pszOnsetUnit);
+			printf("\n");
+		}
+	} else
+		printf("Record statistics:   n/a (impulse responses and magnitude spectra only)\n\n");
+
+	// Effective length histogram and the length required to keep all effective filters
+	if (bIR) {
+		int iFilterLength = dynamic_cast<const DAFFContentIR*>(pContent)->getFilterLength();
+		int iBinWidth = std::max((iFilterLength + STATS_HISTOGRAM_BINS) / STATS_HISTOGRAM_BINS, 1);  // Lengths 0...N
+		int piCounts[STATS_HISTOGRAM_BINS] = {0};
+		int iMaxCount = 1;
+		for (int i = 0; i < iNumRecordChannels; i++) {
+			int iBin = std::min(viEffectiveLengths[i] / iBinWidth, STATS_HISTOGRAM_BINS - 1);
+			iMaxCount = std::max(iMaxCount, ++piCounts[iBin]);
+		}
+
+		printf("Effective lengths (filter length %i)\n", iFilterLength);
+		for (int iBin = 0; iBin < STATS_HISTOGRAM_BINS; iBin++) {
+			int iBarLength = (int)((long long)piCounts[iBin] * 40 / iMaxCount);
+			if (iBin * iBinWidth > iFilterLength)
+				break;
+			printf("  %6i - %6i  %8i  %5.1f%%  %s\n", iBin * iBinWidth,
+				   std::min((iBin + 1) * iBinWidth - 1, iFilterLength), piCounts[iBin],
+				   100.0 * piCounts[iBin] / iNumRecordChannels, std::string(iBarLength, '#').c_str());
+		}
+		int iMaxEnd = *std::max_element(viEffectiveEnds.begin(), viEffectiveEnds.end());
+		printf("  All effective filters end within the first %i samples (%.1f%% of the filter length)\n\n", iMaxEnd,
+			   100.0 * iMaxEnd / iFilterLength);
+	}
+
+	int iNumShared = g_pDAFFReader->getNumSharedRecordChannels();
+	printf("Duplicates\n");
+	printf("  Identical payloads:  %i of %i record channels (%.1f%%)\n", iNumDuplicates, iNumRecordChannels,
+		   100.0 * iNumDuplicates / iNumRecordChannels);
+	printf("  Stored once:         %i record channels (deduplicated in the file)\n\n", iNumShared);
+
+	tidyup();
+
+	return 0;
+}
+
+/* +-----------------------------------------------+
+   |                                               |
+   |    Optimize mode                              |
+   |                                               |
+   +-----------------------------------------------+ */
+
+//! Returns the size of a file [Bytes] (-1 if not readable)
+static long long optimizeFileSize(const std::string& sFilePath)
+{
+	std::ifstream oFile(sFilePath.c_str(), std::ios::binary | std::ios::ate);
+	return (oFile ? (long long)oFile.tellg() : -1);
+}
+
+//! Opens a file repeatedly and returns the median open time [s] (negative on error, the reader stays open)
+static double optimizeOpenTime(DAFFReader* pReader, const std::string& sFilePath)
+{
+	std::vector<double> vdOpenSeconds;
+	for (int i = 0; i < BENCH_NUM_OPENS; i++) {
+		pReader->closeFile();
+
+		BenchClock::time_point t0 = BenchClock::now();
+		int iError = pReader->openFile(sFilePath);
+		BenchClock::time_point t1 = BenchClock::now();
+		if (iError != 0)
+			return -1;
+
+		vdOpenSeconds.push_back(std::chrono::duration<double>(t1 - t0).count());
+	}
+
+	std::sort(vdOpenSeconds.begin(), vdOpenSeconds.end());
+	return vdOpenSeconds[BENCH_NUM_OPENS / 2];
+}
+
+int main_optimize(int argc, char* argv[])
+{
+	bool bForce = false, bQuiet = false, bVerbose = false;
+	std::string sQuantization, sRecordOrder;
+
+	// Everything that speeds up loading and queries, trimming exact zeros only (lossless)
+	DAFFConverter oConverter;
+	oConverter.setDataAlignment(32);
+	oConverter.setDeduplication(true);
+	oConverter.setStatistics(true);
+	oConverter.setDirectionIndex(true);
+	oConverter.setRecordOrder(DAFF_RECORD_ORDER_HILBERT);
+
+	int c;
+	while ((c = getopt(argc, argv, "a:b:cfhj:ko:qvz:")) != -1)
+		switch (c) {
+		case 'a':
+			oConverter.setDataAlignment(atoi(optarg));
+			break;
+
+		case 'b':
+			sQuantization = optarg;
+			std::transform(sQuantization.begin(), sQuantization.end(), sQuantization.begin(), ::toupper);
+			if (sQuantization == "INT16")
+				oConverter.setQuantization(DAFF_INT16);
+			else if (sQuantization == "INT24")
+				oConverter.setQuantization(DAFF_INT24);
+			else if (sQuantization == "FLOAT16")
+				oConverter.setQuantization(DAFF_FLOAT16);
+			else if (sQuantization == "BFLOAT16")
+				oConverter.setQuantization(DAFF_BFLOAT16);
+			else if (sQuantization == "INT16_BFP")
+				oConverter.setQuantization(DAFF_INT16_BFP);
+			else if (sQuantization == "FLOAT32")
+				oConverter.setQuantization(DAFF_FLOAT32);
+			else {
+				fprintf(stderr, "Error: Unknown quantization \"%s\"\n", optarg);
+				return 255;
+			}
+			break;
+
+		case 'c':
+			oConverter.setCompression(true);
+			break;
+
+		case 'f':
+			bForce = true;
+			break;
+
+		case 'h':
+			help_optimize();
+			return 0;
+
+		case 'j':
+			oConverter.setNumThreads(atoi(optarg));
+			break;
+
+		case 'k':
+			oConverter.setChecksums(true);
+			break;
+
+		case 'o':
+			sRecordOrder = optarg;
+			std::transform(sRecordOrder.begin(), sRecordOrder.end(), sRecordOrder.begin(), ::toupper);
+			if (sRecordOrder == "INDEX")
+				oConverter.setRecordOrder(DAFF_RECORD_ORDER_INDEX);
+			else if (sRecordOrder == "MORTON")
+				oConverter.setRecordOrder(DAFF_RECORD_ORDER_MORTON);
+			else if (sRecordOrder == "HILBERT")
+				oConverter.setRecordOrder(DAFF_RECORD_ORDER_HILBERT);
+			else {
+				fprintf(stderr, "Error: Unknown record order \"%s\"\n", optarg);
+				return 255;
+			}
+			break;
+
+		case 'q':
+			bQuiet = true;
+			break;
+
+		case 'v':
+			bVerbose = true;
+			break;
+
+		case 'z':
+			oConverter.setZeroThreshold((float)atof(optarg));
+			break;
+
+		case '?':
+			fprintf(stderr, "Error: Unknown option. Use '%s optimize -h' for help\n", EXECUTABLE_NAME);
+			return 255;
+
+		default:
+			fprintf(stderr, "Error: Internal error\n");
+			return 255;
+		}
+
+	// Remaining number of non-option parameters
+	int iArgs = argc - optind - 1;
+
+	if (iArgs != 2) {
+		syntax();
+		return 255;
+	}
+
+	string sInputFile = argv[optind + 1];
+	string sOutputFile = argv[optind + 2];
+
+	if (doesPathExist(sOutputFile) && !bForce) {
+		std::string sInput;
+		printf("File \"%s\" already exists, overwrite? [y,N]: ", sOutputFile.c_str());
+		std::cin >> sInput;
+		std::transform(sInput.begin(), sInput.end(), sInput.begin(), ::toupper);
+		if (sInput.compare("Y") != 0)
+			return 0;
+	}
+
+	g_pDAFFReader = DAFFReader::create();
+	double dInputOpenTime = optimizeOpenTime(g_pDAFFReader, sInputFile);
+	if (dInputOpenTime < 0) {
+		int iError = g_pDAFFReader->openFile(sInputFile);
+		if (iError == DAFF_FILE_NOT_FOUND)
+			fprintf(stderr, "Error: %s (\"%s\")\n", DAFFUtils::StrError(iError).c_str(), sInputFile.c_str());
+		else
+			fprintf(stderr, "Error: %s\n", DAFFUtils::StrError(iError).c_str());
+		tidyup();
+		return iError;
+	}
+
+	const DAFFProperties* pProps = g_pDAFFReader->getProperties();
+	int iNumRecordChannels = pProps->getNumberOfRecords() * pProps->getNumberOfChannels();
+	if (bVerbose && !bQuiet)
+		printf("Optimizing \"%s\" (%s, %i records) into \"%s\" (alignment %i bytes%s%s)\n", sInputFile.c_str(),
+			   DAFFUtils::StrContentType(pProps->getContentType()).c_str(), pProps->getNumberOfRecords(),
+			   sOutputFile.c_str(), oConverter.getDataAlignment(), (oConverter.getCompression() ? ", compressed" : ""),
+			   (oConverter.getQuantization() >= 0 ? ", requantized" : ""));
+
+	int iError = oConverter.convert(g_pDAFFReader->getContent(), sOutputFile, g_pDAFFReader->getMetadata());
+	if (iError != 0) {
+		fprintf(stderr, "Error: %s\n", DAFFUtils::StrError(iError).c_str());
+		tidyup();
+		return iError;
+	}
+
+	// The result is opened like by an application
+	DAFFReader* pOutputReader = DAFFReader::create();
+	double dOutputOpenTime = optimizeOpenTime(pOutputReader, sOutputFile);
+	if (dOutputOpenTime < 0) {
+		fprintf(stderr, "Error: The optimized file \"%s\" can not be opened\n", sOutputFile.c_str());
+		delete pOutputReader;
+		tidyup();
+		return 255;
+	}
+
+	if (!bQuiet) {
+		long long llInputSize = optimizeFileSize(sInputFile);
+		long long llOutputSize = optimizeFileSize(sOutputFile);
+		int iNumShared = pOutputReader->getNumSharedRecordChannels();
+
+		printf("Optimized \"%s\" into \"%s\"\n", sInputFile.c_str(), sOutputFile.c_str());
+		printf("  File size:           %lld -> %lld bytes (%.1f%%)\n", llInputSize, llOutputSize,
+			   (llInputSize > 0 ? 100.0 * llOutputSize / llInputSize : 0.0));
+		printf("  Open time:           %.3f -> %.3f ms\n", dInputOpenTime * 1e3, dOutputOpenTime * 1e3);
+		printf("  Shared payloads:     %i of %i record channels\n", iNumShared, iNumRecordChannels);
+		printf("  Data alignment:      %i bytes\n", pOutputReader->getDataAlignment());
+		printf("  Record order:        %s\n", DAFFUtils::StrRecordOrder(pOutputReader->getRecordOrder()).c_str());
+	}
+
+	delete pOutputReader;
+	tidyup();
+
+	return 0;
+}
+
+/* +-----------------------------------------------+
+   |                                               |
+   |    Verify mode                                |
+   |                                               |
+   +-----------------------------------------------+ */
+
+//! Result of the verification of a file
+enum VerifyResults {
+	VERIFY_OK = 0,        //!< All checksums match
+	VERIFY_NO_CHECKSUMS,  //!< Consistent, but without checksums
+	VERIFY_FAILED         //!< Open failed (see the error code)
+};
+
+//! Files verified by a worker thread of the verify mode
+struct VerifyTask {
+	const std::vector<std::string>* pvsFiles;  //!@ All files
+	int iFirst;                                //!@ First file index of the worker
+	int iStride;                               //!@ Distance of the file indices of the worker (number of workers)
+	int* piResults;                            //!@ Results of all files, one of #VerifyResults
+	int* piErrors;                             //!@ Error codes of all files
+};
+
+// Collects a file or all DAFF files of a directory and its subdirectories
+static void verifyCollect(const std::string& sPath, std::vector<std::string>& vsFiles)
+{
+	if (!isDirectory(sPath)) {
+		vsFiles.push_back(sPath);
+		return;
+	}
+
+	std::vector<std::string> vsEntries, vsSubdirectories;
+#if !defined(WIN32)
+	DIR* pDir = opendir(sPath.c_str());
+	if (pDir == NULL)
+		return;
+	struct dirent* pEntry;
+	while ((pEntry = readdir(pDir)) != NULL)
+		vsEntries.push_back(pEntry->d_name);
+	closedir(pDir);
+#else
+	WIN32_FIND_DATAA oFindData;
+	HANDLE hFind = FindFirstFileA((sPath + sPathSeparator + "*").c_str(), &oFindData);
+	if (hFind == INVALID_HANDLE_VALUE)
+		return;
+	do
+		vsEntries.push_back(oFindData.cFileName);
+	while (FindNextFileA(hFind, &oFindData));
+	FindClose(hFind);
+#endif
+
+	// Sorted for a reproducible report
+	std::sort(vsEntries.begin(), vsEntries.end());
+	for (size_t i = 0; i < vsEntries.size(); i++) {
+		const std::string& sName = vsEntries[i];
+		if ((sName == ".") || (sName == ".."))
+			continue;
+
+		std::string sEntryPath = sPath + sPathSeparator + sName;
+		std::string sExtension = (sName.length() > 5 ? sName.substr(sName.length() - 5) : "");
+		std::transform(sExtension.begin(), sExtension.end(), sExtension.begin(), ::tolower);
+		if (isDirectory(sEntryPath))
+			vsSubdirectories.push_back(sEntryPath);
+		else if (sExtension == ".daff")
+			vsFiles.push_back(sEntryPath);
+	}
+
+	for (size_t i = 0; i < vsSubdirectories.size(); i++)
+		verifyCollect(vsSubdirectories[i], vsFiles);
+}
+
+static void verifyWorker(VerifyTask* pTask)
+{
+	DAFFReader* pReader = DAFFReader::create();
+	for (int i = pTask->iFirst; i < (int)pTask->pvsFiles->size(); i += pTask->iStride) {
+		int iError = pReader->openFile((*pTask->pvsFiles)[i], DAFF_OPEN_VERIFY);
+		pTask->piErrors[i] = iError;
+		if (iError != DAFF_NO_ERROR)
+			pTask->piResults[i] = VERIFY_FAILED;
+		else
+			pTask->piResults[i] = (pReader->hasChecksums() ? VERIFY_OK : VERIFY_NO_CHECKSUMS);
+		pReader->closeFile();
+	}
+	delete pReader;
+}
+
+int main_verify(int argc, char* argv[])
+{
+	bool bQuiet = false, bVerbose = false;
+	int iNumThreads = 0;
+
+	int c;
+	while ((c = getopt(argc, argv, "hj:qv")) != -1) {
+		switch (c) {
+		case 'h':
+			help_verify();
+			return 0;
+
+		case 'j':
+			iNumThreads = atoi(optarg);
+			break;
+
+		case 'q':
+			bQuiet = true;
+			break;
+
+		case 'v':
+			bVerbose = true;
+			break;
+
+		case '?':
+			fprintf(stderr, "Error: Unknown option. Use '%s verify -h' for help\n", EXECUTABLE_NAME);
+			return 255;
+
+		default:
+			fprintf(stderr, "Error: Internal error\n");
+			return 255;
+		}
+	}
+
+	// Remaining number of non-option parameters
+	int iArgs = argc - optind - 1;
+
+	if (iArgs < 1) {
+		syntax();
+		return 255;
+	}
+
+	std::vector<std::string> vsFiles;
+	for (int i = optind + 1; i < argc; i++)
+		verifyCollect(argv[i], vsFiles);
+
+	int iNumFiles = (int)vsFiles.size();
+	std::vector<int> viResults(iNumFiles, VERIFY_FAILED), viErrors(iNumFiles, DAFF_NO_ERROR);
+	if (iNumThreads <= 0)
+		iNumThreads = (int)std::max(std::thread::hardware_concurrency(), 1u);
+	iNumThreads = std::max(std::min(iNumThreads, iNumFiles), 1);
+
+	// Every worker verifies every n-th file, large files are spread over the workers
+	std::vector<VerifyTask> vTasks(iNumThreads);
+	for (int i = 0; i < iNumThreads; i++) {
+		vTasks[i].pvsFiles = &vsFiles;
+		vTasks[i].iFirst = i;
+		vTasks[i].iStride = iNumThreads;
+		vTasks[i].piResults = (iNumFiles > 0 ? &viResults[0] : NULL);
+		vTasks[i].piErrors = (iNumFiles > 0 ? &viErrors[0] : NULL);
+	}
+
+	std::vector<std::thread> vThreads;
+	for (int i = 1; i < iNumThreads; i++) {
+		try {
+			vThreads.push_back(std::thread(&verifyWorker, &vTasks[i]));
+		} catch (const std::system_error&) {
+			verifyWorker(&vTasks[i]);  // No more threads available
+		}
+	}
+	verifyWorker(&vTasks[0]);
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	int piCounts[3] = {0, 0, 0};
+	for (int i = 0; i < iNumFiles; i++) {
+		piCounts[viResults[i]]++;
+		if (bQuiet)
+			continue;
+
+		if (viResults[i] == VERIFY_FAILED)
+			printf("FAILED        %s (%s)\n", vsFiles[i].c_str(), DAFFUtils::StrError(viErrors[i]).c_str());
+		else if (bVerbose)
+			printf("%-13s %s\n", (viResults[i] == VERIFY_OK ? "OK" : "NO CHECKSUMS"), vsFiles[i].c_str());
+	}
+
+	if (!bQuiet)
+		printf("Verified %i files: %i OK, %i without checksums, %i failed\n", iNumFiles, piCounts[VERIFY_OK],
+			   piCounts[VERIFY_NO_CHECKSUMS], piCounts[VERIFY_FAILED]);
+
+	return (piCounts[VERIFY_FAILED] > 0 ? 1 : 0);
+}
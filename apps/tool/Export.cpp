@@ -4,11 +4,70 @@
 
 #include <sndfile.h>
 
+#include <algorithm>
+#include <atomic>
+#include <system_error>
+#include <thread>
+
 // Disable MSVC security warning for unsafe fopen
 #ifdef _MSC_VER
 #pragma warning(disable : 4996)
 #endif  // _MSC_VER
 
+// Audiofile format and its quantization name for the quantization of impulse responses (0 => unsupported)
+static int getWAVFormat(int iQuantization, std::string& sQuantization)
+{
+	switch (iQuantization) {
+	case DAFF_INT16:
+		sQuantization = DAFFUtils::StrQuantizationType(DAFF_INT16);
+		return SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+
+	case DAFF_INT24:
+		sQuantization = DAFFUtils::StrQuantizationType(DAFF_INT24);
+		return SF_FORMAT_WAV | SF_FORMAT_PCM_24;
+
+	case DAFF_FLOAT16:
+	case DAFF_BFLOAT16:
+	case DAFF_INT16_BFP:
+		// WAV has no 16-bit floating point format (nor scales per record channel)
+	case DAFF_FLOAT32:
+		sQuantization = DAFFUtils::StrQuantizationType(DAFF_FLOAT32);
+		return SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+
+	default:
+		return 0;
+	}
+}
+
+int getRecordChannelLength(const DAFFContent* pContent)
+{
+	switch (pContent->getProperties()->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE: return dynamic_cast<const DAFFContentIR*>(pContent)->getFilterLength();
+	case DAFF_MAGNITUDE_SPECTRUM: return dynamic_cast<const DAFFContentMS*>(pContent)->getNumFrequencies();
+	case DAFF_PHASE_SPECTRUM: return dynamic_cast<const DAFFContentPS*>(pContent)->getNumFrequencies();
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM: return 2 * dynamic_cast<const DAFFContentMPS*>(pContent)->getNumFrequencies();
+	case DAFF_DFT_SPECTRUM: return 2 * dynamic_cast<const DAFFContentDFT*>(pContent)->getNumDFTCoeffs();
+	default: return 0;
+	}
+}
+
+int fetchRecordChannel(const DAFFContent* pContent, int iRecordIndex, int iChannel, float* pfDest)
+{
+	switch (pContent->getProperties()->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		return dynamic_cast<const DAFFContentIR*>(pContent)->getFilterCoeffs(iRecordIndex, iChannel, pfDest);
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return dynamic_cast<const DAFFContentMS*>(pContent)->getMagnitudes(iRecordIndex, iChannel, pfDest);
+	case DAFF_PHASE_SPECTRUM:
+		return dynamic_cast<const DAFFContentPS*>(pContent)->getPhases(iRecordIndex, iChannel, pfDest);
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		return dynamic_cast<const DAFFContentMPS*>(pContent)->getCoefficientsMP(iRecordIndex, iChannel, pfDest);
+	case DAFF_DFT_SPECTRUM:
+		return dynamic_cast<const DAFFContentDFT*>(pContent)->getDFTCoeffs(iRecordIndex, iChannel, pfDest);
+	default: return DAFF_MODAL_ERROR;
+	}
+}
+
 int exportIR(DAFFContentIR* pContentIR, int iRecordIndex, const std::string& sFilename, int iView, bool bQuiet,
 			 bool bVerbose)
 {
@@ -36,24 +95,10 @@ int exportIR(DAFFContentIR* pContentIR, int iRecordIndex, const std::string& sFi
 	SF_INFO sfOutFileInfo;
 
 	std::string sOutfileQuantization;
-	switch (pContentIR->getProperties()->getQuantization()) {
-	case DAFF_INT16:
-		sfOutFileInfo.format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
-		sOutfileQuantization = DAFFUtils::StrQuantizationType(DAFF_INT16);
-		break;
-
-	case DAFF_INT24:
-		sfOutFileInfo.format = SF_FORMAT_WAV | SF_FORMAT_PCM_24;
-		sOutfileQuantization = DAFFUtils::StrQuantizationType(DAFF_INT24);
-		break;
-
-	case DAFF_FLOAT32:
-		sfOutFileInfo.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
-		sOutfileQuantization = DAFFUtils::StrQuantizationType(DAFF_FLOAT32);
-		break;
-
-	default:
+	sfOutFileInfo.format = getWAVFormat(pContentIR->getProperties()->getQuantization(), sOutfileQuantization);
+	if (sfOutFileInfo.format == 0) {
 		fprintf(stderr, "Error: Failed to write output file \"%s\", unrecognized quantization.\n", sFilename.c_str());
+		delete[] pfDataInterleaved;
 		return 255;
 	}
 
@@ -174,6 +219,329 @@ int exportDFT(DAFFContentDFT* pContent, const std::string& sFilename, int iRecor
 	return 0;
 }
 
+// Target size of the record chunks fetched by the bulk exports [Bytes]
+static const size_t EXPORT_CHUNK_SIZE = 16 << 20;
+
+// Number of worker threads for a number of records (iNumThreads <= 0 => all cores)
+static int getNumExportThreads(int iNumThreads, int iNumRecords)
+{
+	if (iNumThreads <= 0)
+		iNumThreads = (int)std::max(std::thread::hardware_concurrency(), 1u);
+	return std::max(std::min(iNumThreads, iNumRecords), 1);
+}
+
+// Runs the tasks on worker threads, the first one on the calling thread
+// (if threads can not be created, the remaining tasks run sequentially)
+template <class TTask>
+static void runExportTasks(std::vector<TTask>& vTasks, void (*pfnWorker)(TTask*))
+{
+	std::vector<std::thread> vThreads;
+	size_t i = 1;
+	try {
+		for (; i < vTasks.size(); i++)
+			vThreads.push_back(std::thread(pfnWorker, &vTasks[i]));
+	} catch (const std::system_error&) {
+		// Not enough threads available
+	}
+
+	pfnWorker(&vTasks[0]);
+	for (; i < vTasks.size(); i++)
+		pfnWorker(&vTasks[i]);
+
+	for (size_t j = 0; j < vThreads.size(); j++)
+		vThreads[j].join();
+}
+
+//! Record range of a worker of the per-record audiofile export
+struct ExportIRTask {
+	DAFFContentIR* pContentIR;                     //!@ Content
+	const std::vector<std::string>* pvsFilenames;  //!@ Output filenames (one per record)
+	int iView;                                     //!@ View, one of #DAFF_VIEWS
+	bool bQuiet;                                   //!@ Quiet output
+	bool bVerbose;                                 //!@ Verbose output
+	int iBegin;                                    //!@ First record index
+	int iEnd;                                      //!@ Record index behind the range
+	std::atomic<bool>* pbAbort;                    //!@ Abort flag shared by all workers
+	int iResult;                                   //!@ Result of the worker
+};
+
+static void exportIRWorker(ExportIRTask* pTask)
+{
+	pTask->iResult = 0;
+	for (int i = pTask->iBegin; (i < pTask->iEnd) && !pTask->pbAbort->load(); i++) {
+		pTask->iResult = exportIR(pTask->pContentIR, i, (*pTask->pvsFilenames)[i], pTask->iView, pTask->bQuiet,
+								  pTask->bVerbose);
+		if (pTask->iResult != 0) {
+			pTask->pbAbort->store(true);
+			break;
+		}
+	}
+}
+
+int exportIRFiles(DAFFContentIR* pContentIR, const std::vector<std::string>& vsFilenames, int iView, int iNumThreads,
+				  bool bQuiet, bool bVerbose)
+{
+	int iNumRecords = (int)vsFilenames.size();
+	if (iNumRecords == 0)
+		return 0;
+
+	// Contiguous record ranges, one per worker
+	iNumThreads = getNumExportThreads(iNumThreads, iNumRecords);
+	std::atomic<bool> bAbort(false);
+	std::vector<ExportIRTask> vTasks(iNumThreads);
+	for (int i = 0; i < iNumThreads; i++) {
+		ExportIRTask& oTask = vTasks[i];
+		oTask.pContentIR = pContentIR;
+		oTask.pvsFilenames = &vsFilenames;
+		oTask.iView = iView;
+		oTask.bQuiet = bQuiet;
+		oTask.bVerbose = bVerbose;
+		oTask.iBegin = (int)((long long)iNumRecords * i / iNumThreads);
+		oTask.iEnd = (int)((long long)iNumRecords * (i + 1) / iNumThreads);
+		oTask.pbAbort = &bAbort;
+		oTask.iResult = 0;
+	}
+
+	runExportTasks(vTasks, &exportIRWorker);
+
+	for (int i = 0; i < iNumThreads; i++)
+		if (vTasks[i].iResult != 0)
+			return vTasks[i].iResult;
+
+	return 0;
+}
+
+//! Record range of a worker filling a chunk of the bulk exports
+struct ExportFillTask {
+	const DAFFContent* pContent;  //!@ Content
+	int iChunkBegin;              //!@ First record index of the chunk
+	int iBegin;                   //!@ First record index of the worker
+	int iEnd;                     //!@ Record index behind the range of the worker
+	bool bInterleaved;            //!@ Channels interleaved per value (audiofile), otherwise channel blocks
+	float* pfChunk;               //!@ Chunk buffer
+	int iResult;                  //!@ Result of the worker
+};
+
+static void exportFillWorker(ExportFillTask* pTask)
+{
+	int iChannels = pTask->pContent->getProperties()->getNumberOfChannels();
+	int iLength = getRecordChannelLength(pTask->pContent);
+	std::vector<float> vfChannel(pTask->bInterleaved ? iLength : 0);
+
+	pTask->iResult = DAFF_NO_ERROR;
+	for (int i = pTask->iBegin; (i < pTask->iEnd) && (pTask->iResult == DAFF_NO_ERROR); i++) {
+		float* pfRecord = pTask->pfChunk + (size_t)(i - pTask->iChunkBegin) * iChannels * iLength;
+		for (int iChannel = 0; (iChannel < iChannels) && (pTask->iResult == DAFF_NO_ERROR); iChannel++) {
+			if (!pTask->bInterleaved) {
+				pTask->iResult = fetchRecordChannel(pTask->pContent, i, iChannel, pfRecord + iChannel * iLength);
+				continue;
+			}
+
+			pTask->iResult = fetchRecordChannel(pTask->pContent, i, iChannel, &vfChannel[0]);
+			for (int k = 0; k < iLength; k++)
+				pfRecord[k * iChannels + iChannel] = vfChannel[k];
+		}
+	}
+}
+
+// Fetches the records [iBegin, iEnd) into a chunk buffer with worker threads
+static int fillExportChunk(const DAFFContent* pContent, int iBegin, int iEnd, bool bInterleaved, int iNumThreads,
+						   float* pfChunk)
+{
+	iNumThreads = getNumExportThreads(iNumThreads, iEnd - iBegin);
+	std::vector<ExportFillTask> vTasks(iNumThreads);
+	for (int i = 0; i < iNumThreads; i++) {
+		ExportFillTask& oTask = vTasks[i];
+		oTask.pContent = pContent;
+		oTask.iChunkBegin = iBegin;
+		oTask.iBegin = iBegin + (int)((long long)(iEnd - iBegin) * i / iNumThreads);
+		oTask.iEnd = iBegin + (int)((long long)(iEnd - iBegin) * (i + 1) / iNumThreads);
+		oTask.bInterleaved = bInterleaved;
+		oTask.pfChunk = pfChunk;
+		oTask.iResult = DAFF_NO_ERROR;
+	}
+
+	runExportTasks(vTasks, &exportFillWorker);
+
+	for (int i = 0; i < iNumThreads; i++)
+		if (vTasks[i].iResult != DAFF_NO_ERROR)
+			return vTasks[i].iResult;
+
+	return DAFF_NO_ERROR;
+}
+
+// Number of records per chunk of the bulk exports
+static int getExportChunkRecords(const DAFFContent* pContent)
+{
+	int iChannels = pContent->getProperties()->getNumberOfChannels();
+	size_t nRecordSize = sizeof(float) * iChannels * std::max(getRecordChannelLength(pContent), 1);
+	return (int)std::max(EXPORT_CHUNK_SIZE / nRecordSize, (size_t)1);
+}
+
+int exportBulkWAV(const DAFFContentIR* pContentIR, const std::string& sFilename, int iNumThreads, bool bQuiet,
+				  bool bVerbose)
+{
+	const DAFFProperties* pProps = pContentIR->getProperties();
+	int iChannels = pProps->getNumberOfChannels();
+	int iFilterLength = pContentIR->getFilterLength();
+	int iNumRecords = pProps->getNumberOfRecords();
+
+	SNDFILE* pSndOutFile(NULL);
+	SF_INFO sfOutFileInfo;
+
+	std::string sOutfileQuantization;
+	sfOutFileInfo.format = getWAVFormat(pProps->getQuantization(), sOutfileQuantization);
+	if (sfOutFileInfo.format == 0) {
+		fprintf(stderr, "Error: Failed to write output file \"%s\", unrecognized quantization.\n", sFilename.c_str());
+		return 255;
+	}
+
+	sfOutFileInfo.channels = iChannels;
+	sfOutFileInfo.samplerate = (int)pContentIR->getSamplerate();
+
+	if (!(pSndOutFile = sf_open(sFilename.c_str(), SFM_WRITE, &sfOutFileInfo))) {
+		fprintf(stderr, "Error: Could not open file \"%s\" for writing\n", sFilename.c_str());
+		return 255;
+	}
+
+	// Records are fetched in chunks by the workers and written in index order
+	int iChunkRecords = getExportChunkRecords(pContentIR);
+	std::vector<float> vfChunk((size_t)std::min(iChunkRecords, iNumRecords) * iChannels * iFilterLength);
+	for (int iBegin = 0; iBegin < iNumRecords; iBegin += iChunkRecords) {
+		int iEnd = std::min(iBegin + iChunkRecords, iNumRecords);
+		int iError = fillExportChunk(pContentIR, iBegin, iEnd, true, iNumThreads, &vfChunk[0]);
+		if (iError != DAFF_NO_ERROR) {
+			fprintf(stderr, "Error: %s\n", DAFFUtils::StrError(iError).c_str());
+			sf_close(pSndOutFile);
+			return iError;
+		}
+
+		sf_count_t nFrames = (sf_count_t)(iEnd - iBegin) * iFilterLength;
+		if (sf_writef_float(pSndOutFile, &vfChunk[0], nFrames) != nFrames) {
+			fprintf(stderr, "Error: Failed to write output file \"%s\"\n", sFilename.c_str());
+			sf_close(pSndOutFile);
+			return 255;
+		}
+
+		if (bVerbose)
+			printf("Exported records %i to %i\n", iBegin, iEnd - 1);
+	}
+
+	sf_close(pSndOutFile);
+
+	if (!bQuiet) {
+		printf("Exported %i impulse responses to \"%s\" (%i samples each | %i channels | %s Hz | %s)\n", iNumRecords,
+			   sFilename.c_str(), iFilterLength, iChannels,
+			   DAFFUtils::Float2StrNice((float)pContentIR->getSamplerate(), 1, false).c_str(),
+			   sOutfileQuantization.c_str());
+	}
+
+	return 0;
+}
+
+// Writes the header of a NumPy file (format version 1.0) with float32 values in native byte order
+static bool writeNPYHeader(FILE* pFile, const std::string& sShape)
+{
+	const unsigned int uiOne = 1;
+	bool bLittleEndian = (*(const unsigned char*)&uiOne == 1);
+
+	// Magic string, version and header length (little endian), the header is padded to a multiple of 64 bytes
+	std::string sHeader = std::string("{'descr': '") + (bLittleEndian ? "<f4" : ">f4") +
+						  "', 'fortran_order': False, 'shape': (" + sShape + "), }";
+	sHeader.append(63 - (10 + sHeader.size()) % 64, ' ');
+	sHeader += '\n';
+
+	unsigned char pcPreamble[10] = {0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0};
+	pcPreamble[8] = (unsigned char)(sHeader.size() & 0xFF);
+	pcPreamble[9] = (unsigned char)(sHeader.size() >> 8);
+
+	return (fwrite(pcPreamble, 1, 10, pFile) == 10) &&
+		   (fwrite(sHeader.data(), 1, sHeader.size(), pFile) == sHeader.size());
+}
+
+int exportBulkNPY(const DAFFContent* pContent, const std::string& sFilename, const std::string& sCoordsFilename,
+				  int iView, int iNumThreads, bool bQuiet, bool bVerbose)
+{
+	const DAFFProperties* pProps = pContent->getProperties();
+	int iChannels = pProps->getNumberOfChannels();
+	int iLength = getRecordChannelLength(pContent);
+	int iNumRecords = pProps->getNumberOfRecords();
+
+	if (iLength == 0) {
+		fprintf(stderr, "Error: Unsupported content type\n");
+		return 255;
+	}
+
+	// Record coordinates
+	std::vector<float> vfCoords(2 * (size_t)iNumRecords);
+	for (int i = 0; i < iNumRecords; i++)
+		pContent->getRecordCoords(i, iView, vfCoords[2 * i], vfCoords[2 * i + 1]);
+
+	std::stringstream ssShape;
+	ssShape << iNumRecords << ", 2";
+
+	FILE* pFile = fopen(sCoordsFilename.c_str(), "wb");
+	if (pFile == NULL) {
+		fprintf(stderr, "Error: Could not open file \"%s\" for writing\n", sCoordsFilename.c_str());
+		return 255;
+	}
+
+	if (!writeNPYHeader(pFile, ssShape.str()) ||
+		(fwrite(&vfCoords[0], sizeof(float), vfCoords.size(), pFile) != vfCoords.size())) {
+		fprintf(stderr, "Error: Failed to write output file \"%s\"\n", sCoordsFilename.c_str());
+		fclose(pFile);
+		return 255;
+	}
+
+	fclose(pFile);
+
+	// Record data, fetched in chunks by the workers and written in index order
+	ssShape.str("");
+	ssShape << iNumRecords << ", " << iChannels << ", " << iLength;
+
+	pFile = fopen(sFilename.c_str(), "wb");
+	if (pFile == NULL) {
+		fprintf(stderr, "Error: Could not open file \"%s\" for writing\n", sFilename.c_str());
+		return 255;
+	}
+
+	if (!writeNPYHeader(pFile, ssShape.str())) {
+		fprintf(stderr, "Error: Failed to write output file \"%s\"\n", sFilename.c_str());
+		fclose(pFile);
+		return 255;
+	}
+
+	int iChunkRecords = getExportChunkRecords(pContent);
+	std::vector<float> vfChunk((size_t)std::min(iChunkRecords, iNumRecords) * iChannels * iLength);
+	for (int iBegin = 0; iBegin < iNumRecords; iBegin += iChunkRecords) {
+		int iEnd = std::min(iBegin + iChunkRecords, iNumRecords);
+		int iError = fillExportChunk(pContent, iBegin, iEnd, false, iNumThreads, &vfChunk[0]);
+		if (iError != DAFF_NO_ERROR) {
+			fprintf(stderr, "Error: %s\n", DAFFUtils::StrError(iError).c_str());
+			fclose(pFile);
+			return iError;
+		}
+
+		size_t nValues = (size_t)(iEnd - iBegin) * iChannels * iLength;
+		if (fwrite(&vfChunk[0], sizeof(float), nValues, pFile) != nValues) {
+			fprintf(stderr, "Error: Failed to write output file \"%s\"\n", sFilename.c_str());
+			fclose(pFile);
+			return 255;
+		}
+
+		if (bVerbose)
+			printf("Exported records %i to %i\n", iBegin, iEnd - 1);
+	}
+
+	fclose(pFile);
+
+	if (!bQuiet)
+		printf("Exported %i records to \"%s\" (%i channels | %i values each), coordinates to \"%s\"\n", iNumRecords,
+			   sFilename.c_str(), iChannels, iLength, sCoordsFilename.c_str());
+
+	return 0;
+}
+
 std::string convertMS2dat(DAFFContentMS* pContentMS, int iRecordIndex, float fAngle1, float fAngle2, int iView,
 						  bool bQuiet, bool bVerbose)
 {
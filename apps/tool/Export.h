@@ -14,14 +14,23 @@
 #define IW_DAFF_TOOL_EXPORT
 
 #include <string>
+#include <vector>
 
 // Forward declarations
+class DAFFContent;
 class DAFFContentIR;
 class DAFFContentMS;
 class DAFFContentPS;
 class DAFFContentMPS;
 class DAFFContentDFT;
 
+// Number of float values per channel of a record as fetched by fetchRecordChannel (0 => unsupported content type)
+int getRecordChannelLength(const DAFFContent* pContent);
+
+// Fetch the data of a record channel with the access method of the content type
+// (IR: filter coefficients, MS: magnitudes, PS: phases, MPS: magnitudes and phases, DFT: coefficients)
+int fetchRecordChannel(const DAFFContent* pContent, int iRecordIndex, int iChannel, float* pfDest);
+
 // Write an impulse response record into an audiofile
 int exportIR(DAFFContentIR* pContentIR, int iRecordIndex, const std::string& sFilename, int iView, bool bQuiet,
 			 bool bVerbose);
@@ -42,6 +51,21 @@ int exportMPS(DAFFContentMPS* pContentMPS, const std::string& sFilename, int iRe
 int exportDFT(DAFFContentDFT* pContentDFT, const std::string& sFilename, int iRecordIndex, float fAngle1, float fAngle2,
 			  int iView, bool bQuiet, bool bVerbose);
 
+// Write impulse response records into one audiofile each (vsFilenames: one per record),
+// with worker threads on a record range partition, each holding at most one open file
+// (iNumThreads <= 0 => all cores)
+int exportIRFiles(DAFFContentIR* pContentIR, const std::vector<std::string>& vsFilenames, int iView, int iNumThreads,
+				  bool bQuiet, bool bVerbose);
+
+// Write all impulse response records into a single audiofile (records concatenated in index order)
+int exportBulkWAV(const DAFFContentIR* pContentIR, const std::string& sFilename, int iNumThreads, bool bQuiet,
+				  bool bVerbose);
+
+// Write all records into a single NumPy file (float32, records x channels x values)
+// and their coordinates into another one (float32, records x 2 angles in degrees)
+int exportBulkNPY(const DAFFContent* pContent, const std::string& sFilename, const std::string& sCoordsFilename,
+				  int iView, int iNumThreads, bool bQuiet, bool bVerbose);
+
 // Convert a magnitude spectrum record into dat parsable file output
 // (iRecordIndex == -1 => Dump all records)
 std::string convertMS2dat(DAFFContentMS* pContentMS, int iRecordIndex, float fAngle1, float fAngle2, int iView,
@@ -2,6 +2,9 @@
 
 #include <DAFF.h>
 
+#include <algorithm>
+#include <cstdint>
+
 
 QDAFF2DPlot::QDAFF2DPlot(QWidget* parent) : QGraphicsView(new QGraphicsScene(), parent), m_pReader(NULL)
 {
@@ -31,6 +34,7 @@ QDAFF2DPlot::QDAFF2DPlot(QWidget* parent) : QGraphicsView(new QGraphicsScene(),
 	scale(1, -1);
 	setRenderHint(QPainter::Antialiasing);
 	connect(horizontalScrollBar(), SIGNAL(sliderReleased()), this, SLOT(HorizontalScrollBarRelease()));
+	connect(horizontalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(HorizontalScrollBarMove(int)));
 }
 
 void QDAFF2DPlot::ReadDAFF(const DAFFReader* pReader)
@@ -40,11 +44,16 @@ void QDAFF2DPlot::ReadDAFF(const DAFFReader* pReader)
 	m_iChannelIndex = 0;
 
 	m_pReader = pReader;
+	m_iEnvelopeRecordIndex = -1;
 	Draw();
 }
 
 void QDAFF2DPlot::CloseDAFF()
 {
+	m_vpEnvelopes.clear();
+	m_viEnvelopeChannels.clear();
+	m_vvpPoints.clear();
+	m_iEnvelopeRecordIndex = -1;
 	scene()->clear();
 	m_pReader = NULL;
 }
@@ -52,7 +61,15 @@ void QDAFF2DPlot::CloseDAFF()
 void QDAFF2DPlot::ChangeRecordIndex(int iRecordIndex)
 {
 	m_iRecordIndex = iRecordIndex;
-	Draw();
+
+	// axes and grid do not depend on the record, impulse response graphs without dots are updated in place
+	bool bDots = false;
+	for (int i = 0; i < m_vvpPoints.size(); i++)
+		bDots |= !m_vvpPoints[i].empty();
+	if (!m_vpEnvelopes.empty() && !bDots)
+		UpdateEnvelopes(m_iRecordIndex);
+	else
+		Draw();
 }
 
 void QDAFF2DPlot::ChangeChannelIndex(int iChannelIndex)
@@ -72,6 +89,11 @@ void QDAFF2DPlot::HorizontalScrollBarRelease()
 	Draw();
 }
 
+void QDAFF2DPlot::HorizontalScrollBarMove(int)
+{
+	UpdateEnvelopes(m_iRecordIndex);
+}
+
 void QDAFF2DPlot::SetAllChannelsVisible(bool bVisible)
 {
 	m_bShowAllChannels = bVisible;
@@ -89,7 +111,9 @@ void QDAFF2DPlot::Draw()
 	if (height() == 0 || width() == 0 || m_pReader == nullptr)
 		return;
 
-	// clear and draw background
+	// clear and draw background (the scene deletes all items)
+	m_vpEnvelopes.clear();
+	m_viEnvelopeChannels.clear();
 	scene()->clear();
 	scene()->setSceneRect(0, 0, plotWidth() - 20, plotHeight() - 20);
 	m_iXAxisLength =
@@ -914,120 +938,41 @@ void QDAFF2DPlot::DrawGraph(int recordIndex, int channelIndex, bool showAllChann
 	}
 	case DAFF_IMPULSE_RESPONSE: {
 		DAFFContentIR* pContent = dynamic_cast<DAFFContentIR*>(m_pReader->getContent());
-		std::vector<float> coeffs = std::vector<float>(pContent->getFilterLength());
 		double amplitudePixelRatio = m_iYAxisLength / 2;
 		double indexValueRatio = 1000000 / (pContent->getSamplerate());
 		QString text;
+		// one graph item per channel, drawn from the cached envelope
+		m_vvpGraphs.clear();
 		if (showAllChannels) {
-			m_vvpGraphs =
-				std::vector<std::vector<QGraphicsLineItem*>>(pContent->getProperties()->getNumberOfChannels());
 			m_vvpPoints = std::vector<std::vector<QGraphicsPoint*>>(pContent->getProperties()->getNumberOfChannels());
+			for (int i = 0; i < m_vvpPoints.size(); i++)
+				m_viEnvelopeChannels.push_back(i);
 		} else {
-			m_vvpGraphs = std::vector<std::vector<QGraphicsLineItem*>>(1);
 			m_vvpPoints = std::vector<std::vector<QGraphicsPoint*>>(1);
+			m_viEnvelopeChannels.push_back(channelIndex);
 		}
-		double dataPixelRatio;  // number of data points per pixel, never smaller than 1
-		double offset;
-		float min, max;  // used to store minimal and maximal amplitude of data points in a specific pixel column
-		int xMin, xMax;  // stores the right and left borders of the visible screen in x axis coordinates
-		int iMin, iMax;  // stores the right and left borders of the visible data points as index.
-		// check if it needs to draw only whats visible
-		if (pContent->getFilterLength() > m_iDrawLimit) {
-			// check which part of the x axis is visible
-			xMin = mapToScene(rect()).boundingRect().bottomLeft().x() - m_pXAxis->line().x1();
-			if (xMin < 0)
-				xMin = 0;
-			xMax = mapToScene(rect()).boundingRect().bottomRight().x() - m_pXAxis->line().x1();
-			if (xMax > m_iXAxisLength)
-				xMax = m_iXAxisLength;
-		} else {
-			xMin = 0;
-			xMax = m_iXAxisLength;
+		for (int i = 0; i < m_viEnvelopeChannels.size(); i++) {
+			m_vpEnvelopes.push_back(new QGraphicsEnvelope(m_voColors[m_viEnvelopeChannels[i] % 10]));
+			scene()->addItem(m_vpEnvelopes[i]);
 		}
-		for (int i = 0; i < m_vvpGraphs.size(); i++) {
-			if (showAllChannels)
-				pContent->getFilterCoeffs(recordIndex, i, &coeffs[0]);
-			else
-				pContent->getFilterCoeffs(recordIndex, channelIndex, &coeffs[0]);
-
-			if (pContent->getFilterLength() > m_iXAxisLength) {
-				dataPixelRatio = (float)pContent->getFilterLength() / m_iXAxisLength;  // number of data points per
-																					   // pixel
-				offset = 1;
-				m_vvpGraphs[i] = std::vector<QGraphicsLineItem*>(xMax - xMin - 1);
-				m_vvpPoints[i] = std::vector<QGraphicsPoint*>(xMax - xMin);
-				for (int j = 0; j < m_vvpGraphs[i].size(); j++) {
-					min = 0;
-					max = 0;
-					int indexMin = (j + xMin) * dataPixelRatio;
-					int indexMax = (j + xMin + 1) * dataPixelRatio;
-					for (int k = indexMin; k < indexMax; k++) {
-						if (coeffs[k] > max)
-							max = coeffs[k];
-						if (coeffs[k] < min)
-							min = coeffs[k];
-					}
-					if (showAllChannels)
-						m_vvpGraphs[i][j] =
-							scene()->addLine(QLine(m_pXAxis->line().x1() + j + xMin + 1,
-												   m_pXAxis->line().y1() + (min + 1) * amplitudePixelRatio,
-												   m_pXAxis->line().x1() + j + xMin + 1,
-												   m_pXAxis->line().y1() + (max + 1) * amplitudePixelRatio),
-											 QPen(m_voColors[i % 10]));
-					else
-						m_vvpGraphs[i][j] =
-							scene()->addLine(QLine(m_pXAxis->line().x1() + j + xMin + 1,
-												   m_pXAxis->line().y1() + (min + 1) * amplitudePixelRatio,
-												   m_pXAxis->line().x1() + j + xMin + 1,
-												   m_pXAxis->line().y1() + (max + 1) * amplitudePixelRatio),
-											 QPen(m_voColors[channelIndex % 10]));
-				}
-			} else {
-				dataPixelRatio = 1;
-				offset = (double)m_iXAxisLength / (pContent->getFilterLength() - 1);
-				iMin = (xMin / offset) - m_iAdditionalPoints;
-				if (iMin < 0)
-					iMin = 0;
-				iMax = (xMax / offset) + m_iAdditionalPoints;
-				if (iMax > pContent->getFilterLength() - 1)
-					iMax = pContent->getFilterLength() - 1;
-				m_vvpGraphs[i] = std::vector<QGraphicsLineItem*>(iMax - iMin - 1);
-				m_vvpPoints[i] = std::vector<QGraphicsPoint*>(iMax - iMin);
-				for (int j = 0; j < m_vvpGraphs[i].size(); j++) {
-					if (showAllChannels)
-						m_vvpGraphs[i][j] = scene()->addLine(
-							QLine(m_pXAxis->line().x1() + (j + iMin) * offset,
-								  m_pXAxis->line().y1() + (coeffs[j + iMin] + 1) * amplitudePixelRatio,
-								  m_pXAxis->line().x1() + (j + iMin + 1) * offset,
-								  m_pXAxis->line().y1() + (coeffs[j + iMin + 1] + 1) * amplitudePixelRatio),
-							QPen(m_voColors[i % 10]));
-					else
-						m_vvpGraphs[i][j] = scene()->addLine(
-							QLine(m_pXAxis->line().x1() + (j + iMin) * offset,
-								  m_pXAxis->line().y1() + (coeffs[j + iMin] + 1) * amplitudePixelRatio,
-								  m_pXAxis->line().x1() + (j + iMin + 1) * offset,
-								  m_pXAxis->line().y1() + (coeffs[j + iMin + 1] + 1) * amplitudePixelRatio),
-							QPen(m_voColors[channelIndex % 10]));
-				}
-			}
+		UpdateEnvelopes(recordIndex);
 
-			if (pContent->getFilterLength() * (m_iPointDiameter + 3) < m_iXAxisLength && showDots) {
-				for (int j = 0; j < m_vvpGraphs[i].size(); j++) {
+		// dots only for short filters, where each sample has enough space
+		if (pContent->getFilterLength() * (m_iPointDiameter + 3) < m_iXAxisLength && showDots) {
+			std::vector<float> coeffs = std::vector<float>(pContent->getFilterLength());
+			double offset = (double)m_iXAxisLength / (pContent->getFilterLength() - 1);
+			for (int i = 0; i < m_vvpPoints.size(); i++) {
+				pContent->getFilterCoeffs(recordIndex, m_viEnvelopeChannels[i], &coeffs[0]);
+				m_vvpPoints[i] = std::vector<QGraphicsPoint*>(coeffs.size());
+				for (int j = 0; j < m_vvpPoints[i].size(); j++) {
 					text = QString("Amplitude: ")
-							   .append(QString::number(coeffs[(int)((j + iMin) * dataPixelRatio)]))
+							   .append(QString::number(coeffs[j]))
 							   .append("\nSample Time: ")
-							   .append(QString::number(((int)((j + iMin) * dataPixelRatio)) * indexValueRatio));
-					m_vvpPoints[i][j] = new QGraphicsPoint(text, m_vvpGraphs[i][j]->line().x1(),
-														   m_vvpGraphs[i][j]->line().y1(), m_iPointDiameter);
-				}
-				size_t j = m_vvpGraphs[i].size();
-				text = QString("Amplitude: ")
-						   .append(QString::number(coeffs[(int)((j + iMin) * dataPixelRatio)]))
-						   .append("\nSample Time: ")
-						   .append(QString::number(((int)((j + iMin) * dataPixelRatio)) * indexValueRatio));
-				m_vvpPoints[i][j] = new QGraphicsPoint(text, m_vvpGraphs[i][j - 1]->line().x2(),
-													   m_vvpGraphs[i][j - 1]->line().y2(), m_iPointDiameter);
-				for (int j = 0; j < m_vvpPoints[i].size(); j++) {
+							   .append(QString::number(j * indexValueRatio));
+					m_vvpPoints[i][j] =
+						new QGraphicsPoint(text, m_pXAxis->line().x1() + j * offset,
+										   m_pXAxis->line().y1() + (coeffs[j] + 1) * amplitudePixelRatio,
+										   m_iPointDiameter);
 					scene()->addItem(m_vvpPoints[i][j]);
 				}
 			}
@@ -1321,6 +1266,94 @@ void QDAFF2DPlot::DrawGraph(int recordIndex, int channelIndex, bool showAllChann
 	}
 }
 
+void QDAFF2DPlot::UpdateEnvelopes(int recordIndex)
+{
+	if (m_vpEnvelopes.empty())
+		return;
+
+	DAFFContentIR* pContent = dynamic_cast<DAFFContentIR*>(m_pReader->getContent());
+	int iFilterLength = pContent->getFilterLength();
+	double amplitudePixelRatio = m_iYAxisLength / 2;
+	int xMin, xMax;  // stores the right and left borders of the visible screen in x axis coordinates
+	// check if it needs to draw only whats visible
+	if (iFilterLength > m_iDrawLimit) {
+		// check which part of the x axis is visible
+		xMin = mapToScene(rect()).boundingRect().bottomLeft().x() - m_pXAxis->line().x1();
+		if (xMin < 0)
+			xMin = 0;
+		xMax = mapToScene(rect()).boundingRect().bottomRight().x() - m_pXAxis->line().x1();
+		if (xMax > m_iXAxisLength)
+			xMax = m_iXAxisLength;
+	} else {
+		xMin = 0;
+		xMax = m_iXAxisLength;
+	}
+
+	if (iFilterLength > m_iXAxisLength) {
+		// more samples than pixels: minimum and maximum per pixel column, computed for visible columns only
+		// and kept until the record or the axis length changes
+		if (m_iEnvelopeRecordIndex != recordIndex || m_iEnvelopeColumns != m_iXAxisLength) {
+			int nrOfChannels = pContent->getProperties()->getNumberOfChannels();
+			m_vvfEnvelopeMin.assign(nrOfChannels, std::vector<float>(m_iXAxisLength, 0.0f));
+			m_vvfEnvelopeMax.assign(nrOfChannels, std::vector<float>(m_iXAxisLength, 0.0f));
+			m_vvbEnvelopeValid.assign(nrOfChannels, std::vector<bool>(m_iXAxisLength, false));
+			m_iEnvelopeRecordIndex = recordIndex;
+			m_iEnvelopeColumns = m_iXAxisLength;
+		}
+		for (int i = 0; i < m_vpEnvelopes.size(); i++) {
+			int channel = m_viEnvelopeChannels[i];
+			std::vector<bool>& valid = m_vvbEnvelopeValid[channel];
+			for (int j = xMin; j < xMax;) {
+				if (valid[j]) {
+					j++;
+					continue;
+				}
+				// column k covers the samples [k * length / columns, (k + 1) * length / columns)
+				int k = j;
+				while (k < xMax && !valid[k])
+					valid[k++] = true;
+				int iFirstSample = (int)((int64_t)j * iFilterLength / m_iXAxisLength);
+				int iLastSample = (int)((int64_t)k * iFilterLength / m_iXAxisLength);
+				pContent->getFilterEnvelope(recordIndex, channel, iFirstSample, iLastSample - iFirstSample, k - j,
+											&m_vvfEnvelopeMin[channel][j], &m_vvfEnvelopeMax[channel][j]);
+				j = k;
+			}
+			// alternate the direction of the vertical strokes, so that the connections follow the extrema
+			QPolygonF polyline;
+			polyline.reserve(2 * (xMax - xMin));
+			for (int j = xMin; j < xMax; j++) {
+				float first = m_vvfEnvelopeMin[channel][j];
+				float second = m_vvfEnvelopeMax[channel][j];
+				if (j % 2)
+					std::swap(first, second);
+				double x = m_pXAxis->line().x1() + j + 1;
+				polyline << QPointF(x, m_pXAxis->line().y1() + (first + 1) * amplitudePixelRatio)
+						 << QPointF(x, m_pXAxis->line().y1() + (second + 1) * amplitudePixelRatio);
+			}
+			m_vpEnvelopes[i]->SetPolyline(polyline);
+		}
+	} else {
+		// every visible sample
+		std::vector<float> coeffs = std::vector<float>(iFilterLength);
+		double offset = (double)m_iXAxisLength / (iFilterLength - 1);
+		int iMin = (xMin / offset) - m_iAdditionalPoints;
+		if (iMin < 0)
+			iMin = 0;
+		int iMax = (xMax / offset) + m_iAdditionalPoints;
+		if (iMax > iFilterLength - 1)
+			iMax = iFilterLength - 1;
+		for (int i = 0; i < m_vpEnvelopes.size(); i++) {
+			pContent->getFilterCoeffs(recordIndex, m_viEnvelopeChannels[i], &coeffs[0]);
+			QPolygonF polyline;
+			polyline.reserve(iMax - iMin + 1);
+			for (int j = iMin; j <= iMax; j++)
+				polyline << QPointF(m_pXAxis->line().x1() + j * offset,
+									m_pXAxis->line().y1() + (coeffs[j] + 1) * amplitudePixelRatio);
+			m_vpEnvelopes[i]->SetPolyline(polyline);
+		}
+	}
+}
+
 void QDAFF2DPlot::ExportImagePNG(const QString& filePath, float factor, bool showAllChannels, bool showDots)
 {
 	bool showAllChannelsOld = m_bShowAllChannels;
@@ -90,6 +90,32 @@ class QGraphicsPoint : public QGraphicsItem {
 	int m_iDiameter;
 };
 
+//! Graph drawn as one polyline in a single paint call (e.g. the min/max envelope of a long impulse response)
+class QGraphicsEnvelope : public QGraphicsItem {
+  public:
+	inline QGraphicsEnvelope(const QColor& oColor) : m_oColor(oColor) {}
+
+	inline void SetPolyline(const QPolygonF& oPolyline)
+	{
+		prepareGeometryChange();
+		m_oPolyline = oPolyline;
+		m_oBoundingRect = m_oPolyline.boundingRect().adjusted(-1, -1, +1, +1);
+	}
+
+	inline void paint(QPainter* painter, const QStyleOptionGraphicsItem*, QWidget*)
+	{
+		painter->setPen(QPen(m_oColor));
+		painter->drawPolyline(m_oPolyline);
+	}
+
+	inline QRectF boundingRect() const { return m_oBoundingRect; }
+
+  private:
+	QColor m_oColor;
+	QPolygonF m_oPolyline;
+	QRectF m_oBoundingRect;
+};
+
 class QDAFF2DPlot : public QGraphicsView {
 	Q_OBJECT
 
@@ -107,6 +133,7 @@ class QDAFF2DPlot : public QGraphicsView {
 	void ChangeChannelIndex(int);
 	void ChangeFrequencyIndex(int);
 	void HorizontalScrollBarRelease();
+	void HorizontalScrollBarMove(int);
 	void SetAllChannelsVisible(bool bVisible);
 	void SetDotsVisible(bool bVisible);
 
@@ -124,6 +151,7 @@ class QDAFF2DPlot : public QGraphicsView {
 	void DrawCoordinateSystem();
 	void DrawGraph(int iRecordIndex, int iChannelIndex, bool bShowAllChannels = false, bool showDots = true);
 	void DrawChannelBox(int iChannelIndex);
+	void UpdateEnvelopes(int iRecordIndex);
 	int plotWidth();
 	int plotHeight();
 	void GetXIncrement(double max);
@@ -139,6 +167,15 @@ class QDAFF2DPlot : public QGraphicsView {
 	std::vector<std::vector<QGraphicsPoint*>> m_vvpPoints;
 	std::vector<QColor> m_voColors;
 
+	// impulse response graphs
+	std::vector<QGraphicsEnvelope*> m_vpEnvelopes;      //!< Graph items of the drawn channels
+	std::vector<int> m_viEnvelopeChannels;              //!< Channel of each graph item
+	std::vector<std::vector<float>> m_vvfEnvelopeMin;   //!< Cached minimum per channel and x axis pixel column
+	std::vector<std::vector<float>> m_vvfEnvelopeMax;   //!< Cached maximum per channel and x axis pixel column
+	std::vector<std::vector<bool>> m_vvbEnvelopeValid;  //!< Cached columns per channel
+	int m_iEnvelopeRecordIndex = -1;                    //!< Record of the cached envelope
+	int m_iEnvelopeColumns = 0;                         //!< Number of pixel columns of the cached envelope
+
 	// variables
 	int m_iXAxisLength;
 	int m_iYAxisLength;
@@ -19,10 +19,106 @@
 #include <QFont>
 #include <QHeaderView>
 #include <QTableView>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <list>
+#include <map>
+#include <vector>
 
 #include <assert.h>
 
+//! Statistics of the recently shown record channels, the least recently used ones are dropped
+class QDAFFRecordStatisticsCache {
+  public:
+	inline QDAFFRecordStatisticsCache(const DAFFReader* pReader, int iCapacity = 64)
+		: m_pReader(pReader), m_iCapacity(iCapacity)
+	{
+	}
+
+	inline const DAFFRecordStatistics& Get(int iRecordIndex, int iChannel)
+	{
+		int iKey = iRecordIndex * m_pReader->getProperties()->getNumberOfChannels() + iChannel;
+		std::map<int, std::list<Entry>::iterator>::iterator it = m_mEntries.find(iKey);
+		if (it != m_mEntries.end()) {
+			m_lEntries.splice(m_lEntries.begin(), m_lEntries, it->second);
+			return it->second->second;
+		}
+
+		if ((int)m_lEntries.size() >= m_iCapacity) {
+			m_mEntries.erase(m_lEntries.back().first);
+			m_lEntries.pop_back();
+		}
+		m_lEntries.push_front(Entry(iKey, Compute(iRecordIndex, iChannel)));
+		m_mEntries[iKey] = m_lEntries.begin();
+		return m_lEntries.front().second;
+	}
+
+  private:
+	typedef std::pair<int, DAFFRecordStatistics> Entry;
+
+	inline DAFFRecordStatistics Compute(int iRecordIndex, int iChannel) const
+	{
+		DAFFRecordStatistics oStats;
+		oStats.fPeak = 0;
+		oStats.fEnergy = 0;
+		oStats.fRMS = 0;
+		oStats.iOnset = -1;
+
+		const DAFFContentIR* pContentIR = NULL;
+		const DAFFContentMS* pContentMS = NULL;
+		if (m_pReader->getContentType() == DAFF_IMPULSE_RESPONSE)
+			pContentIR = dynamic_cast<const DAFFContentIR*>(m_pReader->getContent());
+		else if (m_pReader->getContentType() == DAFF_MAGNITUDE_SPECTRUM)
+			pContentMS = dynamic_cast<const DAFFContentMS*>(m_pReader->getContent());
+		else
+			return oStats;
+
+		// Stored in the file: no need to touch the record data
+		if (m_pReader->hasStatistics()) {
+			if (pContentIR)
+				pContentIR->getRecordStatistics(iRecordIndex, iChannel, oStats);
+			else
+				pContentMS->getRecordStatistics(iRecordIndex, iChannel, oStats);
+			return oStats;
+		}
+
+		// Otherwise only this record, the content would determine the statistics of all records at once
+		std::vector<float> vfValues;
+		int iError;
+		if (pContentIR) {
+			vfValues.resize(pContentIR->getFilterLength());
+			iError = pContentIR->getFilterCoeffs(iRecordIndex, iChannel, &vfValues[0]);
+		} else {
+			vfValues.resize(pContentMS->getNumFrequencies());
+			iError = pContentMS->getMagnitudes(iRecordIndex, iChannel, &vfValues[0]);
+		}
+		if (iError != DAFF_NO_ERROR || vfValues.empty())
+			return oStats;
+
+		for (size_t i = 0; i < vfValues.size(); i++) {
+			oStats.fPeak = std::max(oStats.fPeak, std::fabs(vfValues[i]));
+			oStats.fEnergy += vfValues[i] * vfValues[i];
+		}
+		oStats.fRMS = std::sqrt(oStats.fEnergy / vfValues.size());
+		// Onset: first value reaching -20 dB of the peak
+		if (oStats.fPeak > 0) {
+			for (size_t i = 0; i < vfValues.size(); i++) {
+				if (std::fabs(vfValues[i]) >= 0.1f * oStats.fPeak) {
+					oStats.iOnset = (int)i;
+					break;
+				}
+			}
+		}
+		return oStats;
+	}
+
+	const DAFFReader* m_pReader;                           //!< Reader of the record channels
+	int m_iCapacity;                                       //!< Maximum number of cached record channels
+	std::list<Entry> m_lEntries;                           //!< Cached statistics, most recently used first
+	std::map<int, std::list<Entry>::iterator> m_mEntries;  //!< Cached entry per record channel
+};
+
 class DAFFContentModel : public QAbstractTableModel {
 	Q_OBJECT
 
@@ -76,16 +172,26 @@ class DAFFContentModel : public QAbstractTableModel {
 
 		return QVariant();
 	}
+
+	//! Selects the record channel shown in the record rows
+	inline virtual void SetRecordChannel(int, int) {}
 };
 
 class QDAFFContentIRModel : public DAFFContentModel {
   public:
-	inline QDAFFContentIRModel(QObject* pParent, DAFFContentIR* pContent)
-		: DAFFContentModel(pParent), m_pContent(pContent)
+	inline QDAFFContentIRModel(QObject* pParent, DAFFContentIR* pContent, const DAFFReader* pReader)
+		: DAFFContentModel(pParent), m_pContent(pContent), m_oStatistics(pReader), m_iRecordIndex(0), m_iChannel(0)
 	{
 	}
 
-	inline int rowCount(const QModelIndex&) const { return 5; };
+	inline int rowCount(const QModelIndex&) const { return 9; };
+
+	inline void SetRecordChannel(int iRecordIndex, int iChannel)
+	{
+		m_iRecordIndex = iRecordIndex;
+		m_iChannel = iChannel;
+		emit dataChanged(index(5, 1), index(8, 1));
+	}
 
 	inline QVariant data(const QModelIndex& index, int iRole = Qt::DisplayRole) const
 	{
@@ -107,6 +213,31 @@ class QDAFFContentIRModel : public DAFFContentModel {
 				return (index.column() == 0 ? QString("Sampling rate")
 											: QString("%1 Hz").arg(m_pContent->getSamplerate()));
 			}
+
+			// Record rows, only the shown record channel is fetched
+			if (index.column() == 0) {
+				switch (index.row()) {
+				case 5:
+					return QString("Record peak value");
+				case 6:
+					return QString("Record energy");
+				case 7:
+					return QString("Record RMS value");
+				case 8:
+					return QString("Record onset (-20 dB)");
+				}
+			}
+			const DAFFRecordStatistics& oStats = m_oStatistics.Get(m_iRecordIndex, m_iChannel);
+			switch (index.row()) {
+			case 5:
+				return QString::number(oStats.fPeak);
+			case 6:
+				return QString::number(oStats.fEnergy);
+			case 7:
+				return QString::number(oStats.fRMS);
+			case 8:
+				return (oStats.iOnset < 0 ? QString("-") : QString("Sample %1").arg(oStats.iOnset));
+			}
 		}
 
 		return DAFFContentModel::data(index, iRole);
@@ -114,16 +245,26 @@ class QDAFFContentIRModel : public DAFFContentModel {
 
   private:
 	DAFFContentIR* m_pContent;
+	mutable QDAFFRecordStatisticsCache m_oStatistics;
+	int m_iRecordIndex;
+	int m_iChannel;
 };
 
 class QDAFFContentMSModel : public DAFFContentModel {
   public:
-	inline QDAFFContentMSModel(QObject* pParent, const DAFFContentMS* pContent)
-		: DAFFContentModel(pParent), m_pContent(pContent)
+	inline QDAFFContentMSModel(QObject* pParent, const DAFFContentMS* pContent, const DAFFReader* pReader)
+		: DAFFContentModel(pParent), m_pContent(pContent), m_oStatistics(pReader), m_iRecordIndex(0), m_iChannel(0)
 	{
 	}
 
-	inline int rowCount(const QModelIndex&) const { return 3; };
+	inline int rowCount(const QModelIndex&) const { return 7; };
+
+	inline void SetRecordChannel(int iRecordIndex, int iChannel)
+	{
+		m_iRecordIndex = iRecordIndex;
+		m_iChannel = iChannel;
+		emit dataChanged(index(3, 1), index(6, 1));
+	}
 
 	inline QVariant data(const QModelIndex& index, int iRole = Qt::DisplayRole) const
 	{
@@ -141,6 +282,32 @@ class QDAFFContentMSModel : public DAFFContentModel {
 				return (index.column() == 0 ? QString("Overall maximum magnitude")
 											: QString::number(m_pContent->getOverallMagnitudeMaximum()));
 			}
+
+			// Record rows, only the shown record channel is fetched
+			if (index.column() == 0) {
+				switch (index.row()) {
+				case 3:
+					return QString("Record peak magnitude");
+				case 4:
+					return QString("Record energy");
+				case 5:
+					return QString("Record RMS magnitude");
+				case 6:
+					return QString("Record onset (-20 dB)");
+				}
+			}
+			const DAFFRecordStatistics& oStats = m_oStatistics.Get(m_iRecordIndex, m_iChannel);
+			switch (index.row()) {
+			case 3:
+				return QString::number(oStats.fPeak);
+			case 4:
+				return QString::number(oStats.fEnergy);
+			case 5:
+				return QString::number(oStats.fRMS);
+			case 6:
+				return (oStats.iOnset < 0 ? QString("-")
+										  : QString("%1 Hz").arg(m_pContent->getFrequencies()[oStats.iOnset]));
+			}
 		}
 
 		return DAFFContentModel::data(index, iRole);
@@ -148,6 +315,9 @@ class QDAFFContentMSModel : public DAFFContentModel {
 
   private:
 	const DAFFContentMS* m_pContent;
+	mutable QDAFFRecordStatisticsCache m_oStatistics;
+	int m_iRecordIndex;
+	int m_iChannel;
 };
 
 class QDAFFContentMPSModel : public DAFFContentModel {
@@ -262,7 +432,10 @@ class QDAFFContentTableView : public QTableView {
 	Q_OBJECT
 
   public:
-	inline QDAFFContentTableView(QWidget* parent = Q_NULLPTR) : QTableView(parent), m_pModel(NULL) {}
+	inline QDAFFContentTableView(QWidget* parent = Q_NULLPTR)
+		: QTableView(parent), m_pModel(NULL), m_iRecordIndex(0), m_iChannelIndex(0)
+	{
+	}
 
   public slots:
 	inline void CloseDAFF()
@@ -271,6 +444,20 @@ class QDAFFContentTableView : public QTableView {
 		m_pModel = NULL;
 	};
 
+	inline void ChangeRecordIndex(int iRecordIndex)
+	{
+		m_iRecordIndex = iRecordIndex;
+		if (m_pModel)
+			m_pModel->SetRecordChannel(m_iRecordIndex, m_iChannelIndex);
+	};
+
+	inline void ChangeChannelIndex(int iChannelIndex)
+	{
+		m_iChannelIndex = iChannelIndex;
+		if (m_pModel)
+			m_pModel->SetRecordChannel(m_iRecordIndex, m_iChannelIndex);
+	};
+
 	inline void ReadDAFF(const DAFFReader* pReader)
 	{
 		if (pReader == NULL)
@@ -281,12 +468,12 @@ class QDAFFContentTableView : public QTableView {
 			// No const pointer because one of the methods uses lazy initialization (calculates member value on first
 			// call)
 			DAFFContentIR* pContentIR = dynamic_cast<DAFFContentIR*>(pReader->getContent());
-			m_pModel = new QDAFFContentIRModel(this, pContentIR);
+			m_pModel = new QDAFFContentIRModel(this, pContentIR, pReader);
 			break;
 		}
 		case DAFF_MAGNITUDE_SPECTRUM: {
 			const DAFFContentMS* pContentMS = dynamic_cast<const DAFFContentMS*>(pReader->getContent());
-			m_pModel = new QDAFFContentMSModel(this, pContentMS);
+			m_pModel = new QDAFFContentMSModel(this, pContentMS, pReader);
 			break;
 		}
 		case DAFF_MAGNITUDE_PHASE_SPECTRUM: {
@@ -306,6 +493,8 @@ class QDAFFContentTableView : public QTableView {
 		}
 		}
 
+		m_iRecordIndex = 0;
+		m_iChannelIndex = 0;
 		setModel(m_pModel);
 		verticalHeader()->hide();
 
@@ -316,6 +505,8 @@ class QDAFFContentTableView : public QTableView {
 
   private:
 	DAFFContentModel* m_pModel;
+	int m_iRecordIndex;
+	int m_iChannelIndex;
 };
 
 #endif  // QDAFFCONTENTTABLE_H
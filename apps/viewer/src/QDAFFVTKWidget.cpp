@@ -3,23 +3,79 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QKeyEvent>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <system_error>
 
 #include <vtkAVIWriter.h>
 #include <vtkAssembly.h>
+#include <vtkCallbackCommand.h>
 #include <vtkCamera.h>
+#include <vtkImageData.h>
 #include <vtkImageMagnify.h>
 #include <vtkInteractorStyleTerrain.h>
 #include <vtkPNGWriter.h>
 #include <vtkRenderWindow.h>
 #include <vtkWindowToImageFilter.h>
 
+//! Re-decimates the carpet plot when the camera has been moved (e.g. zoomed)
+static void OnEndInteraction(vtkObject*, unsigned long, void* pClientData, void*)
+{
+	static_cast<QDAFFVTKWidget*>(pClientData)->UpdateCarpetTimeWindow();
+}
+
+//! Applies the pending scene graph changes once per frame, right before the window renders
+static void OnStartRender(vtkObject*, unsigned long, void* pClientData, void*)
+{
+	static_cast<QDAFFVTKWidget*>(pClientData)->UpdateScene();
+}
+
+//! Rendered frame of an image series and its file path
+typedef std::pair<vtkSmartPointer<vtkImageData>, std::string> CFrame;
+
+//! Rendered frames of an image series, encoded and written by worker threads while the next frames are rendered
+struct CFrameQueue {
+	std::deque<CFrame> dFrames;        //!< Waiting frames
+	size_t nMaxFrames;                 //!< Maximum number of waiting frames (bounds the memory)
+	bool bFinished;                    //!< All frames have been queued
+	std::mutex mxFrames;               //!< Guards the frames and the finished flag
+	std::condition_variable cvQueued;  //!< Signalled when a frame has been queued or the series is finished
+	std::condition_variable cvTaken;   //!< Signalled when a frame has been taken
+};
+
+//! Encodes and writes PNG frames of a queue until the series is finished and all frames have been taken
+static void EncodeFrames(CFrameQueue* pQueue)
+{
+	vtkSmartPointer<vtkPNGWriter> pWriter = vtkSmartPointer<vtkPNGWriter>::New();
+	while (true) {
+		std::unique_lock<std::mutex> lock(pQueue->mxFrames);
+		while (pQueue->dFrames.empty() && !pQueue->bFinished)
+			pQueue->cvQueued.wait(lock);
+		if (pQueue->dFrames.empty())
+			return;
+
+		CFrame oFrame = pQueue->dFrames.front();
+		pQueue->dFrames.pop_front();
+		lock.unlock();
+		pQueue->cvTaken.notify_one();
+
+		pWriter->SetInputData(oFrame.first);
+		pWriter->SetFileName(oFrame.second.c_str());
+		pWriter->Write();
+	}
+}
 
 QDAFFVTKWidget::QDAFFVTKWidget(QWidget* parent)
 	: QVTKWidget(parent), m_pRenderer(NULL), m_pSGRootNode(NULL), m_pSCA(NULL), m_pDAFFContentBalloon(NULL),
 	  m_pCCA(NULL), m_pDAFFContentCarpet(NULL), m_pSDI(NULL), m_bBalloonPhaseColor(false), m_bCarpetWarp(true),
-	  m_iCarpetScaling(DAFFViz::CarpetPlot::SCALING_LINEAR), m_iBalloonScaling(DAFFViz::BalloonPlot::SCALING_DECIBEL)
+	  m_iCarpetScaling(DAFFViz::CarpetPlot::SCALING_LINEAR), m_iBalloonScaling(DAFFViz::BalloonPlot::SCALING_DECIBEL),
+	  m_iPlotBuildID(0), m_bBuildingPlot(false), m_pBalloonGeometry(NULL), m_pCarpetGeometry(NULL),
+	  m_iPendingFrequencyIndex(-1), m_iPendingChannelIndex(-1), m_dPendingAlphaDeg(0.0), m_dPendingBetaDeg(0.0),
+	  m_bPendingAlpha(false), m_bPendingBeta(false)
 {
 	m_pSGRootNode = new DAFFViz::SGNode();
 
@@ -39,12 +95,26 @@ QDAFFVTKWidget::QDAFFVTKWidget(QWidget* parent)
 
 	GetRenderWindow()->AddRenderer(m_pRenderer);
 
+	// Setters only mark the scene graph nodes dirty, all changes of a frame are applied in one traversal
+	vtkSmartPointer<vtkCallbackCommand> pStartRender = vtkSmartPointer<vtkCallbackCommand>::New();
+	pStartRender->SetCallback(&OnStartRender);
+	pStartRender->SetClientData(this);
+	GetRenderWindow()->AddObserver(vtkCommand::StartEvent, pStartRender);
+
 	if (SupportsOpenGL()) {
 		m_pRenderer->AddActor(m_pSGRootNode->GetNodeAssembly());
 
 		vtkSmartPointer<vtkInteractorStyleTerrain> pCustomInteractorStyle =
 			vtkSmartPointer<vtkInteractorStyleTerrain>::New();
 		GetRenderWindow()->GetInteractor()->SetInteractorStyle(pCustomInteractorStyle);
+
+		// Frame rate while interacting, the balloon of dense grids reduces its level of detail to reach it
+		GetRenderWindow()->GetInteractor()->SetDesiredUpdateRate(60.0);
+
+		vtkSmartPointer<vtkCallbackCommand> pEndInteraction = vtkSmartPointer<vtkCallbackCommand>::New();
+		pEndInteraction->SetCallback(&OnEndInteraction);
+		pEndInteraction->SetClientData(this);
+		pCustomInteractorStyle->AddObserver(vtkCommand::EndInteractionEvent, pEndInteraction);
 	} else {
 		m_pRenderer->SetBackground(0.71f, 0.71f, 0.71f);
 	}
@@ -52,6 +122,10 @@ QDAFFVTKWidget::QDAFFVTKWidget(QWidget* parent)
 
 QDAFFVTKWidget::~QDAFFVTKWidget()
 {
+	// No signals while destroying
+	m_bBuildingPlot = false;
+	DiscardPlotBuild();
+
 	if (m_pDAFFContentBalloon)
 		delete m_pDAFFContentBalloon;
 	if (m_pSCA)
@@ -72,6 +146,8 @@ bool QDAFFVTKWidget::SupportsOpenGL()
 
 void QDAFFVTKWidget::CloseDAFF()
 {
+	DiscardPlotBuild();
+
 	// Clear current balloon node
 	if (m_pDAFFContentBalloon) {
 		m_pSGRootNode->RemoveChildNode(m_pDAFFContentBalloon);
@@ -98,6 +174,13 @@ void QDAFFVTKWidget::CloseDAFF()
 
 void QDAFFVTKWidget::ReadDAFF(const DAFFReader* pReader)
 {
+	ReadDAFFContent(pReader ? pReader->getContent() : nullptr);
+}
+
+void QDAFFVTKWidget::ReadDAFFContent(const DAFFContent* pContent)
+{
+	DiscardPlotBuild();
+
 	// Clear current balloon node
 	if (m_pDAFFContentBalloon) {
 		m_pSGRootNode->RemoveChildNode(m_pDAFFContentBalloon);
@@ -112,7 +195,7 @@ void QDAFFVTKWidget::ReadDAFF(const DAFFReader* pReader)
 		m_pDAFFContentCarpet = NULL;
 	}
 
-	if (pReader == nullptr)
+	if (pContent == nullptr)
 		return;
 
 	if (m_pSCA->HasParentNode())
@@ -121,11 +204,63 @@ void QDAFFVTKWidget::ReadDAFF(const DAFFReader* pReader)
 	if (m_pCCA->HasParentNode())
 		m_pSGRootNode->RemoveChildNode(m_pCCA);
 
-	switch (pReader->getContentType()) {
-	case DAFF_IMPULSE_RESPONSE: {
-		DAFFContentIR* pContentIR = static_cast<DAFFContentIR*>(pReader->getContent());
-		m_pDAFFContentCarpet = new DAFFViz::CarpetPlot(m_pSGRootNode, pContentIR);
-		m_pDAFFContentCarpet->SetScaling(m_iCarpetScaling);
+	// The plot geometry reads all records, it is built on a worker thread to keep the viewer responsive
+	// (the plot is set up in FinishReadDAFF)
+	m_iPendingFrequencyIndex = -1;
+	m_iPendingChannelIndex = -1;
+	m_bPendingAlpha = false;
+	m_bPendingBeta = false;
+	m_bBuildingPlot = true;
+	emit SignalBuildingPlot(true);
+
+	// Long impulse responses are decimated to the height of the widget
+	try {
+		m_oPlotBuilder =
+			std::thread(&QDAFFVTKWidget::BuildPlotGeometry, this, pContent, m_iCarpetScaling, height(), m_iPlotBuildID);
+	} catch (const std::system_error&) {
+		// No thread available, build here
+		BuildPlotGeometry(pContent, m_iCarpetScaling, height(), m_iPlotBuildID);
+	}
+}
+
+void QDAFFVTKWidget::BuildPlotGeometry(const DAFFContent* pContent, int iCarpetScaling, int iCarpetTimeResolution,
+									   int iBuildID)
+{
+	// Only touches the geometry members, the widget reads them after the thread has been joined
+	switch (pContent->getProperties()->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		m_pCarpetGeometry = new DAFFViz::CarpetPlotGeometry(static_cast<const DAFFContentIR*>(pContent), iCarpetScaling,
+															0, iCarpetTimeResolution);
+		break;
+	case DAFF_DFT_SPECTRUM:
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+	case DAFF_MAGNITUDE_SPECTRUM:
+	case DAFF_PHASE_SPECTRUM:
+		m_pBalloonGeometry = new DAFFViz::BalloonPlotGeometry(pContent);
+		break;
+	}
+
+	QMetaObject::invokeMethod(this, "FinishReadDAFF", Qt::QueuedConnection, Q_ARG(int, iBuildID));
+}
+
+void QDAFFVTKWidget::FinishReadDAFF(int iBuildID)
+{
+	// Build has been discarded meanwhile
+	if (iBuildID != m_iPlotBuildID)
+		return;
+
+	if (m_oPlotBuilder.joinable())
+		m_oPlotBuilder.join();
+
+	if (m_pCarpetGeometry) {
+		const DAFFContentIR* pContentIR = m_pCarpetGeometry->GetContent();
+		m_pDAFFContentCarpet = new DAFFViz::CarpetPlot(m_pSGRootNode, *m_pCarpetGeometry);
+		delete m_pCarpetGeometry;
+		m_pCarpetGeometry = NULL;
+
+		// Scaling may have changed while building
+		if (m_pDAFFContentCarpet->GetScaling() != m_iCarpetScaling)
+			m_pDAFFContentCarpet->SetScaling(m_iCarpetScaling);
 		m_pDAFFContentCarpet->SetWarpingEnabled(m_bCarpetWarp);
 
 		m_pSDI->SetVisible(false);
@@ -147,30 +282,64 @@ void QDAFFVTKWidget::ReadDAFF(const DAFFReader* pReader)
 		m_pCCA->UpdateAxes();
 
 		m_pSGRootNode->AddChildNode(m_pCCA);
-		break;
 	}
-	case DAFF_DFT_SPECTRUM:
-	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
-	case DAFF_MAGNITUDE_SPECTRUM:
-	case DAFF_PHASE_SPECTRUM:
-		m_pDAFFContentBalloon = new DAFFViz::BalloonPlot(m_pSGRootNode, pReader->getContent());
+
+	if (m_pBalloonGeometry) {
+		m_pDAFFContentBalloon = new DAFFViz::BalloonPlot(m_pSGRootNode, *m_pBalloonGeometry);
+		delete m_pBalloonGeometry;
+		m_pBalloonGeometry = NULL;
+
 		m_pDAFFContentBalloon->SetScaling(m_iBalloonScaling);
 		m_pDAFFContentBalloon->SetUsePhaseAsColor(m_bBalloonPhaseColor);
 		m_pDAFFContentBalloon->SetNormalize(m_bNormalize);
 		m_pDAFFContentBalloon->SetNormalizeFrequenciesIndividually(m_bNormalizeFreqsIndiv);
 
 		m_pSGRootNode->AddChildNode(m_pSCA);
-
-		break;
 	}
 
+	m_bBuildingPlot = false;
+
+	// Apply the selections made while building
+	if (m_iPendingFrequencyIndex >= 0)
+		ChangeFrequencyIndex(m_iPendingFrequencyIndex);
+	if (m_iPendingChannelIndex >= 0)
+		ChangeChannelIndex(m_iPendingChannelIndex);
+	if (m_bPendingAlpha)
+		ChangeAlpha(m_dPendingAlphaDeg);
+	if (m_bPendingBeta)
+		ChangeBeta(m_dPendingBetaDeg);
+
+	emit SignalBuildingPlot(false);
+
 	update();
 }
 
+void QDAFFVTKWidget::DiscardPlotBuild()
+{
+	if (m_oPlotBuilder.joinable())
+		m_oPlotBuilder.join();
+
+	delete m_pBalloonGeometry;
+	m_pBalloonGeometry = NULL;
+	delete m_pCarpetGeometry;
+	m_pCarpetGeometry = NULL;
+
+	// Outdates a queued FinishReadDAFF
+	m_iPlotBuildID++;
+
+	if (m_bBuildingPlot) {
+		m_bBuildingPlot = false;
+		emit SignalBuildingPlot(false);
+	}
+}
+
+
 void QDAFFVTKWidget::ChangeFrequencyIndex(int iFrequencyIndex)
 {
 	if (m_pDAFFContentBalloon)
 		m_pDAFFContentBalloon->SetSelectedFrequency(iFrequencyIndex);
+	else if (m_bBuildingPlot)
+		m_iPendingFrequencyIndex = iFrequencyIndex;
 
 	update();
 }
@@ -183,27 +352,49 @@ void QDAFFVTKWidget::ChangeChannelIndex(int iChannelIndex)
 	if (m_pDAFFContentCarpet)
 		m_pDAFFContentCarpet->SetChannel(iChannelIndex);
 
+	if (m_bBuildingPlot)
+		m_iPendingChannelIndex = iChannelIndex;
+
 	update();
 }
 
 void QDAFFVTKWidget::ChangeAlpha(double dAlphaDeg)
 {
-	if (m_pDAFFContentCarpet)
+	if (m_pDAFFContentCarpet) {
 		if (m_pDAFFContentCarpet->getFixedAngle() == DAFFViz::CarpetPlot::ALPHA_FIXED)
 			m_pDAFFContentCarpet->SetSelectedAngle(dAlphaDeg);
+	} else if (m_bBuildingPlot) {
+		m_bPendingAlpha = true;
+		m_dPendingAlphaDeg = dAlphaDeg;
+	}
 
 	update();
 }
 
 void QDAFFVTKWidget::ChangeBeta(double dBetaDeg)
 {
-	if (m_pDAFFContentCarpet)
+	if (m_pDAFFContentCarpet) {
 		if (m_pDAFFContentCarpet->getFixedAngle() == DAFFViz::CarpetPlot::BETA_FIXED)
 			m_pDAFFContentCarpet->SetSelectedAngle(dBetaDeg);
+	} else if (m_bBuildingPlot) {
+		m_bPendingBeta = true;
+		m_dPendingBetaDeg = dBetaDeg;
+	}
 
 	update();
 }
 
+void QDAFFVTKWidget::UpdateCarpetTimeWindow()
+{
+	if (m_pDAFFContentCarpet && m_pDAFFContentCarpet->UpdateTimeWindow(m_pRenderer))
+		update();
+}
+
+void QDAFFVTKWidget::UpdateScene()
+{
+	m_pSGRootNode->Update();
+}
+
 void QDAFFVTKWidget::ChangePhi(double dPhiDeg)
 {
 	if (m_pSDI)
@@ -227,6 +418,7 @@ void QDAFFVTKWidget::ExportScreenshotPNG(QString sFilePath, int iWidth, int iHei
 	vtkSmartPointer<vtkRenderWindow> pImageRenderWin = vtkSmartPointer<vtkRenderWindow>::New();
 	pImageRenderWin->SetSize(iWidth, iHeight);
 	pImageRenderWin->AddRenderer(pImageRenderer);
+	UpdateScene();
 	pImageRenderWin->Render();
 
 	vtkSmartPointer<vtkWindowToImageFilter> pFilter = vtkSmartPointer<vtkWindowToImageFilter>::New();
@@ -250,10 +442,13 @@ void QDAFFVTKWidget::ExportScrenshotSeriesPNG(QString sFileBasePath, QString sFi
 	pImageRenderer->AddActor(m_pSGRootNode->GetNodeAssembly());
 	pImageRenderer->SetActiveCamera(m_pRenderer->GetActiveCamera());
 
+	// Rendered off screen, without showing a window for the frames
 	vtkSmartPointer<vtkRenderWindow> pImageRenderWin = vtkSmartPointer<vtkRenderWindow>::New();
 	pImageRenderWin->SetWindowName(sFileBaseName.toStdString().c_str());
+	pImageRenderWin->SetOffScreenRendering(1);
 	pImageRenderWin->SetSize(oA.iWidth, oA.iHeight);
 	pImageRenderWin->AddRenderer(pImageRenderer);
+	UpdateScene();
 	pImageRenderWin->Render();
 
 	vtkSmartPointer<vtkWindowToImageFilter> pFilter = vtkSmartPointer<vtkWindowToImageFilter>::New();
@@ -261,6 +456,21 @@ void QDAFFVTKWidget::ExportScrenshotSeriesPNG(QString sFileBasePath, QString sFi
 	pFilter->ReadFrontBufferOff();
 	pFilter->SetInput(pImageRenderWin);
 
+	// The frames share the scene graph and are rendered one after another, the PNG encoding of
+	// the rendered frames overlaps on worker threads (the calling thread renders)
+	CFrameQueue oQueue;
+	oQueue.bFinished = false;
+	int iNumThreads = (int)std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	oQueue.nMaxFrames = 2 * iNumThreads;
+
+	std::vector<std::thread> vThreads;
+	try {
+		for (int i = 0; i < iNumThreads; i++)
+			vThreads.push_back(std::thread(&EncodeFrames, &oQueue));
+	} catch (const std::system_error&) {
+		// Not enough threads available, encode with the ones started (or in this thread)
+	}
+
 	vtkSmartPointer<vtkPNGWriter> pExportPNG = vtkSmartPointer<vtkPNGWriter>::New();
 	pExportPNG->SetInputConnection(pFilter->GetOutputPort());
 
@@ -295,6 +505,7 @@ void QDAFFVTKWidget::ExportScrenshotSeriesPNG(QString sFileBasePath, QString sFi
 		}
 
 		// Render
+		UpdateScene();
 		pImageRenderWin->Render();
 
 		// This is required to update the filter, otherwise you have a still image
@@ -307,9 +518,32 @@ void QDAFFVTKWidget::ExportScrenshotSeriesPNG(QString sFileBasePath, QString sFi
 		QDir oDir(sFileBasePath);
 		QFileInfo oFile(oDir, ss.str().c_str());
 
-		pExportPNG->SetFileName(oFile.absoluteFilePath().toStdString().c_str());
-		pExportPNG->Write();
+		if (vThreads.empty()) {
+			pExportPNG->SetFileName(oFile.absoluteFilePath().toStdString().c_str());
+			pExportPNG->Write();
+			continue;
+		}
+
+		// Copy of the frame for the encoders, the filter output is overwritten by the next frame
+		pFilter->Update();
+		vtkSmartPointer<vtkImageData> pFrame = vtkSmartPointer<vtkImageData>::New();
+		pFrame->DeepCopy(pFilter->GetOutput());
+
+		std::unique_lock<std::mutex> lock(oQueue.mxFrames);
+		while (oQueue.dFrames.size() >= oQueue.nMaxFrames)
+			oQueue.cvTaken.wait(lock);
+		oQueue.dFrames.push_back(CFrame(pFrame, oFile.absoluteFilePath().toStdString()));
+		lock.unlock();
+		oQueue.cvQueued.notify_one();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(oQueue.mxFrames);
+		oQueue.bFinished = true;
 	}
+	oQueue.cvQueued.notify_all();
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
 
 	m_pSGRootNode->SetOrientationYPR(0, 0, 0);
 }
@@ -17,6 +17,7 @@
 
 #include <QObject>
 #include <iostream>
+#include <thread>
 
 #include <QVTKWidget.h>
 #include <vtkRenderer.h>
@@ -66,6 +67,7 @@ class QDAFFVTKWidget : public QVTKWidget {
   public slots:
 
 	void ReadDAFF(const DAFFReader* pReader);
+	void ReadDAFFContent(const DAFFContent* pContent);
 	void CloseDAFF();
 
 	void ChangeFrequencyIndex(int iFrequencyIndex);
@@ -91,6 +93,15 @@ class QDAFFVTKWidget : public QVTKWidget {
 	void SetNormalizeFrequenciesIndividually(bool);
 	void SetNormalize(bool);
 
+	void UpdateCarpetTimeWindow();
+	void UpdateScene();
+
+  signals:
+	void SignalBuildingPlot(bool bBuilding);
+
+  private slots:
+	void FinishReadDAFF(int iBuildID);
+
   private:
 	vtkSmartPointer<vtkRenderer> m_pRenderer;
 	DAFFViz::SGNode* m_pSGRootNode;
@@ -102,6 +113,18 @@ class QDAFFVTKWidget : public QVTKWidget {
 	bool m_bBalloonPhaseColor, m_bCarpetWarp;
 	int m_iCarpetScaling, m_iBalloonScaling;
 	bool m_bNormalizeFreqsIndiv, m_bNormalize;
+
+	std::thread m_oPlotBuilder;                            //!< Builds the plot geometry of a file on a worker thread
+	int m_iPlotBuildID;                                    //!< Identifies the latest build (older ones are discarded)
+	bool m_bBuildingPlot;                                  //!< A plot is being built
+	DAFFViz::BalloonPlotGeometry* m_pBalloonGeometry;      //!< Built balloon geometry (handed over in FinishReadDAFF)
+	DAFFViz::CarpetPlotGeometry* m_pCarpetGeometry;        //!< Built carpet geometry (handed over in FinishReadDAFF)
+	int m_iPendingFrequencyIndex, m_iPendingChannelIndex;  //!< Selected while building (-1: none)
+	double m_dPendingAlphaDeg, m_dPendingBetaDeg;          //!< Selected while building
+	bool m_bPendingAlpha, m_bPendingBeta;                  //!< Angle selected while building
+
+	void BuildPlotGeometry(const DAFFContent* pContent, int iCarpetScaling, int iCarpetTimeResolution, int iBuildID);
+	void DiscardPlotBuild();
 };
 
 #endif  // QDAFFVTKWIDGET_H
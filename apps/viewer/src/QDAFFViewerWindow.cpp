@@ -9,6 +9,7 @@
 #include <QLayout>
 #include <QMessageBox>
 #include <QPalette>
+#include <QProgressBar>
 #include <QSettings>
 #include <QShortcut>
 #include <iostream>
@@ -21,8 +22,36 @@
 #include "QDAFFDialogExport3DPlotImageSeries.h"
 #include "QDAFFVTKWidget.h"
 
+//! Forwards the progress and the result of an asynchronous opening from the worker thread into the GUI thread
+class QDAFFOpenCallback : public DAFFOpenCallback {
+  public:
+	inline QDAFFOpenCallback(QDAFFViewerWindow* pWindow) : m_pWindow(pWindow), m_iOpenID(0) {};
+
+	//! Sets the ID of the next opening (only while no opening is in progress)
+	inline void SetOpenID(int iOpenID) { m_iOpenID = iOpenID; };
+
+	inline bool onOpenProgress(float fProgress)
+	{
+		QMetaObject::invokeMethod(m_pWindow, "ShowOpenProgress", Qt::QueuedConnection, Q_ARG(int, m_iOpenID),
+								  Q_ARG(float, fProgress));
+		return true;
+	};
+
+	inline void onOpenFinished(int iErrorCode)
+	{
+		QMetaObject::invokeMethod(m_pWindow, "FinishOpenDAFFFile", Qt::QueuedConnection, Q_ARG(int, m_iOpenID),
+								  Q_ARG(int, iErrorCode));
+	};
+
+  private:
+	QDAFFViewerWindow* m_pWindow;
+	int m_iOpenID;
+};
+
 QDAFFViewerWindow::QDAFFViewerWindow(QWidget* parent, QString sPath)
 	: QMainWindow(parent), ui(new Ui::DAFFViewer), m_pDAFFReader(DAFFReader::create()),
+	  m_pOpenCallback(new QDAFFOpenCallback(this)), m_iOpenID(0), m_bOpenQuiet(false), m_pPlotProgressBar(NULL),
+	  m_pCompareReader(NULL), m_pComparator(NULL),
 	  m_qSettings("ITA", "DAFFViewer"), m_iShowChannel(0), m_iShowFrequencyIndex(0), m_dShowTimeSample(0.0f),
 	  m_dShowAlphaDeg(0.0f), m_dShowBetaDeg(90.0f), m_dShowPhiDeg(0.0f), m_dShowThetaDeg(0.0f),
 	  m_dPhiThetaIncrementDeg(1.0f)
@@ -31,6 +60,14 @@ QDAFFViewerWindow::QDAFFViewerWindow(QWidget* parent, QString sPath)
 
 	RestoreWindowSize();
 
+	// Busy indicator of the 3D plot, which is built in the background
+	m_pPlotProgressBar = new QProgressBar(this);
+	m_pPlotProgressBar->setRange(0, 0);
+	m_pPlotProgressBar->setMaximumWidth(120);
+	m_pPlotProgressBar->setToolTip("Building 3D plot");
+	m_pPlotProgressBar->setVisible(false);
+	ui->DAFFStatusBar->addPermanentWidget(m_pPlotProgressBar);
+
 	// Read DAFF header conns
 	connect(this, SIGNAL(SignalReadDAFF(const DAFFReader*)), ui->groupBox_Reader, SLOT(ReadDAFF(const DAFFReader*)));
 	connect(this, SIGNAL(SignalReadDAFF(const DAFFReader*)), ui->tableView_Metadata, SLOT(ReadDAFF(const DAFFReader*)));
@@ -67,6 +104,7 @@ QDAFFViewerWindow::QDAFFViewerWindow(QWidget* parent, QString sPath)
 	connect(this, SIGNAL(SignalChannelIndexChanged(int)), ui->DAFF3DPlot_VTKWidget, SLOT(ChangeChannelIndex(int)));
 	connect(this, SIGNAL(SignalChannelIndexChanged(int)), ui->spinBox_ChannelIndex, SLOT(setValue(int)));
 	connect(this, SIGNAL(SignalChannelIndexChanged(int)), ui->graphicsView_2DDAFFPlot, SLOT(ChangeChannelIndex(int)));
+	connect(this, SIGNAL(SignalChannelIndexChanged(int)), ui->tableView_Content, SLOT(ChangeChannelIndex(int)));
 	connect(ui->spinBox_ChannelIndex, SIGNAL(valueChanged(int)), this, SLOT(ChangeChannelIndex(int)));
 
 	// Alpha and beta conns
@@ -80,6 +118,7 @@ QDAFFViewerWindow::QDAFFViewerWindow(QWidget* parent, QString sPath)
 	// Record index conns
 	connect(this, SIGNAL(SignalRecordIndexChanged(int)), ui->spinBox_RecordIndex, SLOT(setValue(int)));
 	connect(this, SIGNAL(SignalRecordIndexChanged(int)), ui->graphicsView_2DDAFFPlot, SLOT(ChangeRecordIndex(int)));
+	connect(this, SIGNAL(SignalRecordIndexChanged(int)), ui->tableView_Content, SLOT(ChangeRecordIndex(int)));
 	connect(ui->spinBox_RecordIndex, SIGNAL(valueChanged(int)), this, SLOT(ChangeRecordIndex(int)));
 
 	// Phi and theta conns
@@ -97,6 +136,7 @@ QDAFFViewerWindow::QDAFFViewerWindow(QWidget* parent, QString sPath)
 	// 3D conns
 	connect(this, SIGNAL(SignalExportScreenshotPNG(QString)), ui->DAFF3DPlot_VTKWidget,
 			SLOT(ExportScreenshotPNG(QString)));
+	connect(ui->DAFF3DPlot_VTKWidget, SIGNAL(SignalBuildingPlot(bool)), this, SLOT(ShowBuildingPlot(bool)));
 
 
 	// Menu settings
@@ -151,6 +191,10 @@ QDAFFViewerWindow::QDAFFViewerWindow(QWidget* parent, QString sPath)
 
 QDAFFViewerWindow::~QDAFFViewerWindow()
 {
+	// Cancel a file that is still being opened
+	m_pDAFFReader->cancelOpen();
+	m_pDAFFReader->waitForOpen();
+
 	m_qSettings.setValue("WindowGeometry", saveGeometry());
 	m_qSettings.setValue("WindowState", saveState());
 
@@ -169,12 +213,16 @@ QDAFFViewerWindow::~QDAFFViewerWindow()
 						 ui->action3DSphericalNormalizeFrequenciesIndividually->isChecked());
 	m_qSettings.setValue("Settings/3DPlot/Carpet/Warp", ui->action3DCarpetShowWarp->isChecked());
 
+	// The 3D plot may still build the plot of the difference content
+	DiscardComparison();
+
 	delete ui;
 
 	if (m_pDAFFReader->isFileOpened())
 		m_pDAFFReader->closeFile();
 
 	delete m_pDAFFReader;
+	delete m_pOpenCallback;
 }
 
 void QDAFFViewerWindow::RestoreWindowSize()
@@ -245,6 +293,13 @@ void QDAFFViewerWindow::on_actionQuit_triggered()
 
 void QDAFFViewerWindow::OpenDAFFFile(QString sPath, bool bQuiet)
 {
+	// Cancel a file that is still being opened
+	if (m_pDAFFReader->isOpening())
+		m_pDAFFReader->cancelOpen();
+	m_pDAFFReader->waitForOpen();
+
+	DiscardComparison();
+
 	if (m_pDAFFReader->isFileOpened()) {
 		ui->DAFFStatusBar->showMessage("Closing current DAFF file ");
 		emit SignalCloseDAFF();
@@ -253,14 +308,44 @@ void QDAFFViewerWindow::OpenDAFFFile(QString sPath, bool bQuiet)
 
 	ui->DAFFStatusBar->showMessage("Opening DAFF file " + sPath);
 
+	// The file is loaded on a worker thread, the viewer stays responsive (continued in FinishOpenDAFFFile)
 	QFileInfo oPassedFile(sPath);
-	int iError = DAFF_NO_ERROR;
-	if ((iError = m_pDAFFReader->openFile(oPassedFile.absoluteFilePath().toStdString())) != DAFF_NO_ERROR) {
+	m_sOpenFilePath = sPath;
+	m_bOpenQuiet = bQuiet;
+	m_pOpenCallback->SetOpenID(++m_iOpenID);
+	int iError = m_pDAFFReader->openFileAsync(oPassedFile.absoluteFilePath().toStdString(), m_pOpenCallback);
+	if (iError != DAFF_NO_ERROR)
+		FinishOpenDAFFFile(m_iOpenID, iError);
+}
+
+void QDAFFViewerWindow::ShowOpenProgress(int iOpenID, float fProgress)
+{
+	if (iOpenID == m_iOpenID && m_pDAFFReader->isOpening())
+		ui->DAFFStatusBar->showMessage("Opening DAFF file " + m_sOpenFilePath + " (" +
+									   QString::number(int(fProgress * 100.0f)) + "%)");
+}
+
+void QDAFFViewerWindow::ShowBuildingPlot(bool bBuilding)
+{
+	m_pPlotProgressBar->setVisible(bBuilding);
+}
+
+void QDAFFViewerWindow::FinishOpenDAFFFile(int iOpenID, int iError)
+{
+	// Result of an opening that has been superseded or closed
+	if (iOpenID != m_iOpenID)
+		return;
+
+	QFileInfo oPassedFile(m_sOpenFilePath);
+	if (iError == DAFF_OPEN_CANCELLED) {
+		ui->DAFFStatusBar->showMessage("Opening of '" + oPassedFile.fileName() + "' cancelled");
+		return;
+	} else if (iError != DAFF_NO_ERROR) {
 		QErrorMessage qe;
 		QString sError = "Could not open requested file '" + oPassedFile.fileName() +
 						 "': " + QString(DAFFUtils::StrError(iError).c_str());
 		qe.showMessage(sError);
-		if (!bQuiet)
+		if (!m_bOpenQuiet)
 			qe.exec();
 
 		ui->DAFFStatusBar->showMessage(sError);
@@ -271,6 +356,7 @@ void QDAFFViewerWindow::OpenDAFFFile(QString sPath, bool bQuiet)
 		ui->DAFFStatusBar->showMessage(sMsg);
 		emit SignalReadDAFF(m_pDAFFReader);
 		emit SignalContentLoaded(m_pDAFFReader->getContent());
+		ChangePhiAndTheta(m_dShowPhiDeg, m_dShowThetaDeg);
 
 		QStringList vsRecentFiles = m_qSettings.value("RecentFiles").toStringList();
 		QStringList vsNewRecentFiles;
@@ -335,10 +421,99 @@ void QDAFFViewerWindow::on_actionAboutDAFFViewer_triggered()
 
 void QDAFFViewerWindow::on_actionClose_triggered()
 {
+	m_iOpenID++;  // Discards the result of a file that is still being opened
+	DiscardComparison();
 	emit SignalCloseDAFF();
 	m_pDAFFReader->closeFile();
 }
 
+void QDAFFViewerWindow::on_actionCompare_triggered(bool bChecked)
+{
+	if (!bChecked) {
+		// Back to the current file
+		DiscardComparison();
+		if (m_pDAFFReader->isFileOpened()) {
+			ui->DAFF3DPlot_VTKWidget->ReadDAFF(m_pDAFFReader);
+			ui->DAFFStatusBar->showMessage("Comparison closed");
+		}
+		return;
+	}
+
+	if (!m_pDAFFReader->isFileOpened()) {
+		ui->actionCompare->setChecked(false);
+		ui->DAFFStatusBar->showMessage("Open a DAFF file first, then compare it with another DAFF file");
+		return;
+	}
+
+	QFileDialog fd;
+	fd.setNameFilter("DAFF files (*.daff)");
+	fd.setViewMode(QFileDialog::Detail);
+	fd.setFileMode(QFileDialog::ExistingFile);
+	fd.setWindowTitle("Compare with DAFF file");
+
+	QDir oOpenDialogLastDirectory(m_qSettings.value("OpenDialogLastDirectory").toString());
+	if (oOpenDialogLastDirectory.exists())
+		fd.setDirectory(oOpenDialogLastDirectory);
+
+	if (!fd.exec() || fd.selectedFiles().empty()) {
+		ui->actionCompare->setChecked(false);
+		return;
+	}
+
+	DiscardComparison();
+
+	// The compared file is the test content, the current file is the reference
+	QFileInfo oCompareFile(fd.selectedFiles()[0]);
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+	m_pCompareReader = DAFFReader::create();
+	int iError = m_pCompareReader->openFile(oCompareFile.absoluteFilePath().toStdString());
+	if (iError == DAFF_NO_ERROR) {
+		m_pComparator = new DAFFComparator(m_pDAFFReader->getContent(), m_pCompareReader->getContent(), false);
+		iError = m_pComparator->compare();
+	}
+	QApplication::restoreOverrideCursor();
+
+	if (iError != DAFF_NO_ERROR) {
+		QString sError = "Could not compare with '" + oCompareFile.fileName() +
+						 "': " + QString(DAFFUtils::StrError(iError).c_str());
+		DiscardComparison();
+		ui->actionCompare->setChecked(false);
+		ui->DAFFStatusBar->showMessage(sError);
+		QMessageBox::warning(this, "Compare", sError);
+		return;
+	}
+
+	// Difference impulse responses as carpet plot, magnitude ratios as balloon plot
+	ui->actionCompare->setChecked(true);
+	ui->DAFF3DPlot_VTKWidget->ReadDAFFContent(m_pComparator->getDifferenceContent());
+
+	QString sMsg = "Differences of '" + oCompareFile.fileName() + "': error energy " +
+				   QString::number(m_pComparator->getOverallErrorEnergy(), 'f', 1) + " dB";
+	if (m_pComparator->getNumFrequencies() > 0)
+		sMsg += ", greatest magnitude delta " + QString::number(m_pComparator->getMaximumMagnitudeDelta(), 'f', 1) +
+				" dB";
+	sMsg += (m_pComparator->isGridMatching() ? " (same grid)" : " (resampled to the current grid)");
+	ui->DAFFStatusBar->showMessage(sMsg);
+}
+
+void QDAFFViewerWindow::DiscardComparison()
+{
+	// The 3D plot shows the difference content until it reads another content
+	if (m_pComparator)
+		ui->DAFF3DPlot_VTKWidget->ReadDAFFContent(nullptr);
+
+	delete m_pComparator;
+	m_pComparator = NULL;
+
+	if (m_pCompareReader) {
+		m_pCompareReader->closeFile();
+		delete m_pCompareReader;
+		m_pCompareReader = NULL;
+	}
+
+	ui->actionCompare->setChecked(false);
+}
+
 void QDAFFViewerWindow::on_actionDownload_triggered()
 {
 	QUrl urlDownloadWebsite("http://sourceforge.net/projects/opendaff/files/Content");
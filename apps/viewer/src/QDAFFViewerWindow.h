@@ -15,8 +15,11 @@
 #include <QMainWindow>
 #include <QSettings>
 
+class DAFFComparator;
 class DAFFReader;
 class DAFFContent;
+class QDAFFOpenCallback;
+class QProgressBar;
 
 namespace Ui {
 class DAFFViewer;
@@ -37,6 +40,7 @@ class QDAFFViewerWindow : public QMainWindow {
 	void on_actionOpen_triggered();
 	void on_actionQuit_triggered();
 	void on_actionClose_triggered();
+	void on_actionCompare_triggered(bool);
 	void on_actionOpenDAFFWebsite_triggered();
 	void on_actionCreate_triggered();
 	void on_actionAboutOpenDAFF_triggered();
@@ -52,6 +56,9 @@ class QDAFFViewerWindow : public QMainWindow {
 	void on_action2DShowAllChannels_triggered(bool);
 
 	void OpenDAFFFileRecent();
+	void ShowOpenProgress(int iOpenID, float fProgress);
+	void FinishOpenDAFFFile(int iOpenID, int iError);
+	void ShowBuildingPlot(bool bBuilding);
 
 	void IncreaseAlpha();
 	void DecreaseAlpha();
@@ -137,6 +144,13 @@ class QDAFFViewerWindow : public QMainWindow {
 	QSettings m_qSettings;
 
 	DAFFReader* m_pDAFFReader;
+	QDAFFOpenCallback* m_pOpenCallback;  //!< Forwards the asynchronous opening into the GUI thread
+	int m_iOpenID;                       //!< Identifies the latest opening (results of older ones are discarded)
+	QString m_sOpenFilePath;             //!< File being opened
+	bool m_bOpenQuiet;                   //!< Do not show a message box if opening fails
+	QProgressBar* m_pPlotProgressBar;    //!< Busy indicator while the 3D plot is built
+	DAFFReader* m_pCompareReader;        //!< File compared with the current file (see actionCompare)
+	DAFFComparator* m_pComparator;       //!< Differences of the compared file, shown in the 3D plot
 
 	double m_dShowAlphaDeg, m_dShowBetaDeg;                          //!< Data view angle
 	double m_dShowPhiDeg, m_dShowThetaDeg, m_dPhiThetaIncrementDeg;  //!< Object view angle
@@ -147,6 +161,7 @@ class QDAFFViewerWindow : public QMainWindow {
 	int m_iShowRecordIndex;                                          //!< Show DAFF record index / data of file
 
 	void RestoreWindowSize();
+	void DiscardComparison();
 };
 
 #endif  // QDAFFVIEWERWINDOW_H
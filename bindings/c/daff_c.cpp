@@ -0,0 +1,893 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#include "daff_c.h"
+
+#include <DAFF.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+// The constants of the C interface are part of its ABI and must match the library
+static_assert(DAFFC_IMPULSE_RESPONSE == DAFF_IMPULSE_RESPONSE, "Content type mismatch");
+static_assert(DAFFC_MAGNITUDE_SPECTRUM == DAFF_MAGNITUDE_SPECTRUM, "Content type mismatch");
+static_assert(DAFFC_PHASE_SPECTRUM == DAFF_PHASE_SPECTRUM, "Content type mismatch");
+static_assert(DAFFC_MAGNITUDE_PHASE_SPECTRUM == DAFF_MAGNITUDE_PHASE_SPECTRUM, "Content type mismatch");
+static_assert(DAFFC_DFT_SPECTRUM == DAFF_DFT_SPECTRUM, "Content type mismatch");
+static_assert(DAFFC_QUANTIZATION_INT16 == DAFF_INT16, "Quantization mismatch");
+static_assert(DAFFC_QUANTIZATION_INT24 == DAFF_INT24, "Quantization mismatch");
+static_assert(DAFFC_QUANTIZATION_FLOAT32 == DAFF_FLOAT32, "Quantization mismatch");
+static_assert(DAFFC_QUANTIZATION_FLOAT16 == DAFF_FLOAT16, "Quantization mismatch");
+static_assert(DAFFC_QUANTIZATION_BFLOAT16 == DAFF_BFLOAT16, "Quantization mismatch");
+static_assert(DAFFC_QUANTIZATION_INT16_BFP == DAFF_INT16_BFP, "Quantization mismatch");
+static_assert(DAFFC_DATA_VIEW == DAFF_DATA_VIEW && DAFFC_OBJECT_VIEW == DAFF_OBJECT_VIEW, "View mismatch");
+static_assert(DAFFC_OPEN_DEFAULT == DAFF_OPEN_DEFAULT && DAFFC_OPEN_MAPPED == DAFF_OPEN_MAPPED, "Open flag mismatch");
+static_assert(DAFFC_OPEN_LAZY == DAFF_OPEN_LAZY && DAFFC_OPEN_DECODE == DAFF_OPEN_DECODE, "Open flag mismatch");
+static_assert(DAFFC_OPEN_TRUNCATE == DAFF_OPEN_TRUNCATE && DAFFC_OPEN_VERIFY == DAFF_OPEN_VERIFY, "Open flag mismatch");
+static_assert(DAFFC_OPEN_SLICES == DAFF_OPEN_SLICES && DAFFC_OPEN_STREAM == DAFF_OPEN_STREAM, "Open flag mismatch");
+
+// Thread-local storage for error messages
+static thread_local std::string g_lastError;
+
+static void SetLastError(const std::string& error)
+{
+	g_lastError = error;
+}
+
+// Data source that forwards to the callbacks of a DAFFCSource
+class CallbackSource : public DAFFDataSource {
+  public:
+	inline CallbackSource(const DAFFCSource& source) : m_source(source) {}
+
+	inline uint64_t getSize() const { return m_source.size; }
+
+	inline int read(uint64_t offset, void* dest, size_t nBytes)
+	{
+		return (m_source.read(m_source.userData, offset, dest, nBytes) == 0) ? DAFF_NO_ERROR : DAFF_FILE_CORRUPTED;
+	}
+
+	inline const char* map() { return static_cast<const char*>(m_source.data); }
+
+  private:
+	DAFFCSource m_source;
+};
+
+// Object behind a reader handle
+struct DAFFCReader {
+	DAFFReader* reader;
+	CallbackSource* source;  // Source of the opened content (DAFFC_OpenSource) or nullptr
+};
+
+// Returns the reader of a handle (nullptr for a null handle)
+static DAFFReader* GetReader(DAFFCReaderHandle handle)
+{
+	return handle ? static_cast<DAFFCReader*>(handle)->reader : nullptr;
+}
+
+int DAFFC_GetABIVersion()
+{
+	return DAFFC_ABI_VERSION;
+}
+
+const char* DAFFC_GetLastError()
+{
+	return g_lastError.c_str();
+}
+
+// Reader operations
+DAFFCReaderHandle DAFFC_Create()
+{
+	try {
+		DAFFCReader* object = new DAFFCReader;
+		object->reader = DAFFReader::create();
+		object->source = nullptr;
+		return static_cast<DAFFCReaderHandle>(object);
+	} catch (const std::exception& e) {
+		SetLastError(e.what());
+		return nullptr;
+	}
+}
+
+void DAFFC_Destroy(DAFFCReaderHandle handle)
+{
+	if (handle) {
+		DAFFCReader* object = static_cast<DAFFCReader*>(handle);
+		delete object->reader;
+		delete object->source;
+		delete object;
+	}
+}
+
+bool DAFFC_OpenFile(DAFFCReaderHandle handle, const char* filename)
+{
+	return DAFFC_OpenFileWithFlags(handle, filename, DAFF_OPEN_DEFAULT);
+}
+
+bool DAFFC_OpenFileWithFlags(DAFFCReaderHandle handle, const char* filename, int flags)
+{
+	if (!handle || !filename) {
+		SetLastError("Invalid handle or filename");
+		return false;
+	}
+	try {
+		DAFFReader* reader = GetReader(handle);
+		int result = reader->openFile(filename, flags);
+		if (result != DAFF_NO_ERROR) {
+			SetLastError("Failed to open file: " + std::string(filename) + " (" + DAFFUtils::StrError(result) + ")");
+			return false;
+		}
+		return true;
+	} catch (const std::exception& e) {
+		SetLastError(e.what());
+		return false;
+	}
+}
+
+bool DAFFC_OpenSource(DAFFCReaderHandle handle, const DAFFCSource* source, int flags)
+{
+	if (!handle || !source || !source->read) {
+		SetLastError("Invalid handle or source");
+		return false;
+	}
+	DAFFCReader* object = static_cast<DAFFCReader*>(handle);
+	CallbackSource* callbackSource = nullptr;
+	try {
+		callbackSource = new CallbackSource(*source);
+		int result = object->reader->openSource(callbackSource, flags & ~DAFF_OPEN_MAPPED);
+		if (result != DAFF_NO_ERROR) {
+			delete callbackSource;
+			SetLastError("Failed to open source (" + DAFFUtils::StrError(result) + ")");
+			return false;
+		}
+	} catch (const std::exception& e) {
+		delete callbackSource;
+		SetLastError(e.what());
+		return false;
+	}
+
+	// The reader accesses the source until it is closed (lazy loading, in-place data)
+	object->source = callbackSource;
+	return true;
+}
+
+void DAFFC_Close(DAFFCReaderHandle handle)
+{
+	if (handle) {
+		DAFFCReader* object = static_cast<DAFFCReader*>(handle);
+		object->reader->closeFile();
+		delete object->source;
+		object->source = nullptr;
+	}
+}
+
+bool DAFFC_IsValid(DAFFCReaderHandle handle)
+{
+	if (!handle)
+		return false;
+	DAFFReader* reader = GetReader(handle);
+	return reader->isValid();
+}
+
+// File properties
+int DAFFC_GetContentType(DAFFCReaderHandle handle)
+{
+	if (!handle)
+		return -1;
+	DAFFReader* reader = GetReader(handle);
+	return reader->getProperties()->getContentType();
+}
+
+int DAFFC_GetQuantization(DAFFCReaderHandle handle)
+{
+	if (!handle)
+		return -1;
+	DAFFReader* reader = GetReader(handle);
+	return reader->getProperties()->getQuantization();
+}
+
+int DAFFC_GetNumChannels(DAFFCReaderHandle handle)
+{
+	if (!handle)
+		return -1;
+	DAFFReader* reader = GetReader(handle);
+	return reader->getProperties()->getNumberOfChannels();
+}
+
+int DAFFC_GetNumRecords(DAFFCReaderHandle handle)
+{
+	if (!handle)
+		return -1;
+	DAFFReader* reader = GetReader(handle);
+	return reader->getProperties()->getNumberOfRecords();
+}
+
+float DAFFC_GetAlphaResolution(DAFFCReaderHandle handle)
+{
+	if (!handle)
+		return -1.0f;
+	DAFFReader* reader = GetReader(handle);
+	return reader->getProperties()->getAlphaResolution();
+}
+
+float DAFFC_GetBetaResolution(DAFFCReaderHandle handle)
+{
+	if (!handle)
+		return -1.0f;
+	DAFFReader* reader = GetReader(handle);
+	return reader->getProperties()->getBetaResolution();
+}
+
+int DAFFC_GetAlphaPoints(DAFFCReaderHandle handle)
+{
+	if (!handle)
+		return -1;
+	DAFFReader* reader = GetReader(handle);
+	return reader->getProperties()->getAlphaPoints();
+}
+
+int DAFFC_GetBetaPoints(DAFFCReaderHandle handle)
+{
+	if (!handle)
+		return -1;
+	DAFFReader* reader = GetReader(handle);
+	return reader->getProperties()->getBetaPoints();
+}
+
+int DAFFC_GetOrientationYPR(DAFFCReaderHandle handle, float* yaw, float* pitch, float* roll)
+{
+	if (!handle || !yaw || !pitch || !roll)
+		return -1;
+	DAFFReader* reader = GetReader(handle);
+	DAFFOrientationYPR o;
+	reader->getProperties()->getOrientation(o);
+	*yaw = o.fYawAngleDeg;
+	*pitch = o.fPitchAngleDeg;
+	*roll = o.fRollAngleDeg;
+	return 0;
+}
+
+int DAFFC_GetMemoryFootprint(DAFFCReaderHandle handle, DAFFCMemoryFootprint* footprint)
+{
+	if (!handle || !footprint)
+		return -1;
+	DAFFReader* reader = GetReader(handle);
+	DAFFMemoryFootprint f;
+	reader->getMemoryFootprint(f);
+	footprint->headers = f.ui64Headers;
+	footprint->recordDescriptors = f.ui64RecordDescriptors;
+	footprint->recordData = f.ui64RecordData;
+	footprint->recordCache = f.ui64RecordCache;
+	footprint->metadata = f.ui64Metadata;
+	footprint->statistics = f.ui64Statistics;
+	footprint->total = f.ui64Total;
+	footprint->mapped = f.ui64Mapped;
+	return 0;
+}
+
+// Metadata operations
+bool DAFFC_HasMetadata(DAFFCReaderHandle handle, const char* key)
+{
+	if (!handle || !key)
+		return false;
+	DAFFReader* reader = GetReader(handle);
+	return reader->getMetadata()->hasKey(key);
+}
+
+const char* DAFFC_GetMetadataString(DAFFCReaderHandle handle, const char* key)
+{
+	if (!handle || !key)
+		return nullptr;
+	DAFFReader* reader = GetReader(handle);
+	if (!reader->getMetadata()->hasKey(key))
+		return nullptr;
+	static thread_local std::string value;
+	value = reader->getMetadata()->getKeyString(key);
+	return value.c_str();
+}
+
+bool DAFFC_GetMetadataFloat(DAFFCReaderHandle handle, const char* key, float* value)
+{
+	if (!handle || !key || !value)
+		return false;
+	DAFFReader* reader = GetReader(handle);
+	if (!reader->getMetadata()->hasKey(key))
+		return false;
+	*value = static_cast<float>(reader->getMetadata()->getKeyFloat(key));
+	return true;
+}
+
+bool DAFFC_GetMetadataBool(DAFFCReaderHandle handle, const char* key, bool* value)
+{
+	if (!handle || !key || !value)
+		return false;
+	DAFFReader* reader = GetReader(handle);
+	if (!reader->getMetadata()->hasKey(key))
+		return false;
+	*value = reader->getMetadata()->getKeyBool(key);
+	return true;
+}
+
+// Content access - Impulse Response (IR)
+DAFFCContentHandle DAFFC_GetContentIR(DAFFCReaderHandle handle)
+{
+	if (!handle)
+		return nullptr;
+	DAFFReader* reader = GetReader(handle);
+	if (reader->getProperties()->getContentType() != DAFF_IMPULSE_RESPONSE)
+		return nullptr;
+	return static_cast<DAFFCContentHandle>(dynamic_cast<DAFFContentIR*>(reader->getContent()));
+}
+
+int DAFFC_ContentIR_GetFilterLength(DAFFCContentHandle content)
+{
+	if (!content)
+		return -1;
+	DAFFContentIR* ir = static_cast<DAFFContentIR*>(content);
+	return ir->getFilterLength();
+}
+
+int DAFFC_ContentIR_GetSamplerate(DAFFCContentHandle content)
+{
+	if (!content)
+		return -1;
+	DAFFContentIR* ir = static_cast<DAFFContentIR*>(content);
+	return ir->getSamplerate();
+}
+
+int DAFFC_ContentIR_GetNearestNeighbour(DAFFCContentHandle content, double phi, double theta)
+{
+	if (!content)
+		return -1;
+	DAFFContentIR* ir = static_cast<DAFFContentIR*>(content);
+	int recordIndex;
+	ir->getNearestNeighbour(DAFF_OBJECT_VIEW, static_cast<float>(phi), static_cast<float>(theta), recordIndex);
+	return recordIndex;
+}
+
+bool DAFFC_ContentIR_GetRecordCoords(DAFFCContentHandle content, int recordIndex, double* alpha, double* beta)
+{
+	if (!content || !alpha || !beta)
+		return false;
+	DAFFContentIR* ir = static_cast<DAFFContentIR*>(content);
+	float fAlpha, fBeta;
+	ir->getRecordCoords(recordIndex, DAFF_DATA_VIEW, fAlpha, fBeta);
+	*alpha = fAlpha;
+	*beta = fBeta;
+	return true;
+}
+
+bool DAFFC_ContentIR_GetFilterCoeffs(DAFFCContentHandle content, int recordIndex, int channel, float* coeffs,
+									 int bufferSize)
+{
+	if (!content || !coeffs)
+		return false;
+	DAFFContentIR* ir = static_cast<DAFFContentIR*>(content);
+	if (bufferSize < ir->getFilterLength())
+		return false;
+	ir->getFilterCoeffs(recordIndex, channel, coeffs);
+	return true;
+}
+
+// Content access - Magnitude Spectrum (MS)
+DAFFCContentHandle DAFFC_GetContentMS(DAFFCReaderHandle handle)
+{
+	if (!handle)
+		return nullptr;
+	DAFFReader* reader = GetReader(handle);
+	if (reader->getProperties()->getContentType() != DAFF_MAGNITUDE_SPECTRUM)
+		return nullptr;
+	return static_cast<DAFFCContentHandle>(dynamic_cast<DAFFContentMS*>(reader->getContent()));
+}
+
+int DAFFC_ContentMS_GetNumFrequencies(DAFFCContentHandle content)
+{
+	if (!content)
+		return -1;
+	DAFFContentMS* ms = static_cast<DAFFContentMS*>(content);
+	return ms->getNumFrequencies();
+}
+
+int DAFFC_ContentMS_GetNearestNeighbour(DAFFCContentHandle content, double phi, double theta)
+{
+	if (!content)
+		return -1;
+	DAFFContentMS* ms = static_cast<DAFFContentMS*>(content);
+	int recordIndex;
+	ms->getNearestNeighbour(DAFF_OBJECT_VIEW, static_cast<float>(phi), static_cast<float>(theta), recordIndex);
+	return recordIndex;
+}
+
+bool DAFFC_ContentMS_GetRecordCoords(DAFFCContentHandle content, int recordIndex, double* alpha, double* beta)
+{
+	if (!content || !alpha || !beta)
+		return false;
+	DAFFContentMS* ms = static_cast<DAFFContentMS*>(content);
+	float fAlpha, fBeta;
+	ms->getRecordCoords(recordIndex, DAFF_DATA_VIEW, fAlpha, fBeta);
+	*alpha = fAlpha;
+	*beta = fBeta;
+	return true;
+}
+
+bool DAFFC_ContentMS_GetMagnitudes(DAFFCContentHandle content, int recordIndex, int channel, float* magnitudes,
+								   int bufferSize)
+{
+	if (!content || !magnitudes)
+		return false;
+	DAFFContentMS* ms = static_cast<DAFFContentMS*>(content);
+	if (bufferSize < ms->getNumFrequencies())
+		return false;
+	ms->getMagnitudes(recordIndex, channel, magnitudes);
+	return true;
+}
+
+// Content access - Phase Spectrum (PS)
+DAFFCContentHandle DAFFC_GetContentPS(DAFFCReaderHandle handle)
+{
+	if (!handle)
+		return nullptr;
+	DAFFReader* reader = GetReader(handle);
+	if (reader->getProperties()->getContentType() != DAFF_PHASE_SPECTRUM)
+		return nullptr;
+	return static_cast<DAFFCContentHandle>(dynamic_cast<DAFFContentPS*>(reader->getContent()));
+}
+
+int DAFFC_ContentPS_GetNumFrequencies(DAFFCContentHandle content)
+{
+	if (!content)
+		return -1;
+	DAFFContentPS* ps = static_cast<DAFFContentPS*>(content);
+	return ps->getNumFrequencies();
+}
+
+int DAFFC_ContentPS_GetNearestNeighbour(DAFFCContentHandle content, double phi, double theta)
+{
+	if (!content)
+		return -1;
+	DAFFContentPS* ps = static_cast<DAFFContentPS*>(content);
+	int recordIndex;
+	ps->getNearestNeighbour(DAFF_OBJECT_VIEW, static_cast<float>(phi), static_cast<float>(theta), recordIndex);
+	return recordIndex;
+}
+
+bool DAFFC_ContentPS_GetRecordCoords(DAFFCContentHandle content, int recordIndex, double* alpha, double* beta)
+{
+	if (!content || !alpha || !beta)
+		return false;
+	DAFFContentPS* ps = static_cast<DAFFContentPS*>(content);
+	float fAlpha, fBeta;
+	ps->getRecordCoords(recordIndex, DAFF_DATA_VIEW, fAlpha, fBeta);
+	*alpha = fAlpha;
+	*beta = fBeta;
+	return true;
+}
+
+bool DAFFC_ContentPS_GetPhases(DAFFCContentHandle content, int recordIndex, int channel, float* phases, int bufferSize)
+{
+	if (!content || !phases)
+		return false;
+	DAFFContentPS* ps = static_cast<DAFFContentPS*>(content);
+	if (bufferSize < ps->getNumFrequencies())
+		return false;
+	ps->getPhases(recordIndex, channel, phases);
+	return true;
+}
+
+// Content access - Magnitude-Phase Spectrum (MPS)
+DAFFCContentHandle DAFFC_GetContentMPS(DAFFCReaderHandle handle)
+{
+	if (!handle)
+		return nullptr;
+	DAFFReader* reader = GetReader(handle);
+	if (reader->getProperties()->getContentType() != DAFF_MAGNITUDE_PHASE_SPECTRUM)
+		return nullptr;
+	return static_cast<DAFFCContentHandle>(dynamic_cast<DAFFContentMPS*>(reader->getContent()));
+}
+
+int DAFFC_ContentMPS_GetNumFrequencies(DAFFCContentHandle content)
+{
+	if (!content)
+		return -1;
+	DAFFContentMPS* mps = static_cast<DAFFContentMPS*>(content);
+	return mps->getNumFrequencies();
+}
+
+int DAFFC_ContentMPS_GetNearestNeighbour(DAFFCContentHandle content, double phi, double theta)
+{
+	if (!content)
+		return -1;
+	DAFFContentMPS* mps = static_cast<DAFFContentMPS*>(content);
+	int recordIndex;
+	mps->getNearestNeighbour(DAFF_OBJECT_VIEW, static_cast<float>(phi), static_cast<float>(theta), recordIndex);
+	return recordIndex;
+}
+
+bool DAFFC_ContentMPS_GetRecordCoords(DAFFCContentHandle content, int recordIndex, double* alpha, double* beta)
+{
+	if (!content || !alpha || !beta)
+		return false;
+	DAFFContentMPS* mps = static_cast<DAFFContentMPS*>(content);
+	float fAlpha, fBeta;
+	mps->getRecordCoords(recordIndex, DAFF_DATA_VIEW, fAlpha, fBeta);
+	*alpha = fAlpha;
+	*beta = fBeta;
+	return true;
+}
+
+bool DAFFC_ContentMPS_GetCoefficients(DAFFCContentHandle content, int recordIndex, int channel, float* magnitudes,
+									  float* phases, int bufferSize)
+{
+	if (!content || !magnitudes || !phases)
+		return false;
+	DAFFContentMPS* mps = static_cast<DAFFContentMPS*>(content);
+	int numFreqs = mps->getNumFrequencies();
+	if (bufferSize < numFreqs)
+		return false;
+
+	// Allocate temporary buffer for interleaved data (Mag[0], Ph[0], Mag[1], Ph[1], ...)
+	std::vector<float> interleaved(numFreqs * 2);
+	int result = mps->getCoefficientsMP(recordIndex, channel, interleaved.data());
+	if (result != DAFF_NO_ERROR)
+		return false;
+
+	// De-interleave into separate magnitude and phase arrays
+	for (int i = 0; i < numFreqs; i++) {
+		magnitudes[i] = interleaved[i * 2];
+		phases[i] = interleaved[i * 2 + 1];
+	}
+
+	return true;
+}
+
+// Content access - DFT
+DAFFCContentHandle DAFFC_GetContentDFT(DAFFCReaderHandle handle)
+{
+	if (!handle)
+		return nullptr;
+	DAFFReader* reader = GetReader(handle);
+	if (reader->getProperties()->getContentType() != DAFF_DFT_SPECTRUM)
+		return nullptr;
+	return static_cast<DAFFCContentHandle>(dynamic_cast<DAFFContentDFT*>(reader->getContent()));
+}
+
+int DAFFC_ContentDFT_GetNumDFTCoeffs(DAFFCContentHandle content)
+{
+	if (!content)
+		return -1;
+	DAFFContentDFT* dft = static_cast<DAFFContentDFT*>(content);
+	return dft->getNumDFTCoeffs();
+}
+
+bool DAFFC_ContentDFT_IsSymmetric(DAFFCContentHandle content)
+{
+	if (!content)
+		return false;
+	DAFFContentDFT* dft = static_cast<DAFFContentDFT*>(content);
+	return dft->isSymmetric();
+}
+
+int DAFFC_ContentDFT_GetNearestNeighbour(DAFFCContentHandle content, double phi, double theta)
+{
+	if (!content)
+		return -1;
+	DAFFContentDFT* dft = static_cast<DAFFContentDFT*>(content);
+	int recordIndex;
+	dft->getNearestNeighbour(DAFF_OBJECT_VIEW, static_cast<float>(phi), static_cast<float>(theta), recordIndex);
+	return recordIndex;
+}
+
+bool DAFFC_ContentDFT_GetRecordCoords(DAFFCContentHandle content, int recordIndex, double* alpha, double* beta)
+{
+	if (!content || !alpha || !beta)
+		return false;
+	DAFFContentDFT* dft = static_cast<DAFFContentDFT*>(content);
+	float fAlpha, fBeta;
+	dft->getRecordCoords(recordIndex, DAFF_DATA_VIEW, fAlpha, fBeta);
+	*alpha = fAlpha;
+	*beta = fBeta;
+	return true;
+}
+
+bool DAFFC_ContentDFT_GetDFTCoeffs(DAFFCContentHandle content, int recordIndex, int channel, float* coeffs,
+								   int bufferSize)
+{
+	if (!content || !coeffs)
+		return false;
+	DAFFContentDFT* dft = static_cast<DAFFContentDFT*>(content);
+	if (bufferSize < dft->getNumDFTCoeffs() * 2)
+		return false;  // DFT coeffs are complex (real, imag)
+	dft->getDFTCoeffs(recordIndex, channel, coeffs);
+	return true;
+}
+
+bool DAFFC_ContentDFT_GetDFTCoeffsFull(DAFFCContentHandle content, int recordIndex, int channel, float* coeffs,
+									   int bufferSize)
+{
+	if (!content || !coeffs)
+		return false;
+	DAFFContentDFT* dft = static_cast<DAFFContentDFT*>(content);
+	if (bufferSize < dft->getTransformSize() * 2)
+		return false;  // DFT coeffs are complex (real, imag)
+	return (dft->getDFTCoeffsFull(recordIndex, channel, coeffs) == DAFF_NO_ERROR);
+}
+
+// Batch access - all content types
+
+// Returns the opened reader of a handle (nullptr and the last error otherwise)
+static DAFFReader* GetOpenedReader(DAFFCReaderHandle handle)
+{
+	DAFFReader* reader = GetReader(handle);
+	if (!reader || !reader->isValid()) {
+		SetLastError("No file or source opened");
+		return nullptr;
+	}
+	return reader;
+}
+
+// Number of float values per channel of the record data (complex values and magnitude-phase pairs interleaved)
+static int GetRecordLength(DAFFReader* reader)
+{
+	switch (reader->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		return dynamic_cast<DAFFContentIR*>(reader->getContent())->getFilterLength();
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return dynamic_cast<DAFFContentMS*>(reader->getContent())->getNumFrequencies();
+	case DAFF_PHASE_SPECTRUM:
+		return dynamic_cast<DAFFContentPS*>(reader->getContent())->getNumFrequencies();
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		return 2 * dynamic_cast<DAFFContentMPS*>(reader->getContent())->getNumFrequencies();
+	case DAFF_DFT_SPECTRUM:
+		return 2 * dynamic_cast<DAFFContentDFT*>(reader->getContent())->getNumDFTCoeffs();
+	}
+	return 0;
+}
+
+// Channel pointers and record indices of the batch calls, kept per thread to avoid allocations per call
+static thread_local std::vector<float*> g_channels;
+static thread_local std::vector<int> g_recordIndices;
+
+// Copies all channels of a record into consecutive blocks of a destination
+static int GetRecordData(DAFFReader* reader, int recordIndex, float* dest)
+{
+	std::vector<float*>& channels = g_channels;
+	size_t length = GetRecordLength(reader);
+	channels.resize(reader->getProperties()->getNumberOfChannels());
+	for (size_t c = 0; c < channels.size(); c++)
+		channels[c] = dest + c * length;
+
+	DAFFContent* content = reader->getContent();
+	switch (reader->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		return dynamic_cast<DAFFContentIR*>(content)->getRecord(recordIndex, channels.data());
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return dynamic_cast<DAFFContentMS*>(content)->getRecord(recordIndex, channels.data());
+	case DAFF_PHASE_SPECTRUM:
+		return dynamic_cast<DAFFContentPS*>(content)->getRecord(recordIndex, channels.data());
+	case DAFF_DFT_SPECTRUM:
+		return dynamic_cast<DAFFContentDFT*>(content)->getRecord(recordIndex, channels.data());
+	}
+
+	// Magnitude-phase spectra channel by channel
+	for (size_t c = 0; c < channels.size(); c++) {
+		int result = dynamic_cast<DAFFContentMPS*>(content)->getCoefficientsMP(recordIndex, (int)c, channels[c]);
+		if (result != DAFF_NO_ERROR)
+			return result;
+	}
+	return DAFF_NO_ERROR;
+}
+
+// Checks the view of a batch call (false and the last error if invalid)
+static bool CheckView(int view)
+{
+	if ((view != DAFF_DATA_VIEW) && (view != DAFF_OBJECT_VIEW)) {
+		SetLastError("Invalid view");
+		return false;
+	}
+	return true;
+}
+
+// Checks the destination of a batch call, returns the number of float values per record (0 and the last error if
+// the destination is too small)
+static size_t GetRecordSize(DAFFReader* reader, size_t count, const float* dest, size_t bufferSize)
+{
+	size_t recordSize = (size_t)reader->getProperties()->getNumberOfChannels() * GetRecordLength(reader);
+	if ((recordSize == 0) || ((count > 0) && !dest) || (bufferSize < count * recordSize)) {
+		SetLastError("Destination buffer too small");
+		return 0;
+	}
+	return recordSize;
+}
+
+int DAFFC_GetRecordLength(DAFFCReaderHandle handle)
+{
+	DAFFReader* reader = GetOpenedReader(handle);
+	if (!reader)
+		return -1;
+	return GetRecordLength(reader);
+}
+
+bool DAFFC_GetNearestNeighbours(DAFFCReaderHandle handle, int view, const float* angles1, const float* angles2,
+								int* recordIndices, bool* outOfBounds, size_t count)
+{
+	DAFFReader* reader = GetOpenedReader(handle);
+	if (!reader || !CheckView(view))
+		return false;
+	if ((count > 0) && (!angles1 || !angles2 || !recordIndices)) {
+		SetLastError("Invalid buffers");
+		return false;
+	}
+	reader->getContent()->getNearestNeighbours(view, angles1, angles2, recordIndices, outOfBounds, count);
+	return true;
+}
+
+bool DAFFC_GetRecords(DAFFCReaderHandle handle, const int* recordIndices, size_t count, float* dest, size_t bufferSize)
+{
+	DAFFReader* reader = GetOpenedReader(handle);
+	if (!reader)
+		return false;
+	size_t recordSize = GetRecordSize(reader, count, dest, bufferSize);
+	if (recordSize == 0)
+		return false;
+	if ((count > 0) && !recordIndices) {
+		SetLastError("Invalid buffers");
+		return false;
+	}
+
+	try {
+		int numRecords = reader->getProperties()->getNumberOfRecords();
+		for (size_t i = 0; i < count; i++) {
+			if ((recordIndices[i] < 0) || (recordIndices[i] >= numRecords)) {
+				SetLastError("Invalid record index");
+				return false;
+			}
+			int result = GetRecordData(reader, recordIndices[i], dest + i * recordSize);
+			if (result != DAFF_NO_ERROR) {
+				SetLastError(DAFFUtils::StrError(result));
+				return false;
+			}
+		}
+		return true;
+	} catch (const std::exception& e) {
+		SetLastError(e.what());
+		return false;
+	}
+}
+
+bool DAFFC_GetNearestNeighbourRecords(DAFFCReaderHandle handle, int view, const float* angles1,
+									  const float* angles2, size_t count, int* recordIndices, float* dest,
+										 size_t bufferSize)
+{
+	DAFFReader* reader = GetOpenedReader(handle);
+	if (!reader || !CheckView(view))
+		return false;
+	size_t recordSize = GetRecordSize(reader, count, dest, bufferSize);
+	if (recordSize == 0)
+		return false;
+	if ((count > 0) && (!angles1 || !angles2)) {
+		SetLastError("Invalid buffers");
+		return false;
+	}
+
+	try {
+		// One batch lookup, into the indices of the caller if given
+		if (!recordIndices) {
+			g_recordIndices.resize(count);
+			recordIndices = g_recordIndices.data();
+		}
+		reader->getContent()->getNearestNeighbours(view, angles1, angles2, recordIndices, nullptr, count);
+
+		for (size_t i = 0; i < count; i++) {
+			int result = GetRecordData(reader, recordIndices[i], dest + i * recordSize);
+			if (result != DAFF_NO_ERROR) {
+				SetLastError(DAFFUtils::StrError(result));
+				return false;
+			}
+		}
+		return true;
+	} catch (const std::exception& e) {
+		SetLastError(e.what());
+		return false;
+	}
+}
+
+bool DAFFC_GetInterpolatedRecords(DAFFCReaderHandle handle, int view, const float* angles1, const float* angles2,
+								  size_t count, float* dest, size_t bufferSize)
+{
+	DAFFReader* reader = GetOpenedReader(handle);
+	if (!reader || !CheckView(view))
+		return false;
+	DAFFInterpolator interpolator(reader->getContent());
+	size_t length = interpolator.getDataLength();
+	if (length == 0) {
+		SetLastError("Interpolation requires impulse responses, magnitude spectra or DFT spectra");
+		return false;
+	}
+	size_t recordSize = GetRecordSize(reader, count, dest, bufferSize);
+	if (recordSize == 0)
+		return false;
+	if ((count > 0) && (!angles1 || !angles2)) {
+		SetLastError("Invalid buffers");
+		return false;
+	}
+
+	int numChannels = reader->getProperties()->getNumberOfChannels();
+	for (size_t i = 0; i < count; i++) {
+		for (int c = 0; c < numChannels; c++) {
+			int result = interpolator.interpolate(view, angles1[i], angles2[i], c, dest + i * recordSize + c * length);
+			if (result != DAFF_NO_ERROR) {
+				SetLastError(DAFFUtils::StrError(result));
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool DAFFC_GetRecordRange(DAFFCReaderHandle handle, int firstRecord, size_t count, float* dest, size_t bufferSize)
+{
+	DAFFReader* reader = GetOpenedReader(handle);
+	if (!reader)
+		return false;
+	size_t recordSize = GetRecordSize(reader, count, dest, bufferSize);
+	if (recordSize == 0)
+		return false;
+	size_t numRecords = (size_t)reader->getProperties()->getNumberOfRecords();
+	if ((firstRecord < 0) || ((size_t)firstRecord > numRecords) || (count > numRecords - firstRecord)) {
+		SetLastError("Invalid record range");
+		return false;
+	}
+
+	try {
+		for (size_t i = 0; i < count; i++) {
+			int result = GetRecordData(reader, firstRecord + (int)i, dest + i * recordSize);
+			if (result != DAFF_NO_ERROR) {
+				SetLastError(DAFFUtils::StrError(result));
+				return false;
+			}
+		}
+		return true;
+	} catch (const std::exception& e) {
+		SetLastError(e.what());
+		return false;
+	}
+}
+
+// Zero-copy access
+const float* DAFFC_GetRecordChannelPtr(DAFFCReaderHandle handle, int recordIndex, int channel, int* offset,
+									   int* numValues)
+{
+	DAFFReader* reader = GetReader(handle);
+	if (!reader || !offset || !numValues || !reader->isValid())
+		return nullptr;
+	if (reader->isLazy())
+		return nullptr;  // Lazily loaded data is only valid until the next access
+	const DAFFProperties* properties = reader->getProperties();
+	if ((recordIndex < 0) || (recordIndex >= properties->getNumberOfRecords()) || (channel < 0) ||
+		(channel >= properties->getNumberOfChannels()))
+		return nullptr;
+	*offset = 0;
+	*numValues = GetRecordLength(reader);
+
+	DAFFContent* content = reader->getContent();
+	switch (reader->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		return dynamic_cast<DAFFContentIR*>(content)->getEffectiveFilterCoeffsPtr(recordIndex, channel, *offset,
+																				  *numValues);
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return dynamic_cast<DAFFContentMS*>(content)->getMagnitudesPtr(recordIndex, channel);
+	case DAFF_PHASE_SPECTRUM:
+		return dynamic_cast<DAFFContentPS*>(content)->getPhasesPtr(recordIndex, channel);
+	case DAFF_DFT_SPECTRUM:
+		return dynamic_cast<DAFFContentDFT*>(content)->getDFTCoeffsPtr(recordIndex, channel);
+	}
+	return nullptr;  // No zero-copy access to magnitude-phase spectra
+}
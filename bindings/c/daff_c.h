@@ -0,0 +1,225 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_C
+#define IW_DAFF_C
+
+#if defined WIN32
+#ifdef DAFFC_EXPORTS
+#define DAFFC_API __declspec(dllexport)
+#else
+#define DAFFC_API __declspec(dllimport)
+#endif
+#else
+#define DAFFC_API
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ *  C interface of the DAFF reader (libdaff_c)
+ *
+ *  A plain C ABI over the C++ reader, shared by the language bindings (Go, Rust) and usable
+ *  from any FFI. Only opaque handles, fixed-size integers, floats and caller-owned buffers
+ *  cross the interface, no C++ types and no memory allocated on behalf of the caller.
+ *  Functions are only appended, existing signatures are never changed within an ABI version
+ *  (see DAFFC_GetABIVersion).
+ *
+ *  For low call overhead, the batch functions serve many directions or records per call
+ *  and write into one destination buffer, the zero-copy functions return pointers into the
+ *  loaded record data. Failed calls return false (or a negative value, or NULL) and set a
+ *  message for the calling thread (DAFFC_GetLastError).
+ *
+ *  A reader handle may be used by several threads at once after the file has been opened
+ *  (see DAFFReader), opening and closing must not overlap with other calls.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ABI version, incremented on incompatible changes of the interface
+#define DAFFC_ABI_VERSION 1
+
+// Content types (see DAFF_CONTENT_TYPES)
+#define DAFFC_IMPULSE_RESPONSE 0
+#define DAFFC_MAGNITUDE_SPECTRUM 1
+#define DAFFC_PHASE_SPECTRUM 2
+#define DAFFC_MAGNITUDE_PHASE_SPECTRUM 3
+#define DAFFC_DFT_SPECTRUM 4
+
+// Quantizations (see DAFF_QUANTIZATIONS)
+#define DAFFC_QUANTIZATION_INT16 0
+#define DAFFC_QUANTIZATION_INT24 1
+#define DAFFC_QUANTIZATION_FLOAT32 2
+#define DAFFC_QUANTIZATION_FLOAT16 3
+#define DAFFC_QUANTIZATION_BFLOAT16 4
+#define DAFFC_QUANTIZATION_INT16_BFP 5
+
+// Views (see DAFF_VIEWS)
+#define DAFFC_DATA_VIEW 0
+#define DAFFC_OBJECT_VIEW 1
+
+// Open flags, can be combined (see DAFF_OPEN_FLAGS)
+#define DAFFC_OPEN_DEFAULT 0
+#define DAFFC_OPEN_MAPPED 1
+#define DAFFC_OPEN_LAZY 2
+#define DAFFC_OPEN_DECODE 4
+#define DAFFC_OPEN_TRUNCATE 8
+#define DAFFC_OPEN_VERIFY 16
+#define DAFFC_OPEN_SLICES 32
+#define DAFFC_OPEN_STREAM 64
+
+// Opaque handle types
+typedef void* DAFFCReaderHandle;
+typedef void* DAFFCContentHandle;
+
+// Heap memory held by a reader [Bytes] (see DAFFMemoryFootprint)
+typedef struct {
+	uint64_t headers;
+	uint64_t recordDescriptors;
+	uint64_t recordData;
+	uint64_t recordCache;
+	uint64_t metadata;
+	uint64_t statistics;
+	uint64_t total;
+	uint64_t mapped;
+} DAFFCMemoryFootprint;
+
+// Byte source of DAFF content from custom storage (see DAFFDataSource)
+typedef struct {
+	void* userData;  // Passed to the callbacks
+	uint64_t size;   // Total size of the DAFF content [Bytes]
+
+	// Reads nBytes at an absolute offset into dest, returns 0 if all bytes have been read
+	int (*read)(void* userData, uint64_t offset, void* dest, size_t nBytes);
+
+	// Complete DAFF content in memory, accessed in place (optional, may be NULL)
+	const void* data;
+} DAFFCSource;
+
+// Version and error handling
+DAFFC_API int DAFFC_GetABIVersion();
+DAFFC_API const char* DAFFC_GetLastError();
+
+// Reader operations
+DAFFC_API DAFFCReaderHandle DAFFC_Create();
+DAFFC_API void DAFFC_Destroy(DAFFCReaderHandle handle);
+DAFFC_API bool DAFFC_OpenFile(DAFFCReaderHandle handle, const char* filename);
+DAFFC_API bool DAFFC_OpenFileWithFlags(DAFFCReaderHandle handle, const char* filename, int flags);
+DAFFC_API void DAFFC_Close(DAFFCReaderHandle handle);
+DAFFC_API bool DAFFC_IsValid(DAFFCReaderHandle handle);
+
+// Streaming access - opens DAFF content through the callbacks of a source (copied, the user data must stay valid
+// until the reader is closed). With DAFFC_OPEN_LAZY only the headers are read at once and the record data of the
+// accessed records on demand.
+DAFFC_API bool DAFFC_OpenSource(DAFFCReaderHandle handle, const DAFFCSource* source, int flags);
+
+// File properties
+DAFFC_API int DAFFC_GetContentType(DAFFCReaderHandle handle);
+DAFFC_API int DAFFC_GetQuantization(DAFFCReaderHandle handle);
+DAFFC_API int DAFFC_GetNumChannels(DAFFCReaderHandle handle);
+DAFFC_API int DAFFC_GetNumRecords(DAFFCReaderHandle handle);
+DAFFC_API float DAFFC_GetAlphaResolution(DAFFCReaderHandle handle);
+DAFFC_API float DAFFC_GetBetaResolution(DAFFCReaderHandle handle);
+DAFFC_API int DAFFC_GetAlphaPoints(DAFFCReaderHandle handle);
+DAFFC_API int DAFFC_GetBetaPoints(DAFFCReaderHandle handle);
+DAFFC_API int DAFFC_GetOrientationYPR(DAFFCReaderHandle handle, float* yaw, float* pitch, float* roll);
+DAFFC_API int DAFFC_GetMemoryFootprint(DAFFCReaderHandle handle, DAFFCMemoryFootprint* footprint);
+
+// Metadata operations
+DAFFC_API bool DAFFC_HasMetadata(DAFFCReaderHandle handle, const char* key);
+DAFFC_API const char* DAFFC_GetMetadataString(DAFFCReaderHandle handle, const char* key);
+DAFFC_API bool DAFFC_GetMetadataFloat(DAFFCReaderHandle handle, const char* key, float* value);
+DAFFC_API bool DAFFC_GetMetadataBool(DAFFCReaderHandle handle, const char* key, bool* value);
+
+// Content access - Impulse Response (IR)
+DAFFC_API DAFFCContentHandle DAFFC_GetContentIR(DAFFCReaderHandle handle);
+DAFFC_API int DAFFC_ContentIR_GetFilterLength(DAFFCContentHandle content);
+DAFFC_API int DAFFC_ContentIR_GetSamplerate(DAFFCContentHandle content);
+DAFFC_API int DAFFC_ContentIR_GetNearestNeighbour(DAFFCContentHandle content, double phi, double theta);
+DAFFC_API bool DAFFC_ContentIR_GetRecordCoords(DAFFCContentHandle content, int recordIndex, double* alpha,
+											   double* beta);
+DAFFC_API bool DAFFC_ContentIR_GetFilterCoeffs(DAFFCContentHandle content, int recordIndex, int channel,
+											   float* coeffs, int bufferSize);
+
+// Content access - Magnitude Spectrum (MS)
+DAFFC_API DAFFCContentHandle DAFFC_GetContentMS(DAFFCReaderHandle handle);
+DAFFC_API int DAFFC_ContentMS_GetNumFrequencies(DAFFCContentHandle content);
+DAFFC_API int DAFFC_ContentMS_GetNearestNeighbour(DAFFCContentHandle content, double phi, double theta);
+DAFFC_API bool DAFFC_ContentMS_GetRecordCoords(DAFFCContentHandle content, int recordIndex, double* alpha,
+											   double* beta);
+DAFFC_API bool DAFFC_ContentMS_GetMagnitudes(DAFFCContentHandle content, int recordIndex, int channel,
+											 float* magnitudes, int bufferSize);
+
+// Content access - Phase Spectrum (PS)
+DAFFC_API DAFFCContentHandle DAFFC_GetContentPS(DAFFCReaderHandle handle);
+DAFFC_API int DAFFC_ContentPS_GetNumFrequencies(DAFFCContentHandle content);
+DAFFC_API int DAFFC_ContentPS_GetNearestNeighbour(DAFFCContentHandle content, double phi, double theta);
+DAFFC_API bool DAFFC_ContentPS_GetRecordCoords(DAFFCContentHandle content, int recordIndex, double* alpha,
+											   double* beta);
+DAFFC_API bool DAFFC_ContentPS_GetPhases(DAFFCContentHandle content, int recordIndex, int channel, float* phases,
+										 int bufferSize);
+
+// Content access - Magnitude-Phase Spectrum (MPS)
+DAFFC_API DAFFCContentHandle DAFFC_GetContentMPS(DAFFCReaderHandle handle);
+DAFFC_API int DAFFC_ContentMPS_GetNumFrequencies(DAFFCContentHandle content);
+DAFFC_API int DAFFC_ContentMPS_GetNearestNeighbour(DAFFCContentHandle content, double phi, double theta);
+DAFFC_API bool DAFFC_ContentMPS_GetRecordCoords(DAFFCContentHandle content, int recordIndex, double* alpha,
+												double* beta);
+DAFFC_API bool DAFFC_ContentMPS_GetCoefficients(DAFFCContentHandle content, int recordIndex, int channel,
+												float* magnitudes, float* phases, int bufferSize);
+
+// Content access - DFT
+DAFFC_API DAFFCContentHandle DAFFC_GetContentDFT(DAFFCReaderHandle handle);
+DAFFC_API int DAFFC_ContentDFT_GetNumDFTCoeffs(DAFFCContentHandle content);
+DAFFC_API bool DAFFC_ContentDFT_IsSymmetric(DAFFCContentHandle content);
+DAFFC_API int DAFFC_ContentDFT_GetNearestNeighbour(DAFFCContentHandle content, double phi, double theta);
+DAFFC_API bool DAFFC_ContentDFT_GetRecordCoords(DAFFCContentHandle content, int recordIndex, double* alpha,
+												double* beta);
+DAFFC_API bool DAFFC_ContentDFT_GetDFTCoeffs(DAFFCContentHandle content, int recordIndex, int channel, float* coeffs,
+											 int bufferSize);
+// Full spectrum of getTransformSize() coefficients, symmetric spectra expanded by their conjugate mirror image
+DAFFC_API bool DAFFC_ContentDFT_GetDFTCoeffsFull(DAFFCContentHandle content, int recordIndex, int channel,
+												 float* coeffs, int bufferSize);
+
+// Batch access - all content types (views: DAFFC_DATA_VIEW, DAFFC_OBJECT_VIEW; angles in degrees)
+// Records are written as [count][channels][GetRecordLength()] floats into one destination buffer of bufferSize
+// floats (complex values and magnitude-phase pairs interleaved)
+DAFFC_API int DAFFC_GetRecordLength(DAFFCReaderHandle handle);
+DAFFC_API bool DAFFC_GetNearestNeighbours(DAFFCReaderHandle handle, int view, const float* angles1,
+										  const float* angles2, int* recordIndices, bool* outOfBounds, size_t count);
+DAFFC_API bool DAFFC_GetRecords(DAFFCReaderHandle handle, const int* recordIndices, size_t count, float* dest,
+								size_t bufferSize);
+DAFFC_API bool DAFFC_GetNearestNeighbourRecords(DAFFCReaderHandle handle, int view, const float* angles1,
+												const float* angles2, size_t count, int* recordIndices, float* dest,
+												size_t bufferSize);
+DAFFC_API bool DAFFC_GetInterpolatedRecords(DAFFCReaderHandle handle, int view, const float* angles1,
+											const float* angles2, size_t count, float* dest, size_t bufferSize);
+
+// Streaming fetch - the consecutive records [firstRecord, firstRecord + count) in the layout of the batch access,
+// for processing a whole file chunk by chunk with a fixed buffer
+DAFFC_API bool DAFFC_GetRecordRange(DAFFCReaderHandle handle, int firstRecord, size_t count, float* dest,
+									size_t bufferSize);
+
+// Zero-copy access - borrowed pointer into the record data of a channel, valid until the file is closed
+// (NULL for lazily opened files, magnitude-phase spectra and data that must be converted, e.g. integer
+// impulse responses not opened with DAFFC_OPEN_DECODE). Impulse responses deliver their effective coefficients.
+DAFFC_API const float* DAFFC_GetRecordChannelPtr(DAFFCReaderHandle handle, int recordIndex, int channel, int* offset,
+												 int* numValues);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // IW_DAFF_C
@@ -18,9 +18,41 @@ namespace DAFF
     {
         ImpulseResponse,
         MagnitudeSpectrum,
+        PhaseSpectrum,
+        MagnitudePhaseSpectrum,
+        DFTSpectrum,
         Invalid,
     }
 
+    /// <summary>
+    /// Definition of available quantizations of the record data
+    /// </summary>
+    public enum Quantization
+    {
+        Int16,
+        Int24,
+        Float32,
+        Float16,
+        BFloat16,
+        Int16BFP,
+        Invalid,
+    }
+
+    /// <summary>
+    /// Heap memory held by a reader in bytes, broken down by category
+    /// </summary>
+    public class MemoryFootprint
+    {
+        public ulong Headers;           // File block table, main and content header, frequency list
+        public ulong RecordDescriptors; // Record descriptors, payload indices, record directions and their index
+        public ulong RecordData;        // Record data block and the decoded float arena
+        public ulong RecordCache;       // Record cache and chunk buffer of the lazy loading
+        public ulong Metadata;          // Metadata block and sets
+        public ulong Statistics;        // Record statistics and peak values
+        public ulong Total;             // Sum of the categories above
+        public ulong Mapped;            // Accessed in place, not owned (mapped or borrowed)
+    }
+
     /// <summary>
     ///  The DAFFReader class is used to load a DAFF file and access the fundamental properties such as
     ///  the type of content. Depending on the type, the actual content can be requested and accessd by
@@ -74,10 +106,38 @@ namespace DAFF
                 return ContentType.ImpulseResponse;
             if (NativeContentType == 1)
                 return ContentType.MagnitudeSpectrum;
+            if (NativeContentType == 2)
+                return ContentType.PhaseSpectrum;
+            if (NativeContentType == 3)
+                return ContentType.MagnitudePhaseSpectrum;
+            if (NativeContentType == 4)
+                return ContentType.DFTSpectrum;
             else
                 return ContentType.Invalid;
         }
 
+        /// <summary>
+        /// Returns the heap memory held by the reader, e.g. to budget several loaded files.
+        /// </summary>
+        /// <returns>Memory footprint (all zero if no file is loaded)</returns>
+        public MemoryFootprint GetMemoryFootprint()
+        {
+            ulong[] Bytes = new ulong[8];
+            MemoryFootprint Footprint = new MemoryFootprint();
+            if (!NativeDAFFGetMemoryFootprint(_DAFFHandle, Bytes))
+                return Footprint;
+
+            Footprint.Headers = Bytes[0];
+            Footprint.RecordDescriptors = Bytes[1];
+            Footprint.RecordData = Bytes[2];
+            Footprint.RecordCache = Bytes[3];
+            Footprint.Metadata = Bytes[4];
+            Footprint.Statistics = Bytes[5];
+            Footprint.Total = Bytes[6];
+            Footprint.Mapped = Bytes[7];
+            return Footprint;
+        }
+
         /// <summary>
         /// Returns content of DAFF file as impulse response time domain data (for HRIRs etc. ... and only if content type matches)
         /// </summary>
@@ -96,6 +156,211 @@ namespace DAFF
             return new MS(_DAFFHandle); ;
         }
 
+        /// <summary>
+        /// Returns content of DAFF file as phase spectrum data (only if content type matches)
+        /// </summary>
+        /// <returns>PS content type</returns>
+        public PS GetContentPS()
+        {
+            return new PS(_DAFFHandle);
+        }
+
+        /// <summary>
+        /// Returns content of DAFF file as discrete Fourier spectrum data (only if content type matches)
+        /// </summary>
+        /// <returns>DFT content type</returns>
+        public DFT GetContentDFT()
+        {
+            return new DFT(_DAFFHandle);
+        }
+
+        /// <summary>
+        /// Returns the quantization of the record data, see also Quantization enumeration.
+        /// </summary>
+        /// <returns>Quantization (Invalid if no file is loaded)</returns>
+        public Quantization GetQuantization()
+        {
+            int NativeQuantization = NativeDAFFGetQuantization(_DAFFHandle);
+            if (NativeQuantization == 0)
+                return Quantization.Int16;
+            if (NativeQuantization == 1)
+                return Quantization.Int24;
+            if (NativeQuantization == 2)
+                return Quantization.Float32;
+            if (NativeQuantization == 3)
+                return Quantization.Float16;
+            if (NativeQuantization == 4)
+                return Quantization.BFloat16;
+            if (NativeQuantization == 5)
+                return Quantization.Int16BFP;
+            else
+                return Quantization.Invalid;
+        }
+
+        /// <summary>
+        /// Returns the number of channels of each record.
+        /// </summary>
+        /// <returns>Number of channels (-1 if no file is loaded)</returns>
+        public int GetNumChannels()
+        {
+            return NativeDAFFGetNumChannels(_DAFFHandle);
+        }
+
+        /// <summary>
+        /// Returns the number of records.
+        /// </summary>
+        /// <returns>Number of records (-1 if no file is loaded)</returns>
+        public int GetNumRecords()
+        {
+            return NativeDAFFGetNumRecords(_DAFFHandle);
+        }
+
+        /// <summary>
+        /// Returns the number of values per channel of a record for all content types: filter length, number of
+        /// frequencies or twice that number for interleaved magnitude-phase pairs and real-imaginary DFT coefficients.
+        /// </summary>
+        /// <returns>Number of values per channel (-1 if no file is loaded)</returns>
+        public int GetRecordLength()
+        {
+            return NativeDAFFGetRecordLength(_DAFFHandle);
+        }
+
+        /// <summary>
+        /// Returns the number of values of a record with all channels, the stride of the batch methods.
+        /// </summary>
+        /// <returns>Number of values per record</returns>
+        public int GetRecordSize()
+        {
+            return GetNumChannels() * GetRecordLength();
+        }
+
+        // The batch methods below write records as [records][channels][GetRecordLength()] values into
+        // caller-provided buffers and do not allocate, so the buffers can be reused for every audio block.
+        // Arrays are pinned during the call, not copied. Directions are given in degrees (object view).
+
+        /// <summary>
+        /// Searches the nearest neighbour records of many directions at once.
+        /// </summary>
+        /// <param name="Azimuths">Azimuthal angles in degree</param>
+        /// <param name="Elevations">Elevation angles in degree, same length</param>
+        /// <param name="RecordIndices">Indices of the nearest neighbour records, same length</param>
+        /// <returns>True, if the indices could be determined</returns>
+        public bool GetNearestNeighbourRecordIndices(float[] Azimuths, float[] Elevations, int[] RecordIndices)
+        {
+            if (Elevations.Length != Azimuths.Length || RecordIndices.Length < Azimuths.Length)
+                return false;
+            return NativeDAFFGetNearestNeighbourRecordIndices(_DAFFHandle, Azimuths, Elevations, Azimuths.Length, RecordIndices);
+        }
+
+        /// <summary>
+        /// Copies the data of several records with all channels into one array.
+        /// </summary>
+        /// <param name="RecordIndices">Record indices</param>
+        /// <param name="Dest">Destination, at least RecordIndices.Length * GetRecordSize() elements</param>
+        /// <returns>True, if all records could be copied</returns>
+        public bool GetRecordsData(int[] RecordIndices, float[] Dest)
+        {
+            return NativeDAFFGetRecordsData(_DAFFHandle, RecordIndices, RecordIndices.Length, Dest, Dest.Length);
+        }
+
+        /// <summary>
+        /// Copies the nearest neighbour records of many directions with all channels into one array.
+        /// </summary>
+        /// <param name="Azimuths">Azimuthal angles in degree</param>
+        /// <param name="Elevations">Elevation angles in degree, same length</param>
+        /// <param name="Dest">Destination, at least Azimuths.Length * GetRecordSize() elements</param>
+        /// <returns>True, if all records could be copied</returns>
+        public bool GetNearestNeighbourRecordsData(float[] Azimuths, float[] Elevations, float[] Dest)
+        {
+            if (Elevations.Length != Azimuths.Length)
+                return false;
+            return NativeDAFFGetNearestNeighbourRecordsData(_DAFFHandle, Azimuths, Elevations, Azimuths.Length, Dest, Dest.Length);
+        }
+
+        /// <summary>
+        /// Searches the nearest neighbour records of many directions at once (unmanaged or pinned buffers, e.g. NativeArray).
+        /// </summary>
+        /// <param name="Azimuths">Azimuthal angles in degree, NumDirections floats</param>
+        /// <param name="Elevations">Elevation angles in degree, NumDirections floats</param>
+        /// <param name="NumDirections">Number of directions</param>
+        /// <param name="RecordIndices">Indices of the nearest neighbour records, NumDirections ints</param>
+        /// <returns>True, if the indices could be determined</returns>
+        public bool GetNearestNeighbourRecordIndices(IntPtr Azimuths, IntPtr Elevations, int NumDirections, IntPtr RecordIndices)
+        {
+            return NativeDAFFGetNearestNeighbourRecordIndices(_DAFFHandle, Azimuths, Elevations, NumDirections, RecordIndices);
+        }
+
+        /// <summary>
+        /// Copies the data of several records with all channels into one buffer (unmanaged or pinned buffers, e.g. NativeArray).
+        /// </summary>
+        /// <param name="RecordIndices">Record indices, NumRecords ints</param>
+        /// <param name="NumRecords">Number of records</param>
+        /// <param name="Dest">Destination</param>
+        /// <param name="DestSize">Number of floats of the destination, at least NumRecords * GetRecordSize()</param>
+        /// <returns>True, if all records could be copied</returns>
+        public bool GetRecordsData(IntPtr RecordIndices, int NumRecords, IntPtr Dest, int DestSize)
+        {
+            return NativeDAFFGetRecordsData(_DAFFHandle, RecordIndices, NumRecords, Dest, DestSize);
+        }
+
+        /// <summary>
+        /// Copies the nearest neighbour records of many directions with all channels into one buffer (unmanaged or pinned buffers, e.g. NativeArray).
+        /// </summary>
+        /// <param name="Azimuths">Azimuthal angles in degree, NumDirections floats</param>
+        /// <param name="Elevations">Elevation angles in degree, NumDirections floats</param>
+        /// <param name="NumDirections">Number of directions</param>
+        /// <param name="Dest">Destination</param>
+        /// <param name="DestSize">Number of floats of the destination, at least NumDirections * GetRecordSize()</param>
+        /// <returns>True, if all records could be copied</returns>
+        public bool GetNearestNeighbourRecordsData(IntPtr Azimuths, IntPtr Elevations, int NumDirections, IntPtr Dest, int DestSize)
+        {
+            return NativeDAFFGetNearestNeighbourRecordsData(_DAFFHandle, Azimuths, Elevations, NumDirections, Dest, DestSize);
+        }
+
+#if NETSTANDARD2_1 || NETCOREAPP2_1_OR_GREATER || UNITY_2021_2_OR_NEWER
+        /// <summary>
+        /// Searches the nearest neighbour records of many directions at once.
+        /// </summary>
+        /// <param name="Azimuths">Azimuthal angles in degree</param>
+        /// <param name="Elevations">Elevation angles in degree, same length</param>
+        /// <param name="RecordIndices">Indices of the nearest neighbour records, same length</param>
+        /// <returns>True, if the indices could be determined</returns>
+        public bool GetNearestNeighbourRecordIndices(ReadOnlySpan<float> Azimuths, ReadOnlySpan<float> Elevations, Span<int> RecordIndices)
+        {
+            if (Elevations.Length != Azimuths.Length || RecordIndices.Length < Azimuths.Length)
+                return false;
+            return NativeDAFFGetNearestNeighbourRecordIndices(_DAFFHandle, in MemoryMarshal.GetReference(Azimuths),
+                in MemoryMarshal.GetReference(Elevations), Azimuths.Length, ref MemoryMarshal.GetReference(RecordIndices));
+        }
+
+        /// <summary>
+        /// Copies the data of several records with all channels into one span.
+        /// </summary>
+        /// <param name="RecordIndices">Record indices</param>
+        /// <param name="Dest">Destination, at least RecordIndices.Length * GetRecordSize() elements</param>
+        /// <returns>True, if all records could be copied</returns>
+        public bool GetRecordsData(ReadOnlySpan<int> RecordIndices, Span<float> Dest)
+        {
+            return NativeDAFFGetRecordsData(_DAFFHandle, in MemoryMarshal.GetReference(RecordIndices), RecordIndices.Length,
+                ref MemoryMarshal.GetReference(Dest), Dest.Length);
+        }
+
+        /// <summary>
+        /// Copies the nearest neighbour records of many directions with all channels into one span.
+        /// </summary>
+        /// <param name="Azimuths">Azimuthal angles in degree</param>
+        /// <param name="Elevations">Elevation angles in degree, same length</param>
+        /// <param name="Dest">Destination, at least Azimuths.Length * GetRecordSize() elements</param>
+        /// <returns>True, if all records could be copied</returns>
+        public bool GetNearestNeighbourRecordsData(ReadOnlySpan<float> Azimuths, ReadOnlySpan<float> Elevations, Span<float> Dest)
+        {
+            if (Elevations.Length != Azimuths.Length)
+                return false;
+            return NativeDAFFGetNearestNeighbourRecordsData(_DAFFHandle, in MemoryMarshal.GetReference(Azimuths),
+                in MemoryMarshal.GetReference(Elevations), Azimuths.Length, ref MemoryMarshal.GetReference(Dest), Dest.Length);
+        }
+#endif
+
         [DllImport("DAFFCSWrapper")]
         private static extern IntPtr NativeDAFFCreate();
 
@@ -107,6 +372,62 @@ namespace DAFF
 
         [DllImport("DAFFCSWrapper")]
         private static extern int NativeDAFFGetContentType(IntPtr pHandle);
+
+        [DllImport("DAFFCSWrapper")]
+        private static extern int NativeDAFFGetQuantization(IntPtr pHandle);
+
+        // The native function returns a C++ bool (one byte)
+        [DllImport("DAFFCSWrapper")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        private static extern bool NativeDAFFGetMemoryFootprint(IntPtr pHandle, [Out] ulong[] Bytes);
+
+        [DllImport("DAFFCSWrapper")]
+        private static extern int NativeDAFFGetNumChannels(IntPtr pHandle);
+
+        [DllImport("DAFFCSWrapper")]
+        private static extern int NativeDAFFGetNumRecords(IntPtr pHandle);
+
+        [DllImport("DAFFCSWrapper")]
+        private static extern int NativeDAFFGetRecordLength(IntPtr pHandle);
+
+        // The native functions return a C++ bool (one byte)
+        [DllImport("DAFFCSWrapper")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        private static extern bool NativeDAFFGetNearestNeighbourRecordIndices(IntPtr pHandle, [In] float[] pfAzimuths, [In] float[] pfElevations, int iNumDirections, [Out] int[] piRecordIndices);
+
+        [DllImport("DAFFCSWrapper")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        private static extern bool NativeDAFFGetNearestNeighbourRecordIndices(IntPtr pHandle, IntPtr pfAzimuths, IntPtr pfElevations, int iNumDirections, IntPtr piRecordIndices);
+
+        [DllImport("DAFFCSWrapper")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        private static extern bool NativeDAFFGetRecordsData(IntPtr pHandle, [In] int[] piRecordIndices, int iNumRecords, [Out] float[] pfDest, int iBufferSize);
+
+        [DllImport("DAFFCSWrapper")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        private static extern bool NativeDAFFGetRecordsData(IntPtr pHandle, IntPtr piRecordIndices, int iNumRecords, IntPtr pfDest, int iBufferSize);
+
+        [DllImport("DAFFCSWrapper")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        private static extern bool NativeDAFFGetNearestNeighbourRecordsData(IntPtr pHandle, [In] float[] pfAzimuths, [In] float[] pfElevations, int iNumDirections, [Out] float[] pfDest, int iBufferSize);
+
+        [DllImport("DAFFCSWrapper")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        private static extern bool NativeDAFFGetNearestNeighbourRecordsData(IntPtr pHandle, IntPtr pfAzimuths, IntPtr pfElevations, int iNumDirections, IntPtr pfDest, int iBufferSize);
+
+#if NETSTANDARD2_1 || NETCOREAPP2_1_OR_GREATER || UNITY_2021_2_OR_NEWER
+        [DllImport("DAFFCSWrapper")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        private static extern bool NativeDAFFGetNearestNeighbourRecordIndices(IntPtr pHandle, in float pfAzimuths, in float pfElevations, int iNumDirections, ref int piRecordIndices);
+
+        [DllImport("DAFFCSWrapper")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        private static extern bool NativeDAFFGetRecordsData(IntPtr pHandle, in int piRecordIndices, int iNumRecords, ref float pfDest, int iBufferSize);
+
+        [DllImport("DAFFCSWrapper")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        private static extern bool NativeDAFFGetNearestNeighbourRecordsData(IntPtr pHandle, in float pfAzimuths, in float pfElevations, int iNumDirections, ref float pfDest, int iBufferSize);
+#endif
     }
 
     /// <summary>
@@ -186,6 +507,20 @@ namespace DAFF
 			return Samples;
         }
 
+        /// <summary>
+        /// Copies a record data into a given array without allocation, see GetNearestNeighbourRecordIndex.
+        /// </summary>
+        /// <param name="RecordIndex">Record index</param>
+        /// <param name="ChannelIndex">Channel index (start with 0)</param>
+        /// <param name="Samples">Destination, at least GetLength() elements (can be reused)</param>
+        /// <returns>True, if the data could be copied</returns>
+        public bool GetRecordData(int RecordIndex, int ChannelIndex, float[] Samples)
+        {
+            if (Samples.Length < GetLength())
+                return false;
+            return NativeDAFFContentIRGetRecordData(_DAFFIRHandle, RecordIndex, ChannelIndex, Samples);
+        }
+
         [DllImport("DAFFCSWrapper")]
         private static extern IntPtr NativeDAFFGetContentIR(IntPtr pHandle);
 
@@ -196,6 +531,7 @@ namespace DAFF
         private static extern int NativeDAFFContentIRGetRecordCoords(IntPtr pHandle, int iIndex, ref double dAzimuth, ref double dElevation);
 
         [DllImport("DAFFCSWrapper")]
+        [return: MarshalAs(UnmanagedType.I1)]
         private static extern bool NativeDAFFContentIRGetRecordData(IntPtr pHandle, int iReordIndex, int iChannelIndex, [Out] float[] pfSamples);
 
         [DllImport("DAFFCSWrapper")]
@@ -276,6 +612,20 @@ namespace DAFF
 			return Magnitudes;
         }
 
+        /// <summary>
+        /// Copies a record data into a given array without allocation, see GetNearestNeighbourRecordIndex.
+        /// </summary>
+        /// <param name="RecordIndex">Record index</param>
+        /// <param name="ChannelIndex">Channel index (start with 0)</param>
+        /// <param name="Magnitudes">Destination, at least GetLength() elements (can be reused)</param>
+        /// <returns>True, if the data could be copied</returns>
+        public bool GetRecordData(int RecordIndex, int ChannelIndex, float[] Magnitudes)
+        {
+            if (Magnitudes.Length < GetLength())
+                return false;
+            return NativeDAFFContentMSGetRecordData(_DAFFMSHandle, RecordIndex, ChannelIndex, Magnitudes);
+        }
+
         [DllImport("DAFFCSWrapper")]
         private static extern IntPtr NativeDAFFGetContentMS(IntPtr pHandle);
 
@@ -286,10 +636,229 @@ namespace DAFF
         private static extern int NativeDAFFContentMSGetRecordCoords(IntPtr pHandle, int iIndex, ref double dAzimuth, ref double dElevation);
 
         [DllImport("DAFFCSWrapper")]
+        [return: MarshalAs(UnmanagedType.I1)]
         private static extern bool NativeDAFFContentMSGetRecordData(IntPtr pHandle, int iIndex, int iChannelIndex, [Out] float[] fMags);
 
         [DllImport("DAFFCSWrapper")]
         private static extern int NativeDAFFContentMSGetLength(IntPtr pHandle);
 
     }
+
+    /// <summary>
+    /// Class describing phase spectra.
+    /// </summary>
+    public class PS
+    {
+        private IntPtr _DAFFPSHandle;
+
+        /// <summary>
+        /// Creates a PS class from the DAFF content passed by DAFFReader. For internal use, see GetContentPS() instead.
+        /// </summary>
+        /// <param name="_DAFFHandle">Internal DAFF handle</param>
+        public PS(IntPtr _DAFFHandle)
+        {
+            _DAFFPSHandle = NativeDAFFGetContentPS(_DAFFHandle);
+        }
+
+        ~PS()
+        {
+
+        }
+
+        /// <summary>
+        /// Checks if class is valid and ready to use.
+        /// </summary>
+        /// <returns>True, if ready to use.</returns>
+        public bool IsValid()
+        {
+            return (_DAFFPSHandle != IntPtr.Zero);
+        }
+
+        /// <summary>
+        /// Actual accessor for directional DAFF content. Searches for nearest neighbour in data grid. Uses degrees and solely the DAFF object (user) view.
+        /// (0,0) is front etc, see DAFF C++ documentation for more details.
+        /// </summary>
+        /// <param name="Azimuth">Azimuthal angle in degree</param>
+        /// <param name="Elevation">Elevation angle in degree</param>
+        /// <returns>Index of nearest neighbour record</returns>
+        public int GetNearestNeighbourRecordIndex(double Azimuth, double Elevation)
+        {
+            return NativeDAFFContentPSGetNearestNeighbourRecordIndex(_DAFFPSHandle, Azimuth, Elevation);
+        }
+
+        /// <summary>
+        /// Retrieves the coordinates in azimuth and elevation (degree) for a record index.
+        /// </summary>
+        /// <param name="Index">Record index</param>
+        /// <param name="Azimuth">Azimuth angle in degree</param>
+        /// <param name="Elevation">Elevation angle in degree</param>
+        public void GetRecordCoords(int Index, ref double Azimuth, ref double Elevation)
+        {
+            NativeDAFFContentPSGetRecordCoords(_DAFFPSHandle, Index, ref Azimuth, ref Elevation);
+        }
+
+        /// <summary>
+        /// Returns the length of the underlying content/data values for one record/dataset.
+        /// </summary>
+        /// <returns>Number of content values</returns>
+        public int GetLength()
+        {
+            return NativeDAFFContentPSGetLength(_DAFFPSHandle);
+        }
+
+        /// <summary>
+        /// Retrieves a copy of a record data in given direction by record index, see GetNearestNeighbourRecordIndex.
+        /// </summary>
+        /// <param name="Index">Record index</param>
+        /// <param name="Channel">Channel index (start with 0)</param>
+        /// <param name="Samples">Array of content values</param>
+        public float[] GetRecordData(int RecordIndex, int ChannelIndex)
+        {
+            int NumPhases = GetLength();
+            float[] Phases = new float[NumPhases];
+            if (!NativeDAFFContentPSGetRecordData(_DAFFPSHandle, RecordIndex, ChannelIndex, Phases))
+                return null;
+			return Phases;
+        }
+
+        /// <summary>
+        /// Copies a record data into a given array without allocation, see GetNearestNeighbourRecordIndex.
+        /// </summary>
+        /// <param name="RecordIndex">Record index</param>
+        /// <param name="ChannelIndex">Channel index (start with 0)</param>
+        /// <param name="Phases">Destination, at least GetLength() elements (can be reused)</param>
+        /// <returns>True, if the data could be copied</returns>
+        public bool GetRecordData(int RecordIndex, int ChannelIndex, float[] Phases)
+        {
+            if (Phases.Length < GetLength())
+                return false;
+            return NativeDAFFContentPSGetRecordData(_DAFFPSHandle, RecordIndex, ChannelIndex, Phases);
+        }
+
+        [DllImport("DAFFCSWrapper")]
+        private static extern IntPtr NativeDAFFGetContentPS(IntPtr pHandle);
+
+        [DllImport("DAFFCSWrapper")]
+        private static extern int NativeDAFFContentPSGetNearestNeighbourRecordIndex(IntPtr pHandle, double dAzimuth, double dElevation);
+
+        [DllImport("DAFFCSWrapper")]
+        private static extern int NativeDAFFContentPSGetRecordCoords(IntPtr pHandle, int iIndex, ref double dAzimuth, ref double dElevation);
+
+        [DllImport("DAFFCSWrapper")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        private static extern bool NativeDAFFContentPSGetRecordData(IntPtr pHandle, int iIndex, int iChannelIndex, [Out] float[] pfPhases);
+
+        [DllImport("DAFFCSWrapper")]
+        private static extern int NativeDAFFContentPSGetLength(IntPtr pHandle);
+
+    }
+
+    /// <summary>
+    /// Class describing discrete Fourier spectra (complex-valued DFT coefficients).
+    /// </summary>
+    public class DFT
+    {
+        private IntPtr _DAFFDFTHandle;
+
+        /// <summary>
+        /// Creates a DFT class from the DAFF content passed by DAFFReader. For internal use, see GetContentDFT() instead.
+        /// </summary>
+        /// <param name="_DAFFHandle">Internal DAFF handle</param>
+        public DFT(IntPtr _DAFFHandle)
+        {
+            _DAFFDFTHandle = NativeDAFFGetContentDFT(_DAFFHandle);
+        }
+
+        ~DFT()
+        {
+
+        }
+
+        /// <summary>
+        /// Checks if class is valid and ready to use.
+        /// </summary>
+        /// <returns>True, if ready to use.</returns>
+        public bool IsValid()
+        {
+            return (_DAFFDFTHandle != IntPtr.Zero);
+        }
+
+        /// <summary>
+        /// Actual accessor for directional DAFF content. Searches for nearest neighbour in data grid. Uses degrees and solely the DAFF object (user) view.
+        /// (0,0) is front etc, see DAFF C++ documentation for more details.
+        /// </summary>
+        /// <param name="Azimuth">Azimuthal angle in degree</param>
+        /// <param name="Elevation">Elevation angle in degree</param>
+        /// <returns>Index of nearest neighbour record</returns>
+        public int GetNearestNeighbourRecordIndex(double Azimuth, double Elevation)
+        {
+            return NativeDAFFContentDFTGetNearestNeighbourRecordIndex(_DAFFDFTHandle, Azimuth, Elevation);
+        }
+
+        /// <summary>
+        /// Retrieves the coordinates in azimuth and elevation (degree) for a record index.
+        /// </summary>
+        /// <param name="Index">Record index</param>
+        /// <param name="Azimuth">Azimuth angle in degree</param>
+        /// <param name="Elevation">Elevation angle in degree</param>
+        public void GetRecordCoords(int Index, ref double Azimuth, ref double Elevation)
+        {
+            NativeDAFFContentDFTGetRecordCoords(_DAFFDFTHandle, Index, ref Azimuth, ref Elevation);
+        }
+
+        /// <summary>
+        /// Returns the length of the underlying content/data values for one record/dataset (interleaved real and imaginary parts).
+        /// </summary>
+        /// <returns>Number of content values, twice the number of DFT coefficients</returns>
+        public int GetLength()
+        {
+            return NativeDAFFContentDFTGetLength(_DAFFDFTHandle);
+        }
+
+        /// <summary>
+        /// Retrieves a copy of a record data in given direction by record index, see GetNearestNeighbourRecordIndex.
+        /// </summary>
+        /// <param name="Index">Record index</param>
+        /// <param name="Channel">Channel index (start with 0)</param>
+        /// <param name="Samples">Array of content values</param>
+        public float[] GetRecordData(int RecordIndex, int ChannelIndex)
+        {
+            int NumCoeffs = GetLength();
+            float[] Coeffs = new float[NumCoeffs];
+            if (!NativeDAFFContentDFTGetRecordData(_DAFFDFTHandle, RecordIndex, ChannelIndex, Coeffs))
+                return null;
+			return Coeffs;
+        }
+
+        /// <summary>
+        /// Copies a record data into a given array without allocation, see GetNearestNeighbourRecordIndex.
+        /// </summary>
+        /// <param name="RecordIndex">Record index</param>
+        /// <param name="ChannelIndex">Channel index (start with 0)</param>
+        /// <param name="Coeffs">Destination, at least GetLength() elements (can be reused)</param>
+        /// <returns>True, if the data could be copied</returns>
+        public bool GetRecordData(int RecordIndex, int ChannelIndex, float[] Coeffs)
+        {
+            if (Coeffs.Length < GetLength())
+                return false;
+            return NativeDAFFContentDFTGetRecordData(_DAFFDFTHandle, RecordIndex, ChannelIndex, Coeffs);
+        }
+
+        [DllImport("DAFFCSWrapper")]
+        private static extern IntPtr NativeDAFFGetContentDFT(IntPtr pHandle);
+
+        [DllImport("DAFFCSWrapper")]
+        private static extern int NativeDAFFContentDFTGetNearestNeighbourRecordIndex(IntPtr pHandle, double dAzimuth, double dElevation);
+
+        [DllImport("DAFFCSWrapper")]
+        private static extern int NativeDAFFContentDFTGetRecordCoords(IntPtr pHandle, int iIndex, ref double dAzimuth, ref double dElevation);
+
+        [DllImport("DAFFCSWrapper")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        private static extern bool NativeDAFFContentDFTGetRecordData(IntPtr pHandle, int iIndex, int iChannelIndex, [Out] float[] pfCoeffs);
+
+        [DllImport("DAFFCSWrapper")]
+        private static extern int NativeDAFFContentDFTGetLength(IntPtr pHandle);
+
+    }
 }
@@ -0,0 +1,165 @@
+using System;
+using System.Diagnostics;
+using System.Globalization;
+using DAFF;
+
+namespace DAFF
+{
+    /// <summary>
+    /// C# driver of the cross-language binding benchmark.
+    /// Runs the workload of tests/benchmark/BindingBenchmark.cpp through the C# binding and prints the results in
+    /// its CSV format. The workload file is written by the native baseline (BindingBenchmark -w),
+    /// tests/benchmark/binding_benchmark.py runs both and reports the per-call overhead of the binding.
+    /// </summary>
+    class DAFFBenchmark
+    {
+        // Size of the query pool (also the batch size)
+        const int NumQueries = 4096;
+
+        /// <summary>
+        /// Pseudo-random generator of the native baseline (Random of BenchmarkData.h)
+        /// </summary>
+        class Random
+        {
+            private uint State = 12345;
+
+            public float Next()
+            {
+                State = unchecked(State * 1664525u + 1013904223u);
+                return (float)(State >> 8) / 16777216.0f;
+            }
+        }
+
+        static void PrintResult(string Operation, string Variant, long Calls, Stopwatch Watch, double Checksum)
+        {
+            double NsPerCall = Watch.Elapsed.TotalMilliseconds * 1e6 / Math.Max(Calls, 1);
+            Console.WriteLine(string.Format(CultureInfo.InvariantCulture, "csharp,{0},{1},{2},{3:F2},{4:F6}",
+                Operation, Variant, Calls, NsPerCall, Checksum));
+        }
+
+        static int Argument(string[] args, int Index, int Default)
+        {
+            int Value;
+            if (args.Length > Index && int.TryParse(args[Index], out Value))
+                return Value;
+            return Default;
+        }
+
+        /// <summary>
+        /// Usage: DAFFBenchmark file [queries [fetches [opens]]]
+        /// </summary>
+        static int Main(string[] args)
+        {
+            if (args.Length < 1)
+            {
+                Console.Error.WriteLine("Usage: DAFFBenchmark file [queries [fetches [opens]]]");
+                return 255;
+            }
+            string FilePath = args[0];
+            int Queries = Argument(args, 1, 1000000);
+            int Fetches = Argument(args, 2, 100000);
+            int Opens = Argument(args, 3, 50);
+
+            Console.WriteLine("binding,operation,variant,calls,ns_per_call,checksum");
+
+            // Loading reads the file into memory and deserializes it
+            DAFFReader Reader = new DAFFReader();
+            Stopwatch Watch = Stopwatch.StartNew();
+            for (int i = 0; i < Opens; i++)
+            {
+                if (!Reader.Load(FilePath))
+                {
+                    Console.Error.WriteLine("Could not load DAFF file from path " + FilePath);
+                    return 255;
+                }
+            }
+            PrintResult("open", "call", Opens, Watch, 0);
+
+            IR Content = Reader.GetContentIR();
+            int NumChannels = Reader.GetNumChannels();
+            int NumRecords = Reader.GetNumRecords();
+
+            // Same directions and record indices as the native baseline
+            Random Generator = new Random();
+            float[] Azimuths = new float[NumQueries];
+            float[] Elevations = new float[NumQueries];
+            int[] RecordIndices = new int[NumQueries];
+            for (int i = 0; i < NumQueries; i++)
+            {
+                Azimuths[i] = (float)(360 * Generator.Next()) - 180;
+                Elevations[i] = (float)(180 * Generator.Next()) - 90;
+                RecordIndices[i] = Math.Min((int)(float)(Generator.Next() * NumRecords), NumRecords - 1);
+            }
+
+            // Nearest neighbours, one call per direction and batches of the query pool
+            double Checksum = 0;
+            Watch.Restart();
+            for (int i = 0; i < Queries; i++)
+            {
+                int j = i & (NumQueries - 1);
+                Checksum += Content.GetNearestNeighbourRecordIndex(Azimuths[j], Elevations[j]);
+            }
+            PrintResult("nearest_neighbour", "call", Queries, Watch, Checksum);
+
+            int[] Indices = new int[NumQueries];
+            Checksum = 0;
+            Watch.Restart();
+            for (int i = 0; i < Queries; i += NumQueries)
+            {
+                int n = Math.Min(NumQueries, Queries - i);
+                float[] BatchAzimuths = Azimuths, BatchElevations = Elevations;
+                if (n < NumQueries)
+                {
+                    BatchAzimuths = new float[n];
+                    BatchElevations = new float[n];
+                    Array.Copy(Azimuths, BatchAzimuths, n);
+                    Array.Copy(Elevations, BatchElevations, n);
+                }
+                if (!Reader.GetNearestNeighbourRecordIndices(BatchAzimuths, BatchElevations, Indices))
+                    return 255;
+                for (int k = 0; k < n; k++)
+                    Checksum += Indices[k];
+            }
+            PrintResult("nearest_neighbour", "batch", Queries, Watch, Checksum);
+
+            // Record fetches into reused arrays, per channel and in batches
+            float[] Samples = new float[Content.GetLength()];
+            Checksum = 0;
+            Watch.Restart();
+            for (int i = 0; i < Fetches; i++)
+            {
+                int RecordIndex = RecordIndices[i & (NumQueries - 1)];
+                for (int c = 0; c < NumChannels; c++)
+                {
+                    if (!Content.GetRecordData(RecordIndex, c, Samples))
+                        return 255;
+                    if (c == 0)
+                        Checksum += Samples[0];
+                }
+            }
+            PrintResult("record", "call", Fetches, Watch, Checksum);
+
+            int RecordSize = Reader.GetRecordSize();
+            float[] Data = new float[NumQueries * RecordSize];
+            Checksum = 0;
+            Watch.Restart();
+            for (int i = 0; i < Fetches; i += NumQueries)
+            {
+                int n = Math.Min(NumQueries, Fetches - i);
+                int[] BatchIndices = RecordIndices;
+                if (n < NumQueries)
+                {
+                    BatchIndices = new int[n];
+                    Array.Copy(RecordIndices, BatchIndices, n);
+                }
+                if (!Reader.GetRecordsData(BatchIndices, Data))
+                    return 255;
+                for (int k = 0; k < n; k++)
+                    Checksum += Data[k * RecordSize];
+            }
+            PrintResult("record", "batch", Fetches, Watch, Checksum);
+
+            return 0;
+        }
+    }
+}
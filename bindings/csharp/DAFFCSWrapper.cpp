@@ -48,7 +48,7 @@ bool NativeDAFFLoad(CUnmanagedDAFFHandle* pDAFFHandle, const char* pcFilePath)
 
 	fclose(hDAFFFile);
 
-	pDAFFHandle->pReader->deserialize(pDAFFDataBuffer);
+	pDAFFHandle->pReader->deserialize(pDAFFDataBuffer, nBytes);
 
 	return true;
 }
@@ -60,6 +60,31 @@ int NativeDAFFGetContentType(CUnmanagedDAFFHandle* pDAFFHandle)
 	return pDAFFHandle->pReader->getContentType();
 }
 
+int NativeDAFFGetQuantization(CUnmanagedDAFFHandle* pDAFFHandle)
+{
+	if (!pDAFFHandle->pReader->isValid())
+		return -1;
+	return pDAFFHandle->pReader->getProperties()->getQuantization();
+}
+
+bool NativeDAFFGetMemoryFootprint(CUnmanagedDAFFHandle* pDAFFHandle, unsigned long long* pui64Bytes)
+{
+	if (pui64Bytes == nullptr)
+		return false;
+
+	DAFFMemoryFootprint oFootprint;
+	pDAFFHandle->pReader->getMemoryFootprint(oFootprint);
+	pui64Bytes[0] = oFootprint.ui64Headers;
+	pui64Bytes[1] = oFootprint.ui64RecordDescriptors;
+	pui64Bytes[2] = oFootprint.ui64RecordData;
+	pui64Bytes[3] = oFootprint.ui64RecordCache;
+	pui64Bytes[4] = oFootprint.ui64Metadata;
+	pui64Bytes[5] = oFootprint.ui64Statistics;
+	pui64Bytes[6] = oFootprint.ui64Total;
+	pui64Bytes[7] = oFootprint.ui64Mapped;
+	return true;
+}
+
 DAFFContentIR* NativeDAFFGetContentIR(CUnmanagedDAFFHandle* pDAFFHandle)
 {
 	if (!pDAFFHandle->pReader->isValid())
@@ -159,3 +184,236 @@ int NativeDAFFContentMSGetLength(DAFFContentMS* pDAFFContent)
 		return false;
 	return pDAFFContent->getNumFrequencies();
 }
+
+DAFFContentPS* NativeDAFFGetContentPS(CUnmanagedDAFFHandle* pDAFFHandle)
+{
+	if (!pDAFFHandle->pReader->isValid())
+		return nullptr;
+	if (pDAFFHandle->pReader->getContentType() != DAFF_CONTENT_TYPES::DAFF_PHASE_SPECTRUM)
+		return nullptr;
+
+	return dynamic_cast<DAFFContentPS*>(pDAFFHandle->pReader->getContent());
+}
+
+int NativeDAFFContentPSGetNearestNeighbourRecordIndex(DAFFContentPS* pDAFFContent, double dAzimuth, double dElevation)
+{
+	if (pDAFFContent == nullptr)
+		return -1;
+
+	int iIndex;
+	bool bOutOfBounds;
+	pDAFFContent->getNearestNeighbour(DAFF_OBJECT_VIEW, float(dAzimuth), float(dElevation), iIndex, bOutOfBounds);
+	return iIndex;
+}
+
+void NativeDAFFContentPSGetRecordCoords(DAFFContentPS* pDAFFContent, const int iIndex, double* pdAzimuth,
+										double* pdElevation)
+{
+	if (pDAFFContent == nullptr)
+		return;
+
+	float fAzimuth, fElevation;
+	pDAFFContent->getRecordCoords(iIndex, DAFF_OBJECT_VIEW, fAzimuth, fElevation);
+	*pdAzimuth = double(fAzimuth);
+	*pdElevation = double(fElevation);
+}
+
+bool NativeDAFFContentPSGetRecordData(DAFFContentPS* pDAFFContent, const int iIndex, const int iChannel,
+									  float* pfPhases)
+{
+	if (pDAFFContent == nullptr)
+		return false;
+
+	pDAFFContent->getPhases(iIndex, iChannel, pfPhases);
+	return true;
+}
+
+int NativeDAFFContentPSGetLength(DAFFContentPS* pDAFFContent)
+{
+	if (pDAFFContent == nullptr)
+		return false;
+	return pDAFFContent->getNumFrequencies();
+}
+
+DAFFContentDFT* NativeDAFFGetContentDFT(CUnmanagedDAFFHandle* pDAFFHandle)
+{
+	if (!pDAFFHandle->pReader->isValid())
+		return nullptr;
+	if (pDAFFHandle->pReader->getContentType() != DAFF_CONTENT_TYPES::DAFF_DFT_SPECTRUM)
+		return nullptr;
+
+	return dynamic_cast<DAFFContentDFT*>(pDAFFHandle->pReader->getContent());
+}
+
+int NativeDAFFContentDFTGetNearestNeighbourRecordIndex(DAFFContentDFT* pDAFFContent, double dAzimuth, double dElevation)
+{
+	if (pDAFFContent == nullptr)
+		return -1;
+
+	int iIndex;
+	bool bOutOfBounds;
+	pDAFFContent->getNearestNeighbour(DAFF_OBJECT_VIEW, float(dAzimuth), float(dElevation), iIndex, bOutOfBounds);
+	return iIndex;
+}
+
+void NativeDAFFContentDFTGetRecordCoords(DAFFContentDFT* pDAFFContent, const int iIndex, double* pdAzimuth,
+										 double* pdElevation)
+{
+	if (pDAFFContent == nullptr)
+		return;
+
+	float fAzimuth, fElevation;
+	pDAFFContent->getRecordCoords(iIndex, DAFF_OBJECT_VIEW, fAzimuth, fElevation);
+	*pdAzimuth = double(fAzimuth);
+	*pdElevation = double(fElevation);
+}
+
+bool NativeDAFFContentDFTGetRecordData(DAFFContentDFT* pDAFFContent, const int iIndex, const int iChannel,
+									   float* pfCoeffs)
+{
+	if (pDAFFContent == nullptr)
+		return false;
+
+	pDAFFContent->getDFTCoeffs(iIndex, iChannel, pfCoeffs);
+	return true;
+}
+
+int NativeDAFFContentDFTGetLength(DAFFContentDFT* pDAFFContent)
+{
+	if (pDAFFContent == nullptr)
+		return false;
+	return 2 * pDAFFContent->getNumDFTCoeffs();  // Interleaved real and imaginary parts
+}
+
+// Number of float values per channel of the record data (complex values and magnitude-phase pairs interleaved)
+static int GetRecordLength(DAFFReader* pReader)
+{
+	DAFFContent* pContent = pReader->getContent();
+	switch (pReader->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		return dynamic_cast<DAFFContentIR*>(pContent)->getFilterLength();
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return dynamic_cast<DAFFContentMS*>(pContent)->getNumFrequencies();
+	case DAFF_PHASE_SPECTRUM:
+		return dynamic_cast<DAFFContentPS*>(pContent)->getNumFrequencies();
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		return 2 * dynamic_cast<DAFFContentMPS*>(pContent)->getNumFrequencies();
+	case DAFF_DFT_SPECTRUM:
+		return 2 * dynamic_cast<DAFFContentDFT*>(pContent)->getNumDFTCoeffs();
+	}
+	return 0;
+}
+
+// Number of float values per record, 0 if the reader is not valid or the destination too small for the records
+static int GetRecordSize(CUnmanagedDAFFHandle* pDAFFHandle, int iNumRecords, const float* pfDest, int iBufferSize)
+{
+	DAFFReader* pReader = pDAFFHandle->pReader;
+	if (!pReader->isValid() || (iNumRecords < 0))
+		return 0;
+
+	int iRecordSize = pReader->getProperties()->getNumberOfChannels() * GetRecordLength(pReader);
+	if (((iNumRecords > 0) && (pfDest == nullptr)) || ((int64_t)iBufferSize < (int64_t)iNumRecords * iRecordSize))
+		return 0;
+	return iRecordSize;
+}
+
+// Copies all channels of a record into consecutive blocks of a destination (no intermediate buffers)
+static bool GetRecordChannels(DAFFReader* pReader, int iRecordIndex, float* pfDest)
+{
+	const DAFFProperties* pProps = pReader->getProperties();
+	if ((iRecordIndex < 0) || (iRecordIndex >= pProps->getNumberOfRecords()))
+		return false;
+
+	DAFFContent* pContent = pReader->getContent();
+	int iLength = GetRecordLength(pReader);
+	for (int c = 0; c < pProps->getNumberOfChannels(); c++) {
+		float* pfChannelDest = pfDest + c * iLength;
+		int iError = DAFF_NO_ERROR;
+		switch (pReader->getContentType()) {
+		case DAFF_IMPULSE_RESPONSE:
+			iError = dynamic_cast<DAFFContentIR*>(pContent)->getFilterCoeffs(iRecordIndex, c, pfChannelDest);
+			break;
+		case DAFF_MAGNITUDE_SPECTRUM:
+			iError = dynamic_cast<DAFFContentMS*>(pContent)->getMagnitudes(iRecordIndex, c, pfChannelDest);
+			break;
+		case DAFF_PHASE_SPECTRUM:
+			iError = dynamic_cast<DAFFContentPS*>(pContent)->getPhases(iRecordIndex, c, pfChannelDest);
+			break;
+		case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+			iError = dynamic_cast<DAFFContentMPS*>(pContent)->getCoefficientsMP(iRecordIndex, c, pfChannelDest);
+			break;
+		case DAFF_DFT_SPECTRUM:
+			iError = dynamic_cast<DAFFContentDFT*>(pContent)->getDFTCoeffs(iRecordIndex, c, pfChannelDest);
+			break;
+		}
+		if (iError != DAFF_NO_ERROR)
+			return false;
+	}
+	return true;
+}
+
+int NativeDAFFGetNumChannels(CUnmanagedDAFFHandle* pDAFFHandle)
+{
+	if (!pDAFFHandle->pReader->isValid())
+		return -1;
+	return pDAFFHandle->pReader->getProperties()->getNumberOfChannels();
+}
+
+int NativeDAFFGetNumRecords(CUnmanagedDAFFHandle* pDAFFHandle)
+{
+	if (!pDAFFHandle->pReader->isValid())
+		return -1;
+	return pDAFFHandle->pReader->getProperties()->getNumberOfRecords();
+}
+
+int NativeDAFFGetRecordLength(CUnmanagedDAFFHandle* pDAFFHandle)
+{
+	if (!pDAFFHandle->pReader->isValid())
+		return -1;
+	return GetRecordLength(pDAFFHandle->pReader);
+}
+
+bool NativeDAFFGetNearestNeighbourRecordIndices(CUnmanagedDAFFHandle* pDAFFHandle, const float* pfAzimuths,
+												const float* pfElevations, int iNumDirections, int* piRecordIndices)
+{
+	if (!pDAFFHandle->pReader->isValid() || (iNumDirections < 0))
+		return false;
+	if ((iNumDirections > 0) && ((pfAzimuths == nullptr) || (pfElevations == nullptr) || (piRecordIndices == nullptr)))
+		return false;
+
+	pDAFFHandle->pReader->getContent()->getNearestNeighbours(DAFF_OBJECT_VIEW, pfAzimuths, pfElevations,
+															 piRecordIndices, nullptr, size_t(iNumDirections));
+	return true;
+}
+
+bool NativeDAFFGetRecordsData(CUnmanagedDAFFHandle* pDAFFHandle, const int* piRecordIndices, int iNumRecords,
+							  float* pfDest, int iBufferSize)
+{
+	int iRecordSize = GetRecordSize(pDAFFHandle, iNumRecords, pfDest, iBufferSize);
+	if ((iRecordSize == 0) || ((iNumRecords > 0) && (piRecordIndices == nullptr)))
+		return false;
+
+	for (int i = 0; i < iNumRecords; i++)
+		if (!GetRecordChannels(pDAFFHandle->pReader, piRecordIndices[i], pfDest + (size_t)i * iRecordSize))
+			return false;
+	return true;
+}
+
+bool NativeDAFFGetNearestNeighbourRecordsData(CUnmanagedDAFFHandle* pDAFFHandle, const float* pfAzimuths,
+											  const float* pfElevations, int iNumDirections, float* pfDest,
+											  int iBufferSize)
+{
+	int iRecordSize = GetRecordSize(pDAFFHandle, iNumDirections, pfDest, iBufferSize);
+	if ((iRecordSize == 0) || ((iNumDirections > 0) && ((pfAzimuths == nullptr) || (pfElevations == nullptr))))
+		return false;
+
+	DAFFContent* pContent = pDAFFHandle->pReader->getContent();
+	for (int i = 0; i < iNumDirections; i++) {
+		int iIndex;
+		bool bOutOfBounds;
+		pContent->getNearestNeighbour(DAFF_OBJECT_VIEW, pfAzimuths[i], pfElevations[i], iIndex, bOutOfBounds);
+		if (!GetRecordChannels(pDAFFHandle->pReader, iIndex, pfDest + (size_t)i * iRecordSize))
+			return false;
+	}
+	return true;
+}
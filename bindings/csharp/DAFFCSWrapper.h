@@ -28,12 +28,16 @@
 class CUnmanagedDAFFHandle;
 class DAFFContentIR;
 class DAFFContentMS;
+class DAFFContentPS;
+class DAFFContentDFT;
 
 extern "C" {
 DAFFCS_API CUnmanagedDAFFHandle* NativeDAFFCreate();
 DAFFCS_API void NativeDAFFDispose(CUnmanagedDAFFHandle*);
 DAFFCS_API bool NativeDAFFLoad(CUnmanagedDAFFHandle*, const char*);
 DAFFCS_API int NativeDAFFGetContentType(CUnmanagedDAFFHandle*);
+DAFFCS_API int NativeDAFFGetQuantization(CUnmanagedDAFFHandle*);
+DAFFCS_API bool NativeDAFFGetMemoryFootprint(CUnmanagedDAFFHandle*, unsigned long long*);
 
 DAFFCS_API DAFFContentIR* NativeDAFFGetContentIR(CUnmanagedDAFFHandle*);
 DAFFCS_API int NativeDAFFContentIRGetNearestNeighbourRecordIndex(DAFFContentIR*, double, double);
@@ -46,6 +50,29 @@ DAFFCS_API int NativeDAFFContentMSGetNearestNeighbourRecordIndex(DAFFContentMS*,
 DAFFCS_API void NativeDAFFContentMSGetRecordCoords(DAFFContentMS*, const int, double*, double*);
 DAFFCS_API bool NativeDAFFContentMSGetRecordData(DAFFContentMS*, const int, const int, float*);
 DAFFCS_API int NativeDAFFContentMSGetLength(DAFFContentMS* pDAFFContent);
+
+DAFFCS_API DAFFContentPS* NativeDAFFGetContentPS(CUnmanagedDAFFHandle*);
+DAFFCS_API int NativeDAFFContentPSGetNearestNeighbourRecordIndex(DAFFContentPS*, double, double);
+DAFFCS_API void NativeDAFFContentPSGetRecordCoords(DAFFContentPS*, const int, double*, double*);
+DAFFCS_API bool NativeDAFFContentPSGetRecordData(DAFFContentPS*, const int, const int, float*);
+DAFFCS_API int NativeDAFFContentPSGetLength(DAFFContentPS* pDAFFContent);
+
+DAFFCS_API DAFFContentDFT* NativeDAFFGetContentDFT(CUnmanagedDAFFHandle*);
+DAFFCS_API int NativeDAFFContentDFTGetNearestNeighbourRecordIndex(DAFFContentDFT*, double, double);
+DAFFCS_API void NativeDAFFContentDFTGetRecordCoords(DAFFContentDFT*, const int, double*, double*);
+DAFFCS_API bool NativeDAFFContentDFTGetRecordData(DAFFContentDFT*, const int, const int, float*);
+DAFFCS_API int NativeDAFFContentDFTGetLength(DAFFContentDFT* pDAFFContent);
+
+// Batch access into caller-provided buffers (all content types, object view, angles in degrees). Records are
+// written as [records][channels][NativeDAFFGetRecordLength()] floats, the buffer sizes are given in floats.
+DAFFCS_API int NativeDAFFGetNumChannels(CUnmanagedDAFFHandle*);
+DAFFCS_API int NativeDAFFGetNumRecords(CUnmanagedDAFFHandle*);
+DAFFCS_API int NativeDAFFGetRecordLength(CUnmanagedDAFFHandle*);
+DAFFCS_API bool NativeDAFFGetNearestNeighbourRecordIndices(CUnmanagedDAFFHandle*, const float*, const float*, int,
+														   int*);
+DAFFCS_API bool NativeDAFFGetRecordsData(CUnmanagedDAFFHandle*, const int*, int, float*, int);
+DAFFCS_API bool NativeDAFFGetNearestNeighbourRecordsData(CUnmanagedDAFFHandle*, const float*, const float*, int, float*,
+														 int);
 }
 
 #endif  // IW_DAFF_CS_WRAPPER
@@ -28,6 +28,8 @@ namespace DAFF
                 Console.WriteLine("Could not load DAFF file from path " + FilePath);
 
             Console.WriteLine("DAFF content type is " + MyDAFFReader.GetContentType());
+            Console.WriteLine("DAFF quantization is " + MyDAFFReader.GetQuantization());
+            Console.WriteLine("DAFF reader holds " + MyDAFFReader.GetMemoryFootprint().Total + " bytes");
 
             if (MyDAFFReader.GetContentType() == ContentType.ImpulseResponse)
             {
@@ -45,11 +47,25 @@ namespace DAFF
                 float[] DirectivitySpectrum = Directivity.GetRecordData(RecordIndex, 0);
                 Console.WriteLine("Directivity spectrum: " + DirectivitySpectrum);
             }
+            else if (MyDAFFReader.GetContentType() == ContentType.DFTSpectrum)
+            {
+                DFT Spectrum = MyDAFFReader.GetContentDFT();
+                int RecordIndex = Spectrum.GetNearestNeighbourRecordIndex(0, 0);
+                float[] Coeffs = Spectrum.GetRecordData(RecordIndex, 0);
+                Console.WriteLine("DFT coefficients (real, imaginary): " + Coeffs);
+            }
             else
             {
                 Console.WriteLine("DAFF content type is unrecognized and not supported by C# binding");
             }
 
+            // Allocation-free batch access for all content types, e.g. once per audio block with reused buffers
+            float[] Azimuths = { 0, 90, 180, 270 };
+            float[] Elevations = { 0, 0, 0, 0 };
+            float[] Records = new float[Azimuths.Length * MyDAFFReader.GetRecordSize()];
+            if (MyDAFFReader.GetNearestNeighbourRecordsData(Azimuths, Elevations, Records))
+                Console.WriteLine("Fetched " + Azimuths.Length + " records with " + MyDAFFReader.GetNumChannels() + " channels");
+
             return;
         }
     }
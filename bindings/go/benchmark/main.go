@@ -0,0 +1,174 @@
+// Go driver of the cross-language binding benchmark
+//
+// Runs the workload of tests/benchmark/BindingBenchmark.cpp through the Go binding and prints
+// the results in its CSV format. The workload file is written by the native baseline
+// (BindingBenchmark -w), tests/benchmark/binding_benchmark.py runs both and reports the
+// per-call overhead of the binding.
+//
+// Usage: go run ./benchmark file [queries [fetches [opens]]]
+package main
+
+import (
+	"fmt"
+	"os"
+	"strconv"
+	"time"
+
+	"github.com/MeKo-Tech/opendaff-go"
+)
+
+const numQueries = 4096 // Size of the query pool (also the batch size)
+
+// random is the pseudo-random generator of the native baseline (Random of BenchmarkData.h)
+type random struct {
+	state uint32
+}
+
+func (r *random) next() float32 {
+	r.state = r.state*1664525 + 1013904223
+	return float32(r.state>>8) / 16777216
+}
+
+// queryPool returns the same directions and record indices as the native baseline
+func queryPool(numRecords int) (azimuths, elevations []float32, records []int32) {
+	rnd := random{state: 12345}
+	for i := 0; i < numQueries; i++ {
+		// The conversions round like the float arithmetic of the baseline (no fused multiply-add)
+		azimuths = append(azimuths, float32(360*rnd.next())-180)
+		elevations = append(elevations, float32(180*rnd.next())-90)
+		record := int32(float32(rnd.next() * float32(numRecords)))
+		if record > int32(numRecords-1) {
+			record = int32(numRecords - 1)
+		}
+		records = append(records, record)
+	}
+	return
+}
+
+func printResult(operation, variant string, calls int, elapsed time.Duration, checksum float64) {
+	perCall := float64(elapsed.Nanoseconds()) / float64(max(calls, 1))
+	fmt.Printf("go,%s,%s,%d,%.2f,%.6f\n", operation, variant, calls, perCall, checksum)
+}
+
+func argument(index, defaultValue int) int {
+	if len(os.Args) > index {
+		if value, err := strconv.Atoi(os.Args[index]); err == nil {
+			return value
+		}
+	}
+	return defaultValue
+}
+
+func run(path string, queries, fetches, opens int) error {
+	reader, err := daff.NewReader()
+	if err != nil {
+		return err
+	}
+	defer reader.Close()
+
+	fmt.Println("binding,operation,variant,calls,ns_per_call,checksum")
+
+	t0 := time.Now()
+	for i := 0; i < opens; i++ {
+		if err := reader.OpenFile(path); err != nil {
+			return err
+		}
+		reader.CloseFile()
+	}
+	printResult("open", "call", opens, time.Since(t0), 0)
+
+	if err := reader.OpenFile(path); err != nil {
+		return err
+	}
+	defer reader.CloseFile()
+	ir, err := reader.GetContentIR()
+	if err != nil {
+		return err
+	}
+	numChannels := reader.GetNumChannels()
+	azimuths, elevations, records := queryPool(reader.GetNumRecords())
+
+	// Nearest neighbours, one call per direction and batches of the query pool
+	checksum := 0.0
+	t0 = time.Now()
+	for i := 0; i < queries; i++ {
+		j := i & (numQueries - 1)
+		checksum += float64(ir.GetNearestNeighbour(float64(azimuths[j]), float64(elevations[j])))
+	}
+	printResult("nearest_neighbour", "call", queries, time.Since(t0), checksum)
+
+	indices := make([]int32, numQueries)
+	checksum = 0
+	t0 = time.Now()
+	for i := 0; i < queries; i += numQueries {
+		n := min(numQueries, queries-i)
+		if err := reader.GetNearestNeighbours(daff.ViewObject, azimuths[:n], elevations[:n], indices, nil); err != nil {
+			return err
+		}
+		for _, index := range indices[:n] {
+			checksum += float64(index)
+		}
+	}
+	printResult("nearest_neighbour", "batch", queries, time.Since(t0), checksum)
+
+	// Record fetches, a slice per channel and call, batches into one slice and borrowed data
+	checksum = 0
+	t0 = time.Now()
+	for i := 0; i < fetches; i++ {
+		record := int(records[i&(numQueries-1)])
+		for c := 0; c < numChannels; c++ {
+			coeffs, err := ir.GetFilterCoeffs(record, c)
+			if err != nil {
+				return err
+			}
+			if c == 0 {
+				checksum += float64(coeffs[0])
+			}
+		}
+	}
+	printResult("record", "call", fetches, time.Since(t0), checksum)
+
+	recordSize := reader.GetRecordSize()
+	data := make([]float32, numQueries*recordSize)
+	checksum = 0
+	t0 = time.Now()
+	for i := 0; i < fetches; i += numQueries {
+		n := min(numQueries, fetches-i)
+		if err := reader.GetRecords(records[:n], data); err != nil {
+			return err
+		}
+		for k := 0; k < n; k++ {
+			checksum += float64(data[k*recordSize])
+		}
+	}
+	printResult("record", "batch", fetches, time.Since(t0), checksum)
+
+	checksum = 0
+	t0 = time.Now()
+	for i := 0; i < fetches; i++ {
+		record := int(records[i&(numQueries-1)])
+		for c := 0; c < numChannels; c++ {
+			offset, coeffs, err := reader.GetRecordChannelData(record, c)
+			if err != nil {
+				return err
+			}
+			if c == 0 && offset == 0 && len(coeffs) > 0 {
+				checksum += float64(coeffs[0])
+			}
+		}
+	}
+	printResult("record", "zerocopy", fetches, time.Since(t0), checksum)
+
+	return nil
+}
+
+func main() {
+	if len(os.Args) < 2 {
+		fmt.Fprintln(os.Stderr, "Usage: go run ./benchmark file [queries [fetches [opens]]]")
+		os.Exit(255)
+	}
+	if err := run(os.Args[1], argument(2, 1000000), argument(3, 100000), argument(4, 50)); err != nil {
+		fmt.Fprintln(os.Stderr, "Error:", err)
+		os.Exit(255)
+	}
+}
@@ -28,9 +28,9 @@
 package daff
 
 /*
-#cgo CXXFLAGS: -I../../include -std=c++11
-#cgo LDFLAGS: -L../../build -lDAFF -lstdc++
-#include "daff_go_wrapper.h"
+#cgo CFLAGS: -I../c
+#cgo LDFLAGS: -L../../build -ldaff_c -lstdc++
+#include "daff_c.h"
 #include <stdlib.h>
 */
 import "C"
@@ -40,15 +40,15 @@ import (
 	"unsafe"
 )
 
-// ContentType represents the type of data stored in a DAFF file
+// ContentType represents the type of data stored in a DAFF file (values of the C interface)
 type ContentType int
 
 const (
-	ContentTypeIR  ContentType = 1 // Impulse Response
-	ContentTypeMS  ContentType = 2 // Magnitude Spectrum
-	ContentTypePS  ContentType = 3 // Phase Spectrum
-	ContentTypeMPS ContentType = 4 // Magnitude-Phase Spectrum
-	ContentTypeDFT ContentType = 5 // DFT Coefficients
+	ContentTypeIR  ContentType = C.DAFFC_IMPULSE_RESPONSE         // Impulse Response
+	ContentTypeMS  ContentType = C.DAFFC_MAGNITUDE_SPECTRUM       // Magnitude Spectrum
+	ContentTypePS  ContentType = C.DAFFC_PHASE_SPECTRUM           // Phase Spectrum
+	ContentTypeMPS ContentType = C.DAFFC_MAGNITUDE_PHASE_SPECTRUM // Magnitude-Phase Spectrum
+	ContentTypeDFT ContentType = C.DAFFC_DFT_SPECTRUM             // DFT Coefficients
 )
 
 // String returns the string representation of the content type
@@ -73,9 +73,12 @@ func (c ContentType) String() string {
 type Quantization int
 
 const (
-	QuantizationInt16   Quantization = 1
-	QuantizationInt24   Quantization = 2
-	QuantizationFloat32 Quantization = 3
+	QuantizationInt16    Quantization = C.DAFFC_QUANTIZATION_INT16
+	QuantizationInt24    Quantization = C.DAFFC_QUANTIZATION_INT24
+	QuantizationFloat32  Quantization = C.DAFFC_QUANTIZATION_FLOAT32
+	QuantizationFloat16  Quantization = C.DAFFC_QUANTIZATION_FLOAT16
+	QuantizationBFloat16 Quantization = C.DAFFC_QUANTIZATION_BFLOAT16
+	QuantizationInt16BFP Quantization = C.DAFFC_QUANTIZATION_INT16_BFP
 )
 
 // String returns the string representation of the quantization type
@@ -87,19 +90,45 @@ func (q Quantization) String() string {
 		return "Int24"
 	case QuantizationFloat32:
 		return "Float32"
+	case QuantizationFloat16:
+		return "Float16"
+	case QuantizationBFloat16:
+		return "BFloat16"
+	case QuantizationInt16BFP:
+		return "Int16BFP"
 	default:
 		return "Unknown"
 	}
 }
 
+// View selects the spherical coordinates of directions
+type View int
+
+const (
+	ViewData   View = C.DAFFC_DATA_VIEW   // Data spherical coordinates (alpha, beta)
+	ViewObject View = C.DAFFC_OBJECT_VIEW // Object spherical coordinates (phi, theta)
+)
+
+// OpenFlags control how a file is opened (combinable with |)
+type OpenFlags int
+
+const (
+	OpenDefault  OpenFlags = C.DAFFC_OPEN_DEFAULT  // Read the whole file into memory
+	OpenMapped   OpenFlags = C.DAFFC_OPEN_MAPPED   // Memory-map the file instead of reading it
+	OpenLazy     OpenFlags = C.DAFFC_OPEN_LAZY     // Load record data on demand (no borrowed record data)
+	OpenDecode   OpenFlags = C.DAFFC_OPEN_DECODE   // Convert integer impulse responses into floats at load
+	OpenTruncate OpenFlags = C.DAFFC_OPEN_TRUNCATE // Trim impulse response tails below the truncation threshold at load
+	OpenVerify   OpenFlags = C.DAFFC_OPEN_VERIFY   // Verify the checksums of the file blocks
+)
+
 // Reader provides access to DAFF files
 type Reader struct {
-	handle C.GoDAFFReaderHandle
+	handle C.DAFFCReaderHandle
 }
 
 // NewReader creates a new DAFF reader
 func NewReader() (*Reader, error) {
-	handle := C.GoDAFF_Create()
+	handle := C.DAFFC_Create()
 	if handle == nil {
 		return nil, errors.New("failed to create DAFF reader")
 	}
@@ -112,7 +141,7 @@ func NewReader() (*Reader, error) {
 // Close releases resources associated with the reader
 func (r *Reader) Close() error {
 	if r.handle != nil {
-		C.GoDAFF_Destroy(r.handle)
+		C.DAFFC_Destroy(r.handle)
 		r.handle = nil
 	}
 	return nil
@@ -123,7 +152,18 @@ func (r *Reader) OpenFile(filename string) error {
 	cFilename := C.CString(filename)
 	defer C.free(unsafe.Pointer(cFilename))
 
-	if !C.GoDAFF_OpenFile(r.handle, cFilename) {
+	if !C.DAFFC_OpenFile(r.handle, cFilename) {
+		return errors.New("failed to open file: " + filename)
+	}
+	return nil
+}
+
+// OpenFileWithFlags opens a DAFF file for reading with the given flags
+func (r *Reader) OpenFileWithFlags(filename string, flags OpenFlags) error {
+	cFilename := C.CString(filename)
+	defer C.free(unsafe.Pointer(cFilename))
+
+	if !C.DAFFC_OpenFileWithFlags(r.handle, cFilename, C.int(flags)) {
 		return errors.New("failed to open file: " + filename)
 	}
 	return nil
@@ -131,69 +171,99 @@ func (r *Reader) OpenFile(filename string) error {
 
 // CloseFile closes the currently opened file
 func (r *Reader) CloseFile() {
-	C.GoDAFF_Close(r.handle)
+	C.DAFFC_Close(r.handle)
 }
 
 // IsValid returns true if a file is currently opened and valid
 func (r *Reader) IsValid() bool {
-	return bool(C.GoDAFF_IsValid(r.handle))
+	return bool(C.DAFFC_IsValid(r.handle))
 }
 
 // GetContentType returns the content type of the opened file
 func (r *Reader) GetContentType() ContentType {
-	return ContentType(C.GoDAFF_GetContentType(r.handle))
+	return ContentType(C.DAFFC_GetContentType(r.handle))
 }
 
 // GetQuantization returns the quantization type used in the file
 func (r *Reader) GetQuantization() Quantization {
-	return Quantization(C.GoDAFF_GetQuantization(r.handle))
+	return Quantization(C.DAFFC_GetQuantization(r.handle))
 }
 
 // GetNumChannels returns the number of audio channels
 func (r *Reader) GetNumChannels() int {
-	return int(C.GoDAFF_GetNumChannels(r.handle))
+	return int(C.DAFFC_GetNumChannels(r.handle))
 }
 
 // GetNumRecords returns the number of directional records
 func (r *Reader) GetNumRecords() int {
-	return int(C.GoDAFF_GetNumRecords(r.handle))
+	return int(C.DAFFC_GetNumRecords(r.handle))
 }
 
 // GetAlphaResolution returns the angular resolution in alpha direction (degrees)
 func (r *Reader) GetAlphaResolution() float32 {
-	return float32(C.GoDAFF_GetAlphaResolution(r.handle))
+	return float32(C.DAFFC_GetAlphaResolution(r.handle))
 }
 
 // GetBetaResolution returns the angular resolution in beta direction (degrees)
 func (r *Reader) GetBetaResolution() float32 {
-	return float32(C.GoDAFF_GetBetaResolution(r.handle))
+	return float32(C.DAFFC_GetBetaResolution(r.handle))
 }
 
 // GetAlphaPoints returns the number of sampling points in alpha direction
 func (r *Reader) GetAlphaPoints() int {
-	return int(C.GoDAFF_GetAlphaPoints(r.handle))
+	return int(C.DAFFC_GetAlphaPoints(r.handle))
 }
 
 // GetBetaPoints returns the number of sampling points in beta direction
 func (r *Reader) GetBetaPoints() int {
-	return int(C.GoDAFF_GetBetaPoints(r.handle))
+	return int(C.DAFFC_GetBetaPoints(r.handle))
 }
 
 // GetOrientation returns the orientation as yaw, pitch, roll angles in degrees
 func (r *Reader) GetOrientation() (yaw, pitch, roll float32, err error) {
 	var cYaw, cPitch, cRoll C.float
-	result := C.GoDAFF_GetOrientationYPR(r.handle, &cYaw, &cPitch, &cRoll)
+	result := C.DAFFC_GetOrientationYPR(r.handle, &cYaw, &cPitch, &cRoll)
 	if result != 0 {
 		return 0, 0, 0, errors.New("failed to get orientation")
 	}
 	return float32(cYaw), float32(cPitch), float32(cRoll), nil
 }
 
+// MemoryFootprint is the heap memory held by a reader, broken down by category (in bytes)
+type MemoryFootprint struct {
+	Headers           uint64 // File block table, main and content header, frequency list
+	RecordDescriptors uint64 // Record descriptors, payload indices, record directions and their index
+	RecordData        uint64 // Record data block and the decoded float arena
+	RecordCache       uint64 // Record cache and chunk buffer of the lazy loading
+	Metadata          uint64 // Metadata block and sets
+	Statistics        uint64 // Record statistics and peak values
+	Total             uint64 // Sum of the categories above
+	Mapped            uint64 // Accessed in place, not owned (mapped or borrowed)
+}
+
+// GetMemoryFootprint returns the heap memory held by the reader
+func (r *Reader) GetMemoryFootprint() (MemoryFootprint, error) {
+	var cFootprint C.DAFFCMemoryFootprint
+	if C.DAFFC_GetMemoryFootprint(r.handle, &cFootprint) != 0 {
+		return MemoryFootprint{}, errors.New("failed to get memory footprint")
+	}
+	return MemoryFootprint{
+		Headers:           uint64(cFootprint.headers),
+		RecordDescriptors: uint64(cFootprint.recordDescriptors),
+		RecordData:        uint64(cFootprint.recordData),
+		RecordCache:       uint64(cFootprint.recordCache),
+		Metadata:          uint64(cFootprint.metadata),
+		Statistics:        uint64(cFootprint.statistics),
+		Total:             uint64(cFootprint.total),
+		Mapped:            uint64(cFootprint.mapped),
+	}, nil
+}
+
 // HasMetadata returns true if the specified metadata key exists
 func (r *Reader) HasMetadata(key string) bool {
 	cKey := C.CString(key)
 	defer C.free(unsafe.Pointer(cKey))
-	return bool(C.GoDAFF_HasMetadata(r.handle, cKey))
+	return bool(C.DAFFC_HasMetadata(r.handle, cKey))
 }
 
 // GetMetadataString returns a string metadata value
@@ -201,7 +271,7 @@ func (r *Reader) GetMetadataString(key string) (string, error) {
 	cKey := C.CString(key)
 	defer C.free(unsafe.Pointer(cKey))
 
-	cValue := C.GoDAFF_GetMetadataString(r.handle, cKey)
+	cValue := C.DAFFC_GetMetadataString(r.handle, cKey)
 	if cValue == nil {
 		return "", errors.New("metadata key not found: " + key)
 	}
@@ -214,7 +284,7 @@ func (r *Reader) GetMetadataFloat(key string) (float32, error) {
 	defer C.free(unsafe.Pointer(cKey))
 
 	var value C.float
-	if !C.GoDAFF_GetMetadataFloat(r.handle, cKey, &value) {
+	if !C.DAFFC_GetMetadataFloat(r.handle, cKey, &value) {
 		return 0, errors.New("metadata key not found: " + key)
 	}
 	return float32(value), nil
@@ -226,7 +296,7 @@ func (r *Reader) GetMetadataBool(key string) (bool, error) {
 	defer C.free(unsafe.Pointer(cKey))
 
 	var value C.bool
-	if !C.GoDAFF_GetMetadataBool(r.handle, cKey, &value) {
+	if !C.DAFFC_GetMetadataBool(r.handle, cKey, &value) {
 		return false, errors.New("metadata key not found: " + key)
 	}
 	return bool(value), nil
@@ -234,12 +304,12 @@ func (r *Reader) GetMetadataBool(key string) (bool, error) {
 
 // ContentIR provides access to Impulse Response data
 type ContentIR struct {
-	handle C.GoDAFFContentHandle
+	handle C.DAFFCContentHandle
 }
 
 // GetContentIR returns an impulse response content accessor
 func (r *Reader) GetContentIR() (*ContentIR, error) {
-	handle := C.GoDAFF_GetContentIR(r.handle)
+	handle := C.DAFFC_GetContentIR(r.handle)
 	if handle == nil {
 		return nil, errors.New("file does not contain impulse response data")
 	}
@@ -248,23 +318,23 @@ func (r *Reader) GetContentIR() (*ContentIR, error) {
 
 // GetFilterLength returns the length of the impulse response filters
 func (c *ContentIR) GetFilterLength() int {
-	return int(C.GoDAFF_ContentIR_GetFilterLength(c.handle))
+	return int(C.DAFFC_ContentIR_GetFilterLength(c.handle))
 }
 
 // GetSamplerate returns the sample rate in Hz
 func (c *ContentIR) GetSamplerate() int {
-	return int(C.GoDAFF_ContentIR_GetSamplerate(c.handle))
+	return int(C.DAFFC_ContentIR_GetSamplerate(c.handle))
 }
 
 // GetNearestNeighbour returns the record index for the given direction (phi, theta in radians)
 func (c *ContentIR) GetNearestNeighbour(phi, theta float64) int {
-	return int(C.GoDAFF_ContentIR_GetNearestNeighbour(c.handle, C.double(phi), C.double(theta)))
+	return int(C.DAFFC_ContentIR_GetNearestNeighbour(c.handle, C.double(phi), C.double(theta)))
 }
 
 // GetRecordCoords returns the alpha and beta coordinates for the given record index
 func (c *ContentIR) GetRecordCoords(recordIndex int) (alpha, beta float64, err error) {
 	var cAlpha, cBeta C.double
-	if !C.GoDAFF_ContentIR_GetRecordCoords(c.handle, C.int(recordIndex), &cAlpha, &cBeta) {
+	if !C.DAFFC_ContentIR_GetRecordCoords(c.handle, C.int(recordIndex), &cAlpha, &cBeta) {
 		return 0, 0, errors.New("failed to get record coordinates")
 	}
 	return float64(cAlpha), float64(cBeta), nil
@@ -275,7 +345,7 @@ func (c *ContentIR) GetFilterCoeffs(recordIndex, channel int) ([]float32, error)
 	length := c.GetFilterLength()
 	coeffs := make([]float32, length)
 
-	if !C.GoDAFF_ContentIR_GetFilterCoeffs(c.handle, C.int(recordIndex), C.int(channel),
+	if !C.DAFFC_ContentIR_GetFilterCoeffs(c.handle, C.int(recordIndex), C.int(channel),
 		(*C.float)(unsafe.Pointer(&coeffs[0])), C.int(length)) {
 		return nil, errors.New("failed to get filter coefficients")
 	}
@@ -284,12 +354,12 @@ func (c *ContentIR) GetFilterCoeffs(recordIndex, channel int) ([]float32, error)
 
 // ContentMS provides access to Magnitude Spectrum data
 type ContentMS struct {
-	handle C.GoDAFFContentHandle
+	handle C.DAFFCContentHandle
 }
 
 // GetContentMS returns a magnitude spectrum content accessor
 func (r *Reader) GetContentMS() (*ContentMS, error) {
-	handle := C.GoDAFF_GetContentMS(r.handle)
+	handle := C.DAFFC_GetContentMS(r.handle)
 	if handle == nil {
 		return nil, errors.New("file does not contain magnitude spectrum data")
 	}
@@ -298,18 +368,18 @@ func (r *Reader) GetContentMS() (*ContentMS, error) {
 
 // GetNumFrequencies returns the number of frequency bins
 func (c *ContentMS) GetNumFrequencies() int {
-	return int(C.GoDAFF_ContentMS_GetNumFrequencies(c.handle))
+	return int(C.DAFFC_ContentMS_GetNumFrequencies(c.handle))
 }
 
 // GetNearestNeighbour returns the record index for the given direction
 func (c *ContentMS) GetNearestNeighbour(phi, theta float64) int {
-	return int(C.GoDAFF_ContentMS_GetNearestNeighbour(c.handle, C.double(phi), C.double(theta)))
+	return int(C.DAFFC_ContentMS_GetNearestNeighbour(c.handle, C.double(phi), C.double(theta)))
 }
 
 // GetRecordCoords returns the coordinates for the given record index
 func (c *ContentMS) GetRecordCoords(recordIndex int) (alpha, beta float64, err error) {
 	var cAlpha, cBeta C.double
-	if !C.GoDAFF_ContentMS_GetRecordCoords(c.handle, C.int(recordIndex), &cAlpha, &cBeta) {
+	if !C.DAFFC_ContentMS_GetRecordCoords(c.handle, C.int(recordIndex), &cAlpha, &cBeta) {
 		return 0, 0, errors.New("failed to get record coordinates")
 	}
 	return float64(cAlpha), float64(cBeta), nil
@@ -320,7 +390,7 @@ func (c *ContentMS) GetMagnitudes(recordIndex, channel int) ([]float32, error) {
 	numFreqs := c.GetNumFrequencies()
 	magnitudes := make([]float32, numFreqs)
 
-	if !C.GoDAFF_ContentMS_GetMagnitudes(c.handle, C.int(recordIndex), C.int(channel),
+	if !C.DAFFC_ContentMS_GetMagnitudes(c.handle, C.int(recordIndex), C.int(channel),
 		(*C.float)(unsafe.Pointer(&magnitudes[0])), C.int(numFreqs)) {
 		return nil, errors.New("failed to get magnitudes")
 	}
@@ -329,12 +399,12 @@ func (c *ContentMS) GetMagnitudes(recordIndex, channel int) ([]float32, error) {
 
 // ContentPS provides access to Phase Spectrum data
 type ContentPS struct {
-	handle C.GoDAFFContentHandle
+	handle C.DAFFCContentHandle
 }
 
 // GetContentPS returns a phase spectrum content accessor
 func (r *Reader) GetContentPS() (*ContentPS, error) {
-	handle := C.GoDAFF_GetContentPS(r.handle)
+	handle := C.DAFFC_GetContentPS(r.handle)
 	if handle == nil {
 		return nil, errors.New("file does not contain phase spectrum data")
 	}
@@ -343,18 +413,18 @@ func (r *Reader) GetContentPS() (*ContentPS, error) {
 
 // GetNumFrequencies returns the number of frequency bins
 func (c *ContentPS) GetNumFrequencies() int {
-	return int(C.GoDAFF_ContentPS_GetNumFrequencies(c.handle))
+	return int(C.DAFFC_ContentPS_GetNumFrequencies(c.handle))
 }
 
 // GetNearestNeighbour returns the record index for the given direction
 func (c *ContentPS) GetNearestNeighbour(phi, theta float64) int {
-	return int(C.GoDAFF_ContentPS_GetNearestNeighbour(c.handle, C.double(phi), C.double(theta)))
+	return int(C.DAFFC_ContentPS_GetNearestNeighbour(c.handle, C.double(phi), C.double(theta)))
 }
 
 // GetRecordCoords returns the coordinates for the given record index
 func (c *ContentPS) GetRecordCoords(recordIndex int) (alpha, beta float64, err error) {
 	var cAlpha, cBeta C.double
-	if !C.GoDAFF_ContentPS_GetRecordCoords(c.handle, C.int(recordIndex), &cAlpha, &cBeta) {
+	if !C.DAFFC_ContentPS_GetRecordCoords(c.handle, C.int(recordIndex), &cAlpha, &cBeta) {
 		return 0, 0, errors.New("failed to get record coordinates")
 	}
 	return float64(cAlpha), float64(cBeta), nil
@@ -365,7 +435,7 @@ func (c *ContentPS) GetPhases(recordIndex, channel int) ([]float32, error) {
 	numFreqs := c.GetNumFrequencies()
 	phases := make([]float32, numFreqs)
 
-	if !C.GoDAFF_ContentPS_GetPhases(c.handle, C.int(recordIndex), C.int(channel),
+	if !C.DAFFC_ContentPS_GetPhases(c.handle, C.int(recordIndex), C.int(channel),
 		(*C.float)(unsafe.Pointer(&phases[0])), C.int(numFreqs)) {
 		return nil, errors.New("failed to get phases")
 	}
@@ -374,12 +444,12 @@ func (c *ContentPS) GetPhases(recordIndex, channel int) ([]float32, error) {
 
 // ContentMPS provides access to Magnitude-Phase Spectrum data
 type ContentMPS struct {
-	handle C.GoDAFFContentHandle
+	handle C.DAFFCContentHandle
 }
 
 // GetContentMPS returns a magnitude-phase spectrum content accessor
 func (r *Reader) GetContentMPS() (*ContentMPS, error) {
-	handle := C.GoDAFF_GetContentMPS(r.handle)
+	handle := C.DAFFC_GetContentMPS(r.handle)
 	if handle == nil {
 		return nil, errors.New("file does not contain magnitude-phase spectrum data")
 	}
@@ -388,18 +458,18 @@ func (r *Reader) GetContentMPS() (*ContentMPS, error) {
 
 // GetNumFrequencies returns the number of frequency bins
 func (c *ContentMPS) GetNumFrequencies() int {
-	return int(C.GoDAFF_ContentMPS_GetNumFrequencies(c.handle))
+	return int(C.DAFFC_ContentMPS_GetNumFrequencies(c.handle))
 }
 
 // GetNearestNeighbour returns the record index for the given direction
 func (c *ContentMPS) GetNearestNeighbour(phi, theta float64) int {
-	return int(C.GoDAFF_ContentMPS_GetNearestNeighbour(c.handle, C.double(phi), C.double(theta)))
+	return int(C.DAFFC_ContentMPS_GetNearestNeighbour(c.handle, C.double(phi), C.double(theta)))
 }
 
 // GetRecordCoords returns the coordinates for the given record index
 func (c *ContentMPS) GetRecordCoords(recordIndex int) (alpha, beta float64, err error) {
 	var cAlpha, cBeta C.double
-	if !C.GoDAFF_ContentMPS_GetRecordCoords(c.handle, C.int(recordIndex), &cAlpha, &cBeta) {
+	if !C.DAFFC_ContentMPS_GetRecordCoords(c.handle, C.int(recordIndex), &cAlpha, &cBeta) {
 		return 0, 0, errors.New("failed to get record coordinates")
 	}
 	return float64(cAlpha), float64(cBeta), nil
@@ -411,7 +481,7 @@ func (c *ContentMPS) GetCoefficients(recordIndex, channel int) (magnitudes, phas
 	magnitudes = make([]float32, numFreqs)
 	phases = make([]float32, numFreqs)
 
-	if !C.GoDAFF_ContentMPS_GetCoefficients(c.handle, C.int(recordIndex), C.int(channel),
+	if !C.DAFFC_ContentMPS_GetCoefficients(c.handle, C.int(recordIndex), C.int(channel),
 		(*C.float)(unsafe.Pointer(&magnitudes[0])), (*C.float)(unsafe.Pointer(&phases[0])), C.int(numFreqs)) {
 		return nil, nil, errors.New("failed to get coefficients")
 	}
@@ -420,12 +490,12 @@ func (c *ContentMPS) GetCoefficients(recordIndex, channel int) (magnitudes, phas
 
 // ContentDFT provides access to DFT coefficient data
 type ContentDFT struct {
-	handle C.GoDAFFContentHandle
+	handle C.DAFFCContentHandle
 }
 
 // GetContentDFT returns a DFT content accessor
 func (r *Reader) GetContentDFT() (*ContentDFT, error) {
-	handle := C.GoDAFF_GetContentDFT(r.handle)
+	handle := C.DAFFC_GetContentDFT(r.handle)
 	if handle == nil {
 		return nil, errors.New("file does not contain DFT data")
 	}
@@ -434,23 +504,23 @@ func (r *Reader) GetContentDFT() (*ContentDFT, error) {
 
 // GetNumDFTCoeffs returns the number of DFT coefficients
 func (c *ContentDFT) GetNumDFTCoeffs() int {
-	return int(C.GoDAFF_ContentDFT_GetNumDFTCoeffs(c.handle))
+	return int(C.DAFFC_ContentDFT_GetNumDFTCoeffs(c.handle))
 }
 
 // IsSymmetric returns true if the DFT data is symmetric
 func (c *ContentDFT) IsSymmetric() bool {
-	return bool(C.GoDAFF_ContentDFT_IsSymmetric(c.handle))
+	return bool(C.DAFFC_ContentDFT_IsSymmetric(c.handle))
 }
 
 // GetNearestNeighbour returns the record index for the given direction
 func (c *ContentDFT) GetNearestNeighbour(phi, theta float64) int {
-	return int(C.GoDAFF_ContentDFT_GetNearestNeighbour(c.handle, C.double(phi), C.double(theta)))
+	return int(C.DAFFC_ContentDFT_GetNearestNeighbour(c.handle, C.double(phi), C.double(theta)))
 }
 
 // GetRecordCoords returns the coordinates for the given record index
 func (c *ContentDFT) GetRecordCoords(recordIndex int) (alpha, beta float64, err error) {
 	var cAlpha, cBeta C.double
-	if !C.GoDAFF_ContentDFT_GetRecordCoords(c.handle, C.int(recordIndex), &cAlpha, &cBeta) {
+	if !C.DAFFC_ContentDFT_GetRecordCoords(c.handle, C.int(recordIndex), &cAlpha, &cBeta) {
 		return 0, 0, errors.New("failed to get record coordinates")
 	}
 	return float64(cAlpha), float64(cBeta), nil
@@ -461,9 +531,136 @@ func (c *ContentDFT) GetDFTCoeffs(recordIndex, channel int) ([]float32, error) {
 	numCoeffs := c.GetNumDFTCoeffs()
 	coeffs := make([]float32, numCoeffs*2) // Complex values: real, imag interleaved
 
-	if !C.GoDAFF_ContentDFT_GetDFTCoeffs(c.handle, C.int(recordIndex), C.int(channel),
+	if !C.DAFFC_ContentDFT_GetDFTCoeffs(c.handle, C.int(recordIndex), C.int(channel),
 		(*C.float)(unsafe.Pointer(&coeffs[0])), C.int(numCoeffs*2)) {
 		return nil, errors.New("failed to get DFT coefficients")
 	}
 	return coeffs, nil
 }
+
+// Batch access (one cgo call for many directions or records, all content types).
+// Record data is laid out as [records][channels][GetRecordLength()] values in a single
+// caller-provided slice, complex values and magnitude-phase pairs are interleaved.
+
+// floatPtr returns the C pointer to the first element of a slice (nil if empty)
+func floatPtr(s []float32) *C.float {
+	if len(s) == 0 {
+		return nil
+	}
+	return (*C.float)(unsafe.Pointer(&s[0]))
+}
+
+// intPtr returns the C pointer to the first element of a slice (nil if empty)
+func intPtr(s []int32) *C.int {
+	if len(s) == 0 {
+		return nil
+	}
+	return (*C.int)(unsafe.Pointer(&s[0]))
+}
+
+// GetRecordLength returns the number of values per channel of the batch record data
+func (r *Reader) GetRecordLength() int {
+	return int(C.DAFFC_GetRecordLength(r.handle))
+}
+
+// GetRecordSize returns the number of values per record of the batch record data (all channels)
+func (r *Reader) GetRecordSize() int {
+	return r.GetNumChannels() * r.GetRecordLength()
+}
+
+// GetNearestNeighbours determines the nearest records of many directions (angles in degrees).
+// The record indices are written to indices, the out of bounds indicators to outOfBounds (may be nil).
+func (r *Reader) GetNearestNeighbours(view View, angles1, angles2 []float32, indices []int32, outOfBounds []bool) error {
+	n := len(angles1)
+	if len(angles2) != n || len(indices) < n || (outOfBounds != nil && len(outOfBounds) < n) {
+		return errors.New("slice lengths do not match")
+	}
+	if n == 0 {
+		return nil
+	}
+
+	var cOutOfBounds *C.bool
+	if outOfBounds != nil {
+		cOutOfBounds = (*C.bool)(unsafe.Pointer(&outOfBounds[0]))
+	}
+	if !C.DAFFC_GetNearestNeighbours(r.handle, C.int(view), floatPtr(angles1), floatPtr(angles2), intPtr(indices),
+		cOutOfBounds, C.size_t(n)) {
+		return errors.New("failed to get nearest neighbours")
+	}
+	return nil
+}
+
+// GetRecords copies the data of many records into dst (at least len(indices) * GetRecordSize() values)
+func (r *Reader) GetRecords(indices []int32, dst []float32) error {
+	if len(indices) == 0 {
+		return nil
+	}
+	if !C.DAFFC_GetRecords(r.handle, intPtr(indices), C.size_t(len(indices)), floatPtr(dst), C.size_t(len(dst))) {
+		return errors.New("failed to get records")
+	}
+	return nil
+}
+
+// GetRecordRange copies the data of the consecutive records [first, first+count) into dst
+// (at least count * GetRecordSize() values), for processing a whole file chunk by chunk
+func (r *Reader) GetRecordRange(first, count int, dst []float32) error {
+	if first < 0 || count < 0 {
+		return errors.New("invalid record range")
+	}
+	if count == 0 {
+		return nil
+	}
+	if !C.DAFFC_GetRecordRange(r.handle, C.int(first), C.size_t(count), floatPtr(dst), C.size_t(len(dst))) {
+		return errors.New("failed to get record range")
+	}
+	return nil
+}
+
+// GetNearestNeighbourRecords copies the data of the nearest records of many directions into dst
+// (at least len(angles1) * GetRecordSize() values). The record indices are written to indices (may be nil).
+func (r *Reader) GetNearestNeighbourRecords(view View, angles1, angles2 []float32, indices []int32,
+	dst []float32) error {
+	n := len(angles1)
+	if len(angles2) != n || (indices != nil && len(indices) < n) {
+		return errors.New("slice lengths do not match")
+	}
+	if n == 0 {
+		return nil
+	}
+	if !C.DAFFC_GetNearestNeighbourRecords(r.handle, C.int(view), floatPtr(angles1), floatPtr(angles2),
+		C.size_t(n), intPtr(indices), floatPtr(dst), C.size_t(len(dst))) {
+		return errors.New("failed to get nearest neighbour records")
+	}
+	return nil
+}
+
+// GetInterpolatedRecords copies the bilinear interpolation of the records surrounding many directions into dst
+// (at least len(angles1) * GetRecordSize() values). Impulse responses, magnitude and DFT spectra only.
+func (r *Reader) GetInterpolatedRecords(view View, angles1, angles2 []float32, dst []float32) error {
+	n := len(angles1)
+	if len(angles2) != n {
+		return errors.New("slice lengths do not match")
+	}
+	if n == 0 {
+		return nil
+	}
+	if !C.DAFFC_GetInterpolatedRecords(r.handle, C.int(view), floatPtr(angles1), floatPtr(angles2), C.size_t(n),
+		floatPtr(dst), C.size_t(len(dst))) {
+		return errors.New("failed to get interpolated records")
+	}
+	return nil
+}
+
+// GetRecordChannelData returns the record data of a channel without copying. The slice borrows the
+// memory of the reader and is only valid until the file is closed (CloseFile, Close or the finalizer
+// of an unreachable reader), it must not be modified. Impulse responses deliver their effective
+// coefficients, which start at offset in the filter. It fails for lazily opened files, magnitude-phase
+// spectra and data that must be converted (e.g. integer impulse responses not opened with OpenDecode).
+func (r *Reader) GetRecordChannelData(recordIndex, channel int) (offset int, data []float32, err error) {
+	var cOffset, cNumValues C.int
+	ptr := C.DAFFC_GetRecordChannelPtr(r.handle, C.int(recordIndex), C.int(channel), &cOffset, &cNumValues)
+	if ptr == nil {
+		return 0, nil, errors.New("record data not available without copying")
+	}
+	return int(cOffset), unsafe.Slice((*float32)(unsafe.Pointer(ptr)), int(cNumValues)), nil
+}
@@ -123,6 +123,9 @@ func TestQuantizationString(t *testing.T) {
 		{daff.QuantizationInt16, "Int16"},
 		{daff.QuantizationInt24, "Int24"},
 		{daff.QuantizationFloat32, "Float32"},
+		{daff.QuantizationFloat16, "Float16"},
+		{daff.QuantizationBFloat16, "BFloat16"},
+		{daff.QuantizationInt16BFP, "Int16BFP"},
 	}
 
 	for _, tt := range tests {
@@ -134,6 +137,90 @@ func TestQuantizationString(t *testing.T) {
 	}
 }
 
+func TestBatchWithoutFile(t *testing.T) {
+	reader, err := daff.NewReader()
+	if err != nil {
+		t.Fatalf("Failed to create reader: %v", err)
+	}
+	defer reader.Close()
+
+	indices := make([]int32, 2)
+	dst := make([]float32, 16)
+	if err := reader.GetNearestNeighbours(daff.ViewObject, []float32{0, 90}, []float32{0, 0}, indices, nil); err == nil {
+		t.Error("GetNearestNeighbours should fail without file")
+	}
+	if err := reader.GetRecords(indices, dst); err == nil {
+		t.Error("GetRecords should fail without file")
+	}
+	if err := reader.GetRecordRange(0, 1, dst); err == nil {
+		t.Error("GetRecordRange should fail without file")
+	}
+	if _, _, err := reader.GetRecordChannelData(0, 0); err == nil {
+		t.Error("GetRecordChannelData should fail without file")
+	}
+}
+
+// Test files of the C interface (bindings/c/testdata): 2 channels, 16 taps at 44.1 kHz on a
+// 30 degree grid, impulse at tap 4 (0.25 left, 0.5 right), taps 5 and 6 hold alpha/360 and beta/180
+const testdataDir = "../c/testdata/"
+
+// Test files with their quantization
+var testdataFiles = []struct {
+	name         string
+	quantization daff.Quantization
+}{
+	{"ir_int16.daff", daff.QuantizationInt16},
+	{"ir_float16.daff", daff.QuantizationFloat16},
+	{"ir_bfloat16.daff", daff.QuantizationBFloat16},
+	{"ir_int16_bfp.daff", daff.QuantizationInt16BFP},
+}
+
+func TestImpulseResponseQuantizations(t *testing.T) {
+	for _, tt := range testdataFiles {
+		t.Run(tt.name, func(t *testing.T) {
+			reader, err := daff.NewReader()
+			if err != nil {
+				t.Fatalf("Failed to create reader: %v", err)
+			}
+			defer reader.Close()
+
+			if err := reader.OpenFile(testdataDir + tt.name); err != nil {
+				t.Fatalf("Failed to open file: %v", err)
+			}
+			defer reader.CloseFile()
+
+			if ct := reader.GetContentType(); ct != daff.ContentTypeIR {
+				t.Fatalf("Expected content type %v, got %v (%d)", daff.ContentTypeIR, ct, int(ct))
+			}
+			if q := reader.GetQuantization(); q != tt.quantization {
+				t.Fatalf("Expected quantization %v, got %v (%d)", tt.quantization, q, int(q))
+			}
+			if reader.GetNumChannels() != 2 || reader.GetNumRecords() != 62 {
+				t.Fatalf("Expected 2 channels and 62 records, got %d and %d", reader.GetNumChannels(),
+					reader.GetNumRecords())
+			}
+
+			ir, err := reader.GetContentIR()
+			if err != nil {
+				t.Fatalf("Failed to get IR content: %v", err)
+			}
+			if ir.GetFilterLength() != 16 || ir.GetSamplerate() != 44100 {
+				t.Fatalf("Expected 16 taps at 44100 Hz, got %d at %d Hz", ir.GetFilterLength(), ir.GetSamplerate())
+			}
+
+			for channel, expected := range []float32{0.25, 0.5} {
+				coeffs, err := ir.GetFilterCoeffs(0, channel)
+				if err != nil {
+					t.Fatalf("Failed to get filter coefficients: %v", err)
+				}
+				if d := coeffs[4] - expected; d < -1e-3 || d > 1e-3 {
+					t.Errorf("Channel %d: expected %v at tap 4, got %v", channel, expected, coeffs[4])
+				}
+			}
+		})
+	}
+}
+
 // Note: Integration tests require actual DAFF files.
 // Add your test files to the testdata directory and uncomment the following tests:
 
@@ -160,6 +247,34 @@ func TestOpenFile(t *testing.T) {
 	}
 }
 
+func TestMemoryFootprint(t *testing.T) {
+	reader, err := daff.NewReader()
+	if err != nil {
+		t.Fatalf("Failed to create reader: %v", err)
+	}
+	defer reader.Close()
+
+	if err := reader.OpenFile("testdata/example.daff"); err != nil {
+		t.Fatalf("Failed to open file: %v", err)
+	}
+
+	footprint, err := reader.GetMemoryFootprint()
+	if err != nil {
+		t.Fatalf("Failed to get memory footprint: %v", err)
+	}
+
+	if footprint.Total == 0 || footprint.RecordData > footprint.Total {
+		t.Errorf("Invalid memory footprint: %+v", footprint)
+	}
+
+	reader.CloseFile()
+
+	footprint, err = reader.GetMemoryFootprint()
+	if err != nil || footprint.Total != 0 {
+		t.Errorf("Expected an empty memory footprint after closing, got %+v", footprint)
+	}
+}
+
 func TestImpulseResponse(t *testing.T) {
 	reader, err := daff.NewReader()
 	if err != nil {
@@ -0,0 +1,82 @@
+%
+%  OpenDAFF
+%
+
+function DAFFBenchmark( filepath, queries, fetches, opens )
+%DAFFBENCHMARK Matlab driver of the cross-language binding benchmark
+%   Runs the workload of tests/benchmark/BindingBenchmark.cpp through the
+%   DAFFv17 mex and prints the results in its CSV format. The workload file
+%   is written by the native baseline (BindingBenchmark -w),
+%   tests/benchmark/binding_benchmark.py runs both and reports the per-call
+%   overhead of the binding.
+%
+%   DAFFBenchmark( filepath, [queries], [fetches], [opens] )
+
+    if nargin < 2, queries = 1000000; end;
+    if nargin < 3, fetches = 100000; end;
+    if nargin < 4, opens = 50; end;
+
+    pool = 4096; % Size of the query pool (also the batch size)
+
+    fprintf( 'binding,operation,variant,calls,ns_per_call,checksum\n' );
+
+    % Retained readers are released after every close, so every open parses the file
+    t0 = tic;
+    for i = 1:opens
+        h = DAFFv17( 'open', filepath );
+        DAFFv17( 'close', h );
+        DAFFv17( 'clearCache' );
+    end
+    print_result( 'open', 'call', opens, toc( t0 ), 0 );
+
+    h = DAFFv17( 'open', filepath );
+    props = DAFFv17( 'getProperties', h );
+    [ azimuths, elevations, records ] = query_pool( pool, props.numRecords );
+
+    % Nearest neighbours, one call per direction and vectorized over the query pool
+    checksum = 0;
+    t0 = tic;
+    for i = 0:queries-1
+        j = bitand( i, pool - 1 ) + 1;
+        checksum = checksum + DAFFv17( 'getNearestNeighbourIndex', h, 'object', azimuths( j ), elevations( j ) ) - 1;
+    end
+    print_result( 'nearest_neighbour', 'call', queries, toc( t0 ), checksum );
+
+    checksum = 0;
+    t0 = tic;
+    for i = 0:pool:queries-1
+        n = min( pool, queries - i );
+        idx = DAFFv17( 'getNearestNeighbourIndex', h, 'object', azimuths( 1:n ), elevations( 1:n ) );
+        checksum = checksum + sum( idx ) - n;
+    end
+    print_result( 'nearest_neighbour', 'batch', queries, toc( t0 ), checksum );
+
+    % Record fetches, a double matrix [channels x values] per call
+    checksum = 0;
+    t0 = tic;
+    for i = 0:fetches-1
+        data = DAFFv17( 'getRecordByIndex', h, records( bitand( i, pool - 1 ) + 1 ) );
+        checksum = checksum + data( 1, 1 );
+    end
+    print_result( 'record', 'call', fetches, toc( t0 ), checksum );
+
+    DAFFv17( 'close', h );
+end
+
+function [ azimuths, elevations, records ] = query_pool( pool, num_records )
+%QUERY_POOL Same directions and (one-based) record indices as the native
+%baseline, in single precision like its float arithmetic
+    state = 12345;
+    values = zeros( 3 * pool, 1, 'single' );
+    for i = 1:3 * pool
+        state = mod( state * 1664525 + 1013904223, 2^32 );
+        values( i ) = single( floor( state / 256 ) ) / single( 16777216 );
+    end
+    azimuths = single( 360 ) * values( 1:3:end ) - single( 180 );
+    elevations = single( 180 ) * values( 2:3:end ) - single( 90 );
+    records = double( min( floor( values( 3:3:end ) * single( num_records ) ), num_records - 1 ) ) + 1;
+end
+
+function print_result( operation, variant, calls, seconds, checksum )
+    fprintf( 'matlab,%s,%s,%d,%.2f,%.6f\n', operation, variant, calls, 1e9 * seconds / max( calls, 1 ), checksum );
+end
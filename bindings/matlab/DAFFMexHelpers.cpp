@@ -110,3 +110,22 @@ bool getRealScalar(const mxArray* A, double& dest)
 	dest = *mxGetPr(A);
 	return true;
 }
+
+bool getRealArray(const mxArray* A, std::vector<float>& dest)
+{
+	if (mxIsComplex(A) || (!mxIsDouble(A) && !mxIsSingle(A)))
+		return false;
+
+	size_t n = mxGetNumberOfElements(A);
+	dest.resize(n);
+	if (mxIsDouble(A)) {
+		const double* data = mxGetPr(A);
+		for (size_t i = 0; i < n; i++)
+			dest[i] = (float)data[i];
+	} else {
+		const float* data = (const float*)mxGetData(A);
+		std::copy(data, data + n, dest.begin());
+	}
+
+	return true;
+}
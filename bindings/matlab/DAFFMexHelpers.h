@@ -45,5 +45,6 @@ bool getIntegerScalar(const mxArray* A, int& dest);
 bool getIntegerVector(const mxArray* A, std::vector<int>& dest);
 bool getString(const mxArray* A, std::string& dest);
 bool getRealScalar(const mxArray* A, double& dest);
+bool getRealArray(const mxArray* A, std::vector<float>& dest);
 
 #endif  // IW_DAFF_MATLAB_HELPERS
@@ -37,6 +37,8 @@
 // STL includes
 #include <algorithm>
 #include <map>
+#include <memory>
+#include <vector>
 
 // Project includes
 #include "DAFFMexHelpers.h"
@@ -47,12 +49,15 @@ void Close(int, mxArray**, int, const mxArray**);
 void GetMetadata(int, mxArray**, int, const mxArray**);
 void GetRecordMetadata(int, mxArray**, int, const mxArray**);
 void GetProperties(int, mxArray**, int, const mxArray**);
+void GetMemoryFootprint(int, mxArray**, int, const mxArray**);
 void GetRecordCoords(int, mxArray**, int, const mxArray**);
 void GetRecordByIndex(int, mxArray**, int, const mxArray**);
 void GetNearestNeighbourRecord(int, mxArray**, int, const mxArray**);
+void GetInterpolatedRecord(int, mxArray**, int, const mxArray**);
 void GetCellRecords(int, mxArray**, int, const mxArray**);
 void GetNearestNeighbourIndex(int, mxArray**, int, const mxArray**);
 void GetCell(int, mxArray**, int, const mxArray**);
+void ClearCache(int, mxArray**, int, const mxArray**);
 
 // Handle datatype
 typedef int32_t HANDLE;
@@ -60,10 +65,10 @@ typedef int32_t HANDLE;
 // Reader wrapper/adapter
 class TARGET {
   public:
-	DAFFReader* pReader;  // Associated reader
-	float* pfBuffer;      // Help buffer for conversions
+	std::shared_ptr<const DAFFReader> pReader;  // Associated reader (shared by all handles of the file)
+	float* pfBuffer;                            // Help buffer for conversions
 
-	inline TARGET(DAFFReader* pReader)
+	inline TARGET(const std::shared_ptr<const DAFFReader>& pReader)
 	{
 		this->pReader = pReader;
 
@@ -97,11 +102,7 @@ class TARGET {
 		}
 	}
 
-	inline ~TARGET()
-	{
-		delete pReader;
-		delete[] pfBuffer;
-	}
+	inline ~TARGET() { delete[] pfBuffer; }
 };
 
 // Maps handle => reader
@@ -112,6 +113,11 @@ const mxClassID HANDLE_CLASS_ID = mxINT32_CLASS;
 HANDLE hHandleCount = 1;  // Global handle counter
 HANDLE_MAP mHandles;      // Map handle->reader
 
+// Readers kept loaded after closing, so that later calls open the same files without loading them again
+// (filename => reader, released by the command 'clearCache')
+typedef std::map<std::string, std::shared_ptr<const DAFFReader> > READER_MAP;
+READER_MAP mRetainedReaders;
+
 
 /* +------------------------------------------------------+
    |                                                      |
@@ -187,7 +193,7 @@ void mexFunction(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 		mexPrintf("      Shows this information\n\n\n");
 
 		mexPrintf("  Command \"open\"\n\n");
-		mexPrintf("      Open a DAFF file\n\n");
+		mexPrintf("      Open a DAFF file (files opened before are not loaded again, see \"clearCache\")\n\n");
 		mexPrintf("      Syntax:     [handle] = DAFF('open', filename)\n\n");
 		mexPrintf("      Parameters: filename	char		Filename of the DAFF file\n\n");
 		mexPrintf("      Returns:    handle     1x1 int32	Handle\n\n\n");
@@ -198,6 +204,12 @@ void mexFunction(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 		mexPrintf("      Parameters: handle		1x1 int32	Handle of the opened DAFF file\n\n");
 		mexPrintf("      Returns:    nothing\n\n\n");
 
+		mexPrintf("  Command \"clearCache\"\n\n");
+		mexPrintf("      Releases the readers of closed DAFF files, which are otherwise kept loaded for reuse\n\n");
+		mexPrintf("      Syntax:     [] = DAFF('clearCache')\n\n");
+		mexPrintf("      Parameters: None\n\n");
+		mexPrintf("      Returns:    nothing\n\n\n");
+
 		mexPrintf("  Command \"getMetadata\"\n\n");
 		mexPrintf("      Returns the metadata of an opened DAFF file\n\n");
 		mexPrintf("      Syntax:     [metadata] = DAFF('getMetadata', handle)\n\n");
@@ -218,6 +230,12 @@ void mexFunction(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 		mexPrintf("      Parameters: handle		1x1 int32	Handle of the opened DAFF file\n\n");
 		mexPrintf("      Returns:    props		struct		Properties structure\n\n\n");
 
+		mexPrintf("  Command \"getMemoryFootprint\"\n\n");
+		mexPrintf("      Returns the heap memory held by the reader of an opened DAFF file [bytes]\n\n");
+		mexPrintf("      Syntax:     [footprint] = DAFF('getMemoryFootprint', handle)\n\n");
+		mexPrintf("      Parameters: handle		1x1 int32	Handle of the opened DAFF file\n\n");
+		mexPrintf("      Returns:    footprint	struct		Bytes per category\n\n\n");
+
 		mexPrintf("  Command \"getRecordCoords\"\n\n");
 		mexPrintf("      Returns the coordinates of a grid point\n\n");
 		mexPrintf("      Syntax:     [coords] = DAFF('getRecordCoords', handle, view, index)\n\n");
@@ -236,17 +254,35 @@ void mexFunction(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 			"      Returns:    data		MxN double	Matrix containing the record data (rows => channel data)\n\n\n");
 
 		mexPrintf("  Command \"getNearestNeighbourRecord\"\n\n");
-		mexPrintf("      Returns the data at the nearest neighbour grid point to the given direction\n\n");
+		mexPrintf("      Returns the data at the nearest neighbour grid points to the given directions\n\n");
 		mexPrintf(
 			"      Syntax:     [data, oob] = DAFF('getNearestNeighbourRecord', handle, view, angle1, angle2)\n\n");
 		mexPrintf("      Parameters: handle		1x1 int32	Handle of the opened DAFF file\n");
 		mexPrintf("                  view		char		View ('data' => Data spherical coordinates, 'object' => "
 				  "Object spherical coordinates\n");
-		mexPrintf("                  angle1		1x1 real	First angle (For 'data' alpha; for 'object' azimuth)\n");
-		mexPrintf("                  angle2		1x1 real	Second angle (For 'data' beta; for 'object' elevation)\n");
-		mexPrintf("      Returns:    data		MxN double	Matrix containing the record data (rows => channel "
-				  "data)\n");
-		mexPrintf("                  oob 		1x1 logical Out-of-bounds indicator\n");
+		mexPrintf("                  angle1		MxN real	First angles (For 'data' alpha; for 'object' "
+				  "azimuth)\n");
+		mexPrintf("                  angle2		MxN real	Second angles (For 'data' beta; for 'object' "
+				  "elevation)\n");
+		mexPrintf("      Returns:    data		CxLxK double	Record data of the K = M*N directions (rows => "
+				  "channel data)\n");
+		mexPrintf("                  oob 		MxN logical	Out-of-bounds indicators\n");
+		mexPrintf("      Note:       The angles are arrays of the same size, a scalar angle is expanded to the size "
+				  "of the other one\n\n\n");
+
+		mexPrintf("  Command \"getInterpolatedRecord\"\n\n");
+		mexPrintf("      Returns the data bilinearly interpolated from the surrounding grid points (IR, MS and DFT "
+				  "content)\n\n");
+		mexPrintf("      Syntax:     [data] = DAFF('getInterpolatedRecord', handle, view, angle1, angle2)\n\n");
+		mexPrintf("      Parameters: handle		1x1 int32	Handle of the opened DAFF file\n");
+		mexPrintf("                  view		char		View ('data' => Data spherical coordinates, 'object' => "
+				  "Object spherical coordinates\n");
+		mexPrintf("                  angle1		MxN real	First angles (For 'data' alpha; for 'object' "
+				  "azimuth)\n");
+		mexPrintf("                  angle2		MxN real	Second angles (For 'data' beta; for 'object' "
+				  "elevation)\n");
+		mexPrintf("      Returns:    data		CxLxK double	Interpolated data of the K = M*N directions (rows => "
+				  "channel data)\n\n\n");
 
 
 		mexPrintf("  Command \"getCellRecords\"\n\n");
@@ -264,15 +300,17 @@ void mexFunction(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 		mexPrintf("                  oob 		1x1 logical            Out-of-bounds indicator\n");
 
 		mexPrintf("  Command \"getNearestNeighbourIndex\"\n\n");
-		mexPrintf("      Returns the data at the nearest neighbour grid point to the given direction\n\n");
+		mexPrintf("      Returns the indices of the nearest neighbour grid points to the given directions\n\n");
 		mexPrintf("      Syntax:     [index, oob] = DAFF('getNearestNeighbour', handle, view, angle1, angle2)\n\n");
 		mexPrintf("      Parameters: handle		1x1 int32	Handle of the opened DAFF file\n");
 		mexPrintf("                  view		char		View ('data' => Data spherical coordinates, 'object' => "
 				  "Object spherical coordinates\n");
-		mexPrintf("                  angle1		1x1 real	First angle (For 'data' alpha; for 'object' azimuth)\n");
-		mexPrintf("                  angle2		1x1 real	Second angle (For 'data' beta; for 'object' elevation)\n");
-		mexPrintf("      Returns:    index		1x1 integer	Nearest neighbour's record index\n");
-		mexPrintf("                  oob		1x1 logical	Out of bounds flag\n\n\n");
+		mexPrintf("                  angle1		MxN real	First angles (For 'data' alpha; for 'object' "
+				  "azimuth)\n");
+		mexPrintf("                  angle2		MxN real	Second angles (For 'data' beta; for 'object' "
+				  "elevation)\n");
+		mexPrintf("      Returns:    index		MxN integer	Nearest neighbours' record indices\n");
+		mexPrintf("                  oob		MxN logical	Out of bounds flags\n\n\n");
 
 		mexPrintf("  Command \"getCell\"\n\n");
 		mexPrintf("      Returns the data at the nearest neighbour grid point to the given direction\n\n");
@@ -319,6 +357,11 @@ void mexFunction(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 		bMatch = true;
 	}
 
+	if (sCommand == "getmemoryfootprint") {
+		GetMemoryFootprint(nlhs, plhs, nrhs, prhs);
+		bMatch = true;
+	}
+
 	if (sCommand == "getrecordcoords") {
 		GetRecordCoords(nlhs, plhs, nrhs, prhs);
 		bMatch = true;
@@ -334,6 +377,11 @@ void mexFunction(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 		bMatch = true;
 	}
 
+	if (sCommand == "getinterpolatedrecord") {
+		GetInterpolatedRecord(nlhs, plhs, nrhs, prhs);
+		bMatch = true;
+	}
+
 	if (sCommand == "getcellrecords") {
 		GetCellRecords(nlhs, plhs, nrhs, prhs);
 		bMatch = true;
@@ -349,6 +397,11 @@ void mexFunction(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 		bMatch = true;
 	}
 
+	if (sCommand == "clearcache") {
+		ClearCache(nlhs, plhs, nrhs, prhs);
+		bMatch = true;
+	}
+
 	if (!bMatch)
 		mexErrMsgTxt("Invalid command");
 }
@@ -372,14 +425,15 @@ void Open(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 	if (!getString(prhs[1], sFilename))
 		mexErrMsgTxt("Parameter FILENAME must be a string");
 
-	DAFFReader* pReader = DAFFReader::create();
-	iError = pReader->openFile(sFilename);
+	// Files that are already opened (or retained after closing) and unmodified are not loaded again
+	std::shared_ptr<const DAFFReader> pReader;
+	iError = DAFFContentCache::open(sFilename, pReader);
 	if (iError != DAFF_NO_ERROR) {
 		sError = DAFFUtils::StrError(iError);
-		delete pReader;
 		mexPrintf("Errorcode %d\n", iError);
 		mexErrMsgTxt(sError.c_str());
 	}
+	mRetainedReaders[sFilename] = pReader;
 
 	HANDLE hHandle = hHandleCount++;
 	mHandles.insert(std::pair<int, TARGET*>(hHandle, new TARGET(pReader)));
@@ -399,12 +453,21 @@ void Close(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 	mHandles.erase(it);
 }
 
+void ClearCache(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
+{
+	if (nrhs != 1)
+		mexErrMsgTxt("This command requires no arguments");
+
+	// Readers of open handles stay loaded until they are closed
+	mRetainedReaders.clear();
+}
+
 void GetFilename(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 {
 	if (nrhs != 2)
 		mexErrMsgTxt("This command requires one argument");
 
-	DAFFReader* pReader = GetHandleTarget(prhs[1])->pReader;
+	const DAFFReader* pReader = GetHandleTarget(prhs[1])->pReader.get();
 
 	std::string sFilename = pReader->getFilename();
 
@@ -417,7 +480,7 @@ void GetFileFormatVersion(int nlhs, mxArray* plhs[], int nrhs, const mxArray* pr
 	if (nrhs != 2)
 		mexErrMsgTxt("This command requires one argument");
 
-	DAFFReader* pReader = GetHandleTarget(prhs[1])->pReader;
+	const DAFFReader* pReader = GetHandleTarget(prhs[1])->pReader.get();
 
 	int iVersion = pReader->getFileFormatVersion();
 
@@ -431,7 +494,7 @@ void GetContentType(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 	if (nrhs != 2)
 		mexErrMsgTxt("This command requires one argument");
 
-	DAFFReader* pReader = GetHandleTarget(prhs[1])->pReader;
+	const DAFFReader* pReader = GetHandleTarget(prhs[1])->pReader.get();
 
 	int iType = pReader->getContentType();
 	std::string sType = DAFFUtils::StrShortContentType(iType);
@@ -489,7 +552,7 @@ void GetMetadata(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 	if (nrhs != 2)
 		mexErrMsgTxt("This command requires one argument");
 
-	DAFFReader* pReader = GetHandleTarget(prhs[1])->pReader;
+	const DAFFReader* pReader = GetHandleTarget(prhs[1])->pReader.get();
 	const DAFFMetadata* pMetadata = pReader->getMetadata();
 
 	GetMetadataMatlab(pMetadata, plhs[0]);
@@ -525,7 +588,7 @@ void GetProperties(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 	if (nrhs != 2)
 		mexErrMsgTxt("This command requires one argument");
 
-	DAFFReader* pReader = GetHandleTarget(prhs[1])->pReader;
+	const DAFFReader* pReader = GetHandleTarget(prhs[1])->pReader.get();
 	const DAFFProperties* pProps = pReader->getProperties();
 	int iContentType = pReader->getContentType();
 
@@ -552,6 +615,7 @@ void GetProperties(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 	vsFields.push_back("orientation");
 	vsFields.push_back("orientationDefault");
 	vsFields.push_back("fullSphere");
+	vsFields.push_back("regularGrid");
 
 	switch (iContentType) {
 	case DAFF_IMPULSE_RESPONSE:
@@ -606,6 +670,12 @@ void GetProperties(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 		sQuantization = "int16";
 	if (iQuantization == DAFF_INT24)
 		sQuantization = "int24";
+	if (iQuantization == DAFF_FLOAT16)
+		sQuantization = "float16";
+	if (iQuantization == DAFF_BFLOAT16)
+		sQuantization = "bfloat16";
+	if (iQuantization == DAFF_INT16_BFP)
+		sQuantization = "int16_bfp";
 	if (iQuantization == DAFF_FLOAT32)
 		sQuantization = "float32";
 	mxSetField(pStruct, 0, "quantization", mxCreateString(sQuantization.c_str()));
@@ -672,6 +742,9 @@ void GetProperties(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 	// Full sphere
 	mxSetField(pStruct, 0, "fullSphere", mxCreateLogicalScalar(pProps->coversFullSphere()));
 
+	// Regular grid
+	mxSetField(pStruct, 0, "regularGrid", mxCreateLogicalScalar(pProps->isRegularGrid()));
+
 	if (iContentType == DAFF_IMPULSE_RESPONSE) {
 		DAFFContentIR* pContent = dynamic_cast<DAFFContentIR*>(pReader->getContent());
 
@@ -742,12 +815,35 @@ void GetProperties(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 	plhs[0] = pStruct;
 }
 
+void GetMemoryFootprint(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
+{
+	if (nrhs != 2)
+		mexErrMsgTxt("This command requires one argument");
+
+	DAFFMemoryFootprint oFootprint;
+	GetHandleTarget(prhs[1])->pReader->getMemoryFootprint(oFootprint);
+
+	const char* ppszFieldNames[] = {"headers",  "recordDescriptors", "recordData", "recordCache",
+									"metadata", "statistics",        "total",      "mapped"};
+	mxArray* pStruct = mxCreateStructMatrix(1, 1, 8, ppszFieldNames);
+	mxSetField(pStruct, 0, "headers", mxCreateDoubleScalar((double)oFootprint.ui64Headers));
+	mxSetField(pStruct, 0, "recordDescriptors", mxCreateDoubleScalar((double)oFootprint.ui64RecordDescriptors));
+	mxSetField(pStruct, 0, "recordData", mxCreateDoubleScalar((double)oFootprint.ui64RecordData));
+	mxSetField(pStruct, 0, "recordCache", mxCreateDoubleScalar((double)oFootprint.ui64RecordCache));
+	mxSetField(pStruct, 0, "metadata", mxCreateDoubleScalar((double)oFootprint.ui64Metadata));
+	mxSetField(pStruct, 0, "statistics", mxCreateDoubleScalar((double)oFootprint.ui64Statistics));
+	mxSetField(pStruct, 0, "total", mxCreateDoubleScalar((double)oFootprint.ui64Total));
+	mxSetField(pStruct, 0, "mapped", mxCreateDoubleScalar((double)oFootprint.ui64Mapped));
+
+	plhs[0] = pStruct;
+}
+
 void GetRecordCoords(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 {
 	if (nrhs != 4)
 		mexErrMsgTxt("This command requires three arguments");
 
-	DAFFReader* pReader = GetHandleTarget(prhs[1])->pReader;
+	const DAFFReader* pReader = GetHandleTarget(prhs[1])->pReader.get();
 
 	std::string sView;
 	if (!getString(prhs[2], sView))
@@ -780,112 +876,123 @@ void GetRecordCoords(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 	pdData[1] = (double)fAngle2;
 }
 
-// Internal function: Fetch a record from the content,
-// convert it to double and return it as a Matlab matrix
-void GetRecordMatlab(DAFFReader* pReader, float* pConvBuffer, int iRecordIndex, mxArray*& pResult)
+// Internal function: Number of values per channel of a record,
+// bComplex is set if the values are delivered as complex numbers
+int GetRecordLengthMatlab(const DAFFReader* pReader, bool& bComplex)
 {
-	int iContentType = pReader->getContentType();
-	int iChannels = pReader->getProperties()->getNumberOfChannels();
-
-	if (iContentType == DAFF_IMPULSE_RESPONSE) {
-		DAFFContentIR* pContent = dynamic_cast<DAFFContentIR*>(pReader->getContent());
-		int iFilterLength = pContent->getFilterLength();
-
-		// Create the result matrix (num rows = num of channels, num cols = element size)
-		pResult = mxCreateDoubleMatrix(iChannels, iFilterLength, mxREAL);
-		double* pdData = mxGetPr(pResult);
-
-		// Copy the data
-		for (int c = 0; c < iChannels; c++) {
-			// Get the impulse response
-			pContent->getFilterCoeffs(iRecordIndex, c, pConvBuffer);
-
-			// Convert it to double precision (64-bit)
-			for (int i = 0; i < iFilterLength; i++)
-				pdData[i * iChannels + c] = (double)pConvBuffer[i];
-		}
+	bComplex = false;
+	switch (pReader->getContentType()) {
+		case DAFF_IMPULSE_RESPONSE:
+			return dynamic_cast<DAFFContentIR*>(pReader->getContent())->getFilterLength();
+		case DAFF_MAGNITUDE_SPECTRUM:
+			return dynamic_cast<DAFFContentMS*>(pReader->getContent())->getNumFrequencies();
+		case DAFF_PHASE_SPECTRUM:
+			return dynamic_cast<DAFFContentPS*>(pReader->getContent())->getNumFrequencies();
+		case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+			bComplex = true;
+			return dynamic_cast<DAFFContentMPS*>(pReader->getContent())->getNumFrequencies();
+		case DAFF_DFT_SPECTRUM:
+			bComplex = true;
+			return dynamic_cast<DAFFContentDFT*>(pReader->getContent())->getNumDFTCoeffs();
 	}
+	return 0;
+}
 
-	if (iContentType == DAFF_MAGNITUDE_SPECTRUM) {
-		DAFFContentMS* pContent = dynamic_cast<DAFFContentMS*>(pReader->getContent());
-		int iNumFreqs = pContent->getNumFrequencies();
-
-		// Create the result matrix (num rows = num of channels, num cols = num freqs)
-		pResult = mxCreateDoubleMatrix(iChannels, iNumFreqs, mxREAL);
-		double* pdData = mxGetPr(pResult);
-
-		// Copy the data
-		for (int c = 0; c < iChannels; c++) {
-			// Get the magnitude spectrum
-			pContent->getMagnitudes(iRecordIndex, c, pConvBuffer);
-
-			// Convert it to double precision (64-bit)
-			for (int i = 0; i < iNumFreqs; i++)
-				pdData[i * iChannels + c] = (double)pConvBuffer[i];
-		}
-	}
-
-	if (iContentType == DAFF_PHASE_SPECTRUM) {
-		DAFFContentPS* pContent = dynamic_cast<DAFFContentPS*>(pReader->getContent());
-		int iNumFreqs = pContent->getNumFrequencies();
-
-		// Create the result matrix (num rows = num of channels, num cols = num freqs)
-		pResult = mxCreateDoubleMatrix(iChannels, iNumFreqs, mxREAL);
-		double* pdData = mxGetPr(pResult);
-
-		// Copy the data
-		for (int c = 0; c < iChannels; c++) {
-			// Get the magnitude spectrum
-			pContent->getPhases(iRecordIndex, c, pConvBuffer);
+// Internal function: Fetch a record from the content and convert it to double
+// into a column-major (channels x length) matrix (pdImagData only for complex records)
+void CopyRecordMatlab(const DAFFReader* pReader, float* pConvBuffer, int iRecordIndex, double* pdRealData,
+					  double* pdImagData)
+{
+	int iContentType = pReader->getContentType();
+	int iChannels = pReader->getProperties()->getNumberOfChannels();
+	bool bComplex;
+	int iLength = GetRecordLengthMatlab(pReader, bComplex);
 
-			// Convert it to double precision (64-bit)
-			for (int i = 0; i < iNumFreqs; i++)
-				pdData[i * iChannels + c] = (double)pConvBuffer[i];
+	for (int c = 0; c < iChannels; c++) {
+		// Get the channel data
+		switch (iContentType) {
+			case DAFF_IMPULSE_RESPONSE:
+				dynamic_cast<DAFFContentIR*>(pReader->getContent())->getFilterCoeffs(iRecordIndex, c, pConvBuffer);
+				break;
+			case DAFF_MAGNITUDE_SPECTRUM:
+				dynamic_cast<DAFFContentMS*>(pReader->getContent())->getMagnitudes(iRecordIndex, c, pConvBuffer);
+				break;
+			case DAFF_PHASE_SPECTRUM:
+				dynamic_cast<DAFFContentPS*>(pReader->getContent())->getPhases(iRecordIndex, c, pConvBuffer);
+				break;
+			case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+				dynamic_cast<DAFFContentMPS*>(pReader->getContent())->getCoefficientsRI(iRecordIndex, c, pConvBuffer);
+				break;
+			case DAFF_DFT_SPECTRUM:
+				dynamic_cast<DAFFContentDFT*>(pReader->getContent())->getDFTCoeffs(iRecordIndex, c, pConvBuffer);
+				break;
 		}
-	}
 
-	if (iContentType == DAFF_MAGNITUDE_PHASE_SPECTRUM) {
-		DAFFContentMPS* pContent = dynamic_cast<DAFFContentMPS*>(pReader->getContent());
-		int iNumFreqs = pContent->getNumFrequencies();
-
-		// Create the result matrix (num rows = num of channels, num cols = the element size)
-		pResult = mxCreateDoubleMatrix(iChannels, iNumFreqs, mxCOMPLEX);
-		double* pdRealData = mxGetPr(pResult);
-		double* pdImagData = mxGetPi(pResult);
-
-		// Copy the data
-		for (int c = 0; c < iChannels; c++) {
-			// Get the impulse response
-			pContent->getCoefficientsRI(iRecordIndex, c, pConvBuffer);
-
-			// Convert it to double precision (64-bit) complex values
-			for (int i = 0; i < iNumFreqs; i++) {
+		// Convert it to double precision (64-bit), complex values are interleaved in the buffer
+		if (bComplex) {
+			for (int i = 0; i < iLength; i++) {
 				pdRealData[i * iChannels + c] = (double)pConvBuffer[2 * i];
 				pdImagData[i * iChannels + c] = (double)pConvBuffer[2 * i + 1];
 			}
+		} else {
+			for (int i = 0; i < iLength; i++)
+				pdRealData[i * iChannels + c] = (double)pConvBuffer[i];
 		}
 	}
+}
 
-	if (iContentType == DAFF_DFT_SPECTRUM) {
-		DAFFContentDFT* pContent = dynamic_cast<DAFFContentDFT*>(pReader->getContent());
-		int iNumDFTCoeffs = pContent->getNumDFTCoeffs();
+// Internal function: Create the result array of iNumRecords records
+// (channels x length for a single record, channels x length x records otherwise)
+mxArray* CreateRecordsMatlab(const DAFFReader* pReader, size_t iNumRecords)
+{
+	bool bComplex;
+	mwSize piDims[3];
+	piDims[0] = (mwSize)pReader->getProperties()->getNumberOfChannels();
+	piDims[1] = (mwSize)GetRecordLengthMatlab(pReader, bComplex);
+	piDims[2] = (mwSize)iNumRecords;
+	return mxCreateNumericArray((iNumRecords == 1 ? 2 : 3), piDims, mxDOUBLE_CLASS, (bComplex ? mxCOMPLEX : mxREAL));
+}
 
-		// Create the result matrix (num rows = num of channels, num cols = the element size)
-		pResult = mxCreateDoubleMatrix(iChannels, iNumDFTCoeffs, mxCOMPLEX);
-		double* pdRealData = mxGetPr(pResult);
-		double* pdImagData = mxGetPi(pResult);
+// Internal function: Fetch a record from the content,
+// convert it to double and return it as a Matlab matrix
+void GetRecordMatlab(const DAFFReader* pReader, float* pConvBuffer, int iRecordIndex, mxArray*& pResult)
+{
+	pResult = CreateRecordsMatlab(pReader, 1);
+	CopyRecordMatlab(pReader, pConvBuffer, iRecordIndex, mxGetPr(pResult), mxGetPi(pResult));
+}
 
-		// Copy the data
-		for (int c = 0; c < iChannels; c++) {
-			// Get the impulse response
-			pContent->getDFTCoeffs(iRecordIndex, c, pConvBuffer);
+// Internal function: Parse the view and the direction angles of a command (parameters 3-5)
+// The angles are scalars or arrays of the same size, scalars are expanded to the size of the other angle.
+// The array that determines the size of the results is returned in pShape.
+void GetDirectionsMatlab(const mxArray* prhs[], int& iView, std::vector<float>& vfAngles1,
+						 std::vector<float>& vfAngles2, const mxArray*& pShape)
+{
+	std::string sView;
+	if (!getString(prhs[2], sView))
+		mexErrMsgTxt("Parameter VIEW must be a string");
+	std::transform(sView.begin(), sView.end(), sView.begin(), tolower);
 
-			// Convert it to double precision (64-bit) complex values
-			for (int i = 0; i < iNumDFTCoeffs; i++) {
-				pdRealData[i * iChannels + c] = (double)pConvBuffer[2 * i];
-				pdImagData[i * iChannels + c] = (double)pConvBuffer[2 * i + 1];
-			}
-		}
+	iView = -1;
+	if (sView == "data")
+		iView = DAFF_DATA_VIEW;
+	if (sView == "object")
+		iView = DAFF_OBJECT_VIEW;
+	if (iView == -1)
+		mexErrMsgTxt("Invalid view");
+
+	if (!getRealArray(prhs[3], vfAngles1))
+		mexErrMsgTxt("Parameter ANGLE1 must be a real-valued array");
+	if (!getRealArray(prhs[4], vfAngles2))
+		mexErrMsgTxt("Parameter ANGLE2 must be a real-valued array");
+
+	pShape = prhs[3];
+	if ((vfAngles1.size() == 1) && (vfAngles2.size() != 1)) {
+		vfAngles1.assign(vfAngles2.size(), vfAngles1[0]);
+		pShape = prhs[4];
+	} else if ((vfAngles2.size() == 1) && (vfAngles1.size() != 1)) {
+		vfAngles2.assign(vfAngles1.size(), vfAngles2[0]);
+	} else if (vfAngles1.size() != vfAngles2.size()) {
+		mexErrMsgTxt("Parameters ANGLE1 and ANGLE2 must have the same size");
 	}
 }
 
@@ -895,7 +1002,7 @@ void GetRecordByIndex(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[]
 		mexErrMsgTxt("This command requires two arguments");
 
 	TARGET* pTarget = GetHandleTarget(prhs[1]);
-	DAFFReader* pReader = pTarget->pReader;
+	const DAFFReader* pReader = pTarget->pReader.get();
 
 	int iRecordIndex;
 	if (!getIntegerScalar(prhs[2], iRecordIndex))
@@ -914,35 +1021,83 @@ void GetNearestNeighbourRecord(int nlhs, mxArray* plhs[], int nrhs, const mxArra
 		mexErrMsgTxt("This command requires four arguments");
 
 	TARGET* pTarget = GetHandleTarget(prhs[1]);
-	DAFFReader* pReader = pTarget->pReader;
+	const DAFFReader* pReader = pTarget->pReader.get();
+
+	int iView;
+	std::vector<float> vfAngles1, vfAngles2;
+	const mxArray* pShape;
+	GetDirectionsMatlab(prhs, iView, vfAngles1, vfAngles2, pShape);
+
+	size_t n = vfAngles1.size();
+	std::vector<int> viRecordIndices(n);
+	mxArray* pOutOfBounds = mxCreateLogicalArray(mxGetNumberOfDimensions(pShape), mxGetDimensions(pShape));
+	pReader->getContent()->getNearestNeighbours(iView, vfAngles1.data(), vfAngles2.data(), viRecordIndices.data(),
+											    (bool*)mxGetLogicals(pOutOfBounds), n);
+
+	plhs[0] = CreateRecordsMatlab(pReader, n);
+	double* pdRealData = mxGetPr(plhs[0]);
+	double* pdImagData = mxGetPi(plhs[0]);
+	bool bComplex;
+	size_t iRecordSize =
+		(size_t)pReader->getProperties()->getNumberOfChannels() * (size_t)GetRecordLengthMatlab(pReader, bComplex);
+	for (size_t k = 0; k < n; k++)
+		CopyRecordMatlab(pReader, pTarget->pfBuffer, viRecordIndices[k], pdRealData + k * iRecordSize,
+						 (bComplex ? pdImagData + k * iRecordSize : NULL));
 
-	std::string sView;
-	if (!getString(prhs[2], sView))
-		mexErrMsgTxt("Parameter VIEW must be a string");
-	std::transform(sView.begin(), sView.end(), sView.begin(), tolower);
+	if (nlhs == 2)
+		plhs[1] = pOutOfBounds;
+	else
+		mxDestroyArray(pOutOfBounds);
+}
 
-	int iView = -1;
-	if (sView == "data")
-		iView = DAFF_DATA_VIEW;
-	if (sView == "object")
-		iView = DAFF_OBJECT_VIEW;
-	if (iView == -1)
-		mexErrMsgTxt("Invalid view");
+void GetInterpolatedRecord(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
+{
+	if (nrhs != 5)
+		mexErrMsgTxt("This command requires four arguments");
 
-	double dAngle1, dAngle2;
-	if (!getRealScalar(prhs[3], dAngle1))
-		mexErrMsgTxt("Parameter ANGLE1 must be a real-valued scalar");
-	if (!getRealScalar(prhs[4], dAngle2))
-		mexErrMsgTxt("Parameter ANGLE2 must be a real-valued scalar");
+	TARGET* pTarget = GetHandleTarget(prhs[1]);
+	const DAFFReader* pReader = pTarget->pReader.get();
 
-	int iRecordIndex;
-	bool bOutOfBounds;
-	pReader->getContent()->getNearestNeighbour(iView, (float)dAngle1, (float)dAngle2, iRecordIndex, bOutOfBounds);
+	int iView;
+	std::vector<float> vfAngles1, vfAngles2;
+	const mxArray* pShape;
+	GetDirectionsMatlab(prhs, iView, vfAngles1, vfAngles2, pShape);
 
-	GetRecordMatlab(pReader, pTarget->pfBuffer, iRecordIndex, plhs[0]);
+	DAFFInterpolator oInterpolator(pReader->getContent());
+	if (oInterpolator.getDataLength() == 0)
+		mexErrMsgTxt("Interpolation requires impulse responses, magnitude spectra or DFT spectra");
 
-	if (nlhs == 2)
-		plhs[1] = mxCreateLogicalScalar(bOutOfBounds);
+	size_t n = vfAngles1.size();
+	int iChannels = pReader->getProperties()->getNumberOfChannels();
+	bool bComplex;
+	int iLength = GetRecordLengthMatlab(pReader, bComplex);
+	size_t iRecordSize = (size_t)iChannels * (size_t)iLength;
+
+	plhs[0] = CreateRecordsMatlab(pReader, n);
+	double* pdRealData = mxGetPr(plhs[0]);
+	double* pdImagData = mxGetPi(plhs[0]);
+	for (size_t k = 0; k < n; k++) {
+		for (int c = 0; c < iChannels; c++) {
+			int iError = oInterpolator.interpolate(iView, vfAngles1[k], vfAngles2[k], c, pTarget->pfBuffer);
+			if (iError != DAFF_NO_ERROR) {
+				mxDestroyArray(plhs[0]);
+				mexErrMsgTxt(DAFFUtils::StrError(iError).c_str());
+			}
+
+			// Convert it to double precision (64-bit), DFT coefficients are interleaved in the buffer
+			double* pdReal = pdRealData + k * iRecordSize + c;
+			if (bComplex) {
+				double* pdImag = pdImagData + k * iRecordSize + c;
+				for (int i = 0; i < iLength; i++) {
+					pdReal[i * iChannels] = (double)pTarget->pfBuffer[2 * i];
+					pdImag[i * iChannels] = (double)pTarget->pfBuffer[2 * i + 1];
+				}
+			} else {
+				for (int i = 0; i < iLength; i++)
+					pdReal[i * iChannels] = (double)pTarget->pfBuffer[i];
+			}
+		}
+	}
 }
 
 void GetCellRecords(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
@@ -951,7 +1106,7 @@ void GetCellRecords(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 		mexErrMsgTxt("This command requires four arguments");
 
 	TARGET* pTarget = GetHandleTarget(prhs[1]);
-	DAFFReader* pReader = pTarget->pReader;
+	const DAFFReader* pReader = pTarget->pReader.get();
 
 	std::string sView;
 	if (!getString(prhs[2], sView))
@@ -996,34 +1151,28 @@ void GetNearestNeighbourIndex(int nlhs, mxArray* plhs[], int nrhs, const mxArray
 		mexErrMsgTxt("This command requires four arguments");
 
 	TARGET* pTarget = GetHandleTarget(prhs[1]);
-	DAFFReader* pReader = pTarget->pReader;
-
-	std::string sView;
-	if (!getString(prhs[2], sView))
-		mexErrMsgTxt("Parameter VIEW must be a string");
-	std::transform(sView.begin(), sView.end(), sView.begin(), tolower);
+	const DAFFReader* pReader = pTarget->pReader.get();
 
-	int iView = -1;
-	if (sView == "data")
-		iView = DAFF_DATA_VIEW;
-	if (sView == "object")
-		iView = DAFF_OBJECT_VIEW;
-	if (iView == -1)
-		mexErrMsgTxt("Invalid view");
+	int iView;
+	std::vector<float> vfAngles1, vfAngles2;
+	const mxArray* pShape;
+	GetDirectionsMatlab(prhs, iView, vfAngles1, vfAngles2, pShape);
 
-	double dAngle1, dAngle2;
-	if (!getRealScalar(prhs[3], dAngle1))
-		mexErrMsgTxt("Parameter ANGLE1 must be a real-valued scalar");
-	if (!getRealScalar(prhs[4], dAngle2))
-		mexErrMsgTxt("Parameter ANGLE2 must be a real-valued scalar");
+	size_t n = vfAngles1.size();
+	std::vector<int> viRecordIndices(n);
+	mxArray* pOutOfBounds = mxCreateLogicalArray(mxGetNumberOfDimensions(pShape), mxGetDimensions(pShape));
+	pReader->getContent()->getNearestNeighbours(iView, vfAngles1.data(), vfAngles2.data(), viRecordIndices.data(),
+											    (bool*)mxGetLogicals(pOutOfBounds), n);
 
-	int iRecordIndex;
-	bool bOutOfBounds;
-	pReader->getContent()->getNearestNeighbour(iView, (float)dAngle1, (float)dAngle2, iRecordIndex, bOutOfBounds);
+	plhs[0] = mxCreateNumericArray(mxGetNumberOfDimensions(pShape), mxGetDimensions(pShape), mxDOUBLE_CLASS, mxREAL);
+	double* pdData = mxGetPr(plhs[0]);
+	for (size_t k = 0; k < n; k++)
+		pdData[k] = viRecordIndices[k] + 1;  // cave: matlab indexing
 
-	plhs[0] = mxCreateDoubleScalar(iRecordIndex + 1);  // cave: matlab indexing
 	if (nlhs == 2)
-		plhs[1] = mxCreateLogicalScalar(bOutOfBounds);
+		plhs[1] = pOutOfBounds;
+	else
+		mxDestroyArray(pOutOfBounds);
 }
 
 void GetCell(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
@@ -1032,7 +1181,7 @@ void GetCell(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
 		mexErrMsgTxt("This command requires four arguments");
 
 	TARGET* pTarget = GetHandleTarget(prhs[1]);
-	DAFFReader* pReader = pTarget->pReader;
+	const DAFFReader* pReader = pTarget->pReader.get();
 
 	std::string sView;
 	if (!getString(prhs[2], sView))
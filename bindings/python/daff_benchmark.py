@@ -0,0 +1,110 @@
+# Python driver of the cross-language binding benchmark
+#
+# Runs the workload of tests/benchmark/BindingBenchmark.cpp through the Python
+# binding and prints the results in its CSV format. The workload file is written
+# by the native baseline (BindingBenchmark -w), tests/benchmark/binding_benchmark.py
+# runs both and reports the per-call overhead of the binding.
+#
+# Usage: python daff_benchmark.py file [queries [fetches [opens]]]
+
+import sys
+import time
+
+import numpy
+
+import daffCppInterface
+
+NUM_QUERIES = 4096  # Size of the query pool (also the batch size)
+OBJECT_VIEW = 1
+
+
+def query_pool(num_records):
+    """Same pseudo-random query pool as the native baseline (BenchmarkData.h)"""
+    state = 12345
+    values = numpy.empty(3 * NUM_QUERIES, dtype=numpy.float32)
+    for i in range(3 * NUM_QUERIES):
+        state = (state * 1664525 + 1013904223) & 0xFFFFFFFF
+        values[i] = (state >> 8) / 16777216.0
+    azimuths = numpy.float32(360) * values[0::3] - numpy.float32(180)
+    elevations = numpy.float32(180) * values[1::3] - numpy.float32(90)
+    scaled = values[2::3] * numpy.float32(num_records)
+    records = numpy.minimum(scaled.astype(numpy.int32), num_records - 1)
+    return azimuths, elevations, records
+
+
+def print_result(operation, variant, calls, seconds, checksum):
+    print(
+        "python,%s,%s,%d,%.2f,%.6f"
+        % (operation, variant, calls, 1e9 * seconds / max(calls, 1), checksum)
+    )
+
+
+def main(argv):
+    if len(argv) < 2:
+        sys.stderr.write(
+            "Usage: python daff_benchmark.py file [queries [fetches [opens]]]\n"
+        )
+        return 255
+    path = argv[1]
+    queries = int(argv[2]) if len(argv) > 2 else 1000000
+    fetches = int(argv[3]) if len(argv) > 3 else 100000
+    opens = int(argv[4]) if len(argv) > 4 else 50
+
+    print("binding,operation,variant,calls,ns_per_call,checksum")
+
+    t0 = time.perf_counter()
+    for _ in range(opens):
+        daffCppInterface.open(path).close()
+    print_result("open", "call", opens, time.perf_counter() - t0, 0)
+
+    with daffCppInterface.open(path) as reader:
+        num_records = reader.properties()["NumRecords"]
+        azimuths, elevations, records = query_pool(num_records)
+        azimuth_list = azimuths.tolist()
+        elevation_list = elevations.tolist()
+        record_list = records.tolist()
+
+        # Nearest neighbours, one call per direction and batches of the query pool
+        checksum = 0
+        t0 = time.perf_counter()
+        for i in range(queries):
+            j = i & (NUM_QUERIES - 1)
+            checksum += reader.nearest_neighbour_index(
+                OBJECT_VIEW, azimuth_list[j], elevation_list[j]
+            )[0]
+        print_result(
+            "nearest_neighbour", "call", queries, time.perf_counter() - t0, checksum
+        )
+
+        checksum = 0
+        t0 = time.perf_counter()
+        for i in range(0, queries, NUM_QUERIES):
+            n = min(NUM_QUERIES, queries - i)
+            indices, _ = reader.nearest_neighbour_indices(
+                OBJECT_VIEW, azimuths[:n], elevations[:n], threads=1
+            )
+            checksum += int(indices.sum(dtype=numpy.int64))
+        print_result(
+            "nearest_neighbour", "batch", queries, time.perf_counter() - t0, checksum
+        )
+
+        # Record fetches, views without copying for float32 files
+        checksum = 0.0
+        t0 = time.perf_counter()
+        for i in range(fetches):
+            checksum += float(reader.record(record_list[i & (NUM_QUERIES - 1)])[0, 0])
+        print_result("record", "zerocopy", fetches, time.perf_counter() - t0, checksum)
+
+        checksum = 0.0
+        t0 = time.perf_counter()
+        for i in range(0, fetches, NUM_QUERIES):
+            n = min(NUM_QUERIES, fetches - i)
+            data = reader.records(records[:n], threads=1)
+            checksum += float(data[:, 0, 0].sum(dtype=numpy.float64))
+        print_result("record", "batch", fetches, time.perf_counter() - t0, checksum)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
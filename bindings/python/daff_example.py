@@ -5,11 +5,11 @@ sys.path.append("dist/Lib/site-packages")
 
 import daffCppInterface
 
-d1 = daffCppInterface.open("../../matlab/ExampleShortDiracOmni.ir.daff")
-d2 = daffCppInterface.open("../../matlab/ExampleUnityOmni.ms.daff")
+# Readers are closed at the end of the with block
+with daffCppInterface.open("../../matlab/ExampleShortDiracOmni.ir.daff") as d1:
+    d2 = daffCppInterface.open("../../matlab/ExampleUnityOmni.ms.daff")
 
-index = daffCppInterface.nearest_neighbour_index(d1, 1, 2, 3)
-print(daffCppInterface.content_type(d1))
+    index = d1.nearest_neighbour_index(1, 2, 3)
+    print(d1.content_type())
 
-daffCppInterface.close(d2)
-daffCppInterface.close(d1)
+    d2.close()
@@ -34,608 +34,1088 @@
 
 #include <DAFF.h>
 
-#include <map>
+#include <algorithm>
+#include <memory>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
 
 #include <Python.h>
 
 #include "pydaffdoc.hpp"
 
-static std::map<int, DAFFReader*> g_mReader;  //!< Global reader instance map
-static int g_iLastHandle = 0;                 //!< Stores ID of last used handle identifier
-static PyObject* g_pDAFFError = nullptr;      //!< Static pointer to error instance
+//! Opened DAFF file (daffCppInterface.Reader)
+/**
+ * The reader is shared with the record views and the running batch queries,
+ * which keep it alive after close().
+ */
+struct DAFFReaderObject {
+	PyObject_HEAD
+	std::shared_ptr<DAFFReader>* ppReader;  //!< Reader (NULL if closed)
+	int iOpenFlags;                         //!< Flags of the opening, combination of #DAFF_OPEN_FLAGS
+};
 
+//! Record data exported through the buffer protocol (wrapped into NumPy arrays)
+/**
+ * Either a read-only view into the record data of a reader, which it keeps alive,
+ * or an owned contiguous copy.
+ */
+struct DAFFBufferObject {
+	PyObject_HEAD
+	void* pData;                            //!< First element
+	std::vector<char>* pvcStorage;          //!< Owned copy (NULL for views)
+	std::shared_ptr<DAFFReader>* ppReader;  //!< Reader of a view (NULL for copies)
+	const char* pszFormat;                  //!< Element format ("f": float32, "Zf": complex64, "i": int32, "?": bool)
+	Py_ssize_t nItemSize;                   //!< Size of an element [Bytes]
+	int iNumDims;                           //!< Number of dimensions (at most 3)
+	Py_ssize_t pnShape[3];                  //!< Number of elements per dimension
+	Py_ssize_t pnStrides[3];                //!< Distance of the elements per dimension [Bytes]
+};
 
-static void GetRecordPython(DAFFReader* pReader, int iRecordIndex, PyObject*& listResult);
+static PyObject* g_pDAFFError = nullptr;  //!< Static pointer to error instance
+static PyObject* g_pNumPy = nullptr;      //!< NumPy module (imported on first use)
+static PyTypeObject g_oReaderType = {PyVarObject_HEAD_INIT(NULL, 0) "daffCppInterface.Reader"};
+static PyTypeObject g_oBufferType = {PyVarObject_HEAD_INIT(NULL, 0) "daffCppInterface.Buffer"};
 
-bool ValidHandle(const int iHandle)
+
+static PyObject* GetRecordArray(const DAFFReaderObject* pReaderObject, int iRecordIndex);
+
+// Returns the reader of a reader object (NULL and a raised exception if it was closed)
+static DAFFReader* GetReader(PyObject* pSelf)
 {
-	if (g_mReader.find(iHandle) == g_mReader.end())
-		return false;
-	else
-		return true;
+	DAFFReaderObject* pReaderObject = (DAFFReaderObject*)pSelf;
+	if (pReaderObject->ppReader == NULL) {
+		PyErr_SetString(PyExc_ValueError, std::string("DAFF file is closed").c_str());
+		return NULL;
+	}
+
+	return pReaderObject->ppReader->get();
 }
 
-static PyObject* daff_open(PyObject*, PyObject* args, PyObject* kwargs)
+static void DAFFBuffer_dealloc(PyObject* pSelf)
 {
-	static const char* const keywords[] = {"open", NULL};
-	char* pcFilePath = nullptr;
-
-	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s:open", const_cast<char**>(keywords), &pcFilePath))
-		return NULL;
+	DAFFBufferObject* pBuffer = (DAFFBufferObject*)pSelf;
+	delete pBuffer->pvcStorage;
+	delete pBuffer->ppReader;
+	Py_TYPE(pSelf)->tp_free(pSelf);
+}
 
-	std::string sFilePath(pcFilePath);
-	DAFFReader* pReader = DAFFReader::create();
+static int DAFFBuffer_getbuffer(PyObject* pSelf, Py_buffer* pView, int iFlags)
+{
+	DAFFBufferObject* pBuffer = (DAFFBufferObject*)pSelf;
+	bool bReadOnly = (pBuffer->ppReader != NULL);
+
+	Py_ssize_t nLength = pBuffer->nItemSize;
+	bool bContiguous = true;
+	for (int i = pBuffer->iNumDims - 1; i >= 0; i--) {
+		bContiguous = bContiguous && ((pBuffer->pnShape[i] <= 1) || (pBuffer->pnStrides[i] == nLength));
+		nLength *= pBuffer->pnShape[i];
+	}
 
-	if (pReader->openFile(sFilePath) == DAFF_NO_ERROR) {
-		int iNewHandle = ++g_iLastHandle;
-		g_mReader[iNewHandle] = pReader;
-		return PyLong_FromLong(iNewHandle);
+	if (bReadOnly && (iFlags & PyBUF_WRITABLE)) {
+		PyErr_SetString(PyExc_BufferError, "Record views are read-only");
+		pView->obj = NULL;
+		return -1;
 	}
 
-	delete pReader;
+	if (!bContiguous && ((iFlags & PyBUF_STRIDES) != PyBUF_STRIDES)) {
+		PyErr_SetString(PyExc_BufferError, "Record view is not contiguous");
+		pView->obj = NULL;
+		return -1;
+	}
 
-	PyErr_SetString(PyExc_ConnectionError, std::string("Could not open " + sFilePath).c_str());
-	return NULL;
+	pView->buf = pBuffer->pData;
+	pView->obj = pSelf;
+	Py_INCREF(pSelf);
+	pView->len = nLength;
+	pView->readonly = (bReadOnly ? 1 : 0);
+	pView->itemsize = pBuffer->nItemSize;
+	pView->format = ((iFlags & PyBUF_FORMAT) ? const_cast<char*>(pBuffer->pszFormat) : NULL);
+	pView->ndim = pBuffer->iNumDims;
+	pView->shape = ((iFlags & PyBUF_ND) == PyBUF_ND ? pBuffer->pnShape : NULL);
+	pView->strides = ((iFlags & PyBUF_STRIDES) == PyBUF_STRIDES ? pBuffer->pnStrides : NULL);
+	pView->suboffsets = NULL;
+	pView->internal = NULL;
+	return 0;
 }
 
-static PyObject* daff_close(PyObject*, PyObject* args, PyObject* kwargs)
+static PyBufferProcs g_oBufferProcs = {DAFFBuffer_getbuffer, NULL};
+
+// Creates a buffer with an owned contiguous copy (zero-initialized)
+static DAFFBufferObject* CreateBuffer(const char* pszFormat, Py_ssize_t nItemSize, int iNumDims,
+									  const Py_ssize_t* pnShape)
 {
-	static const char* const keywords[] = {"close", NULL};
-	int iHandle = -1;
+	DAFFBufferObject* pBuffer = PyObject_New(DAFFBufferObject, &g_oBufferType);
+	if (pBuffer == NULL)
+		return NULL;
+
+	pBuffer->pszFormat = pszFormat;
+	pBuffer->nItemSize = nItemSize;
+	pBuffer->iNumDims = iNumDims;
+	pBuffer->ppReader = NULL;
+
+	Py_ssize_t nSize = nItemSize;
+	for (int i = iNumDims - 1; i >= 0; i--) {
+		pBuffer->pnShape[i] = pnShape[i];
+		pBuffer->pnStrides[i] = nSize;
+		nSize *= pnShape[i];
+	}
+
+	pBuffer->pvcStorage = new std::vector<char>((size_t)nSize);
+	pBuffer->pData = (pBuffer->pvcStorage->empty() ? NULL : &(*pBuffer->pvcStorage)[0]);
+	return pBuffer;
+}
 
-	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i:close", const_cast<char**>(keywords), &iHandle))
+// Creates a read-only view into the data of a reader, which it keeps alive
+static DAFFBufferObject* CreateView(const std::shared_ptr<DAFFReader>& pReader, const void* pData,
+									const char* pszFormat, Py_ssize_t nItemSize, int iNumDims,
+									const Py_ssize_t* pnShape, const Py_ssize_t* pnStrides)
+{
+	DAFFBufferObject* pBuffer = PyObject_New(DAFFBufferObject, &g_oBufferType);
+	if (pBuffer == NULL)
 		return NULL;
 
-	if (!ValidHandle(iHandle)) {
-		PyErr_SetString(PyExc_ConnectionError, std::string("Invalid DAFF handle").c_str());
+	pBuffer->pData = const_cast<void*>(pData);
+	pBuffer->pvcStorage = NULL;
+	pBuffer->ppReader = new std::shared_ptr<DAFFReader>(pReader);
+	pBuffer->pszFormat = pszFormat;
+	pBuffer->nItemSize = nItemSize;
+	pBuffer->iNumDims = iNumDims;
+	for (int i = 0; i < iNumDims; i++) {
+		pBuffer->pnShape[i] = pnShape[i];
+		pBuffer->pnStrides[i] = pnStrides[i];
+	}
+	return pBuffer;
+}
+
+// Wraps a buffer into a NumPy array without copying (steals the reference)
+static PyObject* ToNumPy(DAFFBufferObject* pBuffer)
+{
+	if (pBuffer == NULL)
 		return NULL;
-	} else {
-		DAFFReader* pReader = g_mReader[iHandle];
-		g_mReader.erase(iHandle);
-		pReader->closeFile();
-		return Py_None;
+
+	if (g_pNumPy == nullptr)
+		g_pNumPy = PyImport_ImportModule("numpy");
+
+	PyObject* pArray = NULL;
+	if (g_pNumPy != nullptr)
+		pArray = PyObject_CallMethod(g_pNumPy, "asarray", "O", (PyObject*)pBuffer);
+	Py_DECREF(pBuffer);
+	return pArray;
+}
+
+// ------------------ reader type ------------------ //
+
+static int DAFFReader_init(PyObject* pSelf, PyObject* args, PyObject* kwargs)
+{
+	static const char* const keywords[] = {"filepath", "flags", NULL};
+	char* pcFilePath = nullptr;
+	int iOpenFlags = DAFF_OPEN_DEFAULT;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|i:Reader", const_cast<char**>(keywords), &pcFilePath,
+									 &iOpenFlags))
+		return -1;
+
+	std::string sFilePath(pcFilePath);
+	std::shared_ptr<DAFFReader> pReader(DAFFReader::create());
+	if (pReader->openFile(sFilePath, iOpenFlags) != DAFF_NO_ERROR) {
+		PyErr_SetString(PyExc_ConnectionError, std::string("Could not open " + sFilePath).c_str());
+		return -1;
 	}
+
+	DAFFReaderObject* pReaderObject = (DAFFReaderObject*)pSelf;
+	delete pReaderObject->ppReader;
+	pReaderObject->ppReader = new std::shared_ptr<DAFFReader>(pReader);
+	pReaderObject->iOpenFlags = iOpenFlags;
+	return 0;
+}
+
+static void DAFFReader_dealloc(PyObject* pSelf)
+{
+	delete ((DAFFReaderObject*)pSelf)->ppReader;
+	Py_TYPE(pSelf)->tp_free(pSelf);
+}
+
+static PyObject* daff_open(PyObject*, PyObject* args, PyObject* kwargs)
+{
+	return PyObject_Call((PyObject*)&g_oReaderType, args, kwargs);
+}
+
+static PyObject* daff_close(PyObject* pSelf, PyObject*)
+{
+	// The reader is deleted along with the last record view of it (closing twice has no effect)
+	DAFFReaderObject* pReaderObject = (DAFFReaderObject*)pSelf;
+	delete pReaderObject->ppReader;
+	pReaderObject->ppReader = NULL;
+	Py_RETURN_NONE;
+}
+
+static PyObject* daff_enter(PyObject* pSelf, PyObject*)
+{
+	if (!GetReader(pSelf))
+		return NULL;
+
+	Py_INCREF(pSelf);
+	return pSelf;
+}
+
+static PyObject* daff_exit(PyObject* pSelf, PyObject*)
+{
+	daff_close(pSelf, NULL);
+	Py_RETURN_FALSE;
 }
 
-static PyObject* daff_nearest_neighbour_index(PyObject*, PyObject* args, PyObject* kwargs)
+static PyObject* daff_nearest_neighbour_index(PyObject* pSelf, PyObject* args, PyObject* kwargs)
 {
 	// Get the index of the nearest neighbour
-	static const char* const keywords[] = {"index", "view", "angle1", "angle2", NULL};
-	int iHandle = -1;
+	static const char* const keywords[] = {"view", "angle1", "angle2", NULL};
 	int iView;
 	double dAngle1Deg;
 	double dAngle2Deg;
 
 
-	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "iidd:nearest_neighbour_index", const_cast<char**>(keywords),
-									 &iHandle, &iView, &dAngle1Deg, &dAngle2Deg))
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "idd:nearest_neighbour_index", const_cast<char**>(keywords),
+									 &iView, &dAngle1Deg, &dAngle2Deg))
 		return NULL;
 
-	if (!ValidHandle(iHandle)) {
-		PyErr_SetString(PyExc_ConnectionError, std::string("Invalid DAFF handle").c_str());
+	DAFFReader* pReader = GetReader(pSelf);
+	if (!pReader)
 		return NULL;
-	} else {
-		DAFFReader* pReader = g_mReader[iHandle];
-		int iRecordIndex;
-		bool bOutOfBounds;
 
-		pReader->getContent()->getNearestNeighbour(iView, dAngle1Deg, dAngle2Deg, iRecordIndex, bOutOfBounds);
+	int iRecordIndex;
+	bool bOutOfBounds;
 
-		// Python list which contains the Record index and the OutOfBounds Indicator
-		PyObject* pyNearestNeighbour = PyList_New(0);
-		PyList_Append(pyNearestNeighbour, PyLong_FromLong(iRecordIndex));
-		PyList_Append(pyNearestNeighbour, PyBool_FromLong(bOutOfBounds));
+	pReader->getContent()->getNearestNeighbour(iView, dAngle1Deg, dAngle2Deg, iRecordIndex, bOutOfBounds);
 
+	// Python list which contains the Record index and the OutOfBounds Indicator
+	PyObject* pyNearestNeighbour = PyList_New(0);
+	PyList_Append(pyNearestNeighbour, PyLong_FromLong(iRecordIndex));
+	PyList_Append(pyNearestNeighbour, PyBool_FromLong(bOutOfBounds));
 
-		// Return Python list
-		return pyNearestNeighbour;
-	}
 
-	return Py_None;
+	// Return Python list
+	return pyNearestNeighbour;
 }
 
-static PyObject* daff_nearest_neighbour_record(PyObject*, PyObject* args, PyObject* kwargs)
+static PyObject* daff_nearest_neighbour_record(PyObject* pSelf, PyObject* args, PyObject* kwargs)
 {
 	// Get the record of the nearest neighbour
-	static const char* const keywords[] = {"index", "view", "angle1", "angle2", NULL};
-	int iHandle = -1;
+	static const char* const keywords[] = {"view", "angle1", "angle2", NULL};
 	int iView;
 	double dAngle1Deg;
 	double dAngle2Deg;
 
-	// Initialize a new list
-	PyObject* record = PyList_New(0);
-
-	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "iidd:nearest_neighbour_record", const_cast<char**>(keywords),
-									 &iHandle, &iView, &dAngle1Deg, &dAngle2Deg))
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "idd:nearest_neighbour_record", const_cast<char**>(keywords),
+									 &iView, &dAngle1Deg, &dAngle2Deg))
 		return NULL;
 
-	if (!ValidHandle(iHandle)) {
-		PyErr_SetString(PyExc_ConnectionError, std::string("Invalid DAFF handle").c_str());
+	DAFFReader* pReader = GetReader(pSelf);
+	if (!pReader)
 		return NULL;
-	} else {
-		DAFFReader* pReader = g_mReader[iHandle];
-		int iRecordIndex;
-		pReader->getContent()->getNearestNeighbour(iView, dAngle1Deg, dAngle2Deg, iRecordIndex);
-
-		// Get the record and set the record list
-		GetRecordPython(pReader, iRecordIndex, record);
 
-		// Return the record of the nearest neighbour
-		return record;
-	}
+	int iRecordIndex;
+	pReader->getContent()->getNearestNeighbour(iView, dAngle1Deg, dAngle2Deg, iRecordIndex);
 
-	return record;
+	// Return the record of the nearest neighbour
+	return GetRecordArray((const DAFFReaderObject*)pSelf, iRecordIndex);
 }
 
-static PyObject* daff_record(PyObject*, PyObject* args, PyObject* kwargs)
+static PyObject* daff_record(PyObject* pSelf, PyObject* args, PyObject* kwargs)
 {
 	// Get the record of the given record index
-	static const char* const keywords[] = {"index", "recordIndex", NULL};
-	int iHandle = -1;
+	static const char* const keywords[] = {"recordIndex", NULL};
 	int iRecordIndex;
 
-
-	// Initialize a new list
-	PyObject* record = PyList_New(0);
-
-	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ii:record", const_cast<char**>(keywords), &iHandle, &iRecordIndex))
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i:record", const_cast<char**>(keywords), &iRecordIndex))
 		return NULL;
 
-	if (!ValidHandle(iHandle)) {
-		PyErr_SetString(PyExc_ConnectionError, std::string("Invalid DAFF handle").c_str());
+	DAFFReader* pReader = GetReader(pSelf);
+	if (!pReader)
 		return NULL;
-	} else {
-		DAFFReader* pReader = g_mReader[iHandle];
-
-		// Get the record and set the record list
-		GetRecordPython(pReader, iRecordIndex, record);
 
-		// Return the record of the nearest neighbour
-		return record;
+	if ((iRecordIndex < 0) || (iRecordIndex >= pReader->getProperties()->getNumberOfRecords())) {
+		PyErr_SetString(PyExc_IndexError, std::string("Invalid record index").c_str());
+		return NULL;
 	}
 
-	return record;
+	return GetRecordArray((const DAFFReaderObject*)pSelf, iRecordIndex);
 }
 
-// Fetch a record from the content, convert and return it as a python list
-static void GetRecordPython(DAFFReader* pReader, int iRecordIndex, PyObject*& listResult)
+// Returns the number of values per record channel and the element format of the NumPy arrays
+static int GetRecordLayout(DAFFReader* pReader, const char*& pszFormat, Py_ssize_t& nItemSize)
 {
-	int iContentType = pReader->getContentType();
-	int iChannels = pReader->getProperties()->getNumberOfChannels();
+	pszFormat = "f";
+	nItemSize = sizeof(float);
 
-	// Create the result
-	listResult = PyList_New(0);
+	switch (pReader->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		return dynamic_cast<DAFFContentIR*>(pReader->getContent())->getFilterLength();
 
-	if (iContentType == DAFF_IMPULSE_RESPONSE) {
-		DAFFContentIR* pContent = dynamic_cast<DAFFContentIR*>(pReader->getContent());
-		int iFilterLength = pContent->getFilterLength();
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return dynamic_cast<DAFFContentMS*>(pReader->getContent())->getNumFrequencies();
 
+	case DAFF_PHASE_SPECTRUM:
+		return dynamic_cast<DAFFContentPS*>(pReader->getContent())->getNumFrequencies();
 
-		// Copy the data
-		for (int c = 0; c < iChannels; c++) {
-			// Create python list for current channel
-			PyObject* listChannel = PyList_New(0);
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		pszFormat = "Zf";
+		nItemSize = 2 * sizeof(float);
+		return dynamic_cast<DAFFContentMPS*>(pReader->getContent())->getNumFrequencies();
 
-			// Get the impulse response
-			float* fImpulseResponse = NULL;
-			;
-			fImpulseResponse = new float[iFilterLength];
-			pContent->getFilterCoeffs(iRecordIndex, c, fImpulseResponse);
-
-			// Append it to current channel list
-			for (int i = 0; i < iFilterLength; i++)
-				PyList_Append(listChannel, PyFloat_FromDouble(fImpulseResponse[i]));
+	case DAFF_DFT_SPECTRUM:
+		pszFormat = "Zf";
+		nItemSize = 2 * sizeof(float);
+		return dynamic_cast<DAFFContentDFT*>(pReader->getContent())->getNumDFTCoeffs();
+	}
 
-			// Freeing memory
-			delete[] fImpulseResponse;
-			fImpulseResponse = NULL;
+	return 0;
+}
 
-			// Append channel List to result List
-			PyList_Append(listResult, listChannel);
-		}
+// Returns the stored float data of a whole record channel (NULL if it must be converted)
+static const float* GetRecordChannelPtr(DAFFReader* pReader, int iRecordIndex, int iChannel, int iLength)
+{
+	switch (pReader->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE: {
+		int iOffset, iEffectiveLength;
+		const float* pfData = dynamic_cast<DAFFContentIR*>(pReader->getContent())
+								  ->getEffectiveFilterCoeffsPtr(iRecordIndex, iChannel, iOffset, iEffectiveLength);
+		return ((iOffset == 0) && (iEffectiveLength == iLength) ? pfData : NULL);
 	}
 
-	if (iContentType == DAFF_MAGNITUDE_SPECTRUM) {
-		DAFFContentMS* pContent = dynamic_cast<DAFFContentMS*>(pReader->getContent());
-		int iNumFreqs = pContent->getNumFrequencies();
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return dynamic_cast<DAFFContentMS*>(pReader->getContent())->getMagnitudesPtr(iRecordIndex, iChannel);
 
+	case DAFF_PHASE_SPECTRUM:
+		return dynamic_cast<DAFFContentPS*>(pReader->getContent())->getPhasesPtr(iRecordIndex, iChannel);
 
-		// Copy the data
-		for (int c = 0; c < iChannels; c++) {
-			// Create python list for current channel
-			PyObject* listChannel = PyList_New(0);
+	case DAFF_DFT_SPECTRUM:
+		return dynamic_cast<DAFFContentDFT*>(pReader->getContent())->getDFTCoeffsPtr(iRecordIndex, iChannel);
+	}
 
-			// Get the magnitude spectrum
-			float* fMagnitudes = NULL;
-			fMagnitudes = new float[iNumFreqs];
-			pContent->getMagnitudes(iRecordIndex, c, fMagnitudes);
+	return NULL;
+}
 
-			// Append it to current channel list
-			for (int i = 0; i < iNumFreqs; i++)
-				PyList_Append(listChannel, PyFloat_FromDouble(fMagnitudes[i]));
+// Copies a record channel into a buffer (complex values interleaved)
+static int GetRecordChannelData(DAFFReader* pReader, int iRecordIndex, int iChannel, float* pfDest)
+{
+	switch (pReader->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		return dynamic_cast<DAFFContentIR*>(pReader->getContent())->getFilterCoeffs(iRecordIndex, iChannel, pfDest);
 
-			// Freeing memory
-			delete[] fMagnitudes;
-			fMagnitudes = NULL;
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return dynamic_cast<DAFFContentMS*>(pReader->getContent())->getMagnitudes(iRecordIndex, iChannel, pfDest);
 
-			// Append channel List to result List
-			PyList_Append(listResult, listChannel);
-		}
-	}
+	case DAFF_PHASE_SPECTRUM:
+		return dynamic_cast<DAFFContentPS*>(pReader->getContent())->getPhases(iRecordIndex, iChannel, pfDest);
 
-	if (iContentType == DAFF_PHASE_SPECTRUM) {
-		DAFFContentPS* pContent = dynamic_cast<DAFFContentPS*>(pReader->getContent());
-		int iNumFreqs = pContent->getNumFrequencies();
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		return dynamic_cast<DAFFContentMPS*>(pReader->getContent())
+			->getCoefficientsRI(iRecordIndex, iChannel, pfDest);
 
+	case DAFF_DFT_SPECTRUM:
+		return dynamic_cast<DAFFContentDFT*>(pReader->getContent())->getDFTCoeffs(iRecordIndex, iChannel, pfDest);
+	}
 
-		// Copy the data
-		for (int c = 0; c < iChannels; c++) {
-			// Create python list for current channel
-			PyObject* listChannel = PyList_New(0);
+	return DAFF_MODAL_ERROR;
+}
 
-			// Get the phase coefficients
-			float* fPhases = NULL;
-			fPhases = new float[iNumFreqs];
-			pContent->getPhases(iRecordIndex, c, fPhases);
+// Copies all channels of a record into planar buffers with the multi-channel fetch (complex values interleaved)
+static int GetRecordData(DAFFReader* pReader, int iRecordIndex, float** ppfChannelDest)
+{
+	switch (pReader->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		return dynamic_cast<DAFFContentIR*>(pReader->getContent())->getRecord(iRecordIndex, ppfChannelDest);
 
-			// Append it to current channel list
-			for (int i = 0; i < iNumFreqs; i++)
-				PyList_Append(listChannel, PyFloat_FromDouble(fPhases[i]));
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return dynamic_cast<DAFFContentMS*>(pReader->getContent())->getRecord(iRecordIndex, ppfChannelDest);
 
-			// Freeing memory
-			delete[] fPhases;
-			fPhases = NULL;
+	case DAFF_PHASE_SPECTRUM:
+		return dynamic_cast<DAFFContentPS*>(pReader->getContent())->getRecord(iRecordIndex, ppfChannelDest);
 
-			// Append channel List to result List
-			PyList_Append(listResult, listChannel);
-		}
+	case DAFF_DFT_SPECTRUM:
+		return dynamic_cast<DAFFContentDFT*>(pReader->getContent())->getRecord(iRecordIndex, ppfChannelDest);
 	}
 
-	if (iContentType == DAFF_MAGNITUDE_PHASE_SPECTRUM) {
-		DAFFContentMPS* pContent = dynamic_cast<DAFFContentMPS*>(pReader->getContent());
-		int iNumFreqs = pContent->getNumFrequencies();
+	// Magnitude-phase spectra channel by channel
+	for (int c = 0; c < pReader->getProperties()->getNumberOfChannels(); c++) {
+		int iError = GetRecordChannelData(pReader, iRecordIndex, c, ppfChannelDest[c]);
+		if (iError != DAFF_NO_ERROR)
+			return iError;
+	}
 
+	return DAFF_NO_ERROR;
+}
 
-		// Copy the data
-		for (int c = 0; c < iChannels; c++) {
-			// Create python list for current channel
-			PyObject* listChannel = PyList_New(0);
+// Fetch a record from the content and return it as a NumPy array [channels, values]
+static PyObject* GetRecordArray(const DAFFReaderObject* pReaderObject, int iRecordIndex)
+{
+	DAFFReader* pReader = pReaderObject->ppReader->get();
+	int iChannels = pReader->getProperties()->getNumberOfChannels();
 
-			// Get the impulse response
-			float* fCoeffs = NULL;
-			fCoeffs = new float[iNumFreqs];
-			pContent->getCoefficientsRI(iRecordIndex, c, fCoeffs);
+	const char* pszFormat;
+	Py_ssize_t nItemSize;
+	int iLength = GetRecordLayout(pReader, pszFormat, nItemSize);
+	Py_ssize_t pnShape[2] = {iChannels, iLength};
+
+	// Stored float data is exposed directly if the channels lie at equal distances
+	// (not with lazy loading, which reuses the record cache)
+	if (!(pReaderObject->iOpenFlags & DAFF_OPEN_LAZY) && (iChannels > 0)) {
+		const float* pfFirst = GetRecordChannelPtr(pReader, iRecordIndex, 0, iLength);
+		Py_ssize_t pnStrides[2] = {iLength * nItemSize, nItemSize};
+		bool bView = (pfFirst != NULL);
+		for (int c = 1; bView && (c < iChannels); c++) {
+			const float* pfChannel = GetRecordChannelPtr(pReader, iRecordIndex, c, iLength);
+			if (c == 1)
+				pnStrides[0] = (Py_ssize_t)((const char*)pfChannel - (const char*)pfFirst);
+			bView = (pfChannel != NULL) && ((const char*)pfChannel - (const char*)pfFirst == c * pnStrides[0]);
+		}
 
-			// Append it to current channel list. Even indexes are real and odd indexes are imaginary.
-			for (int i = 0; i < iNumFreqs; i++) {
-				PyList_Append(listChannel, PyComplex_FromDoubles(fCoeffs[2 * i], fCoeffs[2 * i + 1]));
-			}
+		if (bView)
+			return ToNumPy(CreateView(*pReaderObject->ppReader, pfFirst, pszFormat, nItemSize, 2, pnShape, pnStrides));
+	}
 
-			// Freeing memory
-			delete[] fCoeffs;
-			fCoeffs = NULL;
+	// Otherwise a single contiguous copy
+	DAFFBufferObject* pBuffer = CreateBuffer(pszFormat, nItemSize, 2, pnShape);
+	if (pBuffer == NULL)
+		return NULL;
 
-			// Append channel List to result List
-			PyList_Append(listResult, listChannel);
-		}
+	std::vector<float*> vpfChannels(iChannels);
+	for (int c = 0; c < iChannels; c++)
+		vpfChannels[c] = (float*)pBuffer->pData + (size_t)c * (iLength * nItemSize / sizeof(float));
+
+	int iError = GetRecordData(pReader, iRecordIndex, vpfChannels.data());
+	if (iError != DAFF_NO_ERROR) {
+		Py_DECREF(pBuffer);
+		PyErr_SetString(g_pDAFFError, DAFFUtils::StrError(iError).c_str());
+		return NULL;
 	}
 
-	if (iContentType == DAFF_DFT_SPECTRUM) {
-		DAFFContentDFT* pContent = dynamic_cast<DAFFContentDFT*>(pReader->getContent());
-		int iNumDFTCoeffs = pContent->getNumDFTCoeffs();
+	return ToNumPy(pBuffer);
+}
 
 
-		// Copy the data
-		for (int c = 0; c < iChannels; c++) {
-			// Create python list for current channel
-			PyObject* listChannel = PyList_New(0);
+// ------------------ batch queries ------------------ //
+
+//! Minimum number of directions per worker thread of the batch queries
+static const size_t BATCH_MIN_DIRECTIONS_PER_THREAD = 16384;
+
+//! Minimum number of records per worker thread of the batch record fetch
+static const size_t BATCH_MIN_RECORDS_PER_THREAD = 64;
+
+//! Part of a batch query processed by a worker thread (without the GIL)
+struct BatchTask {
+	DAFFReader* pReader;         //!< Reader
+	int iView;                   //!< View, one of #DAFF_VIEWS
+	const float* pfAngles1;      //!< First angles of the directions [degrees]
+	const float* pfAngles2;      //!< Second angles of the directions [degrees]
+	const int* piRecordIndices;  //!< Record indices of the fetch (NULL: all records in order)
+	int* piResults;              //!< Record indices found by the query
+	bool* pbOutOfBounds;         //!< Out of bounds indicators of the query
+	float* pfData;               //!< Record data of the fetch [records, channels, values]
+	size_t nRecordFloats;        //!< Number of floats per record of the fetch
+	size_t nChannelFloats;       //!< Number of floats per record channel of the fetch
+	float* pfDataCoords;         //!< Alpha and beta angles of the fetched records [degrees] (may be NULL)
+	float* pfObjectCoords;       //!< Phi and theta angles of the fetched records [degrees] (may be NULL)
+	size_t iBegin;               //!< First element
+	size_t iEnd;                 //!< Behind the last element
+	int iResult;                 //!< Error code of the task
+};
 
-			// Get the impulse response
-			float* fDFTCoeffs = NULL;
-			fDFTCoeffs = new float[iNumDFTCoeffs];
-			pContent->getDFTCoeffs(iRecordIndex, c, fDFTCoeffs);
+static void NearestNeighboursWorker(BatchTask* pTask)
+{
+	size_t n = pTask->iEnd - pTask->iBegin;
+	pTask->pReader->getContent()->getNearestNeighbours(pTask->iView, pTask->pfAngles1 + pTask->iBegin,
+													   pTask->pfAngles2 + pTask->iBegin,
+													   pTask->piResults + pTask->iBegin,
+													   pTask->pbOutOfBounds + pTask->iBegin, n);
+	pTask->iResult = DAFF_NO_ERROR;
+}
 
-			// Append it to current channel list. Even indexes are real and odd indexes are imaginary.
-			for (int i = 0; i < iNumDFTCoeffs; i++) {
-				PyList_Append(listChannel, PyComplex_FromDoubles(fDFTCoeffs[2 * i], fDFTCoeffs[2 * i + 1]));
-			}
+static void RecordsWorker(BatchTask* pTask)
+{
+	int iChannels = pTask->pReader->getProperties()->getNumberOfChannels();
+	std::vector<float*> vpfChannels(iChannels);
+
+	pTask->iResult = DAFF_NO_ERROR;
+	for (size_t i = pTask->iBegin; (i < pTask->iEnd) && (pTask->iResult == DAFF_NO_ERROR); i++) {
+		int iRecordIndex = (pTask->piRecordIndices ? pTask->piRecordIndices[i] : (int)i);
+		for (int c = 0; c < iChannels; c++)
+			vpfChannels[c] = pTask->pfData + i * pTask->nRecordFloats + c * pTask->nChannelFloats;
+		pTask->iResult = GetRecordData(pTask->pReader, iRecordIndex, vpfChannels.data());
+
+		if (pTask->pfDataCoords)
+			pTask->pReader->getContent()->getRecordCoords(iRecordIndex, DAFF_DATA_VIEW, pTask->pfDataCoords[2 * i],
+														  pTask->pfDataCoords[2 * i + 1]);
+		if (pTask->pfObjectCoords)
+			pTask->pReader->getContent()->getRecordCoords(iRecordIndex, DAFF_OBJECT_VIEW,
+														  pTask->pfObjectCoords[2 * i],
+														  pTask->pfObjectCoords[2 * i + 1]);
+	}
+}
 
-			// Freeing memory
-			delete[] fDFTCoeffs;
-			fDFTCoeffs = NULL;
+// Runs the tasks of [0, n) on worker threads (at least nMinPerThread elements each, call without the GIL)
+static int RunBatch(BatchTask oTemplate, size_t n, size_t nMinPerThread, int iNumThreads,
+					void (*pfnWorker)(BatchTask*))
+{
+	if (iNumThreads <= 0)
+		iNumThreads = (int)std::max(std::thread::hardware_concurrency(), 1u);
+	size_t nNumTasks = std::max(std::min((size_t)iNumThreads, n / nMinPerThread), (size_t)1);
+
+	std::vector<BatchTask> vTasks(nNumTasks, oTemplate);
+	for (size_t i = 0; i < nNumTasks; i++) {
+		vTasks[i].iBegin = n * i / nNumTasks;
+		vTasks[i].iEnd = n * (i + 1) / nNumTasks;
+	}
 
-			// Append channel List to result List
-			PyList_Append(listResult, listChannel);
+	std::vector<std::thread> vThreads;
+	for (size_t i = 1; i < nNumTasks; i++) {
+		try {
+			vThreads.push_back(std::thread(pfnWorker, &vTasks[i]));
+		} catch (const std::system_error&) {
+			pfnWorker(&vTasks[i]);  // No more threads available
 		}
 	}
+	pfnWorker(&vTasks[0]);
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	for (size_t i = 0; i < nNumTasks; i++)
+		if (vTasks[i].iResult != DAFF_NO_ERROR)
+			return vTasks[i].iResult;
+	return DAFF_NO_ERROR;
 }
 
+// Converts an object into a contiguous NumPy array of a type and requests its buffer (false on error)
+static bool GetInputBuffer(PyObject* pObject, const char* pszDType, Py_ssize_t nItemSize, Py_buffer& oView,
+						   PyObject*& pArray)
+{
+	if (g_pNumPy == nullptr)
+		g_pNumPy = PyImport_ImportModule("numpy");
+	if (g_pNumPy == nullptr)
+		return false;
+
+	pArray = PyObject_CallMethod(g_pNumPy, "ascontiguousarray", "Os", pObject, pszDType);
+	if (pArray == NULL)
+		return false;
 
-static PyObject* daff_content_type(PyObject*, PyObject* args, PyObject* kwargs)
+	if (PyObject_GetBuffer(pArray, &oView, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) {
+		Py_DECREF(pArray);
+		return false;
+	}
+
+	if (oView.itemsize != nItemSize) {
+		PyBuffer_Release(&oView);
+		Py_DECREF(pArray);
+		PyErr_SetString(PyExc_TypeError, std::string("Unexpected array element size").c_str());
+		return false;
+	}
+
+	return true;
+}
+
+static PyObject* daff_nearest_neighbour_indices(PyObject* pSelf, PyObject* args, PyObject* kwargs)
 {
-	static const char* const keywords[] = {"index", NULL};
-	int iHandle = -1;
+	// Get the indices of the nearest neighbours of many directions
+	static const char* const keywords[] = {"view", "angles1", "angles2", "threads", NULL};
+	int iView;
+	PyObject* pyAngles1;
+	PyObject* pyAngles2;
+	int iNumThreads = 0;
 
-	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i:content_type", const_cast<char**>(keywords), &iHandle))
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "iOO|i:nearest_neighbour_indices", const_cast<char**>(keywords),
+									 &iView, &pyAngles1, &pyAngles2, &iNumThreads))
 		return NULL;
 
-	if (!ValidHandle(iHandle)) {
-		PyErr_SetString(PyExc_ConnectionError, std::string("Invalid DAFF handle").c_str());
+	if (!GetReader(pSelf))
+		return NULL;
+
+	// Shared, since the reader may be closed meanwhile (by the conversions or by other threads)
+	std::shared_ptr<DAFFReader> pReader = *((DAFFReaderObject*)pSelf)->ppReader;
+
+	if ((iView != DAFF_DATA_VIEW) && (iView != DAFF_OBJECT_VIEW)) {
+		PyErr_SetString(PyExc_ValueError, std::string("Invalid view").c_str());
 		return NULL;
-	} else {
-		DAFFReader* pReader = g_mReader[iHandle];
-		int iContentType = pReader->getContentType();
-		return PyLong_FromLong(iContentType);
 	}
-}
 
-static PyObject* daff_content_type_str(PyObject*, PyObject* args, PyObject* kwargs)
-{
-	static const char* const keywords[] = {"index", NULL};
-	int iHandle = -1;
+	Py_buffer oAngles1, oAngles2;
+	PyObject *pyArray1, *pyArray2;
+	if (!GetInputBuffer(pyAngles1, "float32", sizeof(float), oAngles1, pyArray1))
+		return NULL;
+	if (!GetInputBuffer(pyAngles2, "float32", sizeof(float), oAngles2, pyArray2)) {
+		PyBuffer_Release(&oAngles1);
+		Py_DECREF(pyArray1);
+		return NULL;
+	}
 
-	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i:content_type_str", const_cast<char**>(keywords), &iHandle))
+	Py_ssize_t n = oAngles1.len / (Py_ssize_t)sizeof(float);
+	DAFFBufferObject* pIndices = NULL;
+	DAFFBufferObject* pOutOfBounds = NULL;
+	if (oAngles2.len != oAngles1.len)
+		PyErr_SetString(PyExc_ValueError, std::string("Angle arrays differ in size").c_str());
+	else {
+		pIndices = CreateBuffer("i", sizeof(int), 1, &n);
+		pOutOfBounds = CreateBuffer("?", sizeof(bool), 1, &n);
+	}
+
+	if (pIndices && pOutOfBounds) {
+		BatchTask oTemplate = BatchTask();
+		oTemplate.pReader = pReader.get();
+		oTemplate.iView = iView;
+		oTemplate.pfAngles1 = (const float*)oAngles1.buf;
+		oTemplate.pfAngles2 = (const float*)oAngles2.buf;
+		oTemplate.piResults = (int*)pIndices->pData;
+		oTemplate.pbOutOfBounds = (bool*)pOutOfBounds->pData;
+
+		Py_BEGIN_ALLOW_THREADS
+		RunBatch(oTemplate, (size_t)n, BATCH_MIN_DIRECTIONS_PER_THREAD, iNumThreads, &NearestNeighboursWorker);
+		Py_END_ALLOW_THREADS
+	}
+
+	PyBuffer_Release(&oAngles1);
+	PyBuffer_Release(&oAngles2);
+	Py_DECREF(pyArray1);
+	Py_DECREF(pyArray2);
+
+	if (!pIndices || !pOutOfBounds) {
+		Py_XDECREF(pIndices);
+		Py_XDECREF(pOutOfBounds);
 		return NULL;
+	}
 
-	if (!ValidHandle(iHandle)) {
-		PyErr_SetString(PyExc_ConnectionError, std::string("Invalid DAFF handle").c_str());
+	// Tuple of the record indices (int32) and the out of bounds indicators (bool)
+	PyObject* pyIndices = ToNumPy(pIndices);
+	PyObject* pyOutOfBounds = ToNumPy(pOutOfBounds);
+	if (!pyIndices || !pyOutOfBounds) {
+		Py_XDECREF(pyIndices);
+		Py_XDECREF(pyOutOfBounds);
 		return NULL;
-	} else {
-		DAFFReader* pReader = g_mReader[iHandle];
-		std::string sContentType = DAFFUtils::StrContentType(pReader->getContentType());
-		return PyUnicode_FromString(sContentType.c_str());
 	}
+
+	return Py_BuildValue("(NN)", pyIndices, pyOutOfBounds);
 }
 
-static PyObject* daff_metadata(PyObject*, PyObject* args, PyObject* kwargs)
+static PyObject* daff_records(PyObject* pSelf, PyObject* args, PyObject* kwargs)
 {
-	static const char* const keywords[] = {"index", NULL};
-	int iHandle = -1;
+	// Get the data of many records at once
+	static const char* const keywords[] = {"recordIndices", "threads", NULL};
+	PyObject* pyRecordIndices;
+	int iNumThreads = 0;
 
-	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i:metadata", const_cast<char**>(keywords), &iHandle)) {
-		PyErr_SetString(PyExc_KeyError, std::string("Wrong number of arguments").c_str());
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|i:records", const_cast<char**>(keywords), &pyRecordIndices,
+									 &iNumThreads))
 		return NULL;
-	}
 
-	if (!ValidHandle(iHandle)) {
-		PyErr_SetString(PyExc_ConnectionError, std::string("Invalid DAFF handle").c_str());
+	if (!GetReader(pSelf))
 		return NULL;
-	} else {
-		DAFFReader* pReader = g_mReader[iHandle];
-		int iContentType = pReader->getContentType();
 
-		// Create a new python dictionary
-		PyObject* metadata = PyDict_New();
+	// Shared, since the reader may be closed meanwhile (by the conversions or by other threads)
+	std::shared_ptr<DAFFReader> pReader = *((DAFFReaderObject*)pSelf)->ppReader;
 
-		// Get the metadata
-		const DAFFMetadata* pMetadata = pReader->getMetadata();
+	Py_buffer oIndices;
+	PyObject* pyArray;
+	if (!GetInputBuffer(pyRecordIndices, "int32", sizeof(int), oIndices, pyArray))
+		return NULL;
 
-		// Get all the metadata keys
-		std::vector<std::string> vsKeys;
-		pMetadata->getKeys(vsKeys);
+	const int* piRecordIndices = (const int*)oIndices.buf;
+	Py_ssize_t n = oIndices.len / (Py_ssize_t)sizeof(int);
+	int iNumRecords = pReader->getProperties()->getNumberOfRecords();
+	for (Py_ssize_t i = 0; i < n; i++) {
+		if ((piRecordIndices[i] < 0) || (piRecordIndices[i] >= iNumRecords)) {
+			PyBuffer_Release(&oIndices);
+			Py_DECREF(pyArray);
+			PyErr_SetString(PyExc_IndexError, std::string("Invalid record index").c_str());
+			return NULL;
+		}
+	}
 
+	const char* pszFormat;
+	Py_ssize_t nItemSize;
+	int iLength = GetRecordLayout(pReader.get(), pszFormat, nItemSize);
+	int iChannels = pReader->getProperties()->getNumberOfChannels();
+	Py_ssize_t pnShape[3] = {n, iChannels, iLength};
+	DAFFBufferObject* pBuffer = CreateBuffer(pszFormat, nItemSize, 3, pnShape);
+
+	int iError = DAFF_NO_ERROR;
+	if (pBuffer) {
+		BatchTask oTemplate = BatchTask();
+		oTemplate.pReader = pReader.get();
+		oTemplate.piRecordIndices = piRecordIndices;
+		oTemplate.pfData = (float*)pBuffer->pData;
+		oTemplate.nChannelFloats = (size_t)(iLength * nItemSize / sizeof(float));
+		oTemplate.nRecordFloats = iChannels * oTemplate.nChannelFloats;
+
+		Py_BEGIN_ALLOW_THREADS
+		iError = RunBatch(oTemplate, (size_t)n, BATCH_MIN_RECORDS_PER_THREAD, iNumThreads, &RecordsWorker);
+		Py_END_ALLOW_THREADS
+	}
 
-		for (const std::string& sKey : vsKeys) {
-			// Current key as python object
-			PyObject* pyKey = PyUnicode_FromString(sKey.c_str());
+	PyBuffer_Release(&oIndices);
+	Py_DECREF(pyArray);
 
-			// Check the value type and set the value to the python dictionary at the current key
-			switch (pMetadata->getKeyType(sKey)) {
-			case DAFFMetadata::DAFF_BOOL:
-				// Set the boolean value
-				PyDict_SetItem(metadata, pyKey, PyBool_FromLong(pMetadata->getKeyBool(sKey)));
-				break;
+	if (pBuffer && (iError != DAFF_NO_ERROR)) {
+		Py_DECREF(pBuffer);
+		PyErr_SetString(g_pDAFFError, DAFFUtils::StrError(iError).c_str());
+		return NULL;
+	}
 
-			case DAFFMetadata::DAFF_INT:
-				// Set the integer value
-				PyDict_SetItem(metadata, pyKey, PyLong_FromLong(pMetadata->getKeyInt(sKey)));
-				break;
+	return ToNumPy(pBuffer);
+}
 
-			case DAFFMetadata::DAFF_FLOAT:
-				// Set the floating point value
-				PyDict_SetItem(metadata, pyKey, PyFloat_FromDouble(pMetadata->getKeyFloat(sKey)));
-				break;
+static PyObject* daff_to_array(PyObject* pSelf, PyObject* args, PyObject* kwargs)
+{
+	// Get the data and the directions of all records
+	static const char* const keywords[] = {"threads", NULL};
+	int iNumThreads = 0;
 
-			case DAFFMetadata::DAFF_STRING:
-				// Set the string value
-				PyDict_SetItem(metadata, pyKey, PyUnicode_FromString(pMetadata->getKeyString(sKey).c_str()));
-				break;
-			}
-		}
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|i:to_array", const_cast<char**>(keywords), &iNumThreads))
+		return NULL;
+
+	if (!GetReader(pSelf))
+		return NULL;
 
-		return metadata;
+	// Shared, since the reader may be closed by another thread meanwhile
+	std::shared_ptr<DAFFReader> pReader = *((DAFFReaderObject*)pSelf)->ppReader;
+
+	const char* pszFormat;
+	Py_ssize_t nItemSize;
+	int iLength = GetRecordLayout(pReader.get(), pszFormat, nItemSize);
+	int iChannels = pReader->getProperties()->getNumberOfChannels();
+	Py_ssize_t n = pReader->getProperties()->getNumberOfRecords();
+	Py_ssize_t pnShape[3] = {n, iChannels, iLength};
+	Py_ssize_t pnCoordsShape[2] = {n, 2};
+
+	// Preallocated output, filled in a single pass
+	DAFFBufferObject* pData = CreateBuffer(pszFormat, nItemSize, 3, pnShape);
+	DAFFBufferObject* pDataCoords = CreateBuffer("f", sizeof(float), 2, pnCoordsShape);
+	DAFFBufferObject* pObjectCoords = CreateBuffer("f", sizeof(float), 2, pnCoordsShape);
+	if (!pData || !pDataCoords || !pObjectCoords) {
+		Py_XDECREF(pData);
+		Py_XDECREF(pDataCoords);
+		Py_XDECREF(pObjectCoords);
+		return NULL;
 	}
 
+	BatchTask oTemplate = BatchTask();
+	oTemplate.pReader = pReader.get();
+	oTemplate.pfData = (float*)pData->pData;
+	oTemplate.nChannelFloats = (size_t)(iLength * nItemSize / sizeof(float));
+	oTemplate.nRecordFloats = iChannels * oTemplate.nChannelFloats;
+	oTemplate.pfDataCoords = (float*)pDataCoords->pData;
+	oTemplate.pfObjectCoords = (float*)pObjectCoords->pData;
+
+	int iError;
+	Py_BEGIN_ALLOW_THREADS
+	iError = RunBatch(oTemplate, (size_t)n, BATCH_MIN_RECORDS_PER_THREAD, iNumThreads, &RecordsWorker);
+	Py_END_ALLOW_THREADS
+
+	if (iError != DAFF_NO_ERROR) {
+		Py_DECREF(pData);
+		Py_DECREF(pDataCoords);
+		Py_DECREF(pObjectCoords);
+		PyErr_SetString(g_pDAFFError, DAFFUtils::StrError(iError).c_str());
+		return NULL;
+	}
 
-	PyErr_SetString(PyExc_ConnectionError, std::string("Something went wrong.").c_str());
-	return Py_None;
+	// Tuple of the data [records, channels, values] and the record directions [records, 2] of both views
+	PyObject* pyData = ToNumPy(pData);
+	PyObject* pyDataCoords = ToNumPy(pDataCoords);
+	PyObject* pyObjectCoords = ToNumPy(pObjectCoords);
+	if (!pyData || !pyDataCoords || !pyObjectCoords) {
+		Py_XDECREF(pyData);
+		Py_XDECREF(pyDataCoords);
+		Py_XDECREF(pyObjectCoords);
+		return NULL;
+	}
+
+	return Py_BuildValue("(NNN)", pyData, pyDataCoords, pyObjectCoords);
 }
 
-static PyObject* daff_properties(PyObject*, PyObject* args, PyObject* kwargs)
+
+static PyObject* daff_content_type(PyObject* pSelf, PyObject*)
 {
-	static const char* const keywords[] = {"index", NULL};
-	int iHandle = -1;
+	DAFFReader* pReader = GetReader(pSelf);
+	if (!pReader)
+		return NULL;
+
+	int iContentType = pReader->getContentType();
+	return PyLong_FromLong(iContentType);
+}
 
-	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i:properties", const_cast<char**>(keywords), &iHandle)) {
-		PyErr_SetString(PyExc_KeyError, std::string("Wrong number of arguments").c_str());
+static PyObject* daff_content_type_str(PyObject* pSelf, PyObject*)
+{
+	DAFFReader* pReader = GetReader(pSelf);
+	if (!pReader)
 		return NULL;
-	}
 
-	if (!ValidHandle(iHandle)) {
-		PyErr_SetString(PyExc_ConnectionError, std::string("Invalid DAFF handle").c_str());
+	std::string sContentType = DAFFUtils::StrContentType(pReader->getContentType());
+	return PyUnicode_FromString(sContentType.c_str());
+}
+
+static PyObject* daff_metadata(PyObject* pSelf, PyObject*)
+{
+	DAFFReader* pReader = GetReader(pSelf);
+	if (!pReader)
 		return NULL;
-	} else {
-		// Create a new python dictionary
-		PyObject* pyProperties = PyDict_New();
 
+	int iContentType = pReader->getContentType();
 
-		DAFFReader* pReader = g_mReader[iHandle];
-		const DAFFProperties* pProps = pReader->getProperties();
+	// Create a new python dictionary
+	PyObject* metadata = PyDict_New();
 
-		// --= Create a Python dictionary of the property fields =----------
+	// Get the metadata
+	const DAFFMetadata* pMetadata = pReader->getMetadata();
 
-		// Filename
-		PyDict_SetItem(pyProperties, PyUnicode_FromString("Filename"),
-					   PyUnicode_FromString(pReader->getFilename().c_str()));
+	// Get all the metadata keys
+	std::vector<std::string> vsKeys;
+	pMetadata->getKeys(vsKeys);
 
-		// File format version
-		PyDict_SetItem(pyProperties, PyUnicode_FromString("FileFormatVersion"),
-					   PyLong_FromLong(pReader->getFileFormatVersion()));
 
-		// Content type
-		int iContentType = pReader->getContentType();
-		std::string sContentType = DAFFUtils::StrShortContentType(iContentType);
-		PyDict_SetItem(pyProperties, PyUnicode_FromString("ContentType"), PyUnicode_FromString(sContentType.c_str()));
+	for (const std::string& sKey : vsKeys) {
+		// Current key as python object
+		PyObject* pyKey = PyUnicode_FromString(sKey.c_str());
 
-		// Quantization
-		int iQuantization = pProps->getQuantization();
-		std::string sQuantization;
-		if (iQuantization == DAFF_INT16)
-			sQuantization = "int16";
-		if (iQuantization == DAFF_INT24)
-			sQuantization = "int24";
-		if (iQuantization == DAFF_FLOAT32)
-			sQuantization = "float32";
-		PyDict_SetItem(pyProperties, PyUnicode_FromString("Quantization"), PyUnicode_FromString(sQuantization.c_str()));
+		// Check the value type and set the value to the python dictionary at the current key
+		switch (pMetadata->getKeyType(sKey)) {
+		case DAFFMetadata::DAFF_BOOL:
+			// Set the boolean value
+			PyDict_SetItem(metadata, pyKey, PyBool_FromLong(pMetadata->getKeyBool(sKey)));
+			break;
 
-		// Number of channels
-		int iChannels = pProps->getNumberOfChannels();
-		PyDict_SetItem(pyProperties, PyUnicode_FromString("NumChannels"), PyLong_FromLong(iChannels));
+		case DAFFMetadata::DAFF_INT:
+			// Set the integer value
+			PyDict_SetItem(metadata, pyKey, PyLong_FromLong(pMetadata->getKeyInt(sKey)));
+			break;
 
-		// Number of records
-		PyDict_SetItem(pyProperties, PyUnicode_FromString("NumRecords"), PyLong_FromLong(pProps->getNumberOfRecords()));
+		case DAFFMetadata::DAFF_FLOAT:
+			// Set the floating point value
+			PyDict_SetItem(metadata, pyKey, PyFloat_FromDouble(pMetadata->getKeyFloat(sKey)));
+			break;
 
-		// Channel labels (python list of strings)
-		PyObject* pyChannelLabels = PyList_New(0);
-		for (int c = 0; c < iChannels; c++) {
-			if (!pProps->getChannelLabel(c).empty())
-				PyList_Append(pyChannelLabels, PyUnicode_FromString(pProps->getChannelLabel(c).c_str()));
-		}
-		PyDict_SetItem(pyProperties, PyUnicode_FromString("ChannelLabels"), pyChannelLabels);
-
-
-		// Alpha points
-		PyDict_SetItem(pyProperties, PyUnicode_FromString("AlphaPoints"), PyLong_FromLong(pProps->getAlphaPoints()));
-
-		// Alpha resolution
-		PyDict_SetItem(pyProperties, PyUnicode_FromString("AlphaResolution"),
-					   PyFloat_FromDouble(pProps->getAlphaResolution()));
-
-		// Alpha range
-		PyObject* pyAlphaRange = PyList_New(0);
-		float alphaStart = pProps->getAlphaStart();
-		float alphaEnd = pProps->getAlphaEnd();
-		PyList_Append(pyAlphaRange, PyFloat_FromDouble(alphaStart));
-		PyList_Append(pyAlphaRange, PyFloat_FromDouble(alphaEnd));
-		PyDict_SetItem(pyProperties, PyUnicode_FromString("AlphaRange"), pyAlphaRange);
-
-		// Beta points
-		PyDict_SetItem(pyProperties, PyUnicode_FromString("BetaPoints"), PyLong_FromLong(pProps->getBetaPoints()));
-
-		// Beta resolution
-		PyDict_SetItem(pyProperties, PyUnicode_FromString("BetaResolution"),
-					   PyFloat_FromDouble(pProps->getBetaResolution()));
-
-		// Beta range
-		PyObject* pyBetaRange = PyList_New(0);
-		float betaStart = pProps->getBetaStart();
-		float betaEnd = pProps->getBetaEnd();
-		PyList_Append(pyBetaRange, PyFloat_FromDouble(betaStart));
-		PyList_Append(pyBetaRange, PyFloat_FromDouble(betaEnd));
-		PyDict_SetItem(pyProperties, PyUnicode_FromString("BetaRange"), pyBetaRange);
-
-		// Orientation
-		DAFFOrientationYPR orient;
-		PyObject* pyOrientation = PyDict_New();
-		pProps->getOrientation(orient);
-		float fYawAngle = orient.fYawAngleDeg;
-		float fPitchAngle = orient.fPitchAngleDeg;
-		float fRollAngle = orient.fRollAngleDeg;
-		PyDict_SetItem(pyOrientation, PyUnicode_FromString("YawAngle"), PyFloat_FromDouble(fYawAngle));
-		PyDict_SetItem(pyOrientation, PyUnicode_FromString("PitchAngle"), PyFloat_FromDouble(fPitchAngle));
-		PyDict_SetItem(pyOrientation, PyUnicode_FromString("RollAngle"), PyFloat_FromDouble(fRollAngle));
-		PyDict_SetItem(pyProperties, PyUnicode_FromString("Orientation"), pyOrientation);
-
-		// Default orientation
-		PyObject* pyDefOrientation = PyDict_New();
-
-		pProps->getDefaultOrientation(orient);
-		fYawAngle = orient.fYawAngleDeg;
-		fPitchAngle = orient.fPitchAngleDeg;
-		fRollAngle = orient.fRollAngleDeg;
-		PyDict_SetItem(pyDefOrientation, PyUnicode_FromString("YawAngle"), PyFloat_FromDouble(fYawAngle));
-		PyDict_SetItem(pyDefOrientation, PyUnicode_FromString("PitchAngle"), PyFloat_FromDouble(fPitchAngle));
-		PyDict_SetItem(pyDefOrientation, PyUnicode_FromString("RollAngle"), PyFloat_FromDouble(fRollAngle));
-		PyDict_SetItem(pyProperties, PyUnicode_FromString("OrientationDefault"), pyDefOrientation);
-
-
-		// Full sphere
-		PyDict_SetItem(pyProperties, PyUnicode_FromString("FullSphere"), PyBool_FromLong(pProps->coversFullSphere()));
-
-		if (iContentType == DAFF_IMPULSE_RESPONSE) {
-			DAFFContentIR* pContent = dynamic_cast<DAFFContentIR*>(pReader->getContent());
-
-			// Samplerate
-			PyDict_SetItem(pyProperties, PyUnicode_FromString("Samplerate"),
-						   PyFloat_FromDouble(pContent->getSamplerate()));
-
-			// Filter length
-			PyDict_SetItem(pyProperties, PyUnicode_FromString("FilterLength"),
-						   PyLong_FromLong(pContent->getFilterLength()));
-		} else if (iContentType == DAFF_MAGNITUDE_SPECTRUM || iContentType == DAFF_PHASE_SPECTRUM ||
-				   iContentType == DAFF_MAGNITUDE_PHASE_SPECTRUM) {
-			DAFFContentMS* pContent = dynamic_cast<DAFFContentMS*>(pReader->getContent());
-
-			// Number of frequencies
-			int iNumFreqs = pContent->getNumFrequencies();
-			PyDict_SetItem(pyProperties, PyUnicode_FromString("NumFreqs"), PyLong_FromLong(iNumFreqs));
-
-			// Frequencies
-			PyObject* pyFrequencies = PyList_New(0);
-			const std::vector<float>& vfFreqs = pContent->getFrequencies();
-			for (int i = 0; i < iNumFreqs; i++)
-				PyList_Append(pyFrequencies, PyFloat_FromDouble(vfFreqs[i]));
-			PyDict_SetItem(pyProperties, PyUnicode_FromString("Frequencies"), pyFrequencies);
-		} else if (iContentType == DAFF_DFT_SPECTRUM) {
-			DAFFContentDFT* pContent = dynamic_cast<DAFFContentDFT*>(pReader->getContent());
-
-			PyDict_SetItem(pyProperties, PyUnicode_FromString("TransformSize"),
-						   PyLong_FromLong(pContent->getTransformSize()));
-			PyDict_SetItem(pyProperties, PyUnicode_FromString("NumDFTCoeffs"),
-						   PyLong_FromLong(pContent->getNumDFTCoeffs()));
-			PyDict_SetItem(pyProperties, PyUnicode_FromString("IsSymmetric"), PyBool_FromLong(pContent->isSymmetric()));
-			PyDict_SetItem(pyProperties, PyUnicode_FromString("Samplerate"),
-						   PyFloat_FromDouble(pContent->getSamplerate()));
-			PyDict_SetItem(pyProperties, PyUnicode_FromString("FrequencyBandwidth"),
-						   PyFloat_FromDouble(pContent->getFrequencyBandwidth()));
+		case DAFFMetadata::DAFF_STRING:
+			// Set the string value
+			PyDict_SetItem(metadata, pyKey, PyUnicode_FromString(pMetadata->getKeyString(sKey).c_str()));
+			break;
 		}
+	}
+
+	return metadata;
+}
+
+static PyObject* daff_properties(PyObject* pSelf, PyObject*)
+{
+	DAFFReader* pReader = GetReader(pSelf);
+	if (!pReader)
+		return NULL;
+
+	// Create a new python dictionary
+	PyObject* pyProperties = PyDict_New();
 
+	const DAFFProperties* pProps = pReader->getProperties();
 
-		return pyProperties;
+	// --= Create a Python dictionary of the property fields =----------
+
+	// Filename
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("Filename"),
+				   PyUnicode_FromString(pReader->getFilename().c_str()));
+
+	// File format version
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("FileFormatVersion"),
+				   PyLong_FromLong(pReader->getFileFormatVersion()));
+
+	// Content type
+	int iContentType = pReader->getContentType();
+	std::string sContentType = DAFFUtils::StrShortContentType(iContentType);
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("ContentType"), PyUnicode_FromString(sContentType.c_str()));
+
+	// Quantization
+	int iQuantization = pProps->getQuantization();
+	std::string sQuantization;
+	if (iQuantization == DAFF_INT16)
+		sQuantization = "int16";
+	if (iQuantization == DAFF_INT24)
+		sQuantization = "int24";
+	if (iQuantization == DAFF_FLOAT16)
+		sQuantization = "float16";
+	if (iQuantization == DAFF_BFLOAT16)
+		sQuantization = "bfloat16";
+	if (iQuantization == DAFF_INT16_BFP)
+		sQuantization = "int16_bfp";
+	if (iQuantization == DAFF_FLOAT32)
+		sQuantization = "float32";
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("Quantization"), PyUnicode_FromString(sQuantization.c_str()));
+
+	// Number of channels
+	int iChannels = pProps->getNumberOfChannels();
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("NumChannels"), PyLong_FromLong(iChannels));
+
+	// Number of records
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("NumRecords"), PyLong_FromLong(pProps->getNumberOfRecords()));
+
+	// Channel labels (python list of strings)
+	PyObject* pyChannelLabels = PyList_New(0);
+	for (int c = 0; c < iChannels; c++) {
+		if (!pProps->getChannelLabel(c).empty())
+			PyList_Append(pyChannelLabels, PyUnicode_FromString(pProps->getChannelLabel(c).c_str()));
 	}
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("ChannelLabels"), pyChannelLabels);
+
+
+	// Alpha points
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("AlphaPoints"), PyLong_FromLong(pProps->getAlphaPoints()));
+
+	// Alpha resolution
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("AlphaResolution"),
+				   PyFloat_FromDouble(pProps->getAlphaResolution()));
+
+	// Alpha range
+	PyObject* pyAlphaRange = PyList_New(0);
+	float alphaStart = pProps->getAlphaStart();
+	float alphaEnd = pProps->getAlphaEnd();
+	PyList_Append(pyAlphaRange, PyFloat_FromDouble(alphaStart));
+	PyList_Append(pyAlphaRange, PyFloat_FromDouble(alphaEnd));
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("AlphaRange"), pyAlphaRange);
+
+	// Beta points
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("BetaPoints"), PyLong_FromLong(pProps->getBetaPoints()));
+
+	// Beta resolution
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("BetaResolution"),
+				   PyFloat_FromDouble(pProps->getBetaResolution()));
+
+	// Beta range
+	PyObject* pyBetaRange = PyList_New(0);
+	float betaStart = pProps->getBetaStart();
+	float betaEnd = pProps->getBetaEnd();
+	PyList_Append(pyBetaRange, PyFloat_FromDouble(betaStart));
+	PyList_Append(pyBetaRange, PyFloat_FromDouble(betaEnd));
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("BetaRange"), pyBetaRange);
+
+	// Orientation
+	DAFFOrientationYPR orient;
+	PyObject* pyOrientation = PyDict_New();
+	pProps->getOrientation(orient);
+	float fYawAngle = orient.fYawAngleDeg;
+	float fPitchAngle = orient.fPitchAngleDeg;
+	float fRollAngle = orient.fRollAngleDeg;
+	PyDict_SetItem(pyOrientation, PyUnicode_FromString("YawAngle"), PyFloat_FromDouble(fYawAngle));
+	PyDict_SetItem(pyOrientation, PyUnicode_FromString("PitchAngle"), PyFloat_FromDouble(fPitchAngle));
+	PyDict_SetItem(pyOrientation, PyUnicode_FromString("RollAngle"), PyFloat_FromDouble(fRollAngle));
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("Orientation"), pyOrientation);
+
+	// Default orientation
+	PyObject* pyDefOrientation = PyDict_New();
+
+	pProps->getDefaultOrientation(orient);
+	fYawAngle = orient.fYawAngleDeg;
+	fPitchAngle = orient.fPitchAngleDeg;
+	fRollAngle = orient.fRollAngleDeg;
+	PyDict_SetItem(pyDefOrientation, PyUnicode_FromString("YawAngle"), PyFloat_FromDouble(fYawAngle));
+	PyDict_SetItem(pyDefOrientation, PyUnicode_FromString("PitchAngle"), PyFloat_FromDouble(fPitchAngle));
+	PyDict_SetItem(pyDefOrientation, PyUnicode_FromString("RollAngle"), PyFloat_FromDouble(fRollAngle));
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("OrientationDefault"), pyDefOrientation);
+
+
+	// Full sphere
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("FullSphere"), PyBool_FromLong(pProps->coversFullSphere()));
+
+	// Regular grid
+	PyDict_SetItem(pyProperties, PyUnicode_FromString("RegularGrid"), PyBool_FromLong(pProps->isRegularGrid()));
 
+	if (iContentType == DAFF_IMPULSE_RESPONSE) {
+		DAFFContentIR* pContent = dynamic_cast<DAFFContentIR*>(pReader->getContent());
 
-	PyErr_SetString(PyExc_ConnectionError, std::string("Something went wrong.").c_str());
-	return Py_None;
+		// Samplerate
+		PyDict_SetItem(pyProperties, PyUnicode_FromString("Samplerate"),
+					   PyFloat_FromDouble(pContent->getSamplerate()));
+
+		// Filter length
+		PyDict_SetItem(pyProperties, PyUnicode_FromString("FilterLength"),
+					   PyLong_FromLong(pContent->getFilterLength()));
+	} else if (iContentType == DAFF_MAGNITUDE_SPECTRUM || iContentType == DAFF_PHASE_SPECTRUM ||
+			   iContentType == DAFF_MAGNITUDE_PHASE_SPECTRUM) {
+		DAFFContentMS* pContent = dynamic_cast<DAFFContentMS*>(pReader->getContent());
+
+		// Number of frequencies
+		int iNumFreqs = pContent->getNumFrequencies();
+		PyDict_SetItem(pyProperties, PyUnicode_FromString("NumFreqs"), PyLong_FromLong(iNumFreqs));
+
+		// Frequencies
+		PyObject* pyFrequencies = PyList_New(0);
+		const std::vector<float>& vfFreqs = pContent->getFrequencies();
+		for (int i = 0; i < iNumFreqs; i++)
+			PyList_Append(pyFrequencies, PyFloat_FromDouble(vfFreqs[i]));
+		PyDict_SetItem(pyProperties, PyUnicode_FromString("Frequencies"), pyFrequencies);
+	} else if (iContentType == DAFF_DFT_SPECTRUM) {
+		DAFFContentDFT* pContent = dynamic_cast<DAFFContentDFT*>(pReader->getContent());
+
+		PyDict_SetItem(pyProperties, PyUnicode_FromString("TransformSize"),
+					   PyLong_FromLong(pContent->getTransformSize()));
+		PyDict_SetItem(pyProperties, PyUnicode_FromString("NumDFTCoeffs"),
+					   PyLong_FromLong(pContent->getNumDFTCoeffs()));
+		PyDict_SetItem(pyProperties, PyUnicode_FromString("IsSymmetric"), PyBool_FromLong(pContent->isSymmetric()));
+		PyDict_SetItem(pyProperties, PyUnicode_FromString("Samplerate"),
+					   PyFloat_FromDouble(pContent->getSamplerate()));
+		PyDict_SetItem(pyProperties, PyUnicode_FromString("FrequencyBandwidth"),
+					   PyFloat_FromDouble(pContent->getFrequencyBandwidth()));
+	}
+
+
+	return pyProperties;
+}
+
+
+static PyObject* daff_memory_footprint(PyObject* pSelf, PyObject*)
+{
+	DAFFReader* pReader = GetReader(pSelf);
+	if (!pReader)
+		return NULL;
+
+	DAFFMemoryFootprint oFootprint;
+	pReader->getMemoryFootprint(oFootprint);
+
+	PyObject* pyFootprint = PyDict_New();
+	PyDict_SetItem(pyFootprint, PyUnicode_FromString("Headers"), PyLong_FromUnsignedLongLong(oFootprint.ui64Headers));
+	PyDict_SetItem(pyFootprint, PyUnicode_FromString("RecordDescriptors"),
+				   PyLong_FromUnsignedLongLong(oFootprint.ui64RecordDescriptors));
+	PyDict_SetItem(pyFootprint, PyUnicode_FromString("RecordData"),
+				   PyLong_FromUnsignedLongLong(oFootprint.ui64RecordData));
+	PyDict_SetItem(pyFootprint, PyUnicode_FromString("RecordCache"),
+				   PyLong_FromUnsignedLongLong(oFootprint.ui64RecordCache));
+	PyDict_SetItem(pyFootprint, PyUnicode_FromString("Metadata"), PyLong_FromUnsignedLongLong(oFootprint.ui64Metadata));
+	PyDict_SetItem(pyFootprint, PyUnicode_FromString("Statistics"),
+				   PyLong_FromUnsignedLongLong(oFootprint.ui64Statistics));
+	PyDict_SetItem(pyFootprint, PyUnicode_FromString("Total"), PyLong_FromUnsignedLongLong(oFootprint.ui64Total));
+	PyDict_SetItem(pyFootprint, PyUnicode_FromString("Mapped"), PyLong_FromUnsignedLongLong(oFootprint.ui64Mapped));
+	return pyFootprint;
 }
 
 
 // ------------------ module definitions ------------------ //
 
-static PyMethodDef daff_methods[] = {
-	{"open", (PyCFunction)(void (*)(void))daff_open, METH_VARARGS | METH_KEYWORDS, open_doc},
-	{"close", (PyCFunction)(void (*)(void))daff_close, METH_VARARGS | METH_KEYWORDS, no_doc},
+static PyMethodDef g_oReaderMethods[] = {
+	{"close", (PyCFunction)daff_close, METH_NOARGS, close_doc},
 	{"nearest_neighbour_index", (PyCFunction)(void (*)(void))daff_nearest_neighbour_index, METH_VARARGS | METH_KEYWORDS,
 	 no_doc},
 	{"nearest_neighbour_record", (PyCFunction)(void (*)(void))daff_nearest_neighbour_record,
-	 METH_VARARGS | METH_KEYWORDS, no_doc},
-	{"record", (PyCFunction)(void (*)(void))daff_record, METH_VARARGS | METH_KEYWORDS, no_doc},
-	{"content_type", (PyCFunction)(void (*)(void))daff_content_type, METH_VARARGS | METH_KEYWORDS, no_doc},
-	{"content_type_str", (PyCFunction)(void (*)(void))daff_content_type_str, METH_VARARGS | METH_KEYWORDS, no_doc},
-	{"metadata", (PyCFunction)(void (*)(void))daff_metadata, METH_VARARGS | METH_KEYWORDS, no_doc},
-	{"properties", (PyCFunction)(void (*)(void))daff_properties, METH_VARARGS | METH_KEYWORDS, no_doc},
+	 METH_VARARGS | METH_KEYWORDS, nearest_neighbour_record_doc},
+	{"record", (PyCFunction)(void (*)(void))daff_record, METH_VARARGS | METH_KEYWORDS, record_doc},
+	{"nearest_neighbour_indices", (PyCFunction)(void (*)(void))daff_nearest_neighbour_indices,
+	 METH_VARARGS | METH_KEYWORDS, nearest_neighbour_indices_doc},
+	{"records", (PyCFunction)(void (*)(void))daff_records, METH_VARARGS | METH_KEYWORDS, records_doc},
+	{"to_array", (PyCFunction)(void (*)(void))daff_to_array, METH_VARARGS | METH_KEYWORDS, to_array_doc},
+	{"content_type", (PyCFunction)daff_content_type, METH_NOARGS, no_doc},
+	{"content_type_str", (PyCFunction)daff_content_type_str, METH_NOARGS, no_doc},
+	{"metadata", (PyCFunction)daff_metadata, METH_NOARGS, no_doc},
+	{"properties", (PyCFunction)daff_properties, METH_NOARGS, no_doc},
+	{"memory_footprint", (PyCFunction)daff_memory_footprint, METH_NOARGS, memory_footprint_doc},
+	{"__enter__", (PyCFunction)daff_enter, METH_NOARGS, no_doc},
+	{"__exit__", (PyCFunction)daff_exit, METH_VARARGS, close_doc},
+	{NULL, NULL, 0, NULL} /* Sentinel */
+};
+
+static PyMethodDef daff_methods[] = {
+	{"open", (PyCFunction)(void (*)(void))daff_open, METH_VARARGS | METH_KEYWORDS, open_doc},
 	{NULL, NULL, 0, NULL} /* Sentinel */
 };
 
@@ -644,9 +1124,30 @@ static struct PyModuleDef daff_module_def = {
 
 PyMODINIT_FUNC PyInit_daffCppInterface(void)
 {
+	g_oBufferType.tp_basicsize = sizeof(DAFFBufferObject);
+	g_oBufferType.tp_dealloc = DAFFBuffer_dealloc;
+	g_oBufferType.tp_as_buffer = &g_oBufferProcs;
+	g_oBufferType.tp_flags = Py_TPFLAGS_DEFAULT;
+	g_oBufferType.tp_doc = buffer_doc;
+	if (PyType_Ready(&g_oBufferType) < 0)
+		return NULL;
+
+	g_oReaderType.tp_basicsize = sizeof(DAFFReaderObject);
+	g_oReaderType.tp_dealloc = DAFFReader_dealloc;
+	g_oReaderType.tp_flags = Py_TPFLAGS_DEFAULT;
+	g_oReaderType.tp_doc = reader_doc;
+	g_oReaderType.tp_methods = g_oReaderMethods;
+	g_oReaderType.tp_init = DAFFReader_init;
+	g_oReaderType.tp_new = PyType_GenericNew;
+	if (PyType_Ready(&g_oReaderType) < 0)
+		return NULL;
+
 	PyObject* pModule = PyModule_Create(&daff_module_def);
+	Py_INCREF(&g_oReaderType);
+	PyModule_AddObject(pModule, "Reader", (PyObject*)&g_oReaderType);
 	g_pDAFFError = PyErr_NewException("daffCppInterface.error", NULL, NULL);
 	Py_INCREF(g_pDAFFError);
+	PyModule_AddObject(pModule, "error", g_pDAFFError);
 
 	return pModule;
 }
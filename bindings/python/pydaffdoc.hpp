@@ -13,10 +13,47 @@
 
 #include <Python.h>
 
-PyDoc_STRVAR(daff_doc, "open( filepath ) - Open a DAFF file from a file path\n"
-					   "close() - close the DAFF file.");
+PyDoc_STRVAR(daff_doc, "open( filepath, flags = 0 ) - Open a DAFF file from a file path, returns a Reader\n"
+					   "Reader.close() - close the DAFF file.");
 
 PyDoc_STRVAR(no_doc, "For this method no dedicated documentation is available. Please read the C++ API documentation\n"
 					 "of this method for further information.");
 
-PyDoc_STRVAR(open_doc, "open( filepath ): open a DAFF file\n");
+PyDoc_STRVAR(open_doc, "open( filepath, flags = 0 ): open a DAFF file (flags: combination of DAFF_OPEN_FLAGS),\n"
+					   "returns a Reader (same as Reader( filepath, flags ))\n");
+
+PyDoc_STRVAR(reader_doc,
+			 "Reader( filepath, flags = 0 ): opened DAFF file. The file is closed by close(), at the end of a\n"
+			 "with block or when the object is deleted. Readers are independent of each other, their batch\n"
+			 "queries run without the GIL and may be called concurrently from several threads.\n");
+
+PyDoc_STRVAR(close_doc, "close(): close the DAFF file (record views keep their data alive)\n");
+
+PyDoc_STRVAR(record_doc,
+			 "record( recordIndex ): record data as a NumPy array [channels, values]\n"
+			 "Float data is returned as a read-only view without copying (float32 files or files opened\n"
+			 "with DAFF_OPEN_DECODE, not with DAFF_OPEN_LAZY), otherwise as a copy. Spectra with real and\n"
+			 "imaginary parts are complex64.\n");
+
+PyDoc_STRVAR(nearest_neighbour_record_doc,
+			 "nearest_neighbour_record( view, angle1, angle2 ): record data of the nearest neighbour\n"
+			 "as a NumPy array [channels, values], see record()\n");
+
+PyDoc_STRVAR(nearest_neighbour_indices_doc,
+			 "nearest_neighbour_indices( view, angles1, angles2, threads = 0 ): nearest neighbours of many\n"
+			 "directions at once, returns the record indices (int32) and the out of bounds indicators (bool) as\n"
+			 "flat NumPy arrays. The angle arrays are converted to float32, the work is distributed over the\n"
+			 "worker threads (0: all cores) and runs without the GIL.\n");
+
+PyDoc_STRVAR(records_doc,
+			 "records( recordIndices, threads = 0 ): data of many records at once as a NumPy array\n"
+			 "[records, channels, values], fetched by worker threads (0: all cores) without the GIL\n");
+
+PyDoc_STRVAR(to_array_doc,
+			 "to_array( threads = 0 ): all records as a NumPy array [records, channels, values] along with\n"
+			 "the record directions of the data view (alpha, beta) and the object view (phi, theta) as arrays\n"
+			 "[records, 2] in degrees. Filled by worker threads (0: all cores) without the GIL.\n");
+
+PyDoc_STRVAR(buffer_doc, "Record data exported through the buffer protocol (wrapped into NumPy arrays)");
+
+PyDoc_STRVAR(memory_footprint_doc, "memory_footprint(): heap memory held by the reader per category [bytes]\n");
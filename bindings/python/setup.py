@@ -5,11 +5,27 @@ daffmodule = Extension(
     include_dirs=["../../include"],
     sources=[
         "pydaff.cpp",
+        "../../src/DAFFChecksum.cpp",
+        "../../src/DAFFCompression.cpp",
+        "../../src/DAFFContentCache.cpp",
+        "../../src/DAFFConverter.cpp",
+        "../../src/DAFFDirectionLUT.cpp",
+        "../../src/DAFFFileSource.cpp",
+        "../../src/DAFFFilterCrossfader.cpp",
+        "../../src/DAFFInstrumentation.cpp",
+        "../../src/DAFFInterpolator.cpp",
+        "../../src/DAFFMappedFile.cpp",
         "../../src/DAFFMetadataImpl.cpp",
         "../../src/DAFFReader.cpp",
         "../../src/DAFFReaderImpl.cpp",
+        "../../src/DAFFRealtimeFilterSlot.cpp",
+        "../../src/DAFFRecordCache.cpp",
         "../../src/DAFFSCTransform.cpp",
+        "../../src/DAFFSIMDAVX2.cpp",
+        "../../src/DAFFSphereIndex.cpp",
         "../../src/DAFFUtils.cpp",
+        "../../src/DAFFView.cpp",
+        "../../src/DAFFWriter.cpp",
         "../../src/Utils.cpp",
     ],
 )
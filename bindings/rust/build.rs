@@ -5,7 +5,7 @@ fn main() {
     // Get the build output directory
     let manifest_dir = env::var("CARGO_MANIFEST_DIR").unwrap();
 
-    // Link to the C++ wrapper library
+    // Link to the C interface library (bindings/c)
     // By default, we'll look in ../../build for the shared library
     let build_dir = PathBuf::from(&manifest_dir)
         .join("../..")
@@ -16,11 +16,8 @@ fn main() {
     println!("cargo:rustc-link-search=native=/usr/local/lib");
     println!("cargo:rustc-link-search=native=/usr/lib");
 
-    // Link the wrapper library
-    println!("cargo:rustc-link-lib=dylib=daffrustwrapper");
-
-    // Also link the main DAFF library
-    println!("cargo:rustc-link-lib=dylib=DAFF");
+    // Link the C interface library (contains or references the DAFF library)
+    println!("cargo:rustc-link-lib=dylib=daff_c");
 
     // Link the C++ standard library
     #[cfg(target_os = "linux")]
@@ -29,9 +26,8 @@ fn main() {
     #[cfg(target_os = "macos")]
     println!("cargo:rustc-link-lib=dylib=c++");
 
-    // Rerun if the wrapper changes
-    println!("cargo:rerun-if-changed=daff_rust_wrapper.h");
-    println!("cargo:rerun-if-changed=daff_rust_wrapper.cpp");
+    // Rerun if the C interface changes
+    println!("cargo:rerun-if-changed=../c/daff_c.h");
 
     // Set rpath for finding shared libraries at runtime
     #[cfg(target_os = "linux")]
@@ -0,0 +1,154 @@
+//! Rust driver of the cross-language binding benchmark
+//!
+//! Runs the workload of tests/benchmark/BindingBenchmark.cpp through the Rust binding and
+//! prints the results in its CSV format. The workload file is written by the native baseline
+//! (BindingBenchmark -w), tests/benchmark/binding_benchmark.py runs both and reports the
+//! per-call overhead of the binding.
+//!
+//! Usage: cargo run --release --example binding_benchmark -- file [queries [fetches [opens]]]
+
+use opendaff::{Reader, View};
+use std::env;
+use std::time::{Duration, Instant};
+
+/// Size of the query pool (also the batch size)
+const NUM_QUERIES: usize = 4096;
+
+/// Pseudo-random generator of the native baseline (Random of BenchmarkData.h)
+struct Random {
+    state: u32,
+}
+
+impl Random {
+    fn next(&mut self) -> f32 {
+        self.state = self.state.wrapping_mul(1664525).wrapping_add(1013904223);
+        (self.state >> 8) as f32 / 16777216.0
+    }
+}
+
+/// Same directions and record indices as the native baseline
+fn query_pool(num_records: i32) -> (Vec<f32>, Vec<f32>, Vec<i32>) {
+    let mut random = Random { state: 12345 };
+    let mut azimuths = Vec::with_capacity(NUM_QUERIES);
+    let mut elevations = Vec::with_capacity(NUM_QUERIES);
+    let mut records = Vec::with_capacity(NUM_QUERIES);
+    for _ in 0..NUM_QUERIES {
+        azimuths.push(360.0 * random.next() - 180.0);
+        elevations.push(180.0 * random.next() - 90.0);
+        records.push(((random.next() * num_records as f32) as i32).min(num_records - 1));
+    }
+    (azimuths, elevations, records)
+}
+
+fn print_result(operation: &str, variant: &str, calls: usize, elapsed: Duration, checksum: f64) {
+    let per_call = elapsed.as_nanos() as f64 / calls.max(1) as f64;
+    println!(
+        "rust,{},{},{},{:.2},{:.6}",
+        operation, variant, calls, per_call, checksum
+    );
+}
+
+fn main() -> Result<(), Box<dyn std::error::Error>> {
+    let args: Vec<String> = env::args().collect();
+    if args.len() < 2 {
+        eprintln!("Usage: {} file [queries [fetches [opens]]]", args[0]);
+        std::process::exit(255);
+    }
+    let path = &args[1];
+    let argument = |index: usize, default: usize| -> usize {
+        args.get(index)
+            .and_then(|a| a.parse().ok())
+            .unwrap_or(default)
+    };
+    let queries = argument(2, 1_000_000);
+    let fetches = argument(3, 100_000);
+    let opens = argument(4, 50);
+
+    println!("binding,operation,variant,calls,ns_per_call,checksum");
+
+    let mut reader = Reader::new()?;
+    let t0 = Instant::now();
+    for _ in 0..opens {
+        reader.open_file(path)?;
+        reader.close();
+    }
+    print_result("open", "call", opens, t0.elapsed(), 0.0);
+
+    reader.open_file(path)?;
+    let ir = reader.content_ir()?;
+    let num_channels = reader.num_channels();
+    let (azimuths, elevations, records) = query_pool(reader.num_records());
+
+    // Nearest neighbours, one call per direction and batches of the query pool
+    let mut checksum = 0.0;
+    let t0 = Instant::now();
+    for i in 0..queries {
+        let j = i & (NUM_QUERIES - 1);
+        checksum += ir.nearest_neighbour(azimuths[j] as f64, elevations[j] as f64) as f64;
+    }
+    print_result("nearest_neighbour", "call", queries, t0.elapsed(), checksum);
+
+    let mut indices = vec![0i32; NUM_QUERIES];
+    checksum = 0.0;
+    let t0 = Instant::now();
+    for i in (0..queries).step_by(NUM_QUERIES) {
+        let n = NUM_QUERIES.min(queries - i);
+        reader.nearest_neighbours(
+            View::Object,
+            &azimuths[..n],
+            &elevations[..n],
+            &mut indices[..n],
+            None,
+        )?;
+        checksum += indices[..n].iter().map(|&index| index as f64).sum::<f64>();
+    }
+    print_result(
+        "nearest_neighbour",
+        "batch",
+        queries,
+        t0.elapsed(),
+        checksum,
+    );
+
+    // Record fetches, a vector per channel and call, batches into one buffer and borrowed data
+    checksum = 0.0;
+    let t0 = Instant::now();
+    for i in 0..fetches {
+        let record = records[i & (NUM_QUERIES - 1)];
+        for c in 0..num_channels {
+            let coeffs = ir.filter_coeffs(record, c)?;
+            if c == 0 {
+                checksum += coeffs[0] as f64;
+            }
+        }
+    }
+    print_result("record", "call", fetches, t0.elapsed(), checksum);
+
+    let record_size = (num_channels * reader.record_length()) as usize;
+    let mut data = vec![0.0f32; NUM_QUERIES * record_size];
+    checksum = 0.0;
+    let t0 = Instant::now();
+    for i in (0..fetches).step_by(NUM_QUERIES) {
+        let n = NUM_QUERIES.min(fetches - i);
+        reader.records(&records[..n], &mut data)?;
+        checksum += (0..n).map(|k| data[k * record_size] as f64).sum::<f64>();
+    }
+    print_result("record", "batch", fetches, t0.elapsed(), checksum);
+
+    checksum = 0.0;
+    let t0 = Instant::now();
+    for i in 0..fetches {
+        let record = records[i & (NUM_QUERIES - 1)];
+        for c in 0..num_channels {
+            let (offset, coeffs) = reader
+                .record_channel_data(record, c)
+                .ok_or("record data not available without copying")?;
+            if c == 0 && offset == 0 && !coeffs.is_empty() {
+                checksum += coeffs[0] as f64;
+            }
+        }
+    }
+    print_result("record", "zerocopy", fetches, t0.elapsed(), checksum);
+
+    Ok(())
+}
@@ -1,82 +1,128 @@
-//! Raw FFI bindings to the OpenDAFF C wrapper library.
+//! Raw FFI bindings to the OpenDAFF C interface library (libdaff_c, see bindings/c/daff_c.h).
 //!
 //! This module contains unsafe FFI declarations. Use the safe wrappers in the parent module instead.
 
 use std::os::raw::{c_char, c_double, c_float, c_int};
 
+// Constants of daff_c.h (part of the ABI, checked against the library there)
+pub const DAFFC_IMPULSE_RESPONSE: c_int = 0;
+pub const DAFFC_MAGNITUDE_SPECTRUM: c_int = 1;
+pub const DAFFC_PHASE_SPECTRUM: c_int = 2;
+pub const DAFFC_MAGNITUDE_PHASE_SPECTRUM: c_int = 3;
+pub const DAFFC_DFT_SPECTRUM: c_int = 4;
+
+pub const DAFFC_QUANTIZATION_INT16: c_int = 0;
+pub const DAFFC_QUANTIZATION_INT24: c_int = 1;
+pub const DAFFC_QUANTIZATION_FLOAT32: c_int = 2;
+pub const DAFFC_QUANTIZATION_FLOAT16: c_int = 3;
+pub const DAFFC_QUANTIZATION_BFLOAT16: c_int = 4;
+pub const DAFFC_QUANTIZATION_INT16_BFP: c_int = 5;
+
+pub const DAFFC_DATA_VIEW: c_int = 0;
+pub const DAFFC_OBJECT_VIEW: c_int = 1;
+
+pub const DAFFC_OPEN_DEFAULT: c_int = 0;
+pub const DAFFC_OPEN_MAPPED: c_int = 1;
+pub const DAFFC_OPEN_LAZY: c_int = 2;
+pub const DAFFC_OPEN_DECODE: c_int = 4;
+pub const DAFFC_OPEN_TRUNCATE: c_int = 8;
+pub const DAFFC_OPEN_VERIFY: c_int = 16;
+
 #[repr(C)]
-pub struct RustDAFFReaderHandle {
+pub struct DAFFCReaderHandle {
     _private: [u8; 0],
 }
 
 #[repr(C)]
-pub struct RustDAFFContentHandle {
+pub struct DAFFCContentHandle {
     _private: [u8; 0],
 }
 
+#[repr(C)]
+#[derive(Debug, Default, Clone, Copy)]
+pub struct DAFFCMemoryFootprint {
+    pub headers: u64,
+    pub record_descriptors: u64,
+    pub record_data: u64,
+    pub record_cache: u64,
+    pub metadata: u64,
+    pub statistics: u64,
+    pub total: u64,
+    pub mapped: u64,
+}
+
 extern "C" {
     // Error handling
-    pub fn RustDAFF_GetLastError() -> *const c_char;
+    pub fn DAFFC_GetLastError() -> *const c_char;
 
     // Reader operations
-    pub fn RustDAFF_Create() -> *mut RustDAFFReaderHandle;
-    pub fn RustDAFF_Destroy(handle: *mut RustDAFFReaderHandle);
-    pub fn RustDAFF_OpenFile(handle: *mut RustDAFFReaderHandle, filename: *const c_char) -> bool;
-    pub fn RustDAFF_Close(handle: *mut RustDAFFReaderHandle);
-    pub fn RustDAFF_IsValid(handle: *const RustDAFFReaderHandle) -> bool;
+    pub fn DAFFC_Create() -> *mut DAFFCReaderHandle;
+    pub fn DAFFC_Destroy(handle: *mut DAFFCReaderHandle);
+    pub fn DAFFC_OpenFile(handle: *mut DAFFCReaderHandle, filename: *const c_char) -> bool;
+    pub fn DAFFC_OpenFileWithFlags(
+        handle: *mut DAFFCReaderHandle,
+        filename: *const c_char,
+        flags: c_int,
+    ) -> bool;
+    pub fn DAFFC_Close(handle: *mut DAFFCReaderHandle);
+    pub fn DAFFC_IsValid(handle: *const DAFFCReaderHandle) -> bool;
 
     // File properties
-    pub fn RustDAFF_GetContentType(handle: *const RustDAFFReaderHandle) -> c_int;
-    pub fn RustDAFF_GetQuantization(handle: *const RustDAFFReaderHandle) -> c_int;
-    pub fn RustDAFF_GetNumChannels(handle: *const RustDAFFReaderHandle) -> c_int;
-    pub fn RustDAFF_GetNumRecords(handle: *const RustDAFFReaderHandle) -> c_int;
-    pub fn RustDAFF_GetAlphaResolution(handle: *const RustDAFFReaderHandle) -> c_float;
-    pub fn RustDAFF_GetBetaResolution(handle: *const RustDAFFReaderHandle) -> c_float;
-    pub fn RustDAFF_GetAlphaPoints(handle: *const RustDAFFReaderHandle) -> c_int;
-    pub fn RustDAFF_GetBetaPoints(handle: *const RustDAFFReaderHandle) -> c_int;
-    pub fn RustDAFF_GetOrientationYPR(
-        handle: *const RustDAFFReaderHandle,
+    pub fn DAFFC_GetContentType(handle: *const DAFFCReaderHandle) -> c_int;
+    pub fn DAFFC_GetQuantization(handle: *const DAFFCReaderHandle) -> c_int;
+    pub fn DAFFC_GetNumChannels(handle: *const DAFFCReaderHandle) -> c_int;
+    pub fn DAFFC_GetNumRecords(handle: *const DAFFCReaderHandle) -> c_int;
+    pub fn DAFFC_GetAlphaResolution(handle: *const DAFFCReaderHandle) -> c_float;
+    pub fn DAFFC_GetBetaResolution(handle: *const DAFFCReaderHandle) -> c_float;
+    pub fn DAFFC_GetAlphaPoints(handle: *const DAFFCReaderHandle) -> c_int;
+    pub fn DAFFC_GetBetaPoints(handle: *const DAFFCReaderHandle) -> c_int;
+    pub fn DAFFC_GetOrientationYPR(
+        handle: *const DAFFCReaderHandle,
         yaw: *mut c_float,
         pitch: *mut c_float,
         roll: *mut c_float,
     ) -> c_int;
+    pub fn DAFFC_GetMemoryFootprint(
+        handle: *const DAFFCReaderHandle,
+        footprint: *mut DAFFCMemoryFootprint,
+    ) -> c_int;
 
     // Metadata operations
-    pub fn RustDAFF_HasMetadata(handle: *const RustDAFFReaderHandle, key: *const c_char) -> bool;
-    pub fn RustDAFF_GetMetadataString(
-        handle: *const RustDAFFReaderHandle,
+    pub fn DAFFC_HasMetadata(handle: *const DAFFCReaderHandle, key: *const c_char) -> bool;
+    pub fn DAFFC_GetMetadataString(
+        handle: *const DAFFCReaderHandle,
         key: *const c_char,
     ) -> *const c_char;
-    pub fn RustDAFF_GetMetadataFloat(
-        handle: *const RustDAFFReaderHandle,
+    pub fn DAFFC_GetMetadataFloat(
+        handle: *const DAFFCReaderHandle,
         key: *const c_char,
         value: *mut c_float,
     ) -> bool;
-    pub fn RustDAFF_GetMetadataBool(
-        handle: *const RustDAFFReaderHandle,
+    pub fn DAFFC_GetMetadataBool(
+        handle: *const DAFFCReaderHandle,
         key: *const c_char,
         value: *mut bool,
     ) -> bool;
 
     // Content access - Impulse Response (IR)
-    pub fn RustDAFF_GetContentIR(
-        handle: *const RustDAFFReaderHandle,
-    ) -> *mut RustDAFFContentHandle;
-    pub fn RustDAFF_ContentIR_GetFilterLength(content: *const RustDAFFContentHandle) -> c_int;
-    pub fn RustDAFF_ContentIR_GetSamplerate(content: *const RustDAFFContentHandle) -> c_int;
-    pub fn RustDAFF_ContentIR_GetNearestNeighbour(
-        content: *const RustDAFFContentHandle,
+    pub fn DAFFC_GetContentIR(
+        handle: *const DAFFCReaderHandle,
+    ) -> *mut DAFFCContentHandle;
+    pub fn DAFFC_ContentIR_GetFilterLength(content: *const DAFFCContentHandle) -> c_int;
+    pub fn DAFFC_ContentIR_GetSamplerate(content: *const DAFFCContentHandle) -> c_int;
+    pub fn DAFFC_ContentIR_GetNearestNeighbour(
+        content: *const DAFFCContentHandle,
         phi: c_double,
         theta: c_double,
     ) -> c_int;
-    pub fn RustDAFF_ContentIR_GetRecordCoords(
-        content: *const RustDAFFContentHandle,
+    pub fn DAFFC_ContentIR_GetRecordCoords(
+        content: *const DAFFCContentHandle,
         record_index: c_int,
         alpha: *mut c_double,
         beta: *mut c_double,
     ) -> bool;
-    pub fn RustDAFF_ContentIR_GetFilterCoeffs(
-        content: *const RustDAFFContentHandle,
+    pub fn DAFFC_ContentIR_GetFilterCoeffs(
+        content: *const DAFFCContentHandle,
         record_index: c_int,
         channel: c_int,
         coeffs: *mut c_float,
@@ -84,23 +130,23 @@ extern "C" {
     ) -> bool;
 
     // Content access - Magnitude Spectrum (MS)
-    pub fn RustDAFF_GetContentMS(
-        handle: *const RustDAFFReaderHandle,
-    ) -> *mut RustDAFFContentHandle;
-    pub fn RustDAFF_ContentMS_GetNumFrequencies(content: *const RustDAFFContentHandle) -> c_int;
-    pub fn RustDAFF_ContentMS_GetNearestNeighbour(
-        content: *const RustDAFFContentHandle,
+    pub fn DAFFC_GetContentMS(
+        handle: *const DAFFCReaderHandle,
+    ) -> *mut DAFFCContentHandle;
+    pub fn DAFFC_ContentMS_GetNumFrequencies(content: *const DAFFCContentHandle) -> c_int;
+    pub fn DAFFC_ContentMS_GetNearestNeighbour(
+        content: *const DAFFCContentHandle,
         phi: c_double,
         theta: c_double,
     ) -> c_int;
-    pub fn RustDAFF_ContentMS_GetRecordCoords(
-        content: *const RustDAFFContentHandle,
+    pub fn DAFFC_ContentMS_GetRecordCoords(
+        content: *const DAFFCContentHandle,
         record_index: c_int,
         alpha: *mut c_double,
         beta: *mut c_double,
     ) -> bool;
-    pub fn RustDAFF_ContentMS_GetMagnitudes(
-        content: *const RustDAFFContentHandle,
+    pub fn DAFFC_ContentMS_GetMagnitudes(
+        content: *const DAFFCContentHandle,
         record_index: c_int,
         channel: c_int,
         magnitudes: *mut c_float,
@@ -108,23 +154,23 @@ extern "C" {
     ) -> bool;
 
     // Content access - Phase Spectrum (PS)
-    pub fn RustDAFF_GetContentPS(
-        handle: *const RustDAFFReaderHandle,
-    ) -> *mut RustDAFFContentHandle;
-    pub fn RustDAFF_ContentPS_GetNumFrequencies(content: *const RustDAFFContentHandle) -> c_int;
-    pub fn RustDAFF_ContentPS_GetNearestNeighbour(
-        content: *const RustDAFFContentHandle,
+    pub fn DAFFC_GetContentPS(
+        handle: *const DAFFCReaderHandle,
+    ) -> *mut DAFFCContentHandle;
+    pub fn DAFFC_ContentPS_GetNumFrequencies(content: *const DAFFCContentHandle) -> c_int;
+    pub fn DAFFC_ContentPS_GetNearestNeighbour(
+        content: *const DAFFCContentHandle,
         phi: c_double,
         theta: c_double,
     ) -> c_int;
-    pub fn RustDAFF_ContentPS_GetRecordCoords(
-        content: *const RustDAFFContentHandle,
+    pub fn DAFFC_ContentPS_GetRecordCoords(
+        content: *const DAFFCContentHandle,
         record_index: c_int,
         alpha: *mut c_double,
         beta: *mut c_double,
     ) -> bool;
-    pub fn RustDAFF_ContentPS_GetPhases(
-        content: *const RustDAFFContentHandle,
+    pub fn DAFFC_ContentPS_GetPhases(
+        content: *const DAFFCContentHandle,
         record_index: c_int,
         channel: c_int,
         phases: *mut c_float,
@@ -132,23 +178,23 @@ extern "C" {
     ) -> bool;
 
     // Content access - Magnitude-Phase Spectrum (MPS)
-    pub fn RustDAFF_GetContentMPS(
-        handle: *const RustDAFFReaderHandle,
-    ) -> *mut RustDAFFContentHandle;
-    pub fn RustDAFF_ContentMPS_GetNumFrequencies(content: *const RustDAFFContentHandle) -> c_int;
-    pub fn RustDAFF_ContentMPS_GetNearestNeighbour(
-        content: *const RustDAFFContentHandle,
+    pub fn DAFFC_GetContentMPS(
+        handle: *const DAFFCReaderHandle,
+    ) -> *mut DAFFCContentHandle;
+    pub fn DAFFC_ContentMPS_GetNumFrequencies(content: *const DAFFCContentHandle) -> c_int;
+    pub fn DAFFC_ContentMPS_GetNearestNeighbour(
+        content: *const DAFFCContentHandle,
         phi: c_double,
         theta: c_double,
     ) -> c_int;
-    pub fn RustDAFF_ContentMPS_GetRecordCoords(
-        content: *const RustDAFFContentHandle,
+    pub fn DAFFC_ContentMPS_GetRecordCoords(
+        content: *const DAFFCContentHandle,
         record_index: c_int,
         alpha: *mut c_double,
         beta: *mut c_double,
     ) -> bool;
-    pub fn RustDAFF_ContentMPS_GetCoefficients(
-        content: *const RustDAFFContentHandle,
+    pub fn DAFFC_ContentMPS_GetCoefficients(
+        content: *const DAFFCContentHandle,
         record_index: c_int,
         channel: c_int,
         magnitudes: *mut c_float,
@@ -157,27 +203,81 @@ extern "C" {
     ) -> bool;
 
     // Content access - DFT
-    pub fn RustDAFF_GetContentDFT(
-        handle: *const RustDAFFReaderHandle,
-    ) -> *mut RustDAFFContentHandle;
-    pub fn RustDAFF_ContentDFT_GetNumDFTCoeffs(content: *const RustDAFFContentHandle) -> c_int;
-    pub fn RustDAFF_ContentDFT_IsSymmetric(content: *const RustDAFFContentHandle) -> bool;
-    pub fn RustDAFF_ContentDFT_GetNearestNeighbour(
-        content: *const RustDAFFContentHandle,
+    pub fn DAFFC_GetContentDFT(
+        handle: *const DAFFCReaderHandle,
+    ) -> *mut DAFFCContentHandle;
+    pub fn DAFFC_ContentDFT_GetNumDFTCoeffs(content: *const DAFFCContentHandle) -> c_int;
+    pub fn DAFFC_ContentDFT_IsSymmetric(content: *const DAFFCContentHandle) -> bool;
+    pub fn DAFFC_ContentDFT_GetNearestNeighbour(
+        content: *const DAFFCContentHandle,
         phi: c_double,
         theta: c_double,
     ) -> c_int;
-    pub fn RustDAFF_ContentDFT_GetRecordCoords(
-        content: *const RustDAFFContentHandle,
+    pub fn DAFFC_ContentDFT_GetRecordCoords(
+        content: *const DAFFCContentHandle,
         record_index: c_int,
         alpha: *mut c_double,
         beta: *mut c_double,
     ) -> bool;
-    pub fn RustDAFF_ContentDFT_GetDFTCoeffs(
-        content: *const RustDAFFContentHandle,
+    pub fn DAFFC_ContentDFT_GetDFTCoeffs(
+        content: *const DAFFCContentHandle,
         record_index: c_int,
         channel: c_int,
         coeffs: *mut c_float,
         buffer_size: c_int,
     ) -> bool;
+
+    // Batch access - all content types
+    pub fn DAFFC_GetRecordLength(handle: *const DAFFCReaderHandle) -> c_int;
+    pub fn DAFFC_GetNearestNeighbours(
+        handle: *const DAFFCReaderHandle,
+        view: c_int,
+        angles1: *const c_float,
+        angles2: *const c_float,
+        record_indices: *mut c_int,
+        out_of_bounds: *mut bool,
+        count: usize,
+    ) -> bool;
+    pub fn DAFFC_GetRecords(
+        handle: *const DAFFCReaderHandle,
+        record_indices: *const c_int,
+        count: usize,
+        dest: *mut c_float,
+        buffer_size: usize,
+    ) -> bool;
+    pub fn DAFFC_GetRecordRange(
+        handle: *const DAFFCReaderHandle,
+        first_record: c_int,
+        count: usize,
+        dest: *mut c_float,
+        buffer_size: usize,
+    ) -> bool;
+    pub fn DAFFC_GetNearestNeighbourRecords(
+        handle: *const DAFFCReaderHandle,
+        view: c_int,
+        angles1: *const c_float,
+        angles2: *const c_float,
+        count: usize,
+        record_indices: *mut c_int,
+        dest: *mut c_float,
+        buffer_size: usize,
+    ) -> bool;
+    pub fn DAFFC_GetInterpolatedRecords(
+        handle: *const DAFFCReaderHandle,
+        view: c_int,
+        angles1: *const c_float,
+        angles2: *const c_float,
+        count: usize,
+        dest: *mut c_float,
+        buffer_size: usize,
+    ) -> bool;
+
+    // Zero-copy access
+    pub fn DAFFC_GetRecordChannelPtr(
+        handle: *const DAFFCReaderHandle,
+        record_index: c_int,
+        channel: c_int,
+        offset: *mut c_int,
+        num_values: *mut c_int,
+    ) -> *const c_float;
 }
@@ -73,7 +73,7 @@ impl Error {
 
     fn from_last_error() -> Self {
         unsafe {
-            let c_str = ffi::RustDAFF_GetLastError();
+            let c_str = ffi::DAFFC_GetLastError();
             if c_str.is_null() {
                 Self::new("Unknown error")
             } else {
@@ -99,25 +99,25 @@ impl StdError for Error {}
 #[repr(i32)]
 pub enum ContentType {
     /// Impulse response
-    ImpulseResponse = 1,
+    ImpulseResponse = ffi::DAFFC_IMPULSE_RESPONSE,
     /// Magnitude spectrum
-    MagnitudeSpectrum = 2,
+    MagnitudeSpectrum = ffi::DAFFC_MAGNITUDE_SPECTRUM,
     /// Phase spectrum
-    PhaseSpectrum = 3,
+    PhaseSpectrum = ffi::DAFFC_PHASE_SPECTRUM,
     /// Magnitude-phase spectrum
-    MagnitudePhaseSpectrum = 4,
+    MagnitudePhaseSpectrum = ffi::DAFFC_MAGNITUDE_PHASE_SPECTRUM,
     /// DFT coefficients
-    DftSpectrum = 5,
+    DftSpectrum = ffi::DAFFC_DFT_SPECTRUM,
 }
 
 impl ContentType {
     fn from_i32(value: i32) -> Option<Self> {
         match value {
-            1 => Some(ContentType::ImpulseResponse),
-            2 => Some(ContentType::MagnitudeSpectrum),
-            3 => Some(ContentType::PhaseSpectrum),
-            4 => Some(ContentType::MagnitudePhaseSpectrum),
-            5 => Some(ContentType::DftSpectrum),
+            ffi::DAFFC_IMPULSE_RESPONSE => Some(ContentType::ImpulseResponse),
+            ffi::DAFFC_MAGNITUDE_SPECTRUM => Some(ContentType::MagnitudeSpectrum),
+            ffi::DAFFC_PHASE_SPECTRUM => Some(ContentType::PhaseSpectrum),
+            ffi::DAFFC_MAGNITUDE_PHASE_SPECTRUM => Some(ContentType::MagnitudePhaseSpectrum),
+            ffi::DAFFC_DFT_SPECTRUM => Some(ContentType::DftSpectrum),
             _ => None,
         }
     }
@@ -135,33 +135,70 @@ impl fmt::Display for ContentType {
     }
 }
 
+/// Coordinate system of the angles passed to the batch queries
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[repr(i32)]
+pub enum View {
+    /// Data view (alpha, beta)
+    Data = ffi::DAFFC_DATA_VIEW,
+    /// Object view (phi, theta)
+    Object = ffi::DAFFC_OBJECT_VIEW,
+}
+
+/// Options for opening a DAFF file (combinable with `|`)
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub struct OpenFlags(i32);
+
+impl OpenFlags {
+    /// Load the whole file into memory
+    pub const DEFAULT: OpenFlags = OpenFlags(ffi::DAFFC_OPEN_DEFAULT);
+    /// Map the file into memory instead of reading it
+    pub const MAPPED: OpenFlags = OpenFlags(ffi::DAFFC_OPEN_MAPPED);
+    /// Load the record data on demand
+    pub const LAZY: OpenFlags = OpenFlags(ffi::DAFFC_OPEN_LAZY);
+    /// Decode integer record data to floats when opening
+    pub const DECODE: OpenFlags = OpenFlags(ffi::DAFFC_OPEN_DECODE);
+    /// Trim impulse response tails below the truncation threshold when opening
+    pub const TRUNCATE: OpenFlags = OpenFlags(ffi::DAFFC_OPEN_TRUNCATE);
+    /// Verify the block checksums when opening
+    pub const VERIFY: OpenFlags = OpenFlags(ffi::DAFFC_OPEN_VERIFY);
+}
+
+impl std::ops::BitOr for OpenFlags {
+    type Output = OpenFlags;
+
+    fn bitor(self, rhs: OpenFlags) -> OpenFlags {
+        OpenFlags(self.0 | rhs.0)
+    }
+}
+
 /// Quantization type for DAFF data
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
 #[repr(i32)]
 pub enum Quantization {
-    /// 8-bit integer
-    Int8 = 1,
     /// 16-bit integer
-    Int16 = 2,
+    Int16 = ffi::DAFFC_QUANTIZATION_INT16,
     /// 24-bit integer
-    Int24 = 3,
-    /// 32-bit integer
-    Int32 = 4,
+    Int24 = ffi::DAFFC_QUANTIZATION_INT24,
     /// 32-bit float
-    Float32 = 5,
-    /// 64-bit float
-    Float64 = 6,
+    Float32 = ffi::DAFFC_QUANTIZATION_FLOAT32,
+    /// 16-bit float (IEEE 754 half precision)
+    Float16 = ffi::DAFFC_QUANTIZATION_FLOAT16,
+    /// 16-bit float (bfloat16, upper half of a 32-bit float)
+    BFloat16 = ffi::DAFFC_QUANTIZATION_BFLOAT16,
+    /// 16-bit integer with a scale per record channel (block floating point, IR only)
+    Int16Bfp = ffi::DAFFC_QUANTIZATION_INT16_BFP,
 }
 
 impl Quantization {
     fn from_i32(value: i32) -> Option<Self> {
         match value {
-            1 => Some(Quantization::Int8),
-            2 => Some(Quantization::Int16),
-            3 => Some(Quantization::Int24),
-            4 => Some(Quantization::Int32),
-            5 => Some(Quantization::Float32),
-            6 => Some(Quantization::Float64),
+            ffi::DAFFC_QUANTIZATION_INT16 => Some(Quantization::Int16),
+            ffi::DAFFC_QUANTIZATION_INT24 => Some(Quantization::Int24),
+            ffi::DAFFC_QUANTIZATION_FLOAT32 => Some(Quantization::Float32),
+            ffi::DAFFC_QUANTIZATION_FLOAT16 => Some(Quantization::Float16),
+            ffi::DAFFC_QUANTIZATION_BFLOAT16 => Some(Quantization::BFloat16),
+            ffi::DAFFC_QUANTIZATION_INT16_BFP => Some(Quantization::Int16Bfp),
             _ => None,
         }
     }
@@ -178,16 +215,37 @@ pub struct Orientation {
     pub roll: f32,
 }
 
+/// Heap memory held by a reader, broken down by category (bytes)
+#[derive(Debug, Default, Clone, Copy)]
+pub struct MemoryFootprint {
+    /// File block table, main and content header, frequency list
+    pub headers: u64,
+    /// Record descriptors, payload indices, record directions and their index
+    pub record_descriptors: u64,
+    /// Record data block and the decoded float arena
+    pub record_data: u64,
+    /// Record cache and chunk buffer of the lazy loading
+    pub record_cache: u64,
+    /// Metadata block and sets
+    pub metadata: u64,
+    /// Record statistics and peak values
+    pub statistics: u64,
+    /// Sum of the categories above
+    pub total: u64,
+    /// Accessed in place, not owned (mapped or borrowed)
+    pub mapped: u64,
+}
+
 /// Main DAFF reader interface
 pub struct Reader {
-    handle: *mut ffi::RustDAFFReaderHandle,
+    handle: *mut ffi::DAFFCReaderHandle,
 }
 
 impl Reader {
     /// Create a new DAFF reader
     pub fn new() -> Result<Self> {
         unsafe {
-            let handle = ffi::RustDAFF_Create();
+            let handle = ffi::DAFFC_Create();
             if handle.is_null() {
                 Err(Error::from_last_error())
             } else {
@@ -202,7 +260,21 @@ impl Reader {
             .map_err(|_| Error::new("Invalid filename"))?;
 
         unsafe {
-            if ffi::RustDAFF_OpenFile(self.handle, c_filename.as_ptr()) {
+            if ffi::DAFFC_OpenFile(self.handle, c_filename.as_ptr()) {
+                Ok(())
+            } else {
+                Err(Error::from_last_error())
+            }
+        }
+    }
+
+    /// Open a DAFF file with the given options
+    pub fn open_file_with_flags(&mut self, filename: &str, flags: OpenFlags) -> Result<()> {
+        let c_filename = CString::new(filename)
+            .map_err(|_| Error::new("Invalid filename"))?;
+
+        unsafe {
+            if ffi::DAFFC_OpenFileWithFlags(self.handle, c_filename.as_ptr(), flags.0) {
                 Ok(())
             } else {
                 Err(Error::from_last_error())
@@ -213,21 +285,21 @@ impl Reader {
     /// Close the currently open file
     pub fn close(&mut self) {
         unsafe {
-            ffi::RustDAFF_Close(self.handle);
+            ffi::DAFFC_Close(self.handle);
         }
     }
 
     /// Check if a file is currently open and valid
     pub fn is_valid(&self) -> bool {
         unsafe {
-            ffi::RustDAFF_IsValid(self.handle)
+            ffi::DAFFC_IsValid(self.handle)
         }
     }
 
     /// Get the content type of the open file
     pub fn content_type(&self) -> ContentType {
         unsafe {
-            let ct = ffi::RustDAFF_GetContentType(self.handle);
+            let ct = ffi::DAFFC_GetContentType(self.handle);
             ContentType::from_i32(ct).unwrap_or(ContentType::ImpulseResponse)
         }
     }
@@ -235,7 +307,7 @@ impl Reader {
     /// Get the quantization type
     pub fn quantization(&self) -> Option<Quantization> {
         unsafe {
-            let q = ffi::RustDAFF_GetQuantization(self.handle);
+            let q = ffi::DAFFC_GetQuantization(self.handle);
             Quantization::from_i32(q)
         }
     }
@@ -243,42 +315,42 @@ impl Reader {
     /// Get the number of channels
     pub fn num_channels(&self) -> i32 {
         unsafe {
-            ffi::RustDAFF_GetNumChannels(self.handle)
+            ffi::DAFFC_GetNumChannels(self.handle)
         }
     }
 
     /// Get the number of records
     pub fn num_records(&self) -> i32 {
         unsafe {
-            ffi::RustDAFF_GetNumRecords(self.handle)
+            ffi::DAFFC_GetNumRecords(self.handle)
         }
     }
 
     /// Get alpha resolution (azimuth)
     pub fn alpha_resolution(&self) -> f32 {
         unsafe {
-            ffi::RustDAFF_GetAlphaResolution(self.handle)
+            ffi::DAFFC_GetAlphaResolution(self.handle)
         }
     }
 
     /// Get beta resolution (elevation)
     pub fn beta_resolution(&self) -> f32 {
         unsafe {
-            ffi::RustDAFF_GetBetaResolution(self.handle)
+            ffi::DAFFC_GetBetaResolution(self.handle)
         }
     }
 
     /// Get number of alpha points
     pub fn alpha_points(&self) -> i32 {
         unsafe {
-            ffi::RustDAFF_GetAlphaPoints(self.handle)
+            ffi::DAFFC_GetAlphaPoints(self.handle)
         }
     }
 
     /// Get number of beta points
     pub fn beta_points(&self) -> i32 {
         unsafe {
-            ffi::RustDAFF_GetBetaPoints(self.handle)
+            ffi::DAFFC_GetBetaPoints(self.handle)
         }
     }
 
@@ -289,7 +361,7 @@ impl Reader {
         let mut roll = 0.0f32;
 
         unsafe {
-            if ffi::RustDAFF_GetOrientationYPR(self.handle, &mut yaw, &mut pitch, &mut roll) == 0 {
+            if ffi::DAFFC_GetOrientationYPR(self.handle, &mut yaw, &mut pitch, &mut roll) == 0 {
                 Ok(Orientation { yaw, pitch, roll })
             } else {
                 Err(Error::new("Failed to get orientation"))
@@ -297,6 +369,209 @@ impl Reader {
         }
     }
 
+    /// Get the heap memory held by the reader
+    pub fn memory_footprint(&self) -> Result<MemoryFootprint> {
+        let mut f = ffi::DAFFCMemoryFootprint::default();
+
+        unsafe {
+            if ffi::DAFFC_GetMemoryFootprint(self.handle, &mut f) == 0 {
+                Ok(MemoryFootprint {
+                    headers: f.headers,
+                    record_descriptors: f.record_descriptors,
+                    record_data: f.record_data,
+                    record_cache: f.record_cache,
+                    metadata: f.metadata,
+                    statistics: f.statistics,
+                    total: f.total,
+                    mapped: f.mapped,
+                })
+            } else {
+                Err(Error::new("Failed to get memory footprint"))
+            }
+        }
+    }
+
+    /// Get the number of float values per channel of a record
+    ///
+    /// Filter length, number of frequencies or twice that number for
+    /// interleaved magnitude-phase pairs and complex DFT coefficients.
+    pub fn record_length(&self) -> i32 {
+        unsafe {
+            ffi::DAFFC_GetRecordLength(self.handle)
+        }
+    }
+
+    /// Get the nearest neighbour records of several directions (degrees)
+    ///
+    /// `out_of_bounds` is optional, all slices must have the same length.
+    pub fn nearest_neighbours(
+        &self,
+        view: View,
+        angles1: &[f32],
+        angles2: &[f32],
+        record_indices: &mut [i32],
+        out_of_bounds: Option<&mut [bool]>,
+    ) -> Result<()> {
+        let count = angles1.len();
+        let out_of_bounds = match out_of_bounds {
+            Some(o) if o.len() != count => return Err(Error::new("Slice lengths differ")),
+            Some(o) => o.as_mut_ptr(),
+            None => std::ptr::null_mut(),
+        };
+        if angles2.len() != count || record_indices.len() != count {
+            return Err(Error::new("Slice lengths differ"));
+        }
+
+        unsafe {
+            if ffi::DAFFC_GetNearestNeighbours(
+                self.handle,
+                view as i32,
+                angles1.as_ptr(),
+                angles2.as_ptr(),
+                record_indices.as_mut_ptr(),
+                out_of_bounds,
+                count,
+            ) {
+                Ok(())
+            } else {
+                Err(Error::from_last_error())
+            }
+        }
+    }
+
+    /// Copy the data of several records into one buffer
+    ///
+    /// The records are written as `[records][channels][record_length()]`,
+    /// `dest` must hold at least that many values.
+    pub fn records(&self, record_indices: &[i32], dest: &mut [f32]) -> Result<()> {
+        unsafe {
+            if ffi::DAFFC_GetRecords(
+                self.handle,
+                record_indices.as_ptr(),
+                record_indices.len(),
+                dest.as_mut_ptr(),
+                dest.len(),
+            ) {
+                Ok(())
+            } else {
+                Err(Error::from_last_error())
+            }
+        }
+    }
+
+    /// Copy the consecutive records `first_record..first_record + count` into one buffer
+    ///
+    /// Same layout as [`Reader::records`], for processing a whole file chunk by chunk.
+    pub fn record_range(&self, first_record: i32, count: usize, dest: &mut [f32]) -> Result<()> {
+        unsafe {
+            if ffi::DAFFC_GetRecordRange(self.handle, first_record, count, dest.as_mut_ptr(), dest.len()) {
+                Ok(())
+            } else {
+                Err(Error::from_last_error())
+            }
+        }
+    }
+
+    /// Copy the nearest neighbour records of several directions (degrees) into one buffer
+    ///
+    /// Same layout as [`Reader::records`]. The record indices are stored in
+    /// `record_indices` if given.
+    pub fn nearest_neighbour_records(
+        &self,
+        view: View,
+        angles1: &[f32],
+        angles2: &[f32],
+        record_indices: Option<&mut [i32]>,
+        dest: &mut [f32],
+    ) -> Result<()> {
+        let count = angles1.len();
+        let record_indices = match record_indices {
+            Some(r) if r.len() != count => return Err(Error::new("Slice lengths differ")),
+            Some(r) => r.as_mut_ptr(),
+            None => std::ptr::null_mut(),
+        };
+        if angles2.len() != count {
+            return Err(Error::new("Slice lengths differ"));
+        }
+
+        unsafe {
+            if ffi::DAFFC_GetNearestNeighbourRecords(
+                self.handle,
+                view as i32,
+                angles1.as_ptr(),
+                angles2.as_ptr(),
+                count,
+                record_indices,
+                dest.as_mut_ptr(),
+                dest.len(),
+            ) {
+                Ok(())
+            } else {
+                Err(Error::from_last_error())
+            }
+        }
+    }
+
+    /// Interpolate the records of several directions (degrees) into one buffer
+    ///
+    /// Same layout as [`Reader::records`]. Only impulse responses, magnitude
+    /// spectra and DFT spectra can be interpolated.
+    pub fn interpolated_records(
+        &self,
+        view: View,
+        angles1: &[f32],
+        angles2: &[f32],
+        dest: &mut [f32],
+    ) -> Result<()> {
+        if angles2.len() != angles1.len() {
+            return Err(Error::new("Slice lengths differ"));
+        }
+
+        unsafe {
+            if ffi::DAFFC_GetInterpolatedRecords(
+                self.handle,
+                view as i32,
+                angles1.as_ptr(),
+                angles2.as_ptr(),
+                angles1.len(),
+                dest.as_mut_ptr(),
+                dest.len(),
+            ) {
+                Ok(())
+            } else {
+                Err(Error::from_last_error())
+            }
+        }
+    }
+
+    /// Borrow the data of a record channel without copying
+    ///
+    /// Returns the offset of the first value within the record and the
+    /// values (the effective filter coefficients of impulse responses).
+    /// `None` if the data is not available in place: lazily opened files,
+    /// magnitude-phase spectra and integer data not opened with
+    /// [`OpenFlags::DECODE`].
+    pub fn record_channel_data(&self, record_index: i32, channel: i32) -> Option<(i32, &[f32])> {
+        let mut offset = 0;
+        let mut num_values = 0;
+
+        unsafe {
+            let data = ffi::DAFFC_GetRecordChannelPtr(
+                self.handle,
+                record_index,
+                channel,
+                &mut offset,
+                &mut num_values,
+            );
+            if data.is_null() {
+                None
+            } else {
+                let len = num_values.max(0) as usize;
+                Some((offset, std::slice::from_raw_parts(data, len)))
+            }
+        }
+    }
+
     /// Check if metadata key exists
     pub fn has_metadata(&self, key: &str) -> bool {
         let Ok(c_key) = CString::new(key) else {
@@ -304,7 +579,7 @@ impl Reader {
         };
 
         unsafe {
-            ffi::RustDAFF_HasMetadata(self.handle, c_key.as_ptr())
+            ffi::DAFFC_HasMetadata(self.handle, c_key.as_ptr())
         }
     }
 
@@ -314,7 +589,7 @@ impl Reader {
             .map_err(|_| Error::new("Invalid key"))?;
 
         unsafe {
-            let c_str = ffi::RustDAFF_GetMetadataString(self.handle, c_key.as_ptr());
+            let c_str = ffi::DAFFC_GetMetadataString(self.handle, c_key.as_ptr());
             if c_str.is_null() {
                 Err(Error::new(format!("Metadata key '{}' not found", key)))
             } else {
@@ -332,7 +607,7 @@ impl Reader {
         let mut value = 0.0f32;
 
         unsafe {
-            if ffi::RustDAFF_GetMetadataFloat(self.handle, c_key.as_ptr(), &mut value) {
+            if ffi::DAFFC_GetMetadataFloat(self.handle, c_key.as_ptr(), &mut value) {
                 Ok(value)
             } else {
                 Err(Error::new(format!("Metadata key '{}' not found", key)))
@@ -347,7 +622,7 @@ impl Reader {
         let mut value = false;
 
         unsafe {
-            if ffi::RustDAFF_GetMetadataBool(self.handle, c_key.as_ptr(), &mut value) {
+            if ffi::DAFFC_GetMetadataBool(self.handle, c_key.as_ptr(), &mut value) {
                 Ok(value)
             } else {
                 Err(Error::new(format!("Metadata key '{}' not found", key)))
@@ -358,7 +633,7 @@ impl Reader {
     /// Get impulse response content
     pub fn content_ir(&self) -> Result<ContentIR<'_>> {
         unsafe {
-            let content = ffi::RustDAFF_GetContentIR(self.handle);
+            let content = ffi::DAFFC_GetContentIR(self.handle);
             if content.is_null() {
                 Err(Error::new("Not an IR content type"))
             } else {
@@ -373,7 +648,7 @@ impl Reader {
     /// Get magnitude spectrum content
     pub fn content_ms(&self) -> Result<ContentMS<'_>> {
         unsafe {
-            let content = ffi::RustDAFF_GetContentMS(self.handle);
+            let content = ffi::DAFFC_GetContentMS(self.handle);
             if content.is_null() {
                 Err(Error::new("Not an MS content type"))
             } else {
@@ -388,7 +663,7 @@ impl Reader {
     /// Get phase spectrum content
     pub fn content_ps(&self) -> Result<ContentPS<'_>> {
         unsafe {
-            let content = ffi::RustDAFF_GetContentPS(self.handle);
+            let content = ffi::DAFFC_GetContentPS(self.handle);
             if content.is_null() {
                 Err(Error::new("Not a PS content type"))
             } else {
@@ -403,7 +678,7 @@ impl Reader {
     /// Get magnitude-phase spectrum content
     pub fn content_mps(&self) -> Result<ContentMPS<'_>> {
         unsafe {
-            let content = ffi::RustDAFF_GetContentMPS(self.handle);
+            let content = ffi::DAFFC_GetContentMPS(self.handle);
             if content.is_null() {
                 Err(Error::new("Not an MPS content type"))
             } else {
@@ -418,7 +693,7 @@ impl Reader {
     /// Get DFT content
     pub fn content_dft(&self) -> Result<ContentDFT<'_>> {
         unsafe {
-            let content = ffi::RustDAFF_GetContentDFT(self.handle);
+            let content = ffi::DAFFC_GetContentDFT(self.handle);
             if content.is_null() {
                 Err(Error::new("Not a DFT content type"))
             } else {
@@ -434,7 +709,7 @@ impl Reader {
 impl Drop for Reader {
     fn drop(&mut self) {
         unsafe {
-            ffi::RustDAFF_Destroy(self.handle);
+            ffi::DAFFC_Destroy(self.handle);
         }
     }
 }
@@ -444,19 +719,19 @@ unsafe impl Sync for Reader {}
 
 /// Impulse Response content
 pub struct ContentIR<'a> {
-    handle: *mut ffi::RustDAFFContentHandle,
+    handle: *mut ffi::DAFFCContentHandle,
     _phantom: PhantomData<&'a ()>,
 }
 
 impl<'a> ContentIR<'a> {
     /// Get the filter length (number of samples)
     pub fn filter_length(&self) -> i32 {
-        unsafe { ffi::RustDAFF_ContentIR_GetFilterLength(self.handle) }
+        unsafe { ffi::DAFFC_ContentIR_GetFilterLength(self.handle) }
     }
 
     /// Get the sample rate in Hz
     pub fn samplerate(&self) -> i32 {
-        unsafe { ffi::RustDAFF_ContentIR_GetSamplerate(self.handle) }
+        unsafe { ffi::DAFFC_ContentIR_GetSamplerate(self.handle) }
     }
 
     /// Find the nearest neighbour record for given angles
@@ -465,7 +740,7 @@ impl<'a> ContentIR<'a> {
     /// * `phi` - Azimuth angle in radians [0, 2π)
     /// * `theta` - Elevation angle in radians [-π/2, π/2]
     pub fn nearest_neighbour(&self, phi: f64, theta: f64) -> i32 {
-        unsafe { ffi::RustDAFF_ContentIR_GetNearestNeighbour(self.handle, phi, theta) }
+        unsafe { ffi::DAFFC_ContentIR_GetNearestNeighbour(self.handle, phi, theta) }
     }
 
     /// Get record coordinates
@@ -476,7 +751,7 @@ impl<'a> ContentIR<'a> {
         let mut beta = 0.0;
 
         unsafe {
-            if ffi::RustDAFF_ContentIR_GetRecordCoords(
+            if ffi::DAFFC_ContentIR_GetRecordCoords(
                 self.handle,
                 record_index,
                 &mut alpha,
@@ -495,7 +770,7 @@ impl<'a> ContentIR<'a> {
         let mut coeffs = vec![0.0f32; length];
 
         unsafe {
-            if ffi::RustDAFF_ContentIR_GetFilterCoeffs(
+            if ffi::DAFFC_ContentIR_GetFilterCoeffs(
                 self.handle,
                 record_index,
                 channel,
@@ -512,19 +787,19 @@ impl<'a> ContentIR<'a> {
 
 /// Magnitude Spectrum content
 pub struct ContentMS<'a> {
-    handle: *mut ffi::RustDAFFContentHandle,
+    handle: *mut ffi::DAFFCContentHandle,
     _phantom: PhantomData<&'a ()>,
 }
 
 impl<'a> ContentMS<'a> {
     /// Get the number of frequencies
     pub fn num_frequencies(&self) -> i32 {
-        unsafe { ffi::RustDAFF_ContentMS_GetNumFrequencies(self.handle) }
+        unsafe { ffi::DAFFC_ContentMS_GetNumFrequencies(self.handle) }
     }
 
     /// Find the nearest neighbour record for given angles
     pub fn nearest_neighbour(&self, phi: f64, theta: f64) -> i32 {
-        unsafe { ffi::RustDAFF_ContentMS_GetNearestNeighbour(self.handle, phi, theta) }
+        unsafe { ffi::DAFFC_ContentMS_GetNearestNeighbour(self.handle, phi, theta) }
     }
 
     /// Get record coordinates
@@ -533,7 +808,7 @@ impl<'a> ContentMS<'a> {
         let mut beta = 0.0;
 
         unsafe {
-            if ffi::RustDAFF_ContentMS_GetRecordCoords(
+            if ffi::DAFFC_ContentMS_GetRecordCoords(
                 self.handle,
                 record_index,
                 &mut alpha,
@@ -552,7 +827,7 @@ impl<'a> ContentMS<'a> {
         let mut magnitudes = vec![0.0f32; length];
 
         unsafe {
-            if ffi::RustDAFF_ContentMS_GetMagnitudes(
+            if ffi::DAFFC_ContentMS_GetMagnitudes(
                 self.handle,
                 record_index,
                 channel,
@@ -569,19 +844,19 @@ impl<'a> ContentMS<'a> {
 
 /// Phase Spectrum content
 pub struct ContentPS<'a> {
-    handle: *mut ffi::RustDAFFContentHandle,
+    handle: *mut ffi::DAFFCContentHandle,
     _phantom: PhantomData<&'a ()>,
 }
 
 impl<'a> ContentPS<'a> {
     /// Get the number of frequencies
     pub fn num_frequencies(&self) -> i32 {
-        unsafe { ffi::RustDAFF_ContentPS_GetNumFrequencies(self.handle) }
+        unsafe { ffi::DAFFC_ContentPS_GetNumFrequencies(self.handle) }
     }
 
     /// Find the nearest neighbour record for given angles
     pub fn nearest_neighbour(&self, phi: f64, theta: f64) -> i32 {
-        unsafe { ffi::RustDAFF_ContentPS_GetNearestNeighbour(self.handle, phi, theta) }
+        unsafe { ffi::DAFFC_ContentPS_GetNearestNeighbour(self.handle, phi, theta) }
     }
 
     /// Get record coordinates
@@ -590,7 +865,7 @@ impl<'a> ContentPS<'a> {
         let mut beta = 0.0;
 
         unsafe {
-            if ffi::RustDAFF_ContentPS_GetRecordCoords(
+            if ffi::DAFFC_ContentPS_GetRecordCoords(
                 self.handle,
                 record_index,
                 &mut alpha,
@@ -609,7 +884,7 @@ impl<'a> ContentPS<'a> {
         let mut phases = vec![0.0f32; length];
 
         unsafe {
-            if ffi::RustDAFF_ContentPS_GetPhases(
+            if ffi::DAFFC_ContentPS_GetPhases(
                 self.handle,
                 record_index,
                 channel,
@@ -626,19 +901,19 @@ impl<'a> ContentPS<'a> {
 
 /// Magnitude-Phase Spectrum content
 pub struct ContentMPS<'a> {
-    handle: *mut ffi::RustDAFFContentHandle,
+    handle: *mut ffi::DAFFCContentHandle,
     _phantom: PhantomData<&'a ()>,
 }
 
 impl<'a> ContentMPS<'a> {
     /// Get the number of frequencies
     pub fn num_frequencies(&self) -> i32 {
-        unsafe { ffi::RustDAFF_ContentMPS_GetNumFrequencies(self.handle) }
+        unsafe { ffi::DAFFC_ContentMPS_GetNumFrequencies(self.handle) }
     }
 
     /// Find the nearest neighbour record for given angles
     pub fn nearest_neighbour(&self, phi: f64, theta: f64) -> i32 {
-        unsafe { ffi::RustDAFF_ContentMPS_GetNearestNeighbour(self.handle, phi, theta) }
+        unsafe { ffi::DAFFC_ContentMPS_GetNearestNeighbour(self.handle, phi, theta) }
     }
 
     /// Get record coordinates
@@ -647,7 +922,7 @@ impl<'a> ContentMPS<'a> {
         let mut beta = 0.0;
 
         unsafe {
-            if ffi::RustDAFF_ContentMPS_GetRecordCoords(
+            if ffi::DAFFC_ContentMPS_GetRecordCoords(
                 self.handle,
                 record_index,
                 &mut alpha,
@@ -669,7 +944,7 @@ impl<'a> ContentMPS<'a> {
         let mut phases = vec![0.0f32; length];
 
         unsafe {
-            if ffi::RustDAFF_ContentMPS_GetCoefficients(
+            if ffi::DAFFC_ContentMPS_GetCoefficients(
                 self.handle,
                 record_index,
                 channel,
@@ -687,24 +962,24 @@ impl<'a> ContentMPS<'a> {
 
 /// DFT Spectrum content
 pub struct ContentDFT<'a> {
-    handle: *mut ffi::RustDAFFContentHandle,
+    handle: *mut ffi::DAFFCContentHandle,
     _phantom: PhantomData<&'a ()>,
 }
 
 impl<'a> ContentDFT<'a> {
     /// Get the number of DFT coefficients
     pub fn num_dft_coeffs(&self) -> i32 {
-        unsafe { ffi::RustDAFF_ContentDFT_GetNumDFTCoeffs(self.handle) }
+        unsafe { ffi::DAFFC_ContentDFT_GetNumDFTCoeffs(self.handle) }
     }
 
     /// Check if DFT is symmetric
     pub fn is_symmetric(&self) -> bool {
-        unsafe { ffi::RustDAFF_ContentDFT_IsSymmetric(self.handle) }
+        unsafe { ffi::DAFFC_ContentDFT_IsSymmetric(self.handle) }
     }
 
     /// Find the nearest neighbour record for given angles
     pub fn nearest_neighbour(&self, phi: f64, theta: f64) -> i32 {
-        unsafe { ffi::RustDAFF_ContentDFT_GetNearestNeighbour(self.handle, phi, theta) }
+        unsafe { ffi::DAFFC_ContentDFT_GetNearestNeighbour(self.handle, phi, theta) }
     }
 
     /// Get record coordinates
@@ -713,7 +988,7 @@ impl<'a> ContentDFT<'a> {
         let mut beta = 0.0;
 
         unsafe {
-            if ffi::RustDAFF_ContentDFT_GetRecordCoords(
+            if ffi::DAFFC_ContentDFT_GetRecordCoords(
                 self.handle,
                 record_index,
                 &mut alpha,
@@ -734,7 +1009,7 @@ impl<'a> ContentDFT<'a> {
         let mut coeffs = vec![0.0f32; length];
 
         unsafe {
-            if ffi::RustDAFF_ContentDFT_GetDFTCoeffs(
+            if ffi::DAFFC_ContentDFT_GetDFTCoeffs(
                 self.handle,
                 record_index,
                 channel,
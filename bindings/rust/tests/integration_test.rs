@@ -3,7 +3,7 @@
 //! Note: These tests require actual DAFF files to run.
 //! Place test files in the testdata/ directory to enable these tests.
 
-use opendaff::Reader;
+use opendaff::{ContentType, Quantization, Reader, View};
 
 #[test]
 fn test_reader_creation() {
@@ -21,6 +21,70 @@ fn test_reader_invalid_file() {
     assert!(result.is_err(), "Should fail to open non-existent file");
 }
 
+#[test]
+fn test_memory_footprint_without_file() {
+    let reader = Reader::new().unwrap();
+    let footprint = reader.memory_footprint().expect("Failed to get memory footprint");
+    assert_eq!(footprint.total, 0, "Reader without file should not hold memory");
+}
+
+#[test]
+fn test_batch_without_file() {
+    let reader = Reader::new().unwrap();
+    let mut indices = [0i32; 2];
+    let mut dest = [0.0f32; 16];
+    assert!(reader
+        .nearest_neighbours(View::Object, &[0.0, 90.0], &[0.0, 0.0], &mut indices, None)
+        .is_err());
+    assert!(reader.records(&indices, &mut dest).is_err());
+    assert!(reader.record_range(0, 1, &mut dest).is_err());
+    assert!(reader.record_channel_data(0, 0).is_none());
+}
+
+// Test files of the C interface (bindings/c/testdata): 2 channels, 16 taps at 44.1 kHz on a
+// 30 degree grid, impulse at tap 4 (0.25 left, 0.5 right), taps 5 and 6 hold alpha/360 and beta/180
+const TESTDATA_DIR: &str = concat!(env!("CARGO_MANIFEST_DIR"), "/../c/testdata/");
+
+// Test files with their quantization
+const TESTDATA_FILES: [(&str, Quantization); 4] = [
+    ("ir_int16.daff", Quantization::Int16),
+    ("ir_float16.daff", Quantization::Float16),
+    ("ir_bfloat16.daff", Quantization::BFloat16),
+    ("ir_int16_bfp.daff", Quantization::Int16Bfp),
+];
+
+#[test]
+fn test_impulse_response_quantizations() {
+    for (name, quantization) in TESTDATA_FILES.iter() {
+        let mut reader = Reader::new().unwrap();
+        reader
+            .open_file(&format!("{}{}", TESTDATA_DIR, name))
+            .expect("Failed to open file");
+
+        assert_eq!(reader.content_type(), ContentType::ImpulseResponse, "{}", name);
+        assert_eq!(reader.quantization(), Some(*quantization), "{}", name);
+        assert_eq!(reader.num_channels(), 2, "{}", name);
+        assert_eq!(reader.num_records(), 62, "{}", name);
+
+        let ir = reader.content_ir().expect("Failed to get IR content");
+        assert_eq!(ir.filter_length(), 16, "{}", name);
+        assert_eq!(ir.samplerate(), 44100, "{}", name);
+
+        for (channel, expected) in [0.25f32, 0.5].iter().enumerate() {
+            let coeffs = ir
+                .filter_coeffs(0, channel as i32)
+                .expect("Failed to get filter coefficients");
+            assert!(
+                (coeffs[4] - expected).abs() < 1e-3,
+                "{} channel {}: {} at tap 4",
+                name,
+                channel,
+                coeffs[4]
+            );
+        }
+    }
+}
+
 // Integration tests with actual files would go here
 // Uncomment and add test files to enable
 
@@ -0,0 +1,58 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/DAFFAsyncFetcher.cpp" "CMakeFiles/DAFF.dir/src/DAFFAsyncFetcher.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFAsyncFetcher.cpp.o.d"
+  "/root/repo/src/DAFFChecksum.cpp" "CMakeFiles/DAFF.dir/src/DAFFChecksum.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFChecksum.cpp.o.d"
+  "/root/repo/src/DAFFComparator.cpp" "CMakeFiles/DAFF.dir/src/DAFFComparator.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFComparator.cpp.o.d"
+  "/root/repo/src/DAFFCompression.cpp" "CMakeFiles/DAFF.dir/src/DAFFCompression.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFCompression.cpp.o.d"
+  "/root/repo/src/DAFFContentCache.cpp" "CMakeFiles/DAFF.dir/src/DAFFContentCache.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFContentCache.cpp.o.d"
+  "/root/repo/src/DAFFConverter.cpp" "CMakeFiles/DAFF.dir/src/DAFFConverter.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFConverter.cpp.o.d"
+  "/root/repo/src/DAFFDirectionLUT.cpp" "CMakeFiles/DAFF.dir/src/DAFFDirectionLUT.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFDirectionLUT.cpp.o.d"
+  "/root/repo/src/DAFFDirectivityAnalyzer.cpp" "CMakeFiles/DAFF.dir/src/DAFFDirectivityAnalyzer.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFDirectivityAnalyzer.cpp.o.d"
+  "/root/repo/src/DAFFDistanceSet.cpp" "CMakeFiles/DAFF.dir/src/DAFFDistanceSet.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFDistanceSet.cpp.o.d"
+  "/root/repo/src/DAFFFileSource.cpp" "CMakeFiles/DAFF.dir/src/DAFFFileSource.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFFileSource.cpp.o.d"
+  "/root/repo/src/DAFFFilterCrossfader.cpp" "CMakeFiles/DAFF.dir/src/DAFFFilterCrossfader.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFFilterCrossfader.cpp.o.d"
+  "/root/repo/src/DAFFGPUTable.cpp" "CMakeFiles/DAFF.dir/src/DAFFGPUTable.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFGPUTable.cpp.o.d"
+  "/root/repo/src/DAFFHotReloader.cpp" "CMakeFiles/DAFF.dir/src/DAFFHotReloader.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFHotReloader.cpp.o.d"
+  "/root/repo/src/DAFFInstrumentation.cpp" "CMakeFiles/DAFF.dir/src/DAFFInstrumentation.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFInstrumentation.cpp.o.d"
+  "/root/repo/src/DAFFInterpolator.cpp" "CMakeFiles/DAFF.dir/src/DAFFInterpolator.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFInterpolator.cpp.o.d"
+  "/root/repo/src/DAFFLoader.cpp" "CMakeFiles/DAFF.dir/src/DAFFLoader.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFLoader.cpp.o.d"
+  "/root/repo/src/DAFFMappedFile.cpp" "CMakeFiles/DAFF.dir/src/DAFFMappedFile.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFMappedFile.cpp.o.d"
+  "/root/repo/src/DAFFMetadataImpl.cpp" "CMakeFiles/DAFF.dir/src/DAFFMetadataImpl.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFMetadataImpl.cpp.o.d"
+  "/root/repo/src/DAFFNUMA.cpp" "CMakeFiles/DAFF.dir/src/DAFFNUMA.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFNUMA.cpp.o.d"
+  "/root/repo/src/DAFFPrincipalComponents.cpp" "CMakeFiles/DAFF.dir/src/DAFFPrincipalComponents.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFPrincipalComponents.cpp.o.d"
+  "/root/repo/src/DAFFReader.cpp" "CMakeFiles/DAFF.dir/src/DAFFReader.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFReader.cpp.o.d"
+  "/root/repo/src/DAFFReaderImpl.cpp" "CMakeFiles/DAFF.dir/src/DAFFReaderImpl.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFReaderImpl.cpp.o.d"
+  "/root/repo/src/DAFFReaderPool.cpp" "CMakeFiles/DAFF.dir/src/DAFFReaderPool.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFReaderPool.cpp.o.d"
+  "/root/repo/src/DAFFRealtimeFilterSlot.cpp" "CMakeFiles/DAFF.dir/src/DAFFRealtimeFilterSlot.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFRealtimeFilterSlot.cpp.o.d"
+  "/root/repo/src/DAFFRecordCache.cpp" "CMakeFiles/DAFF.dir/src/DAFFRecordCache.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFRecordCache.cpp.o.d"
+  "/root/repo/src/DAFFSCTransform.cpp" "CMakeFiles/DAFF.dir/src/DAFFSCTransform.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFSCTransform.cpp.o.d"
+  "/root/repo/src/DAFFSHExpansion.cpp" "CMakeFiles/DAFF.dir/src/DAFFSHExpansion.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFSHExpansion.cpp.o.d"
+  "/root/repo/src/DAFFSIMDAVX2.cpp" "CMakeFiles/DAFF.dir/src/DAFFSIMDAVX2.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFSIMDAVX2.cpp.o.d"
+  "/root/repo/src/DAFFSharedMemory.cpp" "CMakeFiles/DAFF.dir/src/DAFFSharedMemory.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFSharedMemory.cpp.o.d"
+  "/root/repo/src/DAFFSphereIndex.cpp" "CMakeFiles/DAFF.dir/src/DAFFSphereIndex.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFSphereIndex.cpp.o.d"
+  "/root/repo/src/DAFFSphereIntegrator.cpp" "CMakeFiles/DAFF.dir/src/DAFFSphereIntegrator.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFSphereIntegrator.cpp.o.d"
+  "/root/repo/src/DAFFStaticReader.cpp" "CMakeFiles/DAFF.dir/src/DAFFStaticReader.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFStaticReader.cpp.o.d"
+  "/root/repo/src/DAFFTrajectoryPlanner.cpp" "CMakeFiles/DAFF.dir/src/DAFFTrajectoryPlanner.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFTrajectoryPlanner.cpp.o.d"
+  "/root/repo/src/DAFFTransformerDFT2MagPhase.cpp" "CMakeFiles/DAFF.dir/src/DAFFTransformerDFT2MagPhase.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFTransformerDFT2MagPhase.cpp.o.d"
+  "/root/repo/src/DAFFTransformerIR2Resampled.cpp" "CMakeFiles/DAFF.dir/src/DAFFTransformerIR2Resampled.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFTransformerIR2Resampled.cpp.o.d"
+  "/root/repo/src/DAFFTransformerMS2Bands.cpp" "CMakeFiles/DAFF.dir/src/DAFFTransformerMS2Bands.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFTransformerMS2Bands.cpp.o.d"
+  "/root/repo/src/DAFFUtils.cpp" "CMakeFiles/DAFF.dir/src/DAFFUtils.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFUtils.cpp.o.d"
+  "/root/repo/src/DAFFView.cpp" "CMakeFiles/DAFF.dir/src/DAFFView.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFView.cpp.o.d"
+  "/root/repo/src/DAFFWriter.cpp" "CMakeFiles/DAFF.dir/src/DAFFWriter.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/DAFFWriter.cpp.o.d"
+  "/root/repo/src/Utils.cpp" "CMakeFiles/DAFF.dir/src/Utils.cpp.o" "gcc" "CMakeFiles/DAFF.dir/src/Utils.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
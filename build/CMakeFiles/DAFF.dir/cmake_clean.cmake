@@ -0,0 +1,89 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/DAFF.dir/src/DAFFAsyncFetcher.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFAsyncFetcher.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFChecksum.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFChecksum.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFComparator.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFComparator.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFCompression.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFCompression.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFContentCache.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFContentCache.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFConverter.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFConverter.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFDirectionLUT.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFDirectionLUT.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFDirectivityAnalyzer.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFDirectivityAnalyzer.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFDistanceSet.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFDistanceSet.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFFileSource.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFFileSource.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFFilterCrossfader.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFFilterCrossfader.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFGPUTable.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFGPUTable.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFHotReloader.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFHotReloader.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFInstrumentation.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFInstrumentation.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFInterpolator.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFInterpolator.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFLoader.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFLoader.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFMappedFile.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFMappedFile.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFMetadataImpl.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFMetadataImpl.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFNUMA.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFNUMA.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFPrincipalComponents.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFPrincipalComponents.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFReader.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFReader.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFReaderImpl.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFReaderImpl.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFReaderPool.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFReaderPool.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFRealtimeFilterSlot.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFRealtimeFilterSlot.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFRecordCache.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFRecordCache.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFSCTransform.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFSCTransform.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFSHExpansion.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFSHExpansion.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFSIMDAVX2.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFSIMDAVX2.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFSharedMemory.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFSharedMemory.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFSphereIndex.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFSphereIndex.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFSphereIntegrator.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFSphereIntegrator.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFStaticReader.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFStaticReader.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFTrajectoryPlanner.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFTrajectoryPlanner.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFTransformerDFT2MagPhase.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFTransformerDFT2MagPhase.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFTransformerIR2Resampled.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFTransformerIR2Resampled.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFTransformerMS2Bands.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFTransformerMS2Bands.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFUtils.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFUtils.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFView.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFView.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/DAFFWriter.cpp.o"
+  "CMakeFiles/DAFF.dir/src/DAFFWriter.cpp.o.d"
+  "CMakeFiles/DAFF.dir/src/Utils.cpp.o"
+  "CMakeFiles/DAFF.dir/src/Utils.cpp.o.d"
+  "libDAFF.a"
+  "libDAFF.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DAFF.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
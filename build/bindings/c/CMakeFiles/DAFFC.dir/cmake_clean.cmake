@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../../libdaff_c.pdb"
+  "../../libdaff_c.so"
+  "CMakeFiles/DAFFC.dir/daff_c.cpp.o"
+  "CMakeFiles/DAFFC.dir/daff_c.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DAFFC.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/DAFFCSWrapper.dir/DAFFCSWrapper.cpp.o"
+  "CMakeFiles/DAFFCSWrapper.dir/DAFFCSWrapper.cpp.o.d"
+  "libDAFFCSWrapper.pdb"
+  "libDAFFCSWrapper.so"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DAFFCSWrapper.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,147 @@
+# Install script for directory: /root/repo
+
+# Set the install prefix
+if(NOT DEFINED CMAKE_INSTALL_PREFIX)
+  set(CMAKE_INSTALL_PREFIX "/usr/local")
+endif()
+string(REGEX REPLACE "/$" "" CMAKE_INSTALL_PREFIX "${CMAKE_INSTALL_PREFIX}")
+
+# Set the install configuration name.
+if(NOT DEFINED CMAKE_INSTALL_CONFIG_NAME)
+  if(BUILD_TYPE)
+    string(REGEX REPLACE "^[^A-Za-z0-9_]+" ""
+           CMAKE_INSTALL_CONFIG_NAME "${BUILD_TYPE}")
+  else()
+    set(CMAKE_INSTALL_CONFIG_NAME "")
+  endif()
+  message(STATUS "Install configuration: \"${CMAKE_INSTALL_CONFIG_NAME}\"")
+endif()
+
+# Set the component getting installed.
+if(NOT CMAKE_INSTALL_COMPONENT)
+  if(COMPONENT)
+    message(STATUS "Install component: \"${COMPONENT}\"")
+    set(CMAKE_INSTALL_COMPONENT "${COMPONENT}")
+  else()
+    set(CMAKE_INSTALL_COMPONENT)
+  endif()
+endif()
+
+# Install shared libraries without execute permission?
+if(NOT DEFINED CMAKE_INSTALL_SO_NO_EXE)
+  set(CMAKE_INSTALL_SO_NO_EXE "1")
+endif()
+
+# Is this installation the result of a crosscompile?
+if(NOT DEFINED CMAKE_CROSSCOMPILING)
+  set(CMAKE_CROSSCOMPILING "FALSE")
+endif()
+
+# Set default install directory permissions.
+if(NOT DEFINED CMAKE_OBJDUMP)
+  set(CMAKE_OBJDUMP "/usr/bin/objdump")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/lib" TYPE STATIC_LIBRARY FILES "/root/repo/build/libDAFF.a")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/include" TYPE FILE FILES
+    "/root/repo/include/DAFF.h"
+    "/root/repo/include/DAFFAsyncFetcher.h"
+    "/root/repo/include/DAFFComparator.h"
+    "/root/repo/include/DAFFContent.h"
+    "/root/repo/include/DAFFContentCache.h"
+    "/root/repo/include/DAFFContentDFT.h"
+    "/root/repo/include/DAFFContentIR.h"
+    "/root/repo/include/DAFFContentMPS.h"
+    "/root/repo/include/DAFFContentMS.h"
+    "/root/repo/include/DAFFContentPS.h"
+    "/root/repo/include/DAFFConverter.h"
+    "/root/repo/include/DAFFDataSource.h"
+    "/root/repo/include/DAFFDefs.h"
+    "/root/repo/include/DAFFDirectionLUT.h"
+    "/root/repo/include/DAFFDirectivityAnalyzer.h"
+    "/root/repo/include/DAFFDistanceSet.h"
+    "/root/repo/include/DAFFFilterCrossfader.h"
+    "/root/repo/include/DAFFGPU.h"
+    "/root/repo/include/DAFFGPUTable.h"
+    "/root/repo/include/DAFFHotReloader.h"
+    "/root/repo/include/DAFFInstrumentation.h"
+    "/root/repo/include/DAFFInterpolator.h"
+    "/root/repo/include/DAFFLoader.h"
+    "/root/repo/include/DAFFMetadata.h"
+    "/root/repo/include/DAFFPrincipalComponents.h"
+    "/root/repo/include/DAFFProperties.h"
+    "/root/repo/include/DAFFReader.h"
+    "/root/repo/include/DAFFReaderPool.h"
+    "/root/repo/include/DAFFRealtimeFilterSlot.h"
+    "/root/repo/include/DAFFSCTransform.h"
+    "/root/repo/include/DAFFSHExpansion.h"
+    "/root/repo/include/DAFFSphereIntegrator.h"
+    "/root/repo/include/DAFFStaticReader.h"
+    "/root/repo/include/DAFFTrajectoryPlanner.h"
+    "/root/repo/include/DAFFTransformerDFT2MagPhase.h"
+    "/root/repo/include/DAFFTransformerIR2Resampled.h"
+    "/root/repo/include/DAFFTransformerMS2Bands.h"
+    "/root/repo/include/DAFFTypedIRView.h"
+    "/root/repo/include/DAFFUtils.h"
+    "/root/repo/include/DAFFView.h"
+    "/root/repo/include/DAFFWriter.h"
+    )
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/." TYPE FILE FILES "/root/repo/README.md")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/." TYPE FILE FILES "/root/repo/LICENSE.md")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/." TYPE FILE FILES "/root/repo/FILEFORMAT.md")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/." TYPE DIRECTORY FILES "/root/repo/content" FILES_MATCHING REGEX "/[^/]*\\.daff$")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/content" TYPE DIRECTORY FILES "/root/repo/matlab" FILES_MATCHING REGEX "/[^/]*\\.daff$")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/csharp" TYPE FILE FILES "/root/repo/bindings/csharp/DAFF.cs")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/csharp" TYPE FILE FILES "/root/repo/bindings/csharp/DAFFTest.cs")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/csharp" TYPE FILE FILES "/root/repo/bindings/csharp/DAFFTest.csproj")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/c" TYPE FILE FILES "/root/repo/bindings/c/README.md")
+endif()
+
+if(NOT CMAKE_INSTALL_LOCAL_ONLY)
+  # Include the install script for each subdirectory.
+  include("/root/repo/build/bindings/csharp/cmake_install.cmake")
+  include("/root/repo/build/bindings/c/cmake_install.cmake")
+
+endif()
+
+if(CMAKE_INSTALL_COMPONENT)
+  set(CMAKE_INSTALL_MANIFEST "install_manifest_${CMAKE_INSTALL_COMPONENT}.txt")
+else()
+  set(CMAKE_INSTALL_MANIFEST "install_manifest.txt")
+endif()
+
+string(REPLACE ";" "\n" CMAKE_INSTALL_MANIFEST_CONTENT
+       "${CMAKE_INSTALL_MANIFEST_FILES}")
+file(WRITE "/root/repo/build/${CMAKE_INSTALL_MANIFEST}"
+     "${CMAKE_INSTALL_MANIFEST_CONTENT}")
@@ -27,18 +27,46 @@
  *
  */
 
+#include <DAFFAsyncFetcher.h>
+#include <DAFFComparator.h>
 #include <DAFFContent.h>
+#include <DAFFContentCache.h>
 #include <DAFFContentDFT.h>
 #include <DAFFContentIR.h>
 #include <DAFFContentMPS.h>
 #include <DAFFContentMS.h>
 #include <DAFFContentPS.h>
+#include <DAFFConverter.h>
+#include <DAFFDataSource.h>
 #include <DAFFDefs.h>
+#include <DAFFDirectionLUT.h>
+#include <DAFFDirectivityAnalyzer.h>
+#include <DAFFDistanceSet.h>
+#include <DAFFFilterCrossfader.h>
+#include <DAFFGPU.h>
+#include <DAFFGPUTable.h>
+#include <DAFFHotReloader.h>
+#include <DAFFInstrumentation.h>
+#include <DAFFInterpolator.h>
+#include <DAFFLoader.h>
 #include <DAFFMetadata.h>
+#include <DAFFPrincipalComponents.h>
 #include <DAFFProperties.h>
 #include <DAFFReader.h>
+#include <DAFFReaderPool.h>
+#include <DAFFRealtimeFilterSlot.h>
 #include <DAFFSCTransform.h>
+#include <DAFFSHExpansion.h>
+#include <DAFFSphereIntegrator.h>
+#include <DAFFStaticReader.h>
+#include <DAFFTrajectoryPlanner.h>
+#include <DAFFTransformerDFT2MagPhase.h>
+#include <DAFFTransformerIR2Resampled.h>
+#include <DAFFTransformerMS2Bands.h>
+#include <DAFFTypedIRView.h>
 #include <DAFFUtils.h>
+#include <DAFFView.h>
+#include <DAFFWriter.h>
 
 
 /*!
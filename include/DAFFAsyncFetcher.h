@@ -0,0 +1,290 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_ASYNCFETCHER
+#define IW_DAFF_ASYNCFETCHER
+
+#include <DAFFDefs.h>
+
+#include <condition_variable>
+#include <cstring>  // required for size_t
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// C++20 coroutine support of the including translation unit (the library itself is C++11)
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#define DAFF_FETCH_COROUTINES
+#endif
+#endif
+
+// Forward declarations
+class DAFFContent;
+class DAFFContentDFT;
+class DAFFContentIR;
+class DAFFContentMS;
+class DAFFContentPS;
+class DAFFFetchAwaitable;
+
+//! Completion of an asynchronous fetch
+class DAFF_API DAFFFetchCallback {
+  public:
+	inline virtual ~DAFFFetchCallback() {};
+
+	//! Reports the completion of a fetch, called exactly once
+	/**
+	 * \param [in] iErrorCode	#DAFF_NO_ERROR if the data is in the destination buffers, another #DAFF_ERROR
+	 *							otherwise (#DAFF_FETCH_CANCELLED after a cancellation)
+	 */
+	virtual void onFetchFinished(int iErrorCode) = 0;
+};
+
+//! Executor of the completions of asynchronous fetches
+/**
+ * Hands the completions over to the threads of the application, e.g. the task queue of a
+ * coroutine scheduler or the event loop of a GUI. Without an executor the completions run
+ * on the I/O threads of the fetcher.
+ */
+class DAFF_API DAFFFetchExecutor {
+  public:
+	inline virtual ~DAFFFetchExecutor() {};
+
+	//! Schedules the completion of a fetch
+	/**
+	 * Called on an I/O thread of the fetcher once the fetch has finished. The executor must
+	 * call pCallback->onFetchFinished(iErrorCode) exactly once, on a thread of its choice,
+	 * and should return without blocking (the I/O thread waits for it).
+	 *
+	 * \param [in] pCallback	Completion
+	 * \param [in] iErrorCode	Result of the fetch
+	 */
+	virtual void post(DAFFFetchCallback* pCallback, int iErrorCode) = 0;
+};
+
+//! Asynchronous record fetch for applications that must not block on I/O
+/**
+ * With lazily loaded files (#DAFF_OPEN_LAZY) and custom sources (DAFFReader::openSource),
+ * fetching a record may block on the storage. The fetcher moves the fetches to a pool of
+ * I/O threads: fetchRecord() and fetchCell() validate the request, queue it and return
+ * immediately, the completion is reported through a DAFFFetchCallback, optionally scheduled
+ * on a user-supplied DAFFFetchExecutor. Any number of fetches can be in flight, they are
+ * processed in the order of submission by getNumThreads() threads concurrently, so that
+ * the I/O of the pending fetches overlaps with the computations of the application.
+ *
+ * The data written is that of getRecord() of the content (IR, MS, PS or DFT), one planar
+ * buffer per channel of getDataLength() floats. The destination buffers and the callback
+ * must stay valid until the completion. Translation units compiled as C++20 additionally
+ * get awaitable variants for coroutines, co_fetchRecord() and co_fetchCell():
+ *
+ *		int iError = co_await oFetcher.co_fetchRecord(iRecordIndex, ppfChannelDest);
+ *
+ * The coroutine is resumed inside the completion, i.e. by the executor (or on an I/O
+ * thread without one).
+ *
+ * The fetcher keeps a pointer to the content, which must outlive it. The methods are
+ * thread-safe, completions may queue new fetches but must not destroy the fetcher.
+ */
+class DAFF_API DAFFAsyncFetcher {
+  public:
+	//! Constructor (starts the I/O threads)
+	/**
+	 * \param [in] pContent		Content (IR, MS, PS or DFT)
+	 * \param [in] pExecutor		Executor of the completions (NULL: completions run on the I/O threads)
+	 * \param [in] iNumThreads	Number of I/O threads (0: automatic, at least 4, the threads mostly wait for
+	 *							the storage)
+	 */
+	DAFFAsyncFetcher(const DAFFContent* pContent, DAFFFetchExecutor* pExecutor = NULL, int iNumThreads = 0);
+
+	//! Destructor (cancels the queued fetches and waits for the running ones)
+	virtual ~DAFFAsyncFetcher();
+
+	//! Returns the content
+	const DAFFContent* getContent() const;
+
+	//! Returns the executor of the completions (or NULL)
+	DAFFFetchExecutor* getExecutor() const;
+
+	//! Returns the number of I/O threads
+	int getNumThreads() const;
+
+	//! Returns the number of channels
+	int getNumChannels() const;
+
+	//! Returns the number of floats per channel (filter length, frequencies or 2 * DFT coefficients)
+	int getDataLength() const;
+
+	//! Fetches all channels of a record asynchronously
+	/**
+	 * \param [in] iRecordIndex		Record index
+	 * \param [in] ppfChannelDest	Destination buffers, one per channel (each size >= getDataLength(),
+	 *								NULL buffers are skipped), the array is copied
+	 * \param [in] pCallback			Completion
+	 *
+	 * @return #DAFF_NO_ERROR if the fetch has been queued (the callback will be called), #DAFF_MODAL_ERROR for
+	 *		   unsupported content types, #DAFF_INVALID_INDEX on invalid record indices (no callback)
+	 */
+	int fetchRecord(int iRecordIndex, float** ppfChannelDest, DAFFFetchCallback* pCallback);
+
+	//! Fetches all channels of the four records of a cell asynchronously
+	/**
+	 * The cell is determined immediately (see DAFFContent::getCell), the records are fetched
+	 * on the I/O threads and reported by a single completion.
+	 *
+	 * \param [in] iView				View of the angles, one of #DAFF_VIEWS
+	 * \param [in] fAngle1Deg		First angle (Phi or Alpha, depending on view)
+	 * \param [in] fAngle2Deg		Second angle (Theta or Beta, depending on view)
+	 * \param [out] qIndices			Record indices of the cell
+	 * \param [in] ppfCellDest		Destination buffers, 4 * getNumChannels() (index record * channels + channel,
+	 *								records in the order of qIndices, NULL buffers are skipped), the array is copied
+	 * \param [in] pCallback			Completion
+	 *
+	 * @return #DAFF_NO_ERROR if the fetch has been queued (the callback will be called), #DAFF_MODAL_ERROR for
+	 *		   unsupported content types (no callback)
+	 */
+	int fetchCell(int iView, float fAngle1Deg, float fAngle2Deg, DAFFQuad& qIndices, float** ppfCellDest,
+				  DAFFFetchCallback* pCallback);
+
+	//! Returns the number of fetches that have not finished yet (queued or running)
+	int getNumPending() const;
+
+	//! Cancels the queued fetches, their completions report #DAFF_FETCH_CANCELLED (running ones finish)
+	void cancelAll();
+
+	//! Waits until all fetches have finished
+	void waitForAll() const;
+
+#ifdef DAFF_FETCH_COROUTINES
+	//! Awaitable fetchRecord(), the result of co_await is the error code
+	inline DAFFFetchAwaitable co_fetchRecord(int iRecordIndex, float** ppfChannelDest);
+
+	//! Awaitable fetchCell(), the result of co_await is the error code
+	inline DAFFFetchAwaitable co_fetchCell(int iView, float fAngle1Deg, float fAngle2Deg, DAFFQuad& qIndices,
+										   float** ppfCellDest);
+#endif
+
+  private:
+	//! Queued fetch
+	struct Request {
+		int piRecordIndices[4];        //!@ Record indices
+		int iNumRecords;               //!@ Number of records (1 or 4)
+		std::vector<float*> vpfDest;   //!@ Destination buffers (index record * channels + channel)
+		DAFFFetchCallback* pCallback;  //!@ Completion
+	};
+
+	const DAFFContent* m_pContent;             //!@ Content
+	const DAFFContentIR* m_pContentIR;         //!@ Content as impulse responses (or NULL)
+	const DAFFContentMS* m_pContentMS;         //!@ Content as magnitude spectra (or NULL)
+	const DAFFContentPS* m_pContentPS;         //!@ Content as phase spectra (or NULL)
+	const DAFFContentDFT* m_pContentDFT;       //!@ Content as DFT spectra (or NULL)
+	DAFFFetchExecutor* m_pExecutor;            //!@ Executor of the completions (or NULL)
+	int m_iNumChannels;                        //!@ Number of channels
+	int m_iDataLength;                         //!@ Floats per channel
+
+	std::vector<std::thread> m_vThreads;       //!@ I/O threads
+	mutable std::mutex m_mxQueue;              //!@ Guards the queue, the pending count and the stop request
+	std::condition_variable m_cvQueue;         //!@ Signals queued fetches and the stop to the I/O threads
+	mutable std::condition_variable m_cvIdle;  //!@ Signals that all fetches have finished
+	std::deque<Request> m_dRequests;           //!@ Queued fetches
+	int m_iNumPending;                         //!@ Fetches that have not finished (queued or running)
+	bool m_bStopped;                           //!@ Stop of the I/O threads requested
+
+	//! Queues (or, without I/O threads, runs) a fetch
+	int submit(Request& oRequest);
+
+	//! Fetches the records of a request into its destination buffers
+	int fetch(Request& oRequest) const;
+
+	//! Reports the completion of a request (through the executor if any)
+	void complete(const Request& oRequest, int iErrorCode);
+
+	//! I/O thread, processes the queued fetches
+	void run();
+
+	// No copy
+	DAFFAsyncFetcher(const DAFFAsyncFetcher&);
+	DAFFAsyncFetcher& operator=(const DAFFAsyncFetcher&);
+};
+
+#ifdef DAFF_FETCH_COROUTINES
+
+//! Awaitable asynchronous fetch (see DAFFAsyncFetcher::co_fetchRecord and DAFFAsyncFetcher::co_fetchCell)
+/**
+ * Suspends the awaiting coroutine until the completion, which resumes it. Fetches that
+ * fail to queue do not suspend. The result of co_await is the #DAFF_ERROR of the fetch.
+ */
+class DAFFFetchAwaitable : public DAFFFetchCallback {
+  public:
+	inline DAFFFetchAwaitable(DAFFAsyncFetcher* pFetcher, int iRecordIndex, float** ppfDest)
+		: m_pFetcher(pFetcher), m_bCell(false), m_iRecordIndex(iRecordIndex), m_iView(0), m_fAngle1Deg(0),
+		  m_fAngle2Deg(0), m_pqIndices(NULL), m_ppfDest(ppfDest), m_iErrorCode(DAFF_NO_ERROR) {};
+
+	inline DAFFFetchAwaitable(DAFFAsyncFetcher* pFetcher, int iView, float fAngle1Deg, float fAngle2Deg,
+							  DAFFQuad* pqIndices, float** ppfDest)
+		: m_pFetcher(pFetcher), m_bCell(true), m_iRecordIndex(-1), m_iView(iView), m_fAngle1Deg(fAngle1Deg),
+		  m_fAngle2Deg(fAngle2Deg), m_pqIndices(pqIndices), m_ppfDest(ppfDest), m_iErrorCode(DAFF_NO_ERROR) {};
+
+	inline bool await_ready() const noexcept { return false; };
+
+	inline bool await_suspend(std::coroutine_handle<> hCoroutine)
+	{
+		// The completion may resume the coroutine before submission returns, the awaitable
+		// must not be touched once the fetch has been queued
+		m_hCoroutine = hCoroutine;
+		int iError;
+		if (m_bCell)
+			iError = m_pFetcher->fetchCell(m_iView, m_fAngle1Deg, m_fAngle2Deg, *m_pqIndices, m_ppfDest, this);
+		else
+			iError = m_pFetcher->fetchRecord(m_iRecordIndex, m_ppfDest, this);
+		if (iError == DAFF_NO_ERROR)
+			return true;
+
+		m_iErrorCode = iError;
+		return false;
+	};
+
+	inline int await_resume() const noexcept { return m_iErrorCode; };
+
+	inline void onFetchFinished(int iErrorCode)
+	{
+		m_iErrorCode = iErrorCode;
+		m_hCoroutine.resume();
+	};
+
+  private:
+	DAFFAsyncFetcher* m_pFetcher;          //!@ Fetcher
+	bool m_bCell;                          //!@ Cell fetch (otherwise record fetch)
+	int m_iRecordIndex;                    //!@ Record index (record fetch)
+	int m_iView;                           //!@ View of the angles (cell fetch)
+	float m_fAngle1Deg;                    //!@ First angle (cell fetch)
+	float m_fAngle2Deg;                    //!@ Second angle (cell fetch)
+	DAFFQuad* m_pqIndices;                 //!@ Record indices of the cell (cell fetch)
+	float** m_ppfDest;                     //!@ Destination buffers
+	int m_iErrorCode;                      //!@ Result of the fetch
+	std::coroutine_handle<> m_hCoroutine;  //!@ Awaiting coroutine
+};
+
+inline DAFFFetchAwaitable DAFFAsyncFetcher::co_fetchRecord(int iRecordIndex, float** ppfChannelDest)
+{
+	return DAFFFetchAwaitable(this, iRecordIndex, ppfChannelDest);
+}
+
+inline DAFFFetchAwaitable DAFFAsyncFetcher::co_fetchCell(int iView, float fAngle1Deg, float fAngle2Deg,
+														 DAFFQuad& qIndices, float** ppfCellDest)
+{
+	return DAFFFetchAwaitable(this, iView, fAngle1Deg, fAngle2Deg, &qIndices, ppfCellDest);
+}
+
+#endif  // DAFF_FETCH_COROUTINES
+
+#endif  // IW_DAFF_ASYNCFETCHER
@@ -0,0 +1,139 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_CUDA
+#define IW_DAFF_CUDA
+
+#include <DAFFDefs.h>
+#include <DAFFGPU.h>
+
+#include <cstring>  // required for size_t
+
+// Forward declarations
+class DAFFContent;
+class DAFFGPUTable;
+
+//! Content resident in CUDA device memory with batched lookup kernels
+/**
+ * The content is packed once (DAFFGPUTable) and its values are copied to device memory with
+ * a single transfer. The batch methods launch one kernel for many directions, the lookups
+ * match the reader (see DAFFGPU.h): getNearestNeighbours like DAFFContent::getNearestNeighbour,
+ * getCells like DAFFContent::getCell, interpolate like DAFFInterpolator::interpolate. Band
+ * lookups read a single value (e.g. the magnitude of one frequency band) per direction.
+ *
+ * All arrays of the batch methods are device pointers, the directions are given as separate
+ * arrays of the first and second angle. The kernels are enqueued asynchronously on the given
+ * stream (a cudaStream_t, NULL: default stream), so the results are available after a
+ * synchronization of the stream. Custom kernels can use the functions of DAFFGPU.h with the
+ * description returned by getDeviceContent().
+ *
+ * Only available if OpenDAFF is built with CUDA (OPENDAFF_WITH_CUDA).
+ */
+class DAFF_API DAFFCUDAContent {
+  public:
+	//! Default constructor (nothing uploaded)
+	DAFFCUDAContent();
+
+	//! Destructor (frees the device memory)
+	virtual ~DAFFCUDAContent();
+
+	//! Packs a content and copies its values to the current device
+	/**
+	 * @return #DAFF_NO_ERROR on success, #DAFF_DEVICE_ERROR if the device memory could not be allocated or written,
+	 *		   the error of DAFFGPUTable::load otherwise
+	 */
+	int upload(const DAFFContent* pContent);
+
+	//! Copies packed values to the current device
+	int upload(const DAFFGPUTable* pTable);
+
+	//! Frees the device memory
+	void release();
+
+	//! Returns true if a content is resident
+	bool isUploaded() const;
+
+	//! Sets the object view orientation (yaw-pitch-roll), no new upload required
+	void setOrientation(const DAFFOrientationYPR& o);
+
+	//! Returns the description of the resident content for custom kernels (device data pointer)
+	const DAFFGPUContent& getDeviceContent() const;
+
+	//! Returns the device memory held by the content [Bytes]
+	size_t getDeviceMemoryUsage() const;
+
+	//! Determines the nearest neighbour records of many directions
+	/**
+	 * \param [in] iView			View, one of #DAFF_VIEWS
+	 * \param [in] pfAngles1		First angles (Phi or Alpha, depending on view) [n, device]
+	 * \param [in] pfAngles2		Second angles (Theta or Beta, depending on view) [n, device]
+	 * \param [out] piRecordIndices	Record indices [n, device]
+	 * \param [out] pbOutOfBounds	Indicators if the directions are out of bounds [n, device] (NULL: not required)
+	 * \param [in] n				Number of directions
+	 * \param [in] pStream			CUDA stream (NULL: default stream)
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if nothing is uploaded, #DAFF_DEVICE_ERROR on launch errors
+	 */
+	int getNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int* piRecordIndices,
+							 bool* pbOutOfBounds, size_t n, void* pStream = NULL) const;
+
+	//! Determines the surrounding records of many directions
+	/**
+	 * \param [out] piIndices	Four record indices per direction in the sequence of DAFFQuad [4n, device]
+	 *
+	 * Other parameters and return values like getNearestNeighbours.
+	 */
+	int getCells(int iView, const float* pfAngles1, const float* pfAngles2, int* piIndices, size_t n,
+				 void* pStream = NULL) const;
+
+	//! Determines the surrounding records and their bilinear weights for many directions
+	/**
+	 * \param [out] piIndices	Four record indices per direction [4n, device]
+	 * \param [out] pfWeights	Four weights per direction, coinciding records merged [4n, device]
+	 *
+	 * Other parameters and return values like getNearestNeighbours.
+	 */
+	int getWeights(int iView, const float* pfAngles1, const float* pfAngles2, int* piIndices, float* pfWeights,
+				   size_t n, void* pStream = NULL) const;
+
+	//! Interpolates all values of a channel bilinearly for many directions
+	/**
+	 * \param [in] iChannel	Channel index
+	 * \param [out] pfDest	Values, getDeviceContent().iNumValues per direction [n x values, device]
+	 *
+	 * Other parameters and return values like getNearestNeighbours, #DAFF_INVALID_INDEX on invalid channels.
+	 */
+	int interpolate(int iView, const float* pfAngles1, const float* pfAngles2, int iChannel, float* pfDest, size_t n,
+					void* pStream = NULL) const;
+
+	//! Looks up one value of a channel (e.g. a band magnitude) for many directions
+	/**
+	 * \param [in] iChannel		Channel index
+	 * \param [in] iValue		Value index (e.g. frequency band)
+	 * \param [in] bInterpolate	Bilinear interpolation (otherwise nearest neighbour)
+	 * \param [out] pfDest		Values [n, device]
+	 *
+	 * Other parameters and return values like getNearestNeighbours, #DAFF_INVALID_INDEX on invalid indices.
+	 */
+	int getBandValues(int iView, const float* pfAngles1, const float* pfAngles2, int iChannel, int iValue,
+					  bool bInterpolate, float* pfDest, size_t n, void* pStream = NULL) const;
+
+  private:
+	DAFFGPUContent m_oContent;  //!@ Description of the resident content
+	float* m_pfDeviceData;      //!@ Values in device memory (NULL: nothing uploaded)
+	size_t m_nDeviceBytes;      //!@ Size of the device memory [Bytes]
+
+	// No copy
+	DAFFCUDAContent(const DAFFCUDAContent&);
+	DAFFCUDAContent& operator=(const DAFFCUDAContent&);
+};
+
+#endif  // IW_DAFF_CUDA
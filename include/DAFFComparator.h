@@ -0,0 +1,207 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_COMPARATOR
+#define IW_DAFF_COMPARATOR
+
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+#include <vector>
+
+// Forward declarations
+class DAFFContent;
+class DAFFContentDFT;
+class DAFFContentIR;
+class DAFFContentMPS;
+class DAFFContentMS;
+class DAFFInterpolator;
+
+//! Per-record differences of two contents, e.g. two revisions of a directivity
+/**
+ * The comparator compares a test content with a reference content record by record and
+ * provides the differences on the grid of the reference:
+ *
+ * - Impulse responses (IR): the difference impulse responses (test minus reference) as a
+ *   DAFFContentIR, e.g. for a carpet plot, and the error energy of every record channel,
+ *   the energy of the difference relative to the energy of the reference [dB]. Both
+ *   contents need the same sampling rate, the shorter filters are padded with zeros.
+ * - Spectra (MS, MPS or DFT, also mixed): the magnitude ratios (test over reference) as a
+ *   DAFFContentMS at the frequencies of the reference, e.g. for a balloon plot in decibels,
+ *   the magnitude deltas [dB] and the error energy of the magnitudes [dB]. Test spectra with
+ *   other frequencies are interpolated over the logarithm of the frequency (constant beyond
+ *   their support), DFT spectra are compared by the magnitudes of their coefficients.
+ *
+ * If the test content has a record at the direction of every reference record in the object
+ * view (independent of the record order and the orientations), the records are compared
+ * directly. Otherwise the test content is resampled at the directions of the reference records
+ * with bilinear weights (see DAFFInterpolator), or from the nearest neighbours on irregular
+ * grids. Both contents need the same number of channels.
+ *
+ * All records are compared in a single parallel pass with SIMD kernels (setNumThreads()).
+ * Magnitudes and energies are limited to -200 dB, so silent records have finite deltas.
+ * The comparator keeps pointers to both contents, which must outlive it. The lifetime of
+ * the difference content is limited to the lifetime of the comparator.
+ */
+class DAFF_API DAFFComparator {
+  public:
+	//! Default constructor
+	DAFFComparator();
+
+	//! Initializing constructor
+	/**
+	 * \param [in] pReference	Reference content (IR, MS, MPS or DFT)
+	 * \param [in] pTest			Test content (same domain as the reference)
+	 * \param [in] bCompare		Compare the contents directly? [optional, default: yes]
+	 */
+	DAFFComparator(const DAFFContent* pReference, const DAFFContent* pTest, bool bCompare = true);
+
+	//! Destructor
+	virtual ~DAFFComparator();
+
+	//! Returns the reference content
+	const DAFFContent* getReferenceContent() const;
+
+	//! Returns the test content
+	const DAFFContent* getTestContent() const;
+
+	//! Sets the contents to compare
+	/**
+	 * \param pReference	Reference content (IR, MS, MPS or DFT)
+	 * \param pTest		Test content (same domain as the reference)
+	 * \param bCompare	Compare the contents directly? [optional, default: yes]
+	 */
+	void setInputContents(const DAFFContent* pReference, const DAFFContent* pTest, bool bCompare = true);
+
+	//! Returns the number of worker threads of the comparison (0: automatic)
+	int getNumThreads() const;
+
+	//! Sets the number of worker threads of the comparison
+	/**
+	 * \param iNumThreads	Number of threads (0: automatic, 1: no worker threads)
+	 */
+	void setNumThreads(int iNumThreads);
+
+	//! Compares the contents
+	/**
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if the contents can not be compared
+	 *		   (missing contents, different domains, phase spectra, different numbers of channels
+	 *		   or sampling rates of impulse responses)
+	 */
+	int compare();
+
+	//! Indicates whether the test content has been compared without resampling
+	bool isGridMatching() const;
+
+	//! Returns the differences as a content on the grid of the reference (NULL if not compared)
+	/**
+	 * DAFFContentIR of the difference impulse responses for impulse responses,
+	 * DAFFContentMS of the magnitude ratios for spectra.
+	 */
+	const DAFFContent* getDifferenceContent() const;
+
+	//! Returns the number of frequencies of the magnitude deltas (0 for impulse responses)
+	int getNumFrequencies() const;
+
+	//! Returns the frequencies of the magnitude deltas [Hz] (frequencies of the reference)
+	const std::vector<float>& getFrequencies() const;
+
+	//! Returns the magnitude deltas of a record channel [dB] (20 log10 of test over reference magnitude)
+	/**
+	 * \param [in] iRecordIndex	Record index of the reference
+	 * \param [in] iChannel		Channel index
+	 * \param [out] pfDest		Destination buffer (getNumFrequencies() elements)
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if not compared or for impulse responses,
+	 *		   #DAFF_INVALID_INDEX for invalid indices
+	 */
+	int getMagnitudeDeltas(int iRecordIndex, int iChannel, float* pfDest) const;
+
+	//! Returns the greatest absolute magnitude delta of all records, channels and frequencies [dB]
+	float getMaximumMagnitudeDelta() const;
+
+	//! Returns the error energy of a record channel [dB] (energy of the difference over energy of the reference)
+	float getErrorEnergy(int iRecordIndex, int iChannel) const;
+
+	//! Returns the error energy of all records and channels [dB] (sum of the differences over sum of the references)
+	float getOverallErrorEnergy() const;
+
+	//! Returns the heap memory held by the comparator [Bytes]
+	size_t getMemoryFootprint() const;
+
+	//! Free memory
+	/**
+	 * Afterwards getDifferenceContent returns NULL, until compare is called again.
+	 */
+	void clear();
+
+  private:
+	const DAFFContent* m_pReference;          //!@ Reference content
+	const DAFFContent* m_pTest;               //!@ Test content
+	const DAFFContentIR* m_pReferenceIR;      //!@ Reference as impulse responses (or NULL)
+	const DAFFContentIR* m_pTestIR;           //!@ Test as impulse responses (or NULL)
+	DAFFContent* m_pOutputContent;            //!@ Difference content
+	DAFFInterpolator* m_pInterpolator;        //!@ Resamples the test content (grids not matching)
+	int m_iNumThreads;                        //!@ Number of worker threads (0: automatic)
+	bool m_bGridMatching;                     //!@ Test records at the directions of the reference records
+	std::vector<int> m_viTestRecords;         //!@ Test record per reference record (grids matching)
+	std::vector<float> m_vfFrequencies;       //!@ Frequencies of the reference [Hz]
+	std::vector<float> m_vfTestFrequencies;   //!@ Frequencies of the test content [Hz]
+	std::vector<int> m_viFreqIndices;         //!@ Lower test frequency per reference frequency (empty: same support)
+	std::vector<float> m_vfFreqWeights;       //!@ Weight of the upper test frequency per reference frequency
+	int m_iLength;                            //!@ Number of values of a record channel
+	int m_iStride;                            //!@ Distance of the record channels in the buffer [floats]
+	float* m_pfBuf;                           //!@ Difference impulse responses or magnitude ratios
+	std::vector<float> m_vfErrorEnergies;     //!@ Error energies per record channel [dB]
+	std::vector<float> m_vfPeaks;             //!@ Peaks (IR) or greatest ratios (spectra) per record channel
+	std::vector<float> m_vfChannelPeaks;      //!@ Peaks per channel (IR)
+	float m_fOverallPeak;                     //!@ Greatest peak or ratio
+	float m_fMaxDelta;                        //!@ Greatest absolute magnitude delta [dB]
+	float m_fOverallErrorEnergy;              //!@ Error energy of all records [dB]
+
+	//! Determines the test record of every reference record (returns false if a direction is missing)
+	bool matchGrids();
+
+	//! Determines the interpolation of the test frequencies at the reference frequencies
+	void initFrequencies();
+
+	//! Compares the record channels [iBegin, iEnd) (with index record * channels + channel)
+	/**
+	 * \param pdEnergies		Energies of the references and of the differences per record channel (output)
+	 * \param pfRatios		Smallest and greatest magnitude ratio per record channel (output, spectra)
+	 * \param piError		Error of the range (output)
+	 */
+	void compareRange(int iBegin, int iEnd, double* pdEnergies, float* pfRatios, int* piError) const;
+
+	// Called by inner content classes
+	const float* getDataPtr(int iRecordIndex, int iChannel) const;
+	int getData(int iRecordIndex, int iChannel, float* pfDest, float fGain, bool bAdd) const;
+	int getValue(int iRecordIndex, int iChannel, int iIndex, float& fValue) const;
+	int getRecord(int iRecordIndex, float** ppfChannelDest) const;
+	int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const;
+	int getSlice(int iChannel, int iIndex, float* pfDest) const;
+	int getFilterEnvelope(int iRecordIndex, int iChannel, int iFirstSample, int iNumSamples, int iNumBins,
+						  float* pfMin, float* pfMax) const;
+	int getFixedPointFilterCoeffs(int iRecordIndex, int iChannel, int16_t* piDestQ15, int32_t* piDestQ31, float fGain,
+								  bool bAdd) const;
+	float getChannelPeak(int iChannel) const;
+	float getRecordPeak(int iRecordIndex, int iChannel) const;
+	int getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const;
+
+	friend class DAFFContentIRDifferenceRealization;
+	friend class DAFFContentMSDifferenceRealization;
+
+	// No copy
+	DAFFComparator(const DAFFComparator&);
+	DAFFComparator& operator=(const DAFFComparator&);
+};
+
+#endif  // IW_DAFF_COMPARATOR
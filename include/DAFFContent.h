@@ -115,6 +115,101 @@ class DAFF_API DAFFContent {
 	virtual void getNearestNeighbour(int iView, float fAngle1Deg, float fAngle2Deg, int& iRecordIndex,
 									 bool& bOutOfBounds) const = 0;
 
+	//! Determine the nearest neighbour records of many directions at once
+	/**
+	 * Batch version of getNearestNeighbour for renderers that resolve large numbers of
+	 * directions per audio block. The per-call overhead is avoided and object view
+	 * directions are transformed with the single precision SIMD kernels of
+	 * DAFFSCTransform. Results equal those of getNearestNeighbour, except for directions
+	 * closer than about 10^-4 degrees to the border between two grid cells.
+	 *
+	 * @param [in] iView				The view that should be used for the given pairs of angles, one of #DAFF_VIEWS
+	 * @param [in] pfAngles1Deg		First angles (Phi or Alpha, depending on view), n elements
+	 * @param [in] pfAngles2Deg		Second angles (Theta or Beta, depending on view), n elements
+	 * @param [out] piRecordIndices	Indices that correspond to the pairs of angles, n elements
+	 * @param [out] pbOutOfBounds	Out of bounds indicators, n elements (may be NULL)
+	 * @param [in] n					Number of directions
+	 */
+	virtual void getNearestNeighbours(int iView, const float* pfAngles1Deg, const float* pfAngles2Deg,
+									  int* piRecordIndices, bool* pbOutOfBounds, size_t n) const = 0;
+
+	//! Determine the k nearest records of a direction and their great-circle distances
+	/**
+	 * Searches all records for the smallest great-circle distances, e.g. for VBAP-style or
+	 * inverse distance interpolation. Unlike the grid search of getNearestNeighbour, the
+	 * poles and the 0&deg;/360&deg; seam need no special treatment and directions outside
+	 * partially covered grids simply yield the closest boundary records. The search uses
+	 * a spatial index of the record directions (O(log N) per query), which is built on the
+	 * first call for regular grids.
+	 *
+	 * @param [in] iView				The view that should be used for the given pair of angles, one of #DAFF_VIEWS
+	 * @param [in] fAngle1Deg		First angle (Phi or Alpha, depending on view)
+	 * @param [in] fAngle2Deg		Second angle (Theta or Beta, depending on view)
+	 * @param [in] k					Number of requested records
+	 * @param [out] piRecordIndices	Record indices by ascending distance, k elements
+	 * @param [out] pfDistancesDeg	Great-circle distances [degrees], k elements (may be NULL)
+	 *
+	 * @return Number of records found, min(k, number of records)
+	 */
+	virtual int getKNearestNeighbours(int iView, float fAngle1Deg, float fAngle2Deg, int k, int* piRecordIndices,
+									  float* pfDistancesDeg) const = 0;
+
+	//! Determine the k nearest records of many directions at once
+	/**
+	 * Batch version of getKNearestNeighbours. The results of direction i are stored in the
+	 * elements [i*k, (i+1)*k) of the output arrays. If the content has fewer than k records,
+	 * the remaining indices and distances of each row are set to -1.
+	 *
+	 * @param [in] iView				The view that should be used for the given pairs of angles, one of #DAFF_VIEWS
+	 * @param [in] pfAngles1Deg		First angles (Phi or Alpha, depending on view), n elements
+	 * @param [in] pfAngles2Deg		Second angles (Theta or Beta, depending on view), n elements
+	 * @param [in] k					Number of requested records per direction
+	 * @param [out] piRecordIndices	Record indices by ascending distance, n*k elements
+	 * @param [out] pfDistancesDeg	Great-circle distances [degrees], n*k elements (may be NULL)
+	 * @param [in] n					Number of directions
+	 *
+	 * @return Number of records found per direction, min(k, number of records)
+	 */
+	virtual int getKNearestNeighbours(int iView, const float* pfAngles1Deg, const float* pfAngles2Deg, int k,
+									  int* piRecordIndices, float* pfDistancesDeg, size_t n) const = 0;
+
+	//! Determine all records within an angular radius around a direction
+	/**
+	 * Collects the records whose directions have a great-circle distance of at most the given
+	 * radius to the direction. On regular grids only the grid rows and columns that intersect
+	 * the cone are visited, irregular grids use a range search on the spatial index of the
+	 * record directions. The cost grows with the number of records found, not with the
+	 * total number of records.
+	 *
+	 * @param [in] iView				The view that should be used for the given pair of angles, one of #DAFF_VIEWS
+	 * @param [in] fAngle1Deg		First angle (Phi or Alpha, depending on view)
+	 * @param [in] fAngle2Deg		Second angle (Theta or Beta, depending on view)
+	 * @param [in] fRadiusDeg		Angular radius of the cone [degrees] (negative: no records)
+	 * @param [out] viRecordIndices	Record indices in ascending order (previous contents are replaced)
+	 *
+	 * @return Number of records found
+	 */
+	virtual int getRecordsInCone(int iView, float fAngle1Deg, float fAngle2Deg, float fRadiusDeg,
+								 std::vector<int>& viRecordIndices) const = 0;
+
+	//! Determine all records within an angular radius around many directions at once
+	/**
+	 * Batch version of getRecordsInCone. The records of direction i are stored in the elements
+	 * [viOffsets[i], viOffsets[i+1]) of viRecordIndices, in ascending order.
+	 *
+	 * @param [in] iView				The view that should be used for the given pairs of angles, one of #DAFF_VIEWS
+	 * @param [in] pfAngles1Deg		First angles (Phi or Alpha, depending on view), n elements
+	 * @param [in] pfAngles2Deg		Second angles (Theta or Beta, depending on view), n elements
+	 * @param [in] fRadiusDeg		Angular radius of the cones [degrees] (negative: no records)
+	 * @param [out] viRecordIndices	Record indices of all directions (previous contents are replaced)
+	 * @param [out] viOffsets		Offsets of the directions in viRecordIndices, n+1 elements
+	 * @param [in] n					Number of directions
+	 *
+	 * @return Total number of records found
+	 */
+	virtual int getRecordsInCone(int iView, const float* pfAngles1Deg, const float* pfAngles2Deg, float fRadiusDeg,
+								 std::vector<int>& viRecordIndices, std::vector<int>& viOffsets, size_t n) const = 0;
+
 	//! Determines the cell of a given direction on the sphere grid and delivers its surrounding record indices
 	/**
 	 * This method takes a direction in form of an angular pair and searches for the valid
@@ -183,6 +278,9 @@ class DAFF_API DAFFContent {
 	 *		Anyway, using getCell out of the boundaries does not make that much sense. In case you run
 	 *		out of bounds onsider using getNearestNeighbour with boundary flag instead.
 	 *
+	 *		On irregular grids (see DAFFProperties::isRegularGrid) there are no cells. The quad then
+	 *		holds the four nearest records by ascending great-circle distance.
+	 *
 	 * @param [in] iView	View, one of #DAFF_VIEWS
 	 * @param [in] fAngle1Deg	Angle of first value in degree
 	 * @param [in] fAngle2Deg	Angle of first value in degree
@@ -190,6 +288,47 @@ class DAFF_API DAFFContent {
 	 */
 	virtual void getCell(int iView, float fAngle1Deg, float fAngle2Deg, DAFFQuad& qIndices) const = 0;
 
+	// --= Prefetching =--
+
+	//! Hints that the data of records will be accessed soon
+	/**
+	 * Meant for a control thread that warms the records around the current viewing direction,
+	 * so that the first access in the audio thread does not stall on I/O. The data of all
+	 * channels of the records is requested and the method returns without waiting for it:
+	 *
+	 *  -	Mapped files (#DAFF_OPEN_MAPPED) advise the operating system to read the pages ahead
+	 *		(madvise with MADV_WILLNEED, PrefetchVirtualMemory on Windows).
+	 *  -	Lazily loaded files (#DAFF_OPEN_LAZY) queue the record channels for a background
+	 *		thread, which loads them into the record cache. The cache must be large enough to
+	 *		hold the prefetched records (see DAFFReader::setLazyCacheSize).
+	 *  -	Otherwise the data is in memory already and nothing is done (default).
+	 *
+	 * @param [in] piRecordIndices	Record indices, n elements
+	 * @param [in] n					Number of records
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_INVALID_INDEX on invalid record indices (nothing is prefetched)
+	 */
+	inline virtual int prefetchRecords(const int*, size_t) const { return DAFF_NO_ERROR; };
+
+	//! Hints that the records of the cell of a direction will be accessed soon
+	/**
+	 * Prefetches the (up to four distinct) records that getCell() determines for the direction,
+	 * i.e. the records an interpolation of the direction accesses. See prefetchRecords().
+	 *
+	 * @param [in] iView			The view that should be used for the given pair of angles, one of #DAFF_VIEWS
+	 * @param [in] fAngle1Deg	First angle (Phi or Alpha, depending on view)
+	 * @param [in] fAngle2Deg	Second angle (Theta or Beta, depending on view)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	inline virtual int prefetchCell(int iView, float fAngle1Deg, float fAngle2Deg) const
+	{
+		DAFFQuad qIndices;
+		getCell(iView, fAngle1Deg, fAngle2Deg, qIndices);
+		const int piRecordIndices[4] = { qIndices.iIndex1, qIndices.iIndex2, qIndices.iIndex3, qIndices.iIndex4 };
+		return prefetchRecords(piRecordIndices, 4);
+	};
+
 	// --= Coordinate transformations =--
 
 	//! Transforms data spherical coordinates into object spherical coordinates
@@ -0,0 +1,72 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_CONTENTCACHE
+#define IW_DAFF_CONTENTCACHE
+
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+#include <memory>
+#include <string>
+
+// Forward declarations
+class DAFFReader;
+
+//! Process-wide cache of shared readers
+/**
+ * Opening the same DAFF file several times (e.g. once per sound source) loads it
+ * only once. Files are identified by their canonical path, modification time and
+ * size together with the open flags, so a file that has been modified on disk is
+ * loaded again. The readers are reference-counted: a reader is closed and its data
+ * released when the last user drops its pointer.
+ *
+ * The shared readers are const, they can neither be closed nor reopened. Since
+ * other users may query the same reader concurrently (see DAFFReader), the reader-global
+ * orientation should not be changed. Use a DAFFView per user instead.
+ *
+ * All methods are thread-safe. Different files are loaded concurrently, requests of a
+ * file that is being loaded wait for it (see DAFFLoader for loading many files in parallel).
+ *
+ * With #DAFF_OPEN_NUMA, a file is loaded once per NUMA node on systems with several nodes:
+ * each request receives the replica of the node its thread is running on, which is loaded
+ * by a thread bound to the node, so that its data is placed in the local memory. Threads
+ * should then request their reader after they have been bound to their node and keep it.
+ * Mapped files (#DAFF_OPEN_MAPPED) share the page cache and are not replicated. Lazily loaded
+ * records are placed on the node of the thread that first accesses them.
+ */
+class DAFF_API DAFFContentCache {
+  public:
+	//! Returns a shared reader for a file
+	/**
+	 * Hands out the reader of an already opened, unmodified file or opens it.
+	 *
+	 * \param [in] sFilePath		Path to the DAFF file
+	 * \param [out] pReader		Shared reader (reset on errors)
+	 * \param [in] iOpenFlags	Combination of #DAFF_OPEN_FLAGS
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	static int open(const std::string& sFilePath, std::shared_ptr<const DAFFReader>& pReader,
+					int iOpenFlags = DAFF_OPEN_DEFAULT);
+
+	//! Returns the number of shared readers currently in use (replicas count separately)
+	static size_t getNumReaders();
+
+	//! Returns the number of NUMA nodes of the system (replicas per file with #DAFF_OPEN_NUMA)
+	static int getNumNUMANodes();
+
+  private:
+	// Only static methods
+	DAFFContentCache();
+};
+
+#endif  // IW_DAFF_CONTENTCACHE
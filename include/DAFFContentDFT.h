@@ -87,10 +87,12 @@ class DAFF_API DAFFContentDFT : public DAFFContent {
 	/**
 	 * This method retrives a single complex-valued DFT coefficient for the given direction (record index)
 	 * and channel and stores them in the supplied destination variable.
+	 * For symmetric spectra, indices beyond the stored coefficients (up to getTransformSize())
+	 * deliver the complex conjugate of the mirrored coefficient.
 	 *
 	 * @param [in] iRecordIndex Record index (direction)
 	 * @param [in] iChannel     Channel index
-	 * @param [in] iDFTCoeff    DFT coefficient index
+	 * @param [in] iDFTCoeff    DFT coefficient index (< getTransformSize())
 	 * @param [out] fReal	Real part
 	 * @param [out] fImag	Imaginary part
 	 *
@@ -113,6 +115,124 @@ class DAFF_API DAFFContentDFT : public DAFFContent {
 	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
 	 */
 	virtual int getDFTCoeffs(int iRecordIndex, int iChannel, float* pfDest) const = 0;
+
+	//! Retrieves the full DFT spectrum
+	/**
+	 * Like getDFTCoeffs(), but symmetric spectra are expanded to all getTransformSize()
+	 * coefficients: the coefficients beyond the stored ones are the complex conjugates of
+	 * the mirrored coefficients, X[N-k] = conj(X[k]). Spectra that are not symmetric are
+	 * returned as they are stored.
+	 *
+	 * \param iRecordIndex  Record index (direction)
+	 * \param iChannel      Channel index
+	 * \param pfDest		Destination buffer (size >= 2*getTransformSize())
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getDFTCoeffsFull(int iRecordIndex, int iChannel, float* pfDest) const = 0;
+
+	//! Retrieves one DFT coefficient for all records
+	/**
+	 * Cross-record slice: writes the complex-valued DFT coefficient of the given channel
+	 * and coefficient index for every record, in the order of the record indices. With
+	 * #DAFF_OPEN_SLICES the slice is copied from a frequency-major copy of the data.
+	 *
+	 * The output storage scheme is: pfDest = (Re[record 0], Im[record 0], Re[record 1], Im[record 1], ...)
+	 *
+	 * \param [in] iChannel      Channel index
+	 * \param [in] iDFTCoeff     DFT coefficient index
+	 * \param [out] pfDest		Destination buffer (size >= 2*number of records)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getDFTCoeffSlice(int iChannel, int iDFTCoeff, float* pfDest) const = 0;
+
+	//! Retrieves DFT coefficients in polar form
+	/**
+	 * This method retrieves the DFT coefficients for the given direction (record index)
+	 * and channel as magnitudes and phases (radians within [-pi/2, 3pi/2)). The method writes
+	 * exactly 2*getNumDFTCoeffs() values.
+	 *
+	 * The output storage scheme is: pfDest = (Mag[0], Ph[0], Mag[1], Ph[1], ...)
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [in] iChannel      Channel index
+	 * \param [out] pfDest		Destination buffer (size >= 2*getNumDFTCoeffs())
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getCoefficientsMP(int iRecordIndex, int iChannel, float* pfDest) const = 0;
+
+	//! Retrieves the DFT coefficients of several records in polar form
+	/**
+	 * Same as calling getCoefficientsMP for every record, but the records are fetched at once
+	 * and converted in a single pass. The records are written one after the other, each in the
+	 * storage scheme of getCoefficientsMP (2*getNumDFTCoeffs() values per record).
+	 *
+	 * \param [in] piRecordIndices	Record indices (directions)
+	 * \param [in] iNumRecords		Number of records
+	 * \param [in] iChannel			Channel index
+	 * \param [out] pfDest			Destination buffer (size >= 2*getNumDFTCoeffs()*number of records)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getCoefficientsMP(const int* piRecordIndices, int iNumRecords, int iChannel, float* pfDest) const = 0;
+
+	//! Adds DFT coefficients to a given buffer
+	/**
+	 * This method retrieves the complex-valued DFT coefficients for the given direction (record index)
+	 * and channel, multiplies them with the (real-valued) gain and numerically adds them to the
+	 * supplied destination buffer, using the same storage scheme as getDFTCoeffs().
+	 *
+	 * \param iRecordIndex  Record index (direction)
+	 * \param iChannel      Channel index
+	 * \param pfDest		Destination buffer (size >= 2*getNumDFTCoeffs())
+	 * \param fGain			Gain factor (optional, default: 1)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int addDFTCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const = 0;
+
+	//! Returns a read-only pointer to the DFT coefficients for record and channel
+	/**
+	 * Zero-copy access to the complex-valued DFT coefficients (2*getNumDFTCoeffs() values in
+	 * the storage scheme of getDFTCoeffs()). The pointer stays valid as long as the content
+	 * exists. With #DAFF_OPEN_LAZY it refers to the record cache and is only valid until
+	 * the next data access.
+	 *
+	 * \param iRecordIndex  Record index (direction)
+	 * \param iChannel      Channel index
+	 *
+	 * @return Pointer to the coefficients, NULL on invalid indices or for 16-bit floating point data (unless decoded,
+	 *         see DAFFReader::getRecordChannelData16Ptr)
+	 */
+	virtual const float* getDFTCoeffsPtr(int iRecordIndex, int iChannel) const = 0;
+
+	//! Retrieves the DFT coefficients of all channels of a record
+	/**
+	 * Same as calling getDFTCoeffs for every channel, but the record is validated
+	 * once. Each channel is written into its own (planar) buffer, using the storage
+	 * scheme of getDFTCoeffs(). Channels with a NULL buffer are skipped.
+	 *
+	 * \param iRecordIndex		Record index (direction)
+	 * \param ppfChannelDest	Destination buffers, one per channel (each size >= 2*getNumDFTCoeffs())
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getRecord(int iRecordIndex, float** ppfChannelDest) const = 0;
+
+	//! Retrieves the DFT coefficients of all channels of a record into an interleaved buffer
+	/**
+	 * Coefficients are interleaved as complex values: Re and Im of coefficient k
+	 * of channel c are stored at pfDest[k*iStride + 2*c] and pfDest[k*iStride + 2*c + 1].
+	 *
+	 * \param iRecordIndex  Record index (direction)
+	 * \param pfDest		Destination buffer (size >= getNumDFTCoeffs() * iStride)
+	 * \param iStride		Distance of consecutive coefficients of a channel in floats (>= 2 * number of channels)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const = 0;
 };
 
 #endif  // IW_DAFF_CONTENTDFT
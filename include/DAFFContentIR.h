@@ -71,6 +71,42 @@ class DAFF_API DAFFContentIR : public DAFFContent {
 	 */
 	virtual int getFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const = 0;
 
+	//! Retrieves a single filter coefficient for record and channel
+	/**
+	 * Reads only the requested coefficient (zero outside of the effective part),
+	 * without converting the whole filter.
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [in] iChannel      Channel index
+	 * \param [in] iSample       Coefficient index (0 <= index < filter length)
+	 * \param [out] fCoeff       Filter coefficient
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getFilterCoeff(int iRecordIndex, int iChannel, int iSample, float& fCoeff) const = 0;
+
+	//! Retrieves the filter coefficients for record and channel up to the end of the effective part
+	/**
+	 * Same as getFilterCoeffs, but the trailing zeros are not written. The compacted
+	 * length (effective filter offset plus effective filter length) is returned, which
+	 * is at most getMaxTruncatedFilterLength(). Files opened with #DAFF_OPEN_TRUNCATE
+	 * additionally have their tails below the truncation threshold removed, so that
+	 * convolutions can use much shorter filters.
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [in] iChannel      Channel index
+	 * \param [out] pfDest		Destination buffer (size >= getMaxTruncatedFilterLength())
+	 * \param [out] iLength		Number of coefficients written
+	 * \param [in] fGain			Gain factor (optional, default: 1)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getFilterCoeffsTruncated(int iRecordIndex, int iChannel, float* pfDest, int& iLength,
+										 float fGain = 1.0F) const = 0;
+
+	//! Returns the maximum length returned by getFilterCoeffsTruncated over all records
+	virtual int getMaxTruncatedFilterLength() const = 0;
+
 	//! Adds filter coefficients for record and channel to a given buffer
 	/**
 	 * This method retrieves the full filter impulse response for the given
@@ -89,6 +125,91 @@ class DAFF_API DAFFContentIR : public DAFFContent {
 	 */
 	virtual int addFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const = 0;
 
+	//! Retrieves the filter coefficients for record and channel in Q15 fixed point
+	/**
+	 * Same as getFilterCoeffs, but the coefficients are written as 16-bit fixed-point
+	 * values for integer DSP pipelines, without an intermediate float buffer. Full scale
+	 * is the one of #DAFF_INT16 (32767 for a coefficient of 1), so the samples of #DAFF_INT16
+	 * files are copied unchanged for unit gain. Other quantizations are converted, the
+	 * values are rounded to nearest even and saturated. Gains of powers of two are exact,
+	 * i.e. they act as shifts (with rounding).
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [in] iChannel      Channel index
+	 * \param [out] piDest		Destination buffer (size >= filter length)
+	 * \param [in] fGain			Gain factor (optional, default: 1)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getFilterCoeffsQ15(int iRecordIndex, int iChannel, int16_t* piDest, float fGain = 1.0F) const = 0;
+
+	//! Retrieves the filter coefficients for record and channel in Q31 fixed point
+	/**
+	 * Same as getFilterCoeffsQ15 for 32-bit fixed-point values, full scale is 2147483647.
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [in] iChannel      Channel index
+	 * \param [out] piDest		Destination buffer (size >= filter length)
+	 * \param [in] fGain			Gain factor (optional, default: 1)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getFilterCoeffsQ31(int iRecordIndex, int iChannel, int32_t* piDest, float fGain = 1.0F) const = 0;
+
+	//! Adds the filter coefficients for record and channel in Q15 fixed point to a given buffer
+	/**
+	 * Same as addFilterCoeffs in the fixed point of getFilterCoeffsQ15. The sums saturate,
+	 * only the effective part of the filter is accumulated.
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [in] iChannel      Channel index
+	 * \param [in,out] piDest	Destination buffer (size >= filter length)
+	 * \param [in] fGain			Gain factor (optional, default: 1)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int addFilterCoeffsQ15(int iRecordIndex, int iChannel, int16_t* piDest, float fGain = 1.0F) const = 0;
+
+	//! Adds the filter coefficients for record and channel in Q31 fixed point to a given buffer
+	/**
+	 * Same as addFilterCoeffs in the fixed point of getFilterCoeffsQ31. The sums saturate,
+	 * only the effective part of the filter is accumulated.
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [in] iChannel      Channel index
+	 * \param [in,out] piDest	Destination buffer (size >= filter length)
+	 * \param [in] fGain			Gain factor (optional, default: 1)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int addFilterCoeffsQ31(int iRecordIndex, int iChannel, int32_t* piDest, float fGain = 1.0F) const = 0;
+
+	//! Retrieves the filter coefficients of all channels of a record
+	/**
+	 * Same as calling getFilterCoeffs for every channel, but the record is validated
+	 * once and all channels are converted in a single pass. Each channel is written
+	 * into its own (planar) buffer. Channels with a NULL buffer are skipped.
+	 *
+	 * \param [in] iRecordIndex		Record index (direction)
+	 * \param [out] ppfChannelDest	Destination buffers, one per channel (each size >= filter length)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getRecord(int iRecordIndex, float** ppfChannelDest) const = 0;
+
+	//! Retrieves the filter coefficients of all channels of a record into an interleaved buffer
+	/**
+	 * The coefficient k of channel c is stored at pfDest[k*iStride + c]. Values in
+	 * between (iStride greater than the number of channels) remain untouched.
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [out] pfDest		Destination buffer (size >= filter length * iStride)
+	 * \param [in] iStride		Distance of consecutive coefficients of a channel (>= number of channels)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const = 0;
+
 	// --= Low-level data access =--
 
 	//! Returns the minimal effective filter offset over all records
@@ -168,11 +289,93 @@ class DAFF_API DAFFContentIR : public DAFFContent {
 	 */
 	virtual int addEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const = 0;
 
+	//! Returns a read-only pointer to the effective filter coefficients for record and channel
+	/**
+	 * Zero-copy access to the effective filter coefficients, which are stored as
+	 * 32-bit floats in the record data. A pointer can only be provided if no sample
+	 * type conversion is required, i.e. for #DAFF_FLOAT32 quantization or files opened
+	 * with #DAFF_OPEN_DECODE or #DAFF_OPEN_TRUNCATE. Otherwise NULL is returned and getEffectiveFilterCoeffs()
+	 * must be used instead.
+	 *
+	 * The pointer stays valid as long as the file is opened. With #DAFF_OPEN_LAZY
+	 * it refers to the record cache and is only valid until the next data access.
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [in] iChannel      Channel index
+	 * \param [out] iOffset		Effective filter offset
+	 * \param [out] iLength		Effective filter length (number of values behind the pointer)
+	 *
+	 * @return Pointer to the coefficients, NULL on invalid indices or if a conversion is required
+	 *
+	 * \sa getEffectiveFilterBounds
+	 */
+	virtual const float* getEffectiveFilterCoeffsPtr(int iRecordIndex, int iChannel, int& iOffset,
+													 int& iLength) const = 0;
+
+	//! Retrieves the envelope (minimum and maximum per bin) of a part of the filter coefficients
+	/**
+	 * Decimates the coefficients [iFirstSample, iFirstSample + iNumSamples) for record and
+	 * channel into iNumBins consecutive bins and stores the smallest and the greatest
+	 * coefficient of each bin, e.g. to plot long impulse responses at screen resolution.
+	 * Bin k covers the coefficients from iFirstSample + k * iNumSamples / iNumBins up to
+	 * iFirstSample + (k + 1) * iNumSamples / iNumBins (exclusive, integer division).
+	 * The envelope is determined directly on the stored samples, without converting the
+	 * whole filter.
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [in] iChannel      Channel index
+	 * \param [in] iFirstSample	First coefficient
+	 * \param [in] iNumSamples	Number of coefficients (first sample + number of samples <= filter length)
+	 * \param [in] iNumBins		Number of bins (1 <= number of bins <= number of samples)
+	 * \param [out] pfMin		Minimum of each bin (size >= number of bins)
+	 * \param [out] pfMax		Maximum of each bin (size >= number of bins)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getFilterEnvelope(int iRecordIndex, int iChannel, int iFirstSample, int iNumSamples, int iNumBins,
+								  float* pfMin, float* pfMax) const = 0;
+
 	//! Get overall peak value
 	/**
+	 * Returns the greatest absolute filter coefficient over all records and channels.
+	 * The peak values are determined once on first request of any of the peak methods
+	 * (thread-safe) directly on the stored samples, in parallel for large files.
+	 *
 	 * @return Overall peak value
 	 */
-	virtual float getOverallPeak() = 0;
+	virtual float getOverallPeak() const = 0;
+
+	//! Get peak value of a channel
+	/**
+	 * @param [in] iChannel  Channel index
+	 *
+	 * @return Greatest absolute filter coefficient of the channel over all records (0 for invalid indices)
+	 */
+	virtual float getChannelPeak(int iChannel) const = 0;
+
+	//! Get peak value of a record channel
+	/**
+	 * @param [in] iRecordIndex  Record index (direction)
+	 * @param [in] iChannel      Channel index
+	 *
+	 * @return Greatest absolute filter coefficient of the record channel (0 for invalid indices)
+	 */
+	virtual float getRecordPeak(int iRecordIndex, int iChannel) const = 0;
+
+	//! Retrieves statistics of a record channel
+	/**
+	 * Delivers peak, energy, RMS and onset (first coefficient reaching -20 dB of the peak,
+	 * counted from the start of the full filter) of the impulse response. The values are
+	 * taken from the optional statistics block of the file. Without this block they are
+	 * computed for all records on first request (thread-safe).
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [in] iChannel      Channel index
+	 * \param [out] oStats		Statistics
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const = 0;
 };
 
 #endif  // IW_DAFF_CONTENTIR
@@ -91,6 +91,20 @@ class DAFF_API DAFFContentMPS : public DAFFContent {
 	 */
 	virtual int getMagnitude(int iRecordIndex, int iChannel, int iFreqIndex, float& fMag) const = 0;
 
+	//! Retrieves the magnitude coefficients of one frequency for all records
+	/**
+	 * Cross-record slice: writes the magnitude coefficient of the given channel and
+	 * frequency index for every record, in the order of the record indices. With
+	 * #DAFF_OPEN_SLICES the slice is copied from a frequency-major copy of the data.
+	 *
+	 * \param [in] iChannel      Channel index
+	 * \param [in] iFreqIndex    Frequency index
+	 * \param [out] pfDest		Destination buffer (size >= number of records)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getMagnitudeSlice(int iChannel, int iFreqIndex, float* pfDest) const = 0;
+
 	//! Retrieves phase coefficients
 	/**
 	 * This method retrives the phase coefficients for the given direction (record index)
@@ -121,6 +135,20 @@ class DAFF_API DAFFContentMPS : public DAFFContent {
 	 */
 	virtual int getPhase(int iRecordIndex, int iChannel, int iFreqIndex, float& fPhase) const = 0;
 
+	//! Retrieves the phase coefficients of one frequency for all records
+	/**
+	 * Cross-record slice: writes the phase coefficient of the given channel and
+	 * frequency index for every record, in the order of the record indices. With
+	 * #DAFF_OPEN_SLICES the slice is copied from a frequency-major copy of the data.
+	 *
+	 * \param [in] iChannel      Channel index
+	 * \param [in] iFreqIndex    Frequency index
+	 * \param [out] pfDest		Destination buffer (size >= number of records)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getPhaseSlice(int iChannel, int iFreqIndex, float* pfDest) const = 0;
+
 	//! Retrieves coefficients in polar form
 	/**
 	 * This method retrives the coefficients for the given direction (record index)
@@ -141,6 +169,21 @@ class DAFF_API DAFFContentMPS : public DAFFContent {
 	// TODO: Ausgabe Interleaved
 	virtual int getCoefficientsMP(int iRecordIndex, int iChannel, float* pfDest) const = 0;
 
+	//! Retrieves the coefficients of several records in polar form
+	/**
+	 * Same as calling getCoefficientsMP for every record, but the records are fetched at once
+	 * and converted in a single pass. The records are written one after the other, each in the
+	 * storage scheme of getCoefficientsMP (2*number of frequencies values per record).
+	 *
+	 * \param [in] piRecordIndices	Record indices (directions)
+	 * \param [in] iNumRecords		Number of records
+	 * \param [in] iChannel			Channel index
+	 * \param [out] pfDest			Destination buffer (size >= 2*number of frequencies*number of records)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getCoefficientsMP(const int* piRecordIndices, int iNumRecords, int iChannel, float* pfDest) const = 0;
+
 	//! Retrieves coefficients in cartesian form
 	/**
 	 * This method retrives the coefficients for the given direction (record index)
@@ -72,6 +72,47 @@ class DAFF_API DAFFContentMS : public DAFFContent {
 	 */
 	virtual int getMagnitudes(int iRecordIndex, int iChannel, float* pfDest) const = 0;
 
+	//! Adds magnitude coefficients to a given buffer
+	/**
+	 * This method retrieves the magnitude coefficients for the given direction (record index)
+	 * and channel, multiplies them with the gain and numerically adds them to the supplied
+	 * destination buffer. Weighted sums of several records (e.g. interpolation) can thereby
+	 * be computed without intermediate buffers.
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [in] iChannel      Channel index
+	 * \param [in,out] pfDest	Destination buffer (size >= number of frequencies)
+	 * \param [in] fGain			Gain factor (optional, default: 1)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int addMagnitudes(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const = 0;
+
+	//! Retrieves the magnitude coefficients of all channels of a record
+	/**
+	 * Same as calling getMagnitudes for every channel, but the record is validated
+	 * once. Each channel is written into its own (planar) buffer. Channels with a
+	 * NULL buffer are skipped.
+	 *
+	 * \param [in] iRecordIndex		Record index (direction)
+	 * \param [out] ppfChannelDest	Destination buffers, one per channel (each size >= number of frequencies)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getRecord(int iRecordIndex, float** ppfChannelDest) const = 0;
+
+	//! Retrieves the magnitude coefficients of all channels of a record into an interleaved buffer
+	/**
+	 * The magnitude at frequency index k of channel c is stored at pfDest[k*iStride + c].
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [out] pfDest		Destination buffer (size >= number of frequencies * iStride)
+	 * \param [in] iStride		Distance of consecutive magnitudes of a channel (>= number of channels)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const = 0;
+
 	//! Retrieves a single magnitude coefficient
 	/**
 	 * This method retrives the magnitude coefficient for the given direction (record index),
@@ -87,6 +128,49 @@ class DAFF_API DAFFContentMS : public DAFFContent {
 	 * \note The magnitude value is a factor (no decibel).
 	 */
 	virtual int getMagnitude(int iRecordIndex, int iChannel, int iFreqIndex, float& fMag) const = 0;
+
+	//! Retrieves the magnitude coefficients of one frequency for all records
+	/**
+	 * Cross-record slice: writes the magnitude coefficient of the given channel and
+	 * frequency index for every record, in the order of the record indices. With
+	 * #DAFF_OPEN_SLICES the slice is copied from a frequency-major copy of the data.
+	 *
+	 * \param [in] iChannel      Channel index
+	 * \param [in] iFreqIndex    Frequency index
+	 * \param [out] pfDest		Destination buffer (size >= number of records)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getMagnitudeSlice(int iChannel, int iFreqIndex, float* pfDest) const = 0;
+
+	//! Returns a read-only pointer to the magnitude coefficients for record and channel
+	/**
+	 * Zero-copy access to the magnitudes inside the record data (as many values as
+	 * there are support frequencies). The pointer stays valid as long as the file is
+	 * opened. With #DAFF_OPEN_LAZY it refers to the record cache and is only valid
+	 * until the next data access.
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [in] iChannel      Channel index
+	 *
+	 * @return Pointer to the magnitudes, NULL on invalid indices or for 16-bit floating point data (unless decoded,
+	 *         see DAFFReader::getRecordChannelData16Ptr)
+	 */
+	virtual const float* getMagnitudesPtr(int iRecordIndex, int iChannel) const = 0;
+
+	//! Retrieves statistics of a record channel
+	/**
+	 * Delivers peak, energy, RMS and onset (first frequency index reaching -20 dB of the peak)
+	 * of the magnitude spectrum. The values are taken from the optional statistics block of
+	 * the file. Without this block they are computed for all records on first request (thread-safe).
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [in] iChannel      Channel index
+	 * \param [out] oStats		Statistics
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const = 0;
 };
 
 #endif  // IW_DAFF_CONTENTMS
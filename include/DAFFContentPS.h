@@ -61,6 +61,60 @@ class DAFF_API DAFFContentPS : public DAFFContent {
 	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
 	 */
 	virtual int getPhases(int iRecordIndex, int iChannel, float* pfDest) const = 0;
+
+	//! Retrieves the phase coefficients of one frequency for all records
+	/**
+	 * Cross-record slice: writes the phase coefficient of the given channel and
+	 * frequency index for every record, in the order of the record indices. With
+	 * #DAFF_OPEN_SLICES the slice is copied from a frequency-major copy of the data.
+	 *
+	 * \param [in] iChannel      Channel index
+	 * \param [in] iFreqIndex    Frequency index
+	 * \param [out] pfDest		Destination buffer (size >= number of records)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getPhaseSlice(int iChannel, int iFreqIndex, float* pfDest) const = 0;
+
+	//! Returns a read-only pointer to the phase coefficients for record and channel
+	/**
+	 * Zero-copy access to the phases inside the record data (as many values as
+	 * there are support frequencies). The pointer stays valid as long as the file is
+	 * opened. With #DAFF_OPEN_LAZY it refers to the record cache and is only valid
+	 * until the next data access.
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [in] iChannel      Channel index
+	 *
+	 * @return Pointer to the phases, NULL on invalid indices or for 16-bit floating point data (unless decoded,
+	 *         see DAFFReader::getRecordChannelData16Ptr)
+	 */
+	virtual const float* getPhasesPtr(int iRecordIndex, int iChannel) const = 0;
+
+	//! Retrieves the phase coefficients of all channels of a record
+	/**
+	 * Same as calling getPhases for every channel, but the record is validated
+	 * once. Each channel is written into its own (planar) buffer. Channels with a
+	 * NULL buffer are skipped.
+	 *
+	 * \param [in] iRecordIndex		Record index (direction)
+	 * \param [out] ppfChannelDest	Destination buffers, one per channel (each size >= number of frequencies)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getRecord(int iRecordIndex, float** ppfChannelDest) const = 0;
+
+	//! Retrieves the phase coefficients of all channels of a record into an interleaved buffer
+	/**
+	 * The phase at frequency index k of channel c is stored at pfDest[k*iStride + c].
+	 *
+	 * \param [in] iRecordIndex  Record index (direction)
+	 * \param [out] pfDest		Destination buffer (size >= number of frequencies * iStride)
+	 * \param [in] iStride		Distance of consecutive phases of a channel (>= number of channels)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const = 0;
 };
 
 #endif  // IW_DAFF_CONTENTPS
@@ -0,0 +1,195 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_CONVERTER
+#define IW_DAFF_CONVERTER
+
+#include <DAFFDefs.h>
+
+#include <string>
+
+// Forward declarations
+class DAFFContent;
+class DAFFMetadata;
+
+//! Parallel conversion of DAFF contents into new DAFF files (read, transform, write)
+/**
+ * The converter copies a content with its grid, orientation and metadata into a new
+ * DAFF file, optionally requantized, resampled (impulse responses) and trimmed. The
+ * records pass a pipeline of three stages: a reader thread fetches the records into a
+ * ring of slots, worker threads transform them, and the calling thread appends them in
+ * the order of the record indices with the streaming interface of DAFFWriter. The ring
+ * bounds the memory usage to a few records per thread, independent of the file size.
+ *
+ * Any content can be converted, so further transformations are available through the
+ * content views of the transformers, e.g. impulse responses into DFT spectra with the
+ * output content of DAFFTransformerIR2DFT (the workers then transform the records on
+ * their first access, if the transformer is lazy).
+ *
+ * Resampling uses bandlimited (Blackman windowed sinc) interpolation and scales the
+ * coefficients by the ratio of the sampling rates, so that the frequency response is
+ * preserved below the lower Nyquist frequency.
+ */
+class DAFF_API DAFFConverter {
+  public:
+	//! Default constructor (keeps quantization and sampling rate, no trimming)
+	DAFFConverter();
+
+	//! Destructor
+	virtual ~DAFFConverter();
+
+	//! Returns the output quantization (-1: quantization of the input)
+	int getQuantization() const;
+
+	//! Sets the output quantization
+	/**
+	 * \param iQuantization	One of #DAFF_QUANTIZATIONS, or -1 for the quantization of the input
+	 *						(spectra of integer impulse responses are stored as #DAFF_FLOAT32)
+	 */
+	void setQuantization(int iQuantization);
+
+	//! Returns the output sampling rate of impulse responses (0: sampling rate of the input)
+	float getSamplerate() const;
+
+	//! Sets the output sampling rate of impulse responses [Hz] (0: no resampling)
+	void setSamplerate(float fSamplerate);
+
+	//! Returns the maximum output filter length (0: no limit)
+	int getMaxFilterLength() const;
+
+	//! Sets the maximum output filter length of impulse responses, applied after resampling (0: no limit)
+	void setMaxFilterLength(int iMaxFilterLength);
+
+	//! Returns the zero threshold of the effective bounds [dB]
+	float getZeroThreshold() const;
+
+	//! Sets the zero threshold of the effective bounds, see DAFFWriter::setZeroThreshold [dB]
+	void setZeroThreshold(float fThresholdDB);
+
+	//! Indicates whether the output record data is compressed
+	bool getCompression() const;
+
+	//! Enables the lossless compression of the output record data, see DAFFWriter::setCompression
+	void setCompression(bool bEnabled);
+
+	//! Returns the alignment of the output record channels [Bytes]
+	int getDataAlignment() const;
+
+	//! Sets the alignment of the output record channels, see DAFFWriter::setDataAlignment (default: 16 Bytes)
+	void setDataAlignment(int iAlignment);
+
+	//! Indicates whether identical output record channels are stored only once
+	bool getDeduplication() const;
+
+	//! Enables the deduplication of the output record data, see DAFFWriter::setDeduplication
+	void setDeduplication(bool bEnabled);
+
+	//! Indicates whether the output embeds the statistics of the record channels
+	bool getStatistics() const;
+
+	//! Enables the statistics block of the output, see DAFFWriter::setStatistics
+	void setStatistics(bool bEnabled);
+
+	//! Indicates whether the output embeds the nearest neighbour index of the record directions
+	bool getDirectionIndex() const;
+
+	//! Enables the direction index block of the output, see DAFFWriter::setDirectionIndex
+	void setDirectionIndex(bool bEnabled);
+
+	//! Indicates whether the output contains checksums
+	bool getChecksums() const;
+
+	//! Enables the checksum block of the output, see DAFFWriter::setChecksums
+	void setChecksums(bool bEnabled);
+
+	//! Returns the symmetry of the output grid (-1: input)
+	int getSymmetry() const;
+
+	//! Sets the symmetry of the output grid, see DAFFWriter::setSymmetry (-1: input, default)
+	/**
+	 * The stored output records are the input records in the same directions, the
+	 * others are not read.
+	 */
+	void setSymmetry(int iSymmetry);
+
+	//! Returns the record order of the output (-1: input)
+	int getRecordOrder() const;
+
+	//! Sets the record order of the output, see DAFFWriter::setRecordOrder (-1: input, default)
+	/**
+	 * The input records are read and converted in the order of the output data.
+	 */
+	void setRecordOrder(int iRecordOrder);
+
+	//! Returns the number of worker threads (0: automatic)
+	int getNumThreads() const;
+
+	//! Sets the number of worker threads (0: automatic, 1: convert sequentially without threads)
+	void setNumThreads(int iNumThreads);
+
+	//! Converts a content into a DAFF file
+	/**
+	 * The content must be safe for concurrent reads (e.g. a loaded DAFFReader) and stay
+	 * valid during the conversion.
+	 *
+	 * \param [in] pInputContent		Input content
+	 * \param [in] sOutputFilePath	Output file path
+	 * \param [in] pMetadata			Global metadata of the output [optional, default: none]
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise (the output file is removed)
+	 */
+	int convert(const DAFFContent* pInputContent, const std::string& sOutputFilePath,
+				const DAFFMetadata* pMetadata = NULL) const;
+
+	//! Converts a DAFF file into another one (including its global metadata)
+	/**
+	 * \param [in] sInputFilePath	Input file path
+	 * \param [in] sOutputFilePath	Output file path (must differ from the input)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise (the output file is removed)
+	 */
+	int convertFile(const std::string& sInputFilePath, const std::string& sOutputFilePath) const;
+
+	//! Returns the output length of the record data of a content (see DAFFWriter::getRecordDataLength)
+	/**
+	 * @return Number of floats per channel, 0 if the content can not be converted
+	 */
+	int getOutputRecordDataLength(const DAFFContent* pInputContent) const;
+
+	//! Transforms the data of a record channel (resampling and trimming of impulse responses)
+	/**
+	 * \param [in] pInputContent	Input content
+	 * \param [in] pfInput		Data of the input channel
+	 * \param [out] pfOutput		Data of the output channel (getOutputRecordDataLength() floats)
+	 */
+	void processChannel(const DAFFContent* pInputContent, const float* pfInput, float* pfOutput) const;
+
+  private:
+	int m_iQuantization;       //!@ Output quantization (-1: input)
+	float m_fSamplerate;       //!@ Output sampling rate of impulse responses (0: input)
+	int m_iMaxFilterLength;    //!@ Maximum output filter length (0: no limit)
+	float m_fZeroThresholdDB;  //!@ Zero threshold of the effective bounds [dB]
+	bool m_bCompression;       //!@ Compress the output record data
+	int m_iDataAlignment;      //!@ Alignment of the output record channels [Bytes]
+	bool m_bDeduplication;     //!@ Store identical output record channels only once
+	bool m_bStatistics;        //!@ Embed the statistics of the output record channels
+	bool m_bDirectionIndex;    //!@ Embed the nearest neighbour index of the output record directions
+	bool m_bChecksums;         //!@ Embed the checksums of the output file blocks
+	int m_iSymmetry;           //!@ Symmetry of the output grid (-1: input)
+	int m_iRecordOrder;        //!@ Record order of the output data (-1: input)
+	int m_iNumThreads;         //!@ Number of worker threads (0: automatic)
+
+	// No copy
+	DAFFConverter(const DAFFConverter&);
+	DAFFConverter& operator=(const DAFFConverter&);
+};
+
+#endif  // IW_DAFF_CONVERTER
@@ -0,0 +1,150 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_CONVOLVER
+#define IW_DAFF_CONVOLVER
+
+#include <DAFFDefs.h>
+
+#include <atomic>
+
+// Forward declarations
+class DAFFTransformerIR2Partitioned;
+struct DAFFFFTPlanState;
+
+//! Uniformly partitioned convolution of several sources with the filters of a content
+/**
+ * The convolver renders blocks of B samples (the block length of the partitioned filters)
+ * with overlap-save: each source signal is transformed once per block into a frequency-domain
+ * delay line of getNumPartitions() spectra, which are multiplied with the filter partitions of
+ * the record of the source (DAFFTransformerIR2Partitioned::getPartitionsPtr, zero-copy). The
+ * products of all sources are accumulated per output channel in the frequency domain, so that
+ * one inverse FFT per output channel and block suffices regardless of the number of sources.
+ * The output channels are the channels of the content (e.g. two for HRIRs).
+ *
+ * A record switch of a source is crossfaded within one block: the outgoing and the incoming
+ * filters of all switching sources are accumulated into separate spectra, which are transformed
+ * back and crossfaded in the time domain (linearly or with a squared sine, see setCosineCrossfade).
+ *
+ * Records are assigned by a control thread (setSourceRecord, setSourceDirection) and take effect
+ * with the next block rendered by the audio thread (process). The audio thread methods are
+ * wait-free and neither allocate memory nor take locks. Sources without a record are silent
+ * (the first record of a source fades in like a switch).
+ *
+ * The filters must be transformed eagerly (not lazy, see DAFFTransformerIR2Partitioned::setLazy).
+ * The convolver keeps a pointer to the transformer, which must outlive it and must not be
+ * transformed again while the convolver is in use.
+ */
+class DAFF_API DAFFConvolver {
+  public:
+	//! Constructor (allocates all buffers)
+	/**
+	 * \param [in] pFilters		Partitioned filters (transformed, not lazy)
+	 * \param [in] iNumSources	Number of sources (at least one)
+	 */
+	DAFFConvolver(const DAFFTransformerIR2Partitioned* pFilters, int iNumSources);
+
+	//! Destructor
+	virtual ~DAFFConvolver();
+
+	//! Returns the partitioned filters
+	const DAFFTransformerIR2Partitioned* getFilters() const;
+
+	//! Returns the block length B [samples]
+	int getBlockLength() const;
+
+	//! Returns the number of filter partitions
+	int getNumPartitions() const;
+
+	//! Returns the number of sources
+	int getNumSources() const;
+
+	//! Returns the number of output channels
+	int getNumChannels() const;
+
+	//! Returns true if record switches are crossfaded with a squared sine instead of linearly
+	bool isCosineCrossfade() const;
+
+	//! Selects the crossfade ramp of record switches (default: linear)
+	void setCosineCrossfade(bool bCosine);
+
+	// --= Control thread =--
+
+	//! Assigns a record to a source
+	/**
+	 * \param [in] iSource		Source index
+	 * \param [in] iRecordIndex	Record index (-1: silent)
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_INVALID_INDEX on invalid sources or records
+	 */
+	int setSourceRecord(int iSource, int iRecordIndex);
+
+	//! Assigns the nearest neighbour record of a direction to a source
+	/**
+	 * \param [in] iSource		Source index
+	 * \param [in] iView			View, one of #DAFF_VIEWS
+	 * \param [in] fAngle1Deg	First angle (Phi or Alpha, depending on view)
+	 * \param [in] fAngle2Deg	Second angle (Theta or Beta, depending on view)
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_INVALID_INDEX on invalid sources
+	 */
+	int setSourceDirection(int iSource, int iView, float fAngle1Deg, float fAngle2Deg);
+
+	//! Returns the record last assigned to a source (-1: silent or invalid source)
+	int getSourceRecord(int iSource) const;
+
+	// --= Audio thread (wait-free) =--
+
+	//! Renders a block
+	/**
+	 * \param [in] ppfInputs		Input signals of the sources (getNumSources() pointers to B samples, NULL: silence)
+	 * \param [out] ppfOutputs	Output signals (getNumChannels() pointers to B samples)
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if the filters are not available
+	 */
+	int process(const float* const* ppfInputs, float* const* ppfOutputs);
+
+	//! Clears the delay lines of all sources (silence), the assigned records are kept
+	void reset();
+
+  private:
+	const DAFFTransformerIR2Partitioned* m_pFilters;  //!@ Partitioned filters
+	int m_iBlockLength;                               //!@ Block length B
+	int m_iNumPartitions;                             //!@ Number of filter partitions
+	int m_iStride;                                    //!@ Distance of the spectra [floats]
+	int m_iNumSources;                                //!@ Number of sources
+	int m_iNumChannels;                               //!@ Number of output channels
+	int m_iNumRecords;                                //!@ Number of records of the filters
+	bool m_bCosine;                                   //!@ Squared sine crossfade
+	int m_iHead;                                      //!@ Slot of the latest spectra in the delay lines
+	std::atomic<int>* m_piRequested;                  //!@ Records assigned by the control thread (per source)
+	int* m_piCurrent;                                 //!@ Records in use by the audio thread (per source)
+	float* m_pfHistory;                               //!@ Previous input block of each source [source][B]
+	float* m_pfDelayLines;                            //!@ Input spectra [source][partition slot][stride]
+	float* m_pfAccumulators;                          //!@ Output spectra [stable, outgoing, incoming][channel][stride]
+	float* m_pfWindow;                                //!@ Input window of 2B samples
+	float* m_pfTime;                                  //!@ Output of the inverse FFT, 2B samples
+	float* m_pfCrossfade;                             //!@ Outgoing output during crossfades, B samples
+	DAFFFFTPlanState* m_pForwardState;                //!@ FFT plan state (forward)
+	DAFFFFTPlanState* m_pInverseState;                //!@ FFT plan state (inverse)
+
+	//! Accumulates the product of the delay line of a source with the filters of a record
+	void accumulate(int iSource, int iRecordIndex, float* pfAccumulators) const;
+
+	//! Transforms an output spectrum back and returns the valid B samples (scaled), the spectrum is overwritten
+	const float* inverse(float* pfSpectrum);
+
+	// No copy
+	DAFFConvolver(const DAFFConvolver&);
+	DAFFConvolver& operator=(const DAFFConvolver&);
+};
+
+#endif  // IW_DAFF_CONVOLVER
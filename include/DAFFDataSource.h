@@ -0,0 +1,87 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_DATASOURCE
+#define IW_DAFF_DATASOURCE
+
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+
+//! Byte range of a batched read (see DAFFDataSource::readBatch)
+struct DAFF_API DAFFReadRequest {
+	uint64_t ui64Offset;  //!< Position relative to the beginning of the DAFF content [Bytes]
+	void* pDest;          //!< Destination buffer
+	size_t nBytes;        //!< Number of bytes to read
+};
+
+//! Byte source interface for reading DAFF content from custom storage
+/**
+ * Implement this interface to serve DAFF content from storage other than
+ * plain files or memory buffers, like asset packages, object stores with
+ * range requests or compressed containers, and pass it to DAFFReader::openSource().
+ *
+ * The reader only fetches the blocks it requires. In combination with #DAFF_OPEN_LAZY
+ * these are the headers, the record descriptors, the metadata and the data of the
+ * records that are actually accessed.
+ */
+class DAFF_API DAFFDataSource {
+  public:
+	inline virtual ~DAFFDataSource() {};
+
+	//! Returns the total size of the DAFF content [Bytes]
+	virtual uint64_t getSize() const = 0;
+
+	//! Reads bytes at an absolute position
+	/**
+	 * @param ui64Offset  Position relative to the beginning of the DAFF content [Bytes]
+	 * @param pDest       Destination buffer
+	 * @param nBytes      Number of bytes to read
+	 *
+	 * @return #DAFF_NO_ERROR if all bytes have been read, another #DAFF_ERROR otherwise
+	 */
+	virtual int read(uint64_t ui64Offset, void* pDest, size_t nBytes) = 0;
+
+	//! Reads a batch of byte ranges (optional)
+	/**
+	 * The lazy loading reads the record channels of batch fetches and prefetches this way,
+	 * sorted by offset and without overlaps. Sources with vectored or asynchronous I/O can
+	 * coalesce adjacent ranges and keep several reads in flight. The default implementation
+	 * reads the ranges one by one.
+	 *
+	 * @param pRequests  Ranges to read (ascending offsets)
+	 * @param n          Number of ranges
+	 *
+	 * @return #DAFF_NO_ERROR if all ranges have been read, another #DAFF_ERROR otherwise
+	 */
+	inline virtual int readBatch(const DAFFReadRequest* pRequests, size_t n)
+	{
+		for (size_t i = 0; i < n; i++) {
+			int iError = read(pRequests[i].ui64Offset, pRequests[i].pDest, pRequests[i].nBytes);
+			if (iError != DAFF_NO_ERROR)
+				return iError;
+		}
+		return DAFF_NO_ERROR;
+	};
+
+	//! Returns the complete DAFF content in memory, if available (optional)
+	/**
+	 * Sources that hold the whole content in memory (for instance a file mapping)
+	 * can return it here. The reader then accesses the record descriptors and the record
+	 * data in place, without copying. The memory must stay valid and unmodified while
+	 * the content is opened.
+	 *
+	 * @return Pointer to getSize() bytes, or NULL if not supported (default)
+	 */
+	inline virtual const char* map() { return NULL; };
+};
+
+#endif  // IW_DAFF_DATASOURCE
@@ -31,6 +31,7 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
 
 // Define necessary typedef from stdint.h for Microsoft compilers before Visual C++ 2010
 #if _MSC_VER < 1600
@@ -72,9 +73,12 @@ enum DAFF_CONTENT_TYPES {
 
 //! Quantization modes
 enum DAFF_QUANTIZATIONS {
-	DAFF_INT16 = 0,    //!< 16-Bit signed integer
-	DAFF_INT24 = 1,    //!< 24-Bit signed integer
-	DAFF_FLOAT32 = 2,  //!< 32-Bit floating point
+	DAFF_INT16 = 0,      //!< 16-Bit signed integer
+	DAFF_INT24 = 1,      //!< 24-Bit signed integer
+	DAFF_FLOAT32 = 2,    //!< 32-Bit floating point
+	DAFF_FLOAT16 = 3,    //!< 16-Bit floating point (IEEE 754 half precision)
+	DAFF_BFLOAT16 = 4,   //!< 16-Bit floating point (bfloat16, upper half of a 32-Bit float)
+	DAFF_INT16_BFP = 5,  //!< 16-Bit signed integer with a scale per record channel (block floating point, IR only)
 };
 
 
@@ -85,6 +89,57 @@ enum DAFF_VIEWS {
 };
 
 
+//! Flags for opening DAFF files (may be combined using bitwise or)
+enum DAFF_OPEN_FLAGS {
+	DAFF_OPEN_DEFAULT = 0,   //!< Read the whole file into memory
+	DAFF_OPEN_MAPPED = 1,    //!< Memory-map the file instead of reading it (page cache is shared among processes)
+	DAFF_OPEN_LAZY = 2,      //!< Load record data on demand into a bounded cache (ignored if mapped)
+	DAFF_OPEN_DECODE = 4,    //!< Convert integer impulse responses into floats once at load (ignored if lazy)
+	DAFF_OPEN_TRUNCATE = 8,  //!< Trim impulse response tails below the truncation threshold at load (ignored if lazy)
+	DAFF_OPEN_VERIFY = 16,   //!< Verify the checksums of the loaded file blocks (lazily loaded data on first access)
+	DAFF_OPEN_SLICES = 32,   //!< Keep a frequency-major copy of spectra for frequency slices (built on first access)
+	DAFF_OPEN_STREAM = 64,   //!< Stream the record data level by level in the background (implies lazy)
+	DAFF_OPEN_NUMA = 128,    //!< DAFFContentCache: one replica per NUMA node, handed to the threads of the node
+};
+
+
+//! Symmetries of regular grids covering the full alpha range (only the unique records are stored)
+enum DAFF_SYMMETRIES {
+	DAFF_SYMMETRY_NONE = 0,    //!< All records are stored
+	DAFF_SYMMETRY_AXIAL = 1,   //!< Rotational symmetry around the pole axis, the meridian alpha = 0 is stored
+	DAFF_SYMMETRY_MIRROR = 2,  //!< Mirror symmetry at the plane alpha = 0/180 with reversed channel order,
+							   //!< the records with alpha in [0, 180] are stored
+};
+
+
+//! Orders of the record data within the data block (see DAFFWriter::setRecordOrder)
+enum DAFF_RECORD_ORDERS {
+	DAFF_RECORD_ORDER_INDEX = 0,    //!< Order of the record indices (beta-major on regular grids)
+	DAFF_RECORD_ORDER_MORTON = 1,   //!< Morton curve (Z-order) over the record directions (data view)
+	DAFF_RECORD_ORDER_HILBERT = 2,  //!< Hilbert curve over the record directions (data view)
+};
+
+
+//! Angular regions of the records loaded by a reader (see DAFFReader::setRegion)
+enum DAFF_REGIONS {
+	DAFF_REGION_ALL = 0,         //!< All records
+	DAFF_REGION_BETA_RANGE = 1,  //!< Records with a beta angle in a range (data view), e.g. a hemisphere
+	DAFF_REGION_CONE = 2,        //!< Records within an angle around a direction (object view)
+	DAFF_REGION_RECORDS = 3,     //!< Records of a list of record indices
+};
+
+
+//! Comparison operators of record selections by metadata values (see DAFFReader::selectRecords)
+enum DAFF_COMPARISONS {
+	DAFF_EQ = 0,  //!< Equal to the value
+	DAFF_NE = 1,  //!< Not equal to the value
+	DAFF_LT = 2,  //!< Less than the value
+	DAFF_LE = 3,  //!< Less than or equal to the value
+	DAFF_GT = 4,  //!< Greater than the value
+	DAFF_GE = 5,  //!< Greater than or equal to the value
+};
+
+
 //! Errorcodes
 enum DAFF_ERROR {
 	DAFF_NO_ERROR = 0,  //!< No error = 0
@@ -103,6 +158,10 @@ enum DAFF_ERROR {
 	DAFF_FILE_UNKOWN_METADATA_TYPE,        //!< Given metadata type is unknown, use bool, int, double, string
 	DAFF_FILE_CORRUPTED,                   //!< Data reading error of an otherwise valid DAFF file
 	DAFF_INVALID_INDEX,                    //!< Invalid index (e.g. record index)
+	DAFF_FILE_CHECKSUM_MISMATCH,           //!< File block does not match its checksum (#DAFF_OPEN_VERIFY)
+	DAFF_OPEN_CANCELLED,                   //!< Asynchronous opening cancelled (see DAFFReader::cancelOpen())
+	DAFF_DEVICE_ERROR,                     //!< GPU device error (allocation, transfer or kernel launch)
+	DAFF_FETCH_CANCELLED,                  //!< Asynchronous fetch cancelled (see DAFFAsyncFetcher::cancelAll())
 };
 
 
@@ -123,6 +182,88 @@ struct DAFF_API DAFFQuad {
 };
 
 
+//! Pure data class with statistics of the data of a record channel
+/**
+ * For impulse responses the values refer to the full filter (including leading zeros),
+ * for magnitude spectra to the magnitudes at all support frequencies.
+ */
+struct DAFF_API DAFFRecordStatistics {
+	float fPeak;    //!< Greatest absolute value
+	float fEnergy;  //!< Sum of the squared values
+	float fRMS;     //!< Root mean square value
+	int iOnset;     //!< Index of the first value that reaches 10% of the peak (-20 dB), -1 if all values are zero
+};
+
+
+//! Pure data class with the wall times and sizes of the load phases of a reader
+/**
+ * Filled by DAFFReader::openFile, DAFFReader::openSource and DAFFReader::deserialize and
+ * delivered by DAFFReader::getLoadStats. Sizes are the sizes of the file blocks processed
+ * in a phase, also if they are accessed in place (see bBorrowed) and not copied.
+ */
+struct DAFF_API DAFFLoadStats {
+	double dOpenTime;                    //!< Opening (and mapping) the file [s]
+	double dHeaderTime;                  //!< File header, file block table, main and content header [s]
+	double dRecordDescriptorTime;        //!< Record descriptor block including the endianness conversion [s]
+	double dRecordDataTime;              //!< Record data block including decompression and endianness conversion [s]
+	double dMetadataTime;                //!< Metadata block [s]
+	double dAuxiliaryTime;               //!< Optional statistics, record directions and symmetry blocks [s]
+	double dGridTime;                    //!< Verification of the angle ranges [s]
+	double dDecodeTime;                  //!< Conversion of the record data to floats (#DAFF_OPEN_DECODE) [s]
+	double dTruncateTime;                //!< Truncation of the impulse responses (#DAFF_OPEN_TRUNCATE) [s]
+	double dTotalTime;                   //!< Whole call [s]
+	uint64_t ui64HeaderBytes;            //!< Size of the headers and the file block table [Bytes]
+	uint64_t ui64RecordDescriptorBytes;  //!< Size of the record descriptor block [Bytes]
+	uint64_t ui64RecordDataBytes;        //!< Size of the record data block (0: loaded on demand) [Bytes]
+	uint64_t ui64MetadataBytes;          //!< Size of the metadata block [Bytes]
+	uint64_t ui64AuxiliaryBytes;         //!< Size of the optional blocks [Bytes]
+	bool bBorrowed;                      //!< Record descriptors and data are accessed in place (mapped or borrowed)
+
+	inline DAFFLoadStats()
+		: dOpenTime(0), dHeaderTime(0), dRecordDescriptorTime(0), dRecordDataTime(0), dMetadataTime(0),
+		  dAuxiliaryTime(0), dGridTime(0), dDecodeTime(0), dTruncateTime(0), dTotalTime(0), ui64HeaderBytes(0),
+		  ui64RecordDescriptorBytes(0), ui64RecordDataBytes(0), ui64MetadataBytes(0), ui64AuxiliaryBytes(0),
+		  bBorrowed(false) {};
+};
+
+//! Data class for the memory footprint of a reader
+/**
+ * Heap memory owned by the reader, broken down by category. Memory that is accessed in
+ * place (file mappings and borrowed buffers) is reported separately and not part of the total.
+ */
+struct DAFF_API DAFFMemoryFootprint {
+	uint64_t ui64Headers;            //!< File block table, main and content header, frequency list [Bytes]
+	uint64_t ui64RecordDescriptors;  //!< Record descriptors, payload indices, record directions and their index [Bytes]
+	uint64_t ui64RecordData;         //!< Record data block and the decoded float arena (#DAFF_OPEN_DECODE) [Bytes]
+	uint64_t ui64RecordCache;        //!< Record cache and chunk buffer of the lazy loading (#DAFF_OPEN_LAZY) [Bytes]
+	uint64_t ui64Metadata;           //!< Metadata block and sets [Bytes]
+	uint64_t ui64Statistics;         //!< Record statistics and peak values [Bytes]
+	uint64_t ui64Total;              //!< Sum of the categories above [Bytes]
+	uint64_t ui64Mapped;             //!< Accessed in place, not owned (mapped or borrowed) [Bytes]
+
+	inline DAFFMemoryFootprint()
+		: ui64Headers(0), ui64RecordDescriptors(0), ui64RecordData(0), ui64RecordCache(0), ui64Metadata(0),
+		  ui64Statistics(0), ui64Total(0), ui64Mapped(0) {};
+};
+
+//! Data class for the angular region of the records loaded by a reader
+/**
+ * Only the members of the region type are used. Boundaries are inclusive.
+ */
+struct DAFF_API DAFFRegion {
+	int iType;                   //!< Region type, one of #DAFF_REGIONS
+	float fBetaStart;            //!< Lowest beta angle of #DAFF_REGION_BETA_RANGE (data view) [degrees]
+	float fBetaEnd;              //!< Highest beta angle of #DAFF_REGION_BETA_RANGE (data view) [degrees]
+	float fConeAzimuth;          //!< Azimuth angle of the axis of #DAFF_REGION_CONE (object view) [degrees]
+	float fConeElevation;        //!< Elevation angle of the axis of #DAFF_REGION_CONE (object view) [degrees]
+	float fConeAngle;            //!< Great-circle distance from the axis to the boundary of the cone [degrees]
+	std::vector<int> viRecords;  //!< Record indices of #DAFF_REGION_RECORDS (in any order)
+
+	inline DAFFRegion()
+		: iType(DAFF_REGION_ALL), fBetaStart(0), fBetaEnd(180), fConeAzimuth(0), fConeElevation(0),
+		  fConeAngle(180) {};
+};
+
 //! Data class for orientations in yaw-pitch-roll (YPR) angles (right-handed OpenGL coordinate system)
 /**
  * Yaw Pitch Roll angles define Euler angles using the OpenGL right-handed Cartesian coordinate system.
@@ -0,0 +1,110 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_DIRECTIONLUT
+#define IW_DAFF_DIRECTIONLUT
+
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+#include <vector>
+
+// Forward declarations
+class DAFFContent;
+class DAFFView;
+
+//! Precomputed direction to record lookup table
+/**
+ * The table holds the nearest neighbour record (DAFFContent::getNearestNeighbour) for
+ * the nodes of a regular angular grid with the given step size. A lookup rounds the
+ * direction to the closest node and reads its record index, without any trigonometry
+ * or grid search. Results equal those of getNearestNeighbour, except for directions
+ * closer than half a step to the border between two records.
+ *
+ * A table is built for one view. Object view tables include the orientation at the time
+ * of construction (of the reader or of a DAFFView) and must be rebuilt after the
+ * orientation changed. Memory: (360/step) x (180/step + 1) x 4 bytes (260 KB for 1&deg;).
+ *
+ * The table keeps no pointer to the content. Lookups are const and can run concurrently.
+ */
+class DAFF_API DAFFDirectionLUT {
+  public:
+	//! Constructor
+	/**
+	 * \param [in] pContent			Content
+	 * \param [in] iView				View of the directions, one of #DAFF_VIEWS (object view: reader orientation)
+	 * \param [in] fResolutionDeg	Step size of the table [degrees] (reduced to split the ranges evenly)
+	 */
+	DAFFDirectionLUT(const DAFFContent* pContent, int iView = DAFF_DATA_VIEW, float fResolutionDeg = 1.0f);
+
+	//! Constructor for the object view of a view (with its current orientation)
+	/**
+	 * \param [in] pView				View
+	 * \param [in] fResolutionDeg	Step size of the table [degrees] (reduced to split the ranges evenly)
+	 */
+	DAFFDirectionLUT(const DAFFView* pView, float fResolutionDeg = 1.0f);
+
+	//! Returns the view of the directions, one of #DAFF_VIEWS
+	int getView() const;
+
+	//! Returns the actual step size [degrees] of the first and second angle
+	void getResolution(float& fAngle1ResolutionDeg, float& fAngle2ResolutionDeg) const;
+
+	//! Returns the nearest neighbour record of a direction
+	/**
+	 * \param [in] fAngle1Deg	First angle (Phi or Alpha, depending on view)
+	 * \param [in] fAngle2Deg	Second angle (Theta or Beta, depending on view)
+	 *
+	 * @return Record index
+	 */
+	int lookup(float fAngle1Deg, float fAngle2Deg) const;
+
+	//! Returns the nearest neighbour record of a direction and whether it is out of bounds
+	/**
+	 * \param [in] fAngle1Deg		First angle (Phi or Alpha, depending on view)
+	 * \param [in] fAngle2Deg		Second angle (Theta or Beta, depending on view)
+	 * \param [out] bOutOfBounds	Indicator if the direction is out of bounds
+	 *
+	 * @return Record index
+	 */
+	int lookup(float fAngle1Deg, float fAngle2Deg, bool& bOutOfBounds) const;
+
+	//! Determines the nearest neighbour records of many directions at once
+	/**
+	 * \param [in] pfAngles1Deg		First angles (Phi or Alpha, depending on view), n elements
+	 * \param [in] pfAngles2Deg		Second angles (Theta or Beta, depending on view), n elements
+	 * \param [out] piRecordIndices	Record indices, n elements
+	 * \param [out] pbOutOfBounds	Out of bounds indicators, n elements (may be NULL)
+	 * \param [in] n					Number of directions
+	 */
+	void lookup(const float* pfAngles1Deg, const float* pfAngles2Deg, int* piRecordIndices, bool* pbOutOfBounds,
+				size_t n) const;
+
+  private:
+	int m_iView;                 //!@ View of the directions
+	int m_iNumPoints1;           //!@ Number of nodes of the first angle (full circle, no duplicate at 360&deg;)
+	int m_iNumPoints2;           //!@ Number of nodes of the second angle (including both poles)
+	float m_fOffset1;            //!@ Offset that maps the first angle onto [0&deg;, 360&deg;]
+	float m_fOffset2;            //!@ Offset that maps the second angle onto [0&deg;, 180&deg;]
+	float m_fResolution1;        //!@ Step size of the first angle [degrees]
+	float m_fResolution2;        //!@ Step size of the second angle [degrees]
+	float m_fInvResolution1;     //!@ Reciprocal step size of the first angle [1/degrees]
+	float m_fInvResolution2;     //!@ Reciprocal step size of the second angle [1/degrees]
+	std::vector<int> m_viTable;  //!@ Record index per node, out of bounds nodes are stored as -(index+1)
+
+	//! Fills the table
+	void init(const DAFFContent* pContent, const DAFFView* pView, int iView, float fResolutionDeg);
+
+	//! Returns the table entry of a direction
+	int getEntry(float fAngle1Deg, float fAngle2Deg) const;
+};
+
+#endif  // IW_DAFF_DIRECTIONLUT
@@ -0,0 +1,185 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_DIRECTIVITY_ANALYZER
+#define IW_DAFF_DIRECTIVITY_ANALYZER
+
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+#include <vector>
+
+// Forward declarations
+class DAFFContent;
+class DAFFContentDFT;
+class DAFFContentMPS;
+class DAFFContentMS;
+
+//! Piece of an iso-level contour between two directions (data view)
+struct DAFF_API DAFFContourSegment {
+	float fAlpha1Deg;  //!< Alpha angle of the first end point [degrees]
+	float fBeta1Deg;   //!< Beta angle of the first end point [degrees]
+	float fAlpha2Deg;  //!< Alpha angle of the second end point [degrees]
+	float fBeta2Deg;   //!< Beta angle of the second end point [degrees]
+};
+
+//! Search for extrema and iso-level contours of directivity patterns
+/**
+ * The analyzer answers questions like "which direction has the maximum level at 2 kHz" or
+ * "where is the -6 dB contour" for all records at once. It works on the cross-record slices
+ * of the content (DAFFContentMS::getMagnitudeSlice, DAFFContentMPS::getMagnitudeSlice,
+ * DAFFContentDFT::getDFTCoeffSlice), one slice per frequency, which are copied from the
+ * frequency-major copy of the reader with #DAFF_OPEN_SLICES. The levels are the magnitudes,
+ * for DFT content the magnitudes of the stored coefficients. Impulse responses are analyzed
+ * through a transformer, e.g. DAFFTransformerIR2MS.
+ *
+ * The frequencies of a query are distributed over several threads (setNumThreads()), each
+ * reads its slices once and scans them with SIMD kernels. The methods are const and can run
+ * concurrently.
+ *
+ * Contours are extracted with marching squares on regular grids, in the grid cells between
+ * neighbouring alpha and beta points (closed across alpha = 0 if the alpha points cover the
+ * full circle). The crossing points are interpolated linearly in decibels along the cell
+ * edges, ambiguous cells are resolved by the mean level of their corners. Irregular grids
+ * (and regions, see DAFFReader::setRegion) have no cells and no contours.
+ *
+ * The analyzer keeps a pointer to the content, which must outlive it.
+ */
+class DAFF_API DAFFDirectivityAnalyzer {
+  public:
+	//! Constructor
+	/**
+	 * \param [in] pContent	Content to analyze (MS, MPS or DFT)
+	 */
+	DAFFDirectivityAnalyzer(const DAFFContent* pContent);
+
+	//! Destructor
+	virtual ~DAFFDirectivityAnalyzer();
+
+	//! Returns the content
+	const DAFFContent* getContent() const;
+
+	//! Returns the number of frequencies (getNumDFTCoeffs() for DFT content, 0 for unsupported content)
+	int getDataLength() const;
+
+	//! Returns the number of worker threads (0: automatic)
+	int getNumThreads() const;
+
+	//! Sets the number of worker threads
+	/**
+	 * \param iNumThreads	Number of threads (0: automatic, 1: no worker threads)
+	 */
+	void setNumThreads(int iNumThreads);
+
+	//! Finds the records with the greatest and the smallest magnitude of a channel at a frequency
+	/**
+	 * Ties are resolved by the smallest record index.
+	 *
+	 * \param [in] iChannel		Channel index
+	 * \param [in] iFreqIndex	Frequency index (DFT coefficient index for DFT content)
+	 * \param [out] iMaxRecord	Record index of the greatest magnitude
+	 * \param [out] fMax			Greatest magnitude (factor)
+	 * \param [out] iMinRecord	Record index of the smallest magnitude
+	 * \param [out] fMin			Smallest magnitude (factor)
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR for unsupported content types, another #DAFF_ERROR otherwise
+	 */
+	int getExtremum(int iChannel, int iFreqIndex, int& iMaxRecord, float& fMax, int& iMinRecord, float& fMin) const;
+
+	//! Finds the records with the greatest and the smallest magnitude of a channel at all frequencies
+	/**
+	 * Like getExtremum() for every frequency in a single parallel pass. All arrays have
+	 * getDataLength() elements, any of them may be NULL.
+	 *
+	 * \param [in] iChannel			Channel index
+	 * \param [out] piMaxRecords		Record indices of the greatest magnitudes (or NULL)
+	 * \param [out] pfMaxValues		Greatest magnitudes (or NULL)
+	 * \param [out] piMinRecords		Record indices of the smallest magnitudes (or NULL)
+	 * \param [out] pfMinValues		Smallest magnitudes (or NULL)
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR for unsupported content types, another #DAFF_ERROR otherwise
+	 */
+	int getExtrema(int iChannel, int* piMaxRecords, float* pfMaxValues, int* piMinRecords, float* pfMinValues) const;
+
+	//! Extracts the iso-level contour of a channel at a frequency
+	/**
+	 * Absolute levels are 20 log10 of the magnitudes, relative levels refer to the greatest
+	 * magnitude of all records.
+	 *
+	 * \param [in] iChannel		Channel index
+	 * \param [in] iFreqIndex	Frequency index (DFT coefficient index for DFT content)
+	 * \param [in] fLevelDB		Level of the contour [dB], e.g. -6
+	 * \param [in] bRelative		Level relative to the greatest magnitude at the frequency? (otherwise absolute)
+	 * \param [out] vSegments	Segments of the contour (unordered)
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR for unsupported content types or irregular grids,
+	 *		   another #DAFF_ERROR otherwise
+	 */
+	int getContour(int iChannel, int iFreqIndex, float fLevelDB, bool bRelative,
+				   std::vector<DAFFContourSegment>& vSegments) const;
+
+	//! Extracts the iso-level contours of a channel at several frequencies
+	/**
+	 * Like getContour() for every frequency in a single parallel pass. The segments of the
+	 * i-th frequency are vSegments[viOffsets[i]] to vSegments[viOffsets[i + 1] - 1], viOffsets
+	 * has iNumFreqs + 1 elements.
+	 *
+	 * \param [in] iChannel			Channel index
+	 * \param [in] piFreqIndices		Frequency indices
+	 * \param [in] iNumFreqs			Number of frequencies
+	 * \param [in] fLevelDB			Level of the contours [dB]
+	 * \param [in] bRelative			Level relative to the greatest magnitude at each frequency?
+	 * \param [out] vSegments		Segments of all contours
+	 * \param [out] viOffsets		Offsets of the contours in the segments
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR for unsupported content types or irregular grids,
+	 *		   another #DAFF_ERROR otherwise
+	 */
+	int getContours(int iChannel, const int* piFreqIndices, int iNumFreqs, float fLevelDB, bool bRelative,
+					std::vector<DAFFContourSegment>& vSegments, std::vector<int>& viOffsets) const;
+
+	//! Returns the heap memory held by the analyzer [Bytes]
+	size_t getMemoryFootprint() const;
+
+  private:
+	const DAFFContent* m_pContent;        //!@ Content
+	const DAFFContentMS* m_pContentMS;    //!@ Content as magnitude spectra (or NULL)
+	const DAFFContentMPS* m_pContentMPS;  //!@ Content as magnitude-phase spectra (or NULL)
+	const DAFFContentDFT* m_pContentDFT;  //!@ Content as DFT spectra (or NULL)
+	int m_iNumThreads;                    //!@ Number of worker threads (0: automatic)
+	int m_iAlphaPoints;                   //!@ Alpha points of the regular grid (0: irregular grid)
+	int m_iBetaPoints;                    //!@ Beta points of the regular grid
+	bool m_bAlphaWrap;                    //!@ The alpha points cover the full circle (cells across alpha = 0)
+	std::vector<int> m_viGridRecords;     //!@ Record indices of the grid points (index beta * alpha points + alpha)
+
+	//! Energies of the records (squared magnitudes) of a channel at a frequency (pfScratch: 2 * records floats)
+	int getEnergySlice(int iChannel, int iFreqIndex, float* pfEnergies, float* pfScratch) const;
+
+	//! Returns the number of threads for iNumFreqs frequencies
+	int getThreadCount(int iNumFreqs) const;
+
+	//! Determines the extrema of the frequencies [iBegin, iEnd)
+	void scanExtrema(int iChannel, int iBegin, int iEnd, int* piMaxRecords, float* pfMaxValues, int* piMinRecords,
+					 float* pfMinValues, int* piError) const;
+
+	//! Extracts the contours of the frequencies piFreqIndices[iBegin, iEnd) (one segment list each)
+	void scanContours(int iChannel, const int* piFreqIndices, int iBegin, int iEnd, float fLevelDB, bool bRelative,
+					  std::vector<std::vector<DAFFContourSegment> >* pvvSegments, int* piError) const;
+
+	//! Runs marching squares on the energies of all records
+	void marchSquares(const float* pfEnergies, float fThresholdDB, std::vector<DAFFContourSegment>& vSegments) const;
+
+	// No copy
+	DAFFDirectivityAnalyzer(const DAFFDirectivityAnalyzer&);
+	DAFFDirectivityAnalyzer& operator=(const DAFFDirectivityAnalyzer&);
+};
+
+#endif  // IW_DAFF_DIRECTIVITY_ANALYZER
@@ -0,0 +1,123 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_DISTANCE_SET
+#define IW_DAFF_DISTANCE_SET
+
+#include <DAFFDefs.h>
+#include <DAFFInterpolator.h>
+
+#include <vector>
+
+// Forward declarations
+class DAFFContent;
+class DAFFContentDFT;
+class DAFFContentIR;
+class DAFFContentMS;
+
+//! Set of contents at several distances (e.g. near-field HRTFs) with radial interpolation
+/**
+ * The set groups contents of the same type and dimensions that were measured at different
+ * radii and interpolates their data trilinearly: bilinearly on the grid of the two contents
+ * whose radii enclose the requested distance (see DAFFInterpolator), and linearly in the radius
+ * between them. Distances outside the range of the set are clamped to the closest radius.
+ *
+ * Contents with the same grid share the angular lookup: the cell and its weights are determined
+ * once for both radii. All (up to eight) records are accumulated with their combined weights
+ * into the destination in a single pass, every distinct record exactly once.
+ *
+ * Impulse responses (IR), magnitude spectra (MS) and DFT spectra (DFT) on regular grids are
+ * supported. The set keeps pointers to the contents, which must outlive it.
+ */
+class DAFF_API DAFFDistanceSet {
+  public:
+	//! Default constructor (empty set)
+	DAFFDistanceSet();
+
+	//! Destructor
+	virtual ~DAFFDistanceSet();
+
+	//! Adds a content at a radius
+	/**
+	 * \param [in] pContent	Content (IR, MS or DFT on a regular grid, same type and dimensions as the others)
+	 * \param [in] fRadius	Radius of the measurement [m] (> 0, distinct from the others)
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR on unsupported or mismatching contents or radii
+	 */
+	int addContent(const DAFFContent* pContent, float fRadius);
+
+	//! Removes all contents (empty set)
+	void clear();
+
+	//! Returns the number of distances
+	int getNumDistances() const;
+
+	//! Returns the radius of a distance [m] (ascending order, 0 on invalid indices)
+	float getRadius(int iDistance) const;
+
+	//! Returns the content of a distance (ascending order of the radii, NULL on invalid indices)
+	const DAFFContent* getContent(int iDistance) const;
+
+	//! Returns the number of float values per channel written by interpolate() (see DAFFInterpolator::getDataLength)
+	int getDataLength() const;
+
+	//! Determines the records and weights of the trilinear interpolation
+	/**
+	 * \param [in] iView				View, one of #DAFF_VIEWS
+	 * \param [in] fAngle1Deg		First angle (Phi or Alpha, depending on view)
+	 * \param [in] fAngle2Deg		Second angle (Theta or Beta, depending on view)
+	 * \param [in] fDistance			Distance [m]
+	 * \param [out] piDistances		Distance indices of the lower and upper radius (2 elements, equal if clamped)
+	 * \param [out] pqIndices		Cells of the lower and upper radius (2 elements)
+	 * \param [out] pfWeights		Weights of the records of both cells (8 elements, sum 1)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int getWeights(int iView, float fAngle1Deg, float fAngle2Deg, float fDistance, int* piDistances,
+				   DAFFQuad* pqIndices, float* pfWeights) const;
+
+	//! Interpolates the data of a channel for a direction and a distance
+	/**
+	 * \param [in] iView			View, one of #DAFF_VIEWS
+	 * \param [in] fAngle1Deg	First angle (Phi or Alpha, depending on view)
+	 * \param [in] fAngle2Deg	Second angle (Theta or Beta, depending on view)
+	 * \param [in] fDistance		Distance [m]
+	 * \param [in] iChannel		Channel index
+	 * \param [out] pfDest		Destination buffer (size >= getDataLength())
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int interpolate(int iView, float fAngle1Deg, float fAngle2Deg, float fDistance, int iChannel,
+					float* pfDest) const;
+
+  private:
+	//! Content at a radius
+	struct DistanceEntry {
+		float fRadius;                      //!@ Radius [m]
+		const DAFFContent* pContent;        //!@ Content
+		const DAFFContentIR* pContentIR;    //!@ Content as impulse responses (or NULL)
+		const DAFFContentMS* pContentMS;    //!@ Content as magnitude spectra (or NULL)
+		const DAFFContentDFT* pContentDFT;  //!@ Content as DFT spectra (or NULL)
+		int iLookup;                        //!@ Index of the angular lookup (shared by equal grids)
+	};
+
+	std::vector<DistanceEntry> m_vDistances;     //!@ Contents in ascending order of the radii
+	std::vector<DAFFInterpolator*> m_vpLookups;  //!@ Angular lookups of the distinct grids
+
+	//! Returns true if two contents have the same grid
+	static bool hasSameGrid(const DAFFContent* pContent1, const DAFFContent* pContent2);
+
+	// No copy
+	DAFFDistanceSet(const DAFFDistanceSet&);
+	DAFFDistanceSet& operator=(const DAFFDistanceSet&);
+};
+
+#endif  // IW_DAFF_DISTANCE_SET
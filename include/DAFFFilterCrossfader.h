@@ -0,0 +1,147 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_FILTERCROSSFADER
+#define IW_DAFF_FILTERCROSSFADER
+
+#include <DAFFDefs.h>
+
+// Forward declarations
+class DAFFContent;
+class DAFFContentDFT;
+class DAFFContentIR;
+class DAFFContentMS;
+
+//! Crossfade ramp shapes
+enum {
+	DAFF_CROSSFADE_LINEAR = 0,  //!< Linear ramp (constant amplitude sum, for correlated signals)
+	DAFF_CROSSFADE_COSINE,      //!< Squared sine ramp (smooth start and end)
+};
+
+//! Blending of records for filter switches of moving sources
+/**
+ * A direction change switches the filter of a source from one record to another,
+ * which causes clicks without a crossfade. The crossfader blends the data of the
+ * previous and the next record, or of the records of a grid cell with their weights
+ * (DAFFContent::getCell, DAFFInterpolator::getWeights), into a destination buffer.
+ * Supported are impulse responses (IR), magnitude spectra (MS) and DFT spectra (DFT),
+ * with the data layout of DAFFInterpolator::getDataLength.
+ *
+ * If the records are kept in memory, the crossfader reads them through their zero-copy
+ * pointers (e.g. DAFFContentIR::getEffectiveFilterCoeffsPtr) and computes the weighted
+ * sum of all records in a single SIMD pass over the destination. Otherwise (lazy loading,
+ * sample type conversion, transformed contents) the records are accumulated with the add
+ * methods of the content, like in DAFFInterpolator. Both give the same results.
+ *
+ * The crossfader has no state besides the content, which must outlive it. All methods
+ * are const and may be called from several threads.
+ */
+class DAFF_API DAFFFilterCrossfader {
+  public:
+	//! Constructor
+	/**
+	 * \param [in] pContent	Content (IR, MS or DFT)
+	 */
+	DAFFFilterCrossfader(const DAFFContent* pContent);
+
+	//! Destructor
+	virtual ~DAFFFilterCrossfader();
+
+	//! Returns the content
+	const DAFFContent* getContent() const;
+
+	//! Returns the number of float values per channel (see DAFFInterpolator::getDataLength)
+	int getDataLength() const;
+
+	//! Indicates whether records are blended in a single pass over their zero-copy pointers
+	/**
+	 * Only for contents of readers that keep the record data in memory (no #DAFF_OPEN_LAZY).
+	 * Impulse responses additionally require #DAFF_FLOAT32 quantization, #DAFF_OPEN_DECODE or #DAFF_OPEN_TRUNCATE.
+	 */
+	bool isZeroCopy() const;
+
+	//! Blends the data of two records, dest = (1 - fMix) * previous + fMix * next
+	/**
+	 * \param [in] iPrevRecordIndex	Record index of the previous filter
+	 * \param [in] iNextRecordIndex	Record index of the next filter
+	 * \param [in] fMix				Weight of the next filter (0: previous, 1: next)
+	 * \param [in] iChannel			Channel index
+	 * \param [out] pfDest			Destination buffer (size >= getDataLength())
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int blend(int iPrevRecordIndex, int iNextRecordIndex, float fMix, int iChannel, float* pfDest) const;
+
+	//! Blends the data of four records with weights (e.g. of DAFFInterpolator::getWeights)
+	/**
+	 * \param [in] qIndices		Record indices of a grid cell
+	 * \param [in] pfWeights		Weights of the four records
+	 * \param [in] iChannel		Channel index
+	 * \param [out] pfDest		Destination buffer (size >= getDataLength())
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int blend(const DAFFQuad& qIndices, const float* pfWeights, int iChannel, float* pfDest) const;
+
+	//! Blends the data of any number of records with weights
+	/**
+	 * Coinciding record indices are read once with the sum of their weights, records
+	 * with zero weight are not read at all.
+	 *
+	 * \param [in] piRecordIndices	Record indices
+	 * \param [in] pfWeights			Weights of the records
+	 * \param [in] iNumRecords		Number of records
+	 * \param [in] iChannel			Channel index
+	 * \param [out] pfDest			Destination buffer (size >= getDataLength())
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int blend(const int* piRecordIndices, const float* pfWeights, int iNumRecords, int iChannel,
+			  float* pfDest) const;
+
+	//! Crossfades two signals over a block, e.g. the outputs of the previous and the next filter
+	/**
+	 * dest[n] = old[n] + w(n / iLength) * (new[n] - old[n]), where w rises from 0 at the first
+	 * sample towards 1 at the end of the block. The destination may be one of the inputs.
+	 *
+	 * \param [in] pfOld		Signal of the previous filter
+	 * \param [in] pfNew		Signal of the next filter
+	 * \param [out] pfDest	Destination
+	 * \param [in] iLength	Number of samples
+	 * \param [in] iShape	Ramp shape, one of DAFF_CROSSFADE_* [optional, default: linear]
+	 */
+	static void crossfade(const float* pfOld, const float* pfNew, float* pfDest, int iLength,
+						  int iShape = DAFF_CROSSFADE_LINEAR);
+
+  private:
+	//! Maximum number of records blended in a single pass
+	enum { MAX_FUSED_RECORDS = 8 };
+
+	const DAFFContent* m_pContent;        //!@ Content
+	const DAFFContentIR* m_pContentIR;    //!@ Content as impulse responses (or NULL)
+	const DAFFContentMS* m_pContentMS;    //!@ Content as magnitude spectra (or NULL)
+	const DAFFContentDFT* m_pContentDFT;  //!@ Content as DFT spectra (or NULL)
+	bool m_bZeroCopy;                     //!@ Zero-copy pointers stay valid
+
+	//! Blends distinct records with non-zero weights in a single pass (false: a pointer is not available)
+	bool blendZeroCopy(const int* piRecordIndices, const float* pfWeights, int iNumRecords, int iChannel,
+					   float* pfDest) const;
+
+	//! Accumulates distinct records with non-zero weights using the add methods of the content
+	int blendAdd(const int* piRecordIndices, const float* pfWeights, int iNumRecords, int iChannel,
+				 float* pfDest) const;
+
+	// No copy
+	DAFFFilterCrossfader(const DAFFFilterCrossfader&);
+	DAFFFilterCrossfader& operator=(const DAFFFilterCrossfader&);
+};
+
+#endif  // IW_DAFF_FILTERCROSSFADER
@@ -0,0 +1,362 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_GPU
+#define IW_DAFF_GPU
+
+#include <DAFFDefs.h>
+
+#include <math.h>
+
+/*
+ * Direction lookup on GPUs
+ *
+ * This header has no dependencies besides the C math library and can be compiled by
+ * CUDA (nvcc), HIP (hipcc) and host compilers. All functions are host and device functions
+ * on the plain data structures DAFFGPUGrid and DAFFGPUContent, which are filled on the host
+ * by DAFFGPUTable and are passed to kernels by value. Custom kernels (e.g. of a ray tracer)
+ * can thus call the lookups directly, DAFFCUDAContent provides ready-made batch kernels.
+ *
+ * The functions reproduce the operations of the reader step by step: DAFFContent::getNearestNeighbour,
+ * DAFFContent::getCell and DAFFInterpolator::getWeights / interpolate. Their results are identical,
+ * provided that the device evaluates the double precision trigonometry of the object view transform
+ * like the host libm (CUDA: within 1-2 ulp, which only matters for directions on cell borders) and that
+ * the compiler does not contract multiplications and additions (nvcc --fmad=false).
+ */
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+#define DAFF_GPU_FUNC __host__ __device__ inline
+#else
+#define DAFF_GPU_FUNC inline
+#endif
+
+// Constants of the reader (DAFF::PI_F and DAFF::PI_D, as macros for device code)
+#define DAFF_GPU_PI_F 3.14159265358979323846f
+#define DAFF_GPU_PI_D 3.14159265358979323846
+
+//! Regular grid of a content for GPU lookups (plain data)
+struct DAFFGPUGrid {
+	int iNumRecords;         //!< Number of records
+	int iNumChannels;        //!< Number of channels
+	int iAlphaPoints;        //!< Number of alpha points
+	float fAlphaStart;       //!< Alpha start angle [degrees]
+	float fAlphaEnd;         //!< Alpha end angle [degrees]
+	float fAlphaSpan;        //!< Alpha span [degrees]
+	float fAlphaResolution;  //!< Alpha resolution [degrees]
+	int iBetaPoints;         //!< Number of beta points
+	float fBetaStart;        //!< Beta start angle [degrees]
+	float fBetaEnd;          //!< Beta end angle [degrees]
+	float fBetaResolution;   //!< Beta resolution [degrees]
+	bool bFullAlphaRange;    //!< Alpha range from 0 to 360 degrees (DAFFProperties::coversFullAlphaRange)
+	bool bFullSphere;        //!< Full sphere covered (DAFFProperties::coversFullSphere)
+	bool bSouthPole;         //!< Single record at the south pole (beta start = 0)
+	bool bNorthPole;         //!< Single record at the north pole (beta end = 180)
+	double pdRotation[9];    //!< Rotation constants t1..t9 of the object view orientation (DAFFSCTransform)
+};
+
+//! Content data for GPU lookups (plain data)
+/**
+ * The values of record r and channel c start at pfData + (r * iNumChannels + c) * iStride.
+ * The pointer usually refers to device memory. Integer quantized impulse responses keep
+ * their raw samples, which are divided by the full scale value like in the reader.
+ */
+struct DAFFGPUContent {
+	DAFFGPUGrid oGrid;           //!< Grid
+	const float* pfData;         //!< Values of all records and channels
+	int iNumValues;              //!< Number of values per record and channel
+	int iStride;                 //!< Distance of the values of two record channels [floats]
+	int iContentType;            //!< Content type, one of #DAFF_CONTENT_TYPES
+	float fQuantizationDivisor;  //!< Full scale value of integer quantizations (32767, 8388607), otherwise 1
+};
+
+namespace DAFFGPU {
+//! Normalizes a data view direction like DAFFUtils::NormalizeDirection
+DAFF_GPU_FUNC void normalizeDirection(float& fAlpha, float& fBeta)
+{
+	const float EPSILON = 0.00001F;
+
+	float a = fAlpha;
+	float b = fmodf(fBeta, 360.0f);
+	if (b > 180.0f) {
+		a += 180.0f;
+		b -= 180.0f;
+	}
+
+	a = fmodf(a, 360.0f);
+	if (a < 0.0f)
+		a += 360.0f;
+
+	if ((fabsf(b) <= EPSILON) || (fabsf(b - 180.0f) <= EPSILON))
+		a = 0.0f;
+
+	fAlpha = roundf(a * 1000.0f) / 1000.0f;
+	fBeta = roundf(b * 1000.0f) / 1000.0f;
+}
+
+//! Normalizes a grid corner like DAFF::normalize_directions_dsc (directions outside its ranges are kept)
+DAFF_GPU_FUNC void normalizeCorner(float& fAlpha, float& fBeta)
+{
+	if ((fabsf(fAlpha) < 540.0F) && (fabsf(fBeta) < 720.0F))
+		normalizeDirection(fAlpha, fBeta);
+}
+
+//! Transforms an object view direction into the data view like DAFFSCTransform::transformOSC2DSC
+DAFF_GPU_FUNC void transformAnglesO2D(const DAFFGPUGrid& g, float fAzimuth, float fElevation, float& fAlpha,
+									  float& fBeta)
+{
+	double ai = double(fAzimuth) * DAFF_GPU_PI_D / 180.0f, ei = double(fElevation) * DAFF_GPU_PI_D / 180.0f;
+
+	double sa = sin(ai), ca = cos(ai);
+	double se = sin(ei), ce = cos(ei);
+	double sa_ce = sa * ce;
+	double ca_ce = ca * ce;
+
+	const double* t = g.pdRotation;
+	double ao = atan2(t[0] * sa_ce - t[1] * se + t[2] * ca_ce, t[3] * sa_ce - t[4] * se + t[5] * ca_ce);
+	double eo = asin(t[6] * sa_ce + t[7] * se + t[8] * ca_ce);
+
+	fAlpha = float(ao * 180.0f / DAFF_GPU_PI_D);
+	fBeta = float(eo * 180.0f / DAFF_GPU_PI_D + 90.0F);
+}
+
+//! Transforms a direction of a view into the normalized data view
+DAFF_GPU_FUNC void getNormalizedDSC(const DAFFGPUGrid& g, int iView, float fAngle1Deg, float fAngle2Deg,
+									float& fAlpha, float& fBeta)
+{
+	fAlpha = fAngle1Deg;
+	fBeta = fAngle2Deg;
+	if (iView == DAFF_OBJECT_VIEW)
+		transformAnglesO2D(g, fAngle1Deg, fAngle2Deg, fAlpha, fBeta);
+	normalizeDirection(fAlpha, fBeta);
+}
+
+//! Absolute angular difference in degrees like DAFF::anglef_mindiff_abs_0_360_DEG (single precision radians)
+DAFF_GPU_FUNC float getAngleDifference(float fAlphaDeg, float fBetaDeg)
+{
+	float a = fmodf(fAlphaDeg * DAFF_GPU_PI_F / 180.0f, 2 * DAFF_GPU_PI_F);
+	if (a < 0)
+		a += 2 * DAFF_GPU_PI_F;
+	float b = fmodf(fBetaDeg * DAFF_GPU_PI_F / 180.0f, 2 * DAFF_GPU_PI_F);
+	if (b < 0)
+		b += 2 * DAFF_GPU_PI_F;
+
+	float gamma = b - a;
+	if (gamma >= 0)
+		gamma = (gamma <= DAFF_GPU_PI_F ? gamma : gamma - 2 * DAFF_GPU_PI_F);
+	else
+		gamma = (gamma >= -DAFF_GPU_PI_F ? gamma : gamma + 2 * DAFF_GPU_PI_F);
+
+	return fabsf(gamma) * 180.0f / DAFF_GPU_PI_F;
+}
+
+//! Returns the record index of a grid point
+DAFF_GPU_FUNC int getGridRecordIndex(const DAFFGPUGrid& g, int iAlphaIndex, int iBetaIndex)
+{
+	if (g.bSouthPole) {
+		if (iBetaIndex == 0)
+			return 0;  // South pole
+		if ((iBetaIndex == g.iBetaPoints - 1) && g.bNorthPole)
+			return 1 + (iBetaIndex - 1) * g.iAlphaPoints;  // North pole
+		return 1 + (iBetaIndex - 1) * g.iAlphaPoints + iAlphaIndex;
+	}
+
+	if ((iBetaIndex == g.iBetaPoints - 1) && g.bNorthPole)
+		return iBetaIndex * g.iAlphaPoints;  // North pole
+	return iBetaIndex * g.iAlphaPoints + iAlphaIndex;
+}
+
+//! Nearest neighbour record of a normalized data view direction
+DAFF_GPU_FUNC int getNearestNeighbourNormalizedDSC(const DAFFGPUGrid& g, float fAlpha, float fBeta,
+												   bool& bOutOfBounds)
+{
+	int iAlphaIndex, iBetaIndex;
+	bOutOfBounds = false;
+
+	if (g.iAlphaPoints == 1) {
+		iAlphaIndex = 0;
+		bOutOfBounds = true;
+		if (fAlpha == g.fAlphaStart && fAlpha == fmodf(g.fAlphaEnd, 360.0f))
+			bOutOfBounds = false;  // Direct hit
+	} else if ((fAlpha >= g.fAlphaStart) && (fAlpha <= g.fAlphaEnd)) {
+		iAlphaIndex = (int)roundf((fAlpha - g.fAlphaStart) / g.fAlphaResolution);
+		if (iAlphaIndex >= g.iAlphaPoints)
+			iAlphaIndex = (g.bFullAlphaRange ? 0 : g.iAlphaPoints - 1);
+	} else {
+		// Outside the covered alpha range: closer boundary
+		if (getAngleDifference(g.fAlphaStart, fAlpha) <= getAngleDifference(g.fAlphaEnd, fAlpha))
+			iAlphaIndex = 0;
+		else
+			iAlphaIndex = g.iAlphaPoints - 1;
+		bOutOfBounds = true;
+	}
+
+	if (g.iBetaPoints == 1) {
+		iBetaIndex = 0;
+		bOutOfBounds = true;
+		if (fBeta == g.fBetaEnd && fBeta == g.fBetaStart)
+			bOutOfBounds = false;  // Direct hit
+	} else if ((fBeta >= g.fBetaStart) && (fBeta <= g.fBetaEnd)) {
+		iBetaIndex = (int)roundf((fBeta - g.fBetaStart) / g.fBetaResolution);
+	} else {
+		// Outside the covered beta range: closer boundary
+		if (fabsf(g.fBetaStart - fBeta) <= fabsf(g.fBetaEnd - fBeta))
+			iBetaIndex = 0;
+		else
+			iBetaIndex = g.iBetaPoints - 1;
+		bOutOfBounds = true;
+	}
+
+	return getGridRecordIndex(g, iAlphaIndex, iBetaIndex);
+}
+
+//! Nearest neighbour record of a direction like DAFFContent::getNearestNeighbour
+DAFF_GPU_FUNC int getNearestNeighbour(const DAFFGPUGrid& g, int iView, float fAngle1Deg, float fAngle2Deg,
+									  bool& bOutOfBounds)
+{
+	float fAlpha, fBeta;
+	getNormalizedDSC(g, iView, fAngle1Deg, fAngle2Deg, fAlpha, fBeta);
+	return getNearestNeighbourNormalizedDSC(g, fAlpha, fBeta, bOutOfBounds);
+}
+
+//! Surrounding records of a direction like DAFFContent::getCell (four indices)
+DAFF_GPU_FUNC void getCell(const DAFFGPUGrid& g, int iView, float fAngle1Deg, float fAngle2Deg, int* piIndices)
+{
+	float fAlpha, fBeta;
+	getNormalizedDSC(g, iView, fAngle1Deg, fAngle2Deg, fAlpha, fBeta);
+
+	bool bOutOfBounds;
+	if (fBeta == 0.0f && g.bFullSphere) {  // South pole four times
+		piIndices[0] = getNearestNeighbourNormalizedDSC(g, 0.0f, 0.0f, bOutOfBounds);
+		piIndices[1] = piIndices[2] = piIndices[3] = piIndices[0];
+		return;
+	}
+
+	float pfAlpha[4], pfBeta[4];
+	pfAlpha[0] = fAlpha - fmodf(fAlpha, g.fAlphaResolution);
+	pfAlpha[1] = pfAlpha[0];
+	pfAlpha[2] = fAlpha + g.fAlphaResolution - fmodf(fAlpha, g.fAlphaResolution);
+	pfAlpha[3] = pfAlpha[2];
+
+	pfBeta[0] = fBeta - fmodf(fBeta, g.fBetaResolution);
+	pfBeta[1] = fBeta + g.fBetaResolution - fmodf(fBeta, g.fBetaResolution);
+	pfBeta[2] = pfBeta[1];
+	pfBeta[3] = pfBeta[0];
+
+	if (pfBeta[1] > 180.0f)
+		pfBeta[1] = pfBeta[2] = 180.0f;
+
+	for (int i = 0; i < 4; i++) {
+		normalizeCorner(pfAlpha[i], pfBeta[i]);
+		piIndices[i] = getNearestNeighbourNormalizedDSC(g, pfAlpha[i], pfBeta[i], bOutOfBounds);
+	}
+}
+
+//! Surrounding records and bilinear weights like DAFFInterpolator::getWeights
+/**
+ * Weights of coinciding records (poles, boundaries) are merged into the first occurrence
+ * like in DAFFInterpolator::interpolate, the other occurrences get the weight zero.
+ */
+DAFF_GPU_FUNC void getWeights(const DAFFGPUGrid& g, int iView, float fAngle1Deg, float fAngle2Deg, int* piIndices,
+							  float* pfWeights)
+{
+	float fAlpha, fBeta;
+	getNormalizedDSC(g, iView, fAngle1Deg, fAngle2Deg, fAlpha, fBeta);
+
+	int iAlpha1 = 0, iAlpha2 = 0;
+	float fAlphaFrac = 0.0f;
+	if ((g.iAlphaPoints > 1) && (g.fAlphaResolution > 0.0f)) {
+		float fRelAlpha = fAlpha - g.fAlphaStart;
+		if (fRelAlpha < 0.0f)
+			fRelAlpha += 360.0f;
+
+		if (g.fAlphaSpan == 360.0f) {
+			float fPos = fRelAlpha / g.fAlphaResolution;
+			iAlpha1 = (int)floorf(fPos);
+			fAlphaFrac = fPos - (float)iAlpha1;
+			iAlpha1 %= g.iAlphaPoints;
+			iAlpha2 = (iAlpha1 + 1) % g.iAlphaPoints;
+		} else if (fRelAlpha <= g.fAlphaSpan) {
+			float fPos = fRelAlpha / g.fAlphaResolution;
+			iAlpha1 = (int)floorf(fPos);
+			if (iAlpha1 >= g.iAlphaPoints - 1) {
+				iAlpha1 = iAlpha2 = g.iAlphaPoints - 1;
+			} else {
+				fAlphaFrac = fPos - (float)iAlpha1;
+				iAlpha2 = iAlpha1 + 1;
+			}
+		} else {
+			if ((fRelAlpha - g.fAlphaSpan) <= (360.0f - fRelAlpha))
+				iAlpha1 = iAlpha2 = g.iAlphaPoints - 1;
+			else
+				iAlpha1 = iAlpha2 = 0;
+		}
+	}
+
+	int iBeta1 = 0, iBeta2 = 0;
+	float fBetaFrac = 0.0f;
+	if ((g.iBetaPoints > 1) && (g.fBetaResolution > 0.0f)) {
+		float fPos = (fBeta - g.fBetaStart) / g.fBetaResolution;
+		if (fPos <= 0.0f) {
+			iBeta1 = iBeta2 = 0;
+		} else if (fPos >= (float)(g.iBetaPoints - 1)) {
+			iBeta1 = iBeta2 = g.iBetaPoints - 1;
+		} else {
+			iBeta1 = (int)floorf(fPos);
+			fBetaFrac = fPos - (float)iBeta1;
+			iBeta2 = iBeta1 + 1;
+		}
+	}
+
+	piIndices[0] = getGridRecordIndex(g, iAlpha1, iBeta1);
+	piIndices[1] = getGridRecordIndex(g, iAlpha1, iBeta2);
+	piIndices[2] = getGridRecordIndex(g, iAlpha2, iBeta2);
+	piIndices[3] = getGridRecordIndex(g, iAlpha2, iBeta1);
+
+	pfWeights[0] = (1.0f - fAlphaFrac) * (1.0f - fBetaFrac);
+	pfWeights[1] = (1.0f - fAlphaFrac) * fBetaFrac;
+	pfWeights[2] = fAlphaFrac * fBetaFrac;
+	pfWeights[3] = fAlphaFrac * (1.0f - fBetaFrac);
+
+	for (int i = 1; i < 4; i++)
+		for (int j = 0; j < i; j++)
+			if (piIndices[j] == piIndices[i]) {
+				pfWeights[j] += pfWeights[i];
+				pfWeights[i] = 0.0f;
+				break;
+			}
+}
+
+//! Returns a pointer to the values of a record channel
+DAFF_GPU_FUNC const float* getValuesPtr(const DAFFGPUContent& c, int iRecordIndex, int iChannel)
+{
+	return c.pfData + ((size_t)iRecordIndex * c.oGrid.iNumChannels + iChannel) * c.iStride;
+}
+
+//! Returns a value of a record channel (e.g. the magnitude of a band) like the data getters of the contents
+DAFF_GPU_FUNC float getValue(const DAFFGPUContent& c, int iRecordIndex, int iChannel, int iValue)
+{
+	return getValuesPtr(c, iRecordIndex, iChannel)[iValue] * (1.0f / c.fQuantizationDivisor);
+}
+
+//! Interpolates a value (e.g. the magnitude of a band) from the records and weights of getWeights
+DAFF_GPU_FUNC float interpolateValue(const DAFFGPUContent& c, const int* piIndices, const float* pfWeights,
+									 int iChannel, int iValue)
+{
+	// Same sequence of operations as DAFFInterpolator::interpolate (gain folded into the conversion)
+	float fValue = 0.0f;
+	for (int i = 0; i < 4; i++)
+		if (pfWeights[i] != 0.0f)
+			fValue += getValuesPtr(c, piIndices[i], iChannel)[iValue] * (pfWeights[i] / c.fQuantizationDivisor);
+	return fValue;
+}
+}  // namespace DAFFGPU
+
+#endif  // IW_DAFF_GPU
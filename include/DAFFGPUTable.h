@@ -0,0 +1,107 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_GPU_TABLE
+#define IW_DAFF_GPU_TABLE
+
+#include <DAFFDefs.h>
+#include <DAFFGPU.h>
+
+#include <vector>
+
+// Forward declarations
+class DAFFContent;
+
+//! Content data packed for GPU lookups
+/**
+ * The table holds the grid of a content (DAFFGPUGrid) and the values of all records and
+ * channels as one block of floats, which is copied to device memory at once (see DAFFGPU.h
+ * and DAFFCUDAContent). The values of a record channel are padded to a multiple of 32 floats
+ * (128 bytes), so that the values of each record channel start at an aligned address.
+ *
+ * Packed values per content type:
+ *  - Impulse responses: filter coefficients (full filter length, raw samples of integer quantizations)
+ *  - Magnitude spectra: magnitudes of the support frequencies
+ *  - Magnitude-phase spectra: magnitudes of the support frequencies (band magnitude lookups)
+ *  - DFT spectra: interleaved complex coefficients (Re[0], Im[0], Re[1], ...)
+ *
+ * Phase spectra are not supported, and neither are irregular grids (records without cells).
+ *
+ * The object view uses the orientation of the content at the time of loading. It can be changed
+ * with setOrientation(), which only affects the grid (no new upload of the data required).
+ */
+class DAFF_API DAFFGPUTable {
+  public:
+	//! Default constructor (empty table)
+	DAFFGPUTable();
+
+	//! Destructor
+	virtual ~DAFFGPUTable();
+
+	//! Packs the grid and the values of a content
+	/**
+	 * \param [in] pContent	Content
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR for irregular grids and phase spectra,
+	 *		   the error of the content otherwise (e.g. #DAFF_FILE_CORRUPTED, the table is cleared then)
+	 */
+	int load(const DAFFContent* pContent);
+
+	//! Frees the data
+	void clear();
+
+	//! Returns true if a content is loaded
+	bool isLoaded() const;
+
+	//! Returns the content type, one of #DAFF_CONTENT_TYPES (-1 if not loaded)
+	int getContentType() const;
+
+	//! Returns the grid
+	const DAFFGPUGrid& getGrid() const;
+
+	//! Sets the object view orientation of the grid (yaw-pitch-roll)
+	void setOrientation(const DAFFOrientationYPR& o);
+
+	//! Returns the number of values per record and channel
+	int getNumValues() const;
+
+	//! Returns the distance of the values of two record channels [floats]
+	int getStride() const;
+
+	//! Returns the packed values of all records and channels
+	const float* getData() const;
+
+	//! Returns the full scale value of the packed raw integer samples (1 for other quantizations)
+	float getQuantizationDivisor() const;
+
+	//! Returns the size of the packed values [Bytes]
+	size_t getDataSize() const;
+
+	//! Returns the lookup description for a copy of the packed values
+	/**
+	 * \param [in] pfData	Copy of the values (usually device memory), NULL: values of the table
+	 */
+	DAFFGPUContent getContent(const float* pfData = NULL) const;
+
+  private:
+	DAFFGPUGrid m_oGrid;           //!@ Grid
+	std::vector<float> m_vfData;   //!@ Packed values [record][channel][stride]
+	int m_iNumValues;              //!@ Number of values per record and channel
+	int m_iStride;                 //!@ Distance of two record channels [floats]
+	int m_iContentType;            //!@ Content type (-1: not loaded)
+	float m_fQuantizationDivisor;  //!@ Full scale value of raw integer samples (otherwise 1)
+
+	// No copy
+	DAFFGPUTable(const DAFFGPUTable&);
+	DAFFGPUTable& operator=(const DAFFGPUTable&);
+};
+
+#endif  // IW_DAFF_GPU_TABLE
@@ -0,0 +1,137 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_HOTRELOADER
+#define IW_DAFF_HOTRELOADER
+
+#include <DAFFDefs.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Forward declarations
+class DAFFReader;
+
+//! Watches a DAFF file and reloads it when it changes
+/**
+ * The reloader holds the current version of a file as a shared reader. When the file changes
+ * (modification time or size), the new version is loaded with a new reader, either by
+ * checkForChanges() or by a watching thread (startWatching()), and swapped in atomically.
+ * Users take a snapshot with getReader() (e.g. once per audio block) and query it, so queries
+ * in flight finish against the old data, which is released with its last snapshot. Loading
+ * happens entirely outside the users of the readers.
+ *
+ * A version is only taken if the file did not change while it was loaded. Versions that fail to
+ * load (e.g. a file that is still being written) keep the previous version and are retried when
+ * the file changes again, see getLastError(). The previous version is kept until the next reload,
+ * so that real-time threads do not usually drop the last reference (and free the data).
+ *
+ * Loading with #DAFF_OPEN_LAZY reads only the headers on reloads. Lazily loaded and mapped files
+ * are accessed after loading, so exporters should replace the file (write a new file and rename
+ * it) instead of overwriting it in place. All methods are thread-safe.
+ */
+class DAFF_API DAFFHotReloader {
+  public:
+	//! Default constructor (no file)
+	DAFFHotReloader();
+
+	//! Destructor (stops watching, users keep their readers)
+	virtual ~DAFFHotReloader();
+
+	//! Opens a file and watches it for changes
+	/**
+	 * Loads the current version in the calling thread. The file is watched also if it can not
+	 * be loaded, getReader() returns an empty pointer until a valid version has been loaded.
+	 * A watching thread of a previous file is stopped.
+	 *
+	 * \param [in] sFilePath		Path to the DAFF file
+	 * \param [in] iOpenFlags	Combination of #DAFF_OPEN_FLAGS
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int open(const std::string& sFilePath, int iOpenFlags = DAFF_OPEN_DEFAULT);
+
+	//! Stops watching and drops the current version (users keep their readers)
+	void close();
+
+	//! Returns the path of the watched file (empty if none)
+	std::string getFilePath() const;
+
+	//! Returns the open flags of the loaded versions
+	int getOpenFlags() const;
+
+	//! Returns the current version (empty if none has been loaded)
+	std::shared_ptr<const DAFFReader> getReader() const;
+
+	//! Returns the number of versions loaded since the reloader was created
+	/**
+	 * Users can compare it between their queries to detect a reload (e.g. to reset their
+	 * interpolation or views of the content).
+	 */
+	uint64_t getGeneration() const;
+
+	//! Returns the result of the last load (#DAFF_NO_ERROR or another #DAFF_ERROR)
+	int getLastError() const;
+
+	//! Checks the file for changes and reloads it in the calling thread
+	/**
+	 * @return True if a new version has been swapped in
+	 */
+	bool checkForChanges();
+
+	//! Starts a thread that checks the file for changes periodically
+	/**
+	 * \param [in] iIntervalMS	Time between two checks [ms]
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if no file is opened or no thread is available
+	 */
+	int startWatching(int iIntervalMS = 500);
+
+	//! Stops the watching thread (waits for a reload in progress)
+	void stopWatching();
+
+	//! Returns true if the watching thread is running
+	bool isWatching() const;
+
+  private:
+	std::string m_sFilePath;                        //!@ Watched file
+	int m_iOpenFlags;                               //!@ Open flags of the versions
+	std::shared_ptr<const DAFFReader> m_pReader;    //!@ Current version (accessed atomically)
+	std::shared_ptr<const DAFFReader> m_pPrevious;  //!@ Previous version (kept until the next reload)
+	int64_t m_iModTime;                             //!@ Modification time of the current version [ns]
+	int64_t m_iSize;                                //!@ File size of the current version [Bytes]
+	int64_t m_iFailedModTime;                       //!@ Modification time of the last version that failed [ns]
+	int64_t m_iFailedSize;                          //!@ File size of the last version that failed [Bytes]
+	std::atomic<int> m_iLastError;                  //!@ Result of the last load
+	std::atomic<uint64_t> m_ui64Generation;         //!@ Number of versions loaded
+	mutable std::mutex m_mxReload;                  //!@ Guards the file and the versions (one load at a time)
+	std::thread m_oWatchThread;                     //!@ Watching thread
+	int m_iIntervalMS;                              //!@ Time between two checks of the watching thread [ms]
+	bool m_bStopWatching;                           //!@ Stop request of the watching thread
+	std::mutex m_mxWatch;                           //!@ Guards the stop request
+	std::condition_variable m_cvWatch;              //!@ Signals the stop request
+
+	//! Loads the file if it changed since the current version (m_mxReload must be held)
+	bool reload();
+
+	//! Checks the file periodically until stopped
+	void watch();
+
+	// No copy
+	DAFFHotReloader(const DAFFHotReloader&);
+	DAFFHotReloader& operator=(const DAFFHotReloader&);
+};
+
+#endif  // IW_DAFF_HOTRELOADER
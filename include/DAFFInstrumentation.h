@@ -0,0 +1,98 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_INSTRUMENTATION
+#define IW_DAFF_INSTRUMENTATION
+
+#include <DAFFDefs.h>
+
+//! Event counters of the instrumentation
+enum DAFF_COUNTERS {
+	DAFF_COUNTER_NEAREST_NEIGHBOUR = 0,     //!< Nearest neighbour lookups
+	DAFF_COUNTER_OUT_OF_BOUNDS,             //!< Nearest neighbour lookups outside the covered angle ranges
+	DAFF_COUNTER_FETCHED_BYTES_INT16,       //!< Converted record data of 16-bit integer quantization [Bytes]
+	DAFF_COUNTER_FETCHED_BYTES_INT24,       //!< Converted record data of 24-bit integer quantization [Bytes]
+	DAFF_COUNTER_FETCHED_BYTES_FLOAT32,     //!< Converted record data of 32-bit float quantization [Bytes]
+	DAFF_COUNTER_FETCHED_BYTES_FLOAT16,     //!< Converted record data of 16-bit float quantization [Bytes]
+	DAFF_COUNTER_FETCHED_BYTES_BFLOAT16,    //!< Converted record data of bfloat16 quantization [Bytes]
+	DAFF_COUNTER_FETCHED_BYTES_INT16_BFP,   //!< Converted record data of block floating point quantization [Bytes]
+	DAFF_COUNTER_RECORD_CACHE_HITS,         //!< Record data found in the cache of the lazy loading
+	DAFF_COUNTER_RECORD_CACHE_MISSES,       //!< Record data loaded on demand (lazy loading)
+	DAFF_COUNTER_TRANSFORMER_CACHE_HITS,    //!< Elements found in the cache of a lazy transformer
+	DAFF_COUNTER_TRANSFORMER_CACHE_MISSES,  //!< Elements transformed on demand by a lazy transformer
+	DAFF_COUNTER_CONTENT_CACHE_HITS,        //!< Shared readers handed out by DAFFContentCache
+	DAFF_COUNTER_CONTENT_CACHE_MISSES,      //!< Files opened by DAFFContentCache
+	DAFF_NUM_COUNTERS                       //!< Number of counters
+};
+
+//! Receiver of the trace scopes of the instrumentation
+/**
+ * Scopes are reported from the thread that executed them, the receiver must be thread-safe.
+ */
+class DAFF_API DAFFInstrumentationSink {
+  public:
+	inline virtual ~DAFFInstrumentationSink() {};
+
+	//! Called when a traced scope has ended
+	/**
+	 * \param [in] pszScope		Scope name (static string, e.g. "load.header")
+	 * \param [in] dDuration		Wall time of the scope [s]
+	 */
+	virtual void onTraceScope(const char* pszScope, double dDuration) = 0;
+};
+
+//! Process-wide instrumentation of the hot paths (counters and trace scopes)
+/**
+ * The library counts lookups, fetched bytes and cache accesses and traces the load
+ * phases only if it is built with the CMake option OPENDAFF_WITH_INSTRUMENTATION
+ * (compile definition DAFF_WITH_INSTRUMENTATION). Otherwise the hooks are compiled
+ * out entirely, the counters stay zero and no scopes are reported. The interface is
+ * always present, so applications need not be built differently.
+ *
+ * The counters are relaxed atomics and can be read at any time, e.g. by an exporter
+ * polling them periodically. They are cumulative until resetCounters().
+ */
+class DAFF_API DAFFInstrumentation {
+  public:
+	//! Returns true if the library was built with instrumentation
+	static bool isEnabled();
+
+	//! Registers the receiver of the trace scopes (NULL: none, default)
+	/**
+	 * The sink is not owned and must stay valid until it is unregistered.
+	 * Scopes already running may still report to the previous sink.
+	 */
+	static void setSink(DAFFInstrumentationSink* pSink);
+
+	//! Returns the registered receiver of the trace scopes (NULL: none)
+	static DAFFInstrumentationSink* getSink();
+
+	//! Returns the value of a counter (one of #DAFF_COUNTERS, 0 if invalid)
+	static uint64_t getCounter(int iCounter);
+
+	//! Returns the values of all counters
+	/**
+	 * \param [out] pui64Values	Counter values, #DAFF_NUM_COUNTERS elements (index: #DAFF_COUNTERS)
+	 */
+	static void getCounters(uint64_t* pui64Values);
+
+	//! Sets all counters to zero
+	static void resetCounters();
+
+	//! Returns the name of a counter (e.g. "nearest_neighbour", empty if invalid)
+	static const char* getCounterName(int iCounter);
+
+  private:
+	// Only static methods
+	DAFFInstrumentation();
+};
+
+#endif  // IW_DAFF_INSTRUMENTATION
@@ -0,0 +1,105 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_INTERPOLATOR
+#define IW_DAFF_INTERPOLATOR
+
+#include <DAFFDefs.h>
+
+// Forward declarations
+class DAFFContent;
+class DAFFContentDFT;
+class DAFFContentIR;
+class DAFFContentMS;
+
+//! Bilinear interpolation of records on the regular sphere grid
+/**
+ * The interpolator determines the grid cell that surrounds a direction (in the
+ * same sequence as DAFFContent::getCell) and the bilinear weights of its four
+ * records in data spherical coordinates (DSC). Towards the poles, where the grid
+ * collapses into a single record, the weights of the coinciding records add up.
+ * Outside of partially covered grids the direction is clamped to the boundary.
+ * Irregular grids (see DAFFProperties::isRegularGrid) are not supported (#DAFF_MODAL_ERROR).
+ *
+ * For impulse responses (IR), magnitude spectra (MS) and DFT spectra (DFT) the
+ * interpolator also blends the data directly into a destination buffer. Every
+ * distinct record is accumulated exactly once with its weight, using the add
+ * methods of the content with a gain (e.g. DAFFContentIR::addFilterCoeffs),
+ * so no intermediate buffers are required.
+ *
+ * The interpolator keeps a pointer to the content, which must outlive it.
+ */
+class DAFF_API DAFFInterpolator {
+  public:
+	//! Constructor
+	/**
+	 * \param [in] pContent	Content to interpolate (any content type for weights, IR, MS or DFT for data)
+	 */
+	DAFFInterpolator(const DAFFContent* pContent);
+
+	//! Returns the content
+	const DAFFContent* getContent() const;
+
+	//! Returns the number of float values per channel written by interpolate()
+	/**
+	 * Filter length for IR, number of frequencies for MS and 2*getNumDFTCoeffs()
+	 * for DFT content (interleaved real and imaginary parts), 0 otherwise.
+	 */
+	int getDataLength() const;
+
+	//! Determines the surrounding records of a direction and their bilinear weights
+	/**
+	 * \param [in] iView			View, one of #DAFF_VIEWS
+	 * \param [in] fAngle1Deg	First angle (Phi or Alpha, depending on view)
+	 * \param [in] fAngle2Deg	Second angle (Theta or Beta, depending on view)
+	 * \param [out] qIndices		Record indices of the cell
+	 * \param [out] pfWeights	Weights of the four records (4 elements, sum 1)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int getWeights(int iView, float fAngle1Deg, float fAngle2Deg, DAFFQuad& qIndices, float* pfWeights) const;
+
+	//! Interpolates the data of a channel for a direction
+	/**
+	 * \param [in] iView			View, one of #DAFF_VIEWS
+	 * \param [in] fAngle1Deg	First angle (Phi or Alpha, depending on view)
+	 * \param [in] fAngle2Deg	Second angle (Theta or Beta, depending on view)
+	 * \param [in] iChannel		Channel index
+	 * \param [out] pfDest		Destination buffer (size >= getDataLength())
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int interpolate(int iView, float fAngle1Deg, float fAngle2Deg, int iChannel, float* pfDest) const;
+
+  private:
+	const DAFFContent* m_pContent;        //!@ Content
+	const DAFFContentIR* m_pContentIR;    //!@ Content as impulse responses (or NULL)
+	const DAFFContentMS* m_pContentMS;    //!@ Content as magnitude spectra (or NULL)
+	const DAFFContentDFT* m_pContentDFT;  //!@ Content as DFT spectra (or NULL)
+
+	// Grid
+	int m_iAlphaPoints;        //!@ Number of alpha points
+	float m_fAlphaStart;       //!@ Alpha start angle [degrees]
+	float m_fAlphaSpan;        //!@ Alpha span [degrees]
+	float m_fAlphaResolution;  //!@ Alpha resolution [degrees]
+	bool m_bFullAlphaRange;    //!@ Alpha range wraps around
+	int m_iBetaPoints;         //!@ Number of beta points
+	float m_fBetaStart;        //!@ Beta start angle [degrees]
+	float m_fBetaResolution;   //!@ Beta resolution [degrees]
+	bool m_bSouthPole;         //!@ Single record at the south pole
+	bool m_bNorthPole;         //!@ Single record at the north pole
+	bool m_bRegularGrid;       //!@ Records lie on the regular grid
+
+	//! Returns the record index of a grid point
+	int getRecordIndex(int iAlpha, int iBeta) const;
+};
+
+#endif  // IW_DAFF_INTERPOLATOR
@@ -0,0 +1,77 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_LOADER
+#define IW_DAFF_LOADER
+
+#include <DAFFDefs.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class DAFFReader;
+
+//! Parallel loading of many DAFF files (e.g. the directivities of a scene)
+/**
+ * The loader opens a list of files with a bounded number of threads. Loading is mostly
+ * bound by the CPU (byte order conversion, decoding, metadata and index setup), so it scales
+ * with the number of threads until the storage saturates.
+ *
+ * The files are opened through the DAFFContentCache and share its readers: files that are already
+ * in use are not loaded again, and a file listed several times (also under different paths) is
+ * loaded only once.
+ */
+class DAFF_API DAFFLoader {
+  public:
+	//! Default constructor (default open flags, automatic number of threads)
+	DAFFLoader();
+
+	//! Destructor
+	virtual ~DAFFLoader();
+
+	//! Returns the open flags of the files
+	int getOpenFlags() const;
+
+	//! Sets the open flags of the files (combination of #DAFF_OPEN_FLAGS)
+	void setOpenFlags(int iOpenFlags);
+
+	//! Returns the number of loading threads (0: automatic)
+	int getNumThreads() const;
+
+	//! Sets the number of loading threads, i.e. the number of files loaded at once
+	/**
+	 * \param iNumThreads	Number of threads (0: number of hardware threads, 1: load sequentially without threads)
+	 */
+	void setNumThreads(int iNumThreads);
+
+	//! Loads files in parallel
+	/**
+	 * \param [in] vsFilePaths		Paths of the DAFF files
+	 * \param [out] vpReaders		Shared readers, one per path (empty for files that failed)
+	 * \param [out] viErrorCodes		#DAFF_NO_ERROR or another #DAFF_ERROR, one per path
+	 *
+	 * @return #DAFF_NO_ERROR if all files have been loaded, otherwise the error of the first file that failed
+	 */
+	int load(const std::vector<std::string>& vsFilePaths, std::vector<std::shared_ptr<const DAFFReader> >& vpReaders,
+			 std::vector<int>& viErrorCodes) const;
+
+  private:
+	int m_iOpenFlags;   //!@ Open flags of the files
+	int m_iNumThreads;  //!@ Number of loading threads (0: automatic)
+
+	// No copy
+	DAFFLoader(const DAFFLoader&);
+	DAFFLoader& operator=(const DAFFLoader&);
+};
+
+#endif  // IW_DAFF_LOADER
@@ -77,6 +77,14 @@ class DAFF_API DAFFMetadata {
 	 */
 	virtual std::string getKeyString(const std::string& sKey) const = 0;
 
+	//! Returns the value of a string key without copying it
+	/**
+	 * The pointer stays valid as long as the metadata exists.
+	 *
+	 * @return Null-terminated value, NULL if the key does not exist or is no string key
+	 */
+	virtual const char* getKeyStringPtr(const std::string& sKey) const = 0;
+
 	//! Returns the value (true|false) of a boolean key
 	virtual bool getKeyBool(const std::string& sKey) const = 0;
 
@@ -0,0 +1,206 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_PRINCIPAL_COMPONENTS
+#define IW_DAFF_PRINCIPAL_COMPONENTS
+
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+#include <string>
+#include <vector>
+
+// Forward declarations
+class DAFFContent;
+
+//! Low-rank representation of directional data by principal components (PCA)
+/**
+ * The records of large data sets (e.g. head-related impulse responses) are highly redundant
+ * across the directions. The representation stores per channel the mean of all records, K
+ * principal components and K weights per record, and reconstructs a record as the mean plus
+ * the weighted sum of the components. With K much smaller than the number of values per
+ * channel the memory drops accordingly, e.g. 10 to 50 times for HRIRs of some hundred taps
+ * with 10 to 20 components.
+ *
+ * The values per channel are the ones of DAFFSHExpansion (see getDataLength()). The components
+ * are the leading right singular vectors of the mean-free data of each channel, determined by a
+ * randomized singular value decomposition with power iterations, whose matrix products run in
+ * parallel over the records and values. The fit holds the data of one channel in memory.
+ *
+ * Since the reconstruction is linear, interpolation happens in the weight space: the K weights
+ * of the records are blended (e.g. with the bilinear weights of DAFFInterpolator::getWeights)
+ * and reconstructed by a single matrix-vector product of K+1 multiply-adds per value, independent
+ * of the number of blended records and only touching the compact basis instead of the records.
+ * The grid is not part of the representation, the record indices are the ones of the fitted content.
+ *
+ * Representations can be stored in a file (save) and loaded later without the content (load).
+ * Reconstructions are const and can run concurrently.
+ */
+class DAFF_API DAFFPrincipalComponents {
+  public:
+	//! Maximum number of principal components
+	enum { MAX_COMPONENTS = 255 };
+
+	//! Default constructor (empty representation)
+	DAFFPrincipalComponents();
+
+	//! Destructor
+	virtual ~DAFFPrincipalComponents();
+
+	//! Returns true if the representation holds components (fitted or loaded)
+	bool isValid() const;
+
+	//! Returns the number of principal components K (0 if empty)
+	int getNumComponents() const;
+
+	//! Returns the content type of the fitted data, one of #DAFF_CONTENT_TYPES (-1 if empty)
+	int getContentType() const;
+
+	//! Returns the number of records (0 if empty)
+	int getNumRecords() const;
+
+	//! Returns the number of channels (0 if empty)
+	int getNumChannels() const;
+
+	//! Returns the number of float values per channel written by reconstruct()
+	/**
+	 * Filter length for IR, number of frequencies for MS and PS, 2*number of frequencies for MPS
+	 * and 2*getNumDFTCoeffs() for DFT content (interleaved like the record data), 0 if empty.
+	 */
+	int getDataLength() const;
+
+	//! Returns the number of threads of the fit (0: automatic)
+	int getNumThreads() const;
+
+	//! Sets the number of threads of the fit
+	/**
+	 * \param iNumThreads	Number of threads (0: number of hardware threads, 1: no worker threads)
+	 */
+	void setNumThreads(int iNumThreads);
+
+	//! Free memory (empty representation)
+	void clear();
+
+	//! Fits the representation to the data of a content
+	/**
+	 * The number of components is limited by the number of records and values per channel.
+	 *
+	 * \param [in] pContent			Content (any content type)
+	 * \param [in] iNumComponents	Number of principal components K in [1, #MAX_COMPONENTS]
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise (the representation is cleared)
+	 */
+	int fit(const DAFFContent* pContent, int iNumComponents);
+
+	//! Returns the mean of the records of a channel (getDataLength() floats, NULL if empty or on invalid channels)
+	const float* getMeanPtr(int iChannel) const;
+
+	//! Returns the principal components of a channel
+	/**
+	 * The components are laid out as getNumComponents() consecutive orthonormal rows of
+	 * getDataLength() floats, in descending order of the variance they explain.
+	 *
+	 * \param [in] iChannel	Channel index
+	 *
+	 * @return Pointer to the components (NULL if empty or on invalid channels)
+	 */
+	const float* getComponentsPtr(int iChannel) const;
+
+	//! Returns the weights of the records of a channel
+	/**
+	 * The weights are laid out as getNumRecords() consecutive rows of getNumComponents() floats.
+	 *
+	 * \param [in] iChannel	Channel index
+	 *
+	 * @return Pointer to the weights (NULL if empty or on invalid channels)
+	 */
+	const float* getWeightsPtr(int iChannel) const;
+
+	//! Returns the fraction of the variance of a channel explained by the components (0 to 1, 0 if empty)
+	float getExplainedVariance(int iChannel) const;
+
+	//! Reconstructs a record channel
+	/**
+	 * \param [in] iRecordIndex	Record index
+	 * \param [in] iChannel		Channel index
+	 * \param [out] pfDest		Destination buffer (size >= getDataLength())
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int reconstruct(int iRecordIndex, int iChannel, float* pfDest) const;
+
+	//! Reconstructs the weighted sum of records of a channel, interpolated in the weight space
+	/**
+	 * The weights of the records are blended first and reconstructed once with a single
+	 * matrix-vector product, which equals the weighted sum of the reconstructed records.
+	 *
+	 * \param [in] piRecordIndices	Record indices, n elements
+	 * \param [in] pfRecordWeights	Weights of the records, n elements
+	 * \param [in] n					Number of records
+	 * \param [in] iChannel			Channel index
+	 * \param [out] pfDest			Destination buffer (size >= getDataLength())
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int interpolate(const int* piRecordIndices, const float* pfRecordWeights, int n, int iChannel,
+					float* pfDest) const;
+
+	//! Reconstructs the bilinear interpolation of a grid cell of a channel (see DAFFInterpolator::getWeights)
+	/**
+	 * \param [in] qIndices		Record indices of the cell
+	 * \param [in] pfWeights		Weights of the four records (4 elements)
+	 * \param [in] iChannel		Channel index
+	 * \param [out] pfDest		Destination buffer (size >= getDataLength())
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int interpolate(const DAFFQuad& qIndices, const float* pfWeights, int iChannel, float* pfDest) const;
+
+	//! Stores the representation in a file
+	/**
+	 * \param [in] sFilePath	File path
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if empty, #DAFF_FILE_NOT_FOUND if not writable
+	 */
+	int save(const std::string& sFilePath) const;
+
+	//! Loads a representation from a file
+	/**
+	 * \param [in] sFilePath	File path
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise (the representation is cleared)
+	 */
+	int load(const std::string& sFilePath);
+
+	//! Returns the heap memory held by the representation [Bytes]
+	size_t getMemoryFootprint() const;
+
+  private:
+	int m_iNumComponents;                 //!@ Number of principal components (0: empty)
+	int m_iContentType;                   //!@ Content type of the fitted data (-1: empty)
+	int m_iNumRecords;                    //!@ Number of records
+	int m_iNumChannels;                   //!@ Number of channels
+	int m_iDataLength;                    //!@ Number of values per channel
+	int m_iNumThreads;                    //!@ Number of threads of the fit (0: automatic)
+	std::vector<float> m_vfBasis;         //!@ Mean and components [channel][mean, component][value]
+	std::vector<float> m_vfWeights;       //!@ Weights [channel][record][component]
+	std::vector<float> m_vfExplained;     //!@ Explained variance [channel]
+	std::vector<const float*> m_vpfRows;  //!@ Basis rows [channel][mean, component]
+
+	//! Sets up an empty representation of the given dimensions (basis and weights zero)
+	void init(int iNumComponents, int iContentType, int iNumRecords, int iNumChannels, int iDataLength);
+
+	// No copy
+	DAFFPrincipalComponents(const DAFFPrincipalComponents&);
+	DAFFPrincipalComponents& operator=(const DAFFPrincipalComponents&);
+};
+
+#endif  // IW_DAFF_PRINCIPAL_COMPONENTS
@@ -101,6 +101,10 @@ class DAFF_API DAFFProperties {
 	virtual void getOrientation(DAFFOrientationYPR& o) const = 0;
 
 	//! Sets the current orientation of the object view
+	/**
+	 * Can be called while other threads query the reader. Each query in the
+	 * object view uses either the previous or the new orientation as a whole.
+	 */
 	virtual void setOrientation(const DAFFOrientationYPR& o) = 0;
 
 	// -= Coverage =--------------------------------------
@@ -113,6 +117,17 @@ class DAFF_API DAFFProperties {
 
 	//! Indicates whether the data covers the full sphere
 	virtual bool coversFullSphere() const = 0;
+
+	// -= Sampling =--------------------------------------
+
+	//! Indicates whether the records lie on the regular alpha/beta grid
+	/**
+	 * Irregular grids (e.g. Lebedev, Gaussian or spiral sampling) store an explicit
+	 * direction per record, which getRecordCoords() returns. Nearest neighbour queries
+	 * then find the record with the smallest great-circle distance and are never out
+	 * of bounds. The alpha/beta points and resolutions have no meaning for irregular grids.
+	 */
+	virtual bool isRegularGrid() const = 0;
 };
 
 #endif  // IW_DAFF_PROPERTIES
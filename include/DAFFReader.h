@@ -14,12 +14,43 @@
 #include <DAFFDefs.h>
 
 #include <string>
+#include <vector>
 
 // Forward declarations
 class DAFFContent;
+class DAFFDataSource;
 class DAFFMetadata;
 class DAFFProperties;
 
+//! Receiver of the progress and the completion of DAFFReader::openFileAsync()
+/**
+ * The methods are called from the worker thread that opens the file. GUI applications
+ * should forward them into their event loop. They may query the reader, but must not
+ * open, close or wait for it (see DAFFReader::waitForOpen()).
+ */
+class DAFF_API DAFFOpenCallback {
+  public:
+	inline virtual ~DAFFOpenCallback() {};
+
+	//! Reports the progress of the opening (optional)
+	/**
+	 * Called repeatedly while the record data is read and once when reading is complete.
+	 * Decoding and truncation (#DAFF_OPEN_DECODE, #DAFF_OPEN_TRUNCATE) follow afterwards.
+	 *
+	 * \param [in] fProgress	Fraction of the record data read [0..1]
+	 *
+	 * @return False to cancel the opening (like DAFFReader::cancelOpen()), true to continue (default)
+	 */
+	inline virtual bool onOpenProgress(float) { return true; };
+
+	//! Reports the completion of the opening, called exactly once
+	/**
+	 * \param [in] iErrorCode	#DAFF_NO_ERROR if the file has been opened, another #DAFF_ERROR otherwise
+	 *							(#DAFF_OPEN_CANCELLED after a cancellation)
+	 */
+	virtual void onOpenFinished(int iErrorCode) = 0;
+};
+
 //! Reader interface for DAFF files
 /**
  * This purely abstract class defines the reader interface for DAFF files.
@@ -102,6 +133,19 @@ class DAFFProperties;
  * that areas because the grids do not match. Be aware of that and, if possible, simply avoid it :)
  *
  *
+ *		Thread safety
+ *
+ * Opening, closing and deserializing is not thread-safe (openFileAsync() opens a file on a worker thread,
+ * the reader must not be used until the opening has completed). Once the content is loaded, all const
+ * methods of the reader, its properties and contents can be called concurrently from several threads,
+ * so a single reader can be shared instead of loading the data several times. This includes the
+ * lazily determined values (e.g. peaks and statistics), which are computed once by the first caller.
+ * setOrientation() can be called concurrently as well: Object view queries use an immutable snapshot
+ * of the orientation. With #DAFF_OPEN_LAZY the record cache is locked during each access, pointers
+ * returned by the zero-copy accessors (e.g. getMagnitudesPtr()) are then only valid until the next
+ * data access of any thread. Transformed contents (e.g. DAFFTransformerIR2DFT) are not thread-safe.
+ *
+ *
  *		Definitions
  *
  * It is generally a good idea to have a look at the "DAFFDefs.h" header file. Here you find a couple
@@ -136,9 +180,101 @@ class DAFF_API DAFFReader {
 	 * This method opens the given DAFF file for reading and
 	 * loads all of its data into the memory.
 	 *
+	 * With #DAFF_OPEN_MAPPED the file is memory-mapped instead. On little endian
+	 * systems the record descriptors and the record data are then accessed directly
+	 * within the mapping, the file is not copied and pages are only loaded on access.
+	 * The file must not be modified while it is opened.
+	 *
+	 * With #DAFF_OPEN_LAZY only the headers, the record descriptors and the metadata
+	 * are loaded. The file stays opened and record channel data is read on first access
+	 * into a least-recently-used cache, which is bounded by setLazyCacheSize().
+	 *
+	 * With #DAFF_OPEN_DECODE, 16- and 24-bit integer impulse responses and 16-bit floating point
+	 * contents (#DAFF_FLOAT16, #DAFF_BFLOAT16) are converted once after loading into a 32-byte
+	 * aligned float buffer. Subsequent data access then works as for #DAFF_FLOAT32 files
+	 * (including getEffectiveFilterCoeffsPtr()), at the cost of the additional memory.
+	 * The flag is ignored with #DAFF_OPEN_LAZY.
+	 *
+	 * With #DAFF_OPEN_TRUNCATE, the tails of impulse responses below the truncation
+	 * threshold (setTruncationThreshold()) are dropped and the remaining coefficients
+	 * are repacked into a float buffer like with #DAFF_OPEN_DECODE. The effective filter
+	 * bounds, getMaxEffectiveFilterLength() and getFilterCoeffsTruncated() then refer to
+	 * the truncated filters. The flag is ignored with #DAFF_OPEN_LAZY.
+	 *
+	 * With #DAFF_OPEN_VERIFY, the blocks read while loading are verified against the checksums
+	 * of the file (see DAFFWriter::setChecksums), large blocks on several threads. With
+	 * #DAFF_OPEN_LAZY, record data is verified segment by segment on first access instead,
+	 * a corrupted segment then fails the access. Files without checksums are loaded as usual
+	 * (see hasChecksums()). A mismatch results in #DAFF_FILE_CHECKSUM_MISMATCH.
+	 *
+	 * With #DAFF_OPEN_SLICES, the first cross-record slice of a spectrum (e.g.
+	 * DAFFContentMS::getMagnitudeSlice()) builds a frequency-major copy of the record data
+	 * on several threads, further slices are then plain copies. The copy takes as much memory
+	 * as the record data in floats. The flag is ignored for impulse responses.
+	 *
+	 * With #DAFF_OPEN_STREAM, the file is opened like with #DAFF_OPEN_LAZY and a worker thread
+	 * streams the record data into the cache, which is enlarged to hold all of it. Files written
+	 * with resolution levels (see DAFFWriter::setNumLevels) are streamed from a coarse subgrid
+	 * to the full grid, and getNearestNeighbour() refines with every streamed level, so that a
+	 * preview is available long before the whole file has been read (see getNumLoadedLevels()).
+	 *
+	 * @param sFilePath    Path to the DAFF file
+	 * @param iOpenFlags   Combination of #DAFF_OPEN_FLAGS
+	 *
 	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
 	 */
-	virtual int openFile(const std::string& sFilePath) = 0;
+	virtual int openFile(const std::string& sFilePath, int iOpenFlags = DAFF_OPEN_DEFAULT) = 0;
+
+	//! Opens DAFF content from a custom data source
+	/**
+	 * Reads the DAFF content through the given source instead of a file.
+	 * If the source provides its content in memory (DAFFDataSource::map()),
+	 * the record descriptors and the record data are accessed in place.
+	 * With #DAFF_OPEN_LAZY, record data is read through the source on first access.
+	 * The source is not owned by the reader. In these two cases it must stay alive
+	 * until closeFile() is called or the reader is destroyed.
+	 *
+	 * @param pSource      Data source
+	 * @param iOpenFlags   Combination of #DAFF_OPEN_FLAGS (#DAFF_OPEN_MAPPED has no effect)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int openSource(DAFFDataSource* pSource, int iOpenFlags = DAFF_OPEN_DEFAULT) = 0;
+
+	//! Opens a DAFF file asynchronously
+	/**
+	 * Starts opening the file like openFile() on a worker thread and returns immediately,
+	 * so that a GUI stays responsive and many files can be loaded concurrently (one reader each).
+	 * The callback receives the progress and the result. Until the opening has completed
+	 * (isOpening() returns false), only isOpening(), isFileOpened(), isValid(), cancelOpen() and
+	 * waitForOpen() may be called, closeFile() and the destructor cancel the opening and wait for it.
+	 *
+	 * @param sFilePath    Path to the DAFF file
+	 * @param pCallback    Receiver of the progress and the result (may be NULL, must outlive the opening)
+	 * @param iOpenFlags   Combination of #DAFF_OPEN_FLAGS
+	 *
+	 * @return #DAFF_NO_ERROR if the opening has been started, #DAFF_MODAL_ERROR if a file is opened or being opened
+	 */
+	virtual int openFileAsync(const std::string& sFilePath, DAFFOpenCallback* pCallback = NULL,
+							  int iOpenFlags = DAFF_OPEN_DEFAULT) = 0;
+
+	//! Returns whether an asynchronous opening is in progress
+	virtual bool isOpening() const = 0;
+
+	//! Requests the cancellation of an asynchronous opening
+	/**
+	 * Returns immediately, the opening then fails with #DAFF_OPEN_CANCELLED as soon as
+	 * possible. If it completes nonetheless, the file is opened.
+	 */
+	virtual void cancelOpen() = 0;
+
+	//! Waits for the completion of an asynchronous opening
+	/**
+	 * Must not be called from the callback.
+	 *
+	 * @return Result of the last asynchronous opening, #DAFF_MODAL_ERROR if none has been started
+	 */
+	virtual int waitForOpen() = 0;
 
 	//! Closes an opened DAFF file
 	/**
@@ -149,15 +285,335 @@ class DAFF_API DAFFReader {
 	//! Returns the name of the opened DAFF file
 	virtual std::string getFilename() const = 0;
 
+	//! Indicates whether record data is loaded on demand (#DAFF_OPEN_LAZY)
+	/**
+	 * Zero-copy pointers of lazily loaded contents are only valid until the next data access.
+	 */
+	virtual bool isLazy() const = 0;
+
+	//! Indicates whether the record data is stored in a compressed data block
+	/**
+	 * Compressed record data is decompressed at load, or chunk by chunk on demand with #DAFF_OPEN_LAZY.
+	 */
+	virtual bool isCompressed() const = 0;
+
+	//! Indicates whether the file contains checksums of its blocks (verified with #DAFF_OPEN_VERIFY)
+	virtual bool hasChecksums() const = 0;
+
+	//! Indicates whether the file contains the statistics of its record channels (see DAFFWriter::setStatistics)
+	/**
+	 * With the statistics block, peaks and record statistics are available at once. Otherwise
+	 * they are computed from all records on first request.
+	 */
+	virtual bool hasStatistics() const = 0;
+
+	//! Returns the guaranteed alignment of the record data of the zero-copy views [Bytes]
+	/**
+	 * The record channel data returned by the zero-copy accessors (e.g. getMagnitudesPtr()) is
+	 * aligned to at least this boundary, so aligned SIMD loads can be used with an alignment of
+	 * 32 (AVX) or 64 (AVX-512). Files written with
+	 * DAFFWriter::setDataAlignment provide the chosen alignment when loaded or mapped as a whole,
+	 * decoded and truncated data (#DAFF_OPEN_DECODE, #DAFF_OPEN_TRUNCATE) is 32-byte aligned and
+	 * lazily loaded data (#DAFF_OPEN_LAZY) 64-byte aligned.
+	 *
+	 * @return Alignment (power of two, at most 64), 0 if no file is loaded
+	 */
+	virtual int getDataAlignment() const = 0;
+
+	//! Returns a read-only pointer to the 16-bit floating point data of a record channel
+	/**
+	 * Zero-copy access to the raw samples of #DAFF_FLOAT16 and #DAFF_BFLOAT16 contents in system
+	 * byte order, e.g. for processing pipelines that consume half-precision values directly.
+	 * Impulse responses deliver their effective coefficients (see DAFFContentIR::getEffectiveFilterBounds),
+	 * complex-valued spectra interleaved values. The pointer stays valid as long as the file is opened,
+	 * with #DAFF_OPEN_LAZY only until the next data access. Decoded and truncated data
+	 * (#DAFF_OPEN_DECODE, #DAFF_OPEN_TRUNCATE) is converted to floats and not available.
+	 *
+	 * \param [in]  iRecordIndex  Record index (direction)
+	 * \param [in]  iChannel      Channel index
+	 * \param [out] iNumValues    Number of 16-bit values
+	 *
+	 * @return Pointer to the values, NULL for other quantizations or on invalid indices
+	 */
+	virtual const unsigned short* getRecordChannelData16Ptr(int iRecordIndex, int iChannel, int& iNumValues) const = 0;
+
+	//! Returns a read-only pointer to the record channel data in its quantization in memory
+	/**
+	 * Zero-copy access to the samples of a record channel of any quantization, e.g. for typed
+	 * kernels that are specialized per quantization at compile time (see DAFFTypedIRView). The
+	 * values are those of getRecordChannelData16Ptr(), or floats after decoding or truncation
+	 * (#DAFF_OPEN_DECODE, #DAFF_OPEN_TRUNCATE). #DAFF_INT24 samples take up three bytes each
+	 * (little endian), #DAFF_INT16_BFP samples are scaled by getRecordChannelScale(). The pointer
+	 * stays valid as long as the file is opened, with #DAFF_OPEN_LAZY only until the next data access.
+	 *
+	 * \param [in]  iRecordIndex  Record index (direction)
+	 * \param [in]  iChannel      Channel index
+	 * \param [out] iQuantization Quantization of the values, one of #DAFF_QUANTIZATIONS
+	 * \param [out] iNumValues    Number of values
+	 *
+	 * @return Pointer to the values, NULL on invalid indices or unreadable data
+	 */
+	virtual const void* getRecordChannelRawDataPtr(int iRecordIndex, int iChannel, int& iQuantization,
+												   int& iNumValues) const = 0;
+
+	//! Returns the block scale of a record channel of #DAFF_INT16_BFP impulse responses
+	/**
+	 * Block floating point samples x represent the coefficients x / 32767 * scale. Decoded and
+	 * truncated data (#DAFF_OPEN_DECODE, #DAFF_OPEN_TRUNCATE) already contains the scales.
+	 *
+	 * @return Scale of the samples of getRecordChannelRawDataPtr(), 1 for other quantizations or on invalid indices
+	 */
+	virtual float getRecordChannelScale(int iRecordIndex, int iChannel) const = 0;
+
+	//! Returns the number of record channels that share their data with another record channel
+	/**
+	 * Record channels whose descriptors refer to the same data (see DAFFWriter::setDeduplication)
+	 * are decoded, truncated, cached and analyzed only once, their zero-copy pointers are equal.
+	 */
+	virtual int getNumSharedRecordChannels() const = 0;
+
+	//! Returns the symmetry of the stored records (see #DAFF_SYMMETRIES)
+	/**
+	 * Symmetric files store a part of the grid only (see DAFFWriter::setSymmetry). The reader
+	 * expands them to the full grid, all records and channels are accessed as usual.
+	 */
+	virtual int getSymmetry() const = 0;
+
+	//! Returns the number of records stored in the file (less than the number of records for symmetric files)
+	virtual int getNumStoredRecords() const = 0;
+
+	//! Returns the number of channels stored in the file (more than the number of channels with a channel selection)
+	virtual int getNumStoredChannels() const = 0;
+
+	//! Returns the number of resolution levels of the record data (see DAFFWriter::setNumLevels)
+	/**
+	 * Files without levels have a single one, 0 is returned if no file is loaded.
+	 */
+	virtual int getNumLevels() const = 0;
+
+	//! Returns the number of resolution levels whose record data is available at once
+	/**
+	 * All levels, unless the file is being streamed (#DAFF_OPEN_STREAM). Then the count rises
+	 * while the worker proceeds, and getNearestNeighbour() returns the nearest record of the
+	 * streamed levels (of the full grid before the first level is complete). Other accesses
+	 * (e.g. getCell()) refer to the full grid, records not streamed yet are loaded on demand.
+	 */
+	virtual int getNumLoadedLevels() const = 0;
+
+	//! Returns the order of the record data within the data block (see DAFFWriter::setRecordOrder)
+	/**
+	 * One of #DAFF_RECORD_ORDERS, #DAFF_RECORD_ORDER_INDEX for files without record order block.
+	 */
+	virtual int getRecordOrder() const = 0;
+
+	//! Returns the records stored next to a record, e.g. for prefetching a neighbourhood
+	/**
+	 * Determines the records whose data is stored up to iRadius positions before or after the
+	 * data of the record (including the record), in the order of the data. With a record order
+	 * along a curve these are records of nearby directions, which can be passed on to
+	 * prefetchRecords(). Records sharing data (symmetry, deduplication) are ordered by index.
+	 *
+	 * \param [in] iRecordIndex		Record index
+	 * \param [in] iRadius			Number of stored records before and after the record
+	 * \param [out] viRecordIndices	Record indices in the order of the data
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if no file is loaded,
+	 *		   #DAFF_INVALID_INDEX for an invalid record index or a negative radius
+	 */
+	virtual int getStorageNeighbours(int iRecordIndex, int iRadius, std::vector<int>& viRecordIndices) const = 0;
+
+	//! Returns the maximum size of the record data cache used by #DAFF_OPEN_LAZY [Bytes]
+	virtual size_t getLazyCacheSize() const = 0;
+
+	//! Sets the maximum size of the record data cache used by #DAFF_OPEN_LAZY [Bytes]
+	/**
+	 * The default is 16 MiB. A single record channel is always cached, even if
+	 * it exceeds the given size. Can be changed at any time, surplus entries are dropped.
+	 */
+	virtual void setLazyCacheSize(size_t nMaxBytes) = 0;
+
+	//! Returns the energy threshold of the tail truncation used by #DAFF_OPEN_TRUNCATE [dB]
+	virtual float getTruncationThreshold() const = 0;
+
+	//! Sets the energy threshold of the tail truncation used by #DAFF_OPEN_TRUNCATE [dB]
+	/**
+	 * With #DAFF_OPEN_TRUNCATE, the tail of every impulse response is dropped as long as
+	 * its energy stays below the given threshold relative to the energy of the whole
+	 * impulse response. The remaining coefficients are repacked contiguously as floats.
+	 * The default is -60 dB. Applies to files opened afterwards.
+	 *
+	 * \param [in] fThresholdDB	Threshold [dB] (negative, e.g. -60)
+	 */
+	virtual void setTruncationThreshold(float fThresholdDB) = 0;
+
+	//! Returns the stored channels selected for the files opened afterwards (empty: all channels)
+	virtual std::vector<int> getChannelSelection() const = 0;
+
+	//! Selects the stored channels loaded from the files opened afterwards
+	/**
+	 * Contents of many channels (e.g. microphone arrays) are often used with a few of them only.
+	 * With a selection, the reader holds the given stored channels in the given order. The
+	 * record channels of the selection are read through their descriptor offsets and packed
+	 * contiguously, the data of the other channels is neither read nor decoded (mapped files and
+	 * borrowed buffers are not touched there). Channel indices, getNumberOfChannels() and
+	 * getChannelLabel() refer to the selection, getNumStoredChannels() to the file. Compressed
+	 * data is decompressed as a whole. Opening fails with #DAFF_INVALID_INDEX if a selected
+	 * channel does not exist. The default is an empty selection (all channels).
+	 *
+	 * \param [in] viChannels	Stored channel indices (empty: all channels)
+	 */
+	virtual void setChannelSelection(const std::vector<int>& viChannels) = 0;
+
+	//! Returns the region of the records loaded from the files opened afterwards
+	virtual DAFFRegion getRegion() const = 0;
+
+	//! Restricts the records loaded from the files opened afterwards to an angular region
+	/**
+	 * Renderers of a limited field (e.g. sources in the frontal hemisphere) need a part of the
+	 * records only. With a region, the reader holds the records of the region in their stored
+	 * order, the data of the other records is neither read nor decoded (like with a channel
+	 * selection, see setChannelSelection). Record indices and getNumberOfRecords() refer to the
+	 * loaded records, getRegionRecords() maps them to the records of the full grid.
+	 *
+	 * Beta ranges of regular grids keep the grid, restricted to the rows of the range. All other
+	 * regions hold the loaded records with their directions like an irregular grid (isRegularGrid()
+	 * returns false). getNearestNeighbour() returns the closest loaded record, bOutOfBounds is set
+	 * for directions outside of the region: outside of the row range or the cone, or closer to a
+	 * record of the full grid that is not in the record list. The cone is converted to the data
+	 * view with the default orientation of the file. Levels are not used with a region.
+	 *
+	 * Opening fails with #DAFF_INVALID_INDEX if the region holds no records or lists a record that
+	 * does not exist. The default is #DAFF_REGION_ALL.
+	 *
+	 * \param [in] oRegion	Region of the records
+	 */
+	virtual void setRegion(const DAFFRegion& oRegion) = 0;
+
+	//! Returns the record indices of the full grid of the loaded records (empty: all records loaded)
+	virtual std::vector<int> getRegionRecords() const = 0;
+
+	//! Returns true if closeFile() keeps the memory of the file blocks for the next file
+	virtual bool getKeepCapacity() const = 0;
+
+	//! Sets whether closeFile() keeps the memory of the file blocks for the next file
+	/**
+	 * The headers, record descriptors, metadata and stored record data of a file share a single
+	 * allocation (arena). With kept capacity, closing a file keeps the arena and the record index,
+	 * and opening a file that fits into them does not allocate them again (e.g. for readers that
+	 * are closed and reopened constantly, see DAFFReaderPool). The default is off. Disabling
+	 * releases the kept memory right away if no file is opened, otherwise when it is closed.
+	 *
+	 * \param [in] bKeep	Keep the capacity?
+	 */
+	virtual void setKeepCapacity(bool bKeep) = 0;
+
+	//! Returns the capacity of the arena of the file blocks [Bytes]
+	virtual size_t getCapacity() const = 0;
+
+	//! Allocates the arena of the file blocks ahead of opening files
+	/**
+	 * Enables kept capacity (see setKeepCapacity()). The arena is not changed if it is already
+	 * large enough or a file is opened. Check getCapacity() for the result.
+	 *
+	 * \param [in] nBytes	Capacity [Bytes]
+	 */
+	virtual void reserveCapacity(size_t nBytes) = 0;
+
+	//! Returns the wall times and sizes of the phases of the last load
+	/**
+	 * Every call of openFile(), openSource() and deserialize() measures its phases (a few clock
+	 * reads per load). A failed load keeps the phases up to the error, its total time is zero.
+	 * The values are kept after closeFile() and reset by the next load.
+	 *
+	 * \param [out] oStats	Load statistics
+	 */
+	virtual void getLoadStats(DAFFLoadStats& oStats) const = 0;
+
+	//! Returns the heap memory held by the reader, broken down by category
+	/**
+	 * Counts the blocks, tables, caches and lazily built structures (statistics, direction index,
+	 * metadata sets) as currently allocated. Transformers and visualizations attached to the
+	 * content report their own memory (e.g. DAFFTransformerIR2DFT::getMemoryFootprint()).
+	 *
+	 * \param [out] oFootprint	Memory footprint
+	 */
+	virtual void getMemoryFootprint(DAFFMemoryFootprint& oFootprint) const = 0;
+
 
 	// --= Serialization methods =--
 
 	//! Deserializes DAFF content from a byte buffer
+	/**
+	 * Copies the content out of the buffer. The buffer size is unknown, so
+	 * no bounds checks are possible. Prefer the sized variant.
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
 	virtual int deserialize(char* pDAFFDataBuffer) = 0;
 
+	//! Deserializes DAFF content from a byte buffer of known size
+	/**
+	 * All file blocks are validated against the buffer size. If bBorrow is set,
+	 * the record descriptors and the record data are not copied but accessed
+	 * directly inside the buffer. The caller then has to keep the buffer alive
+	 * and unmodified until closeFile() is called or the reader is destroyed.
+	 * On big endian systems or if the record data is not 4-byte aligned in memory,
+	 * the content is copied anyway.
+	 *
+	 * @param pDAFFDataBuffer  Buffer with the complete DAFF file data
+	 * @param nSize            Size of the buffer [Bytes]
+	 * @param bBorrow          Access the data inside the buffer instead of copying it
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	virtual int deserialize(const char* pDAFFDataBuffer, size_t nSize, bool bBorrow = false) = 0;
+
 	virtual bool isValid() const = 0;
 
 
+	// --= Shared memory =--
+
+	//! Publishes the loaded content in a named shared-memory segment
+	/**
+	 * The segment holds the image of the file and, if the reader has decoded or truncated the
+	 * record data (#DAFF_OPEN_DECODE, #DAFF_OPEN_TRUNCATE), the resulting float data. Other
+	 * processes attach to it with attachShared() and access the content in place, so there is
+	 * one copy of the (decoded) data per machine. The reader keeps the segment until
+	 * closeFile() is called or the reader is destroyed. Closing removes the name (POSIX) or
+	 * the segment is destroyed with its last handle (Windows). Readers that are already
+	 * attached stay valid in both cases.
+	 *
+	 * The file image is taken from the mapping (#DAFF_OPEN_MAPPED) or read from the file again.
+	 * It is compared against the loaded file headers. Only readers opened with openFile() can publish,
+	 * and only with all channels and records (see setChannelSelection and setRegion). Attaching readers
+	 * can select channels and regions.
+	 *
+	 * \param [in] sName	Name of the segment (POSIX: without slashes, Windows: in the "Local\" namespace)
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if the reader has not been opened from a file,
+	 *		   holds a channel selection or a region, already publishes a segment, is attached or the name
+	 *		   is in use (e.g. after a crash on POSIX systems: remove /dev/shm/<name>), #DAFF_FILE_INVALID if
+	 *		   the segment could not be created or the file has changed
+	 */
+	virtual int publishShared(const std::string& sName) = 0;
+
+	//! Attaches to the content published by another reader (read-only, zero-copy)
+	/**
+	 * The record descriptors, the record data and the decoded float data of the publisher are
+	 * accessed in the segment, only the headers and the record index are built locally.
+	 * That makes attaching almost instant. Compressed record data is decompressed by each
+	 * attached reader, unless the publisher has decoded it. The reader behaves like a reader
+	 * opened with the flags of the publisher, but isFileOpened() returns false
+	 * (like after deserialize()). closeFile() detaches.
+	 *
+	 * \param [in] sName	Name of the segment
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_FILE_NOT_FOUND if no complete segment of the name exists,
+	 *		   #DAFF_MODAL_ERROR if the reader is not empty, another #DAFF_ERROR for invalid segments
+	 */
+	virtual int attachShared(const std::string& sName) = 0;
+
+
 	// --= Properties =--
 
 	//! Returns the DAFF version of the file format
@@ -172,6 +628,38 @@ class DAFF_API DAFFReader {
 	//! Returns the metadata
 	virtual const DAFFMetadata* getMetadata() const = 0;
 
+	//! Returns the values of a key of the record metadata as a column (one value per record)
+	/**
+	 * Looking up a key in the metadata of every record (DAFFContent::getRecordMetadata) parses
+	 * all metadata sets once per query. The column holds the value of the key for all records
+	 * as floats instead: boolean keys as 0 or 1, integer and floating-point keys as their value
+	 * (rounded to single precision), and NaN for string keys and for records without the key.
+	 * The column of a key (case-insensitive) is built on first access from the metadata sets
+	 * and kept until the file is closed (thread-safe).
+	 *
+	 * \param [in] sKey	Key name
+	 *
+	 * @return Column of getNumberOfRecords() values, NULL if no record has a numerical value for the key
+	 */
+	virtual const float* getRecordMetadataColumn(const std::string& sKey) const = 0;
+
+	//! Selects the records by comparing a value with a key of their metadata
+	/**
+	 * Evaluates the comparison of the column of the key (see getRecordMetadataColumn) with vector
+	 * instructions, e.g. selectRecords("quality", DAFF_GE, 0.9f, vi) for all records with a quality
+	 * of at least 0.9. Records without a numerical value for the key are never selected (not even
+	 * by #DAFF_NE).
+	 *
+	 * \param [in] sKey				Key name (case-insensitive)
+	 * \param [in] iOperator		Comparison operator, one of #DAFF_COMPARISONS
+	 * \param [in] fValue			Value compared with (right-hand side)
+	 * \param [out] viRecordIndices	Indices of the selected records (ascending)
+	 *
+	 * @return Number of selected records
+	 */
+	virtual int selectRecords(const std::string& sKey, int iOperator, float fValue,
+							  std::vector<int>& viRecordIndices) const = 0;
+
 	//! Returns the properties of the file
 	virtual DAFFProperties* getProperties() const = 0;
 
@@ -0,0 +1,93 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_READERPOOL
+#define IW_DAFF_READERPOOL
+
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+#include <mutex>
+#include <vector>
+
+// Forward declarations
+class DAFFReader;
+
+//! Pool of readers that are reused instead of being created and deleted
+/**
+ * Applications that open and close readers constantly (e.g. as sound sources enter and leave
+ * a scene) take readers from the pool and give them back instead of deleting them. The readers
+ * keep their capacity across closeFile() (see DAFFReader::setKeepCapacity), so once they have
+ * been warmed up by files of the typical size or reserved ahead, opening a file does not allocate
+ * its blocks again.
+ *
+ * The most recently released reader is handed out first. Settings changed by a user (e.g. the
+ * truncation threshold) stay with the reader. All methods are thread-safe, a reader is used by
+ * one user at a time. Readers that are still acquired when the pool is destroyed belong to their
+ * users (delete them as usual).
+ */
+class DAFF_API DAFFReaderPool {
+  public:
+	//! Constructor
+	/**
+	 * \param [in] iNumReaders	Number of idle readers created ahead
+	 * \param [in] nCapacity		Capacity reserved per reader [Bytes] (0: grown by the files opened)
+	 */
+	DAFFReaderPool(int iNumReaders = 0, size_t nCapacity = 0);
+
+	//! Destructor (deletes the idle readers)
+	virtual ~DAFFReaderPool();
+
+	//! Returns the capacity reserved per reader [Bytes]
+	size_t getCapacity() const;
+
+	//! Returns the number of idle readers
+	int getNumIdleReaders() const;
+
+	//! Creates idle readers until the given number is available
+	/**
+	 * \param [in] iNumReaders	Number of idle readers
+	 */
+	void reserve(int iNumReaders);
+
+	//! Takes a reader out of the pool
+	/**
+	 * Hands out an idle reader or creates a new one, if none is available.
+	 *
+	 * @return Reader without an opened file, which keeps its capacity
+	 */
+	DAFFReader* acquire();
+
+	//! Gives a reader back to the pool
+	/**
+	 * Closes the file of the reader (cancels an asynchronous opening).
+	 *
+	 * \param [in] pReader	Reader (NULL is ignored)
+	 */
+	void release(DAFFReader* pReader);
+
+	//! Deletes the idle readers
+	void clear();
+
+  private:
+	size_t m_nCapacity;                        //!@ Capacity reserved per reader [Bytes]
+	std::vector<DAFFReader*> m_vpIdleReaders;  //!@ Idle readers (most recently released last)
+	mutable std::mutex m_mxIdleReaders;        //!@ Guards the idle readers
+
+	//! Creates a reader which keeps its capacity
+	DAFFReader* createReader() const;
+
+	// No copy
+	DAFFReaderPool(const DAFFReaderPool&);
+	DAFFReaderPool& operator=(const DAFFReaderPool&);
+};
+
+#endif  // IW_DAFF_READERPOOL
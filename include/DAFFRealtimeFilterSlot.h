@@ -0,0 +1,157 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_REALTIMEFILTERSLOT
+#define IW_DAFF_REALTIMEFILTERSLOT
+
+#include <DAFFDefs.h>
+
+#include <atomic>
+
+// Forward declarations
+class DAFFContent;
+class DAFFContentDFT;
+class DAFFContentIR;
+class DAFFContentMS;
+class DAFFInterpolator;
+
+//! Hand-over of filters from a control thread to a real-time (audio) thread
+/**
+ * A control thread (e.g. head tracking) resolves directions and fetches the data of
+ * all channels into a spare buffer, which is then published by a single atomic exchange.
+ * The audio thread picks up the latest published filter with acquire(). All methods of
+ * the audio thread are wait-free and neither allocate memory nor take locks.
+ *
+ * Filters are impulse responses (IR, DAFFContentIR::getFilterCoeffs), magnitudes (MS)
+ * or interleaved DFT coefficients (DFT, DAFFContentDFT::getDFTCoeffs), interpolated
+ * filters are blended with DAFFInterpolator (add methods of the content).
+ *
+ * Four buffers rotate between the threads: the current and the previous filter of
+ * the audio thread, one buffer in transit and one of the control thread. A switch
+ * reported by acquire() is a crossfade boundary, the outgoing filter stays available
+ * through getPreviousFilter() until the next switch. Filters published faster than
+ * the audio thread acquires them replace each other (only the latest one arrives).
+ *
+ * Exactly one control thread and one audio thread may use a slot. Before the first
+ * published filter all data is zero. The slot keeps a pointer to the content, which
+ * must outlive it.
+ */
+class DAFF_API DAFFRealtimeFilterSlot {
+  public:
+	//! Constructor (allocates all buffers)
+	/**
+	 * \param [in] pContent	Content (IR, MS or DFT)
+	 */
+	DAFFRealtimeFilterSlot(const DAFFContent* pContent);
+
+	//! Destructor
+	virtual ~DAFFRealtimeFilterSlot();
+
+	//! Returns the content
+	const DAFFContent* getContent() const;
+
+	//! Returns the number of channels
+	int getNumChannels() const;
+
+	//! Returns the number of float values per channel (see DAFFInterpolator::getDataLength)
+	int getDataLength() const;
+
+	// --= Control thread =--
+
+	//! Publishes the data of a record
+	/**
+	 * \param [in] iRecordIndex	Record index
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise (nothing is published)
+	 */
+	int updateRecord(int iRecordIndex);
+
+	//! Publishes the data of the nearest neighbour record of a direction
+	/**
+	 * Nothing is published if the nearest neighbour equals the last published record,
+	 * so small movements within a record cause no crossfades.
+	 *
+	 * \param [in] iView			View, one of #DAFF_VIEWS
+	 * \param [in] fAngle1Deg	First angle (Phi or Alpha, depending on view)
+	 * \param [in] fAngle2Deg	Second angle (Theta or Beta, depending on view)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise (nothing is published)
+	 */
+	int updateNearest(int iView, float fAngle1Deg, float fAngle2Deg);
+
+	//! Publishes the bilinear interpolation of the records surrounding a direction
+	/**
+	 * \param [in] iView			View, one of #DAFF_VIEWS
+	 * \param [in] fAngle1Deg	First angle (Phi or Alpha, depending on view)
+	 * \param [in] fAngle2Deg	Second angle (Theta or Beta, depending on view)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise (nothing is published)
+	 */
+	int updateInterpolated(int iView, float fAngle1Deg, float fAngle2Deg);
+
+	// --= Audio thread (wait-free) =--
+
+	//! Switches to the latest published filter
+	/**
+	 * @return True if the filter changed (crossfade from getPreviousFilter to getFilter), false otherwise
+	 */
+	bool acquire();
+
+	//! Returns the current filter of a channel (getDataLength floats, 16-byte aligned)
+	const float* getFilter(int iChannel) const;
+
+	//! Returns the filter of a channel before the last switch (getDataLength floats, 16-byte aligned)
+	const float* getPreviousFilter(int iChannel) const;
+
+	//! Returns the record index of the current filter (-1: interpolated or none)
+	int getRecordIndex() const;
+
+  private:
+	//! Number of buffers
+	enum { NUM_BUFFERS = 4 };
+
+	//! Flag of the buffer in transit: not acquired yet
+	enum { FLAG_PUBLISHED = 8 };
+
+	const DAFFContent* m_pContent;        //!@ Content
+	const DAFFContentIR* m_pContentIR;    //!@ Content as impulse responses (or NULL)
+	const DAFFContentMS* m_pContentMS;    //!@ Content as magnitude spectra (or NULL)
+	const DAFFContentDFT* m_pContentDFT;  //!@ Content as DFT spectra (or NULL)
+	DAFFInterpolator* m_pInterpolator;    //!@ Interpolator for updateInterpolated
+	int m_iNumChannels;                   //!@ Number of channels
+	int m_iDataLength;                    //!@ Number of float values per channel
+	int m_iChannelStride;                 //!@ Distance of the channels in a buffer [floats]
+	float* m_pfData;                      //!@ Data of all buffers
+	int m_piRecord[NUM_BUFFERS];          //!@ Record index of the data in each buffer (-1: interpolated or none)
+
+	// Control thread
+	int m_iBack;           //!@ Buffer being filled
+	int m_iLastPublished;  //!@ Record index of the last published buffer (-1: interpolated or none)
+
+	// Shared
+	std::atomic<int> m_iTransit;  //!@ Buffer in transit, with #FLAG_PUBLISHED if not acquired yet
+
+	// Audio thread
+	int m_iFront;     //!@ Buffer of the current filter
+	int m_iPrevious;  //!@ Buffer of the filter before the last switch
+
+	//! Returns the data of a channel in a buffer
+	float* getChannelData(int iBuffer, int iChannel) const;
+
+	//! Hands the buffer of the control thread over to the audio thread
+	void publish(int iRecordIndex);
+
+	// No copy
+	DAFFRealtimeFilterSlot(const DAFFRealtimeFilterSlot&);
+	DAFFRealtimeFilterSlot& operator=(const DAFFRealtimeFilterSlot&);
+};
+
+#endif  // IW_DAFF_REALTIMEFILTERSLOT
@@ -34,6 +34,9 @@ class DAFF_API DAFFSCTransform {
 	//! Sets the OSC->DSC orientation (yaw-pitch-roll)
 	void setOrientation(const DAFFOrientationYPR& orient);
 
+	//! Returns the nine cached rotation constants t1..t9 of the orientation (see DAFFGPUGrid)
+	void getRotationConstants(double* pdConstants) const;
+
 	//! Transform coordinates from OSC -> DSC (including coordinate system rotation)
 	void transformOSC2DSC(float azimuth_in, float elevation_in, float& alpha_out, float& beta_out) const;
 
@@ -46,6 +49,24 @@ class DAFF_API DAFFSCTransform {
 	//! Transform coordinates from DSC -> OSC (including coordinate system rotation)
 	void transformDSC2OSC(double alpha_in, double beta_in, double& azimuth_out, double& elevation_out) const;
 
+	//! Transform many coordinates from OSC -> DSC (including coordinate system rotation)
+	/**
+	 * Single precision batch version using SIMD kernels (SSE2, AVX2 or NEON) with
+	 * polynomial trigonometric functions. The directional error is in the order
+	 * of 10^-4 degrees, far below any grid resolution (the azimuth very close to
+	 * the poles is less accurate). Platforms without SIMD support use the double
+	 * precision method for each direction.
+	 */
+	void transformOSC2DSC(const float* azimuth_in, const float* elevation_in, float* alpha_out, float* beta_out,
+						  size_t n) const;
+
+	//! Transform many coordinates from DSC -> OSC (including coordinate system rotation)
+	/**
+	 * Single precision batch version, see transformOSC2DSC
+	 */
+	void transformDSC2OSC(const float* alpha_in, const float* beta_in, float* azimuth_out, float* elevation_out,
+						  size_t n) const;
+
   private:
 	//! Cached trigenometric terms of yaw-pitch-roll angles
 	class RotationConstants {
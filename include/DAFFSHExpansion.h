@@ -0,0 +1,234 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_SH_EXPANSION
+#define IW_DAFF_SH_EXPANSION
+
+#include <DAFFDefs.h>
+#include <DAFFSCTransform.h>
+
+#include <cstring>  // required for size_t
+#include <string>
+#include <vector>
+
+// Forward declarations
+class DAFFContent;
+class DAFFContentDFT;
+
+//! Spherical harmonic (SH) expansion of directional data
+/**
+ * The expansion approximates the data of a content by spherical harmonics up to an order N,
+ * separately for every value of a channel (sample, frequency or real and imaginary part), and
+ * evaluates it at arbitrary directions. Contrary to the nearest neighbour search or the
+ * bilinear interpolation on the grid, the result varies continuously with the direction and
+ * costs (N+1)^2 multiply-adds per value, independent of the grid resolution. The coefficients
+ * of order 10 take up less memory than the records of a 1 degree grid.
+ *
+ * The values per channel are those of the content type (see getDataLength()):
+ *
+ *   - IR: filter coefficients (DAFFContentIR::getFilterCoeffs)
+ *   - MS: magnitudes (DAFFContentMS::getMagnitudes)
+ *   - PS: phases (DAFFContentPS::getPhases), fitted as they are (phase wraps are not removed)
+ *   - MPS: stored coefficient pairs (DAFFContentMPS::getCoefficientsRI)
+ *   - DFT: stored DFT coefficients, real and imaginary parts (DAFFContentDFT::getDFTCoeffs)
+ *
+ * The basis are the orthonormal real spherical harmonics in ACN order (index n*n + n + m, no
+ * Condon-Shortley phase) of the azimuth alpha and the colatitude 180&deg; - beta in data spherical
+ * coordinates (DSC). The coefficients are fitted by weighted least squares over all records
+ * in parallel, where the records of regular grids are weighted with the solid angle they
+ * represent. A small Tikhonov regularization keeps the fit stable for grids that do not cover
+ * the full sphere or have fewer records than coefficients, but the expansion is meaningless
+ * far away from the covered directions.
+ *
+ * Head-related transfer functions are expanded by magnitude least squares with fitMagLS(), which
+ * yields the binaural decoding filters of Ambisonics signals.
+ *
+ * Expansions can be stored in a file (save) and loaded later without the content (load). The
+ * object view uses the orientation of the content at the time of fitting (stored in the file),
+ * which can be changed with setOrientation(). Evaluations are const and can run concurrently.
+ */
+class DAFF_API DAFFSHExpansion {
+  public:
+	//! Maximum order
+	enum { MAX_ORDER = 31 };
+
+	//! Default constructor (empty expansion)
+	DAFFSHExpansion();
+
+	//! Destructor
+	virtual ~DAFFSHExpansion();
+
+	//! Returns true if the expansion holds coefficients (fitted or loaded)
+	bool isValid() const;
+
+	//! Returns the order N (-1 if empty)
+	int getOrder() const;
+
+	//! Returns the number of spherical harmonics (N+1)^2 (0 if empty)
+	int getNumSHCoeffs() const;
+
+	//! Returns the content type of the fitted data, one of #DAFF_CONTENT_TYPES (-1 if empty)
+	int getContentType() const;
+
+	//! Returns the number of channels (0 if empty)
+	int getNumChannels() const;
+
+	//! Returns the number of float values per channel written by evaluate()
+	/**
+	 * Filter length for IR, number of frequencies for MS and PS, 2*number of frequencies for MPS
+	 * and 2*getNumDFTCoeffs() for DFT content (interleaved like the record data), 0 if empty.
+	 */
+	int getDataLength() const;
+
+	//! Returns the relative regularization of the fit
+	float getRegularization() const;
+
+	//! Sets the relative regularization of the fit (default: 10^-4 of the mean diagonal of the normal matrix)
+	void setRegularization(float fRegularization);
+
+	//! Returns the number of threads of the fit (0: automatic)
+	int getNumThreads() const;
+
+	//! Sets the number of threads of the fit
+	/**
+	 * \param iNumThreads	Number of threads (0: number of hardware threads, 1: no worker threads)
+	 */
+	void setNumThreads(int iNumThreads);
+
+	//! Returns the orientation of the object view
+	void getOrientation(DAFFOrientationYPR& o) const;
+
+	//! Sets the orientation of the object view
+	void setOrientation(const DAFFOrientationYPR& o);
+
+	//! Free memory (empty expansion)
+	void clear();
+
+	//! Fits the expansion to the data of a content
+	/**
+	 * \param [in] pContent	Content (any content type)
+	 * \param [in] iOrder	Order N in [0, #MAX_ORDER]
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise (the expansion is cleared)
+	 */
+	int fit(const DAFFContent* pContent, int iOrder);
+
+	//! Fits the expansion to DFT spectra by magnitude least squares (Ambisonics binaural decoding filters)
+	/**
+	 * Below the cutoff frequency the DFT coefficients are fitted by complex least squares like fit().
+	 * Above it, where the phase of head-related transfer functions varies too fast over the directions
+	 * for the order, only the magnitudes are fitted: starting from the least squares fit, the phases of
+	 * the records are repeatedly replaced by the phases of the expansion and fitted again, which keeps
+	 * the magnitudes (and the interaural level differences) correct at the expense of phase errors that
+	 * are inaudible at high frequencies. The DFT coefficients are fitted independently in parallel.
+	 *
+	 * For HRTFs, the coefficient rows of each ear are the SH-domain binaural decoding filters of an
+	 * Ambisonics signal of the same normalization (orthonormal real SH in ACN order): the ear spectrum
+	 * is the sum over k of the SH signal k times the row k (interleaved DFT coefficients). Impulse
+	 * responses can be fitted through a DAFFTransformerIR2DFT, the filters are cached with save().
+	 *
+	 * \param [in] pContent			DFT spectra (e.g. head-related transfer functions)
+	 * \param [in] iOrder			Order N in [0, #MAX_ORDER]
+	 * \param [in] fCutoffFrequency	Cutoff frequency [Hz] (optional, 0: N * 624 Hz for a head of 8.75 cm radius)
+	 * \param [in] iNumIterations	Phase iterations per DFT coefficient above the cutoff (optional)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise (the expansion is cleared)
+	 */
+	int fitMagLS(const DAFFContentDFT* pContent, int iOrder, float fCutoffFrequency = 0.0f, int iNumIterations = 10);
+
+	//! Returns the coefficients of a channel
+	/**
+	 * The coefficients are laid out as getNumSHCoeffs() consecutive rows of getDataLength()
+	 * floats, the row k holding the coefficient of the spherical harmonic k for all values.
+	 *
+	 * \param [in] iChannel	Channel index
+	 *
+	 * @return Pointer to the coefficients (NULL if empty or on invalid channels)
+	 */
+	const float* getCoefficientsPtr(int iChannel) const;
+
+	//! Evaluates the expansion of a channel at a direction
+	/**
+	 * \param [in] iView			View, one of #DAFF_VIEWS
+	 * \param [in] fAngle1Deg	First angle (Phi or Alpha, depending on view)
+	 * \param [in] fAngle2Deg	Second angle (Theta or Beta, depending on view)
+	 * \param [in] iChannel		Channel index
+	 * \param [out] pfDest		Destination buffer (size >= getDataLength())
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int evaluate(int iView, float fAngle1Deg, float fAngle2Deg, int iChannel, float* pfDest) const;
+
+	//! Evaluates the expansion of a channel at many directions at once
+	/**
+	 * The spherical harmonics of the directions are computed by a SIMD kernel in blocks.
+	 *
+	 * \param [in] iView			View, one of #DAFF_VIEWS
+	 * \param [in] pfAngles1Deg	First angles (Phi or Alpha, depending on view), n elements
+	 * \param [in] pfAngles2Deg	Second angles (Theta or Beta, depending on view), n elements
+	 * \param [in] iChannel		Channel index
+	 * \param [out] pfDest		Destination buffer, getDataLength() floats per direction (n * getDataLength())
+	 * \param [in] n				Number of directions
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int evaluate(int iView, const float* pfAngles1Deg, const float* pfAngles2Deg, int iChannel, float* pfDest,
+				 size_t n) const;
+
+	//! Computes the spherical harmonics of a direction in data spherical coordinates
+	/**
+	 * \param [in] iOrder		Order N in [0, #MAX_ORDER]
+	 * \param [in] fAlphaDeg		Alpha angle (DSC)
+	 * \param [in] fBetaDeg		Beta angle (DSC)
+	 * \param [out] pfDest		Destination buffer, (N+1)^2 floats in ACN order
+	 */
+	static void getBasis(int iOrder, float fAlphaDeg, float fBetaDeg, float* pfDest);
+
+	//! Stores the expansion in a file
+	/**
+	 * \param [in] sFilePath	File path
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if empty, #DAFF_FILE_NOT_FOUND if not writable
+	 */
+	int save(const std::string& sFilePath) const;
+
+	//! Loads an expansion from a file
+	/**
+	 * \param [in] sFilePath	File path
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise (the expansion is cleared)
+	 */
+	int load(const std::string& sFilePath);
+
+	//! Returns the heap memory held by the expansion [Bytes]
+	size_t getMemoryFootprint() const;
+
+  private:
+	int m_iOrder;                         //!@ Order (-1: empty)
+	int m_iContentType;                   //!@ Content type of the fitted data (-1: empty)
+	int m_iNumChannels;                   //!@ Number of channels
+	int m_iDataLength;                    //!@ Number of values per channel
+	float m_fRegularization;              //!@ Relative regularization of the fit
+	int m_iNumThreads;                    //!@ Number of threads of the fit (0: automatic)
+	DAFFSCTransform m_oTransform;         //!@ Transformation of the object view
+	std::vector<float> m_vfRecurrence;    //!@ Recurrence factors of the spherical harmonics
+	std::vector<float> m_vfCoeffs;        //!@ Coefficients [channel][spherical harmonic][value]
+	std::vector<const float*> m_vpfRows;  //!@ Coefficient rows [channel][spherical harmonic]
+
+	//! Sets up an empty expansion of the given dimensions (coefficients zero)
+	void init(int iOrder, int iContentType, int iNumChannels, int iDataLength);
+
+	// No copy
+	DAFFSHExpansion(const DAFFSHExpansion&);
+	DAFFSHExpansion& operator=(const DAFFSHExpansion&);
+};
+
+#endif  // IW_DAFF_SH_EXPANSION
@@ -0,0 +1,157 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_SPHERE_INTEGRATOR
+#define IW_DAFF_SPHERE_INTEGRATOR
+
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+#include <vector>
+
+// Forward declarations
+class DAFFContent;
+class DAFFContentDFT;
+class DAFFContentMPS;
+class DAFFContentMS;
+
+//! Integration of directional data over the sphere
+/**
+ * The integrator precomputes a quadrature weight for every record of a content, the solid
+ * angle [sr] the record represents, and evaluates weighted sums over all records with them.
+ *
+ * On regular grids the records cover the cells between the midpoints of their neighbours:
+ * alpha resolution times the latitude band from half a beta step below to half a beta step
+ * above the record (clipped to the poles). The single records at the poles (beta start 0
+ * or beta end 180) take the whole polar cap of half a beta step. A grid with a single alpha
+ * point stands for the full circle, a grid with a single beta point for the full beta range.
+ * The weights of a full sphere grid add up to 4 pi. Irregular grids (and regions, see
+ * DAFFReader::setRegion) are weighted with the areas of the Voronoi cells of the records,
+ * estimated by assigning a dense quasi-uniform set of directions to their nearest records.
+ * Directions outside of a region do not count.
+ *
+ * The reductions work on spectra, the energy per frequency is the squared magnitude:
+ *
+ *   - MS, MPS: magnitudes (DAFFContentMS::getMagnitudes, DAFFContentMPS::getMagnitudes)
+ *   - DFT: stored DFT coefficients (DAFFContentDFT::getDFTCoeffs)
+ *
+ * Impulse responses are integrated through a transformer, e.g. DAFFTransformerIR2MS or
+ * DAFFTransformerIR2DFT. The records are accumulated with SIMD kernels by several threads
+ * (setNumThreads()), every call reads all records once. The methods are const and can run
+ * concurrently.
+ *
+ * The integrator keeps a pointer to the content, which must outlive it.
+ */
+class DAFF_API DAFFSphereIntegrator {
+  public:
+	//! Constructor (computes the quadrature weights)
+	/**
+	 * \param [in] pContent	Content to integrate (any content type for weights, MS, MPS or DFT for the reductions)
+	 */
+	DAFFSphereIntegrator(const DAFFContent* pContent);
+
+	//! Destructor
+	virtual ~DAFFSphereIntegrator();
+
+	//! Returns the content
+	const DAFFContent* getContent() const;
+
+	//! Returns the number of values per channel written by the reductions
+	/**
+	 * Number of frequencies for MS and MPS, getNumDFTCoeffs() for DFT content, 0 otherwise.
+	 */
+	int getDataLength() const;
+
+	//! Returns the number of worker threads of the reductions (0: automatic)
+	int getNumThreads() const;
+
+	//! Sets the number of worker threads of the reductions
+	/**
+	 * \param iNumThreads	Number of threads (0: automatic, 1: no worker threads)
+	 */
+	void setNumThreads(int iNumThreads);
+
+	//! Returns the quadrature weights of all records [sr] (one per record)
+	const float* getWeightsPtr() const;
+
+	//! Returns the quadrature weight of a record [sr]
+	float getWeight(int iRecordIndex) const;
+
+	//! Returns the solid angle covered by the records, the sum of all weights [sr]
+	float getCoveredSolidAngle() const;
+
+	//! Computes the power response of a channel, the integral of the energy over the sphere
+	/**
+	 * pfDest[k] = sum over all records r of w(r) |H(r, k)|^2
+	 *
+	 * \param [in] iChannel	Channel index
+	 * \param [out] pfDest	Destination buffer (size >= getDataLength())
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR for unsupported content types, another #DAFF_ERROR otherwise
+	 */
+	int getPowerResponse(int iChannel, float* pfDest) const;
+
+	//! Computes the diffuse-field average magnitude spectrum of a channel
+	/**
+	 * Root mean square of the magnitudes over the covered solid angle, the square root of the
+	 * power response divided by getCoveredSolidAngle(). Dividing the records by it yields the
+	 * diffuse-field equalized data.
+	 *
+	 * \param [in] iChannel	Channel index
+	 * \param [out] pfDest	Destination buffer (size >= getDataLength())
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR for unsupported content types, another #DAFF_ERROR otherwise
+	 */
+	int getDiffuseFieldAverage(int iChannel, float* pfDest) const;
+
+	//! Computes the directivity index of a channel for a direction [dB]
+	/**
+	 * Ratio of the energy of the nearest record of the direction to the mean energy over the
+	 * covered solid angle, 10 log10(|H(d, k)|^2 / |H_diffuse(k)|^2). Frequencies without energy
+	 * in all directions have an index of 0 dB.
+	 *
+	 * \param [in] iView			View, one of #DAFF_VIEWS
+	 * \param [in] fAngle1Deg	First angle (Phi or Alpha, depending on view), e.g. the main axis
+	 * \param [in] fAngle2Deg	Second angle (Theta or Beta, depending on view)
+	 * \param [in] iChannel		Channel index
+	 * \param [out] pfDestDB		Destination buffer [dB] (size >= getDataLength())
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR for unsupported content types, another #DAFF_ERROR otherwise
+	 */
+	int getDirectivityIndex(int iView, float fAngle1Deg, float fAngle2Deg, int iChannel, float* pfDestDB) const;
+
+	//! Returns the heap memory held by the integrator [Bytes]
+	size_t getMemoryFootprint() const;
+
+  private:
+	const DAFFContent* m_pContent;        //!@ Content
+	const DAFFContentMS* m_pContentMS;    //!@ Content as magnitude spectra (or NULL)
+	const DAFFContentMPS* m_pContentMPS;  //!@ Content as magnitude-phase spectra (or NULL)
+	const DAFFContentDFT* m_pContentDFT;  //!@ Content as DFT spectra (or NULL)
+	int m_iNumThreads;                    //!@ Number of worker threads (0: automatic)
+	std::vector<float> m_vfWeights;       //!@ Quadrature weights of the records [sr]
+	double m_dCoveredSolidAngle;          //!@ Sum of the weights [sr]
+
+	//! Sets up the weights of the records of a regular grid
+	void initRegularWeights();
+
+	//! Estimates the weights of the records of an irregular grid by their Voronoi cells
+	void initIrregularWeights();
+
+	//! Accumulates the weighted energies of the records [iBegin, iEnd) of a channel into pfSum
+	void accumulateRange(int iChannel, int iBegin, int iEnd, float* pfSum, int* piError) const;
+
+	// No copy
+	DAFFSphereIntegrator(const DAFFSphereIntegrator&);
+	DAFFSphereIntegrator& operator=(const DAFFSphereIntegrator&);
+};
+
+#endif  // IW_DAFF_SPHERE_INTEGRATOR
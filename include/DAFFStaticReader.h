@@ -0,0 +1,237 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_STATIC_READER
+#define IW_DAFF_STATIC_READER
+
+#include <DAFFDefs.h>
+#include <DAFFSCTransform.h>
+
+#include <cstring>  // required for size_t
+#include <stdint.h>
+
+//! Record channel entry of the arena of a DAFFStaticReader
+struct DAFFStaticRecordChannel {
+	uint32_t ui32DataOffset;  //!@ Offset of the samples/coefficients within the data block [Bytes]
+	int32_t iLeadingZeros;    //!@ Leading zeros of impulse responses (0 for spectra)
+	int32_t iLength;          //!@ Number of stored values (effective filter length of impulse responses)
+	float fScale;             //!@ Block scale of #DAFF_INT16_BFP samples (1 otherwise)
+};
+
+//! Size of the arena of a DAFFStaticReader [Bytes]
+/**
+ * Compile-time bound for the largest file a reader opens (number of support frequencies is 0
+ * for impulse responses and DFT spectra), e.g. for a static buffer of 4-byte aligned words.
+ */
+#define DAFF_STATIC_READER_ARENA_SIZE(iNumRecords, iNumChannels, iNumFrequencies)           \
+	((size_t)(iNumRecords) * (size_t)(iNumChannels) * sizeof(DAFFStaticRecordChannel) + \
+	 (size_t)(iNumFrequencies) * sizeof(float))
+
+//! Heap-free reader for DAFF file images in memory (e.g. flash-resident on embedded targets)
+/**
+ * The reader accesses the record data in place (zero-copy) and never allocates memory. Its
+ * only state beyond the object itself is a caller-provided arena (see #DAFF_STATIC_READER_ARENA_SIZE
+ * and getArenaSize), which holds an aligned copy of the packed record channel descriptors and the
+ * support frequencies. All descriptor and data ranges are validated when opening, so the accessors
+ * neither check nor convert more than the requested values. Metadata is not parsed.
+ *
+ * The profile covers little-endian targets and regular grids of uncompressed files without
+ * symmetry. Other files (irregular grids, symmetry, compressed data, big-endian targets) are
+ * rejected with #DAFF_MODAL_ERROR and require DAFFReader. The image data block must be 4-byte
+ * aligned, as written by DAFFWriter, and the image and the arena must outlive the reader.
+ *
+ * Lookups and data accesses are const and can run concurrently, setOrientation must not.
+ */
+class DAFF_API DAFFStaticReader {
+  public:
+	//! Constructor (closed reader)
+	DAFFStaticReader();
+
+	//! Determines the required arena size for a file image
+	/**
+	 * \param [in] pImage		File image
+	 * \param [in] nImageSize	Size of the file image [Bytes]
+	 * \param [out] nArenaSize	Required arena size [Bytes]
+	 *
+	 * @return Error code, one of #DAFF_ERROR
+	 */
+	static int getArenaSize(const void* pImage, size_t nImageSize, size_t& nArenaSize);
+
+	//! Opens a file image
+	/**
+	 * \param [in] pImage		File image (accessed in place, must outlive the reader)
+	 * \param [in] nImageSize	Size of the file image [Bytes]
+	 * \param [in] pArena		Arena (4-byte aligned, must outlive the reader)
+	 * \param [in] nArenaSize	Size of the arena [Bytes]
+	 *
+	 * @return Error code, one of #DAFF_ERROR (#DAFF_MODAL_ERROR for a too small or misaligned arena)
+	 */
+	int open(const void* pImage, size_t nImageSize, void* pArena, size_t nArenaSize);
+
+	//! Closes the reader (the image and the arena are released)
+	void close();
+
+	//! Returns whether a file image is opened
+	bool isValid() const;
+
+	//! Returns the content type, one of #DAFF_CONTENT_TYPES
+	int getContentType() const;
+
+	//! Returns the quantization of the stored data, one of #DAFF_QUANTIZATIONS
+	int getQuantization() const;
+
+	//! Returns the number of channels
+	int getNumberOfChannels() const;
+
+	//! Returns the number of records
+	int getNumberOfRecords() const;
+
+	//! Returns the number of values of a record channel written by getRecordChannel
+	/**
+	 * Filter length of impulse responses, number of frequencies of magnitude and phase spectra,
+	 * twice the number of frequencies of magnitude-phase spectra (interleaved magnitudes and
+	 * phases) and twice the number of coefficients of DFT spectra (interleaved real and imaginary parts).
+	 */
+	int getDataLength() const;
+
+	//! Returns the sampling rate [Hz] of impulse responses and DFT spectra (0 otherwise)
+	double getSamplerate() const;
+
+	//! Returns the number of support frequencies of magnitude, phase and magnitude-phase spectra (0 otherwise)
+	int getNumFrequencies() const;
+
+	//! Returns the support frequencies [Hz] (in the arena, NULL for other content)
+	const float* getFrequencies() const;
+
+	//! Returns the number of stored DFT coefficients of DFT spectra (0 otherwise)
+	int getNumDFTCoeffs() const;
+
+	//! Returns the transform size of DFT spectra (0 otherwise)
+	int getTransformSize() const;
+
+	//! Returns the number of alpha points
+	int getAlphaPoints() const;
+
+	//! Returns the alpha angle range start and end [degrees]
+	void getAlphaRange(float& fAlphaStartDeg, float& fAlphaEndDeg) const;
+
+	//! Returns the alpha resolution [degrees]
+	float getAlphaResolution() const;
+
+	//! Returns the number of beta points
+	int getBetaPoints() const;
+
+	//! Returns the beta angle range start and end [degrees]
+	void getBetaRange(float& fBetaStartDeg, float& fBetaEndDeg) const;
+
+	//! Returns the beta resolution [degrees]
+	float getBetaResolution() const;
+
+	//! Returns whether the full alpha range [0&deg;, 360&deg;) is covered
+	bool coversFullAlphaRange() const;
+
+	//! Returns whether the full beta range [0&deg;, 180&deg;] is covered
+	bool coversFullBetaRange() const;
+
+	//! Returns the orientation of the file
+	void getDefaultOrientation(DAFFOrientationYPR& oOrientation) const;
+
+	//! Returns the orientation of the object view
+	void getOrientation(DAFFOrientationYPR& oOrientation) const;
+
+	//! Sets the orientation of the object view (opening resets it to the orientation of the file)
+	void setOrientation(const DAFFOrientationYPR& oOrientation);
+
+	//! Returns the direction of a record
+	/**
+	 * \param [in] iRecordIndex	Record index
+	 * \param [in] iView			View of the direction, one of #DAFF_VIEWS
+	 * \param [out] fAngle1Deg	First angle (Phi or Alpha, depending on view)
+	 * \param [out] fAngle2Deg	Second angle (Theta or Beta, depending on view)
+	 *
+	 * @return Error code, one of #DAFF_ERROR
+	 */
+	int getRecordCoords(int iRecordIndex, int iView, float& fAngle1Deg, float& fAngle2Deg) const;
+
+	//! Determines the nearest neighbour record of a direction (see DAFFContent::getNearestNeighbour)
+	void getNearestNeighbour(int iView, float fAngle1Deg, float fAngle2Deg, int& iRecordIndex) const;
+
+	//! Determines the nearest neighbour record of a direction and whether it is out of bounds
+	void getNearestNeighbour(int iView, float fAngle1Deg, float fAngle2Deg, int& iRecordIndex,
+							 bool& bOutOfBounds) const;
+
+	//! Determines the grid cell of a direction (see DAFFContent::getCell)
+	void getCell(int iView, float fAngle1Deg, float fAngle2Deg, DAFFQuad& qIndices) const;
+
+	//! Returns the stored (raw) data of a record channel in the image, without any copy
+	/**
+	 * \param [in] iRecordIndex		Record index
+	 * \param [in] iChannel			Channel
+	 * \param [out] pData			Stored values in the quantization of the file (little endian, #DAFF_INT16_BFP
+	 *								samples scaled by getRecordChannelScale)
+	 * \param [out] iLeadingZeros	Leading zeros before the stored values (impulse responses, 0 otherwise)
+	 * \param [out] iLength			Number of stored values (pairs count twice)
+	 *
+	 * @return Error code, one of #DAFF_ERROR
+	 */
+	int getRecordChannelData(int iRecordIndex, int iChannel, const void*& pData, int& iLeadingZeros,
+							 int& iLength) const;
+
+	//! Returns the block scale of a record channel of #DAFF_INT16_BFP impulse responses (1 otherwise)
+	float getRecordChannelScale(int iRecordIndex, int iChannel) const;
+
+	//! Converts the data of a record channel into floats
+	/**
+	 * \param [in] iRecordIndex	Record index
+	 * \param [in] iChannel		Channel
+	 * \param [out] pfDest		Destination, getDataLength() values (impulse responses including the zeros)
+	 *
+	 * @return Error code, one of #DAFF_ERROR
+	 */
+	int getRecordChannel(int iRecordIndex, int iChannel, float* pfDest) const;
+
+  private:
+	const char* m_pDataBlock;                    //!@ Data block in the image
+	const DAFFStaticRecordChannel* m_pChannels;  //!@ Record channel table in the arena
+	const float* m_pfFrequencies;                //!@ Support frequencies in the arena
+	int m_iContentType;                          //!@ Content type
+	int m_iQuantization;                         //!@ Quantization of the stored data
+	int m_iNumChannels;                          //!@ Number of channels
+	int m_iNumRecords;                           //!@ Number of records
+	int m_iElementsPerRecord;                    //!@ Elements per record (filter length, frequencies, coefficients)
+	int m_iNumFrequencies;                       //!@ Number of support frequencies
+	int m_iNumDFTCoeffs;                         //!@ Number of stored DFT coefficients
+	int m_iTransformSize;                        //!@ DFT transform size
+	float m_fSamplerate;                         //!@ Sampling rate [Hz]
+	int m_iAlphaPoints;                          //!@ Number of alpha points
+	float m_fAlphaStart, m_fAlphaEnd;            //!@ Alpha range [degrees]
+	float m_fAlphaResolution;                    //!@ Alpha resolution [degrees]
+	int m_iBetaPoints;                           //!@ Number of beta points
+	float m_fBetaStart, m_fBetaEnd;              //!@ Beta range [degrees]
+	float m_fBetaResolution;                     //!@ Beta resolution [degrees]
+	DAFFOrientationYPR m_oDefaultOrientation;    //!@ Orientation of the file
+	DAFFSCTransform m_oTransform;                //!@ Transform of the object view
+
+	//! Parses the headers of an image, the arena may be NULL (only the size is determined)
+	int parse(const char* pImage, size_t nImageSize, char* pArena, size_t& nArenaSize);
+
+	//! Nearest neighbour of a normalized direction in the data view
+	void getNearestNeighbourNormalizedDSC(float fAlpha, float fBeta, int& iRecordIndex, bool& bOutOfBounds) const;
+
+	//! Record index of grid indices
+	int getGridRecordIndex(int iAlphaIndex, int iBetaIndex) const;
+
+	// No copy
+	DAFFStaticReader(const DAFFStaticReader&);
+	DAFFStaticReader& operator=(const DAFFStaticReader&);
+};
+
+#endif  // IW_DAFF_STATIC_READER
@@ -0,0 +1,121 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_TRAJECTORY_PLANNER
+#define IW_DAFF_TRAJECTORY_PLANNER
+
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+#include <vector>
+
+// Forward declarations
+class DAFFContent;
+
+//! Pure data class for consecutive trajectory frames with the same nearest neighbour
+struct DAFF_API DAFFTrajectoryRecordRun {
+	double dStartTime;  //!< Time stamp of the first frame, i.e. the switch point [s]
+	int iFirstFrame;    //!< Index of the first frame
+	int iNumFrames;     //!< Number of frames
+	int iRecordIndex;   //!< Record index of the nearest neighbour
+};
+
+//! Pure data class for consecutive trajectory frames within the same grid cell
+struct DAFF_API DAFFTrajectoryCellRun {
+	double dStartTime;  //!< Time stamp of the first frame, i.e. the switch point [s]
+	int iFirstFrame;    //!< Index of the first frame
+	int iNumFrames;     //!< Number of frames
+	DAFFQuad qIndices;  //!< Record indices of the cell (sequence of DAFFInterpolator::getWeights)
+};
+
+//! Lookup planning for a known trajectory of directions (e.g. a moving source in offline auralization)
+/**
+ * Instead of resolving the directions frame by frame, the planner resolves a whole time-stamped
+ * trajectory at once and delivers the result run-length encoded: the runs of frames with the
+ * same nearest neighbour, the runs of frames within the same grid cell with the bilinear weights
+ * of every frame (see DAFFInterpolator), and the sorted set of records used. A renderer can thus
+ * prefetch exactly the records it needs and fetch every record once per run.
+ *
+ * Consecutive frames with the same direction (e.g. resting sources) are resolved once, the other
+ * directions with the batch nearest neighbour search of the content (DAFFContent::getNearestNeighbours),
+ * which normalizes and transforms them block by block. Cells require a regular grid.
+ *
+ * The planner keeps a pointer to the content, which must outlive it.
+ */
+class DAFF_API DAFFTrajectoryPlanner {
+  public:
+	//! Constructor
+	/**
+	 * \param [in] pContent	Content (any content type)
+	 */
+	DAFFTrajectoryPlanner(const DAFFContent* pContent);
+
+	//! Destructor
+	virtual ~DAFFTrajectoryPlanner();
+
+	//! Returns the content
+	const DAFFContent* getContent() const;
+
+	//! Resolves a trajectory
+	/**
+	 * \param [in] iView			View, one of #DAFF_VIEWS
+	 * \param [in] pdTimes		Time stamps of the frames [s] (non-decreasing), n elements
+	 * \param [in] pfAngles1Deg	First angles (Phi or Alpha, depending on view), n elements
+	 * \param [in] pfAngles2Deg	Second angles (Theta or Beta, depending on view), n elements
+	 * \param [in] n				Number of frames
+	 * \param [in] bCells		Determine the cells and weights as well? (requires a regular grid)
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR on invalid views, decreasing time stamps or cells
+	 *         on irregular grids (the plan is cleared on errors)
+	 */
+	int plan(int iView, const double* pdTimes, const float* pfAngles1Deg, const float* pfAngles2Deg, size_t n,
+			 bool bCells = true);
+
+	//! Free memory (empty plan)
+	void clear();
+
+	//! Returns the number of frames of the plan
+	int getNumFrames() const;
+
+	//! Returns true if the plan contains cells and weights
+	bool hasCells() const;
+
+	//! Returns the runs of frames with the same nearest neighbour (in the order of the frames)
+	const std::vector<DAFFTrajectoryRecordRun>& getRecordRuns() const;
+
+	//! Returns the runs of frames within the same cell (in the order of the frames, empty without cells)
+	const std::vector<DAFFTrajectoryCellRun>& getCellRuns() const;
+
+	//! Returns the bilinear weights of a frame
+	/**
+	 * \param [in] iFrame	Frame index
+	 *
+	 * @return Weights of the four records of the cell of the frame (sum 1), NULL without cells or on invalid frames
+	 */
+	const float* getWeights(int iFrame) const;
+
+	//! Returns the records used by the plan (nearest neighbours and cells), sorted ascending
+	const std::vector<int>& getRequiredRecords() const;
+
+  private:
+	const DAFFContent* m_pContent;                       //!@ Content
+	int m_iNumFrames;                                    //!@ Number of frames
+	std::vector<DAFFTrajectoryRecordRun> m_vRecordRuns;  //!@ Runs of frames with the same nearest neighbour
+	std::vector<DAFFTrajectoryCellRun> m_vCellRuns;      //!@ Runs of frames within the same cell
+	std::vector<float> m_vfWeights;                      //!@ Weights of the cells [frame][4]
+	std::vector<int> m_viRequiredRecords;                //!@ Records used, sorted ascending
+
+	// No copy
+	DAFFTrajectoryPlanner(const DAFFTrajectoryPlanner&);
+	DAFFTrajectoryPlanner& operator=(const DAFFTrajectoryPlanner&);
+};
+
+#endif  // IW_DAFF_TRAJECTORY_PLANNER
@@ -0,0 +1,215 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFFTRANSFORMER_DFT2IR
+#define IW_DAFFTRANSFORMER_DFT2IR
+
+#include <DAFFContentDFT.h>
+#include <DAFFContentIR.h>
+#include <DAFFDefs.h>
+
+#include <mutex>
+#include <vector>
+
+// Forward declarations
+class DAFFRecordCache;
+struct DAFFFFTPlanState;
+
+//! Transformer from Discrete Fourier spectra (DFT) into impulse responses (IR)
+/**
+ * This class is associated a DAFFContentDFT instance and transforms each spectrum into
+ * an impulse response of the transform size with an inverse real-data FFT, normalized
+ * by the transform size. It is the inverse of DAFFTransformerIR2DFT and provides a
+ * DAFFContentIR view on DAFFContentDFT datasets, with the sampling rate of the spectra.
+ * Spectra that are not complex-conjugate symmetric are reduced to their symmetric part,
+ * i.e. the real part of the inverse transform.
+ *
+ * The record channels are transformed in parallel, each thread transforms batches of
+ * spectra with one batched plan of the process-wide FFT plan cache (see
+ * DAFFTransformerIR2DFT::setPlanningRigor). The effective bounds of the impulse responses
+ * are determined on the results: leading and trailing samples below the bounds threshold
+ * (setBoundsThreshold()) relative to the peak of the impulse response are set to zero and
+ * not part of the effective filter, so that the effective and truncated getters of
+ * DAFFContentIR only touch the relevant coefficients.
+ *
+ * The transformer keeps a pointer to the input content, which must outlive it.
+ */
+class DAFF_API DAFFTransformerDFT2IR {
+  public:
+	//! Default constructor
+	DAFFTransformerDFT2IR();
+
+	//! Initializing constructor
+	/**
+	 * \param [in] pInputContent	Input data
+	 * \param [in] bTransform		Transform the data directly? [optional, default: yes]
+	 */
+	DAFFTransformerDFT2IR(const DAFFContentDFT* pInputContent, bool bTransform = true);
+
+	//! Destructor
+	virtual ~DAFFTransformerDFT2IR();
+
+	//! Returns the input content (NULL if none is assigned)
+	const DAFFContentDFT* getInputContent() const;
+
+	//! Set input content
+	/**
+	 * \param pInputContent	Input content (DFT spectra)
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setInputContent(const DAFFContentDFT* pInputContent, bool bTransform = true);
+
+	//! Get the impulse responses
+	/**
+	 * \note This method returns NULL if not input data has been assigned
+	 */
+	DAFFContentIR* getOutputContent() const;
+
+	//! Returns the threshold of the effective bounds relative to the peak of an impulse response [dB]
+	float getBoundsThreshold() const;
+
+	//! Sets the threshold of the effective bounds relative to the peak of an impulse response
+	/**
+	 * The default of -120 dB removes the rounding noise of the inverse FFT. Lower thresholds
+	 * keep more of the leading and trailing samples.
+	 *
+	 * \param fThresholdDB	Threshold [dB] (negative, e.g. -120)
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setBoundsThreshold(float fThresholdDB, bool bTransform = true);
+
+	//! Returns the number of worker threads of the transformation (0: automatic)
+	int getNumThreads() const;
+
+	//! Sets the number of worker threads of the transformation
+	/**
+	 * See DAFFTransformerIR2DFT::setNumThreads.
+	 *
+	 * \param iNumThreads	Number of threads (0: automatic, 1: no worker threads)
+	 */
+	void setNumThreads(int iNumThreads);
+
+	//! Indicates whether impulse responses are transformed on first access
+	bool isLazy() const;
+
+	//! Enables or disables the lazy transformation
+	/**
+	 * In lazy mode transform() returns immediately and every impulse response is transformed
+	 * on its first access into a least-recently-used cache, bounded by setLazyCacheSize().
+	 * The output content can then be accessed from several threads. Pointers returned by
+	 * DAFFContentIR::getEffectiveFilterCoeffsPtr() are only valid until the next data access.
+	 * The peaks over several records and the overall effective bounds (e.g.
+	 * DAFFContentIR::getMaxEffectiveFilterLength()) transform all impulse responses once.
+	 *
+	 * \param bLazy			Transform on first access?
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setLazy(bool bLazy, bool bTransform = true);
+
+	//! Returns the maximum size of the cache of the lazy transformation [Bytes]
+	size_t getLazyCacheSize() const;
+
+	//! Sets the maximum size of the cache of the lazy transformation [Bytes]
+	/**
+	 * The default is 16 MiB. A single impulse response is always cached, even if it exceeds
+	 * the given size. Can be changed at any time, surplus entries are dropped.
+	 */
+	void setLazyCacheSize(size_t nMaxBytes);
+
+	//! Returns the heap memory held by the transformer [Bytes] (filters, bounds, peaks and the cache)
+	size_t getMemoryFootprint() const;
+
+	//! Free memory
+	/**
+	 * Afterwards getOutputContent returns NULL, until transform is called again.
+	 */
+	void clear();
+
+	//! Transform the data
+	void transform();
+
+  private:
+	const DAFFContentDFT* m_pInputContent;        //!@ Assigned input data
+	DAFFContentIR* m_pOutputContent;              //!@ Impulse responses
+	float m_fBoundsThreshold;                     //!@ Threshold of the effective bounds [dB]
+	int m_iNumThreads;                            //!@ Number of worker threads (0: automatic)
+	bool m_bLazy;                                 //!@ Transform impulse responses on first access
+	DAFFRecordCache* m_pCache;                    //!@ Impulse response cache of the lazy transformation
+	mutable std::mutex m_mxCache;                 //!@ Guards the cache and the scratch buffer
+	int m_iLength;                                //!@ Length of the impulse responses (transform size)
+	int m_iStride;                                //!@ Distance of the filters in the buffer [floats]
+	int m_iSpectrumSize;                          //!@ Size of a spectrum buffer [floats]
+	float* m_pfBuf;                               //!@ Buffer for the impulse responses
+	float* m_pfScratch;                           //!@ Spectrum buffer of the lazy transformation
+	std::vector<int> m_viOffsets;                 //!@ Effective filter offsets (index record * channels + channel)
+	std::vector<int> m_viLengths;                 //!@ Effective filter lengths (same index)
+	std::vector<float> m_vfPeaks;                 //!@ Peaks of the impulse responses (same index)
+	mutable std::vector<float> m_vfChannelPeaks;  //!@ Peaks of the impulse responses per channel
+	mutable float m_fOverallPeak;                 //!@ Peak of all impulse responses
+	mutable int m_iMinEffectiveOffset;            //!@ Minimum effective filter offset
+	mutable int m_iMaxEffectiveLength;            //!@ Maximum effective filter length
+	mutable int m_iMaxTruncatedLength;            //!@ Maximum effective filter end
+	mutable bool m_bBoundsKnown;                  //!@ Peaks and overall bounds have been determined
+
+	//! Transforms the record channels [iBegin, iEnd) (with index record * channels + channel) into the buffer
+	void transformRange(int iBegin, int iEnd);
+
+	//! Transforms a single record channel (pfSpectrum: m_iSpectrumSize floats, 16-byte aligned)
+	/**
+	 * @return Peak of the impulse response
+	 */
+	float transformFilter(int iRecordIndex, int iChannel, float* pfSpectrum, float* pfDest, int& iOffset,
+						  int& iLength, DAFFFFTPlanState& oState) const;
+
+	//! Determines the peaks and the overall effective bounds (all impulse responses are transformed once in lazy mode)
+	/**
+	 * Requires the lock of lockCache().
+	 */
+	void initBounds() const;
+
+	//! Locks the cache for lazy transformation (returns an unlocked lock otherwise)
+	std::unique_lock<std::mutex> lockCache() const;
+
+	//! Returns the impulse response of a record channel and its bounds, transformed on first access in lazy mode
+	/**
+	 * Requires the lock of lockCache(), the pointer is valid until the next call (NULL on errors).
+	 */
+	const float* getFilterPtr(int iRecordIndex, int iChannel, int& iOffset, int& iLength, float& fPeak) const;
+
+	// Called by inner content class
+	int getMinEffectiveFilterOffset() const;
+	int getMaxEffectiveFilterLength() const;
+	int getMaxTruncatedFilterLength() const;
+	int getFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain, bool bAdd) const;
+	int getFilterCoeff(int iRecordIndex, int iChannel, int iSample, float& fCoeff) const;
+	int getFilterCoeffsTruncated(int iRecordIndex, int iChannel, float* pfDest, int& iLength, float fGain) const;
+	int getFixedPointFilterCoeffs(int iRecordIndex, int iChannel, int16_t* piDestQ15, int32_t* piDestQ31, float fGain,
+								  bool bAdd) const;
+	int getRecord(int iRecordIndex, float** ppfChannelDest) const;
+	int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const;
+	int getEffectiveFilterBounds(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const;
+	int getEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain, bool bAdd) const;
+	const float* getEffectiveFilterCoeffsPtr(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const;
+	int getFilterEnvelope(int iRecordIndex, int iChannel, int iFirstSample, int iNumSamples, int iNumBins,
+						  float* pfMin, float* pfMax) const;
+	float getOverallPeak() const;
+	float getChannelPeak(int iChannel) const;
+	float getRecordPeak(int iRecordIndex, int iChannel) const;
+	int getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const;
+
+	friend class DAFFContentIRInverseRealization;
+
+	// No copy
+	DAFFTransformerDFT2IR(const DAFFTransformerDFT2IR&);
+	DAFFTransformerDFT2IR& operator=(const DAFFTransformerDFT2IR&);
+};
+
+#endif  // IW_DAFFTRANSFORMER_DFT2IR
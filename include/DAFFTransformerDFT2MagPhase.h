@@ -0,0 +1,176 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFFTRANSFORMER_DFT2MAGPHASE
+#define IW_DAFFTRANSFORMER_DFT2MAGPHASE
+
+#include <DAFFDefs.h>
+
+#include <cstddef>  // required for size_t and ptrdiff_t
+
+// Forward declarations
+class DAFFContentDFT;
+class DAFFInterpolator;
+
+//! Transformer from DFT spectra into magnitudes, unwrapped phases and group delays
+/**
+ * This class is associated a DAFFContentDFT instance and decomposes the DFT coefficients
+ * of each record channel into magnitudes and unwrapped phases (radians, continuous over the
+ * frequency bins, starting within [-pi/2, 3pi/2) like DAFF::carg), as well as the group
+ * delays (negative derivative of the phase over the angular frequency, in samples).
+ *
+ * Blending complex DFT coefficients linearly causes comb filter artefacts between records
+ * with different delays. interpolate() instead blends the magnitudes and the unwrapped phases
+ * with the bilinear weights of DAFFInterpolator::getWeights and resynthesizes the complex
+ * coefficients, so that the phase unwrapping is not repeated for every query.
+ *
+ * All records are decomposed in parallel. The transformer keeps a pointer to the input
+ * content, which must outlive it.
+ */
+class DAFF_API DAFFTransformerDFT2MagPhase {
+  public:
+	//! Default constructor
+	DAFFTransformerDFT2MagPhase();
+
+	//! Initializing constructor
+	/**
+	 * \param [in] pInputContent	Input data
+	 * \param [in] bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	DAFFTransformerDFT2MagPhase(const DAFFContentDFT* pInputContent, bool bTransform = true);
+
+	//! Destructor
+	virtual ~DAFFTransformerDFT2MagPhase();
+
+	//! Returns the input content (NULL if none is assigned)
+	const DAFFContentDFT* getInputContent() const;
+
+	//! Set input content
+	/**
+	 * \param pInputContent	Input content (DFT spectra)
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setInputContent(const DAFFContentDFT* pInputContent, bool bTransform = true);
+
+	//! Returns true if the data has been transformed
+	bool isTransformed() const;
+
+	//! Returns the number of values per record channel (number of DFT coefficients, 0 if not transformed)
+	int getNumValues() const;
+
+	//! Returns the number of worker threads of the transformation (0: automatic)
+	int getNumThreads() const;
+
+	//! Sets the number of worker threads of the transformation
+	/**
+	 * See DAFFTransformerIR2DFT::setNumThreads.
+	 *
+	 * \param iNumThreads	Number of threads (0: automatic, 1: no worker threads)
+	 */
+	void setNumThreads(int iNumThreads);
+
+	//! Free memory
+	void clear();
+
+	//! Transform the data
+	void transform();
+
+	//! Retrieves the magnitudes of a record channel
+	/**
+	 * \param [in] iRecordIndex	Record index
+	 * \param [in] iChannel		Channel index
+	 * \param [out] pfDest		Destination buffer (size >= getNumValues())
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if not transformed, #DAFF_INVALID_INDEX otherwise
+	 */
+	int getMagnitudes(int iRecordIndex, int iChannel, float* pfDest) const;
+
+	//! Retrieves the unwrapped phases of a record channel [radians]
+	/**
+	 * \param [in] iRecordIndex	Record index
+	 * \param [in] iChannel		Channel index
+	 * \param [out] pfDest		Destination buffer (size >= getNumValues())
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if not transformed, #DAFF_INVALID_INDEX otherwise
+	 */
+	int getUnwrappedPhases(int iRecordIndex, int iChannel, float* pfDest) const;
+
+	//! Retrieves the group delays of a record channel [samples]
+	/**
+	 * The group delays are the central differences of the unwrapped phases (one-sided at the
+	 * first and last coefficient). Divide them by the sampling rate to obtain seconds.
+	 *
+	 * \param [in] iRecordIndex	Record index
+	 * \param [in] iChannel		Channel index
+	 * \param [out] pfDest		Destination buffer (size >= getNumValues())
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if not transformed, #DAFF_INVALID_INDEX otherwise
+	 */
+	int getGroupDelays(int iRecordIndex, int iChannel, float* pfDest) const;
+
+	//! Interpolates the magnitudes and unwrapped phases of a channel for a direction
+	/**
+	 * \param [in] iView			View, one of #DAFF_VIEWS
+	 * \param [in] fAngle1Deg	First angle (Phi or Alpha, depending on view)
+	 * \param [in] fAngle2Deg	Second angle (Theta or Beta, depending on view)
+	 * \param [in] iChannel		Channel index
+	 * \param [out] pfMagnitudes	Destination of the magnitudes (size >= getNumValues())
+	 * \param [out] pfPhases		Destination of the unwrapped phases [radians] (size >= getNumValues())
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int interpolateMagPhase(int iView, float fAngle1Deg, float fAngle2Deg, int iChannel, float* pfMagnitudes,
+							float* pfPhases) const;
+
+	//! Interpolates the DFT coefficients of a channel for a direction in magnitude and phase
+	/**
+	 * \param [in] iView			View, one of #DAFF_VIEWS
+	 * \param [in] fAngle1Deg	First angle (Phi or Alpha, depending on view)
+	 * \param [in] fAngle2Deg	Second angle (Theta or Beta, depending on view)
+	 * \param [in] iChannel		Channel index
+	 * \param [out] pfDest		Destination of the interleaved complex coefficients (size >= 2*getNumValues())
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int interpolate(int iView, float fAngle1Deg, float fAngle2Deg, int iChannel, float* pfDest) const;
+
+	//! Returns the heap memory held by the transformer [Bytes]
+	size_t getMemoryFootprint() const;
+
+  private:
+	const DAFFContentDFT* m_pInputContent;  //!@ Assigned input data
+	DAFFInterpolator* m_pInterpolator;      //!@ Interpolation weights of the input content
+	int m_iNumThreads;                      //!@ Number of worker threads (0: automatic)
+	int m_iNumValues;                       //!@ Number of DFT coefficients (0 if not transformed)
+	int m_iStride;                          //!@ Distance of the record channels in the buffers [floats]
+	float* m_pfMagnitudes;                  //!@ Magnitudes (index record * channels + channel)
+	float* m_pfPhases;                      //!@ Unwrapped phases (same index)
+	float* m_pfGroupDelays;                 //!@ Group delays (same index)
+
+	//! Transforms the record channels [iBegin, iEnd) (with index record * channels + channel)
+	void transformRange(int iBegin, int iEnd);
+
+	//! Returns the offset of a record channel in the buffers (-1 on invalid indices)
+	ptrdiff_t getOffset(int iRecordIndex, int iChannel) const;
+
+	//! Determines the distinct records of the cell of a direction (offsets in the buffers) and their weights
+	int getSources(int iView, float fAngle1Deg, float fAngle2Deg, int iChannel, ptrdiff_t* pnOffsets, float* pfGains,
+				   int& iNumRecords) const;
+
+	//! Copies the values of a record channel from a buffer
+	int getValues(const float* pfBuf, int iRecordIndex, int iChannel, float* pfDest) const;
+
+	// No copy
+	DAFFTransformerDFT2MagPhase(const DAFFTransformerDFT2MagPhase&);
+	DAFFTransformerDFT2MagPhase& operator=(const DAFFTransformerDFT2MagPhase&);
+};
+
+#endif  // IW_DAFFTRANSFORMER_DFT2MAGPHASE
@@ -17,12 +17,27 @@
 #include <DAFFDefs.h>
 
 #include <cmath>
+#include <mutex>
+#include <string>
+
+// Forward declarations
+class DAFFRecordCache;
 
 //! Window functions
 enum {
-	DAFF_WINDOW_NONE = 0,  //!< No windowing
-	DAFF_WINDOW_HANN,      //!< Hann window
-						   // TODO: Add more by request ...
+	DAFF_WINDOW_NONE = 0,         //!< No windowing
+	DAFF_WINDOW_HANN,             //!< Hann window
+	DAFF_WINDOW_HAMMING,          //!< Hamming window
+	DAFF_WINDOW_BLACKMAN_HARRIS,  //!< 4-term Blackman-Harris window
+	DAFF_WINDOW_TUKEY,            //!< Tukey (tapered cosine) window, taper: fraction of the length in both flanks
+	DAFF_WINDOW_HALF_HANN_TAIL,   //!< Half Hann fade-out of the tail only, taper: fraction of the length faded out
+};
+
+//! FFT planning rigor (FFTW planner flags)
+enum {
+	DAFF_FFT_ESTIMATE = 0,  //!< Heuristic plans, created instantly (FFTW_ESTIMATE)
+	DAFF_FFT_MEASURE,       //!< Measured plans, faster transforms at higher planning cost (FFTW_MEASURE)
+	DAFF_FFT_PATIENT,       //!< Exhaustively measured plans, for batch processing (FFTW_PATIENT)
 };
 
 //! Transformer from impulse responses (IR) to Discrete Fourier spectra (DFT)
@@ -32,6 +47,11 @@ enum {
  * Thereby is provides a DAFFContentDFT view on DAFFContentIR datasets.
  * The views lifetime is limited to the lifetime of the transformed content.
  * Additional parameters can be changed (e.g. window function).
+ *
+ * FFT plans are shared process-wide: a plan is created once per transform size,
+ * memory alignment and planning rigor and reused by all transformers. Measured
+ * plans can be made persistent across processes by exporting the FFTW wisdom
+ * and importing it on the next start.
  */
 
 class DAFF_API DAFFTransformerIR2DFT {
@@ -71,13 +91,70 @@ class DAFF_API DAFFTransformerIR2DFT {
 
 	//! Set the window function
 	/**
-	 * Sets windowing for the impulse responses.
+	 * Sets windowing for the impulse responses. The window is tabulated once per
+	 * transformation and multiplied onto the impulse responses before the FFT.
 	 *
 	 * \param iWindowFunction	Window function
 	 * \param bTransform		Transform the data directly? [optional, default: yes]
 	 */
 	void setWindowFunction(int iWindowFunction, bool bTransform = true);
 
+	//! Returns the taper of the window function (Tukey, tail window)
+	float getWindowTaper() const;
+
+	//! Sets the taper of the window function (Tukey, tail window)
+	/**
+	 * The taper is the fraction of the filter length that is shaped by the window
+	 * (default: 0.5). A Tukey window with taper 0 is rectangular, with taper 1 Hann.
+	 *
+	 * \param fTaper		Taper [0, 1]
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setWindowTaper(float fTaper, bool bTransform = true);
+
+	//! Returns the number of worker threads of the transformation (0: automatic)
+	int getNumThreads() const;
+
+	//! Sets the number of worker threads of the transformation
+	/**
+	 * The records are split into ranges that are transformed concurrently, each
+	 * thread with its own input buffer and the shared FFT plans. Automatic mode
+	 * uses all hardware threads, but not more than the amount of data justifies.
+	 * The input content is read concurrently (supported by all readers, see DAFFReader).
+	 *
+	 * \param iNumThreads	Number of threads (0: automatic, 1: no worker threads)
+	 */
+	void setNumThreads(int iNumThreads);
+
+	//! Indicates whether spectra are transformed on first access
+	bool isLazy() const;
+
+	//! Enables or disables the lazy transformation
+	/**
+	 * In lazy mode transform() returns immediately and every spectrum is transformed
+	 * on its first access into a least-recently-used cache, bounded by setLazyCacheSize().
+	 * The output content can then be accessed from several threads. Pointers returned by
+	 * DAFFContentDFT::getDFTCoeffsPtr() are only valid until the next data access, and
+	 * DAFFContentDFT::getOverallMagnitudeMaximum() transforms all spectra once.
+	 *
+	 * \param bLazy			Transform on first access?
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setLazy(bool bLazy, bool bTransform = true);
+
+	//! Returns the maximum size of the spectrum cache of the lazy transformation [Bytes]
+	size_t getLazyCacheSize() const;
+
+	//! Sets the maximum size of the spectrum cache of the lazy transformation [Bytes]
+	/**
+	 * The default is 16 MiB. A single spectrum is always cached, even if it exceeds
+	 * the given size. Can be changed at any time, surplus entries are dropped.
+	 */
+	void setLazyCacheSize(size_t nMaxBytes);
+
+	//! Returns the heap memory held by the transformer [Bytes] (buffers and the cache of the lazy transformation)
+	size_t getMemoryFootprint() const;
+
 	//! Free memory
 	/**
 	 * This function clears all memory allocated for the DFT representation.
@@ -93,19 +170,86 @@ class DAFF_API DAFFTransformerIR2DFT {
 	 */
 	void transform();
 
+	//! Returns the planning rigor of new FFT plans, one of the DAFF_FFT_* values
+	static int getPlanningRigor();
+
+	//! Sets the planning rigor of new FFT plans (process-wide, default: #DAFF_FFT_ESTIMATE)
+	/**
+	 * Plans that have already been created are kept, see clearPlanCache().
+	 *
+	 * \param iRigor	Planning rigor, one of the DAFF_FFT_* values
+	 */
+	static void setPlanningRigor(int iRigor);
+
+	//! Destroys all cached FFT plans
+	/**
+	 * Must not be called while another thread transforms data. Objects that keep plans across
+	 * calls (e.g. DAFFConvolver) create them again on their next transformation.
+	 */
+	static void clearPlanCache();
+
+	//! Returns the number of cached FFT plans
+	static int getNumCachedPlans();
+
+	//! Imports FFTW wisdom from a file (adds to the wisdom in memory)
+	/**
+	 * \param sFilePath	Path of the wisdom file
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_FILE_NOT_FOUND or #DAFF_FILE_CORRUPTED otherwise
+	 */
+	static int importWisdom(const std::string& sFilePath);
+
+	//! Exports the FFTW wisdom to a file (including the plans of this process)
+	/**
+	 * \param sFilePath	Path of the wisdom file (overwritten)
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_FILE_NOT_FOUND if the file cannot be written
+	 */
+	static int exportWisdom(const std::string& sFilePath);
+
   private:
-	const DAFFContentIR* m_pInputContent;  //!@ Assigned input data
-	DAFFContentDFT* m_pOutputContent;      //!@ output data
-	int m_iWindowFunction;                 //!@ Window function
-	float* m_pfBuf;                        //!@ Buffer for transformed DFT spectra
-	int m_iNumDFTCoeffs;                   //!@ Number of symmetric DFT coefficients
-	int m_iElementSize;                    //!@ Size of transformed DFT spectrum (number of elements)
-	float m_fOverallMagnitudePeak;         //!@ Maximum magnitude over all records/channels
+	const DAFFContentIR* m_pInputContent;   //!@ Assigned input data
+	DAFFContentDFT* m_pOutputContent;       //!@ output data
+	int m_iWindowFunction;                  //!@ Window function
+	float m_fWindowTaper;                   //!@ Taper of the window function
+	int m_iNumThreads;                      //!@ Number of worker threads (0: automatic)
+	bool m_bLazy;                           //!@ Transform spectra on first access
+	DAFFRecordCache* m_pCache;              //!@ Spectrum cache of the lazy transformation
+	mutable std::mutex m_mxCache;           //!@ Guards the spectrum cache
+	float* m_pfBuf;                         //!@ Buffer for transformed DFT spectra
+	float* m_pfWindow;                      //!@ Window function (filter length elements)
+	float* m_pfScratch;                     //!@ Input buffer of the lazy transformation
+	int m_iNumDFTCoeffs;                    //!@ Number of symmetric DFT coefficients
+	int m_iElementSize;                     //!@ Size of transformed DFT spectrum (number of elements)
+	mutable float m_fOverallMagnitudePeak;  //!@ Maximum magnitude over all records/channels
+	mutable bool m_bPeakKnown;              //!@ Maximum magnitude has been determined
+
+	//! Transforms the record channels [iBegin, iEnd) (with index record * channels + channel) into the buffer
+	/**
+	 * \param pfMagSqPeak	Greatest squared magnitude of the transformed spectra (output)
+	 */
+	void transformRange(int iBegin, int iEnd, float* pfMagSqPeak);
+
+	//! Locks the spectrum cache for lazy transformation (returns an unlocked lock otherwise)
+	std::unique_lock<std::mutex> lockCache() const;
+
+	//! Returns the spectrum of a record channel, transformed on first access in lazy mode (NULL on errors)
+	/**
+	 * Requires the lock of lockCache(), the pointer is valid until the next call.
+	 */
+	const float* getSpectrumPtr(int iRecordIndex, int iChannel) const;
 
 	// Called by inner content class
 	float getOverallMagnitudeMaximum() const;
 	int getDFTCoeff(int iRecordIndex, int iChannel, int iDFTCoeff, float& fReal, float& fImag) const;
 	int getDFTCoeffs(int iRecordIndex, int iChannel, float* pfDest) const;
+	int getDFTCoeffsFull(int iRecordIndex, int iChannel, float* pfDest) const;
+	int getDFTCoeffSlice(int iChannel, int iDFTCoeff, float* pfDest) const;
+	int getCoefficientsMP(const int* piRecordIndices, int iNumRecords, int iChannel, float* pfDest) const;
+	int addDFTCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const;
+	const float* getDFTCoeffsPtr(int iRecordIndex, int iChannel) const;
+	int getRecord(int iRecordIndex, float** ppfChannelDest) const;
+	int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const;
 
 	friend class DAFFContentDFTRealization;
 };
@@ -0,0 +1,216 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFFTRANSFORMER_IR2MS
+#define IW_DAFFTRANSFORMER_IR2MS
+
+#include <DAFFContentIR.h>
+#include <DAFFContentMS.h>
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+#include <mutex>
+#include <vector>
+
+// Forward declarations
+class DAFFRecordCache;
+struct DAFFFFTPlanState;
+
+//! Magnitude evaluation modes
+enum {
+	DAFF_MS_BANDS = 0,  //!< Energetic mean of the DFT magnitudes within the band around each support frequency
+	DAFF_MS_POINTS,     //!< DFT magnitude at each support frequency (linear interpolation of the bins)
+};
+
+//! Transformer from impulse responses (IR) to magnitude spectra (MS)
+/**
+ * This class is associated a DAFFContentIR instance and provides a DAFFContentMS
+ * view on it, with magnitudes at an arbitrary support of frequencies (default: the
+ * 31 third octave bands from 20 Hz to 20 kHz). The impulse responses are transformed
+ * into DFT spectra of the filter length, using the FFT plans of DAFFTransformerIR2DFT.
+ *
+ * In band mode (default) the band of a support frequency reaches from the geometric
+ * mean with the previous to the geometric mean with the next frequency. With third
+ * octave centre frequencies these are the third octave bands. Bands narrower than the
+ * DFT resolution take the interpolated magnitude at their centre frequency.
+ *
+ * The magnitudes are factors (no decibel) and all records are transformed in parallel,
+ * or on first access in lazy mode. The views lifetime is limited to the lifetime of
+ * the transformed content.
+ */
+class DAFF_API DAFFTransformerIR2MS {
+  public:
+	//! Default constructor
+	DAFFTransformerIR2MS();
+
+	//! Initializing constructor (third octave bands)
+	/**
+	 * \param [in] pInputContent	Input data
+	 * \param [in] bTransform		Transform the data directly? [optional, default: yes]
+	 */
+	DAFFTransformerIR2MS(const DAFFContentIR* pInputContent, bool bTransform = true);
+
+	//! Initializing constructor
+	/**
+	 * \param [in] pInputContent	Input data
+	 * \param [in] vfFrequencies	Support frequencies [Hz], ascending
+	 * \param [in] iMode			Magnitude evaluation mode, one of DAFF_MS_* [optional, default: bands]
+	 * \param [in] bTransform		Transform the data directly? [optional, default: yes]
+	 */
+	DAFFTransformerIR2MS(const DAFFContentIR* pInputContent, const std::vector<float>& vfFrequencies,
+						 int iMode = DAFF_MS_BANDS, bool bTransform = true);
+
+	//! Destructor
+	virtual ~DAFFTransformerIR2MS();
+
+	//! Set input content
+	/**
+	 * \param pInputContent	Input content (impulse responses)
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setInputContent(const DAFFContentIR* pInputContent, bool bTransform = true);
+
+	//! Get transformed output data
+	/**
+	 * \note This method returns NULL if not input data has been assigned
+	 */
+	DAFFContentMS* getOutputContent() const;
+
+	//! Returns the support frequencies [Hz]
+	const std::vector<float>& getFrequencies() const;
+
+	//! Sets the support frequencies [Hz]
+	/**
+	 * \param vfFrequencies	Support frequencies, ascending and positive
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setFrequencies(const std::vector<float>& vfFrequencies, bool bTransform = true);
+
+	//! Returns the magnitude evaluation mode, one of DAFF_MS_*
+	int getMode() const;
+
+	//! Sets the magnitude evaluation mode
+	/**
+	 * \param iMode			Magnitude evaluation mode, one of DAFF_MS_*
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setMode(int iMode, bool bTransform = true);
+
+	//! Returns the number of worker threads of the transformation (0: automatic)
+	int getNumThreads() const;
+
+	//! Sets the number of worker threads of the transformation
+	/**
+	 * See DAFFTransformerIR2DFT::setNumThreads.
+	 *
+	 * \param iNumThreads	Number of threads (0: automatic, 1: no worker threads)
+	 */
+	void setNumThreads(int iNumThreads);
+
+	//! Indicates whether magnitudes are computed on first access
+	bool isLazy() const;
+
+	//! Enables or disables the lazy transformation
+	/**
+	 * Same as DAFFTransformerIR2DFT::setLazy. Pointers returned by
+	 * DAFFContentMS::getMagnitudesPtr() are only valid until the next data access, and
+	 * DAFFContentMS::getOverallMagnitudeMaximum() transforms all records once.
+	 *
+	 * \param bLazy			Transform on first access?
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setLazy(bool bLazy, bool bTransform = true);
+
+	//! Returns the maximum size of the magnitude cache of the lazy transformation [Bytes]
+	size_t getLazyCacheSize() const;
+
+	//! Sets the maximum size of the magnitude cache of the lazy transformation [Bytes] (default: 16 MiB)
+	void setLazyCacheSize(size_t nMaxBytes);
+
+	//! Returns the heap memory held by the transformer [Bytes] (buffers and the cache of the lazy transformation)
+	size_t getMemoryFootprint() const;
+
+	//! Free memory
+	/**
+	 * Afterwards getOutputData returns NULL, until transform is called again.
+	 */
+	void clear();
+
+	//! Transform the data
+	void transform();
+
+	//! Returns the 31 nominal third octave centre frequencies from 20 Hz to 20 kHz
+	static std::vector<float> getThirdOctaveFrequencies();
+
+	//! Returns the 10 nominal octave centre frequencies from 31.5 Hz to 16 kHz
+	static std::vector<float> getOctaveFrequencies();
+
+  private:
+	const DAFFContentIR* m_pInputContent;   //!@ Assigned input data
+	DAFFContentMS* m_pOutputContent;        //!@ output data
+	std::vector<float> m_vfFrequencies;     //!@ Support frequencies [Hz]
+	int m_iMode;                            //!@ Magnitude evaluation mode
+	int m_iNumThreads;                      //!@ Number of worker threads (0: automatic)
+	bool m_bLazy;                           //!@ Transform magnitudes on first access
+	DAFFRecordCache* m_pCache;              //!@ Magnitude cache of the lazy transformation
+	mutable std::mutex m_mxCache;           //!@ Guards the magnitude cache
+	float* m_pfBuf;                         //!@ Buffer for the magnitudes (eager transformation)
+	float* m_pfScratch;                     //!@ Buffers of the lazy transformation
+	std::vector<int> m_viBandBegin;         //!@ First DFT bin per band
+	std::vector<int> m_viBandEnd;           //!@ DFT bin behind the last one per band (equal begin: no bins)
+	std::vector<float> m_vfCentreBin;       //!@ Fractional DFT bin of each support frequency
+	int m_iElementSize;                     //!@ Size of the magnitudes of a record channel (number of elements)
+	mutable float m_fOverallMagnitudePeak;  //!@ Maximum magnitude over all records/channels
+	mutable bool m_bPeakKnown;              //!@ Maximum magnitude has been determined
+
+	//! Determines the DFT bins of the bands
+	void initBands();
+
+	//! Transforms the record channels [iBegin, iEnd) (with index record * channels + channel) into the buffer
+	/**
+	 * \param pfPeak	Greatest magnitude of the transformed record channels (output)
+	 */
+	void transformRange(int iBegin, int iEnd, float* pfPeak);
+
+	//! Computes the magnitudes of a record channel, returns their maximum
+	/**
+	 * \param pfScratch	Scratch buffer (getScratchSize floats, 16-byte aligned)
+	 */
+	float transformMagnitudes(int iRecordIndex, int iChannel, float* pfScratch, float* pfDest,
+							  DAFFFFTPlanState& oState) const;
+
+	//! Returns the number of floats of the scratch buffer of transformMagnitudes (input and spectrum)
+	size_t getScratchSize() const;
+
+	//! Locks the magnitude cache for lazy transformation (returns an unlocked lock otherwise)
+	std::unique_lock<std::mutex> lockCache() const;
+
+	//! Returns the magnitudes of a record channel, transformed on first access in lazy mode (NULL on errors)
+	/**
+	 * Requires the lock of lockCache(), the pointer is valid until the next call.
+	 */
+	const float* getMagnitudesPtrLocked(int iRecordIndex, int iChannel) const;
+
+	// Called by inner content class
+	float getOverallMagnitudeMaximum() const;
+	int getMagnitudes(int iRecordIndex, int iChannel, float* pfDest) const;
+	int addMagnitudes(int iRecordIndex, int iChannel, float* pfDest, float fGain) const;
+	int getRecord(int iRecordIndex, float** ppfChannelDest) const;
+	int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const;
+	int getMagnitude(int iRecordIndex, int iChannel, int iFreqIndex, float& fMag) const;
+	int getMagnitudeSlice(int iChannel, int iFreqIndex, float* pfDest) const;
+	const float* getMagnitudesPtr(int iRecordIndex, int iChannel) const;
+	int getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const;
+
+	friend class DAFFContentMSRealization;
+};
+
+#endif  // IW_DAFFTRANSFORMER_IR2MS
@@ -0,0 +1,222 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFFTRANSFORMER_IR2MINPHASE
+#define IW_DAFFTRANSFORMER_IR2MINPHASE
+
+#include <DAFFContentIR.h>
+#include <DAFFDefs.h>
+
+#include <string>
+#include <vector>
+
+// Forward declarations
+class DAFFFilterCrossfader;
+class DAFFInterpolator;
+
+//! Transformer from impulse responses (IR) into minimum-phase filters and onset delays
+/**
+ * This class is associated a DAFFContentIR instance (e.g. HRIRs) and decomposes each
+ * record channel into a minimum-phase filter and a fractional onset delay, so that
+ * the interaural time difference can be interpolated separately from the spectra.
+ * The minimum-phase filters are provided as a DAFFContentIR view, truncated to
+ * getMinPhaseLength() coefficients, which concentrate the energy at the start and are
+ * usually much shorter than the input filters.
+ *
+ * The minimum-phase filters are computed with the real cepstrum (homomorphic method)
+ * on FFTs of four times the input filter length (rounded up to a power of two), using
+ * the FFT plans of DAFFTransformerIR2DFT. The delay of a record channel is the
+ * difference of the onsets of the input and the minimum-phase filter, where the onset
+ * is the linearly interpolated position at which the absolute value first reaches the
+ * onset threshold relative to the peak (clamped to zero).
+ *
+ * All records are transformed in parallel. The results can be stored in a cache file
+ * (save) and loaded later instead of transforming again (load). The transformer keeps
+ * a pointer to the input content, which must outlive it.
+ */
+class DAFF_API DAFFTransformerIR2MinPhase {
+  public:
+	//! Default constructor
+	DAFFTransformerIR2MinPhase();
+
+	//! Initializing constructor
+	/**
+	 * \param [in] pInputContent		Input data
+	 * \param [in] iMinPhaseLength	Length of the minimum-phase filters (0: input filter length) [optional]
+	 * \param [in] bTransform		Transform the data directly? [optional, default: yes]
+	 */
+	DAFFTransformerIR2MinPhase(const DAFFContentIR* pInputContent, int iMinPhaseLength = 0, bool bTransform = true);
+
+	//! Destructor
+	virtual ~DAFFTransformerIR2MinPhase();
+
+	//! Returns the input content (NULL if none is assigned)
+	const DAFFContentIR* getInputContent() const;
+
+	//! Set input content
+	/**
+	 * \param pInputContent	Input content (impulse responses)
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setInputContent(const DAFFContentIR* pInputContent, bool bTransform = true);
+
+	//! Get the minimum-phase filters
+	/**
+	 * \note This method returns NULL if not input data has been assigned
+	 */
+	DAFFContentIR* getOutputContent() const;
+
+	//! Returns the length of the minimum-phase filters [samples]
+	int getMinPhaseLength() const;
+
+	//! Sets the length of the minimum-phase filters
+	/**
+	 * \param iMinPhaseLength	Length [samples] (0: input filter length, greater lengths are limited to it)
+	 * \param bTransform			Transform the data directly? [optional, default: yes]
+	 */
+	void setMinPhaseLength(int iMinPhaseLength, bool bTransform = true);
+
+	//! Returns the onset threshold relative to the peak
+	float getOnsetThreshold() const;
+
+	//! Sets the onset threshold relative to the peak (default: 0.1, i.e. -20 dB)
+	/**
+	 * \param fThreshold	Threshold in (0, 1]
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setOnsetThreshold(float fThreshold, bool bTransform = true);
+
+	//! Returns the number of worker threads of the transformation (0: automatic)
+	int getNumThreads() const;
+
+	//! Sets the number of worker threads of the transformation
+	/**
+	 * See DAFFTransformerIR2DFT::setNumThreads.
+	 *
+	 * \param iNumThreads	Number of threads (0: automatic, 1: no worker threads)
+	 */
+	void setNumThreads(int iNumThreads);
+
+	//! Free memory
+	/**
+	 * Afterwards getOutputContent returns NULL, until transform or load is called again.
+	 */
+	void clear();
+
+	//! Transform the data
+	void transform();
+
+	//! Returns the onset delay of a record channel
+	/**
+	 * \param [in] iRecordIndex	Record index
+	 * \param [in] iChannel		Channel index
+	 * \param [out] fDelay		Onset delay [samples]
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if not transformed, #DAFF_INVALID_INDEX otherwise
+	 */
+	int getDelay(int iRecordIndex, int iChannel, float& fDelay) const;
+
+	//! Interpolates the minimum-phase filter and the onset delay of a channel for a direction
+	/**
+	 * The bilinear weights of DAFFInterpolator::getWeights blend the minimum-phase filters
+	 * and the delays separately. Apply the delay to the filter (e.g. with a fractional delay
+	 * line) to obtain the interpolated impulse response.
+	 *
+	 * \param [in] iView			View, one of #DAFF_VIEWS
+	 * \param [in] fAngle1Deg	First angle (Phi or Alpha, depending on view)
+	 * \param [in] fAngle2Deg	Second angle (Theta or Beta, depending on view)
+	 * \param [in] iChannel		Channel index
+	 * \param [out] pfDest		Destination of the filter (getMinPhaseLength() floats)
+	 * \param [out] fDelay		Onset delay [samples]
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int interpolate(int iView, float fAngle1Deg, float fAngle2Deg, int iChannel, float* pfDest, float& fDelay) const;
+
+	//! Stores the minimum-phase filters and delays in a cache file
+	/**
+	 * \param [in] sFilePath	Cache file path
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if not transformed, #DAFF_FILE_NOT_FOUND if not writable
+	 */
+	int save(const std::string& sFilePath) const;
+
+	//! Loads the minimum-phase filters and delays from a cache file instead of transforming them
+	/**
+	 * The input content must be assigned and match the one of the file (records, channels,
+	 * filter length, sampling rate). The minimum-phase length and the onset threshold are
+	 * taken from the file.
+	 *
+	 * \param [in] sFilePath	Cache file path
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise (the transformer is cleared)
+	 */
+	int load(const std::string& sFilePath);
+
+	//! Returns the heap memory held by the transformer [Bytes] (filters, delays and peaks)
+	size_t getMemoryFootprint() const;
+
+  private:
+	const DAFFContentIR* m_pInputContent;  //!@ Assigned input data
+	DAFFContentIR* m_pOutputContent;       //!@ Minimum-phase filters
+	DAFFInterpolator* m_pInterpolator;     //!@ Interpolation weights of the output content
+	DAFFFilterCrossfader* m_pCrossfader;   //!@ Blending of the minimum-phase filters
+	int m_iMinPhaseLength;                 //!@ Requested length of the minimum-phase filters (0: filter length)
+	float m_fOnsetThreshold;               //!@ Onset threshold relative to the peak
+	int m_iNumThreads;                     //!@ Number of worker threads (0: automatic)
+	int m_iLength;                         //!@ Length of the minimum-phase filters of the output content
+	int m_iStride;                         //!@ Distance of the filters in the buffer [floats]
+	float* m_pfBuf;                        //!@ Buffer for the minimum-phase filters
+	std::vector<float> m_vfDelays;         //!@ Onset delays (index record * channels + channel)
+	std::vector<float> m_vfPeaks;          //!@ Peaks of the minimum-phase filters (same index)
+	std::vector<float> m_vfChannelPeaks;   //!@ Peaks of the minimum-phase filters per channel
+	float m_fOverallPeak;                  //!@ Peak of all minimum-phase filters
+
+	//! Returns the FFT size, four times the filter length rounded up to a power of two
+	int getTransformSize() const;
+
+	//! Creates the output content and the buffers for the current input (false on errors)
+	bool init(int iLength);
+
+	//! Determines the peaks of the minimum-phase filters
+	void initPeaks();
+
+	//! Transforms the record channels [iBegin, iEnd) (with index record * channels + channel) into the buffer
+	void transformRange(int iBegin, int iEnd);
+
+	//! Returns the minimum-phase filter of a record channel (NULL on errors)
+	const float* getFilterPtr(int iRecordIndex, int iChannel) const;
+
+	//! Returns the linearly interpolated onset of a filter [samples]
+	static float getOnset(const float* pfData, int iLength, float fThreshold);
+
+	// Called by inner content class
+	int getFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const;
+	int getFilterCoeff(int iRecordIndex, int iChannel, int iSample, float& fCoeff) const;
+	int addFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const;
+	int getFixedPointFilterCoeffs(int iRecordIndex, int iChannel, int16_t* piDestQ15, int32_t* piDestQ31, float fGain,
+								  bool bAdd) const;
+	int getRecord(int iRecordIndex, float** ppfChannelDest) const;
+	int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const;
+	int getFilterEnvelope(int iRecordIndex, int iChannel, int iFirstSample, int iNumSamples, int iNumBins,
+						  float* pfMin, float* pfMax) const;
+	float getChannelPeak(int iChannel) const;
+	float getRecordPeak(int iRecordIndex, int iChannel) const;
+	int getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const;
+
+	friend class DAFFContentIRMinPhaseRealization;
+
+	// No copy
+	DAFFTransformerIR2MinPhase(const DAFFTransformerIR2MinPhase&);
+	DAFFTransformerIR2MinPhase& operator=(const DAFFTransformerIR2MinPhase&);
+};
+
+#endif  // IW_DAFFTRANSFORMER_IR2MINPHASE
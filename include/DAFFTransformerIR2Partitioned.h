@@ -0,0 +1,202 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFFTRANSFORMER_IR2PARTITIONED
+#define IW_DAFFTRANSFORMER_IR2PARTITIONED
+
+#include <DAFFContentIR.h>
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+#include <mutex>
+
+// Forward declarations
+class DAFFRecordCache;
+
+//! Transformer from impulse responses (IR) to uniformly partitioned filter spectra
+/**
+ * This class is associated a DAFFContentIR instance and splits its impulse responses
+ * into partitions of B samples (the block length of a uniformly partitioned convolution,
+ * e.g. overlap-save). Each partition is zero-padded to 2B samples and transformed into
+ * B+1 complex DFT coefficients, interleaved real and imaginary parts. The last partition
+ * is zero-padded if the filter length is not a multiple of B.
+ *
+ * Since all spectra are computed by transform(), a direction switch in the audio thread
+ * only exchanges pointers (getPartitionsPtr) and costs no FFT. The partitions of a record
+ * channel are stored consecutively with the distance getPartitionStride() (16-byte aligned).
+ * Alternatively the spectra can be transformed on first access (see setLazy).
+ *
+ * The FFT plans are shared with DAFFTransformerIR2DFT, including its planning rigor.
+ * The transformer keeps a pointer to the input content, which must outlive it.
+ */
+class DAFF_API DAFFTransformerIR2Partitioned {
+  public:
+	//! Default constructor
+	DAFFTransformerIR2Partitioned();
+
+	//! Initializing constructor
+	/**
+	 * \param [in] pInputContent	Input data
+	 * \param [in] iBlockLength		Block length B [samples]
+	 * \param [in] bTransform		Transform the data directly? [optional, default: yes]
+	 */
+	DAFFTransformerIR2Partitioned(const DAFFContentIR* pInputContent, int iBlockLength, bool bTransform = true);
+
+	//! Destructor
+	virtual ~DAFFTransformerIR2Partitioned();
+
+	//! Returns the input content (NULL if none is assigned)
+	const DAFFContentIR* getInputContent() const;
+
+	//! Set input content
+	/**
+	 * \param pInputContent	Input content (impulse responses)
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setInputContent(const DAFFContentIR* pInputContent, bool bTransform = true);
+
+	//! Returns the block length B [samples]
+	int getBlockLength() const;
+
+	//! Sets the block length B [samples]
+	/**
+	 * \param iBlockLength	Block length (greater than zero)
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setBlockLength(int iBlockLength, bool bTransform = true);
+
+	//! Returns the number of partitions per record channel, ceil(filter length / B)
+	int getNumPartitions() const;
+
+	//! Returns the DFT size of the partitions, 2B
+	int getTransformSize() const;
+
+	//! Returns the number of complex DFT coefficients per partition, B+1
+	int getNumDFTCoeffs() const;
+
+	//! Returns the distance between consecutive partitions [floats]
+	/**
+	 * At least 2*(B+1), rounded up to keep all partitions 16-byte aligned.
+	 */
+	int getPartitionStride() const;
+
+	//! Returns the number of worker threads of the transformation (0: automatic)
+	int getNumThreads() const;
+
+	//! Sets the number of worker threads of the transformation
+	/**
+	 * See DAFFTransformerIR2DFT::setNumThreads.
+	 *
+	 * \param iNumThreads	Number of threads (0: automatic, 1: no worker threads)
+	 */
+	void setNumThreads(int iNumThreads);
+
+	//! Indicates whether spectra are transformed on first access
+	bool isLazy() const;
+
+	//! Enables or disables the lazy transformation
+	/**
+	 * In lazy mode transform() returns immediately and the partitions of a record channel
+	 * are transformed on their first access into a least-recently-used cache, bounded by
+	 * setLazyCacheSize(). Accesses from several threads are safe, but pointers returned by
+	 * getPartitionsPtr() and getPartitionPtr() are only valid until the next data access.
+	 * Not suited for the audio thread, since a cache miss costs getNumPartitions() FFTs.
+	 *
+	 * \param bLazy			Transform on first access?
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setLazy(bool bLazy, bool bTransform = true);
+
+	//! Returns the maximum size of the spectrum cache of the lazy transformation [Bytes]
+	size_t getLazyCacheSize() const;
+
+	//! Sets the maximum size of the spectrum cache of the lazy transformation [Bytes]
+	/**
+	 * The default is 16 MiB. The partitions of a single record channel are always cached,
+	 * even if they exceed the given size.
+	 */
+	void setLazyCacheSize(size_t nMaxBytes);
+
+	//! Returns the heap memory held by the transformer [Bytes] (buffers and the cache of the lazy transformation)
+	size_t getMemoryFootprint() const;
+
+	//! Free memory
+	/**
+	 * Afterwards all data access methods fail, until transform is called again.
+	 */
+	void clear();
+
+	//! Transform the data
+	/**
+	 * Transforms the partitions of all records and channels (or prepares the lazy
+	 * transformation). Fails silently if no input content is assigned.
+	 */
+	void transform();
+
+	//! Returns the partitions of a record channel (zero-copy)
+	/**
+	 * \param [in] iRecordIndex	Record index
+	 * \param [in] iChannel		Channel index
+	 *
+	 * @return Partition 0 of getNumPartitions(), partition p starts at p * getPartitionStride() (NULL on errors)
+	 */
+	const float* getPartitionsPtr(int iRecordIndex, int iChannel) const;
+
+	//! Returns a single partition of a record channel (zero-copy)
+	/**
+	 * \param [in] iRecordIndex	Record index
+	 * \param [in] iChannel		Channel index
+	 * \param [in] iPartition	Partition index
+	 *
+	 * @return getNumDFTCoeffs() interleaved complex coefficients (NULL on errors)
+	 */
+	const float* getPartitionPtr(int iRecordIndex, int iChannel, int iPartition) const;
+
+	//! Copies the partitions of a record channel
+	/**
+	 * \param [in] iRecordIndex	Record index
+	 * \param [in] iChannel		Channel index
+	 * \param [out] pfDest		Destination of getNumPartitions() * 2 * getNumDFTCoeffs() floats (no padding)
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if not transformed, #DAFF_INVALID_INDEX otherwise
+	 */
+	int getPartitions(int iRecordIndex, int iChannel, float* pfDest) const;
+
+  private:
+	const DAFFContentIR* m_pInputContent;  //!@ Assigned input data
+	int m_iBlockLength;                    //!@ Block length B
+	int m_iNumPartitions;                  //!@ Number of partitions per record channel
+	int m_iPartitionStride;                //!@ Distance between partitions [floats]
+	int m_iNumThreads;                     //!@ Number of worker threads (0: automatic)
+	bool m_bLazy;                          //!@ Transform partitions on first access
+	bool m_bTransformed;                   //!@ Data access is possible
+	DAFFRecordCache* m_pCache;             //!@ Partition cache of the lazy transformation
+	mutable std::mutex m_mxCache;          //!@ Guards the partition cache
+	float* m_pfBuf;                        //!@ Buffer for all partitions (eager transformation)
+	float* m_pfScratch;                    //!@ Input buffer of the lazy transformation
+
+	//! Returns the number of floats of all partitions of a record channel
+	size_t getElementSize() const;
+
+	//! Transforms the record channels [iBegin, iEnd) (with index record * channels + channel) into the buffer
+	void transformRange(int iBegin, int iEnd);
+
+	//! Locks the partition cache for lazy transformation (returns an unlocked lock otherwise)
+	std::unique_lock<std::mutex> lockCache() const;
+
+	//! Returns the partitions of a record channel, transformed on first access in lazy mode (NULL on errors)
+	/**
+	 * Requires the lock of lockCache(), the pointer is valid until the next call.
+	 */
+	const float* getElementPtr(int iRecordIndex, int iChannel) const;
+};
+
+#endif  // IW_DAFFTRANSFORMER_IR2PARTITIONED
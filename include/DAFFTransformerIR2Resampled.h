@@ -0,0 +1,181 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFFTRANSFORMER_IR2RESAMPLED
+#define IW_DAFFTRANSFORMER_IR2RESAMPLED
+
+#include <DAFFContentIR.h>
+#include <DAFFDefs.h>
+
+#include <string>
+#include <vector>
+
+//! Transformer from impulse responses (IR) into impulse responses of another sampling rate
+/**
+ * This class is associated a DAFFContentIR instance (e.g. HRIRs of 44.1 kHz) and converts
+ * all record channels to a target sampling rate (e.g. 48 kHz). The resampled filters are
+ * provided as a DAFFContentIR view, which delivers the target rate by getSamplerate() and
+ * effective bounds, peaks and statistics of the resampled filters.
+ *
+ * The conversion uses a polyphase filter for the ratio of the (integer) sampling rates, with
+ * a Kaiser-windowed sinc kernel of 32 zero crossings per side (stopband attenuation about
+ * 90 dB) and a cutoff at 94% of the lower Nyquist frequency. The coefficients are scaled by
+ * the ratio of the input and the target rate, so that the filters keep their transfer
+ * function. The kernel is centered, the filters are not delayed. The length of the
+ * resampled filters is the input filter length scaled by the rate ratio (rounded up).
+ *
+ * All records are transformed in parallel. The results can be stored in a cache file
+ * (save) and loaded later instead of transforming again (load). The transformer keeps
+ * a pointer to the input content, which must outlive it.
+ */
+class DAFF_API DAFFTransformerIR2Resampled {
+  public:
+	//! Default constructor
+	DAFFTransformerIR2Resampled();
+
+	//! Initializing constructor
+	/**
+	 * \param [in] pInputContent		Input data
+	 * \param [in] dTargetSamplerate	Target sampling rate [Hz]
+	 * \param [in] bTransform		Transform the data directly? [optional, default: yes]
+	 */
+	DAFFTransformerIR2Resampled(const DAFFContentIR* pInputContent, double dTargetSamplerate, bool bTransform = true);
+
+	//! Destructor
+	virtual ~DAFFTransformerIR2Resampled();
+
+	//! Returns the input content (NULL if none is assigned)
+	const DAFFContentIR* getInputContent() const;
+
+	//! Set input content
+	/**
+	 * \param pInputContent	Input content (impulse responses)
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setInputContent(const DAFFContentIR* pInputContent, bool bTransform = true);
+
+	//! Get the resampled filters
+	/**
+	 * \note This method returns NULL if not input data has been assigned
+	 */
+	DAFFContentIR* getOutputContent() const;
+
+	//! Returns the target sampling rate [Hz]
+	double getTargetSamplerate() const;
+
+	//! Sets the target sampling rate
+	/**
+	 * \param dTargetSamplerate	Target sampling rate [Hz] (rounded to integer Hz for the rate ratio)
+	 * \param bTransform			Transform the data directly? [optional, default: yes]
+	 */
+	void setTargetSamplerate(double dTargetSamplerate, bool bTransform = true);
+
+	//! Returns the number of worker threads of the transformation (0: automatic)
+	int getNumThreads() const;
+
+	//! Sets the number of worker threads of the transformation
+	/**
+	 * See DAFFTransformerIR2DFT::setNumThreads.
+	 *
+	 * \param iNumThreads	Number of threads (0: automatic, 1: no worker threads)
+	 */
+	void setNumThreads(int iNumThreads);
+
+	//! Free memory
+	/**
+	 * Afterwards getOutputContent returns NULL, until transform or load is called again.
+	 */
+	void clear();
+
+	//! Transform the data
+	void transform();
+
+	//! Stores the resampled filters in a cache file
+	/**
+	 * \param [in] sFilePath	Cache file path
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if not transformed, #DAFF_FILE_NOT_FOUND if not writable
+	 */
+	int save(const std::string& sFilePath) const;
+
+	//! Loads the resampled filters from a cache file instead of transforming them
+	/**
+	 * The input content must be assigned and match the one of the file (records, channels,
+	 * filter length, sampling rate). The target sampling rate is taken from the file.
+	 *
+	 * \param [in] sFilePath	Cache file path
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise (the transformer is cleared)
+	 */
+	int load(const std::string& sFilePath);
+
+	//! Returns the heap memory held by the transformer [Bytes] (filters, bounds, peaks and polyphase filter)
+	size_t getMemoryFootprint() const;
+
+  private:
+	const DAFFContentIR* m_pInputContent;  //!@ Assigned input data
+	DAFFContentIR* m_pOutputContent;       //!@ Resampled filters
+	double m_dTargetSamplerate;            //!@ Target sampling rate [Hz]
+	int m_iNumThreads;                     //!@ Number of worker threads (0: automatic)
+	int m_iUpFactor;                       //!@ Interpolation factor of the rate ratio (number of phases)
+	int m_iDownFactor;                     //!@ Decimation factor of the rate ratio
+	int m_iNumTaps;                        //!@ Number of coefficients per phase of the polyphase filter
+	std::vector<float> m_vfPolyphase;      //!@ Polyphase filter [phase][tap]
+	int m_iLength;                         //!@ Length of the resampled filters
+	int m_iStride;                         //!@ Distance of the filters in the buffer [floats]
+	float* m_pfBuf;                        //!@ Buffer for the resampled filters
+	std::vector<int> m_viOffsets;          //!@ Effective filter offsets (index record * channels + channel)
+	std::vector<int> m_viLengths;          //!@ Effective filter lengths (same index)
+	int m_iMinEffectiveOffset;             //!@ Minimum effective filter offset
+	int m_iMaxEffectiveLength;             //!@ Maximum effective filter length
+	int m_iMaxTruncatedLength;             //!@ Maximum effective filter end
+	std::vector<float> m_vfPeaks;          //!@ Peaks of the resampled filters (same index)
+	std::vector<float> m_vfChannelPeaks;   //!@ Peaks of the resampled filters per channel
+	float m_fOverallPeak;                  //!@ Peak of all resampled filters
+
+	//! Determines the rate ratio and the polyphase filter, creates the output content and buffers (false on errors)
+	bool init();
+
+	//! Determines the effective bounds and peaks of the resampled filters
+	void initBounds();
+
+	//! Resamples the record channels [iBegin, iEnd) (with index record * channels + channel) into the buffer
+	void transformRange(int iBegin, int iEnd);
+
+	//! Returns the resampled filter of a record channel (NULL on errors)
+	const float* getFilterPtr(int iRecordIndex, int iChannel) const;
+
+	// Called by inner content class
+	int getFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const;
+	int getFilterCoeff(int iRecordIndex, int iChannel, int iSample, float& fCoeff) const;
+	int addFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const;
+	int getFixedPointFilterCoeffs(int iRecordIndex, int iChannel, int16_t* piDestQ15, int32_t* piDestQ31, float fGain,
+								  bool bAdd) const;
+	int getFilterCoeffsTruncated(int iRecordIndex, int iChannel, float* pfDest, int& iLength, float fGain) const;
+	int getRecord(int iRecordIndex, float** ppfChannelDest) const;
+	int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const;
+	int getEffectiveFilterBounds(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const;
+	int getEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain, bool bAdd) const;
+	const float* getEffectiveFilterCoeffsPtr(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const;
+	int getFilterEnvelope(int iRecordIndex, int iChannel, int iFirstSample, int iNumSamples, int iNumBins,
+						  float* pfMin, float* pfMax) const;
+	float getChannelPeak(int iChannel) const;
+	float getRecordPeak(int iRecordIndex, int iChannel) const;
+	int getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const;
+
+	friend class DAFFContentIRResampledRealization;
+
+	// No copy
+	DAFFTransformerIR2Resampled(const DAFFTransformerIR2Resampled&);
+	DAFFTransformerIR2Resampled& operator=(const DAFFTransformerIR2Resampled&);
+};
+
+#endif  // IW_DAFFTRANSFORMER_IR2RESAMPLED
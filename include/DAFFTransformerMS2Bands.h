@@ -0,0 +1,238 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFFTRANSFORMER_MS2BANDS
+#define IW_DAFFTRANSFORMER_MS2BANDS
+
+#include <DAFFContentDFT.h>
+#include <DAFFContentMS.h>
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+#include <mutex>
+#include <vector>
+
+// Forward declarations
+class DAFFRecordCache;
+
+//! Frequency remapping modes
+enum {
+	DAFF_REMAP_LINEAR = 0,  //!< Linear interpolation over the frequency
+	DAFF_REMAP_LOG,         //!< Linear interpolation over the logarithm of the frequency
+	DAFF_REMAP_BANDS,       //!< Energetic mean of the input values within the band around each target frequency
+};
+
+//! Transformer from magnitude spectra (MS) or DFT spectra into magnitude spectra of a target frequency support
+/**
+ * This class is associated a DAFFContentMS instance with its own support frequencies (or a
+ * DAFFContentDFT instance, whose bins are the support) and provides a DAFFContentMS view on it
+ * at a fixed target support of frequencies, e.g. the bands of a simulation engine. Records of
+ * different files then answer in the same frequencies without interpolation per query.
+ *
+ * The mapping is a sparse matrix, computed once from the input and the target frequencies:
+ * each target value is a weighted sum of few input values (the magnitudes of the DFT
+ * coefficients for DFT spectra). Target frequencies outside of the input support take the
+ * value at the nearest boundary. In band mode the band of a target frequency reaches from the
+ * geometric mean with the previous to the geometric mean with the next frequency (like
+ * DAFFTransformerIR2MS) and the input values are weighted with the overlap of their own band
+ * (the bin width for DFT spectra) in the squared domain. Bands within a single input band take
+ * the log-frequency interpolation at their centre frequency.
+ *
+ * The magnitudes are factors (no decibel) and all records are transformed in parallel,
+ * or on first access in lazy mode. The views lifetime is limited to the lifetime of
+ * the transformed content.
+ */
+class DAFF_API DAFFTransformerMS2Bands {
+  public:
+	//! Default constructor
+	DAFFTransformerMS2Bands();
+
+	//! Initializing constructor for magnitude spectra
+	/**
+	 * \param [in] pInputContent	Input data
+	 * \param [in] vfFrequencies	Target frequencies [Hz], ascending and positive
+	 * \param [in] iMode			Remapping mode, one of DAFF_REMAP_* [optional, default: log-frequency interpolation]
+	 * \param [in] bTransform		Transform the data directly? [optional, default: yes]
+	 */
+	DAFFTransformerMS2Bands(const DAFFContentMS* pInputContent, const std::vector<float>& vfFrequencies,
+							int iMode = DAFF_REMAP_LOG, bool bTransform = true);
+
+	//! Initializing constructor for DFT spectra
+	/**
+	 * \param [in] pInputContent	Input data
+	 * \param [in] vfFrequencies	Target frequencies [Hz], ascending and positive
+	 * \param [in] iMode			Remapping mode, one of DAFF_REMAP_* [optional, default: bands]
+	 * \param [in] bTransform		Transform the data directly? [optional, default: yes]
+	 */
+	DAFFTransformerMS2Bands(const DAFFContentDFT* pInputContent, const std::vector<float>& vfFrequencies,
+							int iMode = DAFF_REMAP_BANDS, bool bTransform = true);
+
+	//! Destructor
+	virtual ~DAFFTransformerMS2Bands();
+
+	//! Set input content (magnitude spectra)
+	/**
+	 * \param pInputContent	Input content (magnitude spectra)
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setInputContent(const DAFFContentMS* pInputContent, bool bTransform = true);
+
+	//! Set input content (DFT spectra)
+	/**
+	 * \param pInputContent	Input content (DFT spectra)
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setInputContent(const DAFFContentDFT* pInputContent, bool bTransform = true);
+
+	//! Get transformed output data
+	/**
+	 * \note This method returns NULL if not input data has been assigned
+	 */
+	DAFFContentMS* getOutputContent() const;
+
+	//! Returns the target frequencies [Hz]
+	const std::vector<float>& getFrequencies() const;
+
+	//! Sets the target frequencies [Hz]
+	/**
+	 * \param vfFrequencies	Target frequencies, ascending and positive
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setFrequencies(const std::vector<float>& vfFrequencies, bool bTransform = true);
+
+	//! Returns the remapping mode, one of DAFF_REMAP_*
+	int getMode() const;
+
+	//! Sets the remapping mode
+	/**
+	 * \param iMode			Remapping mode, one of DAFF_REMAP_*
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setMode(int iMode, bool bTransform = true);
+
+	//! Returns the number of worker threads of the transformation (0: automatic)
+	int getNumThreads() const;
+
+	//! Sets the number of worker threads of the transformation
+	/**
+	 * See DAFFTransformerIR2DFT::setNumThreads.
+	 *
+	 * \param iNumThreads	Number of threads (0: automatic, 1: no worker threads)
+	 */
+	void setNumThreads(int iNumThreads);
+
+	//! Indicates whether magnitudes are computed on first access
+	bool isLazy() const;
+
+	//! Enables or disables the lazy transformation
+	/**
+	 * Same as DAFFTransformerIR2MS::setLazy. Pointers returned by
+	 * DAFFContentMS::getMagnitudesPtr() are only valid until the next data access, and
+	 * DAFFContentMS::getOverallMagnitudeMaximum() transforms all records once.
+	 *
+	 * \param bLazy			Transform on first access?
+	 * \param bTransform	Transform the data directly? [optional, default: yes]
+	 */
+	void setLazy(bool bLazy, bool bTransform = true);
+
+	//! Returns the maximum size of the magnitude cache of the lazy transformation [Bytes]
+	size_t getLazyCacheSize() const;
+
+	//! Sets the maximum size of the magnitude cache of the lazy transformation [Bytes] (default: 16 MiB)
+	void setLazyCacheSize(size_t nMaxBytes);
+
+	//! Returns the sparse remapping matrix in compressed row format (empty if not transformed)
+	/**
+	 * The target value i is the sum over j in [viRowBegin[i], viRowBegin[i+1]) of vfWeights[j] times
+	 * the input value viColumns[j] (of the squared values in band mode, followed by the square root).
+	 *
+	 * \param [out] viRowBegin	First entry of each target frequency, number of target frequencies + 1 elements
+	 * \param [out] viColumns	Input frequency (or DFT coefficient) index of each entry
+	 * \param [out] vfWeights	Weight of each entry
+	 */
+	void getMatrix(std::vector<int>& viRowBegin, std::vector<int>& viColumns, std::vector<float>& vfWeights) const;
+
+	//! Returns the heap memory held by the transformer [Bytes] (buffers, matrix, cache of lazy transformation)
+	size_t getMemoryFootprint() const;
+
+	//! Free memory
+	/**
+	 * Afterwards getOutputData returns NULL, until transform is called again.
+	 */
+	void clear();
+
+	//! Transform the data
+	void transform();
+
+  private:
+	const DAFFContent* m_pInputContent;        //!@ Assigned input data
+	const DAFFContentMS* m_pInputContentMS;    //!@ Input data as magnitude spectra (or NULL)
+	const DAFFContentDFT* m_pInputContentDFT;  //!@ Input data as DFT spectra (or NULL)
+	DAFFContentMS* m_pOutputContent;           //!@ output data
+	std::vector<float> m_vfFrequencies;        //!@ Target frequencies [Hz]
+	int m_iMode;                               //!@ Remapping mode
+	int m_iNumThreads;                         //!@ Number of worker threads (0: automatic)
+	bool m_bLazy;                              //!@ Transform magnitudes on first access
+	DAFFRecordCache* m_pCache;                 //!@ Magnitude cache of the lazy transformation
+	mutable std::mutex m_mxCache;              //!@ Guards the magnitude cache
+	float* m_pfBuf;                            //!@ Buffer for the magnitudes (eager transformation)
+	mutable std::vector<float> m_vfScratch;    //!@ Input values of the lazy transformation
+	std::vector<int> m_viRowBegin;             //!@ First matrix entry per target frequency
+	std::vector<int> m_viColumns;              //!@ Input value index per matrix entry
+	std::vector<float> m_vfWeights;            //!@ Weight per matrix entry
+	int m_iInputSize;                          //!@ Number of input values of a record channel
+	int m_iElementSize;                        //!@ Size of the magnitudes of a record channel (number of elements)
+	mutable float m_fOverallMagnitudePeak;     //!@ Maximum magnitude over all records/channels
+	mutable bool m_bPeakKnown;                 //!@ Maximum magnitude has been determined
+
+	//! Determines the remapping matrix for the input frequencies
+	void initMatrix();
+
+	//! Transforms the record channels [iBegin, iEnd) (with index record * channels + channel) into the buffer
+	/**
+	 * \param pfPeak	Greatest magnitude of the transformed record channels (output)
+	 */
+	void transformRange(int iBegin, int iEnd, float* pfPeak);
+
+	//! Computes the magnitudes of a record channel, returns their maximum
+	/**
+	 * \param pfInput	Buffer for the input values (2 * m_iInputSize floats)
+	 */
+	float transformMagnitudes(int iRecordIndex, int iChannel, float* pfInput, float* pfDest) const;
+
+	//! Locks the magnitude cache for lazy transformation (returns an unlocked lock otherwise)
+	std::unique_lock<std::mutex> lockCache() const;
+
+	//! Returns the magnitudes of a record channel, transformed on first access in lazy mode (NULL on errors)
+	/**
+	 * Requires the lock of lockCache(), the pointer is valid until the next call.
+	 */
+	const float* getMagnitudesPtrLocked(int iRecordIndex, int iChannel) const;
+
+	// Called by inner content class
+	float getOverallMagnitudeMaximum() const;
+	int getMagnitudes(int iRecordIndex, int iChannel, float* pfDest) const;
+	int addMagnitudes(int iRecordIndex, int iChannel, float* pfDest, float fGain) const;
+	int getRecord(int iRecordIndex, float** ppfChannelDest) const;
+	int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const;
+	int getMagnitude(int iRecordIndex, int iChannel, int iFreqIndex, float& fMag) const;
+	int getMagnitudeSlice(int iChannel, int iFreqIndex, float* pfDest) const;
+	const float* getMagnitudesPtr(int iRecordIndex, int iChannel) const;
+	int getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const;
+
+	friend class DAFFContentMSBandsRealization;
+
+	// No copy
+	DAFFTransformerMS2Bands(const DAFFTransformerMS2Bands&);
+	DAFFTransformerMS2Bands& operator=(const DAFFTransformerMS2Bands&);
+};
+
+#endif  // IW_DAFFTRANSFORMER_MS2BANDS
@@ -0,0 +1,294 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_TYPED_IR_VIEW
+#define IW_DAFF_TYPED_IR_VIEW
+
+#include <DAFFContentIR.h>
+#include <DAFFDefs.h>
+#include <DAFFProperties.h>
+#include <DAFFReader.h>
+
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+//! Sample type and conversion of a quantization (specialized for all #DAFF_QUANTIZATIONS but #DAFF_INT16_BFP)
+/**
+ * The conversions equal those of the reader: integer samples are scaled by the gain divided
+ * by the full scale, 16-bit floating point samples convert exactly into single precision.
+ * Block floating point samples depend on the scale of their record channel, such files are
+ * viewed after decoding (#DAFF_OPEN_DECODE, Q = #DAFF_FLOAT32).
+ */
+template <int Q>
+struct DAFFSampleTraits;
+
+template <>
+struct DAFFSampleTraits<DAFF_INT16> {
+	typedef short Sample;
+	static inline float getFactor(float fGain) { return fGain / 32767.0F; }
+	static inline float toFloat(const Sample* p, int i) { return (float)p[i]; }
+};
+
+template <>
+struct DAFFSampleTraits<DAFF_INT24> {
+	typedef unsigned char Sample;  // Three bytes per sample (little endian)
+	static inline float getFactor(float fGain) { return fGain / 8388607.0F; }
+	static inline float toFloat(const Sample* p, int i)
+	{
+		const Sample* q = p + 3 * i;
+		return (float)((int)(((unsigned int)q[0] << 8) | ((unsigned int)q[1] << 16) | ((unsigned int)q[2] << 24)) >> 8);
+	}
+};
+
+template <>
+struct DAFFSampleTraits<DAFF_FLOAT16> {
+	typedef unsigned short Sample;
+	static inline float getFactor(float fGain) { return fGain; }
+	static inline float toFloat(const Sample* p, int i)
+	{
+		// Shift exponent and mantissa into place, a multiplication by 2^112 rebiases the exponent
+		unsigned int u = (unsigned int)(p[i] & 0x7FFF) << 13;
+		float f;
+		memcpy(&f, &u, sizeof(float));
+		f *= 5.192296858534828e+33F;
+		memcpy(&u, &f, sizeof(float));
+		if (u >= 0x47800000)  // Infinity and NaN
+			u |= 0x7F800000;
+		u |= (unsigned int)(p[i] & 0x8000) << 16;
+		memcpy(&f, &u, sizeof(float));
+		return f;
+	}
+};
+
+template <>
+struct DAFFSampleTraits<DAFF_BFLOAT16> {
+	typedef unsigned short Sample;
+	static inline float getFactor(float fGain) { return fGain; }
+	static inline float toFloat(const Sample* p, int i)
+	{
+		unsigned int u = (unsigned int)p[i] << 16;
+		float f;
+		memcpy(&f, &u, sizeof(float));
+		return f;
+	}
+};
+
+template <>
+struct DAFFSampleTraits<DAFF_FLOAT32> {
+	typedef float Sample;
+	static inline float getFactor(float fGain) { return fGain; }
+	static inline float toFloat(const Sample* p, int i) { return p[i]; }
+};
+
+//! Non-virtual, typed view on the impulse responses of a reader
+/**
+ * The content interfaces select the conversion of the samples at runtime on every call, behind
+ * a virtual call and the record cache lock. For mixing engines that fetch many filters per
+ * block, this view resolves the data pointers of all record channels once (init) and provides
+ * inline kernels, which are specialized at compile time for the quantization Q, the guaranteed
+ * alignment A [Bytes] of the record channel data (see DAFFReader::getDataAlignment) and unit
+ * gain. The compiler can thereby inline and vectorize them into the calling loop.
+ *
+ * The quantization is the one of the data in memory: Files opened with #DAFF_OPEN_DECODE or
+ * #DAFF_OPEN_TRUNCATE are accessed with Q = #DAFF_FLOAT32. The results equal those of
+ * DAFFContentIR::getEffectiveFilterCoeffs and friends. Indices are only checked by assertions.
+ *
+ * The view keeps pointers into the data of the reader, which must stay opened while the view
+ * is used. Lazily loaded files are not supported, as their data pointers change on access.
+ * After init the view is read-only and can be used concurrently.
+ *
+ * Example:
+ *
+ *   DAFFTypedIRView<DAFF_INT16> oView;
+ *   if (oView.init(pReader) == DAFF_NO_ERROR)
+ *       oView.addEffectiveFilterCoeffs(iRecord, iChannel, pfFilter, fGain);
+ */
+template <int Q, int A = 1>
+class DAFFTypedIRView {
+  public:
+	//! Sample type of the quantization
+	typedef typename DAFFSampleTraits<Q>::Sample Sample;
+
+	//! Default constructor (invalid view)
+	DAFFTypedIRView() : m_iNumRecords(0), m_iNumChannels(0), m_iFilterLength(0) {}
+
+	//! Resolves the data of all record channels of a reader
+	/**
+	 * \param [in] pReader	Reader of an opened impulse response file
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if the file is no IR content, loaded
+	 *         lazily, has another quantization in memory than Q or a smaller data alignment than A,
+	 *         #DAFF_FILE_CORRUPTED on unreadable data (the view is cleared on errors)
+	 */
+	int init(const DAFFReader* pReader)
+	{
+		clear();
+		if ((pReader == NULL) || !pReader->isFileOpened() || (pReader->getContentType() != DAFF_IMPULSE_RESPONSE) ||
+			pReader->isLazy() || (pReader->getDataAlignment() < A))
+			return DAFF_MODAL_ERROR;
+
+		const DAFFContentIR* pContent = static_cast<const DAFFContentIR*>(pReader->getContent());
+		int iNumRecords = pReader->getProperties()->getNumberOfRecords();
+		int iNumChannels = pReader->getProperties()->getNumberOfChannels();
+		size_t nNumRecordChannels = (size_t)iNumRecords * iNumChannels;
+		m_vpData.resize(nNumRecordChannels);
+		m_viOffsets.resize(nNumRecordChannels);
+		m_viLengths.resize(nNumRecordChannels);
+
+		for (int iRecord = 0; iRecord < iNumRecords; iRecord++) {
+			for (int iChannel = 0; iChannel < iNumChannels; iChannel++) {
+				size_t n = (size_t)iRecord * iNumChannels + iChannel;
+				int iQuantization = -1;
+				int iNumValues = 0;
+				const void* pData = pReader->getRecordChannelRawDataPtr(iRecord, iChannel, iQuantization, iNumValues);
+				int iError = (iQuantization != Q) ? DAFF_MODAL_ERROR : (pData ? DAFF_NO_ERROR : DAFF_FILE_CORRUPTED);
+				if (iError == DAFF_NO_ERROR)
+					iError = pContent->getEffectiveFilterBounds(iRecord, iChannel, m_viOffsets[n], m_viLengths[n]);
+				if (iError != DAFF_NO_ERROR) {
+					clear();
+					return iError;
+				}
+
+				m_vpData[n] = (const Sample*)pData;
+			}
+		}
+
+		m_iNumRecords = iNumRecords;
+		m_iNumChannels = iNumChannels;
+		m_iFilterLength = pContent->getFilterLength();
+
+		return DAFF_NO_ERROR;
+	}
+
+	//! Free memory (invalid view)
+	void clear()
+	{
+		m_iNumRecords = 0;
+		m_iNumChannels = 0;
+		m_iFilterLength = 0;
+		m_vpData.clear();
+		m_viOffsets.clear();
+		m_viLengths.clear();
+	}
+
+	//! Returns true if the view is initialized
+	bool isValid() const { return !m_vpData.empty(); }
+
+	//! Returns the number of records (0 if invalid)
+	int getNumRecords() const { return m_iNumRecords; }
+
+	//! Returns the number of channels (0 if invalid)
+	int getNumChannels() const { return m_iNumChannels; }
+
+	//! Returns the filter length [samples] (0 if invalid)
+	int getFilterLength() const { return m_iFilterLength; }
+
+	//! Returns the effective filter bounds of a record channel (see DAFFContentIR::getEffectiveFilterBounds)
+	inline void getEffectiveFilterBounds(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const
+	{
+		size_t n = getIndex(iRecordIndex, iChannel);
+		iOffset = m_viOffsets[n];
+		iLength = m_viLengths[n];
+	}
+
+	//! Returns the samples of the effective filter coefficients of a record channel
+	inline const Sample* getEffectiveDataPtr(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const
+	{
+		getEffectiveFilterBounds(iRecordIndex, iChannel, iOffset, iLength);
+		return getData(getIndex(iRecordIndex, iChannel));
+	}
+
+	//! Writes the effective filter coefficients of a record channel with unit gain (getEffectiveFilterBounds() values)
+	inline void getEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest) const
+	{
+		size_t n = getIndex(iRecordIndex, iChannel);
+		convert(getData(n), m_viLengths[n], DAFFSampleTraits<Q>::getFactor(1.0F), pfDest);
+	}
+
+	//! Writes the effective filter coefficients of a record channel multiplied by a gain
+	inline void getEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
+	{
+		size_t n = getIndex(iRecordIndex, iChannel);
+		convert(getData(n), m_viLengths[n], DAFFSampleTraits<Q>::getFactor(fGain), pfDest);
+	}
+
+	//! Adds the effective filter coefficients of a record channel with unit gain to a buffer
+	inline void addEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest) const
+	{
+		size_t n = getIndex(iRecordIndex, iChannel);
+		accumulate(getData(n), m_viLengths[n], DAFFSampleTraits<Q>::getFactor(1.0F), pfDest);
+	}
+
+	//! Adds the effective filter coefficients of a record channel multiplied by a gain to a buffer
+	inline void addEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
+	{
+		size_t n = getIndex(iRecordIndex, iChannel);
+		accumulate(getData(n), m_viLengths[n], DAFFSampleTraits<Q>::getFactor(fGain), pfDest);
+	}
+
+	//! Writes the full filter of a record channel multiplied by a gain (getFilterLength() values, zero padded)
+	inline void getFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		size_t n = getIndex(iRecordIndex, iChannel);
+		int iOffset = m_viOffsets[n];
+		int iLength = m_viLengths[n];
+		memset(pfDest, 0, iOffset * sizeof(float));
+		convert(getData(n), iLength, DAFFSampleTraits<Q>::getFactor(fGain), pfDest + iOffset);
+		memset(pfDest + iOffset + iLength, 0, (m_iFilterLength - iOffset - iLength) * sizeof(float));
+	}
+
+	//! Adds the full filter of a record channel multiplied by a gain to a buffer (getFilterLength() values)
+	inline void addFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		size_t n = getIndex(iRecordIndex, iChannel);
+		accumulate(getData(n), m_viLengths[n], DAFFSampleTraits<Q>::getFactor(fGain), pfDest + m_viOffsets[n]);
+	}
+
+  private:
+	int m_iNumRecords;                    //!@ Number of records
+	int m_iNumChannels;                   //!@ Number of channels
+	int m_iFilterLength;                  //!@ Filter length [samples]
+	std::vector<const Sample*> m_vpData;  //!@ Effective samples (index record * channels + channel)
+	std::vector<int> m_viOffsets;         //!@ Effective filter offsets (same index)
+	std::vector<int> m_viLengths;         //!@ Effective filter lengths (same index)
+
+	inline size_t getIndex(int iRecordIndex, int iChannel) const
+	{
+		assert((iRecordIndex >= 0) && (iRecordIndex < m_iNumRecords));
+		assert((iChannel >= 0) && (iChannel < m_iNumChannels));
+		return (size_t)iRecordIndex * m_iNumChannels + iChannel;
+	}
+
+	// The alignment lets the compiler use aligned loads of the samples
+	inline const Sample* getData(size_t n) const
+	{
+#ifdef __GNUC__
+		return (const Sample*)__builtin_assume_aligned(m_vpData[n], A);
+#else
+		return m_vpData[n];
+#endif
+	}
+
+	static inline void convert(const Sample* p, int iCount, float fFactor, float* pfDest)
+	{
+		for (int i = 0; i < iCount; i++)
+			pfDest[i] = DAFFSampleTraits<Q>::toFloat(p, i) * fFactor;
+	}
+
+	static inline void accumulate(const Sample* p, int iCount, float fFactor, float* pfDest)
+	{
+		for (int i = 0; i < iCount; i++)
+			pfDest[i] += DAFFSampleTraits<Q>::toFloat(p, i) * fFactor;
+	}
+};
+
+#endif  // IW_DAFF_TYPED_IR_VIEW
@@ -67,6 +67,12 @@ class DAFF_API DAFFUtils {
 	//! Returns a string corresponding to a quantization type
 	static std::string StrQuantizationType(int iQuantizationType);
 
+	//! Returns a string corresponding to a symmetry (e.g. "axial")
+	static std::string StrSymmetry(int iSymmetry);
+
+	//! Returns a string corresponding to a record order (e.g. "Hilbert curve")
+	static std::string StrRecordOrder(int iRecordOrder);
+
 	//! Normalize a direction (angular pair)
 	/**
 	 * The methods normalizes directions regarding a spherical coordinate system (data|object)
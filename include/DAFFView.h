@@ -0,0 +1,144 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_VIEW
+#define IW_DAFF_VIEW
+
+#include <DAFFDefs.h>
+#include <DAFFSCTransform.h>
+
+#include <cstring>  // required for size_t
+
+// Forward declarations
+class DAFFContent;
+
+//! Oriented view on shared content
+/**
+ * A view combines a content with an orientation of its own, independent of the
+ * orientation of the reader (DAFFProperties::setOrientation). Several sound sources
+ * sharing one directivity at different rotations can thereby use a single reader
+ * with one small view each, instead of one reader (and a copy of the data) per source.
+ *
+ * The methods equal those of DAFFContent. In the object view the directions are
+ * transformed with the orientation of the view, the data view is passed through.
+ * Record data is accessed on the content with the resulting record indices. For
+ * interpolation, directions can be transformed into the data view using
+ * transformAnglesO2D() and passed to DAFFInterpolator with #DAFF_DATA_VIEW.
+ *
+ * The view keeps a pointer to the content, which must outlive it. Queries are const
+ * and can run concurrently, the orientation must not be changed at the same time.
+ */
+class DAFF_API DAFFView {
+  public:
+	//! Constructor with the default orientation of the content (as stored in the file)
+	/**
+	 * \param [in] pContent	Content
+	 */
+	DAFFView(const DAFFContent* pContent);
+
+	//! Constructor with an initial orientation
+	/**
+	 * \param [in] pContent	Content
+	 * \param [in] o			Orientation
+	 */
+	DAFFView(const DAFFContent* pContent, const DAFFOrientationYPR& o);
+
+	//! Returns the content
+	const DAFFContent* getContent() const;
+
+	//! Returns the orientation of the view
+	void getOrientation(DAFFOrientationYPR& o) const;
+
+	//! Sets the orientation of the view
+	void setOrientation(const DAFFOrientationYPR& o);
+
+	//! Determines the spherical coordinates of a record
+	/**
+	 * \sa DAFFContent::getRecordCoords
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int getRecordCoords(int iRecordIndex, int iView, float& fAngle1Deg, float& fAngle2Deg) const;
+
+	//! Determines the nearest neighbour record of a direction
+	/**
+	 * \sa DAFFContent::getNearestNeighbour
+	 */
+	void getNearestNeighbour(int iView, float fAngle1Deg, float fAngle2Deg, int& iRecordIndex) const;
+
+	//! Determines the nearest neighbour record of a direction and whether it is out of bounds
+	/**
+	 * \sa DAFFContent::getNearestNeighbour
+	 */
+	void getNearestNeighbour(int iView, float fAngle1Deg, float fAngle2Deg, int& iRecordIndex,
+							 bool& bOutOfBounds) const;
+
+	//! Determines the nearest neighbour records of many directions at once
+	/**
+	 * \sa DAFFContent::getNearestNeighbours
+	 */
+	void getNearestNeighbours(int iView, const float* pfAngles1Deg, const float* pfAngles2Deg, int* piRecordIndices,
+							  bool* pbOutOfBounds, size_t n) const;
+
+	//! Determines the k nearest records of a direction and their great-circle distances
+	/**
+	 * \sa DAFFContent::getKNearestNeighbours
+	 *
+	 * @return Number of records found
+	 */
+	int getKNearestNeighbours(int iView, float fAngle1Deg, float fAngle2Deg, int k, int* piRecordIndices,
+							  float* pfDistancesDeg) const;
+
+	//! Determines the k nearest records of many directions at once
+	/**
+	 * \sa DAFFContent::getKNearestNeighbours
+	 *
+	 * @return Number of records found per direction
+	 */
+	int getKNearestNeighbours(int iView, const float* pfAngles1Deg, const float* pfAngles2Deg, int k,
+							  int* piRecordIndices, float* pfDistancesDeg, size_t n) const;
+
+	//! Determines all records within an angular radius around a direction
+	/**
+	 * \sa DAFFContent::getRecordsInCone
+	 *
+	 * @return Number of records found
+	 */
+	int getRecordsInCone(int iView, float fAngle1Deg, float fAngle2Deg, float fRadiusDeg,
+						 std::vector<int>& viRecordIndices) const;
+
+	//! Determines all records within an angular radius around many directions at once
+	/**
+	 * \sa DAFFContent::getRecordsInCone
+	 *
+	 * @return Total number of records found
+	 */
+	int getRecordsInCone(int iView, const float* pfAngles1Deg, const float* pfAngles2Deg, float fRadiusDeg,
+						 std::vector<int>& viRecordIndices, std::vector<int>& viOffsets, size_t n) const;
+
+	//! Determines the cell of a direction on the sphere grid
+	/**
+	 * \sa DAFFContent::getCell
+	 */
+	void getCell(int iView, float fAngle1Deg, float fAngle2Deg, DAFFQuad& qIndices) const;
+
+	//! Transforms data spherical coordinates into object spherical coordinates of the view
+	void transformAnglesD2O(float fAlphaDeg, float fBetaDeg, float& fAzimuthDeg, float& fElevationDeg) const;
+
+	//! Transforms object spherical coordinates of the view into data spherical coordinates
+	void transformAnglesO2D(float fAzimuthDeg, float fElevationDeg, float& fAlphaDeg, float& fBetaDeg) const;
+
+  private:
+	const DAFFContent* m_pContent;  //!@ Content
+	DAFFSCTransform m_tTrans;       //!@ Spherical coordinates transformer of the view
+};
+
+#endif  // IW_DAFF_VIEW
@@ -0,0 +1,605 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_WRITER
+#define IW_DAFF_WRITER
+
+#include <DAFFDefs.h>
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class DAFFMetadata;
+struct DAFFFileBlockEntry;
+
+//! Supplier of the record data for DAFFWriter
+/**
+ * Implement this interface to deliver the data of the records (directions) one
+ * after another, for instance from measurements or from a simulation.
+ */
+class DAFF_API DAFFWriterCallback {
+  public:
+	inline virtual ~DAFFWriterCallback() {};
+
+	//! Delivers the data of a record
+	/**
+	 * The destination buffers are zeroed before the call.
+	 *
+	 * \param [in] iRecordIndex		Record index
+	 * \param [in] fAlphaDeg			Alpha angle of the record direction (data view) [degrees]
+	 * \param [in] fBetaDeg			Beta angle of the record direction (data view) [degrees]
+	 * \param [out] ppfChannelData	Destination of each channel (DAFFWriter::getRecordDataLength() floats)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR aborts writing (and is returned by DAFFWriter::write)
+	 */
+	virtual int getRecordData(int iRecordIndex, float fAlphaDeg, float fBetaDeg, float** ppfChannelData) = 0;
+
+	//! Returns the metadata of a record (optional)
+	/**
+	 * The metadata is serialized right away and may be released afterwards.
+	 *
+	 * @return Metadata, or NULL if the record has no metadata (default)
+	 */
+	inline virtual const DAFFMetadata* getRecordMetadata(int) { return NULL; };
+};
+
+//! Writer for DAFF files (version 1.7)
+/**
+ * Native replacement of the MATLAB function daffv17_write. The content, the grid
+ * and the quantization are configured first, then write() fetches the records
+ * in the order of the record indices from a callback and streams them into the
+ * file in a single pass.
+ *
+ * For measurement rigs that deliver one direction at a time, the records can also
+ * be streamed manually: open() the file, appendRecord() in the order of the record
+ * indices (see getNextRecordIndex and getRecordCoords for the direction of the next
+ * record) and close() it. Record data goes directly into the data block, the record descriptors and
+ * the record metadata are collected in temporary files, so that the memory usage
+ * does not depend on the number of records.
+ *
+ * The effective bounds of impulse responses (leading zeros and effective length,
+ * see DAFFContentIR::getEffectiveFilterBounds) are determined with a single SIMD
+ * pass over each channel: coefficients whose absolute value does not exceed the zero
+ * threshold are omitted at the beginning and at the end. Like in daffv17_write, the
+ * offsets are rounded down and the lengths up to multiples of four.
+ *
+ * Every record channel starts at a 16-byte boundary within the data block. For
+ * aligned SIMD kernels on the zero-copy data of readers, the data block and the record
+ * channels can start at 32- or 64-byte boundaries instead (see setDataAlignment). The
+ * block table, the content header and the record descriptors are written when all
+ * records have been delivered (close). A failed or incomplete file is removed,
+ * also if the writer is destroyed while the file is open.
+ *
+ * Optionally, the record data is compressed losslessly into a compressed data block
+ * (see setCompression). Every record channel becomes a chunk of its own, so readers
+ * keep random access and decompress only the touched chunks when loading lazily.
+ * Note that readers without support for compressed data blocks reject such files.
+ *
+ * Record channels with identical data (e.g. the records at the poles or symmetric
+ * halves) can share their stored data (see setDeduplication): their descriptors then
+ * point to the same data offset, which is valid in every DAFF v1.7 file.
+ *
+ * To speed up the reader, the writer can embed the statistics of the stored record
+ * channels (see setStatistics) and the nearest neighbour index of the record directions
+ * (see setDirectionIndex), which readers otherwise compute on first use resp. while
+ * loading irregular grids. Checksums of all file blocks (see setChecksums) let readers
+ * detect corrupted files.
+ *
+ * For previews of dense grids (e.g. browsing over the network), the record data of regular
+ * grids can be ordered by resolution levels (see setNumLevels): a coarse subgrid first, then
+ * the records that refine it, so that streaming readers show the coarse grid early.
+ * For queries that touch neighbouring directions (interpolation, regions, prefetching), the
+ * record data can be stored along a space-filling curve over the directions (see
+ * setRecordOrder), so that nearby records are also close in the file.
+ *
+ * The layout of the record data delivered by the callback (per channel):
+ *   - Impulse responses: getFilterLength() coefficients
+ *   - Magnitude spectra: one magnitude per frequency
+ *   - Phase spectra: one phase [radians] per frequency
+ *   - Magnitude-phase spectra: interleaved real and imaginary parts per frequency
+ *   - DFT spectra: interleaved real and imaginary parts of the stored DFT coefficients
+ */
+class DAFF_API DAFFWriter {
+  public:
+	//! Default constructor (no content, one channel, full sphere with a single record)
+	DAFFWriter();
+
+	//! Destructor
+	virtual ~DAFFWriter();
+
+	// --= Content =--
+
+	//! Configures impulse response content
+	/**
+	 * \param [in] iFilterLength	Number of filter coefficients
+	 * \param [in] fSamplerate	Sampling rate [Hz]
+	 */
+	void setImpulseResponses(int iFilterLength, float fSamplerate);
+
+	//! Configures magnitude spectrum content
+	/**
+	 * \param [in] vfFrequencies	Support frequencies [Hz]
+	 */
+	void setMagnitudeSpectra(const std::vector<float>& vfFrequencies);
+
+	//! Configures phase spectrum content
+	/**
+	 * \param [in] vfFrequencies	Support frequencies [Hz]
+	 */
+	void setPhaseSpectra(const std::vector<float>& vfFrequencies);
+
+	//! Configures magnitude-phase spectrum content
+	/**
+	 * \param [in] vfFrequencies	Support frequencies [Hz]
+	 */
+	void setMagnitudePhaseSpectra(const std::vector<float>& vfFrequencies);
+
+	//! Configures DFT spectrum content
+	/**
+	 * \param [in] iTransformSize	DFT transform size
+	 * \param [in] fSamplerate		Sampling rate [Hz]
+	 * \param [in] bSymmetric		Store only iTransformSize/2+1 coefficients (real signals)? [optional, default: yes]
+	 */
+	void setDFTSpectra(int iTransformSize, float fSamplerate, bool bSymmetric = true);
+
+	//! Returns the content type (one of #DAFF_CONTENT_TYPES, -1 if not configured)
+	int getContentType() const;
+
+	//! Returns the number of float values per channel delivered by the callback
+	int getRecordDataLength() const;
+
+	//! Returns the quantization
+	int getQuantization() const;
+
+	//! Sets the quantization (default: #DAFF_FLOAT32, integer quantizations for impulse responses only)
+	/**
+	 * #DAFF_FLOAT16 and #DAFF_BFLOAT16 are available for all content types, values are rounded to nearest even.
+	 * #DAFF_INT16_BFP stores every record channel of impulse responses with the peak of its effective part as
+	 * scale, so that quiet records keep the full 16-bit resolution (e.g. off-axis directions).
+	 */
+	void setQuantization(int iQuantization);
+
+	//! Returns the number of channels
+	int getNumChannels() const;
+
+	//! Sets the number of channels (default: 1)
+	void setNumChannels(int iNumChannels);
+
+	//! Returns the zero threshold of the effective bounds [dB]
+	float getZeroThreshold() const;
+
+	//! Sets the zero threshold of the effective bounds of impulse responses [dB]
+	/**
+	 * \param [in] fThresholdDB	Threshold relative to 1 [dB] (default: -infinity, only zeros are omitted)
+	 */
+	void setZeroThreshold(float fThresholdDB);
+
+	//! Indicates whether the record data is compressed
+	bool getCompression() const;
+
+	//! Enables the lossless compression of the record data (default: disabled)
+	/**
+	 * The samples of each record channel (floats as their bit patterns) are predicted with
+	 * a fixed polynomial predictor and the residuals are Rice coded, like in FLAC. Record
+	 * channels that do not shrink are stored uncompressed.
+	 *
+	 * \param [in] bEnabled	Compress the record data into a compressed data block
+	 */
+	void setCompression(bool bEnabled);
+
+	//! Returns the alignment of the record channels [Bytes]
+	int getDataAlignment() const;
+
+	//! Sets the alignment of the record channels (default: 16 Bytes)
+	/**
+	 * The data block starts at a boundary of the alignment within the file and every record
+	 * channel at a boundary within the data block. The effective bounds of impulse responses
+	 * are rounded to multiples of a quarter of the alignment (floats), so that the effective
+	 * data starts aligned as well. Readers report the alignment of their record data with
+	 * DAFFReader::getDataAlignment. The files stay compatible with all DAFF v1.7 readers.
+	 *
+	 * \param [in] iAlignment	16, 32 (AVX) or 64 (AVX-512, cache lines) [Bytes]
+	 */
+	void setDataAlignment(int iAlignment);
+
+	//! Indicates whether identical record channel data is stored only once
+	bool getDeduplication() const;
+
+	//! Enables the deduplication of record channel data (default: disabled)
+	/**
+	 * The stored data of every record channel (compressed, if enabled) is hashed. Record
+	 * channels whose data equals the data of a preceding one refer to the stored data
+	 * instead of storing it again. Candidates are compared with the bytes in the file,
+	 * so hash collisions can not corrupt the record data.
+	 *
+	 * \param [in] bEnabled	Share the data of identical record channels
+	 */
+	void setDeduplication(bool bEnabled);
+
+	//! Returns the number of record channels that refer to the data of a preceding one (last written file)
+	int getNumSharedRecordChannels() const;
+
+	//! Indicates whether a statistics block is written
+	bool getStatistics() const;
+
+	//! Enables the statistics block for impulse responses and magnitude spectra (default: disabled)
+	/**
+	 * Peak, energy and onset of every record channel are determined from the stored
+	 * values (after trimming and quantization), so readers report the same statistics
+	 * as without the block, but do not need to scan the record data. Other content types
+	 * have no statistics and ignore the setting.
+	 *
+	 * \param [in] bEnabled	Write the statistics block
+	 */
+	void setStatistics(bool bEnabled);
+
+	//! Indicates whether a direction index block is written
+	bool getDirectionIndex() const;
+
+	//! Enables the direction index block (default: disabled)
+	/**
+	 * The block holds the tree of the nearest neighbour index of all record directions
+	 * (of the full grid, if symmetric), which readers otherwise build while loading
+	 * irregular grids and on the first k-nearest neighbour query on regular grids.
+	 *
+	 * \param [in] bEnabled	Write the direction index block
+	 */
+	void setDirectionIndex(bool bEnabled);
+
+	//! Indicates whether a checksum block is written
+	bool getChecksums() const;
+
+	//! Enables the checksum block (default: disabled)
+	/**
+	 * The block holds the CRC-32C of every 1 MiB segment of all other file blocks and of the
+	 * block table. Readers verify the blocks they load if opened with #DAFF_OPEN_VERIFY,
+	 * readers without support for the block ignore it. The checksums are computed from the
+	 * written file when it is closed, which reads the file once more.
+	 *
+	 * \param [in] bEnabled	Write the checksum block
+	 */
+	void setChecksums(bool bEnabled);
+
+	//! Returns the number of resolution levels of the record data
+	int getNumLevels() const;
+
+	//! Sets the number of resolution levels of the record data (default: 1, record order)
+	/**
+	 * With K > 1 levels the records of regular grids without symmetry are stored level by level
+	 * and a level block describes where the data of each level ends. The level l (from 0) holds
+	 * the records whose alpha and beta indices are multiples of 2^(K-1-l) and that no coarser
+	 * level holds, the poles belong to level 0. E.g. with 4 levels, level 0 is the subgrid of
+	 * every 8th alpha and beta point. Readers that stream the file (#DAFF_OPEN_STREAM) refine
+	 * their nearest neighbours level by level, other readers are not affected. Records are then
+	 * delivered and appended in the order of the levels (see getNextRecordIndex). Irregular and
+	 * symmetric grids are always stored in record order.
+	 *
+	 * \param [in] iNumLevels	Number of levels (1-8)
+	 */
+	void setNumLevels(int iNumLevels);
+
+	//! Returns the order of the record data (#DAFF_RECORD_ORDERS)
+	int getRecordOrder() const;
+
+	//! Sets the order of the record data within the data block (default: #DAFF_RECORD_ORDER_INDEX)
+	/**
+	 * With #DAFF_RECORD_ORDER_MORTON or #DAFF_RECORD_ORDER_HILBERT the records are stored along
+	 * a Morton resp. Hilbert curve over their directions in the data view, so that records of
+	 * nearby directions are also close in the file (fewer pages and cache lines per query of a
+	 * neighbourhood). A record order block tells readers the order, the record indices and the
+	 * grid do not change. Together with resolution levels the records of each level are ordered
+	 * along the curve. Records are then delivered and appended in the order of the curve (see
+	 * getNextRecordIndex and getAppendOrder).
+	 *
+	 * \param [in] iRecordOrder	Record order (#DAFF_RECORD_ORDERS)
+	 */
+	void setRecordOrder(int iRecordOrder);
+
+	// --= Grid =--
+
+	//! Sets a regular grid (like the arguments of daffv17_write)
+	/**
+	 * Every beta point at a pole (0 or 180 degrees) contributes a single record,
+	 * all other beta points contribute iAlphaPoints records.
+	 *
+	 * \param [in] iAlphaPoints	Number of alpha points
+	 * \param [in] fAlphaStart	Alpha range start [degrees]
+	 * \param [in] fAlphaEnd		Alpha range end [degrees] (360: full circle)
+	 * \param [in] iBetaPoints	Number of beta points (including poles)
+	 * \param [in] fBetaStart	Beta range start [degrees]
+	 * \param [in] fBetaEnd		Beta range end [degrees]
+	 */
+	void setGrid(int iAlphaPoints, float fAlphaStart, float fAlphaEnd, int iBetaPoints, float fBetaStart,
+				 float fBetaEnd);
+
+	//! Returns the symmetry of the grid (#DAFF_SYMMETRIES)
+	int getSymmetry() const;
+
+	//! Sets the symmetry of the grid (default: #DAFF_SYMMETRY_NONE)
+	/**
+	 * Only the unique records of symmetric sources are stored, readers reconstruct the
+	 * others (see DAFFReader::getSymmetry). The regular grid must cover the full alpha
+	 * range (0-360), with an even number of alpha points for #DAFF_SYMMETRY_MIRROR.
+	 * getNumRecords and getRecordCoords then refer to the stored records: a single
+	 * meridian (alpha = 0) for #DAFF_SYMMETRY_AXIAL, the alpha range 0-180 for
+	 * #DAFF_SYMMETRY_MIRROR. Readers without support for symmetry blocks read the
+	 * stored records only.
+	 *
+	 * \param [in] iSymmetry	One of #DAFF_SYMMETRIES
+	 */
+	void setSymmetry(int iSymmetry);
+
+	//! Sets an irregular grid with explicit record directions (record directions block)
+	/**
+	 * \param [in] vfAlphaDeg	Alpha angles of the records [degrees], within [0, 360)
+	 * \param [in] vfBetaDeg		Beta angles of the records [degrees], within [0, 180]
+	 */
+	void setRecordDirections(const std::vector<float>& vfAlphaDeg, const std::vector<float>& vfBetaDeg);
+
+	//! Returns the number of stored records of the grid (0 if the grid is invalid)
+	int getNumRecords() const;
+
+	//! Returns the direction of a record in the data view, as the reader determines it
+	/**
+	 * @return #DAFF_NO_ERROR on success, #DAFF_INVALID_INDEX otherwise
+	 */
+	int getRecordCoords(int iRecordIndex, float& fAlphaDeg, float& fBetaDeg) const;
+
+	//! Returns the orientation of the object
+	DAFFOrientationYPR getOrientation() const;
+
+	//! Sets the orientation of the object (default: no rotation)
+	void setOrientation(const DAFFOrientationYPR& oOrientation);
+
+	// --= Metadata =--
+
+	//! Sets the global metadata (NULL: none)
+	/**
+	 * The metadata is not copied and must stay valid until write returned.
+	 */
+	void setMetadata(const DAFFMetadata* pMetadata);
+
+	// --= Writing =--
+
+	//! Writes a DAFF file, fetching the records from the callback
+	/**
+	 * \param [in] sFilePath		File path
+	 * \param [in] pCallback		Supplier of the record data
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise (#DAFF_FILE_NOT_FOUND if not writable)
+	 */
+	int write(const std::string& sFilePath, DAFFWriterCallback* pCallback);
+
+	// --= Streaming =--
+
+	//! Creates a file for appending records
+	/**
+	 * The configuration must not be changed until the file is closed.
+	 *
+	 * \param [in] sFilePath		File path
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if a file is open, another #DAFF_ERROR otherwise
+	 */
+	int open(const std::string& sFilePath);
+
+	//! Indicates whether a file is open for appending records
+	bool isOpen() const;
+
+	//! Returns the number of records appended to the open file
+	int getNumAppendedRecords() const;
+
+	//! Returns the index of the record to be appended next (-1 if no file is open or all records have been appended)
+	/**
+	 * The record index equals getNumAppendedRecords(), unless the records are ordered by
+	 * resolution levels (see setNumLevels) or along a curve (see setRecordOrder).
+	 */
+	int getNextRecordIndex() const;
+
+	//! Returns the record indices in the order of appending, for the current grid and settings
+	/**
+	 * Does not require an open file, e.g. for preparing the records in the order of appending.
+	 *
+	 * \param [out] viRecordIndices	Record indices (getNumRecords() elements)
+	 */
+	void getAppendOrder(std::vector<int>& viRecordIndices) const;
+
+	//! Appends the next record to the open file
+	/**
+	 * \param [in] ppfChannelData	Data of each channel (getRecordDataLength() floats, layout as for the callback)
+	 * \param [in] pMetadata			Record metadata, serialized right away [optional, default: none]
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if no file is open or all records have been
+	 *         appended, #DAFF_FILE_NOT_FOUND if the file is not writable (the file is removed)
+	 */
+	int appendRecord(float** ppfChannelData, const DAFFMetadata* pMetadata = NULL);
+
+	//! Writes the record descriptors, the metadata and the headers and closes the file
+	/**
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if no file is open or records are
+	 *         missing (the file is removed), #DAFF_FILE_NOT_FOUND if the file is not writable
+	 */
+	int close();
+
+  private:
+	int m_iContentType;                  //!@ Content type (-1: not configured)
+	int m_iQuantization;                 //!@ Quantization
+	int m_iNumChannels;                  //!@ Number of channels
+	int m_iElementsPerRecord;            //!@ Filter length, number of frequencies or DFT coefficients
+	int m_iTransformSize;                //!@ DFT transform size
+	float m_fSamplerate;                 //!@ Sampling rate [Hz] (IR and DFT)
+	std::vector<float> m_vfFrequencies;  //!@ Support frequencies [Hz] (MS, PS and MPS)
+	float m_fZeroThresholdDB;            //!@ Zero threshold of the effective bounds [dB]
+	bool m_bCompression;                 //!@ Compress the record data (compressed data block)
+	int m_iDataAlignment;                //!@ Alignment of the record channels [Bytes]
+	bool m_bDeduplication;               //!@ Share the data of identical record channels
+	bool m_bStatistics;                  //!@ Write the statistics block (IR and MS)
+	bool m_bDirectionIndex;              //!@ Write the direction index block
+	bool m_bChecksums;                   //!@ Write the checksum block
+	int m_iNumLevels;                    //!@ Number of resolution levels of the record data
+	int m_iRecordOrder;                  //!@ Order of the record data (#DAFF_RECORD_ORDERS)
+	int m_iSymmetry;                     //!@ Symmetry of the grid (only the unique records are stored)
+	int m_iAlphaPoints;                  //!@ Number of alpha points
+	float m_fAlphaStart;                 //!@ Alpha range start [degrees]
+	float m_fAlphaEnd;                   //!@ Alpha range end [degrees]
+	int m_iBetaPoints;                   //!@ Number of beta points
+	float m_fBetaStart;                  //!@ Beta range start [degrees]
+	float m_fBetaEnd;                    //!@ Beta range end [degrees]
+	std::vector<float> m_vfAlpha;        //!@ Alpha angles of an irregular grid [degrees]
+	std::vector<float> m_vfBeta;         //!@ Beta angles of an irregular grid [degrees]
+	DAFFOrientationYPR m_oOrientation;   //!@ Orientation of the object
+	const DAFFMetadata* m_pMetadata;     //!@ Global metadata (not owned, may be NULL)
+
+	// Writing state
+	FILE* m_pFile;                      //!@ File being written (NULL: none)
+	std::string m_sFilePath;            //!@ Path of the file being written
+	uint64_t m_ui64DataOffset;          //!@ Position of the data block in the file [Bytes]
+	uint64_t m_ui64DataSize;            //!@ Size of the (uncompressed) data written so far [Bytes]
+	uint64_t m_ui64CompressedSize;      //!@ Size of the compressed data block written so far [Bytes]
+	FILE* m_pChunkFile;                 //!@ Temporary file of the chunk table (file byte order)
+	int m_iNumChunks;                   //!@ Number of compressed chunks written so far
+	FILE* m_pDescFile;                  //!@ Temporary file of the record descriptors (file byte order)
+	FILE* m_pMetadataFile;              //!@ Temporary file of the serialized record metadata
+	FILE* m_pStatisticsFile;            //!@ Temporary file of the statistics (file byte order)
+	uint64_t m_ui64RecordMetadataSize;  //!@ Size of the serialized record metadata [Bytes]
+	int m_iNumAppendedRecords;          //!@ Number of records written so far
+	int m_iNumRecordMetadata;           //!@ Number of serialized record metadata
+	int m_iMinFilterOffset;             //!@ Minimum effective filter offset so far (IR)
+	int m_iMaxEffectiveFilterLength;    //!@ Maximum effective filter length so far (IR)
+	float m_fMax;                       //!@ Greatest magnitude so far (MS, MPS, DFT)
+	std::vector<char> m_vcBuf;          //!@ Buffer for the conversion into the file format
+	std::vector<char> m_vcChunk;        //!@ Buffer of a compressed chunk
+	std::vector<float> m_vfStored;      //!@ Buffer for the stored values of a record channel (statistics, scaling)
+
+	// Resolution levels and record order
+	std::vector<int> m_viAppendOrder;            //!@ Record indices in the order of appending (empty: record order)
+	std::vector<int> m_viLevelRecordEnds;        //!@ Number of appended records at the end of each level
+	std::vector<uint64_t> m_vui64LevelDataEnds;  //!@ Data size at the end of each completed level [Bytes]
+
+	//! Stored data of a record channel (deduplication)
+	struct PayloadEntry {
+		uint64_t ui64DataOffset;  //!@ Offset within the (uncompressed) data [Bytes]
+		uint64_t ui64DataSize;    //!@ Size of the (uncompressed) data [Bytes]
+		uint64_t ui64Offset;      //!@ Position of the stored bytes in the file [Bytes]
+		uint64_t ui64Size;        //!@ Number of stored bytes [Bytes]
+		int iMethod;              //!@ Compression method of the stored bytes
+	};
+
+	typedef std::multimap<uint64_t, PayloadEntry> PayloadMap;
+
+	PayloadMap m_mPayloads;          //!@ Stored data by hash (deduplication)
+	std::vector<char> m_vcCompare;   //!@ Buffer for comparing with stored data
+	int m_iNumSharedRecordChannels;  //!@ Number of record channels sharing stored data
+
+	//! Validates the configuration
+	/**
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int validate() const;
+
+	//! Indicates whether the statistics block is written (enabled and supported by the content type)
+	bool hasStatistics() const;
+
+	//! Indicates whether the record data is ordered by resolution levels (more than one level, regular grid)
+	bool hasLevels() const;
+
+	//! Indicates whether the record data is ordered along a curve (record order block)
+	bool hasRecordOrder() const;
+
+	//! Determines the order of appending and the number of records at the end of each level (if any)
+	void computeAppendOrder(std::vector<int>& viRecordIndices, std::vector<int>& viLevelRecordEnds) const;
+
+	//! Determines the order of appending and the number of records of each level
+	void initLevels();
+
+	//! Orders the records by resolution levels and determines the number of records at the end of each level
+	void computeLevels(std::vector<int>& viRecordIndices, std::vector<int>& viLevelRecordEnds) const;
+
+	//! Returns the number of file blocks
+	int getNumFileBlocks() const;
+
+	//! Returns the number of records of the regular grid with a number of alpha points (0 if invalid)
+	int getGridSize(int iAlphaPoints) const;
+
+	//! Returns the direction of a record of the regular grid with a number of alpha points and an alpha range end
+	void getGridCoords(int iRecordIndex, int iAlphaPoints, float fAlphaEnd, float& fAlphaDeg, float& fBetaDeg) const;
+
+	//! Returns the alpha points and the alpha range end of the stored records (symmetry)
+	void getStoredAlphaGrid(int& iAlphaPoints, float& fAlphaEnd) const;
+
+	//! Returns the size of the content header [Bytes]
+	size_t getContentHeaderSize() const;
+
+	//! Returns the size of a record channel descriptor [Bytes]
+	size_t getRecordDescSize() const;
+
+	//! Closes and removes the file
+	void abort();
+
+	//! Closes (and thereby removes) the temporary files
+	void closeTempFiles();
+
+	//! Appends the first bytes of a temporary file at the current position
+	bool copyFromFile(FILE* pSource, uint64_t ui64Size);
+
+	//! Writes bytes at the current position and pads them to the next boundary of an alignment [Bytes]
+	bool writeBlock(const void* pData, size_t nBytes, uint64_t& ui64Pos, int iAlignment = 16);
+
+	//! Writes the data of a record channel (compressed and deduplicated, if enabled)
+	/**
+	 * \param [in] pData			Record channel data in the file format
+	 * \param [in] nBytes			Size of the data [Bytes]
+	 * \param [in] iSampleSize		Size of a sample (2, 3 or 4 Bytes)
+	 * \param [out] ui64DataOffset	Offset of the data within the (uncompressed) data block
+	 */
+	bool writeRecordChannelData(const void* pData, size_t nBytes, int iSampleSize, uint64_t& ui64DataOffset);
+
+	//! Appends the statistics of a record channel to the temporary file
+	/**
+	 * \param [in] pData			Record channel data in the file format, before the byte order conversion
+	 * \param [in] iNumValues		Number of stored values
+	 * \param [in] iOffset			Number of omitted leading values (impulse responses)
+	 * \param [in] fScale			Block scale of #DAFF_INT16_BFP data (otherwise 1)
+	 */
+	bool writeStatistics(const void* pData, int iNumValues, int iOffset, float fScale);
+
+	//! Writes the direction index block at the current position
+	/**
+	 * \param [in,out] ui64Pos	Position of the block, advanced behind it (padded) [Bytes]
+	 * \param [out] ui64Size	Size of the block [Bytes]
+	 */
+	bool writeDirectionIndex(uint64_t& ui64Pos, uint64_t& ui64Size);
+
+	//! Computes the checksums of the written file blocks and writes the checksum block
+	/**
+	 * \param [in] vBlocks		File block table (the checksum block is already described)
+	 * \param [in] iBlock		Index of the checksum block in the table
+	 * \param [in] pHeaders		File header and file block table in the file byte order
+	 */
+	bool writeChecksums(const std::vector<DAFFFileBlockEntry>& vBlocks, int iBlock, const char* pHeaders);
+
+	//! Looks up identical stored data (ui64DataOffset: its offset, UINT64_MAX if there is none)
+	bool findPayload(uint64_t ui64Hash, const PayloadEntry& oEntry, const void* pStored, uint64_t& ui64DataOffset);
+
+	//! Appends the compressed chunk in m_vcChunk at the current position
+	/**
+	 * Advances the size of the uncompressed data like writeBlock and appends the chunk to the chunk table.
+	 */
+	bool writeChunk(const PayloadEntry& oEntry);
+
+	// No copy
+	DAFFWriter(const DAFFWriter&);
+	DAFFWriter& operator=(const DAFFWriter&);
+};
+
+#endif  // IW_DAFF_WRITER
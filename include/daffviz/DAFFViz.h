@@ -30,6 +30,9 @@
 // Base class
 #include "DAFFVizSGNode.h"
 
+// Shared geometry
+#include "DAFFVizGeometryCache.h"
+
 // Simple objects
 #include "DAFFVizArrow.h"
 #include "DAFFVizGrid.h"
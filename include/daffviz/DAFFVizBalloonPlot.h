@@ -16,21 +16,70 @@
 
 #include <vtkSmartPointer.h>
 
+#include <vector>
+
 // Forward declarations
 class vtkActor;
+class vtkCellArray;
+class vtkPoints;
 class vtkPolyData;
 class vtkPolyDataMapper;
-class vtkWarpScalar;
 class vtkDoubleArray;
+class vtkFloatArray;
 class vtkVectorText;
 
 class DAFFContent;
 
 namespace DAFFViz {
 
+//! Geometry of a balloon plot
+/**
+ * Builds the grid points, the faces (including the levels of detail) and the cached spectra of a
+ * balloon plot, which is the expensive part of creating a plot (the records are read in parallel).
+ * The geometry does not touch the scene graph or the render pipeline, so it can be built on a
+ * worker thread and then handed to a BalloonPlot on the GUI thread.
+ */
+class DAFF_API BalloonPlotGeometry {
+  public:
+	//! Builds the geometry of a content, caching the spectra of the given channel
+	BalloonPlotGeometry(const DAFFContent* pContent, int iChannel = 0);
+	virtual ~BalloonPlotGeometry();
+
+	//! Returns the content
+	const DAFFContent* GetContent() const;
+
+  private:
+	const DAFFContent* m_pContent;                              //!@ Content
+	int m_iChannel;                                             //!@ Channel of the cached spectra
+	int m_iNumFrequencies;                                      //!@ Number of frequencies
+	float m_fOverallMagnitudeMaximum;                           //!@ Magnitude maximum of the content
+	vtkSmartPointer<vtkPoints> m_pPoints;                       //!@ Grid points (one per record)
+	vtkSmartPointer<vtkDoubleArray> m_pNormals;                 //!@ Flipped normals for warping
+	vtkSmartPointer<vtkCellArray> m_pCells;                     //!@ Faces of the full grid
+	std::vector<vtkSmartPointer<vtkCellArray> > m_vpLODCells;  //!@ Faces of the coarser grids
+	std::vector<float> m_vfMagnitudes;                          //!@ Magnitudes [frequency][record]
+	std::vector<float> m_vfPhases;                              //!@ Phases [frequency][record]
+	std::vector<float> m_vfMagnitudeMaxima;                     //!@ Magnitude maxima per frequency
+
+	friend class BalloonPlot;
+
+	// No copy
+	BalloonPlotGeometry(const BalloonPlotGeometry&);
+	BalloonPlotGeometry& operator=(const BalloonPlotGeometry&);
+};
+
 //! Simple directivity object node
 /**
  * This class derived from the scene graph node class creates a directivity.
+ *
+ * Dense grids (about 2 degrees resolution or finer) also get coarser levels of detail using every
+ * 2nd, 4th and 8th ring and azimuth point. A vtkLODActor switches to them while the view is
+ * interacted with and draws the full grid again once the interaction ends. The frame rate to reach
+ * is the desired update rate of the render window interactor.
+ *
+ * Warping scales the grid points in place by the magnitudes (one shared point set for all levels
+ * of detail), and the scalars are colored by a texture lookup on the GPU. Changing the frequency,
+ * channel or scaling updates these arrays without executing a filter pipeline.
  */
 
 class DAFF_API BalloonPlot : public DAFFViz::SGNode {
@@ -41,6 +90,9 @@ class DAFF_API BalloonPlot : public DAFFViz::SGNode {
 
 	BalloonPlot(SGNode* pParentNode, const DAFFContent* pContent);
 	BalloonPlot(const DAFFContent* pContent);
+
+	//! Creates the plot from a prebuilt geometry, which is taken over (and left empty)
+	BalloonPlot(SGNode* pParentNode, BalloonPlotGeometry& oGeometry);
 	virtual ~BalloonPlot();
 
 	// --= Object related methods =--
@@ -84,7 +136,7 @@ class DAFF_API BalloonPlot : public DAFFViz::SGNode {
 	//! get active channel
 	int GetChannel();
 
-	//! Enable/Disable warping (WARP_DISABLE | WARP_ENABLE)
+	//! Enable/Disable warping of the grid points by the magnitudes
 	// \note default: enabled
 	void EnableWarp();
 	void DisableWarp();
@@ -107,9 +159,11 @@ class DAFF_API BalloonPlot : public DAFFViz::SGNode {
 	//! Update probe nodes
 	void UpdateProbe();
 
+	//! Returns the memory held by the subtree, including the plot geometry and its warped copy [Bytes]
+	size_t GetMemoryFootprint() const;
+
   private:
 	const DAFFContent* m_pContent;
-	vtkSmartPointer<vtkWarpScalar> m_pWarp;
 	vtkSmartPointer<vtkPolyDataMapper> m_pMapper;
 	vtkSmartPointer<vtkActor> m_pPlotActor;
 	vtkSmartPointer<vtkPolyData> m_pPlotPolydata;
@@ -125,14 +179,34 @@ class DAFF_API BalloonPlot : public DAFFViz::SGNode {
 	vtkSmartPointer<vtkVectorText> m_pProbeLabel;
 	vtkSmartPointer<vtkActor> m_pLabel;
 
-	// The initializer generates dynamic objects like source, mapper, actor ...
-	void init();
+	vtkSmartPointer<vtkFloatArray> m_pMagnitudes;  //!@ Scalars of the selected frequency (mapped magnitudes)
+	vtkSmartPointer<vtkFloatArray> m_pPhases;      //!@ Phases of the selected frequency (references the cache)
+	float m_fOverallMagnitudeMaximum;              //!@ Magnitude maximum of the content
+	int m_iCacheChannel;                           //!@ Channel of the cached spectra (-1: none)
+	std::vector<float> m_vfMagnitudes;             //!@ Magnitudes of the cached channel [frequency][record]
+	std::vector<float> m_vfPhases;                 //!@ Phases of the cached channel [frequency][record]
+	std::vector<float> m_vfMagnitudeMaxima;        //!@ Magnitude maxima of the cached channel per frequency
+
+	vtkSmartPointer<vtkPoints> m_pWarpedPoints;                        //!@ Grid points scaled by the magnitudes
+	vtkSmartPointer<vtkPolyData> m_pWarpedPolydata;                    //!@ Plot on the warped points
+	std::vector<vtkSmartPointer<vtkPolyData> > m_vpLODPolydata;        //!@ Coarser grids (every 2nd, 4th, 8th ring)
+	std::vector<vtkSmartPointer<vtkPolyData> > m_vpLODWarpedPolydata;  //!@ Coarser grids on the warped points
+	std::vector<vtkSmartPointer<vtkPolyDataMapper> > m_vpLODMappers;   //!@ Mappers of the coarser grids
+
+	// The initializer takes over the geometry and generates dynamic objects like mapper, actor ...
+	void init(BalloonPlotGeometry& oGeometry);
 
 	// Update scalars (e.g. when selected frequency changed)
 	void SetScalars();
 
-	// Convert orientation (phi, theta) into cartesian coordiates (x,y,z)
-	void sph2cart(double phi, double theta, double& x, double& y, double& z);
+	// Apply the changed settings (scalars and warp are updated once per frame)
+	void OnUpdate();
+
+	// Cache the magnitudes and phases of all frequencies of the selected channel (in parallel)
+	void UpdateCache();
+
+	// Scale the warped points by the current scalars
+	void UpdateWarp();
 
 	// Convert a linear value into decibel
 	float FactorToDecibel(float x) const;
@@ -140,6 +214,7 @@ class DAFF_API BalloonPlot : public DAFFViz::SGNode {
 	// Convert decibel to linear value
 	float DecibelToFactor(float x) const;
 
+	// Magnitude maximum of the selected frequency and channel
 	float getMagnitudeMaximum() const;
 };
 
@@ -18,14 +18,21 @@
 
 // Forward declarations
 class vtkActor;
+class vtkCellArray;
+class vtkFloatArray;
+class vtkPoints;
 class vtkPolyData;
 class vtkPolyDataMapper;
+class vtkRenderer;
 class vtkWarpScalar;
 class vtkVectorText;
 
 class DAFFContentIR;
 
 namespace DAFFViz {
+
+class CarpetPlotGeometry;
+
 //! Simple carpet plot object node
 /**
  * This class derived from the scene graph node class creates a carpet plot visualization.
@@ -39,8 +46,13 @@ class DAFF_API CarpetPlot : public DAFFViz::SGNode {
 
 	enum { MODE_SURFACE = 0, MODE_WIREFRAME, MODE_POINT };
 
+	enum { DEFAULT_TIME_RESOLUTION = 1024 };
+
 	CarpetPlot(SGNode* pParent, const DAFFContentIR* pContentIR);
 	CarpetPlot(const DAFFContentIR* pContentIR);
+
+	//! Creates the plot from a prebuilt geometry, which is taken over (and left empty)
+	CarpetPlot(SGNode* pParent, CarpetPlotGeometry& oGeometry);
 	virtual ~CarpetPlot();
 
 	// --= Object related methods =--
@@ -96,6 +108,32 @@ class DAFF_API CarpetPlot : public DAFFViz::SGNode {
 
 	void GtWarpingEnabled(bool) const;
 
+	//! Returns the time resolution, the number of bins long filters are decimated to (0: no decimation)
+	int GetTimeResolution() const;
+
+	//! Sets the time resolution (e.g. the height of the plot in pixels, 0: no decimation)
+	/**
+	 * Time windows with more than twice as many samples are decimated, each bin is shown by
+	 * the minimum and the maximum of its samples (envelope). The size of the mesh then depends
+	 * on the resolution instead of the filter length.
+	 */
+	void SetTimeResolution(int iNumBins);
+
+	//! Returns the time window, the part of the filters that is shown [samples]
+	void GetTimeWindow(int& iFirstSample, int& iNumSamples) const;
+
+	//! Sets the time window [samples] (number of samples 0: up to the end of the filters)
+	void SetTimeWindow(int iFirstSample, int iNumSamples);
+
+	//! Adapts the time window and the time resolution to the part of the plot visible in a renderer
+	/**
+	 * Restricts the time window to the visible samples and sets the resolution to their extent
+	 * on the screen, so that zooming in re-decimates at a higher resolution.
+	 *
+	 * @return True, if the plot has been rebuilt
+	 */
+	bool UpdateTimeWindow(vtkRenderer* pRenderer);
+
 	//! Set probe angles
 	void SetProbeAngles(double dAlpha, double dBeta);
 
@@ -105,6 +143,9 @@ class DAFF_API CarpetPlot : public DAFFViz::SGNode {
 	//! Update probe nodes
 	void UpdateProbe();
 
+	//! Returns the memory held by the subtree, including the plot geometry and its warped copy [Bytes]
+	size_t GetMemoryFootprint() const;
+
   private:
 	const DAFFContentIR* m_pContentIR;
 	vtkSmartPointer<vtkWarpScalar> m_pWarp;
@@ -116,14 +157,17 @@ class DAFF_API CarpetPlot : public DAFFViz::SGNode {
 	int m_iFixedAngle;
 	float m_dMin, m_dMax;  // linear factors!
 	int m_iChannel;
+	int m_iTimeResolution;
+	int m_iFirstSample, m_iNumSamples;
 	bool m_bWarp;
+	bool m_bMeshDirty;  //!@ Mesh has to be rebuilt on the next update (time window or fixed angle changed)
 	vtkSmartPointer<vtkActor> m_pProbe;
 	vtkSmartPointer<vtkVectorText> m_pProbeLabel;
 	vtkSmartPointer<vtkActor> m_pLabel;
 	float m_dProbeX, m_dProbeY;
 
-	//! Initialize 3D objects
-	void Init();
+	//! Initialize 3D objects (takes over the geometry)
+	void Init(CarpetPlotGeometry& oGeometry);
 
 	// The initializer generates dynamic objects like source, mapper, actor ...
 	void InitCarpetMesh();
@@ -131,6 +175,9 @@ class DAFF_API CarpetPlot : public DAFFViz::SGNode {
 	// Update scalars (e.g. when selected angle changed)
 	void SetScalars();
 
+	// Apply the changed settings (mesh and scalars are updated once per frame)
+	void OnUpdate();
+
 	// Convert a linear value into decibel
 	double factor2decibel(double x) const;
 
@@ -141,6 +188,45 @@ class DAFF_API CarpetPlot : public DAFFViz::SGNode {
 	void updatePlotOffset();
 };
 
+//! Geometry of a carpet plot
+/**
+ * Builds the mesh and the scalars of a carpet plot with the default plot settings (beta fixed,
+ * selected angle 0, whole filters), which is the expensive part of creating a plot (the records
+ * are read in parallel). The geometry does not touch the scene graph or the render pipeline, so it can be
+ * built on a worker thread and then handed to a CarpetPlot on the GUI thread.
+ */
+class DAFF_API CarpetPlotGeometry {
+  public:
+	//! Builds the geometry of an impulse response content
+	/**
+	 * \param pContentIR	Impulse response content
+	 * \param iScaling	Scaling of the plot (CarpetPlot::SCALING_LINEAR | CarpetPlot::SCALING_DECIBEL)
+	 * \param iChannel	Channel of the plot
+	 * \param iTimeResolution	Time resolution of the plot (see CarpetPlot::SetTimeResolution)
+	 */
+	CarpetPlotGeometry(const DAFFContentIR* pContentIR, int iScaling = CarpetPlot::SCALING_LINEAR, int iChannel = 0,
+					   int iTimeResolution = CarpetPlot::DEFAULT_TIME_RESOLUTION);
+	virtual ~CarpetPlotGeometry();
+
+	//! Returns the content
+	const DAFFContentIR* GetContent() const;
+
+  private:
+	const DAFFContentIR* m_pContentIR;          //!@ Content
+	int m_iScaling;                             //!@ Scaling of the scalars
+	int m_iChannel;                             //!@ Channel of the scalars
+	int m_iTimeResolution;                      //!@ Time resolution of the mesh
+	vtkSmartPointer<vtkPoints> m_pPoints;       //!@ Grid points
+	vtkSmartPointer<vtkCellArray> m_pCells;     //!@ Faces
+	vtkSmartPointer<vtkFloatArray> m_pScalars;  //!@ Scalars (normalized filter coefficients)
+
+	friend class CarpetPlot;
+
+	// No copy
+	CarpetPlotGeometry(const CarpetPlotGeometry&);
+	CarpetPlotGeometry& operator=(const CarpetPlotGeometry&);
+};
+
 }  // namespace DAFFViz
 
 #endif  //  IW_DAFF_CARPETPLOT
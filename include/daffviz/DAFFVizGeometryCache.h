@@ -0,0 +1,82 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_GEOMETRYCACHE
+#define IW_DAFF_GEOMETRYCACHE
+
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+#include <string>
+
+// VTK includes
+#include <vtkSmartPointer.h>
+
+// Forward declarations
+class vtkPolyData;
+class vtkPolyDataMapper;
+
+namespace DAFFViz {
+
+//! Shared geometry of the simple objects and coordinate assistants
+/**
+ * The static geometry of the scene, spheres, circles, meridians, grids and label texts, only
+ * depends on a handful of parameters. The cache creates it once per parameter set and hands
+ * out the same vtkPolyData to every node, so that creating a plot, reopening a file or
+ * rebuilding the grid of a coordinate assistant does not regenerate identical meshes.
+ * GetMapper() returns a single mapper per data set, the nodes instance it with their own
+ * actors (position, color and opacity live in the actor).
+ *
+ * The cached data sets are shared and must not be modified. Nodes that change their
+ * parameters (e.g. Sphere::SetRadius) swap the mapper of their actor instead. The cache is
+ * guarded by its own mutex, entries live until Clear() is called (the nodes keep their data
+ * alive by reference counting).
+ */
+class DAFF_API GeometryCache {
+  public:
+	//! Sphere around the origin (see vtkSphereSource)
+	static vtkSmartPointer<vtkPolyData> GetSphere(double dRadius, int iPhiResolution, int iThetaResolution);
+
+	//! Circle around the origin in the XZ plane, one closed polyline of iNumPoints points starting at -Z
+	static vtkSmartPointer<vtkPolyData> GetCircle(double dRadius, int iNumPoints);
+
+	//! Unit meridian polyline from the south to the north pole (iResolution segments) at an azimuth
+	/**
+	 * \param dAzimuthDeg	Azimuth of the meridian [degrees], 0 is +Z, 90 is +X
+	 * \param iResolution	Number of segments
+	 */
+	static vtkSmartPointer<vtkPolyData> GetMeridian(double dAzimuthDeg, int iResolution);
+
+	//! Unit wireframe grid in the XZ plane (1 times 1, see Grid)
+	static vtkSmartPointer<vtkPolyData> GetGrid(int iCellsX, int iCellsZ);
+
+	//! Text geometry (see vtkVectorText)
+	static vtkSmartPointer<vtkPolyData> GetText(const std::string& sText);
+
+	//! Returns the shared mapper of a cached data set (created on first use)
+	static vtkSmartPointer<vtkPolyDataMapper> GetMapper(vtkPolyData* pData);
+
+	//! Releases all entries (data still used by nodes stays alive until the nodes are deleted)
+	static void Clear();
+
+	//! Returns the number of cached data sets
+	static int GetNumEntries();
+
+	//! Returns the memory of the cached data sets [Bytes]
+	static size_t GetMemoryFootprint();
+
+  private:
+	GeometryCache();
+};
+
+}  // namespace DAFFViz
+
+#endif  //  IW_DAFF_GEOMETRYCACHE
@@ -20,13 +20,13 @@ class vtkActor;
 class vtkCamera;
 class vtkFollower;
 class vtkPolyDataMapper;
-class vtkVectorText;
 
 namespace DAFFViz {
 
 //! Simple arrow object node
 /**
  * This class derived from the scene graph node class creates a text label from VTK.
+ * The text geometry is shared with all labels of the same text (see GeometryCache).
  */
 
 class DAFF_API Label : public DAFFViz::SGNode {
@@ -67,7 +67,6 @@ class DAFF_API Label : public DAFFViz::SGNode {
 	std::string GetText() const;
 
   private:
-	vtkSmartPointer<vtkVectorText> m_pLabelText;
 	vtkSmartPointer<vtkPolyDataMapper> m_pMapper;
 	vtkSmartPointer<vtkFollower> m_pFollower;
 	vtkSmartPointer<vtkActor> m_pActor;
@@ -24,6 +24,7 @@
 class vtkActor;
 class vtkAssembly;
 class vtkCamera;
+class vtkMatrix4x4;
 class QtDAFFVizTestWindow;
 class QDAFFVTKWidget;
 
@@ -62,6 +63,11 @@ namespace DAFFViz {
  * to your scene graph root or any subtree. At the very end you will apply the scene graph
  * root to your DAFFViz::QtDAFFWidget which will render your own scene and display it in your Qt application.
  *
+ * Nodes with expensive property changes (e.g. recomputing plot scalars) only mark themselves dirty
+ * in their setters. The display calls Update() on the root once per frame before rendering, which
+ * applies the pending changes of all dirty nodes in one traversal, so that many property changes
+ * during one event cost one pipeline update and one render.
+ *
  */
 
 class DAFF_API SGNode {
@@ -187,6 +193,15 @@ class DAFF_API SGNode {
 	 */
 	bool RemoveChildNodes(const std::vector<DAFFViz::SGNode*>& vpChildren);
 
+	//! Returns the memory held by the subtree
+	/**
+	 * Sums up the memory of the node and its child nodes. Nodes with large geometry
+	 * (e.g. plots) add the size of their VTK data objects.
+	 *
+	 * @return Memory footprint [Bytes]
+	 */
+	virtual size_t GetMemoryFootprint() const;
+
 
 	// --= Modificators =--
 
@@ -329,6 +344,21 @@ class DAFF_API SGNode {
 	 */
 	virtual bool IsVisible() const;
 
+	//! Applies the pending changes of the subtree
+	/**
+	 * Traverses the dirty parts of the subtree and applies the pending changes of the
+	 * dirty nodes (see OnUpdate()). Call this on the root once per frame before rendering.
+	 *
+	 * @see IsDirty()
+	 */
+	void Update();
+
+	//! Returns true if the node or a node in its subtree has pending changes
+	/**
+	 * @return True, if an Update() is required before rendering
+	 */
+	bool IsDirty() const;
+
   protected:
 	// --= Modificators for subclasses =--
 
@@ -364,8 +394,25 @@ class DAFF_API SGNode {
 	 */
 	void RemoveAssembly(vtkSmartPointer<vtkAssembly> pAssembly);
 
+	//! Returns the transformation from node coordinates into world coordinates
+	/**
+	 * Concatenates the transformations (position, orientation, scale) of the node and all its parents.
+	 *
+	 * @param [out] pMatrix Transformation matrix
+	 */
+	void GetWorldMatrix(vtkMatrix4x4* pMatrix) const;
+
+	//! Marks the node as dirty, its pending changes are applied by the next Update() of the tree
+	void SetDirty();
+
 	// --= Event handlers =--
 
+	//! Apply the pending changes of the node
+	/**
+	 * Called by Update() for dirty nodes, the default implementation does nothing.
+	 */
+	virtual void OnUpdate();
+
 	//! Set active camera for followers
 	/**
 	 *
@@ -377,6 +424,8 @@ class DAFF_API SGNode {
 	DAFFViz::SGNode* m_pParentNode;                //!@ Parent scene graph node (NULL => root node)
 	std::vector<DAFFViz::SGNode*> m_vpChildNodes;  //!@ Scene graph child nodes list
 	vtkSmartPointer<vtkAssembly> m_pNodeAssembly;  //!@ Internal VTK assembly of the node
+	bool m_bDirty;                                 //!@ Node has pending changes
+	bool m_bSubtreeDirty;                          //!@ Node or a node in its subtree has pending changes
 
 	bool _debug;  //!@ Debug switch for internal use only
 
@@ -16,7 +16,6 @@
 
 // Forward declaration
 class vtkActor;
-class vtkSphereSource;
 class vtkPolyDataMapper;
 
 namespace DAFFViz {
@@ -24,6 +23,7 @@ namespace DAFFViz {
 //! Simple sphere object node
 /**
  * This class derived from the scene graph node class creates a sphere from VTK.
+ * The mesh is shared with all spheres of the same radius and resolution (see GeometryCache).
  */
 
 class DAFF_API Sphere : public DAFFViz::SGNode {
@@ -66,12 +66,18 @@ class DAFF_API Sphere : public DAFFViz::SGNode {
 	bool IsVisible() const;
 
   private:
-	vtkSmartPointer<vtkSphereSource> m_pSource;
 	vtkSmartPointer<vtkPolyDataMapper> m_pMapper;
 	vtkSmartPointer<vtkActor> m_pActor;
 
+	double m_dRadius;
+	int m_iPhiResolution;
+	int m_iThetaResolution;
+
 	// The initializer generates dynamic objects like source, mapper, actor ...
 	void init();
+
+	// Assigns the shared mesh of the current radius and resolution to the actor
+	void UpdateGeometry();
 };
 
 }  // namespace DAFFViz
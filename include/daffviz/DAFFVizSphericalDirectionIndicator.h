@@ -65,6 +65,9 @@ class DAFF_API SphericalDirectionIndicator : public DAFFViz::SGNode {
 	//! The initializer generates dynamic objects like source, mapper, actor ...
 	void Init();
 	void UpdateOrientation();
+
+	//! Applies the changed direction (once per frame)
+	void OnUpdate();
 };
 
 }  // namespace DAFFViz
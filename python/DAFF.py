@@ -3,7 +3,11 @@ import sys
 import numpy as np
 
 sys.path.append("../bindings/python/dist/Lib/site-packages")
-import daffCppInterface
+try:
+    import daffCppInterface
+except ImportError:
+    daffCppInterface = None
+import DAFFMemmap
 from DAFFProperties import (
     DAFFPropertiesDFTSpectrum,
     DAFFPropertiesIR,
@@ -13,50 +17,73 @@ from DAFFProperties import (
 
 # The class for the OpenDAFF objects
 class DAFF:
-    # Initialize DAFF object
-    def __init__(self, filepath):
-        self._index = daffCppInterface.open(filepath)
+    # Initialize DAFF object (backend "cpp", "numpy" or None: the compiled module if available)
+    def __init__(self, filepath, backend=None):
+        if backend is None:
+            backend = "numpy" if daffCppInterface is None else "cpp"
+        if backend == "cpp":
+            if daffCppInterface is None:
+                raise ImportError("The compiled module daffCppInterface is missing")
+            self._reader = daffCppInterface.open(filepath)
+        elif backend == "numpy":
+            self._reader = DAFFMemmap.open(filepath)
+        else:
+            raise ValueError("Unknown backend " + str(backend))
         self.view = 1
-        self.__contentType = daffCppInterface.content_type(self._index)
-        self.__contentTypeString = daffCppInterface.content_type_str(self._index)
+        self.__contentType = self._reader.content_type()
+        self.__contentTypeString = self._reader.content_type_str()
 
-        self.__properties = daffCppInterface.properties(self._index)
-        self.__metadata = daffCppInterface.metadata(self._index)
+        self.__properties = self._reader.properties()
+        self.__metadata = self._reader.metadata()
 
         if self.__contentType == 0:  # contentType == DAFF_IMPULSE_RESPONSE
-            self.__properties = DAFFPropertiesIR(self._index)
+            self.__properties = DAFFPropertiesIR(self._reader)
         elif self.__contentType == 4:  # contentType == DAFF_DFT_SPECTRUM
-            self.__properties = DAFFPropertiesDFTSpectrum(self._index)
+            self.__properties = DAFFPropertiesDFTSpectrum(self._reader)
         else:
-            self.__properties = DAFFPropertiesSpectrum(self._index)
+            self.__properties = DAFFPropertiesSpectrum(self._reader)
 
     # Get the nearest neighbour of the current position
     def GetNearestNeighbour(self, angle1, angle2):
-        return daffCppInterface.nearest_neighbour_index(
-            self._index, self.view, angle1, angle2
-        )
+        return self._reader.nearest_neighbour_index(self.view, angle1, angle2)
 
     # Get the index of the nearest neighbour of the current position
     def GetNearestNeighbourIndex(self, angle1, angle2):
-        return daffCppInterface.nearest_neighbour_index(
-            self._index, self.view, angle1, angle2
-        )[0]
+        return self._reader.nearest_neighbour_index(self.view, angle1, angle2)[0]
 
     # Check if the nearest neighbour is out of bounds
     def IsNearestNeighbourOutOfBounds(self, angle1, angle2):
-        return daffCppInterface.nearest_neighbour_index(
-            self._index, self.view, angle1, angle2
-        )[1]
+        return self._reader.nearest_neighbour_index(self.view, angle1, angle2)[1]
 
     # Get the records of the nearest neighbour of the current position
     def GetNearestNeighbourRecord(self, angle1, angle2):
-        return daffCppInterface.nearest_neighbour_record(
-            self._index, self.view, angle1, angle2
-        )
+        return self._reader.nearest_neighbour_record(self.view, angle1, angle2)
 
     # Get the records of the nearest neighbour of the current position
     def GetRecord(self, index):
-        return daffCppInterface.record(self._index, index)
+        return self._reader.record(index)
+
+    # Get the indices of the nearest neighbours of many positions (arrays of indices and out of bounds flags)
+    def GetNearestNeighbourIndices(self, angles1, angles2):
+        return self._reader.nearest_neighbour_indices(self.view, angles1, angles2)
+
+    # Get the records of many indices as one array [records, channels, values]
+    def GetRecords(self, indices):
+        return self._reader.records(indices)
+
+    # Get all records [records, channels, values] and their directions [records, 2] (data view, object view)
+    def GetAllRecords(self):
+        return self._reader.to_array()
+
+    # Close the file (also done at the end of a with block and when the object is deleted)
+    def Close(self):
+        self._reader.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.Close()
 
     # Get the content type
     @property
@@ -0,0 +1,806 @@
+# Pure-Python reader of DAFF files (version 1.7) backed by numpy.memmap
+#
+# The headers are parsed with structured dtypes that mirror the packed structs of
+# src/DAFFHeader.h (see FILEFORMAT.md). The record descriptors are a structured view
+# of the memory-mapped file and the record data is read from the mapped data block on
+# access, so that opening is instant regardless of the file size. The reader offers the
+# methods of the compiled daffCppInterface reader and can be used by the DAFF class
+# without the compiled module (DAFF(filepath, backend="numpy")).
+#
+# Not supported: compressed data blocks (DAFFWriter::setCompression). The optional
+# statistics, direction index, level and checksum blocks are ignored.
+
+import struct
+
+import numpy as np
+
+# Content types (DAFF_CONTENT_TYPES)
+DAFF_IMPULSE_RESPONSE = 0
+DAFF_MAGNITUDE_SPECTRUM = 1
+DAFF_PHASE_SPECTRUM = 2
+DAFF_MAGNITUDE_PHASE_SPECTRUM = 3
+DAFF_DFT_SPECTRUM = 4
+
+# Quantizations (DAFF_QUANTIZATIONS)
+DAFF_INT16 = 0
+DAFF_INT24 = 1
+DAFF_FLOAT32 = 2
+DAFF_FLOAT16 = 3
+DAFF_BFLOAT16 = 4
+DAFF_INT16_BFP = 5
+
+# Views (DAFF_VIEWS)
+DAFF_DATA_VIEW = 0
+DAFF_OBJECT_VIEW = 1
+
+# Symmetries (DAFF_SYMMETRIES)
+DAFF_SYMMETRY_AXIAL = 1
+DAFF_SYMMETRY_MIRROR = 2
+
+# File block IDs
+FILEBLOCK_DAFF1_MAIN_HEADER_ID = 0x0001
+FILEBLOCK_DAFF1_CONTENT_HEADER_ID = 0x0002
+FILEBLOCK_DAFF1_RECORD_DESC_ID = 0x0003
+FILEBLOCK_DAFF1_DATA_ID = 0x0004
+FILEBLOCK_DAFF1_METADATA_ID = 0x0005
+FILEBLOCK_DAFF1_RECORD_DIRECTIONS_ID = 0x0007
+FILEBLOCK_DAFF1_COMPRESSED_DATA_ID = 0x0008
+FILEBLOCK_DAFF1_SYMMETRY_ID = 0x0009
+
+# Supported file format version (1.7)
+DAFF_FILE_FORMAT_VERSION = 170
+
+# Packed little-endian structs of the file format (DAFFHeader.h)
+DAFFFileHeader = np.dtype(
+    [("Signature", "S2"), ("FileFormatVersion", "<i4"), ("NumFileBlocks", "<i4")]
+)
+
+DAFFFileBlockEntry = np.dtype([("ID", "<i4"), ("Offset", "<u8"), ("Size", "<u8")])
+
+DAFFMainHeader = np.dtype(
+    [
+        ("ContentType", "<i4"),
+        ("Quantization", "<i4"),
+        ("NumChannels", "<i4"),
+        ("NumRecords", "<i4"),
+        ("ElementsPerRecord", "<i4"),
+        ("MetadataIndex", "<i4"),
+        ("AlphaPoints", "<i4"),
+        ("AlphaStart", "<f4"),
+        ("AlphaEnd", "<f4"),
+        ("BetaPoints", "<i4"),
+        ("BetaStart", "<f4"),
+        ("BetaEnd", "<f4"),
+        ("OrientYaw", "<f4"),
+        ("OrientPitch", "<f4"),
+        ("OrientRoll", "<f4"),
+    ]
+)
+
+DAFFContentHeaderIR = np.dtype(
+    [
+        ("Samplerate", "<f4"),
+        ("MinFilterOffset", "<i4"),
+        ("MaxEffectiveFilterLength", "<i4"),
+    ]
+)
+
+# MS and MPS (the support frequencies follow at byte 8)
+DAFFContentHeaderMS = np.dtype([("Max", "<f4"), ("NumFreqs", "<i4")])
+
+# PS (the support frequencies follow at byte 8 as well)
+DAFFContentHeaderPS = np.dtype([("NumFreqs", "<i4")])
+
+DAFFContentHeaderDFT = np.dtype(
+    [
+        ("NumDFTCoeffs", "<i4"),
+        ("TransformSize", "<i4"),
+        ("Samplerate", "<f4"),
+        ("Max", "<f4"),
+    ]
+)
+
+DAFFRecordChannelDescDefault = np.dtype(
+    [("MetadataIndex", "<i4"), ("DataOffset", "<u8")]
+)
+
+DAFFRecordChannelDescIR = np.dtype(
+    [
+        ("MetadataIndex", "<i4"),
+        ("DataOffset", "<u8"),
+        ("LeadingZeros", "<i4"),
+        ("ElementLength", "<i4"),
+    ]
+)
+
+# Descriptor of block floating point impulse responses (a sample of 32767 equals the scale)
+DAFFRecordChannelDescIRBFP = np.dtype(
+    [
+        ("MetadataIndex", "<i4"),
+        ("DataOffset", "<u8"),
+        ("LeadingZeros", "<i4"),
+        ("ElementLength", "<i4"),
+        ("Scale", "<f4"),
+    ]
+)
+
+DAFFRecordDirectionEntry = np.dtype([("Alpha", "<f4"), ("Beta", "<f4")])
+
+DAFFSymmetryHeader = np.dtype([("Symmetry", "<i4"), ("AlphaPoints", "<i4")])
+
+# Stored dtype and size of the samples of a quantization
+_SAMPLE_DTYPES = {
+    DAFF_INT16: np.dtype("<i2"),
+    DAFF_INT24: np.dtype("u1"),
+    DAFF_FLOAT32: np.dtype("<f4"),
+    DAFF_FLOAT16: np.dtype("<f2"),
+    DAFF_BFLOAT16: np.dtype("<u2"),
+    DAFF_INT16_BFP: np.dtype("<i2"),
+}
+_SAMPLE_SIZES = {
+    DAFF_INT16: 2,
+    DAFF_INT24: 3,
+    DAFF_FLOAT32: 4,
+    DAFF_FLOAT16: 2,
+    DAFF_BFLOAT16: 2,
+    DAFF_INT16_BFP: 2,
+}
+
+_CONTENT_TYPE_STRINGS = {
+    DAFF_IMPULSE_RESPONSE: "Impulse response",
+    DAFF_MAGNITUDE_SPECTRUM: "Magnitude spectrum",
+    DAFF_PHASE_SPECTRUM: "Phase spectrum",
+    DAFF_MAGNITUDE_PHASE_SPECTRUM: "Magnitude-phase spectrum",
+    DAFF_DFT_SPECTRUM: "Discrete Fourier-spectrum",
+}
+
+_CONTENT_TYPE_SHORT_STRINGS = {
+    DAFF_IMPULSE_RESPONSE: "ir",
+    DAFF_MAGNITUDE_SPECTRUM: "ms",
+    DAFF_PHASE_SPECTRUM: "ps",
+    DAFF_MAGNITUDE_PHASE_SPECTRUM: "mps",
+    DAFF_DFT_SPECTRUM: "dft",
+}
+
+_QUANTIZATION_STRINGS = {
+    DAFF_INT16: "int16",
+    DAFF_INT24: "int24",
+    DAFF_FLOAT32: "float32",
+    DAFF_FLOAT16: "float16",
+    DAFF_BFLOAT16: "bfloat16",
+    DAFF_INT16_BFP: "int16_bfp",
+}
+
+# Number of directions whose nearest neighbours on irregular grids are searched at once
+_DIRECTION_BLOCK_SIZE = 1024
+
+
+# Parses the metadata sets of the metadata block (list of dictionaries, upper case keys)
+def parse_metadata(buf):
+    buf = bytes(buf)
+    sets = []
+    pos = 0
+    while pos < len(buf):
+        if len(buf) - pos < 4:
+            raise ValueError("Corrupted metadata block")
+        (num_keys,) = struct.unpack_from("<i", buf, pos)
+        pos += 4
+        if num_keys < 0:
+            raise ValueError("Corrupted metadata block")
+
+        keys = {}
+        for _ in range(num_keys):
+            (key_type,) = struct.unpack_from("<i", buf, pos)
+            pos += 4
+            name, pos = _read_string(buf, pos)
+
+            # A later key replaces an earlier one with the same name
+            if key_type in (0, 1):  # DAFF_BOOL, DAFF_INT
+                (value,) = struct.unpack_from("<i", buf, pos)
+                pos += 4
+                keys[name.upper()] = bool(value) if key_type == 0 else value
+            elif key_type == 2:  # DAFF_FLOAT
+                (value,) = struct.unpack_from("<d", buf, pos)
+                pos += 8
+                keys[name.upper()] = value
+            elif key_type == 3:  # DAFF_STRING
+                value, pos = _read_string(buf, pos)
+                keys[name.upper()] = value
+            else:
+                raise ValueError("Unknown metadata type %d" % key_type)
+
+        sets.append(keys)
+    return sets
+
+
+# Reads a null-terminated string, returns it and the position behind it
+def _read_string(buf, pos):
+    end = buf.find(b"\0", pos)
+    if end < 0:
+        raise ValueError("Corrupted metadata block")
+    return buf[pos:end].decode("latin-1"), end + 1
+
+
+# Rotation constants of a yaw-pitch-roll orientation (DAFFSCTransform::RotationConstants)
+def _rotation_constants(yaw, pitch, roll):
+    y, p, r = np.radians([yaw, pitch, roll])
+    sy, cy = np.sin(y), np.cos(y)
+    sp, cp = np.sin(p), np.cos(p)
+    sr, cr = np.sin(r), np.cos(r)
+    return (
+        cy * cr - sy * sp * sr,
+        cy * sr + sy * sp * cr,
+        sy * cp,
+        -sy * cr - cy * sp * sr,
+        -sy * sr + cy * sp * cr,
+        cy * cp,
+        cp * sr,
+        cp * cr,
+        sp,
+    )
+
+
+# Transforms object view directions (azimuth, elevation) into data view directions (alpha, beta)
+def transform_osc2dsc(t, azimuth, elevation):
+    ai = np.radians(np.asarray(azimuth, dtype=np.float64))
+    ei = np.radians(np.asarray(elevation, dtype=np.float64))
+    sa_ce = np.sin(ai) * np.cos(ei)
+    ca_ce = np.cos(ai) * np.cos(ei)
+    se = np.sin(ei)
+    ao = np.arctan2(
+        t[0] * sa_ce - t[1] * se + t[2] * ca_ce, t[3] * sa_ce - t[4] * se + t[5] * ca_ce
+    )
+    eo = np.arcsin(np.clip(t[6] * sa_ce + t[7] * se + t[8] * ca_ce, -1.0, 1.0))
+    return np.degrees(ao), np.degrees(eo) + 90.0
+
+
+# Transforms data view directions (alpha, beta) into object view directions (azimuth, elevation)
+def transform_dsc2osc(t, alpha, beta):
+    ai = np.radians(np.asarray(alpha, dtype=np.float64))
+    ei = np.radians(np.asarray(beta, dtype=np.float64) - 90.0)
+    sa_ce = np.sin(ai) * np.cos(ei)
+    ca_ce = np.cos(ai) * np.cos(ei)
+    se = np.sin(ei)
+    ao = np.arctan2(
+        t[0] * sa_ce + t[6] * se + t[3] * ca_ce, t[2] * sa_ce + t[8] * se + t[5] * ca_ce
+    )
+    eo = -np.arcsin(np.clip(t[1] * sa_ce - t[7] * se + t[4] * ca_ce, -1.0, 1.0))
+    return np.degrees(ao), np.degrees(eo)
+
+
+# Normalizes data view directions (DAFFUtils::NormalizeDirection)
+def normalize_dsc(alpha, beta):
+    alpha = np.asarray(alpha, dtype=np.float32)
+    beta = np.fmod(np.asarray(beta, dtype=np.float32), np.float32(360))
+    over = beta > 180
+    alpha = np.where(over, alpha + np.float32(180), alpha)
+    beta = np.where(over, beta - np.float32(180), beta)
+    alpha = np.fmod(alpha, np.float32(360))
+    alpha = np.where(alpha < 0, alpha + np.float32(360), alpha)
+    pole = (np.abs(beta) <= 1e-5) | (np.abs(beta - 180) <= 1e-5)
+    alpha = np.where(pole, np.float32(0), alpha)
+    alpha = np.round(alpha * np.float32(1000)) / np.float32(1000)
+    beta = np.round(beta * np.float32(1000)) / np.float32(1000)
+    return alpha.astype(np.float32), beta.astype(np.float32)
+
+
+# Smallest absolute difference of two angles [degrees] on the circle
+def _angle_mindiff(a, b):
+    d = np.abs(np.fmod(np.asarray(a, dtype=np.float32) - b, np.float32(360)))
+    return np.minimum(d, 360 - d)
+
+
+# The reader of a DAFF file
+class DAFFMemmapReader:
+    # Open a file (the file stays mapped until closed)
+    def __init__(self, filepath):
+        self._filepath = filepath
+        self._map = np.memmap(filepath, dtype=np.uint8, mode="r")
+        try:
+            self._load()
+        except Exception:
+            self.close()
+            raise
+
+    # Returns a structured view of the file at an offset
+    def _struct(self, dtype, offset, count=1):
+        if offset + dtype.itemsize * count > self._map.size:
+            raise ValueError("File corrupted (truncated)")
+        return np.frombuffer(self._map, dtype=dtype, count=count, offset=offset)
+
+    # Returns the file block entries of an ID
+    def _blocks(self, block_id):
+        return self.file_blocks[self.file_blocks["ID"] == block_id]
+
+    # Returns the single file block of an ID (None if missing)
+    def _block(self, block_id, required=False):
+        blocks = self._blocks(block_id)
+        if len(blocks) > 1 or (required and len(blocks) == 0):
+            raise ValueError("File corrupted (block 0x%04X)" % block_id)
+        return blocks[0] if len(blocks) == 1 else None
+
+    def _load(self):
+        header = self._struct(DAFFFileHeader, 0)[0]
+        if header["Signature"] != b"FW":
+            raise ValueError("Not a DAFF file")
+        if header["FileFormatVersion"] != DAFF_FILE_FORMAT_VERSION:
+            raise ValueError(
+                "File format version %d unsupported" % header["FileFormatVersion"]
+            )
+        if header["NumFileBlocks"] <= 0:
+            raise ValueError("File corrupted (no file blocks)")
+
+        self.file_format_version = int(header["FileFormatVersion"])
+        self.file_blocks = self._struct(
+            DAFFFileBlockEntry, DAFFFileHeader.itemsize, int(header["NumFileBlocks"])
+        )
+
+        # Main header (a copy, the symmetry expands the grid)
+        block = self._block(FILEBLOCK_DAFF1_MAIN_HEADER_ID, True)
+        self.main_header = self._struct(DAFFMainHeader, int(block["Offset"])).copy()[0]
+        mh = self.main_header
+        if mh["ContentType"] not in _CONTENT_TYPE_STRINGS:
+            raise ValueError("Unknown content type %d" % mh["ContentType"])
+        if mh["Quantization"] not in _SAMPLE_SIZES:
+            raise ValueError("Unknown quantization %d" % mh["Quantization"])
+        if mh["NumChannels"] < 1 or mh["NumRecords"] < 1 or mh["ElementsPerRecord"] < 1:
+            raise ValueError("Invalid main header")
+
+        self._content_type = int(mh["ContentType"])
+        self._quantization = int(mh["Quantization"])
+        self._num_channels = int(mh["NumChannels"])
+
+        self._load_content_header()
+
+        # Record descriptors [records, channels]
+        is_ir = self._content_type == DAFF_IMPULSE_RESPONSE
+        desc_dtype = DAFFRecordChannelDescIR if is_ir else DAFFRecordChannelDescDefault
+        if is_ir and self._quantization == DAFF_INT16_BFP:
+            desc_dtype = DAFFRecordChannelDescIRBFP
+        block = self._block(FILEBLOCK_DAFF1_RECORD_DESC_ID, True)
+        num_descs = int(mh["NumRecords"]) * self._num_channels
+        if int(block["Size"]) < num_descs * desc_dtype.itemsize:
+            raise ValueError("File corrupted (record descriptors)")
+        self.descriptors = self._struct(
+            desc_dtype, int(block["Offset"]), num_descs
+        ).reshape(int(mh["NumRecords"]), self._num_channels)
+
+        # Data block, mapped as bytes
+        block = self._block(FILEBLOCK_DAFF1_DATA_ID)
+        if block is None:
+            if len(self._blocks(FILEBLOCK_DAFF1_COMPRESSED_DATA_ID)) > 0:
+                raise NotImplementedError(
+                    "Compressed DAFF files are not supported, use the compiled module"
+                )
+            raise ValueError("File corrupted (no data block)")
+        offset, size = int(block["Offset"]), int(block["Size"])
+        if offset + size > self._map.size:
+            raise ValueError("File corrupted (truncated data block)")
+        self.data = self._map[offset : offset + size]
+
+        # Metadata sets
+        block = self._block(FILEBLOCK_DAFF1_METADATA_ID)
+        self.metadata_sets = []
+        if block is not None and int(block["Size"]) > 0:
+            offset, size = int(block["Offset"]), int(block["Size"])
+            self.metadata_sets = parse_metadata(self._map[offset : offset + size])
+
+        # Record directions of irregular grids
+        block = self._block(FILEBLOCK_DAFF1_RECORD_DIRECTIONS_ID)
+        self.directions = None
+        if block is not None:
+            self.directions = self._struct(
+                DAFFRecordDirectionEntry, int(block["Offset"]), int(mh["NumRecords"])
+            )
+
+        # Symmetric grids are expanded to the full grid (descriptors only)
+        self.symmetry = 0
+        block = self._block(FILEBLOCK_DAFF1_SYMMETRY_ID)
+        if block is not None:
+            header = self._struct(DAFFSymmetryHeader, int(block["Offset"]))[0]
+            self._expand_symmetry(header)
+
+        self._init_grid()
+        self.set_orientation(mh["OrientYaw"], mh["OrientPitch"], mh["OrientRoll"])
+
+    def _load_content_header(self):
+        block = self._block(FILEBLOCK_DAFF1_CONTENT_HEADER_ID, True)
+        offset = int(block["Offset"])
+        self._frequencies = None
+
+        if self._content_type == DAFF_IMPULSE_RESPONSE:
+            self.content_header = self._struct(DAFFContentHeaderIR, offset)[0]
+            self._num_values = int(self.main_header["ElementsPerRecord"])
+        elif self._content_type == DAFF_DFT_SPECTRUM:
+            self.content_header = self._struct(DAFFContentHeaderDFT, offset)[0]
+            n = int(self.content_header["NumDFTCoeffs"])
+            size = int(self.content_header["TransformSize"])
+            if n != size and n != size // 2 + 1:
+                raise ValueError("Invalid content header")
+            self._num_values = n
+        else:
+            dtype = (
+                DAFFContentHeaderPS
+                if self._content_type == DAFF_PHASE_SPECTRUM
+                else DAFFContentHeaderMS
+            )
+            self.content_header = self._struct(dtype, offset)[0]
+            n = int(self.content_header["NumFreqs"])
+            if n <= 0:
+                raise ValueError("Invalid content header")
+            self._frequencies = self._struct(np.dtype("<f4"), offset + 8, n)
+            self._num_values = n
+
+    def _expand_symmetry(self, header):
+        mh = self.main_header
+        symmetry = int(header["Symmetry"])
+        alpha_points = int(header["AlphaPoints"])
+        stored_alpha_points = int(mh["AlphaPoints"])
+        if self.directions is not None or mh["AlphaStart"] != 0 or alpha_points < 1:
+            raise ValueError("File corrupted (symmetry)")
+        if symmetry == DAFF_SYMMETRY_AXIAL:
+            valid = stored_alpha_points == 1 and mh["AlphaEnd"] == 0
+        elif symmetry == DAFF_SYMMETRY_MIRROR:
+            valid = (
+                alpha_points >= 2
+                and alpha_points % 2 == 0
+                and stored_alpha_points == alpha_points // 2 + 1
+                and mh["AlphaEnd"] == 180
+            )
+        else:
+            valid = False
+        if not valid:
+            raise ValueError("File corrupted (symmetry)")
+
+        # Source record and channel order of every record of the full grid
+        south_pole = mh["BetaStart"] == 0
+        north_pole = mh["BetaEnd"] == 180
+        beta_points = int(mh["BetaPoints"])
+        channels = np.arange(self._num_channels)
+        sources, channel_orders = [], []
+        stored = 0
+        for b in range(beta_points):
+            pole = (south_pole and b == 0) or (north_pole and b == beta_points - 1)
+            for a in range(1 if pole else alpha_points):
+                stored_alpha, mirrored = 0, False
+                if not pole and symmetry == DAFF_SYMMETRY_MIRROR:
+                    mirrored = a > alpha_points // 2
+                    stored_alpha = alpha_points - a if mirrored else a
+                sources.append(stored + stored_alpha)
+                channel_orders.append(channels[::-1] if mirrored else channels)
+            stored += 1 if pole else stored_alpha_points
+
+        if stored != mh["NumRecords"]:
+            raise ValueError("File corrupted (symmetry)")
+
+        # Mirrored records refer to the data of the stored ones in reverse channel order
+        sources = np.array(sources)
+        expanded = self.descriptors[sources[:, None], np.array(channel_orders)]
+        expanded["MetadataIndex"] = self.descriptors["MetadataIndex"][sources, :1]
+        self.descriptors = expanded
+
+        self.symmetry = symmetry
+        mh["NumRecords"] = len(sources)
+        mh["AlphaPoints"] = alpha_points
+        mh["AlphaEnd"] = 360
+
+    def _init_grid(self):
+        mh = self.main_header
+        start, end = float(mh["AlphaStart"]), float(mh["AlphaEnd"])
+        alpha_span = end - start if end > start else 360 - start + end
+        beta_span = float(mh["BetaEnd"] - mh["BetaStart"])
+
+        self._alpha_resolution = 0.0
+        if mh["AlphaPoints"] > 1:
+            divisor = mh["AlphaPoints"] if alpha_span == 360 else mh["AlphaPoints"] - 1
+            self._alpha_resolution = alpha_span / divisor
+        self._beta_resolution = 0.0
+        if mh["BetaPoints"] > 1:
+            self._beta_resolution = beta_span / (mh["BetaPoints"] - 1)
+
+        # Data view directions of all records [records, 2]
+        num_records = int(mh["NumRecords"])
+        if self.directions is not None:
+            self._coords = np.stack(
+                [self.directions["Alpha"], self.directions["Beta"]], axis=1
+            ).astype(np.float32)
+            return
+
+        index = np.arange(num_records)
+        alpha_points = int(mh["AlphaPoints"])
+        if mh["BetaStart"] == 0:  # Single record at the south pole
+            alpha_index = np.where(index == 0, 0, (index - 1) % alpha_points)
+            beta_index = np.where(index == 0, 0, 1 + (index - 1) // alpha_points)
+            beta = beta_index * np.float32(self._beta_resolution)
+        else:
+            alpha_index = index % alpha_points
+            beta_index = index // alpha_points
+            beta = mh["BetaStart"] + beta_index * np.float32(self._beta_resolution)
+        alpha = mh["AlphaStart"] + alpha_index * np.float32(self._alpha_resolution)
+        self._coords = np.stack([alpha, beta], axis=1).astype(np.float32)
+        if mh["BetaStart"] == 0:
+            self._coords[0] = 0
+
+    # Sets the orientation of the object view [degrees]
+    def set_orientation(self, yaw, pitch, roll):
+        self._orientation = (float(yaw), float(pitch), float(roll))
+        self._rotation = _rotation_constants(yaw, pitch, roll)
+
+    # Returns the record index of grid indices (DAFFReaderImpl::getGridRecordIndex)
+    def _grid_record_index(self, alpha_index, beta_index):
+        mh = self.main_header
+        alpha_points = int(mh["AlphaPoints"])
+        north = (beta_index == mh["BetaPoints"] - 1) & (mh["BetaEnd"] == 180)
+        if mh["BetaStart"] == 0:  # Single record at the south pole
+            index = 1 + (beta_index - 1) * alpha_points
+            index = index + np.where(north, 0, alpha_index)
+            return np.where(beta_index == 0, 0, index)
+        return beta_index * alpha_points + np.where(north, 0, alpha_index)
+
+    # Nearest neighbours of normalized data view directions (record indices, out of bounds)
+    def _nearest_dsc(self, alpha, beta):
+        if self.directions is not None:
+            return self._nearest_irregular(alpha, beta)
+
+        mh = self.main_header
+        start, end = np.float32(mh["AlphaStart"]), np.float32(mh["AlphaEnd"])
+        out_of_bounds = np.zeros(alpha.shape, dtype=bool)
+
+        if mh["AlphaPoints"] == 1:
+            alpha_index = np.zeros(alpha.shape, dtype=np.int64)
+            out_of_bounds |= ~((alpha == start) & (alpha == np.fmod(end, 360)))
+        else:
+            inside = (alpha >= start) & (alpha <= end)
+            index = np.round((alpha - start) / np.float32(self._alpha_resolution))
+            index = index.astype(np.int64)
+            full = start == 0 and end == 360
+            wrap = 0 if full else int(mh["AlphaPoints"]) - 1
+            index = np.where(index >= mh["AlphaPoints"], wrap, index)
+            closer_start = _angle_mindiff(start, alpha) <= _angle_mindiff(end, alpha)
+            outside_index = np.where(closer_start, 0, int(mh["AlphaPoints"]) - 1)
+            alpha_index = np.where(inside, index, outside_index)
+            out_of_bounds |= ~inside
+
+        start, end = np.float32(mh["BetaStart"]), np.float32(mh["BetaEnd"])
+        if mh["BetaPoints"] == 1:
+            beta_index = np.zeros(beta.shape, dtype=np.int64)
+            out_of_bounds |= ~((beta == start) & (beta == end))
+        else:
+            inside = (beta >= start) & (beta <= end)
+            index = np.round((beta - start) / np.float32(self._beta_resolution))
+            closer_start = np.abs(start - beta) <= np.abs(end - beta)
+            outside_index = np.where(closer_start, 0, int(mh["BetaPoints"]) - 1)
+            beta_index = np.where(inside, index.astype(np.int64), outside_index)
+            out_of_bounds |= ~inside
+
+        return self._grid_record_index(alpha_index, beta_index), out_of_bounds
+
+    # Nearest neighbours on irregular grids (smallest great-circle distance)
+    def _nearest_irregular(self, alpha, beta):
+        records = _unit_vectors(self._coords[:, 0], self._coords[:, 1])
+        queries = _unit_vectors(alpha, beta)
+        indices = np.empty(len(queries), dtype=np.int64)
+        for i in range(0, len(queries), _DIRECTION_BLOCK_SIZE):
+            block = queries[i : i + _DIRECTION_BLOCK_SIZE]
+            indices[i : i + len(block)] = np.argmax(block @ records.T, axis=1)
+        return indices, np.zeros(len(queries), dtype=bool)
+
+    # Nearest neighbours of directions of a view (record indices, out of bounds)
+    def _nearest(self, view, angles1, angles2):
+        angles1 = np.atleast_1d(np.asarray(angles1, dtype=np.float32))
+        angles2 = np.atleast_1d(np.asarray(angles2, dtype=np.float32))
+        if angles1.shape != angles2.shape:
+            raise ValueError("Angle arrays differ in size")
+        if view == DAFF_OBJECT_VIEW:
+            angles1, angles2 = transform_osc2dsc(self._rotation, angles1, angles2)
+        elif view != DAFF_DATA_VIEW:
+            raise ValueError("Invalid view")
+        alpha, beta = normalize_dsc(angles1, angles2)
+        indices, out_of_bounds = self._nearest_dsc(alpha.ravel(), beta.ravel())
+        return indices.astype(np.int32), out_of_bounds
+
+    def _check_record_index(self, index):
+        if index < 0 or index >= self.main_header["NumRecords"]:
+            raise IndexError("Invalid record index")
+
+    # Returns the stored samples of record channels as float32 (flat arrays of descriptors)
+    def _decode(self, offsets, num_samples):
+        size = _SAMPLE_SIZES[self._quantization]
+        if np.any(offsets + num_samples * size > self.data.size):
+            raise ValueError("File corrupted (record data out of bounds)")
+        byte_index = offsets[:, None] + np.arange(num_samples * size, dtype=np.uint64)
+        raw = self.data[byte_index.astype(np.int64)]
+
+        if self._quantization == DAFF_INT24:
+            raw = raw.reshape(len(offsets), num_samples, 3).astype(np.int32)
+            values = raw[..., 0] | (raw[..., 1] << 8) | (raw[..., 2] << 16)
+            values = np.where(values >= 1 << 23, values - (1 << 24), values)
+            return values.astype(np.float32) / np.float32(8388607)
+
+        values = raw.view(_SAMPLE_DTYPES[self._quantization])
+        if self._quantization in (DAFF_INT16, DAFF_INT16_BFP):
+            return values.astype(np.float32) / np.float32(32767)
+        if self._quantization == DAFF_BFLOAT16:
+            return (values.astype(np.uint32) << 16).view(np.float32)
+        return values.astype(np.float32)
+
+    # Returns the data of record channels as arrays [n, values] (complex64 for MPS and DFT)
+    def _record_channels(self, descs):
+        descs = descs.ravel()
+        offsets = descs["DataOffset"].astype(np.uint64)
+
+        if self._content_type == DAFF_IMPULSE_RESPONSE:
+            # Leading zeros and effective lengths differ among the record channels
+            length = self._num_values
+            lengths = descs["ElementLength"].astype(np.int64)
+            leading = descs["LeadingZeros"].astype(np.int64)
+            if np.any(lengths < 0) or np.any(leading + lengths > length):
+                raise ValueError("File corrupted (record descriptors)")
+            result = np.zeros((len(descs), length), dtype=np.float32)
+            for n in np.unique(lengths[lengths > 0]):
+                rows = np.nonzero(lengths == n)[0]
+                values = self._decode(offsets[rows], int(n))
+                if self._quantization == DAFF_INT16_BFP:
+                    values *= descs["Scale"][rows, None]
+                columns = leading[rows, None] + np.arange(n)
+                result[rows[:, None], columns] = values
+            return result
+
+        if self._content_type in (DAFF_MAGNITUDE_PHASE_SPECTRUM, DAFF_DFT_SPECTRUM):
+            values = self._decode(offsets, 2 * self._num_values)
+            return values.view(np.complex64)
+        return self._decode(offsets, self._num_values)
+
+    # --= Methods of the compiled reader =--
+
+    # Closes the file (views of the data keep the mapping alive)
+    def close(self):
+        self._map = None
+        self.data = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+        return False
+
+    def content_type(self):
+        return self._content_type
+
+    def content_type_str(self):
+        return _CONTENT_TYPE_STRINGS[self._content_type]
+
+    # Returns the global metadata (dictionary)
+    def metadata(self):
+        return dict(self.metadata_sets[0]) if self.metadata_sets else {}
+
+    # Returns the properties (dictionary with the keys of the compiled reader)
+    def properties(self):
+        mh = self.main_header
+        labels = []
+        for c in range(self._num_channels):
+            label = self.metadata().get("LABEL_CHANNEL_%d" % (c + 1))
+            if isinstance(label, str) and label:
+                labels.append(label)
+
+        default_orientation = {
+            "YawAngle": float(mh["OrientYaw"]),
+            "PitchAngle": float(mh["OrientPitch"]),
+            "RollAngle": float(mh["OrientRoll"]),
+        }
+        yaw, pitch, roll = self._orientation
+        full_alpha = mh["AlphaStart"] == 0 and mh["AlphaEnd"] == 360
+        full_beta = mh["BetaStart"] == 0 and mh["BetaEnd"] == 180
+        props = {
+            "Filename": self._filepath,
+            "FileFormatVersion": self.file_format_version,
+            "ContentType": _CONTENT_TYPE_SHORT_STRINGS[self._content_type],
+            "Quantization": _QUANTIZATION_STRINGS[self._quantization],
+            "NumChannels": self._num_channels,
+            "NumRecords": int(mh["NumRecords"]),
+            "ChannelLabels": labels,
+            "AlphaPoints": int(mh["AlphaPoints"]),
+            "AlphaResolution": self._alpha_resolution,
+            "AlphaRange": [float(mh["AlphaStart"]), float(mh["AlphaEnd"])],
+            "BetaPoints": int(mh["BetaPoints"]),
+            "BetaResolution": self._beta_resolution,
+            "BetaRange": [float(mh["BetaStart"]), float(mh["BetaEnd"])],
+            "Orientation": {"YawAngle": yaw, "PitchAngle": pitch, "RollAngle": roll},
+            "OrientationDefault": default_orientation,
+            "FullSphere": bool(full_alpha and full_beta),
+            "RegularGrid": self.directions is None,
+        }
+
+        ch = self.content_header
+        if self._content_type == DAFF_IMPULSE_RESPONSE:
+            props["Samplerate"] = float(ch["Samplerate"])
+            props["FilterLength"] = self._num_values
+        elif self._content_type == DAFF_DFT_SPECTRUM:
+            props["TransformSize"] = int(ch["TransformSize"])
+            props["NumDFTCoeffs"] = int(ch["NumDFTCoeffs"])
+            props["IsSymmetric"] = bool(ch["NumDFTCoeffs"] != ch["TransformSize"])
+            props["Samplerate"] = float(ch["Samplerate"])
+            props["FrequencyBandwidth"] = float(ch["Samplerate"]) / int(
+                ch["TransformSize"]
+            )
+        else:
+            props["NumFreqs"] = self._num_values
+            props["Frequencies"] = [float(f) for f in self._frequencies]
+        return props
+
+    # Returns the nearest neighbour of a direction as [record index, out of bounds]
+    def nearest_neighbour_index(self, view, angle1, angle2):
+        indices, out_of_bounds = self._nearest(view, angle1, angle2)
+        return [int(indices[0]), bool(out_of_bounds[0])]
+
+    # Returns the record of the nearest neighbour of a direction [channels, values]
+    def nearest_neighbour_record(self, view, angle1, angle2):
+        return self.record(self.nearest_neighbour_index(view, angle1, angle2)[0])
+
+    # Returns the nearest neighbours of many directions (int32 record indices, bool out of bounds)
+    def nearest_neighbour_indices(self, view, angles1, angles2, threads=0):
+        return self._nearest(view, angles1, angles2)
+
+    # Returns a record [channels, values]
+    def record(self, recordIndex):
+        self._check_record_index(recordIndex)
+        return self._record_channels(self.descriptors[recordIndex])
+
+    # Returns many records [records, channels, values]
+    def records(self, recordIndices, threads=0):
+        indices = np.asarray(recordIndices, dtype=np.int64).ravel()
+        if np.any(indices < 0) or np.any(indices >= self.main_header["NumRecords"]):
+            raise IndexError("Invalid record index")
+        data = self._record_channels(self.descriptors[indices])
+        return data.reshape(len(indices), self._num_channels, -1)
+
+    # Returns all records [records, channels, values] and their directions [records, 2] (data view, object view)
+    def to_array(self, threads=0):
+        data = self.records(np.arange(self.main_header["NumRecords"]))
+        azimuth, elevation = transform_dsc2osc(
+            self._rotation, self._coords[:, 0], self._coords[:, 1]
+        )
+        object_coords = np.stack([azimuth, elevation], axis=1).astype(np.float32)
+        return data, self._coords.copy(), object_coords
+
+    # --= Zero-copy access =--
+
+    # Returns the stored data of a record channel as a read-only view of the mapped file
+    # (float32 quantization only, complex64 for MPS and DFT). Impulse responses are
+    # returned without their leading and trailing zeros (see the LeadingZeros field).
+    def record_channel_view(self, recordIndex, channel):
+        self._check_record_index(recordIndex)
+        if channel < 0 or channel >= self._num_channels:
+            raise IndexError("Invalid channel index")
+        if self._quantization != DAFF_FLOAT32:
+            raise ValueError("Views are available for float32 quantization only")
+
+        desc = self.descriptors[recordIndex, channel]
+        if self._content_type == DAFF_IMPULSE_RESPONSE:
+            count, dtype = int(desc["ElementLength"]), np.dtype("<f4")
+        elif self._content_type in (DAFF_MAGNITUDE_PHASE_SPECTRUM, DAFF_DFT_SPECTRUM):
+            count, dtype = self._num_values, np.dtype("<c8")
+        else:
+            count, dtype = self._num_values, np.dtype("<f4")
+
+        offset = int(desc["DataOffset"])
+        if offset + count * dtype.itemsize > self.data.size:
+            raise ValueError("File corrupted (record data out of bounds)")
+        return np.frombuffer(self.data, dtype=dtype, count=count, offset=offset)
+
+    # Returns the data view directions of all records [records, 2]
+    def record_coords(self):
+        return self._coords.copy()
+
+
+# Returns the unit vectors of data view directions [n, 3] (x = sin(b) cos(a), y = sin(b) sin(a), z = -cos(b))
+def _unit_vectors(alpha, beta):
+    a = np.radians(np.asarray(alpha, dtype=np.float64))
+    b = np.radians(np.asarray(beta, dtype=np.float64))
+    return np.stack([np.sin(b) * np.cos(a), np.sin(b) * np.sin(a), -np.cos(b)], axis=1)
+
+
+# Opens a DAFF file (like daffCppInterface.open)
+def open(filepath):
+    return DAFFMemmapReader(filepath)
@@ -0,0 +1,142 @@
+# Compares the pure NumPy reader (DAFFMemmap.py) with the compiled module
+# daffCppInterface: records, directions, nearest neighbours, metadata and
+# properties of every file of a directory.
+#
+# Usage: python DAFFMemmapTest.py [directory]
+#
+# The default directory holds the binding test files (../bindings/c/testdata, written by
+# tests/tryout/TestDataWriter): every content type in every quantization it supports.
+# The test is skipped if NumPy or the compiled module is missing.
+
+import glob
+import os
+import sys
+import unittest
+
+sys.path.append("../bindings/python/dist/Lib/site-packages")
+try:
+    import numpy as np
+
+    import daffCppInterface
+    import DAFFMemmap
+except ImportError as error:
+    np = None
+    _import_error = str(error)
+
+_TESTDATA_DIR = os.path.join(
+    os.path.dirname(os.path.abspath(__file__)), "..", "bindings", "c", "testdata"
+)
+_testdata_dir = _TESTDATA_DIR
+
+
+def setUpModule():
+    if np is None:
+        raise unittest.SkipTest(_import_error)
+
+
+# Compares values of the property dictionaries (floats as float32 and double)
+def _assert_equal(test, expected, actual, key):
+    if isinstance(expected, dict):
+        test.assertEqual(sorted(expected.keys()), sorted(actual.keys()), key)
+        for k in expected:
+            _assert_equal(test, expected[k], actual[k], key + "." + k)
+    elif isinstance(expected, (list, tuple)):
+        test.assertEqual(len(expected), len(actual), key)
+        for i, (e, a) in enumerate(zip(expected, actual)):
+            _assert_equal(test, e, a, "%s[%d]" % (key, i))
+    elif isinstance(expected, float) and not isinstance(actual, bool):
+        test.assertTrue(np.isclose(expected, actual, rtol=1e-6, atol=1e-5), key)
+    else:
+        test.assertEqual(expected, actual, key)
+
+
+class DAFFMemmapTest(unittest.TestCase):
+    def setUp(self):
+        self.files = sorted(glob.glob(os.path.join(_testdata_dir, "*.daff")))
+        self.assertTrue(self.files, "No DAFF files in " + _testdata_dir)
+
+    # Runs a check for every file with both readers
+    def _for_all_files(self, check):
+        for filepath in self.files:
+            with self.subTest(file=os.path.basename(filepath)):
+                with daffCppInterface.open(filepath) as cpp, DAFFMemmap.open(
+                    filepath
+                ) as numpy_reader:
+                    check(cpp, numpy_reader)
+
+    def test_content_type(self):
+        def check(cpp, numpy_reader):
+            self.assertEqual(cpp.content_type(), numpy_reader.content_type())
+            self.assertEqual(cpp.content_type_str(), numpy_reader.content_type_str())
+
+        self._for_all_files(check)
+
+    def test_metadata(self):
+        def check(cpp, numpy_reader):
+            _assert_equal(self, cpp.metadata(), numpy_reader.metadata(), "metadata")
+
+        self._for_all_files(check)
+
+    def test_properties(self):
+        def check(cpp, numpy_reader):
+            _assert_equal(
+                self, cpp.properties(), numpy_reader.properties(), "properties"
+            )
+
+        self._for_all_files(check)
+
+    def test_records(self):
+        def check(cpp, numpy_reader):
+            data, coords, object_coords = cpp.to_array()
+            numpy_data, numpy_coords, numpy_object_coords = numpy_reader.to_array()
+            self.assertEqual(data.shape, numpy_data.shape)
+            self.assertEqual(data.dtype, numpy_data.dtype)
+            np.testing.assert_allclose(numpy_data, data, rtol=0, atol=1e-6)
+            np.testing.assert_allclose(numpy_coords, coords, rtol=0, atol=1e-4)
+            np.testing.assert_allclose(
+                numpy_object_coords, object_coords, rtol=0, atol=1e-4
+            )
+
+            num_records = data.shape[0]
+            for i in range(num_records):
+                np.testing.assert_allclose(
+                    numpy_reader.record(i), cpp.record(i), rtol=0, atol=1e-6
+                )
+
+            indices = [num_records - 1, 0, num_records // 2, 0]
+            np.testing.assert_allclose(
+                numpy_reader.records(indices), cpp.records(indices), rtol=0, atol=1e-6
+            )
+            self.assertRaises(IndexError, numpy_reader.record, num_records)
+            self.assertRaises(IndexError, cpp.record, num_records)
+
+        self._for_all_files(check)
+
+    def test_nearest_neighbours(self):
+        random = np.random.RandomState(1)
+        angles1 = random.uniform(-180, 360, 500).astype(np.float32)
+        angles2 = random.uniform(-90, 180, 500).astype(np.float32)
+
+        def check(cpp, numpy_reader):
+            for view in (DAFFMemmap.DAFF_DATA_VIEW, DAFFMemmap.DAFF_OBJECT_VIEW):
+                a2 = angles2 if view == DAFFMemmap.DAFF_DATA_VIEW else angles2 - 90
+                indices, out_of_bounds = cpp.nearest_neighbour_indices(
+                    view, angles1, a2
+                )
+                numpy_indices, numpy_out_of_bounds = (
+                    numpy_reader.nearest_neighbour_indices(view, angles1, a2)
+                )
+                np.testing.assert_array_equal(numpy_indices, indices)
+                np.testing.assert_array_equal(numpy_out_of_bounds, out_of_bounds)
+                self.assertEqual(
+                    numpy_reader.nearest_neighbour_index(view, 10.5, 20.5),
+                    cpp.nearest_neighbour_index(view, 10.5, 20.5),
+                )
+
+        self._for_all_files(check)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) > 1 and not sys.argv[1].startswith("-"):
+        _testdata_dir = sys.argv.pop(1)
+    unittest.main()
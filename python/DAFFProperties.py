@@ -1,17 +1,13 @@
-import sys
-
 import numpy as np
 
-sys.path.append("../bindings/python/dist/Lib/site-packages")
-import daffCppInterface
 from DAFFOrientation import DAFFOrientation
 
 
 # The DAFFProperties class contains the properties of the "Property" property
 class DAFFProperties:
     # Initialize DAFF-Metadata object
-    def __init__(self, index):
-        self._propertyDict = daffCppInterface.properties(index)
+    def __init__(self, reader):
+        self._propertyDict = reader.properties()
         self.__alphaPoints = self._propertyDict["AlphaPoints"]
         self.__alphaRange = self._propertyDict["AlphaRange"]
         self.__alphaResolution = self._propertyDict["AlphaResolution"]
@@ -122,8 +118,8 @@ class DAFFProperties:
 
 # Properties of the Content Type DAFF_IMPULSE_RESPONSE
 class DAFFPropertiesIR(DAFFProperties):
-    def __init__(self, index):
-        DAFFProperties.__init__(self, index)
+    def __init__(self, reader):
+        DAFFProperties.__init__(self, reader)
         self.__samplerate = self._propertyDict["Samplerate"]
         self.__filterLength = self._propertyDict["FilterLength"]
 
@@ -140,8 +136,8 @@ class DAFFPropertiesIR(DAFFProperties):
 
 # Properties of the Content Types DAFF_MAGNITUDE_SPECTRUM, DAFF_PHASE_SPECTRUM & DAFF_MAGNITUDE_PHASE_SPECTRUM
 class DAFFPropertiesSpectrum(DAFFProperties):
-    def __init__(self, index):
-        DAFFProperties.__init__(self, index)
+    def __init__(self, reader):
+        DAFFProperties.__init__(self, reader)
         self.__numFreqs = self._propertyDict["NumFreqs"]
         self.__frequencies = self._propertyDict["Frequencies"]
 
@@ -158,8 +154,8 @@ class DAFFPropertiesSpectrum(DAFFProperties):
 
 # Properties of the Content Type DAFF_DFT_SPECTRUM
 class DAFFPropertiesDFTSpectrum(DAFFProperties):
-    def __init__(self, index):
-        DAFFProperties.__init__(self, index)
+    def __init__(self, reader):
+        DAFFProperties.__init__(self, reader)
         self.__transformSize = self._propertyDict["TransformSize"]
         self.__numDFTCoeffs = self._propertyDict["NumDFTCoeffs"]
         self.__isSymmetric = self._propertyDict["IsSymmetric"]
@@ -0,0 +1,235 @@
+#include <DAFFAsyncFetcher.h>
+
+#include <DAFFContent.h>
+#include <DAFFContentDFT.h>
+#include <DAFFContentIR.h>
+#include <DAFFContentMS.h>
+#include <DAFFContentPS.h>
+#include <DAFFProperties.h>
+
+#include <algorithm>
+#include <cassert>
+#include <system_error>
+#include <utility>
+
+//! Minimum number of I/O threads of the automatic thread count
+static const int DAFF_FETCHER_MIN_THREADS = 4;
+
+DAFFAsyncFetcher::DAFFAsyncFetcher(const DAFFContent* pContent, DAFFFetchExecutor* pExecutor, int iNumThreads)
+	: m_pContent(pContent), m_pContentIR(NULL), m_pContentMS(NULL), m_pContentPS(NULL), m_pContentDFT(NULL),
+	  m_pExecutor(pExecutor), m_iNumChannels(0), m_iDataLength(0), m_iNumPending(0), m_bStopped(false)
+{
+	assert(pContent != NULL);
+
+	switch (pContent->getProperties()->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		m_pContentIR = dynamic_cast<const DAFFContentIR*>(pContent);
+		if (m_pContentIR)
+			m_iDataLength = m_pContentIR->getFilterLength();
+		break;
+	case DAFF_MAGNITUDE_SPECTRUM:
+		m_pContentMS = dynamic_cast<const DAFFContentMS*>(pContent);
+		if (m_pContentMS)
+			m_iDataLength = m_pContentMS->getNumFrequencies();
+		break;
+	case DAFF_PHASE_SPECTRUM:
+		m_pContentPS = dynamic_cast<const DAFFContentPS*>(pContent);
+		if (m_pContentPS)
+			m_iDataLength = m_pContentPS->getNumFrequencies();
+		break;
+	case DAFF_DFT_SPECTRUM:
+		m_pContentDFT = dynamic_cast<const DAFFContentDFT*>(pContent);
+		if (m_pContentDFT)
+			m_iDataLength = 2 * m_pContentDFT->getNumDFTCoeffs();
+		break;
+	}
+	m_iNumChannels = pContent->getProperties()->getNumberOfChannels();
+
+	if (iNumThreads <= 0)
+		iNumThreads = std::max((int)std::thread::hardware_concurrency(), DAFF_FETCHER_MIN_THREADS);
+
+	try {
+		for (int i = 0; i < iNumThreads; i++)
+			m_vThreads.push_back(std::thread(&DAFFAsyncFetcher::run, this));
+	} catch (const std::system_error&) {
+		// Not enough threads available, fetch with the ones started (or in the caller)
+	}
+}
+
+DAFFAsyncFetcher::~DAFFAsyncFetcher()
+{
+	cancelAll();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mxQueue);
+		m_bStopped = true;
+	}
+	m_cvQueue.notify_all();
+
+	for (size_t i = 0; i < m_vThreads.size(); i++)
+		m_vThreads[i].join();
+}
+
+const DAFFContent* DAFFAsyncFetcher::getContent() const
+{
+	return m_pContent;
+}
+
+DAFFFetchExecutor* DAFFAsyncFetcher::getExecutor() const
+{
+	return m_pExecutor;
+}
+
+int DAFFAsyncFetcher::getNumThreads() const
+{
+	return (int)m_vThreads.size();
+}
+
+int DAFFAsyncFetcher::getNumChannels() const
+{
+	return m_iNumChannels;
+}
+
+int DAFFAsyncFetcher::getDataLength() const
+{
+	return m_iDataLength;
+}
+
+int DAFFAsyncFetcher::fetchRecord(int iRecordIndex, float** ppfChannelDest, DAFFFetchCallback* pCallback)
+{
+	assert(ppfChannelDest != NULL);
+	assert(pCallback != NULL);
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pContent->getProperties()->getNumberOfRecords()))
+		return DAFF_INVALID_INDEX;
+
+	Request oRequest;
+	oRequest.piRecordIndices[0] = iRecordIndex;
+	oRequest.iNumRecords = 1;
+	oRequest.vpfDest.assign(ppfChannelDest, ppfChannelDest + m_iNumChannels);
+	oRequest.pCallback = pCallback;
+	return submit(oRequest);
+}
+
+int DAFFAsyncFetcher::fetchCell(int iView, float fAngle1Deg, float fAngle2Deg, DAFFQuad& qIndices,
+								float** ppfCellDest, DAFFFetchCallback* pCallback)
+{
+	assert(ppfCellDest != NULL);
+	assert(pCallback != NULL);
+
+	// Determining the cell does not touch the record data
+	m_pContent->getCell(iView, fAngle1Deg, fAngle2Deg, qIndices);
+
+	Request oRequest;
+	oRequest.piRecordIndices[0] = qIndices.iIndex1;
+	oRequest.piRecordIndices[1] = qIndices.iIndex2;
+	oRequest.piRecordIndices[2] = qIndices.iIndex3;
+	oRequest.piRecordIndices[3] = qIndices.iIndex4;
+	oRequest.iNumRecords = 4;
+	oRequest.vpfDest.assign(ppfCellDest, ppfCellDest + 4 * m_iNumChannels);
+	oRequest.pCallback = pCallback;
+	return submit(oRequest);
+}
+
+int DAFFAsyncFetcher::getNumPending() const
+{
+	std::lock_guard<std::mutex> lock(m_mxQueue);
+	return m_iNumPending;
+}
+
+void DAFFAsyncFetcher::cancelAll()
+{
+	std::deque<Request> dCancelled;
+	{
+		std::lock_guard<std::mutex> lock(m_mxQueue);
+		dCancelled.swap(m_dRequests);
+	}
+
+	// Completions run outside of the lock, they may queue new fetches
+	for (size_t i = 0; i < dCancelled.size(); i++)
+		complete(dCancelled[i], DAFF_FETCH_CANCELLED);
+}
+
+void DAFFAsyncFetcher::waitForAll() const
+{
+	std::unique_lock<std::mutex> lock(m_mxQueue);
+	while (m_iNumPending > 0)
+		m_cvIdle.wait(lock);
+}
+
+int DAFFAsyncFetcher::submit(Request& oRequest)
+{
+	if (!m_pContentIR && !m_pContentMS && !m_pContentPS && !m_pContentDFT)
+		return DAFF_MODAL_ERROR;
+
+	if (m_vThreads.empty()) {
+		// No I/O threads, the caller fetches
+		{
+			std::lock_guard<std::mutex> lock(m_mxQueue);
+			m_iNumPending++;
+		}
+		complete(oRequest, fetch(oRequest));
+		return DAFF_NO_ERROR;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mxQueue);
+		m_iNumPending++;
+		m_dRequests.push_back(std::move(oRequest));
+	}
+	m_cvQueue.notify_one();
+	return DAFF_NO_ERROR;
+}
+
+int DAFFAsyncFetcher::fetch(Request& oRequest) const
+{
+	int iError = DAFF_NO_ERROR;
+	for (int i = 0; (i < oRequest.iNumRecords) && (iError == DAFF_NO_ERROR); i++) {
+		int iRecordIndex = oRequest.piRecordIndices[i];
+		float** ppfDest = &oRequest.vpfDest[(size_t)i * m_iNumChannels];
+		if (m_pContentIR)
+			iError = m_pContentIR->getRecord(iRecordIndex, ppfDest);
+		else if (m_pContentMS)
+			iError = m_pContentMS->getRecord(iRecordIndex, ppfDest);
+		else if (m_pContentPS)
+			iError = m_pContentPS->getRecord(iRecordIndex, ppfDest);
+		else
+			iError = m_pContentDFT->getRecord(iRecordIndex, ppfDest);
+	}
+	return iError;
+}
+
+void DAFFAsyncFetcher::complete(const Request& oRequest, int iErrorCode)
+{
+	if (m_pExecutor)
+		m_pExecutor->post(oRequest.pCallback, iErrorCode);
+	else
+		oRequest.pCallback->onFetchFinished(iErrorCode);
+
+	bool bIdle;
+	{
+		std::lock_guard<std::mutex> lock(m_mxQueue);
+		bIdle = (--m_iNumPending == 0);
+	}
+	if (bIdle)
+		m_cvIdle.notify_all();
+}
+
+void DAFFAsyncFetcher::run()
+{
+	for (;;) {
+		Request oRequest;
+		{
+			std::unique_lock<std::mutex> lock(m_mxQueue);
+			while (!m_bStopped && m_dRequests.empty())
+				m_cvQueue.wait(lock);
+			if (m_dRequests.empty())
+				return;
+
+			oRequest = std::move(m_dRequests.front());
+			m_dRequests.pop_front();
+		}
+
+		complete(oRequest, fetch(oRequest));
+	}
+}
@@ -0,0 +1,253 @@
+#include <DAFFCUDA.h>
+
+#include <DAFFGPUTable.h>
+#include <DAFFSCTransform.h>
+
+#include <cuda_runtime.h>
+
+// Threads per block of the direction kernels
+static const int BLOCK_SIZE = 256;
+
+// Threads per direction of the interpolation kernel (one block per direction)
+static const int VALUE_BLOCK_SIZE = 128;
+
+static __global__ void nearestNeighboursKernel(DAFFGPUContent c, int iView, const float* pfAngles1,
+											   const float* pfAngles2, int* piRecordIndices, bool* pbOutOfBounds,
+											   size_t n)
+{
+	size_t i = (size_t)blockIdx.x * blockDim.x + threadIdx.x;
+	if (i >= n)
+		return;
+
+	bool bOutOfBounds;
+	piRecordIndices[i] = DAFFGPU::getNearestNeighbour(c.oGrid, iView, pfAngles1[i], pfAngles2[i], bOutOfBounds);
+	if (pbOutOfBounds)
+		pbOutOfBounds[i] = bOutOfBounds;
+}
+
+static __global__ void cellsKernel(DAFFGPUContent c, int iView, const float* pfAngles1, const float* pfAngles2,
+								   int* piIndices, size_t n)
+{
+	size_t i = (size_t)blockIdx.x * blockDim.x + threadIdx.x;
+	if (i >= n)
+		return;
+
+	DAFFGPU::getCell(c.oGrid, iView, pfAngles1[i], pfAngles2[i], piIndices + 4 * i);
+}
+
+static __global__ void weightsKernel(DAFFGPUContent c, int iView, const float* pfAngles1, const float* pfAngles2,
+									 int* piIndices, float* pfWeights, size_t n)
+{
+	size_t i = (size_t)blockIdx.x * blockDim.x + threadIdx.x;
+	if (i >= n)
+		return;
+
+	DAFFGPU::getWeights(c.oGrid, iView, pfAngles1[i], pfAngles2[i], piIndices + 4 * i, pfWeights + 4 * i);
+}
+
+static __global__ void interpolateKernel(DAFFGPUContent c, int iView, const float* pfAngles1, const float* pfAngles2,
+										 int iChannel, float* pfDest, size_t n)
+{
+	// One block per direction, the threads read consecutive values of the records (coalesced)
+	__shared__ int piIndices[4];
+	__shared__ float pfWeights[4];
+
+	size_t i = blockIdx.x;
+	if (threadIdx.x == 0)
+		DAFFGPU::getWeights(c.oGrid, iView, pfAngles1[i], pfAngles2[i], piIndices, pfWeights);
+	__syncthreads();
+
+	float* pfValues = pfDest + i * c.iNumValues;
+	for (int k = threadIdx.x; k < c.iNumValues; k += blockDim.x)
+		pfValues[k] = DAFFGPU::interpolateValue(c, piIndices, pfWeights, iChannel, k);
+}
+
+static __global__ void bandValuesKernel(DAFFGPUContent c, int iView, const float* pfAngles1, const float* pfAngles2,
+										int iChannel, int iValue, bool bInterpolate, float* pfDest, size_t n)
+{
+	size_t i = (size_t)blockIdx.x * blockDim.x + threadIdx.x;
+	if (i >= n)
+		return;
+
+	if (bInterpolate) {
+		int piIndices[4];
+		float pfWeights[4];
+		DAFFGPU::getWeights(c.oGrid, iView, pfAngles1[i], pfAngles2[i], piIndices, pfWeights);
+		pfDest[i] = DAFFGPU::interpolateValue(c, piIndices, pfWeights, iChannel, iValue);
+	} else {
+		bool bOutOfBounds;
+		int iRecordIndex = DAFFGPU::getNearestNeighbour(c.oGrid, iView, pfAngles1[i], pfAngles2[i], bOutOfBounds);
+		pfDest[i] = DAFFGPU::getValue(c, iRecordIndex, iChannel, iValue);
+	}
+}
+
+//! Returns the number of blocks for n directions
+static unsigned int getNumBlocks(size_t n)
+{
+	return (unsigned int)((n + BLOCK_SIZE - 1) / BLOCK_SIZE);
+}
+
+//! Checks the preconditions of a batch lookup
+static int checkLookup(const float* pfDeviceData, int iView)
+{
+	if (!pfDeviceData || ((iView != DAFF_DATA_VIEW) && (iView != DAFF_OBJECT_VIEW)))
+		return DAFF_MODAL_ERROR;
+	return DAFF_NO_ERROR;
+}
+
+//! Maps the result of a kernel launch to an error code
+static int getLaunchError()
+{
+	return (cudaGetLastError() == cudaSuccess ? DAFF_NO_ERROR : DAFF_DEVICE_ERROR);
+}
+
+DAFFCUDAContent::DAFFCUDAContent() : m_pfDeviceData(NULL), m_nDeviceBytes(0)
+{
+	memset(&m_oContent, 0, sizeof(m_oContent));
+}
+
+DAFFCUDAContent::~DAFFCUDAContent()
+{
+	release();
+}
+
+int DAFFCUDAContent::upload(const DAFFContent* pContent)
+{
+	DAFFGPUTable oTable;
+	int iError = oTable.load(pContent);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	return upload(&oTable);
+}
+
+int DAFFCUDAContent::upload(const DAFFGPUTable* pTable)
+{
+	release();
+
+	if ((pTable == NULL) || !pTable->isLoaded())
+		return DAFF_MODAL_ERROR;
+
+	size_t nBytes = pTable->getDataSize();
+	void* pData = NULL;
+	if (cudaMalloc(&pData, nBytes) != cudaSuccess)
+		return DAFF_DEVICE_ERROR;
+
+	if (cudaMemcpy(pData, pTable->getData(), nBytes, cudaMemcpyHostToDevice) != cudaSuccess) {
+		cudaFree(pData);
+		return DAFF_DEVICE_ERROR;
+	}
+
+	m_pfDeviceData = (float*)pData;
+	m_nDeviceBytes = nBytes;
+	m_oContent = pTable->getContent(m_pfDeviceData);
+
+	return DAFF_NO_ERROR;
+}
+
+void DAFFCUDAContent::release()
+{
+	if (m_pfDeviceData)
+		cudaFree(m_pfDeviceData);
+
+	m_pfDeviceData = NULL;
+	m_nDeviceBytes = 0;
+	memset(&m_oContent, 0, sizeof(m_oContent));
+}
+
+bool DAFFCUDAContent::isUploaded() const
+{
+	return (m_pfDeviceData != NULL);
+}
+
+void DAFFCUDAContent::setOrientation(const DAFFOrientationYPR& o)
+{
+	// The grid is passed to the kernels by value
+	DAFFSCTransform oTrans(o);
+	oTrans.getRotationConstants(m_oContent.oGrid.pdRotation);
+}
+
+const DAFFGPUContent& DAFFCUDAContent::getDeviceContent() const
+{
+	return m_oContent;
+}
+
+size_t DAFFCUDAContent::getDeviceMemoryUsage() const
+{
+	return m_nDeviceBytes;
+}
+
+int DAFFCUDAContent::getNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2,
+										  int* piRecordIndices, bool* pbOutOfBounds, size_t n, void* pStream) const
+{
+	int iError = checkLookup(m_pfDeviceData, iView);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+	if (n == 0)
+		return DAFF_NO_ERROR;
+
+	nearestNeighboursKernel<<<getNumBlocks(n), BLOCK_SIZE, 0, (cudaStream_t)pStream>>>(
+		m_oContent, iView, pfAngles1, pfAngles2, piRecordIndices, pbOutOfBounds, n);
+	return getLaunchError();
+}
+
+int DAFFCUDAContent::getCells(int iView, const float* pfAngles1, const float* pfAngles2, int* piIndices, size_t n,
+							  void* pStream) const
+{
+	int iError = checkLookup(m_pfDeviceData, iView);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+	if (n == 0)
+		return DAFF_NO_ERROR;
+
+	cellsKernel<<<getNumBlocks(n), BLOCK_SIZE, 0, (cudaStream_t)pStream>>>(m_oContent, iView, pfAngles1, pfAngles2,
+																		   piIndices, n);
+	return getLaunchError();
+}
+
+int DAFFCUDAContent::getWeights(int iView, const float* pfAngles1, const float* pfAngles2, int* piIndices,
+								float* pfWeights, size_t n, void* pStream) const
+{
+	int iError = checkLookup(m_pfDeviceData, iView);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+	if (n == 0)
+		return DAFF_NO_ERROR;
+
+	weightsKernel<<<getNumBlocks(n), BLOCK_SIZE, 0, (cudaStream_t)pStream>>>(m_oContent, iView, pfAngles1,
+																			 pfAngles2, piIndices, pfWeights, n);
+	return getLaunchError();
+}
+
+int DAFFCUDAContent::interpolate(int iView, const float* pfAngles1, const float* pfAngles2, int iChannel,
+								 float* pfDest, size_t n, void* pStream) const
+{
+	int iError = checkLookup(m_pfDeviceData, iView);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+	if ((iChannel < 0) || (iChannel >= m_oContent.oGrid.iNumChannels))
+		return DAFF_INVALID_INDEX;
+	if (n == 0)
+		return DAFF_NO_ERROR;
+
+	interpolateKernel<<<(unsigned int)n, VALUE_BLOCK_SIZE, 0, (cudaStream_t)pStream>>>(
+		m_oContent, iView, pfAngles1, pfAngles2, iChannel, pfDest, n);
+	return getLaunchError();
+}
+
+int DAFFCUDAContent::getBandValues(int iView, const float* pfAngles1, const float* pfAngles2, int iChannel,
+								   int iValue, bool bInterpolate, float* pfDest, size_t n, void* pStream) const
+{
+	int iError = checkLookup(m_pfDeviceData, iView);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+	if ((iChannel < 0) || (iChannel >= m_oContent.oGrid.iNumChannels) || (iValue < 0) ||
+		(iValue >= m_oContent.iNumValues))
+		return DAFF_INVALID_INDEX;
+	if (n == 0)
+		return DAFF_NO_ERROR;
+
+	bandValuesKernel<<<getNumBlocks(n), BLOCK_SIZE, 0, (cudaStream_t)pStream>>>(
+		m_oContent, iView, pfAngles1, pfAngles2, iChannel, iValue, bInterpolate, pfDest, n);
+	return getLaunchError();
+}
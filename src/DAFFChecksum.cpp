@@ -0,0 +1,192 @@
+#include "DAFFChecksum.h"
+
+#include "Utils.h"
+
+#include <algorithm>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <nmmintrin.h>
+#define DAFF_CRC32C_SSE42
+#define DAFF_CRC32C_TARGET __attribute__((target("sse4.2")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <nmmintrin.h>
+#define DAFF_CRC32C_SSE42
+#define DAFF_CRC32C_TARGET
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define DAFF_CRC32C_ARM
+#endif
+
+//! Reflected Castagnoli polynomial
+static const uint32_t DAFF_CRC32C_POLYNOMIAL = 0x82F63B78;
+
+//! Minimum number of bytes per thread of the segment checksums
+static const size_t DAFF_CRC32C_MIN_BYTES_PER_THREAD = 4 * 1024 * 1024;
+
+//! Lookup tables of the software CRC-32C (slicing by 8)
+struct DAFFCRC32CTables {
+	uint32_t pui32Table[8][256];  //!@ Table k: CRC of a byte followed by k zero bytes
+
+	DAFFCRC32CTables()
+	{
+		for (uint32_t i = 0; i < 256; i++) {
+			uint32_t c = i;
+			for (int j = 0; j < 8; j++)
+				c = (c & 1) ? ((c >> 1) ^ DAFF_CRC32C_POLYNOMIAL) : (c >> 1);
+			pui32Table[0][i] = c;
+		}
+
+		for (int k = 1; k < 8; k++)
+			for (int i = 0; i < 256; i++)
+				pui32Table[k][i] = (pui32Table[k - 1][i] >> 8) ^ pui32Table[0][pui32Table[k - 1][i] & 0xFF];
+	}
+};
+
+static const DAFFCRC32CTables g_oCRC32CTables;
+
+// Operates on the inverted checksum
+static uint32_t crc32c_software(uint32_t c, const unsigned char* p, size_t n)
+{
+	const uint32_t(*t)[256] = g_oCRC32CTables.pui32Table;
+
+	for (; (n > 0) && (((uintptr_t)p & 7) != 0); n--)
+		c = (c >> 8) ^ t[0][(c ^ *p++) & 0xFF];
+
+	// Slicing by 8 (the bytes are assembled in little-endian order on all systems)
+	for (; n >= 8; n -= 8, p += 8) {
+		uint32_t lo = c ^ ((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+		uint32_t hi = (uint32_t)p[4] | ((uint32_t)p[5] << 8) | ((uint32_t)p[6] << 16) | ((uint32_t)p[7] << 24);
+		c = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^ t[3][hi & 0xFF] ^
+			t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+	}
+
+	for (; n > 0; n--)
+		c = (c >> 8) ^ t[0][(c ^ *p++) & 0xFF];
+
+	return c;
+}
+
+#ifdef DAFF_CRC32C_SSE42
+// Operates on the inverted checksum, requires SSE 4.2 (see DAFF::cpu_supports_sse42)
+DAFF_CRC32C_TARGET static uint32_t crc32c_sse42(uint32_t c, const unsigned char* p, size_t n)
+{
+	for (; (n > 0) && (((uintptr_t)p & 7) != 0); n--)
+		c = _mm_crc32_u8(c, *p++);
+
+#if defined(__x86_64__) || defined(_M_X64)
+	uint64_t c64 = c;
+	for (; n >= 32; n -= 32, p += 32) {
+		uint64_t v[4];
+		memcpy(v, p, sizeof(v));
+		c64 = _mm_crc32_u64(c64, v[0]);
+		c64 = _mm_crc32_u64(c64, v[1]);
+		c64 = _mm_crc32_u64(c64, v[2]);
+		c64 = _mm_crc32_u64(c64, v[3]);
+	}
+	for (; n >= 8; n -= 8, p += 8) {
+		uint64_t v;
+		memcpy(&v, p, sizeof(v));
+		c64 = _mm_crc32_u64(c64, v);
+	}
+	c = (uint32_t)c64;
+#else
+	for (; n >= 4; n -= 4, p += 4) {
+		uint32_t v;
+		memcpy(&v, p, sizeof(v));
+		c = _mm_crc32_u32(c, v);
+	}
+#endif
+
+	for (; n > 0; n--)
+		c = _mm_crc32_u8(c, *p++);
+
+	return c;
+}
+#endif  // DAFF_CRC32C_SSE42
+
+#ifdef DAFF_CRC32C_ARM
+// Operates on the inverted checksum
+static uint32_t crc32c_arm(uint32_t c, const unsigned char* p, size_t n)
+{
+	for (; (n > 0) && (((uintptr_t)p & 7) != 0); n--)
+		c = __crc32cb(c, *p++);
+
+	for (; n >= 8; n -= 8, p += 8) {
+		uint64_t v;
+		memcpy(&v, p, sizeof(v));
+		c = __crc32cd(c, v);
+	}
+
+	for (; n > 0; n--)
+		c = __crc32cb(c, *p++);
+
+	return c;
+}
+#endif  // DAFF_CRC32C_ARM
+
+typedef uint32_t (*CRC32CFunction)(uint32_t c, const unsigned char* p, size_t n);
+
+static CRC32CFunction select_crc32c()
+{
+#if defined(DAFF_CRC32C_SSE42)
+	if (DAFF::cpu_supports_sse42())
+		return &crc32c_sse42;
+#elif defined(DAFF_CRC32C_ARM)
+	return &crc32c_arm;
+#endif
+	return &crc32c_software;
+}
+
+static const CRC32CFunction g_pfnCRC32C = select_crc32c();
+
+// Segment checksums of [iBegin, iEnd)
+static void crc32c_segment_range(const unsigned char* p, size_t nBytes, size_t nSegmentSize, uint32_t* pui32Checksums,
+								 size_t iBegin, size_t iEnd)
+{
+	for (size_t i = iBegin; i < iEnd; i++) {
+		size_t nOffset = i * nSegmentSize;
+		pui32Checksums[i] = ~g_pfnCRC32C(0xFFFFFFFF, p + nOffset, std::min(nSegmentSize, nBytes - nOffset));
+	}
+}
+
+namespace DAFF {
+uint32_t crc32c(const void* pData, size_t nBytes, uint32_t ui32CRC)
+{
+	return ~g_pfnCRC32C(~ui32CRC, (const unsigned char*)pData, nBytes);
+}
+
+bool crc32c_hardware()
+{
+	return (g_pfnCRC32C != &crc32c_software);
+}
+
+void crc32c_segments(const void* pData, size_t nBytes, size_t nSegmentSize, uint32_t* pui32Checksums)
+{
+	const unsigned char* p = (const unsigned char*)pData;
+	size_t nNumSegments = (nBytes + nSegmentSize - 1) / nSegmentSize;
+
+	size_t nMaxThreads = std::max(nBytes / DAFF_CRC32C_MIN_BYTES_PER_THREAD, (size_t)1);
+	size_t nNumThreads = std::min(std::min((size_t)std::max(std::thread::hardware_concurrency(), 1u), nMaxThreads),
+								  std::max(nNumSegments, (size_t)1));
+
+	std::vector<std::thread> vThreads;
+	size_t nChunk = (nNumSegments + nNumThreads - 1) / nNumThreads;
+	for (size_t iBegin = nChunk; iBegin < nNumSegments; iBegin += nChunk) {
+		size_t iEnd = std::min(iBegin + nChunk, nNumSegments);
+		try {
+			vThreads.push_back(
+				std::thread(&crc32c_segment_range, p, nBytes, nSegmentSize, pui32Checksums, iBegin, iEnd));
+		} catch (const std::system_error&) {
+			crc32c_segment_range(p, nBytes, nSegmentSize, pui32Checksums, iBegin, iEnd);  // No more threads available
+		}
+	}
+
+	crc32c_segment_range(p, nBytes, nSegmentSize, pui32Checksums, 0, std::min(nChunk, nNumSegments));
+
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+}
+}  // namespace DAFF
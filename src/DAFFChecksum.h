@@ -0,0 +1,54 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_CHECKSUM
+#define IW_DAFF_CHECKSUM
+
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+
+/*
+ *  CRC-32C (Castagnoli polynomial 0x1EDC6F41, reflected, as in iSCSI and ext4)
+ *
+ *  Computed with the CRC32 instruction of SSE 4.2 if the CPU supports it (selected at
+ *  runtime), with the ARMv8 CRC instructions if the compiler targets them, and with
+ *  table lookups (slicing by 8) otherwise. All variants deliver the same checksums.
+ */
+
+namespace DAFF {
+//! Computes the CRC-32C of a byte range
+/**
+ * \param [in] pData		Data
+ * \param [in] nBytes		Size of the data [Bytes]
+ * \param [in] ui32CRC		Checksum of the preceding data to be continued (0 for a new checksum)
+ *
+ * @return Checksum
+ */
+uint32_t crc32c(const void* pData, size_t nBytes, uint32_t ui32CRC = 0);
+
+//! Returns true if the CRC-32C is computed by CPU instructions
+bool crc32c_hardware();
+
+//! Computes the CRC-32C of consecutive segments of a byte range
+/**
+ * Every segment has its own checksum, the last one may be shorter. Large ranges
+ * are distributed over several threads.
+ *
+ * \param [in] pData				Data
+ * \param [in] nBytes			Size of the data [Bytes]
+ * \param [in] nSegmentSize		Size of a segment [Bytes] (greater than zero)
+ * \param [out] pui32Checksums	Checksums of the segments, (nBytes + nSegmentSize - 1) / nSegmentSize elements
+ */
+void crc32c_segments(const void* pData, size_t nBytes, size_t nSegmentSize, uint32_t* pui32Checksums);
+}  // namespace DAFF
+
+#endif  // IW_DAFF_CHECKSUM
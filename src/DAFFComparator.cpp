@@ -0,0 +1,1084 @@
+#include <DAFFComparator.h>
+
+#include <DAFFContentDFT.h>
+#include <DAFFContentIR.h>
+#include <DAFFContentMPS.h>
+#include <DAFFContentMS.h>
+#include <DAFFInterpolator.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <system_error>
+#include <thread>
+
+#include "DAFFPropertiesImpl.h"
+#include "Utils.h"
+
+//! Smallest magnitude of the ratios (-200 dB)
+static const float DAFF_COMPARATOR_MAGNITUDE_FLOOR = 1e-10f;
+
+//! Smallest energy and smallest energy ratio of the error energies (-200 dB)
+static const double DAFF_COMPARATOR_ENERGY_FLOOR = 1e-20;
+
+//! Greatest angle between two directions that are considered the same [degrees]
+static const double DAFF_COMPARATOR_DIRECTION_TOLERANCE = 0.01;
+
+// Inner content interface realization (difference impulse responses)
+class DAFFContentIRDifferenceRealization : public DAFFContentIR {
+  public:
+	inline DAFFContentIRDifferenceRealization(DAFFComparator* pParent, const DAFFContentIR* pReference)
+		: m_pParent(pParent), m_pReference(pReference)
+	{
+		m_oProps = *(pReference->getProperties());
+		m_oProps.m_iQuantization = DAFF_FLOAT32;
+	};
+
+	inline virtual ~DAFFContentIRDifferenceRealization() {};
+
+	// --= Interface "DAFFContentIR" =--
+
+	inline double getSamplerate() const { return m_pReference->getSamplerate(); };
+
+	inline int getFilterLength() const { return m_pParent->m_iLength; };
+
+	inline int getFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getData(iRecordIndex, iChannel, pfDest, fGain, false);
+	};
+
+	inline int getFilterCoeff(int iRecordIndex, int iChannel, int iSample, float& fCoeff) const
+	{
+		return m_pParent->getValue(iRecordIndex, iChannel, iSample, fCoeff);
+	};
+
+	inline int addFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getData(iRecordIndex, iChannel, pfDest, fGain, true);
+	};
+
+	inline int getFilterCoeffsQ15(int iRecordIndex, int iChannel, int16_t* piDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFixedPointFilterCoeffs(iRecordIndex, iChannel, piDest, NULL, fGain, false);
+	};
+
+	inline int getFilterCoeffsQ31(int iRecordIndex, int iChannel, int32_t* piDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFixedPointFilterCoeffs(iRecordIndex, iChannel, NULL, piDest, fGain, false);
+	};
+
+	inline int addFilterCoeffsQ15(int iRecordIndex, int iChannel, int16_t* piDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFixedPointFilterCoeffs(iRecordIndex, iChannel, piDest, NULL, fGain, true);
+	};
+
+	inline int addFilterCoeffsQ31(int iRecordIndex, int iChannel, int32_t* piDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFixedPointFilterCoeffs(iRecordIndex, iChannel, NULL, piDest, fGain, true);
+	};
+
+	inline int getRecord(int iRecordIndex, float** ppfChannelDest) const
+	{
+		return m_pParent->getRecord(iRecordIndex, ppfChannelDest);
+	};
+
+	inline int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const
+	{
+		return m_pParent->getRecordInterleaved(iRecordIndex, pfDest, iStride);
+	};
+
+	// The difference filters start at the first coefficient and are stored completely
+
+	inline int getMinEffectiveFilterOffset() const { return 0; };
+
+	inline int getMaxEffectiveFilterLength() const { return m_pParent->m_iLength; };
+
+	inline int getEffectiveFilterBounds(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const
+	{
+		if (!m_pParent->getDataPtr(iRecordIndex, iChannel))
+			return DAFF_INVALID_INDEX;
+
+		iOffset = 0;
+		iLength = m_pParent->m_iLength;
+		return DAFF_NO_ERROR;
+	};
+
+	inline int getEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getData(iRecordIndex, iChannel, pfDest, fGain, false);
+	};
+
+	inline int getFilterCoeffsTruncated(int iRecordIndex, int iChannel, float* pfDest, int& iLength,
+										float fGain = 1.0F) const
+	{
+		int iError = m_pParent->getData(iRecordIndex, iChannel, pfDest, fGain, false);
+		if (iError == DAFF_NO_ERROR)
+			iLength = m_pParent->m_iLength;
+		return iError;
+	};
+
+	inline int getMaxTruncatedFilterLength() const { return m_pParent->m_iLength; };
+
+	inline int addEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getData(iRecordIndex, iChannel, pfDest, fGain, true);
+	};
+
+	inline const float* getEffectiveFilterCoeffsPtr(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const
+	{
+		iOffset = 0;
+		iLength = m_pParent->m_iLength;
+		return m_pParent->getDataPtr(iRecordIndex, iChannel);
+	};
+
+	inline int getFilterEnvelope(int iRecordIndex, int iChannel, int iFirstSample, int iNumSamples, int iNumBins,
+								 float* pfMin, float* pfMax) const
+	{
+		return m_pParent->getFilterEnvelope(iRecordIndex, iChannel, iFirstSample, iNumSamples, iNumBins, pfMin, pfMax);
+	};
+
+	inline float getOverallPeak() const { return m_pParent->m_fOverallPeak; };
+
+	inline float getChannelPeak(int iChannel) const { return m_pParent->getChannelPeak(iChannel); };
+
+	inline float getRecordPeak(int iRecordIndex, int iChannel) const
+	{
+		return m_pParent->getRecordPeak(iRecordIndex, iChannel);
+	};
+
+	inline int getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const
+	{
+		return m_pParent->getRecordStatistics(iRecordIndex, iChannel, oStats);
+	};
+
+	// --= Interface "DAFFContent" =--
+
+	// This interface is completely delegated to the reference content
+
+	inline DAFFReader* getParent() const { return m_pReference->getParent(); };
+
+	inline const DAFFPropertiesImpl* getProperties() const { return &m_oProps; };
+
+	inline const DAFFMetadata* getRecordMetadata(int iRecordIndex) const
+	{
+		return m_pReference->getRecordMetadata(iRecordIndex);
+	};
+
+	inline int getRecordCoords(int iRecordIndex, int iView, float& fAngle1, float& fAngle2) const
+	{
+		return m_pReference->getRecordCoords(iRecordIndex, iView, fAngle1, fAngle2);
+	};
+
+	inline void getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex) const
+	{
+		m_pReference->getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex);
+	};
+
+	inline void getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex,
+									bool& bOutOfBounds) const
+	{
+		m_pReference->getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex, bOutOfBounds);
+	};
+
+	inline void getNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int* piRecordIndices,
+									 bool* pbOutOfBounds, size_t n) const
+	{
+		m_pReference->getNearestNeighbours(iView, pfAngles1, pfAngles2, piRecordIndices, pbOutOfBounds, n);
+	};
+
+	inline int getKNearestNeighbours(int iView, float fAngle1, float fAngle2, int k, int* piRecordIndices,
+									 float* pfDistances) const
+	{
+		return m_pReference->getKNearestNeighbours(iView, fAngle1, fAngle2, k, piRecordIndices, pfDistances);
+	};
+
+	inline int getKNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int k,
+									 int* piRecordIndices, float* pfDistances, size_t n) const
+	{
+		return m_pReference->getKNearestNeighbours(iView, pfAngles1, pfAngles2, k, piRecordIndices, pfDistances, n);
+	};
+
+	inline int getRecordsInCone(int iView, float fAngle1, float fAngle2, float fRadius,
+								std::vector<int>& viRecordIndices) const
+	{
+		return m_pReference->getRecordsInCone(iView, fAngle1, fAngle2, fRadius, viRecordIndices);
+	};
+
+	inline int getRecordsInCone(int iView, const float* pfAngles1, const float* pfAngles2, float fRadius,
+								std::vector<int>& viRecordIndices, std::vector<int>& viOffsets, size_t n) const
+	{
+		return m_pReference->getRecordsInCone(iView, pfAngles1, pfAngles2, fRadius, viRecordIndices, viOffsets, n);
+	};
+
+	inline void getCell(int iView, float fAngle1, float fAngle2, DAFFQuad& qIndices) const
+	{
+		m_pReference->getCell(iView, fAngle1, fAngle2, qIndices);
+	};
+
+	inline void transformAnglesD2O(float fAlpha, float fBeta, float& fAzimuth, float& fElevation) const
+	{
+		m_pReference->transformAnglesD2O(fAlpha, fBeta, fAzimuth, fElevation);
+	};
+
+	inline void transformAnglesO2D(float fAzimuth, float fElevation, float& fAlpha, float& fBeta) const
+	{
+		m_pReference->transformAnglesO2D(fAzimuth, fElevation, fAlpha, fBeta);
+	};
+
+  private:
+	DAFFComparator* m_pParent;
+	const DAFFContentIR* m_pReference;
+	DAFFPropertiesImpl m_oProps;
+};
+
+// Inner content interface realization (magnitude ratios)
+class DAFFContentMSDifferenceRealization : public DAFFContentMS {
+  public:
+	inline DAFFContentMSDifferenceRealization(DAFFComparator* pParent, const DAFFContent* pReference)
+		: m_pParent(pParent), m_pReference(pReference)
+	{
+		m_oProps = *(pReference->getProperties());
+		m_oProps.m_iContentType = DAFF_MAGNITUDE_SPECTRUM;
+		m_oProps.m_iQuantization = DAFF_FLOAT32;
+	};
+
+	inline virtual ~DAFFContentMSDifferenceRealization() {};
+
+	// --= Interface "DAFFContentMS" =--
+
+	inline int getNumFrequencies() const { return m_pParent->m_iLength; };
+
+	inline const std::vector<float>& getFrequencies() const { return m_pParent->m_vfFrequencies; };
+
+	inline float getOverallMagnitudeMaximum() const { return m_pParent->m_fOverallPeak; };
+
+	inline int getMagnitudes(int iRecordIndex, int iChannel, float* pfDest) const
+	{
+		return m_pParent->getData(iRecordIndex, iChannel, pfDest, 1.0f, false);
+	};
+
+	inline int addMagnitudes(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getData(iRecordIndex, iChannel, pfDest, fGain, true);
+	};
+
+	inline int getRecord(int iRecordIndex, float** ppfChannelDest) const
+	{
+		return m_pParent->getRecord(iRecordIndex, ppfChannelDest);
+	};
+
+	inline int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const
+	{
+		return m_pParent->getRecordInterleaved(iRecordIndex, pfDest, iStride);
+	};
+
+	inline int getMagnitude(int iRecordIndex, int iChannel, int iFreqIndex, float& fMag) const
+	{
+		return m_pParent->getValue(iRecordIndex, iChannel, iFreqIndex, fMag);
+	};
+
+	inline int getMagnitudeSlice(int iChannel, int iFreqIndex, float* pfDest) const
+	{
+		return m_pParent->getSlice(iChannel, iFreqIndex, pfDest);
+	};
+
+	inline const float* getMagnitudesPtr(int iRecordIndex, int iChannel) const
+	{
+		return m_pParent->getDataPtr(iRecordIndex, iChannel);
+	};
+
+	inline int getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const
+	{
+		return m_pParent->getRecordStatistics(iRecordIndex, iChannel, oStats);
+	};
+
+	// --= Interface "DAFFContent" =--
+
+	// This interface is completely delegated to the reference content
+
+	inline DAFFReader* getParent() const { return m_pReference->getParent(); };
+
+	inline const DAFFPropertiesImpl* getProperties() const { return &m_oProps; };
+
+	inline const DAFFMetadata* getRecordMetadata(int iRecordIndex) const
+	{
+		return m_pReference->getRecordMetadata(iRecordIndex);
+	};
+
+	inline int getRecordCoords(int iRecordIndex, int iView, float& fAngle1, float& fAngle2) const
+	{
+		return m_pReference->getRecordCoords(iRecordIndex, iView, fAngle1, fAngle2);
+	};
+
+	inline void getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex) const
+	{
+		m_pReference->getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex);
+	};
+
+	inline void getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex,
+									bool& bOutOfBounds) const
+	{
+		m_pReference->getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex, bOutOfBounds);
+	};
+
+	inline void getNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int* piRecordIndices,
+									 bool* pbOutOfBounds, size_t n) const
+	{
+		m_pReference->getNearestNeighbours(iView, pfAngles1, pfAngles2, piRecordIndices, pbOutOfBounds, n);
+	};
+
+	inline int getKNearestNeighbours(int iView, float fAngle1, float fAngle2, int k, int* piRecordIndices,
+									 float* pfDistances) const
+	{
+		return m_pReference->getKNearestNeighbours(iView, fAngle1, fAngle2, k, piRecordIndices, pfDistances);
+	};
+
+	inline int getKNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int k,
+									 int* piRecordIndices, float* pfDistances, size_t n) const
+	{
+		return m_pReference->getKNearestNeighbours(iView, pfAngles1, pfAngles2, k, piRecordIndices, pfDistances, n);
+	};
+
+	inline int getRecordsInCone(int iView, float fAngle1, float fAngle2, float fRadius,
+								std::vector<int>& viRecordIndices) const
+	{
+		return m_pReference->getRecordsInCone(iView, fAngle1, fAngle2, fRadius, viRecordIndices);
+	};
+
+	inline int getRecordsInCone(int iView, const float* pfAngles1, const float* pfAngles2, float fRadius,
+								std::vector<int>& viRecordIndices, std::vector<int>& viOffsets, size_t n) const
+	{
+		return m_pReference->getRecordsInCone(iView, pfAngles1, pfAngles2, fRadius, viRecordIndices, viOffsets, n);
+	};
+
+	inline void getCell(int iView, float fAngle1, float fAngle2, DAFFQuad& qIndices) const
+	{
+		m_pReference->getCell(iView, fAngle1, fAngle2, qIndices);
+	};
+
+	inline void transformAnglesD2O(float fAlpha, float fBeta, float& fAzimuth, float& fElevation) const
+	{
+		m_pReference->transformAnglesD2O(fAlpha, fBeta, fAzimuth, fElevation);
+	};
+
+	inline void transformAnglesO2D(float fAzimuth, float fElevation, float& fAlpha, float& fBeta) const
+	{
+		m_pReference->transformAnglesO2D(fAzimuth, fElevation, fAlpha, fBeta);
+	};
+
+  private:
+	DAFFComparator* m_pParent;
+	const DAFFContent* m_pReference;
+	DAFFPropertiesImpl m_oProps;
+};
+
+//! Returns the number of values of a record channel (filter length, number of frequencies or DFT coefficients)
+static int getNumValues(const DAFFContent* pContent)
+{
+	switch (pContent->getProperties()->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		return dynamic_cast<const DAFFContentIR*>(pContent)->getFilterLength();
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return dynamic_cast<const DAFFContentMS*>(pContent)->getNumFrequencies();
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		return dynamic_cast<const DAFFContentMPS*>(pContent)->getNumFrequencies();
+	case DAFF_DFT_SPECTRUM:
+		return dynamic_cast<const DAFFContentDFT*>(pContent)->getNumDFTCoeffs();
+	default:
+		return 0;
+	}
+}
+
+//! Reads the coefficients or magnitudes of a record channel (pfScratch: 2 * getNumValues() floats for DFT spectra)
+static int readValues(const DAFFContent* pContent, int iRecordIndex, int iChannel, float* pfDest, float* pfScratch)
+{
+	switch (pContent->getProperties()->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		return dynamic_cast<const DAFFContentIR*>(pContent)->getFilterCoeffs(iRecordIndex, iChannel, pfDest);
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return dynamic_cast<const DAFFContentMS*>(pContent)->getMagnitudes(iRecordIndex, iChannel, pfDest);
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		return dynamic_cast<const DAFFContentMPS*>(pContent)->getMagnitudes(iRecordIndex, iChannel, pfDest);
+	case DAFF_DFT_SPECTRUM: {
+		const DAFFContentDFT* pContentDFT = dynamic_cast<const DAFFContentDFT*>(pContent);
+		int iError = pContentDFT->getCoefficientsMP(iRecordIndex, iChannel, pfScratch);
+		if (iError != DAFF_NO_ERROR)
+			return iError;
+		for (int i = 0; i < pContentDFT->getNumDFTCoeffs(); i++)
+			pfDest[i] = pfScratch[2 * i];
+		return DAFF_NO_ERROR;
+	}
+	default:
+		return DAFF_MODAL_ERROR;
+	}
+}
+
+//! Returns the frequencies of a spectrum [Hz] (the DFT coefficients of DFT spectra)
+static void getSpectrumFrequencies(const DAFFContent* pContent, std::vector<float>& vfFrequencies)
+{
+	switch (pContent->getProperties()->getContentType()) {
+	case DAFF_MAGNITUDE_SPECTRUM:
+		vfFrequencies = dynamic_cast<const DAFFContentMS*>(pContent)->getFrequencies();
+		break;
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		vfFrequencies = dynamic_cast<const DAFFContentMPS*>(pContent)->getFrequencies();
+		break;
+	case DAFF_DFT_SPECTRUM: {
+		const DAFFContentDFT* pContentDFT = dynamic_cast<const DAFFContentDFT*>(pContent);
+		vfFrequencies.resize(pContentDFT->getNumDFTCoeffs());
+		for (int i = 0; i < pContentDFT->getNumDFTCoeffs(); i++)
+			vfFrequencies[i] = (float)(i * pContentDFT->getFrequencyBandwidth());
+		break;
+	}
+	default:
+		vfFrequencies.clear();
+	}
+}
+
+//! Indicates whether two directions (object view) are the same within the direction tolerance
+static bool isSameDirection(float fAzimuth1Deg, float fElevation1Deg, float fAzimuth2Deg, float fElevation2Deg)
+{
+	const double dDeg2Rad = std::acos(-1.0) / 180;
+	double dEle1 = fElevation1Deg * dDeg2Rad, dEle2 = fElevation2Deg * dDeg2Rad;
+	double dAzi = (fAzimuth2Deg - fAzimuth1Deg) * dDeg2Rad;
+
+	// Cosine of the angle between the unit vectors
+	double dCos = std::sin(dEle1) * std::sin(dEle2) + std::cos(dEle1) * std::cos(dEle2) * std::cos(dAzi);
+	return dCos >= std::cos(DAFF_COMPARATOR_DIRECTION_TOLERANCE * dDeg2Rad);
+}
+
+//! Ratio of two energies in decibels (not below the energy floor)
+static float getEnergyRatioDecibel(double dEnergy, double dReference)
+{
+	double dRatio =
+		std::max(dEnergy, DAFF_COMPARATOR_ENERGY_FLOOR) / std::max(dReference, DAFF_COMPARATOR_ENERGY_FLOOR);
+	return (float)(10 * std::log10(std::max(dRatio, DAFF_COMPARATOR_ENERGY_FLOOR)));
+}
+
+DAFFComparator::DAFFComparator()
+	: m_pReference(NULL), m_pTest(NULL), m_pReferenceIR(NULL), m_pTestIR(NULL), m_pOutputContent(NULL),
+	  m_pInterpolator(NULL), m_iNumThreads(0), m_bGridMatching(false), m_iLength(0), m_iStride(0), m_pfBuf(NULL),
+	  m_fOverallPeak(0), m_fMaxDelta(0), m_fOverallErrorEnergy(0)
+{
+}
+
+DAFFComparator::DAFFComparator(const DAFFContent* pReference, const DAFFContent* pTest, bool bCompare)
+	: m_pReference(NULL), m_pTest(NULL), m_pReferenceIR(NULL), m_pTestIR(NULL), m_pOutputContent(NULL),
+	  m_pInterpolator(NULL), m_iNumThreads(0), m_bGridMatching(false), m_iLength(0), m_iStride(0), m_pfBuf(NULL),
+	  m_fOverallPeak(0), m_fMaxDelta(0), m_fOverallErrorEnergy(0)
+{
+	setInputContents(pReference, pTest, bCompare);
+}
+
+DAFFComparator::~DAFFComparator()
+{
+	clear();
+}
+
+const DAFFContent* DAFFComparator::getReferenceContent() const
+{
+	return m_pReference;
+}
+
+const DAFFContent* DAFFComparator::getTestContent() const
+{
+	return m_pTest;
+}
+
+void DAFFComparator::setInputContents(const DAFFContent* pReference, const DAFFContent* pTest, bool bCompare)
+{
+	clear();
+	m_pReference = pReference;
+	m_pTest = pTest;
+	if (bCompare)
+		compare();
+}
+
+int DAFFComparator::getNumThreads() const
+{
+	return m_iNumThreads;
+}
+
+void DAFFComparator::setNumThreads(int iNumThreads)
+{
+	m_iNumThreads = (iNumThreads > 0 ? iNumThreads : 0);
+}
+
+bool DAFFComparator::isGridMatching() const
+{
+	return m_bGridMatching;
+}
+
+const DAFFContent* DAFFComparator::getDifferenceContent() const
+{
+	return m_pOutputContent;
+}
+
+int DAFFComparator::getNumFrequencies() const
+{
+	return (int)m_vfFrequencies.size();
+}
+
+const std::vector<float>& DAFFComparator::getFrequencies() const
+{
+	return m_vfFrequencies;
+}
+
+size_t DAFFComparator::getMemoryFootprint() const
+{
+	size_t nBytes = m_viTestRecords.capacity() * sizeof(int) + m_viFreqIndices.capacity() * sizeof(int);
+	nBytes += (m_vfFrequencies.capacity() + m_vfTestFrequencies.capacity()) * sizeof(float);
+	nBytes += m_vfFreqWeights.capacity() * sizeof(float);
+	nBytes += (m_vfErrorEnergies.capacity() + m_vfPeaks.capacity() + m_vfChannelPeaks.capacity()) * sizeof(float);
+	if (m_pOutputContent)
+		nBytes += (size_t)m_pReference->getProperties()->getNumberOfRecords() *
+				  m_pReference->getProperties()->getNumberOfChannels() * m_iStride * sizeof(float);
+	return nBytes;
+}
+
+void DAFFComparator::clear()
+{
+	delete m_pInterpolator;
+	m_pInterpolator = NULL;
+
+	delete m_pOutputContent;
+	m_pOutputContent = NULL;
+
+	DAFF::free_aligned16(m_pfBuf);
+	m_pfBuf = NULL;
+
+	m_pReferenceIR = NULL;
+	m_pTestIR = NULL;
+	m_bGridMatching = false;
+	m_viTestRecords.clear();
+	m_vfFrequencies.clear();
+	m_vfTestFrequencies.clear();
+	m_viFreqIndices.clear();
+	m_vfFreqWeights.clear();
+	m_vfErrorEnergies.clear();
+	m_vfPeaks.clear();
+	m_vfChannelPeaks.clear();
+	m_iLength = 0;
+	m_iStride = 0;
+	m_fOverallPeak = 0;
+	m_fMaxDelta = 0;
+	m_fOverallErrorEnergy = 0;
+}
+
+bool DAFFComparator::matchGrids()
+{
+	int iRecords = m_pReference->getProperties()->getNumberOfRecords();
+	m_viTestRecords.resize(iRecords);
+	for (int i = 0; i < iRecords; i++) {
+		float fAzimuth, fElevation, fTestAzimuth, fTestElevation;
+		m_pReference->getRecordCoords(i, DAFF_OBJECT_VIEW, fAzimuth, fElevation);
+
+		int iTestRecord;
+		bool bOutOfBounds;
+		m_pTest->getNearestNeighbour(DAFF_OBJECT_VIEW, fAzimuth, fElevation, iTestRecord, bOutOfBounds);
+		if (bOutOfBounds ||
+			m_pTest->getRecordCoords(iTestRecord, DAFF_OBJECT_VIEW, fTestAzimuth, fTestElevation) != DAFF_NO_ERROR ||
+			!isSameDirection(fAzimuth, fElevation, fTestAzimuth, fTestElevation)) {
+			m_viTestRecords.clear();
+			return false;
+		}
+		m_viTestRecords[i] = iTestRecord;
+	}
+	return true;
+}
+
+void DAFFComparator::initFrequencies()
+{
+	getSpectrumFrequencies(m_pReference, m_vfFrequencies);
+	getSpectrumFrequencies(m_pTest, m_vfTestFrequencies);
+
+	// Same support, no interpolation
+	bool bSame = (m_vfFrequencies.size() == m_vfTestFrequencies.size());
+	for (size_t i = 0; bSame && (i < m_vfFrequencies.size()); i++)
+		bSame = (std::fabs(m_vfFrequencies[i] - m_vfTestFrequencies[i]) <= 1e-4f * std::max(m_vfFrequencies[i], 1.0f));
+	if (bSame || m_vfTestFrequencies.empty())
+		return;
+
+	// Interpolation over the logarithm of the frequency, constant beyond the test support as in
+	// DAFFTransformerMS2Bands (the DC coefficient of DFT spectra is interpolated linearly)
+	int n = (int)m_vfTestFrequencies.size();
+	m_viFreqIndices.resize(m_vfFrequencies.size());
+	m_vfFreqWeights.resize(m_vfFrequencies.size());
+	for (size_t i = 0; i < m_vfFrequencies.size(); i++) {
+		double dFrequency = m_vfFrequencies[i];
+		int j = (int)(std::upper_bound(m_vfTestFrequencies.begin(), m_vfTestFrequencies.end(), m_vfFrequencies[i]) -
+					  m_vfTestFrequencies.begin()) -
+				1;
+		if (j < 0 || j >= n - 1) {
+			m_viFreqIndices[i] = std::min(std::max(j, 0), n - 1);
+			m_vfFreqWeights[i] = 0;
+			continue;
+		}
+
+		double dLower = m_vfTestFrequencies[j], dUpper = m_vfTestFrequencies[j + 1];
+		double t;
+		if ((dLower > 0) && (dFrequency > 0))
+			t = std::log(dFrequency / dLower) / std::log(dUpper / dLower);
+		else
+			t = (dFrequency - dLower) / (dUpper - dLower);
+
+		m_viFreqIndices[i] = j;
+		m_vfFreqWeights[i] = (float)t;
+	}
+}
+
+int DAFFComparator::compare()
+{
+	// Discard previous results
+	clear();
+
+	if (!m_pReference || !m_pTest)
+		return DAFF_MODAL_ERROR;
+
+	const DAFFProperties* pReferenceProps = m_pReference->getProperties();
+	const DAFFProperties* pTestProps = m_pTest->getProperties();
+	int iReferenceType = pReferenceProps->getContentType();
+	int iTestType = pTestProps->getContentType();
+	if ((iReferenceType == DAFF_PHASE_SPECTRUM) || (iTestType == DAFF_PHASE_SPECTRUM) ||
+		((iReferenceType == DAFF_IMPULSE_RESPONSE) != (iTestType == DAFF_IMPULSE_RESPONSE)) ||
+		(pReferenceProps->getNumberOfChannels() != pTestProps->getNumberOfChannels()))
+		return DAFF_MODAL_ERROR;
+
+	if (iReferenceType == DAFF_IMPULSE_RESPONSE) {
+		m_pReferenceIR = dynamic_cast<const DAFFContentIR*>(m_pReference);
+		m_pTestIR = dynamic_cast<const DAFFContentIR*>(m_pTest);
+		if (m_pReferenceIR->getSamplerate() != m_pTestIR->getSamplerate()) {
+			clear();
+			return DAFF_MODAL_ERROR;
+		}
+		m_iLength = std::max(m_pReferenceIR->getFilterLength(), m_pTestIR->getFilterLength());
+	} else {
+		initFrequencies();
+		m_iLength = (int)m_vfFrequencies.size();
+	}
+
+	int iRecords = pReferenceProps->getNumberOfRecords();
+	int iChannels = pReferenceProps->getNumberOfChannels();
+	int iNumRecordChannels = iRecords * iChannels;
+	if ((m_iLength < 1) || (getNumValues(m_pTest) < 1) || (iNumRecordChannels < 1)) {
+		clear();
+		return DAFF_MODAL_ERROR;
+	}
+
+	// Records at the same directions are compared directly, otherwise the test content is resampled
+	m_bGridMatching = matchGrids();
+	if (!m_bGridMatching)
+		m_pInterpolator = new DAFFInterpolator(m_pTest);
+
+	// Record channels are 16-byte aligned
+	m_iStride = (m_iLength + 3) / 4 * 4;
+	size_t nBytes = (size_t)iNumRecordChannels * m_iStride * sizeof(float);
+	m_pfBuf = static_cast<float*>(DAFF::malloc_aligned16(nBytes));
+	if (!m_pfBuf) {
+		clear();
+		return DAFF_MODAL_ERROR;
+	}
+	memset(m_pfBuf, 0, nBytes);
+
+	// Distribute the record channels over several threads, each comparing a range
+	int iNumThreads = m_iNumThreads;
+	if (iNumThreads <= 0) {
+		const uint64_t ui64MinSamplesPerThread = 1 << 16;
+		uint64_t ui64NumSamples = (uint64_t)iNumRecordChannels * m_iLength;
+		uint64_t ui64MaxThreads = std::max(ui64NumSamples / ui64MinSamplesPerThread, (uint64_t)1);
+		iNumThreads = (int)std::min((uint64_t)std::max(std::thread::hardware_concurrency(), 1u), ui64MaxThreads);
+	}
+
+	std::vector<double> vdEnergies(2 * (size_t)iNumRecordChannels);
+	std::vector<float> vfRatios(2 * (size_t)iNumRecordChannels);
+	std::vector<int> viErrors(iNumThreads + 1, DAFF_NO_ERROR);
+	std::vector<std::thread> vThreads;
+	int iChunk = (iNumRecordChannels + iNumThreads - 1) / iNumThreads;
+	int iRange = 1;
+	for (int iBegin = iChunk; iBegin < iNumRecordChannels; iBegin += iChunk, iRange++) {
+		int iEnd = std::min(iBegin + iChunk, iNumRecordChannels);
+		try {
+			vThreads.push_back(std::thread(&DAFFComparator::compareRange, this, iBegin, iEnd, &vdEnergies[0],
+										   &vfRatios[0], &viErrors[iRange]));
+		} catch (const std::system_error&) {
+			// No more threads available
+			compareRange(iBegin, iEnd, &vdEnergies[0], &vfRatios[0], &viErrors[iRange]);
+		}
+	}
+
+	compareRange(0, std::min(iChunk, iNumRecordChannels), &vdEnergies[0], &vfRatios[0], &viErrors[0]);
+
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	for (size_t i = 0; i < viErrors.size(); i++) {
+		if (viErrors[i] != DAFF_NO_ERROR) {
+			int iError = viErrors[i];
+			clear();
+			return iError;
+		}
+	}
+
+	// Error energies and peaks of the record channels
+	double dReferenceEnergy = 0, dErrorEnergy = 0;
+	m_vfErrorEnergies.resize(iNumRecordChannels);
+	m_vfPeaks.resize(iNumRecordChannels);
+	m_vfChannelPeaks.assign(iChannels, 0.0f);
+	for (int n = 0; n < iNumRecordChannels; n++) {
+		m_vfErrorEnergies[n] = getEnergyRatioDecibel(vdEnergies[2 * n + 1], vdEnergies[2 * n]);
+		dReferenceEnergy += vdEnergies[2 * n];
+		dErrorEnergy += vdEnergies[2 * n + 1];
+
+		float fMin = vfRatios[2 * n], fMax = vfRatios[2 * n + 1];
+		if (m_pReferenceIR) {
+			m_vfPeaks[n] = std::max(std::fabs(fMin), std::fabs(fMax));
+		} else {
+			m_vfPeaks[n] = fMax;
+			m_fMaxDelta = std::max(m_fMaxDelta, std::max(20 * std::log10(fMax), -20 * std::log10(fMin)));
+		}
+		m_vfChannelPeaks[n % iChannels] = std::max(m_vfChannelPeaks[n % iChannels], m_vfPeaks[n]);
+		m_fOverallPeak = std::max(m_fOverallPeak, m_vfPeaks[n]);
+	}
+	m_fOverallErrorEnergy = getEnergyRatioDecibel(dErrorEnergy, dReferenceEnergy);
+
+	if (m_pReferenceIR)
+		m_pOutputContent = new DAFFContentIRDifferenceRealization(this, m_pReferenceIR);
+	else
+		m_pOutputContent = new DAFFContentMSDifferenceRealization(this, m_pReference);
+
+	return DAFF_NO_ERROR;
+}
+
+void DAFFComparator::compareRange(int iBegin, int iEnd, double* pdEnergies, float* pfRatios, int* piError) const
+{
+	int iChannels = m_pReference->getProperties()->getNumberOfChannels();
+	int iReferenceLength = getNumValues(m_pReference);
+	int iTestLength = getNumValues(m_pTest);
+	int iMaxLength = std::max(m_iLength, iTestLength);
+
+	// Reference values, test values (of a record, blended at the reference direction, at the reference
+	// frequencies) and scratch buffer (DFT coefficients in polar form, magnitude differences)
+	std::vector<float> vfReference(std::max(m_iLength, iReferenceLength));
+	std::vector<float> vfTestRecord(iMaxLength), vfTest(iMaxLength), vfRemapped(iMaxLength);
+	std::vector<float> vfScratch(2 * std::max(iMaxLength, iReferenceLength));
+
+	DAFFQuad qCell;
+	float pfWeights[4];
+	int piRecords[4];
+	int iRecord = -1;
+	for (int n = iBegin; n < iEnd; n++) {
+		int iRecordIndex = n / iChannels;
+		int iChannel = n % iChannels;
+
+		// Filters are padded with zeros to the common length
+		std::fill(vfReference.begin(), vfReference.end(), 0.0f);
+		*piError = readValues(m_pReference, iRecordIndex, iChannel, &vfReference[0], &vfScratch[0]);
+		if (*piError != DAFF_NO_ERROR)
+			return;
+
+		// Test records at the direction of the reference record (once per record)
+		if (iRecordIndex != iRecord) {
+			iRecord = iRecordIndex;
+			if (m_bGridMatching) {
+				piRecords[0] = m_viTestRecords[iRecordIndex];
+				pfWeights[0] = 1;
+				pfWeights[1] = pfWeights[2] = pfWeights[3] = 0;
+			} else {
+				float fAzimuth, fElevation;
+				m_pReference->getRecordCoords(iRecordIndex, DAFF_OBJECT_VIEW, fAzimuth, fElevation);
+				if (m_pInterpolator->getWeights(DAFF_OBJECT_VIEW, fAzimuth, fElevation, qCell, pfWeights) ==
+					DAFF_NO_ERROR) {
+					piRecords[0] = qCell.iIndex1;
+					piRecords[1] = qCell.iIndex2;
+					piRecords[2] = qCell.iIndex3;
+					piRecords[3] = qCell.iIndex4;
+				} else {
+					// Irregular grid
+					m_pTest->getNearestNeighbour(DAFF_OBJECT_VIEW, fAzimuth, fElevation, piRecords[0]);
+					pfWeights[0] = 1;
+					pfWeights[1] = pfWeights[2] = pfWeights[3] = 0;
+				}
+			}
+		}
+
+		std::fill(vfTest.begin(), vfTest.end(), 0.0f);
+		for (int k = 0; k < 4; k++) {
+			if (pfWeights[k] == 0)
+				continue;
+
+			*piError = readValues(m_pTest, piRecords[k], iChannel, &vfTestRecord[0], &vfScratch[0]);
+			if (*piError != DAFF_NO_ERROR)
+				return;
+			for (int i = 0; i < iTestLength; i++)
+				vfTest[i] += pfWeights[k] * vfTestRecord[i];
+		}
+
+		// Test spectra at the reference frequencies
+		const float* pfTest = &vfTest[0];
+		if (!m_viFreqIndices.empty()) {
+			for (int i = 0; i < m_iLength; i++) {
+				int j = m_viFreqIndices[i];
+				float t = m_vfFreqWeights[i];
+				vfRemapped[i] = (t > 0 ? vfTest[j] + t * (vfTest[j + 1] - vfTest[j]) : vfTest[j]);
+			}
+			pfTest = &vfRemapped[0];
+		}
+
+		float* pfDest = m_pfBuf + (size_t)n * m_iStride;
+		if (m_pReferenceIR) {
+			DAFF::sub_float(pfDest, pfTest, &vfReference[0], m_iLength);
+			pdEnergies[2 * n + 1] = DAFF::energy_float(pfDest, m_iLength);
+		} else {
+			DAFF::ratio_float(pfDest, pfTest, &vfReference[0], DAFF_COMPARATOR_MAGNITUDE_FLOOR, m_iLength);
+			DAFF::sub_float(&vfScratch[0], pfTest, &vfReference[0], m_iLength);
+			pdEnergies[2 * n + 1] = DAFF::energy_float(&vfScratch[0], m_iLength);
+		}
+		pdEnergies[2 * n] = DAFF::energy_float(&vfReference[0], m_iLength);
+
+		pfRatios[2 * n] = pfRatios[2 * n + 1] = pfDest[0];
+		DAFF::minmax_float(pfDest, m_iLength, pfRatios[2 * n], pfRatios[2 * n + 1]);
+	}
+}
+
+int DAFFComparator::getMagnitudeDeltas(int iRecordIndex, int iChannel, float* pfDest) const
+{
+	if (!m_pOutputContent || m_pReferenceIR)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getDataPtr(iRecordIndex, iChannel);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	assert(pfDest != 0);
+	for (int i = 0; i < m_iLength; i++)
+		pfDest[i] = 20 * std::log10(pfData[i]);
+	return DAFF_NO_ERROR;
+}
+
+float DAFFComparator::getMaximumMagnitudeDelta() const
+{
+	return m_fMaxDelta;
+}
+
+float DAFFComparator::getErrorEnergy(int iRecordIndex, int iChannel) const
+{
+	if (!m_pOutputContent)
+		return 0;
+
+	int iRecords = m_pReference->getProperties()->getNumberOfRecords();
+	int iChannels = m_pReference->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert((iChannel >= 0) && (iChannel < iChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords) || (iChannel < 0) || (iChannel >= iChannels))
+		return 0;
+
+	return m_vfErrorEnergies[(size_t)iRecordIndex * iChannels + iChannel];
+}
+
+float DAFFComparator::getOverallErrorEnergy() const
+{
+	return m_fOverallErrorEnergy;
+}
+
+const float* DAFFComparator::getDataPtr(int iRecordIndex, int iChannel) const
+{
+	if (!m_pOutputContent)
+		return NULL;
+
+	int iRecords = m_pReference->getProperties()->getNumberOfRecords();
+	int iChannels = m_pReference->getProperties()->getNumberOfChannels();
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords) || (iChannel < 0) || (iChannel >= iChannels))
+		return NULL;
+
+	return m_pfBuf + ((size_t)iRecordIndex * iChannels + iChannel) * m_iStride;
+}
+
+int DAFFComparator::getData(int iRecordIndex, int iChannel, float* pfDest, float fGain, bool bAdd) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getDataPtr(iRecordIndex, iChannel);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	if (bAdd) {
+		for (int i = 0; i < m_iLength; i++)
+			pfDest[i] += pfData[i] * fGain;
+	} else {
+		for (int i = 0; i < m_iLength; i++)
+			pfDest[i] = pfData[i] * fGain;
+	}
+	return DAFF_NO_ERROR;
+}
+
+int DAFFComparator::getValue(int iRecordIndex, int iChannel, int iIndex, float& fValue) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getDataPtr(iRecordIndex, iChannel);
+	assert(pfData != NULL);
+	assert((iIndex >= 0) && (iIndex < m_iLength));
+	if (!pfData || (iIndex < 0) || (iIndex >= m_iLength))
+		return DAFF_INVALID_INDEX;
+
+	fValue = pfData[iIndex];
+	return DAFF_NO_ERROR;
+}
+
+int DAFFComparator::getRecord(int iRecordIndex, float** ppfChannelDest) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pReference->getProperties()->getNumberOfRecords();
+	int iChannels = m_pReference->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return DAFF_INVALID_INDEX;
+
+	assert(ppfChannelDest != 0);
+	for (int c = 0; c < iChannels; c++)
+		if (ppfChannelDest[c])
+			memcpy(ppfChannelDest[c], getDataPtr(iRecordIndex, c), m_iLength * sizeof(float));
+	return DAFF_NO_ERROR;
+}
+
+int DAFFComparator::getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pReference->getProperties()->getNumberOfRecords();
+	int iChannels = m_pReference->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert(iStride >= iChannels);
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return DAFF_INVALID_INDEX;
+	if (iStride < iChannels)
+		return DAFF_MODAL_ERROR;
+
+	assert(pfDest != 0);
+	for (int c = 0; c < iChannels; c++) {
+		const float* pfData = getDataPtr(iRecordIndex, c);
+		for (int i = 0; i < m_iLength; i++)
+			pfDest[i * iStride + c] = pfData[i];
+	}
+	return DAFF_NO_ERROR;
+}
+
+int DAFFComparator::getSlice(int iChannel, int iIndex, float* pfDest) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pReference->getProperties()->getNumberOfRecords();
+	int iChannels = m_pReference->getProperties()->getNumberOfChannels();
+
+	assert((iChannel >= 0) && (iChannel < iChannels));
+	assert((iIndex >= 0) && (iIndex < m_iLength));
+
+	if ((iChannel < 0) || (iChannel >= iChannels) || (iIndex < 0) || (iIndex >= m_iLength))
+		return DAFF_INVALID_INDEX;
+
+	assert(pfDest != 0);
+	for (int i = 0; i < iRecords; i++)
+		pfDest[i] = getDataPtr(i, iChannel)[iIndex];
+	return DAFF_NO_ERROR;
+}
+
+int DAFFComparator::getFilterEnvelope(int iRecordIndex, int iChannel, int iFirstSample, int iNumSamples,
+									  int iNumBins, float* pfMin, float* pfMax) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getDataPtr(iRecordIndex, iChannel);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	if ((iFirstSample < 0) || (iNumBins < 1) || (iNumBins > iNumSamples) || (iNumSamples > m_iLength - iFirstSample))
+		return DAFF_INVALID_INDEX;
+
+	for (int k = 0; k < iNumBins; k++) {
+		int iBegin = iFirstSample + (int)((int64_t)k * iNumSamples / iNumBins);
+		int iEnd = iFirstSample + (int)((int64_t)(k + 1) * iNumSamples / iNumBins);
+		pfMin[k] = pfMax[k] = pfData[iBegin];
+		DAFF::minmax_float(pfData + iBegin, iEnd - iBegin, pfMin[k], pfMax[k]);
+	}
+	return DAFF_NO_ERROR;
+}
+
+int DAFFComparator::getFixedPointFilterCoeffs(int iRecordIndex, int iChannel, int16_t* piDestQ15, int32_t* piDestQ31,
+											  float fGain, bool bAdd) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getDataPtr(iRecordIndex, iChannel);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	if ((piDestQ15 == NULL) && (piDestQ31 == NULL))
+		return DAFF_NO_ERROR;
+
+	DAFF::stc_float_to_fixed_point(piDestQ15, piDestQ31, pfData, m_iLength, fGain, bAdd);
+	return DAFF_NO_ERROR;
+}
+
+float DAFFComparator::getChannelPeak(int iChannel) const
+{
+	if ((iChannel < 0) || (iChannel >= (int)m_vfChannelPeaks.size()))
+		return 0;
+	return m_vfChannelPeaks[iChannel];
+}
+
+float DAFFComparator::getRecordPeak(int iRecordIndex, int iChannel) const
+{
+	if (!getDataPtr(iRecordIndex, iChannel))
+		return 0;
+
+	int iChannels = m_pReference->getProperties()->getNumberOfChannels();
+	return m_vfPeaks[(size_t)iRecordIndex * iChannels + iChannel];
+}
+
+int DAFFComparator::getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getDataPtr(iRecordIndex, iChannel);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	// Same definitions as for stored impulse responses and magnitude spectra (the ratios are positive)
+	double dEnergy = DAFF::energy_float(pfData, m_iLength);
+	oStats.fPeak = getRecordPeak(iRecordIndex, iChannel);
+	oStats.fEnergy = (float)dEnergy;
+	oStats.fRMS = (float)std::sqrt(dEnergy / m_iLength);
+
+	oStats.iOnset = -1;
+	for (int i = 0; (i < m_iLength) && (oStats.fPeak > 0); i++) {
+		if (std::fabs(pfData[i]) >= 0.1f * oStats.fPeak) {
+			oStats.iOnset = i;
+			break;
+		}
+	}
+
+	return DAFF_NO_ERROR;
+}
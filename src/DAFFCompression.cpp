@@ -0,0 +1,365 @@
+#include "DAFFCompression.h"
+
+#include <algorithm>
+
+#include <stdint.h>
+
+//! Number of samples of a partition with an individual Rice parameter
+static const size_t DAFF_COMPRESSION_PARTITION_SIZE = 256;
+
+//! Rice parameter of a partition with verbatim samples
+static const int DAFF_COMPRESSION_ESCAPE = 63;
+
+//! Highest predictor order (like the fixed predictors of FLAC)
+static const int DAFF_COMPRESSION_MAX_ORDER = 4;
+
+//! Additional bits of the residuals of the highest order compared to the samples
+static const int DAFF_COMPRESSION_RESIDUAL_BITS = 5;
+
+//! Bit stream writer (most significant bit first)
+struct DAFFBitWriter {
+	std::vector<char>* pvcDest;  //!@ Destination
+	uint64_t ui64Bits;           //!@ Pending bits (lowest iNumBits bits)
+	int iNumBits;                //!@ Number of pending bits (less than 8 between calls)
+};
+
+//! Bit stream reader (most significant bit first)
+struct DAFFBitReader {
+	const unsigned char* pPos;  //!@ Next byte
+	const unsigned char* pEnd;  //!@ End of the bit stream
+	uint64_t ui64Bits;          //!@ Buffered bits (left-aligned)
+	int iNumBits;               //!@ Number of buffered bits
+};
+
+//! Appends up to 32 bits
+static inline void writeBits(DAFFBitWriter& w, uint64_t ui64Value, int iNumBits)
+{
+	w.ui64Bits = (w.ui64Bits << iNumBits) | (ui64Value & (((uint64_t)1 << iNumBits) - 1));
+	w.iNumBits += iNumBits;
+	while (w.iNumBits >= 8) {
+		w.iNumBits -= 8;
+		w.pvcDest->push_back((char)(w.ui64Bits >> w.iNumBits));
+	}
+	w.ui64Bits &= ((uint64_t)1 << w.iNumBits) - 1;
+}
+
+//! Appends a value in unary code (zeros terminated by a one)
+static inline void writeUnary(DAFFBitWriter& w, uint64_t ui64Value)
+{
+	while (ui64Value >= 32) {
+		writeBits(w, 0, 32);
+		ui64Value -= 32;
+	}
+	writeBits(w, 1, (int)ui64Value + 1);
+}
+
+//! Appends up to 62 bits
+static inline void writeLongBits(DAFFBitWriter& w, uint64_t ui64Value, int iNumBits)
+{
+	if (iNumBits > 32) {
+		writeBits(w, ui64Value >> 32, iNumBits - 32);
+		iNumBits = 32;
+	}
+	writeBits(w, ui64Value, iNumBits);
+}
+
+//! Writes the pending bits, padded with zeros to a whole byte
+static void flushBits(DAFFBitWriter& w)
+{
+	if (w.iNumBits > 0)
+		writeBits(w, 0, 8 - w.iNumBits);
+}
+
+//! Fills the bit buffer with whole bytes
+static inline void refillBits(DAFFBitReader& r)
+{
+	while ((r.iNumBits <= 56) && (r.pPos < r.pEnd)) {
+		r.ui64Bits |= (uint64_t)(*r.pPos++) << (56 - r.iNumBits);
+		r.iNumBits += 8;
+	}
+}
+
+//! Reads up to 32 bits (returns false at the end of the stream)
+static inline bool readBits(DAFFBitReader& r, int iNumBits, uint64_t& ui64Value)
+{
+	if (iNumBits == 0) {
+		ui64Value = 0;
+		return true;
+	}
+
+	if (r.iNumBits < iNumBits) {
+		refillBits(r);
+		if (r.iNumBits < iNumBits)
+			return false;
+	}
+
+	ui64Value = r.ui64Bits >> (64 - iNumBits);
+	r.ui64Bits <<= iNumBits;
+	r.iNumBits -= iNumBits;
+	return true;
+}
+
+//! Reads up to 62 bits (returns false at the end of the stream)
+static inline bool readLongBits(DAFFBitReader& r, int iNumBits, uint64_t& ui64Value)
+{
+	if (iNumBits <= 32)
+		return readBits(r, iNumBits, ui64Value);
+
+	uint64_t ui64Low;
+	if (!readBits(r, iNumBits - 32, ui64Value) || !readBits(r, 32, ui64Low))
+		return false;
+
+	ui64Value = (ui64Value << 32) | ui64Low;
+	return true;
+}
+
+//! Reads a value in unary code (returns false at the end of the stream)
+static inline bool readUnary(DAFFBitReader& r, uint64_t& ui64Value)
+{
+	ui64Value = 0;
+	for (;;) {
+		if (r.iNumBits == 0) {
+			refillBits(r);
+			if (r.iNumBits == 0)
+				return false;
+		}
+
+		// Count the leading zeros of the buffered bits
+		if (r.ui64Bits == 0) {
+			ui64Value += r.iNumBits;
+			r.iNumBits = 0;
+			continue;
+		}
+
+		// Bits behind the buffered ones are always zero, so the one is among them
+#if defined(__GNUC__) || defined(__clang__)
+		int iZeros = __builtin_clzll(r.ui64Bits);
+#else
+		int iZeros = 0;
+		while (!(r.ui64Bits & ((uint64_t)1 << (63 - iZeros))))
+			iZeros++;
+#endif
+
+		// Two shifts, a shift by 64 bits is undefined
+		ui64Value += iZeros;
+		r.ui64Bits = (r.ui64Bits << iZeros) << 1;
+		r.iNumBits -= iZeros + 1;
+		return true;
+	}
+}
+
+//! Reads a little-endian sample and extends its sign
+static inline int64_t loadSample(const unsigned char* p, int iSampleSize)
+{
+	uint64_t ui64Value = 0;
+	for (int i = 0; i < iSampleSize; i++)
+		ui64Value |= (uint64_t)p[i] << (8 * i);
+
+	int iShift = 64 - 8 * iSampleSize;
+	return (int64_t)(ui64Value << iShift) >> iShift;
+}
+
+//! Writes the lowest bytes of a sample in little endian
+static inline void storeSample(unsigned char* p, uint64_t ui64Value, int iSampleSize)
+{
+	for (int i = 0; i < iSampleSize; i++)
+		p[i] = (unsigned char)(ui64Value >> (8 * i));
+}
+
+//! Prediction of a sample from its predecessors (piPrev[0] is the previous sample)
+static inline int64_t predict(int iOrder, const int64_t* piPrev)
+{
+	switch (iOrder) {
+	case 1:
+		return piPrev[0];
+
+	case 2:
+		return 2 * piPrev[0] - piPrev[1];
+
+	case 3:
+		return 3 * piPrev[0] - 3 * piPrev[1] + piPrev[2];
+
+	case 4:
+		return 4 * piPrev[0] - 6 * piPrev[1] + 4 * piPrev[2] - piPrev[3];
+	}
+
+	return 0;
+}
+
+//! Shifts a sample into the history of predecessors
+static inline void pushSample(int64_t* piPrev, int64_t iSample)
+{
+	for (int i = DAFF_COMPRESSION_MAX_ORDER - 1; i > 0; i--)
+		piPrev[i] = piPrev[i - 1];
+	piPrev[0] = iSample;
+}
+
+//! Maps signed residuals onto unsigned values (0, -1, 1, -2, ...)
+static inline uint64_t zigzag(int64_t iValue)
+{
+	return ((uint64_t)iValue << 1) ^ (uint64_t)(iValue >> 63);
+}
+
+namespace DAFF {
+int compress_chunk(const void* pSrc, size_t nBytes, int iSampleSize, std::vector<char>& vcDest)
+{
+	const unsigned char* pData = (const unsigned char*)pSrc;
+	size_t nNumSamples = nBytes / iSampleSize;
+
+	vcDest.clear();
+	if (nNumSamples > 0) {
+		std::vector<int64_t> viSamples(nNumSamples);
+		for (size_t i = 0; i < nNumSamples; i++)
+			viSamples[i] = loadSample(pData + i * iSampleSize, iSampleSize);
+
+		// Predictor order with the smallest sum of absolute residuals (predecessors of the first samples are zero)
+		int iOrder = 0;
+		uint64_t ui64MinSum = 0;
+		for (int o = 0; o <= DAFF_COMPRESSION_MAX_ORDER; o++) {
+			int64_t piPrev[DAFF_COMPRESSION_MAX_ORDER] = { 0 };
+			uint64_t ui64Sum = 0;
+			for (size_t i = 0; i < nNumSamples; i++) {
+				ui64Sum += zigzag(viSamples[i] - predict(o, piPrev));
+				pushSample(piPrev, viSamples[i]);
+			}
+
+			if ((o == 0) || (ui64Sum < ui64MinSum)) {
+				iOrder = o;
+				ui64MinSum = ui64Sum;
+			}
+		}
+
+		std::vector<uint64_t> vui64Residuals(nNumSamples);
+		int64_t piPrev[DAFF_COMPRESSION_MAX_ORDER] = { 0 };
+		for (size_t i = 0; i < nNumSamples; i++) {
+			vui64Residuals[i] = zigzag(viSamples[i] - predict(iOrder, piPrev));
+			pushSample(piPrev, viSamples[i]);
+		}
+
+		vcDest.reserve(nBytes + 8);
+		vcDest.push_back((char)iOrder);
+
+		DAFFBitWriter w;
+		w.pvcDest = &vcDest;
+		w.ui64Bits = 0;
+		w.iNumBits = 0;
+
+		int iSampleBits = 8 * iSampleSize;
+		for (size_t nStart = 0; nStart < nNumSamples; nStart += DAFF_COMPRESSION_PARTITION_SIZE) {
+			size_t nEnd = std::min(nStart + DAFF_COMPRESSION_PARTITION_SIZE, nNumSamples);
+
+			// Rice parameter with the fewest bits
+			int iParam = DAFF_COMPRESSION_ESCAPE;
+			uint64_t ui64MinBits = (uint64_t)(nEnd - nStart) * iSampleBits;
+			for (int k = 0; k <= iSampleBits + DAFF_COMPRESSION_RESIDUAL_BITS; k++) {
+				uint64_t ui64Bits = (uint64_t)(nEnd - nStart) * (k + 1);
+				for (size_t i = nStart; (i < nEnd) && (ui64Bits < ui64MinBits); i++)
+					ui64Bits += vui64Residuals[i] >> k;
+
+				if (ui64Bits < ui64MinBits) {
+					iParam = k;
+					ui64MinBits = ui64Bits;
+				}
+			}
+
+			writeBits(w, iParam, 6);
+			if (iParam == DAFF_COMPRESSION_ESCAPE) {
+				for (size_t i = nStart; i < nEnd; i++)
+					writeBits(w, (uint64_t)viSamples[i], iSampleBits);
+			} else {
+				for (size_t i = nStart; i < nEnd; i++) {
+					writeUnary(w, vui64Residuals[i] >> iParam);
+					writeLongBits(w, vui64Residuals[i], iParam);
+				}
+			}
+
+			// Give up as soon as the chunk does not shrink
+			if (vcDest.size() >= nBytes)
+				break;
+		}
+
+		flushBits(w);
+	}
+
+	// Trailing bytes
+	vcDest.insert(vcDest.end(), (const char*)pData + nNumSamples * iSampleSize, (const char*)pData + nBytes);
+
+	if ((nNumSamples == 0) || (vcDest.size() >= nBytes)) {
+		vcDest.assign((const char*)pData, (const char*)pData + nBytes);
+		return COMPRESSION_METHOD_NONE;
+	}
+
+	return COMPRESSION_METHOD_PREDICTIVE;
+}
+
+int decompress_chunk(int iMethod, int iSampleSize, const void* pSrc, size_t nSrcBytes, void* pDest,
+					 size_t nDestBytes)
+{
+	if (iMethod == COMPRESSION_METHOD_NONE) {
+		if (nSrcBytes != nDestBytes)
+			return DAFF_FILE_CORRUPTED;
+
+		memcpy(pDest, pSrc, nDestBytes);
+		return DAFF_NO_ERROR;
+	}
+
+	if ((iMethod != COMPRESSION_METHOD_PREDICTIVE) || (iSampleSize < 2) || (iSampleSize > 4))
+		return DAFF_FILE_CORRUPTED;
+
+	const unsigned char* pSrcData = (const unsigned char*)pSrc;
+	unsigned char* pDestData = (unsigned char*)pDest;
+	size_t nNumSamples = nDestBytes / iSampleSize;
+	size_t nTailBytes = nDestBytes - nNumSamples * iSampleSize;
+
+	if (nSrcBytes < 1 + nTailBytes)
+		return DAFF_FILE_CORRUPTED;
+
+	int iOrder = pSrcData[0];
+	if (iOrder > DAFF_COMPRESSION_MAX_ORDER)
+		return DAFF_FILE_CORRUPTED;
+
+	DAFFBitReader r;
+	r.pPos = pSrcData + 1;
+	r.pEnd = pSrcData + nSrcBytes - nTailBytes;
+	r.ui64Bits = 0;
+	r.iNumBits = 0;
+
+	int iSampleBits = 8 * iSampleSize;
+	int64_t piPrev[DAFF_COMPRESSION_MAX_ORDER] = { 0 };
+	for (size_t nStart = 0; nStart < nNumSamples; nStart += DAFF_COMPRESSION_PARTITION_SIZE) {
+		size_t nEnd = std::min(nStart + DAFF_COMPRESSION_PARTITION_SIZE, nNumSamples);
+
+		uint64_t ui64Param;
+		if (!readBits(r, 6, ui64Param))
+			return DAFF_FILE_CORRUPTED;
+
+		int iParam = (int)ui64Param;
+		if ((iParam != DAFF_COMPRESSION_ESCAPE) && (iParam > iSampleBits + DAFF_COMPRESSION_RESIDUAL_BITS))
+			return DAFF_FILE_CORRUPTED;
+
+		for (size_t i = nStart; i < nEnd; i++) {
+			uint64_t ui64Value;
+			if (iParam == DAFF_COMPRESSION_ESCAPE) {
+				if (!readBits(r, iSampleBits, ui64Value))
+					return DAFF_FILE_CORRUPTED;
+			} else {
+				uint64_t ui64Quotient, ui64Remainder;
+				if (!readUnary(r, ui64Quotient) || !readLongBits(r, iParam, ui64Remainder))
+					return DAFF_FILE_CORRUPTED;
+
+				// Unsigned arithmetic, corrupted residuals wrap around instead of overflowing
+				uint64_t ui64Residual = (ui64Quotient << iParam) | ui64Remainder;
+				uint64_t ui64Signed = (ui64Residual >> 1) ^ (~(ui64Residual & 1) + 1);
+				ui64Value = ui64Signed + (uint64_t)predict(iOrder, piPrev);
+			}
+
+			storeSample(pDestData + i * iSampleSize, ui64Value, iSampleSize);
+			pushSample(piPrev, loadSample(pDestData + i * iSampleSize, iSampleSize));
+		}
+	}
+
+	memcpy(pDestData + nNumSamples * iSampleSize, pSrcData + nSrcBytes - nTailBytes, nTailBytes);
+
+	return DAFF_NO_ERROR;
+}
+}  // namespace DAFF
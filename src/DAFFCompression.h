@@ -0,0 +1,71 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_COMPRESSION
+#define IW_DAFF_COMPRESSION
+
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+#include <vector>
+
+/*
+ *  Lossless compression of the chunks of a compressed data block
+ *
+ *  A chunk holds the little-endian record data of a record channel. The predictive
+ *  method works like FLAC on the samples of the quantization (16-bit and 24-bit integers,
+ *  floats as their 32-bit patterns): a fixed polynomial predictor of order 0-4 is chosen
+ *  per chunk and the residuals are Rice coded in partitions with individual parameters.
+ *  Partitions that would grow are stored verbatim, chunks that would grow are not
+ *  compressed at all.
+ *
+ *  Layout of a predictive chunk:
+ *    - Predictor order (1 byte)
+ *    - Partitions of up to 256 samples (bit stream, most significant bit first):
+ *      Rice parameter (6 bits, 63: verbatim samples), then per sample the quotient in
+ *      unary (zeros terminated by a one) and the remainder, or the verbatim sample bits
+ *    - Trailing bytes that do not form a whole sample (verbatim)
+ */
+
+namespace DAFF {
+//! Chunk is stored uncompressed
+static const int COMPRESSION_METHOD_NONE = 0;
+
+//! Chunk is compressed with a fixed predictor and Rice coded residuals
+static const int COMPRESSION_METHOD_PREDICTIVE = 1;
+
+//! Compresses a chunk
+/**
+ * \param [in] pSrc			Little-endian chunk data
+ * \param [in] nBytes		Size of the chunk data [Bytes]
+ * \param [in] iSampleSize	Size of a sample (2, 3 or 4 Bytes)
+ * \param [out] vcDest		Compressed chunk (the chunk data itself for #COMPRESSION_METHOD_NONE)
+ *
+ * @return Compression method of the chunk
+ */
+int compress_chunk(const void* pSrc, size_t nBytes, int iSampleSize, std::vector<char>& vcDest);
+
+//! Decompresses a chunk
+/**
+ * \param [in] iMethod		Compression method of the chunk
+ * \param [in] iSampleSize	Size of a sample (2, 3 or 4 Bytes)
+ * \param [in] pSrc			Compressed chunk
+ * \param [in] nSrcBytes		Size of the compressed chunk [Bytes]
+ * \param [out] pDest		Little-endian chunk data
+ * \param [in] nDestBytes	Size of the chunk data [Bytes]
+ *
+ * @return #DAFF_NO_ERROR on success, #DAFF_FILE_CORRUPTED on invalid data
+ */
+int decompress_chunk(int iMethod, int iSampleSize, const void* pSrc, size_t nSrcBytes, void* pDest,
+					 size_t nDestBytes);
+}  // namespace DAFF
+
+#endif  // IW_DAFF_COMPRESSION
@@ -0,0 +1,227 @@
+// Use 64-bit off_t on 32-bit POSIX systems (must precede all system includes)
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include <DAFFContentCache.h>
+
+#include <DAFFReader.h>
+
+#include <climits>
+#include <condition_variable>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <system_error>
+#include <thread>
+
+#include "DAFFInstrumentationImpl.h"
+#include "DAFFNUMA.h"
+
+//! File identity and open flags
+struct DAFFContentCacheKey {
+	std::string sPath;  //!@ Canonical path
+	int64_t iModTime;   //!@ Modification time [s]
+	uint64_t ui64Size;  //!@ File size [Bytes]
+	int iOpenFlags;     //!@ Open flags
+	int iNode;          //!@ NUMA node of the replica (0 without replication)
+
+	bool operator<(const DAFFContentCacheKey& rhs) const
+	{
+		if (sPath != rhs.sPath)
+			return sPath < rhs.sPath;
+		if (iModTime != rhs.iModTime)
+			return iModTime < rhs.iModTime;
+		if (ui64Size != rhs.ui64Size)
+			return ui64Size < rhs.ui64Size;
+		if (iOpenFlags != rhs.iOpenFlags)
+			return iOpenFlags < rhs.iOpenFlags;
+		return iNode < rhs.iNode;
+	};
+};
+
+//! Shared reader of a file, or a file being loaded
+struct DAFFContentCacheEntry {
+	std::weak_ptr<const DAFFReader> pReader;  //!@ Shared reader (weak, readers are owned by their users)
+	bool bLoading;                            //!@ The file is being loaded by another thread
+
+	inline DAFFContentCacheEntry() : bLoading(false) {};
+};
+
+typedef std::map<DAFFContentCacheKey, DAFFContentCacheEntry> DAFFContentCacheMap;
+
+//! Load of a replica on a NUMA node
+struct DAFFContentCacheNodeLoad {
+	DAFFReader* pReader;        //!@ Reader to open
+	const std::string* psPath;  //!@ Canonical path
+	int iOpenFlags;             //!@ Open flags
+	int iNode;                  //!@ NUMA node
+	int iError;                 //!@ Result of the opening
+};
+
+//! Cache entries
+static DAFFContentCacheMap& getCacheMap()
+{
+	static DAFFContentCacheMap mEntries;
+	return mEntries;
+}
+
+//! Guards the cache entries
+static std::mutex& getCacheMutex()
+{
+	static std::mutex mx;
+	return mx;
+}
+
+//! Signals the completion of loads (guarded by the cache mutex)
+static std::condition_variable& getLoadCondition()
+{
+	static std::condition_variable cv;
+	return cv;
+}
+
+//! Removes the entries of readers that are not in use anymore
+static void purgeExpired(DAFFContentCacheMap& mEntries)
+{
+	for (DAFFContentCacheMap::iterator it = mEntries.begin(); it != mEntries.end();) {
+		if (!it->second.bLoading && it->second.pReader.expired())
+			mEntries.erase(it++);
+		else
+			++it;
+	}
+}
+
+//! Determines the identity of a file
+static int getFileKey(const std::string& sFilePath, int iOpenFlags, DAFFContentCacheKey& oKey)
+{
+#ifdef WIN32
+	char pszPath[_MAX_PATH];
+	if (_fullpath(pszPath, sFilePath.c_str(), _MAX_PATH) == NULL)
+		return DAFF_FILE_NOT_FOUND;
+
+	struct _stat64 statinfo;
+	if (_stat64(pszPath, &statinfo) != 0)
+		return DAFF_FILE_NOT_FOUND;
+#else
+	char pszPath[PATH_MAX];
+	if (realpath(sFilePath.c_str(), pszPath) == NULL)
+		return DAFF_FILE_NOT_FOUND;
+
+	struct stat statinfo;
+	if (stat(pszPath, &statinfo) != 0)
+		return DAFF_FILE_NOT_FOUND;
+#endif
+
+	oKey.sPath = pszPath;
+	oKey.iModTime = (int64_t)statinfo.st_mtime;
+	oKey.ui64Size = (uint64_t)statinfo.st_size;
+	oKey.iOpenFlags = iOpenFlags;
+	oKey.iNode = 0;
+
+	return DAFF_NO_ERROR;
+}
+
+//! Opens a replica in a thread bound to its node (memory is placed on the node of the first touch)
+static void runNodeLoad(DAFFContentCacheNodeLoad* pLoad)
+{
+	DAFFNUMA::bindCurrentThread(pLoad->iNode);
+	pLoad->iError = pLoad->pReader->openFile(*pLoad->psPath, pLoad->iOpenFlags);
+}
+
+//! Opens a reader, replicas are loaded on their node
+static int openReader(DAFFReader* pReader, const DAFFContentCacheKey& oKey, bool bReplicate)
+{
+	int iOpenFlags = oKey.iOpenFlags & ~DAFF_OPEN_NUMA;
+	if (!bReplicate)
+		return pReader->openFile(oKey.sPath, iOpenFlags);
+
+	DAFFContentCacheNodeLoad oLoad = { pReader, &oKey.sPath, iOpenFlags, oKey.iNode, DAFF_NO_ERROR };
+	try {
+		std::thread oWorker(runNodeLoad, &oLoad);
+		oWorker.join();
+	} catch (const std::system_error&) {
+		// No thread available, the calling thread runs on the node anyway
+		oLoad.iError = pReader->openFile(oKey.sPath, iOpenFlags);
+	}
+
+	return oLoad.iError;
+}
+
+int DAFFContentCache::open(const std::string& sFilePath, std::shared_ptr<const DAFFReader>& pReader, int iOpenFlags)
+{
+	pReader.reset();
+
+	DAFFContentCacheKey oKey;
+	// Replicas only make sense on several nodes and for data in private memory
+	bool bReplicate = ((iOpenFlags & DAFF_OPEN_NUMA) != 0) && !(iOpenFlags & DAFF_OPEN_MAPPED) &&
+					  (DAFFNUMA::getNumNodes() > 1);
+	if (!bReplicate)
+		iOpenFlags &= ~DAFF_OPEN_NUMA;
+
+	int iError = getFileKey(sFilePath, iOpenFlags, oKey);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	if (bReplicate)
+		oKey.iNode = DAFFNUMA::getCurrentNode();
+
+	std::unique_lock<std::mutex> lock(getCacheMutex());
+	DAFFContentCacheMap& mEntries = getCacheMap();
+
+	// Requests of a file that is being loaded wait for it
+	DAFFContentCacheMap::iterator it = mEntries.find(oKey);
+	while ((it != mEntries.end()) && it->second.bLoading) {
+		getLoadCondition().wait(lock);
+		it = mEntries.find(oKey);
+	}
+
+	if (it != mEntries.end()) {
+		pReader = it->second.pReader.lock();
+		if (pReader) {
+			DAFF_INSTRUMENT_COUNT(DAFF_COUNTER_CONTENT_CACHE_HITS, 1);
+			return DAFF_NO_ERROR;
+		}
+	}
+
+	DAFF_INSTRUMENT_COUNT(DAFF_COUNTER_CONTENT_CACHE_MISSES, 1);
+	purgeExpired(mEntries);
+
+	// Loaded without the lock, so that different files are loaded concurrently
+	mEntries[oKey].bLoading = true;
+	lock.unlock();
+
+	DAFFReader* pNewReader = DAFFReader::create();
+	iError = openReader(pNewReader, oKey, bReplicate);
+	if (iError != DAFF_NO_ERROR) {
+		delete pNewReader;
+		pNewReader = NULL;
+	}
+
+	lock.lock();
+	if (pNewReader) {
+		pReader = std::shared_ptr<const DAFFReader>(pNewReader);
+		mEntries[oKey].pReader = pReader;
+		mEntries[oKey].bLoading = false;
+	} else {
+		mEntries.erase(oKey);
+	}
+
+	getLoadCondition().notify_all();
+
+	return iError;
+}
+
+size_t DAFFContentCache::getNumReaders()
+{
+	std::lock_guard<std::mutex> lock(getCacheMutex());
+	DAFFContentCacheMap& mEntries = getCacheMap();
+	purgeExpired(mEntries);
+	return mEntries.size();
+}
+
+int DAFFContentCache::getNumNUMANodes()
+{
+	return DAFFNUMA::getNumNodes();
+}
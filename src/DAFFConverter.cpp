@@ -0,0 +1,600 @@
+#include <DAFFConverter.h>
+
+#include <DAFFContentDFT.h>
+#include <DAFFContentIR.h>
+#include <DAFFContentMPS.h>
+#include <DAFFContentMS.h>
+#include <DAFFContentPS.h>
+#include <DAFFProperties.h>
+#include <DAFFReader.h>
+#include <DAFFWriter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+//! Half width of the resampling kernel [zero crossings of the sinc]
+static const int DAFF_CONVERTER_RESAMPLING_HALF_WIDTH = 16;
+
+//! States of a slot in the ring of the pipeline
+enum {
+	DAFF_CONVERTER_SLOT_FREE = 0,  //!< Available for the reader
+	DAFF_CONVERTER_SLOT_READ,      //!< Read, waiting for or in transformation
+	DAFF_CONVERTER_SLOT_DONE,      //!< Transformed, waiting for the writer
+};
+
+//! Record in the pipeline
+struct DAFFConverterSlot {
+	int iState;                   //!@ One of DAFF_CONVERTER_SLOT_*
+	int iRecordIndex;             //!@ Record index
+	int iError;                   //!@ Error of reading the record
+	std::vector<float> vfInput;   //!@ Input data (channel after channel)
+	std::vector<float> vfOutput;  //!@ Output data (channel after channel)
+};
+
+//! Shared state of the pipeline stages
+struct DAFFConverterPipeline {
+	const DAFFConverter* pConverter;         //!@ Converter
+	const DAFFContent* pInputContent;        //!@ Input content
+	int iNumRecords;                         //!@ Number of records
+	std::vector<int> viRecordIndices;        //!@ Input record index, per output record
+	int iNumChannels;                        //!@ Number of channels
+	int iInputLength;                        //!@ Input floats per channel
+	int iOutputLength;                       //!@ Output floats per channel
+	std::vector<DAFFConverterSlot> vSlots;   //!@ Ring of slots (record index modulo size)
+	std::deque<int> qiPendingSlots;          //!@ Queue of read slots for the workers
+	bool bReaderFinished;                    //!@ All records have been read
+	bool bAbort;                             //!@ Stop all stages
+	std::mutex mxState;                      //!@ Guards the slot states, the queue and the flags
+	std::condition_variable cvStateChanged;  //!@ Signals changes of the slot states, the queue and the flags
+};
+
+//! Returns the number of floats per channel of a content (0 if not supported)
+static int getInputRecordDataLength(const DAFFContent* pContent)
+{
+	switch (pContent->getProperties()->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		return dynamic_cast<const DAFFContentIR*>(pContent)->getFilterLength();
+
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return dynamic_cast<const DAFFContentMS*>(pContent)->getNumFrequencies();
+
+	case DAFF_PHASE_SPECTRUM:
+		return dynamic_cast<const DAFFContentPS*>(pContent)->getNumFrequencies();
+
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		return 2 * dynamic_cast<const DAFFContentMPS*>(pContent)->getNumFrequencies();
+
+	case DAFF_DFT_SPECTRUM:
+		return 2 * dynamic_cast<const DAFFContentDFT*>(pContent)->getNumDFTCoeffs();
+	}
+
+	return 0;
+}
+
+//! Reads the data of a record channel in the layout of DAFFWriter (returns a #DAFF_ERROR)
+static int readChannel(const DAFFContent* pContent, int iRecordIndex, int iChannel, float* pfDest)
+{
+	switch (pContent->getProperties()->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		return dynamic_cast<const DAFFContentIR*>(pContent)->getFilterCoeffs(iRecordIndex, iChannel, pfDest);
+
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return dynamic_cast<const DAFFContentMS*>(pContent)->getMagnitudes(iRecordIndex, iChannel, pfDest);
+
+	case DAFF_PHASE_SPECTRUM:
+		return dynamic_cast<const DAFFContentPS*>(pContent)->getPhases(iRecordIndex, iChannel, pfDest);
+
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		return dynamic_cast<const DAFFContentMPS*>(pContent)->getCoefficientsRI(iRecordIndex, iChannel, pfDest);
+
+	case DAFF_DFT_SPECTRUM:
+		return dynamic_cast<const DAFFContentDFT*>(pContent)->getDFTCoeffs(iRecordIndex, iChannel, pfDest);
+	}
+
+	return DAFF_FILE_CONTENT_TYPE_UNKOWN;
+}
+
+//! Reads all channels of a record into a slot
+static void readSlot(DAFFConverterPipeline* pPipeline, DAFFConverterSlot& oSlot)
+{
+	oSlot.iError = DAFF_NO_ERROR;
+	for (int c = 0; (c < pPipeline->iNumChannels) && (oSlot.iError == DAFF_NO_ERROR); c++)
+		oSlot.iError = readChannel(pPipeline->pInputContent, oSlot.iRecordIndex, c,
+								   &oSlot.vfInput[(size_t)c * pPipeline->iInputLength]);
+}
+
+//! Transforms all channels of a slot
+static void processSlot(DAFFConverterPipeline* pPipeline, DAFFConverterSlot& oSlot)
+{
+	if (oSlot.iError != DAFF_NO_ERROR)
+		return;
+
+	for (int c = 0; c < pPipeline->iNumChannels; c++)
+		pPipeline->pConverter->processChannel(pPipeline->pInputContent,
+											  &oSlot.vfInput[(size_t)c * pPipeline->iInputLength],
+											  &oSlot.vfOutput[(size_t)c * pPipeline->iOutputLength]);
+}
+
+//! Reader stage: reads the records into free slots
+static void readerStage(DAFFConverterPipeline* pPipeline)
+{
+	for (int i = 0; i < pPipeline->iNumRecords; i++) {
+		DAFFConverterSlot& oSlot = pPipeline->vSlots[i % pPipeline->vSlots.size()];
+		{
+			std::unique_lock<std::mutex> lock(pPipeline->mxState);
+			while ((oSlot.iState != DAFF_CONVERTER_SLOT_FREE) && !pPipeline->bAbort)
+				pPipeline->cvStateChanged.wait(lock);
+			if (pPipeline->bAbort)
+				return;
+		}
+
+		// The slot is owned by this stage until it is queued
+		oSlot.iRecordIndex = pPipeline->viRecordIndices[i];
+		readSlot(pPipeline, oSlot);
+
+		std::lock_guard<std::mutex> lock(pPipeline->mxState);
+		oSlot.iState = DAFF_CONVERTER_SLOT_READ;
+		pPipeline->qiPendingSlots.push_back(i % (int)pPipeline->vSlots.size());
+		pPipeline->cvStateChanged.notify_all();
+	}
+
+	std::lock_guard<std::mutex> lock(pPipeline->mxState);
+	pPipeline->bReaderFinished = true;
+	pPipeline->cvStateChanged.notify_all();
+}
+
+//! Worker stage: transforms the queued slots
+static void workerStage(DAFFConverterPipeline* pPipeline)
+{
+	while (true) {
+		int iSlot;
+		{
+			std::unique_lock<std::mutex> lock(pPipeline->mxState);
+			while (pPipeline->qiPendingSlots.empty() && !pPipeline->bReaderFinished && !pPipeline->bAbort)
+				pPipeline->cvStateChanged.wait(lock);
+			if (pPipeline->qiPendingSlots.empty() || pPipeline->bAbort)
+				return;
+
+			iSlot = pPipeline->qiPendingSlots.front();
+			pPipeline->qiPendingSlots.pop_front();
+		}
+
+		processSlot(pPipeline, pPipeline->vSlots[iSlot]);
+
+		std::lock_guard<std::mutex> lock(pPipeline->mxState);
+		pPipeline->vSlots[iSlot].iState = DAFF_CONVERTER_SLOT_DONE;
+		pPipeline->cvStateChanged.notify_all();
+	}
+}
+
+//! Bandlimited resampling with a Blackman windowed sinc kernel
+/**
+ * \param [in] pfIn		Input samples
+ * \param [in] iInLength	Number of input samples
+ * \param [out] pfOut	Output samples
+ * \param [in] iOutLength	Number of output samples
+ * \param [in] dRatio	Output sampling rate divided by the input sampling rate
+ */
+static void resample(const float* pfIn, int iInLength, float* pfOut, int iOutLength, double dRatio)
+{
+	// Cutoff at the lower Nyquist frequency (relative to the input)
+	double dCutoff = std::min(dRatio, 1.0);
+	double dHalfWidth = DAFF_CONVERTER_RESAMPLING_HALF_WIDTH / dCutoff;
+	double dGain = dCutoff / dRatio;
+	const double dPi = 3.14159265358979323846;
+
+	for (int n = 0; n < iOutLength; n++) {
+		double dTime = n / dRatio;
+		int iFirst = std::max((int)ceil(dTime - dHalfWidth), 0);
+		int iLast = std::min((int)floor(dTime + dHalfWidth), iInLength - 1);
+
+		double dSum = 0;
+		for (int k = iFirst; k <= iLast; k++) {
+			double dX = (dTime - k) * dCutoff;
+			double dW = (dTime - k) / dHalfWidth;
+			double dSinc = (dX == 0 ? 1.0 : sin(dPi * dX) / (dPi * dX));
+			double dWindow = 0.42 + 0.5 * cos(dPi * dW) + 0.08 * cos(2 * dPi * dW);
+			dSum += pfIn[k] * dSinc * dWindow;
+		}
+
+		pfOut[n] = (float)(dSum * dGain);
+	}
+}
+
+DAFFConverter::DAFFConverter()
+	: m_iQuantization(-1), m_fSamplerate(0), m_iMaxFilterLength(0), m_fZeroThresholdDB(-HUGE_VALF),
+	  m_bCompression(false), m_iDataAlignment(16), m_bDeduplication(false), m_bStatistics(false),
+	  m_bDirectionIndex(false), m_bChecksums(false), m_iSymmetry(-1), m_iRecordOrder(-1),
+	  m_iNumThreads(0)
+{
+}
+
+DAFFConverter::~DAFFConverter() {}
+
+int DAFFConverter::getQuantization() const
+{
+	return m_iQuantization;
+}
+
+void DAFFConverter::setQuantization(int iQuantization)
+{
+	m_iQuantization = iQuantization;
+}
+
+float DAFFConverter::getSamplerate() const
+{
+	return m_fSamplerate;
+}
+
+void DAFFConverter::setSamplerate(float fSamplerate)
+{
+	m_fSamplerate = fSamplerate;
+}
+
+int DAFFConverter::getMaxFilterLength() const
+{
+	return m_iMaxFilterLength;
+}
+
+void DAFFConverter::setMaxFilterLength(int iMaxFilterLength)
+{
+	m_iMaxFilterLength = iMaxFilterLength;
+}
+
+float DAFFConverter::getZeroThreshold() const
+{
+	return m_fZeroThresholdDB;
+}
+
+void DAFFConverter::setZeroThreshold(float fThresholdDB)
+{
+	m_fZeroThresholdDB = fThresholdDB;
+}
+
+bool DAFFConverter::getCompression() const
+{
+	return m_bCompression;
+}
+
+void DAFFConverter::setCompression(bool bEnabled)
+{
+	m_bCompression = bEnabled;
+}
+
+int DAFFConverter::getDataAlignment() const
+{
+	return m_iDataAlignment;
+}
+
+void DAFFConverter::setDataAlignment(int iAlignment)
+{
+	m_iDataAlignment = iAlignment;
+}
+
+bool DAFFConverter::getDeduplication() const
+{
+	return m_bDeduplication;
+}
+
+void DAFFConverter::setDeduplication(bool bEnabled)
+{
+	m_bDeduplication = bEnabled;
+}
+
+bool DAFFConverter::getStatistics() const
+{
+	return m_bStatistics;
+}
+
+void DAFFConverter::setStatistics(bool bEnabled)
+{
+	m_bStatistics = bEnabled;
+}
+
+bool DAFFConverter::getDirectionIndex() const
+{
+	return m_bDirectionIndex;
+}
+
+void DAFFConverter::setDirectionIndex(bool bEnabled)
+{
+	m_bDirectionIndex = bEnabled;
+}
+
+bool DAFFConverter::getChecksums() const
+{
+	return m_bChecksums;
+}
+
+void DAFFConverter::setChecksums(bool bEnabled)
+{
+	m_bChecksums = bEnabled;
+}
+
+int DAFFConverter::getSymmetry() const
+{
+	return m_iSymmetry;
+}
+
+void DAFFConverter::setSymmetry(int iSymmetry)
+{
+	m_iSymmetry = iSymmetry;
+}
+
+int DAFFConverter::getRecordOrder() const
+{
+	return m_iRecordOrder;
+}
+
+void DAFFConverter::setRecordOrder(int iRecordOrder)
+{
+	m_iRecordOrder = iRecordOrder;
+}
+
+int DAFFConverter::getNumThreads() const
+{
+	return m_iNumThreads;
+}
+
+void DAFFConverter::setNumThreads(int iNumThreads)
+{
+	m_iNumThreads = iNumThreads;
+}
+
+int DAFFConverter::getOutputRecordDataLength(const DAFFContent* pInputContent) const
+{
+	int iLength = getInputRecordDataLength(pInputContent);
+	if (pInputContent->getProperties()->getContentType() != DAFF_IMPULSE_RESPONSE)
+		return iLength;
+
+	float fInputSamplerate = dynamic_cast<const DAFFContentIR*>(pInputContent)->getSamplerate();
+	if ((m_fSamplerate > 0) && (m_fSamplerate != fInputSamplerate) && (fInputSamplerate > 0))
+		iLength = (int)ceil((double)iLength * m_fSamplerate / fInputSamplerate);
+
+	if (m_iMaxFilterLength > 0)
+		iLength = std::min(iLength, m_iMaxFilterLength);
+
+	return iLength;
+}
+
+void DAFFConverter::processChannel(const DAFFContent* pInputContent, const float* pfInput, float* pfOutput) const
+{
+	int iInputLength = getInputRecordDataLength(pInputContent);
+	int iOutputLength = getOutputRecordDataLength(pInputContent);
+
+	if (pInputContent->getProperties()->getContentType() == DAFF_IMPULSE_RESPONSE) {
+		float fInputSamplerate = dynamic_cast<const DAFFContentIR*>(pInputContent)->getSamplerate();
+		if ((m_fSamplerate > 0) && (m_fSamplerate != fInputSamplerate) && (fInputSamplerate > 0)) {
+			resample(pfInput, iInputLength, pfOutput, iOutputLength, (double)m_fSamplerate / fInputSamplerate);
+			return;
+		}
+	}
+
+	// Spectra are copied, impulse responses trimmed to the output length
+	std::copy(pfInput, pfInput + std::min(iInputLength, iOutputLength), pfOutput);
+}
+
+int DAFFConverter::convert(const DAFFContent* pInputContent, const std::string& sOutputFilePath,
+						   const DAFFMetadata* pMetadata) const
+{
+	if (pInputContent == NULL)
+		return DAFF_MODAL_ERROR;
+
+	const DAFFProperties* pProps = pInputContent->getProperties();
+	int iContentType = pProps->getContentType();
+	int iOutputLength = getOutputRecordDataLength(pInputContent);
+
+	// Output content like the input
+	DAFFWriter oWriter;
+	switch (iContentType) {
+	case DAFF_IMPULSE_RESPONSE: {
+		const DAFFContentIR* pContentIR = dynamic_cast<const DAFFContentIR*>(pInputContent);
+		oWriter.setImpulseResponses(iOutputLength, (m_fSamplerate > 0 ? m_fSamplerate : pContentIR->getSamplerate()));
+		break;
+	}
+
+	case DAFF_MAGNITUDE_SPECTRUM:
+		oWriter.setMagnitudeSpectra(dynamic_cast<const DAFFContentMS*>(pInputContent)->getFrequencies());
+		break;
+
+	case DAFF_PHASE_SPECTRUM:
+		oWriter.setPhaseSpectra(dynamic_cast<const DAFFContentPS*>(pInputContent)->getFrequencies());
+		break;
+
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		oWriter.setMagnitudePhaseSpectra(dynamic_cast<const DAFFContentMPS*>(pInputContent)->getFrequencies());
+		break;
+
+	case DAFF_DFT_SPECTRUM: {
+		const DAFFContentDFT* pContentDFT = dynamic_cast<const DAFFContentDFT*>(pInputContent);
+		oWriter.setDFTSpectra(pContentDFT->getTransformSize(), pContentDFT->getSamplerate(),
+							  pContentDFT->isSymmetric());
+		break;
+	}
+
+	default:
+		return DAFF_FILE_CONTENT_TYPE_UNKOWN;
+	}
+
+	// Resampling and trimming only apply to impulse responses
+	if ((iContentType != DAFF_IMPULSE_RESPONSE) && ((m_fSamplerate > 0) || (m_iMaxFilterLength > 0)))
+		return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+
+	int iQuantization = m_iQuantization;
+	if (iQuantization < 0) {
+		// Integer quantizations are available for impulse responses only
+		iQuantization = pProps->getQuantization();
+		bool bInteger =
+			(iQuantization == DAFF_INT16) || (iQuantization == DAFF_INT24) || (iQuantization == DAFF_INT16_BFP);
+		if ((iContentType != DAFF_IMPULSE_RESPONSE) && bInteger)
+			iQuantization = DAFF_FLOAT32;
+	}
+
+	DAFFOrientationYPR oOrientation;
+	pProps->getDefaultOrientation(oOrientation);
+
+	oWriter.setQuantization(iQuantization);
+	oWriter.setNumChannels(pProps->getNumberOfChannels());
+	oWriter.setZeroThreshold(m_fZeroThresholdDB);
+	oWriter.setCompression(m_bCompression);
+	oWriter.setDataAlignment(m_iDataAlignment);
+	oWriter.setDeduplication(m_bDeduplication);
+	oWriter.setStatistics(m_bStatistics);
+	oWriter.setDirectionIndex(m_bDirectionIndex);
+	oWriter.setChecksums(m_bChecksums);
+	oWriter.setOrientation(oOrientation);
+	oWriter.setMetadata(pMetadata);
+
+	int iSymmetry = m_iSymmetry;
+	if (iSymmetry < 0)
+		iSymmetry = (pInputContent->getParent() ? pInputContent->getParent()->getSymmetry() : DAFF_SYMMETRY_NONE);
+	oWriter.setSymmetry(iSymmetry);
+
+	int iRecordOrder = m_iRecordOrder;
+	if (iRecordOrder < 0)
+		iRecordOrder =
+			(pInputContent->getParent() ? pInputContent->getParent()->getRecordOrder() : DAFF_RECORD_ORDER_INDEX);
+	oWriter.setRecordOrder(iRecordOrder);
+
+	int iNumRecords = pProps->getNumberOfRecords();
+	if (pProps->isRegularGrid()) {
+		oWriter.setGrid(pProps->getAlphaPoints(), pProps->getAlphaStart(), pProps->getAlphaEnd(),
+						pProps->getBetaPoints(), pProps->getBetaStart(), pProps->getBetaEnd());
+	} else {
+		std::vector<float> vfAlpha(iNumRecords), vfBeta(iNumRecords);
+		for (int i = 0; i < iNumRecords; i++)
+			pInputContent->getRecordCoords(i, DAFF_DATA_VIEW, vfAlpha[i], vfBeta[i]);
+		oWriter.setRecordDirections(vfAlpha, vfBeta);
+	}
+
+	// Symmetric outputs store the input records in the directions of the stored records only
+	std::vector<int> viRecordIndices(iNumRecords);
+	for (int i = 0; i < iNumRecords; i++)
+		viRecordIndices[i] = i;
+
+	if (iSymmetry != DAFF_SYMMETRY_NONE) {
+		viRecordIndices.resize(oWriter.getNumRecords());
+		for (size_t i = 0; i < viRecordIndices.size(); i++) {
+			float fAlpha, fBeta;
+			if (oWriter.getRecordCoords((int)i, fAlpha, fBeta) != DAFF_NO_ERROR)
+				return DAFF_FILE_INVALID_MAIN_PARAMETER;
+			pInputContent->getNearestNeighbour(DAFF_DATA_VIEW, fAlpha, fBeta, viRecordIndices[i]);
+		}
+		iNumRecords = (int)viRecordIndices.size();
+	} else if (oWriter.getNumRecords() != iNumRecords)
+		return DAFF_FILE_INVALID_MAIN_PARAMETER;
+
+	// The records are read in the order of appending (see DAFFWriter::getNextRecordIndex)
+	std::vector<int> viAppendOrder;
+	oWriter.getAppendOrder(viAppendOrder);
+	if ((int)viAppendOrder.size() == iNumRecords) {
+		std::vector<int> viOrderedIndices(iNumRecords);
+		for (int i = 0; i < iNumRecords; i++)
+			viOrderedIndices[i] = viRecordIndices[viAppendOrder[i]];
+		viRecordIndices.swap(viOrderedIndices);
+	}
+
+	int iError = oWriter.open(sOutputFilePath);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	// Pipeline with a ring of two slots per worker (and the reader and the writer)
+	int iNumThreads = m_iNumThreads;
+	if (iNumThreads <= 0)
+		iNumThreads = (int)std::max(std::thread::hardware_concurrency(), 1u);
+
+	DAFFConverterPipeline oPipeline;
+	oPipeline.pConverter = this;
+	oPipeline.pInputContent = pInputContent;
+	oPipeline.iNumRecords = iNumRecords;
+	oPipeline.viRecordIndices.swap(viRecordIndices);
+	oPipeline.iNumChannels = pProps->getNumberOfChannels();
+	oPipeline.iInputLength = getInputRecordDataLength(pInputContent);
+	oPipeline.iOutputLength = iOutputLength;
+	oPipeline.bReaderFinished = false;
+	oPipeline.bAbort = false;
+	oPipeline.vSlots.resize(iNumThreads > 1 ? 2 * iNumThreads + 2 : 1);
+	for (size_t i = 0; i < oPipeline.vSlots.size(); i++) {
+		oPipeline.vSlots[i].iState = DAFF_CONVERTER_SLOT_FREE;
+		oPipeline.vSlots[i].vfInput.resize((size_t)oPipeline.iNumChannels * oPipeline.iInputLength);
+		oPipeline.vSlots[i].vfOutput.resize((size_t)oPipeline.iNumChannels * iOutputLength);
+	}
+
+	std::vector<std::thread> vThreads;
+	if (iNumThreads > 1) {
+		try {
+			vThreads.push_back(std::thread(&readerStage, &oPipeline));
+			for (int i = 0; i < iNumThreads; i++)
+				vThreads.push_back(std::thread(&workerStage, &oPipeline));
+		} catch (const std::system_error&) {
+			// Not enough threads available, convert sequentially
+			{
+				std::lock_guard<std::mutex> lock(oPipeline.mxState);
+				oPipeline.bAbort = true;
+				oPipeline.cvStateChanged.notify_all();
+			}
+
+			for (size_t i = 0; i < vThreads.size(); i++)
+				vThreads[i].join();
+			vThreads.clear();
+		}
+	}
+
+	// Writer stage (calling thread), in the order of appending
+	std::vector<float*> vpfChannelData(oPipeline.iNumChannels);
+	for (int i = 0; (i < iNumRecords) && (iError == DAFF_NO_ERROR); i++) {
+		DAFFConverterSlot& oSlot = oPipeline.vSlots[i % oPipeline.vSlots.size()];
+		if (vThreads.empty()) {
+			oSlot.iRecordIndex = oPipeline.viRecordIndices[i];
+			readSlot(&oPipeline, oSlot);
+			processSlot(&oPipeline, oSlot);
+		} else {
+			std::unique_lock<std::mutex> lock(oPipeline.mxState);
+			while (oSlot.iState != DAFF_CONVERTER_SLOT_DONE)
+				oPipeline.cvStateChanged.wait(lock);
+		}
+
+		iError = oSlot.iError;
+		if (iError == DAFF_NO_ERROR) {
+			for (int c = 0; c < oPipeline.iNumChannels; c++)
+				vpfChannelData[c] = &oSlot.vfOutput[(size_t)c * iOutputLength];
+			iError = oWriter.appendRecord(&vpfChannelData[0], pInputContent->getRecordMetadata(oSlot.iRecordIndex));
+		}
+
+		std::lock_guard<std::mutex> lock(oPipeline.mxState);
+		oSlot.iState = DAFF_CONVERTER_SLOT_FREE;
+		oPipeline.cvStateChanged.notify_all();
+	}
+
+	if (!vThreads.empty()) {
+		{
+			std::lock_guard<std::mutex> lock(oPipeline.mxState);
+			oPipeline.bAbort = true;
+			oPipeline.cvStateChanged.notify_all();
+		}
+
+		for (size_t i = 0; i < vThreads.size(); i++)
+			vThreads[i].join();
+	}
+
+	// An incomplete file is removed by the writer
+	int iCloseError = oWriter.close();
+	return (iError != DAFF_NO_ERROR ? iError : iCloseError);
+}
+
+int DAFFConverter::convertFile(const std::string& sInputFilePath, const std::string& sOutputFilePath) const
+{
+	DAFFReader* pReader = DAFFReader::create();
+	int iError = pReader->openFile(sInputFilePath);
+	if (iError == DAFF_NO_ERROR)
+		iError = convert(pReader->getContent(), sOutputFilePath, pReader->getMetadata());
+
+	delete pReader;
+	return iError;
+}
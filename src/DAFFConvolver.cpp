@@ -0,0 +1,232 @@
+#include <DAFFConvolver.h>
+
+#include <DAFFContentIR.h>
+#include <DAFFProperties.h>
+#include <DAFFTransformerIR2Partitioned.h>
+
+#include <cassert>
+#include <cstring>
+
+#include "DAFFFFTPlanCache.h"
+#include "Utils.h"
+
+DAFFConvolver::DAFFConvolver(const DAFFTransformerIR2Partitioned* pFilters, int iNumSources)
+	: m_pFilters(pFilters), m_iNumSources(iNumSources), m_bCosine(false), m_iHead(0)
+{
+	assert(pFilters != NULL);
+	assert(iNumSources > 0);
+
+	const DAFFContentIR* pContent = pFilters->getInputContent();
+	m_iBlockLength = pFilters->getBlockLength();
+	m_iNumPartitions = pFilters->getNumPartitions();
+	m_iStride = pFilters->getPartitionStride();
+	m_iNumChannels = (pContent ? pContent->getProperties()->getNumberOfChannels() : 0);
+	m_iNumRecords = (pContent ? pContent->getProperties()->getNumberOfRecords() : 0);
+
+	m_piRequested = new std::atomic<int>[m_iNumSources];
+	m_piCurrent = new int[m_iNumSources];
+	for (int i = 0; i < m_iNumSources; i++) {
+		m_piRequested[i].store(-1);
+		m_piCurrent[i] = -1;
+	}
+
+	// All buffers are 16-byte aligned (B is not necessarily a multiple of four)
+	int iBlockStride = (m_iBlockLength + 3) / 4 * 4;
+	m_pfHistory = static_cast<float*>(DAFF::malloc_aligned16((size_t)m_iNumSources * iBlockStride * sizeof(float)));
+	m_pfDelayLines = static_cast<float*>(
+		DAFF::malloc_aligned16((size_t)m_iNumSources * m_iNumPartitions * m_iStride * sizeof(float)));
+	m_pfAccumulators =
+		static_cast<float*>(DAFF::malloc_aligned16(3 * (size_t)m_iNumChannels * m_iStride * sizeof(float)));
+	m_pfWindow = static_cast<float*>(DAFF::malloc_aligned16(2 * iBlockStride * sizeof(float)));
+	m_pfTime = static_cast<float*>(DAFF::malloc_aligned16(2 * iBlockStride * sizeof(float)));
+	m_pfCrossfade = static_cast<float*>(DAFF::malloc_aligned16(iBlockStride * sizeof(float)));
+	m_pForwardState = new DAFFFFTPlanState;
+	m_pInverseState = new DAFFFFTPlanState;
+
+	reset();
+
+	// Create the FFT plans here instead of in the audio thread
+	if ((m_iBlockLength > 0) && (m_iNumChannels > 0)) {
+		DAFFFFTPlanCache::execute(2 * m_iBlockLength, m_pfWindow, m_pfAccumulators, *m_pForwardState);
+		memset(m_pfAccumulators, 0, m_iStride * sizeof(float));
+		DAFFFFTPlanCache::executeInverse(2 * m_iBlockLength, m_pfAccumulators, m_pfTime, *m_pInverseState);
+	}
+}
+
+DAFFConvolver::~DAFFConvolver()
+{
+	delete[] m_piRequested;
+	delete[] m_piCurrent;
+	DAFF::free_aligned16(m_pfHistory);
+	DAFF::free_aligned16(m_pfDelayLines);
+	DAFF::free_aligned16(m_pfAccumulators);
+	DAFF::free_aligned16(m_pfWindow);
+	DAFF::free_aligned16(m_pfTime);
+	DAFF::free_aligned16(m_pfCrossfade);
+	delete m_pForwardState;
+	delete m_pInverseState;
+}
+
+const DAFFTransformerIR2Partitioned* DAFFConvolver::getFilters() const
+{
+	return m_pFilters;
+}
+
+int DAFFConvolver::getBlockLength() const
+{
+	return m_iBlockLength;
+}
+
+int DAFFConvolver::getNumPartitions() const
+{
+	return m_iNumPartitions;
+}
+
+int DAFFConvolver::getNumSources() const
+{
+	return m_iNumSources;
+}
+
+int DAFFConvolver::getNumChannels() const
+{
+	return m_iNumChannels;
+}
+
+bool DAFFConvolver::isCosineCrossfade() const
+{
+	return m_bCosine;
+}
+
+void DAFFConvolver::setCosineCrossfade(bool bCosine)
+{
+	m_bCosine = bCosine;
+}
+
+int DAFFConvolver::setSourceRecord(int iSource, int iRecordIndex)
+{
+	if ((iSource < 0) || (iSource >= m_iNumSources) || (iRecordIndex < -1) || (iRecordIndex >= m_iNumRecords))
+		return DAFF_INVALID_INDEX;
+
+	m_piRequested[iSource].store(iRecordIndex, std::memory_order_relaxed);
+	return DAFF_NO_ERROR;
+}
+
+int DAFFConvolver::setSourceDirection(int iSource, int iView, float fAngle1Deg, float fAngle2Deg)
+{
+	if ((iSource < 0) || (iSource >= m_iNumSources) || !m_pFilters->getInputContent())
+		return DAFF_INVALID_INDEX;
+
+	int iRecordIndex = -1;
+	m_pFilters->getInputContent()->getNearestNeighbour(iView, fAngle1Deg, fAngle2Deg, iRecordIndex);
+	return setSourceRecord(iSource, iRecordIndex);
+}
+
+int DAFFConvolver::getSourceRecord(int iSource) const
+{
+	if ((iSource < 0) || (iSource >= m_iNumSources))
+		return -1;
+
+	return m_piRequested[iSource].load(std::memory_order_relaxed);
+}
+
+void DAFFConvolver::reset()
+{
+	int iBlockStride = (m_iBlockLength + 3) / 4 * 4;
+	memset(m_pfHistory, 0, (size_t)m_iNumSources * iBlockStride * sizeof(float));
+	memset(m_pfDelayLines, 0, (size_t)m_iNumSources * m_iNumPartitions * m_iStride * sizeof(float));
+	m_iHead = 0;
+}
+
+void DAFFConvolver::accumulate(int iSource, int iRecordIndex, float* pfAccumulators) const
+{
+	int iNumDFTCoeffs = m_iBlockLength + 1;
+	const float* pfDelayLine = m_pfDelayLines + (size_t)iSource * m_iNumPartitions * m_iStride;
+
+	for (int c = 0; c < m_iNumChannels; c++) {
+		const float* pfPartitions = m_pFilters->getPartitionsPtr(iRecordIndex, c);
+		float* pfDest = pfAccumulators + (size_t)c * m_iStride;
+
+		// Partition p filters the input spectrum of p blocks ago
+		for (int p = 0; p < m_iNumPartitions; p++) {
+			int iSlot = (m_iHead - p + m_iNumPartitions) % m_iNumPartitions;
+			DAFF::cmac_float(pfDest, pfDelayLine + (size_t)iSlot * m_iStride, pfPartitions + (size_t)p * m_iStride,
+							 iNumDFTCoeffs);
+		}
+	}
+}
+
+const float* DAFFConvolver::inverse(float* pfSpectrum)
+{
+	DAFFFFTPlanCache::executeInverse(2 * m_iBlockLength, pfSpectrum, m_pfTime, *m_pInverseState);
+
+	// Overlap-save: the second half is free of circular aliasing
+	float* pfValid = m_pfTime + m_iBlockLength;
+	float fScale = 1.0f / (2 * m_iBlockLength);
+	for (int i = 0; i < m_iBlockLength; i++)
+		pfValid[i] *= fScale;
+	return pfValid;
+}
+
+int DAFFConvolver::process(const float* const* ppfInputs, float* const* ppfOutputs)
+{
+	if ((m_iNumChannels == 0) || (m_iNumPartitions == 0) || m_pFilters->isLazy() ||
+		(m_pFilters->getNumPartitions() != m_iNumPartitions) || !m_pFilters->getPartitionsPtr(0, 0))
+		return DAFF_MODAL_ERROR;
+
+	int B = m_iBlockLength;
+	int iBlockStride = (B + 3) / 4 * 4;
+	size_t nAccuSize = (size_t)m_iNumChannels * m_iStride;
+	float* pfStable = m_pfAccumulators;
+	float* pfOutgoing = m_pfAccumulators + nAccuSize;
+	float* pfIncoming = m_pfAccumulators + 2 * nAccuSize;
+
+	memset(m_pfAccumulators, 0, 3 * nAccuSize * sizeof(float));
+
+	// Advance the delay lines
+	m_iHead = (m_iHead + 1) % m_iNumPartitions;
+
+	bool bSwitch = false;
+	for (int s = 0; s < m_iNumSources; s++) {
+		// Overlap-save window of the previous and the current block
+		float* pfHistory = m_pfHistory + (size_t)s * iBlockStride;
+		memcpy(m_pfWindow, pfHistory, B * sizeof(float));
+		if (ppfInputs[s])
+			memcpy(pfHistory, ppfInputs[s], B * sizeof(float));
+		else
+			memset(pfHistory, 0, B * sizeof(float));
+		memcpy(m_pfWindow + B, pfHistory, B * sizeof(float));
+
+		float* pfSlot = m_pfDelayLines + ((size_t)s * m_iNumPartitions + m_iHead) * m_iStride;
+		DAFFFFTPlanCache::execute(2 * B, m_pfWindow, pfSlot, *m_pForwardState);
+
+		int iCurrent = m_piCurrent[s];
+		int iRequested = m_piRequested[s].load(std::memory_order_relaxed);
+		if (iRequested == iCurrent) {
+			if (iCurrent != -1)
+				accumulate(s, iCurrent, pfStable);
+			continue;
+		}
+
+		// Record switch: crossfade from the outgoing to the incoming filter
+		if (iCurrent != -1)
+			accumulate(s, iCurrent, pfOutgoing);
+		if (iRequested != -1)
+			accumulate(s, iRequested, pfIncoming);
+		m_piCurrent[s] = iRequested;
+		bSwitch = true;
+	}
+
+	for (int c = 0; c < m_iNumChannels; c++) {
+		memcpy(ppfOutputs[c], inverse(pfStable + (size_t)c * m_iStride), B * sizeof(float));
+		if (!bSwitch)
+			continue;
+
+		memcpy(m_pfCrossfade, inverse(pfOutgoing + (size_t)c * m_iStride), B * sizeof(float));
+		const float* pfIncomingOutput = inverse(pfIncoming + (size_t)c * m_iStride);
+		DAFF::crossfade_float(m_pfCrossfade, m_pfCrossfade, pfIncomingOutput, B, 0.0f, 1.0f / B, m_bCosine);
+		for (int i = 0; i < B; i++)
+			ppfOutputs[c][i] += m_pfCrossfade[i];
+	}
+
+	return DAFF_NO_ERROR;
+}
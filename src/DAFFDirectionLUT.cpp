@@ -0,0 +1,128 @@
+#include <DAFFDirectionLUT.h>
+
+#include <DAFFContent.h>
+#include <DAFFUtils.h>
+#include <DAFFView.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <memory>
+
+DAFFDirectionLUT::DAFFDirectionLUT(const DAFFContent* pContent, int iView, float fResolutionDeg)
+{
+	assert(pContent != NULL);
+	init(pContent, NULL, iView, fResolutionDeg);
+}
+
+DAFFDirectionLUT::DAFFDirectionLUT(const DAFFView* pView, float fResolutionDeg)
+{
+	assert(pView != NULL);
+	init(pView->getContent(), pView, DAFF_OBJECT_VIEW, fResolutionDeg);
+}
+
+int DAFFDirectionLUT::getView() const
+{
+	return m_iView;
+}
+
+void DAFFDirectionLUT::getResolution(float& fAngle1ResolutionDeg, float& fAngle2ResolutionDeg) const
+{
+	fAngle1ResolutionDeg = m_fResolution1;
+	fAngle2ResolutionDeg = m_fResolution2;
+}
+
+int DAFFDirectionLUT::lookup(float fAngle1Deg, float fAngle2Deg) const
+{
+	int iEntry = getEntry(fAngle1Deg, fAngle2Deg);
+	return (iEntry >= 0 ? iEntry : -iEntry - 1);
+}
+
+int DAFFDirectionLUT::lookup(float fAngle1Deg, float fAngle2Deg, bool& bOutOfBounds) const
+{
+	int iEntry = getEntry(fAngle1Deg, fAngle2Deg);
+	bOutOfBounds = (iEntry < 0);
+	return (iEntry >= 0 ? iEntry : -iEntry - 1);
+}
+
+void DAFFDirectionLUT::lookup(const float* pfAngles1Deg, const float* pfAngles2Deg, int* piRecordIndices,
+							  bool* pbOutOfBounds, size_t n) const
+{
+	for (size_t i = 0; i < n; i++) {
+		int iEntry = getEntry(pfAngles1Deg[i], pfAngles2Deg[i]);
+		piRecordIndices[i] = (iEntry >= 0 ? iEntry : -iEntry - 1);
+		if (pbOutOfBounds)
+			pbOutOfBounds[i] = (iEntry < 0);
+	}
+}
+
+void DAFFDirectionLUT::init(const DAFFContent* pContent, const DAFFView* pView, int iView, float fResolutionDeg)
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+	assert(fResolutionDeg > 0);
+
+	m_iView = iView;
+	if (m_iView == DAFF_DATA_VIEW) {
+		m_fOffset1 = 0.0f;
+		m_fOffset2 = 0.0f;
+	} else {
+		m_fOffset1 = 180.0f;
+		m_fOffset2 = 90.0f;
+	}
+
+	// Split the ranges evenly, at least one step per quadrant
+	if (!(fResolutionDeg > 0))
+		fResolutionDeg = 1.0f;
+	m_iNumPoints1 = std::max((int)std::ceil(360.0f / fResolutionDeg), 4);
+	m_iNumPoints2 = std::max((int)std::ceil(180.0f / fResolutionDeg), 2) + 1;
+	m_fResolution1 = 360.0f / m_iNumPoints1;
+	m_fResolution2 = 180.0f / (m_iNumPoints2 - 1);
+	m_fInvResolution1 = m_iNumPoints1 / 360.0f;
+	m_fInvResolution2 = (m_iNumPoints2 - 1) / 180.0f;
+
+	m_viTable.resize((size_t)m_iNumPoints1 * m_iNumPoints2);
+
+	// Nearest neighbours of all nodes, row by row with the batch search
+	std::vector<float> vfAngles1(m_iNumPoints1);
+	std::vector<float> vfAngles2(m_iNumPoints1);
+	std::unique_ptr<bool[]> pbRow(new bool[m_iNumPoints1]);
+	for (int i2 = 0; i2 < m_iNumPoints2; i2++) {
+		for (int i1 = 0; i1 < m_iNumPoints1; i1++) {
+			vfAngles1[i1] = i1 * m_fResolution1 - m_fOffset1;
+			vfAngles2[i1] = i2 * m_fResolution2 - m_fOffset2;
+		}
+
+		int* piRow = &m_viTable[(size_t)i2 * m_iNumPoints1];
+		if (pView)
+			pView->getNearestNeighbours(iView, &vfAngles1[0], &vfAngles2[0], piRow, pbRow.get(), m_iNumPoints1);
+		else
+			pContent->getNearestNeighbours(iView, &vfAngles1[0], &vfAngles2[0], piRow, pbRow.get(), m_iNumPoints1);
+
+		for (int i1 = 0; i1 < m_iNumPoints1; i1++)
+			if (pbRow[i1])
+				piRow[i1] = -piRow[i1] - 1;
+	}
+}
+
+int DAFFDirectionLUT::getEntry(float fAngle1Deg, float fAngle2Deg) const
+{
+	float f1 = fAngle1Deg + m_fOffset1;
+	float f2 = fAngle2Deg + m_fOffset2;
+
+	// Directions outside of the canonical ranges (rare) are normalized first
+	if (!((f1 >= 0.0f) && (f1 <= 360.0f) && (f2 >= 0.0f) && (f2 <= 180.0f))) {
+		DAFFUtils::NormalizeDirection(m_iView, fAngle1Deg, fAngle2Deg, fAngle1Deg, fAngle2Deg);
+		f1 = fmodf(fAngle1Deg + m_fOffset1, 360.0f);
+		if (f1 < 0.0f)
+			f1 += 360.0f;
+		f2 = std::min(std::max(fAngle2Deg + m_fOffset2, 0.0f), 180.0f);
+	}
+
+	// Closest node (the first angle wraps around at 360 degrees)
+	int i1 = (int)(f1 * m_fInvResolution1 + 0.5f);
+	if (i1 >= m_iNumPoints1)
+		i1 -= m_iNumPoints1;
+	int i2 = std::min((int)(f2 * m_fInvResolution2 + 0.5f), m_iNumPoints2 - 1);
+
+	return m_viTable[(size_t)i2 * m_iNumPoints1 + i1];
+}
@@ -0,0 +1,415 @@
+#include <DAFFDirectivityAnalyzer.h>
+
+#include <DAFFContent.h>
+#include <DAFFContentDFT.h>
+#include <DAFFContentMPS.h>
+#include <DAFFContentMS.h>
+#include <DAFFProperties.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <system_error>
+#include <thread>
+
+#include "Utils.h"
+
+//! Minimum number of values (records times frequencies) per thread of the automatic thread count
+static const uint64_t DAFF_ANALYZER_MIN_OPS_PER_THREAD = 1 << 18;
+
+//! Segments of the marching squares cases as pairs of cell edges (-1: end), saddles (5, 10) separately
+/**
+ * Corners: 0 = (alpha, beta), 1 = (alpha + 1, beta), 2 = (alpha + 1, beta + 1), 3 = (alpha, beta + 1),
+ * edge k runs from corner k to corner (k + 1) mod 4, bit k of the case is set if corner k reaches the level.
+ */
+static const int DAFF_MARCHING_SQUARES_EDGES[16][4] = {
+	{-1, -1, -1, -1}, {3, 0, -1, -1}, {0, 1, -1, -1}, {3, 1, -1, -1}, {1, 2, -1, -1}, {-1, -1, -1, -1},
+	{0, 2, -1, -1},   {3, 2, -1, -1}, {2, 3, -1, -1}, {0, 2, -1, -1}, {-1, -1, -1, -1}, {1, 2, -1, -1},
+	{1, 3, -1, -1},   {0, 1, -1, -1}, {0, 3, -1, -1}, {-1, -1, -1, -1},
+};
+
+//! Saddle segments if the corners 0 and 2 are connected through the cell (corners 1 and 3 separated)
+static const int DAFF_MARCHING_SQUARES_SADDLE_02[4] = {0, 1, 2, 3};
+
+//! Saddle segments if the corners 1 and 3 are connected through the cell (corners 0 and 2 separated)
+static const int DAFF_MARCHING_SQUARES_SADDLE_13[4] = {3, 0, 1, 2};
+
+//! Level of an energy [dB]
+static inline double energyToDB(float fEnergy)
+{
+	return 10.0 * std::log10(std::max(fEnergy, FLT_MIN));
+}
+
+//! Finds the first records with the greatest and the smallest energy, returns the magnitudes
+static void findExtrema(const float* pfEnergies, int iNumRecords, int& iMaxRecord, float& fMax, int& iMinRecord,
+						float& fMin)
+{
+	float fMinEnergy = FLT_MAX, fMaxEnergy = -FLT_MAX;
+	DAFF::minmax_float(pfEnergies, iNumRecords, fMinEnergy, fMaxEnergy);
+
+	iMaxRecord = (int)(std::find(pfEnergies, pfEnergies + iNumRecords, fMaxEnergy) - pfEnergies);
+	iMinRecord = (int)(std::find(pfEnergies, pfEnergies + iNumRecords, fMinEnergy) - pfEnergies);
+	fMax = std::sqrt(fMaxEnergy);
+	fMin = std::sqrt(fMinEnergy);
+}
+
+DAFFDirectivityAnalyzer::DAFFDirectivityAnalyzer(const DAFFContent* pContent)
+	: m_pContent(pContent), m_pContentMS(NULL), m_pContentMPS(NULL), m_pContentDFT(NULL), m_iNumThreads(0),
+	  m_iAlphaPoints(0), m_iBetaPoints(0), m_bAlphaWrap(false)
+{
+	assert(pContent != NULL);
+
+	const DAFFProperties* pProps = m_pContent->getProperties();
+	switch (pProps->getContentType()) {
+	case DAFF_MAGNITUDE_SPECTRUM:
+		m_pContentMS = dynamic_cast<const DAFFContentMS*>(m_pContent);
+		break;
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		m_pContentMPS = dynamic_cast<const DAFFContentMPS*>(m_pContent);
+		break;
+	case DAFF_DFT_SPECTRUM:
+		m_pContentDFT = dynamic_cast<const DAFFContentDFT*>(m_pContent);
+		break;
+	}
+
+	if (!pProps->isRegularGrid())
+		return;
+
+	// Record indices of the grid points, the points at the poles share the single pole records
+	m_iAlphaPoints = pProps->getAlphaPoints();
+	m_iBetaPoints = pProps->getBetaPoints();
+	m_bAlphaWrap = (m_iAlphaPoints > 1) && (m_iAlphaPoints * pProps->getAlphaResolution() >= 359.99f);
+	m_viGridRecords.resize((size_t)m_iAlphaPoints * m_iBetaPoints);
+	for (int b = 0; b < m_iBetaPoints; b++) {
+		float fBeta = pProps->getBetaStart() + b * pProps->getBetaResolution();
+		for (int a = 0; a < m_iAlphaPoints; a++) {
+			float fAlpha = pProps->getAlphaStart() + a * pProps->getAlphaResolution();
+			m_pContent->getNearestNeighbour(DAFF_DATA_VIEW, fAlpha, fBeta, m_viGridRecords[b * m_iAlphaPoints + a]);
+		}
+	}
+}
+
+DAFFDirectivityAnalyzer::~DAFFDirectivityAnalyzer() {}
+
+const DAFFContent* DAFFDirectivityAnalyzer::getContent() const
+{
+	return m_pContent;
+}
+
+int DAFFDirectivityAnalyzer::getDataLength() const
+{
+	if (m_pContentMS)
+		return m_pContentMS->getNumFrequencies();
+	if (m_pContentMPS)
+		return m_pContentMPS->getNumFrequencies();
+	if (m_pContentDFT)
+		return m_pContentDFT->getNumDFTCoeffs();
+	return 0;
+}
+
+int DAFFDirectivityAnalyzer::getNumThreads() const
+{
+	return m_iNumThreads;
+}
+
+void DAFFDirectivityAnalyzer::setNumThreads(int iNumThreads)
+{
+	m_iNumThreads = std::max(iNumThreads, 0);
+}
+
+int DAFFDirectivityAnalyzer::getEnergySlice(int iChannel, int iFreqIndex, float* pfEnergies, float* pfScratch) const
+{
+	int iNumRecords = m_pContent->getProperties()->getNumberOfRecords();
+
+	int iError;
+	if (m_pContentMS)
+		iError = m_pContentMS->getMagnitudeSlice(iChannel, iFreqIndex, pfScratch);
+	else if (m_pContentMPS)
+		iError = m_pContentMPS->getMagnitudeSlice(iChannel, iFreqIndex, pfScratch);
+	else
+		iError = m_pContentDFT->getDFTCoeffSlice(iChannel, iFreqIndex, pfScratch);
+
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	std::fill(pfEnergies, pfEnergies + iNumRecords, 0.0f);
+	if (m_pContentDFT)
+		DAFF::csqmac_float(pfEnergies, pfScratch, 1.0f, iNumRecords);
+	else
+		DAFF::sqmac_float(pfEnergies, pfScratch, 1.0f, iNumRecords);
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFDirectivityAnalyzer::getThreadCount(int iNumFreqs) const
+{
+	int iNumThreads = m_iNumThreads;
+	if (iNumThreads <= 0) {
+		uint64_t ui64NumOps = (uint64_t)m_pContent->getProperties()->getNumberOfRecords() * iNumFreqs;
+		uint64_t ui64MaxThreads = std::max(ui64NumOps / DAFF_ANALYZER_MIN_OPS_PER_THREAD, (uint64_t)1);
+		iNumThreads = (int)std::min((uint64_t)std::max(std::thread::hardware_concurrency(), 1u), ui64MaxThreads);
+	}
+	return std::max(std::min(iNumThreads, iNumFreqs), 1);
+}
+
+void DAFFDirectivityAnalyzer::scanExtrema(int iChannel, int iBegin, int iEnd, int* piMaxRecords, float* pfMaxValues,
+										  int* piMinRecords, float* pfMinValues, int* piError) const
+{
+	int iNumRecords = m_pContent->getProperties()->getNumberOfRecords();
+	std::vector<float> vfEnergies(iNumRecords);
+	std::vector<float> vfScratch(2 * iNumRecords);
+
+	for (int k = iBegin; k < iEnd; k++) {
+		int iError = getEnergySlice(iChannel, k, &vfEnergies[0], &vfScratch[0]);
+		if (iError != DAFF_NO_ERROR) {
+			*piError = iError;
+			return;
+		}
+
+		int iMaxRecord, iMinRecord;
+		float fMax, fMin;
+		findExtrema(&vfEnergies[0], iNumRecords, iMaxRecord, fMax, iMinRecord, fMin);
+		if (piMaxRecords)
+			piMaxRecords[k] = iMaxRecord;
+		if (pfMaxValues)
+			pfMaxValues[k] = fMax;
+		if (piMinRecords)
+			piMinRecords[k] = iMinRecord;
+		if (pfMinValues)
+			pfMinValues[k] = fMin;
+	}
+}
+
+int DAFFDirectivityAnalyzer::getExtremum(int iChannel, int iFreqIndex, int& iMaxRecord, float& fMax, int& iMinRecord,
+										 float& fMin) const
+{
+	int iLength = getDataLength();
+	if (iLength == 0)
+		return DAFF_MODAL_ERROR;
+
+	if ((iChannel < 0) || (iChannel >= m_pContent->getProperties()->getNumberOfChannels()))
+		return DAFF_INVALID_INDEX;
+
+	if ((iFreqIndex < 0) || (iFreqIndex >= iLength))
+		return DAFF_INVALID_INDEX;
+
+	int iNumRecords = m_pContent->getProperties()->getNumberOfRecords();
+	std::vector<float> vfEnergies(iNumRecords);
+	std::vector<float> vfScratch(2 * iNumRecords);
+	int iError = getEnergySlice(iChannel, iFreqIndex, &vfEnergies[0], &vfScratch[0]);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	findExtrema(&vfEnergies[0], iNumRecords, iMaxRecord, fMax, iMinRecord, fMin);
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFDirectivityAnalyzer::getExtrema(int iChannel, int* piMaxRecords, float* pfMaxValues, int* piMinRecords,
+										float* pfMinValues) const
+{
+	int iLength = getDataLength();
+	if (iLength == 0)
+		return DAFF_MODAL_ERROR;
+
+	if ((iChannel < 0) || (iChannel >= m_pContent->getProperties()->getNumberOfChannels()))
+		return DAFF_INVALID_INDEX;
+
+	if (!piMaxRecords && !pfMaxValues && !piMinRecords && !pfMinValues)
+		return DAFF_NO_ERROR;
+
+	// Distribute the frequencies over several threads, each scanning a range of slices
+	int iNumThreads = getThreadCount(iLength);
+	std::vector<int> viErrors(iNumThreads, DAFF_NO_ERROR);
+	std::vector<std::thread> vThreads;
+	int iChunk = (iLength + iNumThreads - 1) / iNumThreads;
+	for (int t = 1; t < iNumThreads; t++) {
+		int iBegin = t * iChunk;
+		int iEnd = std::min(iBegin + iChunk, iLength);
+		try {
+			vThreads.push_back(std::thread(&DAFFDirectivityAnalyzer::scanExtrema, this, iChannel, iBegin, iEnd,
+										   piMaxRecords, pfMaxValues, piMinRecords, pfMinValues, &viErrors[t]));
+		} catch (const std::system_error&) {
+			// No more threads available
+			scanExtrema(iChannel, iBegin, iEnd, piMaxRecords, pfMaxValues, piMinRecords, pfMinValues, &viErrors[t]);
+		}
+	}
+
+	scanExtrema(iChannel, 0, std::min(iChunk, iLength), piMaxRecords, pfMaxValues, piMinRecords, pfMinValues,
+				&viErrors[0]);
+
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	for (int t = 0; t < iNumThreads; t++)
+		if (viErrors[t] != DAFF_NO_ERROR)
+			return viErrors[t];
+
+	return DAFF_NO_ERROR;
+}
+
+void DAFFDirectivityAnalyzer::marchSquares(const float* pfEnergies, float fThresholdDB,
+										   std::vector<DAFFContourSegment>& vSegments) const
+{
+	const DAFFProperties* pProps = m_pContent->getProperties();
+	float fAlphaStart = pProps->getAlphaStart();
+	float fAlphaResolution = pProps->getAlphaResolution();
+	float fBetaStart = pProps->getBetaStart();
+	float fBetaResolution = pProps->getBetaResolution();
+
+	int iAlphaCells = (m_bAlphaWrap ? m_iAlphaPoints : m_iAlphaPoints - 1);
+	float fThreshold = (float)std::pow(10.0, fThresholdDB / 10.0);
+
+	for (int b = 0; b + 1 < m_iBetaPoints; b++) {
+		for (int a = 0; a < iAlphaCells; a++) {
+			int a1 = (a + 1) % m_iAlphaPoints;
+			const int piRecords[4] = {
+				m_viGridRecords[b * m_iAlphaPoints + a], m_viGridRecords[b * m_iAlphaPoints + a1],
+				m_viGridRecords[(b + 1) * m_iAlphaPoints + a1], m_viGridRecords[(b + 1) * m_iAlphaPoints + a]};
+
+			int iCase = 0;
+			for (int k = 0; k < 4; k++)
+				iCase |= (pfEnergies[piRecords[k]] >= fThreshold ? 1 << k : 0);
+			if ((iCase == 0) || (iCase == 15))
+				continue;
+
+			const int* piEdges = DAFF_MARCHING_SQUARES_EDGES[iCase];
+			if ((iCase == 5) || (iCase == 10)) {
+				float fMean = 0.25f * (pfEnergies[piRecords[0]] + pfEnergies[piRecords[1]] +
+									   pfEnergies[piRecords[2]] + pfEnergies[piRecords[3]]);
+				bool bCenter = (fMean >= fThreshold);
+				piEdges = ((iCase == 5) == bCenter ? DAFF_MARCHING_SQUARES_SADDLE_02 : DAFF_MARCHING_SQUARES_SADDLE_13);
+			}
+
+			// Grid coordinates of the corners (unwrapped)
+			float fAlpha0 = fAlphaStart + a * fAlphaResolution;
+			float fBeta0 = fBetaStart + b * fBetaResolution;
+			const float pfAlpha[4] = {fAlpha0, fAlpha0 + fAlphaResolution, fAlpha0 + fAlphaResolution, fAlpha0};
+			const float pfBeta[4] = {fBeta0, fBeta0, fBeta0 + fBetaResolution, fBeta0 + fBetaResolution};
+
+			for (int s = 0; (s < 4) && (piEdges[s] >= 0); s += 2) {
+				float pfPoint[4];
+				for (int p = 0; p < 2; p++) {
+					int k0 = piEdges[s + p];
+					int k1 = (k0 + 1) % 4;
+					double dLevel0 = energyToDB(pfEnergies[piRecords[k0]]);
+					double dLevel1 = energyToDB(pfEnergies[piRecords[k1]]);
+					double t = (dLevel1 != dLevel0 ? (fThresholdDB - dLevel0) / (dLevel1 - dLevel0) : 0.5);
+					t = std::min(std::max(t, 0.0), 1.0);
+					float fAlpha = (float)(pfAlpha[k0] + t * (pfAlpha[k1] - pfAlpha[k0]));
+					pfPoint[2 * p] = DAFF::anglef_proj_0_360_DEG(fAlpha);
+					pfPoint[2 * p + 1] = (float)(pfBeta[k0] + t * (pfBeta[k1] - pfBeta[k0]));
+				}
+
+				DAFFContourSegment oSegment;
+				oSegment.fAlpha1Deg = pfPoint[0];
+				oSegment.fBeta1Deg = pfPoint[1];
+				oSegment.fAlpha2Deg = pfPoint[2];
+				oSegment.fBeta2Deg = pfPoint[3];
+				vSegments.push_back(oSegment);
+			}
+		}
+	}
+}
+
+void DAFFDirectivityAnalyzer::scanContours(int iChannel, const int* piFreqIndices, int iBegin, int iEnd,
+										   float fLevelDB, bool bRelative,
+										   std::vector<std::vector<DAFFContourSegment> >* pvvSegments,
+										   int* piError) const
+{
+	int iNumRecords = m_pContent->getProperties()->getNumberOfRecords();
+	std::vector<float> vfEnergies(iNumRecords);
+	std::vector<float> vfScratch(2 * iNumRecords);
+
+	for (int i = iBegin; i < iEnd; i++) {
+		int iError = getEnergySlice(iChannel, piFreqIndices[i], &vfEnergies[0], &vfScratch[0]);
+		if (iError != DAFF_NO_ERROR) {
+			*piError = iError;
+			return;
+		}
+
+		float fThresholdDB = fLevelDB;
+		if (bRelative) {
+			float fMin = FLT_MAX, fMax = 0.0f;
+			DAFF::minmax_float(&vfEnergies[0], iNumRecords, fMin, fMax);
+			if (fMax <= 0.0f)
+				continue;  // No energy in any direction
+			fThresholdDB += (float)energyToDB(fMax);
+		}
+
+		marchSquares(&vfEnergies[0], fThresholdDB, (*pvvSegments)[i]);
+	}
+}
+
+int DAFFDirectivityAnalyzer::getContour(int iChannel, int iFreqIndex, float fLevelDB, bool bRelative,
+										std::vector<DAFFContourSegment>& vSegments) const
+{
+	std::vector<int> viOffsets;
+	return getContours(iChannel, &iFreqIndex, 1, fLevelDB, bRelative, vSegments, viOffsets);
+}
+
+int DAFFDirectivityAnalyzer::getContours(int iChannel, const int* piFreqIndices, int iNumFreqs, float fLevelDB,
+										 bool bRelative, std::vector<DAFFContourSegment>& vSegments,
+										 std::vector<int>& viOffsets) const
+{
+	vSegments.clear();
+	viOffsets.assign(1, 0);
+
+	int iLength = getDataLength();
+	if ((iLength == 0) || m_viGridRecords.empty())
+		return DAFF_MODAL_ERROR;
+
+	if ((iChannel < 0) || (iChannel >= m_pContent->getProperties()->getNumberOfChannels()))
+		return DAFF_INVALID_INDEX;
+
+	for (int i = 0; i < iNumFreqs; i++)
+		if ((piFreqIndices[i] < 0) || (piFreqIndices[i] >= iLength))
+			return DAFF_INVALID_INDEX;
+
+	if (iNumFreqs <= 0)
+		return DAFF_NO_ERROR;
+
+	// Distribute the frequencies over several threads, each collecting the contours of a range
+	int iNumThreads = getThreadCount(iNumFreqs);
+	std::vector<std::vector<DAFFContourSegment> > vvSegments(iNumFreqs);
+	std::vector<int> viErrors(iNumThreads, DAFF_NO_ERROR);
+	std::vector<std::thread> vThreads;
+	int iChunk = (iNumFreqs + iNumThreads - 1) / iNumThreads;
+	for (int t = 1; t < iNumThreads; t++) {
+		int iBegin = t * iChunk;
+		int iEnd = std::min(iBegin + iChunk, iNumFreqs);
+		try {
+			vThreads.push_back(std::thread(&DAFFDirectivityAnalyzer::scanContours, this, iChannel, piFreqIndices,
+										   iBegin, iEnd, fLevelDB, bRelative, &vvSegments, &viErrors[t]));
+		} catch (const std::system_error&) {
+			// No more threads available
+			scanContours(iChannel, piFreqIndices, iBegin, iEnd, fLevelDB, bRelative, &vvSegments, &viErrors[t]);
+		}
+	}
+
+	scanContours(iChannel, piFreqIndices, 0, std::min(iChunk, iNumFreqs), fLevelDB, bRelative, &vvSegments,
+				 &viErrors[0]);
+
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	for (int t = 0; t < iNumThreads; t++)
+		if (viErrors[t] != DAFF_NO_ERROR)
+			return viErrors[t];
+
+	viOffsets.resize(iNumFreqs + 1);
+	for (int i = 0; i < iNumFreqs; i++)
+		viOffsets[i + 1] = viOffsets[i] + (int)vvSegments[i].size();
+
+	vSegments.reserve(viOffsets[iNumFreqs]);
+	for (int i = 0; i < iNumFreqs; i++)
+		vSegments.insert(vSegments.end(), vvSegments[i].begin(), vvSegments[i].end());
+
+	return DAFF_NO_ERROR;
+}
+
+size_t DAFFDirectivityAnalyzer::getMemoryFootprint() const
+{
+	return m_viGridRecords.capacity() * sizeof(int);
+}
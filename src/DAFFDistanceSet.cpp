@@ -0,0 +1,278 @@
+#include <DAFFDistanceSet.h>
+
+#include <DAFFContent.h>
+#include <DAFFContentDFT.h>
+#include <DAFFContentIR.h>
+#include <DAFFContentMS.h>
+#include <DAFFProperties.h>
+
+#include <cassert>
+#include <cstring>
+
+//! Returns true if two orientations are equal
+static bool isSameOrientation(const DAFFOrientationYPR& a, const DAFFOrientationYPR& b)
+{
+	return (a.fYawAngleDeg == b.fYawAngleDeg) && (a.fPitchAngleDeg == b.fPitchAngleDeg) &&
+		   (a.fRollAngleDeg == b.fRollAngleDeg);
+}
+
+//! Merges coinciding records of a cell (poles, boundaries), so that every record is read once
+static void mergeRecords(int* piIndices, float* pfWeights)
+{
+	for (int i = 1; i < 4; i++)
+		for (int j = 0; j < i; j++)
+			if (piIndices[j] == piIndices[i]) {
+				pfWeights[j] += pfWeights[i];
+				pfWeights[i] = 0.0f;
+				break;
+			}
+}
+
+DAFFDistanceSet::DAFFDistanceSet() {}
+
+DAFFDistanceSet::~DAFFDistanceSet()
+{
+	clear();
+}
+
+int DAFFDistanceSet::addContent(const DAFFContent* pContent, float fRadius)
+{
+	if ((pContent == NULL) || !(fRadius > 0.0f))
+		return DAFF_MODAL_ERROR;
+
+	const DAFFProperties* pProps = pContent->getProperties();
+	if (!pProps->isRegularGrid())
+		return DAFF_MODAL_ERROR;
+
+	DistanceEntry oEntry;
+	oEntry.fRadius = fRadius;
+	oEntry.pContent = pContent;
+	oEntry.pContentIR = NULL;
+	oEntry.pContentMS = NULL;
+	oEntry.pContentDFT = NULL;
+	oEntry.iLookup = -1;
+
+	switch (pProps->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		oEntry.pContentIR = dynamic_cast<const DAFFContentIR*>(pContent);
+		break;
+	case DAFF_MAGNITUDE_SPECTRUM:
+		oEntry.pContentMS = dynamic_cast<const DAFFContentMS*>(pContent);
+		break;
+	case DAFF_DFT_SPECTRUM:
+		oEntry.pContentDFT = dynamic_cast<const DAFFContentDFT*>(pContent);
+		break;
+	default:
+		return DAFF_MODAL_ERROR;
+	}
+
+	// Same kind of data for all distances
+	if (!m_vDistances.empty()) {
+		const DAFFProperties* pFirstProps = m_vDistances[0].pContent->getProperties();
+		if ((pProps->getContentType() != pFirstProps->getContentType()) ||
+			(pProps->getNumberOfChannels() != pFirstProps->getNumberOfChannels()))
+			return DAFF_MODAL_ERROR;
+	}
+
+	DAFFInterpolator* pLookup = new DAFFInterpolator(pContent);
+	if (!m_vDistances.empty() && (pLookup->getDataLength() != getDataLength())) {
+		delete pLookup;
+		return DAFF_MODAL_ERROR;
+	}
+
+	// Ascending order of the radii
+	size_t iPos = 0;
+	while ((iPos < m_vDistances.size()) && (m_vDistances[iPos].fRadius < fRadius))
+		iPos++;
+	if ((iPos < m_vDistances.size()) && (m_vDistances[iPos].fRadius == fRadius)) {
+		delete pLookup;
+		return DAFF_MODAL_ERROR;
+	}
+
+	// Share the lookup with a content of the same grid
+	for (size_t i = 0; i < m_vDistances.size(); i++)
+		if (hasSameGrid(m_vDistances[i].pContent, pContent)) {
+			oEntry.iLookup = m_vDistances[i].iLookup;
+			break;
+		}
+
+	if (oEntry.iLookup == -1) {
+		oEntry.iLookup = (int)m_vpLookups.size();
+		m_vpLookups.push_back(pLookup);
+	} else {
+		delete pLookup;
+	}
+
+	m_vDistances.insert(m_vDistances.begin() + iPos, oEntry);
+
+	return DAFF_NO_ERROR;
+}
+
+void DAFFDistanceSet::clear()
+{
+	for (size_t i = 0; i < m_vpLookups.size(); i++)
+		delete m_vpLookups[i];
+	m_vpLookups.clear();
+	m_vDistances.clear();
+}
+
+int DAFFDistanceSet::getNumDistances() const
+{
+	return (int)m_vDistances.size();
+}
+
+float DAFFDistanceSet::getRadius(int iDistance) const
+{
+	if ((iDistance < 0) || (iDistance >= (int)m_vDistances.size()))
+		return 0.0f;
+
+	return m_vDistances[iDistance].fRadius;
+}
+
+const DAFFContent* DAFFDistanceSet::getContent(int iDistance) const
+{
+	if ((iDistance < 0) || (iDistance >= (int)m_vDistances.size()))
+		return NULL;
+
+	return m_vDistances[iDistance].pContent;
+}
+
+int DAFFDistanceSet::getDataLength() const
+{
+	if (m_vpLookups.empty())
+		return 0;
+
+	return m_vpLookups[0]->getDataLength();
+}
+
+int DAFFDistanceSet::getWeights(int iView, float fAngle1Deg, float fAngle2Deg, float fDistance, int* piDistances,
+								DAFFQuad* pqIndices, float* pfWeights) const
+{
+	assert(piDistances != NULL);
+	assert(pqIndices != NULL);
+	assert(pfWeights != NULL);
+
+	if (m_vDistances.empty())
+		return DAFF_MODAL_ERROR;
+
+	// Enclosing radii and the radial fraction, clamped to the range of the set
+	int iLast = (int)m_vDistances.size() - 1;
+	int iLower = 0, iUpper = 0;
+	float fFrac = 0.0f;
+	if (!(fDistance > m_vDistances[0].fRadius)) {
+		iLower = iUpper = 0;
+	} else if (fDistance >= m_vDistances[iLast].fRadius) {
+		iLower = iUpper = iLast;
+	} else {
+		iUpper = 1;
+		while (m_vDistances[iUpper].fRadius <= fDistance)
+			iUpper++;
+		iLower = iUpper - 1;
+		float fLowerRadius = m_vDistances[iLower].fRadius;
+		fFrac = (fDistance - fLowerRadius) / (m_vDistances[iUpper].fRadius - fLowerRadius);
+	}
+
+	piDistances[0] = iLower;
+	piDistances[1] = iUpper;
+
+	const DistanceEntry& oLower = m_vDistances[iLower];
+	const DistanceEntry& oUpper = m_vDistances[iUpper];
+
+	// Data spherical coordinates, transformed with the orientation of the respective content
+	// (the lookups of shared grids belong to the first content of the grid)
+	float fLowerAlpha = fAngle1Deg, fLowerBeta = fAngle2Deg;
+	if (iView == DAFF_OBJECT_VIEW)
+		oLower.pContent->transformAnglesO2D(fAngle1Deg, fAngle2Deg, fLowerAlpha, fLowerBeta);
+	else if (iView != DAFF_DATA_VIEW)
+		return DAFF_MODAL_ERROR;
+
+	int iError = m_vpLookups[oLower.iLookup]->getWeights(DAFF_DATA_VIEW, fLowerAlpha, fLowerBeta, pqIndices[0],
+														 pfWeights);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	// Shared angular lookup (the object view additionally requires the same orientation)
+	bool bShared = (iLower == iUpper) || (oLower.iLookup == oUpper.iLookup);
+	if (bShared && (iLower != iUpper) && (iView == DAFF_OBJECT_VIEW)) {
+		DAFFOrientationYPR oLowerOrient, oUpperOrient;
+		oLower.pContent->getProperties()->getOrientation(oLowerOrient);
+		oUpper.pContent->getProperties()->getOrientation(oUpperOrient);
+		bShared = isSameOrientation(oLowerOrient, oUpperOrient);
+	}
+
+	if (bShared) {
+		pqIndices[1] = pqIndices[0];
+		memcpy(pfWeights + 4, pfWeights, 4 * sizeof(float));
+	} else {
+		float fUpperAlpha = fAngle1Deg, fUpperBeta = fAngle2Deg;
+		if (iView == DAFF_OBJECT_VIEW)
+			oUpper.pContent->transformAnglesO2D(fAngle1Deg, fAngle2Deg, fUpperAlpha, fUpperBeta);
+
+		iError = m_vpLookups[oUpper.iLookup]->getWeights(DAFF_DATA_VIEW, fUpperAlpha, fUpperBeta, pqIndices[1],
+														 pfWeights + 4);
+		if (iError != DAFF_NO_ERROR)
+			return iError;
+	}
+
+	for (int i = 0; i < 4; i++) {
+		pfWeights[i] *= (1.0f - fFrac);
+		pfWeights[4 + i] *= fFrac;
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFDistanceSet::interpolate(int iView, float fAngle1Deg, float fAngle2Deg, float fDistance, int iChannel,
+								 float* pfDest) const
+{
+	int iLength = getDataLength();
+	if (iLength == 0)
+		return DAFF_MODAL_ERROR;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	int piDistances[2];
+	DAFFQuad pqIndices[2];
+	float pfWeights[8];
+	int iError = getWeights(iView, fAngle1Deg, fAngle2Deg, fDistance, piDistances, pqIndices, pfWeights);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	int piIndices[8] = { pqIndices[0].iIndex1, pqIndices[0].iIndex2, pqIndices[0].iIndex3, pqIndices[0].iIndex4,
+						 pqIndices[1].iIndex1, pqIndices[1].iIndex2, pqIndices[1].iIndex3, pqIndices[1].iIndex4 };
+	mergeRecords(piIndices, pfWeights);
+	mergeRecords(piIndices + 4, pfWeights + 4);
+
+	memset(pfDest, 0, iLength * sizeof(float));
+
+	// All records of both radii accumulate into the destination in one pass
+	for (int i = 0; i < 8; i++) {
+		if (pfWeights[i] == 0.0f)
+			continue;
+
+		const DistanceEntry& oEntry = m_vDistances[piDistances[i / 4]];
+		if (oEntry.pContentIR)
+			iError = oEntry.pContentIR->addFilterCoeffs(piIndices[i], iChannel, pfDest, pfWeights[i]);
+		else if (oEntry.pContentMS)
+			iError = oEntry.pContentMS->addMagnitudes(piIndices[i], iChannel, pfDest, pfWeights[i]);
+		else
+			iError = oEntry.pContentDFT->addDFTCoeffs(piIndices[i], iChannel, pfDest, pfWeights[i]);
+
+		if (iError != DAFF_NO_ERROR)
+			return iError;
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+bool DAFFDistanceSet::hasSameGrid(const DAFFContent* pContent1, const DAFFContent* pContent2)
+{
+	const DAFFProperties* p1 = pContent1->getProperties();
+	const DAFFProperties* p2 = pContent2->getProperties();
+
+	return (p1->getAlphaPoints() == p2->getAlphaPoints()) && (p1->getAlphaStart() == p2->getAlphaStart()) &&
+		   (p1->getAlphaEnd() == p2->getAlphaEnd()) && (p1->getBetaPoints() == p2->getBetaPoints()) &&
+		   (p1->getBetaStart() == p2->getBetaStart()) && (p1->getBetaEnd() == p2->getBetaEnd()) &&
+		   (p1->isRegularGrid() == p2->isRegularGrid());
+}
@@ -0,0 +1,247 @@
+#include "DAFFFFTPlanCache.h"
+
+#include <DAFFTransformerIR2DFT.h>
+
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <mutex>
+
+//! Properties of a real-to-complex or complex-to-real FFT plan
+struct DAFFFFTPlanKey {
+	int iSize;         //!@ Transform size (number of real samples)
+	int iHowMany;      //!@ Number of transforms (1: single transform)
+	int iInputDist;    //!@ Distance of the inputs of batched transforms [floats] (0: single transform)
+	int iOutputDist;   //!@ Distance of the outputs of batched transforms [floats] (0: single transform)
+	int iInputAlign;   //!@ Alignment of the input data (fftwf_alignment_of)
+	int iOutputAlign;  //!@ Alignment of the output data (fftwf_alignment_of)
+	unsigned uFlags;   //!@ Planner flags
+	bool bInverse;     //!@ Complex-to-real transform
+
+	bool operator<(const DAFFFFTPlanKey& rhs) const
+	{
+		if (iSize != rhs.iSize)
+			return iSize < rhs.iSize;
+		if (iHowMany != rhs.iHowMany)
+			return iHowMany < rhs.iHowMany;
+		if (iInputDist != rhs.iInputDist)
+			return iInputDist < rhs.iInputDist;
+		if (iOutputDist != rhs.iOutputDist)
+			return iOutputDist < rhs.iOutputDist;
+		if (iInputAlign != rhs.iInputAlign)
+			return iInputAlign < rhs.iInputAlign;
+		if (iOutputAlign != rhs.iOutputAlign)
+			return iOutputAlign < rhs.iOutputAlign;
+		if (uFlags != rhs.uFlags)
+			return uFlags < rhs.uFlags;
+		return bInverse < rhs.bInverse;
+	};
+};
+
+typedef std::map<DAFFFFTPlanKey, fftwf_plan> DAFFFFTPlanMap;
+
+//! Process-wide FFT plans and planner settings (guarded by the planner mutex)
+struct DAFFFFTPlans {
+	DAFFFFTPlanMap mPlans;  //!@ Plans
+	int iRigor;             //!@ Planning rigor of new plans
+
+	DAFFFFTPlans() : iRigor(DAFF_FFT_ESTIMATE) {};
+};
+
+static DAFFFFTPlans& getPlans()
+{
+	static DAFFFFTPlans oPlans;
+	return oPlans;
+}
+
+//! Serializes all calls of the FFTW planner (which is not thread-safe)
+static std::mutex& getPlannerMutex()
+{
+	static std::mutex mx;
+	return mx;
+}
+
+//! Generation of the cached plans, advanced by every clear (plans of older generations are destroyed)
+static std::atomic<unsigned>& getGeneration()
+{
+	static std::atomic<unsigned> uiGeneration(0);
+	return uiGeneration;
+}
+
+//! Indicates whether the plan of a state is cached for the alignment of the data
+static inline bool isPlanCurrent(const DAFFFFTPlanState& oState, float* pfIn, float* pfOut)
+{
+	return (fftwf_alignment_of(pfIn) == oState.iInputAlign) && (fftwf_alignment_of(pfOut) == oState.iOutputAlign) &&
+		   (oState.uiGeneration == getGeneration().load(std::memory_order_acquire));
+}
+
+static unsigned getPlannerFlags(int iRigor)
+{
+	switch (iRigor) {
+	case DAFF_FFT_MEASURE:
+		return FFTW_MEASURE;
+	case DAFF_FFT_PATIENT:
+		return FFTW_PATIENT;
+	default:
+		return FFTW_ESTIMATE;
+	}
+}
+
+//! Returns a cached plan (creates it if necessary)
+/**
+ * Batched plans (only complex-to-real) transform iHowMany arrays at the given distances [floats].
+ */
+static fftwf_plan getCachedPlan(int iSize, int iInputAlign, int iOutputAlign, bool bInverse, int iHowMany = 1,
+								int iInputDist = 0, int iOutputDist = 0)
+{
+	std::lock_guard<std::mutex> lock(getPlannerMutex());
+	DAFFFFTPlans& oPlans = getPlans();
+
+	DAFFFFTPlanKey oKey;
+	oKey.iSize = iSize;
+	oKey.iHowMany = iHowMany;
+	oKey.iInputDist = iInputDist;
+	oKey.iOutputDist = iOutputDist;
+	oKey.iInputAlign = iInputAlign;
+	oKey.iOutputAlign = iOutputAlign;
+	oKey.uFlags = getPlannerFlags(oPlans.iRigor);
+	oKey.bInverse = bInverse;
+
+	DAFFFFTPlanMap::iterator it = oPlans.mPlans.find(oKey);
+	if (it != oPlans.mPlans.end())
+		return it->second;
+
+	// Plans are created on scratch buffers (FFTW aligned) shifted by the alignment offsets
+	// of the actual data, because measuring planners overwrite the data
+	const size_t nPadding = 64;
+	size_t nRealBytes = ((size_t)(iHowMany - 1) * iOutputDist + iSize) * sizeof(float);
+	size_t nComplexBytes = ((size_t)(iHowMany - 1) * iInputDist / 2 + iSize / 2 + 1) * sizeof(fftwf_complex);
+	char* pcReal = static_cast<char*>(fftwf_malloc(nRealBytes + nPadding));
+	char* pcComplex = static_cast<char*>(fftwf_malloc(nComplexBytes + nPadding));
+
+	fftwf_plan oPlan;
+	if (iInputDist > 0)
+		oPlan = fftwf_plan_many_dft_c2r(1, &iSize, iHowMany, reinterpret_cast<fftwf_complex*>(pcComplex + iInputAlign),
+										NULL, 1, iInputDist / 2, reinterpret_cast<float*>(pcReal + iOutputAlign), NULL,
+										1, iOutputDist, oKey.uFlags);
+	else if (bInverse)
+		oPlan = fftwf_plan_dft_c2r_1d(iSize, reinterpret_cast<fftwf_complex*>(pcComplex + iInputAlign),
+									  reinterpret_cast<float*>(pcReal + iOutputAlign), oKey.uFlags);
+	else
+		oPlan = fftwf_plan_dft_r2c_1d(iSize, reinterpret_cast<float*>(pcReal + iInputAlign),
+									  reinterpret_cast<fftwf_complex*>(pcComplex + iOutputAlign), oKey.uFlags);
+
+	fftwf_free(pcReal);
+	fftwf_free(pcComplex);
+
+	oPlans.mPlans[oKey] = oPlan;
+	return oPlan;
+}
+
+fftwf_plan DAFFFFTPlanCache::getPlan(int iSize, float* pfIn, fftwf_complex* pOut)
+{
+	return getCachedPlan(iSize, fftwf_alignment_of(pfIn), fftwf_alignment_of(reinterpret_cast<float*>(pOut)), false);
+}
+
+fftwf_plan DAFFFFTPlanCache::getInversePlan(int iSize, fftwf_complex* pIn, float* pfOut)
+{
+	return getCachedPlan(iSize, fftwf_alignment_of(reinterpret_cast<float*>(pIn)), fftwf_alignment_of(pfOut), true);
+}
+
+void DAFFFFTPlanCache::execute(int iSize, float* pfIn, float* pfOut, DAFFFFTPlanState& oState)
+{
+	fftwf_complex* pOut = reinterpret_cast<fftwf_complex*>(pfOut);
+	if (!isPlanCurrent(oState, pfIn, pfOut)) {
+		oState.uiGeneration = getGeneration().load(std::memory_order_acquire);
+		oState.oPlan = getPlan(iSize, pfIn, pOut);
+		oState.iInputAlign = fftwf_alignment_of(pfIn);
+		oState.iOutputAlign = fftwf_alignment_of(pfOut);
+	}
+	fftwf_execute_dft_r2c(oState.oPlan, pfIn, pOut);
+}
+
+void DAFFFFTPlanCache::executeInverse(int iSize, float* pfIn, float* pfOut, DAFFFFTPlanState& oState)
+{
+	fftwf_complex* pIn = reinterpret_cast<fftwf_complex*>(pfIn);
+	if (!isPlanCurrent(oState, pfIn, pfOut)) {
+		oState.uiGeneration = getGeneration().load(std::memory_order_acquire);
+		oState.oPlan = getInversePlan(iSize, pIn, pfOut);
+		oState.iInputAlign = fftwf_alignment_of(pfIn);
+		oState.iOutputAlign = fftwf_alignment_of(pfOut);
+	}
+	fftwf_execute_dft_c2r(oState.oPlan, pIn, pfOut);
+}
+
+void DAFFFFTPlanCache::executeInverseBatch(int iSize, int iHowMany, float* pfIn, int iInputDist, float* pfOut,
+										   int iOutputDist, DAFFFFTPlanState& oState)
+{
+	if (!isPlanCurrent(oState, pfIn, pfOut) || (iHowMany != oState.iHowMany)) {
+		oState.uiGeneration = getGeneration().load(std::memory_order_acquire);
+		oState.oPlan = getCachedPlan(iSize, fftwf_alignment_of(pfIn), fftwf_alignment_of(pfOut), true, iHowMany,
+									 iInputDist, iOutputDist);
+		oState.iInputAlign = fftwf_alignment_of(pfIn);
+		oState.iOutputAlign = fftwf_alignment_of(pfOut);
+		oState.iHowMany = iHowMany;
+	}
+
+	// New-array execution is valid for batched plans as well (same distances and alignment)
+	fftwf_execute_dft_c2r(oState.oPlan, reinterpret_cast<fftwf_complex*>(pfIn), pfOut);
+}
+
+int DAFFFFTPlanCache::getRigor()
+{
+	std::lock_guard<std::mutex> lock(getPlannerMutex());
+	return getPlans().iRigor;
+}
+
+void DAFFFFTPlanCache::setRigor(int iRigor)
+{
+	std::lock_guard<std::mutex> lock(getPlannerMutex());
+	getPlans().iRigor = iRigor;
+}
+
+void DAFFFFTPlanCache::clear()
+{
+	std::lock_guard<std::mutex> lock(getPlannerMutex());
+	DAFFFFTPlanMap& mPlans = getPlans().mPlans;
+	for (DAFFFFTPlanMap::iterator it = mPlans.begin(); it != mPlans.end(); ++it)
+		fftwf_destroy_plan(it->second);
+	mPlans.clear();
+	getGeneration().fetch_add(1, std::memory_order_release);
+}
+
+int DAFFFFTPlanCache::getNumPlans()
+{
+	std::lock_guard<std::mutex> lock(getPlannerMutex());
+	return (int)getPlans().mPlans.size();
+}
+
+int DAFFFFTPlanCache::importWisdom(const std::string& sFilePath)
+{
+	FILE* pFile = fopen(sFilePath.c_str(), "r");
+	if (pFile == NULL)
+		return DAFF_FILE_NOT_FOUND;
+
+	int iSuccess;
+	{
+		std::lock_guard<std::mutex> lock(getPlannerMutex());
+		iSuccess = fftwf_import_wisdom_from_file(pFile);
+	}
+	fclose(pFile);
+
+	return (iSuccess ? DAFF_NO_ERROR : DAFF_FILE_CORRUPTED);
+}
+
+int DAFFFFTPlanCache::exportWisdom(const std::string& sFilePath)
+{
+	FILE* pFile = fopen(sFilePath.c_str(), "w");
+	if (pFile == NULL)
+		return DAFF_FILE_NOT_FOUND;
+
+	{
+		std::lock_guard<std::mutex> lock(getPlannerMutex());
+		fftwf_export_wisdom_to_file(pFile);
+	}
+
+	return (fclose(pFile) == 0 ? DAFF_NO_ERROR : DAFF_FILE_NOT_FOUND);
+}
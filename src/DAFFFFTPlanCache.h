@@ -0,0 +1,105 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_FFTPLANCACHE
+#define IW_DAFF_FFTPLANCACHE
+
+#include <DAFFDefs.h>
+
+#include <string>
+
+#include <fftw3.h>
+
+//! Plan lookup state of a sequence of transformations of one size
+/**
+ * States may outlive a clear() of the cache (e.g. of a DAFFConvolver), their plan is
+ * then looked up again on the next execution.
+ */
+struct DAFFFFTPlanState {
+	fftwf_plan oPlan;       //!@ Plan for the current data alignment
+	int iInputAlign;        //!@ Input alignment of the plan (-1: none)
+	int iOutputAlign;       //!@ Output alignment of the plan (-1: none)
+	int iHowMany;           //!@ Number of transforms of a batched plan
+	unsigned uiGeneration;  //!@ Generation of the cache the plan was looked up in (see clear)
+
+	DAFFFFTPlanState() : oPlan(NULL), iInputAlign(-1), iOutputAlign(-1), iHowMany(0), uiGeneration(0) {};
+};
+
+//! Process-wide cache of real-to-complex and complex-to-real FFT plans
+/**
+ * Used by the transformers. A plan is created once per transform size, batch layout, memory
+ * alignment and planning rigor (see DAFFTransformerIR2DFT::setPlanningRigor) and
+ * reused by all threads. Calls of the FFTW planner are serialized, the execution
+ * of cached plans runs concurrently.
+ */
+class DAFFFFTPlanCache {
+  public:
+	//! Returns a cached plan for the given size and data alignment (creates it if necessary)
+	/**
+	 * The plan is executed with fftwf_execute_dft_r2c() on arrays that have the same
+	 * alignment as pfIn and pOut.
+	 */
+	static fftwf_plan getPlan(int iSize, float* pfIn, fftwf_complex* pOut);
+
+	//! Returns a cached inverse plan for the given size and data alignment (creates it if necessary)
+	/**
+	 * The plan is executed with fftwf_execute_dft_c2r() on arrays that have the same
+	 * alignment as pIn and pfOut.
+	 */
+	static fftwf_plan getInversePlan(int iSize, fftwf_complex* pIn, float* pfOut);
+
+	//! Transforms iSize real samples into iSize/2+1 interleaved complex coefficients
+	/**
+	 * The plan is looked up again only if the alignment of the data changes.
+	 */
+	static void execute(int iSize, float* pfIn, float* pfOut, DAFFFFTPlanState& oState);
+
+	//! Transforms iSize/2+1 interleaved complex coefficients into iSize real samples (not normalized)
+	/**
+	 * The input is overwritten. A state must not be shared with execute().
+	 */
+	static void executeInverse(int iSize, float* pfIn, float* pfOut, DAFFFFTPlanState& oState);
+
+	//! Transforms iHowMany spectra into iHowMany signals of iSize real samples with one batched plan (not normalized)
+	/**
+	 * Spectrum i starts at pfIn + i * iInputDist and holds iSize/2+1 interleaved complex coefficients,
+	 * signal i starts at pfOut + i * iOutputDist (distances in floats, iInputDist even). The inputs are
+	 * overwritten. The plan is looked up again only if the number of transforms or the alignment of
+	 * the data changes, the distances must stay the same. A state must not be shared with execute()
+	 * or executeInverse().
+	 */
+	static void executeInverseBatch(int iSize, int iHowMany, float* pfIn, int iInputDist, float* pfOut,
+									int iOutputDist, DAFFFFTPlanState& oState);
+
+	//! Returns the planning rigor of new plans
+	static int getRigor();
+
+	//! Sets the planning rigor of new plans
+	static void setRigor(int iRigor);
+
+	//! Destroys all plans
+	/**
+	 * Starts a new generation of the cache, so that plan states look up their plans again.
+	 * Must not be called while another thread executes a plan.
+	 */
+	static void clear();
+
+	//! Returns the number of plans
+	static int getNumPlans();
+
+	//! Imports FFTW wisdom from a file
+	static int importWisdom(const std::string& sFilePath);
+
+	//! Exports the FFTW wisdom to a file
+	static int exportWisdom(const std::string& sFilePath);
+};
+
+#endif  // IW_DAFF_FFTPLANCACHE
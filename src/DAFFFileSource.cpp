@@ -0,0 +1,246 @@
+// Use 64-bit off_t on 32-bit POSIX systems (must precede all system includes)
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include "DAFFFileSource.h"
+
+#include <vector>
+
+#ifndef WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+// Disable MSVC security warning for unsafe fopen
+#ifdef _MSC_VER
+#pragma warning(disable : 4996)
+#endif  // _MSC_VER
+
+#ifndef WIN32
+//! Largest gap between two ranges of a batch that is read along instead of starting a new read [Bytes]
+static const uint64_t DAFF_BATCH_MAX_GAP = 4096;
+
+//! Maximum number of buffers of a single preadv
+#ifdef IOV_MAX
+static const size_t DAFF_BATCH_MAX_IOVECS = (IOV_MAX < 1024) ? IOV_MAX : 1024;
+#else
+static const size_t DAFF_BATCH_MAX_IOVECS = 16;
+#endif
+#endif  // WIN32
+
+DAFFFileSource::DAFFFileSource()
+	:
+#ifdef WIN32
+	  m_file(NULL),
+#else
+	  m_iFD(-1),
+#endif
+	  m_ui64Size(0)
+{
+}
+
+DAFFFileSource::~DAFFFileSource()
+{
+	close();
+}
+
+int DAFFFileSource::open(const std::string& sFilePath)
+{
+	if (isOpened())
+		return DAFF_MODAL_ERROR;
+
+#ifdef WIN32
+	m_file = fopen(sFilePath.c_str(), "rb");
+	if (!m_file)
+		return DAFF_FILE_NOT_FOUND;
+
+	if (_fseeki64(m_file, 0, SEEK_END) != 0) {
+		close();
+		return DAFF_FILE_INVALID;
+	}
+
+	__int64 iSize = _ftelli64(m_file);
+	if (iSize < 0) {
+		close();
+		return DAFF_FILE_INVALID;
+	}
+
+	m_ui64Size = (uint64_t)iSize;
+#else
+	m_iFD = ::open(sFilePath.c_str(), O_RDONLY);
+	if (m_iFD < 0)
+		return DAFF_FILE_NOT_FOUND;
+
+	struct stat statinfo;
+	if ((fstat(m_iFD, &statinfo) != 0) || (statinfo.st_size < 0)) {
+		close();
+		return DAFF_FILE_INVALID;
+	}
+
+	m_ui64Size = (uint64_t)statinfo.st_size;
+#endif
+
+	return DAFF_NO_ERROR;
+}
+
+void DAFFFileSource::close()
+{
+#ifdef WIN32
+	if (m_file) {
+		fclose(m_file);
+		m_file = NULL;
+	}
+#else
+	if (m_iFD >= 0) {
+		::close(m_iFD);
+		m_iFD = -1;
+	}
+#endif
+
+	m_ui64Size = 0;
+}
+
+bool DAFFFileSource::isOpened() const
+{
+#ifdef WIN32
+	return (m_file != NULL);
+#else
+	return (m_iFD >= 0);
+#endif
+}
+
+uint64_t DAFFFileSource::getSize() const
+{
+	return m_ui64Size;
+}
+
+int DAFFFileSource::read(uint64_t ui64Offset, void* pDest, size_t nBytes)
+{
+	if (!isOpened())
+		return DAFF_MODAL_ERROR;
+
+	// Requested range must lie inside the file
+	if ((ui64Offset > m_ui64Size) || (nBytes > m_ui64Size - ui64Offset))
+		return DAFF_FILE_CORRUPTED;
+
+#ifdef WIN32
+	if (_fseeki64(m_file, (__int64)ui64Offset, SEEK_SET) != 0)
+		return DAFF_FILE_CORRUPTED;
+
+	if (fread(pDest, 1, nBytes, m_file) != nBytes)
+		return DAFF_FILE_CORRUPTED;
+#else
+	// pread may return less than requested, continue until done
+	char* p = (char*)pDest;
+	while (nBytes > 0) {
+		ssize_t n = pread(m_iFD, p, nBytes, (off_t)ui64Offset);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		if (n == 0)
+			return DAFF_FILE_CORRUPTED;  // Unexpected end of file
+
+		p += n;
+		nBytes -= (size_t)n;
+		ui64Offset += (uint64_t)n;
+	}
+#endif
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFFileSource::readBatch(const DAFFReadRequest* pRequests, size_t n)
+{
+	if (!isOpened())
+		return DAFF_MODAL_ERROR;
+
+	for (size_t i = 0; i < n; i++)
+		if ((pRequests[i].ui64Offset > m_ui64Size) || (pRequests[i].nBytes > m_ui64Size - pRequests[i].ui64Offset))
+			return DAFF_FILE_CORRUPTED;
+
+#ifdef WIN32
+	return DAFFDataSource::readBatch(pRequests, n);
+#else
+	// Runs of ranges that are read at once (index of the first range, ascending)
+	std::vector<size_t> vnRuns;
+	uint64_t ui64RunEnd = 0;
+	for (size_t i = 0; i < n; i++) {
+		bool bGap = vnRuns.empty() || (pRequests[i].ui64Offset < ui64RunEnd) ||
+					(pRequests[i].ui64Offset - ui64RunEnd > DAFF_BATCH_MAX_GAP);
+
+		// Gaps and ranges each take a buffer
+		if (bGap || (2 * (i - vnRuns.back()) + 1 > DAFF_BATCH_MAX_IOVECS))
+			vnRuns.push_back(i);
+		ui64RunEnd = pRequests[i].ui64Offset + pRequests[i].nBytes;
+	}
+	vnRuns.push_back(n);
+
+	// Several runs: All of them are requested ahead, so that the device works on them concurrently
+	if (vnRuns.size() > 2) {
+		for (size_t r = 0; r + 1 < vnRuns.size(); r++) {
+			const DAFFReadRequest& oLast = pRequests[vnRuns[r + 1] - 1];
+			uint64_t ui64Begin = pRequests[vnRuns[r]].ui64Offset;
+			posix_fadvise(m_iFD, (off_t)ui64Begin, (off_t)(oLast.ui64Offset + oLast.nBytes - ui64Begin),
+						  POSIX_FADV_WILLNEED);
+		}
+	}
+
+	char pcScratch[DAFF_BATCH_MAX_GAP];
+	for (size_t r = 0; r + 1 < vnRuns.size(); r++) {
+		int iError = readRun(pRequests, vnRuns[r], vnRuns[r + 1], pcScratch);
+		if (iError != DAFF_NO_ERROR)
+			return iError;
+	}
+
+	return DAFF_NO_ERROR;
+#endif
+}
+
+#ifndef WIN32
+int DAFFFileSource::readRun(const DAFFReadRequest* pRequests, size_t iBegin, size_t iEnd, char* pcScratch)
+{
+	if (iEnd - iBegin == 1)
+		return read(pRequests[iBegin].ui64Offset, pRequests[iBegin].pDest, pRequests[iBegin].nBytes);
+
+	struct iovec pIovecs[DAFF_BATCH_MAX_IOVECS];
+	int iNumIovecs = 0;
+	size_t nTotal = 0;
+	for (size_t i = iBegin; i < iEnd; i++) {
+		if (i > iBegin) {
+			size_t nGap = (size_t)(pRequests[i].ui64Offset - pRequests[i - 1].ui64Offset - pRequests[i - 1].nBytes);
+			if (nGap > 0) {
+				pIovecs[iNumIovecs].iov_base = pcScratch;
+				pIovecs[iNumIovecs++].iov_len = nGap;
+				nTotal += nGap;
+			}
+		}
+		pIovecs[iNumIovecs].iov_base = pRequests[i].pDest;
+		pIovecs[iNumIovecs++].iov_len = pRequests[i].nBytes;
+		nTotal += pRequests[i].nBytes;
+	}
+
+	ssize_t n;
+	do {
+		n = preadv(m_iFD, pIovecs, iNumIovecs, (off_t)pRequests[iBegin].ui64Offset);
+	} while ((n < 0) && (errno == EINTR));
+
+	if ((n >= 0) && ((size_t)n == nTotal))
+		return DAFF_NO_ERROR;
+
+	// Short or failed read, the ranges are read one by one
+	for (size_t i = iBegin; i < iEnd; i++) {
+		int iError = read(pRequests[i].ui64Offset, pRequests[i].pDest, pRequests[i].nBytes);
+		if (iError != DAFF_NO_ERROR)
+			return iError;
+	}
+	return DAFF_NO_ERROR;
+}
+#endif
@@ -0,0 +1,83 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_FILESOURCE
+#define IW_DAFF_FILESOURCE
+
+#include <DAFFDataSource.h>
+#include <DAFFDefs.h>
+
+#include <cstdio>
+#include <cstring>  // required for size_t
+#include <string>
+
+//! Read-only file access with 64-bit offsets
+/**
+ * Positional reads use pread on POSIX systems (64-bit off_t) and
+ * _fseeki64 on Windows, so files beyond 2 GB (32-bit long) are supported.
+ *
+ * Batched reads on POSIX systems coalesce ranges that are adjacent or separated by
+ * small gaps into single preadv calls. Before, the system is advised to read all
+ * ranges of the batch ahead (posix_fadvise), which keeps several device reads in
+ * flight while the ranges are copied one after the other.
+ */
+class DAFFFileSource : public DAFFDataSource {
+  public:
+	DAFFFileSource();
+	~DAFFFileSource();
+
+	//! Opens the given file for reading
+	/**
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int open(const std::string& sFilePath);
+
+	//! Closes the file (if opened)
+	void close();
+
+	//! Returns whether a file is opened
+	bool isOpened() const;
+
+	//! Returns the file size [Bytes]
+	uint64_t getSize() const;
+
+	//! Reads bytes at an absolute file position
+	/**
+	 * @param ui64Offset  File position [Bytes]
+	 * @param pDest       Destination buffer
+	 * @param nBytes      Number of bytes to read
+	 *
+	 * @return #DAFF_NO_ERROR if all bytes have been read, #DAFF_FILE_CORRUPTED otherwise
+	 */
+	int read(uint64_t ui64Offset, void* pDest, size_t nBytes);
+
+	//! Reads a batch of byte ranges (ascending offsets, see DAFFDataSource::readBatch)
+	int readBatch(const DAFFReadRequest* pRequests, size_t n);
+
+  private:
+#ifdef WIN32
+	FILE* m_file;  //!@ File handle
+#else
+	int m_iFD;  //!@ File descriptor
+#endif
+	uint64_t m_ui64Size;  //!@ File size [Bytes]
+
+#ifndef WIN32
+	//! Reads the ranges [iBegin, iEnd) of a batch with a single preadv (gaps into a scratch buffer)
+	int readRun(const DAFFReadRequest* pRequests, size_t iBegin, size_t iEnd, char* pcScratch);
+#endif
+
+	// No copy
+	DAFFFileSource(const DAFFFileSource&);
+	DAFFFileSource& operator=(const DAFFFileSource&);
+};
+
+#endif  // IW_DAFF_FILESOURCE
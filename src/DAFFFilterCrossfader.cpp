@@ -0,0 +1,216 @@
+#include <DAFFFilterCrossfader.h>
+
+#include <DAFFContentDFT.h>
+#include <DAFFContentIR.h>
+#include <DAFFContentMS.h>
+#include <DAFFProperties.h>
+#include <DAFFReader.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "Utils.h"
+
+DAFFFilterCrossfader::DAFFFilterCrossfader(const DAFFContent* pContent)
+	: m_pContent(pContent), m_pContentIR(NULL), m_pContentMS(NULL), m_pContentDFT(NULL), m_bZeroCopy(false)
+{
+	assert(pContent != NULL);
+
+	switch (pContent->getProperties()->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		m_pContentIR = dynamic_cast<const DAFFContentIR*>(pContent);
+		break;
+	case DAFF_MAGNITUDE_SPECTRUM:
+		m_pContentMS = dynamic_cast<const DAFFContentMS*>(pContent);
+		break;
+	case DAFF_DFT_SPECTRUM:
+		m_pContentDFT = dynamic_cast<const DAFFContentDFT*>(pContent);
+		break;
+	}
+
+	// Pointers of transformed contents (lazy transformers) and lazy readers expire with the next access
+	const DAFFReader* pReader = pContent->getParent();
+	m_bZeroCopy = pReader && (pReader->getContent() == pContent) && !pReader->isLazy();
+}
+
+DAFFFilterCrossfader::~DAFFFilterCrossfader() {}
+
+const DAFFContent* DAFFFilterCrossfader::getContent() const
+{
+	return m_pContent;
+}
+
+int DAFFFilterCrossfader::getDataLength() const
+{
+	if (m_pContentIR)
+		return m_pContentIR->getFilterLength();
+	if (m_pContentMS)
+		return m_pContentMS->getNumFrequencies();
+	if (m_pContentDFT)
+		return 2 * m_pContentDFT->getNumDFTCoeffs();
+	return 0;
+}
+
+bool DAFFFilterCrossfader::isZeroCopy() const
+{
+	return m_bZeroCopy;
+}
+
+int DAFFFilterCrossfader::blend(int iPrevRecordIndex, int iNextRecordIndex, float fMix, int iChannel,
+								float* pfDest) const
+{
+	int piIndices[2] = { iPrevRecordIndex, iNextRecordIndex };
+	float pfWeights[2] = { 1.0f - fMix, fMix };
+	return blend(piIndices, pfWeights, 2, iChannel, pfDest);
+}
+
+int DAFFFilterCrossfader::blend(const DAFFQuad& qIndices, const float* pfWeights, int iChannel, float* pfDest) const
+{
+	int piIndices[4] = { qIndices.iIndex1, qIndices.iIndex2, qIndices.iIndex3, qIndices.iIndex4 };
+	return blend(piIndices, pfWeights, 4, iChannel, pfDest);
+}
+
+int DAFFFilterCrossfader::blend(const int* piRecordIndices, const float* pfWeights, int iNumRecords, int iChannel,
+								float* pfDest) const
+{
+	if (getDataLength() == 0)
+		return DAFF_MODAL_ERROR;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	const DAFFProperties* pProps = m_pContent->getProperties();
+	if ((iChannel < 0) || (iChannel >= pProps->getNumberOfChannels()) || (iNumRecords < 0) ||
+		((iNumRecords > 0) && (!piRecordIndices || !pfWeights)))
+		return DAFF_INVALID_INDEX;
+
+	for (int i = 0; i < iNumRecords; i++)
+		if ((piRecordIndices[i] < 0) || (piRecordIndices[i] >= pProps->getNumberOfRecords()))
+			return DAFF_INVALID_INDEX;
+
+	// Merge coinciding records (poles, unchanged records), so that every record is read once
+	int piIndices[MAX_FUSED_RECORDS];
+	float pfGains[MAX_FUSED_RECORDS];
+	int n = 0;
+	for (int i = 0; i < iNumRecords; i++) {
+		if (pfWeights[i] == 0.0f)
+			continue;
+
+		int j = 0;
+		while ((j < n) && (piIndices[j] != piRecordIndices[i]))
+			j++;
+
+		if (j < n) {
+			pfGains[j] += pfWeights[i];
+			continue;
+		}
+
+		if (n == MAX_FUSED_RECORDS)
+			return blendAdd(piRecordIndices, pfWeights, iNumRecords, iChannel, pfDest);  // Too many to fuse
+
+		piIndices[n] = piRecordIndices[i];
+		pfGains[n] = pfWeights[i];
+		n++;
+	}
+
+	if (m_bZeroCopy && blendZeroCopy(piIndices, pfGains, n, iChannel, pfDest))
+		return DAFF_NO_ERROR;
+
+	return blendAdd(piIndices, pfGains, n, iChannel, pfDest);
+}
+
+void DAFFFilterCrossfader::crossfade(const float* pfOld, const float* pfNew, float* pfDest, int iLength, int iShape)
+{
+	if (iLength <= 0)
+		return;
+
+	DAFF::crossfade_float(pfDest, pfOld, pfNew, iLength, 0.0f, 1.0f / (float)iLength,
+						  (iShape == DAFF_CROSSFADE_COSINE));
+}
+
+bool DAFFFilterCrossfader::blendZeroCopy(const int* piRecordIndices, const float* pfWeights, int iNumRecords,
+										 int iChannel, float* pfDest) const
+{
+	int iLength = getDataLength();
+	const float* ppfSrc[MAX_FUSED_RECORDS];
+
+	if (!m_pContentIR) {
+		// Spectra cover the whole data length
+		for (int i = 0; i < iNumRecords; i++) {
+			if (m_pContentMS)
+				ppfSrc[i] = m_pContentMS->getMagnitudesPtr(piRecordIndices[i], iChannel);
+			else
+				ppfSrc[i] = m_pContentDFT->getDFTCoeffsPtr(piRecordIndices[i], iChannel);
+			if (ppfSrc[i] == NULL)
+				return false;
+		}
+
+		DAFF::blend_float(pfDest, ppfSrc, pfWeights, iNumRecords, iLength);
+		return true;
+	}
+
+	// Impulse responses: only the effective coefficients are stored
+	int piOffset[MAX_FUSED_RECORDS], piEnd[MAX_FUSED_RECORDS];
+	int piBounds[2 * MAX_FUSED_RECORDS + 2];
+	int iNumBounds = 0;
+	piBounds[iNumBounds++] = 0;
+	piBounds[iNumBounds++] = iLength;
+	for (int i = 0; i < iNumRecords; i++) {
+		int iEffectiveLength;
+		ppfSrc[i] = m_pContentIR->getEffectiveFilterCoeffsPtr(piRecordIndices[i], iChannel, piOffset[i],
+															   iEffectiveLength);
+		if (ppfSrc[i] == NULL)
+			return false;
+
+		piEnd[i] = piOffset[i] + iEffectiveLength;
+		piBounds[iNumBounds++] = piOffset[i];
+		piBounds[iNumBounds++] = piEnd[i];
+	}
+	std::sort(piBounds, piBounds + iNumBounds);
+
+	// Between two bounds the same records are effective, each segment is a single pass
+	const float* ppfSegmentSrc[MAX_FUSED_RECORDS];
+	float pfSegmentGains[MAX_FUSED_RECORDS];
+	for (int b = 0; b + 1 < iNumBounds; b++) {
+		int iBegin = piBounds[b], iEnd = piBounds[b + 1];
+		if (iBegin >= iEnd)
+			continue;
+
+		int m = 0;
+		for (int i = 0; i < iNumRecords; i++)
+			if ((piOffset[i] <= iBegin) && (iEnd <= piEnd[i])) {
+				ppfSegmentSrc[m] = ppfSrc[i] + (iBegin - piOffset[i]);
+				pfSegmentGains[m] = pfWeights[i];
+				m++;
+			}
+
+		DAFF::blend_float(pfDest + iBegin, ppfSegmentSrc, pfSegmentGains, m, iEnd - iBegin);
+	}
+
+	return true;
+}
+
+int DAFFFilterCrossfader::blendAdd(const int* piRecordIndices, const float* pfWeights, int iNumRecords, int iChannel,
+								   float* pfDest) const
+{
+	memset(pfDest, 0, getDataLength() * sizeof(float));
+
+	for (int i = 0; i < iNumRecords; i++) {
+		if (pfWeights[i] == 0.0f)
+			continue;
+
+		int iError;
+		if (m_pContentIR)
+			iError = m_pContentIR->addFilterCoeffs(piRecordIndices[i], iChannel, pfDest, pfWeights[i]);
+		else if (m_pContentMS)
+			iError = m_pContentMS->addMagnitudes(piRecordIndices[i], iChannel, pfDest, pfWeights[i]);
+		else
+			iError = m_pContentDFT->addDFTCoeffs(piRecordIndices[i], iChannel, pfDest, pfWeights[i]);
+
+		if (iError != DAFF_NO_ERROR)
+			return iError;
+	}
+
+	return DAFF_NO_ERROR;
+}
@@ -0,0 +1,187 @@
+#include <DAFFGPUTable.h>
+
+#include <DAFFContent.h>
+#include <DAFFContentDFT.h>
+#include <DAFFContentIR.h>
+#include <DAFFContentMPS.h>
+#include <DAFFContentMS.h>
+#include <DAFFProperties.h>
+#include <DAFFSCTransform.h>
+
+#include <cstring>
+
+// Alignment of the values of a record channel [floats] (128 bytes)
+static const int STRIDE_ALIGNMENT = 32;
+
+DAFFGPUTable::DAFFGPUTable() : m_iNumValues(0), m_iStride(0), m_iContentType(-1), m_fQuantizationDivisor(1.0f)
+{
+	memset(&m_oGrid, 0, sizeof(m_oGrid));
+}
+
+DAFFGPUTable::~DAFFGPUTable() {}
+
+int DAFFGPUTable::load(const DAFFContent* pContent)
+{
+	clear();
+
+	if (pContent == NULL)
+		return DAFF_MODAL_ERROR;
+
+	const DAFFProperties* pProps = pContent->getProperties();
+	if (!pProps->isRegularGrid())
+		return DAFF_MODAL_ERROR;
+
+	int iContentType = pProps->getContentType();
+	const DAFFContentIR* pContentIR = NULL;
+	const DAFFContentMS* pContentMS = NULL;
+	const DAFFContentMPS* pContentMPS = NULL;
+	const DAFFContentDFT* pContentDFT = NULL;
+	int iNumValues = 0;
+	switch (iContentType) {
+	case DAFF_IMPULSE_RESPONSE:
+		pContentIR = dynamic_cast<const DAFFContentIR*>(pContent);
+		iNumValues = pContentIR->getFilterLength();
+		break;
+	case DAFF_MAGNITUDE_SPECTRUM:
+		pContentMS = dynamic_cast<const DAFFContentMS*>(pContent);
+		iNumValues = pContentMS->getNumFrequencies();
+		break;
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		pContentMPS = dynamic_cast<const DAFFContentMPS*>(pContent);
+		iNumValues = pContentMPS->getNumFrequencies();
+		break;
+	case DAFF_DFT_SPECTRUM:
+		pContentDFT = dynamic_cast<const DAFFContentDFT*>(pContent);
+		iNumValues = 2 * pContentDFT->getNumDFTCoeffs();
+		break;
+	default:
+		return DAFF_MODAL_ERROR;
+	}
+
+	// Grid like in the nearest neighbour search of the reader
+	DAFFGPUGrid& g = m_oGrid;
+	g.iNumRecords = pProps->getNumberOfRecords();
+	g.iNumChannels = pProps->getNumberOfChannels();
+	g.iAlphaPoints = pProps->getAlphaPoints();
+	g.fAlphaStart = pProps->getAlphaStart();
+	g.fAlphaEnd = pProps->getAlphaEnd();
+	g.fAlphaSpan = pProps->getAlphaSpan();
+	g.fAlphaResolution = pProps->getAlphaResolution();
+	g.iBetaPoints = pProps->getBetaPoints();
+	g.fBetaStart = pProps->getBetaStart();
+	g.fBetaEnd = pProps->getBetaEnd();
+	g.fBetaResolution = pProps->getBetaResolution();
+	g.bFullAlphaRange = pProps->coversFullAlphaRange();
+	g.bFullSphere = pProps->coversFullSphere();
+	g.bSouthPole = (g.fBetaStart == 0.0f);
+	g.bNorthPole = (g.fBetaEnd == 180.0f);
+
+	DAFFOrientationYPR o;
+	pProps->getOrientation(o);
+	setOrientation(o);
+
+	// Integer samples are kept raw (added to zeros with the full scale as gain, exact), so that
+	// the lookups can convert them together with the weights like the reader
+	float fDivisor = 1.0f;
+	if (pProps->getQuantization() == DAFF_INT16)
+		fDivisor = 32767.0F;
+	else if (pProps->getQuantization() == DAFF_INT24)
+		fDivisor = 8388607.0F;
+
+	int iStride = (iNumValues + STRIDE_ALIGNMENT - 1) / STRIDE_ALIGNMENT * STRIDE_ALIGNMENT;
+	m_vfData.assign((size_t)g.iNumRecords * g.iNumChannels * iStride, 0.0f);
+
+	for (int r = 0; r < g.iNumRecords; r++)
+		for (int c = 0; c < g.iNumChannels; c++) {
+			float* pfDest = &m_vfData[((size_t)r * g.iNumChannels + c) * iStride];
+			int iError;
+			if (pContentIR)
+				iError = pContentIR->addFilterCoeffs(r, c, pfDest, fDivisor);
+			else if (pContentMS)
+				iError = pContentMS->getMagnitudes(r, c, pfDest);
+			else if (pContentMPS)
+				iError = pContentMPS->getMagnitudes(r, c, pfDest);
+			else
+				iError = pContentDFT->getDFTCoeffs(r, c, pfDest);
+
+			if (iError != DAFF_NO_ERROR) {
+				clear();
+				return iError;
+			}
+		}
+
+	m_iNumValues = iNumValues;
+	m_iStride = iStride;
+	m_iContentType = iContentType;
+	m_fQuantizationDivisor = fDivisor;
+
+	return DAFF_NO_ERROR;
+}
+
+void DAFFGPUTable::clear()
+{
+	std::vector<float>().swap(m_vfData);
+	memset(&m_oGrid, 0, sizeof(m_oGrid));
+	m_iNumValues = 0;
+	m_iStride = 0;
+	m_iContentType = -1;
+	m_fQuantizationDivisor = 1.0f;
+}
+
+bool DAFFGPUTable::isLoaded() const
+{
+	return (m_iContentType != -1);
+}
+
+int DAFFGPUTable::getContentType() const
+{
+	return m_iContentType;
+}
+
+const DAFFGPUGrid& DAFFGPUTable::getGrid() const
+{
+	return m_oGrid;
+}
+
+void DAFFGPUTable::setOrientation(const DAFFOrientationYPR& o)
+{
+	DAFFSCTransform oTrans(o);
+	oTrans.getRotationConstants(m_oGrid.pdRotation);
+}
+
+int DAFFGPUTable::getNumValues() const
+{
+	return m_iNumValues;
+}
+
+int DAFFGPUTable::getStride() const
+{
+	return m_iStride;
+}
+
+const float* DAFFGPUTable::getData() const
+{
+	return (m_vfData.empty() ? NULL : &m_vfData[0]);
+}
+
+float DAFFGPUTable::getQuantizationDivisor() const
+{
+	return m_fQuantizationDivisor;
+}
+
+size_t DAFFGPUTable::getDataSize() const
+{
+	return m_vfData.size() * sizeof(float);
+}
+
+DAFFGPUContent DAFFGPUTable::getContent(const float* pfData) const
+{
+	DAFFGPUContent c;
+	c.oGrid = m_oGrid;
+	c.pfData = (pfData ? pfData : getData());
+	c.iNumValues = m_iNumValues;
+	c.iStride = m_iStride;
+	c.iContentType = m_iContentType;
+	c.fQuantizationDivisor = m_fQuantizationDivisor;
+	return c;
+}
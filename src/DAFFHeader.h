@@ -50,6 +50,30 @@ static const int FILEBLOCK_DAFF1_DATA_ID = 0x0004;
 //! DAFF Version 1: Metadata block
 static const int FILEBLOCK_DAFF1_METADATA_ID = 0x0005;
 
+//! DAFF Version 1: Statistics block (optional)
+static const int FILEBLOCK_DAFF1_STATISTICS_ID = 0x0006;
+
+//! DAFF Version 1: Record directions block (optional, irregular grids)
+static const int FILEBLOCK_DAFF1_RECORD_DIRECTIONS_ID = 0x0007;
+
+//! DAFF Version 1: Compressed data block (optional, replaces the data block)
+static const int FILEBLOCK_DAFF1_COMPRESSED_DATA_ID = 0x0008;
+
+//! DAFF Version 1: Symmetry block (optional, the other blocks describe the stored records only)
+static const int FILEBLOCK_DAFF1_SYMMETRY_ID = 0x0009;
+
+//! DAFF Version 1: Direction index block (optional, nearest neighbour index of the full grid)
+static const int FILEBLOCK_DAFF1_DIRECTION_INDEX_ID = 0x000A;
+
+//! DAFF Version 1: Checksum block (optional, CRC-32C of the other file blocks)
+static const int FILEBLOCK_DAFF1_CHECKSUMS_ID = 0x000B;
+
+//! DAFF Version 1: Level block (optional, the record data is ordered by resolution levels)
+static const int FILEBLOCK_DAFF1_LEVELS_ID = 0x000C;
+
+//! DAFF Version 1: Record order block (optional, the record data is ordered along a space-filling curve)
+static const int FILEBLOCK_DAFF1_RECORD_ORDER_ID = 0x000D;
+
 
 /* +---------------------------------------------------+
    |                                                   |
@@ -266,4 +290,221 @@ struct DAFFRecordChannelDescIR {
 	};
 } DAFF_PACK_ATTR;
 
+//! Record channel descriptor of #DAFF_INT16_BFP impulse responses (the IR descriptor followed by the block scale)
+struct DAFFRecordChannelDescIRBFP {
+#pragma pack(push, 1)
+	DAFFRecordChannelDescIR oDesc;  //!@ Descriptor of the impulse response
+	float fScale;                   //!@ Scale of the samples (a sample of 32767 equals this coefficient)
+#pragma pack(pop)
+
+	//! Convert the little-endian file format into the systems endianness
+	inline void fixEndianness()
+	{
+		oDesc.fixEndianness();
+		DAFF::le2se_4byte(&fScale, 1);
+	};
+} DAFF_PACK_ATTR;
+
+//! Statistics of a record channel (entries of the optional statistics block, ordered like the record descriptors)
+struct DAFFStatisticsEntry {
+#pragma pack(push, 1)
+	float fPeak;     //!@ Greatest absolute value
+	float fEnergy;   //!@ Sum of the squared values
+	int32_t iOnset;  //!@ Index of the first value that reaches 10% of the peak (-1 if all values are zero)
+#pragma pack(pop)
+
+	//! Convert the little-endian file format into the systems endianness
+	inline void fixEndianness()
+	{
+		DAFF::le2se_4byte(&fPeak, 1);
+		DAFF::le2se_4byte(&fEnergy, 1);
+		DAFF::le2se_4byte(&iOnset, 1);
+	};
+} DAFF_PACK_ATTR;
+
+//! Direction of a record (entries of the optional record directions block, ordered by record index)
+struct DAFFRecordDirectionEntry {
+#pragma pack(push, 1)
+	float fAlpha;  //!@ Alpha angle in the data spherical coordinate system [degrees], within [0, 360)
+	float fBeta;   //!@ Beta angle in the data spherical coordinate system [degrees], within [0, 180]
+#pragma pack(pop)
+
+	//! Convert the little-endian file format into the systems endianness
+	inline void fixEndianness()
+	{
+		DAFF::le2se_4byte(&fAlpha, 1);
+		DAFF::le2se_4byte(&fBeta, 1);
+	};
+} DAFF_PACK_ATTR;
+
+//! Node of the nearest neighbour index (entries of the optional direction index block, in tree order)
+struct DAFFDirectionIndexEntry {
+#pragma pack(push, 1)
+	int32_t iRecordIndex;  //!@ Record index of the node
+	int32_t iAxis;         //!@ Split axis of the node (0-2: x, y, z of the unit vector)
+#pragma pack(pop)
+
+	//! Convert the little-endian file format into the systems endianness
+	inline void fixEndianness()
+	{
+		DAFF::le2se_4byte(&iRecordIndex, 1);
+		DAFF::le2se_4byte(&iAxis, 1);
+	};
+} DAFF_PACK_ATTR;
+
+/* +---------------------------------------------------+
+   |                                                   |
+   |   DAFF compressed data block                      |
+   |                                                   |
+   +---------------------------------------------------+ */
+
+//! Header of the compressed data block
+/**
+ * The compressed data block replaces the data block. The chunks hold the data of
+ * ranges of the (uncompressed) data block, which the record descriptors refer to as
+ * usual. Bytes outside of all chunks are zero.
+ */
+struct DAFFCompressedDataHeader {
+#pragma pack(push, 1)
+	int32_t iNumChunks;             //!@ Number of chunks
+	uint64_t ui64DataSize;          //!@ Size of the uncompressed data block [Bytes]
+	uint64_t ui64ChunkTableOffset;  //!@ Position of the chunk table within the compressed data block [Bytes]
+#pragma pack(pop)
+
+	//! Convert the little-endian file format into the systems endianness
+	inline void fixEndianness()
+	{
+		DAFF::le2se_4byte(&iNumChunks, 1);
+		DAFF::le2se_8byte(&ui64DataSize, 1);
+		DAFF::le2se_8byte(&ui64ChunkTableOffset, 1);
+	};
+} DAFF_PACK_ATTR;
+
+//! Chunk of the compressed data block (entries of the chunk table, ordered by data offset)
+struct DAFFCompressedChunkEntry {
+#pragma pack(push, 1)
+	uint64_t ui64DataOffset;  //!@ Position of the chunk data within the uncompressed data block [Bytes]
+	uint64_t ui64DataSize;    //!@ Size of the chunk data [Bytes]
+	uint64_t ui64Offset;      //!@ Position of the compressed chunk within the compressed data block [Bytes]
+	uint64_t ui64Size;        //!@ Size of the compressed chunk [Bytes]
+	int32_t iMethod;          //!@ Compression method
+#pragma pack(pop)
+
+	//! Convert the little-endian file format into the systems endianness
+	inline void fixEndianness()
+	{
+		DAFF::le2se_8byte(&ui64DataOffset, 1);
+		DAFF::le2se_8byte(&ui64DataSize, 1);
+		DAFF::le2se_8byte(&ui64Offset, 1);
+		DAFF::le2se_8byte(&ui64Size, 1);
+		DAFF::le2se_4byte(&iMethod, 1);
+	};
+} DAFF_PACK_ATTR;
+
+//! Symmetry block
+/**
+ * The main header, the record descriptors, the statistics and the record data describe
+ * the stored part of the grid: the meridian alpha = 0 (iAlphaPoints = 1, alpha range 0-0)
+ * for #DAFF_SYMMETRY_AXIAL, the alpha range 0-180 (iAlphaPoints/2 + 1 points) for
+ * #DAFF_SYMMETRY_MIRROR. Readers expand it to the full grid with iAlphaPoints points
+ * over the alpha range 0-360.
+ */
+struct DAFFSymmetryHeader {
+#pragma pack(push, 1)
+	int32_t iSymmetry;     //!@ Symmetry of the grid (#DAFF_SYMMETRIES)
+	int32_t iAlphaPoints;  //!@ Number of alpha points of the full grid
+#pragma pack(pop)
+
+	//! Convert the little-endian file format into the systems endianness
+	inline void fixEndianness()
+	{
+		DAFF::le2se_4byte(&iSymmetry, 1);
+		DAFF::le2se_4byte(&iAlphaPoints, 1);
+	};
+} DAFF_PACK_ATTR;
+
+//! Checksum block
+/**
+ * Every file block, except the checksum block itself, is divided into segments of
+ * iSegmentSize bytes (the last one may be shorter, empty blocks have none). The header is
+ * followed by the CRC-32C of all segments (uint32_t), block after block in the order of
+ * the file block table. Readers can thereby verify large blocks in parallel and ranges
+ * of lazily loaded blocks on their own.
+ */
+struct DAFFChecksumHeader {
+#pragma pack(push, 1)
+	int32_t iNumFileBlocks;       //!@ Number of entries of the file block table (for a consistency check)
+	int32_t iSegmentSize;         //!@ Size of the checksummed segments [Bytes] (power of two, at least 4096)
+	uint32_t ui32HeaderChecksum;  //!@ CRC-32C of the file header and the file block table
+	int32_t iReserved;            //!@ Reserved (zero)
+#pragma pack(pop)
+
+	//! Convert the little-endian file format into the systems endianness
+	inline void fixEndianness()
+	{
+		DAFF::le2se_4byte(&iNumFileBlocks, 1);
+		DAFF::le2se_4byte(&iSegmentSize, 1);
+		DAFF::le2se_4byte(&ui32HeaderChecksum, 1);
+		DAFF::le2se_4byte(&iReserved, 1);
+	};
+} DAFF_PACK_ATTR;
+
+//! Level block
+/**
+ * The record data of regular grids is stored level by level, from a coarse subgrid to the full
+ * resolution. Level l holds the records of the (stored) grid whose alpha and beta indices are
+ * multiples of its step and that no coarser level holds, the poles belong to the coarsest level.
+ * The steps are decreasing powers of two, the last one is 1. The header is followed by one
+ * entry per level, the data of a level ends where the data of the next one begins.
+ */
+struct DAFFLevelHeader {
+#pragma pack(push, 1)
+	int32_t iNumLevels;  //!@ Number of levels
+	int32_t iReserved;   //!@ Reserved (zero)
+#pragma pack(pop)
+
+	//! Convert the little-endian file format into the systems endianness
+	inline void fixEndianness()
+	{
+		DAFF::le2se_4byte(&iNumLevels, 1);
+		DAFF::le2se_4byte(&iReserved, 1);
+	};
+} DAFF_PACK_ATTR;
+
+//! Entry of the level block
+struct DAFFLevelEntry {
+#pragma pack(push, 1)
+	int32_t iStep;         //!@ Grid step of the level (alpha and beta points)
+	uint64_t ui64DataEnd;  //!@ End of the record data of the level (offset within the data) [Bytes]
+#pragma pack(pop)
+
+	//! Convert the little-endian file format into the systems endianness
+	inline void fixEndianness()
+	{
+		DAFF::le2se_4byte(&iStep, 1);
+		DAFF::le2se_8byte(&ui64DataEnd, 1);
+	};
+} DAFF_PACK_ATTR;
+
+//! Record order block
+/**
+ * The record data is stored along a space-filling curve over the record directions (data view)
+ * instead of the order of the record indices, so that records of nearby directions are stored
+ * close to each other. The record descriptors keep the record indices, only their data offsets
+ * follow the curve. With levels, the records of each level are ordered along the curve.
+ */
+struct DAFFRecordOrderHeader {
+#pragma pack(push, 1)
+	int32_t iRecordOrder;  //!@ Record order (#DAFF_RECORD_ORDERS, not DAFF_RECORD_ORDER_INDEX)
+	int32_t iReserved;     //!@ Reserved (zero)
+#pragma pack(pop)
+
+	//! Convert the little-endian file format into the systems endianness
+	inline void fixEndianness()
+	{
+		DAFF::le2se_4byte(&iRecordOrder, 1);
+		DAFF::le2se_4byte(&iReserved, 1);
+	};
+} DAFF_PACK_ATTR;
+
 #endif  // IW_DAFF_HEADER
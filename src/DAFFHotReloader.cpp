@@ -0,0 +1,174 @@
+#include <DAFFHotReloader.h>
+
+#include <DAFFReader.h>
+
+#include <algorithm>
+#include <chrono>
+#include <system_error>
+
+#include "Utils.h"
+
+DAFFHotReloader::DAFFHotReloader()
+	: m_iOpenFlags(DAFF_OPEN_DEFAULT), m_iModTime(-1), m_iSize(-1), m_iFailedModTime(-1), m_iFailedSize(-1),
+	  m_iLastError(DAFF_NO_ERROR), m_ui64Generation(0), m_iIntervalMS(500), m_bStopWatching(false)
+{
+}
+
+DAFFHotReloader::~DAFFHotReloader()
+{
+	close();
+}
+
+int DAFFHotReloader::open(const std::string& sFilePath, int iOpenFlags)
+{
+	close();
+
+	std::lock_guard<std::mutex> lock(m_mxReload);
+	m_sFilePath = sFilePath;
+	m_iOpenFlags = iOpenFlags;
+	reload();
+	if (std::atomic_load(&m_pReader))
+		return DAFF_NO_ERROR;
+
+	// Missing or changed while loading
+	if (m_iLastError == DAFF_NO_ERROR)
+		m_iLastError = DAFF_FILE_NOT_FOUND;
+	return m_iLastError;
+}
+
+void DAFFHotReloader::close()
+{
+	stopWatching();
+
+	std::lock_guard<std::mutex> lock(m_mxReload);
+	m_sFilePath = "";
+	std::atomic_store(&m_pReader, std::shared_ptr<const DAFFReader>());
+	m_pPrevious.reset();
+	m_iModTime = m_iSize = -1;
+	m_iFailedModTime = m_iFailedSize = -1;
+	m_iLastError = DAFF_NO_ERROR;
+}
+
+std::string DAFFHotReloader::getFilePath() const
+{
+	std::lock_guard<std::mutex> lock(m_mxReload);
+	return m_sFilePath;
+}
+
+int DAFFHotReloader::getOpenFlags() const
+{
+	std::lock_guard<std::mutex> lock(m_mxReload);
+	return m_iOpenFlags;
+}
+
+std::shared_ptr<const DAFFReader> DAFFHotReloader::getReader() const
+{
+	return std::atomic_load(&m_pReader);
+}
+
+uint64_t DAFFHotReloader::getGeneration() const
+{
+	return m_ui64Generation;
+}
+
+int DAFFHotReloader::getLastError() const
+{
+	return m_iLastError;
+}
+
+bool DAFFHotReloader::checkForChanges()
+{
+	std::lock_guard<std::mutex> lock(m_mxReload);
+	return reload();
+}
+
+int DAFFHotReloader::startWatching(int iIntervalMS)
+{
+	stopWatching();
+
+	if (getFilePath().empty())
+		return DAFF_MODAL_ERROR;
+
+	m_iIntervalMS = std::max(iIntervalMS, 1);
+	m_bStopWatching = false;
+	try {
+		m_oWatchThread = std::thread(&DAFFHotReloader::watch, this);
+	} catch (const std::system_error&) {
+		return DAFF_MODAL_ERROR;
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+void DAFFHotReloader::stopWatching()
+{
+	if (!m_oWatchThread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mxWatch);
+		m_bStopWatching = true;
+	}
+	m_cvWatch.notify_all();
+	m_oWatchThread.join();
+}
+
+bool DAFFHotReloader::isWatching() const
+{
+	return m_oWatchThread.joinable();
+}
+
+bool DAFFHotReloader::reload()
+{
+	if (m_sFilePath.empty())
+		return false;
+
+	// Unchanged, missing (e.g. while being replaced) or known to fail
+	int64_t iModTime = DAFF::getFileModTime(m_sFilePath);
+	int64_t iSize = DAFF::getFileSize(m_sFilePath);
+	if ((iModTime < 0) || (iSize < 0))
+		return false;
+	if ((iModTime == m_iModTime) && (iSize == m_iSize))
+		return false;
+	if ((iModTime == m_iFailedModTime) && (iSize == m_iFailedSize))
+		return false;
+
+	DAFFReader* pReader = DAFFReader::create();
+	int iError = pReader->openFile(m_sFilePath, m_iOpenFlags);
+
+	// A file that changed while loading is still being written, tried again with the next check
+	if ((DAFF::getFileModTime(m_sFilePath) != iModTime) || (DAFF::getFileSize(m_sFilePath) != iSize)) {
+		delete pReader;
+		return false;
+	}
+
+	m_iLastError = iError;
+	if (iError != DAFF_NO_ERROR) {
+		delete pReader;
+		m_iFailedModTime = iModTime;
+		m_iFailedSize = iSize;
+		return false;
+	}
+
+	m_iModTime = iModTime;
+	m_iSize = iSize;
+	m_pPrevious = std::atomic_load(&m_pReader);
+	std::atomic_store(&m_pReader, std::shared_ptr<const DAFFReader>(pReader));
+	m_ui64Generation++;
+
+	return true;
+}
+
+void DAFFHotReloader::watch()
+{
+	std::unique_lock<std::mutex> lock(m_mxWatch);
+	while (!m_bStopWatching) {
+		m_cvWatch.wait_for(lock, std::chrono::milliseconds(m_iIntervalMS));
+		if (m_bStopWatching)
+			break;
+
+		lock.unlock();
+		checkForChanges();
+		lock.lock();
+	}
+}
@@ -0,0 +1,91 @@
+#include <DAFFInstrumentation.h>
+
+#include "DAFFInstrumentationImpl.h"
+
+#include <atomic>
+
+//! Names of the counters (index: DAFF_COUNTERS)
+static const char* const g_ppszCounterNames[DAFF_NUM_COUNTERS] = {
+	"nearest_neighbour",
+	"out_of_bounds",
+	"fetched_bytes_int16",
+	"fetched_bytes_int24",
+	"fetched_bytes_float32",
+	"fetched_bytes_float16",
+	"fetched_bytes_bfloat16",
+	"fetched_bytes_int16_bfp",
+	"record_cache_hits",
+	"record_cache_misses",
+	"transformer_cache_hits",
+	"transformer_cache_misses",
+	"content_cache_hits",
+	"content_cache_misses",
+};
+
+//! Registered receiver of the trace scopes
+static std::atomic<DAFFInstrumentationSink*> g_pSink(nullptr);
+
+#ifdef DAFF_WITH_INSTRUMENTATION
+
+std::atomic<uint64_t> DAFF::g_aui64InstrumentationCounters[DAFF_NUM_COUNTERS];
+
+void DAFF::instrumentationTrace(const char* pszScope, double dDuration)
+{
+	DAFFInstrumentationSink* pSink = g_pSink.load(std::memory_order_acquire);
+	if (pSink)
+		pSink->onTraceScope(pszScope, dDuration);
+}
+
+#endif  // DAFF_WITH_INSTRUMENTATION
+
+bool DAFFInstrumentation::isEnabled()
+{
+#ifdef DAFF_WITH_INSTRUMENTATION
+	return true;
+#else
+	return false;
+#endif
+}
+
+void DAFFInstrumentation::setSink(DAFFInstrumentationSink* pSink)
+{
+	g_pSink.store(pSink, std::memory_order_release);
+}
+
+DAFFInstrumentationSink* DAFFInstrumentation::getSink()
+{
+	return g_pSink.load(std::memory_order_acquire);
+}
+
+uint64_t DAFFInstrumentation::getCounter(int iCounter)
+{
+	if ((iCounter < 0) || (iCounter >= DAFF_NUM_COUNTERS))
+		return 0;
+
+#ifdef DAFF_WITH_INSTRUMENTATION
+	return DAFF::g_aui64InstrumentationCounters[iCounter].load(std::memory_order_relaxed);
+#else
+	return 0;
+#endif
+}
+
+void DAFFInstrumentation::getCounters(uint64_t* pui64Values)
+{
+	for (int i = 0; i < DAFF_NUM_COUNTERS; i++)
+		pui64Values[i] = getCounter(i);
+}
+
+void DAFFInstrumentation::resetCounters()
+{
+#ifdef DAFF_WITH_INSTRUMENTATION
+	for (int i = 0; i < DAFF_NUM_COUNTERS; i++)
+		DAFF::g_aui64InstrumentationCounters[i].store(0, std::memory_order_relaxed);
+#endif
+}
+
+const char* DAFFInstrumentation::getCounterName(int iCounter)
+{
+	if ((iCounter < 0) || (iCounter >= DAFF_NUM_COUNTERS))
+		return "";
+	return g_ppszCounterNames[iCounter];
+}
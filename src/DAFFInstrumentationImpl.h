@@ -0,0 +1,49 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_INSTRUMENTATIONIMPL
+#define IW_DAFF_INSTRUMENTATIONIMPL
+
+#include <DAFFInstrumentation.h>
+
+// Instrumentation hooks of the library. Without DAFF_WITH_INSTRUMENTATION the hooks
+// expand to nothing and their arguments are not evaluated.
+
+#ifdef DAFF_WITH_INSTRUMENTATION
+
+#include <atomic>
+
+namespace DAFF {
+//! Counters of the instrumentation (index: DAFF_COUNTERS)
+extern std::atomic<uint64_t> g_aui64InstrumentationCounters[DAFF_NUM_COUNTERS];
+
+//! Adds a value to a counter
+inline void instrumentationCount(int iCounter, uint64_t ui64Value)
+{
+	g_aui64InstrumentationCounters[iCounter].fetch_add(ui64Value, std::memory_order_relaxed);
+}
+
+//! Reports a finished trace scope to the registered sink
+void instrumentationTrace(const char* pszScope, double dDuration);
+}  // namespace DAFF
+
+#define DAFF_INSTRUMENT_COUNT(iCounter, ui64Value) DAFF::instrumentationCount((iCounter), (ui64Value))
+#define DAFF_INSTRUMENT_TRACE(pszScope, dDuration) DAFF::instrumentationTrace((pszScope), (dDuration))
+
+#else  // DAFF_WITH_INSTRUMENTATION
+
+// The arguments are not evaluated, but count as used (no unused parameter warnings)
+#define DAFF_INSTRUMENT_COUNT(iCounter, ui64Value) ((void)sizeof(iCounter), (void)sizeof(ui64Value))
+#define DAFF_INSTRUMENT_TRACE(pszScope, dDuration) ((void)sizeof(pszScope), (void)sizeof(dDuration))
+
+#endif  // DAFF_WITH_INSTRUMENTATION
+
+#endif  // IW_DAFF_INSTRUMENTATIONIMPL
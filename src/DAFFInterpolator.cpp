@@ -0,0 +1,202 @@
+#include <DAFFInterpolator.h>
+
+#include <DAFFContent.h>
+#include <DAFFContentDFT.h>
+#include <DAFFContentIR.h>
+#include <DAFFContentMS.h>
+#include <DAFFProperties.h>
+#include <DAFFUtils.h>
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+DAFFInterpolator::DAFFInterpolator(const DAFFContent* pContent)
+	: m_pContent(pContent), m_pContentIR(NULL), m_pContentMS(NULL), m_pContentDFT(NULL)
+{
+	assert(pContent != NULL);
+
+	const DAFFProperties* pProps = m_pContent->getProperties();
+	switch (pProps->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		m_pContentIR = dynamic_cast<const DAFFContentIR*>(m_pContent);
+		break;
+	case DAFF_MAGNITUDE_SPECTRUM:
+		m_pContentMS = dynamic_cast<const DAFFContentMS*>(m_pContent);
+		break;
+	case DAFF_DFT_SPECTRUM:
+		m_pContentDFT = dynamic_cast<const DAFFContentDFT*>(m_pContent);
+		break;
+	}
+
+	m_iAlphaPoints = pProps->getAlphaPoints();
+	m_fAlphaStart = pProps->getAlphaStart();
+	m_fAlphaSpan = pProps->getAlphaSpan();
+	m_fAlphaResolution = pProps->getAlphaResolution();
+	m_bFullAlphaRange = (m_fAlphaSpan == 360.0f);
+	m_iBetaPoints = pProps->getBetaPoints();
+	m_fBetaStart = pProps->getBetaStart();
+	m_fBetaResolution = pProps->getBetaResolution();
+
+	// Same record layout as in the nearest neighbour search
+	m_bSouthPole = (m_fBetaStart == 0.0f);
+	m_bNorthPole = (pProps->getBetaEnd() == 180.0f);
+	m_bRegularGrid = pProps->isRegularGrid();
+}
+
+const DAFFContent* DAFFInterpolator::getContent() const
+{
+	return m_pContent;
+}
+
+int DAFFInterpolator::getDataLength() const
+{
+	if (m_pContentIR)
+		return m_pContentIR->getFilterLength();
+	if (m_pContentMS)
+		return m_pContentMS->getNumFrequencies();
+	if (m_pContentDFT)
+		return 2 * m_pContentDFT->getNumDFTCoeffs();
+	return 0;
+}
+
+int DAFFInterpolator::getWeights(int iView, float fAngle1Deg, float fAngle2Deg, DAFFQuad& qIndices,
+								 float* pfWeights) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+	assert(pfWeights != NULL);
+
+	if ((iView != DAFF_DATA_VIEW) && (iView != DAFF_OBJECT_VIEW))
+		return DAFF_MODAL_ERROR;
+
+	// The records of irregular grids do not form cells
+	if (!m_bRegularGrid)
+		return DAFF_MODAL_ERROR;
+
+	float fAlpha = fAngle1Deg;
+	float fBeta = fAngle2Deg;
+	if (iView == DAFF_OBJECT_VIEW)
+		m_pContent->transformAnglesO2D(fAngle1Deg, fAngle2Deg, fAlpha, fBeta);
+	DAFFUtils::NormalizeDirection(DAFF_DATA_VIEW, fAlpha, fBeta, fAlpha, fBeta);
+
+	// Alpha grid indices (lower and upper) and fractional position in between
+	int iAlpha1 = 0, iAlpha2 = 0;
+	float fAlphaFrac = 0.0f;
+	if ((m_iAlphaPoints > 1) && (m_fAlphaResolution > 0.0f)) {
+		float fRelAlpha = fAlpha - m_fAlphaStart;  // Within [0, 360)
+		if (fRelAlpha < 0.0f)
+			fRelAlpha += 360.0f;
+
+		if (m_bFullAlphaRange) {
+			float fPos = fRelAlpha / m_fAlphaResolution;
+			iAlpha1 = (int)floorf(fPos);
+			fAlphaFrac = fPos - (float)iAlpha1;
+			iAlpha1 %= m_iAlphaPoints;
+			iAlpha2 = (iAlpha1 + 1) % m_iAlphaPoints;  // Wrap around
+		} else if (fRelAlpha <= m_fAlphaSpan) {
+			float fPos = fRelAlpha / m_fAlphaResolution;
+			iAlpha1 = (int)floorf(fPos);
+			if (iAlpha1 >= m_iAlphaPoints - 1) {
+				iAlpha1 = iAlpha2 = m_iAlphaPoints - 1;
+			} else {
+				fAlphaFrac = fPos - (float)iAlpha1;
+				iAlpha2 = iAlpha1 + 1;
+			}
+		} else {
+			// Outside the covered alpha range: clamp to the closer boundary
+			if ((fRelAlpha - m_fAlphaSpan) <= (360.0f - fRelAlpha))
+				iAlpha1 = iAlpha2 = m_iAlphaPoints - 1;
+			else
+				iAlpha1 = iAlpha2 = 0;
+		}
+	}
+
+	// Beta grid indices, clamped to the covered beta range
+	int iBeta1 = 0, iBeta2 = 0;
+	float fBetaFrac = 0.0f;
+	if ((m_iBetaPoints > 1) && (m_fBetaResolution > 0.0f)) {
+		float fPos = (fBeta - m_fBetaStart) / m_fBetaResolution;
+		if (fPos <= 0.0f) {
+			iBeta1 = iBeta2 = 0;
+		} else if (fPos >= (float)(m_iBetaPoints - 1)) {
+			iBeta1 = iBeta2 = m_iBetaPoints - 1;
+		} else {
+			iBeta1 = (int)floorf(fPos);
+			fBetaFrac = fPos - (float)iBeta1;
+			iBeta2 = iBeta1 + 1;
+		}
+	}
+
+	// Cell in the sequence of getCell
+	qIndices.iIndex1 = getRecordIndex(iAlpha1, iBeta1);
+	qIndices.iIndex2 = getRecordIndex(iAlpha1, iBeta2);
+	qIndices.iIndex3 = getRecordIndex(iAlpha2, iBeta2);
+	qIndices.iIndex4 = getRecordIndex(iAlpha2, iBeta1);
+
+	pfWeights[0] = (1.0f - fAlphaFrac) * (1.0f - fBetaFrac);
+	pfWeights[1] = (1.0f - fAlphaFrac) * fBetaFrac;
+	pfWeights[2] = fAlphaFrac * fBetaFrac;
+	pfWeights[3] = fAlphaFrac * (1.0f - fBetaFrac);
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFInterpolator::interpolate(int iView, float fAngle1Deg, float fAngle2Deg, int iChannel, float* pfDest) const
+{
+	int iLength = getDataLength();
+	if (iLength == 0)
+		return DAFF_MODAL_ERROR;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	DAFFQuad qIndices;
+	float pfWeights[4];
+	int iError = getWeights(iView, fAngle1Deg, fAngle2Deg, qIndices, pfWeights);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	// Merge coinciding records (poles, boundaries), so that every record is read once
+	int piIndices[4] = { qIndices.iIndex1, qIndices.iIndex2, qIndices.iIndex3, qIndices.iIndex4 };
+	for (int i = 1; i < 4; i++)
+		for (int j = 0; j < i; j++)
+			if (piIndices[j] == piIndices[i]) {
+				pfWeights[j] += pfWeights[i];
+				pfWeights[i] = 0.0f;
+				break;
+			}
+
+	memset(pfDest, 0, iLength * sizeof(float));
+
+	for (int i = 0; i < 4; i++) {
+		if (pfWeights[i] == 0.0f)
+			continue;
+
+		if (m_pContentIR)
+			iError = m_pContentIR->addFilterCoeffs(piIndices[i], iChannel, pfDest, pfWeights[i]);
+		else if (m_pContentMS)
+			iError = m_pContentMS->addMagnitudes(piIndices[i], iChannel, pfDest, pfWeights[i]);
+		else
+			iError = m_pContentDFT->addDFTCoeffs(piIndices[i], iChannel, pfDest, pfWeights[i]);
+
+		if (iError != DAFF_NO_ERROR)
+			return iError;
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFInterpolator::getRecordIndex(int iAlpha, int iBeta) const
+{
+	if (m_bSouthPole) {
+		if (iBeta == 0)
+			return 0;  // South pole
+		if (m_bNorthPole && (iBeta == m_iBetaPoints - 1))
+			return 1 + (iBeta - 1) * m_iAlphaPoints;  // North pole
+		return 1 + (iBeta - 1) * m_iAlphaPoints + iAlpha;
+	}
+
+	if (m_bNorthPole && (iBeta == m_iBetaPoints - 1))
+		return iBeta * m_iAlphaPoints;  // North pole
+	return iBeta * m_iAlphaPoints + iAlpha;
+}
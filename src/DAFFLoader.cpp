@@ -0,0 +1,102 @@
+#include <DAFFLoader.h>
+
+#include <DAFFContentCache.h>
+#include <DAFFReader.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <system_error>
+#include <thread>
+
+//! Files of a load, shared by the loading threads
+struct DAFFLoaderJob {
+	std::vector<std::string> vsFilePaths;                       //!@ Distinct file paths
+	std::vector<std::shared_ptr<const DAFFReader> > vpReaders;  //!@ Readers of the distinct files
+	std::vector<int> viErrorCodes;                              //!@ Errors of the distinct files
+	int iOpenFlags;                                             //!@ Open flags
+	std::atomic<size_t> nNextFile;                              //!@ Next file to be loaded
+};
+
+//! Loads the files of a job until all have been taken (each file is taken by one thread)
+static void loadFiles(DAFFLoaderJob* pJob)
+{
+	for (size_t i = pJob->nNextFile++; i < pJob->vsFilePaths.size(); i = pJob->nNextFile++)
+		pJob->viErrorCodes[i] = DAFFContentCache::open(pJob->vsFilePaths[i], pJob->vpReaders[i], pJob->iOpenFlags);
+}
+
+DAFFLoader::DAFFLoader() : m_iOpenFlags(DAFF_OPEN_DEFAULT), m_iNumThreads(0) {}
+
+DAFFLoader::~DAFFLoader() {}
+
+int DAFFLoader::getOpenFlags() const
+{
+	return m_iOpenFlags;
+}
+
+void DAFFLoader::setOpenFlags(int iOpenFlags)
+{
+	m_iOpenFlags = iOpenFlags;
+}
+
+int DAFFLoader::getNumThreads() const
+{
+	return m_iNumThreads;
+}
+
+void DAFFLoader::setNumThreads(int iNumThreads)
+{
+	m_iNumThreads = iNumThreads;
+}
+
+int DAFFLoader::load(const std::vector<std::string>& vsFilePaths,
+					 std::vector<std::shared_ptr<const DAFFReader> >& vpReaders, std::vector<int>& viErrorCodes) const
+{
+	// Paths listed several times are loaded once (the content cache unifies different paths of a file)
+	DAFFLoaderJob oJob;
+	std::map<std::string, size_t> mFileIndices;
+	std::vector<size_t> vnFileIndices(vsFilePaths.size());
+	for (size_t i = 0; i < vsFilePaths.size(); i++) {
+		std::map<std::string, size_t>::iterator it = mFileIndices.find(vsFilePaths[i]);
+		if (it == mFileIndices.end()) {
+			it = mFileIndices.insert(std::make_pair(vsFilePaths[i], oJob.vsFilePaths.size())).first;
+			oJob.vsFilePaths.push_back(vsFilePaths[i]);
+		}
+		vnFileIndices[i] = it->second;
+	}
+
+	oJob.vpReaders.resize(oJob.vsFilePaths.size());
+	oJob.viErrorCodes.assign(oJob.vsFilePaths.size(), DAFF_NO_ERROR);
+	oJob.iOpenFlags = m_iOpenFlags;
+	oJob.nNextFile = 0;
+
+	int iNumThreads = m_iNumThreads;
+	if (iNumThreads <= 0)
+		iNumThreads = (int)std::max(std::thread::hardware_concurrency(), 1u);
+	iNumThreads = (int)std::min((size_t)iNumThreads, oJob.vsFilePaths.size());
+
+	// The calling thread loads as well
+	std::vector<std::thread> vThreads;
+	try {
+		for (int i = 1; i < iNumThreads; i++)
+			vThreads.push_back(std::thread(&loadFiles, &oJob));
+	} catch (const std::system_error&) {
+		// Not enough threads available, load with the ones started
+	}
+
+	loadFiles(&oJob);
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	int iError = DAFF_NO_ERROR;
+	vpReaders.resize(vsFilePaths.size());
+	viErrorCodes.resize(vsFilePaths.size());
+	for (size_t i = 0; i < vsFilePaths.size(); i++) {
+		vpReaders[i] = oJob.vpReaders[vnFileIndices[i]];
+		viErrorCodes[i] = oJob.viErrorCodes[vnFileIndices[i]];
+		if ((iError == DAFF_NO_ERROR) && (viErrorCodes[i] != DAFF_NO_ERROR))
+			iError = viErrorCodes[i];
+	}
+
+	return iError;
+}
@@ -0,0 +1,167 @@
+// Use 64-bit off_t on 32-bit POSIX systems (must precede all system includes)
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include "DAFFMappedFile.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+DAFFMappedFile::DAFFMappedFile()
+	: m_pData(NULL), m_nSize(0)
+#ifdef WIN32
+	  ,
+	  m_hFile(NULL), m_hMapping(NULL)
+#endif
+{
+}
+
+DAFFMappedFile::~DAFFMappedFile()
+{
+	close();
+}
+
+int DAFFMappedFile::open(const std::string& sFilePath)
+{
+	if (m_pData)
+		return DAFF_MODAL_ERROR;
+
+#ifdef WIN32
+	HANDLE hFile = CreateFileA(sFilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+							   FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return DAFF_FILE_NOT_FOUND;
+
+	LARGE_INTEGER liSize;
+	if (!GetFileSizeEx(hFile, &liSize) || (liSize.QuadPart == 0) || ((uint64_t)liSize.QuadPart > (size_t)-1)) {
+		CloseHandle(hFile);
+		return DAFF_FILE_INVALID;
+	}
+
+	HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (hMapping == NULL) {
+		CloseHandle(hFile);
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	void* pView = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (pView == NULL) {
+		CloseHandle(hMapping);
+		CloseHandle(hFile);
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	m_hFile = hFile;
+	m_hMapping = hMapping;
+	m_pData = (const char*)pView;
+	m_nSize = (size_t)liSize.QuadPart;
+#else
+	int iFD = ::open(sFilePath.c_str(), O_RDONLY);
+	if (iFD < 0)
+		return DAFF_FILE_NOT_FOUND;
+
+	struct stat statinfo;
+	if ((fstat(iFD, &statinfo) != 0) || (statinfo.st_size <= 0) || ((uint64_t)statinfo.st_size > (size_t)-1)) {
+		::close(iFD);
+		return DAFF_FILE_INVALID;
+	}
+
+	size_t nSize = (size_t)statinfo.st_size;
+	void* pView = mmap(NULL, nSize, PROT_READ, MAP_SHARED, iFD, 0);
+
+	// The mapping stays valid after closing the descriptor
+	::close(iFD);
+
+	if (pView == MAP_FAILED)
+		return DAFF_FILE_CORRUPTED;
+
+	m_pData = (const char*)pView;
+	m_nSize = nSize;
+#endif
+
+	return DAFF_NO_ERROR;
+}
+
+void DAFFMappedFile::close()
+{
+	if (!m_pData)
+		return;
+
+#ifdef WIN32
+	UnmapViewOfFile(m_pData);
+	CloseHandle((HANDLE)m_hMapping);
+	CloseHandle((HANDLE)m_hFile);
+	m_hMapping = NULL;
+	m_hFile = NULL;
+#else
+	munmap((void*)m_pData, m_nSize);
+#endif
+
+	m_pData = NULL;
+	m_nSize = 0;
+}
+
+bool DAFFMappedFile::isOpened() const
+{
+	return (m_pData != NULL);
+}
+
+const char* DAFFMappedFile::getData() const
+{
+	return m_pData;
+}
+
+uint64_t DAFFMappedFile::getSize() const
+{
+	return (uint64_t)m_nSize;
+}
+
+int DAFFMappedFile::read(uint64_t ui64Offset, void* pDest, size_t nBytes)
+{
+	if (!m_pData)
+		return DAFF_MODAL_ERROR;
+
+	if ((ui64Offset > m_nSize) || (nBytes > m_nSize - ui64Offset))
+		return DAFF_FILE_CORRUPTED;
+
+	memcpy(pDest, m_pData + ui64Offset, nBytes);
+	return DAFF_NO_ERROR;
+}
+
+const char* DAFFMappedFile::map()
+{
+	return m_pData;
+}
+
+void DAFFMappedFile::prefetch(const void* pData, size_t nBytes) const
+{
+	const char* pBegin = static_cast<const char*>(pData);
+	if (!m_pData || (pBegin < m_pData) || (pBegin >= m_pData + m_nSize) || (nBytes == 0))
+		return;
+
+	if (nBytes > (size_t)(m_pData + m_nSize - pBegin))
+		nBytes = (size_t)(m_pData + m_nSize - pBegin);
+
+#ifdef WIN32
+#if defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0602)
+	// Windows 8 and later
+	WIN32_MEMORY_RANGE_ENTRY oRange;
+	oRange.VirtualAddress = (PVOID)pBegin;
+	oRange.NumberOfBytes = nBytes;
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &oRange, 0);
+#endif
+#else
+	// madvise requires a page aligned start (the mapping itself is page aligned)
+	static const size_t nPageSize = (size_t)sysconf(_SC_PAGESIZE);
+	size_t nOffset = (size_t)(pBegin - m_pData);
+	size_t nAlignedOffset = nOffset - nOffset % nPageSize;
+	madvise((void*)(m_pData + nAlignedOffset), nBytes + nOffset - nAlignedOffset, MADV_WILLNEED);
+#endif
+}
@@ -0,0 +1,75 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_MAPPEDFILE
+#define IW_DAFF_MAPPEDFILE
+
+#include <DAFFDataSource.h>
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+#include <string>
+
+//! Read-only memory mapping of a whole file
+/**
+ * Uses mmap on POSIX systems and MapViewOfFile on Windows. The mapping is
+ * shared, so several processes opening the same file share the page cache.
+ */
+class DAFFMappedFile : public DAFFDataSource {
+  public:
+	DAFFMappedFile();
+	~DAFFMappedFile();
+
+	//! Maps the given file into memory
+	/**
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int open(const std::string& sFilePath);
+
+	//! Unmaps the file (if mapped)
+	void close();
+
+	//! Returns whether a file is mapped
+	bool isOpened() const;
+
+	//! Returns the start address of the mapping (NULL if not mapped)
+	const char* getData() const;
+
+	//! Returns the size of the mapping [Bytes]
+	uint64_t getSize() const;
+
+	//! Copies bytes out of the mapping
+	int read(uint64_t ui64Offset, void* pDest, size_t nBytes);
+
+	//! Returns the start address of the mapping
+	const char* map();
+
+	//! Advises the system to read a range of the mapping ahead (returns at once)
+	/**
+	 * The range is extended to whole pages. Without support by the system nothing is done.
+	 */
+	void prefetch(const void* pData, size_t nBytes) const;
+
+  private:
+	const char* m_pData;  //!@ Start of the mapped memory
+	size_t m_nSize;       //!@ Size of the mapped memory [Bytes]
+
+#ifdef WIN32
+	void* m_hFile;     //!@ Windows file handle
+	void* m_hMapping;  //!@ Windows file mapping handle
+#endif
+
+	// No copy
+	DAFFMappedFile(const DAFFMappedFile&);
+	DAFFMappedFile& operator=(const DAFFMappedFile&);
+};
+
+#endif  // IW_DAFF_MAPPEDFILE
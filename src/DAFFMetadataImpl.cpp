@@ -2,128 +2,181 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 
 #include "Utils.h"
 
-class DAFFMetadataKey {
-  public:
-	int m_iType;
-
-	inline DAFFMetadataKey(int iType) : m_iType(iType) {};
-
-	inline virtual ~DAFFMetadataKey() {};
-};
+//! Orders keys by name (stable sorting keeps the order of duplicates)
+static bool isKeyBefore(const DAFFMetadataKey& oKey1, const DAFFMetadataKey& oKey2)
+{
+	return (strcmp(oKey1.pszName, oKey2.pszName) < 0);
+}
 
-class DAFFMetadataKeyBool : public DAFFMetadataKey {
-  public:
-	bool m_bValue;
+//! Compares an upper case key name with a key name of any case (like strcmp)
+static int compareKeyName(const char* pszName, const std::string& sKey)
+{
+	for (size_t i = 0; i < sKey.length(); i++) {
+		int iChar1 = (unsigned char)pszName[i];
+		int iChar2 = toupper((unsigned char)sKey[i]);
+		if (iChar1 != iChar2)
+			return iChar1 - iChar2;
+		if (iChar1 == 0)
+			return -1;  // Null characters inside the search key
+	}
 
-	inline DAFFMetadataKeyBool(bool bValue) : DAFFMetadataKey(DAFFMetadata::DAFF_BOOL), m_bValue(bValue) {};
-};
+	return (unsigned char)pszName[sKey.length()];
+}
 
-class DAFFMetadataKeyInt : public DAFFMetadataKey {
-  public:
-	int m_iValue;
+//! Reads a null-terminated string in [p, pEnd) and advances p behind it (NULL if unterminated)
+static const char* readString(char*& p, const char* pEnd)
+{
+	char* pStringEnd = (char*)memchr(p, 0, pEnd - p);
+	if (pStringEnd == NULL)
+		return NULL;
 
-	inline DAFFMetadataKeyInt(int iValue) : DAFFMetadataKey(DAFFMetadata::DAFF_INT), m_iValue(iValue) {};
-};
+	const char* psz = p;
+	p = pStringEnd + 1;
+	return psz;
+}
 
-class DAFFMetadataKeyFloat : public DAFFMetadataKey {
-  public:
-	double m_dValue;
+DAFFMetadataImpl::DAFFMetadataImpl() : m_pData(NULL), m_nSize(0) {}
 
-	inline DAFFMetadataKeyFloat(double dValue) : DAFFMetadataKey(DAFFMetadata::DAFF_FLOAT), m_dValue(dValue) {};
-};
+int DAFFMetadataImpl::load(char* pData, size_t nSize, size_t& nBytesRead)
+{
+	int iError = scan(pData, nSize, nBytesRead);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
 
-class DAFFMetadataKeyString : public DAFFMetadataKey {
-  public:
-	std::string m_sValue;
+	defer(pData, nBytesRead);
+	ensureParsed();
+	return DAFF_NO_ERROR;
+}
 
-	inline DAFFMetadataKeyString(const std::string& sValue)
-		: DAFFMetadataKey(DAFFMetadata::DAFF_STRING), m_sValue(sValue) {};
-};
+int DAFFMetadataImpl::scan(const char* pData, size_t nSize, size_t& nBytesRead)
+{
+	// Without keys to fill the data is not modified
+	return readKeys(const_cast<char*>(pData), nSize, nBytesRead, NULL);
+}
 
-DAFFMetadataImpl::DAFFMetadataImpl() {}
+void DAFFMetadataImpl::defer(char* pData, size_t nSize)
+{
+	m_pData = pData;
+	m_nSize = nSize;
+}
 
-int DAFFMetadataImpl::load(void* pData, size_t& iBytesRead)
+int DAFFMetadataImpl::readKeys(char* pData, size_t nSize, size_t& nBytesRead, std::vector<DAFFMetadataKey>* pvKeys)
 {
-	char* p = (char*)pData;
+	char* p = pData;
+	const char* pEnd = pData + nSize;
 
 	// Read the number of keys
-	int* piNumKeys = (int*)p;
-	DAFF::le2se_4byte(piNumKeys, 1);
+	int32_t iNumKeys;
+	if (nSize < 4)
+		return DAFF_FILE_CORRUPTED;
+	memcpy(&iNumKeys, p, 4);
+	DAFF::le2se_4byte(&iNumKeys, 1);
 	p += 4;
 
-	int* piDatatype;
-	int* piValue;
-	double* pdValue;
-	std::string sValue;
+	// Every key takes at least 6 bytes (datatype, empty name, empty string)
+	if ((iNumKeys < 0) || ((size_t)iNumKeys > (nSize - 4) / 6))
+		return DAFF_FILE_CORRUPTED;
+	if (pvKeys)
+		pvKeys->reserve(iNumKeys);
 
 	// Read the keys
-	for (int i = 0; i < *piNumKeys; i++) {
+	for (int i = 0; i < iNumKeys; i++) {
+		DAFFMetadataKey oKey = { NULL, NULL, 0, 0, 0 };
+
 		// Datatype
-		piDatatype = (int*)p;
-		DAFF::le2se_4byte(piDatatype, 1);
+		if (pEnd - p < 4)
+			return DAFF_FILE_CORRUPTED;
+		memcpy(&oKey.iType, p, 4);
+		DAFF::le2se_4byte(&oKey.iType, 1);
 		p += 4;
 
 		// Key name
-		std::string sKey(p);
-		p += sKey.length() + 1;
+		char* pszName = p;
+		oKey.pszName = readString(p, pEnd);
+		if (oKey.pszName == NULL)
+			return DAFF_FILE_CORRUPTED;
 
 		// Value
-		switch (*piDatatype) {
+		switch (oKey.iType) {
 		case DAFF_BOOL:
-			piValue = (int*)p;
-			DAFF::le2se_4byte(piValue, 1);
-			p += 4;
-
-			insertKey(sKey, new DAFFMetadataKeyBool(*piValue != 0));
-			break;
-
 		case DAFF_INT:
-			piValue = (int*)p;
-			DAFF::le2se_4byte(piValue, 1);
+			if (pEnd - p < 4)
+				return DAFF_FILE_CORRUPTED;
+			memcpy(&oKey.iValue, p, 4);
+			DAFF::le2se_4byte(&oKey.iValue, 1);
 			p += 4;
-
-			insertKey(sKey, new DAFFMetadataKeyInt(*piValue));
 			break;
 
 		case DAFF_FLOAT:
-			pdValue = (double*)p;
-			DAFF::le2se_8byte(pdValue, 1);
+			if (pEnd - p < 8)
+				return DAFF_FILE_CORRUPTED;
+			memcpy(&oKey.dValue, p, 8);
+			DAFF::le2se_8byte(&oKey.dValue, 1);
 			p += 8;
-
-			insertKey(sKey, new DAFFMetadataKeyFloat(*pdValue));
 			break;
 
 		case DAFF_STRING:
-			sValue = p;
-			p += sValue.length() + 1;
-
-			insertKey(sKey, new DAFFMetadataKeyString(sValue));
+			oKey.pszValue = readString(p, pEnd);
+			if (oKey.pszValue == NULL)
+				return DAFF_FILE_CORRUPTED;
 			break;
 
 		default:
 			return DAFF_FILE_UNKOWN_METADATA_TYPE;
 		}
+
+		// Key names are converted to upper case for later key search
+		if (pvKeys) {
+			for (char* pc = pszName; *pc; pc++)
+				*pc = (char)toupper((unsigned char)*pc);
+			pvKeys->push_back(oKey);
+		}
 	}
 
-	iBytesRead = (size_t)(p - (char*)pData);
-	return 0;
+	nBytesRead = (size_t)(p - pData);
+	return DAFF_NO_ERROR;
 }
 
-DAFFMetadataImpl::~DAFFMetadataImpl()
+void DAFFMetadataImpl::parse() const
 {
-	// Delete all keys
-	std::for_each(m_mKeys.begin(), m_mKeys.end(), deleteMetadataKeyPair);
-	m_mKeys.clear();
+	// The data has been checked by scan()
+	size_t nBytesRead;
+	readKeys(m_pData, m_nSize, nBytesRead, &m_vKeys);
+
+	// Sorted keys for the binary search, a later key replaces an earlier one with the same name
+	std::stable_sort(m_vKeys.begin(), m_vKeys.end(), isKeyBefore);
+	size_t n = 0;
+	for (size_t i = 0; i < m_vKeys.size(); i++) {
+		if ((n > 0) && (strcmp(m_vKeys[n - 1].pszName, m_vKeys[i].pszName) == 0))
+			n--;
+		m_vKeys[n++] = m_vKeys[i];
+	}
+	m_vKeys.resize(n);
+}
+
+size_t DAFFMetadataImpl::getMemoryFootprint() const
+{
+	ensureParsed();
+	return m_vKeys.capacity() * sizeof(DAFFMetadataKey);
+}
+
+void DAFFMetadataImpl::ensureParsed() const
+{
+	if (m_pData)
+		std::call_once(m_fParsed, &DAFFMetadataImpl::parse, this);
 }
 
 bool DAFFMetadataImpl::isEmpty() const
 {
-	return m_mKeys.empty();
+	ensureParsed();
+	return m_vKeys.empty();
 }
 
 bool DAFFMetadataImpl::hasKey(const std::string& sKey) const
@@ -133,15 +186,17 @@ bool DAFFMetadataImpl::hasKey(const std::string& sKey) const
 
 void DAFFMetadataImpl::getKeys(std::vector<std::string>& vsKeyList) const
 {
+	ensureParsed();
 	vsKeyList.clear();
-	for (KeyMapConstIterator cit = m_mKeys.begin(); cit != m_mKeys.end(); ++cit)
-		vsKeyList.push_back(cit->first);
+	vsKeyList.reserve(m_vKeys.size());
+	for (size_t i = 0; i < m_vKeys.size(); i++)
+		vsKeyList.push_back(m_vKeys[i].pszName);
 }
 
 int DAFFMetadataImpl::getKeyType(const std::string& sKey) const
 {
 	const DAFFMetadataKey* pKey = findKey(sKey);
-	return (pKey != NULL ? pKey->m_iType : -1);
+	return (pKey != NULL ? pKey->iType : -1);
 }
 
 std::string DAFFMetadataImpl::getKeyString(const std::string& sKey) const
@@ -153,20 +208,20 @@ std::string DAFFMetadataImpl::getKeyString(const std::string& sKey) const
 		return "";
 
 	std::stringstream ss;
-	switch (pKey->m_iType) {
+	switch (pKey->iType) {
 	case DAFF_BOOL:
-		return (dynamic_cast<const DAFFMetadataKeyBool*>(pKey)->m_bValue ? "yes" : "no");
+		return (pKey->iValue != 0 ? "yes" : "no");
 
 	case DAFF_INT:
-		ss << dynamic_cast<const DAFFMetadataKeyInt*>(pKey)->m_iValue;
+		ss << pKey->iValue;
 		return ss.str();
 
 	case DAFF_FLOAT:
-		ss << dynamic_cast<const DAFFMetadataKeyFloat*>(pKey)->m_dValue;
+		ss << pKey->dValue;
 		return ss.str();
 
 	case DAFF_STRING:
-		return dynamic_cast<const DAFFMetadataKeyString*>(pKey)->m_sValue;
+		return pKey->pszValue;
 
 	default:
 		// This will never be reached, but satisfies the compiler warning...
@@ -174,80 +229,82 @@ std::string DAFFMetadataImpl::getKeyString(const std::string& sKey) const
 	}
 }
 
+const char* DAFFMetadataImpl::getKeyStringPtr(const std::string& sKey) const
+{
+	const DAFFMetadataKey* pKey = findKey(sKey);
+	return ((pKey != NULL) && (pKey->iType == DAFF_STRING) ? pKey->pszValue : NULL);
+}
+
 bool DAFFMetadataImpl::getKeyBool(const std::string& sKey) const
 {
 	const DAFFMetadataKey* pKey = findKey(sKey);
 	assert(pKey != NULL);
-	assert(pKey->m_iType == DAFF_BOOL);
+	assert(pKey->iType == DAFF_BOOL);
 
-	if ((pKey == NULL) || (pKey->m_iType != DAFF_BOOL))
+	if ((pKey == NULL) || (pKey->iType != DAFF_BOOL))
 		return 0;
-	return dynamic_cast<const DAFFMetadataKeyBool*>(pKey)->m_bValue;
+	return (pKey->iValue != 0);
 }
 
 int DAFFMetadataImpl::getKeyInt(const std::string& sKey) const
 {
 	const DAFFMetadataKey* pKey = findKey(sKey);
 	assert(pKey != NULL);
-	assert(pKey->m_iType == DAFF_INT);
+	assert(pKey->iType == DAFF_INT);
 
-	if ((pKey == NULL) || (pKey->m_iType != DAFF_INT))
+	if ((pKey == NULL) || (pKey->iType != DAFF_INT))
 		return 0;
-	return dynamic_cast<const DAFFMetadataKeyInt*>(pKey)->m_iValue;
+	return pKey->iValue;
 }
 
 double DAFFMetadataImpl::getKeyFloat(const std::string& sKey) const
 {
 	const DAFFMetadataKey* pKey = findKey(sKey);
 	assert(pKey != NULL);
-	assert((pKey->m_iType == DAFF_FLOAT) || (pKey->m_iType == DAFF_INT));
+	assert((pKey->iType == DAFF_FLOAT) || (pKey->iType == DAFF_INT));
 
 	if (pKey == NULL)
 		return 0;
-	if ((pKey->m_iType != DAFF_FLOAT) && (pKey->m_iType != DAFF_INT))
+	if ((pKey->iType != DAFF_FLOAT) && (pKey->iType != DAFF_INT))
 		return 0;
 
-	if (pKey->m_iType == DAFF_FLOAT)
-		return dynamic_cast<const DAFFMetadataKeyFloat*>(pKey)->m_dValue;
+	if (pKey->iType == DAFF_FLOAT)
+		return pKey->dValue;
 	else
-		return (double)dynamic_cast<const DAFFMetadataKeyInt*>(pKey)->m_iValue;
+		return (double)pKey->iValue;
 }
 
 std::string DAFFMetadataImpl::toString() const
 {
+	ensureParsed();
 	std::stringstream ss;
-	for (KeyMapConstIterator cit = m_mKeys.begin(); cit != m_mKeys.end(); ++cit) {
-		ss << cit->first << " = " << getKeyString(cit->first) << std::endl;
-	}
+	for (size_t i = 0; i < m_vKeys.size(); i++)
+		ss << m_vKeys[i].pszName << " = " << getKeyString(m_vKeys[i].pszName) << std::endl;
 
 	return ss.str();
 }
 
-void DAFFMetadataImpl::insertKey(const std::string& sName, DAFFMetadataKey* pKey)
-{
-	// For later key search: Ensure that the keyname is upper case
-	std::string sKeyUpper(sName);
-	std::transform(sKeyUpper.begin(), sKeyUpper.end(), sKeyUpper.begin(), (int (*)(int))::toupper);
-
-	m_mKeys[sKeyUpper] = pKey;
-};
-
 const DAFFMetadataKey* DAFFMetadataImpl::findKey(const std::string& sKey) const
 {
 	// Empty strings are no valid key names
 	if (sKey.empty())
 		return NULL;
 
-	// Convert the keyname to upper case
-	std::string sKeyUpper(sKey);
-	std::transform(sKeyUpper.begin(), sKeyUpper.end(), sKeyUpper.begin(), (int (*)(int))::toupper);
+	ensureParsed();
 
-	// Search in the keymap
-	KeyMapConstIterator cit = m_mKeys.find(sKeyUpper);
-	return (cit == m_mKeys.end() ? NULL : cit->second);
-}
+	// Binary search without converting the key name
+	size_t nBegin = 0, nEnd = m_vKeys.size();
+	while (nBegin < nEnd) {
+		size_t nMiddle = (nBegin + nEnd) / 2;
+		int iOrder = compareKeyName(m_vKeys[nMiddle].pszName, sKey);
+		if (iOrder == 0)
+			return &m_vKeys[nMiddle];
 
-void DAFFMetadataImpl::deleteMetadataKeyPair(const KeyPair& pKeyPair)
-{
-	delete pKeyPair.second;
+		if (iOrder < 0)
+			nBegin = nMiddle + 1;
+		else
+			nEnd = nMiddle;
+	}
+
+	return NULL;
 }
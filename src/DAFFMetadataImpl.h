@@ -14,18 +14,49 @@
 
 #include <DAFFMetadata.h>
 
-#include <map>
+#include <mutex>
+#include <vector>
 
-// Forward declarations
-class DAFFMetadataKey;
+//! Key of a metadata set
+/**
+ * Names and string values refer to the buffer the metadata set was loaded from.
+ */
+struct DAFFMetadataKey {
+	const char* pszName;   //!@ Key name (upper case)
+	const char* pszValue;  //!@ Value of string keys
+	double dValue;         //!@ Value of floating-point number keys
+	int iValue;            //!@ Value of boolean and integer number keys
+	int iType;             //!@ Key type
+};
 
 class DAFFMetadataImpl : public DAFFMetadata {
   public:
 	DAFFMetadataImpl();
-	~DAFFMetadataImpl();
 
-	// Load data from a buffer
-	int load(void* pData, size_t& iBytesRead);
+	//! Loads a metadata set from a buffer (once)
+	/**
+	 * The key names are converted to upper case in place. The keys refer to the names
+	 * and string values inside the buffer, which must therefore outlive the metadata set.
+	 *
+	 * \param [in]  pData       Serialized metadata set
+	 * \param [in]  nSize       Available bytes in the buffer
+	 * \param [out] nBytesRead  Size of the serialized metadata set [Bytes]
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int load(char* pData, size_t nSize, size_t& nBytesRead);
+
+	//! Checks a serialized metadata set and determines its size, without parsing it
+	static int scan(const char* pData, size_t nSize, size_t& nBytesRead);
+
+	//! Assigns a serialized metadata set checked by scan(), which is parsed on first access (thread-safe)
+	/**
+	 * The buffer is modified by the parsing (see load()) and must outlive the metadata set.
+	 */
+	void defer(char* pData, size_t nSize);
+
+	//! Returns the heap memory of the parsed keys [Bytes] (parses a deferred set)
+	size_t getMemoryFootprint() const;
 
 	// --= Implementation of the interface "DAFFMetadata" =--
 
@@ -34,6 +65,7 @@ class DAFFMetadataImpl : public DAFFMetadata {
 	void getKeys(std::vector<std::string>& vsKeyList) const;
 	int getKeyType(const std::string& sKey) const;
 	std::string getKeyString(const std::string& sKey) const;
+	const char* getKeyStringPtr(const std::string& sKey) const;
 	bool getKeyBool(const std::string& sKey) const;
 	int getKeyInt(const std::string& sKey) const;
 	double getKeyFloat(const std::string& sKey) const;
@@ -41,20 +73,22 @@ class DAFFMetadataImpl : public DAFFMetadata {
 	std::string toString() const;
 
   private:
-	typedef std::pair<std::string, DAFFMetadataKey*> KeyPair;
-	typedef std::map<std::string, DAFFMetadataKey*> KeyMap;
-	typedef std::map<std::string, DAFFMetadataKey*>::const_iterator KeyMapConstIterator;
+	char* m_pData;                                 //!@ Serialized metadata set (NULL: no keys)
+	size_t m_nSize;                                //!@ Size of the serialized metadata set [Bytes]
+	mutable std::once_flag m_fParsed;              //!@ The serialized metadata set has been parsed
+	mutable std::vector<DAFFMetadataKey> m_vKeys;  //!@ Keys sorted by name (without duplicates)
 
-	KeyMap m_mKeys;
+	//! Reads the keys of a serialized metadata set (only checks it if pvKeys is NULL)
+	static int readKeys(char* pData, size_t nSize, size_t& nBytesRead, std::vector<DAFFMetadataKey>* pvKeys);
 
-	//! Insert a key into the keymap
-	void insertKey(const std::string& sName, DAFFMetadataKey* pKey);
+	//! Parses the serialized metadata set into the keys
+	void parse() const;
 
-	//! Search for a key and return the pointer to it (NULL => key not found)
-	const DAFFMetadataKey* findKey(const std::string& sKey) const;
+	//! Parses the serialized metadata set on first call
+	void ensureParsed() const;
 
-	//! Delete functor for key pairs
-	static void deleteMetadataKeyPair(const KeyPair& pKeyPair);
+	//! Search for a key (case-insensitive) and return the pointer to it (NULL => key not found)
+	const DAFFMetadataKey* findKey(const std::string& sKey) const;
 };
 
 #endif  // IW_DAFF_METADATAIMPL
@@ -0,0 +1,146 @@
+#include "DAFFNUMA.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <cstdio>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#endif
+
+// Windows 7 and later provide the processor group aware NUMA API
+#if defined(WIN32) && defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0601)
+#define DAFF_NUMA_WINDOWS
+#endif
+
+#ifdef __linux__
+
+//! Processors of the NUMA nodes (Linux)
+struct DAFFNUMATopology {
+	std::vector<std::vector<int> > vviNodeCPUs;  //!@ Processors per node (empty nodes have no processors)
+	std::vector<int> viCPUNodes;                 //!@ Node per processor (-1: unknown)
+
+	DAFFNUMATopology();
+};
+
+//! Parses a list of processors or nodes like "0-3,8-11" (ascending)
+static void parseIndexList(FILE* pFile, std::vector<int>& viCPUs)
+{
+	int iFirst, iLast;
+	while (fscanf(pFile, "%d", &iFirst) == 1) {
+		iLast = iFirst;
+		int c = fgetc(pFile);
+		if ((c == '-') && (fscanf(pFile, "%d", &iLast) == 1))
+			c = fgetc(pFile);
+
+		for (int i = iFirst; (i <= iLast) && (i < CPU_SETSIZE); i++)
+			viCPUs.push_back(i);
+
+		if (c != ',')
+			break;
+	}
+}
+
+DAFFNUMATopology::DAFFNUMATopology()
+{
+	// Node numbers may have gaps (nodes without processors or memory)
+	std::vector<int> viNodes;
+	FILE* pFile = fopen("/sys/devices/system/node/online", "r");
+	if (pFile) {
+		parseIndexList(pFile, viNodes);
+		fclose(pFile);
+	}
+
+	int iNumNodes = (viNodes.empty() ? 1 : viNodes.back() + 1);
+	vviNodeCPUs.resize(iNumNodes);
+
+	char pszPath[64];
+	for (size_t n = 0; n < viNodes.size(); n++) {
+		int iNode = viNodes[n];
+		snprintf(pszPath, sizeof(pszPath), "/sys/devices/system/node/node%d/cpulist", iNode);
+		pFile = fopen(pszPath, "r");
+		if (!pFile)
+			continue;
+
+		std::vector<int>& viCPUs = vviNodeCPUs[iNode];
+		parseIndexList(pFile, viCPUs);
+		fclose(pFile);
+
+		for (size_t i = 0; i < viCPUs.size(); i++) {
+			if ((int)viCPUNodes.size() <= viCPUs[i])
+				viCPUNodes.resize(viCPUs[i] + 1, -1);
+			viCPUNodes[viCPUs[i]] = iNode;
+		}
+	}
+}
+
+//! Returns the topology (determined on first use)
+static const DAFFNUMATopology& getTopology()
+{
+	static const DAFFNUMATopology oTopology;
+	return oTopology;
+}
+
+#endif  // __linux__
+
+int DAFFNUMA::getNumNodes()
+{
+#if defined(__linux__)
+	return (int)getTopology().vviNodeCPUs.size();
+#elif defined(DAFF_NUMA_WINDOWS)
+	ULONG ulHighestNode = 0;
+	if (!GetNumaHighestNodeNumber(&ulHighestNode))
+		return 1;
+	return (int)ulHighestNode + 1;
+#else
+	return 1;
+#endif
+}
+
+int DAFFNUMA::getCurrentNode()
+{
+#if defined(__linux__)
+	const DAFFNUMATopology& oTopology = getTopology();
+	int iCPU = sched_getcpu();
+	if ((iCPU < 0) || (iCPU >= (int)oTopology.viCPUNodes.size()) || (oTopology.viCPUNodes[iCPU] < 0))
+		return 0;
+	return oTopology.viCPUNodes[iCPU];
+#elif defined(DAFF_NUMA_WINDOWS)
+	PROCESSOR_NUMBER oProcessor;
+	GetCurrentProcessorNumberEx(&oProcessor);
+	USHORT usNode = 0;
+	if (!GetNumaProcessorNodeEx(&oProcessor, &usNode) || (usNode == 0xFFFF))
+		return 0;
+	return (int)usNode;
+#else
+	return 0;
+#endif
+}
+
+bool DAFFNUMA::bindCurrentThread(int iNode)
+{
+	if ((iNode < 0) || (iNode >= getNumNodes()))
+		return false;
+
+#if defined(__linux__)
+	const std::vector<int>& viCPUs = getTopology().vviNodeCPUs[iNode];
+	if (viCPUs.empty())
+		return false;
+
+	cpu_set_t oSet;
+	CPU_ZERO(&oSet);
+	for (size_t i = 0; i < viCPUs.size(); i++)
+		CPU_SET(viCPUs[i], &oSet);
+	return (pthread_setaffinity_np(pthread_self(), sizeof(oSet), &oSet) == 0);
+#elif defined(DAFF_NUMA_WINDOWS)
+	GROUP_AFFINITY oAffinity;
+	if (!GetNumaNodeProcessorMaskEx((USHORT)iNode, &oAffinity) || (oAffinity.Mask == 0))
+		return false;
+	return (SetThreadGroupAffinity(GetCurrentThread(), &oAffinity, NULL) != 0);
+#else
+	return (iNode == 0);
+#endif
+}
@@ -0,0 +1,45 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_NUMA
+#define IW_DAFF_NUMA
+
+#include <DAFFDefs.h>
+
+//! NUMA topology of the system
+/**
+ * Used by the content cache to place one replica of a content per NUMA node. The nodes
+ * are determined once from /sys/devices/system/node on Linux and from the NUMA API on
+ * Windows. Other systems, and systems where the topology is not available, have a single node.
+ *
+ * Memory is placed on the node of the thread that first touches it (first-touch policy
+ * of Linux and Windows), so a reader loaded by a thread bound to a node keeps its data there.
+ */
+class DAFFNUMA {
+  public:
+	//! Returns the number of NUMA nodes (at least one)
+	static int getNumNodes();
+
+	//! Returns the node of the processor the calling thread is running on (0 if unknown)
+	static int getCurrentNode();
+
+	//! Binds the calling thread to the processors of a node
+	/**
+	 * @return True on success
+	 */
+	static bool bindCurrentThread(int iNode);
+
+  private:
+	// Only static methods
+	DAFFNUMA();
+};
+
+#endif  // IW_DAFF_NUMA
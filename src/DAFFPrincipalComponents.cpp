@@ -0,0 +1,663 @@
+#include <DAFFPrincipalComponents.h>
+
+#include <DAFFContent.h>
+#include <DAFFContentDFT.h>
+#include <DAFFContentIR.h>
+#include <DAFFContentMPS.h>
+#include <DAFFContentMS.h>
+#include <DAFFContentPS.h>
+#include <DAFFProperties.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <system_error>
+#include <thread>
+
+#include "Utils.h"
+
+//! Signature of principal component files
+static const char DAFF_PCA_SIGNATURE[4] = { 'D', 'P', 'C', 'A' };
+
+//! Version of the principal component file format
+static const int DAFF_PCA_VERSION = 1;
+
+//! Number of rows (records or values) processed by a thread at once
+static const int DAFF_PCA_BLOCK_SIZE = 64;
+
+//! Additional columns of the randomized range finder
+static const int DAFF_PCA_OVERSAMPLING = 8;
+
+//! Power iterations of the randomized range finder (sharpen the decay of the singular values)
+static const int DAFF_PCA_POWER_ITERATIONS = 4;
+
+//! Sweeps of the Jacobi eigenvalue method
+static const int DAFF_PCA_JACOBI_SWEEPS = 50;
+
+//! Operations of a fitting job
+enum {
+	DAFF_PCA_LOAD,                //!@ Read the values of the records into the data matrix
+	DAFF_PCA_MULTIPLY,            //!@ Out [record][column] = Data [record][value] * In [value][column]
+	DAFF_PCA_MULTIPLY_TRANSPOSED  //!@ Out [value][column] = Data^T [value][record] * In [record][column]
+};
+
+//! Data of a channel and the operation of a fit, shared by the fitting threads
+struct DAFFPCAFitJob {
+	const DAFFContentIR* pContentIR;    //!@ Content as impulse responses (or NULL)
+	const DAFFContentMS* pContentMS;    //!@ Content as magnitude spectra (or NULL)
+	const DAFFContentPS* pContentPS;    //!@ Content as phase spectra (or NULL)
+	const DAFFContentMPS* pContentMPS;  //!@ Content as magnitude-phase spectra (or NULL)
+	const DAFFContentDFT* pContentDFT;  //!@ Content as DFT spectra (or NULL)
+	int iChannel;                       //!@ Channel
+	int iNumRecords;                    //!@ Number of records
+	int iDataLength;                    //!@ Number of values per channel
+	float* pfData;                      //!@ Data matrix of the channel [record][value]
+	int iOperation;                     //!@ Operation
+	int iNumColumns;                    //!@ Columns of the operands of the multiplications
+	const double* pdIn;                 //!@ Input operand of the multiplications
+	double* pdOut;                      //!@ Output operand of the multiplications
+	std::atomic<int> iNextBlock;        //!@ Next block of rows to be processed
+	std::atomic<int> iError;            //!@ First error of a thread
+};
+
+//! Reads the values of a record channel
+static int getValues(const DAFFPCAFitJob* pJob, int iRecordIndex, float* pfDest)
+{
+	if (pJob->pContentIR)
+		return pJob->pContentIR->getFilterCoeffs(iRecordIndex, pJob->iChannel, pfDest);
+	if (pJob->pContentMS)
+		return pJob->pContentMS->getMagnitudes(iRecordIndex, pJob->iChannel, pfDest);
+	if (pJob->pContentPS)
+		return pJob->pContentPS->getPhases(iRecordIndex, pJob->iChannel, pfDest);
+	if (pJob->pContentMPS)
+		return pJob->pContentMPS->getCoefficientsRI(iRecordIndex, pJob->iChannel, pfDest);
+	return pJob->pContentDFT->getDFTCoeffs(iRecordIndex, pJob->iChannel, pfDest);
+}
+
+//! Processes blocks of output rows of the operation until all have been taken
+static void processBlocks(DAFFPCAFitJob* pJob)
+{
+	const int N = pJob->iNumRecords;
+	const int L = pJob->iDataLength;
+	const int P = pJob->iNumColumns;
+	const int iNumRows = (pJob->iOperation == DAFF_PCA_MULTIPLY_TRANSPOSED ? L : N);
+
+	for (int iBegin = DAFF_PCA_BLOCK_SIZE * pJob->iNextBlock++;
+		 (iBegin < iNumRows) && (pJob->iError == DAFF_NO_ERROR); iBegin = DAFF_PCA_BLOCK_SIZE * pJob->iNextBlock++) {
+		int iEnd = std::min(iBegin + DAFF_PCA_BLOCK_SIZE, iNumRows);
+
+		if (pJob->iOperation == DAFF_PCA_LOAD) {
+			for (int r = iBegin; r < iEnd; r++) {
+				int iError = getValues(pJob, r, pJob->pfData + (size_t)r * L);
+				if (iError != DAFF_NO_ERROR) {
+					int iNoError = DAFF_NO_ERROR;
+					pJob->iError.compare_exchange_strong(iNoError, iError);
+					return;
+				}
+			}
+		} else if (pJob->iOperation == DAFF_PCA_MULTIPLY) {
+			for (int r = iBegin; r < iEnd; r++) {
+				const float* pfRow = pJob->pfData + (size_t)r * L;
+				double* pdOut = pJob->pdOut + (size_t)r * P;
+				std::fill(pdOut, pdOut + P, 0.0);
+				for (int l = 0; l < L; l++) {
+					double a = pfRow[l];
+					const double* pdIn = pJob->pdIn + (size_t)l * P;
+					for (int j = 0; j < P; j++)
+						pdOut[j] += a * pdIn[j];
+				}
+			}
+		} else {
+			// The values of the block are accumulated over all records
+			std::fill(pJob->pdOut + (size_t)iBegin * P, pJob->pdOut + (size_t)iEnd * P, 0.0);
+			for (int r = 0; r < N; r++) {
+				const float* pfRow = pJob->pfData + (size_t)r * L;
+				const double* pdIn = pJob->pdIn + (size_t)r * P;
+				for (int l = iBegin; l < iEnd; l++) {
+					double a = pfRow[l];
+					double* pdOut = pJob->pdOut + (size_t)l * P;
+					for (int j = 0; j < P; j++)
+						pdOut[j] += a * pdIn[j];
+				}
+			}
+		}
+	}
+}
+
+//! Runs an operation with several threads (0: automatic)
+static int runOperation(DAFFPCAFitJob* pJob, int iOperation, int iNumThreads)
+{
+	pJob->iOperation = iOperation;
+	pJob->iNextBlock = 0;
+	pJob->iError = DAFF_NO_ERROR;
+
+	int iNumRows = (iOperation == DAFF_PCA_MULTIPLY_TRANSPOSED ? pJob->iDataLength : pJob->iNumRecords);
+	int iNumBlocks = (iNumRows + DAFF_PCA_BLOCK_SIZE - 1) / DAFF_PCA_BLOCK_SIZE;
+	if (iNumThreads <= 0)
+		iNumThreads = (int)std::max(std::thread::hardware_concurrency(), 1u);
+	iNumThreads = std::max(std::min(iNumThreads, iNumBlocks), 1);
+
+	// The calling thread processes blocks as well
+	std::vector<std::thread> vThreads;
+	try {
+		for (int i = 1; i < iNumThreads; i++)
+			vThreads.push_back(std::thread(&processBlocks, pJob));
+	} catch (const std::system_error&) {
+		// Not enough threads available, process with the ones started
+	}
+
+	processBlocks(pJob);
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	return pJob->iError;
+}
+
+//! Converts to single precision, denormals are flushed to zero (they slow down the reconstruction)
+static float toFloat(double d)
+{
+	return (std::fabs(d) < FLT_MIN ? 0.0f : (float)d);
+}
+
+//! Orthonormalizes the columns of a matrix [row][column] in place (modified Gram-Schmidt, twice)
+static void orthonormalize(double* pdMatrix, int iNumRows, int iNumColumns)
+{
+	for (int j = 0; j < iNumColumns; j++) {
+		double dNormBefore = 0;
+		for (int i = 0; i < iNumRows; i++)
+			dNormBefore += pdMatrix[(size_t)i * iNumColumns + j] * pdMatrix[(size_t)i * iNumColumns + j];
+
+		for (int iPass = 0; iPass < 2; iPass++) {
+			for (int k = 0; k < j; k++) {
+				double d = 0;
+				for (int i = 0; i < iNumRows; i++)
+					d += pdMatrix[(size_t)i * iNumColumns + k] * pdMatrix[(size_t)i * iNumColumns + j];
+				for (int i = 0; i < iNumRows; i++)
+					pdMatrix[(size_t)i * iNumColumns + j] -= d * pdMatrix[(size_t)i * iNumColumns + k];
+			}
+		}
+
+		double dNorm = 0;
+		for (int i = 0; i < iNumRows; i++)
+			dNorm += pdMatrix[(size_t)i * iNumColumns + j] * pdMatrix[(size_t)i * iNumColumns + j];
+
+		// Columns in the span of the previous ones (rank deficient data) are dropped
+		double f = (dNorm > 1e-24 * dNormBefore ? 1.0 / std::sqrt(dNorm) : 0.0);
+		for (int i = 0; i < iNumRows; i++)
+			pdMatrix[(size_t)i * iNumColumns + j] *= f;
+	}
+}
+
+//! Eigen decomposition of a symmetric matrix by the cyclic Jacobi method, eigenvalues descending
+/**
+ * The matrix is diagonalized in place, the columns of the eigenvector matrix are the eigenvectors.
+ */
+static void jacobiEigen(double* pdMatrix, int M, double* pdEigenvalues, double* pdEigenvectors)
+{
+	for (int i = 0; i < M; i++)
+		for (int j = 0; j < M; j++)
+			pdEigenvectors[(size_t)i * M + j] = (i == j ? 1.0 : 0.0);
+
+	for (int iSweep = 0; iSweep < DAFF_PCA_JACOBI_SWEEPS; iSweep++) {
+		double dOff = 0, dDiag = 0;
+		for (int i = 0; i < M; i++) {
+			dDiag += pdMatrix[(size_t)i * M + i] * pdMatrix[(size_t)i * M + i];
+			for (int j = i + 1; j < M; j++)
+				dOff += pdMatrix[(size_t)i * M + j] * pdMatrix[(size_t)i * M + j];
+		}
+		if (dOff <= 1e-30 * dDiag)
+			break;
+
+		for (int p = 0; p < M - 1; p++) {
+			for (int q = p + 1; q < M; q++) {
+				double dPQ = pdMatrix[(size_t)p * M + q];
+				if (dPQ == 0)
+					continue;
+
+				// Rotation that annihilates the element (p, q)
+				double dTheta = (pdMatrix[(size_t)q * M + q] - pdMatrix[(size_t)p * M + p]) / (2 * dPQ);
+				double t = (dTheta >= 0 ? 1.0 : -1.0) / (std::fabs(dTheta) + std::sqrt(dTheta * dTheta + 1));
+				double c = 1 / std::sqrt(t * t + 1);
+				double s = t * c;
+
+				for (int k = 0; k < M; k++) {
+					double dKP = pdMatrix[(size_t)k * M + p];
+					double dKQ = pdMatrix[(size_t)k * M + q];
+					pdMatrix[(size_t)k * M + p] = c * dKP - s * dKQ;
+					pdMatrix[(size_t)k * M + q] = s * dKP + c * dKQ;
+				}
+				for (int k = 0; k < M; k++) {
+					double dPK = pdMatrix[(size_t)p * M + k];
+					double dQK = pdMatrix[(size_t)q * M + k];
+					pdMatrix[(size_t)p * M + k] = c * dPK - s * dQK;
+					pdMatrix[(size_t)q * M + k] = s * dPK + c * dQK;
+				}
+				for (int k = 0; k < M; k++) {
+					double dKP = pdEigenvectors[(size_t)k * M + p];
+					double dKQ = pdEigenvectors[(size_t)k * M + q];
+					pdEigenvectors[(size_t)k * M + p] = c * dKP - s * dKQ;
+					pdEigenvectors[(size_t)k * M + q] = s * dKP + c * dKQ;
+				}
+			}
+		}
+	}
+
+	// Selection sort of the eigenpairs
+	for (int i = 0; i < M; i++)
+		pdEigenvalues[i] = pdMatrix[(size_t)i * M + i];
+	for (int i = 0; i < M; i++) {
+		int iMax = i;
+		for (int j = i + 1; j < M; j++)
+			if (pdEigenvalues[j] > pdEigenvalues[iMax])
+				iMax = j;
+		if (iMax == i)
+			continue;
+
+		std::swap(pdEigenvalues[i], pdEigenvalues[iMax]);
+		for (int k = 0; k < M; k++)
+			std::swap(pdEigenvectors[(size_t)k * M + i], pdEigenvectors[(size_t)k * M + iMax]);
+	}
+}
+
+DAFFPrincipalComponents::DAFFPrincipalComponents()
+	: m_iNumComponents(0), m_iContentType(-1), m_iNumRecords(0), m_iNumChannels(0), m_iDataLength(0),
+	  m_iNumThreads(0)
+{
+}
+
+DAFFPrincipalComponents::~DAFFPrincipalComponents() {}
+
+bool DAFFPrincipalComponents::isValid() const
+{
+	return (m_iNumComponents > 0);
+}
+
+int DAFFPrincipalComponents::getNumComponents() const
+{
+	return m_iNumComponents;
+}
+
+int DAFFPrincipalComponents::getContentType() const
+{
+	return m_iContentType;
+}
+
+int DAFFPrincipalComponents::getNumRecords() const
+{
+	return m_iNumRecords;
+}
+
+int DAFFPrincipalComponents::getNumChannels() const
+{
+	return m_iNumChannels;
+}
+
+int DAFFPrincipalComponents::getDataLength() const
+{
+	return m_iDataLength;
+}
+
+int DAFFPrincipalComponents::getNumThreads() const
+{
+	return m_iNumThreads;
+}
+
+void DAFFPrincipalComponents::setNumThreads(int iNumThreads)
+{
+	m_iNumThreads = (iNumThreads > 0 ? iNumThreads : 0);
+}
+
+void DAFFPrincipalComponents::clear()
+{
+	m_iNumComponents = 0;
+	m_iContentType = -1;
+	m_iNumRecords = 0;
+	m_iNumChannels = 0;
+	m_iDataLength = 0;
+	std::vector<float>().swap(m_vfBasis);
+	std::vector<float>().swap(m_vfWeights);
+	std::vector<float>().swap(m_vfExplained);
+	std::vector<const float*>().swap(m_vpfRows);
+}
+
+void DAFFPrincipalComponents::init(int iNumComponents, int iContentType, int iNumRecords, int iNumChannels,
+								   int iDataLength)
+{
+	m_iNumComponents = iNumComponents;
+	m_iContentType = iContentType;
+	m_iNumRecords = iNumRecords;
+	m_iNumChannels = iNumChannels;
+	m_iDataLength = iDataLength;
+
+	m_vfBasis.assign((size_t)iNumChannels * (iNumComponents + 1) * iDataLength, 0.0f);
+	m_vfWeights.assign((size_t)iNumChannels * iNumRecords * iNumComponents, 0.0f);
+	m_vfExplained.assign(iNumChannels, 0.0f);
+	m_vpfRows.resize((size_t)iNumChannels * (iNumComponents + 1));
+	for (size_t i = 0; i < m_vpfRows.size(); i++)
+		m_vpfRows[i] = &m_vfBasis[i * iDataLength];
+}
+
+int DAFFPrincipalComponents::fit(const DAFFContent* pContent, int iNumComponents)
+{
+	clear();
+
+	assert(pContent != NULL);
+	assert((iNumComponents > 0) && (iNumComponents <= MAX_COMPONENTS));
+
+	if (!pContent || (iNumComponents <= 0) || (iNumComponents > MAX_COMPONENTS))
+		return DAFF_MODAL_ERROR;
+
+	const DAFFProperties* pProps = pContent->getProperties();
+	DAFFPCAFitJob oJob;
+	oJob.pContentIR = NULL;
+	oJob.pContentMS = NULL;
+	oJob.pContentPS = NULL;
+	oJob.pContentMPS = NULL;
+	oJob.pContentDFT = NULL;
+
+	int iDataLength = 0;
+	switch (pProps->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		oJob.pContentIR = dynamic_cast<const DAFFContentIR*>(pContent);
+		iDataLength = (oJob.pContentIR ? oJob.pContentIR->getFilterLength() : 0);
+		break;
+	case DAFF_MAGNITUDE_SPECTRUM:
+		oJob.pContentMS = dynamic_cast<const DAFFContentMS*>(pContent);
+		iDataLength = (oJob.pContentMS ? oJob.pContentMS->getNumFrequencies() : 0);
+		break;
+	case DAFF_PHASE_SPECTRUM:
+		oJob.pContentPS = dynamic_cast<const DAFFContentPS*>(pContent);
+		iDataLength = (oJob.pContentPS ? oJob.pContentPS->getNumFrequencies() : 0);
+		break;
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		oJob.pContentMPS = dynamic_cast<const DAFFContentMPS*>(pContent);
+		iDataLength = (oJob.pContentMPS ? 2 * oJob.pContentMPS->getNumFrequencies() : 0);
+		break;
+	case DAFF_DFT_SPECTRUM:
+		oJob.pContentDFT = dynamic_cast<const DAFFContentDFT*>(pContent);
+		iDataLength = (oJob.pContentDFT ? 2 * oJob.pContentDFT->getNumDFTCoeffs() : 0);
+		break;
+	}
+
+	const int N = pProps->getNumberOfRecords();
+	const int L = iDataLength;
+	int iNumChannels = pProps->getNumberOfChannels();
+	if ((L <= 0) || (N <= 0) || (iNumChannels <= 0))
+		return DAFF_MODAL_ERROR;
+
+	// The rank of the data limits the number of components
+	const int K = std::min(iNumComponents, std::min(N, L));
+	const int P = std::min(K + DAFF_PCA_OVERSAMPLING, std::min(N, L));
+	init(K, pProps->getContentType(), N, iNumChannels, L);
+
+	std::vector<float> vfData((size_t)N * L);
+	std::vector<double> vdY((size_t)N * P), vdZ((size_t)L * P);
+	std::vector<double> vdGram((size_t)P * P), vdEigenvalues(P), vdEigenvectors((size_t)P * P);
+	std::vector<double> vdMean(L), vdComponents((size_t)L * K), vdWeights((size_t)N * K);
+
+	oJob.iNumRecords = N;
+	oJob.iDataLength = L;
+	oJob.pfData = &vfData[0];
+	for (int c = 0; c < iNumChannels; c++) {
+		oJob.iChannel = c;
+		int iError = runOperation(&oJob, DAFF_PCA_LOAD, m_iNumThreads);
+		if (iError != DAFF_NO_ERROR) {
+			clear();
+			return iError;
+		}
+
+		// Mean-free data and its total variance
+		std::fill(vdMean.begin(), vdMean.end(), 0.0);
+		for (int r = 0; r < N; r++)
+			for (int l = 0; l < L; l++)
+				vdMean[l] += vfData[(size_t)r * L + l];
+		for (int l = 0; l < L; l++)
+			vdMean[l] /= N;
+
+		double dTotal = 0;
+		for (int r = 0; r < N; r++) {
+			for (int l = 0; l < L; l++) {
+				float& fValue = vfData[(size_t)r * L + l];
+				fValue = (float)(fValue - vdMean[l]);
+				dTotal += (double)fValue * fValue;
+			}
+		}
+
+		// Randomized range finder Y = (A A^T)^q A Omega of the data A, with a reproducible Omega
+		std::mt19937 oGenerator(1);
+		std::uniform_real_distribution<double> oDistribution(-1.0, 1.0);
+		for (size_t i = 0; i < vdZ.size(); i++)
+			vdZ[i] = oDistribution(oGenerator);
+
+		oJob.iNumColumns = P;
+		oJob.pdIn = &vdZ[0];
+		oJob.pdOut = &vdY[0];
+		runOperation(&oJob, DAFF_PCA_MULTIPLY, m_iNumThreads);
+		orthonormalize(&vdY[0], N, P);
+		for (int q = 0; q < DAFF_PCA_POWER_ITERATIONS; q++) {
+			oJob.pdIn = &vdY[0];
+			oJob.pdOut = &vdZ[0];
+			runOperation(&oJob, DAFF_PCA_MULTIPLY_TRANSPOSED, m_iNumThreads);
+			orthonormalize(&vdZ[0], L, P);
+
+			oJob.pdIn = &vdZ[0];
+			oJob.pdOut = &vdY[0];
+			runOperation(&oJob, DAFF_PCA_MULTIPLY, m_iNumThreads);
+			orthonormalize(&vdY[0], N, P);
+		}
+
+		// Projection B^T = A^T Y onto the range, its right singular vectors from the eigenpairs of B B^T
+		oJob.pdIn = &vdY[0];
+		oJob.pdOut = &vdZ[0];
+		runOperation(&oJob, DAFF_PCA_MULTIPLY_TRANSPOSED, m_iNumThreads);
+
+		std::fill(vdGram.begin(), vdGram.end(), 0.0);
+		for (int l = 0; l < L; l++) {
+			const double* pdRow = &vdZ[(size_t)l * P];
+			for (int i = 0; i < P; i++)
+				for (int j = 0; j <= i; j++)
+					vdGram[(size_t)i * P + j] += pdRow[i] * pdRow[j];
+		}
+		for (int i = 0; i < P; i++)
+			for (int j = 0; j < i; j++)
+				vdGram[(size_t)j * P + i] = vdGram[(size_t)i * P + j];
+		jacobiEigen(&vdGram[0], P, &vdEigenvalues[0], &vdEigenvectors[0]);
+
+		// Components V = B^T U / sigma, singular values vanishing against the largest one are dropped
+		double dExplained = 0;
+		for (int k = 0; k < K; k++) {
+			double dEigenvalue = vdEigenvalues[k];
+			bool bSignificant = (dEigenvalue > 1e-12 * vdEigenvalues[0]) && (dEigenvalue > 0);
+			double f = (bSignificant ? 1.0 / std::sqrt(dEigenvalue) : 0.0);
+			if (bSignificant)
+				dExplained += dEigenvalue;
+
+			for (int l = 0; l < L; l++) {
+				double d = 0;
+				for (int j = 0; j < P; j++)
+					d += vdZ[(size_t)l * P + j] * vdEigenvectors[(size_t)j * P + k];
+				vdComponents[(size_t)l * K + k] = f * d;
+			}
+		}
+
+		// Weights W = A V of the records
+		oJob.iNumColumns = K;
+		oJob.pdIn = &vdComponents[0];
+		oJob.pdOut = &vdWeights[0];
+		runOperation(&oJob, DAFF_PCA_MULTIPLY, m_iNumThreads);
+
+		float* pfMean = &m_vfBasis[(size_t)c * (K + 1) * L];
+		for (int l = 0; l < L; l++)
+			pfMean[l] = toFloat(vdMean[l]);
+		for (int k = 0; k < K; k++)
+			for (int l = 0; l < L; l++)
+				pfMean[(size_t)(k + 1) * L + l] = toFloat(vdComponents[(size_t)l * K + k]);
+		for (size_t i = 0; i < (size_t)N * K; i++)
+			m_vfWeights[(size_t)c * N * K + i] = toFloat(vdWeights[i]);
+		m_vfExplained[c] = (float)(dTotal > 0 ? std::min(dExplained / dTotal, 1.0) : 1.0);
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+const float* DAFFPrincipalComponents::getMeanPtr(int iChannel) const
+{
+	if (!isValid() || (iChannel < 0) || (iChannel >= m_iNumChannels))
+		return NULL;
+	return m_vpfRows[(size_t)iChannel * (m_iNumComponents + 1)];
+}
+
+const float* DAFFPrincipalComponents::getComponentsPtr(int iChannel) const
+{
+	if (!isValid() || (iChannel < 0) || (iChannel >= m_iNumChannels))
+		return NULL;
+	return m_vpfRows[(size_t)iChannel * (m_iNumComponents + 1) + 1];
+}
+
+const float* DAFFPrincipalComponents::getWeightsPtr(int iChannel) const
+{
+	if (!isValid() || (iChannel < 0) || (iChannel >= m_iNumChannels))
+		return NULL;
+	return &m_vfWeights[(size_t)iChannel * m_iNumRecords * m_iNumComponents];
+}
+
+float DAFFPrincipalComponents::getExplainedVariance(int iChannel) const
+{
+	if (!isValid() || (iChannel < 0) || (iChannel >= m_iNumChannels))
+		return 0.0f;
+	return m_vfExplained[iChannel];
+}
+
+int DAFFPrincipalComponents::reconstruct(int iRecordIndex, int iChannel, float* pfDest) const
+{
+	float fWeight = 1.0f;
+	return interpolate(&iRecordIndex, &fWeight, 1, iChannel, pfDest);
+}
+
+int DAFFPrincipalComponents::interpolate(const int* piRecordIndices, const float* pfRecordWeights, int n,
+										 int iChannel, float* pfDest) const
+{
+	assert(pfDest != NULL);
+
+	if (!isValid())
+		return DAFF_MODAL_ERROR;
+	if ((iChannel < 0) || (iChannel >= m_iNumChannels))
+		return DAFF_INVALID_INDEX;
+	for (int i = 0; i < n; i++)
+		if ((piRecordIndices[i] < 0) || (piRecordIndices[i] >= m_iNumRecords))
+			return DAFF_INVALID_INDEX;
+
+	// Gain of the mean and blended weights of the components
+	const int K = m_iNumComponents;
+	const float* pfWeights = &m_vfWeights[(size_t)iChannel * m_iNumRecords * K];
+	float pfGains[MAX_COMPONENTS + 1];
+	std::fill(pfGains, pfGains + K + 1, 0.0f);
+	for (int i = 0; i < n; i++) {
+		const float* pfRecordWeightsK = pfWeights + (size_t)piRecordIndices[i] * K;
+		float w = pfRecordWeights[i];
+		pfGains[0] += w;
+		for (int k = 0; k < K; k++)
+			pfGains[k + 1] += w * pfRecordWeightsK[k];
+	}
+
+	DAFF::blend_float(pfDest, &m_vpfRows[(size_t)iChannel * (K + 1)], pfGains, K + 1, m_iDataLength);
+	return DAFF_NO_ERROR;
+}
+
+int DAFFPrincipalComponents::interpolate(const DAFFQuad& qIndices, const float* pfWeights, int iChannel,
+										 float* pfDest) const
+{
+	assert(pfWeights != NULL);
+
+	int piRecordIndices[4] = { qIndices.iIndex1, qIndices.iIndex2, qIndices.iIndex3, qIndices.iIndex4 };
+	return interpolate(piRecordIndices, pfWeights, 4, iChannel, pfDest);
+}
+
+int DAFFPrincipalComponents::save(const std::string& sFilePath) const
+{
+	if (!isValid())
+		return DAFF_MODAL_ERROR;
+
+	FILE* pFile = fopen(sFilePath.c_str(), "wb");
+	if (pFile == NULL)
+		return DAFF_FILE_NOT_FOUND;
+
+	// Header and data in little endian
+	int piHeader[6] = { DAFF_PCA_VERSION, m_iNumComponents, m_iContentType, m_iNumRecords, m_iNumChannels,
+						m_iDataLength };
+	DAFF::le2se_4byte(piHeader, 6);
+
+	bool bSuccess = (fwrite(DAFF_PCA_SIGNATURE, 1, 4, pFile) == 4) && (fwrite(piHeader, 4, 6, pFile) == 6);
+
+	std::vector<float> vfData(m_vfBasis);
+	vfData.insert(vfData.end(), m_vfWeights.begin(), m_vfWeights.end());
+	vfData.insert(vfData.end(), m_vfExplained.begin(), m_vfExplained.end());
+	DAFF::le2se_4byte(&vfData[0], vfData.size());
+	bSuccess = bSuccess && (fwrite(&vfData[0], 4, vfData.size(), pFile) == vfData.size());
+
+	bSuccess = (fclose(pFile) == 0) && bSuccess;
+	return (bSuccess ? DAFF_NO_ERROR : DAFF_FILE_NOT_FOUND);
+}
+
+int DAFFPrincipalComponents::load(const std::string& sFilePath)
+{
+	clear();
+
+	FILE* pFile = fopen(sFilePath.c_str(), "rb");
+	if (pFile == NULL)
+		return DAFF_FILE_NOT_FOUND;
+
+	char pcSignature[4];
+	int piHeader[6];
+	if ((fread(pcSignature, 1, 4, pFile) != 4) || (fread(piHeader, 4, 6, pFile) != 6)) {
+		fclose(pFile);
+		return DAFF_FILE_CORRUPTED;
+	}
+	DAFF::le2se_4byte(piHeader, 6);
+
+	int iError = DAFF_NO_ERROR;
+	int64_t iNumValues = 0;
+	if (memcmp(pcSignature, DAFF_PCA_SIGNATURE, 4) != 0)
+		iError = DAFF_FILE_INVALID;
+	else if (piHeader[0] != DAFF_PCA_VERSION)
+		iError = DAFF_FILE_FORMAT_VERSION_UNSUPPORTED;
+	else if ((piHeader[1] <= 0) || (piHeader[1] > MAX_COMPONENTS) || (piHeader[2] < DAFF_IMPULSE_RESPONSE) ||
+			 (piHeader[2] > DAFF_DFT_SPECTRUM) || (piHeader[3] <= 0) || (piHeader[4] <= 0) || (piHeader[5] <= 0))
+		iError = DAFF_FILE_CORRUPTED;
+	else {
+		iNumValues = (int64_t)piHeader[4] * ((int64_t)(piHeader[1] + 1) * piHeader[5] +
+											 (int64_t)piHeader[3] * piHeader[1] + 1);
+		if (DAFF::getFileSize(sFilePath) != 28 + 4 * iNumValues)
+			iError = DAFF_FILE_CORRUPTED;  // Truncated file or implausible dimensions
+	}
+
+	if (iError == DAFF_NO_ERROR) {
+		init(piHeader[1], piHeader[2], piHeader[3], piHeader[4], piHeader[5]);
+		bool bSuccess = (fread(&m_vfBasis[0], 4, m_vfBasis.size(), pFile) == m_vfBasis.size()) &&
+						(fread(&m_vfWeights[0], 4, m_vfWeights.size(), pFile) == m_vfWeights.size()) &&
+						(fread(&m_vfExplained[0], 4, m_vfExplained.size(), pFile) == m_vfExplained.size());
+		DAFF::le2se_4byte(&m_vfBasis[0], m_vfBasis.size());
+		DAFF::le2se_4byte(&m_vfWeights[0], m_vfWeights.size());
+		DAFF::le2se_4byte(&m_vfExplained[0], m_vfExplained.size());
+		if (!bSuccess)
+			iError = DAFF_FILE_CORRUPTED;
+	}
+	fclose(pFile);
+
+	if (iError != DAFF_NO_ERROR) {
+		clear();
+		return iError;
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+size_t DAFFPrincipalComponents::getMemoryFootprint() const
+{
+	return (m_vfBasis.capacity() + m_vfWeights.capacity() + m_vfExplained.capacity()) * sizeof(float) +
+		   m_vpfRows.capacity() * sizeof(const float*);
+}
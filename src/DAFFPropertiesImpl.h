@@ -25,17 +25,34 @@ class DAFF_API DAFFPropertiesImpl : public DAFFProperties {
 	// Default constructor
 	inline DAFFPropertiesImpl()
 		: m_iFileFormatVersion(0), m_iContentType(0), m_iQuantization(0), m_iNumChannels(0), m_iNumRecords(0),
-		  m_iAlphaPoints(0), m_fAlphaStart(0), m_fAlphaEnd(0), m_fAlphaResolution(0), m_iBetaPoints(0), m_fBetaStart(0),
-		  m_fBetaEnd(0), m_fBetaResolution(0), m_pOrientationDefault(0), m_pTrans(0) {};
+		  m_iAlphaPoints(0), m_iBetaPoints(0), m_fAlphaStart(0), m_fAlphaEnd(0), m_fAlphaResolution(0), m_fBetaStart(0),
+		  m_fBetaEnd(0), m_fBetaResolution(0), m_bRegularGrid(true), m_pOrientationDefault(new DAFFOrientationYPR),
+		  m_pTrans(new DAFFSCTransform(DAFFOrientationYPR())) {};
 
 	//! Copy constructor
-	inline DAFFPropertiesImpl(const DAFFProperties* pProps)
+	inline DAFFPropertiesImpl(const DAFFProperties* pProps) : m_pOrientationDefault(0), m_pTrans(0)
 	{
 		assert(pProps != NULL);
 		*this = *pProps;
 	};
 
-	inline ~DAFFPropertiesImpl() { delete m_pOrientationDefault; };
+	//! Copy constructor (deep copy of the orientations)
+	inline DAFFPropertiesImpl(const DAFFPropertiesImpl& oProps) : m_pOrientationDefault(0), m_pTrans(0)
+	{
+		*this = oProps;
+	};
+
+	inline ~DAFFPropertiesImpl()
+	{
+		delete m_pOrientationDefault;
+		delete m_pTrans;
+	};
+
+	//! Assignment operator (deep copy of the orientations)
+	inline DAFFPropertiesImpl& operator=(const DAFFPropertiesImpl& oProps)
+	{
+		return (*this = static_cast<const DAFFProperties&>(oProps));
+	};
 
 	//! Assignment operator
 	inline DAFFPropertiesImpl& operator=(const DAFFProperties& oProps)
@@ -53,17 +70,24 @@ class DAFF_API DAFFPropertiesImpl : public DAFFProperties {
 		m_fBetaStart = oProps.getBetaStart();
 		m_fBetaEnd = oProps.getBetaEnd();
 		m_fBetaResolution = oProps.getBetaResolution();
+		m_bRegularGrid = oProps.isRegularGrid();
+
+		// Copied before the old orientations are freed, oProps may be this object
+		DAFFOrientationYPR* pOrientationDefault = new DAFFOrientationYPR;
+		oProps.getDefaultOrientation(*pOrientationDefault);
+		DAFFOrientationYPR oOrientation;
+		oProps.getOrientation(oOrientation);
+		DAFFSCTransform* pTrans = new DAFFSCTransform(oOrientation);
 
-		m_pOrientationDefault = new DAFFOrientationYPR;
-		oProps.getDefaultOrientation(*m_pOrientationDefault);
-		DAFFOrientationYPR* orient = new DAFFOrientationYPR;
-		oProps.getOrientation(*orient);
-		m_pTrans = new DAFFSCTransform(*orient);
-		delete orient;
+		delete m_pOrientationDefault;
+		delete m_pTrans;
+		m_pOrientationDefault = pOrientationDefault;
+		m_pTrans = pTrans;
 
-		std::vector<std::string> m_vChannelLabels;
+		std::vector<std::string> vChannelLabels;
 		for (int i = 0; i < oProps.getNumberOfChannels(); i++)
-			m_vChannelLabels.push_back(oProps.getChannelLabel(i));
+			vChannelLabels.push_back(oProps.getChannelLabel(i));
+		m_vChannelLabels.swap(vChannelLabels);
 
 		return *this;
 	};
@@ -166,6 +190,11 @@ class DAFF_API DAFFPropertiesImpl : public DAFFProperties {
 	//! Indicates whether the data covers the full sphere
 	inline virtual bool coversFullSphere() const { return coversFullAlphaRange() && coversFullBetaRange(); };
 
+	// -= Sampling =--------------------------------------
+
+	//! Indicates whether the records lie on the regular alpha/beta grid
+	inline virtual bool isRegularGrid() const { return m_bRegularGrid; };
+
 	// --= Variables =--
 
 	int m_iFileFormatVersion, m_iContentType, m_iQuantization, m_iNumChannels, m_iNumRecords, m_iAlphaPoints,
@@ -173,6 +202,8 @@ class DAFF_API DAFFPropertiesImpl : public DAFFProperties {
 
 	float m_fAlphaStart, m_fAlphaEnd, m_fAlphaResolution, m_fBetaStart, m_fBetaEnd, m_fBetaResolution;
 
+	bool m_bRegularGrid;
+
 	DAFFOrientationYPR* m_pOrientationDefault;
 	DAFFSCTransform* m_pTrans;
 	std::vector<std::string> m_vChannelLabels;
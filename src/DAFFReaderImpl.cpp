@@ -2,1412 +2,5651 @@
 
 #include <DAFFUtils.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <cfloat>
+#include <climits>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <limits>
 #include <sstream>
+#include <system_error>
+#include <thread>
 
+#include "DAFFChecksum.h"
+#include "DAFFCompression.h"
 #include "DAFFHeader.h"
+#include "DAFFInstrumentationImpl.h"
 #include "DAFFMetadataImpl.h"
 #include "Utils.h"
 
-// Disable MSVC security warning for unsafe fopen
-#ifdef _MSC_VER
-#pragma warning(disable : 4996)
-#endif  // _MSC_VER
 
+//! Size of the chunks in which the record data is read during an asynchronous opening [Bytes]
+static const size_t DAFF_OPEN_PROGRESS_CHUNK_SIZE = 4 * 1024 * 1024;
+
+//! Largest gap between record channels of a channel selection that are read at once (alignment padding) [Bytes]
+static const uint64_t DAFF_SELECTION_MAX_GAP = 64;
+
+//! Largest padding behind the last record channel of the data block (alignment of the record channels) [Bytes]
+static const uint64_t DAFF_MAX_DATA_PADDING = 64;
+
+//! Maximum size of a batched read of the lazy loading, bounds the time the record cache is locked [Bytes]
+static const size_t DAFF_LAZY_BATCH_SIZE = 1024 * 1024;
+
+//! Maximum number of record channels the prefetch worker loads at once
+static const size_t DAFF_PREFETCH_BATCH = 256;
+
+// Tolerance of the region boundaries, covers rounding errors of the record directions [degrees]
+static const float DAFF_REGION_TOLERANCE = 1e-3f;
+
+//! Size of a sample of a quantization in the data block [Bytes]
+static int getQuantizationSampleSize(int iQuantization)
+{
+	switch (iQuantization) {
+	case DAFF_INT16:
+	case DAFF_FLOAT16:
+	case DAFF_BFLOAT16:
+	case DAFF_INT16_BFP:
+		return 2;
+
+	case DAFF_INT24:
+		return 3;
+	}
+
+	return 4;
+}
+
+//! Copies record data from the file byte order (little endian) into the system byte order (dest may equal src)
+static void copyRecordData(void* pDest, const void* pSrc, size_t nBytes, int iQuantization)
+{
+	int iSampleSize = getQuantizationSampleSize(iQuantization);
+	size_t nNumValues = nBytes / iSampleSize;
+	switch (iSampleSize) {
+	case 2:
+		DAFF::le2se_copy_2byte(pDest, pSrc, nNumValues);
+		break;
+
+	case 3:
+		DAFF::le2se_copy_3byte(pDest, pSrc, nNumValues);
+		break;
+
+	case 4:
+		DAFF::le2se_copy_4byte(pDest, pSrc, nNumValues);
+		break;
+	}
+
+	// Bytes after the last complete sample are copied as they are
+	size_t nConverted = nNumValues * iSampleSize;
+	if ((pDest != pSrc) && (nConverted < nBytes))
+		memcpy((char*)pDest + nConverted, (const char*)pSrc + nConverted, nBytes - nConverted);
+}
 
 DAFFReaderImpl::DAFFReaderImpl()
-	: m_bDAFFObjectValid(false), m_bDAFFObjectFromFileValid(false), m_file(NULL), m_pFileBlockTable(NULL),
-	  m_pMainHeader(NULL), m_pContentHeader(NULL), m_pRecordDescriptorBlock(NULL), m_pDataBlock(NULL),
-	  m_bOverallPeakInitialized(false), m_fOverallPeak(0.0)
+	: m_bDAFFObjectValid(false), m_bDAFFObjectFromFileValid(false), m_pFileBlockTable(NULL), m_pMainHeader(NULL),
+	  m_ui64DataSize(0), m_pContentHeader(NULL), m_pRecordDescriptorBlock(NULL), m_pDataBlock(NULL), m_pArena(NULL),
+	  m_nArenaSize(0), m_nArenaCapacity(0), m_bKeepCapacity(false), m_bBlocksBorrowed(false), m_pSource(NULL),
+	  m_bLazyLoading(false), m_pfDecodedData(NULL), m_nDecodedDataSize(0), m_bDecodedDataBorrowed(false),
+	  m_bTruncated(false), m_iDataQuantization(DAFF_FLOAT32),
+	  m_fTruncationThresholdDB(-60.0f), m_iNumSharedRecordChannels(0), m_iSymmetry(DAFF_SYMMETRY_NONE),
+	  m_iNumStoredRecords(0), m_iNumStoredChannels(0), m_iNumGridRecords(0), m_pfRegionAxis(),
+	  m_fRegionCosAngle(-1.0f), m_bCompressed(false), m_iNumMetadataSets(0), m_pMetadataBlock(NULL),
+	  m_bOverallPeakInitialized(false), m_fOverallPeak(0.0), m_bStatisticsStored(false), m_bSlices(false),
+	  m_bOpening(false), m_bOpenCancelled(false), m_pOpenCallback(NULL), m_iAsyncOpenResult(DAFF_MODAL_ERROR),
+	  m_iNumLoadedLevels(0), m_bStreamCancelled(false), m_nStreamCacheRestore(0),
+	  m_iRecordOrder(DAFF_RECORD_ORDER_INDEX), m_bPrefetchStopped(false),
+	  m_bVerify(false),
+	  m_iChecksumSegmentSize(0), m_pTrans(std::make_shared<const DAFFSCTransform>())
 {
 	m_pEmptyMetadata = new DAFFMetadataImpl;
 }
 
 DAFFReaderImpl::~DAFFReaderImpl()
 {
+	cancelOpen();
+	waitForOpen();
 	tidyup();
+	releaseCapacity();
 	delete m_pEmptyMetadata;
 }
 
 bool DAFFReaderImpl::isFileOpened() const
 {
-	return (m_bDAFFObjectFromFileValid && m_bDAFFObjectValid);
+	return (!m_bOpening && m_bDAFFObjectFromFileValid && m_bDAFFObjectValid);
 }
 
 bool DAFFReaderImpl::isValid() const
 {
-	return m_bDAFFObjectValid;
+	return (!m_bOpening && m_bDAFFObjectValid);
 }
 
 int DAFFReaderImpl::deserialize(char* pDAFFDataBuffer)
 {
-	if (m_bDAFFObjectValid)
+	// Size unknown: Trust the block table
+	return deserialize(pDAFFDataBuffer, (size_t)-1, false);
+}
+
+int DAFFReaderImpl::deserialize(const char* pDAFFDataBuffer, size_t nSize, bool bBorrow)
+{
+	if (m_bOpening || m_bDAFFObjectValid)
 		return DAFF_MODAL_ERROR;
 
-	// File header
-	char* pFileHeaderBuffer = (char*)&m_fileHeader;
-	for (size_t i = 0; i < sizeof(DAFFFileHeader); i++)
-		pFileHeaderBuffer[i] = pDAFFDataBuffer[i];
+	if (pDAFFDataBuffer == NULL)
+		return DAFF_FILE_INVALID;
 
-	int ec = loadFileHeader();
+	beginLoadStats();
+
+	int ec = loadFromMemory(pDAFFDataBuffer, nSize, bBorrow, DAFF_OPEN_DEFAULT);
 	if (ec != DAFF_NO_ERROR)
 		return ec;
 
-	size_t nBufferReadPos = sizeof(DAFFFileHeader);
+	endLoadStats();
 
-	// File block table
-	size_t nFileBlockTableSize = m_fileHeader.iNumFileBlocks * sizeof(DAFFFileBlockEntry);
-	m_pFileBlockTable = (DAFFFileBlockEntry*)DAFF::malloc_aligned16(nFileBlockTableSize);
-	char* pFileBlockTableBuffer = (char*)m_pFileBlockTable;
+	return DAFF_NO_ERROR;
+}
 
-	for (size_t i = 0; i < nFileBlockTableSize; i++)
-		pFileBlockTableBuffer[i] = pDAFFDataBuffer[i + nBufferReadPos];
+//! Returns the offset rounded up to the next section of a shared-memory segment
+static uint64_t alignSharedSection(uint64_t ui64Offset)
+{
+	return (ui64Offset + 63) & ~(uint64_t)63;
+}
 
-	ec = loadFileBlockTable();
-	if (ec != DAFF_NO_ERROR) {
-		DAFF::free_aligned16(m_pFileBlockTable);
-		tidyup();
-		return ec;
-	}
+int DAFFReaderImpl::publishShared(const std::string& sName)
+{
+	// The record index and the decoded data of a channel selection or a region do not describe the file image
+	if (m_bOpening || !m_bDAFFObjectFromFileValid || m_sharedMemory.isOpened() || !m_viSelectedChannels.empty() ||
+		!m_viRegionRecords.empty())
+		return DAFF_MODAL_ERROR;
 
-	nBufferReadPos += nFileBlockTableSize;
+	// The file image is copied from the mapping or the file (which must not have changed since opening)
+	DAFFMappedFile oFile;
+	const char* pImage = m_mappedFile.getData();
+	size_t nImageSize = (size_t)m_mappedFile.getSize();
+	if (pImage == NULL) {
+		int ec = oFile.open(m_sFilePath);
+		if (ec != DAFF_NO_ERROR)
+			return ec;
 
-	// Main header
-	DAFFFileBlockEntry* pfbMainHeader;
-	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_MAIN_HEADER_ID, pfbMainHeader) != 1) {
-		tidyup();
-		return DAFF_FILE_INVALID;
+		pImage = oFile.getData();
+		nImageSize = (size_t)oFile.getSize();
 	}
 
-	m_pMainHeader = (DAFFMainHeader*)DAFF::malloc_aligned16(sizeof(DAFFMainHeader));
-	char* pMainHeaderBuffer = (char*)m_pMainHeader;
+	if (!matchesFileImage(pImage, nImageSize))
+		return DAFF_FILE_INVALID;
 
-	for (size_t i = 0; i < sizeof(DAFFMainHeader); i++)
-		pMainHeaderBuffer[i] = pDAFFDataBuffer[i + pfbMainHeader->ui64Offset];
+	DAFFSharedSegmentHeader oHeader;
+	memset(&oHeader, 0, sizeof(oHeader));
+	oHeader.iVersion = DAFF_SHARED_VERSION;
+	oHeader.iNumRecordChannels = m_pMainHeader->iNumRecords * m_pMainHeader->iNumChannels;
+	oHeader.ui64ImageOffset = alignSharedSection(sizeof(DAFFSharedSegmentHeader));
+	oHeader.ui64ImageSize = (uint64_t)nImageSize;
+	oHeader.fTruncationThreshold = m_fTruncationThresholdDB;
+
+	uint64_t ui64SegmentSize = oHeader.ui64ImageOffset + oHeader.ui64ImageSize;
+	if (m_pfDecodedData) {
+		oHeader.ui64OffsetsOffset = alignSharedSection(ui64SegmentSize);
+		ui64SegmentSize = oHeader.ui64OffsetsOffset + (uint64_t)oHeader.iNumRecordChannels * sizeof(uint64_t);
+		if (m_bTruncated) {
+			oHeader.ui64LengthsOffset = alignSharedSection(ui64SegmentSize);
+			ui64SegmentSize = oHeader.ui64LengthsOffset + (uint64_t)oHeader.iNumRecordChannels * sizeof(int32_t);
+		}
+		oHeader.ui64ArenaOffset = alignSharedSection(ui64SegmentSize);
+		oHeader.ui64ArenaSize = (uint64_t)m_nDecodedDataSize;
+		ui64SegmentSize = oHeader.ui64ArenaOffset + oHeader.ui64ArenaSize;
+	}
 
-	ec = loadMainHeader();
-	if (ec != DAFF_NO_ERROR) {
-		DAFF::free_aligned16(m_pMainHeader);
-		tidyup();
+	if (ui64SegmentSize > (uint64_t)((size_t)-1))
+		return DAFF_FILE_INVALID;
+
+	int ec = m_sharedMemory.create(sName, (size_t)ui64SegmentSize);
+	if (ec != DAFF_NO_ERROR)
 		return ec;
-	}
 
-	// Content header
-	DAFFFileBlockEntry* pfbContentHeader;
-	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_CONTENT_HEADER_ID, pfbContentHeader) != 1) {
-		tidyup();
-		return DAFF_FILE_CORRUPTED;
+	char* pSegment = m_sharedMemory.getData();
+	memcpy(pSegment + oHeader.ui64ImageOffset, pImage, nImageSize);
+	if (m_pfDecodedData) {
+		memcpy(pSegment + oHeader.ui64OffsetsOffset, &m_vui64DecodedOffsets[0],
+			   (size_t)oHeader.iNumRecordChannels * sizeof(uint64_t));
+		if (m_bTruncated)
+			for (int i = 0; i < oHeader.iNumRecordChannels; i++) {
+				int32_t iLength = (int32_t)m_viElementLengths[i];
+				memcpy(pSegment + oHeader.ui64LengthsOffset + (size_t)i * sizeof(int32_t), &iLength, sizeof(int32_t));
+			}
+		memcpy(pSegment + oHeader.ui64ArenaOffset, m_pfDecodedData, m_nDecodedDataSize);
 	}
 
-	m_pContentHeader = (char*)DAFF::malloc_aligned16((size_t)pfbContentHeader->ui64Size);
-	char* pContentHeaderBuffer = (char*)m_pContentHeader;
+	// The signature marks the segment as complete, attaching processes reject it before
+	memcpy(pSegment, &oHeader, sizeof(oHeader));
+	std::atomic_thread_fence(std::memory_order_release);
+	memcpy(pSegment, DAFF_SHARED_SIGNATURE, sizeof(DAFF_SHARED_SIGNATURE));
 
-	for (size_t i = 0; i < (size_t)pfbContentHeader->ui64Size; i++)
-		pContentHeaderBuffer[i] = pDAFFDataBuffer[i + pfbContentHeader->ui64Offset];
+	return DAFF_NO_ERROR;
+}
 
-	ec = loadContentHeader();
-	if (ec != DAFF_NO_ERROR) {
-		DAFF::free_aligned16(m_pContentHeader);
-		tidyup();
-		return ec;
-	}
+int DAFFReaderImpl::attachShared(const std::string& sName)
+{
+	if (m_bOpening || m_bDAFFObjectValid)
+		return DAFF_MODAL_ERROR;
 
-	// Record descriptor
-	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_RECORD_DESC_ID, m_pRecordDescriptorTable) != 1) {
-		tidyup();
-		return DAFF_FILE_CORRUPTED;
-	}
+	beginLoadStats();
 
-	m_pRecordDescriptorBlock = (char*)DAFF::malloc_aligned16((size_t)m_pRecordDescriptorTable->ui64Size);
-	char* pRecordDescriptorBuffer = (char*)m_pRecordDescriptorBlock;
+	int ec = m_sharedMemory.attach(sName);
+	if (ec != DAFF_NO_ERROR)
+		return ec;
 
-	for (size_t i = 0; i < (size_t)m_pRecordDescriptorTable->ui64Size; i++)
-		pRecordDescriptorBuffer[i] = pDAFFDataBuffer[i + m_pRecordDescriptorTable->ui64Offset];
+	endLoadPhase(m_oLoadStats.dOpenTime, "load.open");
 
-	ec = loadRecordDescriptor();
-	if (ec != DAFF_NO_ERROR) {
-		DAFF::free_aligned16(m_pRecordDescriptorBlock);
-		tidyup();
-		return ec;
+	const char* pSegment = m_sharedMemory.getData();
+	uint64_t ui64SegmentSize = (uint64_t)m_sharedMemory.getSize();
+	DAFFSharedSegmentHeader oHeader;
+	if (ui64SegmentSize < sizeof(oHeader)) {
+		m_sharedMemory.close();
+		return DAFF_FILE_NOT_FOUND;
 	}
 
-	// Record data
-	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_DATA_ID, m_pDataFileBlock) != 1) {
-		tidyup();
-		return DAFF_FILE_CORRUPTED;
+	std::atomic_thread_fence(std::memory_order_acquire);
+	memcpy(&oHeader, pSegment, sizeof(oHeader));
+	if (memcmp(oHeader.pcSignature, DAFF_SHARED_SIGNATURE, sizeof(DAFF_SHARED_SIGNATURE)) != 0) {
+		m_sharedMemory.close();
+		return DAFF_FILE_NOT_FOUND;
 	}
 
-	m_pDataBlock = DAFF::malloc_aligned16((size_t)m_pDataFileBlock->ui64Size);
-	char* pDataBlockBuffer = (char*)m_pDataBlock;
+	if (oHeader.iVersion != DAFF_SHARED_VERSION) {
+		m_sharedMemory.close();
+		return DAFF_FILE_FORMAT_VERSION_UNSUPPORTED;
+	}
 
-	for (size_t i = 0; i < (size_t)m_pDataFileBlock->ui64Size; i++)
-		pDataBlockBuffer[i] = pDAFFDataBuffer[i + m_pDataFileBlock->ui64Offset];
+	// All sections must reside inside the segment
+	uint64_t ui64NumRecordChannels = (uint64_t)std::max(oHeader.iNumRecordChannels, 0);
+	bool bValid = (oHeader.ui64ImageOffset <= ui64SegmentSize) &&
+				  (oHeader.ui64ImageSize <= ui64SegmentSize - oHeader.ui64ImageOffset);
+	if (oHeader.ui64ArenaOffset != 0)
+		bValid = bValid && (oHeader.ui64OffsetsOffset <= ui64SegmentSize) &&
+				 (ui64NumRecordChannels * sizeof(uint64_t) <= ui64SegmentSize - oHeader.ui64OffsetsOffset) &&
+				 (oHeader.ui64LengthsOffset <= ui64SegmentSize) &&
+				 (ui64NumRecordChannels * sizeof(int32_t) <= ui64SegmentSize - oHeader.ui64LengthsOffset) &&
+				 (oHeader.ui64ArenaOffset <= ui64SegmentSize) &&
+				 (oHeader.ui64ArenaSize <= ui64SegmentSize - oHeader.ui64ArenaOffset) &&
+				 ((oHeader.ui64ArenaOffset & 31) == 0) && ((oHeader.ui64OffsetsOffset & 7) == 0);
+	if (!bValid) {
+		m_sharedMemory.close();
+		return DAFF_FILE_CORRUPTED;
+	}
 
-	ec = loadRecordData();
+	ec = loadFromMemory(pSegment + oHeader.ui64ImageOffset, (size_t)oHeader.ui64ImageSize, true, DAFF_OPEN_DEFAULT);
 	if (ec != DAFF_NO_ERROR) {
-		DAFF::free_aligned16(m_pDataBlock);
-		tidyup();
+		m_sharedMemory.close();
 		return ec;
 	}
 
-	// Metadata
-	DAFFFileBlockEntry* pMetadataFileBlock = NULL;
-	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_METADATA_ID, pMetadataFileBlock) > 1) {
-		tidyup();
-		return DAFF_FILE_CORRUPTED;
+	if (oHeader.ui64ArenaOffset != 0) {
+		ec = attachDecodedData(oHeader);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
 	}
 
-	if (pMetadataFileBlock == nullptr) {
-		m_vpMetadata.push_back(new DAFFMetadataImpl);  // Empty
-	} else if (pMetadataFileBlock->ui64Size == 0) {
-		m_vpMetadata.push_back(new DAFFMetadataImpl);  // Empty  )
-	} else {
-		// Metadata block present
-		void* pMetadataBuf = DAFF::malloc_aligned16((size_t)pMetadataFileBlock->ui64Size);
-		char* pMetadataBuffer = (char*)pMetadataBuf;
+	m_fTruncationThresholdDB = oHeader.fTruncationThreshold;
 
-		for (size_t i = 0; i < (size_t)pMetadataFileBlock->ui64Size; i++)
-			pMetadataBuffer[i] = pDAFFDataBuffer[i + pMetadataFileBlock->ui64Offset];
+	endLoadStats();
 
-		ec = loadMetadata(pMetadataBuffer);  // Converts to internal representation
+	return DAFF_NO_ERROR;
+}
 
-		DAFF::free_aligned16(pMetadataBuf);
+int DAFFReaderImpl::openFile(const std::string& sFilePath, int iOpenFlags)
+{
+	if (m_bOpening || m_bDAFFObjectValid)
+		return DAFF_MODAL_ERROR;
 
-		if (ec != DAFF_NO_ERROR) {
-			tidyup();
-			return ec;
-		}
-	}
+	return loadFile(sFilePath, iOpenFlags);
+}
 
-	fixAngleRanges();
+int DAFFReaderImpl::openFileAsync(const std::string& sFilePath, DAFFOpenCallback* pCallback, int iOpenFlags)
+{
+	if (m_bOpening || m_bDAFFObjectValid)
+		return DAFF_MODAL_ERROR;
 
-	// ... done.
+	// Worker of the previous opening (already finished)
+	if (m_oOpenWorker.joinable())
+		m_oOpenWorker.join();
 
-	m_bDAFFObjectFromFileValid = false;
-	m_bDAFFObjectValid = true;
+	m_pOpenCallback = pCallback;
+	m_bOpenCancelled = false;
+	m_bOpening = true;
+	m_oOpenWorker = std::thread(&DAFFReaderImpl::runOpenWorker, this, sFilePath, iOpenFlags);
 
 	return DAFF_NO_ERROR;
 }
 
-int DAFFReaderImpl::openFile(const std::string& sFilePath)
+bool DAFFReaderImpl::isOpening() const
 {
-	if (m_bDAFFObjectValid)
-		return DAFF_MODAL_ERROR;
+	return m_bOpening;
+}
 
-	m_file = fopen(sFilePath.c_str(), "rb");
-	if (!m_file)
-		return DAFF_FILE_NOT_FOUND;
+void DAFFReaderImpl::cancelOpen()
+{
+	if (m_bOpening)
+		m_bOpenCancelled = true;
+}
 
-	// File header
-	if (fread(&m_fileHeader, 1, sizeof(DAFFFileHeader), m_file) != sizeof(DAFFFileHeader)) {
-		tidyup();
-		return DAFF_FILE_INVALID;
-	}
+int DAFFReaderImpl::waitForOpen()
+{
+	if (m_oOpenWorker.joinable())
+		m_oOpenWorker.join();
 
-	int ec = loadFileHeader();
-	if (ec != DAFF_NO_ERROR)
-		return ec;
+	return m_iAsyncOpenResult;
+}
 
-	// File block table
-	size_t iFileBlockTableSize = m_fileHeader.iNumFileBlocks * sizeof(DAFFFileBlockEntry);
-	m_pFileBlockTable = (DAFFFileBlockEntry*)DAFF::malloc_aligned16(iFileBlockTableSize);
-	if (fread(m_pFileBlockTable, 1, iFileBlockTableSize, m_file) != iFileBlockTableSize) {
-		tidyup();
-		return DAFF_FILE_INVALID;
-	}
+void DAFFReaderImpl::runOpenWorker(std::string sFilePath, int iOpenFlags)
+{
+	int ec = loadFile(sFilePath, iOpenFlags);
 
-	ec = loadFileBlockTable();
-	if (ec != DAFF_NO_ERROR)
-		return ec;
+	// Reading fails as soon as the opening is cancelled
+	if ((ec != DAFF_NO_ERROR) && m_bOpenCancelled)
+		ec = DAFF_OPEN_CANCELLED;
 
-	// Main header
-	DAFFFileBlockEntry* pfbMainHeader;
-	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_MAIN_HEADER_ID, pfbMainHeader) != 1) {
-		tidyup();
-		return DAFF_FILE_INVALID;
-	}
+	DAFFOpenCallback* pCallback = m_pOpenCallback;
+	m_pOpenCallback = NULL;
+	m_iAsyncOpenResult = ec;
+	m_bOpening = false;
 
-	m_pMainHeader = (DAFFMainHeader*)DAFF::malloc_aligned16(sizeof(DAFFMainHeader));
-	fseek(m_file, (long)pfbMainHeader->ui64Offset, SEEK_SET);
-	if (fread(m_pMainHeader, 1, sizeof(DAFFMainHeader), m_file) != sizeof(DAFFMainHeader)) {
-		tidyup();
-		return DAFF_FILE_INVALID;
-	}
+	// The reader can be used from here on (the callback may query it)
+	if (pCallback)
+		pCallback->onOpenFinished(ec);
+}
 
-	ec = loadMainHeader();
-	if (ec != DAFF_NO_ERROR)
-		return ec;
+bool DAFFReaderImpl::continueOpen(float fProgress)
+{
+	if (!m_bOpenCancelled && m_pOpenCallback && !m_pOpenCallback->onOpenProgress(fProgress))
+		m_bOpenCancelled = true;
 
-	// Content header
-	DAFFFileBlockEntry* pfbContentHeader;
-	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_CONTENT_HEADER_ID, pfbContentHeader) != 1) {
-		tidyup();
-		return DAFF_FILE_CORRUPTED;
-	}
+	return !m_bOpenCancelled;
+}
 
-	m_pContentHeader = (char*)DAFF::malloc_aligned16((size_t)pfbContentHeader->ui64Size);
-	fseek(m_file, (long)pfbContentHeader->ui64Offset, SEEK_SET);
-	if (fread(m_pContentHeader, 1, (size_t)pfbContentHeader->ui64Size, m_file) != (size_t)pfbContentHeader->ui64Size) {
-		tidyup();
-		return DAFF_FILE_CORRUPTED;
-	}
+int DAFFReaderImpl::readDataFileBlock(DAFFDataSource* pSource, void* pDest)
+{
+	uint64_t ui64Offset = m_pDataFileBlock->ui64Offset;
+	uint64_t ui64Size = m_pDataFileBlock->ui64Size;
+	if (!m_bOpening)
+		return pSource->read(ui64Offset, pDest, (size_t)ui64Size);
 
-	ec = loadContentHeader();
-	if (ec != DAFF_NO_ERROR)
-		return ec;
+	for (uint64_t ui64Pos = 0; ui64Pos < ui64Size; ui64Pos += DAFF_OPEN_PROGRESS_CHUNK_SIZE) {
+		if (!continueOpen((float)((double)ui64Pos / (double)ui64Size)))
+			return DAFF_OPEN_CANCELLED;
 
-	// Record descriptor
-	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_RECORD_DESC_ID, m_pRecordDescriptorTable) != 1) {
-		tidyup();
-		return DAFF_FILE_CORRUPTED;
+		size_t nBytes = (size_t)std::min((uint64_t)DAFF_OPEN_PROGRESS_CHUNK_SIZE, ui64Size - ui64Pos);
+		int ec = pSource->read(ui64Offset + ui64Pos, (char*)pDest + ui64Pos, nBytes);
+		if (ec != DAFF_NO_ERROR)
+			return ec;
 	}
 
-	m_pRecordDescriptorBlock = (char*)DAFF::malloc_aligned16((size_t)m_pRecordDescriptorTable->ui64Size);
-	fseek(m_file, (long)m_pRecordDescriptorTable->ui64Offset, SEEK_SET);
-	if (fread(m_pRecordDescriptorBlock, 1, (size_t)m_pRecordDescriptorTable->ui64Size, m_file) !=
-		(size_t)m_pRecordDescriptorTable->ui64Size) {
-		tidyup();
-		return DAFF_FILE_CORRUPTED;
-	}
+	return DAFF_NO_ERROR;
+}
 
-	ec = loadRecordDescriptor();
-	if (ec != DAFF_NO_ERROR)
-		return ec;
+int DAFFReaderImpl::loadFile(const std::string& sFilePath, int iOpenFlags)
+{
+	beginLoadStats();
 
-	// Record data
-	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_DATA_ID, m_pDataFileBlock) != 1) {
-		tidyup();
-		return DAFF_FILE_CORRUPTED;
-	}
+	int ec;
+	if (iOpenFlags & DAFF_OPEN_MAPPED) {
+		ec = m_mappedFile.open(sFilePath);
+		if (ec != DAFF_NO_ERROR)
+			return ec;
 
-	m_pDataBlock = DAFF::malloc_aligned16((size_t)m_pDataFileBlock->ui64Size);
-	fseek(m_file, (long)m_pDataFileBlock->ui64Offset, SEEK_SET);
-	if (fread(m_pDataBlock, 1, (size_t)m_pDataFileBlock->ui64Size, m_file) != (size_t)m_pDataFileBlock->ui64Size) {
-		DAFF::free_aligned16(m_pDataBlock);
-		tidyup();
-		return DAFF_FILE_CORRUPTED;
-	}
+		endLoadPhase(m_oLoadStats.dOpenTime, "load.open");
 
-	ec = loadRecordData();
-	if (ec != DAFF_NO_ERROR)
-		return ec;
+		ec = loadFromSource(&m_mappedFile, iOpenFlags);
+		if (ec != DAFF_NO_ERROR)
+			return ec;
+	} else {
+		ec = m_fileSource.open(sFilePath);
+		if (ec != DAFF_NO_ERROR)
+			return ec;
 
-	// Metadata
-	DAFFFileBlockEntry* pMetadataFileBlock = NULL;
-	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_METADATA_ID, pMetadataFileBlock) > 1) {
+		endLoadPhase(m_oLoadStats.dOpenTime, "load.open");
+
+		ec = loadFromSource(&m_fileSource, iOpenFlags);
+		if (ec != DAFF_NO_ERROR)
+			return ec;
+
+		if (!m_bLazyLoading)
+			m_fileSource.close();
+	}
+
+	// Asynchronous opening: reading is complete, decoding and truncation follow
+	if (m_bOpening && !continueOpen(1.0f)) {
 		tidyup();
-		return DAFF_FILE_CORRUPTED;
+		return DAFF_OPEN_CANCELLED;
 	}
 
-	if (pMetadataFileBlock == nullptr) {
-		m_vpMetadata.push_back(new DAFFMetadataImpl);  // Empty
-	} else if (pMetadataFileBlock->ui64Size == 0) {
-		m_vpMetadata.push_back(new DAFFMetadataImpl);  // Empty  )
-	} else {
-		// Metadata block present
-		void* pMetadataBuf = DAFF::malloc_aligned16((size_t)pMetadataFileBlock->ui64Size);
-		fseek(m_file, (long)pMetadataFileBlock->ui64Offset, SEEK_SET);
-		if (fread(pMetadataBuf, 1, (size_t)pMetadataFileBlock->ui64Size, m_file) !=
-			(size_t)pMetadataFileBlock->ui64Size) {
-			DAFF::free_aligned16(pMetadataBuf);
+	if ((iOpenFlags & DAFF_OPEN_DECODE) && !m_bLazyLoading) {
+		ec = decodeRecordData();
+		if (ec != DAFF_NO_ERROR) {
 			tidyup();
-			return DAFF_FILE_CORRUPTED;
+			return ec;
 		}
 
-		ec = loadMetadata((char*)pMetadataBuf);
-		if (ec != DAFF_NO_ERROR)
+		endLoadPhase(m_oLoadStats.dDecodeTime, "load.decode");
+	}
+
+	if ((iOpenFlags & DAFF_OPEN_TRUNCATE) && !m_bLazyLoading) {
+		ec = truncateRecordData();
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
 			return ec;
+		}
 
-		DAFF::free_aligned16(pMetadataBuf);
+		endLoadPhase(m_oLoadStats.dTruncateTime, "load.truncate");
 	}
 
-	fixAngleRanges();
-
-	fclose(m_file);
-	m_file = NULL;
+	// Everything has been copied, mapping no longer required
+	if ((iOpenFlags & DAFF_OPEN_MAPPED) && !m_bBlocksBorrowed)
+		m_mappedFile.close();
 
 	// ... done.
 
 	m_sFilePath = sFilePath;
-	m_bDAFFObjectValid = true;
 	m_bDAFFObjectFromFileValid = true;
 
+	endLoadStats();
+
 	return DAFF_NO_ERROR;
 }
 
-int DAFFReaderImpl::loadFileHeader()
+int DAFFReaderImpl::openSource(DAFFDataSource* pSource, int iOpenFlags)
 {
-	/*
-	 *  1st step: Load the file header and validate it for correctness
-	 */
-
-	m_fileHeader.fixEndianness();
+	if (m_bOpening || m_bDAFFObjectValid)
+		return DAFF_MODAL_ERROR;
 
-	// Check signature
-	if (!((m_fileHeader.pcSignature[0] == 'F') && (m_fileHeader.pcSignature[1] == 'W'))) {
-		// File is not an OpenDAFF database.
-		tidyup();
+	if (pSource == NULL)
 		return DAFF_FILE_INVALID;
-	}
 
-	// Check version
-	// [This implementation supports version number 1.7]
-	if (m_fileHeader.iFileFormatVersion != 170) {
-		// Database version not supported
-		tidyup();
-		return DAFF_FILE_FORMAT_VERSION_UNSUPPORTED;
-	}
+	beginLoadStats();
 
-	// Check file block entries
-	if (m_fileHeader.iNumFileBlocks <= 0) {
-		// There must be at least one block
-		tidyup();
-		return DAFF_FILE_INVALID;
-	}
-
-	return DAFF_NO_ERROR;
-}
-
-int DAFFReaderImpl::loadFileBlockTable()
-{
-	// Read the file block table
-	size_t iFileBlockTableSize = m_fileHeader.iNumFileBlocks * sizeof(DAFFFileBlockEntry);
+	int ec = loadFromSource(pSource, iOpenFlags);
+	if (ec != DAFF_NO_ERROR)
+		return ec;
 
-	for (int i = 0; i < m_fileHeader.iNumFileBlocks; i++)
-		m_pFileBlockTable[i].fixEndianness();
+	if ((iOpenFlags & DAFF_OPEN_DECODE) && !m_bLazyLoading) {
+		ec = decodeRecordData();
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
 
-#if (DAFF_DEBUG == 1)
-	for (int i = 0; i < m_fileHeader.iNumFileBlocks; i++)
-		printf("FILE BLOCK[%d] = { ID = 0x%04X, offset = %llu, size = %llu bytes }\n", i, m_pFileBlockTable[i].iID,
-			   m_pFileBlockTable[i].ui64Offset, m_pFileBlockTable[i].ui64Size);
-#endif
+		endLoadPhase(m_oLoadStats.dDecodeTime, "load.decode");
+	}
 
-	// Check for correctness
-	for (int i = 0; i < m_fileHeader.iNumFileBlocks; i++) {
-		// Note: IDs are not checked
-		if ((m_pFileBlockTable[i].ui64Offset < (sizeof(DAFFFileHeader) + iFileBlockTableSize))) {
+	if ((iOpenFlags & DAFF_OPEN_TRUNCATE) && !m_bLazyLoading) {
+		ec = truncateRecordData();
+		if (ec != DAFF_NO_ERROR) {
 			tidyup();
-			return DAFF_FILE_INVALID;
+			return ec;
 		}
+
+		endLoadPhase(m_oLoadStats.dTruncateTime, "load.truncate");
 	}
 
+	endLoadStats();
+
 	return DAFF_NO_ERROR;
 }
 
-int DAFFReaderImpl::loadMainHeader()
+int DAFFReaderImpl::decodeRecordData()
 {
-	/*
-	 *  2nd step: Load the main header, validate it for correctness
-	 */
-
-	m_pMainHeader->fixEndianness();
-
-	// Content type
-	switch (m_pMainHeader->iContentType) {
-	case DAFF_IMPULSE_RESPONSE:
-	case DAFF_MAGNITUDE_SPECTRUM:
-	case DAFF_PHASE_SPECTRUM:
-	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
-	case DAFF_DFT_SPECTRUM:
-		break;
-
-	default:
-		// Invalid content type
-		tidyup();
-		return DAFF_FILE_CONTENT_TYPE_UNKOWN;
-	};
-
-	// Quantization
-	switch (m_pMainHeader->iQuantization) {
-	case DAFF_INT16:
-	case DAFF_INT24:
-	case DAFF_FLOAT32:
-		break;
-
-	default:
-		// Invalid quantization
-		tidyup();
-		return DAFF_FILE_QUANTIZATION_UNKOWN;
-	};
-
-	if (m_pMainHeader->iNumChannels < 1)
-		return DAFF_FILE_INVALID_MAIN_PARAMETER;
+	// Only integer impulse responses and 16-bit floating point data require a conversion
+	if (m_pMainHeader->iQuantization == DAFF_FLOAT32)
+		return DAFF_NO_ERROR;
 
-	if (m_pMainHeader->iNumRecords < 1)
-		return DAFF_FILE_INVALID_MAIN_PARAMETER;
+	int iSampleSize = getQuantizationSampleSize(m_pMainHeader->iQuantization);
 
-	if (m_pMainHeader->iElementsPerRecord < 1)
-		return DAFF_FILE_INVALID_MAIN_PARAMETER;
+	// Every record channel starts at a 32-byte boundary inside the arena, shared data is decoded once
+	int iNumRecordChannels = m_pMainHeader->iNumRecords * m_pMainHeader->iNumChannels;
+	std::vector<uint64_t> vui64Offsets(iNumRecordChannels);
+	uint64_t ui64ArenaSize = 0;
+	for (int i = 0; i < iNumRecordChannels; i++) {
+		if (m_viPayloadIndices[i] != i) {
+			vui64Offsets[i] = vui64Offsets[m_viPayloadIndices[i]];
+			continue;
+		}
 
-	if (m_pMainHeader->iAlphaPoints < 1)
-		return DAFF_FILE_ALPHA_ANGLES_INVALID;
+		size_t nNumValues =
+			getRecordChannelDataSize(i / m_pMainHeader->iNumChannels, i % m_pMainHeader->iNumChannels) / iSampleSize;
+		vui64Offsets[i] = ui64ArenaSize;
+		ui64ArenaSize += ((uint64_t)nNumValues + 7) & ~(uint64_t)7;
+	}
 
-	// alpha start value must not be 360&deg;
-	if ((m_pMainHeader->fAlphaStart < 0.0f) || (m_pMainHeader->fAlphaStart >= 360.0f))
-		return DAFF_FILE_ALPHA_ANGLES_INVALID;
+	if (ui64ArenaSize * sizeof(float) > (uint64_t)((size_t)-1))
+		return DAFF_FILE_CORRUPTED;
 
-	// alpha stop value may be 360&deg; indicating that the full alpha range is covered.
-	if ((m_pMainHeader->fAlphaEnd < 0.0f) || (m_pMainHeader->fAlphaEnd > 360.0f))
-		return DAFF_FILE_ALPHA_ANGLES_INVALID;
+	float* pfArena = (float*)DAFF::malloc_aligned32((size_t)(ui64ArenaSize * sizeof(float)));
+	if ((pfArena == NULL) && (ui64ArenaSize > 0))
+		return DAFF_FILE_CORRUPTED;
 
-	// Beta angle validation
-	if (m_pMainHeader->iBetaPoints < 1)
-		return DAFF_FILE_BETA_ANGLES_INVALID;
+	for (int i = 0; i < iNumRecordChannels; i++) {
+		if (m_viPayloadIndices[i] != i)
+			continue;
 
-	if (m_pMainHeader->fBetaStart > m_pMainHeader->fBetaEnd)
-		return DAFF_FILE_BETA_ANGLES_INVALID;
+		int iRecord = i / m_pMainHeader->iNumChannels;
+		int iChannel = i % m_pMainHeader->iNumChannels;
+		const void* pData = getRecordChannelDataPtr(iRecord, iChannel);
+		if (pData == NULL) {
+			DAFF::free_aligned32(pfArena);
+			return DAFF_FILE_CORRUPTED;
+		}
 
-	if ((m_pMainHeader->fBetaStart < 0.0f) || (m_pMainHeader->fBetaStart > 180.0f))
-		return DAFF_FILE_BETA_ANGLES_INVALID;
+		// Block floating point samples are decoded with their scales
+		int iNumValues = (int)(getRecordChannelDataSize(iRecord, iChannel) / iSampleSize);
+		convertValues(pData, iNumValues, 1, pfArena + vui64Offsets[i], 1, getBlockScale(i));
+	}
 
-	if ((m_pMainHeader->fBetaEnd < 0.0f) || (m_pMainHeader->fBetaEnd > 180.0f))
-		return DAFF_FILE_BETA_ANGLES_INVALID;
+	m_pfDecodedData = pfArena;
+	m_nDecodedDataSize = (size_t)(ui64ArenaSize * sizeof(float));
+	m_vui64DecodedOffsets.swap(vui64Offsets);
+	m_iDataQuantization = DAFF_FLOAT32;
+	m_vfBlockScales.clear();
 
-	// Orientation
-	m_orientationDefault.fYawAngleDeg = m_pMainHeader->fOrientYaw;
-	m_orientationDefault.fPitchAngleDeg = m_pMainHeader->fOrientPitch;
-	m_orientationDefault.fRollAngleDeg = m_pMainHeader->fOrientRoll;
-	m_tTrans.setOrientation(m_orientationDefault);
+	// The quantized data is no longer accessed
+	if (!m_bBlocksBorrowed)
+		releaseDataBlock();
 
 	return DAFF_NO_ERROR;
 }
 
-int DAFFReaderImpl::loadContentHeader()
+int DAFFReaderImpl::truncateRecordData()
 {
-	/*
-	 *  3rd step: Load the content header, validate it for correctness
-	 */
-
-	float* pfFreqs = 0;
-
-	switch (m_pMainHeader->iContentType) {
-	case DAFF_IMPULSE_RESPONSE:
-		m_pContentHeaderIR = static_cast<DAFFContentHeaderIR*>(m_pContentHeader);
-		m_pContentHeaderIR->fixEndianness();
-
-		if (m_pContentHeaderIR->fSamplerate < 0.0f)
-			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
-
-		if ((m_pContentHeaderIR->iMaxEffectiveFilterLength < 0) ||
-			(m_pContentHeaderIR->iMaxEffectiveFilterLength > m_pMainHeader->iElementsPerRecord))
-			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
-
-		if ((m_pContentHeaderIR->iMinFilterOffset < 0) ||
-			(m_pContentHeaderIR->iMinFilterOffset > m_pMainHeader->iElementsPerRecord))
-			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
-
-		break;
-
-	case DAFF_MAGNITUDE_SPECTRUM:
-		m_pContentHeaderMS = static_cast<DAFFContentHeaderMS*>(m_pContentHeader);
-		m_pContentHeaderMS->fixEndianness();
-
-		if (m_pContentHeaderMS->iNumFreqs <= 0)
-			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
-
-		pfFreqs = (float*)((char*)m_pContentHeader + 8);
+	if (m_pMainHeader->iContentType != DAFF_IMPULSE_RESPONSE)
+		return DAFF_NO_ERROR;
 
-		// Fix the endianness of the frequency list
-		DAFF::le2se_4byte(pfFreqs, m_pContentHeaderMS->iNumFreqs);
+	// Tails are dropped as long as their energy stays below this share of the total energy
+	double dRelativeEnergy = pow(10.0, (double)m_fTruncationThresholdDB / 10.0);
+
+	int iNumChannels = m_pMainHeader->iNumChannels;
+	int iNumRecordChannels = m_pMainHeader->iNumRecords * iNumChannels;
+	int iMaxElementLength = 0;
+	for (int i = 0; i < iNumRecordChannels; i++)
+		iMaxElementLength = std::max(iMaxElementLength, m_viElementLengths[i]);
+
+	// Determine the truncated lengths
+	std::vector<float> vfBuf(std::max(iMaxElementLength, 1));
+	std::vector<int> viLengths(iNumRecordChannels);
+	for (int i = 0; i < iNumRecordChannels; i++) {
+		if (m_viPayloadIndices[i] != i) {
+			viLengths[i] = viLengths[m_viPayloadIndices[i]];  // Same data, same tail
+			continue;
+		}
 
-		// Load the (dynamically sized) frequency list
-		m_vfFreqs.resize(m_pContentHeaderMS->iNumFreqs);
-		for (int i = 0; i < m_pContentHeaderMS->iNumFreqs; i++)
-			m_vfFreqs[i] = pfFreqs[i];
+		int iLength = std::max(m_viElementLengths[i], 0);
+		int ec = getEffectiveFilterCoeffs(i / iNumChannels, i % iNumChannels, &vfBuf[0]);
+		if (ec != DAFF_NO_ERROR)
+			return ec;
 
-		break;
+		double dEnergy = 0;
+		for (int j = 0; j < iLength; j++)
+			dEnergy += (double)vfBuf[j] * vfBuf[j];
+
+		double dMaxTailEnergy = dRelativeEnergy * dEnergy;
+		double dTailEnergy = 0;
+		while (iLength > 0) {
+			dTailEnergy += (double)vfBuf[iLength - 1] * vfBuf[iLength - 1];
+			if (dTailEnergy > dMaxTailEnergy)
+				break;
+			iLength--;
+		}
 
-	case DAFF_PHASE_SPECTRUM:
-		m_pContentHeaderPS = static_cast<DAFFContentHeaderPS*>(m_pContentHeader);
-		m_pContentHeaderPS->fixEndianness();
+		viLengths[i] = iLength;
+	}
 
-		if (m_pContentHeaderPS->iNumFreqs <= 0)
-			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+	// Repack into a new float arena, every record channel starts at a 32-byte boundary (shared data once)
+	std::vector<uint64_t> vui64Offsets(iNumRecordChannels);
+	uint64_t ui64ArenaSize = 0;
+	for (int i = 0; i < iNumRecordChannels; i++) {
+		if (m_viPayloadIndices[i] != i) {
+			vui64Offsets[i] = vui64Offsets[m_viPayloadIndices[i]];
+			continue;
+		}
 
-		pfFreqs = (float*)((char*)m_pContentHeader + 8);
+		vui64Offsets[i] = ui64ArenaSize;
+		ui64ArenaSize += ((uint64_t)viLengths[i] + 7) & ~(uint64_t)7;
+	}
 
-		// Fix the endianness of the frequency list
-		DAFF::le2se_4byte(pfFreqs, m_pContentHeaderPS->iNumFreqs);
+	float* pfArena = (float*)DAFF::malloc_aligned32((size_t)(ui64ArenaSize * sizeof(float)));
+	if ((pfArena == NULL) && (ui64ArenaSize > 0))
+		return DAFF_FILE_CORRUPTED;
 
-		// Load the (dynamically sized) frequency list
-		m_vfFreqs.resize(m_pContentHeaderPS->iNumFreqs);
-		for (int i = 0; i < m_pContentHeaderPS->iNumFreqs; i++)
-			m_vfFreqs[i] = pfFreqs[i];
+	for (int i = 0; i < iNumRecordChannels; i++) {
+		if (m_viPayloadIndices[i] != i)
+			continue;
 
-		break;
+		int ec = getEffectiveFilterCoeffs(i / iNumChannels, i % iNumChannels, &vfBuf[0]);
+		if (ec != DAFF_NO_ERROR) {
+			DAFF::free_aligned32(pfArena);
+			return ec;
+		}
 
-	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
-		m_pContentHeaderMPS = static_cast<DAFFContentHeaderMPS*>(m_pContentHeader);
-		m_pContentHeaderMPS->fixEndianness();
+		memcpy(pfArena + vui64Offsets[i], &vfBuf[0], viLengths[i] * sizeof(float));
+	}
 
-		if (m_pContentHeaderMPS->iNumFreqs <= 0)
-			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+	// The borrowed blocks are no longer referenced, the descriptors are copied so that the mapping can be released
+	if (m_bBlocksBorrowed) {
+		if (!ownsRecordDescriptors()) {
+			size_t nDescSize = (size_t)m_pRecordDescriptorTable->ui64Size;
+			void* pDescBlock = DAFF::malloc_aligned16(nDescSize);
+			if (pDescBlock == NULL) {
+				DAFF::free_aligned32(pfArena);
+				return DAFF_FILE_CORRUPTED;
+			}
 
-		pfFreqs = (float*)((char*)m_pContentHeader + 8);
+			memcpy(pDescBlock, m_pRecordDescriptorBlock, nDescSize);
+			m_pRecordDescriptorBlock = pDescBlock;
+		}
+		m_pDataBlock = NULL;
+		m_bBlocksBorrowed = false;
+	} else {
+		releaseDataBlock();
+	}
 
-		// Fix the endianness of the frequency list
-		DAFF::le2se_4byte(pfFreqs, m_pContentHeaderMPS->iNumFreqs);
+	if (!m_bDecodedDataBorrowed)
+		DAFF::free_aligned32(m_pfDecodedData);
+	m_pfDecodedData = pfArena;
+	m_nDecodedDataSize = (size_t)(ui64ArenaSize * sizeof(float));
+	m_vui64DecodedOffsets.swap(vui64Offsets);
+	m_bDecodedDataBorrowed = false;
+	m_bTruncated = true;
+	m_iDataQuantization = DAFF_FLOAT32;
+	m_vfBlockScales.clear();
+
+	// Only the record index is updated, the descriptors keep the stored lengths
+	int iMaxEffectiveFilterLength = 0;
+	for (int i = 0; i < iNumRecordChannels; i++)
+		iMaxEffectiveFilterLength = std::max(iMaxEffectiveFilterLength, viLengths[i]);
+	m_viElementLengths.swap(viLengths);
+	m_pContentHeaderIR->iMaxEffectiveFilterLength = iMaxEffectiveFilterLength;
 
-		// Load the (dynamically sized) frequency list
-		m_vfFreqs.resize(m_pContentHeaderMPS->iNumFreqs);
-		for (int i = 0; i < m_pContentHeaderMPS->iNumFreqs; i++)
-			m_vfFreqs[i] = pfFreqs[i];
+	return DAFF_NO_ERROR;
+}
 
-		break;
+bool DAFFReaderImpl::matchesFileImage(const char* pImage, size_t nSize) const
+{
+	DAFFFileHeader oFileHeader;
+	if (nSize < sizeof(DAFFFileHeader))
+		return false;
 
-	case DAFF_DFT_SPECTRUM:
-		m_pContentHeaderDFT = static_cast<DAFFContentHeaderDFT*>(m_pContentHeader);
-		m_pContentHeaderDFT->fixEndianness();
+	memcpy(&oFileHeader, pImage, sizeof(DAFFFileHeader));
+	oFileHeader.fixEndianness();
+	if ((oFileHeader.iFileFormatVersion != m_fileHeader.iFileFormatVersion) ||
+		(oFileHeader.iNumFileBlocks != m_fileHeader.iNumFileBlocks))
+		return false;
 
-		if ((m_pContentHeaderDFT->iNumDFTCoeffs != m_pContentHeaderDFT->iTransformSize) &&
-			(m_pContentHeaderDFT->iNumDFTCoeffs != floor(m_pContentHeaderDFT->iTransformSize / 2.0) + 1))
-			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+	size_t nFileBlockTableSize = (size_t)m_fileHeader.iNumFileBlocks * sizeof(DAFFFileBlockEntry);
+	if (nFileBlockTableSize > nSize - sizeof(DAFFFileHeader))
+		return false;
 
-		break;
+	for (int i = 0; i < m_fileHeader.iNumFileBlocks; i++) {
+		DAFFFileBlockEntry oEntry;
+		memcpy(&oEntry, pImage + sizeof(DAFFFileHeader) + (size_t)i * sizeof(DAFFFileBlockEntry),
+			   sizeof(DAFFFileBlockEntry));
+		oEntry.fixEndianness();
+		if ((oEntry.iID != m_pFileBlockTable[i].iID) || (oEntry.ui64Offset != m_pFileBlockTable[i].ui64Offset) ||
+			(oEntry.ui64Size != m_pFileBlockTable[i].ui64Size))
+			return false;
 	}
 
-	return DAFF_NO_ERROR;
+	return true;
 }
 
-int DAFFReaderImpl::loadRecordDescriptor()
+int DAFFReaderImpl::attachDecodedData(const DAFFSharedSegmentHeader& oHeader)
 {
-	/*
-	 *  4rd step: Load the record descriptor block
-	 */
-
-	// Set access pointer and fix the endianness
-	switch (m_pMainHeader->iContentType) {
-	case DAFF_IMPULSE_RESPONSE:
-		// A single IR record channel desc is 4+4+4+8 Byte = 20 Bytes
-		m_iRecordChannelDescSize = sizeof(DAFFRecordChannelDescIR);
-		assert(m_iRecordChannelDescSize == 20);
-
-		// Fix endianness for channel descriptors and metadata index
-		for (int i = 0; i < m_pMainHeader->iNumRecords; i++) {
-			for (int c = 0; c < m_pMainHeader->iNumChannels; c++) {
-				DAFFRecordChannelDescIR* pDesc =
-					reinterpret_cast<DAFFRecordChannelDescIR*>(getRecordChannelDescPtr(i, c));
-				pDesc->fixEndianness();
-			}
+	const char* pSegment = m_sharedMemory.getData();
+	int iNumChannels = m_pMainHeader->iNumChannels;
+	int iNumStoredChannels = getNumStoredChannels();
+	int iNumRecordChannels = m_pMainHeader->iNumRecords * iNumChannels;
+	int iNumGridRecords = (m_viRegionRecords.empty() ? m_pMainHeader->iNumRecords : m_iNumGridRecords);
+	if (oHeader.iNumRecordChannels != iNumGridRecords * iNumStoredChannels)
+		return DAFF_FILE_CORRUPTED;
 
-			DAFF::le2se_4byte(getRecordMetadataIndexPtr(i), 1);
-		};
+	// The segment holds all records and stored channels, the attached reader may select some of them
+	std::vector<size_t> vnSegmentIndices(iNumRecordChannels);
+	for (int i = 0; i < iNumRecordChannels; i++) {
+		int iRecord = i / iNumChannels;
+		int iChannel = i % iNumChannels;
+		int iGridRecord = (m_viRegionRecords.empty() ? iRecord : m_viRegionRecords[iRecord]);
+		int iStoredChannel = (m_viSelectedChannels.empty() ? iChannel : m_viSelectedChannels[iChannel]);
+		vnSegmentIndices[i] = (size_t)iGridRecord * iNumStoredChannels + iStoredChannel;
+	}
 
-		break;
+	// Truncated lengths must not exceed the stored lengths
+	bool bTruncated = (oHeader.ui64LengthsOffset != 0);
+	std::vector<int> viLengths(bTruncated ? iNumRecordChannels : 0);
+	if (bTruncated) {
+		if (m_pMainHeader->iContentType != DAFF_IMPULSE_RESPONSE)
+			return DAFF_FILE_CORRUPTED;
 
-	case DAFF_MAGNITUDE_SPECTRUM:
-	case DAFF_PHASE_SPECTRUM:
-	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
-	case DAFF_DFT_SPECTRUM:
-		// All other content use a default record channel desc (MS/PS/MPS/DFT) which is 8 Bytes
-		m_iRecordChannelDescSize = sizeof(DAFFRecordChannelDescDefault);
+		for (int i = 0; i < iNumRecordChannels; i++) {
+			int32_t iLength;
+			memcpy(&iLength, pSegment + oHeader.ui64LengthsOffset + vnSegmentIndices[i] * sizeof(int32_t),
+				   sizeof(int32_t));
+			if ((iLength < 0) || (iLength > std::max(m_viElementLengths[i], 0)))
+				return DAFF_FILE_CORRUPTED;
+			viLengths[i] = (int)iLength;
+		}
+	}
 
-		// Fix endianness for channel descriptors and metadata index
-		for (int i = 0; i < m_pMainHeader->iNumRecords; i++) {
-			for (int c = 0; c < m_pMainHeader->iNumChannels; c++) {
-				DAFFRecordChannelDescDefault* pDesc =
-					reinterpret_cast<DAFFRecordChannelDescDefault*>(getRecordChannelDescPtr(i, c));
-				pDesc->fixEndianness();
-			}
+	// Every record channel starts at a 32-byte boundary and ends inside the arena
+	uint64_t ui64ArenaValues = oHeader.ui64ArenaSize / sizeof(float);
+	int iSampleSize = getQuantizationSampleSize(m_pMainHeader->iQuantization);
+	std::vector<uint64_t> vui64Offsets(iNumRecordChannels);
+	for (int i = 0; i < iNumRecordChannels; i++) {
+		memcpy(&vui64Offsets[i], pSegment + oHeader.ui64OffsetsOffset + vnSegmentIndices[i] * sizeof(uint64_t),
+			   sizeof(uint64_t));
+		uint64_t ui64NumValues =
+			(bTruncated ? (uint64_t)viLengths[i]
+						: getRecordChannelDataSize(i / iNumChannels, i % iNumChannels) / iSampleSize);
+		if (((vui64Offsets[i] & 7) != 0) || (vui64Offsets[i] > ui64ArenaValues) ||
+			(ui64NumValues > ui64ArenaValues - vui64Offsets[i]))
+			return DAFF_FILE_CORRUPTED;
+	}
 
-			DAFF::le2se_4byte(getRecordMetadataIndexPtr(i), 1);
-		};
+	m_pfDecodedData = (float*)(pSegment + oHeader.ui64ArenaOffset);
+	m_nDecodedDataSize = (size_t)oHeader.ui64ArenaSize;
+	m_vui64DecodedOffsets.swap(vui64Offsets);
+	m_bDecodedDataBorrowed = true;
+	m_iDataQuantization = DAFF_FLOAT32;
+	m_vfBlockScales.clear();
+
+	if (bTruncated) {
+		int iMaxEffectiveFilterLength = 0;
+		for (int i = 0; i < iNumRecordChannels; i++)
+			iMaxEffectiveFilterLength = std::max(iMaxEffectiveFilterLength, viLengths[i]);
+		m_viElementLengths.swap(viLengths);
+		m_pContentHeaderIR->iMaxEffectiveFilterLength = iMaxEffectiveFilterLength;
+		m_bTruncated = true;
+	}
 
-		break;
-	};
+	// Like after decoding and truncating, the stored data is no longer accessed
+	if (!m_bBlocksBorrowed)
+		releaseDataBlock();
+	else if (bTruncated)
+		m_pDataBlock = NULL;
 
 	return DAFF_NO_ERROR;
 }
 
-int DAFFReaderImpl::loadRecordData()
+int DAFFReaderImpl::loadFromSource(DAFFDataSource* pSource, int iOpenFlags)
 {
-	/*
-	 *  5th step: Load the record data
-	 */
-
-	// Fix the endianess of the data
-	switch (m_pMainHeader->iQuantization) {
-	case DAFF_INT16:
-		DAFF::le2se_2byte(m_pDataBlock, (size_t)(m_pDataFileBlock->ui64Size / 2));
-		break;
+	m_bVerify = ((iOpenFlags & DAFF_OPEN_VERIFY) != 0);
+	m_bSlices = ((iOpenFlags & DAFF_OPEN_SLICES) != 0);
 
-	case DAFF_INT24:
-		DAFF::le2se_3byte(m_pDataBlock, (size_t)(m_pDataFileBlock->ui64Size / 3));
-		break;
+	// Sources that provide the whole content in memory are accessed in place
+	const char* pMemory = pSource->map();
+	if (pMemory && (pSource->getSize() <= (uint64_t)((size_t)-1))) {
+		int ec = loadFromMemory(pMemory, (size_t)pSource->getSize(), true, iOpenFlags);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
 
-	case DAFF_FLOAT32:
-		DAFF::le2se_4byte(m_pDataBlock, (size_t)(m_pDataFileBlock->ui64Size / 4));
-		break;
+		return DAFF_NO_ERROR;
 	}
 
-	return DAFF_NO_ERROR;
-}
+	// Streaming fills the cache of the lazy loading
+	if (iOpenFlags & DAFF_OPEN_STREAM)
+		iOpenFlags |= DAFF_OPEN_LAZY;
 
-int DAFFReaderImpl::loadMetadata(char* pMetadataBuf)
-{
-	/*
-	 *  6th step: Load the metadata
-	 */
+	m_pSource = pSource;
 
-	DAFFFileBlockEntry* pMetadataFileBlock = NULL;
-	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_METADATA_ID, pMetadataFileBlock) > 1) {
+	// File header
+	if (pSource->read(0, &m_fileHeader, sizeof(DAFFFileHeader)) != DAFF_NO_ERROR) {
 		tidyup();
+		return DAFF_FILE_INVALID;
+	}
+
+	uint32_t ui32HeaderChecksum = DAFF::crc32c(&m_fileHeader, sizeof(DAFFFileHeader));
+	int ec = loadFileHeader();
+	if (ec != DAFF_NO_ERROR)
+		return ec;
+
+	// File block table (moved into the arena with the main header)
+	size_t iFileBlockTableSize = m_fileHeader.iNumFileBlocks * sizeof(DAFFFileBlockEntry);
+	std::vector<DAFFFileBlockEntry> vFileBlockTable(m_fileHeader.iNumFileBlocks);
+	m_pFileBlockTable = vFileBlockTable.data();
+	if (pSource->read(sizeof(DAFFFileHeader), m_pFileBlockTable, iFileBlockTableSize) != DAFF_NO_ERROR) {
+		tidyup();
+		return DAFF_FILE_INVALID;
+	}
+
+	ui32HeaderChecksum = DAFF::crc32c(m_pFileBlockTable, iFileBlockTableSize, ui32HeaderChecksum);
+	ec = loadFileBlockTable();
+	if (ec != DAFF_NO_ERROR)
+		return ec;
+
+	// All file blocks must reside inside the source
+	uint64_t ui64SourceSize = pSource->getSize();
+	for (int i = 0; i < m_fileHeader.iNumFileBlocks; i++) {
+		if ((m_pFileBlockTable[i].ui64Offset > ui64SourceSize) ||
+			(m_pFileBlockTable[i].ui64Size > ui64SourceSize - m_pFileBlockTable[i].ui64Offset)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+	}
+
+	// Checksums (optional, only read for the verification)
+	DAFFFileBlockEntry* pChecksumsFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_CHECKSUMS_ID, pChecksumsFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (m_bVerify && (pChecksumsFileBlock != nullptr)) {
+		m_oLoadStats.ui64AuxiliaryBytes += pChecksumsFileBlock->ui64Size;
+		std::vector<char> vcChecksums((size_t)pChecksumsFileBlock->ui64Size);
+		if (!vcChecksums.empty() && (pSource->read(pChecksumsFileBlock->ui64Offset, &vcChecksums[0],
+												   vcChecksums.size()) != DAFF_NO_ERROR)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		ec = loadChecksums(vcChecksums.data(), vcChecksums.size(), ui32HeaderChecksum);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	}
+
+	// Main header
+	DAFFFileBlockEntry* pfbMainHeader;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_MAIN_HEADER_ID, pfbMainHeader) != 1) {
+		tidyup();
+		return DAFF_FILE_INVALID;
+	}
+
+	DAFFMainHeader oMainHeader;
+	m_pMainHeader = &oMainHeader;
+	if (pSource->read(pfbMainHeader->ui64Offset, m_pMainHeader, sizeof(DAFFMainHeader)) != DAFF_NO_ERROR) {
+		tidyup();
+		return DAFF_FILE_INVALID;
+	}
+
+	ec = verifyFileBlock(pfbMainHeader, m_pMainHeader, sizeof(DAFFMainHeader));
+	if (ec == DAFF_NO_ERROR)
+		ec = loadMainHeader();
+	if (ec == DAFF_NO_ERROR)
+		ec = initArena(iOpenFlags, false);
+	if (ec != DAFF_NO_ERROR) {
+		tidyup();
+		return ec;
+	}
+
+	// Content header
+	DAFFFileBlockEntry* pfbContentHeader;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_CONTENT_HEADER_ID, pfbContentHeader) != 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (pSource->read(pfbContentHeader->ui64Offset, m_pContentHeader, (size_t)pfbContentHeader->ui64Size) !=
+		DAFF_NO_ERROR) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	ec = verifyFileBlock(pfbContentHeader, m_pContentHeader, (size_t)pfbContentHeader->ui64Size);
+	if (ec == DAFF_NO_ERROR)
+		ec = loadContentHeader();
+	if (ec != DAFF_NO_ERROR) {
+		tidyup();
+		return ec;
+	}
+
+	m_oLoadStats.ui64HeaderBytes = sizeof(DAFFFileHeader) + iFileBlockTableSize + sizeof(DAFFMainHeader) +
+								   pfbContentHeader->ui64Size;
+	endLoadPhase(m_oLoadStats.dHeaderTime, "load.header");
+
+	// Record descriptor
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_RECORD_DESC_ID, m_pRecordDescriptorTable) != 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (pSource->read(m_pRecordDescriptorTable->ui64Offset, m_pRecordDescriptorBlock,
+						  (size_t)m_pRecordDescriptorTable->ui64Size) != DAFF_NO_ERROR) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	ec = verifyFileBlock(m_pRecordDescriptorTable, m_pRecordDescriptorBlock,
+						 (size_t)m_pRecordDescriptorTable->ui64Size);
+	if (ec == DAFF_NO_ERROR)
+		ec = loadRecordDescriptor();
+	if (ec != DAFF_NO_ERROR) {
+		tidyup();
+		return ec;
+	}
+
+	m_oLoadStats.ui64RecordDescriptorBytes = m_pRecordDescriptorTable->ui64Size;
+	endLoadPhase(m_oLoadStats.dRecordDescriptorTime, "load.record_descriptors");
+
+	// Record data (either a data block or a compressed data block)
+	DAFFFileBlockEntry* pCompressedFileBlock = NULL;
+	int iNumDataBlocks = getFirstFileBlockByID(FILEBLOCK_DAFF1_DATA_ID, m_pDataFileBlock);
+	int iNumCompressedBlocks = getFirstFileBlockByID(FILEBLOCK_DAFF1_COMPRESSED_DATA_ID, pCompressedFileBlock);
+	if (iNumDataBlocks + iNumCompressedBlocks != 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (iNumCompressedBlocks == 1)
+		m_pDataFileBlock = pCompressedFileBlock;
+
+	// Lazily loaded record data is verified segment by segment on first access
+	if ((iOpenFlags & DAFF_OPEN_LAZY) && (m_iChecksumSegmentSize > 0))
+		m_vcVerifiedSegments.assign(
+			(size_t)((m_pDataFileBlock->ui64Size + m_iChecksumSegmentSize - 1) / m_iChecksumSegmentSize), 0);
+
+	if (iNumCompressedBlocks == 1) {
+		DAFFCompressedDataHeader oHeader;
+		if ((m_pDataFileBlock->ui64Size < sizeof(DAFFCompressedDataHeader)) ||
+			(pSource->read(m_pDataFileBlock->ui64Offset, &oHeader, sizeof(DAFFCompressedDataHeader)) !=
+			 DAFF_NO_ERROR)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		ec = verifyDataRange(0, sizeof(DAFFCompressedDataHeader));
+		if (ec == DAFF_NO_ERROR)
+			ec = loadCompressedDataHeader(oHeader);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+
+		size_t nChunkTableSize = m_vCompressedChunks.size() * sizeof(DAFFCompressedChunkEntry);
+		if (!m_vCompressedChunks.empty() &&
+			(pSource->read(m_pDataFileBlock->ui64Offset + oHeader.ui64ChunkTableOffset, &m_vCompressedChunks[0],
+						   nChunkTableSize) != DAFF_NO_ERROR)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		ec = verifyDataRange(oHeader.ui64ChunkTableOffset, nChunkTableSize);
+		if (ec == DAFF_NO_ERROR)
+			ec = loadCompressedChunkTable();
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	} else {
+		m_ui64DataSize = m_pDataFileBlock->ui64Size;
+	}
+
+	// Before the data block is allocated
+	ec = checkRecordDataExtent();
+	if (ec != DAFF_NO_ERROR) {
+		tidyup();
+		return ec;
+	}
+
+	// The data of a channel selection or a region is read once the selected record channels are known
+	bool bSelectedData = isSelecting() && !(iOpenFlags & DAFF_OPEN_LAZY) && !m_bCompressed;
+
+	if (iOpenFlags & DAFF_OPEN_LAZY) {
+		// Record data is read (and decompressed) on demand, the source stays opened
+		m_bLazyLoading = true;
+	} else if (bSelectedData) {
+		// Verified segment by segment, like lazily loaded data
+		if (m_iChecksumSegmentSize > 0)
+			m_vcVerifiedSegments.assign(
+				(size_t)((m_pDataFileBlock->ui64Size + m_iChecksumSegmentSize - 1) / m_iChecksumSegmentSize), 0);
+	} else if (m_bCompressed) {
+		void* pBlock = DAFF::malloc_aligned16((size_t)m_pDataFileBlock->ui64Size);
+		if ((pBlock == NULL) || (readDataFileBlock(pSource, pBlock) != DAFF_NO_ERROR)) {
+			DAFF::free_aligned16(pBlock);
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		ec = verifyFileBlock(m_pDataFileBlock, pBlock, (size_t)m_pDataFileBlock->ui64Size);
+		if (ec == DAFF_NO_ERROR)
+			ec = decompressRecordData((const char*)pBlock);
+		DAFF::free_aligned16(pBlock);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	} else {
+		// Data that is decoded or truncated afterwards is not placed in the arena
+		if (m_pDataBlock == NULL)
+			m_pDataBlock = DAFF::malloc_aligned64((size_t)m_pDataFileBlock->ui64Size);
+		if (readDataFileBlock(pSource, m_pDataBlock) != DAFF_NO_ERROR) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		ec = verifyFileBlock(m_pDataFileBlock, m_pDataBlock, (size_t)m_pDataFileBlock->ui64Size);
+		if (ec == DAFF_NO_ERROR)
+			ec = loadRecordData(m_pDataBlock);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	}
+
+	m_oLoadStats.ui64RecordDataBytes = m_bLazyLoading ? 0 : m_pDataFileBlock->ui64Size;
+	endLoadPhase(m_oLoadStats.dRecordDataTime, "load.record_data");
+
+	// Statistics (optional)
+	DAFFFileBlockEntry* pStatisticsFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_STATISTICS_ID, pStatisticsFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (pStatisticsFileBlock != nullptr) {
+		m_oLoadStats.ui64AuxiliaryBytes += pStatisticsFileBlock->ui64Size;
+		size_t nNumEntries = (size_t)m_pMainHeader->iNumRecords * m_pMainHeader->iNumChannels;
+		if (pStatisticsFileBlock->ui64Size != nNumEntries * sizeof(DAFFStatisticsEntry)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		m_vStatistics.resize(nNumEntries);
+		if (pSource->read(pStatisticsFileBlock->ui64Offset, m_vStatistics.data(),
+						  (size_t)pStatisticsFileBlock->ui64Size) != DAFF_NO_ERROR) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		ec = verifyFileBlock(pStatisticsFileBlock, m_vStatistics.data(), (size_t)pStatisticsFileBlock->ui64Size);
+		if (ec == DAFF_NO_ERROR)
+			ec = loadStatistics();
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	}
+
+	// Record directions (optional)
+	DAFFFileBlockEntry* pDirectionsFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_RECORD_DIRECTIONS_ID, pDirectionsFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (pDirectionsFileBlock != nullptr) {
+		m_oLoadStats.ui64AuxiliaryBytes += pDirectionsFileBlock->ui64Size;
+		size_t nNumEntries = (size_t)m_pMainHeader->iNumRecords;
+		if (pDirectionsFileBlock->ui64Size != nNumEntries * sizeof(DAFFRecordDirectionEntry)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		m_vRecordDirections.resize(nNumEntries);
+		if (pSource->read(pDirectionsFileBlock->ui64Offset, m_vRecordDirections.data(),
+						  (size_t)pDirectionsFileBlock->ui64Size) != DAFF_NO_ERROR) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		ec = verifyFileBlock(pDirectionsFileBlock, m_vRecordDirections.data(), (size_t)pDirectionsFileBlock->ui64Size);
+		if (ec == DAFF_NO_ERROR)
+			ec = loadRecordDirections();
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	}
+
+	endLoadPhase(m_oLoadStats.dAuxiliaryTime, "load.auxiliary");
+
+	// Metadata
+	DAFFFileBlockEntry* pMetadataFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_METADATA_ID, pMetadataFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (pMetadataFileBlock == nullptr) {
+		setEmptyMetadata();
+	} else if (pMetadataFileBlock->ui64Size == 0) {
+		setEmptyMetadata();
+	} else {
+		// Metadata block present (kept, the metadata sets refer to it)
+		m_oLoadStats.ui64MetadataBytes = pMetadataFileBlock->ui64Size;
+		if (pSource->read(pMetadataFileBlock->ui64Offset, m_pMetadataBlock, (size_t)pMetadataFileBlock->ui64Size) !=
+			DAFF_NO_ERROR) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		ec = verifyFileBlock(pMetadataFileBlock, m_pMetadataBlock, (size_t)pMetadataFileBlock->ui64Size);
+		if (ec == DAFF_NO_ERROR)
+			ec = loadMetadata(m_pMetadataBlock);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	}
+
+	endLoadPhase(m_oLoadStats.dMetadataTime, "load.metadata");
+
+	// Symmetry (optional)
+	DAFFFileBlockEntry* pSymmetryFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_SYMMETRY_ID, pSymmetryFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (pSymmetryFileBlock != nullptr) {
+		m_oLoadStats.ui64AuxiliaryBytes += pSymmetryFileBlock->ui64Size;
+		DAFFSymmetryHeader oSymmetryHeader;
+		if ((pSymmetryFileBlock->ui64Size != sizeof(DAFFSymmetryHeader)) ||
+			(pSource->read(pSymmetryFileBlock->ui64Offset, &oSymmetryHeader, sizeof(DAFFSymmetryHeader)) !=
+			 DAFF_NO_ERROR)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		ec = verifyFileBlock(pSymmetryFileBlock, &oSymmetryHeader, sizeof(DAFFSymmetryHeader));
+		if (ec == DAFF_NO_ERROR)
+			ec = loadSymmetry(oSymmetryHeader);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	}
+
+	ec = selectChannels();
+	if (ec != DAFF_NO_ERROR) {
+		tidyup();
+		return ec;
+	}
+
+	// Levels (optional)
+	DAFFFileBlockEntry* pLevelsFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_LEVELS_ID, pLevelsFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	std::vector<char> vcLevels;
+	if (pLevelsFileBlock != nullptr) {
+		m_oLoadStats.ui64AuxiliaryBytes += pLevelsFileBlock->ui64Size;
+		vcLevels.resize((size_t)pLevelsFileBlock->ui64Size);
+		if (!vcLevels.empty() &&
+			(pSource->read(pLevelsFileBlock->ui64Offset, &vcLevels[0], vcLevels.size()) != DAFF_NO_ERROR)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		ec = verifyFileBlock(pLevelsFileBlock, vcLevels.data(), vcLevels.size());
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	}
+
+	ec = loadLevels(pLevelsFileBlock ? vcLevels.data() : NULL, vcLevels.size());
+	if (ec != DAFF_NO_ERROR) {
+		tidyup();
+		return ec;
+	}
+
+	// Record order (optional)
+	DAFFFileBlockEntry* pOrderFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_RECORD_ORDER_ID, pOrderFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	m_iRecordOrder = DAFF_RECORD_ORDER_INDEX;
+	if (pOrderFileBlock != nullptr) {
+		m_oLoadStats.ui64AuxiliaryBytes += pOrderFileBlock->ui64Size;
+		DAFFRecordOrderHeader oOrderHeader;
+		if ((pOrderFileBlock->ui64Size != sizeof(DAFFRecordOrderHeader)) ||
+			(pSource->read(pOrderFileBlock->ui64Offset, &oOrderHeader, sizeof(DAFFRecordOrderHeader)) !=
+			 DAFF_NO_ERROR)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		ec = verifyFileBlock(pOrderFileBlock, &oOrderHeader, sizeof(DAFFRecordOrderHeader));
+		if (ec == DAFF_NO_ERROR)
+			ec = loadRecordOrder(oOrderHeader);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	}
+
+	// Direction index (optional, describes the full grid)
+	DAFFFileBlockEntry* pIndexFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_DIRECTION_INDEX_ID, pIndexFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (pIndexFileBlock != nullptr) {
+		m_oLoadStats.ui64AuxiliaryBytes += pIndexFileBlock->ui64Size;
+		size_t nNumEntries = (size_t)m_pMainHeader->iNumRecords;
+		if (pIndexFileBlock->ui64Size != nNumEntries * sizeof(DAFFDirectionIndexEntry)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		m_vDirectionIndexNodes.resize(nNumEntries);
+		if (pSource->read(pIndexFileBlock->ui64Offset, m_vDirectionIndexNodes.data(),
+						  (size_t)pIndexFileBlock->ui64Size) != DAFF_NO_ERROR) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		ec = verifyFileBlock(pIndexFileBlock, m_vDirectionIndexNodes.data(), (size_t)pIndexFileBlock->ui64Size);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	}
+
+	ec = selectRegion();
+	if (ec != DAFF_NO_ERROR) {
+		tidyup();
+		return ec;
+	}
+
+	endLoadPhase(m_oLoadStats.dAuxiliaryTime, "load.auxiliary");
+
+	if (bSelectedData) {
+		ec = loadSelectedRecordData(pSource, NULL);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+
+		endLoadPhase(m_oLoadStats.dRecordDataTime, "load.record_data");
+	}
+
+	fixAngleRanges();
+	ec = loadDirectionIndex();
+	if (ec != DAFF_NO_ERROR) {
+		tidyup();
+		return ec;
+	}
+
+	endLoadPhase(m_oLoadStats.dGridTime, "load.grid");
+
+	if (!m_bLazyLoading) {
+		m_pSource = NULL;
+		std::vector<char>().swap(m_vcVerifyBuf);
+	}
+
+	m_bDAFFObjectFromFileValid = false;
+	m_bDAFFObjectValid = true;
+
+	if (iOpenFlags & DAFF_OPEN_STREAM)
+		startStreaming();
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::loadFromMemory(const char* pBuffer, size_t nSize, bool bBorrow, int iOpenFlags)
+{
+	// Borrowed data can not be converted, so borrowing requires little endian
+	if (!DAFF::is_little_endian())
+		bBorrow = false;
+
+	// Set first, so that tidyup will not free memory it does not own
+	m_bBlocksBorrowed = bBorrow;
+
+	// File header
+	if (nSize < sizeof(DAFFFileHeader)) {
+		tidyup();
+		return DAFF_FILE_INVALID;
+	}
+
+	memcpy(&m_fileHeader, pBuffer, sizeof(DAFFFileHeader));
+
+	int ec = loadFileHeader();
+	if (ec != DAFF_NO_ERROR)
+		return ec;
+
+	// File block table
+	size_t nFileBlockTableSize = m_fileHeader.iNumFileBlocks * sizeof(DAFFFileBlockEntry);
+	if (nFileBlockTableSize > nSize - sizeof(DAFFFileHeader)) {
+		tidyup();
+		return DAFF_FILE_INVALID;
+	}
+
+	// Moved into the arena with the main header
+	std::vector<DAFFFileBlockEntry> vFileBlockTable(m_fileHeader.iNumFileBlocks);
+	m_pFileBlockTable = vFileBlockTable.data();
+	memcpy(m_pFileBlockTable, pBuffer + sizeof(DAFFFileHeader), nFileBlockTableSize);
+
+	ec = loadFileBlockTable();
+	if (ec != DAFF_NO_ERROR)
+		return ec;
+
+	// All file blocks must reside inside the buffer
+	for (int i = 0; i < m_fileHeader.iNumFileBlocks; i++) {
+		if ((m_pFileBlockTable[i].ui64Offset > nSize) ||
+			(m_pFileBlockTable[i].ui64Size > nSize - m_pFileBlockTable[i].ui64Offset)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+	}
+
+	// Checksums (optional), all blocks are in memory and verified right away
+	DAFFFileBlockEntry* pChecksumsFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_CHECKSUMS_ID, pChecksumsFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (m_bVerify && (pChecksumsFileBlock != nullptr)) {
+		m_oLoadStats.ui64AuxiliaryBytes += pChecksumsFileBlock->ui64Size;
+		ec = loadChecksums(pBuffer + pChecksumsFileBlock->ui64Offset, (size_t)pChecksumsFileBlock->ui64Size,
+						   DAFF::crc32c(pBuffer, sizeof(DAFFFileHeader) + nFileBlockTableSize));
+
+		for (int i = 0; (ec == DAFF_NO_ERROR) && (i < m_fileHeader.iNumFileBlocks); i++) {
+			const DAFFFileBlockEntry& oBlock = m_pFileBlockTable[i];
+			if (oBlock.iID != FILEBLOCK_DAFF1_CHECKSUMS_ID)
+				ec = verifyFileBlock(&oBlock, pBuffer + oBlock.ui64Offset, (size_t)oBlock.ui64Size);
+		}
+
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	}
+
+	// Main header
+	DAFFFileBlockEntry* pfbMainHeader;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_MAIN_HEADER_ID, pfbMainHeader) != 1) {
+		tidyup();
+		return DAFF_FILE_INVALID;
+	}
+
+	if (nSize - pfbMainHeader->ui64Offset < sizeof(DAFFMainHeader)) {
+		tidyup();
+		return DAFF_FILE_INVALID;
+	}
+
+	DAFFMainHeader oMainHeader;
+	m_pMainHeader = &oMainHeader;
+	memcpy(m_pMainHeader, pBuffer + pfbMainHeader->ui64Offset, sizeof(DAFFMainHeader));
+
+	ec = loadMainHeader();
+	if (ec != DAFF_NO_ERROR) {
+		tidyup();
+		return ec;
+	}
+
+	// Samples are accessed as 16-bit and 32-bit words, so copy misaligned data
+	// (compressed data can not be accessed in place at all)
+	DAFFFileBlockEntry* pfbData;
+	if (bBorrow && ((getFirstFileBlockByID(FILEBLOCK_DAFF1_DATA_ID, pfbData) != 1) ||
+					(((uintptr_t)(pBuffer + pfbData->ui64Offset)) % 4 != 0))) {
+		bBorrow = false;
+		m_bBlocksBorrowed = false;
+	}
+
+	ec = initArena(iOpenFlags, bBorrow);
+	if (ec != DAFF_NO_ERROR) {
+		tidyup();
+		return ec;
+	}
+
+	// Content header
+	DAFFFileBlockEntry* pfbContentHeader;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_CONTENT_HEADER_ID, pfbContentHeader) != 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	memcpy(m_pContentHeader, pBuffer + pfbContentHeader->ui64Offset, (size_t)pfbContentHeader->ui64Size);
+
+	ec = loadContentHeader();
+	if (ec != DAFF_NO_ERROR) {
+		tidyup();
+		return ec;
+	}
+
+	m_oLoadStats.ui64HeaderBytes = sizeof(DAFFFileHeader) + nFileBlockTableSize + sizeof(DAFFMainHeader) +
+								   pfbContentHeader->ui64Size;
+	endLoadPhase(m_oLoadStats.dHeaderTime, "load.header");
+
+	// Record descriptor
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_RECORD_DESC_ID, m_pRecordDescriptorTable) != 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	// Record data (either a data block or a compressed data block)
+	DAFFFileBlockEntry* pCompressedFileBlock = NULL;
+	int iNumDataBlocks = getFirstFileBlockByID(FILEBLOCK_DAFF1_DATA_ID, m_pDataFileBlock);
+	int iNumCompressedBlocks = getFirstFileBlockByID(FILEBLOCK_DAFF1_COMPRESSED_DATA_ID, pCompressedFileBlock);
+	if (iNumDataBlocks + iNumCompressedBlocks != 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (iNumCompressedBlocks == 1) {
+		m_pDataFileBlock = pCompressedFileBlock;
+
+		DAFFCompressedDataHeader oHeader;
+		if (m_pDataFileBlock->ui64Size < sizeof(DAFFCompressedDataHeader)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		memcpy(&oHeader, pBuffer + m_pDataFileBlock->ui64Offset, sizeof(DAFFCompressedDataHeader));
+		ec = loadCompressedDataHeader(oHeader);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+
+		if (!m_vCompressedChunks.empty())
+			memcpy(&m_vCompressedChunks[0], pBuffer + m_pDataFileBlock->ui64Offset + oHeader.ui64ChunkTableOffset,
+				   m_vCompressedChunks.size() * sizeof(DAFFCompressedChunkEntry));
+
+		ec = loadCompressedChunkTable();
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	} else {
+		m_ui64DataSize = m_pDataFileBlock->ui64Size;
+	}
+
+	if (bBorrow) {
+		m_pRecordDescriptorBlock = (void*)(pBuffer + m_pRecordDescriptorTable->ui64Offset);
+	} else {
+		memcpy(m_pRecordDescriptorBlock, pBuffer + m_pRecordDescriptorTable->ui64Offset,
+			   (size_t)m_pRecordDescriptorTable->ui64Size);
+	}
+
+	// Note: Endianness conversion is a no-op on borrowed (little endian) data
+	ec = loadRecordDescriptor();
+	if (ec == DAFF_NO_ERROR)
+		ec = checkRecordDataExtent();
+	if (ec != DAFF_NO_ERROR) {
+		tidyup();
+		return ec;
+	}
+
+	m_oLoadStats.ui64RecordDescriptorBytes = m_pRecordDescriptorTable->ui64Size;
+	endLoadPhase(m_oLoadStats.dRecordDescriptorTime, "load.record_descriptors");
+
+	// Record data (copied once the record channels of a channel selection or a region are known)
+	bool bSelectedData = isSelecting() && !bBorrow && !m_bCompressed;
+	if (bBorrow) {
+		m_pDataBlock = (void*)(pBuffer + m_pDataFileBlock->ui64Offset);
+	} else if (m_bCompressed) {
+		ec = decompressRecordData(pBuffer + m_pDataFileBlock->ui64Offset);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	} else if (!bSelectedData) {
+		// Data that is decoded or truncated afterwards is not placed in the arena
+		if (m_pDataBlock == NULL)
+			m_pDataBlock = DAFF::malloc_aligned64((size_t)m_pDataFileBlock->ui64Size);
+
+		// Copied and converted into the system byte order in a single pass
+		ec = loadRecordData(pBuffer + m_pDataFileBlock->ui64Offset);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	}
+
+	m_oLoadStats.ui64RecordDataBytes = m_bLazyLoading ? 0 : m_pDataFileBlock->ui64Size;
+	endLoadPhase(m_oLoadStats.dRecordDataTime, "load.record_data");
+
+	// Statistics (optional)
+	DAFFFileBlockEntry* pStatisticsFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_STATISTICS_ID, pStatisticsFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (pStatisticsFileBlock != nullptr) {
+		m_oLoadStats.ui64AuxiliaryBytes += pStatisticsFileBlock->ui64Size;
+		size_t nNumEntries = (size_t)m_pMainHeader->iNumRecords * m_pMainHeader->iNumChannels;
+		if (pStatisticsFileBlock->ui64Size != nNumEntries * sizeof(DAFFStatisticsEntry)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		// Always copied, the entries are small and converted in place
+		m_vStatistics.resize(nNumEntries);
+		memcpy(m_vStatistics.data(), pBuffer + pStatisticsFileBlock->ui64Offset,
+			   (size_t)pStatisticsFileBlock->ui64Size);
+
+		ec = loadStatistics();
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	}
+
+	// Record directions (optional)
+	DAFFFileBlockEntry* pDirectionsFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_RECORD_DIRECTIONS_ID, pDirectionsFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (pDirectionsFileBlock != nullptr) {
+		m_oLoadStats.ui64AuxiliaryBytes += pDirectionsFileBlock->ui64Size;
+		size_t nNumEntries = (size_t)m_pMainHeader->iNumRecords;
+		if (pDirectionsFileBlock->ui64Size != nNumEntries * sizeof(DAFFRecordDirectionEntry)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		// Always copied, the entries are small and converted in place
+		m_vRecordDirections.resize(nNumEntries);
+		memcpy(m_vRecordDirections.data(), pBuffer + pDirectionsFileBlock->ui64Offset,
+			   (size_t)pDirectionsFileBlock->ui64Size);
+
+		ec = loadRecordDirections();
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	}
+
+	endLoadPhase(m_oLoadStats.dAuxiliaryTime, "load.auxiliary");
+
+	// Metadata
+	DAFFFileBlockEntry* pMetadataFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_METADATA_ID, pMetadataFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (pMetadataFileBlock == nullptr) {
+		setEmptyMetadata();
+	} else if (pMetadataFileBlock->ui64Size == 0) {
+		setEmptyMetadata();
+	} else {
+		// Metadata is converted in place, so always work on a copy (kept, the metadata sets refer to it)
+		m_oLoadStats.ui64MetadataBytes = pMetadataFileBlock->ui64Size;
+		memcpy(m_pMetadataBlock, pBuffer + pMetadataFileBlock->ui64Offset, (size_t)pMetadataFileBlock->ui64Size);
+
+		ec = loadMetadata(m_pMetadataBlock);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	}
+
+	endLoadPhase(m_oLoadStats.dMetadataTime, "load.metadata");
+
+	// Symmetry (optional)
+	DAFFFileBlockEntry* pSymmetryFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_SYMMETRY_ID, pSymmetryFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (pSymmetryFileBlock != nullptr) {
+		m_oLoadStats.ui64AuxiliaryBytes += pSymmetryFileBlock->ui64Size;
+		if (pSymmetryFileBlock->ui64Size != sizeof(DAFFSymmetryHeader)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		DAFFSymmetryHeader oSymmetryHeader;
+		memcpy(&oSymmetryHeader, pBuffer + pSymmetryFileBlock->ui64Offset, sizeof(DAFFSymmetryHeader));
+
+		ec = loadSymmetry(oSymmetryHeader);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	}
+
+	ec = selectChannels();
+	if (ec != DAFF_NO_ERROR) {
+		tidyup();
+		return ec;
+	}
+
+	// Levels (optional, copied and converted in place)
+	DAFFFileBlockEntry* pLevelsFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_LEVELS_ID, pLevelsFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	std::vector<char> vcLevels;
+	if (pLevelsFileBlock != nullptr) {
+		m_oLoadStats.ui64AuxiliaryBytes += pLevelsFileBlock->ui64Size;
+		vcLevels.assign(pBuffer + pLevelsFileBlock->ui64Offset,
+						pBuffer + pLevelsFileBlock->ui64Offset + pLevelsFileBlock->ui64Size);
+	}
+
+	ec = loadLevels(pLevelsFileBlock ? vcLevels.data() : NULL, vcLevels.size());
+	if (ec != DAFF_NO_ERROR) {
+		tidyup();
+		return ec;
+	}
+
+	// Record order (optional)
+	DAFFFileBlockEntry* pOrderFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_RECORD_ORDER_ID, pOrderFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	m_iRecordOrder = DAFF_RECORD_ORDER_INDEX;
+	if (pOrderFileBlock != nullptr) {
+		m_oLoadStats.ui64AuxiliaryBytes += pOrderFileBlock->ui64Size;
+		if (pOrderFileBlock->ui64Size != sizeof(DAFFRecordOrderHeader)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		DAFFRecordOrderHeader oOrderHeader;
+		memcpy(&oOrderHeader, pBuffer + pOrderFileBlock->ui64Offset, sizeof(DAFFRecordOrderHeader));
+
+		ec = loadRecordOrder(oOrderHeader);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+	}
+
+	// Direction index (optional, describes the full grid)
+	DAFFFileBlockEntry* pIndexFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_DIRECTION_INDEX_ID, pIndexFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (pIndexFileBlock != nullptr) {
+		m_oLoadStats.ui64AuxiliaryBytes += pIndexFileBlock->ui64Size;
+		size_t nNumEntries = (size_t)m_pMainHeader->iNumRecords;
+		if (pIndexFileBlock->ui64Size != nNumEntries * sizeof(DAFFDirectionIndexEntry)) {
+			tidyup();
+			return DAFF_FILE_CORRUPTED;
+		}
+
+		// Always copied, the entries are small and converted in place
+		m_vDirectionIndexNodes.resize(nNumEntries);
+		memcpy(m_vDirectionIndexNodes.data(), pBuffer + pIndexFileBlock->ui64Offset,
+			   (size_t)pIndexFileBlock->ui64Size);
+	}
+
+	ec = selectRegion();
+	if (ec != DAFF_NO_ERROR) {
+		tidyup();
+		return ec;
+	}
+
+	endLoadPhase(m_oLoadStats.dAuxiliaryTime, "load.auxiliary");
+
+	if (bSelectedData) {
+		ec = loadSelectedRecordData(NULL, pBuffer + m_pDataFileBlock->ui64Offset);
+		if (ec != DAFF_NO_ERROR) {
+			tidyup();
+			return ec;
+		}
+
+		endLoadPhase(m_oLoadStats.dRecordDataTime, "load.record_data");
+	}
+
+	fixAngleRanges();
+	ec = loadDirectionIndex();
+	if (ec != DAFF_NO_ERROR) {
+		tidyup();
+		return ec;
+	}
+
+	endLoadPhase(m_oLoadStats.dGridTime, "load.grid");
+
+	m_bDAFFObjectFromFileValid = false;
+	m_bDAFFObjectValid = true;
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::loadFileHeader()
+{
+	/*
+	 *  1st step: Load the file header and validate it for correctness
+	 */
+
+	m_fileHeader.fixEndianness();
+
+	// Check signature
+	if (!((m_fileHeader.pcSignature[0] == 'F') && (m_fileHeader.pcSignature[1] == 'W'))) {
+		// File is not an OpenDAFF database.
+		tidyup();
+		return DAFF_FILE_INVALID;
+	}
+
+	// Check version
+	// [This implementation supports version number 1.7]
+	if (m_fileHeader.iFileFormatVersion != 170) {
+		// Database version not supported
+		tidyup();
+		return DAFF_FILE_FORMAT_VERSION_UNSUPPORTED;
+	}
+
+	// Check file block entries
+	if (m_fileHeader.iNumFileBlocks <= 0) {
+		// There must be at least one block
+		tidyup();
+		return DAFF_FILE_INVALID;
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::loadFileBlockTable()
+{
+	// Read the file block table
+	size_t iFileBlockTableSize = m_fileHeader.iNumFileBlocks * sizeof(DAFFFileBlockEntry);
+
+	for (int i = 0; i < m_fileHeader.iNumFileBlocks; i++)
+		m_pFileBlockTable[i].fixEndianness();
+
+#if (DAFF_DEBUG == 1)
+	for (int i = 0; i < m_fileHeader.iNumFileBlocks; i++)
+		printf("FILE BLOCK[%d] = { ID = 0x%04X, offset = %llu, size = %llu bytes }\n", i, m_pFileBlockTable[i].iID,
+			   m_pFileBlockTable[i].ui64Offset, m_pFileBlockTable[i].ui64Size);
+#endif
+
+	// Check for correctness
+	for (int i = 0; i < m_fileHeader.iNumFileBlocks; i++) {
+		// Note: IDs are not checked
+		if ((m_pFileBlockTable[i].ui64Offset < (sizeof(DAFFFileHeader) + iFileBlockTableSize))) {
+			tidyup();
+			return DAFF_FILE_INVALID;
+		}
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::loadMainHeader()
+{
+	/*
+	 *  2nd step: Load the main header, validate it for correctness
+	 */
+
+	m_pMainHeader->fixEndianness();
+
+	// Content type
+	switch (m_pMainHeader->iContentType) {
+	case DAFF_IMPULSE_RESPONSE:
+	case DAFF_MAGNITUDE_SPECTRUM:
+	case DAFF_PHASE_SPECTRUM:
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+	case DAFF_DFT_SPECTRUM:
+		break;
+
+	default:
+		// Invalid content type
+		tidyup();
+		return DAFF_FILE_CONTENT_TYPE_UNKOWN;
+	};
+
+	// Quantization
+	switch (m_pMainHeader->iQuantization) {
+	case DAFF_INT16:
+	case DAFF_INT24:
+	case DAFF_INT16_BFP:
+		// Spectra are always stored as floating point values
+		if (m_pMainHeader->iContentType != DAFF_IMPULSE_RESPONSE) {
+			tidyup();
+			return DAFF_FILE_QUANTIZATION_UNKOWN;
+		}
+		m_iDataQuantization = m_pMainHeader->iQuantization;
+		break;
+
+	case DAFF_FLOAT16:
+	case DAFF_BFLOAT16:
+	case DAFF_FLOAT32:
+		m_iDataQuantization = m_pMainHeader->iQuantization;
+		break;
+
+	default:
+		// Invalid quantization
+		tidyup();
+		return DAFF_FILE_QUANTIZATION_UNKOWN;
+	};
+
+	if (m_pMainHeader->iNumChannels < 1)
+		return DAFF_FILE_INVALID_MAIN_PARAMETER;
+
+	if (m_pMainHeader->iNumRecords < 1)
+		return DAFF_FILE_INVALID_MAIN_PARAMETER;
+
+	if (m_pMainHeader->iElementsPerRecord < 1)
+		return DAFF_FILE_INVALID_MAIN_PARAMETER;
+
+	if (m_pMainHeader->iAlphaPoints < 1)
+		return DAFF_FILE_ALPHA_ANGLES_INVALID;
+
+	// alpha start value must not be 360&deg;
+	if ((m_pMainHeader->fAlphaStart < 0.0f) || (m_pMainHeader->fAlphaStart >= 360.0f))
+		return DAFF_FILE_ALPHA_ANGLES_INVALID;
+
+	// alpha stop value may be 360&deg; indicating that the full alpha range is covered.
+	if ((m_pMainHeader->fAlphaEnd < 0.0f) || (m_pMainHeader->fAlphaEnd > 360.0f))
+		return DAFF_FILE_ALPHA_ANGLES_INVALID;
+
+	// Beta angle validation
+	if (m_pMainHeader->iBetaPoints < 1)
+		return DAFF_FILE_BETA_ANGLES_INVALID;
+
+	if (m_pMainHeader->fBetaStart > m_pMainHeader->fBetaEnd)
+		return DAFF_FILE_BETA_ANGLES_INVALID;
+
+	if ((m_pMainHeader->fBetaStart < 0.0f) || (m_pMainHeader->fBetaStart > 180.0f))
+		return DAFF_FILE_BETA_ANGLES_INVALID;
+
+	if ((m_pMainHeader->fBetaEnd < 0.0f) || (m_pMainHeader->fBetaEnd > 180.0f))
+		return DAFF_FILE_BETA_ANGLES_INVALID;
+
+	// Orientation
+	m_orientationDefault.fYawAngleDeg = m_pMainHeader->fOrientYaw;
+	m_orientationDefault.fPitchAngleDeg = m_pMainHeader->fOrientPitch;
+	m_orientationDefault.fRollAngleDeg = m_pMainHeader->fOrientRoll;
+	std::atomic_store(&m_pTrans, std::make_shared<const DAFFSCTransform>(m_orientationDefault));
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::loadContentHeader()
+{
+	/*
+	 *  3rd step: Load the content header, validate it for correctness
+	 */
+
+	float* pfFreqs = 0;
+
+	switch (m_pMainHeader->iContentType) {
+	case DAFF_IMPULSE_RESPONSE:
+		m_pContentHeaderIR = static_cast<DAFFContentHeaderIR*>(m_pContentHeader);
+		m_pContentHeaderIR->fixEndianness();
+
+		if (m_pContentHeaderIR->fSamplerate < 0.0f)
+			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+
+		if ((m_pContentHeaderIR->iMaxEffectiveFilterLength < 0) ||
+			(m_pContentHeaderIR->iMaxEffectiveFilterLength > m_pMainHeader->iElementsPerRecord))
+			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+
+		if ((m_pContentHeaderIR->iMinFilterOffset < 0) ||
+			(m_pContentHeaderIR->iMinFilterOffset > m_pMainHeader->iElementsPerRecord))
+			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+
+		break;
+
+	case DAFF_MAGNITUDE_SPECTRUM:
+		m_pContentHeaderMS = static_cast<DAFFContentHeaderMS*>(m_pContentHeader);
+		m_pContentHeaderMS->fixEndianness();
+
+		if (m_pContentHeaderMS->iNumFreqs <= 0)
+			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+
+		pfFreqs = (float*)((char*)m_pContentHeader + 8);
+
+		// Fix the endianness of the frequency list
+		DAFF::le2se_4byte(pfFreqs, m_pContentHeaderMS->iNumFreqs);
+
+		// Load the (dynamically sized) frequency list
+		m_vfFreqs.resize(m_pContentHeaderMS->iNumFreqs);
+		for (int i = 0; i < m_pContentHeaderMS->iNumFreqs; i++)
+			m_vfFreqs[i] = pfFreqs[i];
+
+		break;
+
+	case DAFF_PHASE_SPECTRUM:
+		m_pContentHeaderPS = static_cast<DAFFContentHeaderPS*>(m_pContentHeader);
+		m_pContentHeaderPS->fixEndianness();
+
+		if (m_pContentHeaderPS->iNumFreqs <= 0)
+			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+
+		pfFreqs = (float*)((char*)m_pContentHeader + 8);
+
+		// Fix the endianness of the frequency list
+		DAFF::le2se_4byte(pfFreqs, m_pContentHeaderPS->iNumFreqs);
+
+		// Load the (dynamically sized) frequency list
+		m_vfFreqs.resize(m_pContentHeaderPS->iNumFreqs);
+		for (int i = 0; i < m_pContentHeaderPS->iNumFreqs; i++)
+			m_vfFreqs[i] = pfFreqs[i];
+
+		break;
+
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		m_pContentHeaderMPS = static_cast<DAFFContentHeaderMPS*>(m_pContentHeader);
+		m_pContentHeaderMPS->fixEndianness();
+
+		if (m_pContentHeaderMPS->iNumFreqs <= 0)
+			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+
+		pfFreqs = (float*)((char*)m_pContentHeader + 8);
+
+		// Fix the endianness of the frequency list
+		DAFF::le2se_4byte(pfFreqs, m_pContentHeaderMPS->iNumFreqs);
+
+		// Load the (dynamically sized) frequency list
+		m_vfFreqs.resize(m_pContentHeaderMPS->iNumFreqs);
+		for (int i = 0; i < m_pContentHeaderMPS->iNumFreqs; i++)
+			m_vfFreqs[i] = pfFreqs[i];
+
+		break;
+
+	case DAFF_DFT_SPECTRUM:
+		m_pContentHeaderDFT = static_cast<DAFFContentHeaderDFT*>(m_pContentHeader);
+		m_pContentHeaderDFT->fixEndianness();
+
+		if ((m_pContentHeaderDFT->iNumDFTCoeffs != m_pContentHeaderDFT->iTransformSize) &&
+			(m_pContentHeaderDFT->iNumDFTCoeffs != floor(m_pContentHeaderDFT->iTransformSize / 2.0) + 1))
+			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+
+		break;
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::loadRecordDescriptor()
+{
+	/*
+	 *  4rd step: Load the record descriptor block
+	 */
+
+	// Set access pointer and fix the endianness
+	switch (m_pMainHeader->iContentType) {
+	case DAFF_IMPULSE_RESPONSE:
+		// A single IR record channel desc is 4+4+4+8 Byte = 20 Bytes, block floating point adds the 4 Byte scale
+		m_iRecordChannelDescSize = sizeof(DAFFRecordChannelDescIR);
+		assert(m_iRecordChannelDescSize == 20);
+		if (m_iDataQuantization == DAFF_INT16_BFP)
+			m_iRecordChannelDescSize = sizeof(DAFFRecordChannelDescIRBFP);
+
+		if (m_pRecordDescriptorTable->ui64Size <
+			(uint64_t)m_pMainHeader->iNumRecords * m_pMainHeader->iNumChannels * m_iRecordChannelDescSize)
+			return DAFF_FILE_CORRUPTED;
+
+		// Fix endianness for channel descriptors (including the metadata index), nothing to do on little endian
+		if (!DAFF::is_little_endian())
+			for (int i = 0; i < m_pMainHeader->iNumRecords; i++) {
+				for (int c = 0; c < m_pMainHeader->iNumChannels; c++) {
+					if (m_iDataQuantization == DAFF_INT16_BFP) {
+						reinterpret_cast<DAFFRecordChannelDescIRBFP*>(getRecordChannelDescPtr(i, c))->fixEndianness();
+						continue;
+					}
+
+					DAFFRecordChannelDescIR* pDesc =
+						reinterpret_cast<DAFFRecordChannelDescIR*>(getRecordChannelDescPtr(i, c));
+					pDesc->fixEndianness();
+				}
+			};
+
+		break;
+
+	case DAFF_MAGNITUDE_SPECTRUM:
+	case DAFF_PHASE_SPECTRUM:
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+	case DAFF_DFT_SPECTRUM:
+		// All other content use a default record channel desc (MS/PS/MPS/DFT) which is 8 Bytes
+		m_iRecordChannelDescSize = sizeof(DAFFRecordChannelDescDefault);
+
+		if (m_pRecordDescriptorTable->ui64Size <
+			(uint64_t)m_pMainHeader->iNumRecords * m_pMainHeader->iNumChannels * m_iRecordChannelDescSize)
+			return DAFF_FILE_CORRUPTED;
+
+		// Fix endianness for channel descriptors (including the metadata index), nothing to do on little endian
+		if (!DAFF::is_little_endian())
+			for (int i = 0; i < m_pMainHeader->iNumRecords; i++) {
+				for (int c = 0; c < m_pMainHeader->iNumChannels; c++) {
+					DAFFRecordChannelDescDefault* pDesc =
+						reinterpret_cast<DAFFRecordChannelDescDefault*>(getRecordChannelDescPtr(i, c));
+					pDesc->fixEndianness();
+				}
+			};
+
+		break;
+	};
+
+	initRecordIndex();
+
+	// Block scales are positive and finite
+	for (size_t i = 0; i < m_vfBlockScales.size(); i++)
+		if (!(m_vfBlockScales[i] > 0) || !(m_vfBlockScales[i] <= FLT_MAX))
+			return DAFF_FILE_CORRUPTED;
+
+	initPayloadIndices();
+
+	return DAFF_NO_ERROR;
+}
+
+void DAFFReaderImpl::initRecordIndex()
+{
+	int iNumRecords = m_pMainHeader->iNumRecords;
+	int iNumChannels = m_pMainHeader->iNumChannels;
+	size_t nNumRecordChannels = (size_t)iNumRecords * iNumChannels;
+	bool bIR = (m_pMainHeader->iContentType == DAFF_IMPULSE_RESPONSE);
+
+	// Reuses the capacity kept from the previous file (see setKeepCapacity)
+	m_vui64DataOffsets.assign(nNumRecordChannels, 0);
+	{
+		// The storage order is rebuilt on demand (e.g. after selecting a region)
+		std::lock_guard<std::mutex> lock(m_mxStorageOrder);
+		m_viStorageOrder.clear();
+		m_viStoragePositions.clear();
+	}
+	m_viLeadingZeros.assign(bIR ? nNumRecordChannels : 0, 0);
+	m_viElementLengths.assign(bIR ? nNumRecordChannels : 0, 0);
+	m_vfBlockScales.assign((m_iDataQuantization == DAFF_INT16_BFP) ? nNumRecordChannels : 0, 1.0f);
+	m_viMetadataIndices.assign(iNumRecords, 0);
+	for (int i = 0; i < iNumRecords; i++) {
+		m_viMetadataIndices[i] = *getRecordMetadataIndexPtr(i);
+		for (int c = 0; c < iNumChannels; c++) {
+			size_t n = (size_t)i * iNumChannels + c;
+			if (bIR) {
+				const DAFFRecordChannelDescIR* pDesc =
+					reinterpret_cast<const DAFFRecordChannelDescIR*>(getRecordChannelDescPtr(i, c));
+				m_vui64DataOffsets[n] = pDesc->ui64DataOffset;
+				m_viLeadingZeros[n] = pDesc->iLeadingZeros;
+				m_viElementLengths[n] = pDesc->iElementLength;
+				if (!m_vfBlockScales.empty())
+					m_vfBlockScales[n] = reinterpret_cast<const DAFFRecordChannelDescIRBFP*>(pDesc)->fScale;
+			} else {
+				// Note: All record channel descriptors start with the metadata index and the data offset
+				const DAFFRecordChannelDescDefault* pDesc =
+					reinterpret_cast<const DAFFRecordChannelDescDefault*>(getRecordChannelDescPtr(i, c));
+				m_vui64DataOffsets[n] = pDesc->ui64DataOffset;
+			}
+		}
+	}
+}
+
+void DAFFReaderImpl::initPayloadIndices()
+{
+	// Record channels with the same data offset, size and scale share their data (e.g. written with deduplication)
+	int iNumChannels = m_pMainHeader->iNumChannels;
+	int iNumRecordChannels = m_pMainHeader->iNumRecords * iNumChannels;
+	std::vector<std::pair<std::pair<uint64_t, size_t>, int> > vPayloads(iNumRecordChannels);
+	for (int i = 0; i < iNumRecordChannels; i++) {
+		vPayloads[i].first.first = m_vui64DataOffsets[i];
+		vPayloads[i].first.second = getRecordChannelDataSize(i / iNumChannels, i % iNumChannels);
+		vPayloads[i].second = i;
+	}
+
+	// Equal data follows the record channel with the smallest index
+	std::sort(vPayloads.begin(), vPayloads.end());
+
+	m_viPayloadIndices.resize(iNumRecordChannels);
+	m_iNumSharedRecordChannels = 0;
+	for (int k = 0; k < iNumRecordChannels; k++) {
+		int i = vPayloads[k].second;
+		if ((k > 0) && (vPayloads[k].first.second > 0) && (vPayloads[k].first == vPayloads[k - 1].first) &&
+			(getBlockScale(i) == getBlockScale(vPayloads[k - 1].second))) {
+			m_viPayloadIndices[i] = m_viPayloadIndices[vPayloads[k - 1].second];
+			m_iNumSharedRecordChannels++;
+		} else {
+			m_viPayloadIndices[i] = i;
+		}
+	}
+}
+
+int DAFFReaderImpl::loadRecordData(const void* pSource)
+{
+	/*
+	 *  5th step: Load the record data
+	 */
+
+	// Fix the endianess of the data (a plain copy on little endian systems)
+	copyRecordData(m_pDataBlock, pSource, (size_t)m_ui64DataSize, m_pMainHeader->iQuantization);
+
+	return DAFF_NO_ERROR;
+}
+
+//! Orders data offsets before chunks (for the search of the chunk that contains an offset)
+static bool isBeforeChunk(uint64_t ui64DataOffset, const DAFFCompressedChunkEntry& oChunk)
+{
+	return ui64DataOffset < oChunk.ui64DataOffset;
+}
+
+int DAFFReaderImpl::loadCompressedDataHeader(DAFFCompressedDataHeader& oHeader)
+{
+	oHeader.fixEndianness();
+
+	// The chunk table must reside inside the block, behind the header
+	uint64_t ui64BlockSize = m_pDataFileBlock->ui64Size;
+	if ((oHeader.iNumChunks < 0) || (oHeader.ui64ChunkTableOffset < sizeof(DAFFCompressedDataHeader)) ||
+		(oHeader.ui64ChunkTableOffset > ui64BlockSize))
+		return DAFF_FILE_CORRUPTED;
+
+	uint64_t ui64MaxChunks = (ui64BlockSize - oHeader.ui64ChunkTableOffset) / sizeof(DAFFCompressedChunkEntry);
+	if ((uint64_t)oHeader.iNumChunks > ui64MaxChunks)
+		return DAFF_FILE_CORRUPTED;
+
+	if (oHeader.ui64DataSize > (uint64_t)((size_t)-1))
+		return DAFF_FILE_CORRUPTED;
+
+	m_bCompressed = true;
+	m_ui64DataSize = oHeader.ui64DataSize;
+	m_vCompressedChunks.resize(oHeader.iNumChunks);
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::loadCompressedChunkTable()
+{
+	uint64_t ui64BlockSize = m_pDataFileBlock->ui64Size;
+	uint64_t ui64End = 0;
+	for (size_t i = 0; i < m_vCompressedChunks.size(); i++) {
+		DAFFCompressedChunkEntry& oChunk = m_vCompressedChunks[i];
+		oChunk.fixEndianness();
+
+		// Compressed chunks inside the block, chunk data ordered and disjoint inside the data block
+		if ((oChunk.ui64Offset > ui64BlockSize) || (oChunk.ui64Size > ui64BlockSize - oChunk.ui64Offset) ||
+			(oChunk.ui64DataOffset < ui64End) || (oChunk.ui64DataOffset > m_ui64DataSize) ||
+			(oChunk.ui64DataSize > m_ui64DataSize - oChunk.ui64DataOffset))
+			return DAFF_FILE_CORRUPTED;
+
+		if ((oChunk.iMethod != DAFF::COMPRESSION_METHOD_NONE) &&
+			(oChunk.iMethod != DAFF::COMPRESSION_METHOD_PREDICTIVE))
+			return DAFF_FILE_CORRUPTED;
+
+		ui64End = oChunk.ui64DataOffset + oChunk.ui64DataSize;
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::checkRecordDataExtent() const
+{
+	uint64_t ui64Extent = 0;
+	int iNumChannels = m_pMainHeader->iNumChannels;
+	for (size_t i = 0; i < m_vui64DataOffsets.size(); i++) {
+		uint64_t ui64Size = (uint64_t)getRecordChannelDataSize((int)i / iNumChannels, (int)i % iNumChannels);
+		if (ui64Size == 0)
+			continue;
+
+		if ((m_vui64DataOffsets[i] > m_ui64DataSize) || (ui64Size > m_ui64DataSize - m_vui64DataOffsets[i]))
+			return DAFF_FILE_CORRUPTED;
+		ui64Extent = std::max(ui64Extent, m_vui64DataOffsets[i] + ui64Size);
+	}
+
+	if (!m_bCompressed)
+		return DAFF_NO_ERROR;
+
+	// The size of the uncompressed data is only bounded by the header of the compressed data block
+	if (!m_vCompressedChunks.empty())
+		ui64Extent = std::max(ui64Extent, m_vCompressedChunks.back().ui64DataOffset +
+											  m_vCompressedChunks.back().ui64DataSize);
+
+	if ((m_ui64DataSize - ui64Extent > DAFF_MAX_DATA_PADDING) || (m_ui64DataSize > (uint64_t)((size_t)-1)))
+		return DAFF_FILE_CORRUPTED;
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::decompressRecordData(const char* pBlock)
+{
+	// Note: The size is validated by checkRecordDataExtent
+	m_pDataBlock = DAFF::malloc_aligned64((size_t)m_ui64DataSize);
+	if ((m_pDataBlock == NULL) && (m_ui64DataSize > 0))
+		return DAFF_FILE_CORRUPTED;
+
+	// Gaps between the chunks are zero
+	memset(m_pDataBlock, 0, (size_t)m_ui64DataSize);
+
+	int iSampleSize = getQuantizationSampleSize(m_pMainHeader->iQuantization);
+	for (size_t i = 0; i < m_vCompressedChunks.size(); i++) {
+		const DAFFCompressedChunkEntry& oChunk = m_vCompressedChunks[i];
+		int ec = DAFF::decompress_chunk(oChunk.iMethod, iSampleSize, pBlock + oChunk.ui64Offset,
+										(size_t)oChunk.ui64Size, (char*)m_pDataBlock + oChunk.ui64DataOffset,
+										(size_t)oChunk.ui64DataSize);
+		if (ec != DAFF_NO_ERROR)
+			return ec;
+	}
+
+	return loadRecordData(m_pDataBlock);
+}
+
+int DAFFReaderImpl::decompressRange(uint64_t ui64DataOffset, void* pDest, size_t nSize) const
+{
+	if (nSize == 0)
+		return DAFF_NO_ERROR;
+
+	// Last chunk that starts at or before the offset
+	std::vector<DAFFCompressedChunkEntry>::const_iterator it =
+		std::upper_bound(m_vCompressedChunks.begin(), m_vCompressedChunks.end(), ui64DataOffset, isBeforeChunk);
+	if (it == m_vCompressedChunks.begin())
+		return DAFF_FILE_CORRUPTED;
+
+	const DAFFCompressedChunkEntry& oChunk = *(--it);
+	uint64_t ui64RangeOffset = ui64DataOffset - oChunk.ui64DataOffset;
+	if ((ui64RangeOffset > oChunk.ui64DataSize) || (nSize > oChunk.ui64DataSize - ui64RangeOffset))
+		return DAFF_FILE_CORRUPTED;
+
+	// Ranges that do not cover the whole chunk are decompressed behind the compressed chunk
+	size_t nCompressedSize = (size_t)oChunk.ui64Size;
+	bool bWholeChunk = (ui64RangeOffset == 0) && (nSize == oChunk.ui64DataSize);
+	m_vcCompressedBuf.resize(nCompressedSize + (bWholeChunk ? 0 : (size_t)oChunk.ui64DataSize) + 1);
+
+	int ec = verifyDataRange(oChunk.ui64Offset, nCompressedSize);
+	if (ec != DAFF_NO_ERROR)
+		return ec;
+
+	if (m_pSource->read(m_pDataFileBlock->ui64Offset + oChunk.ui64Offset, &m_vcCompressedBuf[0], nCompressedSize) !=
+		DAFF_NO_ERROR)
+		return DAFF_FILE_CORRUPTED;
+
+	int iSampleSize = getQuantizationSampleSize(m_pMainHeader->iQuantization);
+	if (bWholeChunk)
+		return DAFF::decompress_chunk(oChunk.iMethod, iSampleSize, &m_vcCompressedBuf[0], nCompressedSize, pDest,
+									  nSize);
+
+	char* pChunkData = &m_vcCompressedBuf[nCompressedSize];
+	ec = DAFF::decompress_chunk(oChunk.iMethod, iSampleSize, &m_vcCompressedBuf[0], nCompressedSize, pChunkData,
+								(size_t)oChunk.ui64DataSize);
+	if (ec != DAFF_NO_ERROR)
+		return ec;
+
+	memcpy(pDest, pChunkData + ui64RangeOffset, nSize);
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::loadMetadata(char* pMetadataBuf)
+{
+	/*
+	 *  6th step: Load the metadata
+	 */
+
+	DAFFFileBlockEntry* pMetadataFileBlock = NULL;
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_METADATA_ID, pMetadataFileBlock) > 1) {
+		tidyup();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	if (pMetadataFileBlock == nullptr) {
+		setEmptyMetadata();
+	} else if (pMetadataFileBlock->ui64Size == 0) {
+		setEmptyMetadata();
+	} else {
+		// Index the DAFFMetadataImpl instances, which are parsed on first access
+		std::vector<size_t> vnOffsets;
+		size_t nSize = (size_t)pMetadataFileBlock->ui64Size;
+		size_t nOffset = 0;
+		while (nOffset < nSize) {
+			size_t nBytesRead = 0;
+			int iError = DAFFMetadataImpl::scan(pMetadataBuf + nOffset, nSize - nOffset, nBytesRead);
+			if (iError != DAFF_NO_ERROR) {
+				tidyup();
+				return iError;
+			}
+
+			vnOffsets.push_back(nOffset);
+			nOffset += nBytesRead;
+		}
+		vnOffsets.push_back(nSize);
+
+		m_iNumMetadataSets = (int)vnOffsets.size() - 1;
+		m_pMetadataSets.reset(new DAFFMetadataImpl[m_iNumMetadataSets]);
+		for (int i = 0; i < m_iNumMetadataSets; i++)
+			m_pMetadataSets[i].defer(pMetadataBuf + vnOffsets[i], vnOffsets[i + 1] - vnOffsets[i]);
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::loadStatistics()
+{
+	/*
+	 *  7th step: Load the statistics (optional)
+	 */
+
+	int iLength = getStatisticsLength();
+	for (size_t i = 0; i < m_vStatistics.size(); i++) {
+		DAFFStatisticsEntry& oEntry = m_vStatistics[i];
+		oEntry.fixEndianness();
+
+		if (!(oEntry.fPeak >= 0) || !(oEntry.fEnergy >= 0) || (oEntry.iOnset < -1) || (oEntry.iOnset >= iLength))
+			return DAFF_FILE_CORRUPTED;
+	}
+
+	m_bStatisticsStored = true;
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::loadRecordDirections()
+{
+	/*
+	 *  8th step: Load the record directions (optional, irregular grids)
+	 */
+
+	// The index is set up with the direction index (loadDirectionIndex), once the grid is complete
+	for (size_t i = 0; i < m_vRecordDirections.size(); i++) {
+		DAFFRecordDirectionEntry& oEntry = m_vRecordDirections[i];
+		oEntry.fixEndianness();
+
+		if (!(oEntry.fAlpha >= 0) || !(oEntry.fAlpha < 360) || !(oEntry.fBeta >= 0) || !(oEntry.fBeta <= 180))
+			return DAFF_FILE_CORRUPTED;
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::loadSymmetry(DAFFSymmetryHeader& oHeader)
+{
+	/*
+	 *  9th step: Expand the stored records of a symmetric grid to the full grid (optional)
+	 */
+
+	oHeader.fixEndianness();
+
+	// Only regular grids over the full alpha range are stored symmetrically
+	int iAlphaPoints = oHeader.iAlphaPoints;
+	int iStoredAlphaPoints = m_pMainHeader->iAlphaPoints;
+	if (!m_vRecordDirections.empty() || (m_pMainHeader->fAlphaStart != 0) || (iAlphaPoints < 1))
+		return DAFF_FILE_CORRUPTED;
+
+	switch (oHeader.iSymmetry) {
+	case DAFF_SYMMETRY_AXIAL:
+		if ((iStoredAlphaPoints != 1) || (m_pMainHeader->fAlphaEnd != 0))
+			return DAFF_FILE_CORRUPTED;
+		break;
+
+	case DAFF_SYMMETRY_MIRROR:
+		if ((iAlphaPoints < 2) || (iAlphaPoints % 2 != 0) || (iStoredAlphaPoints != iAlphaPoints / 2 + 1) ||
+			(m_pMainHeader->fAlphaEnd != 180))
+			return DAFF_FILE_CORRUPTED;
+		break;
+
+	default:
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	// Poles are single records, all other rows hold the full alpha range
+	int iBetaPoints = m_pMainHeader->iBetaPoints;
+	bool bSouthPole = (m_pMainHeader->fBetaStart == 0);
+	bool bNorthPole = (m_pMainHeader->fBetaEnd == 180);
+	int64_t i64NumStoredRecords = 0, i64NumRecords = 0;
+	for (int b = 0; b < iBetaPoints; b++) {
+		bool bPole = (bSouthPole && (b == 0)) || (bNorthPole && (b == iBetaPoints - 1));
+		i64NumStoredRecords += (bPole ? 1 : iStoredAlphaPoints);
+		i64NumRecords += (bPole ? 1 : iAlphaPoints);
+	}
+
+	int iNumChannels = m_pMainHeader->iNumChannels;
+	if ((i64NumStoredRecords != m_pMainHeader->iNumRecords) || (i64NumRecords * iNumChannels > INT_MAX))
+		return DAFF_FILE_CORRUPTED;
+
+	size_t nDescSize = (size_t)i64NumRecords * iNumChannels * m_iRecordChannelDescSize;
+	char* pDescBlock = (char*)DAFF::malloc_aligned16(nDescSize);
+	if (pDescBlock == NULL)
+		return DAFF_FILE_CORRUPTED;
+
+	std::vector<DAFFStatisticsEntry> vStatistics(m_bStatisticsStored ? (size_t)i64NumRecords * iNumChannels : 0);
+
+	// Mirrored records (alpha > 180) refer to the data of the stored ones in reverse channel order
+	int iStoredRecord = 0, iRecord = 0;
+	for (int b = 0; b < iBetaPoints; b++) {
+		bool bPole = (bSouthPole && (b == 0)) || (bNorthPole && (b == iBetaPoints - 1));
+		int iRowPoints = (bPole ? 1 : iAlphaPoints);
+		for (int a = 0; a < iRowPoints; a++) {
+			int iStoredAlpha = 0;
+			bool bMirrored = false;
+			if (!bPole && (oHeader.iSymmetry == DAFF_SYMMETRY_MIRROR)) {
+				bMirrored = (a > iAlphaPoints / 2);
+				iStoredAlpha = (bMirrored ? iAlphaPoints - a : a);
+			}
+
+			int iSource = iStoredRecord + iStoredAlpha;
+			int iMetadataIndex = *getRecordMetadataIndexPtr(iSource);
+			for (int c = 0; c < iNumChannels; c++) {
+				int iSourceChannel = (bMirrored ? iNumChannels - 1 - c : c);
+				char* pDesc = pDescBlock + ((size_t)(iRecord + a) * iNumChannels + c) * m_iRecordChannelDescSize;
+				memcpy(pDesc, getRecordChannelDescPtr(iSource, iSourceChannel), m_iRecordChannelDescSize);
+				memcpy(pDesc, &iMetadataIndex, sizeof(int));  // Index is at first position of descriptor struct
+
+				if (m_bStatisticsStored)
+					vStatistics[(iRecord + a) * iNumChannels + c] =
+						m_vStatistics[iSource * iNumChannels + iSourceChannel];
+			}
+		}
+
+		iStoredRecord += (bPole ? 1 : iStoredAlphaPoints);
+		iRecord += iRowPoints;
+	}
+
+	// The expanded descriptors are always owned, also for borrowed blocks (stored ones are borrowed or in the arena)
+	m_pRecordDescriptorBlock = pDescBlock;
+	m_vStatistics.swap(vStatistics);
+
+	// From now on the reader describes the full grid
+	m_iSymmetry = oHeader.iSymmetry;
+	m_iNumStoredRecords = m_pMainHeader->iNumRecords;
+	m_pMainHeader->iNumRecords = (int32_t)i64NumRecords;
+	m_pMainHeader->iAlphaPoints = iAlphaPoints;
+	m_pMainHeader->fAlphaEnd = 360;
+
+	initRecordIndex();
+	initPayloadIndices();
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::selectChannels()
+{
+	/*
+	 *  13th step: Restrict the records to the selected channels (optional, see setChannelSelection)
+	 */
+
+	int iNumStoredChannels = m_pMainHeader->iNumChannels;
+	if (m_viChannelSelection.empty())
+		return DAFF_NO_ERROR;
+
+	for (size_t k = 0; k < m_viChannelSelection.size(); k++)
+		if ((m_viChannelSelection[k] < 0) || (m_viChannelSelection[k] >= iNumStoredChannels))
+			return DAFF_INVALID_INDEX;
+
+	int iNumRecords = m_pMainHeader->iNumRecords;
+	int iNumChannels = (int)m_viChannelSelection.size();
+	size_t nDescSize = (size_t)iNumRecords * iNumChannels * m_iRecordChannelDescSize;
+	char* pDescBlock = (char*)DAFF::malloc_aligned16(std::max(nDescSize, (size_t)1));
+	if (pDescBlock == NULL)
+		return DAFF_FILE_CORRUPTED;
+
+	std::vector<DAFFStatisticsEntry> vStatistics(m_bStatisticsStored ? (size_t)iNumRecords * iNumChannels : 0);
+
+	// Mirrored records of symmetric grids keep referring to the data of the stored channels
+	for (int r = 0; r < iNumRecords; r++) {
+		int iMetadataIndex = m_viMetadataIndices[r];
+		for (int c = 0; c < iNumChannels; c++) {
+			int iStoredChannel = m_viChannelSelection[c];
+			char* pDesc = pDescBlock + ((size_t)r * iNumChannels + c) * m_iRecordChannelDescSize;
+			memcpy(pDesc, getRecordChannelDescPtr(r, iStoredChannel), m_iRecordChannelDescSize);
+			memcpy(pDesc, &iMetadataIndex, sizeof(int));  // Index is at first position of descriptor struct
+
+			if (m_bStatisticsStored)
+				vStatistics[(size_t)r * iNumChannels + c] =
+					m_vStatistics[(size_t)r * iNumStoredChannels + iStoredChannel];
+		}
+	}
+
+	// The previous descriptors are owned if expanded (stored ones are borrowed or in the arena)
+	if (!isArenaBlock(m_pRecordDescriptorBlock) && ownsRecordDescriptors())
+		DAFF::free_aligned16(m_pRecordDescriptorBlock);
+	m_pRecordDescriptorBlock = pDescBlock;
+	m_vStatistics.swap(vStatistics);
+
+	// From now on the reader describes the selected channels
+	m_viSelectedChannels = m_viChannelSelection;
+	m_iNumStoredChannels = iNumStoredChannels;
+	m_pMainHeader->iNumChannels = iNumChannels;
+
+	initRecordIndex();
+	initPayloadIndices();
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::loadSelectedRecordData(DAFFDataSource* pSource, const char* pData)
+{
+	/*
+	 *  14th step: Load the data of the selected record channels (channel selection)
+	 */
+
+	// Data ranges of the record channels [offset, end), equal data is read once
+	int iNumChannels = m_pMainHeader->iNumChannels;
+	int iNumRecordChannels = m_pMainHeader->iNumRecords * iNumChannels;
+	std::vector<std::pair<uint64_t, uint64_t> > vRanges;
+	vRanges.reserve(iNumRecordChannels);
+	for (int i = 0; i < iNumRecordChannels; i++) {
+		uint64_t ui64Offset = m_vui64DataOffsets[i];
+		uint64_t ui64Size = (uint64_t)getRecordChannelDataSize(i / iNumChannels, i % iNumChannels);
+		if ((ui64Offset > m_ui64DataSize) || (ui64Size > m_ui64DataSize - ui64Offset))
+			return DAFF_FILE_CORRUPTED;
+		if (ui64Size > 0)
+			vRanges.push_back(std::make_pair(ui64Offset, ui64Offset + ui64Size));
+	}
+
+	std::sort(vRanges.begin(), vRanges.end());
+	vRanges.erase(std::unique(vRanges.begin(), vRanges.end()), vRanges.end());
+
+	// Close ranges are read at once (blocks), the blocks keep their offset modulo 64 Bytes
+	std::vector<std::pair<uint64_t, uint64_t> > vBlocks;
+	for (size_t k = 0; k < vRanges.size(); k++) {
+		if (!vBlocks.empty() && (vRanges[k].first <= vBlocks.back().second + DAFF_SELECTION_MAX_GAP))
+			vBlocks.back().second = std::max(vBlocks.back().second, vRanges[k].second);
+		else
+			vBlocks.push_back(vRanges[k]);
+	}
+
+	std::vector<uint64_t> vui64PackedOffsets(vBlocks.size());
+	uint64_t ui64PackedSize = 0, ui64ReadSize = 0;
+	for (size_t b = 0; b < vBlocks.size(); b++) {
+		vui64PackedOffsets[b] = ((ui64PackedSize + 63) & ~(uint64_t)63) + (vBlocks[b].first & 63);
+		ui64PackedSize = vui64PackedOffsets[b] + (vBlocks[b].second - vBlocks[b].first);
+		ui64ReadSize += vBlocks[b].second - vBlocks[b].first;
+	}
+
+	if (ui64PackedSize > (uint64_t)((size_t)-1))
+		return DAFF_FILE_CORRUPTED;
+
+	m_pDataBlock = DAFF::malloc_aligned64((size_t)ui64PackedSize);
+	if ((m_pDataBlock == NULL) && (ui64PackedSize > 0))
+		return DAFF_FILE_CORRUPTED;
+
+	char* pPacked = (char*)m_pDataBlock;
+	for (size_t b = 0; b < vBlocks.size(); b++) {
+		if (m_bOpening && !continueOpen((float)((double)b / (double)vBlocks.size())))
+			return DAFF_OPEN_CANCELLED;
+
+		size_t nBytes = (size_t)(vBlocks[b].second - vBlocks[b].first);
+		if (pData) {
+			memcpy(pPacked + vui64PackedOffsets[b], pData + vBlocks[b].first, nBytes);
+		} else {
+			if (pSource->read(m_pDataFileBlock->ui64Offset + vBlocks[b].first, pPacked + vui64PackedOffsets[b],
+							  nBytes) != DAFF_NO_ERROR)
+				return DAFF_FILE_CORRUPTED;
+
+			int ec = verifyDataRange(vBlocks[b].first, nBytes);
+			if (ec != DAFF_NO_ERROR)
+				return ec;
+		}
+	}
+
+	// Only the record index is updated, the descriptors keep the stored offsets
+	std::pair<uint64_t, uint64_t> oEnd(0, ~(uint64_t)0);
+	for (int i = 0; i < iNumRecordChannels; i++) {
+		if (getRecordChannelDataSize(i / iNumChannels, i % iNumChannels) == 0) {
+			m_vui64DataOffsets[i] = 0;
+			continue;
+		}
+
+		oEnd.first = m_vui64DataOffsets[i];
+		size_t b = (size_t)(std::upper_bound(vBlocks.begin(), vBlocks.end(), oEnd) - vBlocks.begin()) - 1;
+		m_vui64DataOffsets[i] = vui64PackedOffsets[b] + (m_vui64DataOffsets[i] - vBlocks[b].first);
+	}
+
+	// Fix the endianness per record channel (in place), nothing to do on little endian
+	if (!DAFF::is_little_endian())
+		for (size_t k = 0, b = 0; k < vRanges.size(); k++) {
+			while (vRanges[k].first >= vBlocks[b].second)
+				b++;
+			if ((k > 0) && (vRanges[k].first == vRanges[k - 1].first))
+				continue;
+
+			char* p = pPacked + vui64PackedOffsets[b] + (vRanges[k].first - vBlocks[b].first);
+			copyRecordData(p, p, (size_t)(vRanges[k].second - vRanges[k].first), m_pMainHeader->iQuantization);
+		}
+
+	m_ui64DataSize = ui64PackedSize;
+	m_oLoadStats.ui64RecordDataBytes = ui64ReadSize;
+	std::vector<char>().swap(m_vcVerifiedSegments);
+
+	return DAFF_NO_ERROR;
+}
+
+//! Returns the unit vector of a direction in data spherical coordinates (beta = 0 => -z, like DAFFSphereIndex)
+static void getDirectionVector(float fAlphaDeg, float fBetaDeg, float* v)
+{
+	float fAlpha = DAFFUtils::grad2radf(fAlphaDeg);
+	float fBeta = DAFFUtils::grad2radf(fBetaDeg);
+	float fSinBeta = sinf(fBeta);
+	v[0] = fSinBeta * cosf(fAlpha);
+	v[1] = fSinBeta * sinf(fAlpha);
+	v[2] = -cosf(fBeta);
+}
+
+int DAFFReaderImpl::selectRegion()
+{
+	/*
+	 *  15th step: Restrict the records to the selected region (optional, see setRegion)
+	 */
+
+	const DAFFRegion& oRegion = m_oRegionSelection;
+	if (oRegion.iType == DAFF_REGION_ALL)
+		return DAFF_NO_ERROR;
+
+	// The directions of regular grids require their resolution
+	fixAngleRanges();
+
+	int iNumGridRecords = m_pMainHeader->iNumRecords;
+	std::vector<float> vfAlpha(iNumGridRecords), vfBeta(iNumGridRecords);
+	for (int r = 0; r < iNumGridRecords; r++)
+		getRecordCoords(r, DAFF_DATA_VIEW, vfAlpha[r], vfBeta[r]);
+
+	// Records in the order of the full grid
+	std::vector<int> viRecords;
+	switch (oRegion.iType) {
+	case DAFF_REGION_BETA_RANGE:
+		for (int r = 0; r < iNumGridRecords; r++)
+			if ((vfBeta[r] >= oRegion.fBetaStart - DAFF_REGION_TOLERANCE) &&
+				(vfBeta[r] <= oRegion.fBetaEnd + DAFF_REGION_TOLERANCE))
+				viRecords.push_back(r);
+		break;
+
+	case DAFF_REGION_CONE: {
+		float fAlpha, fBeta;
+		transformAnglesO2D(oRegion.fConeAzimuth, oRegion.fConeElevation, fAlpha, fBeta);
+		getDirectionVector(fAlpha, fBeta, m_pfRegionAxis);
+		m_fRegionCosAngle = cosf(DAFFUtils::grad2radf(std::min(oRegion.fConeAngle + DAFF_REGION_TOLERANCE, 180.0f)));
+
+		for (int r = 0; r < iNumGridRecords; r++) {
+			float v[3];
+			getDirectionVector(vfAlpha[r], vfBeta[r], v);
+			if (v[0] * m_pfRegionAxis[0] + v[1] * m_pfRegionAxis[1] + v[2] * m_pfRegionAxis[2] >= m_fRegionCosAngle)
+				viRecords.push_back(r);
+		}
+		break;
+	}
+
+	case DAFF_REGION_RECORDS:
+		viRecords = oRegion.viRecords;
+		std::sort(viRecords.begin(), viRecords.end());
+		viRecords.erase(std::unique(viRecords.begin(), viRecords.end()), viRecords.end());
+		if (!viRecords.empty() && ((viRecords.front() < 0) || (viRecords.back() >= iNumGridRecords)))
+			return DAFF_INVALID_INDEX;
+		break;
+
+	default:
+		return DAFF_INVALID_INDEX;
+	}
+
+	if (viRecords.empty())
+		return DAFF_INVALID_INDEX;
+
+	int iNumRecords = (int)viRecords.size();
+	int iNumChannels = m_pMainHeader->iNumChannels;
+	size_t nDescSize = (size_t)iNumRecords * iNumChannels * m_iRecordChannelDescSize;
+	char* pDescBlock = (char*)DAFF::malloc_aligned16(std::max(nDescSize, (size_t)1));
+	if (pDescBlock == NULL)
+		return DAFF_FILE_CORRUPTED;
+
+	std::vector<DAFFStatisticsEntry> vStatistics(m_bStatisticsStored ? (size_t)iNumRecords * iNumChannels : 0);
+
+	for (int k = 0; k < iNumRecords; k++) {
+		int r = viRecords[k];
+		int iMetadataIndex = m_viMetadataIndices[r];
+		for (int c = 0; c < iNumChannels; c++) {
+			char* pDesc = pDescBlock + ((size_t)k * iNumChannels + c) * m_iRecordChannelDescSize;
+			memcpy(pDesc, getRecordChannelDescPtr(r, c), m_iRecordChannelDescSize);
+			memcpy(pDesc, &iMetadataIndex, sizeof(int));  // Index is at first position of descriptor struct
+
+			if (m_bStatisticsStored)
+				vStatistics[(size_t)k * iNumChannels + c] = m_vStatistics[(size_t)r * iNumChannels + c];
+		}
+	}
+
+	// The previous descriptors are owned if expanded or selected (stored ones are borrowed or in the arena)
+	if (!isArenaBlock(m_pRecordDescriptorBlock) && ownsRecordDescriptors())
+		DAFF::free_aligned16(m_pRecordDescriptorBlock);
+	m_pRecordDescriptorBlock = pDescBlock;
+	m_vStatistics.swap(vStatistics);
+
+	if (isRegularGrid() && (oRegion.iType == DAFF_REGION_BETA_RANGE)) {
+		// The rows of a beta range are contiguous records, the grid is narrowed to them
+		float fBetaStart = m_pMainHeader->fBetaStart;
+		int iFirstRow = 0, iLastRow = 0;
+		if (m_fBetaResolution > 0) {
+			iFirstRow = (int)roundf((vfBeta[viRecords.front()] - fBetaStart) / m_fBetaResolution);
+			iLastRow = (int)roundf((vfBeta[viRecords.back()] - fBetaStart) / m_fBetaResolution);
+		}
+
+		if (iLastRow < m_pMainHeader->iBetaPoints - 1)
+			m_pMainHeader->fBetaEnd = fBetaStart + (float)iLastRow * m_fBetaResolution;
+		if (iFirstRow > 0)
+			m_pMainHeader->fBetaStart = fBetaStart + (float)iFirstRow * m_fBetaResolution;
+		m_pMainHeader->iBetaPoints = iLastRow - iFirstRow + 1;
+	} else {
+		// Like irregular grids of the writer: a single point in each dimension spanning the whole sphere
+		std::vector<DAFFRecordDirectionEntry> vDirections(iNumRecords);
+		for (int k = 0; k < iNumRecords; k++) {
+			vDirections[k].fAlpha = vfAlpha[viRecords[k]];
+			vDirections[k].fBeta = vfBeta[viRecords[k]];
+		}
+
+		m_vRecordDirections.swap(vDirections);
+		m_pMainHeader->iAlphaPoints = 1;
+		m_pMainHeader->fAlphaStart = 0;
+		m_pMainHeader->fAlphaEnd = 360;
+		m_pMainHeader->iBetaPoints = 1;
+		m_pMainHeader->fBetaStart = 0;
+		m_pMainHeader->fBetaEnd = 180;
+
+		if (oRegion.iType == DAFF_REGION_RECORDS)
+			m_oGridIndex.init(vfAlpha.data(), vfBeta.data(), iNumGridRecords);
+	}
+
+	// The levels and the stored direction index describe the full grid
+	std::vector<DAFFDirectionIndexEntry>().swap(m_vDirectionIndexNodes);
+	loadLevels(NULL, 0);
+
+	// From now on the reader describes the region
+	m_oRegion = oRegion;
+	m_viRegionRecords.swap(viRecords);
+	m_iNumGridRecords = iNumGridRecords;
+	m_pMainHeader->iNumRecords = iNumRecords;
+
+	initRecordIndex();
+	initPayloadIndices();
+
+	return DAFF_NO_ERROR;
+}
+
+bool DAFFReaderImpl::ownsRecordDescriptors() const
+{
+	// Expanded symmetric and selected descriptors are always owned, also for borrowed blocks
+	return !m_bBlocksBorrowed || (m_iSymmetry != DAFF_SYMMETRY_NONE) || !m_viSelectedChannels.empty() ||
+		   !m_viRegionRecords.empty();
+}
+
+bool DAFFReaderImpl::isSelecting() const
+{
+	return !m_viChannelSelection.empty() || (m_oRegionSelection.iType != DAFF_REGION_ALL);
+}
+
+int DAFFReaderImpl::loadLevels(char* pBlock, size_t nSize)
+{
+	/*
+	 *  12th step: Load the resolution levels of the record data (optional)
+	 */
+
+	m_vLevels.clear();
+	if (pBlock == NULL) {
+		DAFFLevelEntry oLevel;
+		oLevel.iStep = 1;
+		oLevel.ui64DataEnd = m_ui64DataSize;
+		m_vLevels.push_back(oLevel);
+		m_iNumLoadedLevels = 1;
+		return DAFF_NO_ERROR;
+	}
+
+	if (nSize < sizeof(DAFFLevelHeader))
+		return DAFF_FILE_CORRUPTED;
+
+	DAFFLevelHeader oHeader;
+	memcpy(&oHeader, pBlock, sizeof(DAFFLevelHeader));
+	oHeader.fixEndianness();
+
+	// Levels are written for regular grids without symmetry only
+	if ((oHeader.iNumLevels < 1) || (oHeader.iNumLevels > 31) ||
+		(nSize != sizeof(DAFFLevelHeader) + (size_t)oHeader.iNumLevels * sizeof(DAFFLevelEntry)) ||
+		!m_vRecordDirections.empty() || (m_iSymmetry != DAFF_SYMMETRY_NONE))
+		return DAFF_FILE_CORRUPTED;
+
+	// Steps decrease down to the full resolution, the data of the levels follows each other
+	m_vLevels.resize(oHeader.iNumLevels);
+	memcpy(m_vLevels.data(), pBlock + sizeof(DAFFLevelHeader), m_vLevels.size() * sizeof(DAFFLevelEntry));
+	for (size_t i = 0; i < m_vLevels.size(); i++) {
+		m_vLevels[i].fixEndianness();
+		if ((m_vLevels[i].iStep < 1) || (m_vLevels[i].ui64DataEnd > m_ui64DataSize) ||
+			((i > 0) && ((m_vLevels[i].iStep >= m_vLevels[i - 1].iStep) ||
+						 (m_vLevels[i].ui64DataEnd < m_vLevels[i - 1].ui64DataEnd)))) {
+			m_vLevels.clear();
+			return DAFF_FILE_CORRUPTED;
+		}
+	}
+
+	if ((m_vLevels.back().iStep != 1) || (m_vLevels.back().ui64DataEnd != m_ui64DataSize)) {
+		m_vLevels.clear();
+		return DAFF_FILE_CORRUPTED;
+	}
+
+	m_iNumLoadedLevels = (int)m_vLevels.size();
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::loadRecordOrder(DAFFRecordOrderHeader& oHeader)
+{
+	/*
+	 *  16th step: Load the order of the record data (optional)
+	 */
+
+	oHeader.fixEndianness();
+
+	// Only curves are written as a block, the descriptors hold the actual offsets anyway
+	if ((oHeader.iRecordOrder != DAFF_RECORD_ORDER_MORTON) && (oHeader.iRecordOrder != DAFF_RECORD_ORDER_HILBERT))
+		return DAFF_FILE_CORRUPTED;
+
+	m_iRecordOrder = oHeader.iRecordOrder;
+	return DAFF_NO_ERROR;
+}
+
+void DAFFReaderImpl::initStorageOrder() const
+{
+	// Sorted by the offset of the first channel, records sharing their data by index
+	int iNumRecords = m_pMainHeader->iNumRecords;
+	int iNumChannels = m_pMainHeader->iNumChannels;
+	std::vector<std::pair<uint64_t, int> > vRecords(iNumRecords);
+	for (int i = 0; i < iNumRecords; i++)
+		vRecords[i] = std::make_pair(m_vui64DataOffsets[(size_t)i * iNumChannels], i);
+	std::sort(vRecords.begin(), vRecords.end());
+
+	m_viStorageOrder.resize(iNumRecords);
+	m_viStoragePositions.resize(iNumRecords);
+	for (int n = 0; n < iNumRecords; n++) {
+		m_viStorageOrder[n] = vRecords[n].second;
+		m_viStoragePositions[vRecords[n].second] = n;
+	}
+}
+
+void DAFFReaderImpl::setEmptyMetadata()
+{
+	m_iNumMetadataSets = 1;
+	m_pMetadataSets.reset(new DAFFMetadataImpl[1]);
+}
+
+void DAFFReaderImpl::beginLoadStats()
+{
+	m_oLoadStats = DAFFLoadStats();
+	m_tLoadStart = std::chrono::steady_clock::now();
+	m_tLoadPhase = m_tLoadStart;
+}
+
+void DAFFReaderImpl::endLoadPhase(double& dPhaseTime, const char* pszPhase)
+{
+	std::chrono::steady_clock::time_point tNow = std::chrono::steady_clock::now();
+	double dDuration = std::chrono::duration<double>(tNow - m_tLoadPhase).count();
+	dPhaseTime += dDuration;
+	m_tLoadPhase = tNow;
+
+	DAFF_INSTRUMENT_TRACE(pszPhase, dDuration);
+}
+
+void DAFFReaderImpl::endLoadStats()
+{
+	m_oLoadStats.dTotalTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_tLoadStart).count();
+	m_oLoadStats.bBorrowed = m_bBlocksBorrowed;
+
+	DAFF_INSTRUMENT_TRACE("load", m_oLoadStats.dTotalTime);
+}
+
+void DAFFReaderImpl::fixAngleRanges()
+{
+	// Important: If there is only one point in a dimension => Then there is no resolution
+	// TODO: Recheck if this is correct for non-full and full angular ranges
+
+	float fAlphaSpan;
+	if (m_pMainHeader->fAlphaEnd > m_pMainHeader->fAlphaStart)
+		fAlphaSpan = m_pMainHeader->fAlphaEnd - m_pMainHeader->fAlphaStart;
+	else
+		fAlphaSpan = 360 - m_pMainHeader->fAlphaStart + m_pMainHeader->fAlphaEnd;
+	float fBetaSpan = m_pMainHeader->fBetaEnd - m_pMainHeader->fBetaStart;
+
+	/*
+	 *  [fwe] Bugfix 2011-05-30
+	 *  Only if the full azimuth range is span, the formula
+	 *
+	 *  m_fAlphaResolution = fAlphaSpan / m_pMainHeader->iAlphaPoints
+	 *
+	 *  is valid. In case there is no full alpha coverage, the last point
+	 *  marks the end of the interval and does not count. Therefore:
+	 *
+	 *  m_fAlphaResolution = fAlphaSpan / (m_pMainHeader->iAlphaPoints-1)
+	 *
+	 */
+
+	if (m_pMainHeader->iAlphaPoints > 1) {
+		if (fAlphaSpan == 360)
+			m_fAlphaResolution = fAlphaSpan / m_pMainHeader->iAlphaPoints;
+		else
+			m_fAlphaResolution = fAlphaSpan / (m_pMainHeader->iAlphaPoints - 1);
+	} else
+		m_fAlphaResolution = 0;
+
+	if (m_pMainHeader->iBetaPoints > 1)
+		m_fBetaResolution = fBetaSpan / (m_pMainHeader->iBetaPoints - 1);
+	else
+		m_fBetaResolution = 0;
+}
+
+void DAFFReaderImpl::closeFile()
+{
+	// An asynchronous opening is cancelled
+	if (m_bOpening) {
+		cancelOpen();
+		waitForOpen();
+	}
+
+	if (!m_bDAFFObjectValid)
+		return;
+
+	tidyup();
+}
+
+void DAFFReaderImpl::tidyup()
+{
+	// The streaming and the prefetching read from the source
+	stopStreaming();
+	stopPrefetching();
+	m_vLevels.clear();
+	m_iNumLoadedLevels = 0;
+	m_iRecordOrder = DAFF_RECORD_ORDER_INDEX;
+
+	m_pSource = NULL;
+	m_fileSource.close();
+
+	// The file block table, the headers and the metadata block are part of the arena (freed below)
+	m_pFileBlockTable = NULL;
+	m_pMainHeader = NULL;
+	m_pContentHeader = NULL;
+
+	if (!isArenaBlock(m_pRecordDescriptorBlock) && ownsRecordDescriptors())
+		DAFF::free_aligned16(m_pRecordDescriptorBlock);
+	if (!m_bBlocksBorrowed)
+		releaseDataBlock();
+	m_pRecordDescriptorBlock = NULL;
+	m_pDataBlock = NULL;
+	m_bBlocksBorrowed = false;
+
+	m_mappedFile.close();
+
+	m_bLazyLoading = false;
+	m_recordCache.clear();
+
+	m_ui64DataSize = 0;
+	m_bCompressed = false;
+	m_vCompressedChunks.clear();
+	m_vcCompressedBuf.clear();
+
+	m_bOverallPeakInitialized = false;
+	m_fOverallPeak = 0;
+	m_vfChannelPeaks.clear();
+	m_vfRecordChannelPeaks.clear();
+
+	m_vStatistics.clear();
+	m_bStatisticsStored = false;
+
+	m_bSlices = false;
+	m_vfSlices.clear();
+
+	m_mMetadataColumns.clear();
+
+	m_vRecordDirections.clear();
+	m_oDirectionIndex.clear();
+	m_vDirectionIndexNodes.clear();
+
+	m_bVerify = false;
+	m_iChecksumSegmentSize = 0;
+	m_vui32Checksums.clear();
+	m_vnFirstChecksums.clear();
+	m_vcVerifiedSegments.clear();
+	m_vcVerifyBuf.clear();
+
+	if (!m_bDecodedDataBorrowed)
+		DAFF::free_aligned32(m_pfDecodedData);
+	m_pfDecodedData = NULL;
+	m_nDecodedDataSize = 0;
+	m_bDecodedDataBorrowed = false;
+	m_bTruncated = false;
+	m_vui64DecodedOffsets.clear();
+	m_viPayloadIndices.clear();
+	m_vui64DataOffsets.clear();
+	m_viLeadingZeros.clear();
+	m_viElementLengths.clear();
+	m_vfBlockScales.clear();
+	m_viMetadataIndices.clear();
+	m_iNumSharedRecordChannels = 0;
+	m_iSymmetry = DAFF_SYMMETRY_NONE;
+	m_iNumStoredRecords = 0;
+	m_viSelectedChannels.clear();
+	m_iNumStoredChannels = 0;
+	m_oRegion = DAFFRegion();
+	m_viRegionRecords.clear();
+	m_iNumGridRecords = 0;
+	m_oGridIndex.clear();
+
+	m_pMetadataSets.reset();
+	m_iNumMetadataSets = 0;
+	m_pMetadataBlock = NULL;
+
+	m_nArenaSize = 0;
+	if (!m_bKeepCapacity)
+		releaseCapacity();
+
+	// Borrowed blocks of an attached segment are no longer referenced
+	m_sharedMemory.close();
+
+	m_sFilePath = "";
+	m_bDAFFObjectValid = false;
+}
+
+int DAFFReaderImpl::initArena(int iOpenFlags, bool bBorrowed)
+{
+	// Missing blocks are reported by the callers
+	DAFFFileBlockEntry* pfbContentHeader;
+	DAFFFileBlockEntry* pfbRecordDesc;
+	DAFFFileBlockEntry* pfbData;
+	DAFFFileBlockEntry* pfbMetadata;
+	getFirstFileBlockByID(FILEBLOCK_DAFF1_CONTENT_HEADER_ID, pfbContentHeader);
+	getFirstFileBlockByID(FILEBLOCK_DAFF1_RECORD_DESC_ID, pfbRecordDesc);
+	getFirstFileBlockByID(FILEBLOCK_DAFF1_DATA_ID, pfbData);
+	getFirstFileBlockByID(FILEBLOCK_DAFF1_METADATA_ID, pfbMetadata);
+
+	// The stored data is placed in the arena if it is kept as it is
+	bool bDecoded = ((iOpenFlags & DAFF_OPEN_DECODE) != 0) && (m_pMainHeader->iQuantization != DAFF_FLOAT32);
+	bool bTruncated =
+		((iOpenFlags & DAFF_OPEN_TRUNCATE) != 0) && (m_pMainHeader->iContentType == DAFF_IMPULSE_RESPONSE);
+	bool bData = (pfbData != NULL) && !bBorrowed && !(iOpenFlags & DAFF_OPEN_LAZY) && !bDecoded && !bTruncated &&
+				 !isSelecting();
+
+	// Every block starts at a cache line
+	enum { TABLE, MAIN_HEADER, CONTENT_HEADER, RECORD_DESC, METADATA, DATA, NUM_BLOCKS };
+	bool pbPlaced[NUM_BLOCKS] = { true, true, pfbContentHeader != NULL, (pfbRecordDesc != NULL) && !bBorrowed,
+								  pfbMetadata != NULL, bData };
+	uint64_t pui64Sizes[NUM_BLOCKS] = { (uint64_t)m_fileHeader.iNumFileBlocks * sizeof(DAFFFileBlockEntry),
+										sizeof(DAFFMainHeader),
+										pbPlaced[CONTENT_HEADER] ? pfbContentHeader->ui64Size : 0,
+										pbPlaced[RECORD_DESC] ? pfbRecordDesc->ui64Size : 0,
+										pbPlaced[METADATA] ? pfbMetadata->ui64Size : 0,
+										pbPlaced[DATA] ? pfbData->ui64Size : 0 };
+	uint64_t pui64Offsets[NUM_BLOCKS];
+	uint64_t ui64ArenaSize = 0;
+	for (int i = 0; i < NUM_BLOCKS; i++) {
+		pui64Offsets[i] = ui64ArenaSize;
+		ui64ArenaSize += (pui64Sizes[i] + 63) & ~(uint64_t)63;
+	}
+
+	if (ui64ArenaSize > (uint64_t)((size_t)-1))
+		return DAFF_FILE_CORRUPTED;
+
+	// A kept arena is reused if the blocks fit
+	if (m_nArenaCapacity < (size_t)ui64ArenaSize) {
+		DAFF::free_arena(m_pArena);
+		m_pArena = (char*)DAFF::malloc_arena((size_t)ui64ArenaSize);
+		m_nArenaCapacity = (m_pArena ? (size_t)ui64ArenaSize : 0);
+		if (m_pArena == NULL)
+			return DAFF_FILE_CORRUPTED;
+	}
+	m_nArenaSize = (size_t)ui64ArenaSize;
+
+	// The file block table and the main header have been loaded before
+	DAFFFileBlockEntry* pFileBlockTable = (DAFFFileBlockEntry*)(m_pArena + pui64Offsets[TABLE]);
+	memcpy(pFileBlockTable, m_pFileBlockTable, (size_t)pui64Sizes[TABLE]);
+	m_pFileBlockTable = pFileBlockTable;
+
+	DAFFMainHeader* pMainHeader = (DAFFMainHeader*)(m_pArena + pui64Offsets[MAIN_HEADER]);
+	memcpy(pMainHeader, m_pMainHeader, sizeof(DAFFMainHeader));
+	m_pMainHeader = pMainHeader;
+
+	void* ppBlocks[NUM_BLOCKS];
+	for (int i = 0; i < NUM_BLOCKS; i++)
+		ppBlocks[i] = (pbPlaced[i] ? m_pArena + pui64Offsets[i] : NULL);
+
+	m_pContentHeader = ppBlocks[CONTENT_HEADER];
+	if (!bBorrowed)
+		m_pRecordDescriptorBlock = ppBlocks[RECORD_DESC];
+	m_pMetadataBlock = (char*)ppBlocks[METADATA];
+	m_pDataBlock = ppBlocks[DATA];
+
+	return DAFF_NO_ERROR;
+}
+
+bool DAFFReaderImpl::isArenaBlock(const void* p) const
+{
+	return (m_pArena != NULL) && ((const char*)p >= m_pArena) && ((const char*)p < m_pArena + m_nArenaSize);
+}
+
+void DAFFReaderImpl::releaseDataBlock()
+{
+	// Data in the arena is released with it
+	if (!isArenaBlock(m_pDataBlock))
+		DAFF::free_aligned64(m_pDataBlock);
+	m_pDataBlock = NULL;
+}
+
+void DAFFReaderImpl::releaseCapacity()
+{
+	DAFF::free_arena(m_pArena);
+	m_pArena = NULL;
+	m_nArenaCapacity = 0;
+
+	std::vector<uint64_t>().swap(m_vui64DataOffsets);
+	std::vector<int>().swap(m_viStorageOrder);
+	std::vector<int>().swap(m_viStoragePositions);
+	std::vector<int>().swap(m_viLeadingZeros);
+	std::vector<int>().swap(m_viElementLengths);
+	std::vector<float>().swap(m_vfBlockScales);
+	std::vector<int>().swap(m_viMetadataIndices);
+}
+
+int DAFFReaderImpl::getFirstFileBlockByID(int iID, DAFFFileBlockEntry*& pfDest) const
+{
+	std::vector<DAFFFileBlockEntry*> v;
+	getFileBlocksByID(iID, v);
+
+	if (v.empty()) {
+		pfDest = NULL;
+		return 0;
+	}
+
+	pfDest = v.front();
+	return (int)v.size();
+}
+
+int DAFFReaderImpl::getFileBlocksByID(int iID, std::vector<DAFFFileBlockEntry*>& vpfDest) const
+{
+	vpfDest.clear();
+	for (int i = 0; i < m_fileHeader.iNumFileBlocks; i++) {
+		if (m_pFileBlockTable[i].iID == iID)
+			vpfDest.push_back(&(m_pFileBlockTable[i]));
+	}
+
+	return (int)vpfDest.size();
+}
+
+std::string DAFFReaderImpl::getFilename() const
+{
+	assert(m_bDAFFObjectValid);
+	return m_sFilePath;
+}
+
+bool DAFFReaderImpl::isLazy() const
+{
+	return m_bLazyLoading;
+}
+
+bool DAFFReaderImpl::isCompressed() const
+{
+	return m_bCompressed;
+}
+
+bool DAFFReaderImpl::hasChecksums() const
+{
+	DAFFFileBlockEntry* pChecksumsFileBlock = NULL;
+	return m_bDAFFObjectValid && (getFirstFileBlockByID(FILEBLOCK_DAFF1_CHECKSUMS_ID, pChecksumsFileBlock) == 1);
+}
+
+bool DAFFReaderImpl::hasStatistics() const
+{
+	return m_bStatisticsStored;
+}
+
+int DAFFReaderImpl::getNumSharedRecordChannels() const
+{
+	return m_iNumSharedRecordChannels;
+}
+
+int DAFFReaderImpl::getSymmetry() const
+{
+	return m_iSymmetry;
+}
+
+int DAFFReaderImpl::getNumLevels() const
+{
+	return (int)m_vLevels.size();
+}
+
+int DAFFReaderImpl::getNumLoadedLevels() const
+{
+	return m_iNumLoadedLevels;
+}
+
+int DAFFReaderImpl::getRecordOrder() const
+{
+	return m_iRecordOrder;
+}
+
+int DAFFReaderImpl::getStorageNeighbours(int iRecordIndex, int iRadius, std::vector<int>& viRecordIndices) const
+{
+	viRecordIndices.clear();
+	if (!m_bDAFFObjectValid)
+		return DAFF_MODAL_ERROR;
+
+	int iNumRecords = m_pMainHeader->iNumRecords;
+	if ((iRecordIndex < 0) || (iRecordIndex >= iNumRecords) || (iRadius < 0))
+		return DAFF_INVALID_INDEX;
+
+	std::lock_guard<std::mutex> lock(m_mxStorageOrder);
+	if (m_viStorageOrder.empty())
+		initStorageOrder();
+
+	int iPosition = m_viStoragePositions[iRecordIndex];
+	int iFirst = std::max(iPosition - iRadius, 0);
+	int iLast = (int)std::min((int64_t)iPosition + iRadius, (int64_t)iNumRecords - 1);
+	viRecordIndices.assign(m_viStorageOrder.begin() + iFirst, m_viStorageOrder.begin() + iLast + 1);
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::getNumStoredRecords() const
+{
+	if (m_iSymmetry != DAFF_SYMMETRY_NONE)
+		return m_iNumStoredRecords;
+	return m_viRegionRecords.empty() ? getNumberOfRecords() : m_iNumGridRecords;
+}
+
+int DAFFReaderImpl::getNumStoredChannels() const
+{
+	return m_viSelectedChannels.empty() ? getNumberOfChannels() : m_iNumStoredChannels;
+}
+
+int DAFFReaderImpl::getDataAlignment() const
+{
+	if (!m_bDAFFObjectValid)
+		return 0;
+
+	// The arenas of DAFF_OPEN_DECODE and DAFF_OPEN_TRUNCATE start every record channel at a 32-byte boundary
+	if (m_pfDecodedData)
+		return 32;
+
+	// Lazy loading: Every record channel is held in a 64-byte aligned cache entry of its own
+	if (m_bLazyLoading)
+		return 64;
+
+	// Otherwise the lowest set bit of the base address and all data offsets
+	uint64_t ui64Bits = (uint64_t)(uintptr_t)m_pDataBlock | 64;
+	for (size_t i = 0; i < m_vui64DataOffsets.size(); i++)
+		ui64Bits |= m_vui64DataOffsets[i];
+
+	return (int)(ui64Bits & (~ui64Bits + 1));
+}
+
+const unsigned short* DAFFReaderImpl::getRecordChannelData16Ptr(int iRecordIndex, int iChannel, int& iNumValues) const
+{
+	if (!m_bDAFFObjectValid)
+		return NULL;
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return NULL;
+
+	// Direct access is only possible to 16-bit floating point data that was not decoded
+	if ((m_iDataQuantization != DAFF_FLOAT16) && (m_iDataQuantization != DAFF_BFLOAT16))
+		return NULL;
+
+	iNumValues = (int)(getRecordChannelDataSize(iRecordIndex, iChannel) / 2);
+
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	return (const unsigned short*)getRecordChannelDataPtr(iRecordIndex, iChannel);
+}
+
+const void* DAFFReaderImpl::getRecordChannelRawDataPtr(int iRecordIndex, int iChannel, int& iQuantization,
+													   int& iNumValues) const
+{
+	if (!m_bDAFFObjectValid)
+		return NULL;
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return NULL;
+
+	// Decoded and truncated data holds as many floats as values stored
+	iQuantization = m_iDataQuantization;
+	iNumValues = (int)(getRecordChannelDataSize(iRecordIndex, iChannel) /
+					   getQuantizationSampleSize(m_pMainHeader->iQuantization));
+
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	return getRecordChannelDataPtr(iRecordIndex, iChannel);
+}
+
+float DAFFReaderImpl::getRecordChannelScale(int iRecordIndex, int iChannel) const
+{
+	if (!m_bDAFFObjectValid)
+		return 1.0f;
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return 1.0f;
+
+	return getBlockScale((size_t)iRecordIndex * m_pMainHeader->iNumChannels + iChannel);
+}
+
+size_t DAFFReaderImpl::getLazyCacheSize() const
+{
+	std::lock_guard<std::mutex> lock(m_mxRecordCache);
+	return m_recordCache.getMaxSize();
+}
+
+void DAFFReaderImpl::setLazyCacheSize(size_t nMaxBytes)
+{
+	std::lock_guard<std::mutex> lock(m_mxRecordCache);
+	m_recordCache.setMaxSize(nMaxBytes);
+	m_nStreamCacheRestore = 0;
+}
+
+float DAFFReaderImpl::getTruncationThreshold() const
+{
+	return m_fTruncationThresholdDB;
+}
+
+void DAFFReaderImpl::setTruncationThreshold(float fThresholdDB)
+{
+	m_fTruncationThresholdDB = fThresholdDB;
+}
+
+std::vector<int> DAFFReaderImpl::getChannelSelection() const
+{
+	return m_viChannelSelection;
+}
+
+void DAFFReaderImpl::setChannelSelection(const std::vector<int>& viChannels)
+{
+	m_viChannelSelection = viChannels;
+}
+
+DAFFRegion DAFFReaderImpl::getRegion() const
+{
+	return m_oRegionSelection;
+}
+
+void DAFFReaderImpl::setRegion(const DAFFRegion& oRegion)
+{
+	m_oRegionSelection = oRegion;
+}
+
+std::vector<int> DAFFReaderImpl::getRegionRecords() const
+{
+	return m_viRegionRecords;
+}
+
+bool DAFFReaderImpl::getKeepCapacity() const
+{
+	return m_bKeepCapacity;
+}
+
+void DAFFReaderImpl::setKeepCapacity(bool bKeep)
+{
+	m_bKeepCapacity = bKeep;
+	if (!m_bKeepCapacity && !m_bDAFFObjectValid && !m_bOpening)
+		releaseCapacity();
+}
+
+size_t DAFFReaderImpl::getCapacity() const
+{
+	return m_nArenaCapacity;
+}
+
+void DAFFReaderImpl::reserveCapacity(size_t nBytes)
+{
+	m_bKeepCapacity = true;
+	if (m_bDAFFObjectValid || m_bOpening || (m_nArenaCapacity >= nBytes))
+		return;
+
+	DAFF::free_arena(m_pArena);
+	m_pArena = (char*)DAFF::malloc_arena(nBytes);
+	m_nArenaCapacity = (m_pArena ? nBytes : 0);
+}
+
+void DAFFReaderImpl::getLoadStats(DAFFLoadStats& oStats) const
+{
+	oStats = m_oLoadStats;
+}
+
+void DAFFReaderImpl::getMemoryFootprint(DAFFMemoryFootprint& oFootprint) const
+{
+	oFootprint = DAFFMemoryFootprint();
+	if (!m_bDAFFObjectValid)
+		return;
+
+	DAFFFileBlockEntry* pfbContentHeader = NULL;
+	oFootprint.ui64Headers = (uint64_t)m_fileHeader.iNumFileBlocks * sizeof(DAFFFileBlockEntry) +
+							 sizeof(DAFFMainHeader) + m_vfFreqs.capacity() * sizeof(float) +
+							 m_vui32Checksums.capacity() * sizeof(uint32_t) +
+							 m_vnFirstChecksums.capacity() * sizeof(size_t);
+	if (getFirstFileBlockByID(FILEBLOCK_DAFF1_CONTENT_HEADER_ID, pfbContentHeader) == 1)
+		oFootprint.ui64Headers += pfbContentHeader->ui64Size;
+
+	// Record descriptors (expanded symmetric and selected descriptors are always owned)
+	uint64_t ui64DescSize =
+		(uint64_t)m_pMainHeader->iNumRecords * m_pMainHeader->iNumChannels * m_iRecordChannelDescSize;
+	if (ownsRecordDescriptors())
+		oFootprint.ui64RecordDescriptors = ui64DescSize;
+	else
+		oFootprint.ui64Mapped += ui64DescSize;
+	oFootprint.ui64RecordDescriptors += m_vui64DataOffsets.capacity() * sizeof(uint64_t) +
+										(m_viLeadingZeros.capacity() + m_viElementLengths.capacity() +
+										 m_viMetadataIndices.capacity()) * sizeof(int) +
+										m_vfBlockScales.capacity() * sizeof(float);
+	oFootprint.ui64RecordDescriptors += m_viPayloadIndices.capacity() * sizeof(int) +
+										m_vui64DecodedOffsets.capacity() * sizeof(uint64_t) +
+										m_vRecordDirections.capacity() * sizeof(DAFFRecordDirectionEntry) +
+										m_vCompressedChunks.capacity() * sizeof(DAFFCompressedChunkEntry);
+	oFootprint.ui64RecordDescriptors += m_viRegionRecords.capacity() * sizeof(int) + m_oGridIndex.getMemoryFootprint();
+	{
+		std::lock_guard<std::mutex> lock(m_mxStorageOrder);
+		oFootprint.ui64RecordDescriptors +=
+			(m_viStorageOrder.capacity() + m_viStoragePositions.capacity()) * sizeof(int);
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_mxDirectionIndex);
+		oFootprint.ui64RecordDescriptors += m_oDirectionIndex.getMemoryFootprint() +
+											m_vDirectionIndexNodes.capacity() * sizeof(DAFFDirectionIndexEntry);
+	}
+
+	// Record data (the data block is released after decoding and not present with lazy loading)
+	if (m_pDataBlock) {
+		if (m_bBlocksBorrowed)
+			oFootprint.ui64Mapped += m_ui64DataSize;
+		else
+			oFootprint.ui64RecordData = m_ui64DataSize;
+	}
+	if (m_bDecodedDataBorrowed)
+		oFootprint.ui64Mapped += m_nDecodedDataSize;
+	else
+		oFootprint.ui64RecordData += m_nDecodedDataSize;
+
+	{
+		std::unique_lock<std::mutex> lock = lockRecordCache();
+		oFootprint.ui64RecordCache = m_recordCache.getSize() + m_vcCompressedBuf.capacity() +
+									 m_vcVerifiedSegments.capacity() + m_vcVerifyBuf.capacity();
+	}
+
+	DAFFFileBlockEntry* pfbMetadata = NULL;
+	if (m_pMetadataBlock && (getFirstFileBlockByID(FILEBLOCK_DAFF1_METADATA_ID, pfbMetadata) == 1))
+		oFootprint.ui64Metadata = pfbMetadata->ui64Size;
+	oFootprint.ui64Metadata += (uint64_t)m_iNumMetadataSets * sizeof(DAFFMetadataImpl);
+	for (int i = 0; i < m_iNumMetadataSets; i++)
+		oFootprint.ui64Metadata += m_pMetadataSets[i].getMemoryFootprint();
+	{
+		std::lock_guard<std::mutex> lock(m_mxMetadataColumns);
+		std::map<std::string, std::vector<float> >::const_iterator it = m_mMetadataColumns.begin();
+		for (; it != m_mMetadataColumns.end(); ++it)
+			oFootprint.ui64Metadata += it->first.capacity() + it->second.capacity() * sizeof(float);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mxSlices);
+		oFootprint.ui64RecordData += m_vfSlices.capacity() * sizeof(float);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mxStatistics);
+		oFootprint.ui64Statistics = m_vStatistics.capacity() * sizeof(DAFFStatisticsEntry);
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_mxPeaks);
+		oFootprint.ui64Statistics += (m_vfChannelPeaks.capacity() + m_vfRecordChannelPeaks.capacity()) * sizeof(float);
+	}
+
+	oFootprint.ui64Total = oFootprint.ui64Headers + oFootprint.ui64RecordDescriptors + oFootprint.ui64RecordData +
+						   oFootprint.ui64RecordCache + oFootprint.ui64Metadata + oFootprint.ui64Statistics;
+}
+
+int DAFFReaderImpl::getFileFormatVersion() const
+{
+	assert(m_bDAFFObjectValid);
+	return m_fileHeader.iFileFormatVersion;
+}
+
+int DAFFReaderImpl::getContentType() const
+{
+	assert(m_bDAFFObjectValid);
+	return m_pMainHeader->iContentType;
+}
+
+DAFFContent* DAFFReaderImpl::getContent() const
+{
+	assert(m_bDAFFObjectValid);
+	// Logical constness here!
+	// TODO: Bad cast
+	return (DAFFContentIR*)this;
+}
+
+const DAFFMetadata* DAFFReaderImpl::getMetadata() const
+{
+	assert(m_bDAFFObjectValid);
+	return &m_pMetadataSets[0];
+}
+
+const float* DAFFReaderImpl::getRecordMetadataColumn(const std::string& sKey) const
+{
+	assert(m_bDAFFObjectValid);
+
+	if (!m_bDAFFObjectValid)
+		return NULL;
+
+	// Metadata key names are stored in upper case
+	std::string sName(sKey);
+	for (size_t i = 0; i < sName.size(); i++)
+		sName[i] = (char)toupper((unsigned char)sName[i]);
+
+	std::lock_guard<std::mutex> lock(m_mxMetadataColumns);
+	std::map<std::string, std::vector<float> >::iterator it = m_mMetadataColumns.find(sName);
+	if (it == m_mMetadataColumns.end()) {
+		it = m_mMetadataColumns.insert(std::make_pair(sName, std::vector<float>())).first;
+		initMetadataColumn(sName, it->second);
+	}
+
+	// The map nodes and the columns stay in place until the file is closed
+	return (it->second.empty() ? NULL : &it->second[0]);
+}
+
+int DAFFReaderImpl::selectRecords(const std::string& sKey, int iOperator, float fValue,
+								  std::vector<int>& viRecordIndices) const
+{
+	assert((iOperator >= DAFF_EQ) && (iOperator <= DAFF_GE));
+
+	viRecordIndices.clear();
+
+	const float* pfColumn = getRecordMetadataColumn(sKey);
+	if (!pfColumn)
+		return 0;
+
+	int iNumRecords = m_pMainHeader->iNumRecords;
+	viRecordIndices.resize(iNumRecords);
+	size_t n = DAFF::select_float(&viRecordIndices[0], pfColumn, fValue, iOperator, (size_t)iNumRecords);
+	viRecordIndices.resize(n);
+
+	return (int)n;
+}
+
+void DAFFReaderImpl::initMetadataColumn(const std::string& sName, std::vector<float>& vfColumn) const
+{
+	// Look up the key once per metadata set, records share them
+	const float fMissing = std::numeric_limits<float>::quiet_NaN();
+	std::vector<float> vfSetValues(m_iNumMetadataSets, fMissing);
+	bool bFound = false;
+	for (int i = 0; i < m_iNumMetadataSets; i++) {
+		const DAFFMetadataImpl& oSet = m_pMetadataSets[i];
+		switch (oSet.getKeyType(sName)) {
+		case DAFFMetadata::DAFF_BOOL:
+			vfSetValues[i] = (oSet.getKeyBool(sName) ? 1.0f : 0.0f);
+			break;
+
+		case DAFFMetadata::DAFF_INT:
+		case DAFFMetadata::DAFF_FLOAT:
+			vfSetValues[i] = (float)oSet.getKeyFloat(sName);
+			break;
+
+		default:
+			// Missing and string keys
+			continue;
+		}
+		bFound = true;
+	}
+
+	if (!bFound)
+		return;
+
+	int iNumRecords = m_pMainHeader->iNumRecords;
+	vfColumn.assign(iNumRecords, fMissing);
+	for (int r = 0; r < iNumRecords; r++) {
+		int iMetadataIndex = m_viMetadataIndices[r];
+		if ((iMetadataIndex >= 0) && (iMetadataIndex < m_iNumMetadataSets))
+			vfColumn[r] = vfSetValues[iMetadataIndex];
+	}
+}
+
+DAFFProperties* DAFFReaderImpl::getProperties() const
+{
+	assert(m_bDAFFObjectValid);
+	// TODO: Fixme
+	return (DAFFProperties*)this;
+}
+
+std::string DAFFReaderImpl::toString() const
+{
+	assert(m_bDAFFObjectValid);
+
+	std::stringstream ss;
+
+	float fVersion = getFileFormatVersion() / 1000.0F;
+	;
+	ss << "File format version: " << DAFFUtils::Float2StrNice(fVersion, 3, false) << std::endl;
+	ss << "Content type:        " << DAFFUtils::StrContentType(getProperties()->getContentType()) << std::endl;
+	ss << "Quantization:        " << DAFFUtils::StrQuantizationType(getProperties()->getQuantization()) << std::endl;
+	ss << "Compressed data:     " << (m_bCompressed ? "yes" : "no") << std::endl;
+	ss << "Data alignment:      " << getDataAlignment() << " Bytes" << std::endl;
+	ss << "Shared channels:     " << m_iNumSharedRecordChannels << std::endl;
+	ss << "Record order:        " << DAFFUtils::StrRecordOrder(m_iRecordOrder) << std::endl;
+	ss << "Symmetry:            " << DAFFUtils::StrSymmetry(m_iSymmetry);
+	if (m_iSymmetry != DAFF_SYMMETRY_NONE)
+		ss << " (" << m_iNumStoredRecords << " stored records)";
+	ss << std::endl << std::endl;
+	ss << "Number of channels:  " << getProperties()->getNumberOfChannels();
+	if (!m_viSelectedChannels.empty())
+		ss << " (selected of " << m_iNumStoredChannels << " stored channels)";
+	ss << std::endl;
+	ss << "Number of records:   " << getProperties()->getNumberOfRecords();
+	if (!m_viRegionRecords.empty())
+		ss << " (region of " << m_iNumGridRecords << " records)";
+	ss << std::endl << std::endl;
+	ss << "Alpha points:        " << getProperties()->getAlphaPoints() << std::endl;
+	ss << "Alpha range:         [" << DAFFUtils::Float2StrNice(getProperties()->getAlphaStart(), 3, false) << "\xF8, "
+	   << DAFFUtils::Float2StrNice(getProperties()->getAlphaEnd(), 3, false) << "\xF8]" << std::endl;
+	ss << "Beta points:         " << getProperties()->getBetaPoints() << std::endl;
+	ss << "Beta range:          [" << DAFFUtils::Float2StrNice(getProperties()->getBetaStart(), 3, false) << "\xF8, "
+	   << DAFFUtils::Float2StrNice(getProperties()->getBetaEnd(), 3, false) << "\xF8]" << std::endl;
+	ss << "Full sphere:         " << (getProperties()->coversFullSphere() ? "yes" : "no") << std::endl;
+	DAFFOrientationYPR o;
+	getOrientation(o);
+	ss << "Orientation:         " << o.toString() << std::endl;
+
+	DAFFContentIR* pContentIR;
+	DAFFReaderImpl* pContent;
+	DAFFContentDFT* pContentDFT;
+	std::vector<float> vsFrequencies;
+
+	switch (getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		pContentIR = dynamic_cast<DAFFContentIR*>(getContent());
+		ss << "Samplerate:          " << DAFFUtils::Double2StrNice(pContentIR->getSamplerate(), 1, false) << " Hz"
+		   << std::endl;
+		ss << "Filter length:       " << pContentIR->getFilterLength() << std::endl;
+		break;
+
+	case DAFF_MAGNITUDE_SPECTRUM:
+	case DAFF_PHASE_SPECTRUM:
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		pContent = dynamic_cast<DAFFReaderImpl*>(getContent());
+		ss << "Number of frequencies: " << pContent->getNumFrequencies() << std::endl;
+		vsFrequencies = pContent->getFrequencies();
+		ss << "Frequency support:     ";
+		for (size_t i = 0; i < vsFrequencies.size(); i++) {
+			ss << DAFFUtils::Float2StrNice(vsFrequencies[i], 3, false);
+			if (i < (vsFrequencies.size() - 1))
+				ss << ", ";
+		}
+		ss << " Hz" << std::endl;
+		break;
+
+
+	case DAFF_DFT_SPECTRUM:
+		pContentDFT = dynamic_cast<DAFFContentDFT*>(getContent());
+		ss << "Transform size: " << pContentDFT->getTransformSize() << std::endl;
+		ss << "Symmetric: " << ((pContentDFT->isSymmetric()) ? "yes" : "no") << std::endl;
+		ss << "Samplerate: " << pContentDFT->getSamplerate() << std::endl;
+		break;
+	}
+	return ss.str();
+}
+
+// --------------------------------------------------------
+
+int DAFFReaderImpl::getQuantization() const
+{
+	assert(m_bDAFFObjectValid);
+	return m_pMainHeader->iQuantization;
+}
+
+int DAFFReaderImpl::getNumberOfChannels() const
+{
+	assert(m_bDAFFObjectValid);
+	return m_pMainHeader->iNumChannels;
+}
+
+int DAFFReaderImpl::getNumberOfRecords() const
+{
+	assert(m_bDAFFObjectValid);
+	return m_pMainHeader->iNumRecords;
+}
+
+std::string DAFFReaderImpl::getChannelLabel(int iChannel) const
+{
+	/* @todo
+	This specific function requires a certain key/value pair
+	within the global metadata entries in the DAFF file. It appears
+	more elegant to provide "styles" that can be met with a defined
+	set of keys and values. Compatibility can be checked during loading
+	or runtime and the file is marked as "whateever"-kompatible.
+	*/
+
+	assert(m_bDAFFObjectValid);
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+
+	// Fetch the channel name from the metadata (labels refer to the stored channels)
+	std::stringstream ss;
+	ss << "LABEL_CHANNEL_" << ((m_viSelectedChannels.empty() ? iChannel : m_viSelectedChannels[iChannel]) + 1);
+	const char* pszLabel = (m_iNumMetadataSets > 0 ? m_pMetadataSets[0].getKeyStringPtr(ss.str()) : NULL);
+	return (pszLabel != NULL ? pszLabel : "");
+}
+
+int DAFFReaderImpl::getAlphaPoints() const
+{
+	assert(m_bDAFFObjectValid);
+	return m_pMainHeader->iAlphaPoints;
+}
+
+float DAFFReaderImpl::getAlphaResolution() const
+{
+	assert(m_bDAFFObjectValid);
+
+	return m_fAlphaResolution;
+}
+
+float DAFFReaderImpl::getAlphaStart() const
+{
+	assert(m_bDAFFObjectValid);
+	return m_pMainHeader->fAlphaStart;
+}
+
+float DAFFReaderImpl::getAlphaEnd() const
+{
+	assert(m_bDAFFObjectValid);
+	return m_pMainHeader->fAlphaEnd;
+}
+
+float DAFFReaderImpl::getAlphaSpan() const
+{
+	assert(m_bDAFFObjectValid);
+	if (m_pMainHeader->fAlphaStart <= m_pMainHeader->fAlphaEnd)
+		return m_pMainHeader->fAlphaEnd - m_pMainHeader->fAlphaStart;
+	else  // wrap around 0&deg;
+		return 360 - m_pMainHeader->fAlphaStart + m_pMainHeader->fAlphaEnd;
+}
+
+int DAFFReaderImpl::getBetaPoints() const
+{
+	assert(m_bDAFFObjectValid);
+	return m_pMainHeader->iBetaPoints;
+}
+
+float DAFFReaderImpl::getBetaResolution() const
+{
+	assert(m_bDAFFObjectValid);
+	return m_fBetaResolution;
+}
+
+float DAFFReaderImpl::getBetaStart() const
+{
+	assert(m_bDAFFObjectValid);
+	return m_pMainHeader->fBetaStart;
+}
+
+float DAFFReaderImpl::getBetaEnd() const
+{
+	assert(m_bDAFFObjectValid);
+	return m_pMainHeader->fBetaEnd;
+}
+
+float DAFFReaderImpl::getBetaSpan() const
+{
+	assert(m_bDAFFObjectValid);
+	return m_pMainHeader->fAlphaEnd - m_pMainHeader->fAlphaStart;
+}
+
+void DAFFReaderImpl::getDefaultOrientation(DAFFOrientationYPR& o) const
+{
+	assert(m_bDAFFObjectValid);
+	o = m_orientationDefault;
+}
+
+void DAFFReaderImpl::setDefaultOrientation()
+{
+	assert(m_bDAFFObjectValid);
+	std::atomic_store(&m_pTrans, std::make_shared<const DAFFSCTransform>(m_orientationDefault));
+}
+
+void DAFFReaderImpl::getOrientation(DAFFOrientationYPR& o) const
+{
+	assert(m_bDAFFObjectValid);
+	getTransform()->getOrientation(o);
+}
+
+void DAFFReaderImpl::setOrientation(const DAFFOrientationYPR& o)
+{
+	assert(m_bDAFFObjectValid);
+
+	// Publish a new transformer, concurrent queries keep using their snapshot
+	std::atomic_store(&m_pTrans, std::make_shared<const DAFFSCTransform>(o));
+}
+
+bool DAFFReaderImpl::coversFullAlphaRange() const
+{
+	assert(m_bDAFFObjectValid);
+	// Regions loaded as irregular grids do not cover the sphere (beta ranges of regular grids keep their alpha range)
+	if (!m_viRegionRecords.empty() && !isRegularGrid())
+		return false;
+
+	// full range coverage is given only when alphastart == 0 and alphaend == 360
+	if ((m_pMainHeader->fAlphaStart == 0) && (m_pMainHeader->fAlphaEnd == 360))
+		return true;
+	else
+		return false;
+}
+
+bool DAFFReaderImpl::coversFullBetaRange() const
+{
+	assert(m_bDAFFObjectValid);
+	if (!m_viRegionRecords.empty() && !isRegularGrid())
+		return false;
+
+	// full range coverage is given only when betastart == 0 and betaend == 180
+	if ((m_pMainHeader->fBetaStart == 0) && (m_pMainHeader->fBetaEnd == 180))
+		return true;
+	else
+		return false;
+}
+
+bool DAFFReaderImpl::coversFullSphere() const
+{
+	assert(m_bDAFFObjectValid);
+	/*
+	if ( ((m_pMainHeader->fAlphaEnd - m_pMainHeader->fAlphaStart) >= (360.0f - getAlphaResolution()) &&
+	((m_pMainHeader->fBetaEnd - m_pMainHeader->fBetaStart) == 180.0f)) )
+	return true;
+
+	return false;*/
+	return coversFullAlphaRange() && coversFullBetaRange();
+}
+
+bool DAFFReaderImpl::isRegularGrid() const
+{
+	return m_vRecordDirections.empty();
+}
+
+DAFFReader* DAFFReaderImpl::getParent() const
+{
+	// We are the reader ourself!
+	// Logical constness here!
+	return const_cast<DAFFReaderImpl*>(this);
+}
+
+void DAFFReaderImpl::getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	bool bDummy;
+	getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex, bDummy);
+}
+
+const DAFFMetadata* DAFFReaderImpl::getRecordMetadata(int iRecordIndex) const
+{
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords))
+		return m_pEmptyMetadata;
+
+	int iMetadataIndex = m_viMetadataIndices[iRecordIndex];
+
+	assert((iMetadataIndex >= -1) && (iMetadataIndex < m_iNumMetadataSets));
+
+	// The metadata set is parsed on first access
+	if ((iMetadataIndex < 0) || (iMetadataIndex >= m_iNumMetadataSets))
+		return m_pEmptyMetadata;
+	else
+		return &m_pMetadataSets[iMetadataIndex];
+}
+
+int DAFFReaderImpl::getRecordCoords(int iRecordIndex, int iView, float& fAngle1, float& fAngle2) const
+{
+	assert((iRecordIndex >= 0) || (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	// Invalid record index - projection to get a valid index
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords)) {
+		// TODO: Discuss if this makes sense
+		return -1;
+	}
+
+	int iAlpha, iBeta;
+	float fAlpha, fBeta;
+
+	if (!m_vRecordDirections.empty()) {  // Irregular grid: explicit directions
+		fAlpha = m_vRecordDirections[iRecordIndex].fAlpha;
+		fBeta = m_vRecordDirections[iRecordIndex].fBeta;
+
+		if (iView == DAFF_DATA_VIEW) {
+			fAngle1 = fAlpha;
+			fAngle2 = fBeta;
+		} else {
+			transformAnglesD2O(fAlpha, fBeta, fAngle1, fAngle2);
+		}
+
+		return 0;
+	}
+
+	bool bSouthPolePresent = false;
+	if (m_pMainHeader->fBetaStart == 0.0f)  // South pole present (single record here)
+		bSouthPolePresent = true;
+
+	if (bSouthPolePresent) {
+		if (iRecordIndex == 0) {  // Hit south pole
+			fAlpha = 0.0f;
+			fBeta = 0.0f;
+		} else {  // somewhere inside the grid (with single value at south pole)
+			iAlpha = (iRecordIndex - 1) % m_pMainHeader->iAlphaPoints;
+			iBeta = 1 + (int)((iRecordIndex - 1) / m_pMainHeader->iAlphaPoints);
+			fAlpha = m_pMainHeader->fAlphaStart + ((float)iAlpha * m_fAlphaResolution);
+			fBeta = (float)iBeta * m_fBetaResolution;
+		}
+	} else {  // somewhere inside the grid (without south pole present)
+		iAlpha = iRecordIndex % m_pMainHeader->iAlphaPoints;
+		iBeta = (int)(iRecordIndex / m_pMainHeader->iAlphaPoints);
+		fAlpha = m_pMainHeader->fAlphaStart + ((float)iAlpha * m_fAlphaResolution);
+		fBeta = m_pMainHeader->fBetaStart + ((float)iBeta * m_fBetaResolution);
+	}
+
+	if (iView == DAFF_DATA_VIEW) {
+		fAngle1 = fAlpha;
+		fAngle2 = fBeta;
+	} else {
+		transformAnglesD2O(fAlpha, fBeta, fAngle1, fAngle2);
+	}
+
+	return 0;
+}
+
+void DAFFReaderImpl::getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex,
+										 bool& bOutOfBounds) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	float fAlpha;
+	float fBeta;
+
+	if (iView == DAFF_DATA_VIEW) {
+		fAlpha = fAngle1;
+		fBeta = fAngle2;
+	} else {
+		// Transform the coordinates into the DSC
+		transformAnglesO2D(fAngle1, fAngle2, fAlpha, fBeta);
+	}
+
+	getNearestNeighbourDSC(fAlpha, fBeta, iRecordIndex, bOutOfBounds);
+
+	DAFF_INSTRUMENT_COUNT(DAFF_COUNTER_NEAREST_NEIGHBOUR, 1);
+	DAFF_INSTRUMENT_COUNT(DAFF_COUNTER_OUT_OF_BOUNDS, bOutOfBounds ? 1 : 0);
+}
+
+void DAFFReaderImpl::getNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2,
+										  int* piRecordIndices, bool* pbOutOfBounds, size_t n) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	// Object view directions are transformed block-wise into the DSC
+	const size_t BLOCK_SIZE = 256;
+	float pfAlpha[BLOCK_SIZE];
+	float pfBeta[BLOCK_SIZE];
+
+	std::shared_ptr<const DAFFSCTransform> pTrans = getTransform();
+
+	bool bDummy;
+	for (size_t i = 0; i < n; i += BLOCK_SIZE) {
+		size_t m = std::min(BLOCK_SIZE, n - i);
+		const float* pfA = pfAngles1 + i;
+		const float* pfB = pfAngles2 + i;
+
+		if (iView == DAFF_OBJECT_VIEW) {
+			pTrans->transformOSC2DSC(pfA, pfB, pfAlpha, pfBeta, m);
+		} else {
+			memcpy(pfAlpha, pfA, m * sizeof(float));
+			memcpy(pfBeta, pfB, m * sizeof(float));
+		}
+
+		// Normalize the block at once
+		DAFF::normalize_directions_dsc(pfAlpha, pfBeta, m);
+
+		for (size_t k = 0; k < m; k++) {
+			bool& bOutOfBounds = (pbOutOfBounds ? pbOutOfBounds[i + k] : bDummy);
+			getNearestNeighbourNormalizedDSC(pfAlpha[k], pfBeta[k], piRecordIndices[i + k], bOutOfBounds);
+			DAFF_INSTRUMENT_COUNT(DAFF_COUNTER_OUT_OF_BOUNDS, bOutOfBounds ? 1 : 0);
+		}
+	}
+
+	DAFF_INSTRUMENT_COUNT(DAFF_COUNTER_NEAREST_NEIGHBOUR, n);
+}
+
+void DAFFReaderImpl::getNearestNeighbourDSC(float fAlpha, float fBeta, int& iRecordIndex, bool& bOutOfBounds) const
+{
+	DAFFUtils::NormalizeDirection(DAFF_DATA_VIEW, fAlpha, fBeta, fAlpha, fBeta);
+	getNearestNeighbourNormalizedDSC(fAlpha, fBeta, iRecordIndex, bOutOfBounds);
+}
+
+void DAFFReaderImpl::getNearestNeighbourNormalizedDSC(float fAlpha, float fBeta, int& iRecordIndex,
+													  bool& bOutOfBounds) const
+{
+	iRecordIndex = -1;
+	bOutOfBounds = false;
+
+	// Irregular grids: smallest great-circle distance (the records cover the sphere, unless restricted to a region)
+	if (!m_vRecordDirections.empty()) {
+		iRecordIndex = m_oDirectionIndex.getNearest(fAlpha, fBeta);
+		if (!m_viRegionRecords.empty())
+			bOutOfBounds = !isInRegion(fAlpha, fBeta);
+		return;
+	}
+
+	int iAlphaIndex, iBetaIndex;
+
+	if (m_pMainHeader->iAlphaPoints == 1) {
+		// Trivial case: Just one point
+		iAlphaIndex = 0;
+		bOutOfBounds = true;
+		if (fAlpha == m_pMainHeader->fAlphaStart && fAlpha == std::fmod(m_pMainHeader->fAlphaEnd, 360.0f))
+			bOutOfBounds = false;  // Direct hit
+	} else {
+		if ((fAlpha >= m_pMainHeader->fAlphaStart) && (fAlpha <= m_pMainHeader->fAlphaEnd)) {
+			// Within the covered alpha range
+			iAlphaIndex = (int)roundf((fAlpha - m_pMainHeader->fAlphaStart) / m_fAlphaResolution);
+
+			// Rounded up beyond the last point: Wrap around to the start on the full circle
+			if (iAlphaIndex >= m_pMainHeader->iAlphaPoints)
+				iAlphaIndex = (coversFullAlphaRange() ? 0 : m_pMainHeader->iAlphaPoints - 1);
+		} else {
+			// Outside the covered alpha range
+			// Decide: Which is closer? Start boundary or end boundary?
+			if (DAFF::anglef_mindiff_abs_0_360_DEG(m_pMainHeader->fAlphaStart, fAlpha) <=
+				DAFF::anglef_mindiff_abs_0_360_DEG(m_pMainHeader->fAlphaEnd, fAlpha))
+				iAlphaIndex = 0;  // Start index
+			else
+				iAlphaIndex = (int)m_pMainHeader->iAlphaPoints - 1;  // End index
+
+			bOutOfBounds = true;
+		}
+	}
+
+	if (m_pMainHeader->iBetaPoints == 1) {
+		// Trivial case: Just one point
+		iBetaIndex = 0;
+		bOutOfBounds = true;
+		if (fBeta == m_pMainHeader->fBetaEnd && fBeta == m_pMainHeader->fBetaStart)
+			bOutOfBounds = false;  // Direct hit
+	} else {
+		if ((fBeta >= m_pMainHeader->fBetaStart) && (fBeta <= m_pMainHeader->fBetaEnd)) {
+			// Within the covered beta range
+			iBetaIndex = (int)roundf((fBeta - m_pMainHeader->fBetaStart) / m_fBetaResolution);
+		} else {
+			// Outside the covered beta range
+			// Decide: Which is closer? Start boundary or end boundary?
+			if (std::abs(m_pMainHeader->fBetaStart - fBeta) <= std::abs(m_pMainHeader->fBetaEnd - fBeta))
+				iBetaIndex = 0;  // Start index
+			else
+				iBetaIndex = (int)m_pMainHeader->iBetaPoints - 1;  // End index
+
+			bOutOfBounds = true;
+		}
+	}
+
+	iRecordIndex = getGridRecordIndex(iAlphaIndex, iBetaIndex);
+
+	// Streaming in progress: coarser grid of the levels streamed so far
+	if (m_iNumLoadedLevels < (int)m_vLevels.size())
+		snapToLoadedLevels(iAlphaIndex, iBetaIndex, iRecordIndex);
+}
+
+int DAFFReaderImpl::getGridRecordIndex(int iAlphaIndex, int iBetaIndex) const
+{
+	if (m_pMainHeader->fBetaStart == 0.0f) {  // South pole present: increment by one (single record at poles)
+		if (iBetaIndex == 0)                  // Hit south pole
+			return 0;
+
+		if ((iBetaIndex == m_pMainHeader->iBetaPoints - 1) && (m_pMainHeader->fBetaEnd == 180.0f))  // Hit north pole
+			return 1 + (iBetaIndex - 1) * m_pMainHeader->iAlphaPoints;
+
+		return 1 + (iBetaIndex - 1) * m_pMainHeader->iAlphaPoints + iAlphaIndex;
+	}
+
+	if ((iBetaIndex == m_pMainHeader->iBetaPoints - 1) && (m_pMainHeader->fBetaEnd == 180.0f))  // Hit north pole
+		return iBetaIndex * m_pMainHeader->iAlphaPoints;
+
+	return iBetaIndex * m_pMainHeader->iAlphaPoints + iAlphaIndex;
+}
+
+bool DAFFReaderImpl::isInRegion(float fAlpha, float fBeta) const
+{
+	switch (m_oRegion.iType) {
+	case DAFF_REGION_BETA_RANGE:
+		return (fBeta >= m_oRegion.fBetaStart - DAFF_REGION_TOLERANCE) &&
+			   (fBeta <= m_oRegion.fBetaEnd + DAFF_REGION_TOLERANCE);
+
+	case DAFF_REGION_CONE: {
+		float v[3];
+		getDirectionVector(fAlpha, fBeta, v);
+		return (v[0] * m_pfRegionAxis[0] + v[1] * m_pfRegionAxis[1] + v[2] * m_pfRegionAxis[2] >= m_fRegionCosAngle);
+	}
+
+	case DAFF_REGION_RECORDS:
+		// Inside if the closest record of the full grid is loaded
+		return std::binary_search(m_viRegionRecords.begin(), m_viRegionRecords.end(),
+								  m_oGridIndex.getNearest(fAlpha, fBeta));
+
+	default:
+		return true;
+	}
+}
+
+void DAFFReaderImpl::snapToLoadedLevels(int iAlphaIndex, int iBetaIndex, int& iRecordIndex) const
+{
+	// Nothing streamed yet: the record is loaded on demand
+	int iNumLoadedLevels = m_iNumLoadedLevels;
+	if (iNumLoadedLevels == 0)
+		return;
+
+	// Poles belong to the coarsest level, other points to the levels whose step divides both indices
+	const DAFFLevelEntry& oLevel = m_vLevels[iNumLoadedLevels - 1];
+	int iStep = oLevel.iStep;
+	int iBetaPoints = m_pMainHeader->iBetaPoints;
+	bool bNorthPole = (m_pMainHeader->fBetaEnd == 180.0f);
+	bool bPole = ((iBetaIndex == 0) && (m_pMainHeader->fBetaStart == 0.0f)) ||
+				 ((iBetaIndex == iBetaPoints - 1) && bNorthPole);
+	if (!bPole) {
+		iBetaIndex = (iBetaIndex + iStep / 2) / iStep * iStep;
+		if (iBetaIndex > iBetaPoints - 1)
+			iBetaIndex = (bNorthPole ? iBetaPoints - 1 : iBetaIndex - iStep);
+
+		iAlphaIndex = (iAlphaIndex + iStep / 2) / iStep * iStep;
+		if (iAlphaIndex > m_pMainHeader->iAlphaPoints - 1)
+			iAlphaIndex = (coversFullAlphaRange() ? 0 : iAlphaIndex - iStep);
+	}
+
+	int iSnappedIndex = getGridRecordIndex(iAlphaIndex, iBetaIndex);
+	if (m_vui64DataOffsets[(size_t)iSnappedIndex * m_pMainHeader->iNumChannels] < oLevel.ui64DataEnd)
+		iRecordIndex = iSnappedIndex;
+}
+
+void DAFFReaderImpl::getCell(int iView, const float fAngle1, const float fAngle2, DAFFQuad& qIndices) const
+{
+	// switch to data view
+	float fAlpha = fAngle1;
+	float fBeta = fAngle2;
+	if (iView == DAFF_OBJECT_VIEW)
+		transformAnglesO2D(fAngle1, fAngle2, fAlpha, fBeta);
+	DAFFUtils::NormalizeDirection(DAFF_DATA_VIEW, fAlpha, fBeta, fAlpha, fBeta);
+
+	// Irregular grids have no cells: the (up to) four nearest records by ascending distance
+	if (!m_vRecordDirections.empty()) {
+		int piIndices[4];
+		int n = m_oDirectionIndex.getKNearest(fAlpha, fBeta, 4, piIndices, NULL);
+		for (int i = n; i < 4; i++)
+			piIndices[i] = piIndices[n - 1];
+		qIndices.iIndex1 = piIndices[0];
+		qIndices.iIndex2 = piIndices[1];
+		qIndices.iIndex3 = piIndices[2];
+		qIndices.iIndex4 = piIndices[3];
+		return;
+	}
+
+	// south pole with full sphere covered is a problem (but algorithm holds for north pole)
+	if (fBeta == 0.0f && coversFullSphere()) {  // return the south pole 4 times
+		getNearestNeighbour(DAFF_DATA_VIEW, 0.0f, 0.0f, qIndices.iIndex1);
+		qIndices.iIndex2 = qIndices.iIndex1;
+		qIndices.iIndex3 = qIndices.iIndex1;
+		qIndices.iIndex4 = qIndices.iIndex1;
+		return;
+	}
+
+	// grid angles of the corners 1-4
+	float pfAlpha[4], pfBeta[4];
+
+	pfAlpha[0] = fAlpha - fmodf(fAlpha, getAlphaResolution());
+	pfAlpha[1] = pfAlpha[0];
+	pfAlpha[2] = fAlpha + getAlphaResolution() - fmodf(fAlpha, getAlphaResolution());
+	pfAlpha[3] = pfAlpha[2];
+
+	pfBeta[0] = fBeta - fmodf(fBeta, getBetaResolution());
+	pfBeta[1] = fBeta + getBetaResolution() - fmodf(fBeta, getBetaResolution());
+	pfBeta[2] = pfBeta[1];
+	pfBeta[3] = pfBeta[0];
+
+	// Upper beta angles are not allowed to overrun the north pole
+	if (pfBeta[1] > 180.0f) {
+		pfBeta[1] = 180.0f;
+		pfBeta[2] = 180.0f;
+	}
+
+	// Normalize all corners at once & get indices (without normalizing again)
+	DAFF::normalize_directions_dsc(pfAlpha, pfBeta, 4);
+
+	int* piIndices[4] = { &qIndices.iIndex1, &qIndices.iIndex2, &qIndices.iIndex3, &qIndices.iIndex4 };
+	for (int i = 0; i < 4; i++) {
+		bool bOutOfBounds;
+		getNearestNeighbourNormalizedDSC(pfAlpha[i], pfBeta[i], *piIndices[i], bOutOfBounds);
+		DAFF_INSTRUMENT_COUNT(DAFF_COUNTER_OUT_OF_BOUNDS, bOutOfBounds ? 1 : 0);
+	}
+
+	DAFF_INSTRUMENT_COUNT(DAFF_COUNTER_NEAREST_NEIGHBOUR, 4);
+}
+
+int DAFFReaderImpl::getKNearestNeighbours(int iView, float fAngle1, float fAngle2, int k, int* piRecordIndices,
+										  float* pfDistances) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	float fAlpha = fAngle1;
+	float fBeta = fAngle2;
+	if (iView == DAFF_OBJECT_VIEW)
+		transformAnglesO2D(fAngle1, fAngle2, fAlpha, fBeta);
+
+	return getDirectionIndex().getKNearest(fAlpha, fBeta, k, piRecordIndices, pfDistances);
+}
+
+int DAFFReaderImpl::getKNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int k,
+										  int* piRecordIndices, float* pfDistances, size_t n) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	if (k <= 0)
+		return 0;
+
+	const DAFFSphereIndex& oIndex = getDirectionIndex();
+	int iFound = std::min(k, oIndex.getNumPoints());
+
+	// Object view directions are transformed block-wise into the DSC
+	const size_t BLOCK_SIZE = 256;
+	float pfAlpha[BLOCK_SIZE];
+	float pfBeta[BLOCK_SIZE];
+
+	std::shared_ptr<const DAFFSCTransform> pTrans = getTransform();
+
+	for (size_t i = 0; i < n; i += BLOCK_SIZE) {
+		size_t m = std::min(BLOCK_SIZE, n - i);
+		const float* pfA = pfAngles1 + i;
+		const float* pfB = pfAngles2 + i;
+
+		if (iView == DAFF_OBJECT_VIEW) {
+			pTrans->transformOSC2DSC(pfA, pfB, pfAlpha, pfBeta, m);
+			pfA = pfAlpha;
+			pfB = pfBeta;
+		}
+
+		for (size_t j = 0; j < m; j++) {
+			int* piRow = piRecordIndices + (i + j) * k;
+			float* pfRow = (pfDistances ? pfDistances + (i + j) * k : NULL);
+			oIndex.getKNearest(pfA[j], pfB[j], k, piRow, pfRow);
+
+			for (int l = iFound; l < k; l++) {
+				piRow[l] = -1;
+				if (pfRow)
+					pfRow[l] = -1.0f;
+			}
+		}
+	}
+
+	return iFound;
+}
+
+int DAFFReaderImpl::getRecordsInCone(int iView, float fAngle1, float fAngle2, float fRadius,
+									 std::vector<int>& viRecordIndices) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	float fAlpha = fAngle1;
+	float fBeta = fAngle2;
+	if (iView == DAFF_OBJECT_VIEW)
+		transformAnglesO2D(fAngle1, fAngle2, fAlpha, fBeta);
+
+	viRecordIndices.clear();
+	getRecordsInConeDSC(fAlpha, fBeta, fRadius, viRecordIndices);
+
+	return (int)viRecordIndices.size();
+}
+
+int DAFFReaderImpl::getRecordsInCone(int iView, const float* pfAngles1, const float* pfAngles2, float fRadius,
+									 std::vector<int>& viRecordIndices, std::vector<int>& viOffsets, size_t n) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	viRecordIndices.clear();
+	viOffsets.resize(n + 1);
+	viOffsets[0] = 0;
+
+	// Object view directions are transformed block-wise into the DSC
+	const size_t BLOCK_SIZE = 256;
+	float pfAlpha[BLOCK_SIZE];
+	float pfBeta[BLOCK_SIZE];
+
+	std::shared_ptr<const DAFFSCTransform> pTrans = getTransform();
+
+	for (size_t i = 0; i < n; i += BLOCK_SIZE) {
+		size_t m = std::min(BLOCK_SIZE, n - i);
+		const float* pfA = pfAngles1 + i;
+		const float* pfB = pfAngles2 + i;
+
+		if (iView == DAFF_OBJECT_VIEW) {
+			pTrans->transformOSC2DSC(pfA, pfB, pfAlpha, pfBeta, m);
+			pfA = pfAlpha;
+			pfB = pfBeta;
+		}
+
+		for (size_t j = 0; j < m; j++) {
+			getRecordsInConeDSC(pfA[j], pfB[j], fRadius, viRecordIndices);
+			viOffsets[i + j + 1] = (int)viRecordIndices.size();
+		}
+	}
+
+	return (int)viRecordIndices.size();
+}
+
+void DAFFReaderImpl::getRecordsInConeDSC(float fAlpha, float fBeta, float fRadius,
+										 std::vector<int>& viRecordIndices) const
+{
+	if (fRadius < 0)
+		return;
+
+	// Grid points exactly on the boundary of the cone are included
+	fRadius = std::min(fRadius + DAFF_REGION_TOLERANCE, 180.0f);
+
+	// Irregular grids (and regions): range search in the direction index
+	if (!m_vRecordDirections.empty()) {
+		size_t nFirst = viRecordIndices.size();
+		getDirectionIndex().getInRadius(fAlpha, fBeta, fRadius, viRecordIndices);
+		std::sort(viRecordIndices.begin() + nFirst, viRecordIndices.end());
+		return;
+	}
+
+	DAFF::normalize_directions_dsc(&fAlpha, &fBeta, 1);
+
+	// Points are compared by their squared chordal distance (like the direction index), all on the whole sphere
+	float q[3];
+	getDirectionVector(fAlpha, fBeta, q);
+	float fChord = 2.0f * sinf(DAFFUtils::grad2radf(fRadius) * 0.5f);
+	float fMaxDist2 = (fRadius >= 180.0f ? FLT_MAX : fChord * fChord);
+
+	float fCosRadius = cosf(DAFFUtils::grad2radf(fRadius));
+	float fCosBeta = cosf(DAFFUtils::grad2radf(fBeta));
+	float fSinBeta = sinf(DAFFUtils::grad2radf(fBeta));
+
+	int iAlphaPoints = m_pMainHeader->iAlphaPoints;
+	int iBetaPoints = m_pMainHeader->iBetaPoints;
+	float fAlphaStart = m_pMainHeader->fAlphaStart;
+	float fBetaStart = m_pMainHeader->fBetaStart;
+
+	// Only the rows within the beta band [beta - r, beta + r] can hold records of the cone
+	int iFirstRow = 0;
+	int iLastRow = iBetaPoints - 1;
+	if (iBetaPoints > 1) {
+		iFirstRow = std::max((int)ceilf((fBeta - fRadius - fBetaStart) / m_fBetaResolution), 0);
+		iLastRow = std::min((int)floorf((fBeta + fRadius - fBetaStart) / m_fBetaResolution), iBetaPoints - 1);
+	}
+
+	for (int iBetaIndex = iFirstRow; iBetaIndex <= iLastRow; iBetaIndex++) {
+		float fRowBeta = fBetaStart + (float)iBetaIndex * m_fBetaResolution;
+		bool bPole = ((iBetaIndex == 0) && (fBetaStart == 0.0f)) ||
+					 ((iBetaIndex == iBetaPoints - 1) && (m_pMainHeader->fBetaEnd == 180.0f));
+
+		// Columns within the alpha half-width: cos(d) = cos(b) cos(b') + sin(b) sin(b') cos(a - a')
+		int iHalfWidth = iAlphaPoints;
+		float fRowSinBeta = sinf(DAFFUtils::grad2radf(fRowBeta));
+		float fDenom = fSinBeta * fRowSinBeta;
+		if (!bPole && (fDenom > 1e-6f) && (iAlphaPoints > 1)) {
+			float fCosHalfWidth = (fCosRadius - fCosBeta * cosf(DAFFUtils::grad2radf(fRowBeta))) / fDenom;
+			if (fCosHalfWidth > -1.0f) {
+				float fHalfWidth = DAFFUtils::rad2gradf(acosf(std::min(fCosHalfWidth, 1.0f)));
+				iHalfWidth = (int)ceilf(fHalfWidth / m_fAlphaResolution);
+			}
+		}
+
+		// Poles are single records, whole rows are tested column by column
+		int iNumColumns = (bPole ? 1 : iAlphaPoints);
+		if (bPole || (2 * iHalfWidth + 3 >= iAlphaPoints)) {
+			for (int iAlphaIndex = 0; iAlphaIndex < iNumColumns; iAlphaIndex++) {
+				float v[3];
+				getDirectionVector(fAlphaStart + (float)iAlphaIndex * m_fAlphaResolution, fRowBeta, v);
+				float dx = q[0] - v[0], dy = q[1] - v[1], dz = q[2] - v[2];
+				if (dx * dx + dy * dy + dz * dz <= fMaxDist2)
+					viRecordIndices.push_back(getGridRecordIndex(iAlphaIndex, iBetaIndex));
+			}
+			continue;
+		}
+
+		// Column windows around the direction and its images one turn apart (wrap-around, alpha start > 0),
+		// the windows are ascending and disjoint, so are the record indices
+		int iNextIndex = 0;
+		for (int iTurn = -1; iTurn <= 2; iTurn++) {
+			float fCenter = (fAlpha + (float)iTurn * 360.0f - fAlphaStart) / m_fAlphaResolution;
+			int iFirst = std::max((int)floorf(fCenter) - iHalfWidth, iNextIndex);
+			int iLast = std::min((int)ceilf(fCenter) + iHalfWidth, iAlphaPoints - 1);
+
+			for (int iAlphaIndex = iFirst; iAlphaIndex <= iLast; iAlphaIndex++) {
+				float v[3];
+				getDirectionVector(fAlphaStart + (float)iAlphaIndex * m_fAlphaResolution, fRowBeta, v);
+				float dx = q[0] - v[0], dy = q[1] - v[1], dz = q[2] - v[2];
+				if (dx * dx + dy * dy + dz * dz <= fMaxDist2)
+					viRecordIndices.push_back(getGridRecordIndex(iAlphaIndex, iBetaIndex));
+			}
+
+			iNextIndex = std::max(iNextIndex, iLast + 1);
+		}
+	}
+}
+
+const DAFFSphereIndex& DAFFReaderImpl::getDirectionIndex() const
+{
+	// Irregular grids set up the index while loading, regular grids on first use
+	std::lock_guard<std::mutex> lock(m_mxDirectionIndex);
+	if (m_oDirectionIndex.getNumPoints() == 0)
+		initDirectionIndex();
+
+	return m_oDirectionIndex;
+}
+
+int DAFFReaderImpl::loadDirectionIndex()
+{
+	/*
+	 *  10th step: Load the direction index (optional)
+	 */
+
+	int iNumRecords = m_pMainHeader->iNumRecords;
+	for (size_t i = 0; i < m_vDirectionIndexNodes.size(); i++) {
+		DAFFDirectionIndexEntry& oEntry = m_vDirectionIndexNodes[i];
+		oEntry.fixEndianness();
+
+		if ((oEntry.iRecordIndex < 0) || (oEntry.iRecordIndex >= iNumRecords) || (oEntry.iAxis < 0) ||
+			(oEntry.iAxis > 2))
+			return DAFF_FILE_CORRUPTED;
+	}
+
+	// Nearest neighbours of irregular grids are always looked up in the index
+	if (!m_vRecordDirections.empty())
+		initDirectionIndex();
+
+	return DAFF_NO_ERROR;
+}
+
+void DAFFReaderImpl::initDirectionIndex() const
+{
+	int iNumRecords = m_pMainHeader->iNumRecords;
+	std::vector<float> vfAlpha(iNumRecords), vfBeta(iNumRecords);
+	for (int i = 0; i < iNumRecords; i++)
+		getRecordCoords(i, DAFF_DATA_VIEW, vfAlpha[i], vfBeta[i]);
+
+	// The stored tree saves the construction, the vectors are computed anyway
+	bool bRestored = false;
+	if (!m_vDirectionIndexNodes.empty()) {
+		std::vector<int> viIndices(iNumRecords), viAxes(iNumRecords);
+		for (int i = 0; i < iNumRecords; i++) {
+			viIndices[i] = m_vDirectionIndexNodes[i].iRecordIndex;
+			viAxes[i] = m_vDirectionIndexNodes[i].iAxis;
+		}
+
+		bRestored = m_oDirectionIndex.restore(vfAlpha.data(), vfBeta.data(), viIndices.data(), viAxes.data(),
+											  iNumRecords);
+		std::vector<DAFFDirectionIndexEntry>().swap(m_vDirectionIndexNodes);
+	}
+
+	if (!bRestored)
+		m_oDirectionIndex.init(vfAlpha.data(), vfBeta.data(), iNumRecords);
+}
+
+int DAFFReaderImpl::loadChecksums(const char* pBlock, size_t nSize, uint32_t ui32HeaderChecksum)
+{
+	/*
+	 *  11th step: Load the checksums (optional, DAFF_OPEN_VERIFY)
+	 */
+
+	DAFFChecksumHeader oHeader;
+	if (nSize < sizeof(DAFFChecksumHeader))
+		return DAFF_FILE_CORRUPTED;
+
+	memcpy(&oHeader, pBlock, sizeof(DAFFChecksumHeader));
+	oHeader.fixEndianness();
+
+	if ((oHeader.iNumFileBlocks != m_fileHeader.iNumFileBlocks) || (oHeader.iSegmentSize < 4096) ||
+		((oHeader.iSegmentSize & (oHeader.iSegmentSize - 1)) != 0))
 		return DAFF_FILE_CORRUPTED;
+
+	// Segments of all blocks except the checksum block itself, in the order of the block table
+	uint64_t ui64SegmentSize = (uint64_t)oHeader.iSegmentSize;
+	size_t nNumSegments = 0;
+	m_vnFirstChecksums.resize(m_fileHeader.iNumFileBlocks);
+	for (int i = 0; i < m_fileHeader.iNumFileBlocks; i++) {
+		m_vnFirstChecksums[i] = nNumSegments;
+		if (m_pFileBlockTable[i].iID != FILEBLOCK_DAFF1_CHECKSUMS_ID)
+			nNumSegments += (size_t)((m_pFileBlockTable[i].ui64Size + ui64SegmentSize - 1) / ui64SegmentSize);
 	}
 
-	if (pMetadataFileBlock == nullptr) {
-		m_vpMetadata.push_back(new DAFFMetadataImpl);  // Empty
-	} else if (pMetadataFileBlock->ui64Size == 0) {
-		m_vpMetadata.push_back(new DAFFMetadataImpl);  // Empty  )
-	} else {
-		// Read all the DAFFMetadataImpl instances
-		DAFFMetadataImpl* pMetadataImpl = NULL;
-		size_t iBytesRead = 0;
-		char* pCurrentBuf = pMetadataBuf;
-		char* pEndOfMetaDataBuf = pCurrentBuf + (size_t)pMetadataFileBlock->ui64Size;
-		while (pCurrentBuf < pEndOfMetaDataBuf) {
-			pMetadataImpl = new DAFFMetadataImpl;
-			int iError = pMetadataImpl->load(pCurrentBuf, iBytesRead);
-			if ((iError != 0) || (iBytesRead == 0)) {
-				tidyup();
-				return iError;
-			}
+	if (nSize != sizeof(DAFFChecksumHeader) + nNumSegments * sizeof(uint32_t))
+		return DAFF_FILE_CORRUPTED;
 
-			m_vpMetadata.push_back(pMetadataImpl);
+	m_vui32Checksums.resize(nNumSegments);
+	if (nNumSegments > 0)
+		memcpy(m_vui32Checksums.data(), pBlock + sizeof(DAFFChecksumHeader), nNumSegments * sizeof(uint32_t));
+	DAFF::le2se_4byte(m_vui32Checksums.data(), nNumSegments);
+	m_iChecksumSegmentSize = oHeader.iSegmentSize;
 
-			// Set Buffer to next DAFFMetaDataImpl instance
-			pCurrentBuf += iBytesRead;
-		}
+	// The block table is verified right away, the blocks when they are loaded
+	if (oHeader.ui32HeaderChecksum != ui32HeaderChecksum)
+		return DAFF_FILE_CHECKSUM_MISMATCH;
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::verifyFileBlock(const DAFFFileBlockEntry* pBlock, const void* pData, size_t nSize) const
+{
+	if (m_iChecksumSegmentSize == 0)
+		return DAFF_NO_ERROR;
+
+	uint64_t ui64SegmentSize = (uint64_t)m_iChecksumSegmentSize;
+	uint64_t ui64NumSegments = (pBlock->ui64Size + ui64SegmentSize - 1) / ui64SegmentSize;
+	const uint32_t* pui32Expected = m_vui32Checksums.data() + m_vnFirstChecksums[pBlock - m_pFileBlockTable];
+
+	// Segments within the loaded bytes (the last one only if the whole block is loaded)
+	size_t nNumLoaded = (size_t)ui64NumSegments;
+	size_t nLoadedSize = (size_t)pBlock->ui64Size;
+	if (nSize < pBlock->ui64Size) {
+		nNumLoaded = (size_t)(nSize / ui64SegmentSize);
+		nLoadedSize = (size_t)(nNumLoaded * ui64SegmentSize);
+	}
+
+	if (nNumLoaded > 0) {
+		std::vector<uint32_t> vui32Checksums(nNumLoaded);
+		DAFF::crc32c_segments(pData, nLoadedSize, (size_t)ui64SegmentSize, vui32Checksums.data());
+		if (!std::equal(vui32Checksums.begin(), vui32Checksums.end(), pui32Expected))
+			return DAFF_FILE_CHECKSUM_MISMATCH;
+	}
+
+	// The remaining segments are read from the source
+	for (uint64_t i = nNumLoaded; i < ui64NumSegments; i++) {
+		size_t nBytes = (size_t)std::min(ui64SegmentSize, pBlock->ui64Size - i * ui64SegmentSize);
+		m_vcVerifyBuf.resize(nBytes);
+		if ((m_pSource == NULL) ||
+			(m_pSource->read(pBlock->ui64Offset + i * ui64SegmentSize, &m_vcVerifyBuf[0], nBytes) != DAFF_NO_ERROR))
+			return DAFF_FILE_CORRUPTED;
+		if (DAFF::crc32c(&m_vcVerifyBuf[0], nBytes) != pui32Expected[i])
+			return DAFF_FILE_CHECKSUM_MISMATCH;
 	}
 
 	return DAFF_NO_ERROR;
 }
 
-void DAFFReaderImpl::fixAngleRanges()
+int DAFFReaderImpl::verifyDataRange(uint64_t ui64Offset, uint64_t ui64Size) const
 {
-	// Important: If there is only one point in a dimension => Then there is no resolution
-	// TODO: Recheck if this is correct for non-full and full angular ranges
+	if (m_vcVerifiedSegments.empty() || (ui64Size == 0))
+		return DAFF_NO_ERROR;
 
-	float fAlphaSpan;
-	if (m_pMainHeader->fAlphaEnd > m_pMainHeader->fAlphaStart)
-		fAlphaSpan = m_pMainHeader->fAlphaEnd - m_pMainHeader->fAlphaStart;
-	else
-		fAlphaSpan = 360 - m_pMainHeader->fAlphaStart + m_pMainHeader->fAlphaEnd;
-	float fBetaSpan = m_pMainHeader->fBetaEnd - m_pMainHeader->fBetaStart;
+	uint64_t ui64BlockSize = m_pDataFileBlock->ui64Size;
+	if ((ui64Offset > ui64BlockSize) || (ui64Size > ui64BlockSize - ui64Offset))
+		return DAFF_FILE_CORRUPTED;
 
-	/*
-	 *  [fwe] Bugfix 2011-05-30
-	 *  Only if the full azimuth range is span, the formula
-	 *
-	 *  m_fAlphaResolution = fAlphaSpan / m_pMainHeader->iAlphaPoints
-	 *
-	 *  is valid. In case there is no full alpha coverage, the last point
-	 *  marks the end of the interval and does not count. Therefore:
-	 *
-	 *  m_fAlphaResolution = fAlphaSpan / (m_pMainHeader->iAlphaPoints-1)
-	 *
-	 */
+	uint64_t ui64SegmentSize = (uint64_t)m_iChecksumSegmentSize;
+	const uint32_t* pui32Expected =
+		m_vui32Checksums.data() + m_vnFirstChecksums[m_pDataFileBlock - m_pFileBlockTable];
 
-	if (m_pMainHeader->iAlphaPoints > 1) {
-		if (fAlphaSpan == 360)
-			m_fAlphaResolution = fAlphaSpan / m_pMainHeader->iAlphaPoints;
-		else
-			m_fAlphaResolution = fAlphaSpan / (m_pMainHeader->iAlphaPoints - 1);
-	} else
-		m_fAlphaResolution = 0;
+	uint64_t ui64Last = (ui64Offset + ui64Size - 1) / ui64SegmentSize;
+	for (uint64_t i = ui64Offset / ui64SegmentSize; i <= ui64Last; i++) {
+		if (m_vcVerifiedSegments[(size_t)i])
+			continue;
 
-	if (m_pMainHeader->iBetaPoints > 1)
-		m_fBetaResolution = fBetaSpan / (m_pMainHeader->iBetaPoints - 1);
-	else
-		m_fBetaResolution = 0;
+		size_t nBytes = (size_t)std::min(ui64SegmentSize, ui64BlockSize - i * ui64SegmentSize);
+		m_vcVerifyBuf.resize(nBytes);
+		if (m_pSource->read(m_pDataFileBlock->ui64Offset + i * ui64SegmentSize, &m_vcVerifyBuf[0], nBytes) !=
+			DAFF_NO_ERROR)
+			return DAFF_FILE_CORRUPTED;
+		if (DAFF::crc32c(&m_vcVerifyBuf[0], nBytes) != pui32Expected[i])
+			return DAFF_FILE_CHECKSUM_MISMATCH;
+
+		m_vcVerifiedSegments[(size_t)i] = 1;
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+std::shared_ptr<const DAFFSCTransform> DAFFReaderImpl::getTransform() const
+{
+	return std::atomic_load(&m_pTrans);
+}
+
+void DAFFReaderImpl::transformAnglesD2O(const float fAlpha, const float fBeta, float& fAzimuth, float& fElevation) const
+{
+	getTransform()->transformDSC2OSC(fAlpha, fBeta, fAzimuth, fElevation);
+}
+
+void DAFFReaderImpl::transformAnglesO2D(const float fAzimuth, const float fElevation, float& fAlpha, float& fBeta) const
+{
+	getTransform()->transformOSC2DSC(fAzimuth, fElevation, fAlpha, fBeta);
+}
+
+double DAFFReaderImpl::getSamplerate() const
+{
+	if (m_pMainHeader->iContentType == DAFF_IMPULSE_RESPONSE)
+		return m_pContentHeaderIR->fSamplerate;
+	if (m_pMainHeader->iContentType == DAFF_DFT_SPECTRUM)
+		return m_pContentHeaderDFT->fSamplerate;
+	return 0;  // error
+}
+
+int DAFFReaderImpl::getFilterLength() const
+{
+	return m_pMainHeader->iElementsPerRecord;
+}
+
+int DAFFReaderImpl::getMinEffectiveFilterOffset() const
+{
+	return m_pContentHeaderIR->iMinFilterOffset;
+}
+
+int DAFFReaderImpl::getMaxEffectiveFilterLength() const
+{
+	return m_pContentHeaderIR->iMaxEffectiveFilterLength;
+}
+
+int DAFFReaderImpl::getFilterCoeffsTruncated(int iRecordIndex, int iChannel, float* pfDest, int& iLength,
+											 float fGain) const
+{
+	int iOffset;
+	int iEffectiveLength;
+	int iError;
+
+	iError = getEffectiveFilterBounds(iRecordIndex, iChannel, iOffset, iEffectiveLength);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	iLength = iOffset + iEffectiveLength;
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	// Place zeros before the data
+	for (int i = 0; i < iOffset; i++)
+		pfDest[i] = 0;
+
+	// Insert the data
+	return getEffectiveFilterCoeffs(iRecordIndex, iChannel, pfDest + iOffset, fGain);
+}
+
+int DAFFReaderImpl::getMaxTruncatedFilterLength() const
+{
+	int iMaxLength = 0;
+	for (size_t i = 0; i < m_viElementLengths.size(); i++)
+		iMaxLength = std::max(iMaxLength, m_viLeadingZeros[i] + m_viElementLengths[i]);
+
+	return iMaxLength;
+}
+
+int DAFFReaderImpl::getFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
+{
+	int iOffset;
+	int iEffectiveLength;
+	int iError;
+
+	iError = getEffectiveFilterBounds(iRecordIndex, iChannel, iOffset, iEffectiveLength);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	// Place zeros before the data
+	for (int i = 0; i < iOffset; i++)
+		pfDest[i] = 0;
+
+	// Insert the data
+	iError = getEffectiveFilterCoeffs(iRecordIndex, iChannel, pfDest + iOffset, fGain);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	// Place zeros behind the data
+	for (int i = iOffset + iEffectiveLength; i < getFilterLength(); i++)
+		pfDest[i] = 0;
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::getFilterCoeff(int iRecordIndex, int iChannel, int iSample, float& fCoeff) const
+{
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+
+	if (m_pMainHeader->iContentType != DAFF_IMPULSE_RESPONSE)
+		return DAFF_MODAL_ERROR;
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels) || (iSample < 0) || (iSample >= getFilterLength()))
+		return DAFF_INVALID_INDEX;
+
+	// Only the effective part is stored, the coefficients around it are zeros
+	size_t n = (size_t)iRecordIndex * m_pMainHeader->iNumChannels + iChannel;
+	if ((iSample < m_viLeadingZeros[n]) || (iSample >= m_viLeadingZeros[n] + m_viElementLengths[n])) {
+		fCoeff = 0;
+		return DAFF_NO_ERROR;
+	}
+
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	const void* pData = getRecordChannelDataPtr(iRecordIndex, iChannel);
+	if (pData == NULL)
+		return DAFF_FILE_CORRUPTED;
+
+	convertValues(getValuePtr(pData, iSample - m_viLeadingZeros[n]), 1, 1, &fCoeff, 1, getBlockScale(n));
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::addFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
+{
+	int iOffset;
+	int iEffectiveLength;
+	int iError;
+
+	iError = getEffectiveFilterBounds(iRecordIndex, iChannel, iOffset, iEffectiveLength);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	// Insert the data
+	iError = addEffectiveFilterCoeffs(iRecordIndex, iChannel, pfDest + iOffset, fGain);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::getFilterCoeffsQ15(int iRecordIndex, int iChannel, int16_t* piDest, float fGain) const
+{
+	return getFixedPointFilterCoeffs(iRecordIndex, iChannel, piDest, NULL, fGain, false);
+}
+
+int DAFFReaderImpl::getFilterCoeffsQ31(int iRecordIndex, int iChannel, int32_t* piDest, float fGain) const
+{
+	return getFixedPointFilterCoeffs(iRecordIndex, iChannel, NULL, piDest, fGain, false);
+}
+
+int DAFFReaderImpl::addFilterCoeffsQ15(int iRecordIndex, int iChannel, int16_t* piDest, float fGain) const
+{
+	return getFixedPointFilterCoeffs(iRecordIndex, iChannel, piDest, NULL, fGain, true);
+}
+
+int DAFFReaderImpl::addFilterCoeffsQ31(int iRecordIndex, int iChannel, int32_t* piDest, float fGain) const
+{
+	return getFixedPointFilterCoeffs(iRecordIndex, iChannel, NULL, piDest, fGain, true);
+}
+
+int DAFFReaderImpl::getFixedPointFilterCoeffs(int iRecordIndex, int iChannel, int16_t* piDestQ15, int32_t* piDestQ31,
+											  float fGain, bool bAdd) const
+{
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+
+	if (m_pMainHeader->iContentType != DAFF_IMPULSE_RESPONSE)
+		return DAFF_MODAL_ERROR;
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return DAFF_INVALID_INDEX;
+
+	if ((piDestQ15 == NULL) && (piDestQ31 == NULL))
+		return DAFF_NO_ERROR;
+
+	size_t n = (size_t)iRecordIndex * m_pMainHeader->iNumChannels + iChannel;
+	int iOffset = m_viLeadingZeros[n];
+	int iLength = m_viElementLengths[n];
+
+	// Only the effective part is stored, the coefficients around it are zeros
+	if (!bAdd) {
+		size_t nSize = (piDestQ15 ? sizeof(int16_t) : sizeof(int32_t));
+		char* pDest = (piDestQ15 ? (char*)piDestQ15 : (char*)piDestQ31);
+		memset(pDest, 0, iOffset * nSize);
+		memset(pDest + (iOffset + iLength) * nSize, 0, (getFilterLength() - iOffset - iLength) * nSize);
+	}
+
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	const void* pData = getRecordChannelDataPtr(iRecordIndex, iChannel);
+	if (pData == NULL)
+		return DAFF_FILE_CORRUPTED;
+
+	convertValuesFixedPoint(pData, iLength, (piDestQ15 ? piDestQ15 + iOffset : NULL),
+							(piDestQ31 ? piDestQ31 + iOffset : NULL), fGain * getBlockScale(n), bAdd);
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::getEffectiveFilterBounds(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const
+{
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return DAFF_INVALID_INDEX;
+
+	size_t n = (size_t)iRecordIndex * m_pMainHeader->iNumChannels + iChannel;
+	iOffset = m_viLeadingZeros[n];
+	iLength = m_viElementLengths[n];
+
+	return DAFF_NO_ERROR;
 }
 
-void DAFFReaderImpl::closeFile()
-{
-	if (!m_bDAFFObjectValid)
-		return;
+int DAFFReaderImpl::getEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
+{
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	size_t n = (size_t)iRecordIndex * m_pMainHeader->iNumChannels + iChannel;
+	int iLength = m_viElementLengths[n];
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	const void* pData = getRecordChannelDataPtr(iRecordIndex, iChannel);
+	if (pData == NULL)
+		return DAFF_FILE_CORRUPTED;
+
+	convertValues(pData, iLength, 1, pfDest, 1, fGain * getBlockScale(n));
 
-	tidyup();
+	return DAFF_NO_ERROR;
 }
 
-void DAFFReaderImpl::tidyup()
+int DAFFReaderImpl::addEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
 {
-	if (m_file) {
-		fclose(m_file);
-		m_file = NULL;
-	}
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
 
-	DAFF::free_aligned16(m_pFileBlockTable);
-	m_pFileBlockTable = NULL;
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return DAFF_INVALID_INDEX;
 
-	DAFF::free_aligned16(m_pMainHeader);
-	m_pMainHeader = NULL;
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
 
-	DAFF::free_aligned16(m_pContentHeader);
-	m_pContentHeader = NULL;
+	size_t n = (size_t)iRecordIndex * m_pMainHeader->iNumChannels + iChannel;
+	int iLength = m_viElementLengths[n];
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	const void* pData = getRecordChannelDataPtr(iRecordIndex, iChannel);
+	if (pData == NULL)
+		return DAFF_FILE_CORRUPTED;
 
-	DAFF::free_aligned16(m_pRecordDescriptorBlock);
-	m_pRecordDescriptorBlock = NULL;
+	convertValues(pData, iLength, 1, pfDest, 1, fGain * getBlockScale(n), true);
 
-	DAFF::free_aligned16(m_pDataBlock);
-	m_pDataBlock = NULL;
+	return DAFF_NO_ERROR;
+}
 
-	for (size_t i = 0; i < m_vpMetadata.size(); ++i)
-		delete m_vpMetadata[i];
+const float* DAFFReaderImpl::getEffectiveFilterCoeffsPtr(int iRecordIndex, int iChannel, int& iOffset,
+															int& iLength) const
+{
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return NULL;
 
-	m_vpMetadata.clear();
+	// Direct access is only possible without sample type conversion
+	if (m_iDataQuantization != DAFF_FLOAT32)
+		return NULL;
 
-	m_sFilePath = "";
-	m_bDAFFObjectValid = false;
+	size_t n = (size_t)iRecordIndex * m_pMainHeader->iNumChannels + iChannel;
+	iOffset = m_viLeadingZeros[n];
+	iLength = m_viElementLengths[n];
+
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	return (const float*)getRecordChannelDataPtr(iRecordIndex, iChannel);
 }
 
-int DAFFReaderImpl::getFirstFileBlockByID(int iID, DAFFFileBlockEntry*& pfDest) const
+int DAFFReaderImpl::getFilterEnvelope(int iRecordIndex, int iChannel, int iFirstSample, int iNumSamples, int iNumBins,
+									  float* pfMin, float* pfMax) const
 {
-	std::vector<DAFFFileBlockEntry*> v;
-	getFileBlocksByID(iID, v);
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
 
-	if (v.empty()) {
-		pfDest = NULL;
-		return 0;
-	}
+	if (m_pMainHeader->iContentType != DAFF_IMPULSE_RESPONSE)
+		return DAFF_MODAL_ERROR;
 
-	pfDest = v.front();
-	return (int)v.size();
-}
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return DAFF_INVALID_INDEX;
 
-int DAFFReaderImpl::getFileBlocksByID(int iID, std::vector<DAFFFileBlockEntry*>& vpfDest) const
-{
-	vpfDest.clear();
-	for (int i = 0; i < m_fileHeader.iNumFileBlocks; i++) {
-		if (m_pFileBlockTable[i].iID == iID)
-			vpfDest.push_back(&(m_pFileBlockTable[i]));
-	}
+	if ((iFirstSample < 0) || (iNumBins < 1) || (iNumBins > iNumSamples) ||
+		(iNumSamples > getFilterLength() - iFirstSample))
+		return DAFF_INVALID_INDEX;
 
-	return (int)vpfDest.size();
-}
+	size_t n = (size_t)iRecordIndex * m_pMainHeader->iNumChannels + iChannel;
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	const void* pData = getRecordChannelDataPtr(iRecordIndex, iChannel);
+	if (pData == NULL)
+		return DAFF_FILE_CORRUPTED;
 
-std::string DAFFReaderImpl::getFilename() const
-{
-	assert(m_bDAFFObjectValid);
-	return m_sFilePath;
-}
+	// Only the effective part is stored, the coefficients around it are zeros (the block scale is positive)
+	const float fScale = getBlockScale(n);
+	const int iDataBegin = m_viLeadingZeros[n];
+	const int iDataEnd = m_viLeadingZeros[n] + m_viElementLengths[n];
+	for (int k = 0; k < iNumBins; k++) {
+		int iBegin = iFirstSample + (int)((int64_t)k * iNumSamples / iNumBins);
+		int iEnd = iFirstSample + (int)((int64_t)(k + 1) * iNumSamples / iNumBins);
+		int iStoredBegin = std::max(iBegin, iDataBegin);
+		int iStoredEnd = std::min(iEnd, iDataEnd);
+
+		float fMin = 0, fMax = 0;
+		if (iStoredBegin < iStoredEnd) {
+			convertValues(getValuePtr(pData, iStoredBegin - iDataBegin), 1, 1, &fMin, 1);
+			fMax = fMin;
+			envelopeValues(getValuePtr(pData, iStoredBegin - iDataBegin), iStoredEnd - iStoredBegin, fMin, fMax);
+			if ((iBegin < iStoredBegin) || (iStoredEnd < iEnd)) {
+				fMin = std::min(fMin, 0.0f);
+				fMax = std::max(fMax, 0.0f);
+			}
+		}
+		pfMin[k] = fMin * fScale;
+		pfMax[k] = fMax * fScale;
+	}
 
-int DAFFReaderImpl::getFileFormatVersion() const
-{
-	assert(m_bDAFFObjectValid);
-	return m_fileHeader.iFileFormatVersion;
+	return DAFF_NO_ERROR;
 }
 
-int DAFFReaderImpl::getContentType() const
+void DAFFReaderImpl::envelopeValues(const void* pData, int iCount, float& fMin, float& fMax) const
 {
-	assert(m_bDAFFObjectValid);
-	return m_pMainHeader->iContentType;
-}
+	if (m_iDataQuantization == DAFF_FLOAT32) {
+		DAFF::minmax_float((const float*)pData, iCount, fMin, fMax);
+		return;
+	}
 
-DAFFContent* DAFFReaderImpl::getContent() const
-{
-	assert(m_bDAFFObjectValid);
-	// Logical constness here!
-	// TODO: Bad cast
-	return (DAFFContentIR*)this;
+	// Other quantizations are converted in small blocks
+	float pfBuf[256];
+	for (int i = 0; i < iCount; i += 256) {
+		int n = std::min(iCount - i, 256);
+		convertValues(getValuePtr(pData, i), n, 1, pfBuf, 1);
+		DAFF::minmax_float(pfBuf, n, fMin, fMax);
+	}
 }
 
-const DAFFMetadata* DAFFReaderImpl::getMetadata() const
+int DAFFReaderImpl::getNumFrequencies() const
 {
-	assert(m_bDAFFObjectValid);
-	return m_vpMetadata[0];
+	switch (m_pMainHeader->iContentType) {
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return m_pContentHeaderMS->iNumFreqs;
+	case DAFF_PHASE_SPECTRUM:
+		return m_pContentHeaderPS->iNumFreqs;
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		return m_pContentHeaderMPS->iNumFreqs;
+	}
+	return 0;  // error!
 }
 
-DAFFProperties* DAFFReaderImpl::getProperties() const
+const std::vector<float>& DAFFReaderImpl::getFrequencies() const
 {
-	assert(m_bDAFFObjectValid);
-	// TODO: Fixme
-	return (DAFFProperties*)this;
+	return m_vfFreqs;
 }
 
-std::string DAFFReaderImpl::toString() const
+float DAFFReaderImpl::getOverallMagnitudeMaximum() const
 {
-	assert(m_bDAFFObjectValid);
-
-	std::stringstream ss;
-
-	float fVersion = getFileFormatVersion() / 1000.0F;
-	;
-	ss << "File format version: " << DAFFUtils::Float2StrNice(fVersion, 3, false) << std::endl;
-	ss << "Content type:        " << DAFFUtils::StrContentType(getProperties()->getContentType()) << std::endl;
-	ss << "Quantization:        " << DAFFUtils::StrQuantizationType(getProperties()->getQuantization()) << std::endl
-	   << std::endl;
-	ss << "Number of channels:  " << getProperties()->getNumberOfChannels() << std::endl;
-	ss << "Number of records:   " << getProperties()->getNumberOfRecords() << std::endl << std::endl;
-	ss << "Alpha points:        " << getProperties()->getAlphaPoints() << std::endl;
-	ss << "Alpha range:         [" << DAFFUtils::Float2StrNice(getProperties()->getAlphaStart(), 3, false) << "\xF8, "
-	   << DAFFUtils::Float2StrNice(getProperties()->getAlphaEnd(), 3, false) << "\xF8]" << std::endl;
-	ss << "Beta points:         " << getProperties()->getBetaPoints() << std::endl;
-	ss << "Beta range:          [" << DAFFUtils::Float2StrNice(getProperties()->getBetaStart(), 3, false) << "\xF8, "
-	   << DAFFUtils::Float2StrNice(getProperties()->getBetaEnd(), 3, false) << "\xF8]" << std::endl;
-	ss << "Full sphere:         " << (getProperties()->coversFullSphere() ? "yes" : "no") << std::endl;
-	DAFFOrientationYPR o;
-	getOrientation(o);
-	ss << "Orientation:         " << o.toString() << std::endl;
-
-	DAFFContentIR* pContentIR;
-	DAFFReaderImpl* pContent;
-	DAFFContentDFT* pContentDFT;
-	std::vector<float> vsFrequencies;
-
-	switch (getContentType()) {
-	case DAFF_IMPULSE_RESPONSE:
-		pContentIR = dynamic_cast<DAFFContentIR*>(getContent());
-		ss << "Samplerate:          " << DAFFUtils::Double2StrNice(pContentIR->getSamplerate(), 1, false) << " Hz"
-		   << std::endl;
-		ss << "Filter length:       " << pContentIR->getFilterLength() << std::endl;
-		break;
-
+	switch (m_pMainHeader->iContentType) {
 	case DAFF_MAGNITUDE_SPECTRUM:
-	case DAFF_PHASE_SPECTRUM:
+		return m_pContentHeaderMS->fMax;
 	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
-		pContent = dynamic_cast<DAFFReaderImpl*>(getContent());
-		ss << "Number of frequencies: " << pContent->getNumFrequencies() << std::endl;
-		vsFrequencies = pContent->getFrequencies();
-		ss << "Frequency support:     ";
-		for (size_t i = 0; i < vsFrequencies.size(); i++) {
-			ss << DAFFUtils::Float2StrNice(vsFrequencies[i], 3, false);
-			if (i < (vsFrequencies.size() - 1))
-				ss << ", ";
-		}
-		ss << " Hz" << std::endl;
-		break;
-
-
+		return m_pContentHeaderMPS->fMax;
 	case DAFF_DFT_SPECTRUM:
-		pContentDFT = dynamic_cast<DAFFContentDFT*>(getContent());
-		ss << "Transform size: " << pContentDFT->getTransformSize() << std::endl;
-		ss << "Symmetric: " << ((pContentDFT->isSymmetric()) ? "yes" : "no") << std::endl;
-		ss << "Samplerate: " << pContentDFT->getSamplerate() << std::endl;
-		break;
+		return m_pContentHeaderDFT->fMax;
 	}
-	return ss.str();
+	return 0.0;  // error!
 }
 
-// --------------------------------------------------------
-
-int DAFFReaderImpl::getQuantization() const
+float DAFFReaderImpl::getOverallPeak() const
 {
-	assert(m_bDAFFObjectValid);
-	return m_pMainHeader->iQuantization;
-}
+	if (m_pMainHeader->iContentType != DAFF_IMPULSE_RESPONSE)
+		return 0;
 
-int DAFFReaderImpl::getNumberOfChannels() const
-{
-	assert(m_bDAFFObjectValid);
-	return m_pMainHeader->iNumChannels;
+	std::lock_guard<std::mutex> lock(m_mxPeaks);
+	if (!m_bOverallPeakInitialized)
+		initPeaks();  // lazy initialization
+	return m_fOverallPeak;
 }
 
-int DAFFReaderImpl::getNumberOfRecords() const
+float DAFFReaderImpl::getChannelPeak(int iChannel) const
 {
-	assert(m_bDAFFObjectValid);
-	return m_pMainHeader->iNumRecords;
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+
+	if ((m_pMainHeader->iContentType != DAFF_IMPULSE_RESPONSE) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return 0;
+
+	std::lock_guard<std::mutex> lock(m_mxPeaks);
+	if (!m_bOverallPeakInitialized)
+		initPeaks();
+	return m_vfChannelPeaks[iChannel];
 }
 
-std::string DAFFReaderImpl::getChannelLabel(int iChannel) const
+float DAFFReaderImpl::getRecordPeak(int iRecordIndex, int iChannel) const
 {
-	/* @todo
-	This specific function requires a certain key/value pair
-	within the global metadata entries in the DAFF file. It appears
-	more elegant to provide "styles" that can be met with a defined
-	set of keys and values. Compatibility can be checked during loading
-	or runtime and the file is marked as "whateever"-kompatible.
-	*/
-
-	assert(m_bDAFFObjectValid);
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
 	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
 
-	// Fetch the channel name from the metadata
-	std::stringstream ss;
-	ss << "LABEL_CHANNEL_" << (iChannel + 1);
-	return ((m_vpMetadata.size() > 0) && (m_vpMetadata[0]->hasKey(ss.str())) ? m_vpMetadata[0]->getKeyString(ss.str())
-																			 : "");
-}
+	if ((m_pMainHeader->iContentType != DAFF_IMPULSE_RESPONSE) || (iRecordIndex < 0) ||
+		(iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) || (iChannel >= m_pMainHeader->iNumChannels))
+		return 0;
 
-int DAFFReaderImpl::getAlphaPoints() const
-{
-	assert(m_bDAFFObjectValid);
-	return m_pMainHeader->iAlphaPoints;
+	std::lock_guard<std::mutex> lock(m_mxPeaks);
+	if (!m_bOverallPeakInitialized)
+		initPeaks();
+	return m_vfRecordChannelPeaks[iRecordIndex * m_pMainHeader->iNumChannels + iChannel];
 }
 
-float DAFFReaderImpl::getAlphaResolution() const
+void DAFFReaderImpl::initPeaks() const
 {
-	assert(m_bDAFFObjectValid);
+	int iNumChannels = m_pMainHeader->iNumChannels;
+	int iNumRecordChannels = m_pMainHeader->iNumRecords * iNumChannels;
+	m_vfRecordChannelPeaks.assign(iNumRecordChannels, 0.0f);
+
+	if (m_bStatisticsStored) {
+		// Taken from the statistics block, no need to touch the sample data
+		for (int i = 0; i < iNumRecordChannels; i++)
+			m_vfRecordChannelPeaks[i] = m_vStatistics[i].fPeak;
+	} else {
+		// Distribute large files over several threads, each scanning a range of record channels.
+		// Not with lazy loading, where the record cache is modified by every access.
+		int iNumThreads = 1;
+		if (!m_bLazyLoading) {
+			const uint64_t ui64MinSamplesPerThread = 1 << 18;
+			uint64_t ui64NumSamples = (uint64_t)iNumRecordChannels * m_pMainHeader->iElementsPerRecord;
+			uint64_t ui64MaxThreads = std::max(ui64NumSamples / ui64MinSamplesPerThread, (uint64_t)1);
+			iNumThreads = (int)std::min((uint64_t)std::max(std::thread::hardware_concurrency(), 1u), ui64MaxThreads);
+		}
 
-	return m_fAlphaResolution;
-}
+		std::vector<std::thread> vThreads;
+		int iChunk = (iNumRecordChannels + iNumThreads - 1) / iNumThreads;
+		for (int iBegin = iChunk; iBegin < iNumRecordChannels; iBegin += iChunk) {
+			int iEnd = std::min(iBegin + iChunk, iNumRecordChannels);
+			try {
+				vThreads.push_back(std::thread(&DAFFReaderImpl::scanPeaks, this, iBegin, iEnd));
+			} catch (const std::system_error&) {
+				scanPeaks(iBegin, iEnd);  // No more threads available
+			}
+		}
 
-float DAFFReaderImpl::getAlphaStart() const
-{
-	assert(m_bDAFFObjectValid);
-	return m_pMainHeader->fAlphaStart;
-}
+		scanPeaks(0, std::min(iChunk, iNumRecordChannels));
 
-float DAFFReaderImpl::getAlphaEnd() const
-{
-	assert(m_bDAFFObjectValid);
-	return m_pMainHeader->fAlphaEnd;
-}
+		for (size_t i = 0; i < vThreads.size(); i++)
+			vThreads[i].join();
 
-float DAFFReaderImpl::getAlphaSpan() const
-{
-	assert(m_bDAFFObjectValid);
-	if (m_pMainHeader->fAlphaStart <= m_pMainHeader->fAlphaEnd)
-		return m_pMainHeader->fAlphaEnd - m_pMainHeader->fAlphaStart;
-	else  // wrap around 0&deg;
-		return 360 - m_pMainHeader->fAlphaStart + m_pMainHeader->fAlphaEnd;
-}
+		// Shared data is scanned once
+		for (int i = 0; i < iNumRecordChannels; i++)
+			m_vfRecordChannelPeaks[i] = m_vfRecordChannelPeaks[m_viPayloadIndices[i]];
+	}
 
-int DAFFReaderImpl::getBetaPoints() const
-{
-	assert(m_bDAFFObjectValid);
-	return m_pMainHeader->iBetaPoints;
+	m_vfChannelPeaks.assign(iNumChannels, 0.0f);
+	m_fOverallPeak = 0;
+	for (int i = 0; i < iNumRecordChannels; i++) {
+		float& fChannelPeak = m_vfChannelPeaks[i % iNumChannels];
+		fChannelPeak = std::max(fChannelPeak, m_vfRecordChannelPeaks[i]);
+		m_fOverallPeak = std::max(m_fOverallPeak, m_vfRecordChannelPeaks[i]);
+	}
+
+	m_bOverallPeakInitialized = true;
 }
 
-float DAFFReaderImpl::getBetaResolution() const
+void DAFFReaderImpl::scanPeaks(int iBegin, int iEnd) const
 {
-	assert(m_bDAFFObjectValid);
-	return m_fBetaResolution;
+	int iNumChannels = m_pMainHeader->iNumChannels;
+	for (int i = iBegin; i < iEnd; i++) {
+		if (m_viPayloadIndices[i] != i)
+			continue;
+
+		int iLength = m_viElementLengths[i];
+		std::unique_lock<std::mutex> lock = lockRecordCache();
+		const void* pData = getRecordChannelDataPtr(i / iNumChannels, i % iNumChannels);
+		if ((pData == NULL) || (iLength <= 0))
+			continue;
+
+		// Maximum absolute value directly on the stored samples
+		switch (m_iDataQuantization) {
+		case DAFF_INT16:
+			m_vfRecordChannelPeaks[i] = DAFF::peak_sint16((const short*)pData, iLength);
+			break;
+
+		case DAFF_INT16_BFP:
+			m_vfRecordChannelPeaks[i] = DAFF::peak_sint16((const short*)pData, iLength) * getBlockScale(i);
+			break;
+
+		case DAFF_INT24:
+			m_vfRecordChannelPeaks[i] = DAFF::peak_sint24(pData, iLength);
+			break;
+
+		case DAFF_FLOAT16:
+			m_vfRecordChannelPeaks[i] = DAFF::peak_half((const unsigned short*)pData, iLength);
+			break;
+
+		case DAFF_BFLOAT16:
+			m_vfRecordChannelPeaks[i] = DAFF::peak_bfloat16((const unsigned short*)pData, iLength);
+			break;
+
+		case DAFF_FLOAT32:
+			m_vfRecordChannelPeaks[i] = DAFF::peak_float((const float*)pData, iLength);
+			break;
+		}
+	}
 }
 
-float DAFFReaderImpl::getBetaStart() const
+int DAFFReaderImpl::getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const
 {
-	assert(m_bDAFFObjectValid);
-	return m_pMainHeader->fBetaStart;
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+
+	if ((m_pMainHeader->iContentType != DAFF_IMPULSE_RESPONSE) &&
+		(m_pMainHeader->iContentType != DAFF_MAGNITUDE_SPECTRUM))
+		return DAFF_MODAL_ERROR;
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return DAFF_INVALID_INDEX;
+
+	DAFFStatisticsEntry oEntry;
+	if (m_bStatisticsStored) {
+		oEntry = m_vStatistics[iRecordIndex * m_pMainHeader->iNumChannels + iChannel];
+	} else {
+		std::lock_guard<std::mutex> lock(m_mxStatistics);
+		if (m_vStatistics.empty())
+			initStatistics();  // lazy initialization
+		oEntry = m_vStatistics[iRecordIndex * m_pMainHeader->iNumChannels + iChannel];
+	}
+
+	oStats.fPeak = oEntry.fPeak;
+	oStats.fEnergy = oEntry.fEnergy;
+	oStats.fRMS = std::sqrt(oEntry.fEnergy / getStatisticsLength());
+	oStats.iOnset = oEntry.iOnset;
+
+	return DAFF_NO_ERROR;
 }
 
-float DAFFReaderImpl::getBetaEnd() const
+int DAFFReaderImpl::getStatisticsLength() const
 {
-	assert(m_bDAFFObjectValid);
-	return m_pMainHeader->fBetaEnd;
+	if (m_pMainHeader->iContentType == DAFF_MAGNITUDE_SPECTRUM)
+		return m_pContentHeaderMS->iNumFreqs;
+	return m_pMainHeader->iElementsPerRecord;
 }
 
-float DAFFReaderImpl::getBetaSpan() const
+void DAFFReaderImpl::initStatistics() const
 {
-	assert(m_bDAFFObjectValid);
-	return m_pMainHeader->fAlphaEnd - m_pMainHeader->fAlphaStart;
-}
+	int iNumChannels = m_pMainHeader->iNumChannels;
+	int iNumRecordChannels = m_pMainHeader->iNumRecords * iNumChannels;
+
+	std::vector<DAFFStatisticsEntry> vStatistics(iNumRecordChannels);
+
+	// Distribute large files over several threads, each scanning a range of record channels.
+	// Not with lazy loading, where the record cache is modified by every access.
+	int iNumThreads = 1;
+	if (!m_bLazyLoading) {
+		const uint64_t ui64MinSamplesPerThread = 1 << 18;
+		uint64_t ui64NumSamples = (uint64_t)iNumRecordChannels * getStatisticsLength();
+		uint64_t ui64MaxThreads = std::max(ui64NumSamples / ui64MinSamplesPerThread, (uint64_t)1);
+		iNumThreads = (int)std::min((uint64_t)std::max(std::thread::hardware_concurrency(), 1u), ui64MaxThreads);
+	}
 
-void DAFFReaderImpl::getDefaultOrientation(DAFFOrientationYPR& o) const
-{
-	assert(m_bDAFFObjectValid);
-	o = m_orientationDefault;
-}
+	std::vector<std::thread> vThreads;
+	int iChunk = (iNumRecordChannels + iNumThreads - 1) / iNumThreads;
+	for (int iBegin = iChunk; iBegin < iNumRecordChannels; iBegin += iChunk) {
+		int iEnd = std::min(iBegin + iChunk, iNumRecordChannels);
+		try {
+			vThreads.push_back(std::thread(&DAFFReaderImpl::scanStatistics, this, iBegin, iEnd, vStatistics.data()));
+		} catch (const std::system_error&) {
+			scanStatistics(iBegin, iEnd, vStatistics.data());  // No more threads available
+		}
+	}
 
-void DAFFReaderImpl::setDefaultOrientation()
-{
-	assert(m_bDAFFObjectValid);
-	m_tTrans.setOrientation(m_orientationDefault);
-}
+	scanStatistics(0, std::min(iChunk, iNumRecordChannels), vStatistics.data());
 
-void DAFFReaderImpl::getOrientation(DAFFOrientationYPR& o) const
-{
-	assert(m_bDAFFObjectValid);
-	m_tTrans.getOrientation(o);
-}
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
 
-void DAFFReaderImpl::setOrientation(const DAFFOrientationYPR& o)
-{
-	assert(m_bDAFFObjectValid);
-	m_tTrans.setOrientation(o);
+	// Shared data is scanned once, only the onset of impulse responses depends on the leading zeros
+	for (int i = 0; i < iNumRecordChannels; i++) {
+		int p = m_viPayloadIndices[i];
+		if (p == i)
+			continue;
+
+		DAFFStatisticsEntry& oEntry = vStatistics[i];
+		oEntry = vStatistics[p];
+		if ((m_pMainHeader->iContentType == DAFF_IMPULSE_RESPONSE) && (oEntry.iOnset >= 0)) {
+			oEntry.iOnset += m_viLeadingZeros[i] - m_viLeadingZeros[p];
+		}
+	}
+
+	m_vStatistics.swap(vStatistics);
 }
 
-bool DAFFReaderImpl::coversFullAlphaRange() const
+void DAFFReaderImpl::scanStatistics(int iBegin, int iEnd, DAFFStatisticsEntry* pStatistics) const
 {
-	assert(m_bDAFFObjectValid);
-	// full range coverage is given only when alphastart == 0 and alphaend == 360
-	if ((m_pMainHeader->fAlphaStart == 0) && (m_pMainHeader->fAlphaEnd == 360))
-		return true;
-	else
-		return false;
+	int iNumChannels = m_pMainHeader->iNumChannels;
+	int iLength = getStatisticsLength();
+
+	std::vector<float> vfData(iLength);
+	for (int i = iBegin; i < iEnd; i++) {
+		if (m_viPayloadIndices[i] != i)
+			continue;
+
+		DAFFStatisticsEntry& oEntry = pStatistics[i];
+		oEntry.fPeak = 0;
+		oEntry.fEnergy = 0;
+		oEntry.iOnset = -1;
+
+		// Full filter (including leading zeros) resp. all magnitudes
+		int iError;
+		{
+			std::unique_lock<std::mutex> lock = lockRecordCache();
+			iError = getRecordChannelData(i / iNumChannels, i % iNumChannels, vfData.data(), 1);
+		}
+		if (iError != DAFF_NO_ERROR)
+			continue;
+
+		oEntry.fPeak = DAFF::peak_float(vfData.data(), iLength);
+		oEntry.fEnergy = (float)DAFF::energy_float(vfData.data(), iLength);
+
+		// Onset: first value reaching -20 dB of the peak
+		if (oEntry.fPeak > 0) {
+			float fThreshold = 0.1f * oEntry.fPeak;
+			for (int k = 0; k < iLength; k++) {
+				if (std::fabs(vfData[k]) >= fThreshold) {
+					oEntry.iOnset = k;
+					break;
+				}
+			}
+		}
+	}
 }
 
-bool DAFFReaderImpl::coversFullBetaRange() const
+int DAFFReaderImpl::getSpectrumLength() const
 {
-	assert(m_bDAFFObjectValid);
-	// full range coverage is given only when betastart == 0 and betaend == 180
-	if ((m_pMainHeader->fBetaStart == 0) && (m_pMainHeader->fBetaEnd == 180))
-		return true;
-	else
-		return false;
+	switch (m_pMainHeader->iContentType) {
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return m_pContentHeaderMS->iNumFreqs;
+	case DAFF_PHASE_SPECTRUM:
+		return m_pContentHeaderPS->iNumFreqs;
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		return 2 * m_pContentHeaderMPS->iNumFreqs;
+	case DAFF_DFT_SPECTRUM:
+		return 2 * m_pContentHeaderDFT->iNumDFTCoeffs;
+	default:
+		return 0;
+	}
 }
 
-bool DAFFReaderImpl::coversFullSphere() const
+int DAFFReaderImpl::getSlice(int iChannel, int iSlice, int iWidth, float* pfDest) const
 {
-	assert(m_bDAFFObjectValid);
-	/*
-	if ( ((m_pMainHeader->fAlphaEnd - m_pMainHeader->fAlphaStart) >= (360.0f - getAlphaResolution()) &&
-	((m_pMainHeader->fBetaEnd - m_pMainHeader->fBetaStart) == 180.0f)) )
-	return true;
+	if ((iChannel < 0) || (iChannel >= m_pMainHeader->iNumChannels))
+		return DAFF_INVALID_INDEX;
 
-	return false;*/
-	return coversFullAlphaRange() && coversFullBetaRange();
-}
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
 
-DAFFReader* DAFFReaderImpl::getParent() const
-{
-	// We are the reader ourself!
-	// Logical constness here!
-	return const_cast<DAFFReaderImpl*>(this);
-}
+	int iNumRecords = m_pMainHeader->iNumRecords;
 
-void DAFFReaderImpl::getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex) const
-{
-	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+	if (m_bSlices) {
+		bool bAvailable;
+		{
+			std::lock_guard<std::mutex> lock(m_mxSlices);
+			if (m_vfSlices.empty())
+				initSlices();  // lazy initialization
+			bAvailable = !m_vfSlices.empty();
+		}
 
-	bool bDummy;
-	getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex, bDummy);
+		// Once built, the copy stays unchanged until the file is closed
+		if (bAvailable) {
+			size_t nOffset = ((size_t)iChannel * getSpectrumLength() + (size_t)iSlice * iWidth) * iNumRecords;
+			memcpy(pfDest, &m_vfSlices[nOffset], (size_t)iNumRecords * iWidth * sizeof(float));
+			return DAFF_NO_ERROR;
+		}
+	}
+
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	for (int i = 0; i < iNumRecords; i++) {
+		const void* pData = getRecordChannelDataPtr(i, iChannel);
+		if (pData == NULL)
+			return DAFF_FILE_CORRUPTED;
+
+		convertValues(getValuePtr(pData, iSlice * iWidth), iWidth, 1, pfDest + i * iWidth, 1);
+	}
+
+	return DAFF_NO_ERROR;
 }
 
-const DAFFMetadata* DAFFReaderImpl::getRecordMetadata(int iRecordIndex) const
+void DAFFReaderImpl::initSlices() const
 {
-	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	int iNumRecords = m_pMainHeader->iNumRecords;
+	size_t nSize = (size_t)m_pMainHeader->iNumChannels * getSpectrumLength() * iNumRecords;
+	if (nSize == 0)
+		return;
 
-	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords))
-		return m_pEmptyMetadata;
+	std::vector<float> vfSlices(nSize);
+
+	// Distribute large files over several threads, each transposing a range of records.
+	// Not with lazy loading, where the record cache is modified by every access.
+	int iNumThreads = 1;
+	if (!m_bLazyLoading) {
+		const uint64_t ui64MinValuesPerThread = 1 << 18;
+		uint64_t ui64MaxThreads = std::max((uint64_t)nSize / ui64MinValuesPerThread, (uint64_t)1);
+		iNumThreads = (int)std::min((uint64_t)std::max(std::thread::hardware_concurrency(), 1u), ui64MaxThreads);
+	}
+
+	std::vector<std::thread> vThreads;
+	int iChunk = (iNumRecords + iNumThreads - 1) / iNumThreads;
+	std::vector<int> viErrors((iNumRecords + iChunk - 1) / iChunk, DAFF_NO_ERROR);
+	for (int iBegin = iChunk; iBegin < iNumRecords; iBegin += iChunk) {
+		int iEnd = std::min(iBegin + iChunk, iNumRecords);
+		int* piError = &viErrors[iBegin / iChunk];
+		try {
+			vThreads.push_back(std::thread(&DAFFReaderImpl::scanSlices, this, iBegin, iEnd, vfSlices.data(), piError));
+		} catch (const std::system_error&) {
+			scanSlices(iBegin, iEnd, vfSlices.data(), piError);  // No more threads available
+		}
+	}
 
-	int iMetadataIndex = *getRecordMetadataIndexPtr(iRecordIndex);
+	scanSlices(0, std::min(iChunk, iNumRecords), vfSlices.data(), &viErrors[0]);
 
-	assert((iMetadataIndex >= -1) && (iMetadataIndex < (int)m_vpMetadata.size()));
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
 
-	if (iMetadataIndex == -1)
-		return m_pEmptyMetadata;
-	else
-		return m_vpMetadata[iMetadataIndex];
+	// Unreadable record data (lazy loading) leaves the copy empty, the slices are then read record by record
+	for (size_t i = 0; i < viErrors.size(); i++)
+		if (viErrors[i] != DAFF_NO_ERROR)
+			return;
+
+	m_vfSlices.swap(vfSlices);
 }
 
-int DAFFReaderImpl::getRecordCoords(int iRecordIndex, int iView, float& fAngle1, float& fAngle2) const
+void DAFFReaderImpl::scanSlices(int iBegin, int iEnd, float* pfSlices, int* piError) const
 {
-	assert((iRecordIndex >= 0) || (iRecordIndex < m_pMainHeader->iNumRecords));
-	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+	int iNumChannels = m_pMainHeader->iNumChannels;
+	int iNumRecords = m_pMainHeader->iNumRecords;
+	int iLength = getSpectrumLength();
+	int iWidth = (m_pMainHeader->iContentType == DAFF_DFT_SPECTRUM) ? 2 : 1;  // Complex values stay interleaved
+
+	for (int i = iBegin; i < iEnd; i++) {
+		for (int c = 0; c < iNumChannels; c++) {
+			std::unique_lock<std::mutex> lock = lockRecordCache();
+			const void* pData = getRecordChannelDataPtr(i, c);
+			if (pData == NULL) {
+				*piError = DAFF_FILE_CORRUPTED;
+				return;
+			}
 
-	// Invalid record index - projection to get a valid index
-	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords)) {
-		// TODO: Discuss if this makes sense
-		return -1;
+			// Value k * iWidth + j of the record goes to slice k at [record * iWidth + j]
+			float* pfDest = pfSlices + (size_t)c * iLength * iNumRecords + (size_t)i * iWidth;
+			for (int j = 0; j < iWidth; j++)
+				convertValues(getValuePtr(pData, j), iLength / iWidth, iWidth, pfDest + j, iWidth * iNumRecords);
+		}
 	}
+}
 
-	int iAlpha, iBeta;
-	float fAlpha, fBeta;
+int DAFFReaderImpl::getMagnitudes(int iRecordIndex, int iChannel, float* pfData) const
+{
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
 
-	bool bSouthPolePresent = false;
-	if (m_pMainHeader->fBetaStart == 0.0f)  // South pole present (single record here)
-		bSouthPolePresent = true;
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return DAFF_INVALID_INDEX;
 
-	if (bSouthPolePresent) {
-		if (iRecordIndex == 0) {  // Hit south pole
-			fAlpha = 0.0f;
-			fBeta = 0.0f;
-		} else {  // somewhere inside the grid (with single value at south pole)
-			iAlpha = (iRecordIndex - 1) % m_pMainHeader->iAlphaPoints;
-			iBeta = 1 + (int)((iRecordIndex - 1) / m_pMainHeader->iAlphaPoints);
-			fAlpha = m_pMainHeader->fAlphaStart + ((float)iAlpha * m_fAlphaResolution);
-			fBeta = (float)iBeta * m_fBetaResolution;
-		}
-	} else {  // somewhere inside the grid (without south pole present)
-		iAlpha = iRecordIndex % m_pMainHeader->iAlphaPoints;
-		iBeta = (int)(iRecordIndex / m_pMainHeader->iAlphaPoints);
-		fAlpha = m_pMainHeader->fAlphaStart + ((float)iAlpha * m_fAlphaResolution);
-		fBeta = m_pMainHeader->fBetaStart + ((float)iBeta * m_fBetaResolution);
-	}
+	if (pfData == NULL)
+		return DAFF_NO_ERROR;
 
-	if (iView == DAFF_DATA_VIEW) {
-		fAngle1 = fAlpha;
-		fAngle2 = fBeta;
-	} else {
-		transformAnglesD2O(fAlpha, fBeta, fAngle1, fAngle2);
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	const void* pData = getRecordChannelDataPtr(iRecordIndex, iChannel);
+	if (pData == NULL)
+		return DAFF_FILE_CORRUPTED;
+
+	switch (m_pMainHeader->iContentType) {
+	case DAFF_MAGNITUDE_SPECTRUM:
+		convertValues(pData, m_pContentHeaderMS->iNumFreqs, 1, pfData, 1);
+		break;
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		convertValues(pData, m_pContentHeaderMPS->iNumFreqs, 2, pfData, 1);
+		break;
+	default:
+		return DAFF_MODAL_ERROR;
 	}
 
-	return 0;
+	return DAFF_NO_ERROR;
 }
 
-void DAFFReaderImpl::getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex,
-										 bool& bOutOfBounds) const
+int DAFFReaderImpl::addMagnitudes(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
 {
-	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
 
-	float fAlpha;
-	float fBeta;
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return DAFF_INVALID_INDEX;
 
-	if (iView == DAFF_DATA_VIEW) {
-		fAlpha = fAngle1;
-		fBeta = fAngle2;
-	} else {
-		// Transform the coordinates into the DSC
-		transformAnglesO2D(fAngle1, fAngle2, fAlpha, fBeta);
-	}
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
 
-	// Normalize the direction
-	DAFFUtils::NormalizeDirection(DAFF_DATA_VIEW, fAlpha, fBeta, fAlpha, fBeta);
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	const void* pData = getRecordChannelDataPtr(iRecordIndex, iChannel);
+	if (pData == NULL)
+		return DAFF_FILE_CORRUPTED;
 
-	iRecordIndex = -1;
-	bOutOfBounds = false;
+	switch (m_pMainHeader->iContentType) {
+	case DAFF_MAGNITUDE_SPECTRUM:
+		convertValues(pData, m_pContentHeaderMS->iNumFreqs, 1, pfDest, 1, fGain, true);
+		break;
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		convertValues(pData, m_pContentHeaderMPS->iNumFreqs, 2, pfDest, 1, fGain, true);
+		break;
+	default:
+		return DAFF_MODAL_ERROR;
+	}
 
-	int iAlphaIndex, iBetaIndex;
+	return DAFF_NO_ERROR;
+}
 
-	if (m_pMainHeader->iAlphaPoints == 1) {
-		// Trivial case: Just one point
-		iAlphaIndex = 0;
-		bOutOfBounds = true;
-		if (fAlpha == m_pMainHeader->fAlphaStart && fAlpha == std::fmod(m_pMainHeader->fAlphaEnd, 360.0f))
-			bOutOfBounds = false;  // Direct hit
-	} else {
-		if ((fAlpha >= m_pMainHeader->fAlphaStart) && (fAlpha <= m_pMainHeader->fAlphaEnd)) {
-			// Within the covered alpha range
-			iAlphaIndex = (int)roundf((fAlpha - m_pMainHeader->fAlphaStart) / m_fAlphaResolution);
-		} else {
-			// Outside the covered alpha range
-			// Decide: Which is closer? Start boundary or end boundary?
-			if (DAFF::anglef_mindiff_abs_0_360_DEG(m_pMainHeader->fAlphaStart, fAlpha) <=
-				DAFF::anglef_mindiff_abs_0_360_DEG(m_pMainHeader->fAlphaEnd, fAlpha))
-				iAlphaIndex = 0;  // Start index
-			else
-				iAlphaIndex = (int)m_pMainHeader->iAlphaPoints - 1;  // End index
+int DAFFReaderImpl::getMagnitude(int iRecordIndex, int iChannel, int iFreqIndex, float& fMag) const
+{
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
 
-			bOutOfBounds = true;
-		}
-	}
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return DAFF_INVALID_INDEX;
 
-	if (m_pMainHeader->iBetaPoints == 1) {
-		// Trivial case: Just one point
-		iBetaIndex = 0;
-		bOutOfBounds = true;
-		if (fBeta == m_pMainHeader->fBetaEnd && fBeta == m_pMainHeader->fBetaStart)
-			bOutOfBounds = false;  // Direct hit
-	} else {
-		if ((fBeta >= m_pMainHeader->fBetaStart) && (fBeta <= m_pMainHeader->fBetaEnd)) {
-			// Within the covered beta range
-			iBetaIndex = (int)roundf((fBeta - m_pMainHeader->fBetaStart) / m_fBetaResolution);
-		} else {
-			// Outside the covered beta range
-			// Decide: Which is closer? Start boundary or end boundary?
-			if (std::abs(m_pMainHeader->fBetaStart - fBeta) <= std::abs(m_pMainHeader->fBetaEnd - fBeta))
-				iBetaIndex = 0;  // Start index
-			else
-				iBetaIndex = (int)m_pMainHeader->iBetaPoints - 1;  // End index
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	const void* pData = getRecordChannelDataPtr(iRecordIndex, iChannel);
+	if (pData == NULL)
+		return DAFF_FILE_CORRUPTED;
 
-			bOutOfBounds = true;
-		}
-	}
+	switch (m_pMainHeader->iContentType) {
+	case DAFF_MAGNITUDE_SPECTRUM:
+		if ((iFreqIndex < 0) || (iFreqIndex >= m_pContentHeaderMS->iNumFreqs))
+			return DAFF_INVALID_INDEX;
 
-	// Calculate index
-	if (m_pMainHeader->fBetaStart == 0.0f) {  // South pole present: increment by one (single record at poles)
-		if (iBetaIndex == 0) {                // Hit south pole
-			iRecordIndex = 0;
-		} else {
-			if ((iBetaIndex == m_pMainHeader->iBetaPoints - 1) &&
-				(m_pMainHeader->fBetaEnd == 180.0f))  // Hit north pole
-				iRecordIndex = 1 + (iBetaIndex - 1) * m_pMainHeader->iAlphaPoints;
-			else
-				iRecordIndex = 1 + (iBetaIndex - 1) * m_pMainHeader->iAlphaPoints + iAlphaIndex;
-		}
-	} else {
-		if ((iBetaIndex == m_pMainHeader->iBetaPoints - 1) && (m_pMainHeader->fBetaEnd == 180.0f))  // Hit north pole
-			iRecordIndex = iBetaIndex * m_pMainHeader->iAlphaPoints;
-		else
-			iRecordIndex = iBetaIndex * m_pMainHeader->iAlphaPoints + iAlphaIndex;
+		convertValues(getValuePtr(pData, iFreqIndex), 1, 1, &fMag, 1);
+		break;
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		if ((iFreqIndex < 0) || (iFreqIndex >= m_pContentHeaderMPS->iNumFreqs))
+			return DAFF_INVALID_INDEX;
+
+		convertValues(getValuePtr(pData, 2 * iFreqIndex), 1, 1, &fMag, 1);
+		break;
+	default:
+		return DAFF_MODAL_ERROR;
 	}
 
-	return;
+	return DAFF_NO_ERROR;
 }
 
-void DAFFReaderImpl::getCell(int iView, const float fAngle1, const float fAngle2, DAFFQuad& qIndices) const
+int DAFFReaderImpl::getMagnitudeSlice(int iChannel, int iFreqIndex, float* pfDest) const
 {
-	// switch to data view
-	float fAlpha = fAngle1;
-	float fBeta = fAngle2;
-	if (iView == DAFF_OBJECT_VIEW)
-		transformAnglesO2D(fAngle1, fAngle2, fAlpha, fBeta);
-	DAFFUtils::NormalizeDirection(DAFF_DATA_VIEW, fAlpha, fBeta, fAlpha, fBeta);
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
 
-	// south pole with full sphere covered is a problem (but algorithm holds for north pole)
-	if (fBeta == 0.0f && coversFullSphere()) {  // return the south pole 4 times
-		getNearestNeighbour(DAFF_DATA_VIEW, 0.0f, 0.0f, qIndices.iIndex1);
-		qIndices.iIndex2 = qIndices.iIndex1;
-		qIndices.iIndex3 = qIndices.iIndex1;
-		qIndices.iIndex4 = qIndices.iIndex1;
-		return;
-	}
+	switch (m_pMainHeader->iContentType) {
+	case DAFF_MAGNITUDE_SPECTRUM:
+		if ((iFreqIndex < 0) || (iFreqIndex >= m_pContentHeaderMS->iNumFreqs))
+			return DAFF_INVALID_INDEX;
 
-	// grid angles
-	float fAlpha1 = 0, fAlpha2 = 0, fAlpha3 = 0, fAlpha4 = 0;
-	float fBeta1 = 0, fBeta2 = 0, fBeta3 = 0, fBeta4 = 0;
+		return getSlice(iChannel, iFreqIndex, 1, pfDest);
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		if ((iFreqIndex < 0) || (iFreqIndex >= m_pContentHeaderMPS->iNumFreqs))
+			return DAFF_INVALID_INDEX;
 
-	fAlpha1 = fAlpha - fmodf(fAlpha, getAlphaResolution());
-	fAlpha2 = fAlpha1;
-	fAlpha3 = fAlpha + getAlphaResolution() - fmodf(fAlpha, getAlphaResolution());
-	fAlpha4 = fAlpha3;
+		return getSlice(iChannel, 2 * iFreqIndex, 1, pfDest);
+	default:
+		return DAFF_MODAL_ERROR;
+	}
+}
 
-	fBeta1 = fBeta - fmodf(fBeta, getBetaResolution());
-	fBeta2 = fBeta + getBetaResolution() - fmodf(fBeta, getBetaResolution());
-	fBeta3 = fBeta2;
-	fBeta4 = fBeta1;
+const float* DAFFReaderImpl::getMagnitudesPtr(int iRecordIndex, int iChannel) const
+{
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
 
-	// Upper beta angles are not allowed to overrun the north pole
-	if (fBeta2 > 180.0f) {
-		fBeta2 = 180.0f;
-		fBeta3 = 180.0f;
-	}
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return NULL;
 
-	// Normalize & get indices
-	DAFFUtils::NormalizeDirection(DAFF_DATA_VIEW, fAlpha1, fBeta1, fAlpha1, fBeta1);
-	DAFFUtils::NormalizeDirection(DAFF_DATA_VIEW, fAlpha2, fBeta2, fAlpha2, fBeta2);
-	DAFFUtils::NormalizeDirection(DAFF_DATA_VIEW, fAlpha3, fBeta3, fAlpha3, fBeta3);
-	DAFFUtils::NormalizeDirection(DAFF_DATA_VIEW, fAlpha4, fBeta4, fAlpha4, fBeta4);
+	// Magnitude-phase spectra are stored interleaved, no direct access (neither without sample type conversion)
+	if ((m_pMainHeader->iContentType != DAFF_MAGNITUDE_SPECTRUM) || (m_iDataQuantization != DAFF_FLOAT32))
+		return NULL;
 
-	getNearestNeighbour(DAFF_DATA_VIEW, fAlpha1, fBeta1, qIndices.iIndex1);
-	getNearestNeighbour(DAFF_DATA_VIEW, fAlpha2, fBeta2, qIndices.iIndex2);
-	getNearestNeighbour(DAFF_DATA_VIEW, fAlpha3, fBeta3, qIndices.iIndex3);
-	getNearestNeighbour(DAFF_DATA_VIEW, fAlpha4, fBeta4, qIndices.iIndex4);
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	return (const float*)getRecordChannelDataPtr(iRecordIndex, iChannel);
 }
 
-void DAFFReaderImpl::transformAnglesD2O(const float fAlpha, const float fBeta, float& fAzimuth, float& fElevation) const
+int DAFFReaderImpl::getPhases(int iRecordIndex, int iChannel, float* pfData) const
 {
-	m_tTrans.transformDSC2OSC(fAlpha, fBeta, fAzimuth, fElevation);
-}
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
 
-void DAFFReaderImpl::transformAnglesO2D(const float fAzimuth, const float fElevation, float& fAlpha, float& fBeta) const
-{
-	m_tTrans.transformOSC2DSC(fAzimuth, fElevation, fAlpha, fBeta);
-}
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return DAFF_INVALID_INDEX;
 
-double DAFFReaderImpl::getSamplerate() const
-{
-	if (m_pMainHeader->iContentType == DAFF_IMPULSE_RESPONSE)
-		return m_pContentHeaderIR->fSamplerate;
-	if (m_pMainHeader->iContentType == DAFF_DFT_SPECTRUM)
-		return m_pContentHeaderDFT->fSamplerate;
-	return 0;  // error
-}
+	if (pfData == NULL)
+		return DAFF_NO_ERROR;
 
-int DAFFReaderImpl::getFilterLength() const
-{
-	return m_pMainHeader->iElementsPerRecord;
-}
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	const void* pData = getRecordChannelDataPtr(iRecordIndex, iChannel);
+	if (pData == NULL)
+		return DAFF_FILE_CORRUPTED;
 
-int DAFFReaderImpl::getMinEffectiveFilterOffset() const
-{
-	return m_pContentHeaderIR->iMinFilterOffset;
+	switch (m_pMainHeader->iContentType) {
+	case DAFF_PHASE_SPECTRUM:
+		convertValues(pData, m_pContentHeaderPS->iNumFreqs, 1, pfData, 1);
+		break;
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		convertValues(getValuePtr(pData, 1), m_pContentHeaderMPS->iNumFreqs, 2, pfData, 1);
+		break;
+	default:
+		return DAFF_MODAL_ERROR;
+	}
+	return DAFF_NO_ERROR;
 }
 
-int DAFFReaderImpl::getMaxEffectiveFilterLength() const
+int DAFFReaderImpl::getPhase(int iRecordIndex, int iChannel, int iFreqIndex, float& fPhase) const
 {
-	return m_pContentHeaderIR->iMaxEffectiveFilterLength;
-}
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
 
-int DAFFReaderImpl::getFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
-{
-	int iOffset;
-	int iEffectiveLength;
-	int iError;
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return DAFF_INVALID_INDEX;
 
-	iError = getEffectiveFilterBounds(iRecordIndex, iChannel, iOffset, iEffectiveLength);
-	if (iError != DAFF_NO_ERROR)
-		return iError;
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	const void* pData = getRecordChannelDataPtr(iRecordIndex, iChannel);
+	if (pData == NULL)
+		return DAFF_FILE_CORRUPTED;
 
-	// Place zeros before the data
-	for (int i = 0; i < iOffset; i++)
-		pfDest[i] = 0;
+	switch (m_pMainHeader->iContentType) {
+	case DAFF_PHASE_SPECTRUM:
+		if ((iFreqIndex < 0) || (iFreqIndex >= m_pContentHeaderPS->iNumFreqs))
+			return DAFF_INVALID_INDEX;
 
-	// Insert the data
-	iError = getEffectiveFilterCoeffs(iRecordIndex, iChannel, pfDest + iOffset, fGain);
-	if (iError != DAFF_NO_ERROR)
-		return iError;
+		convertValues(getValuePtr(pData, iFreqIndex), 1, 1, &fPhase, 1);
+		break;
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		if ((iFreqIndex < 0) || (iFreqIndex >= m_pContentHeaderMPS->iNumFreqs))
+			return DAFF_INVALID_INDEX;
 
-	// Place zeros behind the data
-	for (int i = iOffset + iEffectiveLength; i < getFilterLength(); i++)
-		pfDest[i] = 0;
+		convertValues(getValuePtr(pData, 2 * iFreqIndex + 1), 1, 1, &fPhase, 1);
+		break;
+	default:
+		return DAFF_MODAL_ERROR;
+	}
 
 	return DAFF_NO_ERROR;
 }
 
-int DAFFReaderImpl::addFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
+int DAFFReaderImpl::getPhaseSlice(int iChannel, int iFreqIndex, float* pfDest) const
 {
-	int iOffset;
-	int iEffectiveLength;
-	int iError;
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
 
-	iError = getEffectiveFilterBounds(iRecordIndex, iChannel, iOffset, iEffectiveLength);
-	if (iError != DAFF_NO_ERROR)
-		return iError;
+	switch (m_pMainHeader->iContentType) {
+	case DAFF_PHASE_SPECTRUM:
+		if ((iFreqIndex < 0) || (iFreqIndex >= m_pContentHeaderPS->iNumFreqs))
+			return DAFF_INVALID_INDEX;
 
-	// Insert the data
-	iError = addEffectiveFilterCoeffs(iRecordIndex, iChannel, pfDest + iOffset, fGain);
-	if (iError != DAFF_NO_ERROR)
-		return iError;
+		return getSlice(iChannel, iFreqIndex, 1, pfDest);
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		if ((iFreqIndex < 0) || (iFreqIndex >= m_pContentHeaderMPS->iNumFreqs))
+			return DAFF_INVALID_INDEX;
 
-	return DAFF_NO_ERROR;
+		return getSlice(iChannel, 2 * iFreqIndex + 1, 1, pfDest);
+	default:
+		return DAFF_MODAL_ERROR;
+	}
 }
 
-int DAFFReaderImpl::getEffectiveFilterBounds(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const
+const float* DAFFReaderImpl::getPhasesPtr(int iRecordIndex, int iChannel) const
 {
 	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
 	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
 
 	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
 		(iChannel >= m_pMainHeader->iNumChannels))
-		return DAFF_INVALID_INDEX;
+		return NULL;
 
-	DAFFRecordChannelDescIR* pDesc =
-		reinterpret_cast<DAFFRecordChannelDescIR*>(getRecordChannelDescPtr(iRecordIndex, iChannel));
-	iOffset = pDesc->iLeadingZeros;
-	iLength = pDesc->iElementLength;
+	// Magnitude-phase spectra are stored interleaved, no direct access (neither without sample type conversion)
+	if ((m_pMainHeader->iContentType != DAFF_PHASE_SPECTRUM) || (m_iDataQuantization != DAFF_FLOAT32))
+		return NULL;
 
-	return DAFF_NO_ERROR;
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	return (const float*)getRecordChannelDataPtr(iRecordIndex, iChannel);
 }
 
-int DAFFReaderImpl::getEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
+int DAFFReaderImpl::getCoefficientsMP(int iRecordIndex, int iChannel, float* pfDest) const
 {
 	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+
+	return getCoefficientsMP(&iRecordIndex, 1, iChannel, pfDest);
+}
+
+int DAFFReaderImpl::getCoefficientsMP(const int* piRecordIndices, int iNumRecords, int iChannel, float* pfDest) const
+{
 	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
 
-	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
-		(iChannel >= m_pMainHeader->iNumChannels))
+	int iNumValues;
+	switch (m_pMainHeader->iContentType) {
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		iNumValues = 2 * m_pContentHeaderMPS->iNumFreqs;
+		break;
+	case DAFF_DFT_SPECTRUM:
+		iNumValues = 2 * m_pContentHeaderDFT->iNumDFTCoeffs;
+		break;
+	default:
+		return DAFF_MODAL_ERROR;
+	}
+
+	if ((iChannel < 0) || (iChannel >= m_pMainHeader->iNumChannels) || (iNumRecords < 0))
 		return DAFF_INVALID_INDEX;
+	for (int i = 0; i < iNumRecords; i++)
+		if ((piRecordIndices[i] < 0) || (piRecordIndices[i] >= m_pMainHeader->iNumRecords))
+			return DAFF_INVALID_INDEX;
 
 	if (pfDest == NULL)
 		return DAFF_NO_ERROR;
 
-	DAFFRecordChannelDescIR* pDesc =
-		reinterpret_cast<DAFFRecordChannelDescIR*>(getRecordChannelDescPtr(iRecordIndex, iChannel));
-	// Check data offset for buffer overruns
-	assert(pDesc->ui64DataOffset < m_pDataFileBlock->ui64Size);
-	void* pData = reinterpret_cast<char*>(m_pDataBlock) + pDesc->ui64DataOffset;
+	{
+		std::unique_lock<std::mutex> lock = lockRecordCache();
 
-	// Data type conversion
-	switch (m_pMainHeader->iQuantization) {
-	case DAFF_INT16:
-		DAFF::stc_sint16_to_float(pfDest, (const short*)pData, pDesc->iElementLength, 1, 1, fGain);
-		break;
+		// Lazy loading: The records missing in the cache are read in batches
+		if (m_bLazyLoading && (iNumRecords > 1)) {
+			std::vector<int> viRecordChannels(iNumRecords);
+			for (int i = 0; i < iNumRecords; i++)
+				viRecordChannels[i] = piRecordIndices[i] * m_pMainHeader->iNumChannels + iChannel;
+			loadRecordChannels(viRecordChannels.data(), viRecordChannels.size());
+		}
 
-	case DAFF_INT24:
-		DAFF::stc_sint24_to_float(pfDest, pData, pDesc->iElementLength, 1, 1, fGain);
-		break;
+		for (int i = 0; i < iNumRecords; i++) {
+			const void* pData = getRecordChannelDataPtr(piRecordIndices[i], iChannel);
+			if (pData == NULL)
+				return DAFF_FILE_CORRUPTED;
 
-	case DAFF_FLOAT32:
-		if (fGain == 1) {  // Direct copy
-			memcpy(pfDest, pData, pDesc->iElementLength * sizeof(float));
-		} else {
-			// Copy with gain multiplication
-			float* pfData = (float*)pData;
-			for (int i = 0; i < pDesc->iElementLength; i++)
-				pfDest[i] = pfData[i] * fGain;
+			convertValues(pData, iNumValues, 1, pfDest + (size_t)i * iNumValues, 1);
 		}
-		break;
 	}
 
+	// Conversion in place, all records at once
+	DAFF::cart2polar_float(pfDest, pfDest, (size_t)iNumRecords * iNumValues / 2);
+
 	return DAFF_NO_ERROR;
 }
 
-int DAFFReaderImpl::addEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
+int DAFFReaderImpl::getCoefficientsRI(int iRecordIndex, int iChannel, float* pfDest) const
 {
 	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
 	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
@@ -1419,85 +5658,114 @@ int DAFFReaderImpl::addEffectiveFilterCoeffs(int iRecordIndex, int iChannel, flo
 	if (pfDest == NULL)
 		return DAFF_NO_ERROR;
 
-	DAFFRecordChannelDescIR* pDesc =
-		reinterpret_cast<DAFFRecordChannelDescIR*>(getRecordChannelDescPtr(iRecordIndex, iChannel));
-	// Check data offset for buffer overruns
-	assert(pDesc->ui64DataOffset < m_pDataFileBlock->ui64Size);
-	void* pData = reinterpret_cast<char*>(m_pDataBlock) + pDesc->ui64DataOffset;
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	const void* pData = getRecordChannelDataPtr(iRecordIndex, iChannel);
+	if (pData == NULL)
+		return DAFF_FILE_CORRUPTED;
+	convertValues(pData, 2 * m_pContentHeaderMPS->iNumFreqs, 1, pfDest, 1);
 
-	// Data type conversion
-	switch (m_pMainHeader->iQuantization) {
-	case DAFF_INT16:
-		DAFF::stc_sint16_to_float_add(pfDest, (const short*)pData, pDesc->iElementLength, 1, 1, fGain);
-		break;
+	return DAFF_NO_ERROR;
+}
 
-	case DAFF_INT24:
-		DAFF::stc_sint24_to_float_add(pfDest, pData, pDesc->iElementLength, 1, 1, fGain);
-		break;
+int DAFFReaderImpl::getTransformSize() const
+{
+	return m_pContentHeaderDFT->iTransformSize;
+}
 
-	case DAFF_FLOAT32:
-		float* pfData = (float*)pData;
-		for (int i = 0; i < pDesc->iElementLength; i++)
-			pfDest[i] += pfData[i] * fGain;
-		break;
-	}
+int DAFFReaderImpl::getNumDFTCoeffs() const
+{
+	return m_pContentHeaderDFT->iNumDFTCoeffs;
+}
 
-	return DAFF_NO_ERROR;
+bool DAFFReaderImpl::isSymmetric() const
+{
+	return (m_pContentHeaderDFT->iNumDFTCoeffs != m_pContentHeaderDFT->iTransformSize);
 }
 
-int DAFFReaderImpl::getNumFrequencies() const
+double DAFFReaderImpl::getFrequencyBandwidth() const
 {
-	switch (m_pMainHeader->iContentType) {
-	case DAFF_MAGNITUDE_SPECTRUM:
-		return m_pContentHeaderMS->iNumFreqs;
-	case DAFF_PHASE_SPECTRUM:
-		return m_pContentHeaderPS->iNumFreqs;
-	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
-		return m_pContentHeaderMPS->iNumFreqs;
-	}
-	return 0;  // error!
+	return getSamplerate() / (double)getTransformSize();
 }
 
-const std::vector<float>& DAFFReaderImpl::getFrequencies() const
+int DAFFReaderImpl::getDFTCoeff(int iRecordIndex, int iChannel, int iDFTCoeff, float& fReal, float& fImag) const
 {
-	return m_vfFreqs;
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+	assert((iDFTCoeff >= 0) && (iDFTCoeff < m_pContentHeaderDFT->iTransformSize));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels) || (iDFTCoeff < 0) ||
+		(iDFTCoeff >= m_pContentHeaderDFT->iTransformSize))
+		return DAFF_INVALID_INDEX;
+
+	// Coefficients beyond the stored half of symmetric spectra: X[N-k] = conj(X[k])
+	bool bConjugate = (iDFTCoeff >= m_pContentHeaderDFT->iNumDFTCoeffs);
+	if (bConjugate)
+		iDFTCoeff = m_pContentHeaderDFT->iTransformSize - iDFTCoeff;
+
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	const void* pData = getRecordChannelDataPtr(iRecordIndex, iChannel);
+	if (pData == NULL)
+		return DAFF_FILE_CORRUPTED;
+
+	convertValues(getValuePtr(pData, 2 * iDFTCoeff + 0), 1, 1, &fReal, 1);
+	convertValues(getValuePtr(pData, 2 * iDFTCoeff + 1), 1, 1, &fImag, 1);
+	if (bConjugate)
+		fImag = -fImag;
+
+	return DAFF_NO_ERROR;
 }
 
-float DAFFReaderImpl::getOverallMagnitudeMaximum() const
+int DAFFReaderImpl::getDFTCoeffs(int iRecordIndex, int iChannel, float* pfDest) const
 {
-	switch (m_pMainHeader->iContentType) {
-	case DAFF_MAGNITUDE_SPECTRUM:
-		return m_pContentHeaderMS->fMax;
-	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
-		return m_pContentHeaderMPS->fMax;
-	case DAFF_DFT_SPECTRUM:
-		return m_pContentHeaderDFT->fMax;
-	}
-	return 0.0;  // error!
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
+		(iChannel >= m_pMainHeader->iNumChannels))
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	const void* pData = getRecordChannelDataPtr(iRecordIndex, iChannel);
+	if (pData == NULL)
+		return DAFF_FILE_CORRUPTED;
+	convertValues(pData, 2 * m_pContentHeaderDFT->iNumDFTCoeffs, 1, pfDest, 1);
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::getDFTCoeffsFull(int iRecordIndex, int iChannel, float* pfDest) const
+{
+	int iError = getDFTCoeffs(iRecordIndex, iChannel, pfDest);
+	if ((iError != DAFF_NO_ERROR) || (pfDest == NULL))
+		return iError;
+
+	// Mirror the stored coefficients 1 ... N-K (without DC and Nyquist) behind the stored ones
+	int K = m_pContentHeaderDFT->iNumDFTCoeffs;
+	int N = m_pContentHeaderDFT->iTransformSize;
+	if (K < N)
+		DAFF::conj_mirror_float(pfDest + 2 * K, pfDest + 2, N - K);
+
+	return DAFF_NO_ERROR;
 }
 
-float DAFFReaderImpl::getOverallPeak()
-{
-	if (!m_bOverallPeakInitialized) {
-		// lazy initialization
-		float* pBuf;
-		int iOffs = 0, iLen = 0, iSize = getMaxEffectiveFilterLength();
-		pBuf = new float[iSize];
-		for (int i = 0; i < m_pMainHeader->iNumRecords; i++)
-			for (int j = 0; j < m_pMainHeader->iNumChannels; j++) {
-				getEffectiveFilterCoeffs(i, j, pBuf);
-				getEffectiveFilterBounds(i, j, iOffs, iLen);
-				for (int k = 0; k < iLen - iOffs; k++)
-					if (fabs(pBuf[k]) > m_fOverallPeak)
-						m_fOverallPeak = fabs(pBuf[k]);
-			}
-		delete pBuf;
-		m_bOverallPeakInitialized = true;
-	}
-	return m_fOverallPeak;
+int DAFFReaderImpl::getDFTCoeffSlice(int iChannel, int iDFTCoeff, float* pfDest) const
+{
+	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+
+	if (m_pMainHeader->iContentType != DAFF_DFT_SPECTRUM)
+		return DAFF_MODAL_ERROR;
+
+	if ((iDFTCoeff < 0) || (iDFTCoeff >= m_pContentHeaderDFT->iNumDFTCoeffs))
+		return DAFF_INVALID_INDEX;
+
+	return getSlice(iChannel, iDFTCoeff, 2, pfDest);
 }
 
-int DAFFReaderImpl::getMagnitudes(int iRecordIndex, int iChannel, float* pfData) const
+int DAFFReaderImpl::addDFTCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
 {
 	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
 	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
@@ -1506,249 +5774,620 @@ int DAFFReaderImpl::getMagnitudes(int iRecordIndex, int iChannel, float* pfData)
 		(iChannel >= m_pMainHeader->iNumChannels))
 		return DAFF_INVALID_INDEX;
 
-	if (pfData == NULL)
+	if (pfDest == NULL)
 		return DAFF_NO_ERROR;
 
-	DAFFRecordChannelDescDefault* pDesc =
-		reinterpret_cast<DAFFRecordChannelDescDefault*>(getRecordChannelDescPtr(iRecordIndex, iChannel));
-	float* pfSrc = 0;
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	const void* pData = getRecordChannelDataPtr(iRecordIndex, iChannel);
+	if (pData == NULL)
+		return DAFF_FILE_CORRUPTED;
 
-	switch (m_pMainHeader->iContentType) {
-	case DAFF_MAGNITUDE_SPECTRUM:
-		pfSrc = reinterpret_cast<float*>(reinterpret_cast<char*>(m_pDataBlock) + pDesc->ui64DataOffset);
-		memcpy(pfData, pfSrc, m_pContentHeaderMS->iNumFreqs * sizeof(float));
-		break;
-	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
-		pfSrc = reinterpret_cast<float*>(reinterpret_cast<char*>(m_pDataBlock) + pDesc->ui64DataOffset);
-		// TODO: maybe find a better way to do this
-		for (int i = 0; i <= m_pContentHeaderMPS->iNumFreqs; i++)
-			pfData[i] = pfSrc[2 * i];
-		break;
-	default:
-		return DAFF_MODAL_ERROR;
-	}
+	convertValues(pData, 2 * m_pContentHeaderDFT->iNumDFTCoeffs, 1, pfDest, 1, fGain, true);
 
 	return DAFF_NO_ERROR;
 }
 
-int DAFFReaderImpl::getMagnitude(int iRecordIndex, int iChannel, int iFreqIndex, float& fMag) const
+const float* DAFFReaderImpl::getDFTCoeffsPtr(int iRecordIndex, int iChannel) const
 {
 	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
 	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
 
 	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
 		(iChannel >= m_pMainHeader->iNumChannels))
-		return DAFF_INVALID_INDEX;
+		return NULL;
 
-	DAFFRecordChannelDescDefault* pDesc =
-		reinterpret_cast<DAFFRecordChannelDescDefault*>(getRecordChannelDescPtr(iRecordIndex, iChannel));
-	float* pfSrc = NULL;
+	// Direct access is only possible without sample type conversion
+	if ((m_pMainHeader->iContentType != DAFF_DFT_SPECTRUM) || (m_iDataQuantization != DAFF_FLOAT32))
+		return NULL;
 
-	switch (m_pMainHeader->iContentType) {
-	case DAFF_MAGNITUDE_SPECTRUM:
-		if ((iFreqIndex < 0) || (iFreqIndex >= m_pContentHeaderMS->iNumFreqs))
-			return DAFF_INVALID_INDEX;
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	return (const float*)getRecordChannelDataPtr(iRecordIndex, iChannel);
+}
 
-		pfSrc = reinterpret_cast<float*>(reinterpret_cast<char*>(m_pDataBlock) + pDesc->ui64DataOffset);
-		fMag = pfSrc[iFreqIndex];
-		break;
-	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
-		if ((iFreqIndex < 0) || (iFreqIndex >= m_pContentHeaderMPS->iNumFreqs))
-			return DAFF_INVALID_INDEX;
+int DAFFReaderImpl::getRecord(int iRecordIndex, float** ppfChannelDest) const
+{
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
 
-		pfSrc = reinterpret_cast<float*>(reinterpret_cast<char*>(m_pDataBlock) + pDesc->ui64DataOffset);
-		fMag = pfSrc[2 * iFreqIndex];
-		break;
-	default:
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords))
+		return DAFF_INVALID_INDEX;
+
+	if (m_pMainHeader->iContentType == DAFF_MAGNITUDE_PHASE_SPECTRUM)
 		return DAFF_MODAL_ERROR;
+
+	if (ppfChannelDest == NULL)
+		return DAFF_NO_ERROR;
+
+	// DFT coefficients are complex values
+	int iElementSize = (m_pMainHeader->iContentType == DAFF_DFT_SPECTRUM ? 2 : 1);
+
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	loadRecordChannelsOfRecord(iRecordIndex);
+	for (int iChannel = 0; iChannel < m_pMainHeader->iNumChannels; iChannel++) {
+		if (ppfChannelDest[iChannel] == NULL)
+			continue;
+
+		int iError = getRecordChannelData(iRecordIndex, iChannel, ppfChannelDest[iChannel], iElementSize);
+		if (iError != DAFF_NO_ERROR)
+			return iError;
 	}
 
 	return DAFF_NO_ERROR;
 }
 
-int DAFFReaderImpl::getPhases(int iRecordIndex, int iChannel, float* pfData) const
+int DAFFReaderImpl::getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const
 {
 	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
-	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
 
-	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
-		(iChannel >= m_pMainHeader->iNumChannels))
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords))
 		return DAFF_INVALID_INDEX;
 
-	if (pfData == NULL)
+	if (m_pMainHeader->iContentType == DAFF_MAGNITUDE_PHASE_SPECTRUM)
+		return DAFF_MODAL_ERROR;
+
+	// DFT coefficients are complex values
+	int iElementSize = (m_pMainHeader->iContentType == DAFF_DFT_SPECTRUM ? 2 : 1);
+
+	assert(iStride >= m_pMainHeader->iNumChannels * iElementSize);
+	if (iStride < m_pMainHeader->iNumChannels * iElementSize)
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest == NULL)
 		return DAFF_NO_ERROR;
 
-	DAFFRecordChannelDescDefault* pDesc =
-		reinterpret_cast<DAFFRecordChannelDescDefault*>(getRecordChannelDescPtr(iRecordIndex, iChannel));
-	float* pfSrc = 0;
+	std::unique_lock<std::mutex> lock = lockRecordCache();
+	loadRecordChannelsOfRecord(iRecordIndex);
+	for (int iChannel = 0; iChannel < m_pMainHeader->iNumChannels; iChannel++) {
+		int iError = getRecordChannelData(iRecordIndex, iChannel, pfDest + iChannel * iElementSize, iStride);
+		if (iError != DAFF_NO_ERROR)
+			return iError;
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFReaderImpl::getRecordChannelData(int iRecord, int iChannel, float* pfDest, int iStride) const
+{
+	const void* pData = getRecordChannelDataPtr(iRecord, iChannel);
+	if (pData == NULL)
+		return DAFF_FILE_CORRUPTED;
+
+	int iLength;
 
 	switch (m_pMainHeader->iContentType) {
-	case DAFF_PHASE_SPECTRUM:
-		pfSrc = reinterpret_cast<float*>(reinterpret_cast<char*>(m_pDataBlock) + pDesc->ui64DataOffset);
-		memcpy(pfData, pfSrc, m_pContentHeaderPS->iNumFreqs * sizeof(float));
+	case DAFF_IMPULSE_RESPONSE: {
+		size_t n = (size_t)iRecord * m_pMainHeader->iNumChannels + iChannel;
+		int iOffset = m_viLeadingZeros[n];
+		int iEffectiveLength = m_viElementLengths[n];
+
+		// Place zeros before and behind the data
+		for (int i = 0; i < iOffset; i++)
+			pfDest[i * iStride] = 0;
+		for (int i = iOffset + iEffectiveLength; i < m_pMainHeader->iElementsPerRecord; i++)
+			pfDest[i * iStride] = 0;
+
+		// Insert the data
+		convertValues(pData, iEffectiveLength, 1, pfDest + iOffset * iStride, iStride, getBlockScale(n));
+		return DAFF_NO_ERROR;
+	}
+
+	case DAFF_MAGNITUDE_SPECTRUM:
+		iLength = m_pContentHeaderMS->iNumFreqs;
 		break;
-	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
-		pfSrc = reinterpret_cast<float*>(reinterpret_cast<char*>(m_pDataBlock) + pDesc->ui64DataOffset);
-		for (int i = 0; i <= m_pContentHeaderMPS->iNumFreqs; i++)
-			pfData[i] = pfSrc[2 * i + 1];
+
+	case DAFF_PHASE_SPECTRUM:
+		iLength = m_pContentHeaderPS->iNumFreqs;
 		break;
+
+	case DAFF_DFT_SPECTRUM:
+		if (iStride == 2) {
+			convertValues(pData, 2 * m_pContentHeaderDFT->iNumDFTCoeffs, 1, pfDest, 1);
+		} else {
+			// Real and imaginary parts
+			convertValues(pData, m_pContentHeaderDFT->iNumDFTCoeffs, 2, pfDest, iStride);
+			convertValues(getValuePtr(pData, 1), m_pContentHeaderDFT->iNumDFTCoeffs, 2, pfDest + 1, iStride);
+		}
+		return DAFF_NO_ERROR;
+
 	default:
 		return DAFF_MODAL_ERROR;
 	}
+
+	// Real-valued spectra
+	convertValues(pData, iLength, 1, pfDest, iStride);
+
 	return DAFF_NO_ERROR;
 }
 
-int DAFFReaderImpl::getPhase(int iRecordIndex, int iChannel, int iFreqIndex, float& fPhase) const
+float DAFFReaderImpl::getBlockScale(size_t n) const
 {
-	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
-	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+	return m_vfBlockScales.empty() ? 1.0f : m_vfBlockScales[n];
+}
 
-	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
-		(iChannel >= m_pMainHeader->iNumChannels))
-		return DAFF_INVALID_INDEX;
+const void* DAFFReaderImpl::getValuePtr(const void* pData, int iIndex) const
+{
+	return (const char*)pData + (size_t)iIndex * getQuantizationSampleSize(m_iDataQuantization);
+}
 
-	DAFFRecordChannelDescDefault* pDesc =
-		reinterpret_cast<DAFFRecordChannelDescDefault*>(getRecordChannelDescPtr(iRecordIndex, iChannel));
-	float* pfSrc = 0;
+void DAFFReaderImpl::convertValues(const void* pData, int iCount, int iInputStride, float* pfDest,
+								   int iOutputStride, float fGain, bool bAdd) const
+{
+	DAFF_INSTRUMENT_COUNT(DAFF_COUNTER_FETCHED_BYTES_INT16 + m_iDataQuantization,
+						  (uint64_t)iCount * getQuantizationSampleSize(m_iDataQuantization));
 
-	switch (m_pMainHeader->iContentType) {
-	case DAFF_PHASE_SPECTRUM:
-		if ((iFreqIndex < 0) || (iFreqIndex >= m_pContentHeaderPS->iNumFreqs))
-			return DAFF_INVALID_INDEX;
+	switch (m_iDataQuantization) {
+	case DAFF_INT16:
+	case DAFF_INT16_BFP:  // The callers include the block scale into the gain
+		if (bAdd)
+			DAFF::stc_sint16_to_float_add(pfDest, (const short*)pData, iCount, iInputStride, iOutputStride, fGain);
+		else
+			DAFF::stc_sint16_to_float(pfDest, (const short*)pData, iCount, iInputStride, iOutputStride, fGain);
+		break;
 
-		pfSrc = reinterpret_cast<float*>(reinterpret_cast<char*>(m_pDataBlock) + pDesc->ui64DataOffset);
-		fPhase = pfSrc[iFreqIndex];
+	case DAFF_INT24:
+		if (bAdd)
+			DAFF::stc_sint24_to_float_add(pfDest, pData, iCount, iInputStride, iOutputStride, fGain);
+		else
+			DAFF::stc_sint24_to_float(pfDest, pData, iCount, iInputStride, iOutputStride, fGain);
 		break;
-	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
-		if ((iFreqIndex < 0) || (iFreqIndex >= m_pContentHeaderMPS->iNumFreqs))
-			return DAFF_INVALID_INDEX;
 
-		pfSrc = reinterpret_cast<float*>(reinterpret_cast<char*>(m_pDataBlock) + pDesc->ui64DataOffset);
-		fPhase = pfSrc[2 * iFreqIndex + 1];
+	case DAFF_FLOAT16:
+		if (bAdd)
+			DAFF::stc_half_to_float_add(pfDest, (const unsigned short*)pData, iCount, iInputStride, iOutputStride,
+										fGain);
+		else
+			DAFF::stc_half_to_float(pfDest, (const unsigned short*)pData, iCount, iInputStride, iOutputStride, fGain);
 		break;
-	default:
-		return DAFF_MODAL_ERROR;
-	}
 
-	return DAFF_NO_ERROR;
+	case DAFF_BFLOAT16:
+		if (bAdd)
+			DAFF::stc_bfloat16_to_float_add(pfDest, (const unsigned short*)pData, iCount, iInputStride,
+											iOutputStride, fGain);
+		else
+			DAFF::stc_bfloat16_to_float(pfDest, (const unsigned short*)pData, iCount, iInputStride, iOutputStride,
+										fGain);
+		break;
+
+	case DAFF_FLOAT32: {
+		const float* pfSrc = (const float*)pData;
+		if (!bAdd && (fGain == 1) && (iInputStride == 1) && (iOutputStride == 1)) {  // Direct copy
+			memcpy(pfDest, pfSrc, iCount * sizeof(float));
+		} else if (!bAdd && (fGain == 1) && (iInputStride == 2) && (iOutputStride == 1) && (iCount > 0)) {
+			// Deinterleave, the last pair is incomplete when starting at the second value (e.g. phases)
+			DAFF::deinterleave_float(pfDest, NULL, pfSrc, iCount - 1);
+			pfDest[iCount - 1] = pfSrc[2 * (iCount - 1)];
+		} else if (bAdd) {
+			for (int i = 0; i < iCount; i++)
+				pfDest[i * iOutputStride] += pfSrc[i * iInputStride] * fGain;
+		} else {
+			for (int i = 0; i < iCount; i++)
+				pfDest[i * iOutputStride] = pfSrc[i * iInputStride] * fGain;
+		}
+		break;
+	}
+	}
 }
-int DAFFReaderImpl::getCoefficientsMP(int iRecordIndex, int iChannel, float* pfDest) const
+
+void DAFFReaderImpl::convertValuesFixedPoint(const void* pData, int iCount, int16_t* piDestQ15, int32_t* piDestQ31,
+											 float fGain, bool bAdd) const
 {
-	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
-	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+	DAFF_INSTRUMENT_COUNT(DAFF_COUNTER_FETCHED_BYTES_INT16 + m_iDataQuantization,
+						  (uint64_t)iCount * getQuantizationSampleSize(m_iDataQuantization));
 
-	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
-		(iChannel >= m_pMainHeader->iNumChannels))
-		return DAFF_INVALID_INDEX;
+	switch (m_iDataQuantization) {
+	case DAFF_INT16:
+	case DAFF_INT16_BFP: {
+		// Integer samples are scaled directly (a copy into Q15 for unit gain, the block scale is part of the gain)
+		const int16_t* piSrc = (const int16_t*)pData;
+		if (piDestQ15 && bAdd)
+			DAFF::stc_sint16_to_q15_add(piDestQ15, piSrc, iCount, fGain);
+		else if (piDestQ15)
+			DAFF::stc_sint16_to_q15(piDestQ15, piSrc, iCount, fGain);
+		else if (bAdd)
+			DAFF::stc_sint16_to_q31_add(piDestQ31, piSrc, iCount, fGain);
+		else
+			DAFF::stc_sint16_to_q31(piDestQ31, piSrc, iCount, fGain);
+		break;
+	}
 
-	if (pfDest == NULL)
-		return DAFF_NO_ERROR;
+	case DAFF_INT24:
+		if (piDestQ15 && bAdd)
+			DAFF::stc_sint24_to_q15_add(piDestQ15, pData, iCount, fGain);
+		else if (piDestQ15)
+			DAFF::stc_sint24_to_q15(piDestQ15, pData, iCount, fGain);
+		else if (bAdd)
+			DAFF::stc_sint24_to_q31_add(piDestQ31, pData, iCount, fGain);
+		else
+			DAFF::stc_sint24_to_q31(piDestQ31, pData, iCount, fGain);
+		break;
 
-	DAFFRecordChannelDescDefault* pDesc =
-		reinterpret_cast<DAFFRecordChannelDescDefault*>(getRecordChannelDescPtr(iRecordIndex, iChannel));
-	float* pfSrc = reinterpret_cast<float*>(reinterpret_cast<char*>(m_pDataBlock) + pDesc->ui64DataOffset);
+	case DAFF_FLOAT16:
+	case DAFF_BFLOAT16: {
+		// Through single precision in blocks on the stack
+		const int iBlockSize = 256;
+		float pfBlock[iBlockSize];
+		const unsigned short* piSrc = (const unsigned short*)pData;
+		for (int i = 0; i < iCount; i += iBlockSize) {
+			int iNum = std::min(iCount - i, iBlockSize);
+			if (m_iDataQuantization == DAFF_FLOAT16)
+				DAFF::stc_half_to_float(pfBlock, piSrc + i, iNum);
+			else
+				DAFF::stc_bfloat16_to_float(pfBlock, piSrc + i, iNum);
+			int16_t* piBlockQ15 = (piDestQ15 ? piDestQ15 + i : NULL);
+			int32_t* piBlockQ31 = (piDestQ31 ? piDestQ31 + i : NULL);
+			DAFF::stc_float_to_fixed_point(piBlockQ15, piBlockQ31, pfBlock, iNum, fGain, bAdd);
+		}
+		break;
+	}
 
-	// TODO: find a better way to do this
-	for (int i = 0; i <= m_pContentHeaderMPS->iNumFreqs; i++) {
-		// Magnitude
-		pfDest[2 * i] = DAFF::cabs(pfSrc[2 * i], pfSrc[2 * i + 1]);
-		// Phase
-		pfDest[2 * i + 1] = DAFF::carg(pfSrc[2 * i], pfSrc[2 * i + 1]);
+	case DAFF_FLOAT32:
+		DAFF::stc_float_to_fixed_point(piDestQ15, piDestQ31, (const float*)pData, iCount, fGain, bAdd);
+		break;
 	}
+}
 
-	return DAFF_NO_ERROR;
+void* DAFFReaderImpl::getRecordChannelDescPtr(int iRecord, int iChannel) const
+{
+	// Relative to beginning of record descriptor block in bytes
+	uint64_t uiRecordDescriptorOffset =
+		iRecord * (m_pMainHeader->iNumChannels * m_iRecordChannelDescSize) + iChannel * m_iRecordChannelDescSize;
+
+	// Check buffer overruns
+	assert(uiRecordDescriptorOffset <
+		   (uint64_t)m_pMainHeader->iNumRecords * m_pMainHeader->iNumChannels * m_iRecordChannelDescSize);
+
+	// Return absolute position in memory by using pointer of record descriptor block pointer
+	void* pPtr = ((char*)m_pRecordDescriptorBlock) + uiRecordDescriptorOffset;
+	return pPtr;
 }
 
-int DAFFReaderImpl::getCoefficientsRI(int iRecordIndex, int iChannel, float* pfDest) const
+size_t DAFFReaderImpl::getRecordChannelDataSize(int iRecord, int iChannel) const
 {
-	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
-	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+	// Size of the stored (not decoded) data
+	size_t nSampleSize = (size_t)getQuantizationSampleSize(m_pMainHeader->iQuantization);
+	switch (m_pMainHeader->iContentType) {
+	case DAFF_IMPULSE_RESPONSE: {
+		int iLength = m_viElementLengths[(size_t)iRecord * m_pMainHeader->iNumChannels + iChannel];
+		if (iLength < 0)
+			return 0;
 
-	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
-		(iChannel >= m_pMainHeader->iNumChannels))
-		return DAFF_INVALID_INDEX;
+		return (size_t)iLength * nSampleSize;
+	}
 
-	if (pfDest == NULL)
-		return DAFF_NO_ERROR;
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return (size_t)m_pContentHeaderMS->iNumFreqs * nSampleSize;
 
-	DAFFRecordChannelDescDefault* pDesc =
-		reinterpret_cast<DAFFRecordChannelDescDefault*>(getRecordChannelDescPtr(iRecordIndex, iChannel));
-	float* pfSrc = reinterpret_cast<float*>(reinterpret_cast<char*>(m_pDataBlock) + pDesc->ui64DataOffset);
-	memcpy(pfDest, pfSrc, 2 * m_pContentHeaderMPS->iNumFreqs * sizeof(float));
+	case DAFF_PHASE_SPECTRUM:
+		return (size_t)m_pContentHeaderPS->iNumFreqs * nSampleSize;
 
-	return DAFF_NO_ERROR;
-}
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		return 2 * (size_t)m_pContentHeaderMPS->iNumFreqs * nSampleSize;
 
-int DAFFReaderImpl::getTransformSize() const
-{
-	return m_pContentHeaderDFT->iTransformSize;
+	case DAFF_DFT_SPECTRUM:
+		return 2 * (size_t)m_pContentHeaderDFT->iNumDFTCoeffs * nSampleSize;
+	}
+
+	return 0;
 }
 
-int DAFFReaderImpl::getNumDFTCoeffs() const
+void DAFFReaderImpl::startStreaming()
 {
-	return m_pContentHeaderDFT->iNumDFTCoeffs;
+	// All streamed data stays cached, the previous size is restored on closing
+	m_nStreamCacheRestore = m_recordCache.getMaxSize();
+	m_recordCache.setMaxSize(std::max(m_nStreamCacheRestore, (size_t)m_ui64DataSize));
+
+	m_iNumLoadedLevels = 0;
+	m_bStreamCancelled = false;
+	try {
+		m_oStreamWorker = std::thread(&DAFFReaderImpl::runStreamWorker, this);
+	} catch (const std::system_error&) {
+		// No thread available, the records are loaded on demand
+		m_iNumLoadedLevels = (int)m_vLevels.size();
+	}
 }
 
-bool DAFFReaderImpl::isSymmetric() const
+void DAFFReaderImpl::stopStreaming()
 {
-	return (m_pContentHeaderDFT->iNumDFTCoeffs != m_pContentHeaderDFT->iTransformSize);
+	if (m_oStreamWorker.joinable()) {
+		m_bStreamCancelled = true;
+		m_oStreamWorker.join();
+	}
+
+	if (m_nStreamCacheRestore > 0) {
+		std::lock_guard<std::mutex> lock(m_mxRecordCache);
+		m_recordCache.setMaxSize(m_nStreamCacheRestore);
+		m_nStreamCacheRestore = 0;
+	}
 }
 
-double DAFFReaderImpl::getFrequencyBandwidth() const
+void DAFFReaderImpl::runStreamWorker()
 {
-	return getSamplerate() / (double)getTransformSize();
+	// Record channels with their own data, in the order of the data (level by level)
+	std::vector<std::pair<uint64_t, int> > vRecordChannels;
+	for (size_t i = 0; i < m_viPayloadIndices.size(); i++)
+		if (m_viPayloadIndices[i] == (int)i)
+			vRecordChannels.push_back(std::make_pair(m_vui64DataOffsets[i], (int)i));
+	std::sort(vRecordChannels.begin(), vRecordChannels.end());
+
+	// A level is complete as soon as the data of the next one is reached. The cache is locked
+	// for each record channel, so that accesses in the meantime are delayed by one read at most.
+	int iNumChannels = m_pMainHeader->iNumChannels;
+	int iLevel = 0;
+	for (size_t i = 0; i < vRecordChannels.size(); i++) {
+		if (m_bStreamCancelled)
+			return;
+
+		while ((iLevel < (int)m_vLevels.size()) && (vRecordChannels[i].first >= m_vLevels[iLevel].ui64DataEnd))
+			m_iNumLoadedLevels = ++iLevel;
+
+		// Unreadable data fails on access again
+		std::lock_guard<std::mutex> lock(m_mxRecordCache);
+		getRecordChannelDataPtr(vRecordChannels[i].second / iNumChannels, vRecordChannels[i].second % iNumChannels);
+	}
+
+	m_iNumLoadedLevels = (int)m_vLevels.size();
 }
 
-int DAFFReaderImpl::getDFTCoeff(int iRecordIndex, int iChannel, int iDFTCoeff, float& fReal, float& fImag) const
+int DAFFReaderImpl::prefetchRecords(const int* piRecordIndices, size_t n) const
 {
-	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
-	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
-	assert((iDFTCoeff >= 0) && (iDFTCoeff < m_pContentHeaderDFT->iNumDFTCoeffs));
+	if (!m_bDAFFObjectValid)
+		return DAFF_MODAL_ERROR;
 
-	// TODO: Wrap complex-conjugate symmetric range
+	for (size_t i = 0; i < n; i++)
+		if ((piRecordIndices[i] < 0) || (piRecordIndices[i] >= m_pMainHeader->iNumRecords))
+			return DAFF_INVALID_INDEX;
+
+	int iNumChannels = m_pMainHeader->iNumChannels;
+
+	// Data in memory: The pages of mapped data are read ahead (other data is ignored by the mapping)
+	if (!m_bLazyLoading) {
+		if (m_pfDecodedData || !m_mappedFile.isOpened())
+			return DAFF_NO_ERROR;
+
+		for (size_t i = 0; i < n; i++)
+			for (int c = 0; c < iNumChannels; c++) {
+				uint64_t ui64DataOffset = m_vui64DataOffsets[(size_t)piRecordIndices[i] * iNumChannels + c];
+				m_mappedFile.prefetch(reinterpret_cast<const char*>(m_pDataBlock) + ui64DataOffset,
+									  getRecordChannelDataSize(piRecordIndices[i], c));
+			}
+		return DAFF_NO_ERROR;
+	}
+
+	// Lazy loading: The record channels are queued for the worker (shared data once)
+	bool bWorker = true;
+	{
+		std::lock_guard<std::mutex> lock(m_mxPrefetch);
+		for (size_t i = 0; i < n; i++)
+			for (int c = 0; c < iNumChannels; c++)
+				m_diPrefetchQueue.push_back(m_viPayloadIndices[(size_t)piRecordIndices[i] * iNumChannels + c]);
+
+		// If the worker falls behind, the oldest requests are dropped
+		while (m_diPrefetchQueue.size() > m_viPayloadIndices.size())
+			m_diPrefetchQueue.pop_front();
+
+		if (!m_oPrefetchWorker.joinable()) {
+			try {
+				m_oPrefetchWorker = std::thread(&DAFFReaderImpl::runPrefetchWorker, this);
+			} catch (const std::system_error&) {
+				// No thread available, the records are loaded right here
+				m_diPrefetchQueue.clear();
+				bWorker = false;
+			}
+		}
+	}
 
-	DAFFRecordChannelDescDefault* pDesc =
-		reinterpret_cast<DAFFRecordChannelDescDefault*>(getRecordChannelDescPtr(iRecordIndex, iChannel));
-	float* pfSrc = reinterpret_cast<float*>(reinterpret_cast<char*>(m_pDataBlock) + pDesc->ui64DataOffset);
+	if (bWorker) {
+		m_cvPrefetch.notify_one();
+		return DAFF_NO_ERROR;
+	}
 
-	fReal = pfSrc[2 * iDFTCoeff + 0];
-	fImag = pfSrc[2 * iDFTCoeff + 1];
+	std::vector<int> viRecordChannels;
+	for (size_t i = 0; i < n; i++)
+		for (int c = 0; c < iNumChannels; c++)
+			viRecordChannels.push_back(piRecordIndices[i] * iNumChannels + c);
 
+	std::lock_guard<std::mutex> lock(m_mxRecordCache);
+	loadRecordChannels(viRecordChannels.data(), viRecordChannels.size());
 	return DAFF_NO_ERROR;
 }
 
-int DAFFReaderImpl::getDFTCoeffs(int iRecordIndex, int iChannel, float* pfDest) const
+void DAFFReaderImpl::stopPrefetching()
 {
-	assert((iRecordIndex >= 0) && (iRecordIndex < m_pMainHeader->iNumRecords));
-	assert((iChannel >= 0) && (iChannel < m_pMainHeader->iNumChannels));
+	{
+		std::lock_guard<std::mutex> lock(m_mxPrefetch);
+		m_bPrefetchStopped = true;
+		m_diPrefetchQueue.clear();
+	}
+	m_cvPrefetch.notify_all();
 
-	if ((iRecordIndex < 0) || (iRecordIndex >= m_pMainHeader->iNumRecords) || (iChannel < 0) ||
-		(iChannel >= m_pMainHeader->iNumChannels))
-		return DAFF_INVALID_INDEX;
+	if (m_oPrefetchWorker.joinable())
+		m_oPrefetchWorker.join();
+	m_bPrefetchStopped = false;
+}
 
-	if (pfDest == NULL)
-		return DAFF_NO_ERROR;
+void DAFFReaderImpl::runPrefetchWorker() const
+{
+	std::vector<int> viRecordChannels;
+	std::unique_lock<std::mutex> lock(m_mxPrefetch);
+	while (true) {
+		while (!m_bPrefetchStopped && m_diPrefetchQueue.empty())
+			m_cvPrefetch.wait(lock);
+		if (m_bPrefetchStopped)
+			return;
+
+		// The queued record channels are read in batches
+		size_t n = std::min(m_diPrefetchQueue.size(), DAFF_PREFETCH_BATCH);
+		viRecordChannels.assign(m_diPrefetchQueue.begin(), m_diPrefetchQueue.begin() + n);
+		m_diPrefetchQueue.erase(m_diPrefetchQueue.begin(), m_diPrefetchQueue.begin() + n);
+		lock.unlock();
+
+		// The cache is locked for one batch (unreadable data fails on access again)
+		{
+			std::lock_guard<std::mutex> cacheLock(m_mxRecordCache);
+			loadRecordChannels(viRecordChannels.data(), n);
+		}
 
-	DAFFRecordChannelDescDefault* pDesc =
-		reinterpret_cast<DAFFRecordChannelDescDefault*>(getRecordChannelDescPtr(iRecordIndex, iChannel));
-	float* pfSrc = reinterpret_cast<float*>(reinterpret_cast<char*>(m_pDataBlock) + pDesc->ui64DataOffset);
-	memcpy(pfDest, pfSrc, 2 * m_pContentHeaderDFT->iNumDFTCoeffs * sizeof(float));
+		lock.lock();
+	}
+}
 
-	return DAFF_NO_ERROR;
+void DAFFReaderImpl::loadRecordChannels(const int* piRecordChannels, size_t n) const
+{
+	if (!m_bLazyLoading || m_pfDecodedData)
+		return;
+
+	int iNumChannels = m_pMainHeader->iNumChannels;
+
+	// Compressed data is decompressed chunk by chunk
+	if (m_bCompressed) {
+		for (size_t i = 0; i < n; i++)
+			getRecordChannelDataPtr(piRecordChannels[i] / iNumChannels, piRecordChannels[i] % iNumChannels);
+		return;
+	}
+
+	// Record channels with their own data that are not cached, in the order of the data
+	std::vector<std::pair<uint64_t, int> > vMissing;
+	for (size_t i = 0; i < n; i++) {
+		int iPayload = m_viPayloadIndices[piRecordChannels[i]];
+		if (m_recordCache.find(iPayload) == NULL)
+			vMissing.push_back(std::make_pair(m_vui64DataOffsets[iPayload], iPayload));
+	}
+	std::sort(vMissing.begin(), vMissing.end());
+	vMissing.erase(std::unique(vMissing.begin(), vMissing.end()), vMissing.end());
+
+	// A batch must fit into the cache, otherwise it would evict its own entries
+	size_t nMaxBatchSize = std::min(DAFF_LAZY_BATCH_SIZE, m_recordCache.getMaxSize());
+
+	std::vector<DAFFReadRequest> vRequests;
+	std::vector<int> viKeys;
+	size_t nBatchSize = 0;
+	for (size_t i = 0; i <= vMissing.size(); i++) {
+		size_t nSize = 0;
+		if (i < vMissing.size())
+			nSize = getRecordChannelDataSize(vMissing[i].second / iNumChannels, vMissing[i].second % iNumChannels);
+
+		if (!vRequests.empty() && ((i == vMissing.size()) || (nBatchSize + nSize > nMaxBatchSize))) {
+			if (m_pSource->readBatch(vRequests.data(), vRequests.size()) != DAFF_NO_ERROR) {
+				for (size_t k = 0; k < viKeys.size(); k++)
+					m_recordCache.erase(viKeys[k]);
+			} else if (!DAFF::is_little_endian()) {
+				for (size_t k = 0; k < vRequests.size(); k++)
+					copyRecordData(vRequests[k].pDest, vRequests[k].pDest, vRequests[k].nBytes,
+								   m_pMainHeader->iQuantization);
+			}
+			DAFF_INSTRUMENT_COUNT(DAFF_COUNTER_RECORD_CACHE_MISSES, (uint64_t)viKeys.size());
+
+			vRequests.clear();
+			viKeys.clear();
+			nBatchSize = 0;
+		}
+
+		if (i == vMissing.size())
+			break;
+
+		uint64_t ui64DataOffset = vMissing[i].first;
+		if ((ui64DataOffset > m_ui64DataSize) || (nSize > m_ui64DataSize - ui64DataOffset) ||
+			(verifyDataRange(ui64DataOffset, nSize) != DAFF_NO_ERROR))
+			continue;
+
+		void* pData = m_recordCache.insert(vMissing[i].second, nSize);
+		if (pData == NULL)
+			continue;
+
+		DAFFReadRequest oRequest;
+		oRequest.ui64Offset = m_pDataFileBlock->ui64Offset + ui64DataOffset;
+		oRequest.pDest = pData;
+		oRequest.nBytes = nSize;
+		vRequests.push_back(oRequest);
+		viKeys.push_back(vMissing[i].second);
+		nBatchSize += nSize;
+	}
 }
 
-void* DAFFReaderImpl::getRecordChannelDescPtr(int iRecord, int iChannel) const
+void DAFFReaderImpl::loadRecordChannelsOfRecord(int iRecord) const
 {
-	// Relative to beginning of record descriptor block in bytes
-	uint64_t uiRecordDescriptorOffset =
-		iRecord * (m_pMainHeader->iNumChannels * m_iRecordChannelDescSize) + iChannel * m_iRecordChannelDescSize;
+	int iNumChannels = m_pMainHeader->iNumChannels;
+	if (!m_bLazyLoading || (iNumChannels < 2))
+		return;
 
-	// Check buffer overruns
-	assert(uiRecordDescriptorOffset < m_pRecordDescriptorTable->ui64Size);
+	std::vector<int> viRecordChannels(iNumChannels);
+	for (int c = 0; c < iNumChannels; c++)
+		viRecordChannels[c] = iRecord * iNumChannels + c;
+	loadRecordChannels(viRecordChannels.data(), viRecordChannels.size());
+}
 
-	// Return absolute position in memory by using pointer of record descriptor block pointer
-	void* pPtr = ((char*)m_pRecordDescriptorBlock) + uiRecordDescriptorOffset;
-	return pPtr;
+std::unique_lock<std::mutex> DAFFReaderImpl::lockRecordCache() const
+{
+	if (!m_bLazyLoading)
+		return std::unique_lock<std::mutex>();
+	return std::unique_lock<std::mutex>(m_mxRecordCache);
+}
+
+const void* DAFFReaderImpl::getRecordChannelDataPtr(int iRecord, int iChannel) const
+{
+	// Decoded data is stored in the float arena
+	if (m_pfDecodedData)
+		return m_pfDecodedData + m_vui64DecodedOffsets[(size_t)iRecord * m_pMainHeader->iNumChannels + iChannel];
+
+	// Check data offset for buffer overruns
+	uint64_t ui64DataOffset = m_vui64DataOffsets[(size_t)iRecord * m_pMainHeader->iNumChannels + iChannel];
+	size_t nSize = getRecordChannelDataSize(iRecord, iChannel);
+	assert(ui64DataOffset + nSize <= m_ui64DataSize);
+	if ((ui64DataOffset > m_ui64DataSize) || (nSize > m_ui64DataSize - ui64DataOffset))
+		return NULL;
+
+	if (!m_bLazyLoading)
+		return reinterpret_cast<const char*>(m_pDataBlock) + ui64DataOffset;
+
+	// Lazy loading: Look up the cache first (shared data is cached once)
+	int64_t iKey = m_viPayloadIndices[(size_t)iRecord * m_pMainHeader->iNumChannels + iChannel];
+	void* pData = m_recordCache.find(iKey);
+	DAFF_INSTRUMENT_COUNT(pData ? DAFF_COUNTER_RECORD_CACHE_HITS : DAFF_COUNTER_RECORD_CACHE_MISSES, 1);
+	if (pData)
+		return pData;
+
+	pData = m_recordCache.insert(iKey, nSize);
+	if (pData == NULL)
+		return NULL;
+
+	int ec;
+	if (m_bCompressed) {
+		ec = decompressRange(ui64DataOffset, pData, nSize);
+	} else {
+		ec = verifyDataRange(ui64DataOffset, nSize);
+		if (ec == DAFF_NO_ERROR)
+			ec = m_pSource->read(m_pDataFileBlock->ui64Offset + ui64DataOffset, pData, nSize);
+	}
+
+	if (ec != DAFF_NO_ERROR) {
+		m_recordCache.erase(iKey);
+		return NULL;
+	}
+
+	// Fix the endianess of the data (in place, the data has just been read)
+	if (!DAFF::is_little_endian())
+		copyRecordData(pData, pData, nSize, m_pMainHeader->iQuantization);
+
+	return pData;
 }
 
 int* DAFFReaderImpl::getRecordMetadataIndexPtr(int iRecord) const
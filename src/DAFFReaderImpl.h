@@ -23,9 +23,24 @@
 #include <DAFFReader.h>
 #include <DAFFSCTransform.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "DAFFFileSource.h"
 #include "DAFFHeader.h"
+#include "DAFFMappedFile.h"
+#include "DAFFMetadataImpl.h"
+#include "DAFFRecordCache.h"
+#include "DAFFSharedMemory.h"
+#include "DAFFSphereIndex.h"
 
-class DAFFMetadataImpl;
 
 class DAFFReaderImpl : public DAFFReader,
 					   public DAFFProperties,
@@ -39,17 +54,60 @@ class DAFFReaderImpl : public DAFFReader,
 	~DAFFReaderImpl();
 
 	bool isFileOpened() const;
-	int openFile(const std::string&);
+	int openFile(const std::string&, int iOpenFlags = DAFF_OPEN_DEFAULT);
+	int openSource(DAFFDataSource* pSource, int iOpenFlags = DAFF_OPEN_DEFAULT);
+	int openFileAsync(const std::string& sFilePath, DAFFOpenCallback* pCallback = NULL,
+					  int iOpenFlags = DAFF_OPEN_DEFAULT);
+	bool isOpening() const;
+	void cancelOpen();
+	int waitForOpen();
 	void closeFile();
 	std::string getFilename() const;
+	bool isLazy() const;
+	bool isCompressed() const;
+	bool hasChecksums() const;
+	bool hasStatistics() const;
+	int getDataAlignment() const;
+	const unsigned short* getRecordChannelData16Ptr(int iRecordIndex, int iChannel, int& iNumValues) const;
+	const void* getRecordChannelRawDataPtr(int iRecordIndex, int iChannel, int& iQuantization, int& iNumValues) const;
+	float getRecordChannelScale(int iRecordIndex, int iChannel) const;
+	int getNumSharedRecordChannels() const;
+	int getSymmetry() const;
+	int getNumStoredRecords() const;
+	int getNumStoredChannels() const;
+	int getNumLevels() const;
+	int getNumLoadedLevels() const;
+	int getRecordOrder() const;
+	int getStorageNeighbours(int iRecordIndex, int iRadius, std::vector<int>& viRecordIndices) const;
+	size_t getLazyCacheSize() const;
+	void setLazyCacheSize(size_t nMaxBytes);
+	float getTruncationThreshold() const;
+	void setTruncationThreshold(float fThresholdDB);
+	std::vector<int> getChannelSelection() const;
+	void setChannelSelection(const std::vector<int>& viChannels);
+	DAFFRegion getRegion() const;
+	void setRegion(const DAFFRegion& oRegion);
+	std::vector<int> getRegionRecords() const;
+	bool getKeepCapacity() const;
+	void setKeepCapacity(bool bKeep);
+	size_t getCapacity() const;
+	void reserveCapacity(size_t nBytes);
+	void getLoadStats(DAFFLoadStats& oStats) const;
+	void getMemoryFootprint(DAFFMemoryFootprint& oFootprint) const;
 
 	int deserialize(char* pDAFFDataBuffer);
+	int deserialize(const char* pDAFFDataBuffer, size_t nSize, bool bBorrow = false);
 	bool isValid() const;
 
+	int publishShared(const std::string& sName);
+	int attachShared(const std::string& sName);
+
 	int getFileFormatVersion() const;
 	int getContentType() const;
 	DAFFContent* getContent() const;
 	const DAFFMetadata* getMetadata() const;
+	const float* getRecordMetadataColumn(const std::string& sKey) const;
+	int selectRecords(const std::string& sKey, int iOperator, float fValue, std::vector<int>& viRecordIndices) const;
 	DAFFProperties* getProperties() const;
 
 	std::string toString() const;
@@ -80,6 +138,7 @@ class DAFFReaderImpl : public DAFFReader,
 	bool coversFullAlphaRange() const;
 	bool coversFullBetaRange() const;
 	bool coversFullSphere() const;
+	bool isRegularGrid() const;
 
 	// --= Interface "DAFFContent" =--
 
@@ -89,7 +148,18 @@ class DAFFReaderImpl : public DAFFReader,
 	void getNearestNeighbour(int iView, float fAngle1Deg, float fAngle2Deg, int& iRecordIndex) const;
 	void getNearestNeighbour(int iView, float fAngle1Deg, float fAngle2Deg, int& iRecordIndex,
 							 bool& bOutOfBounds) const;
+	void getNearestNeighbours(int iView, const float* pfAngles1Deg, const float* pfAngles2Deg, int* piRecordIndices,
+							  bool* pbOutOfBounds, size_t n) const;
+	int getKNearestNeighbours(int iView, float fAngle1, float fAngle2, int k, int* piRecordIndices,
+							  float* pfDistances) const;
+	int getKNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int k, int* piRecordIndices,
+							  float* pfDistances, size_t n) const;
+	int getRecordsInCone(int iView, float fAngle1, float fAngle2, float fRadius,
+						 std::vector<int>& viRecordIndices) const;
+	int getRecordsInCone(int iView, const float* pfAngles1, const float* pfAngles2, float fRadius,
+						 std::vector<int>& viRecordIndices, std::vector<int>& viOffsets, size_t n) const;
 	void getCell(int iView, float fAngle1, float fAngle2, DAFFQuad& qIndices) const;
+	int prefetchRecords(const int* piRecordIndices, size_t n) const;
 	void transformAnglesD2O(float fAlpha, float fBeta, float& fAzimuth, float& fElevation) const;
 	void transformAnglesO2D(float fAzimuth, float fElevation, float& fAlpha, float& fBeta) const;
 
@@ -98,13 +168,26 @@ class DAFFReaderImpl : public DAFFReader,
 	double getSamplerate() const;
 	int getFilterLength() const;
 	int getFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const;
+	int getFilterCoeff(int iRecordIndex, int iChannel, int iSample, float& fCoeff) const;
 	int addFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const;
+	int getFilterCoeffsQ15(int iRecordIndex, int iChannel, int16_t* piDest, float fGain = 1.0F) const;
+	int getFilterCoeffsQ31(int iRecordIndex, int iChannel, int32_t* piDest, float fGain = 1.0F) const;
+	int addFilterCoeffsQ15(int iRecordIndex, int iChannel, int16_t* piDest, float fGain = 1.0F) const;
+	int addFilterCoeffsQ31(int iRecordIndex, int iChannel, int32_t* piDest, float fGain = 1.0F) const;
 	int getMinEffectiveFilterOffset() const;
 	int getMaxEffectiveFilterLength() const;
+	int getFilterCoeffsTruncated(int iRecordIndex, int iChannel, float* pfDest, int& iLength,
+								 float fGain = 1.0F) const;
+	int getMaxTruncatedFilterLength() const;
 	int getEffectiveFilterBounds(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const;
 	int getEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const;
 	int addEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const;
-	float getOverallPeak();  // no const because of lazy initialization
+	const float* getEffectiveFilterCoeffsPtr(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const;
+	int getFilterEnvelope(int iRecordIndex, int iChannel, int iFirstSample, int iNumSamples, int iNumBins,
+						  float* pfMin, float* pfMax) const;
+	float getOverallPeak() const;
+	float getChannelPeak(int iChannel) const;
+	float getRecordPeak(int iRecordIndex, int iChannel) const;
 
 	// --= Interface "DAFFContentMS" =--
 
@@ -112,16 +195,20 @@ class DAFFReaderImpl : public DAFFReader,
 	const std::vector<float>& getFrequencies() const;
 	float getOverallMagnitudeMaximum() const;
 	int getMagnitudes(int iRecordIndex, int iChannel, float* pfData) const;
+	int addMagnitudes(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const;
 	int getMagnitude(int iRecordIndex, int iChannel, int iFreqIndex, float& fMag) const;
+	int getMagnitudeSlice(int iChannel, int iFreqIndex, float* pfDest) const;
+	const float* getMagnitudesPtr(int iRecordIndex, int iChannel) const;
 
 	// --= Interface "DAFFContentPS" =--
 
 	int getPhases(int iRecordIndex, int iChannel, float* pfData) const;
 	int getPhase(int iRecordIndex, int iChannel, int iFreqIndex, float& fPhase) const;
+	int getPhaseSlice(int iChannel, int iFreqIndex, float* pfDest) const;
+	const float* getPhasesPtr(int iRecordIndex, int iChannel) const;
 
 	// --= Interface "DAFFContentMPS" =--
 
-	int getCoefficientsMP(int iRecordIndex, int iChannel, float* pfDest) const;
 	int getCoefficientsRI(int iRecordIndex, int iChannel, float* pfDest) const;
 
 	// --= Interface "DAFFContentDFT" =--
@@ -132,21 +219,85 @@ class DAFFReaderImpl : public DAFFReader,
 	double getFrequencyBandwidth() const;
 	int getDFTCoeff(int iRecordIndex, int iChannel, int iDFTCoeff, float& fReal, float& fImag) const;
 	int getDFTCoeffs(int iRecordIndex, int iChannel, float* pfDest) const;
+	int getDFTCoeffsFull(int iRecordIndex, int iChannel, float* pfDest) const;
+	int getDFTCoeffSlice(int iChannel, int iDFTCoeff, float* pfDest) const;
+	int addDFTCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const;
+	const float* getDFTCoeffsPtr(int iRecordIndex, int iChannel) const;
+
+	// --= Shared by the interfaces "DAFFContentIR", "DAFFContentMS", "DAFFContentPS" and "DAFFContentDFT" =--
+
+	int getRecord(int iRecordIndex, float** ppfChannelDest) const;
+	int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const;
+
+	// --= Shared by the interfaces "DAFFContentIR" and "DAFFContentMS" =--
+
+	int getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const;
+
+	// --= Shared by the interfaces "DAFFContentMPS" and "DAFFContentDFT" =--
+
+	int getCoefficientsMP(int iRecordIndex, int iChannel, float* pfDest) const;
+	int getCoefficientsMP(const int* piRecordIndices, int iNumRecords, int iChannel, float* pfDest) const;
 
   private:
 	bool m_bDAFFObjectValid;          //!@ Indicates if DAFF data is present and valid
 	bool m_bDAFFObjectFromFileValid;  //!@ Indicates if DAFF data is present and valid and loaded from a file source
 	std::string m_sFilePath;          //!@ Filename
-	FILE* m_file;                     //!@ File handle
+	DAFFFileSource m_fileSource;      //!@ File (opened while loading and for lazy loading)
 	DAFFFileHeader m_fileHeader;      //!@ File header
 	DAFFMainHeader* m_pMainHeader;    //!@ Main header
 	DAFFFileBlockEntry* m_pFileBlockTable;         //!@ File block table
 	DAFFFileBlockEntry* m_pRecordDescriptorTable;  //!@ File block of the record descriptor table
-	DAFFFileBlockEntry* m_pDataFileBlock;          //!@ File block of the record data
+	DAFFFileBlockEntry* m_pDataFileBlock;          //!@ File block of the record data (raw or compressed)
+	uint64_t m_ui64DataSize;                       //!@ Size of the uncompressed data block [Bytes]
 	void* m_pContentHeader;                        //!@ Content related header (will become IR or MS)
 	void* m_pRecordDescriptorBlock;                //!@ Record descriptor block
 	void* m_pDataBlock;                            //!@ Record data block
 	int m_iRecordChannelDescSize;                  //!@ Size of a record channel descriptor (Bytes)
+	char* m_pArena;                                //!@ Single allocation of the owned file blocks (see initArena)
+	size_t m_nArenaSize;                           //!@ Size of the arena used by the opened file [Bytes]
+	size_t m_nArenaCapacity;                       //!@ Allocated size of the arena [Bytes]
+	bool m_bKeepCapacity;                          //!@ Keep the arena and the record index across closeFile()
+	bool m_bBlocksBorrowed;                        //!@ Record descriptors and data are not owned
+	DAFFMappedFile m_mappedFile;                   //!@ File mapping (if opened with DAFF_OPEN_MAPPED)
+	DAFFSharedMemory m_sharedMemory;               //!@ Published or attached shared-memory segment
+	DAFFDataSource* m_pSource;                     //!@ Source for lazy loading (not owned)
+	bool m_bLazyLoading;                           //!@ Record data is loaded on demand (DAFF_OPEN_LAZY)
+	mutable DAFFRecordCache m_recordCache;         //!@ Cache of record channel data for lazy loading
+	mutable std::mutex m_mxRecordCache;            //!@ Guards the record cache and the source for lazy loading
+	float* m_pfDecodedData;                        //!@ Float arena of decoded record data (DAFF_OPEN_DECODE)
+	size_t m_nDecodedDataSize;                     //!@ Size of the float arena [Bytes]
+	bool m_bDecodedDataBorrowed;                   //!@ Float arena resides in an attached segment (not owned)
+	bool m_bTruncated;                             //!@ Float arena holds truncated impulse responses
+	std::vector<uint64_t> m_vui64DecodedOffsets;   //!@ Offsets of the record channels in the arena [floats]
+	int m_iDataQuantization;                       //!@ Quantization of the record data in memory
+	float m_fTruncationThresholdDB;                //!@ Energy threshold of the tail truncation (DAFF_OPEN_TRUNCATE)
+	std::vector<int> m_viPayloadIndices;           //!@ First record channel with the same data, per record channel
+	std::vector<uint64_t> m_vui64DataOffsets;      //!@ Data offsets of the record channels (record index)
+	std::vector<int> m_viLeadingZeros;             //!@ Leading zeros of the record channels (record index, IR)
+	std::vector<int> m_viElementLengths;           //!@ Stored lengths of the record channels (record index, IR)
+	std::vector<float> m_vfBlockScales;            //!@ Scales of block floating point data (record index, else empty)
+	std::vector<int> m_viMetadataIndices;          //!@ Metadata indices of the records (record index)
+	int m_iNumSharedRecordChannels;                //!@ Number of record channels sharing the data of another one
+	int m_iSymmetry;                               //!@ Symmetry of the stored records (expanded to the full grid)
+	int m_iNumStoredRecords;                       //!@ Number of records in the file (symmetric grids)
+	std::vector<int> m_viChannelSelection;         //!@ Stored channels to load from the next files (empty: all)
+	std::vector<int> m_viSelectedChannels;         //!@ Stored channel per loaded channel (empty: all loaded)
+	int m_iNumStoredChannels;                      //!@ Number of channels in the file (channel selection)
+	DAFFRegion m_oRegionSelection;                 //!@ Region of the records to load from the next files
+	DAFFRegion m_oRegion;                          //!@ Region of the loaded records (DAFF_REGION_ALL: all loaded)
+	std::vector<int> m_viRegionRecords;            //!@ Record of the full grid per loaded record (empty: all loaded)
+	int m_iNumGridRecords;                         //!@ Number of records of the full grid (region)
+	float m_pfRegionAxis[3];                       //!@ Unit vector of the cone axis (data view)
+	float m_fRegionCosAngle;                       //!@ Cosine of the cone angle
+	DAFFSphereIndex m_oGridIndex;                  //!@ Directions of the full grid (record list regions)
+
+	DAFFLoadStats m_oLoadStats;                          //!@ Wall times and sizes of the phases of the last load
+	std::chrono::steady_clock::time_point m_tLoadStart;  //!@ Start of the last load
+	std::chrono::steady_clock::time_point m_tLoadPhase;  //!@ End of the previous load phase
+
+	bool m_bCompressed;                                         //!@ Record data is stored in a compressed data block
+	std::vector<DAFFCompressedChunkEntry> m_vCompressedChunks;  //!@ Chunk table of the compressed data block
+	mutable std::vector<char> m_vcCompressedBuf;                //!@ Buffer of a compressed chunk for lazy loading
 
 	DAFFContentHeaderIR* m_pContentHeaderIR;  //!@ Access pointer for additional header for impulse response content
 	DAFFContentHeaderMS* m_pContentHeaderMS;  //!@ Access pointer for additional header for magnitude spectrum content
@@ -159,17 +310,166 @@ class DAFFReaderImpl : public DAFFReader,
 
 	const DAFFMetadataImpl*
 		m_pEmptyMetadata;  //!@ Empty metadata instance. getRecordMetadata() will return this as fallback
-	std::vector<DAFFMetadataImpl*> m_vpMetadata;  //!@ Vector with pointers to metadata entries
-	DAFFProperties* m_pProperties;                //!@ Properties pointer
-	bool m_bOverallPeakInitialized;  //!@ tells if fOverallPeak has already been initialized (lazy initialization)
-	float m_fOverallPeak;            //!@ Peak value over all records and channels
+	std::unique_ptr<DAFFMetadataImpl[]> m_pMetadataSets;  //!@ Metadata sets (parsed on first access)
+	int m_iNumMetadataSets;                               //!@ Number of metadata sets
+	char* m_pMetadataBlock;                               //!@ Metadata block (names and string values of the sets)
+	mutable std::mutex m_mxMetadataColumns;               //!@ Guards the lazy construction of the metadata columns
+	mutable std::map<std::string, std::vector<float> >
+		m_mMetadataColumns;  //!@ Record metadata columns by key (upper case, empty: no numerical values)
+	DAFFProperties* m_pProperties;                        //!@ Properties pointer
+	mutable std::mutex m_mxPeaks;                       //!@ Guards the lazy initialization of the peak values
+	mutable bool m_bOverallPeakInitialized;             //!@ Peak values have been initialized (lazy initialization)
+	mutable float m_fOverallPeak;                       //!@ Peak value over all records and channels
+	mutable std::vector<float> m_vfChannelPeaks;        //!@ Peak values per channel
+	mutable std::vector<float> m_vfRecordChannelPeaks;  //!@ Peak values per record and channel
+
+	mutable std::mutex m_mxStatistics;                       //!@ Guards the lazy computation of the statistics
+	mutable std::vector<DAFFStatisticsEntry> m_vStatistics;  //!@ Statistics per record and channel (empty until known)
+	bool m_bStatisticsStored;                                //!@ Statistics have been loaded from the statistics block
+
+	bool m_bSlices;                         //!@ Keep a frequency-major copy for the slices (DAFF_OPEN_SLICES)
+	mutable std::mutex m_mxSlices;          //!@ Guards the lazy construction of the frequency-major copy
+	mutable std::vector<float> m_vfSlices;  //!@ Frequency-major copy [channel][slice][record] (empty until built)
+
+	std::vector<DAFFRecordDirectionEntry> m_vRecordDirections;  //!@ Explicit record directions (empty on regular grids)
+	mutable std::mutex m_mxDirectionIndex;                      //!@ Guards the lazy construction of the direction index
+	mutable DAFFSphereIndex m_oDirectionIndex;                  //!@ Nearest neighbour index of the record directions
+
+	mutable std::vector<DAFFDirectionIndexEntry> m_vDirectionIndexNodes;  //!@ Direction index block (until set up)
+
+	std::thread m_oOpenWorker;           //!@ Worker of the last asynchronous opening (joined by the next one)
+	std::atomic<bool> m_bOpening;        //!@ An asynchronous opening is in progress
+	std::atomic<bool> m_bOpenCancelled;  //!@ Cancellation of the asynchronous opening requested
+	DAFFOpenCallback* m_pOpenCallback;   //!@ Receiver of the asynchronous opening (not owned)
+	int m_iAsyncOpenResult;              //!@ Result of the last asynchronous opening
+
+	std::vector<DAFFLevelEntry> m_vLevels;  //!@ Resolution levels of the record data (a single one without level block)
+	std::atomic<int> m_iNumLoadedLevels;    //!@ Number of levels available at once (DAFF_OPEN_STREAM: streamed so far)
+	std::thread m_oStreamWorker;            //!@ Worker streaming the record data into the cache (DAFF_OPEN_STREAM)
+	std::atomic<bool> m_bStreamCancelled;   //!@ Cancellation of the streaming requested
+	size_t m_nStreamCacheRestore;           //!@ Cache size restored after the streaming (0: keep the current one)
+
+	int m_iRecordOrder;                             //!@ Order of the record data (#DAFF_RECORD_ORDERS)
+	mutable std::mutex m_mxStorageOrder;            //!@ Guards the lazy construction of the storage order
+	mutable std::vector<int> m_viStorageOrder;      //!@ Record indices by the offsets of their data (empty until built)
+	mutable std::vector<int> m_viStoragePositions;  //!@ Position of each record in the storage order
+
+	mutable std::thread m_oPrefetchWorker;         //!@ Worker loading prefetched record channels (DAFF_OPEN_LAZY)
+	mutable std::mutex m_mxPrefetch;               //!@ Guards the prefetch queue and the start of the worker
+	mutable std::condition_variable m_cvPrefetch;  //!@ Signals prefetch requests and the stop to the worker
+	mutable std::deque<int> m_diPrefetchQueue;     //!@ Record channels to prefetch (index record * channels + channel)
+	mutable bool m_bPrefetchStopped;               //!@ Stop of the prefetch worker requested
+
+	bool m_bVerify;                                  //!@ Verify the checksums of the loaded blocks (DAFF_OPEN_VERIFY)
+	int m_iChecksumSegmentSize;                      //!@ Size of the checksummed segments [Bytes] (0: not verified)
+	std::vector<uint32_t> m_vui32Checksums;          //!@ Segment checksums of all file blocks (CRC-32C)
+	std::vector<size_t> m_vnFirstChecksums;          //!@ Index of the first segment checksum per file block
+	mutable std::vector<char> m_vcVerifiedSegments;  //!@ Verified segments of the lazily loaded data block
+	mutable std::vector<char> m_vcVerifyBuf;         //!@ Buffer of a segment verified on demand
 
 	DAFFOrientationYPR m_orientation;         //!@ Current orientation
 	DAFFOrientationYPR m_orientationDefault;  //!@ Default orientation
 
-	float m_fAlphaResolution;  //!@ Alpha resolution [&deg;]
-	float m_fBetaResolution;   //!@ Beta resolution [&deg;]
-	DAFFSCTransform m_tTrans;  //!@ Spherical coordinates transformer
+	float m_fAlphaResolution;                         //!@ Alpha resolution [&deg;]
+	float m_fBetaResolution;                          //!@ Beta resolution [&deg;]
+	std::shared_ptr<const DAFFSCTransform> m_pTrans;  //!@ Spherical coordinates transformer (immutable snapshot)
+
+	//! Loads all blocks from a buffer holding the complete DAFF file
+	/**
+	 * Small headers are always copied. If bBorrow is set, the record descriptor
+	 * block and the record data block are not copied but accessed in the buffer,
+	 * which then must outlive the instance content. Borrowing is silently replaced
+	 * by copying on big endian systems and for record data that is not 4-byte aligned.
+	 *
+	 * @param pBuffer     DAFF file data
+	 * @param nSize       Size of the buffer [Bytes]
+	 * @param bBorrow     Access record descriptors and data inside the buffer
+	 * @param iOpenFlags  Open flags (decoding and truncation follow the loading)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int loadFromMemory(const char* pBuffer, size_t nSize, bool bBorrow, int iOpenFlags);
+
+	//! Loads all blocks from a data source
+	/**
+	 * If the source provides its content in memory, loadFromMemory() is used and the
+	 * data is borrowed. Otherwise the blocks are read, except for the record data
+	 * with #DAFF_OPEN_LAZY. In that case the source is kept for loading on demand.
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int loadFromSource(DAFFDataSource* pSource, int iOpenFlags);
+
+	//! Allocates the arena and places the owned file blocks in it
+	/**
+	 * The arena is sized from the file block table and holds the file block table, the
+	 * main header, the content header, the metadata block and, unless borrowed, the record
+	 * descriptors. The record data block is placed in it, if it is kept as stored (not
+	 * borrowed, compressed, loaded lazily, decoded or truncated). Other data blocks and the
+	 * expanded descriptors of symmetric grids are allocated separately.
+	 *
+	 * The file block table and the main header, which have been loaded before (into
+	 * temporary buffers), are moved into the arena. The other blocks are assigned their
+	 * place and must be filled by the caller. A kept arena (see setKeepCapacity) is reused
+	 * if the blocks fit.
+	 *
+	 * @param iOpenFlags  Open flags
+	 * @param bBorrowed   Record descriptors and data are borrowed
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int initArena(int iOpenFlags, bool bBorrowed);
+
+	//! Returns true if the memory belongs to the arena
+	bool isArenaBlock(const void* p) const;
+
+	//! Releases the record data block, unless it is borrowed or part of the arena
+	void releaseDataBlock();
+
+	//! Frees the arena and the record index kept across closeFile()
+	void releaseCapacity();
+
+	//! Opens a DAFF file (openFile() and the worker of openFileAsync())
+	int loadFile(const std::string& sFilePath, int iOpenFlags);
+
+	//! Worker of openFileAsync(), opens the file and delivers the result to the callback
+	void runOpenWorker(std::string sFilePath, int iOpenFlags);
+
+	//! Reports the progress of an asynchronous opening
+	/**
+	 * @return False if the opening has been cancelled
+	 */
+	bool continueOpen(float fProgress);
+
+	//! Reads the record data file block from a source
+	/**
+	 * During an asynchronous opening the block is read in chunks, reporting the
+	 * progress and checking for a cancellation between the chunks.
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int readDataFileBlock(DAFFDataSource* pSource, void* pDest);
+
+	//! Converts quantized impulse responses into the float arena (#DAFF_OPEN_DECODE)
+	/**
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int decodeRecordData();
+
+	//! Trims the impulse response tails and repacks them into the float arena (#DAFF_OPEN_TRUNCATE)
+	/**
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int truncateRecordData();
+
+	//! Checks that a file image matches the loaded file header and file block table
+	bool matchesFileImage(const char* pImage, size_t nSize) const;
+
+	//! Takes over the decoded float arena of an attached segment (see attachShared())
+	/**
+	 * @return #DAFF_NO_ERROR on success, #DAFF_FILE_CORRUPTED for offsets or lengths that do not fit
+	 */
+	int attachDecodedData(const DAFFSharedSegmentHeader& oHeader);
 
 	//! Loads the file header from memory block
 	/**
@@ -201,24 +501,249 @@ class DAFFReaderImpl : public DAFFReader,
 	 */
 	int loadRecordDescriptor();
 
+	//! Builds the record index from the record descriptors
+	/**
+	 * The fields of the packed descriptors are copied into separate arrays, indexed by
+	 * record * channels + channel (metadata: by record). All accesses after loading use them.
+	 */
+	void initRecordIndex();
+
+	//! Determines the record channels sharing their data (same data offset and size)
+	void initPayloadIndices();
+
 	//! Loads the DAFF record data from memory block
 	/**
+	 * Copies the data from pSource into the data block and converts it into the system
+	 * byte order in the same pass (in place if pSource is the data block).
+	 *
+	 * @return DAFFError if not readable
+	 */
+	int loadRecordData(const void* pSource);
+
+	//! Validates the header of the compressed data block (and fixes its endianness)
+	/**
+	 * Determines the size of the uncompressed data block and sizes the chunk table.
+	 *
 	 * @return DAFFError if not readable
 	 */
-	int loadRecordData();
+	int loadCompressedDataHeader(DAFFCompressedDataHeader& oHeader);
+
+	//! Validates the chunk table read from the compressed data block (and fixes its endianness)
+	/**
+	 * @return DAFFError if not readable
+	 */
+	int loadCompressedChunkTable();
+
+	//! Validates that the record channels of the descriptors lie inside the (uncompressed) data block
+	/**
+	 * The size of the uncompressed data of a compressed data block must further match the
+	 * record channels and the chunks, with at most the padding of the last record channel
+	 * behind them, and fit into the address space.
+	 *
+	 * @return DAFFError if not readable
+	 */
+	int checkRecordDataExtent() const;
+
+	//! Decompresses all chunks of a compressed data block into the data block
+	/**
+	 * \param [in] pBlock	Compressed data block
+	 *
+	 * @return DAFFError if not readable
+	 */
+	int decompressRecordData(const char* pBlock);
+
+	//! Decompresses a range of the data block for lazy loading (requires the record cache to be locked)
+	/**
+	 * The range must lie within a single chunk, only this chunk is read.
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_FILE_CORRUPTED otherwise
+	 */
+	int decompressRange(uint64_t ui64DataOffset, void* pDest, size_t nSize) const;
 
 	//! Loads the DAFF metadata from given buffer
 	/**
+	 * The metadata sets are only checked and indexed, each one is parsed on first access.
+	 * The buffer is referenced by the metadata sets.
+	 *
 	 * @return DAFFError if not readable
 	 */
 	int loadMetadata(char*);
 
+	//! Sets a single empty metadata set (files without metadata)
+	void setEmptyMetadata();
+
+	//! Resets the load statistics and starts the measurement of a load
+	void beginLoadStats();
+
+	//! Adds the wall time since the end of the previous load phase to a phase of the load statistics (and traces it)
+	void endLoadPhase(double& dPhaseTime, const char* pszPhase);
+
+	//! Completes the load statistics of a successful load
+	void endLoadStats();
+
+	//! Validates the statistics read from the statistics block (and fixes their endianness)
+	/**
+	 * @return DAFFError if not readable
+	 */
+	int loadStatistics();
+
+	//! Validates the record directions read from the record directions block
+	/**
+	 * @return DAFFError if not readable
+	 */
+	int loadRecordDirections();
+
+	//! Validates the symmetry block and expands the stored records to the full grid
+	/**
+	 * The expanded record descriptors refer to the data of the stored records (shared data).
+	 *
+	 * @return DAFFError if not readable
+	 */
+	int loadSymmetry(DAFFSymmetryHeader& oHeader);
+
+	//! Restricts the records to the selected channels (see setChannelSelection)
+	/**
+	 * Follows the expansion of symmetric grids. The selected descriptors are copied into
+	 * an owned block, the record index and the statistics are set up for the selection.
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_INVALID_INDEX for channels that do not exist
+	 */
+	int selectChannels();
+
+	//! Restricts the records to the selected region (see setRegion)
+	/**
+	 * Follows the channel selection. Beta ranges of regular grids narrow the grid to the rows
+	 * of the range, other regions turn the loaded records into an irregular grid. The selected
+	 * descriptors are copied into an owned block, the record index, the statistics and the
+	 * levels are set up for the region.
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_INVALID_INDEX for empty regions and records that do not exist
+	 */
+	int selectRegion();
+
+	//! Returns true if the records or channels are restricted (see selectChannels and selectRegion)
+	bool isSelecting() const;
+
+	//! Reads the data of the selected record channels into a packed data block
+	/**
+	 * The record channels are read in the order of their data offsets, close ones at once.
+	 * The packed ranges keep their offset modulo 64 Bytes (data alignment), only the record
+	 * index is updated. The segments that are read are verified (like with lazy loading).
+	 *
+	 * \param [in] pSource	Source of the file (NULL: the data block is in memory)
+	 * \param [in] pData		Data block in memory (NULL: read from the source)
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int loadSelectedRecordData(DAFFDataSource* pSource, const char* pData);
+
+	//! Returns true if the record descriptors are owned (not borrowed, or expanded or selected)
+	bool ownsRecordDescriptors() const;
+
+	//! Validates the level block, or sets up a single level without one
+	/**
+	 * @param pBlock  Level block (NULL if there is none), converted in place
+	 * @param nSize   Size of the level block [Bytes]
+	 *
+	 * @return DAFFError if not readable
+	 */
+	int loadLevels(char* pBlock, size_t nSize);
+
+	//! Validates the record order block (the record index order applies without one)
+	/**
+	 * @return DAFFError if not readable
+	 */
+	int loadRecordOrder(DAFFRecordOrderHeader& oHeader);
+
+	//! Sorts the records by the offsets of their data (storage order, lazily on first use)
+	void initStorageOrder() const;
+
+	//! Starts streaming the record data level by level into the record cache (DAFF_OPEN_STREAM)
+	/**
+	 * The cache is enlarged to hold the whole record data. Until the last level has been streamed,
+	 * getNearestNeighbour() returns records of the streamed levels (see getNumLoadedLevels()).
+	 */
+	void startStreaming();
+
+	//! Cancels the streaming and waits for the worker
+	void stopStreaming();
+
+	//! Worker of the streaming, caches the record channels in the order of the data
+	void runStreamWorker();
+
+	//! Drops the queued prefetches and waits for the prefetch worker
+	void stopPrefetching();
+
+	//! Worker of the prefetching, loads the queued record channels into the record cache
+	void runPrefetchWorker() const;
+
+	//! Replaces a record by the nearest one of the streamed levels
+	/**
+	 * Grid indices are rounded to the step of the finest streamed level. Records whose data has
+	 * not been streamed yet (e.g. of files that do not follow the level layout) are kept.
+	 */
+	void snapToLoadedLevels(int iAlphaIndex, int iBetaIndex, int& iRecordIndex) const;
+
+	//! Returns the index of the record at the given grid indices (regular grids, poles are single records)
+	int getGridRecordIndex(int iAlphaIndex, int iBetaIndex) const;
+
+	//! Returns true if a normalized direction in data spherical coordinates is inside the loaded region
+	bool isInRegion(float fAlpha, float fBeta) const;
+
 	//! Verifies and fixes the angle ranges
 	/**
 	 * @return DAFFError if not readable
 	 */
 	void fixAngleRanges();
 
+	//! Validates the nodes read from the direction index block (and fixes their endianness)
+	/**
+	 * Irregular grids set up their index right away, regular grids on first use.
+	 *
+	 * @return DAFFError if not readable
+	 */
+	int loadDirectionIndex();
+
+	//! Sets up the direction index from the stored nodes, or builds it if there are none
+	/**
+	 * A stored tree that does not match the record directions of the reader (e.g. rounded
+	 * differently on another platform) is dropped and the index built anew.
+	 */
+	void initDirectionIndex() const;
+
+	//! Validates the checksum block and verifies the file header and the file block table with it
+	/**
+	 * \param [in] pBlock				Checksum block (file byte order)
+	 * \param [in] nSize				Size of the checksum block [Bytes]
+	 * \param [in] ui32HeaderChecksum	Checksum of the file header and the file block table as read
+	 *
+	 * @return DAFFError if not readable or not matching
+	 */
+	int loadChecksums(const char* pBlock, size_t nSize, uint32_t ui32HeaderChecksum);
+
+	//! Verifies a loaded file block (if opened with DAFF_OPEN_VERIFY and the file contains checksums)
+	/**
+	 * Segments beyond the loaded bytes are read from the source. Large blocks are verified in parallel.
+	 *
+	 * \param [in] pBlock	File block
+	 * \param [in] pData	Loaded bytes of the block (file byte order), starting at the beginning of the block
+	 * \param [in] nSize	Number of loaded bytes
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_FILE_CHECKSUM_MISMATCH or #DAFF_FILE_CORRUPTED otherwise
+	 */
+	int verifyFileBlock(const DAFFFileBlockEntry* pBlock, const void* pData, size_t nSize) const;
+
+	//! Verifies the segments of the lazily loaded data block which overlap a range, once per segment
+	/**
+	 * Requires the record cache to be locked. The segments are read from the source.
+	 *
+	 * \param [in] ui64Offset	Offset of the range within the data block (raw or compressed) [Bytes]
+	 * \param [in] ui64Size		Size of the range [Bytes]
+	 *
+	 * @return #DAFF_NO_ERROR on success, #DAFF_FILE_CHECKSUM_MISMATCH or #DAFF_FILE_CORRUPTED otherwise
+	 */
+	int verifyDataRange(uint64_t ui64Offset, uint64_t ui64Size) const;
+
 
 	//! Search for the first file block that matches the given ID
 	/* @return Total number of matching file blocks)
@@ -228,9 +753,121 @@ class DAFFReaderImpl : public DAFFReader,
 	//! Search for all file blocks with the given ID (returns the number of matches)
 	int getFileBlocksByID(int iID, std::vector<DAFFFileBlockEntry*>& vpfDest) const;
 
-	//! Returns the memory address of a record channel descriptor in the RDB
+	//! Nearest neighbour search for a direction in data spherical coordinates (not normalized)
+	void getNearestNeighbourDSC(float fAlpha, float fBeta, int& iRecordIndex, bool& bOutOfBounds) const;
+
+	//! Nearest neighbour search for a normalized direction (see DAFFUtils::NormalizeDirection)
+	void getNearestNeighbourNormalizedDSC(float fAlpha, float fBeta, int& iRecordIndex, bool& bOutOfBounds) const;
+
+	//! Appends the records within a great-circle distance of a direction in data spherical coordinates (ascending)
+	void getRecordsInConeDSC(float fAlpha, float fBeta, float fRadius, std::vector<int>& viRecordIndices) const;
+
+	//! Returns the memory address of a record channel descriptor in the RDB (loading only, see initRecordIndex)
 	void* getRecordChannelDescPtr(int iRecord, int iChannel) const;
 
+	//! Returns the size of the data of a record channel in the data block (Bytes)
+	size_t getRecordChannelDataSize(int iRecord, int iChannel) const;
+
+	//! Returns the memory address of the (endianness corrected) data of a record channel
+	/**
+	 * In lazy mode the data is read from the file into the record cache if necessary.
+	 * The pointer is valid until the next call.
+	 *
+	 * @return Data pointer, NULL on invalid offsets or read errors
+	 */
+	const void* getRecordChannelDataPtr(int iRecord, int iChannel) const;
+
+	//! Loads record channels into the record cache with batched reads (lazy loading only)
+	/**
+	 * Requires the record cache to be locked. The record channels that are not cached yet
+	 * are read from the source in the order of their data, in batches of at most
+	 * DAFF_LAZY_BATCH_SIZE bytes (see DAFFDataSource::readBatch). Unreadable data is not
+	 * cached and fails on access again.
+	 *
+	 * \param [in] piRecordChannels	Record channels (index record * channels + channel)
+	 * \param [in] n					Number of record channels
+	 */
+	void loadRecordChannels(const int* piRecordChannels, size_t n) const;
+
+	//! Loads all channels of a record with batched reads (lazy loading of multi-channel records only)
+	void loadRecordChannelsOfRecord(int iRecord) const;
+
+	//! Converts the data of a record channel into a strided float buffer
+	/**
+	 * Element k of the channel is written to pfDest[k*iStride] (complex-valued
+	 * elements occupy two consecutive floats). Indices are not validated.
+	 *
+	 * @return #DAFF_NO_ERROR on success, another #DAFF_ERROR otherwise
+	 */
+	int getRecordChannelData(int iRecord, int iChannel, float* pfDest, int iStride) const;
+
+	//! Returns the block scale of a record channel (record index, 1 unless #DAFF_INT16_BFP data is in memory)
+	float getBlockScale(size_t n) const;
+
+	//! Returns the address of a value inside record channel data (in the quantization of the data in memory)
+	const void* getValuePtr(const void* pData, int iIndex) const;
+
+	//! Converts values of record channel data (in the quantization of the data in memory) into floats
+	/**
+	 * Value k is taken from index k*iInputStride of the data, multiplied by the gain and
+	 * stored into (or with bAdd added to) pfDest[k*iOutputStride].
+	 */
+	void convertValues(const void* pData, int iCount, int iInputStride, float* pfDest, int iOutputStride,
+					   float fGain = 1, bool bAdd = false) const;
+
+	//! Retrieves or adds the filter coefficients of a record channel in Q15 or Q31 fixed point (the other one is NULL)
+	int getFixedPointFilterCoeffs(int iRecordIndex, int iChannel, int16_t* piDestQ15, int32_t* piDestQ31, float fGain,
+								  bool bAdd) const;
+
+	//! Converts values of record channel data (unit stride) into Q15 or Q31 fixed point (the other one is NULL)
+	void convertValuesFixedPoint(const void* pData, int iCount, int16_t* piDestQ15, int32_t* piDestQ31, float fGain,
+								 bool bAdd) const;
+
+	//! Minimum and maximum of values of record channel data, combined with the values of fMin and fMax passed in
+	void envelopeValues(const void* pData, int iCount, float& fMin, float& fMax) const;
+
+	//! Returns the current spherical coordinates transformer (snapshot, not affected by later orientation changes)
+	std::shared_ptr<const DAFFSCTransform> getTransform() const;
+
+	//! Locks the record cache for lazy loading (returns an unlocked lock if not lazy loading)
+	/**
+	 * Must be held while data from getRecordChannelDataPtr() is used.
+	 */
+	std::unique_lock<std::mutex> lockRecordCache() const;
+
+	//! Returns the spatial index of the record directions (built on first use for regular grids)
+	const DAFFSphereIndex& getDirectionIndex() const;
+
+	//! Determines all peak values (requires m_mxPeaks to be locked)
+	void initPeaks() const;
+
+	//! Determines the peak values of the record channels [iBegin, iEnd) (with index record * channels + channel)
+	void scanPeaks(int iBegin, int iEnd) const;
+
+	//! Returns the number of elements the statistics of a record channel refer to
+	int getStatisticsLength() const;
+
+	//! Computes the statistics of all record channels (requires m_mxStatistics to be locked)
+	void initStatistics() const;
+
+	//! Computes the statistics of the record channels [iBegin, iEnd) (with index record * channels + channel)
+	void scanStatistics(int iBegin, int iEnd, DAFFStatisticsEntry* pStatistics) const;
+
+	//! Returns the number of values per record channel of a spectrum (0 for impulse responses)
+	int getSpectrumLength() const;
+
+	//! Retrieves a cross-record slice, i.e. the values [iSlice * iWidth, (iSlice + 1) * iWidth) of every record
+	int getSlice(int iChannel, int iSlice, int iWidth, float* pfDest) const;
+
+	//! Builds the frequency-major copy of the spectra (requires m_mxSlices to be locked)
+	void initSlices() const;
+
+	//! Transposes the records [iBegin, iEnd) into the frequency-major copy (sets *piError if data is unreadable)
+	void scanSlices(int iBegin, int iEnd, float* pfSlices, int* piError) const;
+
+	//! Builds the column of a record metadata key (upper case, requires m_mxMetadataColumns to be locked)
+	void initMetadataColumn(const std::string& sName, std::vector<float>& vfColumn) const;
+
 	//! Returns the memory address of a record metadata index in the RDB
 	int* getRecordMetadataIndexPtr(int iRecord) const;
 
@@ -0,0 +1,86 @@
+#include <DAFFReaderPool.h>
+
+#include <DAFFReader.h>
+
+DAFFReaderPool::DAFFReaderPool(int iNumReaders, size_t nCapacity) : m_nCapacity(nCapacity)
+{
+	reserve(iNumReaders);
+}
+
+DAFFReaderPool::~DAFFReaderPool()
+{
+	clear();
+}
+
+size_t DAFFReaderPool::getCapacity() const
+{
+	return m_nCapacity;
+}
+
+int DAFFReaderPool::getNumIdleReaders() const
+{
+	std::lock_guard<std::mutex> lock(m_mxIdleReaders);
+	return (int)m_vpIdleReaders.size();
+}
+
+void DAFFReaderPool::reserve(int iNumReaders)
+{
+	int iNumMissing = iNumReaders - getNumIdleReaders();
+
+	// The readers are created outside the lock
+	std::vector<DAFFReader*> vpReaders;
+	for (int i = 0; i < iNumMissing; i++)
+		vpReaders.push_back(createReader());
+
+	std::lock_guard<std::mutex> lock(m_mxIdleReaders);
+	m_vpIdleReaders.insert(m_vpIdleReaders.begin(), vpReaders.begin(), vpReaders.end());
+}
+
+DAFFReader* DAFFReaderPool::acquire()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mxIdleReaders);
+		if (!m_vpIdleReaders.empty()) {
+			DAFFReader* pReader = m_vpIdleReaders.back();
+			m_vpIdleReaders.pop_back();
+			return pReader;
+		}
+	}
+
+	return createReader();
+}
+
+void DAFFReaderPool::release(DAFFReader* pReader)
+{
+	if (pReader == NULL)
+		return;
+
+	// Users may have disabled keeping the capacity
+	pReader->closeFile();
+	pReader->setKeepCapacity(true);
+
+	std::lock_guard<std::mutex> lock(m_mxIdleReaders);
+	m_vpIdleReaders.push_back(pReader);
+}
+
+void DAFFReaderPool::clear()
+{
+	std::vector<DAFFReader*> vpReaders;
+	{
+		std::lock_guard<std::mutex> lock(m_mxIdleReaders);
+		vpReaders.swap(m_vpIdleReaders);
+	}
+
+	for (size_t i = 0; i < vpReaders.size(); i++)
+		delete vpReaders[i];
+}
+
+DAFFReader* DAFFReaderPool::createReader() const
+{
+	DAFFReader* pReader = DAFFReader::create();
+	if (m_nCapacity > 0)
+		pReader->reserveCapacity(m_nCapacity);
+	else
+		pReader->setKeepCapacity(true);
+	return pReader;
+}
@@ -0,0 +1,163 @@
+#include <DAFFRealtimeFilterSlot.h>
+
+#include <DAFFContentDFT.h>
+#include <DAFFContentIR.h>
+#include <DAFFContentMS.h>
+#include <DAFFInterpolator.h>
+#include <DAFFProperties.h>
+
+#include <cassert>
+
+#include "Utils.h"
+
+DAFFRealtimeFilterSlot::DAFFRealtimeFilterSlot(const DAFFContent* pContent)
+	: m_pContent(pContent), m_pContentIR(NULL), m_pContentMS(NULL), m_pContentDFT(NULL), m_pInterpolator(NULL),
+	  m_iNumChannels(0), m_iDataLength(0), m_iChannelStride(0), m_pfData(NULL), m_iBack(0), m_iLastPublished(-1),
+	  m_iTransit(1), m_iFront(2), m_iPrevious(3)
+{
+	assert(pContent != NULL);
+
+	switch (pContent->getProperties()->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		m_pContentIR = dynamic_cast<const DAFFContentIR*>(pContent);
+		break;
+	case DAFF_MAGNITUDE_SPECTRUM:
+		m_pContentMS = dynamic_cast<const DAFFContentMS*>(pContent);
+		break;
+	case DAFF_DFT_SPECTRUM:
+		m_pContentDFT = dynamic_cast<const DAFFContentDFT*>(pContent);
+		break;
+	}
+	m_pInterpolator = new DAFFInterpolator(pContent);
+
+	m_iNumChannels = pContent->getProperties()->getNumberOfChannels();
+	m_iDataLength = m_pInterpolator->getDataLength();
+
+	// Channels are 16-byte aligned
+	m_iChannelStride = (m_iDataLength + 3) / 4 * 4;
+	size_t nBytes = (size_t)NUM_BUFFERS * m_iNumChannels * m_iChannelStride * sizeof(float);
+	m_pfData = static_cast<float*>(DAFF::malloc_aligned16(nBytes));
+	if (m_pfData)
+		memset(m_pfData, 0, nBytes);
+
+	for (int i = 0; i < NUM_BUFFERS; i++)
+		m_piRecord[i] = -1;
+}
+
+DAFFRealtimeFilterSlot::~DAFFRealtimeFilterSlot()
+{
+	DAFF::free_aligned16(m_pfData);
+	delete m_pInterpolator;
+}
+
+const DAFFContent* DAFFRealtimeFilterSlot::getContent() const
+{
+	return m_pContent;
+}
+
+int DAFFRealtimeFilterSlot::getNumChannels() const
+{
+	return m_iNumChannels;
+}
+
+int DAFFRealtimeFilterSlot::getDataLength() const
+{
+	return m_iDataLength;
+}
+
+int DAFFRealtimeFilterSlot::updateRecord(int iRecordIndex)
+{
+	if (!m_pfData || (!m_pContentIR && !m_pContentMS && !m_pContentDFT))
+		return DAFF_MODAL_ERROR;
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_pContent->getProperties()->getNumberOfRecords()))
+		return DAFF_INVALID_INDEX;
+
+	for (int c = 0; c < m_iNumChannels; c++) {
+		float* pfDest = getChannelData(m_iBack, c);
+
+		int iError;
+		if (m_pContentIR)
+			iError = m_pContentIR->getFilterCoeffs(iRecordIndex, c, pfDest);
+		else if (m_pContentMS)
+			iError = m_pContentMS->getMagnitudes(iRecordIndex, c, pfDest);
+		else
+			iError = m_pContentDFT->getDFTCoeffs(iRecordIndex, c, pfDest);
+
+		if (iError != DAFF_NO_ERROR)
+			return iError;
+	}
+
+	publish(iRecordIndex);
+	return DAFF_NO_ERROR;
+}
+
+int DAFFRealtimeFilterSlot::updateNearest(int iView, float fAngle1Deg, float fAngle2Deg)
+{
+	int iRecordIndex;
+	m_pContent->getNearestNeighbour(iView, fAngle1Deg, fAngle2Deg, iRecordIndex);
+
+	if (iRecordIndex == m_iLastPublished)
+		return DAFF_NO_ERROR;
+
+	return updateRecord(iRecordIndex);
+}
+
+int DAFFRealtimeFilterSlot::updateInterpolated(int iView, float fAngle1Deg, float fAngle2Deg)
+{
+	if (!m_pfData || (m_iDataLength == 0))
+		return DAFF_MODAL_ERROR;
+
+	for (int c = 0; c < m_iNumChannels; c++) {
+		int iError = m_pInterpolator->interpolate(iView, fAngle1Deg, fAngle2Deg, c, getChannelData(m_iBack, c));
+		if (iError != DAFF_NO_ERROR)
+			return iError;
+	}
+
+	publish(-1);
+	return DAFF_NO_ERROR;
+}
+
+bool DAFFRealtimeFilterSlot::acquire()
+{
+	if ((m_iTransit.load(std::memory_order_relaxed) & FLAG_PUBLISHED) == 0)
+		return false;
+
+	// Take the published buffer, hand back the one that is not needed anymore
+	int iTransit = m_iTransit.exchange(m_iPrevious, std::memory_order_acq_rel);
+	m_iPrevious = m_iFront;
+	m_iFront = iTransit & ~FLAG_PUBLISHED;
+	return true;
+}
+
+const float* DAFFRealtimeFilterSlot::getFilter(int iChannel) const
+{
+	assert((iChannel >= 0) && (iChannel < m_iNumChannels));
+	return (m_pfData ? getChannelData(m_iFront, iChannel) : NULL);
+}
+
+const float* DAFFRealtimeFilterSlot::getPreviousFilter(int iChannel) const
+{
+	assert((iChannel >= 0) && (iChannel < m_iNumChannels));
+	return (m_pfData ? getChannelData(m_iPrevious, iChannel) : NULL);
+}
+
+int DAFFRealtimeFilterSlot::getRecordIndex() const
+{
+	return m_piRecord[m_iFront];
+}
+
+float* DAFFRealtimeFilterSlot::getChannelData(int iBuffer, int iChannel) const
+{
+	return m_pfData + ((size_t)iBuffer * m_iNumChannels + iChannel) * m_iChannelStride;
+}
+
+void DAFFRealtimeFilterSlot::publish(int iRecordIndex)
+{
+	m_piRecord[m_iBack] = iRecordIndex;
+	m_iLastPublished = iRecordIndex;
+
+	// An unacquired buffer in transit is replaced and becomes the next back buffer
+	int iTransit = m_iTransit.exchange(m_iBack | FLAG_PUBLISHED, std::memory_order_acq_rel);
+	m_iBack = iTransit & ~FLAG_PUBLISHED;
+}
@@ -0,0 +1,90 @@
+#include "DAFFRecordCache.h"
+
+#include "Utils.h"
+
+DAFFRecordCache::DAFFRecordCache(size_t nMaxBytes) : m_nSize(0), m_nMaxSize(nMaxBytes) {}
+
+DAFFRecordCache::~DAFFRecordCache()
+{
+	clear();
+}
+
+size_t DAFFRecordCache::getMaxSize() const
+{
+	return m_nMaxSize;
+}
+
+void DAFFRecordCache::setMaxSize(size_t nMaxBytes)
+{
+	m_nMaxSize = nMaxBytes;
+	evict();
+}
+
+size_t DAFFRecordCache::getSize() const
+{
+	return m_nSize;
+}
+
+void* DAFFRecordCache::find(int64_t iKey)
+{
+	std::map<int64_t, std::list<Entry>::iterator>::iterator it = m_mIndex.find(iKey);
+	if (it == m_mIndex.end())
+		return NULL;
+
+	// Move to front (most recently used)
+	m_lEntries.splice(m_lEntries.begin(), m_lEntries, it->second);
+	return it->second->pData;
+}
+
+void* DAFFRecordCache::insert(int64_t iKey, size_t nBytes)
+{
+	erase(iKey);
+
+	Entry e;
+	e.iKey = iKey;
+	e.nSize = nBytes;
+	e.pData = DAFF::malloc_aligned64(nBytes > 0 ? nBytes : 1);
+	if (e.pData == NULL)
+		return NULL;
+
+	m_lEntries.push_front(e);
+	m_mIndex[iKey] = m_lEntries.begin();
+	m_nSize += nBytes;
+
+	evict();
+
+	return e.pData;
+}
+
+void DAFFRecordCache::erase(int64_t iKey)
+{
+	std::map<int64_t, std::list<Entry>::iterator>::iterator it = m_mIndex.find(iKey);
+	if (it == m_mIndex.end())
+		return;
+
+	m_nSize -= it->second->nSize;
+	DAFF::free_aligned64(it->second->pData);
+	m_lEntries.erase(it->second);
+	m_mIndex.erase(it);
+}
+
+void DAFFRecordCache::clear()
+{
+	for (std::list<Entry>::iterator it = m_lEntries.begin(); it != m_lEntries.end(); ++it)
+		DAFF::free_aligned64(it->pData);
+
+	m_lEntries.clear();
+	m_mIndex.clear();
+	m_nSize = 0;
+}
+
+void DAFFRecordCache::evict()
+{
+	while ((m_nSize > m_nMaxSize) && (m_lEntries.size() > 1)) {
+		Entry& e = m_lEntries.back();
+		m_nSize -= e.nSize;
+		DAFF::free_aligned64(e.pData);
+		m_mIndex.erase(e.iKey);
+		m_lEntries.pop_back();
+	}
+}
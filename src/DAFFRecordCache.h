@@ -0,0 +1,75 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_RECORDCACHE
+#define IW_DAFF_RECORDCACHE
+
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+#include <list>
+#include <map>
+
+//! Bounded least-recently-used cache of record channel data
+/**
+ * Used by the reader for on-demand loading of record data. Entries are
+ * identified by a key (record index * number of channels + channel index)
+ * and hold the endianness corrected data of one record channel in a 64-byte
+ * aligned buffer. If the cache exceeds its maximum size, the least recently
+ * used entries are removed. The most recently inserted entry is never removed,
+ * so a pointer returned by find() or insert() stays valid until the next insert().
+ */
+class DAFFRecordCache {
+  public:
+	DAFFRecordCache(size_t nMaxBytes = 16 * 1024 * 1024);
+	~DAFFRecordCache();
+
+	//! Returns the maximum size of all cached data [Bytes]
+	size_t getMaxSize() const;
+
+	//! Sets the maximum size of all cached data [Bytes] and evicts entries if necessary
+	void setMaxSize(size_t nMaxBytes);
+
+	//! Returns the current size of all cached data [Bytes]
+	size_t getSize() const;
+
+	//! Returns the data of an entry and marks it as recently used (NULL if not cached)
+	void* find(int64_t iKey);
+
+	//! Allocates a new entry (previous data of the key is dropped)
+	/**
+	 * @return Buffer of nBytes, to be filled by the caller (NULL if the allocation failed)
+	 */
+	void* insert(int64_t iKey, size_t nBytes);
+
+	//! Removes an entry (if cached)
+	void erase(int64_t iKey);
+
+	//! Removes all entries
+	void clear();
+
+  private:
+	struct Entry {
+		int64_t iKey;  //!@ Entry key
+		void* pData;   //!@ Aligned data buffer
+		size_t nSize;  //!@ Size of data buffer [Bytes]
+	};
+
+	std::list<Entry> m_lEntries;                             //!@ Entries, most recently used first
+	std::map<int64_t, std::list<Entry>::iterator> m_mIndex;  //!@ Lookup of entries by key
+	size_t m_nSize;                                          //!@ Current size of all cached data [Bytes]
+	size_t m_nMaxSize;                                       //!@ Maximum size of all cached data [Bytes]
+
+	//! Removes least recently used entries until the maximum size is met (keeps the front entry)
+	void evict();
+};
+
+#endif  // IW_DAFF_RECORDCACHE
@@ -3,8 +3,28 @@
 
 #include <cmath>
 
+#include "DAFFSIMD.h"
 #include "Utils.h"
 
+// Batch rotation kernel, selected once for the host CPU (NULL: scalar double precision fallback)
+typedef void (*SCRotateKernel)(const DAFF::SCRotation&, const float*, const float*, float*, float*, size_t);
+
+static SCRotateKernel select_sc_rotate_kernel()
+{
+	if (DAFF::simd_avx2_compiled() && DAFF::cpu_supports_avx2())
+		return &DAFF::simd_sc_rotate_avx2;
+
+#if defined(DAFF_SIMD_SSE2)
+	return &DAFF::simd_sc_rotate<DAFF::VecSSE2>;
+#elif defined(DAFF_SIMD_NEON)
+	return &DAFF::simd_sc_rotate<DAFF::VecNEON>;
+#else
+	return NULL;
+#endif
+}
+
+static const SCRotateKernel g_pfnSCRotate = select_sc_rotate_kernel();
+
 DAFFSCTransform::DAFFSCTransform(const DAFFOrientationYPR& orient)
 {
 	setOrientation(orient);
@@ -22,6 +42,13 @@ void DAFFSCTransform::setOrientation(const DAFFOrientationYPR& orient)
 	m_const.Init(m_orient.fYawAngleDeg, m_orient.fPitchAngleDeg, m_orient.fRollAngleDeg);
 }
 
+void DAFFSCTransform::getRotationConstants(double* pdConstants) const
+{
+	pdConstants[0] = m_const.t1, pdConstants[1] = m_const.t2, pdConstants[2] = m_const.t3;
+	pdConstants[3] = m_const.t4, pdConstants[4] = m_const.t5, pdConstants[5] = m_const.t6;
+	pdConstants[6] = m_const.t7, pdConstants[7] = m_const.t8, pdConstants[8] = m_const.t9;
+}
+
 /* Transformation functions
 
 	These transformations perform angular conversions between two spherical coordinate systems,
@@ -83,6 +110,25 @@ void DAFFSCTransform::transformOSC2DSC(double azimuth_in, double elevation_in, d
 	beta_out = DAFFUtils::rad2grad(eo) + 90.0F;  // Translate into DSC (b=e+90)
 }
 
+void DAFFSCTransform::transformOSC2DSC(const float* azimuth_in, const float* elevation_in, float* alpha_out,
+									   float* beta_out, size_t n) const
+{
+	DAFF::SCRotation rot;
+	rot.a[0] = float(m_const.t1), rot.a[1] = float(-m_const.t2), rot.a[2] = float(m_const.t3);
+	rot.b[0] = float(m_const.t4), rot.b[1] = float(-m_const.t5), rot.b[2] = float(m_const.t6);
+	rot.c[0] = float(m_const.t7), rot.c[1] = float(m_const.t8), rot.c[2] = float(m_const.t9);
+	rot.fInOffset2 = 0.0f;
+	rot.fOutOffset2 = 90.0f;  // Translate into DSC (b=e+90)
+
+	if (g_pfnSCRotate) {
+		g_pfnSCRotate(rot, azimuth_in, elevation_in, alpha_out, beta_out, n);
+		return;
+	}
+
+	for (size_t i = 0; i < n; i++)
+		transformOSC2DSC(azimuth_in[i], elevation_in[i], alpha_out[i], beta_out[i]);
+}
+
 void DAFFSCTransform::transformDSC2OSC(float alpha_in, float beta_in, float& azimuth_out, float& elevation_out) const
 {
 	double a, e;
@@ -115,6 +161,26 @@ void DAFFSCTransform::transformDSC2OSC(double alpha_in, double beta_in, double&
 	elevation_out = DAFFUtils::rad2grad(eo);
 }
 
+void DAFFSCTransform::transformDSC2OSC(const float* alpha_in, const float* beta_in, float* azimuth_out,
+									   float* elevation_out, size_t n) const
+{
+	// Transposed rotation, elevation with inverted sign (eo = -asin(...))
+	DAFF::SCRotation rot;
+	rot.a[0] = float(m_const.t1), rot.a[1] = float(m_const.t7), rot.a[2] = float(m_const.t4);
+	rot.b[0] = float(m_const.t3), rot.b[1] = float(m_const.t9), rot.b[2] = float(m_const.t6);
+	rot.c[0] = float(-m_const.t2), rot.c[1] = float(m_const.t8), rot.c[2] = float(-m_const.t5);
+	rot.fInOffset2 = -90.0f;  // Translate into OSC (e=b-90)
+	rot.fOutOffset2 = 0.0f;
+
+	if (g_pfnSCRotate) {
+		g_pfnSCRotate(rot, alpha_in, beta_in, azimuth_out, elevation_out, n);
+		return;
+	}
+
+	for (size_t i = 0; i < n; i++)
+		transformDSC2OSC(alpha_in[i], beta_in[i], azimuth_out[i], elevation_out[i]);
+}
+
 void DAFFSCTransform::RotationConstants::Init(double yaw, double pitch, double roll)
 {
 	double y = DAFFUtils::grad2rad(yaw);
@@ -0,0 +1,784 @@
+#include <DAFFSHExpansion.h>
+
+#include <DAFFContent.h>
+#include <DAFFContentDFT.h>
+#include <DAFFContentIR.h>
+#include <DAFFContentMPS.h>
+#include <DAFFContentMS.h>
+#include <DAFFContentPS.h>
+#include <DAFFProperties.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <system_error>
+#include <thread>
+
+#include "DAFFSIMD.h"
+#include "Utils.h"
+
+//! Signature of spherical harmonic expansion files
+static const char DAFF_SH_SIGNATURE[4] = { 'D', 'S', 'H', 'C' };
+
+//! Version of the spherical harmonic expansion file format
+static const int DAFF_SH_VERSION = 1;
+
+//! Number of records (fit) or directions (evaluation) whose spherical harmonics are computed at once
+static const int DAFF_SH_BLOCK_SIZE = 64;
+
+//! Records of a fit, shared by the fitting threads
+struct DAFFSHFitJob {
+	const DAFFContentIR* pContentIR;    //!@ Content as impulse responses (or NULL)
+	const DAFFContentMS* pContentMS;    //!@ Content as magnitude spectra (or NULL)
+	const DAFFContentPS* pContentPS;    //!@ Content as phase spectra (or NULL)
+	const DAFFContentMPS* pContentMPS;  //!@ Content as magnitude-phase spectra (or NULL)
+	const DAFFContentDFT* pContentDFT;  //!@ Content as DFT spectra (or NULL)
+	int iOrder;                         //!@ Order
+	int iNumChannels;                   //!@ Number of channels
+	int iDataLength;                    //!@ Number of values per channel
+	const float* pfRecurrence;          //!@ Recurrence factors of the spherical harmonics
+	std::vector<float> vfAlpha;         //!@ Alpha angles of the records (DSC) [degrees]
+	std::vector<float> vfBeta;          //!@ Beta angles of the records (DSC) [degrees]
+	std::vector<double> vdWeights;      //!@ Quadrature weights of the records
+	std::atomic<int> iNextBlock;        //!@ Next block of records to be accumulated
+	std::atomic<int> iError;            //!@ First error of a thread
+};
+
+//! Sums of a fitting thread
+struct DAFFSHFitSums {
+	std::vector<double> vdNormal;  //!@ Normal matrix (lower triangle) [sh][sh]
+	std::vector<double> vdRHS;     //!@ Right hand sides [channel][sh][value]
+};
+
+//! Reads the values of a record channel
+static int getValues(const DAFFSHFitJob* pJob, int iRecordIndex, int iChannel, float* pfDest)
+{
+	if (pJob->pContentIR)
+		return pJob->pContentIR->getFilterCoeffs(iRecordIndex, iChannel, pfDest);
+	if (pJob->pContentMS)
+		return pJob->pContentMS->getMagnitudes(iRecordIndex, iChannel, pfDest);
+	if (pJob->pContentPS)
+		return pJob->pContentPS->getPhases(iRecordIndex, iChannel, pfDest);
+	if (pJob->pContentMPS)
+		return pJob->pContentMPS->getCoefficientsRI(iRecordIndex, iChannel, pfDest);
+	return pJob->pContentDFT->getDFTCoeffs(iRecordIndex, iChannel, pfDest);
+}
+
+//! Accumulates the weighted normal equations of record blocks until all have been taken
+static void accumulateRecords(DAFFSHFitJob* pJob, DAFFSHFitSums* pSums)
+{
+	const int M = (pJob->iOrder + 1) * (pJob->iOrder + 1);
+	const int L = pJob->iDataLength;
+	const int iNumRecords = (int)pJob->vfAlpha.size();
+
+	pSums->vdNormal.assign((size_t)M * M, 0.0);
+	pSums->vdRHS.assign((size_t)pJob->iNumChannels * M * L, 0.0);
+
+	std::vector<float> vfBasis((size_t)DAFF_SH_BLOCK_SIZE * M);
+	std::vector<float> vfValues(L);
+	for (int iBegin = DAFF_SH_BLOCK_SIZE * pJob->iNextBlock++;
+		 (iBegin < iNumRecords) && (pJob->iError == DAFF_NO_ERROR); iBegin = DAFF_SH_BLOCK_SIZE * pJob->iNextBlock++) {
+		int iEnd = std::min(iBegin + DAFF_SH_BLOCK_SIZE, iNumRecords);
+		DAFF::sh_basis_float(&vfBasis[0], pJob->pfRecurrence, pJob->iOrder, &pJob->vfAlpha[iBegin],
+							 &pJob->vfBeta[iBegin], iEnd - iBegin);
+
+		for (int r = iBegin; r < iEnd; r++) {
+			const float* pfY = &vfBasis[(size_t)(r - iBegin) * M];
+			double dWeight = pJob->vdWeights[r];
+
+			for (int i = 0; i < M; i++) {
+				double dWY = dWeight * pfY[i];
+				double* pdRow = &pSums->vdNormal[(size_t)i * M];
+				for (int j = 0; j <= i; j++)
+					pdRow[j] += dWY * pfY[j];
+			}
+
+			for (int c = 0; c < pJob->iNumChannels; c++) {
+				int iError = getValues(pJob, r, c, &vfValues[0]);
+				if (iError != DAFF_NO_ERROR) {
+					int iNoError = DAFF_NO_ERROR;
+					pJob->iError.compare_exchange_strong(iNoError, iError);
+					return;
+				}
+
+				for (int i = 0; i < M; i++) {
+					double dWY = dWeight * pfY[i];
+					double* pdRHS = &pSums->vdRHS[((size_t)c * M + i) * L];
+					for (int j = 0; j < L; j++)
+						pdRHS[j] += dWY * vfValues[j];
+				}
+			}
+		}
+	}
+}
+
+//! Determines the directions (DSC) and quadrature weights of the records of a content
+static void setupRecords(const DAFFContent* pContent, DAFFSHFitJob* pJob)
+{
+	const DAFFProperties* pProps = pContent->getProperties();
+	int iNumRecords = pProps->getNumberOfRecords();
+
+	pJob->vfAlpha.resize(iNumRecords);
+	pJob->vfBeta.resize(iNumRecords);
+	for (int r = 0; r < iNumRecords; r++)
+		pContent->getRecordCoords(r, DAFF_DATA_VIEW, pJob->vfAlpha[r], pJob->vfBeta[r]);
+
+	// Quadrature weights: the records of a regular grid share the solid angle of their latitude band
+	const double dDeg2Rad = 0.017453292519943295;
+	if (pProps->isRegularGrid()) {
+		std::map<float, int> mBandRecords;
+		for (int r = 0; r < iNumRecords; r++)
+			mBandRecords[pJob->vfBeta[r]]++;
+
+		double dHalfStep = 0.5 * pProps->getBetaResolution();
+		pJob->vdWeights.resize(iNumRecords);
+		for (int r = 0; r < iNumRecords; r++) {
+			double dLower = std::max(pJob->vfBeta[r] - dHalfStep, 0.0);
+			double dUpper = std::min(pJob->vfBeta[r] + dHalfStep, 180.0);
+			double dBand = 2 * 3.14159265358979323846 * (std::cos(dLower * dDeg2Rad) - std::cos(dUpper * dDeg2Rad));
+			pJob->vdWeights[r] = dBand / mBandRecords[pJob->vfBeta[r]];
+		}
+	} else {
+		pJob->vdWeights.assign(iNumRecords, 4 * 3.14159265358979323846 / iNumRecords);
+	}
+}
+
+//! Accumulates the normal equations of all records with several threads (0: automatic)
+static int accumulateNormalEquations(DAFFSHFitJob* pJob, int iNumThreads, DAFFSHFitSums& oSums)
+{
+	pJob->iNextBlock = 0;
+	pJob->iError = DAFF_NO_ERROR;
+
+	int iNumRecords = (int)pJob->vfAlpha.size();
+	int iNumBlocks = (iNumRecords + DAFF_SH_BLOCK_SIZE - 1) / DAFF_SH_BLOCK_SIZE;
+	if (iNumThreads <= 0)
+		iNumThreads = (int)std::max(std::thread::hardware_concurrency(), 1u);
+	iNumThreads = std::max(std::min(iNumThreads, iNumBlocks), 1);
+
+	// The calling thread accumulates as well
+	std::vector<DAFFSHFitSums> vSums(iNumThreads);
+	std::vector<std::thread> vThreads;
+	try {
+		for (int i = 1; i < iNumThreads; i++)
+			vThreads.push_back(std::thread(&accumulateRecords, pJob, &vSums[i]));
+	} catch (const std::system_error&) {
+		// Not enough threads available, accumulate with the ones started
+	}
+
+	accumulateRecords(pJob, &vSums[0]);
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	if (pJob->iError != DAFF_NO_ERROR)
+		return pJob->iError;
+
+	oSums.vdNormal.swap(vSums[0].vdNormal);
+	oSums.vdRHS.swap(vSums[0].vdRHS);
+	for (size_t t = 1; t <= vThreads.size(); t++) {
+		for (size_t i = 0; i < oSums.vdNormal.size(); i++)
+			oSums.vdNormal[i] += vSums[t].vdNormal[i];
+		for (size_t i = 0; i < oSums.vdRHS.size(); i++)
+			oSums.vdRHS[i] += vSums[t].vdRHS[i];
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+//! Cholesky decomposition of a symmetric matrix given by its lower triangle, in place (false if not positive definite)
+static bool choleskyDecompose(double* pdMatrix, int M)
+{
+	for (int j = 0; j < M; j++) {
+		double* pdRowJ = pdMatrix + (size_t)j * M;
+		double d = pdRowJ[j];
+		for (int k = 0; k < j; k++)
+			d -= pdRowJ[k] * pdRowJ[k];
+		if (!(d > 0))
+			return false;
+		pdRowJ[j] = std::sqrt(d);
+
+		for (int i = j + 1; i < M; i++) {
+			double* pdRowI = pdMatrix + (size_t)i * M;
+			double s = pdRowI[j];
+			for (int k = 0; k < j; k++)
+				s -= pdRowI[k] * pdRowJ[k];
+			pdRowI[j] = s / pdRowJ[j];
+		}
+	}
+	return true;
+}
+
+//! Solves (L L^T) X = B for the M rows of L values of B in place (L: Cholesky factor)
+static void choleskySolve(const double* pdFactor, int M, double* pdRHS, int L)
+{
+	// Forward substitution L Y = B
+	for (int i = 0; i < M; i++) {
+		double* pdRowI = pdRHS + (size_t)i * L;
+		for (int k = 0; k < i; k++) {
+			double f = pdFactor[(size_t)i * M + k];
+			const double* pdRowK = pdRHS + (size_t)k * L;
+			for (int j = 0; j < L; j++)
+				pdRowI[j] -= f * pdRowK[j];
+		}
+		double f = 1.0 / pdFactor[(size_t)i * M + i];
+		for (int j = 0; j < L; j++)
+			pdRowI[j] *= f;
+	}
+
+	// Backward substitution L^T X = Y
+	for (int i = M - 1; i >= 0; i--) {
+		double* pdRowI = pdRHS + (size_t)i * L;
+		for (int k = i + 1; k < M; k++) {
+			double f = pdFactor[(size_t)k * M + i];
+			const double* pdRowK = pdRHS + (size_t)k * L;
+			for (int j = 0; j < L; j++)
+				pdRowI[j] -= f * pdRowK[j];
+		}
+		double f = 1.0 / pdFactor[(size_t)i * M + i];
+		for (int j = 0; j < L; j++)
+			pdRowI[j] *= f;
+	}
+}
+
+//! Adds the Tikhonov regularization relative to the mean diagonal and decomposes the normal matrix in place
+static bool decomposeNormalMatrix(double* pdNormal, int M, float fRegularization)
+{
+	double dTrace = 0;
+	for (int i = 0; i < M; i++)
+		dTrace += pdNormal[(size_t)i * M + i];
+	for (int i = 0; i < M; i++)
+		pdNormal[(size_t)i * M + i] += fRegularization * dTrace / M;
+
+	return choleskyDecompose(pdNormal, M);
+}
+
+//! DFT coefficients of a magnitude least squares fit, shared by the fitting threads
+struct DAFFSHMagLSJob {
+	const DAFFContentDFT* pContent;  //!@ DFT spectra
+	int iNumSHCoeffs;                //!@ Number of spherical harmonics
+	int iNumRecords;                 //!@ Number of records
+	int iNumChannels;                //!@ Number of channels
+	int iNumDFTCoeffs;               //!@ Number of DFT coefficients per channel
+	int iFirstMagnitudeCoeff;        //!@ First DFT coefficient fitted in magnitude only (above the cutoff)
+	int iNumIterations;              //!@ Phase iterations of the coefficients fitted in magnitude
+	const double* pdFactor;          //!@ Cholesky factor of the regularized normal matrix
+	const float* pfBasis;            //!@ Spherical harmonics of the records [record][sh]
+	const double* pdWeights;         //!@ Quadrature weights of the records
+	float* pfCoeffs;                 //!@ Destination [channel][sh][2*DFT coefficients]
+	std::atomic<int> iNext;          //!@ Next channel and DFT coefficient (channel * coefficients + coefficient)
+	std::atomic<int> iError;         //!@ First error of a thread
+};
+
+//! Fits complex values of all records (interleaved) by weighted least squares, pdDest: [sh][real, imaginary]
+static void fitComplex(const DAFFSHMagLSJob* pJob, const float* pfValues, double* pdDest)
+{
+	const int M = pJob->iNumSHCoeffs;
+
+	std::fill(pdDest, pdDest + 2 * M, 0.0);
+	for (int r = 0; r < pJob->iNumRecords; r++) {
+		const float* pfY = pJob->pfBasis + (size_t)r * M;
+		double dReal = pJob->pdWeights[r] * pfValues[2 * r];
+		double dImag = pJob->pdWeights[r] * pfValues[2 * r + 1];
+		for (int i = 0; i < M; i++) {
+			pdDest[2 * i] += dReal * pfY[i];
+			pdDest[2 * i + 1] += dImag * pfY[i];
+		}
+	}
+
+	choleskySolve(pJob->pdFactor, M, pdDest, 2);
+}
+
+//! Fits DFT coefficients until all have been taken
+static void fitDFTCoeffs(DAFFSHMagLSJob* pJob)
+{
+	const int M = pJob->iNumSHCoeffs;
+	const int K = pJob->iNumDFTCoeffs;
+	const int iNumRecords = pJob->iNumRecords;
+
+	std::vector<float> vfValues(2 * (size_t)iNumRecords);
+	std::vector<float> vfMagnitudes(iNumRecords);
+	std::vector<double> vdCoeffs(2 * (size_t)M);
+	for (int i = pJob->iNext++; (i < pJob->iNumChannels * K) && (pJob->iError == DAFF_NO_ERROR); i = pJob->iNext++) {
+		int c = i / K;
+		int k = i % K;
+		int iError = pJob->pContent->getDFTCoeffSlice(c, k, &vfValues[0]);
+		if (iError != DAFF_NO_ERROR) {
+			int iNoError = DAFF_NO_ERROR;
+			pJob->iError.compare_exchange_strong(iNoError, iError);
+			return;
+		}
+
+		// Complex least squares, the starting point of the magnitude fit
+		fitComplex(pJob, &vfValues[0], &vdCoeffs[0]);
+
+		// Above the cutoff the phases of the records are replaced by the phases of the expansion
+		if (k >= pJob->iFirstMagnitudeCoeff) {
+			for (int r = 0; r < iNumRecords; r++) {
+				float fReal = vfValues[2 * r], fImag = vfValues[2 * r + 1];
+				vfMagnitudes[r] = std::sqrt(fReal * fReal + fImag * fImag);
+			}
+
+			for (int n = 0; n < pJob->iNumIterations; n++) {
+				for (int r = 0; r < iNumRecords; r++) {
+					const float* pfY = pJob->pfBasis + (size_t)r * M;
+					double dReal = 0, dImag = 0;
+					for (int j = 0; j < M; j++) {
+						dReal += vdCoeffs[2 * j] * pfY[j];
+						dImag += vdCoeffs[2 * j + 1] * pfY[j];
+					}
+
+					double dAbs = std::sqrt(dReal * dReal + dImag * dImag);
+					if (dAbs > 0) {
+						vfValues[2 * r] = (float)(vfMagnitudes[r] * dReal / dAbs);
+						vfValues[2 * r + 1] = (float)(vfMagnitudes[r] * dImag / dAbs);
+					} else {
+						vfValues[2 * r] = vfMagnitudes[r];
+						vfValues[2 * r + 1] = 0.0f;
+					}
+				}
+
+				fitComplex(pJob, &vfValues[0], &vdCoeffs[0]);
+			}
+		}
+
+		float* pfDest = pJob->pfCoeffs + (size_t)c * M * 2 * K + 2 * k;
+		for (int j = 0; j < M; j++) {
+			pfDest[(size_t)j * 2 * K] = (float)vdCoeffs[2 * j];
+			pfDest[(size_t)j * 2 * K + 1] = (float)vdCoeffs[2 * j + 1];
+		}
+	}
+}
+
+DAFFSHExpansion::DAFFSHExpansion()
+	: m_iOrder(-1), m_iContentType(-1), m_iNumChannels(0), m_iDataLength(0), m_fRegularization(1e-4f),
+	  m_iNumThreads(0)
+{
+	m_oTransform.setOrientation(DAFFOrientationYPR());
+}
+
+DAFFSHExpansion::~DAFFSHExpansion() {}
+
+bool DAFFSHExpansion::isValid() const
+{
+	return (m_iOrder >= 0);
+}
+
+int DAFFSHExpansion::getOrder() const
+{
+	return m_iOrder;
+}
+
+int DAFFSHExpansion::getNumSHCoeffs() const
+{
+	return (m_iOrder + 1) * (m_iOrder + 1);
+}
+
+int DAFFSHExpansion::getContentType() const
+{
+	return m_iContentType;
+}
+
+int DAFFSHExpansion::getNumChannels() const
+{
+	return m_iNumChannels;
+}
+
+int DAFFSHExpansion::getDataLength() const
+{
+	return m_iDataLength;
+}
+
+float DAFFSHExpansion::getRegularization() const
+{
+	return m_fRegularization;
+}
+
+void DAFFSHExpansion::setRegularization(float fRegularization)
+{
+	m_fRegularization = (fRegularization > 0 ? fRegularization : 0.0f);
+}
+
+int DAFFSHExpansion::getNumThreads() const
+{
+	return m_iNumThreads;
+}
+
+void DAFFSHExpansion::setNumThreads(int iNumThreads)
+{
+	m_iNumThreads = (iNumThreads > 0 ? iNumThreads : 0);
+}
+
+void DAFFSHExpansion::getOrientation(DAFFOrientationYPR& o) const
+{
+	m_oTransform.getOrientation(o);
+}
+
+void DAFFSHExpansion::setOrientation(const DAFFOrientationYPR& o)
+{
+	m_oTransform.setOrientation(o);
+}
+
+void DAFFSHExpansion::clear()
+{
+	m_iOrder = -1;
+	m_iContentType = -1;
+	m_iNumChannels = 0;
+	m_iDataLength = 0;
+	std::vector<float>().swap(m_vfRecurrence);
+	std::vector<float>().swap(m_vfCoeffs);
+	std::vector<const float*>().swap(m_vpfRows);
+}
+
+void DAFFSHExpansion::init(int iOrder, int iContentType, int iNumChannels, int iDataLength)
+{
+	m_iOrder = iOrder;
+	m_iContentType = iContentType;
+	m_iNumChannels = iNumChannels;
+	m_iDataLength = iDataLength;
+
+	m_vfRecurrence.resize(DAFF::sh_recurrence_size(iOrder));
+	DAFF::sh_recurrence(iOrder, &m_vfRecurrence[0]);
+
+	int M = getNumSHCoeffs();
+	m_vfCoeffs.assign((size_t)iNumChannels * M * iDataLength, 0.0f);
+	m_vpfRows.resize((size_t)iNumChannels * M);
+	for (size_t i = 0; i < m_vpfRows.size(); i++)
+		m_vpfRows[i] = &m_vfCoeffs[i * iDataLength];
+}
+
+int DAFFSHExpansion::fit(const DAFFContent* pContent, int iOrder)
+{
+	clear();
+
+	assert(pContent != NULL);
+	assert((iOrder >= 0) && (iOrder <= MAX_ORDER));
+
+	if (!pContent || (iOrder < 0) || (iOrder > MAX_ORDER))
+		return DAFF_MODAL_ERROR;
+
+	const DAFFProperties* pProps = pContent->getProperties();
+	DAFFSHFitJob oJob;
+	oJob.pContentIR = NULL;
+	oJob.pContentMS = NULL;
+	oJob.pContentPS = NULL;
+	oJob.pContentMPS = NULL;
+	oJob.pContentDFT = NULL;
+
+	int iDataLength = 0;
+	switch (pProps->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		oJob.pContentIR = dynamic_cast<const DAFFContentIR*>(pContent);
+		iDataLength = (oJob.pContentIR ? oJob.pContentIR->getFilterLength() : 0);
+		break;
+	case DAFF_MAGNITUDE_SPECTRUM:
+		oJob.pContentMS = dynamic_cast<const DAFFContentMS*>(pContent);
+		iDataLength = (oJob.pContentMS ? oJob.pContentMS->getNumFrequencies() : 0);
+		break;
+	case DAFF_PHASE_SPECTRUM:
+		oJob.pContentPS = dynamic_cast<const DAFFContentPS*>(pContent);
+		iDataLength = (oJob.pContentPS ? oJob.pContentPS->getNumFrequencies() : 0);
+		break;
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		oJob.pContentMPS = dynamic_cast<const DAFFContentMPS*>(pContent);
+		iDataLength = (oJob.pContentMPS ? 2 * oJob.pContentMPS->getNumFrequencies() : 0);
+		break;
+	case DAFF_DFT_SPECTRUM:
+		oJob.pContentDFT = dynamic_cast<const DAFFContentDFT*>(pContent);
+		iDataLength = (oJob.pContentDFT ? 2 * oJob.pContentDFT->getNumDFTCoeffs() : 0);
+		break;
+	}
+
+	int iNumRecords = pProps->getNumberOfRecords();
+	int iNumChannels = pProps->getNumberOfChannels();
+	if ((iDataLength <= 0) || (iNumRecords <= 0) || (iNumChannels <= 0))
+		return DAFF_MODAL_ERROR;
+
+	init(iOrder, pProps->getContentType(), iNumChannels, iDataLength);
+
+	oJob.iOrder = iOrder;
+	oJob.iNumChannels = iNumChannels;
+	oJob.iDataLength = iDataLength;
+	oJob.pfRecurrence = &m_vfRecurrence[0];
+	setupRecords(pContent, &oJob);
+
+	DAFFSHFitSums oSums;
+	int iError = accumulateNormalEquations(&oJob, m_iNumThreads, oSums);
+	if (iError != DAFF_NO_ERROR) {
+		clear();
+		return iError;
+	}
+
+	int M = getNumSHCoeffs();
+	if (!decomposeNormalMatrix(&oSums.vdNormal[0], M, m_fRegularization)) {
+		clear();
+		return DAFF_MODAL_ERROR;
+	}
+
+	for (int c = 0; c < iNumChannels; c++) {
+		double* pdRHS = &oSums.vdRHS[(size_t)c * M * iDataLength];
+		choleskySolve(&oSums.vdNormal[0], M, pdRHS, iDataLength);
+		for (size_t i = 0; i < (size_t)M * iDataLength; i++)
+			m_vfCoeffs[(size_t)c * M * iDataLength + i] = (float)pdRHS[i];
+	}
+
+	// The object view follows the orientation of the content
+	DAFFOrientationYPR oOrient;
+	pProps->getOrientation(oOrient);
+	m_oTransform.setOrientation(oOrient);
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFSHExpansion::fitMagLS(const DAFFContentDFT* pContent, int iOrder, float fCutoffFrequency, int iNumIterations)
+{
+	clear();
+
+	assert(pContent != NULL);
+	assert((iOrder >= 0) && (iOrder <= MAX_ORDER));
+
+	if (!pContent || (iOrder < 0) || (iOrder > MAX_ORDER))
+		return DAFF_MODAL_ERROR;
+
+	const DAFFProperties* pProps = pContent->getProperties();
+	int iNumRecords = pProps->getNumberOfRecords();
+	int iNumChannels = pProps->getNumberOfChannels();
+	int iNumDFTCoeffs = pContent->getNumDFTCoeffs();
+	if ((iNumDFTCoeffs <= 0) || (iNumRecords <= 0) || (iNumChannels <= 0))
+		return DAFF_MODAL_ERROR;
+
+	init(iOrder, DAFF_DFT_SPECTRUM, iNumChannels, 2 * iNumDFTCoeffs);
+	int M = getNumSHCoeffs();
+
+	// Normal matrix of the records (the same for all DFT coefficients)
+	DAFFSHFitJob oRecords;
+	oRecords.pContentIR = NULL;
+	oRecords.pContentMS = NULL;
+	oRecords.pContentPS = NULL;
+	oRecords.pContentMPS = NULL;
+	oRecords.pContentDFT = pContent;
+	oRecords.iOrder = iOrder;
+	oRecords.iNumChannels = 0;
+	oRecords.iDataLength = 0;
+	oRecords.pfRecurrence = &m_vfRecurrence[0];
+	setupRecords(pContent, &oRecords);
+
+	DAFFSHFitSums oSums;
+	accumulateNormalEquations(&oRecords, m_iNumThreads, oSums);
+	if (!decomposeNormalMatrix(&oSums.vdNormal[0], M, m_fRegularization)) {
+		clear();
+		return DAFF_MODAL_ERROR;
+	}
+
+	std::vector<float> vfBasis((size_t)iNumRecords * M);
+	DAFF::sh_basis_float(&vfBasis[0], &m_vfRecurrence[0], iOrder, &oRecords.vfAlpha[0], &oRecords.vfBeta[0],
+						 iNumRecords);
+
+	// Spatial aliasing of a head of 8.75 cm radius starts at N c / (2 pi r)
+	if (fCutoffFrequency <= 0)
+		fCutoffFrequency = (float)(iOrder * 343.0 / (2 * 3.14159265358979323846 * 0.0875));
+
+	DAFFSHMagLSJob oJob;
+	oJob.pContent = pContent;
+	oJob.iNumSHCoeffs = M;
+	oJob.iNumRecords = iNumRecords;
+	oJob.iNumChannels = iNumChannels;
+	oJob.iNumDFTCoeffs = iNumDFTCoeffs;
+	oJob.iFirstMagnitudeCoeff = (int)std::ceil(fCutoffFrequency / pContent->getFrequencyBandwidth());
+	oJob.iNumIterations = std::max(iNumIterations, 0);
+	oJob.pdFactor = &oSums.vdNormal[0];
+	oJob.pfBasis = &vfBasis[0];
+	oJob.pdWeights = &oRecords.vdWeights[0];
+	oJob.pfCoeffs = &m_vfCoeffs[0];
+	oJob.iNext = 0;
+	oJob.iError = DAFF_NO_ERROR;
+
+	int iNumThreads = m_iNumThreads;
+	if (iNumThreads <= 0)
+		iNumThreads = (int)std::max(std::thread::hardware_concurrency(), 1u);
+	iNumThreads = std::min(iNumThreads, iNumChannels * iNumDFTCoeffs);
+
+	// The calling thread fits as well
+	std::vector<std::thread> vThreads;
+	try {
+		for (int i = 1; i < iNumThreads; i++)
+			vThreads.push_back(std::thread(&fitDFTCoeffs, &oJob));
+	} catch (const std::system_error&) {
+		// Not enough threads available, fit with the ones started
+	}
+
+	fitDFTCoeffs(&oJob);
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	if (oJob.iError != DAFF_NO_ERROR) {
+		clear();
+		return oJob.iError;
+	}
+
+	DAFFOrientationYPR oOrient;
+	pProps->getOrientation(oOrient);
+	m_oTransform.setOrientation(oOrient);
+
+	return DAFF_NO_ERROR;
+}
+
+const float* DAFFSHExpansion::getCoefficientsPtr(int iChannel) const
+{
+	if (!isValid() || (iChannel < 0) || (iChannel >= m_iNumChannels))
+		return NULL;
+	return m_vpfRows[(size_t)iChannel * getNumSHCoeffs()];
+}
+
+int DAFFSHExpansion::evaluate(int iView, float fAngle1Deg, float fAngle2Deg, int iChannel, float* pfDest) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+	assert(pfDest != NULL);
+
+	if (!isValid() || ((iView != DAFF_DATA_VIEW) && (iView != DAFF_OBJECT_VIEW)))
+		return DAFF_MODAL_ERROR;
+	if ((iChannel < 0) || (iChannel >= m_iNumChannels))
+		return DAFF_INVALID_INDEX;
+
+	float fAlpha = fAngle1Deg;
+	float fBeta = fAngle2Deg;
+	if (iView == DAFF_OBJECT_VIEW)
+		m_oTransform.transformOSC2DSC(fAngle1Deg, fAngle2Deg, fAlpha, fBeta);
+
+	int M = getNumSHCoeffs();
+	float pfBasis[(MAX_ORDER + 1) * (MAX_ORDER + 1)];
+	DAFF::sh_basis_float(pfBasis, &m_vfRecurrence[0], m_iOrder, &fAlpha, &fBeta, 1);
+	DAFF::blend_float(pfDest, &m_vpfRows[(size_t)iChannel * M], pfBasis, M, m_iDataLength);
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFSHExpansion::evaluate(int iView, const float* pfAngles1Deg, const float* pfAngles2Deg, int iChannel,
+							  float* pfDest, size_t n) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	if (!isValid() || ((iView != DAFF_DATA_VIEW) && (iView != DAFF_OBJECT_VIEW)))
+		return DAFF_MODAL_ERROR;
+	if ((iChannel < 0) || (iChannel >= m_iNumChannels))
+		return DAFF_INVALID_INDEX;
+	if (n == 0)
+		return DAFF_NO_ERROR;
+
+	int M = getNumSHCoeffs();
+	const float* const* ppfRows = &m_vpfRows[(size_t)iChannel * M];
+	std::vector<float> vfBasis((size_t)DAFF_SH_BLOCK_SIZE * M);
+	float pfAlpha[DAFF_SH_BLOCK_SIZE], pfBeta[DAFF_SH_BLOCK_SIZE];
+
+	for (size_t nBegin = 0; nBegin < n; nBegin += DAFF_SH_BLOCK_SIZE) {
+		size_t nCount = std::min(n - nBegin, (size_t)DAFF_SH_BLOCK_SIZE);
+		const float* pfAlphaBlock = pfAngles1Deg + nBegin;
+		const float* pfBetaBlock = pfAngles2Deg + nBegin;
+		if (iView == DAFF_OBJECT_VIEW) {
+			m_oTransform.transformOSC2DSC(pfAlphaBlock, pfBetaBlock, pfAlpha, pfBeta, nCount);
+			pfAlphaBlock = pfAlpha;
+			pfBetaBlock = pfBeta;
+		}
+
+		DAFF::sh_basis_float(&vfBasis[0], &m_vfRecurrence[0], m_iOrder, pfAlphaBlock, pfBetaBlock, nCount);
+		for (size_t i = 0; i < nCount; i++)
+			DAFF::blend_float(pfDest + (nBegin + i) * m_iDataLength, ppfRows, &vfBasis[i * M], M, m_iDataLength);
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+void DAFFSHExpansion::getBasis(int iOrder, float fAlphaDeg, float fBetaDeg, float* pfDest)
+{
+	assert((iOrder >= 0) && (iOrder <= MAX_ORDER));
+	assert(pfDest != NULL);
+
+	std::vector<float> vfRecurrence(DAFF::sh_recurrence_size(iOrder));
+	DAFF::sh_recurrence(iOrder, &vfRecurrence[0]);
+	DAFF::sh_basis_float(pfDest, &vfRecurrence[0], iOrder, &fAlphaDeg, &fBetaDeg, 1);
+}
+
+int DAFFSHExpansion::save(const std::string& sFilePath) const
+{
+	if (!isValid())
+		return DAFF_MODAL_ERROR;
+
+	FILE* pFile = fopen(sFilePath.c_str(), "wb");
+	if (pFile == NULL)
+		return DAFF_FILE_NOT_FOUND;
+
+	// Header and data in little endian
+	DAFFOrientationYPR oOrient;
+	m_oTransform.getOrientation(oOrient);
+	int piHeader[5] = { DAFF_SH_VERSION, m_iOrder, m_iContentType, m_iNumChannels, m_iDataLength };
+	float pfHeader[4] = { m_fRegularization, oOrient.fYawAngleDeg, oOrient.fPitchAngleDeg, oOrient.fRollAngleDeg };
+	DAFF::le2se_4byte(piHeader, 5);
+	DAFF::le2se_4byte(pfHeader, 4);
+
+	bool bSuccess = (fwrite(DAFF_SH_SIGNATURE, 1, 4, pFile) == 4) && (fwrite(piHeader, 4, 5, pFile) == 5) &&
+					(fwrite(pfHeader, 4, 4, pFile) == 4);
+
+	std::vector<float> vfData(m_vfCoeffs);
+	DAFF::le2se_4byte(&vfData[0], vfData.size());
+	bSuccess = bSuccess && (fwrite(&vfData[0], 4, vfData.size(), pFile) == vfData.size());
+
+	bSuccess = (fclose(pFile) == 0) && bSuccess;
+	return (bSuccess ? DAFF_NO_ERROR : DAFF_FILE_NOT_FOUND);
+}
+
+int DAFFSHExpansion::load(const std::string& sFilePath)
+{
+	clear();
+
+	FILE* pFile = fopen(sFilePath.c_str(), "rb");
+	if (pFile == NULL)
+		return DAFF_FILE_NOT_FOUND;
+
+	char pcSignature[4];
+	int piHeader[5];
+	float pfHeader[4];
+	if ((fread(pcSignature, 1, 4, pFile) != 4) || (fread(piHeader, 4, 5, pFile) != 5) ||
+		(fread(pfHeader, 4, 4, pFile) != 4)) {
+		fclose(pFile);
+		return DAFF_FILE_CORRUPTED;
+	}
+	DAFF::le2se_4byte(piHeader, 5);
+	DAFF::le2se_4byte(pfHeader, 4);
+
+	int iError = DAFF_NO_ERROR;
+	if (memcmp(pcSignature, DAFF_SH_SIGNATURE, 4) != 0)
+		iError = DAFF_FILE_INVALID;
+	else if (piHeader[0] != DAFF_SH_VERSION)
+		iError = DAFF_FILE_FORMAT_VERSION_UNSUPPORTED;
+	else if ((piHeader[1] < 0) || (piHeader[1] > MAX_ORDER) || (piHeader[2] < DAFF_IMPULSE_RESPONSE) ||
+			 (piHeader[2] > DAFF_DFT_SPECTRUM) || (piHeader[3] <= 0) || (piHeader[4] <= 0))
+		iError = DAFF_FILE_CORRUPTED;
+	else if (DAFF::getFileSize(sFilePath) != 40 + 4 * (int64_t)piHeader[3] * (piHeader[1] + 1) * (piHeader[1] + 1) *
+												   piHeader[4])
+		iError = DAFF_FILE_CORRUPTED;  // Truncated file or implausible dimensions
+
+	if (iError == DAFF_NO_ERROR) {
+		init(piHeader[1], piHeader[2], piHeader[3], piHeader[4]);
+		bool bSuccess = (fread(&m_vfCoeffs[0], 4, m_vfCoeffs.size(), pFile) == m_vfCoeffs.size());
+		DAFF::le2se_4byte(&m_vfCoeffs[0], m_vfCoeffs.size());
+		if (!bSuccess)
+			iError = DAFF_FILE_CORRUPTED;
+	}
+	fclose(pFile);
+
+	if (iError != DAFF_NO_ERROR) {
+		clear();
+		return iError;
+	}
+
+	m_fRegularization = pfHeader[0];
+	m_oTransform.setOrientation(DAFFOrientationYPR(pfHeader[1], pfHeader[2], pfHeader[3]));
+	return DAFF_NO_ERROR;
+}
+
+size_t DAFFSHExpansion::getMemoryFootprint() const
+{
+	return (m_vfRecurrence.capacity() + m_vfCoeffs.capacity()) * sizeof(float) +
+		   m_vpfRows.capacity() * sizeof(const float*);
+}
@@ -0,0 +1,2029 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_SIMD
+#define IW_DAFF_SIMD
+
+/*
+ *  Library-internal SIMD kernels
+ *
+ *  The kernels are written once as templates over a vector type V, which provides
+ *  the basic operations on W single precision lanes. Instantiations exist for
+ *
+ *   - SSE2 (always available on x86-64, selected at compile time)
+ *   - AVX2 (instantiated in DAFFSIMDAVX2.cpp, which is compiled with AVX2 enabled,
+ *     and selected at runtime if the CPU supports it)
+ *   - NEON (AArch64, selected at compile time)
+ *   - F16C (half precision conversion, in DAFFSIMDAVX2.cpp, selected at runtime)
+ *
+ *  Platforms without any of these use the scalar code paths. x86 without AVX2
+ *  converts 24-bit samples and reverses their byte order with the branch-free scalar
+ *  code (SSE2 lacks byte shuffles). The fixed-point output kernels have SSE2 and
+ *  NEON paths only.
+ */
+
+#include <cmath>
+#include <cstring>  // required for size_t
+
+#include <stdint.h>  // required for uint64_t
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define DAFF_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define DAFF_SIMD_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define DAFF_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace DAFF {
+// --= Vector types =--
+
+#ifdef DAFF_SIMD_SSE2
+struct VecSSE2 {
+	typedef __m128 F;
+	typedef __m128i I;
+	enum { W = 4 };
+
+	static inline F load(const float* p) { return _mm_loadu_ps(p); };
+	static inline void store(float* p, F a) { _mm_storeu_ps(p, a); };
+	static inline F set1(float f) { return _mm_set1_ps(f); };
+	static inline F add(F a, F b) { return _mm_add_ps(a, b); };
+	static inline F sub(F a, F b) { return _mm_sub_ps(a, b); };
+	static inline F mul(F a, F b) { return _mm_mul_ps(a, b); };
+	static inline F div(F a, F b) { return _mm_div_ps(a, b); };
+	static inline F min(F a, F b) { return _mm_min_ps(a, b); };
+	static inline F max(F a, F b) { return _mm_max_ps(a, b); };
+	static inline F sqrt(F a) { return _mm_sqrt_ps(a); };
+	static inline F andf(F a, F b) { return _mm_and_ps(a, b); };
+	static inline F xorf(F a, F b) { return _mm_xor_ps(a, b); };
+	static inline F cmpgt(F a, F b) { return _mm_cmpgt_ps(a, b); };
+	static inline F cmpeq(F a, F b) { return _mm_cmpeq_ps(a, b); };
+	static inline F select(F m, F a, F b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); };
+	static inline I round(F a) { return _mm_cvtps_epi32(a); };
+	static inline I trunc(F a) { return _mm_cvttps_epi32(a); };
+	static inline F i2f(I a) { return _mm_cvtepi32_ps(a); };
+	static inline I inc(I a) { return _mm_add_epi32(a, _mm_set1_epi32(1)); };
+	static inline F bit0mask(I a)
+	{
+		return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(a, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+	};
+	static inline F bit1sign(I a) { return _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(a, _mm_set1_epi32(2)), 30)); };
+	static inline void deinterleave(F a, F b, F& even, F& odd)
+	{
+		even = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+		odd = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+	};
+	static inline void interleave(F even, F odd, F& a, F& b)
+	{
+		a = _mm_unpacklo_ps(even, odd);
+		b = _mm_unpackhi_ps(even, odd);
+	};
+	static inline F reversepairs(F a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 3, 2)); };
+};
+#endif  // DAFF_SIMD_SSE2
+
+#ifdef DAFF_SIMD_AVX2
+struct VecAVX2 {
+	typedef __m256 F;
+	typedef __m256i I;
+	enum { W = 8 };
+
+	static inline F load(const float* p) { return _mm256_loadu_ps(p); };
+	static inline void store(float* p, F a) { _mm256_storeu_ps(p, a); };
+	static inline F set1(float f) { return _mm256_set1_ps(f); };
+	static inline F add(F a, F b) { return _mm256_add_ps(a, b); };
+	static inline F sub(F a, F b) { return _mm256_sub_ps(a, b); };
+	static inline F mul(F a, F b) { return _mm256_mul_ps(a, b); };
+	static inline F div(F a, F b) { return _mm256_div_ps(a, b); };
+	static inline F min(F a, F b) { return _mm256_min_ps(a, b); };
+	static inline F max(F a, F b) { return _mm256_max_ps(a, b); };
+	static inline F sqrt(F a) { return _mm256_sqrt_ps(a); };
+	static inline F andf(F a, F b) { return _mm256_and_ps(a, b); };
+	static inline F xorf(F a, F b) { return _mm256_xor_ps(a, b); };
+	static inline F cmpgt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); };
+	static inline F cmpeq(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); };
+	static inline F select(F m, F a, F b) { return _mm256_blendv_ps(b, a, m); };
+	static inline I round(F a) { return _mm256_cvtps_epi32(a); };
+	static inline I trunc(F a) { return _mm256_cvttps_epi32(a); };
+	static inline F i2f(I a) { return _mm256_cvtepi32_ps(a); };
+	static inline I inc(I a) { return _mm256_add_epi32(a, _mm256_set1_epi32(1)); };
+	static inline F bit0mask(I a)
+	{
+		return _mm256_castsi256_ps(
+			_mm256_cmpeq_epi32(_mm256_and_si256(a, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+	};
+	static inline F bit1sign(I a)
+	{
+		return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(a, _mm256_set1_epi32(2)), 30));
+	};
+	static inline void deinterleave(F a, F b, F& even, F& odd)
+	{
+		// The shuffles work per 128-bit lane, (0 2 8 10 | 4 6 12 14) is reordered by 64-bit permutation
+		even = _mm256_castpd_ps(
+			_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))), 0xD8));
+		odd = _mm256_castpd_ps(
+			_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))), 0xD8));
+	};
+	static inline void interleave(F even, F odd, F& a, F& b)
+	{
+		F lo = _mm256_unpacklo_ps(even, odd);
+		F hi = _mm256_unpackhi_ps(even, odd);
+		a = _mm256_permute2f128_ps(lo, hi, 0x20);
+		b = _mm256_permute2f128_ps(lo, hi, 0x31);
+	};
+	static inline F reversepairs(F a)
+	{
+		return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(a), _MM_SHUFFLE(0, 1, 2, 3)));
+	};
+};
+#endif  // DAFF_SIMD_AVX2
+
+#ifdef DAFF_SIMD_NEON
+struct VecNEON {
+	typedef float32x4_t F;
+	typedef int32x4_t I;
+	enum { W = 4 };
+
+	static inline F load(const float* p) { return vld1q_f32(p); };
+	static inline void store(float* p, F a) { vst1q_f32(p, a); };
+	static inline F set1(float f) { return vdupq_n_f32(f); };
+	static inline F add(F a, F b) { return vaddq_f32(a, b); };
+	static inline F sub(F a, F b) { return vsubq_f32(a, b); };
+	static inline F mul(F a, F b) { return vmulq_f32(a, b); };
+	static inline F div(F a, F b) { return vdivq_f32(a, b); };
+	static inline F min(F a, F b) { return vminq_f32(a, b); };
+	static inline F max(F a, F b) { return vmaxq_f32(a, b); };
+	static inline F sqrt(F a) { return vsqrtq_f32(a); };
+	static inline F andf(F a, F b)
+	{
+		return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+	};
+	static inline F xorf(F a, F b)
+	{
+		return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+	};
+	static inline F cmpgt(F a, F b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); };
+	static inline F cmpeq(F a, F b) { return vreinterpretq_f32_u32(vceqq_f32(a, b)); };
+	static inline F select(F m, F a, F b) { return vbslq_f32(vreinterpretq_u32_f32(m), a, b); };
+	static inline I round(F a) { return vcvtnq_s32_f32(a); };
+	static inline I trunc(F a) { return vcvtq_s32_f32(a); };
+	static inline F i2f(I a) { return vcvtq_f32_s32(a); };
+	static inline I inc(I a) { return vaddq_s32(a, vdupq_n_s32(1)); };
+	static inline F bit0mask(I a) { return vreinterpretq_f32_u32(vtstq_s32(a, vdupq_n_s32(1))); };
+	static inline F bit1sign(I a) { return vreinterpretq_f32_s32(vshlq_n_s32(vandq_s32(a, vdupq_n_s32(2)), 30)); };
+	static inline void deinterleave(F a, F b, F& even, F& odd)
+	{
+		even = vuzp1q_f32(a, b);
+		odd = vuzp2q_f32(a, b);
+	};
+	static inline void interleave(F even, F odd, F& a, F& b)
+	{
+		a = vzip1q_f32(even, odd);
+		b = vzip2q_f32(even, odd);
+	};
+	static inline F reversepairs(F a) { return vcombine_f32(vget_high_f32(a), vget_low_f32(a)); };
+};
+#endif  // DAFF_SIMD_NEON
+
+// --= Math functions =--
+
+/*
+ *  Polynomial approximations after Cephes (single precision), accurate to
+ *  a few units in the last place within the reduced ranges.
+ */
+
+//! a * b + c
+template <class V>
+inline typename V::F simd_madd(typename V::F a, typename V::F b, typename V::F c)
+{
+	return V::add(V::mul(a, b), c);
+}
+
+//! Sine and cosine of angles in degrees
+template <class V>
+inline void simd_sincos_deg(typename V::F x, typename V::F& s, typename V::F& c)
+{
+	typedef typename V::F F;
+	typedef typename V::I I;
+
+	// Range reduction in degrees (exact for the angles we deal with), quadrant q
+	I q = V::round(V::mul(x, V::set1(1.0f / 90.0f)));
+	F r = V::mul(V::sub(x, V::mul(V::i2f(q), V::set1(90.0f))), V::set1(0.017453292519943295f));
+	F z = V::mul(r, r);
+
+	F sp = simd_madd<V>(V::set1(-1.9515295891E-4f), z, V::set1(8.3321608736E-3f));
+	sp = simd_madd<V>(sp, z, V::set1(-1.6666654611E-1f));
+	sp = simd_madd<V>(V::mul(sp, z), r, r);
+
+	F cp = simd_madd<V>(V::set1(2.443315711809948E-5f), z, V::set1(-1.388731625493765E-3f));
+	cp = simd_madd<V>(cp, z, V::set1(4.166664568298827E-2f));
+	cp = simd_madd<V>(V::mul(cp, z), z, V::sub(V::set1(1.0f), V::mul(V::set1(0.5f), z)));
+
+	// Quadrant: swap and sign
+	F swap = V::bit0mask(q);
+	s = V::xorf(V::select(swap, cp, sp), V::bit1sign(q));
+	c = V::xorf(V::select(swap, sp, cp), V::bit1sign(V::inc(q)));
+}
+
+//! Four-quadrant arc tangent of y/x in radians
+template <class V>
+inline typename V::F simd_atan2(typename V::F y, typename V::F x)
+{
+	typedef typename V::F F;
+
+	const F vSign = V::set1(-0.0f);
+	const F vZero = V::set1(0.0f);
+	const F vOne = V::set1(1.0f);
+
+	F ax = V::xorf(x, V::andf(x, vSign));
+	F ay = V::xorf(y, V::andf(y, vSign));
+
+	// t = min/max within [0,1], further reduced to [0, tan(pi/8)]
+	F t = V::div(V::min(ax, ay), V::max(V::max(ax, ay), V::set1(1e-30f)));
+	F big = V::cmpgt(t, V::set1(0.41421356237f));
+	t = V::select(big, V::div(V::sub(t, vOne), V::add(t, vOne)), t);
+
+	F z = V::mul(t, t);
+	F p = simd_madd<V>(V::set1(8.05374449538e-2f), z, V::set1(-1.38776856032E-1f));
+	p = simd_madd<V>(p, z, V::set1(1.99777106478E-1f));
+	p = simd_madd<V>(p, z, V::set1(-3.33329491539E-1f));
+	p = simd_madd<V>(V::mul(p, z), t, t);
+	p = V::add(p, V::andf(big, V::set1(0.78539816340f)));
+
+	// Undo octant and quadrant reduction
+	p = V::select(V::cmpgt(ay, ax), V::sub(V::set1(1.57079632679f), p), p);
+	p = V::select(V::cmpgt(vZero, x), V::sub(V::set1(3.14159265359f), p), p);
+	return V::xorf(p, V::andf(y, vSign));
+}
+
+//! Phase of complex values like DAFF::carg (radians within [-pi/2, 3pi/2))
+template <class V>
+inline typename V::F simd_carg(typename V::F re, typename V::F im)
+{
+	typename V::F p = simd_atan2<V>(im, re);
+	return V::select(V::cmpgt(V::set1(-1.57079632679f), p), V::add(p, V::set1(6.28318530718f)), p);
+}
+
+// --= Spherical coordinate rotation =--
+
+//! Rotation of spherical coordinates in degrees
+/**
+ * out1 = atan2(A*v, B*v), out2 = atan2(C*v, |(A*v, B*v)|) + fOutOffset2
+ * with v = (sin(in1) cos(in2'), sin(in2'), cos(in1) cos(in2')) and in2' = in2 + fInOffset2.
+ * A, B and C are rows of the rotation matrix. Computing the elevation with atan2
+ * instead of asin keeps the accuracy near the poles.
+ */
+struct SCRotation {
+	float a[3], b[3], c[3];
+	float fInOffset2;
+	float fOutOffset2;
+};
+
+template <class V>
+inline void simd_sc_rotate_block(const SCRotation& rot, const float* in1, const float* in2, float* out1, float* out2)
+{
+	typedef typename V::F F;
+
+	F sa, ca, se, ce;
+	simd_sincos_deg<V>(V::load(in1), sa, ca);
+	simd_sincos_deg<V>(V::add(V::load(in2), V::set1(rot.fInOffset2)), se, ce);
+
+	F sa_ce = V::mul(sa, ce);
+	F ca_ce = V::mul(ca, ce);
+
+	F y = simd_madd<V>(V::set1(rot.a[0]), sa_ce,
+					   simd_madd<V>(V::set1(rot.a[1]), se, V::mul(V::set1(rot.a[2]), ca_ce)));
+	F x = simd_madd<V>(V::set1(rot.b[0]), sa_ce,
+					   simd_madd<V>(V::set1(rot.b[1]), se, V::mul(V::set1(rot.b[2]), ca_ce)));
+	F e = simd_madd<V>(V::set1(rot.c[0]), sa_ce,
+					   simd_madd<V>(V::set1(rot.c[1]), se, V::mul(V::set1(rot.c[2]), ca_ce)));
+
+	const F vRad2Deg = V::set1(57.295779513082321f);
+	V::store(out1, V::mul(simd_atan2<V>(y, x), vRad2Deg));
+	V::store(out2, simd_madd<V>(simd_atan2<V>(e, V::sqrt(simd_madd<V>(x, x, V::mul(y, y)))), vRad2Deg,
+								V::set1(rot.fOutOffset2)));
+}
+
+template <class V>
+void simd_sc_rotate(const SCRotation& rot, const float* in1, const float* in2, float* out1, float* out2, size_t n)
+{
+	size_t i = 0;
+	for (; i + V::W <= n; i += V::W)
+		simd_sc_rotate_block<V>(rot, in1 + i, in2 + i, out1 + i, out2 + i);
+
+	// Remainder through a padded block
+	if (i < n) {
+		float buf[4][V::W] = { { 0 } };
+		memcpy(buf[0], in1 + i, (n - i) * sizeof(float));
+		memcpy(buf[1], in2 + i, (n - i) * sizeof(float));
+		simd_sc_rotate_block<V>(rot, buf[0], buf[1], buf[2], buf[3]);
+		memcpy(out1 + i, buf[2], (n - i) * sizeof(float));
+		memcpy(out2 + i, buf[3], (n - i) * sizeof(float));
+	}
+}
+
+// --= Direction normalization (data spherical coordinates) =--
+
+/*
+ *  Branch-free equivalents of DAFFUtils::NormalizeDirection for the data view, which
+ *  deliver bit-identical results within the ranges the callers deal with: the fmodf
+ *  calls reduce to a single subtraction or addition (exact after Sterbenz), roundf
+ *  to a truncation. Directions outside the ranges are left to the general method.
+ */
+
+//! fmodf(x, 360) for |x| < 720 (exact, including the sign of zero)
+inline float wrap_360_deg(float x)
+{
+	float r = (x >= 360.0F) ? x - 360.0F : ((x <= -360.0F) ? x + 360.0F : x);
+	return std::copysign(r, x);
+}
+
+//! roundf(x) for |x| < 2^22 (exact, including the sign of zero)
+inline float round_small(float x)
+{
+	// x + 0.5 is exact from 0.5 on, smaller values round to zero
+	float r = (float)(int)(x + std::copysign(0.5F, x));
+	return std::copysign((std::fabs(x) < 0.5F) ? 0.0F : r, x);
+}
+
+//! Returns true if a direction is within the ranges of the normalization kernels
+inline bool is_direction_dsc_in_range(float alpha, float beta)
+{
+	return (std::fabs(alpha) < 540.0F) && (std::fabs(beta) < 720.0F);
+}
+
+//! Normalizes a direction like DAFFUtils::NormalizeDirection(DAFF_DATA_VIEW, ...), for |alpha| < 540 and |beta| < 720
+inline void normalize_direction_dsc(float& alpha, float& beta)
+{
+	const float EPSILON = 0.00001F;
+
+	float b = wrap_360_deg(beta);
+	bool flip = (b > 180.0F);
+	float a = wrap_360_deg(flip ? alpha + 180.0F : alpha);
+	a = (a < 0.0F) ? a + 360.0F : a;
+	b = flip ? b - 180.0F : b;
+	if ((std::fabs(b) <= EPSILON) || (std::fabs(b - 180.0F) <= EPSILON))
+		a = 0.0F;
+
+	alpha = round_small(a * 1000.0F) / 1000.0F;
+	beta = round_small(b * 1000.0F) / 1000.0F;
+}
+
+inline void scalar_normalize_directions_dsc(float* alpha, float* beta, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		if (is_direction_dsc_in_range(alpha[i], beta[i]))
+			normalize_direction_dsc(alpha[i], beta[i]);
+}
+
+//! Vector versions of wrap_360_deg and round_small (sign bit mask s)
+template <class V>
+inline typename V::F simd_copysign(typename V::F r, typename V::F x, typename V::F s)
+{
+	return V::xorf(V::xorf(r, V::andf(r, s)), V::andf(x, s));
+}
+
+template <class V>
+inline typename V::F simd_wrap_360_deg(typename V::F x, typename V::F s)
+{
+	typename V::F r = V::select(V::cmpgt(V::set1(360.0f), x), x, V::sub(x, V::set1(360.0f)));
+	r = V::select(V::cmpgt(x, V::set1(-360.0f)), r, V::add(x, V::set1(360.0f)));
+	return simd_copysign<V>(r, x, s);
+}
+
+template <class V>
+inline typename V::F simd_round_small(typename V::F x, typename V::F s)
+{
+	typename V::F r = V::i2f(V::trunc(V::add(x, simd_copysign<V>(V::set1(0.5f), x, s))));
+	r = V::select(V::cmpgt(V::set1(0.5f), V::xorf(x, V::andf(x, s))), V::set1(0.0f), r);
+	return simd_copysign<V>(r, x, s);
+}
+
+//! Normalizes directions like normalize_direction_dsc, directions outside the ranges are left as they are
+template <class V>
+void simd_normalize_directions_dsc(float* alpha, float* beta, size_t count)
+{
+	typedef typename V::F F;
+
+	const F s = V::set1(-0.0f);
+	const F vEpsilon = V::set1(0.00001f);
+	const F v180 = V::set1(180.0f);
+
+	size_t i = 0;
+	for (; i + V::W <= count; i += V::W) {
+		F a0 = V::load(alpha + i);
+		F b0 = V::load(beta + i);
+		F in = V::andf(V::cmpgt(V::set1(540.0f), V::xorf(a0, V::andf(a0, s))),
+					   V::cmpgt(V::set1(720.0f), V::xorf(b0, V::andf(b0, s))));
+
+		// Out-of-range lanes are computed with zeros (no conversion overflow) and not stored
+		F a = V::andf(a0, in);
+		F b = simd_wrap_360_deg<V>(V::andf(b0, in), s);
+		F flip = V::cmpgt(b, v180);
+		a = simd_wrap_360_deg<V>(V::select(flip, V::add(a, v180), a), s);
+		a = V::select(V::cmpgt(V::set1(0.0f), a), V::add(a, V::set1(360.0f)), a);
+		b = V::select(flip, V::sub(b, v180), b);
+
+		// Poles: |b| <= epsilon or |b - 180| <= epsilon
+		F bd = V::sub(b, v180);
+		F other = V::andf(V::cmpgt(V::xorf(b, V::andf(b, s)), vEpsilon),
+						  V::cmpgt(V::xorf(bd, V::andf(bd, s)), vEpsilon));
+		a = V::select(other, a, V::set1(0.0f));
+
+		a = V::div(simd_round_small<V>(V::mul(a, V::set1(1000.0f)), s), V::set1(1000.0f));
+		b = V::div(simd_round_small<V>(V::mul(b, V::set1(1000.0f)), s), V::set1(1000.0f));
+		V::store(alpha + i, V::select(in, a, a0));
+		V::store(beta + i, V::select(in, b, b0));
+	}
+
+	scalar_normalize_directions_dsc(alpha + i, beta + i, count - i);
+}
+
+// --= Vector operations (unit stride) =--
+
+inline void scalar_mul_float(float* dest, const float* src, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		dest[i] *= src[i];
+}
+
+//! Element-wise product dest = dest * src
+template <class V>
+void simd_mul_float(float* dest, const float* src, size_t count)
+{
+	size_t i = 0;
+	for (; i + V::W <= count; i += V::W)
+		V::store(dest + i, V::mul(V::load(dest + i), V::load(src + i)));
+	scalar_mul_float(dest + i, src + i, count - i);
+}
+
+inline void scalar_sub_float(float* dest, const float* a, const float* b, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		dest[i] = a[i] - b[i];
+}
+
+//! Element-wise difference dest = a - b
+template <class V>
+void simd_sub_float(float* dest, const float* a, const float* b, size_t count)
+{
+	size_t i = 0;
+	for (; i + V::W <= count; i += V::W)
+		V::store(dest + i, V::sub(V::load(a + i), V::load(b + i)));
+	scalar_sub_float(dest + i, a + i, b + i, count - i);
+}
+
+inline void scalar_ratio_float(float* dest, const float* a, const float* b, float floor, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		dest[i] = (a[i] > floor ? a[i] : floor) / (b[i] > floor ? b[i] : floor);
+}
+
+//! Element-wise ratio dest = max(a, floor) / max(b, floor)
+template <class V>
+void simd_ratio_float(float* dest, const float* a, const float* b, float floor, size_t count)
+{
+	typedef typename V::F F;
+
+	const F vf = V::set1(floor);
+	size_t i = 0;
+	for (; i + V::W <= count; i += V::W)
+		V::store(dest + i, V::div(V::max(V::load(a + i), vf), V::max(V::load(b + i), vf)));
+	scalar_ratio_float(dest + i, a + i, b + i, floor, count - i);
+}
+
+inline void scalar_blend_float(float* dest, const float* const* src, const float* gain, int n, size_t begin,
+							   size_t end)
+{
+	for (size_t i = begin; i < end; i++) {
+		float s = 0.0f;
+		for (int k = 0; k < n; k++)
+			s += gain[k] * src[k][i];
+		dest[i] = s;
+	}
+}
+
+//! Weighted sum dest = gain[0] * src[0] + ... + gain[n-1] * src[n-1] (zero for n = 0)
+template <class V>
+void simd_blend_float(float* dest, const float* const* src, const float* gain, int n, size_t count)
+{
+	typedef typename V::F F;
+
+	size_t i = 0;
+	for (; i + V::W <= count; i += V::W) {
+		F s = V::set1(0.0f);
+		for (int k = 0; k < n; k++)
+			s = simd_madd<V>(V::set1(gain[k]), V::load(src[k] + i), s);
+		V::store(dest + i, s);
+	}
+	scalar_blend_float(dest, src, gain, n, i, count);
+}
+
+inline void scalar_crossfade_float(float* dest, const float* a, const float* b, size_t begin, size_t end, float t0,
+								   float dt, bool cosine)
+{
+	for (size_t i = begin; i < end; i++) {
+		float w = t0 + dt * (float)i;
+		if (cosine) {
+			float s = std::sin(1.57079632679f * w);
+			w = s * s;
+		}
+		dest[i] = a[i] + w * (b[i] - a[i]);
+	}
+}
+
+//! Crossfade dest[i] = a[i] + w(t0 + i*dt) * (b[i] - a[i]) with the ramp w(t) = t or sin^2(90 deg * t)
+template <class V>
+void simd_crossfade_float(float* dest, const float* a, const float* b, size_t count, float t0, float dt, bool cosine)
+{
+	typedef typename V::F F;
+
+	float pfIota[V::W];
+	for (int k = 0; k < V::W; k++)
+		pfIota[k] = (float)k;
+	const F vIota = V::load(pfIota);
+
+	size_t i = 0;
+	for (; i + V::W <= count; i += V::W) {
+		F w = simd_madd<V>(V::add(V::set1((float)i), vIota), V::set1(dt), V::set1(t0));
+		if (cosine) {
+			F s, c;
+			simd_sincos_deg<V>(V::mul(w, V::set1(90.0f)), s, c);
+			w = V::mul(s, s);
+		}
+		F va = V::load(a + i);
+		V::store(dest + i, simd_madd<V>(w, V::sub(V::load(b + i), va), va));
+	}
+	scalar_crossfade_float(dest, a, b, i, count, t0, dt, cosine);
+}
+
+inline float scalar_dot_float(const float* a, const float* b, size_t count)
+{
+	float s = 0.0f;
+	for (size_t i = 0; i < count; i++)
+		s += a[i] * b[i];
+	return s;
+}
+
+//! Dot product a[0] * b[0] + ... + a[count-1] * b[count-1]
+template <class V>
+float simd_dot_float(const float* a, const float* b, size_t count)
+{
+	typedef typename V::F F;
+
+	F s0 = V::set1(0.0f), s1 = V::set1(0.0f);
+	size_t i = 0;
+	for (; i + 2 * V::W <= count; i += 2 * V::W) {
+		s0 = simd_madd<V>(V::load(a + i), V::load(b + i), s0);
+		s1 = simd_madd<V>(V::load(a + i + V::W), V::load(b + i + V::W), s1);
+	}
+	if (i + V::W <= count) {
+		s0 = simd_madd<V>(V::load(a + i), V::load(b + i), s0);
+		i += V::W;
+	}
+
+	float buf[V::W];
+	V::store(buf, V::add(s0, s1));
+	float s = scalar_dot_float(a + i, b + i, count - i);
+	for (int k = 0; k < V::W; k++)
+		s += buf[k];
+	return s;
+}
+
+inline void scalar_sqmac_float(float* dest, const float* src, float w, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		dest[i] += w * (src[i] * src[i]);
+}
+
+//! Weighted squares accumulation dest = dest + w * src^2
+template <class V>
+void simd_sqmac_float(float* dest, const float* src, float w, size_t count)
+{
+	typedef typename V::F F;
+
+	const F vw = V::set1(w);
+	size_t i = 0;
+	for (; i + V::W <= count; i += V::W) {
+		F x = V::load(src + i);
+		V::store(dest + i, simd_madd<V>(vw, V::mul(x, x), V::load(dest + i)));
+	}
+	scalar_sqmac_float(dest + i, src + i, w, count - i);
+}
+
+// --= Selection =--
+
+/*
+ *  Comparisons of values x with a reference v. NaN values never satisfy a comparison,
+ *  the vector masks are combined from mutually exclusive ordered comparisons.
+ */
+
+struct CmpEQ {
+	static inline bool test(float x, float v) { return (x == v); };
+	template <class V>
+	static inline typename V::F mask(typename V::F x, typename V::F v) { return V::cmpeq(x, v); };
+};
+
+struct CmpNE {
+	static inline bool test(float x, float v) { return (x < v) || (x > v); };
+	template <class V>
+	static inline typename V::F mask(typename V::F x, typename V::F v)
+	{
+		return V::xorf(V::cmpgt(x, v), V::cmpgt(v, x));
+	};
+};
+
+struct CmpLT {
+	static inline bool test(float x, float v) { return (x < v); };
+	template <class V>
+	static inline typename V::F mask(typename V::F x, typename V::F v) { return V::cmpgt(v, x); };
+};
+
+struct CmpLE {
+	static inline bool test(float x, float v) { return (x <= v); };
+	template <class V>
+	static inline typename V::F mask(typename V::F x, typename V::F v)
+	{
+		return V::xorf(V::cmpgt(v, x), V::cmpeq(x, v));
+	};
+};
+
+struct CmpGT {
+	static inline bool test(float x, float v) { return (x > v); };
+	template <class V>
+	static inline typename V::F mask(typename V::F x, typename V::F v) { return V::cmpgt(x, v); };
+};
+
+struct CmpGE {
+	static inline bool test(float x, float v) { return (x >= v); };
+	template <class V>
+	static inline typename V::F mask(typename V::F x, typename V::F v)
+	{
+		return V::xorf(V::cmpgt(x, v), V::cmpeq(x, v));
+	};
+};
+
+//! Indices of the values satisfying a comparison (branch-free compaction), returns their number
+template <class C>
+size_t scalar_select_float(int* dest, const float* src, float v, size_t begin, size_t count)
+{
+	size_t n = 0;
+	for (size_t i = begin; i < count; i++) {
+		dest[n] = (int)i;
+		n += (C::test(src[i], v) ? 1 : 0);
+	}
+	return n;
+}
+
+//! Indices of the values satisfying a comparison (vector comparisons, branch-free compaction)
+template <class V, class C>
+size_t simd_select_float(int* dest, const float* src, float v, size_t count)
+{
+	typedef typename V::F F;
+
+	const F vv = V::set1(v);
+	const F one = V::set1(1.0f);
+	float buf[V::W];
+	size_t n = 0;
+	size_t i = 0;
+	for (; i + V::W <= count; i += V::W) {
+		V::store(buf, V::andf(C::template mask<V>(V::load(src + i), vv), one));
+		for (int k = 0; k < V::W; k++) {
+			dest[n] = (int)(i + k);
+			n += (buf[k] != 0 ? 1 : 0);
+		}
+	}
+	return n + scalar_select_float<C>(dest + n, src, v, i, count);
+}
+
+// --= Sample type conversion (unit stride, little endian) =--
+
+/*
+ *  Convert count samples into dest = (add ? dest : 0) + sample * c.
+ *  The products are computed exactly like in the scalar code, so all kernels
+ *  deliver identical results.
+ */
+
+//! Sign-extended little endian 24-bit sample (branch-free)
+inline int sample_sint24(const unsigned char* p)
+{
+	return (int)(((unsigned int)p[0] << 8) | ((unsigned int)p[1] << 16) | ((unsigned int)p[2] << 24)) >> 8;
+}
+
+inline void scalar_sint16_to_float(float* dest, const short* src, size_t count, float c, bool add)
+{
+	if (add)
+		for (size_t i = 0; i < count; i++)
+			dest[i] += (float)src[i] * c;
+	else
+		for (size_t i = 0; i < count; i++)
+			dest[i] = (float)src[i] * c;
+}
+
+inline void scalar_sint24_to_float(float* dest, const unsigned char* src, size_t count, float c, bool add)
+{
+	if (add)
+		for (size_t i = 0; i < count; i++)
+			dest[i] += (float)sample_sint24(src + 3 * i) * c;
+	else
+		for (size_t i = 0; i < count; i++)
+			dest[i] = (float)sample_sint24(src + 3 * i) * c;
+}
+
+#ifdef DAFF_SIMD_SSE2
+inline void simd_sint16_to_float_sse2(float* dest, const short* src, size_t count, float c, bool add)
+{
+	const __m128 vc = _mm_set1_ps(c);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16)), vc);
+		__m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16)), vc);
+		if (add) {
+			lo = _mm_add_ps(_mm_loadu_ps(dest + i), lo);
+			hi = _mm_add_ps(_mm_loadu_ps(dest + i + 4), hi);
+		}
+		_mm_storeu_ps(dest + i, lo);
+		_mm_storeu_ps(dest + i + 4, hi);
+	}
+	scalar_sint16_to_float(dest + i, src + i, count - i, c, add);
+}
+#endif  // DAFF_SIMD_SSE2
+
+#ifdef DAFF_SIMD_NEON
+inline void simd_sint16_to_float_neon(float* dest, const short* src, size_t count, float c, bool add)
+{
+	const float32x4_t vc = vdupq_n_f32(c);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		int16x8_t x = vld1q_s16(src + i);
+		float32x4_t lo = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))), vc);
+		float32x4_t hi = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))), vc);
+		if (add) {
+			lo = vaddq_f32(vld1q_f32(dest + i), lo);
+			hi = vaddq_f32(vld1q_f32(dest + i + 4), hi);
+		}
+		vst1q_f32(dest + i, lo);
+		vst1q_f32(dest + i + 4, hi);
+	}
+	scalar_sint16_to_float(dest + i, src + i, count - i, c, add);
+}
+
+inline void simd_sint24_to_float_neon(float* dest, const unsigned char* src, size_t count, float c, bool add)
+{
+	const float32x4_t vc = vdupq_n_f32(c);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		// De-interleave 8 samples into their low, mid and high bytes
+		uint8x8x3_t b = vld3_u8(src + 3 * i);
+		uint16x8_t b0 = vmovl_u8(b.val[0]);
+		uint16x8_t b1 = vmovl_u8(b.val[1]);
+		uint16x8_t b2 = vmovl_u8(b.val[2]);
+
+		// Assemble in the upper 24 bits, then sign-extend by arithmetic shift
+		uint32x4_t ulo = vorrq_u32(vorrq_u32(vshll_n_u16(vget_low_u16(b0), 8), vshll_n_u16(vget_low_u16(b1), 16)),
+								   vshlq_n_u32(vmovl_u16(vget_low_u16(b2)), 24));
+		uint32x4_t uhi = vorrq_u32(vorrq_u32(vshll_n_u16(vget_high_u16(b0), 8), vshll_n_u16(vget_high_u16(b1), 16)),
+								   vshlq_n_u32(vmovl_u16(vget_high_u16(b2)), 24));
+		float32x4_t lo = vmulq_f32(vcvtq_f32_s32(vshrq_n_s32(vreinterpretq_s32_u32(ulo), 8)), vc);
+		float32x4_t hi = vmulq_f32(vcvtq_f32_s32(vshrq_n_s32(vreinterpretq_s32_u32(uhi), 8)), vc);
+		if (add) {
+			lo = vaddq_f32(vld1q_f32(dest + i), lo);
+			hi = vaddq_f32(vld1q_f32(dest + i + 4), hi);
+		}
+		vst1q_f32(dest + i, lo);
+		vst1q_f32(dest + i + 4, hi);
+	}
+	scalar_sint24_to_float(dest + i, src + 3 * i, count - i, c, add);
+}
+#endif  // DAFF_SIMD_NEON
+
+// --= 16-bit floating point conversion (unit stride, system byte order) =--
+
+/*
+ *  Half precision (IEEE 754 binary16) and bfloat16 (upper half of a single precision
+ *  float) convert exactly into single precision, the products with c are computed like
+ *  for the integer samples.
+ */
+
+//! Single precision value of a half precision bit pattern (exact, including subnormals, infinity and NaN)
+inline float sample_half(unsigned short h)
+{
+	// Shift exponent and mantissa into place, a multiplication rebiases the exponent and normalizes subnormals
+	unsigned int u = (unsigned int)(h & 0x7FFF) << 13;
+	float f;
+	memcpy(&f, &u, sizeof(float));
+	f *= 5.192296858534828e+33F;  // 2^112
+	memcpy(&u, &f, sizeof(float));
+	if (u >= 0x47800000)  // Infinity and NaN (65536 after the rebias)
+		u |= 0x7F800000;
+	u |= (unsigned int)(h & 0x8000) << 16;
+	memcpy(&f, &u, sizeof(float));
+	return f;
+}
+
+//! Single precision value of a bfloat16 bit pattern
+inline float sample_bfloat16(unsigned short h)
+{
+	unsigned int u = (unsigned int)h << 16;
+	float f;
+	memcpy(&f, &u, sizeof(float));
+	return f;
+}
+
+inline void scalar_half_to_float(float* dest, const unsigned short* src, size_t count, float c, bool add)
+{
+	if (add)
+		for (size_t i = 0; i < count; i++)
+			dest[i] += sample_half(src[i]) * c;
+	else
+		for (size_t i = 0; i < count; i++)
+			dest[i] = sample_half(src[i]) * c;
+}
+
+inline void scalar_bfloat16_to_float(float* dest, const unsigned short* src, size_t count, float c, bool add)
+{
+	if (add)
+		for (size_t i = 0; i < count; i++)
+			dest[i] += sample_bfloat16(src[i]) * c;
+	else
+		for (size_t i = 0; i < count; i++)
+			dest[i] = sample_bfloat16(src[i]) * c;
+}
+
+#ifdef DAFF_SIMD_SSE2
+//! Four half precision values (zero-extended into 32-bit lanes) as single precision, like sample_half
+inline __m128 simd_half4_to_float_sse2(__m128i x)
+{
+	__m128 f = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(x, _mm_set1_epi32(0x7FFF)), 13)),
+						  _mm_set1_ps(5.192296858534828e+33F));
+	__m128 special = _mm_cmpge_ps(f, _mm_set1_ps(65536.0F));
+	f = _mm_or_ps(f, _mm_and_ps(special, _mm_castsi128_ps(_mm_set1_epi32(0x7F800000))));
+	return _mm_or_ps(f, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(x, _mm_set1_epi32(0x8000)), 16)));
+}
+
+inline void simd_half_to_float_sse2(float* dest, const unsigned short* src, size_t count, float c, bool add)
+{
+	const __m128 vc = _mm_set1_ps(c);
+	const __m128i vzero = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128 lo = _mm_mul_ps(simd_half4_to_float_sse2(_mm_unpacklo_epi16(x, vzero)), vc);
+		__m128 hi = _mm_mul_ps(simd_half4_to_float_sse2(_mm_unpackhi_epi16(x, vzero)), vc);
+		if (add) {
+			lo = _mm_add_ps(_mm_loadu_ps(dest + i), lo);
+			hi = _mm_add_ps(_mm_loadu_ps(dest + i + 4), hi);
+		}
+		_mm_storeu_ps(dest + i, lo);
+		_mm_storeu_ps(dest + i + 4, hi);
+	}
+	scalar_half_to_float(dest + i, src + i, count - i, c, add);
+}
+
+inline void simd_bfloat16_to_float_sse2(float* dest, const unsigned short* src, size_t count, float c, bool add)
+{
+	const __m128 vc = _mm_set1_ps(c);
+	const __m128i vzero = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		// Interleaving with zeros puts the values into the upper halves of the lanes
+		__m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128 lo = _mm_mul_ps(_mm_castsi128_ps(_mm_unpacklo_epi16(vzero, x)), vc);
+		__m128 hi = _mm_mul_ps(_mm_castsi128_ps(_mm_unpackhi_epi16(vzero, x)), vc);
+		if (add) {
+			lo = _mm_add_ps(_mm_loadu_ps(dest + i), lo);
+			hi = _mm_add_ps(_mm_loadu_ps(dest + i + 4), hi);
+		}
+		_mm_storeu_ps(dest + i, lo);
+		_mm_storeu_ps(dest + i + 4, hi);
+	}
+	scalar_bfloat16_to_float(dest + i, src + i, count - i, c, add);
+}
+#endif  // DAFF_SIMD_SSE2
+
+#ifdef DAFF_SIMD_NEON
+inline void simd_half_to_float_neon(float* dest, const unsigned short* src, size_t count, float c, bool add)
+{
+	const float32x4_t vc = vdupq_n_f32(c);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		// Hardware conversion (part of the AArch64 base instruction set)
+		float16x8_t x = vreinterpretq_f16_u16(vld1q_u16(src + i));
+		float32x4_t lo = vmulq_f32(vcvt_f32_f16(vget_low_f16(x)), vc);
+		float32x4_t hi = vmulq_f32(vcvt_f32_f16(vget_high_f16(x)), vc);
+		if (add) {
+			lo = vaddq_f32(vld1q_f32(dest + i), lo);
+			hi = vaddq_f32(vld1q_f32(dest + i + 4), hi);
+		}
+		vst1q_f32(dest + i, lo);
+		vst1q_f32(dest + i + 4, hi);
+	}
+	scalar_half_to_float(dest + i, src + i, count - i, c, add);
+}
+
+inline void simd_bfloat16_to_float_neon(float* dest, const unsigned short* src, size_t count, float c, bool add)
+{
+	const float32x4_t vc = vdupq_n_f32(c);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		uint16x8_t x = vld1q_u16(src + i);
+		float32x4_t lo = vmulq_f32(vreinterpretq_f32_u32(vshll_n_u16(vget_low_u16(x), 16)), vc);
+		float32x4_t hi = vmulq_f32(vreinterpretq_f32_u32(vshll_n_u16(vget_high_u16(x), 16)), vc);
+		if (add) {
+			lo = vaddq_f32(vld1q_f32(dest + i), lo);
+			hi = vaddq_f32(vld1q_f32(dest + i + 4), hi);
+		}
+		vst1q_f32(dest + i, lo);
+		vst1q_f32(dest + i + 4, hi);
+	}
+	scalar_bfloat16_to_float(dest + i, src + i, count - i, c, add);
+}
+#endif  // DAFF_SIMD_NEON
+
+// --= Fixed-point output (unit stride, system byte order) =--
+
+/*
+ *  Convert count samples into dest = sat((add ? dest : 0) + sat(round(sample * c)))
+ *  with Q15 (16-bit) or Q31 (32-bit) destinations, rounded to nearest even and
+ *  saturated (NaN: 0). Q15 products are computed in single precision like the
+ *  float conversions, Q31 products in double precision. 24-bit samples use the
+ *  scalar code.
+ */
+
+//! Rounds to nearest even and saturates to [-32768, 32767] (NaN: 0)
+inline int quantize_q15(float y)
+{
+	if (y != y)
+		return 0;
+	y = (y < 32767.0F ? y : 32767.0F);
+	y = (y > -32768.0F ? y : -32768.0F);
+	return (int)std::nearbyint(y);
+}
+
+//! Rounds to nearest even and saturates to [-2^31, 2^31 - 1] (NaN: 0)
+inline int32_t quantize_q31(double y)
+{
+	if (y != y)
+		return 0;
+	y = (y < 2147483647.0 ? y : 2147483647.0);
+	y = (y > -2147483648.0 ? y : -2147483648.0);
+	return (int32_t)std::nearbyint(y);
+}
+
+//! Saturated sum of Q15 values
+inline int16_t add_sat_q15(int16_t a, int b)
+{
+	int s = a + b;
+	return (int16_t)(s > 32767 ? 32767 : (s < -32768 ? -32768 : s));
+}
+
+//! Saturated sum of Q31 values
+inline int32_t add_sat_q31(int32_t a, int32_t b)
+{
+	int64_t s = (int64_t)a + b;
+	if (s > 2147483647)
+		return 2147483647;
+	if (s < -2147483647 - 1)
+		return -2147483647 - 1;
+	return (int32_t)s;
+}
+
+inline void scalar_sint16_to_q15(int16_t* dest, const int16_t* src, size_t count, float c, bool add)
+{
+	for (size_t i = 0; i < count; i++) {
+		int y = quantize_q15((float)src[i] * c);
+		dest[i] = (add ? add_sat_q15(dest[i], y) : (int16_t)y);
+	}
+}
+
+inline void scalar_sint24_to_q15(int16_t* dest, const unsigned char* src, size_t count, float c, bool add)
+{
+	for (size_t i = 0; i < count; i++) {
+		int y = quantize_q15((float)sample_sint24(src + 3 * i) * c);
+		dest[i] = (add ? add_sat_q15(dest[i], y) : (int16_t)y);
+	}
+}
+
+inline void scalar_float_to_q15(int16_t* dest, const float* src, size_t count, float c, bool add)
+{
+	for (size_t i = 0; i < count; i++) {
+		int y = quantize_q15(src[i] * c);
+		dest[i] = (add ? add_sat_q15(dest[i], y) : (int16_t)y);
+	}
+}
+
+inline void scalar_sint16_to_q31(int32_t* dest, const int16_t* src, size_t count, double c, bool add)
+{
+	for (size_t i = 0; i < count; i++) {
+		int32_t y = quantize_q31((double)src[i] * c);
+		dest[i] = (add ? add_sat_q31(dest[i], y) : y);
+	}
+}
+
+inline void scalar_sint24_to_q31(int32_t* dest, const unsigned char* src, size_t count, double c, bool add)
+{
+	for (size_t i = 0; i < count; i++) {
+		int32_t y = quantize_q31((double)sample_sint24(src + 3 * i) * c);
+		dest[i] = (add ? add_sat_q31(dest[i], y) : y);
+	}
+}
+
+inline void scalar_float_to_q31(int32_t* dest, const float* src, size_t count, double c, bool add)
+{
+	for (size_t i = 0; i < count; i++) {
+		int32_t y = quantize_q31((double)src[i] * c);
+		dest[i] = (add ? add_sat_q31(dest[i], y) : y);
+	}
+}
+
+#ifdef DAFF_SIMD_SSE2
+//! Eight products as Q15 values, like quantize_q15 (clamped before the conversion, so the packing is exact)
+inline __m128i simd_quantize_q15_sse2(__m128 lo, __m128 hi)
+{
+	const __m128 vmax = _mm_set1_ps(32767.0F);
+	const __m128 vmin = _mm_set1_ps(-32768.0F);
+	lo = _mm_max_ps(_mm_min_ps(_mm_and_ps(lo, _mm_cmpeq_ps(lo, lo)), vmax), vmin);
+	hi = _mm_max_ps(_mm_min_ps(_mm_and_ps(hi, _mm_cmpeq_ps(hi, hi)), vmax), vmin);
+	return _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi));
+}
+
+//! Two products as Q31 values in the lower lanes, like quantize_q31
+inline __m128i simd_quantize_q31_sse2(__m128d y)
+{
+	y = _mm_and_pd(y, _mm_cmpeq_pd(y, y));
+	y = _mm_max_pd(_mm_min_pd(y, _mm_set1_pd(2147483647.0)), _mm_set1_pd(-2147483648.0));
+	return _mm_cvtpd_epi32(y);
+}
+
+//! Saturated sums of 32-bit lanes, like add_sat_q31
+inline __m128i simd_adds_epi32_sse2(__m128i a, __m128i b)
+{
+	// Overflow if the operands have the same sign and the sum has another one
+	__m128i s = _mm_add_epi32(a, b);
+	__m128i o = _mm_srai_epi32(_mm_andnot_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, s)), 31);
+	__m128i sat = _mm_xor_si128(_mm_srai_epi32(a, 31), _mm_set1_epi32(0x7FFFFFFF));
+	return _mm_or_si128(_mm_and_si128(o, sat), _mm_andnot_si128(o, s));
+}
+
+inline void simd_store_q15_sse2(int16_t* dest, __m128i y, bool add)
+{
+	if (add)
+		y = _mm_adds_epi16(_mm_loadu_si128((const __m128i*)dest), y);
+	_mm_storeu_si128((__m128i*)dest, y);
+}
+
+//! Stores four Q31 values from the lower lanes of two conversions
+inline void simd_store_q31_sse2(int32_t* dest, __m128i lo, __m128i hi, bool add)
+{
+	__m128i y = _mm_unpacklo_epi64(lo, hi);
+	if (add)
+		y = simd_adds_epi32_sse2(_mm_loadu_si128((const __m128i*)dest), y);
+	_mm_storeu_si128((__m128i*)dest, y);
+}
+
+inline void simd_sint16_to_q15_sse2(int16_t* dest, const int16_t* src, size_t count, float c, bool add)
+{
+	const __m128 vc = _mm_set1_ps(c);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16)), vc);
+		__m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16)), vc);
+		simd_store_q15_sse2(dest + i, simd_quantize_q15_sse2(lo, hi), add);
+	}
+	scalar_sint16_to_q15(dest + i, src + i, count - i, c, add);
+}
+
+inline void simd_float_to_q15_sse2(int16_t* dest, const float* src, size_t count, float c, bool add)
+{
+	const __m128 vc = _mm_set1_ps(c);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128 lo = _mm_mul_ps(_mm_loadu_ps(src + i), vc);
+		__m128 hi = _mm_mul_ps(_mm_loadu_ps(src + i + 4), vc);
+		simd_store_q15_sse2(dest + i, simd_quantize_q15_sse2(lo, hi), add);
+	}
+	scalar_float_to_q15(dest + i, src + i, count - i, c, add);
+}
+
+inline void simd_sint16_to_q31_sse2(int32_t* dest, const int16_t* src, size_t count, double c, bool add)
+{
+	const __m128d vc = _mm_set1_pd(c);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i x = _mm_loadl_epi64((const __m128i*)(src + i));
+		x = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+		__m128i lo = simd_quantize_q31_sse2(_mm_mul_pd(_mm_cvtepi32_pd(x), vc));
+		__m128i hi = simd_quantize_q31_sse2(_mm_mul_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(x, x)), vc));
+		simd_store_q31_sse2(dest + i, lo, hi, add);
+	}
+	scalar_sint16_to_q31(dest + i, src + i, count - i, c, add);
+}
+
+inline void simd_float_to_q31_sse2(int32_t* dest, const float* src, size_t count, double c, bool add)
+{
+	const __m128d vc = _mm_set1_pd(c);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128 x = _mm_loadu_ps(src + i);
+		__m128i lo = simd_quantize_q31_sse2(_mm_mul_pd(_mm_cvtps_pd(x), vc));
+		__m128i hi = simd_quantize_q31_sse2(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(x, x)), vc));
+		simd_store_q31_sse2(dest + i, lo, hi, add);
+	}
+	scalar_float_to_q31(dest + i, src + i, count - i, c, add);
+}
+#endif  // DAFF_SIMD_SSE2
+
+#ifdef DAFF_SIMD_NEON
+// The conversions round to nearest even and saturate (NaN: 0), the narrowings saturate
+
+inline void simd_sint16_to_q15_neon(int16_t* dest, const int16_t* src, size_t count, float c, bool add)
+{
+	const float32x4_t vc = vdupq_n_f32(c);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		int16x8_t x = vld1q_s16(src + i);
+		float32x4_t lo = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))), vc);
+		float32x4_t hi = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))), vc);
+		int16x8_t y = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(lo)), vqmovn_s32(vcvtnq_s32_f32(hi)));
+		if (add)
+			y = vqaddq_s16(vld1q_s16(dest + i), y);
+		vst1q_s16(dest + i, y);
+	}
+	scalar_sint16_to_q15(dest + i, src + i, count - i, c, add);
+}
+
+inline void simd_float_to_q15_neon(int16_t* dest, const float* src, size_t count, float c, bool add)
+{
+	const float32x4_t vc = vdupq_n_f32(c);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		float32x4_t lo = vmulq_f32(vld1q_f32(src + i), vc);
+		float32x4_t hi = vmulq_f32(vld1q_f32(src + i + 4), vc);
+		int16x8_t y = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(lo)), vqmovn_s32(vcvtnq_s32_f32(hi)));
+		if (add)
+			y = vqaddq_s16(vld1q_s16(dest + i), y);
+		vst1q_s16(dest + i, y);
+	}
+	scalar_float_to_q15(dest + i, src + i, count - i, c, add);
+}
+
+inline void simd_sint16_to_q31_neon(int32_t* dest, const int16_t* src, size_t count, double c, bool add)
+{
+	const float64x2_t vc = vdupq_n_f64(c);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		int32x4_t x = vmovl_s16(vld1_s16(src + i));
+		float64x2_t lo = vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(x))), vc);
+		float64x2_t hi = vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_high_s32(x))), vc);
+		int32x4_t y = vcombine_s32(vqmovn_s64(vcvtnq_s64_f64(lo)), vqmovn_s64(vcvtnq_s64_f64(hi)));
+		if (add)
+			y = vqaddq_s32(vld1q_s32(dest + i), y);
+		vst1q_s32(dest + i, y);
+	}
+	scalar_sint16_to_q31(dest + i, src + i, count - i, c, add);
+}
+
+inline void simd_float_to_q31_neon(int32_t* dest, const float* src, size_t count, double c, bool add)
+{
+	const float64x2_t vc = vdupq_n_f64(c);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		float32x4_t x = vld1q_f32(src + i);
+		float64x2_t lo = vmulq_f64(vcvt_f64_f32(vget_low_f32(x)), vc);
+		float64x2_t hi = vmulq_f64(vcvt_high_f64_f32(x), vc);
+		int32x4_t y = vcombine_s32(vqmovn_s64(vcvtnq_s64_f64(lo)), vqmovn_s64(vcvtnq_s64_f64(hi)));
+		if (add)
+			y = vqaddq_s32(vld1q_s32(dest + i), y);
+		vst1q_s32(dest + i, y);
+	}
+	scalar_float_to_q31(dest + i, src + i, count - i, c, add);
+}
+#endif  // DAFF_SIMD_NEON
+
+// --= Peak values (maximum absolute sample, unit stride, little endian) =--
+
+inline int scalar_max_abs_sint16(const short* src, size_t count)
+{
+	int iMax = 0;
+	for (size_t i = 0; i < count; i++) {
+		int x = (src[i] < 0 ? -(int)src[i] : (int)src[i]);
+		iMax = (x > iMax ? x : iMax);
+	}
+	return iMax;
+}
+
+inline int scalar_max_abs_sint24(const unsigned char* src, size_t count)
+{
+	int iMax = 0;
+	for (size_t i = 0; i < count; i++) {
+		int x = sample_sint24(src + 3 * i);
+		x = (x < 0 ? -x : x);
+		iMax = (x > iMax ? x : iMax);
+	}
+	return iMax;
+}
+
+inline float scalar_max_abs_float(const float* src, size_t count)
+{
+	float fMax = 0;
+	for (size_t i = 0; i < count; i++) {
+		float x = (src[i] < 0 ? -src[i] : src[i]);
+		fMax = (x > fMax ? x : fMax);
+	}
+	return fMax;
+}
+
+#ifdef DAFF_SIMD_SSE2
+inline int simd_max_abs_sint16_sse2(const short* src, size_t count)
+{
+	// Track minimum and maximum separately, since |-32768| does not fit into 16 bits
+	__m128i vmin = _mm_setzero_si128();
+	__m128i vmax = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+		vmin = _mm_min_epi16(vmin, x);
+		vmax = _mm_max_epi16(vmax, x);
+	}
+
+	short psMin[8], psMax[8];
+	_mm_storeu_si128((__m128i*)psMin, vmin);
+	_mm_storeu_si128((__m128i*)psMax, vmax);
+	int iMax = scalar_max_abs_sint16(src + i, count - i);
+	for (int k = 0; k < 8; k++) {
+		iMax = (psMax[k] > iMax ? psMax[k] : iMax);
+		iMax = (-psMin[k] > iMax ? -psMin[k] : iMax);
+	}
+	return iMax;
+}
+
+inline float simd_max_abs_float_sse2(const float* src, size_t count)
+{
+	const __m128 vsign = _mm_set1_ps(-0.0f);
+	__m128 vmax = _mm_setzero_ps();
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+		vmax = _mm_max_ps(vmax, _mm_andnot_ps(vsign, _mm_loadu_ps(src + i)));
+
+	float pfMax[4];
+	_mm_storeu_ps(pfMax, vmax);
+	float fMax = scalar_max_abs_float(src + i, count - i);
+	for (int k = 0; k < 4; k++)
+		fMax = (pfMax[k] > fMax ? pfMax[k] : fMax);
+	return fMax;
+}
+#endif  // DAFF_SIMD_SSE2
+
+#ifdef DAFF_SIMD_NEON
+inline int simd_max_abs_sint16_neon(const short* src, size_t count)
+{
+	int16x8_t vmin = vdupq_n_s16(0);
+	int16x8_t vmax = vdupq_n_s16(0);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		int16x8_t x = vld1q_s16(src + i);
+		vmin = vminq_s16(vmin, x);
+		vmax = vmaxq_s16(vmax, x);
+	}
+
+	int iMax = scalar_max_abs_sint16(src + i, count - i);
+	int iLaneMax = vmaxvq_s16(vmax);
+	int iLaneMin = -(int)vminvq_s16(vmin);
+	iMax = (iLaneMax > iMax ? iLaneMax : iMax);
+	return (iLaneMin > iMax ? iLaneMin : iMax);
+}
+
+inline float simd_max_abs_float_neon(const float* src, size_t count)
+{
+	float32x4_t vmax = vdupq_n_f32(0);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+		vmax = vmaxq_f32(vmax, vabsq_f32(vld1q_f32(src + i)));
+
+	float fMax = scalar_max_abs_float(src + i, count - i);
+	float fLaneMax = vmaxvq_f32(vmax);
+	return (fLaneMax > fMax ? fLaneMax : fMax);
+}
+#endif  // DAFF_SIMD_NEON
+
+// --= Effective bounds (values above a threshold) and peak value in a single pass =--
+
+//! Returns the peak, [begin, end) is the range of the values with an absolute value above the threshold (empty: 0, 0)
+inline float scalar_bounds_float(const float* src, size_t count, float threshold, size_t& begin, size_t& end)
+{
+	float fMax = 0;
+	begin = end = 0;
+	for (size_t i = 0; i < count; i++) {
+		float x = (src[i] < 0 ? -src[i] : src[i]);
+		fMax = (x > fMax ? x : fMax);
+		if (x > threshold) {
+			if (end == 0)
+				begin = i;
+			end = i + 1;
+		}
+	}
+	return fMax;
+}
+
+//! Combines the first and the last block containing values above the threshold with the scalar tail
+inline float merge_bounds_float(const float* src, size_t count, float threshold, size_t first, size_t last,
+								size_t tail, size_t width, float fMax, size_t& begin, size_t& end)
+{
+	size_t b, e;
+	float fTailMax = scalar_bounds_float(src + tail, count - tail, threshold, b, e);
+	fMax = (fTailMax > fMax ? fTailMax : fMax);
+	begin = tail + b;
+	end = tail + e;
+
+	if (first != count) {
+		scalar_bounds_float(src + first, width, threshold, b, e);
+		begin = first + b;
+		if (end == tail) {
+			scalar_bounds_float(src + last, width, threshold, b, e);
+			end = last + e;
+		}
+	} else if (end == tail) {
+		begin = end = 0;
+	}
+	return fMax;
+}
+
+#ifdef DAFF_SIMD_SSE2
+inline float simd_bounds_float_sse2(const float* src, size_t count, float threshold, size_t& begin, size_t& end)
+{
+	const __m128 vsign = _mm_set1_ps(-0.0f);
+	const __m128 vthreshold = _mm_set1_ps(threshold);
+	__m128 vmax = _mm_setzero_ps();
+	size_t first = count, last = count;  // First and last block with values above the threshold
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128 x = _mm_andnot_ps(vsign, _mm_loadu_ps(src + i));
+		vmax = _mm_max_ps(vmax, x);
+		if (_mm_movemask_ps(_mm_cmpgt_ps(x, vthreshold))) {
+			first = (first == count ? i : first);
+			last = i;
+		}
+	}
+
+	float pfMax[4];
+	_mm_storeu_ps(pfMax, vmax);
+	float fMax = 0;
+	for (int k = 0; k < 4; k++)
+		fMax = (pfMax[k] > fMax ? pfMax[k] : fMax);
+	return merge_bounds_float(src, count, threshold, first, last, i, 4, fMax, begin, end);
+}
+#endif  // DAFF_SIMD_SSE2
+
+#ifdef DAFF_SIMD_NEON
+inline float simd_bounds_float_neon(const float* src, size_t count, float threshold, size_t& begin, size_t& end)
+{
+	const float32x4_t vthreshold = vdupq_n_f32(threshold);
+	float32x4_t vmax = vdupq_n_f32(0);
+	size_t first = count, last = count;  // First and last block with values above the threshold
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		float32x4_t x = vabsq_f32(vld1q_f32(src + i));
+		vmax = vmaxq_f32(vmax, x);
+		if (vmaxvq_u32(vcgtq_f32(x, vthreshold))) {
+			first = (first == count ? i : first);
+			last = i;
+		}
+	}
+
+	return merge_bounds_float(src, count, threshold, first, last, i, 4, vmaxvq_f32(vmax), begin, end);
+}
+#endif  // DAFF_SIMD_NEON
+
+// --= Energy (sum of squares in double precision, unit stride) =--
+
+inline double scalar_energy_float(const float* src, size_t count)
+{
+	double dSum = 0;
+	for (size_t i = 0; i < count; i++)
+		dSum += (double)src[i] * src[i];
+	return dSum;
+}
+
+#ifdef DAFF_SIMD_SSE2
+inline double simd_energy_float_sse2(const float* src, size_t count)
+{
+	// Products in double precision like the scalar version, only the order of the summation differs
+	__m128d vlo = _mm_setzero_pd();
+	__m128d vhi = _mm_setzero_pd();
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128 x = _mm_loadu_ps(src + i);
+		__m128d lo = _mm_cvtps_pd(x);
+		__m128d hi = _mm_cvtps_pd(_mm_movehl_ps(x, x));
+		vlo = _mm_add_pd(vlo, _mm_mul_pd(lo, lo));
+		vhi = _mm_add_pd(vhi, _mm_mul_pd(hi, hi));
+	}
+
+	double pdSum[2];
+	_mm_storeu_pd(pdSum, _mm_add_pd(vlo, vhi));
+	return pdSum[0] + pdSum[1] + scalar_energy_float(src + i, count - i);
+}
+#endif  // DAFF_SIMD_SSE2
+
+#ifdef DAFF_SIMD_NEON
+inline double simd_energy_float_neon(const float* src, size_t count)
+{
+	float64x2_t vlo = vdupq_n_f64(0);
+	float64x2_t vhi = vdupq_n_f64(0);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		float32x4_t x = vld1q_f32(src + i);
+		float64x2_t lo = vcvt_f64_f32(vget_low_f32(x));
+		float64x2_t hi = vcvt_high_f64_f32(x);
+		vlo = vfmaq_f64(vlo, lo, lo);
+		vhi = vfmaq_f64(vhi, hi, hi);
+	}
+
+	return vaddvq_f64(vaddq_f64(vlo, vhi)) + scalar_energy_float(src + i, count - i);
+}
+#endif  // DAFF_SIMD_NEON
+
+// --= Envelope (minimum and maximum, unit stride) =--
+
+inline void scalar_minmax_float(const float* src, size_t count, float& fMin, float& fMax)
+{
+	for (size_t i = 0; i < count; i++) {
+		fMin = (src[i] < fMin ? src[i] : fMin);
+		fMax = (src[i] > fMax ? src[i] : fMax);
+	}
+}
+
+//! Minimum and maximum of the values, combined with the values of fMin and fMax passed in
+template <class V>
+void simd_minmax_float(const float* src, size_t count, float& fMin, float& fMax)
+{
+	size_t i = 0;
+	if (count >= (size_t)V::W) {
+		typename V::F vmin = V::load(src);
+		typename V::F vmax = vmin;
+		for (i = V::W; i + V::W <= count; i += V::W) {
+			typename V::F x = V::load(src + i);
+			vmin = V::min(vmin, x);
+			vmax = V::max(vmax, x);
+		}
+
+		float pfMin[V::W], pfMax[V::W];
+		V::store(pfMin, vmin);
+		V::store(pfMax, vmax);
+		scalar_minmax_float(pfMin, V::W, fMin, fMax);
+		scalar_minmax_float(pfMax, V::W, fMin, fMax);
+	}
+	scalar_minmax_float(src + i, count - i, fMin, fMax);
+}
+
+// --= Complex values (interleaved pairs, unit stride) =--
+
+//! Phase of a complex value in radians within [-pi/2, 3pi/2) (the range of former releases)
+inline float scalar_carg(float re, float im)
+{
+	float p = std::atan2(im, re);
+	return (p < -1.57079632679f ? p + 6.28318530718f : p);
+}
+
+inline void scalar_cart2polar_float(float* dest, const float* src, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		float re = src[2 * i];
+		float im = src[2 * i + 1];
+		dest[2 * i] = std::sqrt(re * re + im * im);
+		dest[2 * i + 1] = scalar_carg(re, im);
+	}
+}
+
+template <class V>
+inline void simd_cart2polar_block(float* dest, const float* src)
+{
+	typedef typename V::F F;
+
+	F re, im, a, b;
+	V::deinterleave(V::load(src), V::load(src + V::W), re, im);
+	V::interleave(V::sqrt(simd_madd<V>(re, re, V::mul(im, im))), simd_carg<V>(re, im), a, b);
+	V::store(dest, a);
+	V::store(dest + V::W, b);
+}
+
+//! Polar form of count complex values, dest = (|z0|, arg(z0), |z1|, arg(z1), ...) (may be in place)
+template <class V>
+void simd_cart2polar_float(float* dest, const float* src, size_t count)
+{
+	size_t i = 0;
+	for (; i + V::W <= count; i += V::W)
+		simd_cart2polar_block<V>(dest + 2 * i, src + 2 * i);
+
+	// Remainder through a padded block (same results for a value wherever it is located)
+	if (i < count) {
+		float buf[2 * V::W] = { 0 };
+		memcpy(buf, src + 2 * i, 2 * (count - i) * sizeof(float));
+		simd_cart2polar_block<V>(buf, buf);
+		memcpy(dest + 2 * i, buf, 2 * (count - i) * sizeof(float));
+	}
+}
+
+inline void scalar_polar2cart_float(float* dest, const float* mag, const float* phase, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		dest[2 * i] = mag[i] * std::cos(phase[i]);
+		dest[2 * i + 1] = mag[i] * std::sin(phase[i]);
+	}
+}
+
+template <class V>
+inline void simd_polar2cart_block(float* dest, const float* mag, const float* phase)
+{
+	typedef typename V::F F;
+
+	F m = V::load(mag);
+	F s, c, a, b;
+	simd_sincos_deg<V>(V::mul(V::load(phase), V::set1(57.295779513082321f)), s, c);
+	V::interleave(V::mul(m, c), V::mul(m, s), a, b);
+	V::store(dest, a);
+	V::store(dest + V::W, b);
+}
+
+//! Cartesian form of count complex values in polar form, dest = (mag0 cos(phase0), mag0 sin(phase0), ...)
+template <class V>
+void simd_polar2cart_float(float* dest, const float* mag, const float* phase, size_t count)
+{
+	size_t i = 0;
+	for (; i + V::W <= count; i += V::W)
+		simd_polar2cart_block<V>(dest + 2 * i, mag + i, phase + i);
+
+	// Remainder through a padded block (same results for a value wherever it is located)
+	if (i < count) {
+		float buf[3 * V::W] = { 0 };
+		memcpy(buf, mag + i, (count - i) * sizeof(float));
+		memcpy(buf + V::W, phase + i, (count - i) * sizeof(float));
+		simd_polar2cart_block<V>(buf + V::W, buf, buf + V::W);
+		memcpy(dest + 2 * i, buf + V::W, 2 * (count - i) * sizeof(float));
+	}
+}
+
+inline void scalar_cmac_float(float* dest, const float* a, const float* b, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		float re = a[2 * i] * b[2 * i] - a[2 * i + 1] * b[2 * i + 1];
+		float im = a[2 * i] * b[2 * i + 1] + a[2 * i + 1] * b[2 * i];
+		dest[2 * i] += re;
+		dest[2 * i + 1] += im;
+	}
+}
+
+//! Complex multiply-accumulate of count interleaved complex values, dest = dest + a * b
+template <class V>
+void simd_cmac_float(float* dest, const float* a, const float* b, size_t count)
+{
+	typedef typename V::F F;
+
+	size_t i = 0;
+	for (; i + V::W <= count; i += V::W) {
+		F ar, ai, br, bi, dr, di, lo, hi;
+		V::deinterleave(V::load(a + 2 * i), V::load(a + 2 * i + V::W), ar, ai);
+		V::deinterleave(V::load(b + 2 * i), V::load(b + 2 * i + V::W), br, bi);
+		V::deinterleave(V::load(dest + 2 * i), V::load(dest + 2 * i + V::W), dr, di);
+		dr = V::add(dr, V::sub(V::mul(ar, br), V::mul(ai, bi)));
+		di = V::add(di, simd_madd<V>(ar, bi, V::mul(ai, br)));
+		V::interleave(dr, di, lo, hi);
+		V::store(dest + 2 * i, lo);
+		V::store(dest + 2 * i + V::W, hi);
+	}
+	scalar_cmac_float(dest + 2 * i, a + 2 * i, b + 2 * i, count - i);
+}
+
+inline void scalar_csqmac_float(float* dest, const float* src, float w, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		dest[i] += w * (src[2 * i] * src[2 * i] + src[2 * i + 1] * src[2 * i + 1]);
+}
+
+//! Weighted squared magnitudes accumulation of count interleaved complex values, dest[i] = dest[i] + w * |src_i|^2
+template <class V>
+void simd_csqmac_float(float* dest, const float* src, float w, size_t count)
+{
+	typedef typename V::F F;
+
+	const F vw = V::set1(w);
+	size_t i = 0;
+	for (; i + V::W <= count; i += V::W) {
+		F re, im;
+		V::deinterleave(V::load(src + 2 * i), V::load(src + 2 * i + V::W), re, im);
+		V::store(dest + i, simd_madd<V>(vw, simd_madd<V>(re, re, V::mul(im, im)), V::load(dest + i)));
+	}
+	scalar_csqmac_float(dest + i, src + 2 * i, w, count - i);
+}
+
+inline void scalar_deinterleave_float(float* even, float* odd, const float* src, size_t count)
+{
+	if (even)
+		for (size_t i = 0; i < count; i++)
+			even[i] = src[2 * i];
+	if (odd)
+		for (size_t i = 0; i < count; i++)
+			odd[i] = src[2 * i + 1];
+}
+
+//! Splits count pairs into the first and the second values, even = (src[0], src[2], ...), odd = (src[1], ...)
+template <class V>
+void simd_deinterleave_float(float* even, float* odd, const float* src, size_t count)
+{
+	typedef typename V::F F;
+
+	size_t i = 0;
+	for (; i + V::W <= count; i += V::W) {
+		F e, o;
+		V::deinterleave(V::load(src + 2 * i), V::load(src + 2 * i + V::W), e, o);
+		if (even)
+			V::store(even + i, e);
+		if (odd)
+			V::store(odd + i, o);
+	}
+	scalar_deinterleave_float(even ? even + i : NULL, odd ? odd + i : NULL, src + 2 * i, count - i);
+}
+
+inline void scalar_conj_mirror_float(float* dest, const float* src, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		dest[2 * i] = src[2 * (count - 1 - i)];
+		dest[2 * i + 1] = -src[2 * (count - 1 - i) + 1];
+	}
+}
+
+//! Conjugates of count complex values in reverse order, dest[i] = conj(src[count - 1 - i]) (not in place)
+template <class V>
+void simd_conj_mirror_float(float* dest, const float* src, size_t count)
+{
+	typedef typename V::F F;
+	const size_t P = V::W / 2;  // Complex values per vector
+
+	float pfSigns[V::W];
+	for (int k = 0; k < V::W; k++)
+		pfSigns[k] = (k % 2 ? -0.0f : 0.0f);
+	const F vSigns = V::load(pfSigns);
+
+	size_t i = 0;
+	for (; i + P <= count; i += P)
+		V::store(dest + 2 * i, V::xorf(V::reversepairs(V::load(src + 2 * (count - i - P))), vSigns));
+	scalar_conj_mirror_float(dest + 2 * i, src, count - i);
+}
+
+// --= Spherical harmonics =--
+
+/*
+ *  Orthonormal real spherical harmonics Y[n*n + n + m] (ACN order, no Condon-Shortley phase)
+ *  of the directions (alpha, beta) in data spherical coordinates [degrees], with the azimuth
+ *  alpha and the colatitude 180 - beta (beta = 180 is the north pole). The associated Legendre
+ *  functions are evaluated by the normalized recurrence in z = cos(colatitude), the azimuthal
+ *  terms by the recurrence of (x + iy)^m, which includes the factor sin^m(colatitude).
+ */
+
+//! Number of recurrence factors up to an order (see sh_recurrence)
+inline size_t sh_recurrence_size(int order)
+{
+	return (size_t)(order + 1) * (order + 2);
+}
+
+//! Recurrence factors up to an order
+/**
+ * For each m = 0 ... order: the constant of P(m, m) (including sqrt(2) for m > 0) and the
+ * factor of P(m+1, m), followed by the factor pairs (a, b) of P(n, m) = a z P(n-1, m) - b P(n-2, m)
+ * for n = m+2 ... order.
+ */
+inline void sh_recurrence(int order, float* rec)
+{
+	double c = std::sqrt(0.25 / 3.14159265358979323846);
+	for (int m = 0; m <= order; m++) {
+		if (m > 0)
+			c *= std::sqrt((2.0 * m + 1) / (2.0 * m));
+		*rec++ = (float)(m > 0 ? c * std::sqrt(2.0) : c);
+		*rec++ = (float)std::sqrt(2.0 * m + 3);
+		for (int n = m + 2; n <= order; n++) {
+			double d = (double)n * n - (double)m * m;
+			*rec++ = (float)std::sqrt((4.0 * n * n - 1) / d);
+			*rec++ = (float)std::sqrt(((n - 1.0) * (n - 1.0) - (double)m * m) * (2.0 * n + 1) / ((2.0 * n - 3) * d));
+		}
+	}
+}
+
+inline void scalar_sh_basis(float* dest, const float* rec, int order, const float* alpha, const float* beta, size_t n)
+{
+	const int M = (order + 1) * (order + 1);
+	const float fDeg2Rad = 0.017453292519943295f;
+	for (size_t i = 0; i < n; i++, dest += M) {
+		float sb = std::sin(beta[i] * fDeg2Rad);
+		float x = sb * std::cos(alpha[i] * fDeg2Rad);
+		float y = sb * std::sin(alpha[i] * fDeg2Rad);
+		float z = -std::cos(beta[i] * fDeg2Rad);
+
+		const float* r = rec;
+		float cm = 1.0f, sm = 0.0f;
+		for (int m = 0; m <= order; m++) {
+			if (m > 0) {
+				float t = x * cm - y * sm;
+				sm = x * sm + y * cm;
+				cm = t;
+			}
+
+			float p2 = r[0];
+			float p1 = r[1] * z * p2;
+			dest[m * m + m + m] = p2 * cm;
+			if (m > 0)
+				dest[m * m + m - m] = p2 * sm;
+			if (m < order) {
+				dest[(m + 1) * (m + 1) + m + 1 + m] = p1 * cm;
+				if (m > 0)
+					dest[(m + 1) * (m + 1) + m + 1 - m] = p1 * sm;
+			}
+			r += 2;
+
+			for (int k = m + 2; k <= order; k++, r += 2) {
+				float p = r[0] * z * p1 - r[1] * p2;
+				dest[k * k + k + m] = p * cm;
+				if (m > 0)
+					dest[k * k + k - m] = p * sm;
+				p2 = p1;
+				p1 = p;
+			}
+		}
+	}
+}
+
+//! Scatters the first lanes of a vector into every M-th destination value
+template <class V>
+inline void simd_sh_scatter(float* dest, size_t M, typename V::F a, int lanes)
+{
+	float buf[V::W];
+	V::store(buf, a);
+	for (int k = 0; k < lanes; k++)
+		dest[k * M] = buf[k];
+}
+
+//! Basis of W directions, scattered into dest[i * M + k] for the first lanes i
+template <class V>
+inline void simd_sh_basis_block(float* dest, const float* rec, int order, const float* alpha, const float* beta,
+								int lanes)
+{
+	typedef typename V::F F;
+	const size_t M = (size_t)(order + 1) * (order + 1);
+
+	F sa, ca, sb, cb;
+	simd_sincos_deg<V>(V::load(alpha), sa, ca);
+	simd_sincos_deg<V>(V::load(beta), sb, cb);
+	F x = V::mul(sb, ca);
+	F y = V::mul(sb, sa);
+	F z = V::xorf(cb, V::set1(-0.0f));
+
+	const float* r = rec;
+	F cm = V::set1(1.0f), sm = V::set1(0.0f);
+	for (int m = 0; m <= order; m++) {
+		if (m > 0) {
+			F t = V::sub(V::mul(x, cm), V::mul(y, sm));
+			sm = simd_madd<V>(x, sm, V::mul(y, cm));
+			cm = t;
+		}
+
+		F p2 = V::set1(r[0]);
+		F p1 = V::mul(V::mul(V::set1(r[1]), z), p2);
+		simd_sh_scatter<V>(dest + m * m + m + m, M, V::mul(p2, cm), lanes);
+		if (m > 0)
+			simd_sh_scatter<V>(dest + m * m + m - m, M, V::mul(p2, sm), lanes);
+		if (m < order) {
+			simd_sh_scatter<V>(dest + (m + 1) * (m + 1) + m + 1 + m, M, V::mul(p1, cm), lanes);
+			if (m > 0)
+				simd_sh_scatter<V>(dest + (m + 1) * (m + 1) + m + 1 - m, M, V::mul(p1, sm), lanes);
+		}
+		r += 2;
+
+		for (int k = m + 2; k <= order; k++, r += 2) {
+			F p = V::sub(V::mul(V::mul(V::set1(r[0]), z), p1), V::mul(V::set1(r[1]), p2));
+			simd_sh_scatter<V>(dest + k * k + k + m, M, V::mul(p, cm), lanes);
+			if (m > 0)
+				simd_sh_scatter<V>(dest + k * k + k - m, M, V::mul(p, sm), lanes);
+			p2 = p1;
+			p1 = p;
+		}
+	}
+}
+
+//! Spherical harmonics of n directions, dest[i * (order+1)^2 + k] (recurrence factors of sh_recurrence)
+template <class V>
+void simd_sh_basis(float* dest, const float* rec, int order, const float* alpha, const float* beta, size_t n)
+{
+	const size_t M = (size_t)(order + 1) * (order + 1);
+
+	size_t i = 0;
+	for (; i + V::W <= n; i += V::W)
+		simd_sh_basis_block<V>(dest + i * M, rec, order, alpha + i, beta + i, V::W);
+
+	// Remainder through a padded block, of which only the valid lanes are stored
+	if (i < n) {
+		float buf[2][V::W] = { { 0 } };
+		memcpy(buf[0], alpha + i, (n - i) * sizeof(float));
+		memcpy(buf[1], beta + i, (n - i) * sizeof(float));
+		simd_sh_basis_block<V>(dest + i * M, rec, order, buf[0], buf[1], (int)(n - i));
+	}
+}
+
+// --= Byte order reversal (unit stride) =--
+
+/*
+ *  Copy count values of 2, 3, 4 or 8 bytes from src into dest with reversed byte order
+ *  (conversion between little and big endian). dest may equal src (in place), otherwise
+ *  the ranges must not overlap. No alignment is required.
+ */
+
+inline void scalar_byteswap_2byte(void* dest, const void* src, size_t count)
+{
+	const unsigned char* s = (const unsigned char*)src;
+	unsigned char* d = (unsigned char*)dest;
+	for (size_t i = 0; i < count; i++) {
+		uint16_t x;
+		memcpy(&x, s + 2 * i, 2);
+		x = (uint16_t)((x >> 8) | (x << 8));
+		memcpy(d + 2 * i, &x, 2);
+	}
+}
+
+inline void scalar_byteswap_3byte(void* dest, const void* src, size_t count)
+{
+	const unsigned char* s = (const unsigned char*)src;
+	unsigned char* d = (unsigned char*)dest;
+	for (size_t i = 0; i < count; i++) {
+		unsigned char b0 = s[3 * i], b1 = s[3 * i + 1], b2 = s[3 * i + 2];
+		d[3 * i] = b2;
+		d[3 * i + 1] = b1;
+		d[3 * i + 2] = b0;
+	}
+}
+
+//! Reversed byte order of a 32-bit word (recognized as a single instruction by the compilers)
+inline uint32_t byteswap32(uint32_t x)
+{
+	return (x >> 24) | ((x >> 8) & 0x0000FF00) | ((x << 8) & 0x00FF0000) | (x << 24);
+}
+
+inline void scalar_byteswap_4byte(void* dest, const void* src, size_t count)
+{
+	const unsigned char* s = (const unsigned char*)src;
+	unsigned char* d = (unsigned char*)dest;
+	for (size_t i = 0; i < count; i++) {
+		uint32_t x;
+		memcpy(&x, s + 4 * i, 4);
+		x = byteswap32(x);
+		memcpy(d + 4 * i, &x, 4);
+	}
+}
+
+inline void scalar_byteswap_8byte(void* dest, const void* src, size_t count)
+{
+	const unsigned char* s = (const unsigned char*)src;
+	unsigned char* d = (unsigned char*)dest;
+	for (size_t i = 0; i < count; i++) {
+		uint64_t x;
+		memcpy(&x, s + 8 * i, 8);
+		x = ((uint64_t)byteswap32((uint32_t)x) << 32) | byteswap32((uint32_t)(x >> 32));
+		memcpy(d + 8 * i, &x, 8);
+	}
+}
+
+#ifdef DAFF_SIMD_SSE2
+//! Swaps the bytes of the 16-bit words
+inline __m128i simd_byteswap16_sse2(__m128i x)
+{
+	return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+}
+
+inline void simd_byteswap_2byte_sse2(void* dest, const void* src, size_t count)
+{
+	const char* s = (const char*)src;
+	char* d = (char*)dest;
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+		_mm_storeu_si128((__m128i*)(d + 2 * i), simd_byteswap16_sse2(_mm_loadu_si128((const __m128i*)(s + 2 * i))));
+	scalar_byteswap_2byte(d + 2 * i, s + 2 * i, count - i);
+}
+
+inline void simd_byteswap_4byte_sse2(void* dest, const void* src, size_t count)
+{
+	const char* s = (const char*)src;
+	char* d = (char*)dest;
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		// Bytes within the words, then the words within the 32-bit values
+		__m128i x = simd_byteswap16_sse2(_mm_loadu_si128((const __m128i*)(s + 4 * i)));
+		x = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+		_mm_storeu_si128((__m128i*)(d + 4 * i), x);
+	}
+	scalar_byteswap_4byte(d + 4 * i, s + 4 * i, count - i);
+}
+
+inline void simd_byteswap_8byte_sse2(void* dest, const void* src, size_t count)
+{
+	const char* s = (const char*)src;
+	char* d = (char*)dest;
+	size_t i = 0;
+	for (; i + 2 <= count; i += 2) {
+		__m128i x = simd_byteswap16_sse2(_mm_loadu_si128((const __m128i*)(s + 8 * i)));
+		x = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+		_mm_storeu_si128((__m128i*)(d + 8 * i), x);
+	}
+	scalar_byteswap_8byte(d + 8 * i, s + 8 * i, count - i);
+}
+#endif  // DAFF_SIMD_SSE2
+
+#ifdef DAFF_SIMD_NEON
+inline void simd_byteswap_2byte_neon(void* dest, const void* src, size_t count)
+{
+	const uint8_t* s = (const uint8_t*)src;
+	uint8_t* d = (uint8_t*)dest;
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+		vst1q_u8(d + 2 * i, vrev16q_u8(vld1q_u8(s + 2 * i)));
+	scalar_byteswap_2byte(d + 2 * i, s + 2 * i, count - i);
+}
+
+inline void simd_byteswap_3byte_neon(void* dest, const void* src, size_t count)
+{
+	const uint8_t* s = (const uint8_t*)src;
+	uint8_t* d = (uint8_t*)dest;
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		// De-interleave 16 values into their bytes, exchange the outer bytes
+		uint8x16x3_t b = vld3q_u8(s + 3 * i);
+		uint8x16_t t = b.val[0];
+		b.val[0] = b.val[2];
+		b.val[2] = t;
+		vst3q_u8(d + 3 * i, b);
+	}
+	scalar_byteswap_3byte(d + 3 * i, s + 3 * i, count - i);
+}
+
+inline void simd_byteswap_4byte_neon(void* dest, const void* src, size_t count)
+{
+	const uint8_t* s = (const uint8_t*)src;
+	uint8_t* d = (uint8_t*)dest;
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+		vst1q_u8(d + 4 * i, vrev32q_u8(vld1q_u8(s + 4 * i)));
+	scalar_byteswap_4byte(d + 4 * i, s + 4 * i, count - i);
+}
+
+inline void simd_byteswap_8byte_neon(void* dest, const void* src, size_t count)
+{
+	const uint8_t* s = (const uint8_t*)src;
+	uint8_t* d = (uint8_t*)dest;
+	size_t i = 0;
+	for (; i + 2 <= count; i += 2)
+		vst1q_u8(d + 8 * i, vrev64q_u8(vld1q_u8(s + 8 * i)));
+	scalar_byteswap_8byte(d + 8 * i, s + 8 * i, count - i);
+}
+#endif  // DAFF_SIMD_NEON
+
+// --= AVX2 kernels (DAFFSIMDAVX2.cpp) =--
+
+//! Returns true if the AVX2 kernels have been compiled (requires the AVX2 compiler switch for DAFFSIMDAVX2.cpp)
+bool simd_avx2_compiled();
+
+void simd_sc_rotate_avx2(const SCRotation& rot, const float* in1, const float* in2, float* out1, float* out2,
+						 size_t n);
+void simd_sint16_to_float_avx2(float* dest, const short* src, size_t count, float c, bool add);
+void simd_sint24_to_float_avx2(float* dest, const unsigned char* src, size_t count, float c, bool add);
+void simd_bfloat16_to_float_avx2(float* dest, const unsigned short* src, size_t count, float c, bool add);
+void simd_cart2polar_float_avx2(float* dest, const float* src, size_t count);
+void simd_polar2cart_float_avx2(float* dest, const float* mag, const float* phase, size_t count);
+void simd_cmac_float_avx2(float* dest, const float* a, const float* b, size_t count);
+void simd_deinterleave_float_avx2(float* even, float* odd, const float* src, size_t count);
+void simd_conj_mirror_float_avx2(float* dest, const float* src, size_t count);
+void simd_sh_basis_avx2(float* dest, const float* rec, int order, const float* alpha, const float* beta, size_t n);
+void simd_normalize_directions_dsc_avx2(float* alpha, float* beta, size_t count);
+void simd_byteswap_2byte_avx2(void* dest, const void* src, size_t count);
+void simd_byteswap_3byte_avx2(void* dest, const void* src, size_t count);
+void simd_byteswap_4byte_avx2(void* dest, const void* src, size_t count);
+void simd_byteswap_8byte_avx2(void* dest, const void* src, size_t count);
+
+//! Requires F16C in addition to AVX2 (see DAFF::cpu_supports_f16c)
+void simd_half_to_float_f16c(float* dest, const unsigned short* src, size_t count, float c, bool add);
+
+}  // namespace DAFF
+
+#endif  // IW_DAFF_SIMD
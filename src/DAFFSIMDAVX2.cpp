@@ -0,0 +1,212 @@
+#include "DAFFSIMD.h"
+
+/*
+ *  This translation unit is compiled with AVX2 code generation enabled (see CMakeLists.txt).
+ *  Its functions must only be called after checking DAFF::cpu_supports_avx2() (and
+ *  DAFF::cpu_supports_f16c() for the half precision conversion, which requires the F16C switch).
+ *  Without the compiler switch only stubs are built and simd_avx2_compiled() returns false.
+ */
+
+namespace DAFF {
+#ifdef DAFF_SIMD_AVX2
+
+bool simd_avx2_compiled()
+{
+	return true;
+}
+
+void simd_sc_rotate_avx2(const SCRotation& rot, const float* in1, const float* in2, float* out1, float* out2, size_t n)
+{
+	simd_sc_rotate<VecAVX2>(rot, in1, in2, out1, out2, n);
+}
+
+void simd_cart2polar_float_avx2(float* dest, const float* src, size_t count)
+{
+	simd_cart2polar_float<VecAVX2>(dest, src, count);
+}
+
+void simd_polar2cart_float_avx2(float* dest, const float* mag, const float* phase, size_t count)
+{
+	simd_polar2cart_float<VecAVX2>(dest, mag, phase, count);
+}
+
+void simd_cmac_float_avx2(float* dest, const float* a, const float* b, size_t count)
+{
+	simd_cmac_float<VecAVX2>(dest, a, b, count);
+}
+
+void simd_deinterleave_float_avx2(float* even, float* odd, const float* src, size_t count)
+{
+	simd_deinterleave_float<VecAVX2>(even, odd, src, count);
+}
+
+void simd_conj_mirror_float_avx2(float* dest, const float* src, size_t count)
+{
+	simd_conj_mirror_float<VecAVX2>(dest, src, count);
+}
+
+void simd_sh_basis_avx2(float* dest, const float* rec, int order, const float* alpha, const float* beta, size_t n)
+{
+	simd_sh_basis<VecAVX2>(dest, rec, order, alpha, beta, n);
+}
+
+void simd_normalize_directions_dsc_avx2(float* alpha, float* beta, size_t count)
+{
+	simd_normalize_directions_dsc<VecAVX2>(alpha, beta, count);
+}
+
+void simd_sint16_to_float_avx2(float* dest, const short* src, size_t count, float c, bool add)
+{
+	const __m256 vc = _mm256_set1_ps(c);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i x = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+		__m256 y = _mm256_mul_ps(_mm256_cvtepi32_ps(x), vc);
+		if (add)
+			y = _mm256_add_ps(_mm256_loadu_ps(dest + i), y);
+		_mm256_storeu_ps(dest + i, y);
+	}
+	scalar_sint16_to_float(dest + i, src + i, count - i, c, add);
+}
+
+void simd_sint24_to_float_avx2(float* dest, const unsigned char* src, size_t count, float c, bool add)
+{
+	// Per 128-bit lane: move the 3 bytes of 4 samples into the upper bytes of 32-bit integers
+	const __m256i vShuffle = _mm256_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1, 0, 1, 2, -1, 3,
+											  4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+	const __m256 vc = _mm256_set1_ps(c);
+	size_t i = 0;
+
+	// Two 16-byte loads per 8 samples (at byte 0 and 12), the second one reads 28 bytes in total
+	for (; i + 10 <= count; i += 8) {
+		const unsigned char* p = src + 3 * i;
+		__m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)),
+											_mm_loadu_si128((const __m128i*)(p + 12)), 1);
+		x = _mm256_srai_epi32(_mm256_shuffle_epi8(x, vShuffle), 8);
+		__m256 y = _mm256_mul_ps(_mm256_cvtepi32_ps(x), vc);
+		if (add)
+			y = _mm256_add_ps(_mm256_loadu_ps(dest + i), y);
+		_mm256_storeu_ps(dest + i, y);
+	}
+	scalar_sint24_to_float(dest + i, src + 3 * i, count - i, c, add);
+}
+
+void simd_bfloat16_to_float_avx2(float* dest, const unsigned short* src, size_t count, float c, bool add)
+{
+	const __m256 vc = _mm256_set1_ps(c);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i x = _mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src + i))), 16);
+		__m256 y = _mm256_mul_ps(_mm256_castsi256_ps(x), vc);
+		if (add)
+			y = _mm256_add_ps(_mm256_loadu_ps(dest + i), y);
+		_mm256_storeu_ps(dest + i, y);
+	}
+	scalar_bfloat16_to_float(dest + i, src + i, count - i, c, add);
+}
+
+void simd_half_to_float_f16c(float* dest, const unsigned short* src, size_t count, float c, bool add)
+{
+	size_t i = 0;
+#if defined(__F16C__) || defined(_MSC_VER)
+	const __m256 vc = _mm256_set1_ps(c);
+	for (; i + 8 <= count; i += 8) {
+		__m256 y = _mm256_mul_ps(_mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(src + i))), vc);
+		if (add)
+			y = _mm256_add_ps(_mm256_loadu_ps(dest + i), y);
+		_mm256_storeu_ps(dest + i, y);
+	}
+#endif
+	scalar_half_to_float(dest + i, src + i, count - i, c, add);
+}
+
+//! Byte shuffle within the 128-bit lanes (same pattern in both lanes)
+static void simd_byteswap_avx2(void* dest, const void* src, size_t nBytes, __m256i mask)
+{
+	const char* s = (const char*)src;
+	char* d = (char*)dest;
+	size_t i = 0;
+	for (; i + 32 <= nBytes; i += 32)
+		_mm256_storeu_si256((__m256i*)(d + i), _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(s + i)), mask));
+}
+
+void simd_byteswap_2byte_avx2(void* dest, const void* src, size_t count)
+{
+	const __m256i mask = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14, 1, 0, 3, 2, 5, 4, 7, 6,
+										  9, 8, 11, 10, 13, 12, 15, 14);
+	size_t i = count / 16 * 16;
+	simd_byteswap_avx2(dest, src, 2 * i, mask);
+	scalar_byteswap_2byte((char*)dest + 2 * i, (const char*)src + 2 * i, count - i);
+}
+
+void simd_byteswap_3byte_avx2(void* dest, const void* src, size_t count)
+{
+	// Five values (15 bytes) per 16-byte block, the last byte is stored unchanged and converted by the next block
+	const __m128i mask = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+	const char* s = (const char*)src;
+	char* d = (char*)dest;
+	size_t i = 0;
+	for (; 3 * i + 16 <= 3 * count; i += 5)
+		_mm_storeu_si128((__m128i*)(d + 3 * i), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(s + 3 * i)), mask));
+	scalar_byteswap_3byte(d + 3 * i, s + 3 * i, count - i);
+}
+
+void simd_byteswap_4byte_avx2(void* dest, const void* src, size_t count)
+{
+	const __m256i mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4,
+										  11, 10, 9, 8, 15, 14, 13, 12);
+	size_t i = count / 8 * 8;
+	simd_byteswap_avx2(dest, src, 4 * i, mask);
+	scalar_byteswap_4byte((char*)dest + 4 * i, (const char*)src + 4 * i, count - i);
+}
+
+void simd_byteswap_8byte_avx2(void* dest, const void* src, size_t count)
+{
+	const __m256i mask = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+										  15, 14, 13, 12, 11, 10, 9, 8);
+	size_t i = count / 4 * 4;
+	simd_byteswap_avx2(dest, src, 8 * i, mask);
+	scalar_byteswap_8byte((char*)dest + 8 * i, (const char*)src + 8 * i, count - i);
+}
+
+#else  // DAFF_SIMD_AVX2
+
+bool simd_avx2_compiled()
+{
+	return false;
+}
+
+void simd_sc_rotate_avx2(const SCRotation&, const float*, const float*, float*, float*, size_t) {}
+
+void simd_cart2polar_float_avx2(float*, const float*, size_t) {}
+
+void simd_polar2cart_float_avx2(float*, const float*, const float*, size_t) {}
+
+void simd_cmac_float_avx2(float*, const float*, const float*, size_t) {}
+
+void simd_deinterleave_float_avx2(float*, float*, const float*, size_t) {}
+
+void simd_conj_mirror_float_avx2(float*, const float*, size_t) {}
+
+void simd_sh_basis_avx2(float*, const float*, int, const float*, const float*, size_t) {}
+
+void simd_normalize_directions_dsc_avx2(float*, float*, size_t) {}
+
+void simd_sint16_to_float_avx2(float*, const short*, size_t, float, bool) {}
+
+void simd_sint24_to_float_avx2(float*, const unsigned char*, size_t, float, bool) {}
+
+void simd_bfloat16_to_float_avx2(float*, const unsigned short*, size_t, float, bool) {}
+
+void simd_half_to_float_f16c(float*, const unsigned short*, size_t, float, bool) {}
+
+void simd_byteswap_2byte_avx2(void*, const void*, size_t) {}
+
+void simd_byteswap_3byte_avx2(void*, const void*, size_t) {}
+
+void simd_byteswap_4byte_avx2(void*, const void*, size_t) {}
+
+void simd_byteswap_8byte_avx2(void*, const void*, size_t) {}
+
+#endif  // DAFF_SIMD_AVX2
+}  // namespace DAFF
@@ -0,0 +1,191 @@
+#include "DAFFSharedMemory.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//! Returns the system name of a segment
+static std::string getSystemName(const std::string& sName)
+{
+#ifdef WIN32
+	// Session namespace, no privileges required
+	return "Local\\" + sName;
+#else
+	// POSIX names start with a single slash
+	return (!sName.empty() && (sName[0] == '/') ? sName : "/" + sName);
+#endif
+}
+
+DAFFSharedMemory::DAFFSharedMemory()
+	: m_pData(NULL), m_nSize(0), m_bCreator(false)
+#ifdef WIN32
+	  ,
+	  m_hMapping(NULL)
+#endif
+{
+}
+
+DAFFSharedMemory::~DAFFSharedMemory()
+{
+	close();
+}
+
+int DAFFSharedMemory::create(const std::string& sName, size_t nSize)
+{
+	if (m_pData || sName.empty() || (nSize == 0))
+		return DAFF_MODAL_ERROR;
+
+	std::string sSystemName = getSystemName(sName);
+
+#ifdef WIN32
+	uint64_t ui64Size = (uint64_t)nSize;
+	HANDLE hMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)(ui64Size >> 32),
+										 (DWORD)(ui64Size & 0xFFFFFFFF), sSystemName.c_str());
+	if (hMapping == NULL)
+		return DAFF_FILE_INVALID;
+
+	if (GetLastError() == ERROR_ALREADY_EXISTS) {
+		CloseHandle(hMapping);
+		return DAFF_MODAL_ERROR;
+	}
+
+	void* pView = MapViewOfFile(hMapping, FILE_MAP_WRITE, 0, 0, 0);
+	if (pView == NULL) {
+		CloseHandle(hMapping);
+		return DAFF_FILE_INVALID;
+	}
+
+	m_hMapping = hMapping;
+#else
+	// Segments are never replaced, the name of a live publisher stays valid
+	int iFD = shm_open(sSystemName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (iFD < 0)
+		return (errno == EEXIST ? DAFF_MODAL_ERROR : DAFF_FILE_INVALID);
+
+	if (ftruncate(iFD, (off_t)nSize) != 0) {
+		::close(iFD);
+		shm_unlink(sSystemName.c_str());
+		return DAFF_FILE_INVALID;
+	}
+
+	void* pView = mmap(NULL, nSize, PROT_READ | PROT_WRITE, MAP_SHARED, iFD, 0);
+
+	// The mapping stays valid after closing the descriptor
+	::close(iFD);
+
+	if (pView == MAP_FAILED) {
+		shm_unlink(sSystemName.c_str());
+		return DAFF_FILE_INVALID;
+	}
+#endif
+
+	m_pData = (char*)pView;
+	m_nSize = nSize;
+	m_bCreator = true;
+	m_sName = sSystemName;
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFSharedMemory::attach(const std::string& sName)
+{
+	if (m_pData || sName.empty())
+		return DAFF_MODAL_ERROR;
+
+	std::string sSystemName = getSystemName(sName);
+
+#ifdef WIN32
+	HANDLE hMapping = OpenFileMappingA(FILE_MAP_READ, FALSE, sSystemName.c_str());
+	if (hMapping == NULL)
+		return DAFF_FILE_NOT_FOUND;
+
+	void* pView = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (pView == NULL) {
+		CloseHandle(hMapping);
+		return DAFF_FILE_NOT_FOUND;
+	}
+
+	// The view covers the whole segment (rounded up to pages)
+	MEMORY_BASIC_INFORMATION oInfo;
+	if (VirtualQuery(pView, &oInfo, sizeof(oInfo)) == 0) {
+		UnmapViewOfFile(pView);
+		CloseHandle(hMapping);
+		return DAFF_FILE_NOT_FOUND;
+	}
+
+	m_hMapping = hMapping;
+	size_t nSize = (size_t)oInfo.RegionSize;
+#else
+	int iFD = shm_open(sSystemName.c_str(), O_RDONLY, 0);
+	if (iFD < 0)
+		return DAFF_FILE_NOT_FOUND;
+
+	struct stat statinfo;
+	if ((fstat(iFD, &statinfo) != 0) || (statinfo.st_size <= 0) || ((uint64_t)statinfo.st_size > (size_t)-1)) {
+		::close(iFD);
+		return DAFF_FILE_NOT_FOUND;
+	}
+
+	size_t nSize = (size_t)statinfo.st_size;
+	void* pView = mmap(NULL, nSize, PROT_READ, MAP_SHARED, iFD, 0);
+	::close(iFD);
+
+	if (pView == MAP_FAILED)
+		return DAFF_FILE_NOT_FOUND;
+#endif
+
+	m_pData = (char*)pView;
+	m_nSize = nSize;
+	m_bCreator = false;
+	m_sName = sSystemName;
+
+	return DAFF_NO_ERROR;
+}
+
+void DAFFSharedMemory::close()
+{
+	if (!m_pData)
+		return;
+
+#ifdef WIN32
+	// The segment is destroyed with its last handle
+	UnmapViewOfFile(m_pData);
+	CloseHandle((HANDLE)m_hMapping);
+	m_hMapping = NULL;
+#else
+	munmap(m_pData, m_nSize);
+	if (m_bCreator)
+		shm_unlink(m_sName.c_str());
+#endif
+
+	m_pData = NULL;
+	m_nSize = 0;
+	m_bCreator = false;
+	m_sName.clear();
+}
+
+bool DAFFSharedMemory::isOpened() const
+{
+	return (m_pData != NULL);
+}
+
+bool DAFFSharedMemory::isCreator() const
+{
+	return m_bCreator;
+}
+
+char* DAFFSharedMemory::getData() const
+{
+	return m_pData;
+}
+
+size_t DAFFSharedMemory::getSize() const
+{
+	return m_nSize;
+}
@@ -0,0 +1,101 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_SHAREDMEMORY
+#define IW_DAFF_SHAREDMEMORY
+
+#include <DAFFDefs.h>
+
+#include <cstring>  // required for size_t
+#include <string>
+
+//! Header of a shared-memory segment published by DAFFReader::publishShared()
+/**
+ * The segment holds the image of the DAFF file and, for decoded contents, the offsets of the record
+ * channels and the float arena of the decoded data. Truncated impulse responses add their lengths.
+ * All sections start at 64-byte boundaries, the values are in the byte order of the machine.
+ */
+struct DAFFSharedSegmentHeader {
+	char pcSignature[8];         //!@ DAFF_SHARED_SIGNATURE (written last, once the segment is complete)
+	int32_t iVersion;            //!@ Version of the layout
+	int32_t iNumRecordChannels;  //!@ Number of record channels (offsets and lengths)
+	uint64_t ui64ImageOffset;    //!@ Start of the file image
+	uint64_t ui64ImageSize;      //!@ Size of the file image [Bytes]
+	uint64_t ui64OffsetsOffset;  //!@ Start of the record channel offsets in the arena [uint64, floats] (0: none)
+	uint64_t ui64LengthsOffset;  //!@ Start of the truncated filter lengths [int32] (0: not truncated)
+	uint64_t ui64ArenaOffset;    //!@ Start of the decoded float arena (0: not decoded)
+	uint64_t ui64ArenaSize;      //!@ Size of the decoded float arena [Bytes]
+	float fTruncationThreshold;  //!@ Truncation threshold of the publisher [dB]
+	int32_t iReserved;           //!@ Reserved (zero)
+};
+
+//! Signature of a complete shared-memory segment
+static const char DAFF_SHARED_SIGNATURE[8] = { 'D', 'A', 'F', 'F', 'S', 'H', 'M', '1' };
+
+//! Version of the shared-memory segment layout
+static const int32_t DAFF_SHARED_VERSION = 1;
+
+//! Named shared-memory segment
+/**
+ * Uses shm_open and mmap on POSIX systems and a file mapping backed by the paging file on
+ * Windows ("Local\" namespace). The creator maps the segment writable, attached processes
+ * read-only. On POSIX systems the creator removes the name when closing the segment,
+ * processes which attached before keep their mapping until they close it.
+ */
+class DAFFSharedMemory {
+  public:
+	DAFFSharedMemory();
+	~DAFFSharedMemory();
+
+	//! Creates a new segment of the given name and size (writable)
+	/**
+	 * @return #DAFF_NO_ERROR on success, #DAFF_MODAL_ERROR if the name is in use,
+	 *		   #DAFF_FILE_INVALID if the segment could not be created
+	 */
+	int create(const std::string& sName, size_t nSize);
+
+	//! Attaches to an existing segment (read-only)
+	/**
+	 * @return #DAFF_NO_ERROR on success, #DAFF_FILE_NOT_FOUND if no segment of the name exists
+	 */
+	int attach(const std::string& sName);
+
+	//! Unmaps the segment (and removes the name, if created)
+	void close();
+
+	//! Returns whether a segment is mapped
+	bool isOpened() const;
+
+	//! Returns whether the segment has been created (not attached)
+	bool isCreator() const;
+
+	//! Returns the start address of the segment (NULL if not mapped)
+	char* getData() const;
+
+	//! Returns the size of the segment [Bytes]
+	size_t getSize() const;
+
+  private:
+	char* m_pData;        //!@ Start of the mapped memory
+	size_t m_nSize;       //!@ Size of the mapped memory [Bytes]
+	bool m_bCreator;      //!@ Segment has been created by this instance
+	std::string m_sName;  //!@ System name of the segment
+
+#ifdef WIN32
+	void* m_hMapping;  //!@ Windows file mapping handle
+#endif
+
+	// No copy
+	DAFFSharedMemory(const DAFFSharedMemory&);
+	DAFFSharedMemory& operator=(const DAFFSharedMemory&);
+};
+
+#endif  // IW_DAFF_SHAREDMEMORY
@@ -0,0 +1,254 @@
+#include "DAFFSphereIndex.h"
+
+#include <DAFFUtils.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+DAFFSphereIndex::DAFFSphereIndex() {}
+
+void DAFFSphereIndex::init(const float* pfAlphaDeg, const float* pfBetaDeg, int n)
+{
+	m_vNodes.resize(n > 0 ? n : 0);
+	for (int i = 0; i < n; i++) {
+		toVector(pfAlphaDeg[i], pfBetaDeg[i], m_vNodes[i].v);
+		m_vNodes[i].iIndex = i;
+		m_vNodes[i].iAxis = 0;
+	}
+
+	build(0, (int)m_vNodes.size());
+}
+
+bool DAFFSphereIndex::restore(const float* pfAlphaDeg, const float* pfBetaDeg, const int* piIndices,
+							  const int* piAxes, int n)
+{
+	m_vNodes.resize(n > 0 ? n : 0);
+	std::vector<bool> vbUsed(m_vNodes.size(), false);
+	for (int i = 0; i < n; i++) {
+		int iIndex = piIndices[i];
+		if ((iIndex < 0) || (iIndex >= n) || vbUsed[iIndex] || (piAxes[i] < 0) || (piAxes[i] > 2)) {
+			clear();
+			return false;
+		}
+
+		vbUsed[iIndex] = true;
+		toVector(pfAlphaDeg[iIndex], pfBetaDeg[iIndex], m_vNodes[i].v);
+		m_vNodes[i].iIndex = iIndex;
+		m_vNodes[i].iAxis = piAxes[i];
+	}
+
+	if (!validate(0, (int)m_vNodes.size())) {
+		clear();
+		return false;
+	}
+
+	return true;
+}
+
+void DAFFSphereIndex::clear()
+{
+	m_vNodes.clear();
+}
+
+int DAFFSphereIndex::getNumPoints() const
+{
+	return (int)m_vNodes.size();
+}
+
+void DAFFSphereIndex::getNode(int iPosition, int& iIndex, int& iAxis) const
+{
+	iIndex = m_vNodes[iPosition].iIndex;
+	iAxis = m_vNodes[iPosition].iAxis;
+}
+
+size_t DAFFSphereIndex::getMemoryFootprint() const
+{
+	return m_vNodes.capacity() * sizeof(Node);
+}
+
+int DAFFSphereIndex::getNearest(float fAlphaDeg, float fBetaDeg) const
+{
+	int iIndex = -1;
+	float fDist2;
+
+	Query oQuery;
+	toVector(fAlphaDeg, fBetaDeg, oQuery.q);
+	oQuery.k = 1;
+	oQuery.n = 0;
+	oQuery.piIndices = &iIndex;
+	oQuery.pfDist2 = &fDist2;
+	search(0, (int)m_vNodes.size(), oQuery);
+
+	return iIndex;
+}
+
+int DAFFSphereIndex::getKNearest(float fAlphaDeg, float fBetaDeg, int k, int* piIndices, float* pfDistDeg) const
+{
+	if (k <= 0)
+		return 0;
+
+	// Squared distances are collected in the output buffer (if given)
+	std::vector<float> vfDist2;
+	float* pfDist2 = pfDistDeg;
+	if (pfDist2 == NULL) {
+		vfDist2.resize(k);
+		pfDist2 = &vfDist2[0];
+	}
+
+	Query oQuery;
+	toVector(fAlphaDeg, fBetaDeg, oQuery.q);
+	oQuery.k = k;
+	oQuery.n = 0;
+	oQuery.piIndices = piIndices;
+	oQuery.pfDist2 = pfDist2;
+	search(0, (int)m_vNodes.size(), oQuery);
+
+	// Chord length c = 2 sin(d/2) => great-circle distance d = 2 asin(c/2)
+	if (pfDistDeg)
+		for (int i = 0; i < oQuery.n; i++)
+			pfDistDeg[i] = DAFFUtils::rad2gradf(2.0f * asinf(std::min(sqrtf(pfDist2[i]) * 0.5f, 1.0f)));
+
+	return oQuery.n;
+}
+
+int DAFFSphereIndex::getInRadius(float fAlphaDeg, float fBetaDeg, float fRadiusDeg, std::vector<int>& viIndices) const
+{
+	if (fRadiusDeg < 0)
+		return 0;
+
+	// Great-circle distance d => chord length c = 2 sin(d/2)
+	float q[3];
+	toVector(fAlphaDeg, fBetaDeg, q);
+	// The whole sphere: no chord comparison, that could miss the antipode by rounding
+	float fChord = 2.0f * sinf(DAFFUtils::grad2radf(fRadiusDeg) * 0.5f);
+	float fMaxDist2 = (fRadiusDeg >= 180.0f ? FLT_MAX : fChord * fChord);
+
+	size_t nFirst = viIndices.size();
+	searchRadius(0, (int)m_vNodes.size(), q, fMaxDist2, viIndices);
+
+	return (int)(viIndices.size() - nFirst);
+}
+
+void DAFFSphereIndex::toVector(float fAlphaDeg, float fBetaDeg, float* v)
+{
+	// Beta is the polar angle measured from the south pole (beta = 0 => -z)
+	float fAlpha = DAFFUtils::grad2radf(fAlphaDeg);
+	float fBeta = DAFFUtils::grad2radf(fBetaDeg);
+	float fSinBeta = sinf(fBeta);
+	v[0] = fSinBeta * cosf(fAlpha);
+	v[1] = fSinBeta * sinf(fAlpha);
+	v[2] = -cosf(fBeta);
+}
+
+void DAFFSphereIndex::build(int lo, int hi)
+{
+	if (hi - lo <= 1)
+		return;
+
+	// Split along the axis of the greatest extent
+	float pfMin[3] = { 1.0f, 1.0f, 1.0f };
+	float pfMax[3] = { -1.0f, -1.0f, -1.0f };
+	for (int i = lo; i < hi; i++)
+		for (int j = 0; j < 3; j++) {
+			pfMin[j] = std::min(pfMin[j], m_vNodes[i].v[j]);
+			pfMax[j] = std::max(pfMax[j], m_vNodes[i].v[j]);
+		}
+
+	AxisLess oLess;
+	oLess.iAxis = 0;
+	for (int j = 1; j < 3; j++)
+		if (pfMax[j] - pfMin[j] > pfMax[oLess.iAxis] - pfMin[oLess.iAxis])
+			oLess.iAxis = j;
+
+	int m = (lo + hi) / 2;
+	std::nth_element(m_vNodes.begin() + lo, m_vNodes.begin() + m, m_vNodes.begin() + hi, oLess);
+	m_vNodes[m].iAxis = oLess.iAxis;
+
+	build(lo, m);
+	build(m + 1, hi);
+}
+
+bool DAFFSphereIndex::validate(int lo, int hi) const
+{
+	if (hi - lo <= 1)
+		return true;
+
+	// Like after nth_element: nothing greater before the median, nothing smaller after it
+	int m = (lo + hi) / 2;
+	int iAxis = m_vNodes[m].iAxis;
+	float fSplit = m_vNodes[m].v[iAxis];
+	for (int i = lo; i < m; i++)
+		if (m_vNodes[i].v[iAxis] > fSplit)
+			return false;
+	for (int i = m + 1; i < hi; i++)
+		if (m_vNodes[i].v[iAxis] < fSplit)
+			return false;
+
+	return validate(lo, m) && validate(m + 1, hi);
+}
+
+void DAFFSphereIndex::search(int lo, int hi, Query& oQuery) const
+{
+	if (lo >= hi)
+		return;
+
+	int m = (lo + hi) / 2;
+	const Node& oNode = m_vNodes[m];
+
+	float dx = oQuery.q[0] - oNode.v[0];
+	float dy = oQuery.q[1] - oNode.v[1];
+	float dz = oQuery.q[2] - oNode.v[2];
+	float fDist2 = dx * dx + dy * dy + dz * dz;
+
+	// Insert into the sorted list of the found points
+	if ((oQuery.n < oQuery.k) || (fDist2 < oQuery.pfDist2[oQuery.n - 1])) {
+		int i = (oQuery.n < oQuery.k ? oQuery.n++ : oQuery.n - 1);
+		for (; (i > 0) && (oQuery.pfDist2[i - 1] > fDist2); i--) {
+			oQuery.pfDist2[i] = oQuery.pfDist2[i - 1];
+			oQuery.piIndices[i] = oQuery.piIndices[i - 1];
+		}
+		oQuery.pfDist2[i] = fDist2;
+		oQuery.piIndices[i] = oNode.iIndex;
+	}
+
+	if (hi - lo == 1)
+		return;
+
+	// Closer half first, the other one only if it can hold closer points
+	float fDiff = oQuery.q[oNode.iAxis] - oNode.v[oNode.iAxis];
+	if (fDiff < 0) {
+		search(lo, m, oQuery);
+		if ((oQuery.n < oQuery.k) || (fDiff * fDiff < oQuery.pfDist2[oQuery.n - 1]))
+			search(m + 1, hi, oQuery);
+	} else {
+		search(m + 1, hi, oQuery);
+		if ((oQuery.n < oQuery.k) || (fDiff * fDiff < oQuery.pfDist2[oQuery.n - 1]))
+			search(lo, m, oQuery);
+	}
+}
+
+void DAFFSphereIndex::searchRadius(int lo, int hi, const float* q, float fMaxDist2, std::vector<int>& viIndices) const
+{
+	if (lo >= hi)
+		return;
+
+	int m = (lo + hi) / 2;
+	const Node& oNode = m_vNodes[m];
+
+	float dx = q[0] - oNode.v[0];
+	float dy = q[1] - oNode.v[1];
+	float dz = q[2] - oNode.v[2];
+	if (dx * dx + dy * dy + dz * dz <= fMaxDist2)
+		viIndices.push_back(oNode.iIndex);
+
+	if (hi - lo == 1)
+		return;
+
+	// The far half only if the splitting plane is within the radius
+	float fDiff = q[oNode.iAxis] - oNode.v[oNode.iAxis];
+	if ((fDiff < 0) || (fDiff * fDiff <= fMaxDist2))
+		searchRadius(lo, m, q, fMaxDist2, viIndices);
+	if ((fDiff >= 0) || (fDiff * fDiff <= fMaxDist2))
+		searchRadius(m + 1, hi, q, fMaxDist2, viIndices);
+}
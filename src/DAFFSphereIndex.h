@@ -0,0 +1,137 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#ifndef IW_DAFF_SPHEREINDEX
+#define IW_DAFF_SPHEREINDEX
+
+#include <DAFFDefs.h>
+
+#include <vector>
+
+//! Spatial index of arbitrary directions on the sphere
+/**
+ * Used by the reader for nearest neighbour queries on irregular grids (records with
+ * explicit directions). The directions are held as unit vectors in a balanced KD-tree,
+ * so a query visits O(log N) points instead of all records. Since the chordal distance
+ * grows monotonically with the great-circle distance, the neighbours are exact and
+ * there are no special cases at the poles or at the 0&deg;/360&deg; seam.
+ *
+ * Directions are given in the data spherical coordinate system (alpha, beta) [degrees].
+ * Queries are const and can run concurrently.
+ */
+class DAFFSphereIndex {
+  public:
+	DAFFSphereIndex();
+
+	//! Builds the index (replaces all previous points)
+	/**
+	 * \param [in] pfAlphaDeg	Alpha angles [degrees], n elements
+	 * \param [in] pfBetaDeg		Beta angles [degrees], n elements
+	 * \param [in] n				Number of points (point indices are 0..n-1)
+	 */
+	void init(const float* pfAlphaDeg, const float* pfBetaDeg, int n);
+
+	//! Restores an index built before from its tree order (e.g. stored in a file)
+	/**
+	 * Skips the construction of the tree. The order is validated: every point must
+	 * appear once and all nodes must split their subtrees along their axes, otherwise
+	 * the index remains empty.
+	 *
+	 * \param [in] pfAlphaDeg	Alpha angles [degrees], n elements (by point index)
+	 * \param [in] pfBetaDeg		Beta angles [degrees], n elements (by point index)
+	 * \param [in] piIndices		Point index of each node, n elements (tree order, see getNode)
+	 * \param [in] piAxes		Split axis of each node, n elements (tree order, see getNode)
+	 * \param [in] n				Number of points
+	 *
+	 * @return True on success, false if the order does not describe a valid tree of the points
+	 */
+	bool restore(const float* pfAlphaDeg, const float* pfBetaDeg, const int* piIndices, const int* piAxes, int n);
+
+	//! Removes all points
+	void clear();
+
+	//! Returns the number of points
+	int getNumPoints() const;
+
+	//! Returns the point index and the split axis of a node in tree order (0 <= iPosition < getNumPoints())
+	void getNode(int iPosition, int& iIndex, int& iAxis) const;
+
+	//! Returns the heap memory of the tree [Bytes]
+	size_t getMemoryFootprint() const;
+
+	//! Returns the index of the point closest to a direction (-1 if the index is empty)
+	int getNearest(float fAlphaDeg, float fBetaDeg) const;
+
+	//! Determines the k points closest to a direction
+	/**
+	 * \param [in] fAlphaDeg		Alpha angle [degrees]
+	 * \param [in] fBetaDeg		Beta angle [degrees]
+	 * \param [in] k				Number of requested points
+	 * \param [out] piIndices	Point indices, sorted by ascending distance, k elements
+	 * \param [out] pfDistDeg	Great-circle distances [degrees], k elements (may be NULL)
+	 *
+	 * @return Number of points found, min(k, number of points)
+	 */
+	int getKNearest(float fAlphaDeg, float fBetaDeg, int k, int* piIndices, float* pfDistDeg) const;
+
+	//! Appends the points within a great-circle distance of a direction (in tree order)
+	/**
+	 * \param [in] fAlphaDeg		Alpha angle [degrees]
+	 * \param [in] fBetaDeg		Beta angle [degrees]
+	 * \param [in] fRadiusDeg	Maximum great-circle distance [degrees]
+	 * \param [out] viIndices	Point indices, appended
+	 *
+	 * @return Number of points found
+	 */
+	int getInRadius(float fAlphaDeg, float fBetaDeg, float fRadiusDeg, std::vector<int>& viIndices) const;
+
+  private:
+	//! Tree node, the children of the node at position m of [lo, hi) are the medians of [lo, m) and [m+1, hi)
+	struct Node {
+		float v[3];  //!@ Unit vector
+		int iIndex;  //!@ Point index
+		int iAxis;   //!@ Split axis (0-2)
+	};
+
+	//! Orders nodes along one axis
+	struct AxisLess {
+		int iAxis;  //!@ Axis (0-2)
+		inline bool operator()(const Node& a, const Node& b) const { return a.v[iAxis] < b.v[iAxis]; };
+	};
+
+	//! Query state
+	struct Query {
+		float q[3];      //!@ Unit vector of the direction
+		int k;           //!@ Number of requested points
+		int n;           //!@ Number of points found so far
+		int* piIndices;  //!@ Found point indices, sorted by ascending distance
+		float* pfDist2;  //!@ Squared chordal distances of the found points
+	};
+
+	std::vector<Node> m_vNodes;  //!@ Nodes in tree order
+
+	//! Converts a direction into a unit vector
+	static void toVector(float fAlphaDeg, float fBetaDeg, float* v);
+
+	//! Arranges the nodes of [lo, hi) recursively
+	void build(int lo, int hi);
+
+	//! Checks recursively that the nodes of [lo, hi) split their subtrees along their axes
+	bool validate(int lo, int hi) const;
+
+	//! Searches the nodes of [lo, hi) recursively
+	void search(int lo, int hi, Query& oQuery) const;
+
+	//! Appends the nodes of [lo, hi) within the squared chordal distance of a unit vector recursively
+	void searchRadius(int lo, int hi, const float* q, float fMaxDist2, std::vector<int>& viIndices) const;
+};
+
+#endif  // IW_DAFF_SPHEREINDEX
@@ -0,0 +1,366 @@
+#include <DAFFSphereIntegrator.h>
+
+#include <DAFFContent.h>
+#include <DAFFContentDFT.h>
+#include <DAFFContentMPS.h>
+#include <DAFFContentMS.h>
+#include <DAFFProperties.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <system_error>
+#include <thread>
+
+#include "Utils.h"
+
+//! Directions per record that estimate the Voronoi cells of irregular grids (within the limits below)
+static const int DAFF_INTEGRATOR_SAMPLES_PER_RECORD = 1024;
+
+//! Minimum number of directions that estimate the Voronoi cells
+static const int DAFF_INTEGRATOR_MIN_SAMPLES = 1 << 16;
+
+//! Maximum number of directions that estimate the Voronoi cells
+static const int DAFF_INTEGRATOR_MAX_SAMPLES = 1 << 22;
+
+//! Number of directions looked up at once
+static const int DAFF_INTEGRATOR_BLOCK_SIZE = 4096;
+
+//! Minimum number of values (records times data length) per thread of the automatic thread count
+static const uint64_t DAFF_INTEGRATOR_MIN_OPS_PER_THREAD = 1 << 18;
+
+static const double DAFF_PI = 3.14159265358979323846;
+
+//! Counts the nearest records of the directions [iBegin, iEnd) of a spherical Fibonacci lattice of n directions
+static void countNearestRecords(const DAFFContent* pContent, int n, int iBegin, int iEnd, std::vector<int>* pviCounts)
+{
+	// Golden angle [degrees]
+	const double dGoldenAngle = 180.0 * (3.0 - std::sqrt(5.0));
+
+	float pfAlpha[DAFF_INTEGRATOR_BLOCK_SIZE];
+	float pfBeta[DAFF_INTEGRATOR_BLOCK_SIZE];
+	int piIndices[DAFF_INTEGRATOR_BLOCK_SIZE];
+	bool pbOutOfBounds[DAFF_INTEGRATOR_BLOCK_SIZE];
+
+	for (int i = iBegin; i < iEnd; i += DAFF_INTEGRATOR_BLOCK_SIZE) {
+		int m = std::min(DAFF_INTEGRATOR_BLOCK_SIZE, iEnd - i);
+
+		// Equal-area rings: z = -cos(beta) uniformly distributed
+		for (int j = 0; j < m; j++) {
+			double z = 1.0 - (2.0 * (i + j) + 1.0) / n;
+			pfAlpha[j] = (float)std::fmod((i + j) * dGoldenAngle, 360.0);
+			pfBeta[j] = (float)(std::acos(-z) * 180.0 / DAFF_PI);
+		}
+
+		pContent->getNearestNeighbours(DAFF_DATA_VIEW, pfAlpha, pfBeta, piIndices, pbOutOfBounds, m);
+
+		for (int j = 0; j < m; j++)
+			if (!pbOutOfBounds[j] && (piIndices[j] >= 0))
+				(*pviCounts)[piIndices[j]]++;
+	}
+}
+
+DAFFSphereIntegrator::DAFFSphereIntegrator(const DAFFContent* pContent)
+	: m_pContent(pContent), m_pContentMS(NULL), m_pContentMPS(NULL), m_pContentDFT(NULL), m_iNumThreads(0),
+	  m_dCoveredSolidAngle(0)
+{
+	assert(pContent != NULL);
+
+	const DAFFProperties* pProps = m_pContent->getProperties();
+	switch (pProps->getContentType()) {
+	case DAFF_MAGNITUDE_SPECTRUM:
+		m_pContentMS = dynamic_cast<const DAFFContentMS*>(m_pContent);
+		break;
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		m_pContentMPS = dynamic_cast<const DAFFContentMPS*>(m_pContent);
+		break;
+	case DAFF_DFT_SPECTRUM:
+		m_pContentDFT = dynamic_cast<const DAFFContentDFT*>(m_pContent);
+		break;
+	}
+
+	if (pProps->isRegularGrid())
+		initRegularWeights();
+	else
+		initIrregularWeights();
+
+	m_dCoveredSolidAngle = 0;
+	for (size_t i = 0; i < m_vfWeights.size(); i++)
+		m_dCoveredSolidAngle += m_vfWeights[i];
+}
+
+DAFFSphereIntegrator::~DAFFSphereIntegrator() {}
+
+void DAFFSphereIntegrator::initRegularWeights()
+{
+	const DAFFProperties* pProps = m_pContent->getProperties();
+	int iNumRecords = pProps->getNumberOfRecords();
+	m_vfWeights.resize(iNumRecords);
+
+	const double dDeg2Rad = DAFF_PI / 180.0;
+
+	// Single alpha point: full circle, single beta point: full beta range
+	double dAlphaWidth = 360.0;
+	if (pProps->getAlphaPoints() > 1)
+		dAlphaWidth = pProps->getAlphaResolution();
+	double dPoleWidth = std::min((double)pProps->getAlphaPoints() * dAlphaWidth, 360.0);
+	double dHalfStep = (pProps->getBetaPoints() > 1 ? 0.5 * pProps->getBetaResolution() : 180.0);
+
+	// Same record layout as in the nearest neighbour search (single records at the poles)
+	bool bSouthPole = (pProps->getBetaStart() == 0.0f);
+	bool bNorthPole = (pProps->getBetaEnd() == 180.0f);
+
+	for (int r = 0; r < iNumRecords; r++) {
+		float fAlpha, fBeta;
+		m_pContent->getRecordCoords(r, DAFF_DATA_VIEW, fAlpha, fBeta);
+
+		bool bPole = (bSouthPole && (fBeta == 0.0f)) || (bNorthPole && (fBeta == 180.0f));
+		double dLower = std::max(fBeta - dHalfStep, 0.0);
+		double dUpper = std::min(fBeta + dHalfStep, 180.0);
+		double dBand = std::cos(dLower * dDeg2Rad) - std::cos(dUpper * dDeg2Rad);
+		m_vfWeights[r] = (float)((bPole ? dPoleWidth : dAlphaWidth) * dDeg2Rad * dBand);
+	}
+}
+
+void DAFFSphereIntegrator::initIrregularWeights()
+{
+	int iNumRecords = m_pContent->getProperties()->getNumberOfRecords();
+	m_vfWeights.assign(iNumRecords, 0.0f);
+	if (iNumRecords == 0)
+		return;
+
+	int64_t i64NumSamples = (int64_t)iNumRecords * DAFF_INTEGRATOR_SAMPLES_PER_RECORD;
+	int n = (int)std::min(std::max(i64NumSamples, (int64_t)DAFF_INTEGRATOR_MIN_SAMPLES),
+						  (int64_t)DAFF_INTEGRATOR_MAX_SAMPLES);
+
+	// The lattice is split into ranges, each counted by a thread
+	int iNumThreads = (int)std::max(std::thread::hardware_concurrency(), 1u);
+	iNumThreads = std::max(std::min(iNumThreads, n / DAFF_INTEGRATOR_MIN_SAMPLES), 1);
+
+	std::vector<std::vector<int> > vviCounts(iNumThreads, std::vector<int>(iNumRecords, 0));
+	std::vector<std::thread> vThreads;
+	int iChunk = (n + iNumThreads - 1) / iNumThreads;
+	for (int t = 1; t < iNumThreads; t++) {
+		int iBegin = t * iChunk;
+		int iEnd = std::min(iBegin + iChunk, n);
+		try {
+			vThreads.push_back(std::thread(countNearestRecords, m_pContent, n, iBegin, iEnd, &vviCounts[t]));
+		} catch (const std::system_error&) {
+			countNearestRecords(m_pContent, n, iBegin, iEnd, &vviCounts[t]);  // No more threads available
+		}
+	}
+
+	countNearestRecords(m_pContent, n, 0, std::min(iChunk, n), &vviCounts[0]);
+
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	// Every direction represents the same solid angle
+	double dSampleWeight = 4 * DAFF_PI / n;
+	for (int r = 0; r < iNumRecords; r++) {
+		int iCount = 0;
+		for (int t = 0; t < iNumThreads; t++)
+			iCount += vviCounts[t][r];
+		m_vfWeights[r] = (float)(iCount * dSampleWeight);
+	}
+}
+
+const DAFFContent* DAFFSphereIntegrator::getContent() const
+{
+	return m_pContent;
+}
+
+int DAFFSphereIntegrator::getDataLength() const
+{
+	if (m_pContentMS)
+		return m_pContentMS->getNumFrequencies();
+	if (m_pContentMPS)
+		return m_pContentMPS->getNumFrequencies();
+	if (m_pContentDFT)
+		return m_pContentDFT->getNumDFTCoeffs();
+	return 0;
+}
+
+int DAFFSphereIntegrator::getNumThreads() const
+{
+	return m_iNumThreads;
+}
+
+void DAFFSphereIntegrator::setNumThreads(int iNumThreads)
+{
+	m_iNumThreads = std::max(iNumThreads, 0);
+}
+
+const float* DAFFSphereIntegrator::getWeightsPtr() const
+{
+	return (m_vfWeights.empty() ? NULL : &m_vfWeights[0]);
+}
+
+float DAFFSphereIntegrator::getWeight(int iRecordIndex) const
+{
+	assert((iRecordIndex >= 0) && (iRecordIndex < (int)m_vfWeights.size()));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= (int)m_vfWeights.size()))
+		return 0.0f;
+
+	return m_vfWeights[iRecordIndex];
+}
+
+float DAFFSphereIntegrator::getCoveredSolidAngle() const
+{
+	return (float)m_dCoveredSolidAngle;
+}
+
+void DAFFSphereIntegrator::accumulateRange(int iChannel, int iBegin, int iEnd, float* pfSum, int* piError) const
+{
+	int iLength = getDataLength();
+	std::vector<float> vfBuf(m_pContentDFT ? 2 * iLength : iLength);
+
+	for (int r = iBegin; r < iEnd; r++) {
+		if (m_vfWeights[r] == 0.0f)
+			continue;
+
+		int iError;
+		if (m_pContentMS)
+			iError = m_pContentMS->getMagnitudes(r, iChannel, &vfBuf[0]);
+		else if (m_pContentMPS)
+			iError = m_pContentMPS->getMagnitudes(r, iChannel, &vfBuf[0]);
+		else
+			iError = m_pContentDFT->getDFTCoeffs(r, iChannel, &vfBuf[0]);
+
+		if (iError != DAFF_NO_ERROR) {
+			*piError = iError;
+			return;
+		}
+
+		if (m_pContentDFT)
+			DAFF::csqmac_float(pfSum, &vfBuf[0], m_vfWeights[r], iLength);
+		else
+			DAFF::sqmac_float(pfSum, &vfBuf[0], m_vfWeights[r], iLength);
+	}
+}
+
+int DAFFSphereIntegrator::getPowerResponse(int iChannel, float* pfDest) const
+{
+	int iLength = getDataLength();
+	if (iLength == 0)
+		return DAFF_MODAL_ERROR;
+
+	if ((iChannel < 0) || (iChannel >= m_pContent->getProperties()->getNumberOfChannels()))
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	int iNumRecords = (int)m_vfWeights.size();
+
+	// Distribute the records over several threads, each accumulating a range into its own sums
+	int iNumThreads = m_iNumThreads;
+	if (iNumThreads <= 0) {
+		uint64_t ui64NumOps = (uint64_t)iNumRecords * iLength;
+		uint64_t ui64MaxThreads = std::max(ui64NumOps / DAFF_INTEGRATOR_MIN_OPS_PER_THREAD, (uint64_t)1);
+		iNumThreads = (int)std::min((uint64_t)std::max(std::thread::hardware_concurrency(), 1u), ui64MaxThreads);
+	}
+	iNumThreads = std::max(std::min(iNumThreads, iNumRecords), 1);
+
+	std::vector<float> vfSums((size_t)iNumThreads * iLength, 0.0f);
+	std::vector<int> viErrors(iNumThreads, DAFF_NO_ERROR);
+	std::vector<std::thread> vThreads;
+	int iChunk = (iNumRecords + iNumThreads - 1) / iNumThreads;
+	for (int t = 1; t < iNumThreads; t++) {
+		int iBegin = t * iChunk;
+		int iEnd = std::min(iBegin + iChunk, iNumRecords);
+		float* pfSum = &vfSums[(size_t)t * iLength];
+		try {
+			vThreads.push_back(std::thread(&DAFFSphereIntegrator::accumulateRange, this, iChannel, iBegin, iEnd, pfSum,
+										   &viErrors[t]));
+		} catch (const std::system_error&) {
+			accumulateRange(iChannel, iBegin, iEnd, pfSum, &viErrors[t]);  // No more threads available
+		}
+	}
+
+	accumulateRange(iChannel, 0, std::min(iChunk, iNumRecords), &vfSums[0], &viErrors[0]);
+
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	for (int t = 0; t < iNumThreads; t++)
+		if (viErrors[t] != DAFF_NO_ERROR)
+			return viErrors[t];
+
+	// Partial sums of the threads in double precision
+	for (int k = 0; k < iLength; k++) {
+		double dSum = 0;
+		for (int t = 0; t < iNumThreads; t++)
+			dSum += vfSums[(size_t)t * iLength + k];
+		pfDest[k] = (float)dSum;
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFSphereIntegrator::getDiffuseFieldAverage(int iChannel, float* pfDest) const
+{
+	int iError = getPowerResponse(iChannel, pfDest);
+	if ((iError != DAFF_NO_ERROR) || (pfDest == NULL))
+		return iError;
+
+	int iLength = getDataLength();
+	double dScale = (m_dCoveredSolidAngle > 0 ? 1.0 / m_dCoveredSolidAngle : 0.0);
+	for (int k = 0; k < iLength; k++)
+		pfDest[k] = (float)std::sqrt(pfDest[k] * dScale);
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFSphereIntegrator::getDirectivityIndex(int iView, float fAngle1Deg, float fAngle2Deg, int iChannel,
+											  float* pfDestDB) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	int iError = getPowerResponse(iChannel, pfDestDB);
+	if ((iError != DAFF_NO_ERROR) || (pfDestDB == NULL))
+		return iError;
+
+	int iRecordIndex;
+	m_pContent->getNearestNeighbour(iView, fAngle1Deg, fAngle2Deg, iRecordIndex);
+
+	// Energy of the record
+	int iLength = getDataLength();
+	std::vector<float> vfBuf(m_pContentDFT ? 2 * iLength : iLength);
+	std::vector<float> vfEnergy(iLength, 0.0f);
+	if (m_pContentMS)
+		iError = m_pContentMS->getMagnitudes(iRecordIndex, iChannel, &vfBuf[0]);
+	else if (m_pContentMPS)
+		iError = m_pContentMPS->getMagnitudes(iRecordIndex, iChannel, &vfBuf[0]);
+	else
+		iError = m_pContentDFT->getDFTCoeffs(iRecordIndex, iChannel, &vfBuf[0]);
+
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	if (m_pContentDFT)
+		DAFF::csqmac_float(&vfEnergy[0], &vfBuf[0], 1.0f, iLength);
+	else
+		DAFF::sqmac_float(&vfEnergy[0], &vfBuf[0], 1.0f, iLength);
+
+	// DI = 10 log10(E * Omega / P), the smallest positive float stands in for no energy in the direction
+	for (int k = 0; k < iLength; k++) {
+		double dPower = pfDestDB[k];
+		if (dPower <= 0) {
+			pfDestDB[k] = 0.0f;
+			continue;
+		}
+
+		double dRatio = std::max(vfEnergy[k] * m_dCoveredSolidAngle / dPower, (double)FLT_MIN);
+		pfDestDB[k] = (float)(10.0 * std::log10(dRatio));
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+size_t DAFFSphereIntegrator::getMemoryFootprint() const
+{
+	return m_vfWeights.capacity() * sizeof(float);
+}
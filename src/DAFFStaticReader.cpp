@@ -0,0 +1,743 @@
+#include <DAFFStaticReader.h>
+
+#include <DAFFUtils.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#include "DAFFHeader.h"
+#include "Utils.h"
+
+//! Size of a sample of a quantization in the data block [Bytes]
+static int getSampleSize(int iQuantization)
+{
+	switch (iQuantization) {
+	case DAFF_INT16:
+	case DAFF_FLOAT16:
+	case DAFF_BFLOAT16:
+	case DAFF_INT16_BFP:
+		return 2;
+
+	case DAFF_INT24:
+		return 3;
+	}
+
+	return 4;
+}
+
+//! Alignment of the samples of a quantization in place [Bytes]
+static int getSampleAlignment(int iQuantization)
+{
+	return (iQuantization == DAFF_INT24) ? 1 : getSampleSize(iQuantization);
+}
+
+//! Converts stored values of a quantization (little endian, aligned) into floats (scale of block floating point)
+static void convertValues(const char* pData, int iQuantization, int iCount, float* pfDest, float fScale)
+{
+	switch (iQuantization) {
+	case DAFF_INT16:
+		DAFF::stc_sint16_to_float(pfDest, (const short*)pData, iCount);
+		break;
+
+	case DAFF_INT16_BFP:
+		DAFF::stc_sint16_to_float(pfDest, (const short*)pData, iCount, 1, 1, fScale);
+		break;
+
+	case DAFF_INT24:
+		DAFF::stc_sint24_to_float(pfDest, pData, iCount);
+		break;
+
+	case DAFF_FLOAT16:
+		DAFF::stc_half_to_float(pfDest, (const unsigned short*)pData, iCount);
+		break;
+
+	case DAFF_BFLOAT16:
+		DAFF::stc_bfloat16_to_float(pfDest, (const unsigned short*)pData, iCount);
+		break;
+
+	default:
+		memcpy(pfDest, pData, (size_t)iCount * sizeof(float));
+		break;
+	}
+}
+
+DAFFStaticReader::DAFFStaticReader()
+{
+	close();
+}
+
+int DAFFStaticReader::getArenaSize(const void* pImage, size_t nImageSize, size_t& nArenaSize)
+{
+	assert(pImage != NULL);
+
+	// Headers only, a temporary reader on the stack
+	DAFFStaticReader oReader;
+	return oReader.parse((const char*)pImage, nImageSize, NULL, nArenaSize);
+}
+
+int DAFFStaticReader::open(const void* pImage, size_t nImageSize, void* pArena, size_t nArenaSize)
+{
+	assert(pImage != NULL);
+	assert(pArena != NULL);
+
+	close();
+
+	if ((pArena == NULL) || ((uintptr_t)pArena % 4 != 0))
+		return DAFF_MODAL_ERROR;
+
+	int ec = parse((const char*)pImage, nImageSize, (char*)pArena, nArenaSize);
+	if (ec != DAFF_NO_ERROR)
+		close();
+
+	return ec;
+}
+
+void DAFFStaticReader::close()
+{
+	m_pDataBlock = NULL;
+	m_pChannels = NULL;
+	m_pfFrequencies = NULL;
+	m_iContentType = -1;
+	m_iQuantization = -1;
+	m_iNumChannels = 0;
+	m_iNumRecords = 0;
+	m_iElementsPerRecord = 0;
+	m_iNumFrequencies = 0;
+	m_iNumDFTCoeffs = 0;
+	m_iTransformSize = 0;
+	m_fSamplerate = 0;
+	m_iAlphaPoints = 0;
+	m_fAlphaStart = m_fAlphaEnd = m_fAlphaResolution = 0;
+	m_iBetaPoints = 0;
+	m_fBetaStart = m_fBetaEnd = m_fBetaResolution = 0;
+	m_oDefaultOrientation = DAFFOrientationYPR();
+	m_oTransform.setOrientation(m_oDefaultOrientation);
+}
+
+bool DAFFStaticReader::isValid() const
+{
+	return (m_pDataBlock != NULL);
+}
+
+int DAFFStaticReader::parse(const char* pImage, size_t nImageSize, char* pArena, size_t& nArenaSize)
+{
+	// The descriptors and the data are accessed in the file byte order
+	if (!DAFF::is_little_endian())
+		return DAFF_MODAL_ERROR;
+
+	// File header
+	DAFFFileHeader oFileHeader;
+	if (nImageSize < sizeof(DAFFFileHeader))
+		return DAFF_FILE_INVALID;
+	memcpy(&oFileHeader, pImage, sizeof(DAFFFileHeader));
+
+	if ((oFileHeader.pcSignature[0] != 'F') || (oFileHeader.pcSignature[1] != 'W'))
+		return DAFF_FILE_INVALID;
+
+	if (oFileHeader.iFileFormatVersion != 170)
+		return DAFF_FILE_FORMAT_VERSION_UNSUPPORTED;
+
+	if (oFileHeader.iNumFileBlocks <= 0)
+		return DAFF_FILE_INVALID;
+
+	size_t nFileBlockTableSize = (size_t)oFileHeader.iNumFileBlocks * sizeof(DAFFFileBlockEntry);
+	if (nFileBlockTableSize > nImageSize - sizeof(DAFFFileHeader))
+		return DAFF_FILE_INVALID;
+
+	// File blocks (read from the table in place)
+	DAFFFileBlockEntry oMainHeaderBlock, oContentHeaderBlock, oRecordDescBlock, oDataBlock;
+	int iNumMainHeaders = 0, iNumContentHeaders = 0, iNumRecordDescs = 0, iNumDataBlocks = 0;
+	bool bUnsupported = false;
+	for (int i = 0; i < oFileHeader.iNumFileBlocks; i++) {
+		DAFFFileBlockEntry oBlock;
+		memcpy(&oBlock, pImage + sizeof(DAFFFileHeader) + i * sizeof(DAFFFileBlockEntry), sizeof(DAFFFileBlockEntry));
+
+		if (oBlock.ui64Offset < sizeof(DAFFFileHeader) + nFileBlockTableSize)
+			return DAFF_FILE_INVALID;
+
+		if ((oBlock.ui64Offset > nImageSize) || (oBlock.ui64Size > nImageSize - oBlock.ui64Offset))
+			return DAFF_FILE_CORRUPTED;
+
+		switch (oBlock.iID) {
+		case FILEBLOCK_DAFF1_MAIN_HEADER_ID:
+			oMainHeaderBlock = oBlock;
+			iNumMainHeaders++;
+			break;
+
+		case FILEBLOCK_DAFF1_CONTENT_HEADER_ID:
+			oContentHeaderBlock = oBlock;
+			iNumContentHeaders++;
+			break;
+
+		case FILEBLOCK_DAFF1_RECORD_DESC_ID:
+			oRecordDescBlock = oBlock;
+			iNumRecordDescs++;
+			break;
+
+		case FILEBLOCK_DAFF1_DATA_ID:
+			oDataBlock = oBlock;
+			iNumDataBlocks++;
+			break;
+
+		case FILEBLOCK_DAFF1_COMPRESSED_DATA_ID:
+			iNumDataBlocks++;
+			bUnsupported = true;
+			break;
+
+		case FILEBLOCK_DAFF1_RECORD_DIRECTIONS_ID:
+		case FILEBLOCK_DAFF1_SYMMETRY_ID:
+			bUnsupported = true;
+			break;
+		}
+	}
+
+	if ((iNumMainHeaders != 1) || (oMainHeaderBlock.ui64Size < sizeof(DAFFMainHeader)))
+		return DAFF_FILE_INVALID;
+
+	if ((iNumContentHeaders != 1) || (iNumRecordDescs != 1) || (iNumDataBlocks != 1))
+		return DAFF_FILE_CORRUPTED;
+
+	// Compressed data, irregular grids and symmetric files require the full reader
+	if (bUnsupported)
+		return DAFF_MODAL_ERROR;
+
+	// Main header
+	DAFFMainHeader oMainHeader;
+	memcpy(&oMainHeader, pImage + oMainHeaderBlock.ui64Offset, sizeof(DAFFMainHeader));
+
+	switch (oMainHeader.iContentType) {
+	case DAFF_IMPULSE_RESPONSE:
+	case DAFF_MAGNITUDE_SPECTRUM:
+	case DAFF_PHASE_SPECTRUM:
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+	case DAFF_DFT_SPECTRUM:
+		break;
+
+	default:
+		return DAFF_FILE_CONTENT_TYPE_UNKOWN;
+	}
+
+	switch (oMainHeader.iQuantization) {
+	case DAFF_INT16:
+	case DAFF_INT24:
+	case DAFF_INT16_BFP:
+		// Spectra are always stored as floating point values
+		if (oMainHeader.iContentType != DAFF_IMPULSE_RESPONSE)
+			return DAFF_FILE_QUANTIZATION_UNKOWN;
+		break;
+
+	case DAFF_FLOAT16:
+	case DAFF_BFLOAT16:
+	case DAFF_FLOAT32:
+		break;
+
+	default:
+		return DAFF_FILE_QUANTIZATION_UNKOWN;
+	}
+
+	if ((oMainHeader.iNumChannels < 1) || (oMainHeader.iNumRecords < 1) || (oMainHeader.iElementsPerRecord < 1))
+		return DAFF_FILE_INVALID_MAIN_PARAMETER;
+
+	if ((oMainHeader.iAlphaPoints < 1) || (oMainHeader.fAlphaStart < 0.0f) || (oMainHeader.fAlphaStart >= 360.0f) ||
+		(oMainHeader.fAlphaEnd < 0.0f) || (oMainHeader.fAlphaEnd > 360.0f))
+		return DAFF_FILE_ALPHA_ANGLES_INVALID;
+
+	if ((oMainHeader.iBetaPoints < 1) || (oMainHeader.fBetaStart > oMainHeader.fBetaEnd) ||
+		(oMainHeader.fBetaStart < 0.0f) || (oMainHeader.fBetaEnd > 180.0f))
+		return DAFF_FILE_BETA_ANGLES_INVALID;
+
+	m_iContentType = oMainHeader.iContentType;
+	m_iQuantization = oMainHeader.iQuantization;
+	m_iNumChannels = oMainHeader.iNumChannels;
+	m_iNumRecords = oMainHeader.iNumRecords;
+	m_iElementsPerRecord = oMainHeader.iElementsPerRecord;
+	m_iAlphaPoints = oMainHeader.iAlphaPoints;
+	m_fAlphaStart = oMainHeader.fAlphaStart;
+	m_fAlphaEnd = oMainHeader.fAlphaEnd;
+	m_iBetaPoints = oMainHeader.iBetaPoints;
+	m_fBetaStart = oMainHeader.fBetaStart;
+	m_fBetaEnd = oMainHeader.fBetaEnd;
+	m_oDefaultOrientation =
+		DAFFOrientationYPR(oMainHeader.fOrientYaw, oMainHeader.fOrientPitch, oMainHeader.fOrientRoll);
+	m_oTransform.setOrientation(m_oDefaultOrientation);
+
+	// Resolutions like DAFFReader (only a full alpha range counts the end point once)
+	float fAlphaSpan =
+		(m_fAlphaEnd > m_fAlphaStart) ? (m_fAlphaEnd - m_fAlphaStart) : (360 - m_fAlphaStart + m_fAlphaEnd);
+	if (m_iAlphaPoints > 1)
+		m_fAlphaResolution = fAlphaSpan / ((fAlphaSpan == 360) ? m_iAlphaPoints : m_iAlphaPoints - 1);
+	if (m_iBetaPoints > 1)
+		m_fBetaResolution = (m_fBetaEnd - m_fBetaStart) / (m_iBetaPoints - 1);
+
+	// The grid must not address records beyond the stored ones (the last row may be the north pole)
+	int iLastRecordIndex = getGridRecordIndex(m_iAlphaPoints - 1, m_iBetaPoints - 1);
+	if (m_iBetaPoints > 1)
+		iLastRecordIndex = std::max(iLastRecordIndex, getGridRecordIndex(m_iAlphaPoints - 1, m_iBetaPoints - 2));
+	if (iLastRecordIndex >= m_iNumRecords)
+		return DAFF_FILE_INVALID_MAIN_PARAMETER;
+
+	// Content header (the support frequencies follow the first 8 bytes)
+	const char* pContentHeader = pImage + oContentHeaderBlock.ui64Offset;
+	int iStoredLength = 0;
+	switch (m_iContentType) {
+	case DAFF_IMPULSE_RESPONSE: {
+		DAFFContentHeaderIR oHeader;
+		if (oContentHeaderBlock.ui64Size < sizeof(oHeader))
+			return DAFF_FILE_CORRUPTED;
+		memcpy(&oHeader, pContentHeader, sizeof(oHeader));
+
+		if ((oHeader.fSamplerate < 0.0f) || (oHeader.iMaxEffectiveFilterLength < 0) ||
+			(oHeader.iMaxEffectiveFilterLength > m_iElementsPerRecord) || (oHeader.iMinFilterOffset < 0) ||
+			(oHeader.iMinFilterOffset > m_iElementsPerRecord))
+			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+
+		m_fSamplerate = oHeader.fSamplerate;
+		break;
+	}
+
+	case DAFF_MAGNITUDE_SPECTRUM:
+	case DAFF_PHASE_SPECTRUM:
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM: {
+		// The number of frequencies is the second word of the MS and MPS headers, the first of the PS header
+		int32_t piWords[2];
+		if (oContentHeaderBlock.ui64Size < sizeof(piWords))
+			return DAFF_FILE_CORRUPTED;
+		memcpy(piWords, pContentHeader, sizeof(piWords));
+
+		m_iNumFrequencies = piWords[(m_iContentType == DAFF_PHASE_SPECTRUM) ? 0 : 1];
+		if (m_iNumFrequencies <= 0)
+			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+
+		if ((oContentHeaderBlock.ui64Size - 8) / sizeof(float) < (uint64_t)m_iNumFrequencies)
+			return DAFF_FILE_CORRUPTED;
+
+		iStoredLength = (m_iContentType == DAFF_MAGNITUDE_PHASE_SPECTRUM) ? 2 * m_iNumFrequencies : m_iNumFrequencies;
+		break;
+	}
+
+	case DAFF_DFT_SPECTRUM: {
+		DAFFContentHeaderDFT oHeader;
+		if (oContentHeaderBlock.ui64Size < sizeof(oHeader))
+			return DAFF_FILE_CORRUPTED;
+		memcpy(&oHeader, pContentHeader, sizeof(oHeader));
+
+		if ((oHeader.iNumDFTCoeffs <= 0) ||
+			((oHeader.iNumDFTCoeffs != oHeader.iTransformSize) &&
+			 (oHeader.iNumDFTCoeffs != oHeader.iTransformSize / 2 + 1)))
+			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+
+		m_iNumDFTCoeffs = oHeader.iNumDFTCoeffs;
+		m_iTransformSize = oHeader.iTransformSize;
+		m_fSamplerate = oHeader.fSamplerate;
+		iStoredLength = 2 * m_iNumDFTCoeffs;
+		break;
+	}
+	}
+
+	// Record descriptors (bounded by the image, so that the arena size does not overflow)
+	bool bIR = (m_iContentType == DAFF_IMPULSE_RESPONSE);
+	bool bBFP = (m_iQuantization == DAFF_INT16_BFP);
+	size_t nDescSize = bIR ? sizeof(DAFFRecordChannelDescIR) : sizeof(DAFFRecordChannelDescDefault);
+	if (bBFP)
+		nDescSize = sizeof(DAFFRecordChannelDescIRBFP);
+	if ((uint64_t)m_iNumRecords * m_iNumChannels > oRecordDescBlock.ui64Size / nDescSize)
+		return DAFF_FILE_CORRUPTED;
+	int iNumRecordChannels = m_iNumRecords * m_iNumChannels;
+
+	size_t nRequiredSize = DAFF_STATIC_READER_ARENA_SIZE(m_iNumRecords, m_iNumChannels, m_iNumFrequencies);
+	if (pArena == NULL) {
+		nArenaSize = nRequiredSize;
+		return DAFF_NO_ERROR;
+	}
+
+	if (nArenaSize < nRequiredSize)
+		return DAFF_MODAL_ERROR;
+
+	// Samples are accessed in place as 16-bit and 32-bit words, offsets within the data block are 32-bit
+	const char* pDataBlock = pImage + oDataBlock.ui64Offset;
+	if (((uintptr_t)pDataBlock % 4 != 0) || (oDataBlock.ui64Size > UINT32_MAX))
+		return DAFF_MODAL_ERROR;
+
+	DAFFStaticRecordChannel* pChannels = reinterpret_cast<DAFFStaticRecordChannel*>(pArena);
+	const char* pDesc = pImage + oRecordDescBlock.ui64Offset;
+	uint64_t ui64SampleSize = (uint64_t)getSampleSize(m_iQuantization);
+	uint64_t ui64SampleAlignment = (uint64_t)getSampleAlignment(m_iQuantization);
+	for (int i = 0; i < iNumRecordChannels; i++) {
+		// Note: All record channel descriptors start with the metadata index and the data offset
+		DAFFRecordChannelDescIRBFP oDesc;
+		oDesc.fScale = 1.0f;
+		memcpy(&oDesc, pDesc + i * nDescSize, nDescSize);
+		if (!bIR) {
+			oDesc.oDesc.iLeadingZeros = 0;
+			oDesc.oDesc.iElementLength = iStoredLength;
+		}
+
+		if (bIR && ((oDesc.oDesc.iLeadingZeros < 0) || (oDesc.oDesc.iElementLength < 0) ||
+					(oDesc.oDesc.iElementLength > m_iElementsPerRecord - oDesc.oDesc.iLeadingZeros)))
+			return DAFF_FILE_CORRUPTED;
+
+		// Block scales are positive and finite
+		if (!(oDesc.fScale > 0) || !(oDesc.fScale <= FLT_MAX))
+			return DAFF_FILE_CORRUPTED;
+
+		const DAFFRecordChannelDescIR& oDescIR = oDesc.oDesc;
+		uint64_t ui64Size = (uint64_t)oDescIR.iElementLength * ui64SampleSize;
+		if ((oDescIR.ui64DataOffset > oDataBlock.ui64Size) ||
+			(ui64Size > oDataBlock.ui64Size - oDescIR.ui64DataOffset) ||
+			(oDescIR.ui64DataOffset % ui64SampleAlignment != 0))
+			return DAFF_FILE_CORRUPTED;
+
+		pChannels[i].ui32DataOffset = (uint32_t)oDescIR.ui64DataOffset;
+		pChannels[i].iLeadingZeros = oDescIR.iLeadingZeros;
+		pChannels[i].iLength = oDescIR.iElementLength;
+		pChannels[i].fScale = oDesc.fScale;
+	}
+
+	// Support frequencies behind the record channels (aligned copy)
+	float* pfFrequencies = reinterpret_cast<float*>(pChannels + iNumRecordChannels);
+	if (m_iNumFrequencies > 0)
+		memcpy(pfFrequencies, pContentHeader + 8, (size_t)m_iNumFrequencies * sizeof(float));
+
+	m_pDataBlock = pDataBlock;
+	m_pChannels = pChannels;
+	m_pfFrequencies = (m_iNumFrequencies > 0) ? pfFrequencies : NULL;
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFStaticReader::getContentType() const
+{
+	return m_iContentType;
+}
+
+int DAFFStaticReader::getQuantization() const
+{
+	return m_iQuantization;
+}
+
+int DAFFStaticReader::getNumberOfChannels() const
+{
+	return m_iNumChannels;
+}
+
+int DAFFStaticReader::getNumberOfRecords() const
+{
+	return m_iNumRecords;
+}
+
+int DAFFStaticReader::getDataLength() const
+{
+	switch (m_iContentType) {
+	case DAFF_IMPULSE_RESPONSE:
+		return m_iElementsPerRecord;
+
+	case DAFF_MAGNITUDE_SPECTRUM:
+	case DAFF_PHASE_SPECTRUM:
+		return m_iNumFrequencies;
+
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		return 2 * m_iNumFrequencies;
+
+	case DAFF_DFT_SPECTRUM:
+		return 2 * m_iNumDFTCoeffs;
+	}
+
+	return 0;
+}
+
+double DAFFStaticReader::getSamplerate() const
+{
+	return m_fSamplerate;
+}
+
+int DAFFStaticReader::getNumFrequencies() const
+{
+	return m_iNumFrequencies;
+}
+
+const float* DAFFStaticReader::getFrequencies() const
+{
+	return m_pfFrequencies;
+}
+
+int DAFFStaticReader::getNumDFTCoeffs() const
+{
+	return m_iNumDFTCoeffs;
+}
+
+int DAFFStaticReader::getTransformSize() const
+{
+	return m_iTransformSize;
+}
+
+int DAFFStaticReader::getAlphaPoints() const
+{
+	return m_iAlphaPoints;
+}
+
+void DAFFStaticReader::getAlphaRange(float& fAlphaStartDeg, float& fAlphaEndDeg) const
+{
+	fAlphaStartDeg = m_fAlphaStart;
+	fAlphaEndDeg = m_fAlphaEnd;
+}
+
+float DAFFStaticReader::getAlphaResolution() const
+{
+	return m_fAlphaResolution;
+}
+
+int DAFFStaticReader::getBetaPoints() const
+{
+	return m_iBetaPoints;
+}
+
+void DAFFStaticReader::getBetaRange(float& fBetaStartDeg, float& fBetaEndDeg) const
+{
+	fBetaStartDeg = m_fBetaStart;
+	fBetaEndDeg = m_fBetaEnd;
+}
+
+float DAFFStaticReader::getBetaResolution() const
+{
+	return m_fBetaResolution;
+}
+
+bool DAFFStaticReader::coversFullAlphaRange() const
+{
+	return (m_fAlphaStart == 0) && (m_fAlphaEnd == 360);
+}
+
+bool DAFFStaticReader::coversFullBetaRange() const
+{
+	return (m_fBetaStart == 0) && (m_fBetaEnd == 180);
+}
+
+void DAFFStaticReader::getDefaultOrientation(DAFFOrientationYPR& oOrientation) const
+{
+	oOrientation = m_oDefaultOrientation;
+}
+
+void DAFFStaticReader::getOrientation(DAFFOrientationYPR& oOrientation) const
+{
+	m_oTransform.getOrientation(oOrientation);
+}
+
+void DAFFStaticReader::setOrientation(const DAFFOrientationYPR& oOrientation)
+{
+	m_oTransform.setOrientation(oOrientation);
+}
+
+int DAFFStaticReader::getRecordCoords(int iRecordIndex, int iView, float& fAngle1Deg, float& fAngle2Deg) const
+{
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_iNumRecords));
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_iNumRecords))
+		return DAFF_INVALID_INDEX;
+
+	float fAlpha, fBeta;
+	if (m_fBetaStart == 0.0f) {  // South pole present (single record here)
+		if (iRecordIndex == 0) {
+			fAlpha = 0.0f;
+			fBeta = 0.0f;
+		} else {
+			fAlpha = m_fAlphaStart + (float)((iRecordIndex - 1) % m_iAlphaPoints) * m_fAlphaResolution;
+			fBeta = (float)(1 + (iRecordIndex - 1) / m_iAlphaPoints) * m_fBetaResolution;
+		}
+	} else {
+		fAlpha = m_fAlphaStart + (float)(iRecordIndex % m_iAlphaPoints) * m_fAlphaResolution;
+		fBeta = m_fBetaStart + (float)(iRecordIndex / m_iAlphaPoints) * m_fBetaResolution;
+	}
+
+	if (iView == DAFF_DATA_VIEW) {
+		fAngle1Deg = fAlpha;
+		fAngle2Deg = fBeta;
+	} else {
+		m_oTransform.transformDSC2OSC(fAlpha, fBeta, fAngle1Deg, fAngle2Deg);
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+void DAFFStaticReader::getNearestNeighbour(int iView, float fAngle1Deg, float fAngle2Deg, int& iRecordIndex) const
+{
+	bool bDummy;
+	getNearestNeighbour(iView, fAngle1Deg, fAngle2Deg, iRecordIndex, bDummy);
+}
+
+void DAFFStaticReader::getNearestNeighbour(int iView, float fAngle1Deg, float fAngle2Deg, int& iRecordIndex,
+										   bool& bOutOfBounds) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	float fAlpha = fAngle1Deg;
+	float fBeta = fAngle2Deg;
+	if (iView == DAFF_OBJECT_VIEW)
+		m_oTransform.transformOSC2DSC(fAngle1Deg, fAngle2Deg, fAlpha, fBeta);
+
+	DAFFUtils::NormalizeDirection(DAFF_DATA_VIEW, fAlpha, fBeta, fAlpha, fBeta);
+	getNearestNeighbourNormalizedDSC(fAlpha, fBeta, iRecordIndex, bOutOfBounds);
+}
+
+void DAFFStaticReader::getNearestNeighbourNormalizedDSC(float fAlpha, float fBeta, int& iRecordIndex,
+														bool& bOutOfBounds) const
+{
+	// Same rounding as DAFFReader, so that both readers select the same records
+	bOutOfBounds = false;
+
+	int iAlphaIndex, iBetaIndex;
+	if (m_iAlphaPoints == 1) {
+		iAlphaIndex = 0;
+		bOutOfBounds = !((fAlpha == m_fAlphaStart) && (fAlpha == std::fmod(m_fAlphaEnd, 360.0f)));
+	} else if ((fAlpha >= m_fAlphaStart) && (fAlpha <= m_fAlphaEnd)) {
+		iAlphaIndex = (int)roundf((fAlpha - m_fAlphaStart) / m_fAlphaResolution);
+
+		// Rounded up beyond the last point: Wrap around to the start on the full circle
+		if (iAlphaIndex >= m_iAlphaPoints)
+			iAlphaIndex = (coversFullAlphaRange() ? 0 : m_iAlphaPoints - 1);
+	} else {
+		// Outside of the alpha range: The closer boundary
+		if (DAFF::anglef_mindiff_abs_0_360_DEG(m_fAlphaStart, fAlpha) <=
+			DAFF::anglef_mindiff_abs_0_360_DEG(m_fAlphaEnd, fAlpha))
+			iAlphaIndex = 0;
+		else
+			iAlphaIndex = m_iAlphaPoints - 1;
+
+		bOutOfBounds = true;
+	}
+
+	if (m_iBetaPoints == 1) {
+		iBetaIndex = 0;
+		if (!((fBeta == m_fBetaEnd) && (fBeta == m_fBetaStart)))
+			bOutOfBounds = true;
+	} else if ((fBeta >= m_fBetaStart) && (fBeta <= m_fBetaEnd)) {
+		iBetaIndex = (int)roundf((fBeta - m_fBetaStart) / m_fBetaResolution);
+	} else {
+		// Outside of the beta range: The closer boundary
+		iBetaIndex = (std::abs(m_fBetaStart - fBeta) <= std::abs(m_fBetaEnd - fBeta)) ? 0 : m_iBetaPoints - 1;
+		bOutOfBounds = true;
+	}
+
+	iRecordIndex = getGridRecordIndex(iAlphaIndex, iBetaIndex);
+}
+
+int DAFFStaticReader::getGridRecordIndex(int iAlphaIndex, int iBetaIndex) const
+{
+	bool bNorthPole = (iBetaIndex == m_iBetaPoints - 1) && (m_fBetaEnd == 180.0f);
+
+	if (m_fBetaStart == 0.0f) {  // South pole present: increment by one (single record at poles)
+		if (iBetaIndex == 0)
+			return 0;
+
+		return 1 + (iBetaIndex - 1) * m_iAlphaPoints + (bNorthPole ? 0 : iAlphaIndex);
+	}
+
+	return iBetaIndex * m_iAlphaPoints + (bNorthPole ? 0 : iAlphaIndex);
+}
+
+void DAFFStaticReader::getCell(int iView, float fAngle1Deg, float fAngle2Deg, DAFFQuad& qIndices) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	float fAlpha = fAngle1Deg;
+	float fBeta = fAngle2Deg;
+	if (iView == DAFF_OBJECT_VIEW)
+		m_oTransform.transformOSC2DSC(fAngle1Deg, fAngle2Deg, fAlpha, fBeta);
+	DAFFUtils::NormalizeDirection(DAFF_DATA_VIEW, fAlpha, fBeta, fAlpha, fBeta);
+
+	bool bOutOfBounds;
+
+	// South pole of a full sphere: The pole record four times
+	if ((fBeta == 0.0f) && coversFullAlphaRange() && coversFullBetaRange()) {
+		getNearestNeighbourNormalizedDSC(0.0f, 0.0f, qIndices.iIndex1, bOutOfBounds);
+		qIndices.iIndex2 = qIndices.iIndex1;
+		qIndices.iIndex3 = qIndices.iIndex1;
+		qIndices.iIndex4 = qIndices.iIndex1;
+		return;
+	}
+
+	// Grid angles of the corners 1-4
+	float pfAlpha[4], pfBeta[4];
+
+	pfAlpha[0] = fAlpha - fmodf(fAlpha, m_fAlphaResolution);
+	pfAlpha[1] = pfAlpha[0];
+	pfAlpha[2] = fAlpha + m_fAlphaResolution - fmodf(fAlpha, m_fAlphaResolution);
+	pfAlpha[3] = pfAlpha[2];
+
+	pfBeta[0] = fBeta - fmodf(fBeta, m_fBetaResolution);
+	pfBeta[1] = fBeta + m_fBetaResolution - fmodf(fBeta, m_fBetaResolution);
+	pfBeta[2] = pfBeta[1];
+	pfBeta[3] = pfBeta[0];
+
+	// Upper beta angles are not allowed to overrun the north pole
+	if (pfBeta[1] > 180.0f) {
+		pfBeta[1] = 180.0f;
+		pfBeta[2] = 180.0f;
+	}
+
+	DAFF::normalize_directions_dsc(pfAlpha, pfBeta, 4);
+
+	getNearestNeighbourNormalizedDSC(pfAlpha[0], pfBeta[0], qIndices.iIndex1, bOutOfBounds);
+	getNearestNeighbourNormalizedDSC(pfAlpha[1], pfBeta[1], qIndices.iIndex2, bOutOfBounds);
+	getNearestNeighbourNormalizedDSC(pfAlpha[2], pfBeta[2], qIndices.iIndex3, bOutOfBounds);
+	getNearestNeighbourNormalizedDSC(pfAlpha[3], pfBeta[3], qIndices.iIndex4, bOutOfBounds);
+}
+
+int DAFFStaticReader::getRecordChannelData(int iRecordIndex, int iChannel, const void*& pData, int& iLeadingZeros,
+										   int& iLength) const
+{
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_iNumChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_iNumRecords) || (iChannel < 0) || (iChannel >= m_iNumChannels))
+		return DAFF_INVALID_INDEX;
+
+	const DAFFStaticRecordChannel& oChannel = m_pChannels[iRecordIndex * m_iNumChannels + iChannel];
+	pData = m_pDataBlock + oChannel.ui32DataOffset;
+	iLeadingZeros = oChannel.iLeadingZeros;
+	iLength = oChannel.iLength;
+
+	return DAFF_NO_ERROR;
+}
+
+float DAFFStaticReader::getRecordChannelScale(int iRecordIndex, int iChannel) const
+{
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_iNumChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_iNumRecords) || (iChannel < 0) || (iChannel >= m_iNumChannels))
+		return 1.0f;
+
+	return m_pChannels[iRecordIndex * m_iNumChannels + iChannel].fScale;
+}
+
+int DAFFStaticReader::getRecordChannel(int iRecordIndex, int iChannel, float* pfDest) const
+{
+	assert((iRecordIndex >= 0) && (iRecordIndex < m_iNumRecords));
+	assert((iChannel >= 0) && (iChannel < m_iNumChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= m_iNumRecords) || (iChannel < 0) || (iChannel >= m_iNumChannels))
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	// Ranges were validated on opening
+	const DAFFStaticRecordChannel& oChannel = m_pChannels[iRecordIndex * m_iNumChannels + iChannel];
+	int iOffset = oChannel.iLeadingZeros;
+	int iLength = oChannel.iLength;
+
+	// Impulse responses: Zeros around the effective part
+	for (int i = 0; i < iOffset; i++)
+		pfDest[i] = 0;
+
+	convertValues(m_pDataBlock + oChannel.ui32DataOffset, m_iQuantization, iLength, pfDest + iOffset, oChannel.fScale);
+
+	for (int i = iOffset + iLength; i < getDataLength(); i++)
+		pfDest[i] = 0;
+
+	return DAFF_NO_ERROR;
+}
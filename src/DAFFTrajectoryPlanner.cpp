@@ -0,0 +1,172 @@
+#include <DAFFTrajectoryPlanner.h>
+
+#include <DAFFContent.h>
+#include <DAFFInterpolator.h>
+#include <DAFFProperties.h>
+
+#include <algorithm>
+#include <cassert>
+
+//! Returns true if two cells consist of the same records in the same sequence
+static bool isSameCell(const DAFFQuad& a, const DAFFQuad& b)
+{
+	return (a.iIndex1 == b.iIndex1) && (a.iIndex2 == b.iIndex2) && (a.iIndex3 == b.iIndex3) &&
+		   (a.iIndex4 == b.iIndex4);
+}
+
+DAFFTrajectoryPlanner::DAFFTrajectoryPlanner(const DAFFContent* pContent) : m_pContent(pContent), m_iNumFrames(0)
+{
+	assert(pContent != NULL);
+}
+
+DAFFTrajectoryPlanner::~DAFFTrajectoryPlanner() {}
+
+const DAFFContent* DAFFTrajectoryPlanner::getContent() const
+{
+	return m_pContent;
+}
+
+int DAFFTrajectoryPlanner::plan(int iView, const double* pdTimes, const float* pfAngles1Deg,
+								const float* pfAngles2Deg, size_t n, bool bCells)
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	clear();
+
+	if ((iView != DAFF_DATA_VIEW) && (iView != DAFF_OBJECT_VIEW))
+		return DAFF_MODAL_ERROR;
+
+	// The records of irregular grids do not form cells
+	if (bCells && !m_pContent->getProperties()->isRegularGrid())
+		return DAFF_MODAL_ERROR;
+
+	for (size_t i = 1; i < n; i++)
+		if (pdTimes[i] < pdTimes[i - 1])
+			return DAFF_MODAL_ERROR;
+
+	if (n == 0)
+		return DAFF_NO_ERROR;
+
+	// Temporal coherence: consecutive frames with the same direction are resolved once
+	std::vector<float> vfAngles1, vfAngles2;
+	std::vector<int> viDirections(n);
+	for (size_t i = 0; i < n; i++) {
+		if ((i == 0) || (pfAngles1Deg[i] != pfAngles1Deg[i - 1]) || (pfAngles2Deg[i] != pfAngles2Deg[i - 1])) {
+			vfAngles1.push_back(pfAngles1Deg[i]);
+			vfAngles2.push_back(pfAngles2Deg[i]);
+		}
+		viDirections[i] = (int)vfAngles1.size() - 1;
+	}
+
+	size_t m = vfAngles1.size();
+	std::vector<int> viNearest(m);
+	m_pContent->getNearestNeighbours(iView, &vfAngles1[0], &vfAngles2[0], &viNearest[0], NULL, m);
+
+	std::vector<DAFFQuad> vqCells;
+	std::vector<float> vfCellWeights;
+	if (bCells) {
+		DAFFInterpolator oInterpolator(m_pContent);
+		vqCells.resize(m);
+		vfCellWeights.resize(4 * m);
+		for (size_t j = 0; j < m; j++) {
+			int iError = oInterpolator.getWeights(iView, vfAngles1[j], vfAngles2[j], vqCells[j], &vfCellWeights[4 * j]);
+			if (iError != DAFF_NO_ERROR)
+				return iError;
+		}
+	}
+
+	// Run-length encoding, a run starts at every switch of the record or cell
+	for (size_t i = 0; i < n; i++) {
+		int j = viDirections[i];
+		if (m_vRecordRuns.empty() || (m_vRecordRuns.back().iRecordIndex != viNearest[j])) {
+			DAFFTrajectoryRecordRun oRun;
+			oRun.dStartTime = pdTimes[i];
+			oRun.iFirstFrame = (int)i;
+			oRun.iNumFrames = 0;
+			oRun.iRecordIndex = viNearest[j];
+			m_vRecordRuns.push_back(oRun);
+		}
+		m_vRecordRuns.back().iNumFrames++;
+
+		if (!bCells)
+			continue;
+
+		if (m_vCellRuns.empty() || !isSameCell(m_vCellRuns.back().qIndices, vqCells[j])) {
+			DAFFTrajectoryCellRun oRun;
+			oRun.dStartTime = pdTimes[i];
+			oRun.iFirstFrame = (int)i;
+			oRun.iNumFrames = 0;
+			oRun.qIndices = vqCells[j];
+			m_vCellRuns.push_back(oRun);
+		}
+		m_vCellRuns.back().iNumFrames++;
+	}
+
+	if (bCells) {
+		m_vfWeights.resize(4 * n);
+		for (size_t i = 0; i < n; i++) {
+			const float* pfCellWeights = &vfCellWeights[4 * (size_t)viDirections[i]];
+			std::copy(pfCellWeights, pfCellWeights + 4, &m_vfWeights[4 * i]);
+		}
+	}
+
+	// Records to prefetch
+	for (size_t i = 0; i < m_vRecordRuns.size(); i++)
+		m_viRequiredRecords.push_back(m_vRecordRuns[i].iRecordIndex);
+	for (size_t i = 0; i < m_vCellRuns.size(); i++) {
+		const DAFFQuad& q = m_vCellRuns[i].qIndices;
+		m_viRequiredRecords.push_back(q.iIndex1);
+		m_viRequiredRecords.push_back(q.iIndex2);
+		m_viRequiredRecords.push_back(q.iIndex3);
+		m_viRequiredRecords.push_back(q.iIndex4);
+	}
+	std::sort(m_viRequiredRecords.begin(), m_viRequiredRecords.end());
+	m_viRequiredRecords.erase(std::unique(m_viRequiredRecords.begin(), m_viRequiredRecords.end()),
+							  m_viRequiredRecords.end());
+
+	m_iNumFrames = (int)n;
+
+	return DAFF_NO_ERROR;
+}
+
+void DAFFTrajectoryPlanner::clear()
+{
+	m_iNumFrames = 0;
+	m_vRecordRuns.clear();
+	m_vCellRuns.clear();
+	m_vfWeights.clear();
+	m_viRequiredRecords.clear();
+}
+
+int DAFFTrajectoryPlanner::getNumFrames() const
+{
+	return m_iNumFrames;
+}
+
+bool DAFFTrajectoryPlanner::hasCells() const
+{
+	return !m_vfWeights.empty();
+}
+
+const std::vector<DAFFTrajectoryRecordRun>& DAFFTrajectoryPlanner::getRecordRuns() const
+{
+	return m_vRecordRuns;
+}
+
+const std::vector<DAFFTrajectoryCellRun>& DAFFTrajectoryPlanner::getCellRuns() const
+{
+	return m_vCellRuns;
+}
+
+const float* DAFFTrajectoryPlanner::getWeights(int iFrame) const
+{
+	if (m_vfWeights.empty() || (iFrame < 0) || (iFrame >= m_iNumFrames))
+		return NULL;
+
+	return &m_vfWeights[4 * (size_t)iFrame];
+}
+
+const std::vector<int>& DAFFTrajectoryPlanner::getRequiredRecords() const
+{
+	return m_viRequiredRecords;
+}
@@ -0,0 +1,901 @@
+#include <DAFFTransformerDFT2IR.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <system_error>
+#include <thread>
+
+#include "DAFFFFTPlanCache.h"
+#include "DAFFInstrumentationImpl.h"
+#include "DAFFPropertiesImpl.h"
+#include "DAFFRecordCache.h"
+#include "Utils.h"
+
+//! Number of output samples of a batch of inverse transforms (fits into the L2 cache)
+static const int DAFF_DFT2IR_BATCH_SAMPLES = 1 << 14;
+
+//! Bounds and peak of an impulse response in the cache of the lazy transformation (in front of the coefficients)
+struct DAFFDFT2IRCacheHeader {
+	int iOffset;    //!@ Effective filter offset
+	int iLength;    //!@ Effective filter length
+	float fPeak;    //!@ Peak of the impulse response
+	int iReserved;  //!@ Keeps the coefficients 16-byte aligned
+};
+
+// Inner content interface realization
+class DAFFContentIRInverseRealization : public DAFFContentIR {
+  public:
+	inline DAFFContentIRInverseRealization(DAFFTransformerDFT2IR* pParent, const DAFFContentDFT* pInputContent)
+		: m_pParent(pParent), m_pInputContent(pInputContent)
+	{
+		m_oProps = *(pInputContent->getProperties());
+		m_oProps.m_iContentType = DAFF_IMPULSE_RESPONSE;
+		m_oProps.m_iQuantization = DAFF_FLOAT32;
+	};
+
+	inline virtual ~DAFFContentIRInverseRealization() {};
+
+	// --= Interface "DAFFContentIR" =--
+
+	inline double getSamplerate() const { return m_pInputContent->getSamplerate(); };
+
+	inline int getFilterLength() const { return m_pParent->m_iLength; };
+
+	inline int getFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFilterCoeffs(iRecordIndex, iChannel, pfDest, fGain, false);
+	};
+
+	inline int getFilterCoeff(int iRecordIndex, int iChannel, int iSample, float& fCoeff) const
+	{
+		return m_pParent->getFilterCoeff(iRecordIndex, iChannel, iSample, fCoeff);
+	};
+
+	inline int addFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFilterCoeffs(iRecordIndex, iChannel, pfDest, fGain, true);
+	};
+
+	inline int getFilterCoeffsQ15(int iRecordIndex, int iChannel, int16_t* piDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFixedPointFilterCoeffs(iRecordIndex, iChannel, piDest, NULL, fGain, false);
+	};
+
+	inline int getFilterCoeffsQ31(int iRecordIndex, int iChannel, int32_t* piDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFixedPointFilterCoeffs(iRecordIndex, iChannel, NULL, piDest, fGain, false);
+	};
+
+	inline int addFilterCoeffsQ15(int iRecordIndex, int iChannel, int16_t* piDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFixedPointFilterCoeffs(iRecordIndex, iChannel, piDest, NULL, fGain, true);
+	};
+
+	inline int addFilterCoeffsQ31(int iRecordIndex, int iChannel, int32_t* piDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFixedPointFilterCoeffs(iRecordIndex, iChannel, NULL, piDest, fGain, true);
+	};
+
+	inline int getRecord(int iRecordIndex, float** ppfChannelDest) const
+	{
+		return m_pParent->getRecord(iRecordIndex, ppfChannelDest);
+	};
+
+	inline int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const
+	{
+		return m_pParent->getRecordInterleaved(iRecordIndex, pfDest, iStride);
+	};
+
+	// The effective bounds are determined on the impulse responses
+
+	inline int getMinEffectiveFilterOffset() const { return m_pParent->getMinEffectiveFilterOffset(); };
+
+	inline int getMaxEffectiveFilterLength() const { return m_pParent->getMaxEffectiveFilterLength(); };
+
+	inline int getEffectiveFilterBounds(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const
+	{
+		return m_pParent->getEffectiveFilterBounds(iRecordIndex, iChannel, iOffset, iLength);
+	};
+
+	inline int getEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getEffectiveFilterCoeffs(iRecordIndex, iChannel, pfDest, fGain, false);
+	};
+
+	inline int getFilterCoeffsTruncated(int iRecordIndex, int iChannel, float* pfDest, int& iLength,
+										float fGain = 1.0F) const
+	{
+		return m_pParent->getFilterCoeffsTruncated(iRecordIndex, iChannel, pfDest, iLength, fGain);
+	};
+
+	inline int getMaxTruncatedFilterLength() const { return m_pParent->getMaxTruncatedFilterLength(); };
+
+	inline int addEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getEffectiveFilterCoeffs(iRecordIndex, iChannel, pfDest, fGain, true);
+	};
+
+	inline const float* getEffectiveFilterCoeffsPtr(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const
+	{
+		return m_pParent->getEffectiveFilterCoeffsPtr(iRecordIndex, iChannel, iOffset, iLength);
+	};
+
+	inline int getFilterEnvelope(int iRecordIndex, int iChannel, int iFirstSample, int iNumSamples, int iNumBins,
+								 float* pfMin, float* pfMax) const
+	{
+		return m_pParent->getFilterEnvelope(iRecordIndex, iChannel, iFirstSample, iNumSamples, iNumBins, pfMin, pfMax);
+	};
+
+	inline float getOverallPeak() const { return m_pParent->getOverallPeak(); };
+
+	inline float getChannelPeak(int iChannel) const { return m_pParent->getChannelPeak(iChannel); };
+
+	inline float getRecordPeak(int iRecordIndex, int iChannel) const
+	{
+		return m_pParent->getRecordPeak(iRecordIndex, iChannel);
+	};
+
+	inline int getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const
+	{
+		return m_pParent->getRecordStatistics(iRecordIndex, iChannel, oStats);
+	};
+
+	// --= Interface "DAFFContent" =--
+
+	// This interface is completely delegated to the input content of the transform
+
+	inline DAFFReader* getParent() const { return m_pInputContent->getParent(); };
+
+	inline const DAFFPropertiesImpl* getProperties() const { return &m_oProps; };
+
+	inline const DAFFMetadata* getRecordMetadata(int iRecordIndex) const
+	{
+		return m_pInputContent->getRecordMetadata(iRecordIndex);
+	};
+
+	inline int getRecordCoords(int iRecordIndex, int iView, float& fAngle1, float& fAngle2) const
+	{
+		return m_pInputContent->getRecordCoords(iRecordIndex, iView, fAngle1, fAngle2);
+	};
+
+	inline void getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex) const
+	{
+		m_pInputContent->getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex);
+	};
+
+	inline void getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex,
+									bool& bOutOfBounds) const
+	{
+		m_pInputContent->getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex, bOutOfBounds);
+	};
+
+	inline void getNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int* piRecordIndices,
+									 bool* pbOutOfBounds, size_t n) const
+	{
+		m_pInputContent->getNearestNeighbours(iView, pfAngles1, pfAngles2, piRecordIndices, pbOutOfBounds, n);
+	};
+
+	inline int getKNearestNeighbours(int iView, float fAngle1, float fAngle2, int k, int* piRecordIndices,
+									 float* pfDistances) const
+	{
+		return m_pInputContent->getKNearestNeighbours(iView, fAngle1, fAngle2, k, piRecordIndices, pfDistances);
+	};
+
+	inline int getKNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int k,
+									 int* piRecordIndices, float* pfDistances, size_t n) const
+	{
+		return m_pInputContent->getKNearestNeighbours(iView, pfAngles1, pfAngles2, k, piRecordIndices, pfDistances,
+													  n);
+	};
+
+	inline int getRecordsInCone(int iView, float fAngle1, float fAngle2, float fRadius,
+								std::vector<int>& viRecordIndices) const
+	{
+		return m_pInputContent->getRecordsInCone(iView, fAngle1, fAngle2, fRadius, viRecordIndices);
+	};
+
+	inline int getRecordsInCone(int iView, const float* pfAngles1, const float* pfAngles2, float fRadius,
+								std::vector<int>& viRecordIndices, std::vector<int>& viOffsets, size_t n) const
+	{
+		return m_pInputContent->getRecordsInCone(iView, pfAngles1, pfAngles2, fRadius, viRecordIndices, viOffsets,
+												 n);
+	};
+
+	inline void getCell(int iView, float fAngle1, float fAngle2, DAFFQuad& qIndices) const
+	{
+		m_pInputContent->getCell(iView, fAngle1, fAngle2, qIndices);
+	};
+
+	inline void transformAnglesD2O(float fAlpha, float fBeta, float& fAzimuth, float& fElevation) const
+	{
+		m_pInputContent->transformAnglesD2O(fAlpha, fBeta, fAzimuth, fElevation);
+	};
+
+	inline void transformAnglesO2D(float fAzimuth, float fElevation, float& fAlpha, float& fBeta) const
+	{
+		m_pInputContent->transformAnglesO2D(fAzimuth, fElevation, fAlpha, fBeta);
+	};
+
+  private:
+	DAFFTransformerDFT2IR* m_pParent;
+	const DAFFContentDFT* m_pInputContent;
+	DAFFPropertiesImpl m_oProps;
+};
+
+//! Fetches the symmetric half of the spectrum of a record channel (iSize/2+1 interleaved coefficients)
+/**
+ * Full spectra of non-symmetric contents are reduced to their conjugate-symmetric part
+ * X'[k] = (X[k] + conj(X[N-k])) / 2, whose inverse transform is the real part of the inverse
+ * transform of X. Missing spectra are zero.
+ *
+ * \param pfDest	Destination (iNumFloats floats, at least 2 * number of DFT coefficients)
+ */
+static void loadSpectrum(const DAFFContentDFT* pInputContent, int iRecord, int iChannel, float* pfDest,
+						 int iNumFloats)
+{
+	if (pInputContent->getDFTCoeffs(iRecord, iChannel, pfDest) != DAFF_NO_ERROR) {
+		memset(pfDest, 0, iNumFloats * sizeof(float));
+		return;
+	}
+
+	if (pInputContent->isSymmetric())
+		return;
+
+	// The coefficients N-k read for k < N/2 lie above N/2 and are not overwritten yet
+	int iSize = pInputContent->getTransformSize();
+	for (int k = 0; k <= iSize / 2; k++) {
+		int j = (k == 0 ? 0 : iSize - k);
+		float fReal = 0.5f * (pfDest[2 * k + 0] + pfDest[2 * j + 0]);
+		float fImag = 0.5f * (pfDest[2 * k + 1] - pfDest[2 * j + 1]);
+		pfDest[2 * k + 0] = fReal;
+		pfDest[2 * k + 1] = fImag;
+	}
+}
+
+//! Normalizes an inverse transform and zeroes the samples outside its effective bounds
+/**
+ * \param fThreshold	Threshold of the effective bounds relative to the peak
+ *
+ * @return Peak of the impulse response
+ */
+static float finishFilter(float* pfData, int iSize, float fThreshold, int& iOffset, int& iLength)
+{
+	float fScale = 1.0f / iSize;
+	for (int i = 0; i < iSize; i++)
+		pfData[i] *= fScale;
+
+	size_t nBegin, nEnd;
+	float fPeak = DAFF::peak_float(pfData, iSize);
+	DAFF::bounds_float(pfData, iSize, fPeak * fThreshold, nBegin, nEnd);
+	memset(pfData, 0, nBegin * sizeof(float));
+	memset(pfData + nEnd, 0, (iSize - nEnd) * sizeof(float));
+
+	iOffset = (int)nBegin;
+	iLength = (int)(nEnd - nBegin);
+	return fPeak;
+}
+
+DAFFTransformerDFT2IR::DAFFTransformerDFT2IR()
+	: m_pInputContent(NULL), m_pOutputContent(NULL), m_fBoundsThreshold(-120), m_iNumThreads(0), m_bLazy(false),
+	  m_pCache(new DAFFRecordCache), m_iLength(0), m_iStride(0), m_iSpectrumSize(0), m_pfBuf(NULL),
+	  m_pfScratch(NULL), m_fOverallPeak(0), m_iMinEffectiveOffset(0), m_iMaxEffectiveLength(0),
+	  m_iMaxTruncatedLength(0), m_bBoundsKnown(false)
+{
+}
+
+DAFFTransformerDFT2IR::DAFFTransformerDFT2IR(const DAFFContentDFT* pInputContent, bool bTransform)
+	: m_pInputContent(NULL), m_pOutputContent(NULL), m_fBoundsThreshold(-120), m_iNumThreads(0), m_bLazy(false),
+	  m_pCache(new DAFFRecordCache), m_iLength(0), m_iStride(0), m_iSpectrumSize(0), m_pfBuf(NULL),
+	  m_pfScratch(NULL), m_fOverallPeak(0), m_iMinEffectiveOffset(0), m_iMaxEffectiveLength(0),
+	  m_iMaxTruncatedLength(0), m_bBoundsKnown(false)
+{
+	setInputContent(pInputContent, bTransform);
+}
+
+DAFFTransformerDFT2IR::~DAFFTransformerDFT2IR()
+{
+	clear();
+	delete m_pCache;
+}
+
+const DAFFContentDFT* DAFFTransformerDFT2IR::getInputContent() const
+{
+	return m_pInputContent;
+}
+
+void DAFFTransformerDFT2IR::setInputContent(const DAFFContentDFT* pInputContent, bool bTransform)
+{
+	m_pInputContent = pInputContent;
+	if (bTransform)
+		transform();
+}
+
+DAFFContentIR* DAFFTransformerDFT2IR::getOutputContent() const
+{
+	return m_pOutputContent;
+}
+
+float DAFFTransformerDFT2IR::getBoundsThreshold() const
+{
+	return m_fBoundsThreshold;
+}
+
+void DAFFTransformerDFT2IR::setBoundsThreshold(float fThresholdDB, bool bTransform)
+{
+	assert(fThresholdDB <= 0);
+	m_fBoundsThreshold = std::min(fThresholdDB, 0.0f);
+	if (bTransform)
+		transform();
+}
+
+int DAFFTransformerDFT2IR::getNumThreads() const
+{
+	return m_iNumThreads;
+}
+
+void DAFFTransformerDFT2IR::setNumThreads(int iNumThreads)
+{
+	m_iNumThreads = (iNumThreads > 0 ? iNumThreads : 0);
+}
+
+bool DAFFTransformerDFT2IR::isLazy() const
+{
+	return m_bLazy;
+}
+
+void DAFFTransformerDFT2IR::setLazy(bool bLazy, bool bTransform)
+{
+	m_bLazy = bLazy;
+	if (bTransform)
+		transform();
+}
+
+size_t DAFFTransformerDFT2IR::getLazyCacheSize() const
+{
+	std::lock_guard<std::mutex> lock(m_mxCache);
+	return m_pCache->getMaxSize();
+}
+
+void DAFFTransformerDFT2IR::setLazyCacheSize(size_t nMaxBytes)
+{
+	std::lock_guard<std::mutex> lock(m_mxCache);
+	m_pCache->setMaxSize(nMaxBytes);
+}
+
+size_t DAFFTransformerDFT2IR::getMemoryFootprint() const
+{
+	size_t nBytes = (m_viOffsets.capacity() + m_viLengths.capacity()) * sizeof(int) +
+					(m_vfPeaks.capacity() + m_vfChannelPeaks.capacity()) * sizeof(float);
+	if (m_pInputContent && m_pfBuf)
+		nBytes += (size_t)m_pInputContent->getProperties()->getNumberOfRecords() *
+				  m_pInputContent->getProperties()->getNumberOfChannels() * m_iStride * sizeof(float);
+	if (m_pfScratch)
+		nBytes += m_iSpectrumSize * sizeof(float);
+
+	std::lock_guard<std::mutex> lock(m_mxCache);
+	return nBytes + m_pCache->getSize();
+}
+
+void DAFFTransformerDFT2IR::clear()
+{
+	delete m_pOutputContent;
+	m_pOutputContent = NULL;
+
+	DAFF::free_aligned16(m_pfBuf);
+	m_pfBuf = NULL;
+
+	DAFF::free_aligned16(m_pfScratch);
+	m_pfScratch = NULL;
+
+	m_pCache->clear();
+	m_viOffsets.clear();
+	m_viLengths.clear();
+	m_vfPeaks.clear();
+	m_vfChannelPeaks.clear();
+	m_iMinEffectiveOffset = m_iMaxEffectiveLength = m_iMaxTruncatedLength = 0;
+	m_fOverallPeak = 0;
+	m_bBoundsKnown = false;
+	m_iLength = 0;
+}
+
+void DAFFTransformerDFT2IR::transform()
+{
+	// Discard previous impulse responses
+	clear();
+
+	if (!m_pInputContent)
+		return;
+
+	int iSize = m_pInputContent->getTransformSize();
+	if (iSize <= 0)
+		return;
+
+	// Filters and spectra are 16-byte aligned
+	m_iLength = iSize;
+	m_iStride = (iSize + 3) / 4 * 4;
+	m_iSpectrumSize = (2 * std::max(m_pInputContent->getNumDFTCoeffs(), iSize / 2 + 1) + 3) / 4 * 4;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int iNumRecordChannels = iRecords * iChannels;
+
+	// Lazy: impulse responses are transformed on first access
+	if (m_bLazy) {
+		m_pfScratch = static_cast<float*>(DAFF::malloc_aligned16(m_iSpectrumSize * sizeof(float)));
+		m_pOutputContent = new DAFFContentIRInverseRealization(this, m_pInputContent);
+		return;
+	}
+
+	m_pfBuf = static_cast<float*>(DAFF::malloc_aligned16((size_t)iNumRecordChannels * m_iStride * sizeof(float)));
+	if (!m_pfBuf) {
+		clear();
+		return;
+	}
+
+	m_viOffsets.resize(iNumRecordChannels);
+	m_viLengths.resize(iNumRecordChannels);
+	m_vfPeaks.resize(iNumRecordChannels);
+	m_pOutputContent = new DAFFContentIRInverseRealization(this, m_pInputContent);
+
+	// Distribute the record channels over several threads, each transforming a range
+	int iNumThreads = m_iNumThreads;
+	if (iNumThreads <= 0) {
+		const uint64_t ui64MinSamplesPerThread = 1 << 16;
+		uint64_t ui64NumSamples = (uint64_t)iNumRecordChannels * iSize;
+		uint64_t ui64MaxThreads = std::max(ui64NumSamples / ui64MinSamplesPerThread, (uint64_t)1);
+		iNumThreads = (int)std::min((uint64_t)std::max(std::thread::hardware_concurrency(), 1u), ui64MaxThreads);
+	}
+
+	std::vector<std::thread> vThreads;
+	int iChunk = (iNumRecordChannels + iNumThreads - 1) / iNumThreads;
+	for (int iBegin = iChunk; iBegin < iNumRecordChannels; iBegin += iChunk) {
+		int iEnd = std::min(iBegin + iChunk, iNumRecordChannels);
+		try {
+			vThreads.push_back(std::thread(&DAFFTransformerDFT2IR::transformRange, this, iBegin, iEnd));
+		} catch (const std::system_error&) {
+			transformRange(iBegin, iEnd);  // No more threads available
+		}
+	}
+
+	transformRange(0, std::min(iChunk, iNumRecordChannels));
+
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	initBounds();
+}
+
+void DAFFTransformerDFT2IR::transformRange(int iBegin, int iEnd)
+{
+	if (iBegin >= iEnd)
+		return;
+
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	float fThreshold = std::pow(10.0f, m_fBoundsThreshold / 20);
+
+	// Batches of spectra are transformed at once into consecutive filters of the buffer
+	int iBatch = std::min(iEnd - iBegin, std::max(DAFF_DFT2IR_BATCH_SAMPLES / m_iLength, 1));
+	float* pfSpectra = static_cast<float*>(DAFF::malloc_aligned16((size_t)iBatch * m_iSpectrumSize * sizeof(float)));
+
+	DAFFFFTPlanState oState;
+	for (int n = iBegin; n < iEnd; n += iBatch) {
+		int iCount = std::min(iBatch, iEnd - n);
+		for (int j = 0; j < iCount; j++)
+			loadSpectrum(m_pInputContent, (n + j) / iChannels, (n + j) % iChannels,
+						 pfSpectra + (size_t)j * m_iSpectrumSize, m_iSpectrumSize);
+
+		float* pfDest = m_pfBuf + (size_t)n * m_iStride;
+		DAFFFFTPlanCache::executeInverseBatch(m_iLength, iCount, pfSpectra, m_iSpectrumSize, pfDest, m_iStride, oState);
+
+		for (int j = 0; j < iCount; j++)
+			m_vfPeaks[n + j] = finishFilter(pfDest + (size_t)j * m_iStride, m_iLength, fThreshold, m_viOffsets[n + j],
+											m_viLengths[n + j]);
+	}
+
+	DAFF::free_aligned16(pfSpectra);
+}
+
+float DAFFTransformerDFT2IR::transformFilter(int iRecordIndex, int iChannel, float* pfSpectrum, float* pfDest,
+											 int& iOffset, int& iLength, DAFFFFTPlanState& oState) const
+{
+	loadSpectrum(m_pInputContent, iRecordIndex, iChannel, pfSpectrum, m_iSpectrumSize);
+	DAFFFFTPlanCache::executeInverse(m_iLength, pfSpectrum, pfDest, oState);
+	return finishFilter(pfDest, m_iLength, std::pow(10.0f, m_fBoundsThreshold / 20), iOffset, iLength);
+}
+
+void DAFFTransformerDFT2IR::initBounds() const
+{
+	if (m_bBoundsKnown || !m_pOutputContent)
+		return;
+
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int iNumRecordChannels = m_pInputContent->getProperties()->getNumberOfRecords() * iChannels;
+
+	// Lazy: all impulse responses have to be transformed once (without caching them)
+	float* pfFilter = NULL;
+	if (m_bLazy)
+		pfFilter = static_cast<float*>(DAFF::malloc_aligned16(m_iStride * sizeof(float)));
+
+	m_vfChannelPeaks.assign(iChannels, 0.0f);
+	m_fOverallPeak = 0;
+	m_iMinEffectiveOffset = m_iLength;
+	m_iMaxEffectiveLength = 0;
+	m_iMaxTruncatedLength = 0;
+
+	DAFFFFTPlanState oState;
+	for (int n = 0; n < iNumRecordChannels; n++) {
+		int iOffset, iLength;
+		float fPeak;
+		if (m_bLazy) {
+			fPeak = transformFilter(n / iChannels, n % iChannels, m_pfScratch, pfFilter, iOffset, iLength, oState);
+		} else {
+			iOffset = m_viOffsets[n];
+			iLength = m_viLengths[n];
+			fPeak = m_vfPeaks[n];
+		}
+
+		if (iLength > 0)
+			m_iMinEffectiveOffset = std::min(m_iMinEffectiveOffset, iOffset);
+		m_iMaxEffectiveLength = std::max(m_iMaxEffectiveLength, iLength);
+		m_iMaxTruncatedLength = std::max(m_iMaxTruncatedLength, iOffset + iLength);
+
+		m_vfChannelPeaks[n % iChannels] = std::max(m_vfChannelPeaks[n % iChannels], fPeak);
+		m_fOverallPeak = std::max(m_fOverallPeak, fPeak);
+	}
+	if (m_iMaxEffectiveLength == 0)
+		m_iMinEffectiveOffset = 0;  // All filters zero
+
+	DAFF::free_aligned16(pfFilter);
+	m_bBoundsKnown = true;
+}
+
+std::unique_lock<std::mutex> DAFFTransformerDFT2IR::lockCache() const
+{
+	if (m_bLazy)
+		return std::unique_lock<std::mutex>(m_mxCache);
+	return std::unique_lock<std::mutex>();
+}
+
+const float* DAFFTransformerDFT2IR::getFilterPtr(int iRecordIndex, int iChannel, int& iOffset, int& iLength,
+												 float& fPeak) const
+{
+	if (!m_pOutputContent)
+		return NULL;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords) || (iChannel < 0) || (iChannel >= iChannels))
+		return NULL;
+
+	int64_t iKey = (int64_t)iRecordIndex * iChannels + iChannel;
+	if (!m_bLazy) {
+		iOffset = m_viOffsets[iKey];
+		iLength = m_viLengths[iKey];
+		fPeak = m_vfPeaks[iKey];
+		return m_pfBuf + iKey * m_iStride;
+	}
+
+	DAFFDFT2IRCacheHeader* pHeader = static_cast<DAFFDFT2IRCacheHeader*>(m_pCache->find(iKey));
+	DAFF_INSTRUMENT_COUNT(pHeader ? DAFF_COUNTER_TRANSFORMER_CACHE_HITS : DAFF_COUNTER_TRANSFORMER_CACHE_MISSES, 1);
+	if (!pHeader) {
+		size_t nBytes = sizeof(DAFFDFT2IRCacheHeader) + m_iLength * sizeof(float);
+		pHeader = static_cast<DAFFDFT2IRCacheHeader*>(m_pCache->insert(iKey, nBytes));
+		if (pHeader == NULL)
+			return NULL;
+
+		DAFFFFTPlanState oState;
+		pHeader->fPeak = transformFilter(iRecordIndex, iChannel, m_pfScratch, reinterpret_cast<float*>(pHeader + 1),
+										 pHeader->iOffset, pHeader->iLength, oState);
+	}
+
+	iOffset = pHeader->iOffset;
+	iLength = pHeader->iLength;
+	fPeak = pHeader->fPeak;
+	return reinterpret_cast<const float*>(pHeader + 1);
+}
+
+int DAFFTransformerDFT2IR::getMinEffectiveFilterOffset() const
+{
+	std::unique_lock<std::mutex> lock = lockCache();
+	initBounds();
+	return m_iMinEffectiveOffset;
+}
+
+int DAFFTransformerDFT2IR::getMaxEffectiveFilterLength() const
+{
+	std::unique_lock<std::mutex> lock = lockCache();
+	initBounds();
+	return m_iMaxEffectiveLength;
+}
+
+int DAFFTransformerDFT2IR::getMaxTruncatedFilterLength() const
+{
+	std::unique_lock<std::mutex> lock = lockCache();
+	initBounds();
+	return m_iMaxTruncatedLength;
+}
+
+int DAFFTransformerDFT2IR::getFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain,
+										   bool bAdd) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iOffset, iLength;
+	float fPeak;
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel, iOffset, iLength, fPeak);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	// Only the effective part is non-zero
+	if (bAdd) {
+		for (int i = iOffset; i < iOffset + iLength; i++)
+			pfDest[i] += pfData[i] * fGain;
+	} else {
+		for (int i = 0; i < m_iLength; i++)
+			pfDest[i] = pfData[i] * fGain;
+	}
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerDFT2IR::getFilterCoeff(int iRecordIndex, int iChannel, int iSample, float& fCoeff) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iOffset, iLength;
+	float fPeak;
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel, iOffset, iLength, fPeak);
+	assert(pfData != NULL);
+	if (!pfData || (iSample < 0) || (iSample >= m_iLength))
+		return DAFF_INVALID_INDEX;
+
+	fCoeff = pfData[iSample];
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerDFT2IR::getFixedPointFilterCoeffs(int iRecordIndex, int iChannel, int16_t* piDestQ15,
+													 int32_t* piDestQ31, float fGain, bool bAdd) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iOffset, iLength;
+	float fPeak;
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel, iOffset, iLength, fPeak);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	if ((piDestQ15 == NULL) && (piDestQ31 == NULL))
+		return DAFF_NO_ERROR;
+
+	// Only the effective part is non-zero
+	int iBegin = (bAdd ? iOffset : 0);
+	int iCount = (bAdd ? iLength : m_iLength);
+	DAFF::stc_float_to_fixed_point((piDestQ15 ? piDestQ15 + iBegin : NULL), (piDestQ31 ? piDestQ31 + iBegin : NULL),
+								   pfData + iBegin, iCount, fGain, bAdd);
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerDFT2IR::getFilterCoeffsTruncated(int iRecordIndex, int iChannel, float* pfDest, int& iLength,
+													float fGain) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iOffset, iEffectiveLength;
+	float fPeak;
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel, iOffset, iEffectiveLength, fPeak);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	iLength = iOffset + iEffectiveLength;
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	for (int i = 0; i < iLength; i++)
+		pfDest[i] = pfData[i] * fGain;
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerDFT2IR::getEffectiveFilterBounds(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	float fPeak;
+	std::unique_lock<std::mutex> lock = lockCache();
+	if (!getFilterPtr(iRecordIndex, iChannel, iOffset, iLength, fPeak))
+		return DAFF_INVALID_INDEX;
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerDFT2IR::getEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain,
+													bool bAdd) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iOffset, iLength;
+	float fPeak;
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel, iOffset, iLength, fPeak);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	pfData += iOffset;
+	if (bAdd) {
+		for (int i = 0; i < iLength; i++)
+			pfDest[i] += pfData[i] * fGain;
+	} else {
+		for (int i = 0; i < iLength; i++)
+			pfDest[i] = pfData[i] * fGain;
+	}
+	return DAFF_NO_ERROR;
+}
+
+const float* DAFFTransformerDFT2IR::getEffectiveFilterCoeffsPtr(int iRecordIndex, int iChannel, int& iOffset,
+																int& iLength) const
+{
+	float fPeak;
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel, iOffset, iLength, fPeak);
+	return (pfData ? pfData + iOffset : NULL);
+}
+
+int DAFFTransformerDFT2IR::getFilterEnvelope(int iRecordIndex, int iChannel, int iFirstSample, int iNumSamples,
+											 int iNumBins, float* pfMin, float* pfMax) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iOffset, iLength;
+	float fPeak;
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel, iOffset, iLength, fPeak);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	if ((iFirstSample < 0) || (iNumBins < 1) || (iNumBins > iNumSamples) || (iNumSamples > m_iLength - iFirstSample))
+		return DAFF_INVALID_INDEX;
+
+	for (int k = 0; k < iNumBins; k++) {
+		int iBegin = iFirstSample + (int)((int64_t)k * iNumSamples / iNumBins);
+		int iEnd = iFirstSample + (int)((int64_t)(k + 1) * iNumSamples / iNumBins);
+		pfMin[k] = pfMax[k] = pfData[iBegin];
+		DAFF::minmax_float(pfData + iBegin, iEnd - iBegin, pfMin[k], pfMax[k]);
+	}
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerDFT2IR::getRecord(int iRecordIndex, float** ppfChannelDest) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return DAFF_INVALID_INDEX;
+
+	assert(ppfChannelDest != 0);
+	std::unique_lock<std::mutex> lock = lockCache();
+	for (int c = 0; c < iChannels; c++) {
+		if (!ppfChannelDest[c])
+			continue;
+
+		int iOffset, iLength;
+		float fPeak;
+		const float* pfData = getFilterPtr(iRecordIndex, c, iOffset, iLength, fPeak);
+		if (!pfData)
+			return DAFF_MODAL_ERROR;
+
+		memcpy(ppfChannelDest[c], pfData, m_iLength * sizeof(float));
+	}
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerDFT2IR::getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert(iStride >= iChannels);
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return DAFF_INVALID_INDEX;
+	if (iStride < iChannels)
+		return DAFF_MODAL_ERROR;
+
+	assert(pfDest != 0);
+	std::unique_lock<std::mutex> lock = lockCache();
+	for (int c = 0; c < iChannels; c++) {
+		int iOffset, iLength;
+		float fPeak;
+		const float* pfData = getFilterPtr(iRecordIndex, c, iOffset, iLength, fPeak);
+		if (!pfData)
+			return DAFF_MODAL_ERROR;
+
+		for (int i = 0; i < m_iLength; i++)
+			pfDest[i * iStride + c] = pfData[i];
+	}
+	return DAFF_NO_ERROR;
+}
+
+float DAFFTransformerDFT2IR::getOverallPeak() const
+{
+	std::unique_lock<std::mutex> lock = lockCache();
+	initBounds();
+	return m_fOverallPeak;
+}
+
+float DAFFTransformerDFT2IR::getChannelPeak(int iChannel) const
+{
+	std::unique_lock<std::mutex> lock = lockCache();
+	initBounds();
+	if ((iChannel < 0) || (iChannel >= (int)m_vfChannelPeaks.size()))
+		return 0;
+	return m_vfChannelPeaks[iChannel];
+}
+
+float DAFFTransformerDFT2IR::getRecordPeak(int iRecordIndex, int iChannel) const
+{
+	int iOffset, iLength;
+	float fPeak;
+	std::unique_lock<std::mutex> lock = lockCache();
+	if (!getFilterPtr(iRecordIndex, iChannel, iOffset, iLength, fPeak))
+		return 0;
+	return fPeak;
+}
+
+int DAFFTransformerDFT2IR::getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iOffset, iLength;
+	float fPeak;
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel, iOffset, iLength, fPeak);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	// Same definitions as for stored impulse responses (see DAFFContentIR::getRecordStatistics)
+	double dEnergy = DAFF::energy_float(pfData + iOffset, iLength);
+	oStats.fPeak = fPeak;
+	oStats.fEnergy = (float)dEnergy;
+	oStats.fRMS = (float)std::sqrt(dEnergy / m_iLength);
+
+	oStats.iOnset = -1;
+	for (int i = iOffset; (i < iOffset + iLength) && (fPeak > 0); i++) {
+		if (std::fabs(pfData[i]) >= 0.1f * fPeak) {
+			oStats.iOnset = i;
+			break;
+		}
+	}
+
+	return DAFF_NO_ERROR;
+}
@@ -0,0 +1,337 @@
+#include <DAFFTransformerDFT2MagPhase.h>
+
+#include <DAFFContentDFT.h>
+#include <DAFFInterpolator.h>
+#include <DAFFProperties.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "Utils.h"
+
+//! Number of coefficients resynthesized per block by interpolate (stack buffers)
+static const int DAFF_MAGPHASE_BLOCK_SIZE = 64;
+
+//! Unwraps phases in place, so that neighbouring phases differ by at most pi
+static void unwrapPhases(float* pfPhases, int iCount)
+{
+	const double dTwoPi = 6.283185307179586;
+
+	// Multiples of 2 pi are counted, so that the rounding errors do not accumulate
+	int iWraps = 0;
+	float fPrevious = (iCount > 0 ? pfPhases[0] : 0);
+	for (int k = 1; k < iCount; k++) {
+		double dDiff = pfPhases[k] + iWraps * dTwoPi - fPrevious;
+		iWraps -= (int)std::floor((dDiff + 3.141592653589793) / dTwoPi);
+		pfPhases[k] = (float)(pfPhases[k] + iWraps * dTwoPi);
+		fPrevious = pfPhases[k];
+	}
+}
+
+//! Group delays [samples] of unwrapped phases at the bins 2 pi k / iTransformSize
+static void groupDelays(float* pfDest, const float* pfPhases, int iCount, int iTransformSize)
+{
+	if (iCount < 2) {
+		if (iCount == 1)
+			pfDest[0] = 0;
+		return;
+	}
+
+	float fScale = (float)(iTransformSize / 6.283185307179586);
+	pfDest[0] = -(pfPhases[1] - pfPhases[0]) * fScale;
+	for (int k = 1; k < iCount - 1; k++)
+		pfDest[k] = -(pfPhases[k + 1] - pfPhases[k - 1]) * 0.5f * fScale;
+	pfDest[iCount - 1] = -(pfPhases[iCount - 1] - pfPhases[iCount - 2]) * fScale;
+}
+
+DAFFTransformerDFT2MagPhase::DAFFTransformerDFT2MagPhase()
+	: m_pInputContent(NULL), m_pInterpolator(NULL), m_iNumThreads(0), m_iNumValues(0), m_iStride(0),
+	  m_pfMagnitudes(NULL), m_pfPhases(NULL), m_pfGroupDelays(NULL)
+{
+}
+
+DAFFTransformerDFT2MagPhase::DAFFTransformerDFT2MagPhase(const DAFFContentDFT* pInputContent, bool bTransform)
+	: m_pInputContent(NULL), m_pInterpolator(NULL), m_iNumThreads(0), m_iNumValues(0), m_iStride(0),
+	  m_pfMagnitudes(NULL), m_pfPhases(NULL), m_pfGroupDelays(NULL)
+{
+	setInputContent(pInputContent, bTransform);
+}
+
+DAFFTransformerDFT2MagPhase::~DAFFTransformerDFT2MagPhase()
+{
+	clear();
+}
+
+const DAFFContentDFT* DAFFTransformerDFT2MagPhase::getInputContent() const
+{
+	return m_pInputContent;
+}
+
+void DAFFTransformerDFT2MagPhase::setInputContent(const DAFFContentDFT* pInputContent, bool bTransform)
+{
+	m_pInputContent = pInputContent;
+	if (bTransform)
+		transform();
+}
+
+bool DAFFTransformerDFT2MagPhase::isTransformed() const
+{
+	return (m_iNumValues > 0);
+}
+
+int DAFFTransformerDFT2MagPhase::getNumValues() const
+{
+	return m_iNumValues;
+}
+
+int DAFFTransformerDFT2MagPhase::getNumThreads() const
+{
+	return m_iNumThreads;
+}
+
+void DAFFTransformerDFT2MagPhase::setNumThreads(int iNumThreads)
+{
+	m_iNumThreads = (iNumThreads > 0 ? iNumThreads : 0);
+}
+
+size_t DAFFTransformerDFT2MagPhase::getMemoryFootprint() const
+{
+	if (!isTransformed())
+		return 0;
+
+	size_t nNumRecordChannels = (size_t)m_pInputContent->getProperties()->getNumberOfRecords() *
+								m_pInputContent->getProperties()->getNumberOfChannels();
+	return 3 * nNumRecordChannels * m_iStride * sizeof(float);
+}
+
+void DAFFTransformerDFT2MagPhase::clear()
+{
+	delete m_pInterpolator;
+	m_pInterpolator = NULL;
+
+	DAFF::free_aligned16(m_pfMagnitudes);
+	DAFF::free_aligned16(m_pfPhases);
+	DAFF::free_aligned16(m_pfGroupDelays);
+	m_pfMagnitudes = m_pfPhases = m_pfGroupDelays = NULL;
+
+	m_iNumValues = 0;
+	m_iStride = 0;
+}
+
+void DAFFTransformerDFT2MagPhase::transform()
+{
+	// Discard previous results
+	clear();
+
+	if (!m_pInputContent)
+		return;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int iNumRecordChannels = iRecords * iChannels;
+	int iNumValues = m_pInputContent->getNumDFTCoeffs();
+	if ((iNumRecordChannels == 0) || (iNumValues == 0))
+		return;
+
+	// Record channels are 16-byte aligned
+	m_iStride = (iNumValues + 3) / 4 * 4;
+	size_t nBytes = (size_t)iNumRecordChannels * m_iStride * sizeof(float);
+	m_pfMagnitudes = static_cast<float*>(DAFF::malloc_aligned16(nBytes));
+	m_pfPhases = static_cast<float*>(DAFF::malloc_aligned16(nBytes));
+	m_pfGroupDelays = static_cast<float*>(DAFF::malloc_aligned16(nBytes));
+	if (!m_pfMagnitudes || !m_pfPhases || !m_pfGroupDelays) {
+		clear();
+		return;
+	}
+	memset(m_pfMagnitudes, 0, nBytes);
+	memset(m_pfPhases, 0, nBytes);
+	memset(m_pfGroupDelays, 0, nBytes);
+	m_iNumValues = iNumValues;
+
+	// Distribute the record channels over several threads, each transforming a range
+	int iNumThreads = m_iNumThreads;
+	if (iNumThreads <= 0) {
+		const uint64_t ui64MinValuesPerThread = 1 << 16;
+		uint64_t ui64NumValues = (uint64_t)iNumRecordChannels * iNumValues;
+		uint64_t ui64MaxThreads = std::max(ui64NumValues / ui64MinValuesPerThread, (uint64_t)1);
+		iNumThreads = (int)std::min((uint64_t)std::max(std::thread::hardware_concurrency(), 1u), ui64MaxThreads);
+	}
+
+	std::vector<std::thread> vThreads;
+	int iChunk = (iNumRecordChannels + iNumThreads - 1) / iNumThreads;
+	for (int iBegin = iChunk; iBegin < iNumRecordChannels; iBegin += iChunk) {
+		int iEnd = std::min(iBegin + iChunk, iNumRecordChannels);
+		try {
+			vThreads.push_back(std::thread(&DAFFTransformerDFT2MagPhase::transformRange, this, iBegin, iEnd));
+		} catch (const std::system_error&) {
+			transformRange(iBegin, iEnd);  // No more threads available
+		}
+	}
+
+	transformRange(0, std::min(iChunk, iNumRecordChannels));
+
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	m_pInterpolator = new DAFFInterpolator(m_pInputContent);
+}
+
+void DAFFTransformerDFT2MagPhase::transformRange(int iBegin, int iEnd)
+{
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int iTransformSize = m_pInputContent->getTransformSize();
+
+	float* pfBuf = static_cast<float*>(DAFF::malloc_aligned16(2 * m_iNumValues * sizeof(float)));
+
+	for (int n = iBegin; n < iEnd; n++) {
+		size_t nOffset = (size_t)n * m_iStride;
+		if (m_pInputContent->getDFTCoeffs(n / iChannels, n % iChannels, pfBuf) != DAFF_NO_ERROR)
+			continue;  // Left zero
+
+		DAFF::cart2polar_float(pfBuf, pfBuf, m_iNumValues);
+		DAFF::deinterleave_float(m_pfMagnitudes + nOffset, m_pfPhases + nOffset, pfBuf, m_iNumValues);
+		unwrapPhases(m_pfPhases + nOffset, m_iNumValues);
+		groupDelays(m_pfGroupDelays + nOffset, m_pfPhases + nOffset, m_iNumValues, iTransformSize);
+	}
+
+	DAFF::free_aligned16(pfBuf);
+}
+
+ptrdiff_t DAFFTransformerDFT2MagPhase::getOffset(int iRecordIndex, int iChannel) const
+{
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords) || (iChannel < 0) || (iChannel >= iChannels))
+		return -1;
+
+	return ((ptrdiff_t)iRecordIndex * iChannels + iChannel) * m_iStride;
+}
+
+int DAFFTransformerDFT2MagPhase::getValues(const float* pfBuf, int iRecordIndex, int iChannel, float* pfDest) const
+{
+	if (!isTransformed())
+		return DAFF_MODAL_ERROR;
+
+	ptrdiff_t nOffset = getOffset(iRecordIndex, iChannel);
+	if (nOffset < 0)
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest)
+		memcpy(pfDest, pfBuf + nOffset, m_iNumValues * sizeof(float));
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerDFT2MagPhase::getMagnitudes(int iRecordIndex, int iChannel, float* pfDest) const
+{
+	return getValues(m_pfMagnitudes, iRecordIndex, iChannel, pfDest);
+}
+
+int DAFFTransformerDFT2MagPhase::getUnwrappedPhases(int iRecordIndex, int iChannel, float* pfDest) const
+{
+	return getValues(m_pfPhases, iRecordIndex, iChannel, pfDest);
+}
+
+int DAFFTransformerDFT2MagPhase::getGroupDelays(int iRecordIndex, int iChannel, float* pfDest) const
+{
+	return getValues(m_pfGroupDelays, iRecordIndex, iChannel, pfDest);
+}
+
+int DAFFTransformerDFT2MagPhase::getSources(int iView, float fAngle1Deg, float fAngle2Deg, int iChannel,
+											ptrdiff_t* pnOffsets, float* pfGains, int& iNumRecords) const
+{
+	if (!isTransformed())
+		return DAFF_MODAL_ERROR;
+
+	DAFFQuad qIndices;
+	float pfWeights[4];
+	int iError = m_pInterpolator->getWeights(iView, fAngle1Deg, fAngle2Deg, qIndices, pfWeights);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	// Merge coinciding records (poles, boundaries), so that every record is read once
+	int piIndices[4] = { qIndices.iIndex1, qIndices.iIndex2, qIndices.iIndex3, qIndices.iIndex4 };
+	for (int i = 1; i < 4; i++)
+		for (int j = 0; j < i; j++)
+			if (piIndices[j] == piIndices[i]) {
+				pfWeights[j] += pfWeights[i];
+				pfWeights[i] = 0.0f;
+				break;
+			}
+
+	iNumRecords = 0;
+	for (int i = 0; i < 4; i++) {
+		if (pfWeights[i] == 0.0f)
+			continue;
+
+		pnOffsets[iNumRecords] = getOffset(piIndices[i], iChannel);
+		if (pnOffsets[iNumRecords] < 0)
+			return DAFF_INVALID_INDEX;
+		pfGains[iNumRecords] = pfWeights[i];
+		iNumRecords++;
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerDFT2MagPhase::interpolateMagPhase(int iView, float fAngle1Deg, float fAngle2Deg, int iChannel,
+													 float* pfMagnitudes, float* pfPhases) const
+{
+	ptrdiff_t pnOffsets[4];
+	float pfGains[4];
+	int iNumRecords = 0;
+	int iError = getSources(iView, fAngle1Deg, fAngle2Deg, iChannel, pnOffsets, pfGains, iNumRecords);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	const float* ppfMagnitudes[4];
+	const float* ppfPhases[4];
+	for (int i = 0; i < iNumRecords; i++) {
+		ppfMagnitudes[i] = m_pfMagnitudes + pnOffsets[i];
+		ppfPhases[i] = m_pfPhases + pnOffsets[i];
+	}
+
+	if (pfMagnitudes)
+		DAFF::blend_float(pfMagnitudes, ppfMagnitudes, pfGains, iNumRecords, m_iNumValues);
+	if (pfPhases)
+		DAFF::blend_float(pfPhases, ppfPhases, pfGains, iNumRecords, m_iNumValues);
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerDFT2MagPhase::interpolate(int iView, float fAngle1Deg, float fAngle2Deg, int iChannel,
+											 float* pfDest) const
+{
+	ptrdiff_t pnOffsets[4];
+	float pfGains[4];
+	int iNumRecords = 0;
+	int iError = getSources(iView, fAngle1Deg, fAngle2Deg, iChannel, pnOffsets, pfGains, iNumRecords);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	// Blend and resynthesize block by block (no intermediate buffers on the heap)
+	float pfMagnitudes[DAFF_MAGPHASE_BLOCK_SIZE];
+	float pfPhases[DAFF_MAGPHASE_BLOCK_SIZE];
+	const float* ppfMagnitudes[4];
+	const float* ppfPhases[4];
+	for (int k = 0; k < m_iNumValues; k += DAFF_MAGPHASE_BLOCK_SIZE) {
+		int iCount = std::min(DAFF_MAGPHASE_BLOCK_SIZE, m_iNumValues - k);
+		for (int i = 0; i < iNumRecords; i++) {
+			ppfMagnitudes[i] = m_pfMagnitudes + pnOffsets[i] + k;
+			ppfPhases[i] = m_pfPhases + pnOffsets[i] + k;
+		}
+
+		DAFF::blend_float(pfMagnitudes, ppfMagnitudes, pfGains, iNumRecords, iCount);
+		DAFF::blend_float(pfPhases, ppfPhases, pfGains, iNumRecords, iCount);
+		DAFF::polar2cart_float(pfDest + 2 * k, pfMagnitudes, pfPhases, iCount);
+	}
+
+	return DAFF_NO_ERROR;
+}
@@ -4,10 +4,15 @@
 
 #include <algorithm>
 #include <cassert>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
 
-#include <fftw3.h>
-
+#include "DAFFFFTPlanCache.h"
+#include "DAFFInstrumentationImpl.h"
 #include "DAFFPropertiesImpl.h"
+#include "DAFFRecordCache.h"
 #include "Utils.h"
 
 // Inner content interface realization
@@ -60,6 +65,46 @@ class DAFFContentDFTRealization : public DAFFContentDFT {
 		return m_pParent->getDFTCoeffs(iRecordIndex, iChannel, pfDest);
 	};
 
+	inline int getDFTCoeffsFull(int iRecordIndex, int iChannel, float* pfDest) const
+	{
+		return m_pParent->getDFTCoeffsFull(iRecordIndex, iChannel, pfDest);
+	};
+
+	inline int getDFTCoeffSlice(int iChannel, int iDFTCoeff, float* pfDest) const
+	{
+		return m_pParent->getDFTCoeffSlice(iChannel, iDFTCoeff, pfDest);
+	};
+
+	inline int getCoefficientsMP(int iRecordIndex, int iChannel, float* pfDest) const
+	{
+		return m_pParent->getCoefficientsMP(&iRecordIndex, 1, iChannel, pfDest);
+	};
+
+	inline int getCoefficientsMP(const int* piRecordIndices, int iNumRecords, int iChannel, float* pfDest) const
+	{
+		return m_pParent->getCoefficientsMP(piRecordIndices, iNumRecords, iChannel, pfDest);
+	};
+
+	inline int addDFTCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
+	{
+		return m_pParent->addDFTCoeffs(iRecordIndex, iChannel, pfDest, fGain);
+	};
+
+	inline const float* getDFTCoeffsPtr(int iRecordIndex, int iChannel) const
+	{
+		return m_pParent->getDFTCoeffsPtr(iRecordIndex, iChannel);
+	};
+
+	inline int getRecord(int iRecordIndex, float** ppfChannelDest) const
+	{
+		return m_pParent->getRecord(iRecordIndex, ppfChannelDest);
+	};
+
+	inline int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const
+	{
+		return m_pParent->getRecordInterleaved(iRecordIndex, pfDest, iStride);
+	};
+
 	// --= Interface "DAFFContent" =--
 
 	// This interface is completely delegated to the input content of the transform
@@ -93,6 +138,38 @@ class DAFFContentDFTRealization : public DAFFContentDFT {
 		m_pInputContent->getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex, bOutOfBounds);
 	};
 
+	inline void getNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int* piRecordIndices,
+									 bool* pbOutOfBounds, size_t n) const
+	{
+		m_pInputContent->getNearestNeighbours(iView, pfAngles1, pfAngles2, piRecordIndices, pbOutOfBounds, n);
+	};
+
+	inline int getKNearestNeighbours(int iView, float fAngle1, float fAngle2, int k, int* piRecordIndices,
+									 float* pfDistances) const
+	{
+		return m_pInputContent->getKNearestNeighbours(iView, fAngle1, fAngle2, k, piRecordIndices, pfDistances);
+	};
+
+	inline int getKNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int k,
+									 int* piRecordIndices, float* pfDistances, size_t n) const
+	{
+		return m_pInputContent->getKNearestNeighbours(iView, pfAngles1, pfAngles2, k, piRecordIndices, pfDistances,
+													  n);
+	};
+
+	inline int getRecordsInCone(int iView, float fAngle1, float fAngle2, float fRadius,
+								std::vector<int>& viRecordIndices) const
+	{
+		return m_pInputContent->getRecordsInCone(iView, fAngle1, fAngle2, fRadius, viRecordIndices);
+	};
+
+	inline int getRecordsInCone(int iView, const float* pfAngles1, const float* pfAngles2, float fRadius,
+								std::vector<int>& viRecordIndices, std::vector<int>& viOffsets, size_t n) const
+	{
+		return m_pInputContent->getRecordsInCone(iView, pfAngles1, pfAngles2, fRadius, viRecordIndices, viOffsets,
+												 n);
+	};
+
 	inline void getCell(int iView, float fAngle1, float fAngle2, DAFFQuad& qIndices) const
 	{
 		m_pInputContent->getCell(iView, fAngle1, fAngle2, qIndices);
@@ -114,21 +191,139 @@ class DAFFContentDFTRealization : public DAFFContentDFT {
 	DAFFPropertiesImpl m_oProps;
 };
 
+int DAFFTransformerIR2DFT::getPlanningRigor()
+{
+	return DAFFFFTPlanCache::getRigor();
+}
+
+void DAFFTransformerIR2DFT::setPlanningRigor(int iRigor)
+{
+	assert((iRigor >= DAFF_FFT_ESTIMATE) && (iRigor <= DAFF_FFT_PATIENT));
+	DAFFFFTPlanCache::setRigor(iRigor);
+}
+
+void DAFFTransformerIR2DFT::clearPlanCache()
+{
+	DAFFFFTPlanCache::clear();
+}
+
+int DAFFTransformerIR2DFT::getNumCachedPlans()
+{
+	return DAFFFFTPlanCache::getNumPlans();
+}
+
+int DAFFTransformerIR2DFT::importWisdom(const std::string& sFilePath)
+{
+	return DAFFFFTPlanCache::importWisdom(sFilePath);
+}
+
+int DAFFTransformerIR2DFT::exportWisdom(const std::string& sFilePath)
+{
+	return DAFFFFTPlanCache::exportWisdom(sFilePath);
+}
+
+//! Tabulates a window function of n samples
+/**
+ * All windows are symmetric. Hann, Tukey and the tail window reach zero at the border.
+ */
+static void createWindow(int iWindowFunction, float fTaper, float* pfWindow, int n)
+{
+	const double dPi = 3.14159265358979323846;
+	double dN = (n > 1 ? n - 1 : 1);
+
+	for (int i = 0; i < n; i++) {
+		double x = 2 * dPi * i / dN;
+		double w = 1;
+
+		switch (iWindowFunction) {
+		case DAFF_WINDOW_HANN:
+			w = 0.5 - 0.5 * cos(x);
+			break;
+
+		case DAFF_WINDOW_HAMMING:
+			w = 0.54 - 0.46 * cos(x);
+			break;
+
+		case DAFF_WINDOW_BLACKMAN_HARRIS:
+			w = 0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2 * x) - 0.01168 * cos(3 * x);
+			break;
+
+		case DAFF_WINDOW_TUKEY: {
+			// Cosine flanks of taper * (n-1) / 2 samples each
+			double dFlank = fTaper * dN / 2;
+			double d = (std::min)((double)i, dN - i);
+			if (d < dFlank)
+				w = 0.5 - 0.5 * cos(dPi * d / dFlank);
+		} break;
+
+		case DAFF_WINDOW_HALF_HANN_TAIL: {
+			// Fade-out of the last taper * n samples, down to zero at the last sample
+			int iFade = (int)(fTaper * n + 0.5f);
+			int j = i - (n - iFade);
+			if (j >= 0)
+				w = 0.5 + 0.5 * cos(dPi * (j + 1) / iFade);
+		} break;
+		}
+
+		pfWindow[i] = (float)w;
+	}
+}
+
+//! Transforms the impulse response of a record channel into a DFT spectrum
+/**
+ * \param pfWindow	Window function (NULL: no windowing)
+ * \param pfInput	Input buffer (filter length, 16-byte aligned)
+ * \param pfDest		Destination of the 2*(filter length/2+1) interleaved coefficients
+ * \param oState		Plan lookup state
+ *
+ * @return Greatest squared magnitude of the spectrum
+ */
+static float transformSpectrum(const DAFFContentIR* pInputContent, int iRecord, int iChannel, const float* pfWindow,
+							   float* pfInput, float* pfDest, DAFFFFTPlanState& oState)
+{
+	int iFilterLength = pInputContent->getFilterLength();
+
+	// Fetch input data
+	pInputContent->getFilterCoeffs(iRecord, iChannel, pfInput);
+
+	// Apply window function
+	if (pfWindow)
+		DAFF::mul_float(pfInput, pfWindow, iFilterLength);
+
+	// Transform into frequency-domain
+	DAFFFFTPlanCache::execute(iFilterLength, pfInput, pfDest, oState);
+
+	// Determine maximum
+	float fMagSqPeak = 0;
+	for (int i = 0; i < iFilterLength / 2 + 1; i++) {
+		float fReal = pfDest[2 * i + 0];
+		float fImag = pfDest[2 * i + 1];
+		fMagSqPeak = (std::max)(fMagSqPeak, fReal * fReal + fImag * fImag);
+	}
+
+	return fMagSqPeak;
+}
+
 DAFFTransformerIR2DFT::DAFFTransformerIR2DFT()
-	: m_pInputContent(NULL), m_pOutputContent(NULL), m_iWindowFunction(DAFF_WINDOW_NONE), m_pfBuf(NULL)
+	: m_pInputContent(NULL), m_pOutputContent(NULL), m_iWindowFunction(DAFF_WINDOW_NONE), m_fWindowTaper(0.5f),
+	  m_iNumThreads(0), m_bLazy(false), m_pCache(new DAFFRecordCache), m_pfBuf(NULL), m_pfWindow(NULL),
+	  m_pfScratch(NULL), m_bPeakKnown(false)
 {
 }
 
 DAFFTransformerIR2DFT::DAFFTransformerIR2DFT(const DAFFContentIR* pInputContent, int iWindowFunction, bool bTransform)
-	: m_pInputContent(NULL), m_pOutputContent(NULL), m_iWindowFunction(DAFF_WINDOW_NONE), m_pfBuf(NULL)
+	: m_pInputContent(NULL), m_pOutputContent(NULL), m_iWindowFunction(DAFF_WINDOW_NONE), m_fWindowTaper(0.5f),
+	  m_iNumThreads(0), m_bLazy(false), m_pCache(new DAFFRecordCache), m_pfBuf(NULL), m_pfWindow(NULL),
+	  m_pfScratch(NULL), m_bPeakKnown(false)
 {
+	setWindowFunction(iWindowFunction, false);
 	setInputContent(pInputContent, bTransform);
-	setWindowFunction(iWindowFunction);
 }
 
 DAFFTransformerIR2DFT::~DAFFTransformerIR2DFT()
 {
 	clear();
+	delete m_pCache;
 }
 
 void DAFFTransformerIR2DFT::setInputContent(const DAFFContentIR* pInputContent, bool bTransform)
@@ -151,7 +346,74 @@ int DAFFTransformerIR2DFT::getWindowFunction() const
 void DAFFTransformerIR2DFT::setWindowFunction(int iWindowFunction, bool bTransform)
 {
 	m_iWindowFunction = iWindowFunction;
-	// if (m_pOutputContent) m_pOutputData->setWindow(iWindow, bTransform);
+	if (bTransform && m_pInputContent)
+		transform();
+}
+
+float DAFFTransformerIR2DFT::getWindowTaper() const
+{
+	return m_fWindowTaper;
+}
+
+void DAFFTransformerIR2DFT::setWindowTaper(float fTaper, bool bTransform)
+{
+	assert((fTaper >= 0) && (fTaper <= 1));
+	m_fWindowTaper = (std::min)((std::max)(fTaper, 0.0f), 1.0f);
+	if (bTransform && m_pInputContent)
+		transform();
+}
+
+int DAFFTransformerIR2DFT::getNumThreads() const
+{
+	return m_iNumThreads;
+}
+
+void DAFFTransformerIR2DFT::setNumThreads(int iNumThreads)
+{
+	m_iNumThreads = (iNumThreads > 0 ? iNumThreads : 0);
+}
+
+bool DAFFTransformerIR2DFT::isLazy() const
+{
+	return m_bLazy;
+}
+
+void DAFFTransformerIR2DFT::setLazy(bool bLazy, bool bTransform)
+{
+	m_bLazy = bLazy;
+	if (bTransform)
+		transform();
+}
+
+size_t DAFFTransformerIR2DFT::getLazyCacheSize() const
+{
+	std::lock_guard<std::mutex> lock(m_mxCache);
+	return m_pCache->getMaxSize();
+}
+
+void DAFFTransformerIR2DFT::setLazyCacheSize(size_t nMaxBytes)
+{
+	std::lock_guard<std::mutex> lock(m_mxCache);
+	m_pCache->setMaxSize(nMaxBytes);
+}
+
+size_t DAFFTransformerIR2DFT::getMemoryFootprint() const
+{
+	size_t nBytes = 0;
+	if (m_pInputContent) {
+		size_t nRecordChannels = (size_t)m_pInputContent->getProperties()->getNumberOfRecords() *
+								 m_pInputContent->getProperties()->getNumberOfChannels();
+		size_t nFilterBytes = (size_t)m_pInputContent->getFilterLength() * sizeof(float);
+		if (m_pfBuf)
+			nBytes += nRecordChannels * ((m_iElementSize * sizeof(float) + 15) / 16 * 16);
+		if (m_pfWindow)
+			nBytes += nFilterBytes;
+		if (m_pfScratch)
+			nBytes += nFilterBytes;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mxCache);
+	return nBytes + m_pCache->getSize();
 }
 
 void DAFFTransformerIR2DFT::clear()
@@ -161,6 +423,15 @@ void DAFFTransformerIR2DFT::clear()
 
 	DAFF::free_aligned16(m_pfBuf);
 	m_pfBuf = NULL;
+
+	DAFF::free_aligned16(m_pfWindow);
+	m_pfWindow = NULL;
+
+	DAFF::free_aligned16(m_pfScratch);
+	m_pfScratch = NULL;
+
+	m_pCache->clear();
+	m_bPeakKnown = false;
 }
 
 void DAFFTransformerIR2DFT::transform()
@@ -188,66 +459,137 @@ void DAFFTransformerIR2DFT::transform()
 			n++;
 		iElementSizeBytes = n * 16;
 
-		// Allocate buffer for DFT spectra
 		iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
 		iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+		iFilterLength = m_pInputContent->getFilterLength();
+
+		// Tabulate the window function
+		if (m_iWindowFunction != DAFF_WINDOW_NONE) {
+			m_pfWindow = static_cast<float*>(DAFF::malloc_aligned16(iFilterLength * sizeof(float)));
+			createWindow(m_iWindowFunction, m_fWindowTaper, m_pfWindow, iFilterLength);
+		}
+
+		// Lazy: spectra are transformed on first access
+		if (m_bLazy) {
+			m_pfScratch = static_cast<float*>(DAFF::malloc_aligned16(iFilterLength * sizeof(float)));
+			return;
+		}
 
-		m_pfBuf = static_cast<float*>(DAFF::malloc_aligned16(iRecords * iChannels * iElementSizeBytes));
+		// Allocate buffer for DFT spectra
+		m_pfBuf = static_cast<float*>(DAFF::malloc_aligned16((size_t)iRecords * iChannels * iElementSizeBytes));
 	}
 
 	// Transform the contents
 	if (m_pOutputContent) {
-		iFilterLength = m_pInputContent->getFilterLength();
-		float* pfInputData = static_cast<float*>(DAFF::malloc_aligned16(iFilterLength * sizeof(float)));
-		float* pfWindow = static_cast<float*>(DAFF::malloc_aligned16(iFilterLength * sizeof(float)));
-
-		fftwf_plan oFFTPlan =
-			fftwf_plan_dft_r2c_1d(iFilterLength, pfInputData, reinterpret_cast<fftwf_complex*>(m_pfBuf), FFTW_ESTIMATE);
-
-		// Create window function
-		switch (m_iWindowFunction) {
-		case DAFF_WINDOW_HANN: {
-			// TODO:
-		} break;
+		// Distribute the record channels over several threads, each transforming a range
+		int iNumRecordChannels = iRecords * iChannels;
+		int iNumThreads = m_iNumThreads;
+		if (iNumThreads <= 0) {
+			const uint64_t ui64MinSamplesPerThread = 1 << 16;
+			uint64_t ui64NumSamples = (uint64_t)iNumRecordChannels * iFilterLength;
+			uint64_t ui64MaxThreads = std::max(ui64NumSamples / ui64MinSamplesPerThread, (uint64_t)1);
+			iNumThreads = (int)std::min((uint64_t)std::max(std::thread::hardware_concurrency(), 1u), ui64MaxThreads);
 		}
 
-		// Written using one loop for effective parallelization
-		for (int n = 0; n < iRecords * iChannels; n++) {
-			int iRecord = n / iChannels;
-			int iChannel = n % iChannels;
-
-			// Fetch input data
-			m_pInputContent->getFilterCoeffs(iRecord, iChannel, pfInputData);
-
-			// Apply window function
-			if (m_iWindowFunction != DAFF_WINDOW_NONE)
-				for (int i = 0; i < iFilterLength; i++)
-					pfInputData[i] *= pfWindow[i];
-
-			// Transform into frequency-domain
-			float* pfOutputData = m_pfBuf + (iRecord * iChannels + iChannel) * m_iElementSize;
-			fftwf_execute_dft_r2c(oFFTPlan, pfInputData, reinterpret_cast<fftwf_complex*>(pfOutputData));
-
-			// Determine maximum
-			for (int i = 0; i < m_iNumDFTCoeffs; i++) {
-				float fReal = pfOutputData[2 * i + 0];
-				float fImag = pfOutputData[2 * i + 1];
-				float fMagSq = fReal * fReal + fImag * fImag;
-				m_fOverallMagnitudePeak = (std::max)(m_fOverallMagnitudePeak, fMagSq);
+		std::vector<std::thread> vThreads;
+		int iChunk = (iNumRecordChannels + iNumThreads - 1) / iNumThreads;
+		std::vector<float> vfMagSqPeaks(iNumThreads, 0.0f);
+		for (int i = 1; i * iChunk < iNumRecordChannels; i++) {
+			int iBegin = i * iChunk;
+			int iEnd = std::min(iBegin + iChunk, iNumRecordChannels);
+			try {
+				vThreads.push_back(
+					std::thread(&DAFFTransformerIR2DFT::transformRange, this, iBegin, iEnd, &vfMagSqPeaks[i]));
+			} catch (const std::system_error&) {
+				transformRange(iBegin, iEnd, &vfMagSqPeaks[i]);  // No more threads available
 			}
 		}
 
-		DAFF::free_aligned16(pfInputData);
-		DAFF::free_aligned16(pfWindow);
+		transformRange(0, std::min(iChunk, iNumRecordChannels), &vfMagSqPeaks[0]);
 
-		fftwf_destroy_plan(oFFTPlan);
+		for (size_t i = 0; i < vThreads.size(); i++)
+			vThreads[i].join();
 
+		for (size_t i = 0; i < vfMagSqPeaks.size(); i++)
+			m_fOverallMagnitudePeak = (std::max)(m_fOverallMagnitudePeak, vfMagSqPeaks[i]);
 		m_fOverallMagnitudePeak = sqrt(m_fOverallMagnitudePeak);
+		m_bPeakKnown = true;
+	}
+}
+
+void DAFFTransformerIR2DFT::transformRange(int iBegin, int iEnd, float* pfMagSqPeak)
+{
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int iFilterLength = m_pInputContent->getFilterLength();
+	float* pfInputData = static_cast<float*>(DAFF::malloc_aligned16(iFilterLength * sizeof(float)));
+	const float* pfWindow = m_pfWindow;
+
+	DAFFFFTPlanState oState;
+	float fMagSqPeak = 0;
+	for (int n = iBegin; n < iEnd; n++) {
+		float* pfOutputData = m_pfBuf + (size_t)n * m_iElementSize;
+		fMagSqPeak = (std::max)(fMagSqPeak, transformSpectrum(m_pInputContent, n / iChannels, n % iChannels, pfWindow,
+																pfInputData, pfOutputData, oState));
 	}
+
+	DAFF::free_aligned16(pfInputData);
+
+	*pfMagSqPeak = fMagSqPeak;
+}
+
+std::unique_lock<std::mutex> DAFFTransformerIR2DFT::lockCache() const
+{
+	if (m_bLazy)
+		return std::unique_lock<std::mutex>(m_mxCache);
+	return std::unique_lock<std::mutex>();
+}
+
+const float* DAFFTransformerIR2DFT::getSpectrumPtr(int iRecordIndex, int iChannel) const
+{
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int64_t iKey = (int64_t)iRecordIndex * iChannels + iChannel;
+	if (!m_bLazy)
+		return m_pfBuf + iKey * m_iElementSize;
+
+	float* pfData = static_cast<float*>(m_pCache->find(iKey));
+	DAFF_INSTRUMENT_COUNT(pfData ? DAFF_COUNTER_TRANSFORMER_CACHE_HITS : DAFF_COUNTER_TRANSFORMER_CACHE_MISSES, 1);
+	if (pfData)
+		return pfData;
+
+	pfData = static_cast<float*>(m_pCache->insert(iKey, m_iElementSize * sizeof(float)));
+	if (pfData == NULL)
+		return NULL;
+
+	DAFFFFTPlanState oState;
+	const float* pfWindow = m_pfWindow;
+	transformSpectrum(m_pInputContent, iRecordIndex, iChannel, pfWindow, m_pfScratch, pfData, oState);
+
+	return pfData;
 }
 
 float DAFFTransformerIR2DFT::getOverallMagnitudeMaximum() const
 {
+	std::unique_lock<std::mutex> lock = lockCache();
+
+	// Lazy: all spectra have to be transformed once (without caching them)
+	if (!m_bPeakKnown && m_pInputContent) {
+		int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+		int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+		float* pfSpectrum = static_cast<float*>(DAFF::malloc_aligned16(m_iElementSize * sizeof(float)));
+		const float* pfWindow = m_pfWindow;
+
+		DAFFFFTPlanState oState;
+		float fMagSqPeak = 0;
+		for (int n = 0; n < iRecords * iChannels; n++)
+			fMagSqPeak = (std::max)(fMagSqPeak, transformSpectrum(m_pInputContent, n / iChannels, n % iChannels,
+																	pfWindow, m_pfScratch, pfSpectrum, oState));
+
+		DAFF::free_aligned16(pfSpectrum);
+
+		m_fOverallMagnitudePeak = sqrt(fMagSqPeak);
+		m_bPeakKnown = true;
+	}
+
 	return m_fOverallMagnitudePeak;
 }
 
@@ -259,21 +601,45 @@ int DAFFTransformerIR2DFT::getDFTCoeff(int iRecordIndex, int iChannel, int iDFTC
 	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
 	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
 
+	int iTransformSize = m_pInputContent->getFilterLength();
+
 	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
 	assert((iChannel >= 0) && (iChannel < iChannels));
-	assert((iDFTCoeff >= 0) && (iDFTCoeff < m_iNumDFTCoeffs));
+	assert((iDFTCoeff >= 0) && (iDFTCoeff < iTransformSize));
 
 	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
 		return -1;
 	if ((iChannel < 0) || (iChannel >= iChannels))
 		return -1;
-	if ((iDFTCoeff < 0) || (iDFTCoeff > m_iNumDFTCoeffs))
+	if ((iDFTCoeff < 0) || (iDFTCoeff >= iTransformSize))
 		return -1;
 
-	float* pfData = m_pfBuf + (iRecordIndex * iChannels + iChannel) * m_iElementSize;
+	// Coefficients beyond the symmetric half: X[N-k] = conj(X[k])
+	bool bConjugate = (iDFTCoeff >= m_iNumDFTCoeffs);
+	if (bConjugate)
+		iDFTCoeff = iTransformSize - iDFTCoeff;
+
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getSpectrumPtr(iRecordIndex, iChannel);
+	if (!pfData)
+		return -1;
 
 	fReal = pfData[2 * iDFTCoeff + 0];
-	fImag = pfData[2 * iDFTCoeff + 1];
+	fImag = (bConjugate ? -pfData[2 * iDFTCoeff + 1] : pfData[2 * iDFTCoeff + 1]);
+
+	return 0;
+}
+
+int DAFFTransformerIR2DFT::getDFTCoeffsFull(int iRecordIndex, int iChannel, float* pfDest) const
+{
+	int iError = getDFTCoeffs(iRecordIndex, iChannel, pfDest);
+	if (iError != 0)
+		return iError;
+
+	// The spectra of real-valued filters are symmetric
+	int iTransformSize = m_pInputContent->getFilterLength();
+	if (m_iNumDFTCoeffs < iTransformSize)
+		DAFF::conj_mirror_float(pfDest + 2 * m_iNumDFTCoeffs, pfDest + 2, iTransformSize - m_iNumDFTCoeffs);
 
 	return 0;
 }
@@ -294,9 +660,178 @@ int DAFFTransformerIR2DFT::getDFTCoeffs(int iRecordIndex, int iChannel, float* p
 	if ((iChannel < 0) || (iChannel >= iChannels))
 		return -1;
 
-	float* pfData = m_pfBuf + (iRecordIndex * iChannels + iChannel) * m_iElementSize;
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getSpectrumPtr(iRecordIndex, iChannel);
+	if (!pfData)
+		return -1;
 
 	assert(pfDest != 0);
 	memcpy(pfDest, pfData, m_iNumDFTCoeffs * 2 * sizeof(float));
 	return 0;
 }
+
+int DAFFTransformerIR2DFT::getDFTCoeffSlice(int iChannel, int iDFTCoeff, float* pfDest) const
+{
+	if (!m_pInputContent)
+		return -1;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iChannel >= 0) && (iChannel < iChannels));
+	assert((iDFTCoeff >= 0) && (iDFTCoeff < m_iNumDFTCoeffs));
+
+	if ((iChannel < 0) || (iChannel >= iChannels))
+		return -1;
+	if ((iDFTCoeff < 0) || (iDFTCoeff >= m_iNumDFTCoeffs))
+		return -1;
+
+	assert(pfDest != 0);
+	std::unique_lock<std::mutex> lock = lockCache();
+	for (int i = 0; i < iRecords; i++) {
+		const float* pfData = getSpectrumPtr(i, iChannel);
+		if (!pfData)
+			return -1;
+
+		pfDest[2 * i + 0] = pfData[2 * iDFTCoeff + 0];
+		pfDest[2 * i + 1] = pfData[2 * iDFTCoeff + 1];
+	}
+	return 0;
+}
+
+int DAFFTransformerIR2DFT::getCoefficientsMP(const int* piRecordIndices, int iNumRecords, int iChannel,
+											 float* pfDest) const
+{
+	if (!m_pInputContent)
+		return -1;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iChannel >= 0) && (iChannel < iChannels));
+
+	if ((iChannel < 0) || (iChannel >= iChannels) || (iNumRecords < 0))
+		return -1;
+	for (int i = 0; i < iNumRecords; i++)
+		if ((piRecordIndices[i] < 0) || (piRecordIndices[i] >= iRecords))
+			return -1;
+
+	assert(pfDest != 0);
+	{
+		std::unique_lock<std::mutex> lock = lockCache();
+		for (int i = 0; i < iNumRecords; i++) {
+			const float* pfData = getSpectrumPtr(piRecordIndices[i], iChannel);
+			if (!pfData)
+				return -1;
+
+			DAFF::cart2polar_float(pfDest + (size_t)i * 2 * m_iNumDFTCoeffs, pfData, m_iNumDFTCoeffs);
+		}
+	}
+	return 0;
+}
+
+int DAFFTransformerIR2DFT::addDFTCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
+{
+	if (!m_pInputContent)
+		return -1;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert((iChannel >= 0) && (iChannel < iChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return -1;
+	if ((iChannel < 0) || (iChannel >= iChannels))
+		return -1;
+
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getSpectrumPtr(iRecordIndex, iChannel);
+	if (!pfData)
+		return -1;
+
+	assert(pfDest != 0);
+	for (int i = 0; i < m_iNumDFTCoeffs * 2; i++)
+		pfDest[i] += pfData[i] * fGain;
+	return 0;
+}
+
+const float* DAFFTransformerIR2DFT::getDFTCoeffsPtr(int iRecordIndex, int iChannel) const
+{
+	if (!m_pInputContent)
+		return 0;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert((iChannel >= 0) && (iChannel < iChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return 0;
+	if ((iChannel < 0) || (iChannel >= iChannels))
+		return 0;
+
+	std::unique_lock<std::mutex> lock = lockCache();
+	return getSpectrumPtr(iRecordIndex, iChannel);
+}
+
+int DAFFTransformerIR2DFT::getRecord(int iRecordIndex, float** ppfChannelDest) const
+{
+	if (!m_pInputContent)
+		return -1;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return -1;
+
+	assert(ppfChannelDest != 0);
+	std::unique_lock<std::mutex> lock = lockCache();
+	for (int c = 0; c < iChannels; c++) {
+		if (!ppfChannelDest[c])
+			continue;
+
+		const float* pfData = getSpectrumPtr(iRecordIndex, c);
+		if (!pfData)
+			return -1;
+
+		memcpy(ppfChannelDest[c], pfData, m_iNumDFTCoeffs * 2 * sizeof(float));
+	}
+	return 0;
+}
+
+int DAFFTransformerIR2DFT::getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const
+{
+	if (!m_pInputContent)
+		return -1;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert(iStride >= 2 * iChannels);
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return -1;
+	if (iStride < 2 * iChannels)
+		return -1;
+
+	assert(pfDest != 0);
+	std::unique_lock<std::mutex> lock = lockCache();
+	for (int c = 0; c < iChannels; c++) {
+		const float* pfData = getSpectrumPtr(iRecordIndex, c);
+		if (!pfData)
+			return -1;
+
+		for (int i = 0; i < m_iNumDFTCoeffs; i++) {
+			pfDest[i * iStride + 2 * c + 0] = pfData[2 * i + 0];
+			pfDest[i * iStride + 2 * c + 1] = pfData[2 * i + 1];
+		}
+	}
+	return 0;
+}
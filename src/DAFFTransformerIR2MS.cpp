@@ -0,0 +1,714 @@
+#include <DAFFTransformerIR2MS.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <system_error>
+#include <thread>
+
+#include "DAFFFFTPlanCache.h"
+#include "DAFFInstrumentationImpl.h"
+#include "DAFFPropertiesImpl.h"
+#include "DAFFRecordCache.h"
+#include "Utils.h"
+
+// Inner content interface realization
+class DAFFContentMSRealization : public DAFFContentMS {
+  public:
+	inline DAFFContentMSRealization(DAFFTransformerIR2MS* pParent, const DAFFContentIR* pInputContent)
+		: m_pParent(pParent), m_pInputContent(pInputContent)
+	{
+		m_oProps = *(pInputContent->getProperties());
+		m_oProps.m_iContentType = DAFF_MAGNITUDE_SPECTRUM;
+		m_oProps.m_iQuantization = DAFF_FLOAT32;
+	};
+
+	inline virtual ~DAFFContentMSRealization() {};
+
+	// --= Interface "DAFFContentMS" =--
+
+	inline int getNumFrequencies() const { return (int)m_pParent->getFrequencies().size(); };
+
+	inline const std::vector<float>& getFrequencies() const { return m_pParent->getFrequencies(); };
+
+	inline float getOverallMagnitudeMaximum() const { return m_pParent->getOverallMagnitudeMaximum(); };
+
+	inline int getMagnitudes(int iRecordIndex, int iChannel, float* pfDest) const
+	{
+		return m_pParent->getMagnitudes(iRecordIndex, iChannel, pfDest);
+	};
+
+	inline int addMagnitudes(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->addMagnitudes(iRecordIndex, iChannel, pfDest, fGain);
+	};
+
+	inline int getRecord(int iRecordIndex, float** ppfChannelDest) const
+	{
+		return m_pParent->getRecord(iRecordIndex, ppfChannelDest);
+	};
+
+	inline int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const
+	{
+		return m_pParent->getRecordInterleaved(iRecordIndex, pfDest, iStride);
+	};
+
+	inline int getMagnitude(int iRecordIndex, int iChannel, int iFreqIndex, float& fMag) const
+	{
+		return m_pParent->getMagnitude(iRecordIndex, iChannel, iFreqIndex, fMag);
+	};
+
+	inline int getMagnitudeSlice(int iChannel, int iFreqIndex, float* pfDest) const
+	{
+		return m_pParent->getMagnitudeSlice(iChannel, iFreqIndex, pfDest);
+	};
+
+	inline const float* getMagnitudesPtr(int iRecordIndex, int iChannel) const
+	{
+		return m_pParent->getMagnitudesPtr(iRecordIndex, iChannel);
+	};
+
+	inline int getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const
+	{
+		return m_pParent->getRecordStatistics(iRecordIndex, iChannel, oStats);
+	};
+
+	// --= Interface "DAFFContent" =--
+
+	// This interface is completely delegated to the input content of the transform
+
+	inline DAFFReader* getParent() const { return m_pInputContent->getParent(); };
+
+	inline const DAFFPropertiesImpl* getProperties() const { return &m_oProps; };
+
+	inline const DAFFMetadata* getRecordMetadata(int iRecordIndex) const
+	{
+		return m_pInputContent->getRecordMetadata(iRecordIndex);
+	};
+
+	inline int getRecordCoords(int iRecordIndex, int iView, float& fAngle1, float& fAngle2) const
+	{
+		return m_pInputContent->getRecordCoords(iRecordIndex, iView, fAngle1, fAngle2);
+	};
+
+	inline void getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex) const
+	{
+		m_pInputContent->getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex);
+	};
+
+	inline void getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex,
+									bool& bOutOfBounds) const
+	{
+		m_pInputContent->getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex, bOutOfBounds);
+	};
+
+	inline void getNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int* piRecordIndices,
+									 bool* pbOutOfBounds, size_t n) const
+	{
+		m_pInputContent->getNearestNeighbours(iView, pfAngles1, pfAngles2, piRecordIndices, pbOutOfBounds, n);
+	};
+
+	inline int getKNearestNeighbours(int iView, float fAngle1, float fAngle2, int k, int* piRecordIndices,
+									 float* pfDistances) const
+	{
+		return m_pInputContent->getKNearestNeighbours(iView, fAngle1, fAngle2, k, piRecordIndices, pfDistances);
+	};
+
+	inline int getKNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int k,
+									 int* piRecordIndices, float* pfDistances, size_t n) const
+	{
+		return m_pInputContent->getKNearestNeighbours(iView, pfAngles1, pfAngles2, k, piRecordIndices, pfDistances,
+													  n);
+	};
+
+	inline int getRecordsInCone(int iView, float fAngle1, float fAngle2, float fRadius,
+								std::vector<int>& viRecordIndices) const
+	{
+		return m_pInputContent->getRecordsInCone(iView, fAngle1, fAngle2, fRadius, viRecordIndices);
+	};
+
+	inline int getRecordsInCone(int iView, const float* pfAngles1, const float* pfAngles2, float fRadius,
+								std::vector<int>& viRecordIndices, std::vector<int>& viOffsets, size_t n) const
+	{
+		return m_pInputContent->getRecordsInCone(iView, pfAngles1, pfAngles2, fRadius, viRecordIndices, viOffsets,
+												 n);
+	};
+
+	inline void getCell(int iView, float fAngle1, float fAngle2, DAFFQuad& qIndices) const
+	{
+		m_pInputContent->getCell(iView, fAngle1, fAngle2, qIndices);
+	};
+
+	inline void transformAnglesD2O(float fAlpha, float fBeta, float& fAzimuth, float& fElevation) const
+	{
+		m_pInputContent->transformAnglesD2O(fAlpha, fBeta, fAzimuth, fElevation);
+	};
+
+	inline void transformAnglesO2D(float fAzimuth, float fElevation, float& fAlpha, float& fBeta) const
+	{
+		m_pInputContent->transformAnglesO2D(fAzimuth, fElevation, fAlpha, fBeta);
+	};
+
+  private:
+	DAFFTransformerIR2MS* m_pParent;
+	const DAFFContentIR* m_pInputContent;
+	DAFFPropertiesImpl m_oProps;
+};
+
+DAFFTransformerIR2MS::DAFFTransformerIR2MS()
+	: m_pInputContent(NULL), m_pOutputContent(NULL), m_vfFrequencies(getThirdOctaveFrequencies()),
+	  m_iMode(DAFF_MS_BANDS), m_iNumThreads(0), m_bLazy(false), m_pCache(new DAFFRecordCache), m_pfBuf(NULL),
+	  m_pfScratch(NULL), m_iElementSize(0), m_fOverallMagnitudePeak(0), m_bPeakKnown(false)
+{
+}
+
+DAFFTransformerIR2MS::DAFFTransformerIR2MS(const DAFFContentIR* pInputContent, bool bTransform)
+	: m_pInputContent(NULL), m_pOutputContent(NULL), m_vfFrequencies(getThirdOctaveFrequencies()),
+	  m_iMode(DAFF_MS_BANDS), m_iNumThreads(0), m_bLazy(false), m_pCache(new DAFFRecordCache), m_pfBuf(NULL),
+	  m_pfScratch(NULL), m_iElementSize(0), m_fOverallMagnitudePeak(0), m_bPeakKnown(false)
+{
+	setInputContent(pInputContent, bTransform);
+}
+
+DAFFTransformerIR2MS::DAFFTransformerIR2MS(const DAFFContentIR* pInputContent, const std::vector<float>& vfFrequencies,
+										   int iMode, bool bTransform)
+	: m_pInputContent(NULL), m_pOutputContent(NULL), m_vfFrequencies(vfFrequencies), m_iMode(iMode),
+	  m_iNumThreads(0), m_bLazy(false), m_pCache(new DAFFRecordCache), m_pfBuf(NULL), m_pfScratch(NULL),
+	  m_iElementSize(0), m_fOverallMagnitudePeak(0), m_bPeakKnown(false)
+{
+	assert(!m_vfFrequencies.empty());
+	setInputContent(pInputContent, bTransform);
+}
+
+DAFFTransformerIR2MS::~DAFFTransformerIR2MS()
+{
+	clear();
+	delete m_pCache;
+}
+
+void DAFFTransformerIR2MS::setInputContent(const DAFFContentIR* pInputContent, bool bTransform)
+{
+	m_pInputContent = pInputContent;
+	if (bTransform)
+		transform();
+}
+
+DAFFContentMS* DAFFTransformerIR2MS::getOutputContent() const
+{
+	return m_pOutputContent;
+}
+
+const std::vector<float>& DAFFTransformerIR2MS::getFrequencies() const
+{
+	return m_vfFrequencies;
+}
+
+void DAFFTransformerIR2MS::setFrequencies(const std::vector<float>& vfFrequencies, bool bTransform)
+{
+	assert(!vfFrequencies.empty());
+
+	// The output content refers to the frequencies
+	clear();
+	m_vfFrequencies = vfFrequencies;
+	if (bTransform)
+		transform();
+}
+
+int DAFFTransformerIR2MS::getMode() const
+{
+	return m_iMode;
+}
+
+void DAFFTransformerIR2MS::setMode(int iMode, bool bTransform)
+{
+	assert((iMode == DAFF_MS_BANDS) || (iMode == DAFF_MS_POINTS));
+	m_iMode = iMode;
+	if (bTransform)
+		transform();
+}
+
+int DAFFTransformerIR2MS::getNumThreads() const
+{
+	return m_iNumThreads;
+}
+
+void DAFFTransformerIR2MS::setNumThreads(int iNumThreads)
+{
+	m_iNumThreads = (iNumThreads > 0 ? iNumThreads : 0);
+}
+
+bool DAFFTransformerIR2MS::isLazy() const
+{
+	return m_bLazy;
+}
+
+void DAFFTransformerIR2MS::setLazy(bool bLazy, bool bTransform)
+{
+	m_bLazy = bLazy;
+	if (bTransform)
+		transform();
+}
+
+size_t DAFFTransformerIR2MS::getLazyCacheSize() const
+{
+	std::lock_guard<std::mutex> lock(m_mxCache);
+	return m_pCache->getMaxSize();
+}
+
+void DAFFTransformerIR2MS::setLazyCacheSize(size_t nMaxBytes)
+{
+	std::lock_guard<std::mutex> lock(m_mxCache);
+	m_pCache->setMaxSize(nMaxBytes);
+}
+
+std::vector<float> DAFFTransformerIR2MS::getThirdOctaveFrequencies()
+{
+	static const float pfFrequencies[31] = { 20,   25,   31.5f, 40,   50,   63,   80,   100,   125,   160,  200,
+											 250,  315,  400,   500,  630,  800,  1000, 1250,  1600,  2000, 2500,
+											 3150, 4000, 5000,  6300, 8000, 10000, 12500, 16000, 20000 };
+	return std::vector<float>(pfFrequencies, pfFrequencies + 31);
+}
+
+std::vector<float> DAFFTransformerIR2MS::getOctaveFrequencies()
+{
+	static const float pfFrequencies[10] = { 31.5f, 63, 125, 250, 500, 1000, 2000, 4000, 8000, 16000 };
+	return std::vector<float>(pfFrequencies, pfFrequencies + 10);
+}
+
+size_t DAFFTransformerIR2MS::getMemoryFootprint() const
+{
+	size_t nBytes = m_vfFrequencies.capacity() * sizeof(float) + m_vfCentreBin.capacity() * sizeof(float) +
+					(m_viBandBegin.capacity() + m_viBandEnd.capacity()) * sizeof(int);
+	if (m_pInputContent && m_pfBuf)
+		nBytes += (size_t)m_pInputContent->getProperties()->getNumberOfRecords() *
+				  m_pInputContent->getProperties()->getNumberOfChannels() * m_iElementSize * sizeof(float);
+	if (m_pfScratch)
+		nBytes += getScratchSize() * sizeof(float);
+
+	std::lock_guard<std::mutex> lock(m_mxCache);
+	return nBytes + m_pCache->getSize();
+}
+
+void DAFFTransformerIR2MS::clear()
+{
+	delete m_pOutputContent;
+	m_pOutputContent = NULL;
+
+	DAFF::free_aligned16(m_pfBuf);
+	m_pfBuf = NULL;
+
+	DAFF::free_aligned16(m_pfScratch);
+	m_pfScratch = NULL;
+
+	m_pCache->clear();
+	m_bPeakKnown = false;
+}
+
+void DAFFTransformerIR2MS::transform()
+{
+	// Discard previous magnitudes
+	clear();
+
+	m_fOverallMagnitudePeak = 0;
+
+	if (!m_pInputContent || m_vfFrequencies.empty())
+		return;
+
+	m_pOutputContent = new DAFFContentMSRealization(this, m_pInputContent);
+	m_iElementSize = (int)m_vfFrequencies.size();
+	initBands();
+
+	// Lazy: magnitudes are computed on first access
+	if (m_bLazy) {
+		m_pfScratch = static_cast<float*>(DAFF::malloc_aligned16(getScratchSize() * sizeof(float)));
+		return;
+	}
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int iFilterLength = m_pInputContent->getFilterLength();
+	int iNumRecordChannels = iRecords * iChannels;
+	m_pfBuf = static_cast<float*>(DAFF::malloc_aligned16((size_t)iNumRecordChannels * m_iElementSize * sizeof(float)));
+
+	// Distribute the record channels over several threads, each transforming a range
+	int iNumThreads = m_iNumThreads;
+	if (iNumThreads <= 0) {
+		const uint64_t ui64MinSamplesPerThread = 1 << 16;
+		uint64_t ui64NumSamples = (uint64_t)iNumRecordChannels * iFilterLength;
+		uint64_t ui64MaxThreads = std::max(ui64NumSamples / ui64MinSamplesPerThread, (uint64_t)1);
+		iNumThreads = (int)std::min((uint64_t)std::max(std::thread::hardware_concurrency(), 1u), ui64MaxThreads);
+	}
+
+	std::vector<std::thread> vThreads;
+	int iChunk = (iNumRecordChannels + iNumThreads - 1) / iNumThreads;
+	std::vector<float> vfPeaks(iNumThreads, 0.0f);
+	for (int i = 1; i * iChunk < iNumRecordChannels; i++) {
+		int iBegin = i * iChunk;
+		int iEnd = std::min(iBegin + iChunk, iNumRecordChannels);
+		try {
+			vThreads.push_back(std::thread(&DAFFTransformerIR2MS::transformRange, this, iBegin, iEnd, &vfPeaks[i]));
+		} catch (const std::system_error&) {
+			transformRange(iBegin, iEnd, &vfPeaks[i]);  // No more threads available
+		}
+	}
+
+	transformRange(0, std::min(iChunk, iNumRecordChannels), &vfPeaks[0]);
+
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	for (size_t i = 0; i < vfPeaks.size(); i++)
+		m_fOverallMagnitudePeak = (std::max)(m_fOverallMagnitudePeak, vfPeaks[i]);
+	m_bPeakKnown = true;
+}
+
+void DAFFTransformerIR2MS::initBands()
+{
+	int iFilterLength = m_pInputContent->getFilterLength();
+	int iNumBins = iFilterLength / 2 + 1;
+	double dBinWidth = m_pInputContent->getSamplerate() / iFilterLength;
+	int n = (int)m_vfFrequencies.size();
+
+	// Band edges at the geometric means of neighbouring frequencies, outer edges mirrored (one octave for n = 1)
+	std::vector<double> vdEdges(n + 1);
+	for (int i = 1; i < n; i++)
+		vdEdges[i] = std::sqrt((double)m_vfFrequencies[i - 1] * m_vfFrequencies[i]);
+	vdEdges[0] = (n > 1 ? (double)m_vfFrequencies[0] * m_vfFrequencies[0] / vdEdges[1]
+						: m_vfFrequencies[0] / std::sqrt(2.0));
+	vdEdges[n] = (n > 1 ? (double)m_vfFrequencies[n - 1] * m_vfFrequencies[n - 1] / vdEdges[n - 1]
+						: m_vfFrequencies[0] * std::sqrt(2.0));
+
+	m_viBandBegin.resize(n);
+	m_viBandEnd.resize(n);
+	m_vfCentreBin.resize(n);
+	for (int i = 0; i < n; i++) {
+		m_viBandBegin[i] = (int)std::min(std::max(std::ceil(vdEdges[i] / dBinWidth), 0.0), (double)iNumBins);
+		m_viBandEnd[i] = (int)std::min(std::max(std::ceil(vdEdges[i + 1] / dBinWidth), 0.0), (double)iNumBins);
+		m_vfCentreBin[i] = (float)std::min(std::max(m_vfFrequencies[i] / dBinWidth, 0.0), (double)(iNumBins - 1));
+	}
+}
+
+size_t DAFFTransformerIR2MS::getScratchSize() const
+{
+	int iFilterLength = m_pInputContent->getFilterLength();
+	return (size_t)((iFilterLength + 3) / 4 * 4) + 2 * (size_t)(iFilterLength / 2 + 1);
+}
+
+float DAFFTransformerIR2MS::transformMagnitudes(int iRecordIndex, int iChannel, float* pfScratch, float* pfDest,
+												 DAFFFFTPlanState& oState) const
+{
+	int iFilterLength = m_pInputContent->getFilterLength();
+	int iNumBins = iFilterLength / 2 + 1;
+	float* pfInput = pfScratch;
+	float* pfSpectrum = pfScratch + (iFilterLength + 3) / 4 * 4;
+
+	// Fetch input data and transform into frequency-domain
+	m_pInputContent->getFilterCoeffs(iRecordIndex, iChannel, pfInput);
+	DAFFFFTPlanCache::execute(iFilterLength, pfInput, pfSpectrum, oState);
+
+	// Squared magnitudes (in place)
+	for (int k = 0; k < iNumBins; k++)
+		pfSpectrum[k] = pfSpectrum[2 * k] * pfSpectrum[2 * k] + pfSpectrum[2 * k + 1] * pfSpectrum[2 * k + 1];
+
+	float fPeak = 0;
+	for (int i = 0; i < m_iElementSize; i++) {
+		if ((m_iMode == DAFF_MS_BANDS) && (m_viBandEnd[i] > m_viBandBegin[i])) {
+			// Energetic mean over the band
+			double dSum = 0;
+			for (int k = m_viBandBegin[i]; k < m_viBandEnd[i]; k++)
+				dSum += pfSpectrum[k];
+			pfDest[i] = (float)std::sqrt(dSum / (m_viBandEnd[i] - m_viBandBegin[i]));
+		} else {
+			// Linear interpolation of the magnitudes
+			int k = std::min((int)m_vfCentreBin[i], iNumBins - 1);
+			int l = std::min(k + 1, iNumBins - 1);
+			float t = m_vfCentreBin[i] - k;
+			pfDest[i] = (1 - t) * std::sqrt(pfSpectrum[k]) + t * std::sqrt(pfSpectrum[l]);
+		}
+
+		fPeak = (std::max)(fPeak, pfDest[i]);
+	}
+
+	return fPeak;
+}
+
+void DAFFTransformerIR2MS::transformRange(int iBegin, int iEnd, float* pfPeak)
+{
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	float* pfScratch = static_cast<float*>(DAFF::malloc_aligned16(getScratchSize() * sizeof(float)));
+
+	DAFFFFTPlanState oState;
+	float fPeak = 0;
+	for (int n = iBegin; n < iEnd; n++)
+		fPeak = (std::max)(fPeak, transformMagnitudes(n / iChannels, n % iChannels, pfScratch,
+													   m_pfBuf + (size_t)n * m_iElementSize, oState));
+
+	DAFF::free_aligned16(pfScratch);
+
+	*pfPeak = fPeak;
+}
+
+std::unique_lock<std::mutex> DAFFTransformerIR2MS::lockCache() const
+{
+	if (m_bLazy)
+		return std::unique_lock<std::mutex>(m_mxCache);
+	return std::unique_lock<std::mutex>();
+}
+
+const float* DAFFTransformerIR2MS::getMagnitudesPtrLocked(int iRecordIndex, int iChannel) const
+{
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int64_t iKey = (int64_t)iRecordIndex * iChannels + iChannel;
+	if (!m_bLazy)
+		return m_pfBuf + iKey * m_iElementSize;
+
+	float* pfData = static_cast<float*>(m_pCache->find(iKey));
+	DAFF_INSTRUMENT_COUNT(pfData ? DAFF_COUNTER_TRANSFORMER_CACHE_HITS : DAFF_COUNTER_TRANSFORMER_CACHE_MISSES, 1);
+	if (pfData)
+		return pfData;
+
+	pfData = static_cast<float*>(m_pCache->insert(iKey, m_iElementSize * sizeof(float)));
+	if (pfData == NULL)
+		return NULL;
+
+	DAFFFFTPlanState oState;
+	transformMagnitudes(iRecordIndex, iChannel, m_pfScratch, pfData, oState);
+
+	return pfData;
+}
+
+float DAFFTransformerIR2MS::getOverallMagnitudeMaximum() const
+{
+	std::unique_lock<std::mutex> lock = lockCache();
+
+	// Lazy: all records have to be transformed once (without caching them)
+	if (!m_bPeakKnown && m_pOutputContent) {
+		int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+		int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+		std::vector<float> vfMagnitudes(m_iElementSize);
+
+		DAFFFFTPlanState oState;
+		float fPeak = 0;
+		for (int n = 0; n < iRecords * iChannels; n++)
+			fPeak = (std::max)(fPeak, transformMagnitudes(n / iChannels, n % iChannels, m_pfScratch,
+														   &vfMagnitudes[0], oState));
+
+		m_fOverallMagnitudePeak = fPeak;
+		m_bPeakKnown = true;
+	}
+
+	return m_fOverallMagnitudePeak;
+}
+
+int DAFFTransformerIR2MS::getMagnitudes(int iRecordIndex, int iChannel, float* pfDest) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert((iChannel >= 0) && (iChannel < iChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords) || (iChannel < 0) || (iChannel >= iChannels))
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getMagnitudesPtrLocked(iRecordIndex, iChannel);
+	if (!pfData)
+		return DAFF_MODAL_ERROR;
+
+	memcpy(pfDest, pfData, m_iElementSize * sizeof(float));
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2MS::addMagnitudes(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert((iChannel >= 0) && (iChannel < iChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords) || (iChannel < 0) || (iChannel >= iChannels))
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getMagnitudesPtrLocked(iRecordIndex, iChannel);
+	if (!pfData)
+		return DAFF_MODAL_ERROR;
+
+	for (int i = 0; i < m_iElementSize; i++)
+		pfDest[i] += pfData[i] * fGain;
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2MS::getRecord(int iRecordIndex, float** ppfChannelDest) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return DAFF_INVALID_INDEX;
+
+	assert(ppfChannelDest != 0);
+	std::unique_lock<std::mutex> lock = lockCache();
+	for (int c = 0; c < iChannels; c++) {
+		if (!ppfChannelDest[c])
+			continue;
+
+		const float* pfData = getMagnitudesPtrLocked(iRecordIndex, c);
+		if (!pfData)
+			return DAFF_MODAL_ERROR;
+
+		memcpy(ppfChannelDest[c], pfData, m_iElementSize * sizeof(float));
+	}
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2MS::getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert(iStride >= iChannels);
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return DAFF_INVALID_INDEX;
+	if (iStride < iChannels)
+		return DAFF_MODAL_ERROR;
+
+	assert(pfDest != 0);
+	std::unique_lock<std::mutex> lock = lockCache();
+	for (int c = 0; c < iChannels; c++) {
+		const float* pfData = getMagnitudesPtrLocked(iRecordIndex, c);
+		if (!pfData)
+			return DAFF_MODAL_ERROR;
+
+		for (int i = 0; i < m_iElementSize; i++)
+			pfDest[i * iStride + c] = pfData[i];
+	}
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2MS::getMagnitude(int iRecordIndex, int iChannel, int iFreqIndex, float& fMag) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert((iChannel >= 0) && (iChannel < iChannels));
+	assert((iFreqIndex >= 0) && (iFreqIndex < m_iElementSize));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords) || (iChannel < 0) || (iChannel >= iChannels) ||
+		(iFreqIndex < 0) || (iFreqIndex >= m_iElementSize))
+		return DAFF_INVALID_INDEX;
+
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getMagnitudesPtrLocked(iRecordIndex, iChannel);
+	if (!pfData)
+		return DAFF_MODAL_ERROR;
+
+	fMag = pfData[iFreqIndex];
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2MS::getMagnitudeSlice(int iChannel, int iFreqIndex, float* pfDest) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iChannel >= 0) && (iChannel < iChannels));
+	assert((iFreqIndex >= 0) && (iFreqIndex < m_iElementSize));
+
+	if ((iChannel < 0) || (iChannel >= iChannels) || (iFreqIndex < 0) || (iFreqIndex >= m_iElementSize))
+		return DAFF_INVALID_INDEX;
+
+	assert(pfDest != 0);
+	std::unique_lock<std::mutex> lock = lockCache();
+	for (int i = 0; i < iRecords; i++) {
+		const float* pfData = getMagnitudesPtrLocked(i, iChannel);
+		if (!pfData)
+			return DAFF_MODAL_ERROR;
+
+		pfDest[i] = pfData[iFreqIndex];
+	}
+	return DAFF_NO_ERROR;
+}
+
+const float* DAFFTransformerIR2MS::getMagnitudesPtr(int iRecordIndex, int iChannel) const
+{
+	if (!m_pOutputContent)
+		return NULL;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords) || (iChannel < 0) || (iChannel >= iChannels))
+		return NULL;
+
+	std::unique_lock<std::mutex> lock = lockCache();
+	return getMagnitudesPtrLocked(iRecordIndex, iChannel);
+}
+
+int DAFFTransformerIR2MS::getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords) || (iChannel < 0) || (iChannel >= iChannels))
+		return DAFF_INVALID_INDEX;
+
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getMagnitudesPtrLocked(iRecordIndex, iChannel);
+	if (!pfData)
+		return DAFF_MODAL_ERROR;
+
+	// Same definitions as for stored magnitude spectra (see DAFFContentMS::getRecordStatistics)
+	double dEnergy = 0;
+	oStats.fPeak = 0;
+	for (int i = 0; i < m_iElementSize; i++) {
+		oStats.fPeak = (std::max)(oStats.fPeak, pfData[i]);
+		dEnergy += (double)pfData[i] * pfData[i];
+	}
+	oStats.fEnergy = (float)dEnergy;
+	oStats.fRMS = (float)std::sqrt(dEnergy / m_iElementSize);
+
+	oStats.iOnset = -1;
+	for (int i = 0; (i < m_iElementSize) && (oStats.fPeak > 0); i++) {
+		if (pfData[i] >= 0.1f * oStats.fPeak) {
+			oStats.iOnset = i;
+			break;
+		}
+	}
+
+	return DAFF_NO_ERROR;
+}
@@ -0,0 +1,853 @@
+#include <DAFFTransformerIR2MinPhase.h>
+
+#include <DAFFFilterCrossfader.h>
+#include <DAFFInterpolator.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <system_error>
+#include <thread>
+
+#include "DAFFFFTPlanCache.h"
+#include "DAFFPropertiesImpl.h"
+#include "Utils.h"
+
+//! Signature of minimum-phase cache files
+static const char DAFF_MINPHASE_SIGNATURE[4] = { 'D', 'M', 'P', 'C' };
+
+//! Version of the minimum-phase cache file format
+static const int DAFF_MINPHASE_VERSION = 1;
+
+// Inner content interface realization
+class DAFFContentIRMinPhaseRealization : public DAFFContentIR {
+  public:
+	inline DAFFContentIRMinPhaseRealization(DAFFTransformerIR2MinPhase* pParent, const DAFFContentIR* pInputContent)
+		: m_pParent(pParent), m_pInputContent(pInputContent)
+	{
+		m_oProps = *(pInputContent->getProperties());
+		m_oProps.m_iQuantization = DAFF_FLOAT32;
+	};
+
+	inline virtual ~DAFFContentIRMinPhaseRealization() {};
+
+	// --= Interface "DAFFContentIR" =--
+
+	inline double getSamplerate() const { return m_pInputContent->getSamplerate(); };
+
+	inline int getFilterLength() const { return m_pParent->m_iLength; };
+
+	inline int getFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFilterCoeffs(iRecordIndex, iChannel, pfDest, fGain);
+	};
+
+	inline int getFilterCoeff(int iRecordIndex, int iChannel, int iSample, float& fCoeff) const
+	{
+		return m_pParent->getFilterCoeff(iRecordIndex, iChannel, iSample, fCoeff);
+	};
+
+	inline int addFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->addFilterCoeffs(iRecordIndex, iChannel, pfDest, fGain);
+	};
+
+	inline int getFilterCoeffsQ15(int iRecordIndex, int iChannel, int16_t* piDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFixedPointFilterCoeffs(iRecordIndex, iChannel, piDest, NULL, fGain, false);
+	};
+
+	inline int getFilterCoeffsQ31(int iRecordIndex, int iChannel, int32_t* piDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFixedPointFilterCoeffs(iRecordIndex, iChannel, NULL, piDest, fGain, false);
+	};
+
+	inline int addFilterCoeffsQ15(int iRecordIndex, int iChannel, int16_t* piDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFixedPointFilterCoeffs(iRecordIndex, iChannel, piDest, NULL, fGain, true);
+	};
+
+	inline int addFilterCoeffsQ31(int iRecordIndex, int iChannel, int32_t* piDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFixedPointFilterCoeffs(iRecordIndex, iChannel, NULL, piDest, fGain, true);
+	};
+
+	inline int getRecord(int iRecordIndex, float** ppfChannelDest) const
+	{
+		return m_pParent->getRecord(iRecordIndex, ppfChannelDest);
+	};
+
+	inline int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const
+	{
+		return m_pParent->getRecordInterleaved(iRecordIndex, pfDest, iStride);
+	};
+
+	// The minimum-phase filters start at the first coefficient and are stored completely
+
+	inline int getMinEffectiveFilterOffset() const { return 0; };
+
+	inline int getMaxEffectiveFilterLength() const { return m_pParent->m_iLength; };
+
+	inline int getEffectiveFilterBounds(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const
+	{
+		if (!m_pParent->getFilterPtr(iRecordIndex, iChannel))
+			return DAFF_INVALID_INDEX;
+
+		iOffset = 0;
+		iLength = m_pParent->m_iLength;
+		return DAFF_NO_ERROR;
+	};
+
+	inline int getEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFilterCoeffs(iRecordIndex, iChannel, pfDest, fGain);
+	};
+
+	inline int getFilterCoeffsTruncated(int iRecordIndex, int iChannel, float* pfDest, int& iLength,
+										float fGain = 1.0F) const
+	{
+		int iError = m_pParent->getFilterCoeffs(iRecordIndex, iChannel, pfDest, fGain);
+		if (iError == DAFF_NO_ERROR)
+			iLength = m_pParent->m_iLength;
+		return iError;
+	};
+
+	inline int getMaxTruncatedFilterLength() const { return m_pParent->m_iLength; };
+
+	inline int addEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->addFilterCoeffs(iRecordIndex, iChannel, pfDest, fGain);
+	};
+
+	inline const float* getEffectiveFilterCoeffsPtr(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const
+	{
+		iOffset = 0;
+		iLength = m_pParent->m_iLength;
+		return m_pParent->getFilterPtr(iRecordIndex, iChannel);
+	};
+
+	inline int getFilterEnvelope(int iRecordIndex, int iChannel, int iFirstSample, int iNumSamples, int iNumBins,
+								 float* pfMin, float* pfMax) const
+	{
+		return m_pParent->getFilterEnvelope(iRecordIndex, iChannel, iFirstSample, iNumSamples, iNumBins, pfMin, pfMax);
+	};
+
+	inline float getOverallPeak() const { return m_pParent->m_fOverallPeak; };
+
+	inline float getChannelPeak(int iChannel) const { return m_pParent->getChannelPeak(iChannel); };
+
+	inline float getRecordPeak(int iRecordIndex, int iChannel) const
+	{
+		return m_pParent->getRecordPeak(iRecordIndex, iChannel);
+	};
+
+	inline int getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const
+	{
+		return m_pParent->getRecordStatistics(iRecordIndex, iChannel, oStats);
+	};
+
+	// --= Interface "DAFFContent" =--
+
+	// This interface is completely delegated to the input content of the transform
+
+	inline DAFFReader* getParent() const { return m_pInputContent->getParent(); };
+
+	inline const DAFFPropertiesImpl* getProperties() const { return &m_oProps; };
+
+	inline const DAFFMetadata* getRecordMetadata(int iRecordIndex) const
+	{
+		return m_pInputContent->getRecordMetadata(iRecordIndex);
+	};
+
+	inline int getRecordCoords(int iRecordIndex, int iView, float& fAngle1, float& fAngle2) const
+	{
+		return m_pInputContent->getRecordCoords(iRecordIndex, iView, fAngle1, fAngle2);
+	};
+
+	inline void getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex) const
+	{
+		m_pInputContent->getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex);
+	};
+
+	inline void getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex,
+									bool& bOutOfBounds) const
+	{
+		m_pInputContent->getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex, bOutOfBounds);
+	};
+
+	inline void getNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int* piRecordIndices,
+									 bool* pbOutOfBounds, size_t n) const
+	{
+		m_pInputContent->getNearestNeighbours(iView, pfAngles1, pfAngles2, piRecordIndices, pbOutOfBounds, n);
+	};
+
+	inline int getKNearestNeighbours(int iView, float fAngle1, float fAngle2, int k, int* piRecordIndices,
+									 float* pfDistances) const
+	{
+		return m_pInputContent->getKNearestNeighbours(iView, fAngle1, fAngle2, k, piRecordIndices, pfDistances);
+	};
+
+	inline int getKNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int k,
+									 int* piRecordIndices, float* pfDistances, size_t n) const
+	{
+		return m_pInputContent->getKNearestNeighbours(iView, pfAngles1, pfAngles2, k, piRecordIndices, pfDistances,
+													  n);
+	};
+
+	inline int getRecordsInCone(int iView, float fAngle1, float fAngle2, float fRadius,
+								std::vector<int>& viRecordIndices) const
+	{
+		return m_pInputContent->getRecordsInCone(iView, fAngle1, fAngle2, fRadius, viRecordIndices);
+	};
+
+	inline int getRecordsInCone(int iView, const float* pfAngles1, const float* pfAngles2, float fRadius,
+								std::vector<int>& viRecordIndices, std::vector<int>& viOffsets, size_t n) const
+	{
+		return m_pInputContent->getRecordsInCone(iView, pfAngles1, pfAngles2, fRadius, viRecordIndices, viOffsets,
+												 n);
+	};
+
+	inline void getCell(int iView, float fAngle1, float fAngle2, DAFFQuad& qIndices) const
+	{
+		m_pInputContent->getCell(iView, fAngle1, fAngle2, qIndices);
+	};
+
+	inline void transformAnglesD2O(float fAlpha, float fBeta, float& fAzimuth, float& fElevation) const
+	{
+		m_pInputContent->transformAnglesD2O(fAlpha, fBeta, fAzimuth, fElevation);
+	};
+
+	inline void transformAnglesO2D(float fAzimuth, float fElevation, float& fAlpha, float& fBeta) const
+	{
+		m_pInputContent->transformAnglesO2D(fAzimuth, fElevation, fAlpha, fBeta);
+	};
+
+  private:
+	DAFFTransformerIR2MinPhase* m_pParent;
+	const DAFFContentIR* m_pInputContent;
+	DAFFPropertiesImpl m_oProps;
+};
+
+DAFFTransformerIR2MinPhase::DAFFTransformerIR2MinPhase()
+	: m_pInputContent(NULL), m_pOutputContent(NULL), m_pInterpolator(NULL), m_pCrossfader(NULL),
+	  m_iMinPhaseLength(0), m_fOnsetThreshold(0.1f), m_iNumThreads(0), m_iLength(0), m_iStride(0), m_pfBuf(NULL),
+	  m_fOverallPeak(0)
+{
+}
+
+DAFFTransformerIR2MinPhase::DAFFTransformerIR2MinPhase(const DAFFContentIR* pInputContent, int iMinPhaseLength,
+													   bool bTransform)
+	: m_pInputContent(NULL), m_pOutputContent(NULL), m_pInterpolator(NULL), m_pCrossfader(NULL),
+	  m_iMinPhaseLength(std::max(iMinPhaseLength, 0)), m_fOnsetThreshold(0.1f), m_iNumThreads(0), m_iLength(0),
+	  m_iStride(0), m_pfBuf(NULL), m_fOverallPeak(0)
+{
+	setInputContent(pInputContent, bTransform);
+}
+
+DAFFTransformerIR2MinPhase::~DAFFTransformerIR2MinPhase()
+{
+	clear();
+}
+
+const DAFFContentIR* DAFFTransformerIR2MinPhase::getInputContent() const
+{
+	return m_pInputContent;
+}
+
+void DAFFTransformerIR2MinPhase::setInputContent(const DAFFContentIR* pInputContent, bool bTransform)
+{
+	m_pInputContent = pInputContent;
+	if (bTransform)
+		transform();
+}
+
+DAFFContentIR* DAFFTransformerIR2MinPhase::getOutputContent() const
+{
+	return m_pOutputContent;
+}
+
+int DAFFTransformerIR2MinPhase::getMinPhaseLength() const
+{
+	if (m_pOutputContent)
+		return m_iLength;
+	if (m_iMinPhaseLength == 0 && m_pInputContent)
+		return m_pInputContent->getFilterLength();
+	return m_iMinPhaseLength;
+}
+
+void DAFFTransformerIR2MinPhase::setMinPhaseLength(int iMinPhaseLength, bool bTransform)
+{
+	m_iMinPhaseLength = std::max(iMinPhaseLength, 0);
+	if (bTransform)
+		transform();
+}
+
+float DAFFTransformerIR2MinPhase::getOnsetThreshold() const
+{
+	return m_fOnsetThreshold;
+}
+
+void DAFFTransformerIR2MinPhase::setOnsetThreshold(float fThreshold, bool bTransform)
+{
+	assert((fThreshold > 0) && (fThreshold <= 1));
+	m_fOnsetThreshold = fThreshold;
+	if (bTransform)
+		transform();
+}
+
+int DAFFTransformerIR2MinPhase::getNumThreads() const
+{
+	return m_iNumThreads;
+}
+
+void DAFFTransformerIR2MinPhase::setNumThreads(int iNumThreads)
+{
+	m_iNumThreads = (iNumThreads > 0 ? iNumThreads : 0);
+}
+
+size_t DAFFTransformerIR2MinPhase::getMemoryFootprint() const
+{
+	size_t nBytes = (m_vfDelays.capacity() + m_vfPeaks.capacity() + m_vfChannelPeaks.capacity()) * sizeof(float);
+	if (m_pInputContent && m_pfBuf)
+		nBytes += (size_t)m_pInputContent->getProperties()->getNumberOfRecords() *
+				  m_pInputContent->getProperties()->getNumberOfChannels() * m_iStride * sizeof(float);
+	return nBytes;
+}
+
+void DAFFTransformerIR2MinPhase::clear()
+{
+	delete m_pCrossfader;
+	m_pCrossfader = NULL;
+
+	delete m_pInterpolator;
+	m_pInterpolator = NULL;
+
+	delete m_pOutputContent;
+	m_pOutputContent = NULL;
+
+	DAFF::free_aligned16(m_pfBuf);
+	m_pfBuf = NULL;
+
+	m_vfDelays.clear();
+	m_vfPeaks.clear();
+	m_vfChannelPeaks.clear();
+	m_fOverallPeak = 0;
+	m_iLength = 0;
+}
+
+int DAFFTransformerIR2MinPhase::getTransformSize() const
+{
+	int iSize = 1;
+	while (iSize < m_pInputContent->getFilterLength())
+		iSize *= 2;
+	return 4 * iSize;
+}
+
+bool DAFFTransformerIR2MinPhase::init(int iLength)
+{
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	size_t nNumRecordChannels = (size_t)iRecords * iChannels;
+
+	// Filters are 16-byte aligned
+	m_iLength = iLength;
+	m_iStride = (iLength + 3) / 4 * 4;
+	size_t nBytes = nNumRecordChannels * m_iStride * sizeof(float);
+	m_pfBuf = static_cast<float*>(DAFF::malloc_aligned16(nBytes));
+	if (!m_pfBuf)
+		return false;
+	memset(m_pfBuf, 0, nBytes);
+
+	m_vfDelays.assign(nNumRecordChannels, 0.0f);
+	m_pOutputContent = new DAFFContentIRMinPhaseRealization(this, m_pInputContent);
+	m_pInterpolator = new DAFFInterpolator(m_pOutputContent);
+	m_pCrossfader = new DAFFFilterCrossfader(m_pOutputContent);
+	return true;
+}
+
+void DAFFTransformerIR2MinPhase::transform()
+{
+	// Discard previous filters
+	clear();
+
+	if (!m_pInputContent)
+		return;
+
+	int iFilterLength = m_pInputContent->getFilterLength();
+	int iLength = (m_iMinPhaseLength > 0 ? std::min(m_iMinPhaseLength, iFilterLength) : iFilterLength);
+	if (!init(iLength)) {
+		clear();
+		return;
+	}
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int iNumRecordChannels = iRecords * iChannels;
+
+	// Distribute the record channels over several threads, each transforming a range
+	int iNumThreads = m_iNumThreads;
+	if (iNumThreads <= 0) {
+		const uint64_t ui64MinSamplesPerThread = 1 << 16;
+		uint64_t ui64NumSamples = (uint64_t)iNumRecordChannels * getTransformSize();
+		uint64_t ui64MaxThreads = std::max(ui64NumSamples / ui64MinSamplesPerThread, (uint64_t)1);
+		iNumThreads = (int)std::min((uint64_t)std::max(std::thread::hardware_concurrency(), 1u), ui64MaxThreads);
+	}
+
+	std::vector<std::thread> vThreads;
+	int iChunk = (iNumRecordChannels + iNumThreads - 1) / iNumThreads;
+	for (int iBegin = iChunk; iBegin < iNumRecordChannels; iBegin += iChunk) {
+		int iEnd = std::min(iBegin + iChunk, iNumRecordChannels);
+		try {
+			vThreads.push_back(std::thread(&DAFFTransformerIR2MinPhase::transformRange, this, iBegin, iEnd));
+		} catch (const std::system_error&) {
+			transformRange(iBegin, iEnd);  // No more threads available
+		}
+	}
+
+	transformRange(0, std::min(iChunk, iNumRecordChannels));
+
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	initPeaks();
+}
+
+void DAFFTransformerIR2MinPhase::initPeaks()
+{
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	size_t nNumRecordChannels = m_vfDelays.size();
+
+	m_vfPeaks.resize(nNumRecordChannels);
+	m_vfChannelPeaks.assign(iChannels, 0.0f);
+	m_fOverallPeak = 0;
+	for (size_t i = 0; i < nNumRecordChannels; i++) {
+		m_vfPeaks[i] = DAFF::peak_float(m_pfBuf + i * m_iStride, m_iLength);
+		m_vfChannelPeaks[i % iChannels] = std::max(m_vfChannelPeaks[i % iChannels], m_vfPeaks[i]);
+		m_fOverallPeak = std::max(m_fOverallPeak, m_vfPeaks[i]);
+	}
+}
+
+void DAFFTransformerIR2MinPhase::transformRange(int iBegin, int iEnd)
+{
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int iFilterLength = m_pInputContent->getFilterLength();
+	int iSize = getTransformSize();
+	int iNumBins = iSize / 2 + 1;
+	float fScale = 1.0f / iSize;
+
+	float* pfSignal = static_cast<float*>(DAFF::malloc_aligned16(iSize * sizeof(float)));
+	float* pfSpectrum = static_cast<float*>(DAFF::malloc_aligned16(2 * iNumBins * sizeof(float)));
+
+	DAFFFFTPlanState oForward, oInverse;
+	for (int n = iBegin; n < iEnd; n++) {
+		float* pfDest = m_pfBuf + (size_t)n * m_iStride;
+
+		m_pInputContent->getFilterCoeffs(n / iChannels, n % iChannels, pfSignal);
+		memset(pfSignal + iFilterLength, 0, (iSize - iFilterLength) * sizeof(float));
+		float fOnset = getOnset(pfSignal, iFilterLength, m_fOnsetThreshold);
+
+		DAFFFFTPlanCache::execute(iSize, pfSignal, pfSpectrum, oForward);
+
+		float fMaxSquared = 0;
+		for (int k = 0; k < iNumBins; k++) {
+			pfSpectrum[k] = pfSpectrum[2 * k] * pfSpectrum[2 * k] + pfSpectrum[2 * k + 1] * pfSpectrum[2 * k + 1];
+			fMaxSquared = std::max(fMaxSquared, pfSpectrum[k]);
+		}
+
+		if (fMaxSquared == 0)
+			continue;  // All zero
+
+		// Real cepstrum of the logarithmic magnitudes (limited to -120 dB of the maximum)
+		float fFloor = fMaxSquared * 1e-12f;
+		for (int k = iNumBins - 1; k >= 0; k--) {
+			pfSpectrum[2 * k] = 0.5f * std::log(std::max(pfSpectrum[k], fFloor));
+			pfSpectrum[2 * k + 1] = 0;
+		}
+		DAFFFFTPlanCache::executeInverse(iSize, pfSpectrum, pfSignal, oInverse);
+
+		// Fold the anti-causal part onto the causal part
+		pfSignal[0] *= fScale;
+		for (int i = 1; i < iSize / 2; i++)
+			pfSignal[i] *= 2 * fScale;
+		pfSignal[iSize / 2] *= fScale;
+		memset(pfSignal + iSize / 2 + 1, 0, (iSize / 2 - 1) * sizeof(float));
+
+		// Minimum-phase spectrum (complex exponential) and impulse response
+		DAFFFFTPlanCache::execute(iSize, pfSignal, pfSpectrum, oForward);
+		for (int k = 0; k < iNumBins; k++) {
+			float fMagnitude = std::exp(pfSpectrum[2 * k]);
+			float fPhase = pfSpectrum[2 * k + 1];
+			pfSpectrum[2 * k] = fMagnitude * std::cos(fPhase);
+			pfSpectrum[2 * k + 1] = fMagnitude * std::sin(fPhase);
+		}
+		DAFFFFTPlanCache::executeInverse(iSize, pfSpectrum, pfSignal, oInverse);
+
+		for (int i = 0; i < m_iLength; i++)
+			pfDest[i] = pfSignal[i] * fScale;
+
+		m_vfDelays[n] = std::max(fOnset - getOnset(pfDest, m_iLength, m_fOnsetThreshold), 0.0f);
+	}
+
+	DAFF::free_aligned16(pfSignal);
+	DAFF::free_aligned16(pfSpectrum);
+}
+
+float DAFFTransformerIR2MinPhase::getOnset(const float* pfData, int iLength, float fThreshold)
+{
+	float fPeak = DAFF::peak_float(pfData, iLength);
+	if (fPeak == 0)
+		return 0;
+
+	float fLevel = fThreshold * fPeak;
+	for (int i = 0; i < iLength; i++) {
+		float fValue = std::fabs(pfData[i]);
+		if (fValue < fLevel)
+			continue;
+
+		if (i == 0)
+			return 0;
+
+		// Linear interpolation between the last value below and the first value reaching the level
+		float fPrevious = std::fabs(pfData[i - 1]);
+		return (i - 1) + (fLevel - fPrevious) / (fValue - fPrevious);
+	}
+
+	return 0;
+}
+
+const float* DAFFTransformerIR2MinPhase::getFilterPtr(int iRecordIndex, int iChannel) const
+{
+	if (!m_pOutputContent)
+		return NULL;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords) || (iChannel < 0) || (iChannel >= iChannels))
+		return NULL;
+
+	return m_pfBuf + ((size_t)iRecordIndex * iChannels + iChannel) * m_iStride;
+}
+
+int DAFFTransformerIR2MinPhase::getDelay(int iRecordIndex, int iChannel, float& fDelay) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	if (!getFilterPtr(iRecordIndex, iChannel))
+		return DAFF_INVALID_INDEX;
+
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	fDelay = m_vfDelays[(size_t)iRecordIndex * iChannels + iChannel];
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2MinPhase::interpolate(int iView, float fAngle1Deg, float fAngle2Deg, int iChannel,
+											float* pfDest, float& fDelay) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	DAFFQuad qIndices;
+	float pfWeights[4];
+	int iError = m_pInterpolator->getWeights(iView, fAngle1Deg, fAngle2Deg, qIndices, pfWeights);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	iError = m_pCrossfader->blend(qIndices, pfWeights, iChannel, pfDest);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	// Delays are blended with the same weights
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int piIndices[4] = { qIndices.iIndex1, qIndices.iIndex2, qIndices.iIndex3, qIndices.iIndex4 };
+	fDelay = 0;
+	for (int i = 0; i < 4; i++)
+		fDelay += pfWeights[i] * m_vfDelays[(size_t)piIndices[i] * iChannels + iChannel];
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2MinPhase::save(const std::string& sFilePath) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	FILE* pFile = fopen(sFilePath.c_str(), "wb");
+	if (pFile == NULL)
+		return DAFF_FILE_NOT_FOUND;
+
+	// Header and data in little endian
+	int piHeader[7];
+	piHeader[0] = DAFF_MINPHASE_VERSION;
+	piHeader[1] = m_pInputContent->getProperties()->getNumberOfRecords();
+	piHeader[2] = m_pInputContent->getProperties()->getNumberOfChannels();
+	piHeader[3] = m_pInputContent->getFilterLength();
+	piHeader[4] = m_iLength;
+	float pfHeader[2] = { m_fOnsetThreshold, (float)m_pInputContent->getSamplerate() };
+	DAFF::le2se_4byte(piHeader, 7);
+	DAFF::le2se_4byte(pfHeader, 2);
+
+	bool bSuccess = (fwrite(DAFF_MINPHASE_SIGNATURE, 1, 4, pFile) == 4) && (fwrite(piHeader, 4, 7, pFile) == 7) &&
+					(fwrite(pfHeader, 4, 2, pFile) == 2);
+
+	std::vector<float> vfData(m_vfDelays);
+	DAFF::le2se_4byte(&vfData[0], vfData.size());
+	bSuccess = bSuccess && (fwrite(&vfData[0], 4, vfData.size(), pFile) == vfData.size());
+
+	vfData.resize(m_iLength);
+	for (size_t i = 0; bSuccess && (i < m_vfDelays.size()); i++) {
+		memcpy(&vfData[0], m_pfBuf + i * m_iStride, m_iLength * sizeof(float));
+		DAFF::le2se_4byte(&vfData[0], m_iLength);
+		bSuccess = (fwrite(&vfData[0], 4, m_iLength, pFile) == (size_t)m_iLength);
+	}
+
+	bSuccess = (fclose(pFile) == 0) && bSuccess;
+	return (bSuccess ? DAFF_NO_ERROR : DAFF_FILE_NOT_FOUND);
+}
+
+int DAFFTransformerIR2MinPhase::load(const std::string& sFilePath)
+{
+	clear();
+
+	if (!m_pInputContent)
+		return DAFF_MODAL_ERROR;
+
+	FILE* pFile = fopen(sFilePath.c_str(), "rb");
+	if (pFile == NULL)
+		return DAFF_FILE_NOT_FOUND;
+
+	char pcSignature[4];
+	int piHeader[7];
+	float pfHeader[2];
+	if ((fread(pcSignature, 1, 4, pFile) != 4) || (fread(piHeader, 4, 7, pFile) != 7) ||
+		(fread(pfHeader, 4, 2, pFile) != 2)) {
+		fclose(pFile);
+		return DAFF_FILE_CORRUPTED;
+	}
+	DAFF::le2se_4byte(piHeader, 7);
+	DAFF::le2se_4byte(pfHeader, 2);
+
+	int iError = DAFF_NO_ERROR;
+	int iFilterLength = m_pInputContent->getFilterLength();
+	if (memcmp(pcSignature, DAFF_MINPHASE_SIGNATURE, 4) != 0)
+		iError = DAFF_FILE_INVALID;
+	else if (piHeader[0] != DAFF_MINPHASE_VERSION)
+		iError = DAFF_FILE_FORMAT_VERSION_UNSUPPORTED;
+	else if ((piHeader[1] != m_pInputContent->getProperties()->getNumberOfRecords()) ||
+			 (piHeader[2] != m_pInputContent->getProperties()->getNumberOfChannels()) ||
+			 (piHeader[3] != iFilterLength) || (pfHeader[1] != (float)m_pInputContent->getSamplerate()))
+		iError = DAFF_FILE_CONTENT_INVALID_PARAMETER;
+	else if ((piHeader[4] <= 0) || (piHeader[4] > iFilterLength) || !(pfHeader[0] > 0) || !(pfHeader[0] <= 1))
+		iError = DAFF_FILE_CORRUPTED;
+	else if (!init(piHeader[4]))
+		iError = DAFF_MODAL_ERROR;
+
+	if (iError == DAFF_NO_ERROR) {
+		size_t nNumRecordChannels = m_vfDelays.size();
+		bool bSuccess = (fread(&m_vfDelays[0], 4, nNumRecordChannels, pFile) == nNumRecordChannels);
+		DAFF::le2se_4byte(&m_vfDelays[0], nNumRecordChannels);
+
+		for (size_t i = 0; bSuccess && (i < nNumRecordChannels); i++) {
+			float* pfDest = m_pfBuf + i * m_iStride;
+			bSuccess = (fread(pfDest, 4, m_iLength, pFile) == (size_t)m_iLength);
+			DAFF::le2se_4byte(pfDest, m_iLength);
+		}
+
+		if (!bSuccess)
+			iError = DAFF_FILE_CORRUPTED;
+	}
+	fclose(pFile);
+
+	if (iError != DAFF_NO_ERROR) {
+		clear();
+		return iError;
+	}
+
+	m_iMinPhaseLength = m_iLength;
+	m_fOnsetThreshold = pfHeader[0];
+	initPeaks();
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2MinPhase::getFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	for (int i = 0; i < m_iLength; i++)
+		pfDest[i] = pfData[i] * fGain;
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2MinPhase::getFilterCoeff(int iRecordIndex, int iChannel, int iSample, float& fCoeff) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel);
+	assert(pfData != NULL);
+	if (!pfData || (iSample < 0) || (iSample >= m_iLength))
+		return DAFF_INVALID_INDEX;
+
+	fCoeff = pfData[iSample];
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2MinPhase::addFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	for (int i = 0; i < m_iLength; i++)
+		pfDest[i] += pfData[i] * fGain;
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2MinPhase::getFilterEnvelope(int iRecordIndex, int iChannel, int iFirstSample, int iNumSamples,
+												  int iNumBins, float* pfMin, float* pfMax) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	if ((iFirstSample < 0) || (iNumBins < 1) || (iNumBins > iNumSamples) || (iNumSamples > m_iLength - iFirstSample))
+		return DAFF_INVALID_INDEX;
+
+	for (int k = 0; k < iNumBins; k++) {
+		int iBegin = iFirstSample + (int)((int64_t)k * iNumSamples / iNumBins);
+		int iEnd = iFirstSample + (int)((int64_t)(k + 1) * iNumSamples / iNumBins);
+		pfMin[k] = pfMax[k] = pfData[iBegin];
+		DAFF::minmax_float(pfData + iBegin, iEnd - iBegin, pfMin[k], pfMax[k]);
+	}
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2MinPhase::getFixedPointFilterCoeffs(int iRecordIndex, int iChannel, int16_t* piDestQ15,
+														  int32_t* piDestQ31, float fGain, bool bAdd) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	if ((piDestQ15 == NULL) && (piDestQ31 == NULL))
+		return DAFF_NO_ERROR;
+
+	DAFF::stc_float_to_fixed_point(piDestQ15, piDestQ31, pfData, m_iLength, fGain, bAdd);
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2MinPhase::getRecord(int iRecordIndex, float** ppfChannelDest) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return DAFF_INVALID_INDEX;
+
+	assert(ppfChannelDest != 0);
+	for (int c = 0; c < iChannels; c++)
+		if (ppfChannelDest[c])
+			memcpy(ppfChannelDest[c], getFilterPtr(iRecordIndex, c), m_iLength * sizeof(float));
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2MinPhase::getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert(iStride >= iChannels);
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return DAFF_INVALID_INDEX;
+	if (iStride < iChannels)
+		return DAFF_MODAL_ERROR;
+
+	assert(pfDest != 0);
+	for (int c = 0; c < iChannels; c++) {
+		const float* pfData = getFilterPtr(iRecordIndex, c);
+		for (int i = 0; i < m_iLength; i++)
+			pfDest[i * iStride + c] = pfData[i];
+	}
+	return DAFF_NO_ERROR;
+}
+
+float DAFFTransformerIR2MinPhase::getChannelPeak(int iChannel) const
+{
+	if ((iChannel < 0) || (iChannel >= (int)m_vfChannelPeaks.size()))
+		return 0;
+	return m_vfChannelPeaks[iChannel];
+}
+
+float DAFFTransformerIR2MinPhase::getRecordPeak(int iRecordIndex, int iChannel) const
+{
+	if (!getFilterPtr(iRecordIndex, iChannel))
+		return 0;
+
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	return m_vfPeaks[(size_t)iRecordIndex * iChannels + iChannel];
+}
+
+int DAFFTransformerIR2MinPhase::getRecordStatistics(int iRecordIndex, int iChannel,
+													DAFFRecordStatistics& oStats) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	// Same definitions as for stored impulse responses (see DAFFContentIR::getRecordStatistics)
+	double dEnergy = 0;
+	for (int i = 0; i < m_iLength; i++)
+		dEnergy += (double)pfData[i] * pfData[i];
+	oStats.fPeak = getRecordPeak(iRecordIndex, iChannel);
+	oStats.fEnergy = (float)dEnergy;
+	oStats.fRMS = (float)std::sqrt(dEnergy / m_iLength);
+
+	oStats.iOnset = -1;
+	for (int i = 0; (i < m_iLength) && (oStats.fPeak > 0); i++) {
+		if (std::fabs(pfData[i]) >= 0.1f * oStats.fPeak) {
+			oStats.iOnset = i;
+			break;
+		}
+	}
+
+	return DAFF_NO_ERROR;
+}
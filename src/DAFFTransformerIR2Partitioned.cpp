@@ -0,0 +1,342 @@
+#include <DAFFTransformerIR2Partitioned.h>
+
+#include <DAFFProperties.h>
+
+#include <algorithm>
+#include <cassert>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "DAFFFFTPlanCache.h"
+#include "DAFFInstrumentationImpl.h"
+#include "DAFFRecordCache.h"
+#include "Utils.h"
+
+//! Returns the number of floats of the scratch buffer of transformPartitions (impulse response and one block)
+static size_t getScratchSize(int iFilterLength, int iBlockLength)
+{
+	return (size_t)((iFilterLength + 3) / 4 * 4) + 2 * (size_t)iBlockLength;
+}
+
+//! Transforms the impulse response of a record channel into uniformly partitioned spectra
+/**
+ * \param pfScratch	Scratch buffer (getScratchSize floats, 16-byte aligned)
+ * \param pfDest		Destination of the partitions (iNumPartitions * iStride floats, 16-byte aligned)
+ * \param oState		Plan lookup state
+ */
+static void transformPartitions(const DAFFContentIR* pInputContent, int iRecord, int iChannel, int iBlockLength,
+								int iNumPartitions, int iStride, float* pfScratch, float* pfDest,
+								DAFFFFTPlanState& oState)
+{
+	int iFilterLength = pInputContent->getFilterLength();
+	float* pfInput = pfScratch;
+	float* pfBlock = pfScratch + (iFilterLength + 3) / 4 * 4;
+
+	// Fetch input data
+	pInputContent->getFilterCoeffs(iRecord, iChannel, pfInput);
+
+	// Zero-padded blocks into frequency-domain
+	for (int p = 0; p < iNumPartitions; p++) {
+		int iOffset = p * iBlockLength;
+		int iCount = std::min(iBlockLength, iFilterLength - iOffset);
+		memcpy(pfBlock, pfInput + iOffset, iCount * sizeof(float));
+		memset(pfBlock + iCount, 0, (2 * iBlockLength - iCount) * sizeof(float));
+
+		DAFFFFTPlanCache::execute(2 * iBlockLength, pfBlock, pfDest + (size_t)p * iStride, oState);
+	}
+}
+
+DAFFTransformerIR2Partitioned::DAFFTransformerIR2Partitioned()
+	: m_pInputContent(NULL), m_iBlockLength(0), m_iNumPartitions(0), m_iPartitionStride(0), m_iNumThreads(0),
+	  m_bLazy(false), m_bTransformed(false), m_pCache(new DAFFRecordCache), m_pfBuf(NULL), m_pfScratch(NULL)
+{
+}
+
+DAFFTransformerIR2Partitioned::DAFFTransformerIR2Partitioned(const DAFFContentIR* pInputContent, int iBlockLength,
+															 bool bTransform)
+	: m_pInputContent(NULL), m_iBlockLength(0), m_iNumPartitions(0), m_iPartitionStride(0), m_iNumThreads(0),
+	  m_bLazy(false), m_bTransformed(false), m_pCache(new DAFFRecordCache), m_pfBuf(NULL), m_pfScratch(NULL)
+{
+	setBlockLength(iBlockLength, false);
+	setInputContent(pInputContent, bTransform);
+}
+
+DAFFTransformerIR2Partitioned::~DAFFTransformerIR2Partitioned()
+{
+	clear();
+	delete m_pCache;
+}
+
+const DAFFContentIR* DAFFTransformerIR2Partitioned::getInputContent() const
+{
+	return m_pInputContent;
+}
+
+void DAFFTransformerIR2Partitioned::setInputContent(const DAFFContentIR* pInputContent, bool bTransform)
+{
+	m_pInputContent = pInputContent;
+	if (bTransform)
+		transform();
+}
+
+int DAFFTransformerIR2Partitioned::getBlockLength() const
+{
+	return m_iBlockLength;
+}
+
+void DAFFTransformerIR2Partitioned::setBlockLength(int iBlockLength, bool bTransform)
+{
+	assert(iBlockLength > 0);
+	m_iBlockLength = (iBlockLength > 0 ? iBlockLength : 0);
+	if (bTransform)
+		transform();
+}
+
+int DAFFTransformerIR2Partitioned::getNumPartitions() const
+{
+	return m_iNumPartitions;
+}
+
+int DAFFTransformerIR2Partitioned::getTransformSize() const
+{
+	return 2 * m_iBlockLength;
+}
+
+int DAFFTransformerIR2Partitioned::getNumDFTCoeffs() const
+{
+	return m_iBlockLength + 1;
+}
+
+int DAFFTransformerIR2Partitioned::getPartitionStride() const
+{
+	return m_iPartitionStride;
+}
+
+int DAFFTransformerIR2Partitioned::getNumThreads() const
+{
+	return m_iNumThreads;
+}
+
+void DAFFTransformerIR2Partitioned::setNumThreads(int iNumThreads)
+{
+	m_iNumThreads = (iNumThreads > 0 ? iNumThreads : 0);
+}
+
+bool DAFFTransformerIR2Partitioned::isLazy() const
+{
+	return m_bLazy;
+}
+
+void DAFFTransformerIR2Partitioned::setLazy(bool bLazy, bool bTransform)
+{
+	m_bLazy = bLazy;
+	if (bTransform)
+		transform();
+}
+
+size_t DAFFTransformerIR2Partitioned::getLazyCacheSize() const
+{
+	std::lock_guard<std::mutex> lock(m_mxCache);
+	return m_pCache->getMaxSize();
+}
+
+void DAFFTransformerIR2Partitioned::setLazyCacheSize(size_t nMaxBytes)
+{
+	std::lock_guard<std::mutex> lock(m_mxCache);
+	m_pCache->setMaxSize(nMaxBytes);
+}
+
+size_t DAFFTransformerIR2Partitioned::getMemoryFootprint() const
+{
+	size_t nBytes = 0;
+	if (m_pInputContent && m_pfBuf)
+		nBytes += (size_t)m_pInputContent->getProperties()->getNumberOfRecords() *
+				  m_pInputContent->getProperties()->getNumberOfChannels() * getElementSize() * sizeof(float);
+	if (m_pInputContent && m_pfScratch)
+		nBytes += getScratchSize(m_pInputContent->getFilterLength(), m_iBlockLength) * sizeof(float);
+
+	std::lock_guard<std::mutex> lock(m_mxCache);
+	return nBytes + m_pCache->getSize();
+}
+
+void DAFFTransformerIR2Partitioned::clear()
+{
+	m_bTransformed = false;
+
+	DAFF::free_aligned16(m_pfBuf);
+	m_pfBuf = NULL;
+
+	DAFF::free_aligned16(m_pfScratch);
+	m_pfScratch = NULL;
+
+	m_pCache->clear();
+}
+
+void DAFFTransformerIR2Partitioned::transform()
+{
+	// Discard previous partitions
+	clear();
+
+	if (!m_pInputContent || (m_iBlockLength <= 0))
+		return;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int iFilterLength = m_pInputContent->getFilterLength();
+
+	// Partitions are 16-byte aligned
+	m_iNumPartitions = (iFilterLength + m_iBlockLength - 1) / m_iBlockLength;
+	m_iPartitionStride = (2 * (m_iBlockLength + 1) + 3) / 4 * 4;
+
+	// Lazy: partitions are transformed on first access
+	if (m_bLazy) {
+		m_pfScratch = static_cast<float*>(
+			DAFF::malloc_aligned16(getScratchSize(iFilterLength, m_iBlockLength) * sizeof(float)));
+		m_bTransformed = true;
+		return;
+	}
+
+	int iNumRecordChannels = iRecords * iChannels;
+	m_pfBuf = static_cast<float*>(DAFF::malloc_aligned16(iNumRecordChannels * getElementSize() * sizeof(float)));
+	if (!m_pfBuf)
+		return;
+
+	// Distribute the record channels over several threads, each transforming a range
+	int iNumThreads = m_iNumThreads;
+	if (iNumThreads <= 0) {
+		const uint64_t ui64MinSamplesPerThread = 1 << 16;
+		uint64_t ui64NumSamples = (uint64_t)iNumRecordChannels * m_iNumPartitions * 2 * m_iBlockLength;
+		uint64_t ui64MaxThreads = std::max(ui64NumSamples / ui64MinSamplesPerThread, (uint64_t)1);
+		iNumThreads = (int)std::min((uint64_t)std::max(std::thread::hardware_concurrency(), 1u), ui64MaxThreads);
+	}
+
+	std::vector<std::thread> vThreads;
+	int iChunk = (iNumRecordChannels + iNumThreads - 1) / iNumThreads;
+	for (int i = 1; i * iChunk < iNumRecordChannels; i++) {
+		int iBegin = i * iChunk;
+		int iEnd = std::min(iBegin + iChunk, iNumRecordChannels);
+		try {
+			vThreads.push_back(std::thread(&DAFFTransformerIR2Partitioned::transformRange, this, iBegin, iEnd));
+		} catch (const std::system_error&) {
+			transformRange(iBegin, iEnd);  // No more threads available
+		}
+	}
+
+	transformRange(0, std::min(iChunk, iNumRecordChannels));
+
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	m_bTransformed = true;
+}
+
+size_t DAFFTransformerIR2Partitioned::getElementSize() const
+{
+	return (size_t)m_iNumPartitions * m_iPartitionStride;
+}
+
+void DAFFTransformerIR2Partitioned::transformRange(int iBegin, int iEnd)
+{
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int iFilterLength = m_pInputContent->getFilterLength();
+	float* pfScratch =
+		static_cast<float*>(DAFF::malloc_aligned16(getScratchSize(iFilterLength, m_iBlockLength) * sizeof(float)));
+
+	DAFFFFTPlanState oState;
+	for (int n = iBegin; n < iEnd; n++)
+		transformPartitions(m_pInputContent, n / iChannels, n % iChannels, m_iBlockLength, m_iNumPartitions,
+							m_iPartitionStride, pfScratch, m_pfBuf + (size_t)n * getElementSize(), oState);
+
+	DAFF::free_aligned16(pfScratch);
+}
+
+std::unique_lock<std::mutex> DAFFTransformerIR2Partitioned::lockCache() const
+{
+	if (m_bLazy)
+		return std::unique_lock<std::mutex>(m_mxCache);
+	return std::unique_lock<std::mutex>();
+}
+
+const float* DAFFTransformerIR2Partitioned::getElementPtr(int iRecordIndex, int iChannel) const
+{
+	if (!m_bTransformed)
+		return NULL;
+
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int64_t iKey = (int64_t)iRecordIndex * iChannels + iChannel;
+	if (!m_bLazy)
+		return m_pfBuf + iKey * getElementSize();
+
+	float* pfData = static_cast<float*>(m_pCache->find(iKey));
+	DAFF_INSTRUMENT_COUNT(pfData ? DAFF_COUNTER_TRANSFORMER_CACHE_HITS : DAFF_COUNTER_TRANSFORMER_CACHE_MISSES, 1);
+	if (pfData)
+		return pfData;
+
+	pfData = static_cast<float*>(m_pCache->insert(iKey, getElementSize() * sizeof(float)));
+	if (pfData == NULL)
+		return NULL;
+
+	DAFFFFTPlanState oState;
+	transformPartitions(m_pInputContent, iRecordIndex, iChannel, m_iBlockLength, m_iNumPartitions,
+						m_iPartitionStride, m_pfScratch, pfData, oState);
+
+	return pfData;
+}
+
+const float* DAFFTransformerIR2Partitioned::getPartitionsPtr(int iRecordIndex, int iChannel) const
+{
+	if (!m_pInputContent)
+		return NULL;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert((iChannel >= 0) && (iChannel < iChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return NULL;
+	if ((iChannel < 0) || (iChannel >= iChannels))
+		return NULL;
+
+	std::unique_lock<std::mutex> lock = lockCache();
+	return getElementPtr(iRecordIndex, iChannel);
+}
+
+const float* DAFFTransformerIR2Partitioned::getPartitionPtr(int iRecordIndex, int iChannel, int iPartition) const
+{
+	assert((iPartition >= 0) && (iPartition < m_iNumPartitions));
+	if ((iPartition < 0) || (iPartition >= m_iNumPartitions))
+		return NULL;
+
+	const float* pfData = getPartitionsPtr(iRecordIndex, iChannel);
+	return (pfData ? pfData + (size_t)iPartition * m_iPartitionStride : NULL);
+}
+
+int DAFFTransformerIR2Partitioned::getPartitions(int iRecordIndex, int iChannel, float* pfDest) const
+{
+	if (!m_pInputContent || !m_bTransformed)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return DAFF_INVALID_INDEX;
+	if ((iChannel < 0) || (iChannel >= iChannels))
+		return DAFF_INVALID_INDEX;
+
+	assert(pfDest != 0);
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getElementPtr(iRecordIndex, iChannel);
+	if (!pfData)
+		return DAFF_MODAL_ERROR;
+
+	int iPartitionSize = 2 * (m_iBlockLength + 1);
+	for (int p = 0; p < m_iNumPartitions; p++)
+		memcpy(pfDest + (size_t)p * iPartitionSize, pfData + (size_t)p * m_iPartitionStride,
+			   iPartitionSize * sizeof(float));
+
+	return DAFF_NO_ERROR;
+}
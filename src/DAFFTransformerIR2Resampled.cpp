@@ -0,0 +1,856 @@
+#include <DAFFTransformerIR2Resampled.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <system_error>
+#include <thread>
+
+#include "DAFFPropertiesImpl.h"
+#include "Utils.h"
+
+//! Signature of resampling cache files
+static const char DAFF_RESAMPLED_SIGNATURE[4] = { 'D', 'R', 'S', 'C' };
+
+//! Version of the resampling cache file format
+static const int DAFF_RESAMPLED_VERSION = 1;
+
+//! Zero crossings of the sinc kernel per side
+static const int DAFF_RESAMPLED_ZERO_CROSSINGS = 32;
+
+//! Cutoff frequency of the kernel relative to the lower Nyquist frequency
+static const double DAFF_RESAMPLED_CUTOFF = 0.94;
+
+//! Shape parameter of the Kaiser window (about 90 dB stopband attenuation)
+static const double DAFF_RESAMPLED_KAISER_BETA = 9.0;
+
+// Inner content interface realization
+class DAFFContentIRResampledRealization : public DAFFContentIR {
+  public:
+	inline DAFFContentIRResampledRealization(DAFFTransformerIR2Resampled* pParent, const DAFFContentIR* pInputContent)
+		: m_pParent(pParent), m_pInputContent(pInputContent)
+	{
+		m_oProps = *(pInputContent->getProperties());
+		m_oProps.m_iQuantization = DAFF_FLOAT32;
+	};
+
+	inline virtual ~DAFFContentIRResampledRealization() {};
+
+	// --= Interface "DAFFContentIR" =--
+
+	inline double getSamplerate() const { return m_pParent->m_dTargetSamplerate; };
+
+	inline int getFilterLength() const { return m_pParent->m_iLength; };
+
+	inline int getFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFilterCoeffs(iRecordIndex, iChannel, pfDest, fGain);
+	};
+
+	inline int getFilterCoeff(int iRecordIndex, int iChannel, int iSample, float& fCoeff) const
+	{
+		return m_pParent->getFilterCoeff(iRecordIndex, iChannel, iSample, fCoeff);
+	};
+
+	inline int addFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->addFilterCoeffs(iRecordIndex, iChannel, pfDest, fGain);
+	};
+
+	inline int getFilterCoeffsQ15(int iRecordIndex, int iChannel, int16_t* piDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFixedPointFilterCoeffs(iRecordIndex, iChannel, piDest, NULL, fGain, false);
+	};
+
+	inline int getFilterCoeffsQ31(int iRecordIndex, int iChannel, int32_t* piDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFixedPointFilterCoeffs(iRecordIndex, iChannel, NULL, piDest, fGain, false);
+	};
+
+	inline int addFilterCoeffsQ15(int iRecordIndex, int iChannel, int16_t* piDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFixedPointFilterCoeffs(iRecordIndex, iChannel, piDest, NULL, fGain, true);
+	};
+
+	inline int addFilterCoeffsQ31(int iRecordIndex, int iChannel, int32_t* piDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getFixedPointFilterCoeffs(iRecordIndex, iChannel, NULL, piDest, fGain, true);
+	};
+
+	inline int getRecord(int iRecordIndex, float** ppfChannelDest) const
+	{
+		return m_pParent->getRecord(iRecordIndex, ppfChannelDest);
+	};
+
+	inline int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const
+	{
+		return m_pParent->getRecordInterleaved(iRecordIndex, pfDest, iStride);
+	};
+
+	// The effective bounds are determined on the resampled filters
+
+	inline int getMinEffectiveFilterOffset() const { return m_pParent->m_iMinEffectiveOffset; };
+
+	inline int getMaxEffectiveFilterLength() const { return m_pParent->m_iMaxEffectiveLength; };
+
+	inline int getEffectiveFilterBounds(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const
+	{
+		return m_pParent->getEffectiveFilterBounds(iRecordIndex, iChannel, iOffset, iLength);
+	};
+
+	inline int getEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getEffectiveFilterCoeffs(iRecordIndex, iChannel, pfDest, fGain, false);
+	};
+
+	inline int getFilterCoeffsTruncated(int iRecordIndex, int iChannel, float* pfDest, int& iLength,
+										float fGain = 1.0F) const
+	{
+		return m_pParent->getFilterCoeffsTruncated(iRecordIndex, iChannel, pfDest, iLength, fGain);
+	};
+
+	inline int getMaxTruncatedFilterLength() const { return m_pParent->m_iMaxTruncatedLength; };
+
+	inline int addEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->getEffectiveFilterCoeffs(iRecordIndex, iChannel, pfDest, fGain, true);
+	};
+
+	inline const float* getEffectiveFilterCoeffsPtr(int iRecordIndex, int iChannel, int& iOffset, int& iLength) const
+	{
+		return m_pParent->getEffectiveFilterCoeffsPtr(iRecordIndex, iChannel, iOffset, iLength);
+	};
+
+	inline int getFilterEnvelope(int iRecordIndex, int iChannel, int iFirstSample, int iNumSamples, int iNumBins,
+								 float* pfMin, float* pfMax) const
+	{
+		return m_pParent->getFilterEnvelope(iRecordIndex, iChannel, iFirstSample, iNumSamples, iNumBins, pfMin, pfMax);
+	};
+
+	inline float getOverallPeak() const { return m_pParent->m_fOverallPeak; };
+
+	inline float getChannelPeak(int iChannel) const { return m_pParent->getChannelPeak(iChannel); };
+
+	inline float getRecordPeak(int iRecordIndex, int iChannel) const
+	{
+		return m_pParent->getRecordPeak(iRecordIndex, iChannel);
+	};
+
+	inline int getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const
+	{
+		return m_pParent->getRecordStatistics(iRecordIndex, iChannel, oStats);
+	};
+
+	// --= Interface "DAFFContent" =--
+
+	// This interface is completely delegated to the input content of the transform
+
+	inline DAFFReader* getParent() const { return m_pInputContent->getParent(); };
+
+	inline const DAFFPropertiesImpl* getProperties() const { return &m_oProps; };
+
+	inline const DAFFMetadata* getRecordMetadata(int iRecordIndex) const
+	{
+		return m_pInputContent->getRecordMetadata(iRecordIndex);
+	};
+
+	inline int getRecordCoords(int iRecordIndex, int iView, float& fAngle1, float& fAngle2) const
+	{
+		return m_pInputContent->getRecordCoords(iRecordIndex, iView, fAngle1, fAngle2);
+	};
+
+	inline void getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex) const
+	{
+		m_pInputContent->getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex);
+	};
+
+	inline void getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex,
+									bool& bOutOfBounds) const
+	{
+		m_pInputContent->getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex, bOutOfBounds);
+	};
+
+	inline void getNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int* piRecordIndices,
+									 bool* pbOutOfBounds, size_t n) const
+	{
+		m_pInputContent->getNearestNeighbours(iView, pfAngles1, pfAngles2, piRecordIndices, pbOutOfBounds, n);
+	};
+
+	inline int getKNearestNeighbours(int iView, float fAngle1, float fAngle2, int k, int* piRecordIndices,
+									 float* pfDistances) const
+	{
+		return m_pInputContent->getKNearestNeighbours(iView, fAngle1, fAngle2, k, piRecordIndices, pfDistances);
+	};
+
+	inline int getKNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int k,
+									 int* piRecordIndices, float* pfDistances, size_t n) const
+	{
+		return m_pInputContent->getKNearestNeighbours(iView, pfAngles1, pfAngles2, k, piRecordIndices, pfDistances,
+													  n);
+	};
+
+	inline int getRecordsInCone(int iView, float fAngle1, float fAngle2, float fRadius,
+								std::vector<int>& viRecordIndices) const
+	{
+		return m_pInputContent->getRecordsInCone(iView, fAngle1, fAngle2, fRadius, viRecordIndices);
+	};
+
+	inline int getRecordsInCone(int iView, const float* pfAngles1, const float* pfAngles2, float fRadius,
+								std::vector<int>& viRecordIndices, std::vector<int>& viOffsets, size_t n) const
+	{
+		return m_pInputContent->getRecordsInCone(iView, pfAngles1, pfAngles2, fRadius, viRecordIndices, viOffsets,
+												 n);
+	};
+
+	inline void getCell(int iView, float fAngle1, float fAngle2, DAFFQuad& qIndices) const
+	{
+		m_pInputContent->getCell(iView, fAngle1, fAngle2, qIndices);
+	};
+
+	inline void transformAnglesD2O(float fAlpha, float fBeta, float& fAzimuth, float& fElevation) const
+	{
+		m_pInputContent->transformAnglesD2O(fAlpha, fBeta, fAzimuth, fElevation);
+	};
+
+	inline void transformAnglesO2D(float fAzimuth, float fElevation, float& fAlpha, float& fBeta) const
+	{
+		m_pInputContent->transformAnglesO2D(fAzimuth, fElevation, fAlpha, fBeta);
+	};
+
+  private:
+	DAFFTransformerIR2Resampled* m_pParent;
+	const DAFFContentIR* m_pInputContent;
+	DAFFPropertiesImpl m_oProps;
+};
+
+//! Modified Bessel function of the first kind and order zero (power series)
+static double besselI0(double x)
+{
+	double dSum = 1, dTerm = 1;
+	for (int k = 1; k < 64; k++) {
+		dTerm *= (0.5 * x / k) * (0.5 * x / k);
+		dSum += dTerm;
+		if (dTerm < 1e-17 * dSum)
+			break;
+	}
+	return dSum;
+}
+
+//! Greatest common divisor
+static int gcd(int a, int b)
+{
+	while (b != 0) {
+		int t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+DAFFTransformerIR2Resampled::DAFFTransformerIR2Resampled()
+	: m_pInputContent(NULL), m_pOutputContent(NULL), m_dTargetSamplerate(48000), m_iNumThreads(0), m_iUpFactor(0),
+	  m_iDownFactor(0), m_iNumTaps(0), m_iLength(0), m_iStride(0), m_pfBuf(NULL), m_iMinEffectiveOffset(0),
+	  m_iMaxEffectiveLength(0), m_iMaxTruncatedLength(0), m_fOverallPeak(0)
+{
+}
+
+DAFFTransformerIR2Resampled::DAFFTransformerIR2Resampled(const DAFFContentIR* pInputContent, double dTargetSamplerate,
+														 bool bTransform)
+	: m_pInputContent(NULL), m_pOutputContent(NULL), m_dTargetSamplerate(dTargetSamplerate), m_iNumThreads(0),
+	  m_iUpFactor(0), m_iDownFactor(0), m_iNumTaps(0), m_iLength(0), m_iStride(0), m_pfBuf(NULL),
+	  m_iMinEffectiveOffset(0), m_iMaxEffectiveLength(0), m_iMaxTruncatedLength(0), m_fOverallPeak(0)
+{
+	setInputContent(pInputContent, bTransform);
+}
+
+DAFFTransformerIR2Resampled::~DAFFTransformerIR2Resampled()
+{
+	clear();
+}
+
+const DAFFContentIR* DAFFTransformerIR2Resampled::getInputContent() const
+{
+	return m_pInputContent;
+}
+
+void DAFFTransformerIR2Resampled::setInputContent(const DAFFContentIR* pInputContent, bool bTransform)
+{
+	m_pInputContent = pInputContent;
+	if (bTransform)
+		transform();
+}
+
+DAFFContentIR* DAFFTransformerIR2Resampled::getOutputContent() const
+{
+	return m_pOutputContent;
+}
+
+double DAFFTransformerIR2Resampled::getTargetSamplerate() const
+{
+	return m_dTargetSamplerate;
+}
+
+void DAFFTransformerIR2Resampled::setTargetSamplerate(double dTargetSamplerate, bool bTransform)
+{
+	assert(dTargetSamplerate >= 1);
+	m_dTargetSamplerate = dTargetSamplerate;
+	if (bTransform)
+		transform();
+}
+
+int DAFFTransformerIR2Resampled::getNumThreads() const
+{
+	return m_iNumThreads;
+}
+
+void DAFFTransformerIR2Resampled::setNumThreads(int iNumThreads)
+{
+	m_iNumThreads = (iNumThreads > 0 ? iNumThreads : 0);
+}
+
+size_t DAFFTransformerIR2Resampled::getMemoryFootprint() const
+{
+	size_t nBytes = (m_vfPolyphase.capacity() + m_vfPeaks.capacity() + m_vfChannelPeaks.capacity()) * sizeof(float) +
+					(m_viOffsets.capacity() + m_viLengths.capacity()) * sizeof(int);
+	if (m_pInputContent && m_pfBuf)
+		nBytes += (size_t)m_pInputContent->getProperties()->getNumberOfRecords() *
+				  m_pInputContent->getProperties()->getNumberOfChannels() * m_iStride * sizeof(float);
+	return nBytes;
+}
+
+void DAFFTransformerIR2Resampled::clear()
+{
+	delete m_pOutputContent;
+	m_pOutputContent = NULL;
+
+	DAFF::free_aligned16(m_pfBuf);
+	m_pfBuf = NULL;
+
+	m_vfPolyphase.clear();
+	m_viOffsets.clear();
+	m_viLengths.clear();
+	m_vfPeaks.clear();
+	m_vfChannelPeaks.clear();
+	m_iUpFactor = m_iDownFactor = m_iNumTaps = 0;
+	m_iMinEffectiveOffset = m_iMaxEffectiveLength = m_iMaxTruncatedLength = 0;
+	m_fOverallPeak = 0;
+	m_iLength = 0;
+}
+
+bool DAFFTransformerIR2Resampled::init()
+{
+	// Rate ratio up/down of the integer rates
+	int iInputRate = (int)(m_pInputContent->getSamplerate() + 0.5);
+	int iTargetRate = (int)(m_dTargetSamplerate + 0.5);
+	if ((iInputRate <= 0) || (iTargetRate <= 0))
+		return false;
+
+	int iDivisor = gcd(iInputRate, iTargetRate);
+	m_iUpFactor = iTargetRate / iDivisor;
+	m_iDownFactor = iInputRate / iDivisor;
+
+	// Kernel in units of input samples, the cutoff follows the lower rate
+	double dCutoff = DAFF_RESAMPLED_CUTOFF * std::min(1.0, (double)m_iUpFactor / m_iDownFactor);
+	double dHalfWidth = DAFF_RESAMPLED_ZERO_CROSSINGS / dCutoff;
+	int iHalfTaps = (int)std::ceil(dHalfWidth);
+	m_iNumTaps = 2 * iHalfTaps;
+
+	// Phase p starts at input time p/up, tap j weights the input sample at the distance p/up + half taps - 1 - j
+	const double dPi = 3.14159265358979323846;
+	double dGain = dCutoff * m_iDownFactor / m_iUpFactor;
+	double dWindowNorm = 1.0 / besselI0(DAFF_RESAMPLED_KAISER_BETA);
+	m_vfPolyphase.resize((size_t)m_iUpFactor * m_iNumTaps);
+	for (int p = 0; p < m_iUpFactor; p++) {
+		for (int j = 0; j < m_iNumTaps; j++) {
+			double t = (double)p / m_iUpFactor + iHalfTaps - 1 - j;
+			double dCoeff = 0;
+			if (std::fabs(t) < dHalfWidth) {
+				double x = dPi * dCutoff * t;
+				double dSinc = (x == 0 ? 1.0 : std::sin(x) / x);
+				double r = t / dHalfWidth;
+				dCoeff = dGain * dSinc * besselI0(DAFF_RESAMPLED_KAISER_BETA * std::sqrt(1 - r * r)) * dWindowNorm;
+			}
+			m_vfPolyphase[(size_t)p * m_iNumTaps + j] = (float)dCoeff;
+		}
+	}
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	size_t nNumRecordChannels = (size_t)iRecords * iChannels;
+
+	// Filters are 16-byte aligned
+	int64_t i64Length = ((int64_t)m_pInputContent->getFilterLength() * m_iUpFactor + m_iDownFactor - 1) / m_iDownFactor;
+	if ((i64Length <= 0) || (i64Length > 0x7FFFFFF0))
+		return false;
+	m_iLength = (int)i64Length;
+	m_iStride = (m_iLength + 3) / 4 * 4;
+	size_t nBytes = nNumRecordChannels * m_iStride * sizeof(float);
+	m_pfBuf = static_cast<float*>(DAFF::malloc_aligned16(nBytes));
+	if (!m_pfBuf)
+		return false;
+	memset(m_pfBuf, 0, nBytes);
+
+	m_pOutputContent = new DAFFContentIRResampledRealization(this, m_pInputContent);
+	return true;
+}
+
+void DAFFTransformerIR2Resampled::transform()
+{
+	// Discard previous filters
+	clear();
+
+	if (!m_pInputContent)
+		return;
+
+	if (!init()) {
+		clear();
+		return;
+	}
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int iNumRecordChannels = iRecords * iChannels;
+
+	// Distribute the record channels over several threads, each transforming a range
+	int iNumThreads = m_iNumThreads;
+	if (iNumThreads <= 0) {
+		const uint64_t ui64MinOpsPerThread = 1 << 20;
+		uint64_t ui64NumOps = (uint64_t)iNumRecordChannels * m_iLength * m_iNumTaps;
+		uint64_t ui64MaxThreads = std::max(ui64NumOps / ui64MinOpsPerThread, (uint64_t)1);
+		iNumThreads = (int)std::min((uint64_t)std::max(std::thread::hardware_concurrency(), 1u), ui64MaxThreads);
+	}
+
+	std::vector<std::thread> vThreads;
+	int iChunk = (iNumRecordChannels + iNumThreads - 1) / iNumThreads;
+	for (int iBegin = iChunk; iBegin < iNumRecordChannels; iBegin += iChunk) {
+		int iEnd = std::min(iBegin + iChunk, iNumRecordChannels);
+		try {
+			vThreads.push_back(std::thread(&DAFFTransformerIR2Resampled::transformRange, this, iBegin, iEnd));
+		} catch (const std::system_error&) {
+			transformRange(iBegin, iEnd);  // No more threads available
+		}
+	}
+
+	transformRange(0, std::min(iChunk, iNumRecordChannels));
+
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	initBounds();
+}
+
+void DAFFTransformerIR2Resampled::initBounds()
+{
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	size_t nNumRecordChannels = (size_t)m_pInputContent->getProperties()->getNumberOfRecords() * iChannels;
+
+	m_viOffsets.resize(nNumRecordChannels);
+	m_viLengths.resize(nNumRecordChannels);
+	m_vfPeaks.resize(nNumRecordChannels);
+	m_vfChannelPeaks.assign(iChannels, 0.0f);
+	m_fOverallPeak = 0;
+	m_iMinEffectiveOffset = m_iLength;
+	m_iMaxEffectiveLength = 0;
+	m_iMaxTruncatedLength = 0;
+	for (size_t i = 0; i < nNumRecordChannels; i++) {
+		// Effective part: all non-zero coefficients
+		size_t nBegin, nEnd;
+		m_vfPeaks[i] = DAFF::bounds_float(m_pfBuf + i * m_iStride, m_iLength, 0.0f, nBegin, nEnd);
+		m_viOffsets[i] = (int)nBegin;
+		m_viLengths[i] = (int)(nEnd - nBegin);
+		if (nEnd > nBegin)
+			m_iMinEffectiveOffset = std::min(m_iMinEffectiveOffset, (int)nBegin);
+		m_iMaxEffectiveLength = std::max(m_iMaxEffectiveLength, (int)(nEnd - nBegin));
+		m_iMaxTruncatedLength = std::max(m_iMaxTruncatedLength, (int)nEnd);
+
+		m_vfChannelPeaks[i % iChannels] = std::max(m_vfChannelPeaks[i % iChannels], m_vfPeaks[i]);
+		m_fOverallPeak = std::max(m_fOverallPeak, m_vfPeaks[i]);
+	}
+	if (m_iMaxEffectiveLength == 0)
+		m_iMinEffectiveOffset = 0;  // All filters zero
+}
+
+void DAFFTransformerIR2Resampled::transformRange(int iBegin, int iEnd)
+{
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int iFilterLength = m_pInputContent->getFilterLength();
+	int iHalfTaps = m_iNumTaps / 2;
+
+	// Input filter with zeros on both sides, so that all taps lie within the buffer
+	std::vector<float> vfInput(iFilterLength + m_iNumTaps, 0.0f);
+	float* pfInput = &vfInput[iHalfTaps - 1];
+
+	for (int n = iBegin; n < iEnd; n++) {
+		float* pfDest = m_pfBuf + (size_t)n * m_iStride;
+		if (m_pInputContent->getFilterCoeffs(n / iChannels, n % iChannels, pfInput) != DAFF_NO_ERROR)
+			memset(pfInput, 0, iFilterLength * sizeof(float));
+
+		// Output sample k lies at the input time k * down/up
+		for (int k = 0; k < m_iLength; k++) {
+			int64_t i64Time = (int64_t)k * m_iDownFactor;
+			int iPhase = (int)(i64Time % m_iUpFactor);
+			int iFirst = (int)(i64Time / m_iUpFactor);
+			pfDest[k] = DAFF::dot_float(&m_vfPolyphase[(size_t)iPhase * m_iNumTaps], &vfInput[iFirst], m_iNumTaps);
+		}
+	}
+}
+
+int DAFFTransformerIR2Resampled::save(const std::string& sFilePath) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	FILE* pFile = fopen(sFilePath.c_str(), "wb");
+	if (pFile == NULL)
+		return DAFF_FILE_NOT_FOUND;
+
+	// Header and data in little endian
+	int piHeader[5];
+	piHeader[0] = DAFF_RESAMPLED_VERSION;
+	piHeader[1] = m_pInputContent->getProperties()->getNumberOfRecords();
+	piHeader[2] = m_pInputContent->getProperties()->getNumberOfChannels();
+	piHeader[3] = m_pInputContent->getFilterLength();
+	piHeader[4] = m_iLength;
+	float pfHeader[2] = { (float)m_pInputContent->getSamplerate(), (float)m_dTargetSamplerate };
+	DAFF::le2se_4byte(piHeader, 5);
+	DAFF::le2se_4byte(pfHeader, 2);
+
+	bool bSuccess = (fwrite(DAFF_RESAMPLED_SIGNATURE, 1, 4, pFile) == 4) && (fwrite(piHeader, 4, 5, pFile) == 5) &&
+					(fwrite(pfHeader, 4, 2, pFile) == 2);
+
+	std::vector<float> vfData(m_iLength);
+	for (size_t i = 0; bSuccess && (i < m_vfPeaks.size()); i++) {
+		memcpy(&vfData[0], m_pfBuf + i * m_iStride, m_iLength * sizeof(float));
+		DAFF::le2se_4byte(&vfData[0], m_iLength);
+		bSuccess = (fwrite(&vfData[0], 4, m_iLength, pFile) == (size_t)m_iLength);
+	}
+
+	bSuccess = (fclose(pFile) == 0) && bSuccess;
+	return (bSuccess ? DAFF_NO_ERROR : DAFF_FILE_NOT_FOUND);
+}
+
+int DAFFTransformerIR2Resampled::load(const std::string& sFilePath)
+{
+	clear();
+
+	if (!m_pInputContent)
+		return DAFF_MODAL_ERROR;
+
+	FILE* pFile = fopen(sFilePath.c_str(), "rb");
+	if (pFile == NULL)
+		return DAFF_FILE_NOT_FOUND;
+
+	char pcSignature[4];
+	int piHeader[5];
+	float pfHeader[2];
+	if ((fread(pcSignature, 1, 4, pFile) != 4) || (fread(piHeader, 4, 5, pFile) != 5) ||
+		(fread(pfHeader, 4, 2, pFile) != 2)) {
+		fclose(pFile);
+		return DAFF_FILE_CORRUPTED;
+	}
+	DAFF::le2se_4byte(piHeader, 5);
+	DAFF::le2se_4byte(pfHeader, 2);
+
+	int iError = DAFF_NO_ERROR;
+	if (memcmp(pcSignature, DAFF_RESAMPLED_SIGNATURE, 4) != 0)
+		iError = DAFF_FILE_INVALID;
+	else if (piHeader[0] != DAFF_RESAMPLED_VERSION)
+		iError = DAFF_FILE_FORMAT_VERSION_UNSUPPORTED;
+	else if ((piHeader[1] != m_pInputContent->getProperties()->getNumberOfRecords()) ||
+			 (piHeader[2] != m_pInputContent->getProperties()->getNumberOfChannels()) ||
+			 (piHeader[3] != m_pInputContent->getFilterLength()) ||
+			 (pfHeader[0] != (float)m_pInputContent->getSamplerate()))
+		iError = DAFF_FILE_CONTENT_INVALID_PARAMETER;
+	else if (!(pfHeader[1] >= 1))
+		iError = DAFF_FILE_CORRUPTED;
+
+	if (iError == DAFF_NO_ERROR) {
+		m_dTargetSamplerate = pfHeader[1];
+		if (!init())
+			iError = DAFF_MODAL_ERROR;
+		else if (piHeader[4] != m_iLength)
+			iError = DAFF_FILE_CORRUPTED;
+	}
+
+	if (iError == DAFF_NO_ERROR) {
+		size_t nNumRecordChannels = (size_t)piHeader[1] * piHeader[2];
+		bool bSuccess = true;
+		for (size_t i = 0; bSuccess && (i < nNumRecordChannels); i++) {
+			float* pfDest = m_pfBuf + i * m_iStride;
+			bSuccess = (fread(pfDest, 4, m_iLength, pFile) == (size_t)m_iLength);
+			DAFF::le2se_4byte(pfDest, m_iLength);
+		}
+
+		if (!bSuccess)
+			iError = DAFF_FILE_CORRUPTED;
+	}
+	fclose(pFile);
+
+	if (iError != DAFF_NO_ERROR) {
+		clear();
+		return iError;
+	}
+
+	initBounds();
+	return DAFF_NO_ERROR;
+}
+
+const float* DAFFTransformerIR2Resampled::getFilterPtr(int iRecordIndex, int iChannel) const
+{
+	if (!m_pOutputContent)
+		return NULL;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords) || (iChannel < 0) || (iChannel >= iChannels))
+		return NULL;
+
+	return m_pfBuf + ((size_t)iRecordIndex * iChannels + iChannel) * m_iStride;
+}
+
+int DAFFTransformerIR2Resampled::getFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	for (int i = 0; i < m_iLength; i++)
+		pfDest[i] = pfData[i] * fGain;
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2Resampled::getFilterCoeff(int iRecordIndex, int iChannel, int iSample, float& fCoeff) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel);
+	assert(pfData != NULL);
+	if (!pfData || (iSample < 0) || (iSample >= m_iLength))
+		return DAFF_INVALID_INDEX;
+
+	fCoeff = pfData[iSample];
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2Resampled::addFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	for (int i = 0; i < m_iLength; i++)
+		pfDest[i] += pfData[i] * fGain;
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2Resampled::getFixedPointFilterCoeffs(int iRecordIndex, int iChannel, int16_t* piDestQ15,
+														   int32_t* piDestQ31, float fGain, bool bAdd) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	if ((piDestQ15 == NULL) && (piDestQ31 == NULL))
+		return DAFF_NO_ERROR;
+
+	DAFF::stc_float_to_fixed_point(piDestQ15, piDestQ31, pfData, m_iLength, fGain, bAdd);
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2Resampled::getFilterCoeffsTruncated(int iRecordIndex, int iChannel, float* pfDest, int& iLength,
+														  float fGain) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	size_t n = (size_t)iRecordIndex * m_pInputContent->getProperties()->getNumberOfChannels() + iChannel;
+	iLength = m_viOffsets[n] + m_viLengths[n];
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	for (int i = 0; i < iLength; i++)
+		pfDest[i] = pfData[i] * fGain;
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2Resampled::getEffectiveFilterBounds(int iRecordIndex, int iChannel, int& iOffset,
+														  int& iLength) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	if (!getFilterPtr(iRecordIndex, iChannel))
+		return DAFF_INVALID_INDEX;
+
+	size_t n = (size_t)iRecordIndex * m_pInputContent->getProperties()->getNumberOfChannels() + iChannel;
+	iOffset = m_viOffsets[n];
+	iLength = m_viLengths[n];
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2Resampled::getEffectiveFilterCoeffs(int iRecordIndex, int iChannel, float* pfDest, float fGain,
+														  bool bAdd) const
+{
+	int iOffset, iLength;
+	const float* pfData = getEffectiveFilterCoeffsPtr(iRecordIndex, iChannel, iOffset, iLength);
+	if (!pfData)
+		return (m_pOutputContent ? DAFF_INVALID_INDEX : DAFF_MODAL_ERROR);
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	if (bAdd) {
+		for (int i = 0; i < iLength; i++)
+			pfDest[i] += pfData[i] * fGain;
+	} else {
+		for (int i = 0; i < iLength; i++)
+			pfDest[i] = pfData[i] * fGain;
+	}
+	return DAFF_NO_ERROR;
+}
+
+const float* DAFFTransformerIR2Resampled::getEffectiveFilterCoeffsPtr(int iRecordIndex, int iChannel, int& iOffset,
+																	  int& iLength) const
+{
+	if (getEffectiveFilterBounds(iRecordIndex, iChannel, iOffset, iLength) != DAFF_NO_ERROR)
+		return NULL;
+	return getFilterPtr(iRecordIndex, iChannel) + iOffset;
+}
+
+int DAFFTransformerIR2Resampled::getFilterEnvelope(int iRecordIndex, int iChannel, int iFirstSample, int iNumSamples,
+												   int iNumBins, float* pfMin, float* pfMax) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel);
+	assert(pfData != NULL);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	if ((iFirstSample < 0) || (iNumBins < 1) || (iNumBins > iNumSamples) || (iNumSamples > m_iLength - iFirstSample))
+		return DAFF_INVALID_INDEX;
+
+	for (int k = 0; k < iNumBins; k++) {
+		int iBegin = iFirstSample + (int)((int64_t)k * iNumSamples / iNumBins);
+		int iEnd = iFirstSample + (int)((int64_t)(k + 1) * iNumSamples / iNumBins);
+		pfMin[k] = pfMax[k] = pfData[iBegin];
+		DAFF::minmax_float(pfData + iBegin, iEnd - iBegin, pfMin[k], pfMax[k]);
+	}
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2Resampled::getRecord(int iRecordIndex, float** ppfChannelDest) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return DAFF_INVALID_INDEX;
+
+	assert(ppfChannelDest != 0);
+	for (int c = 0; c < iChannels; c++)
+		if (ppfChannelDest[c])
+			memcpy(ppfChannelDest[c], getFilterPtr(iRecordIndex, c), m_iLength * sizeof(float));
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerIR2Resampled::getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert(iStride >= iChannels);
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return DAFF_INVALID_INDEX;
+	if (iStride < iChannels)
+		return DAFF_MODAL_ERROR;
+
+	assert(pfDest != 0);
+	for (int c = 0; c < iChannels; c++) {
+		const float* pfData = getFilterPtr(iRecordIndex, c);
+		for (int i = 0; i < m_iLength; i++)
+			pfDest[i * iStride + c] = pfData[i];
+	}
+	return DAFF_NO_ERROR;
+}
+
+float DAFFTransformerIR2Resampled::getChannelPeak(int iChannel) const
+{
+	if ((iChannel < 0) || (iChannel >= (int)m_vfChannelPeaks.size()))
+		return 0;
+	return m_vfChannelPeaks[iChannel];
+}
+
+float DAFFTransformerIR2Resampled::getRecordPeak(int iRecordIndex, int iChannel) const
+{
+	if (!getFilterPtr(iRecordIndex, iChannel))
+		return 0;
+
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	return m_vfPeaks[(size_t)iRecordIndex * iChannels + iChannel];
+}
+
+int DAFFTransformerIR2Resampled::getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	const float* pfData = getFilterPtr(iRecordIndex, iChannel);
+	if (!pfData)
+		return DAFF_INVALID_INDEX;
+
+	// Same definitions as for stored impulse responses (see DAFFContentIR::getRecordStatistics)
+	double dEnergy = 0;
+	for (int i = 0; i < m_iLength; i++)
+		dEnergy += (double)pfData[i] * pfData[i];
+	oStats.fPeak = getRecordPeak(iRecordIndex, iChannel);
+	oStats.fEnergy = (float)dEnergy;
+	oStats.fRMS = (float)std::sqrt(dEnergy / m_iLength);
+
+	oStats.iOnset = -1;
+	for (int i = 0; (i < m_iLength) && (oStats.fPeak > 0); i++) {
+		if (std::fabs(pfData[i]) >= 0.1f * oStats.fPeak) {
+			oStats.iOnset = i;
+			break;
+		}
+	}
+
+	return DAFF_NO_ERROR;
+}
@@ -0,0 +1,789 @@
+#include <DAFFTransformerMS2Bands.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <system_error>
+#include <thread>
+
+#include "DAFFInstrumentationImpl.h"
+#include "DAFFPropertiesImpl.h"
+#include "DAFFRecordCache.h"
+#include "Utils.h"
+
+// Inner content interface realization
+class DAFFContentMSBandsRealization : public DAFFContentMS {
+  public:
+	inline DAFFContentMSBandsRealization(DAFFTransformerMS2Bands* pParent, const DAFFContent* pInputContent)
+		: m_pParent(pParent), m_pInputContent(pInputContent)
+	{
+		m_oProps = *(pInputContent->getProperties());
+		m_oProps.m_iContentType = DAFF_MAGNITUDE_SPECTRUM;
+		m_oProps.m_iQuantization = DAFF_FLOAT32;
+	};
+
+	inline virtual ~DAFFContentMSBandsRealization() {};
+
+	// --= Interface "DAFFContentMS" =--
+
+	inline int getNumFrequencies() const { return (int)m_pParent->getFrequencies().size(); };
+
+	inline const std::vector<float>& getFrequencies() const { return m_pParent->getFrequencies(); };
+
+	inline float getOverallMagnitudeMaximum() const { return m_pParent->getOverallMagnitudeMaximum(); };
+
+	inline int getMagnitudes(int iRecordIndex, int iChannel, float* pfDest) const
+	{
+		return m_pParent->getMagnitudes(iRecordIndex, iChannel, pfDest);
+	};
+
+	inline int addMagnitudes(int iRecordIndex, int iChannel, float* pfDest, float fGain = 1.0F) const
+	{
+		return m_pParent->addMagnitudes(iRecordIndex, iChannel, pfDest, fGain);
+	};
+
+	inline int getRecord(int iRecordIndex, float** ppfChannelDest) const
+	{
+		return m_pParent->getRecord(iRecordIndex, ppfChannelDest);
+	};
+
+	inline int getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const
+	{
+		return m_pParent->getRecordInterleaved(iRecordIndex, pfDest, iStride);
+	};
+
+	inline int getMagnitude(int iRecordIndex, int iChannel, int iFreqIndex, float& fMag) const
+	{
+		return m_pParent->getMagnitude(iRecordIndex, iChannel, iFreqIndex, fMag);
+	};
+
+	inline int getMagnitudeSlice(int iChannel, int iFreqIndex, float* pfDest) const
+	{
+		return m_pParent->getMagnitudeSlice(iChannel, iFreqIndex, pfDest);
+	};
+
+	inline const float* getMagnitudesPtr(int iRecordIndex, int iChannel) const
+	{
+		return m_pParent->getMagnitudesPtr(iRecordIndex, iChannel);
+	};
+
+	inline int getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const
+	{
+		return m_pParent->getRecordStatistics(iRecordIndex, iChannel, oStats);
+	};
+
+	// --= Interface "DAFFContent" =--
+
+	// This interface is completely delegated to the input content of the transform
+
+	inline DAFFReader* getParent() const { return m_pInputContent->getParent(); };
+
+	inline const DAFFPropertiesImpl* getProperties() const { return &m_oProps; };
+
+	inline const DAFFMetadata* getRecordMetadata(int iRecordIndex) const
+	{
+		return m_pInputContent->getRecordMetadata(iRecordIndex);
+	};
+
+	inline int getRecordCoords(int iRecordIndex, int iView, float& fAngle1, float& fAngle2) const
+	{
+		return m_pInputContent->getRecordCoords(iRecordIndex, iView, fAngle1, fAngle2);
+	};
+
+	inline void getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex) const
+	{
+		m_pInputContent->getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex);
+	};
+
+	inline void getNearestNeighbour(int iView, float fAngle1, float fAngle2, int& iRecordIndex,
+									bool& bOutOfBounds) const
+	{
+		m_pInputContent->getNearestNeighbour(iView, fAngle1, fAngle2, iRecordIndex, bOutOfBounds);
+	};
+
+	inline void getNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int* piRecordIndices,
+									 bool* pbOutOfBounds, size_t n) const
+	{
+		m_pInputContent->getNearestNeighbours(iView, pfAngles1, pfAngles2, piRecordIndices, pbOutOfBounds, n);
+	};
+
+	inline int getKNearestNeighbours(int iView, float fAngle1, float fAngle2, int k, int* piRecordIndices,
+									 float* pfDistances) const
+	{
+		return m_pInputContent->getKNearestNeighbours(iView, fAngle1, fAngle2, k, piRecordIndices, pfDistances);
+	};
+
+	inline int getKNearestNeighbours(int iView, const float* pfAngles1, const float* pfAngles2, int k,
+									 int* piRecordIndices, float* pfDistances, size_t n) const
+	{
+		return m_pInputContent->getKNearestNeighbours(iView, pfAngles1, pfAngles2, k, piRecordIndices, pfDistances,
+													  n);
+	};
+
+	inline int getRecordsInCone(int iView, float fAngle1, float fAngle2, float fRadius,
+								std::vector<int>& viRecordIndices) const
+	{
+		return m_pInputContent->getRecordsInCone(iView, fAngle1, fAngle2, fRadius, viRecordIndices);
+	};
+
+	inline int getRecordsInCone(int iView, const float* pfAngles1, const float* pfAngles2, float fRadius,
+								std::vector<int>& viRecordIndices, std::vector<int>& viOffsets, size_t n) const
+	{
+		return m_pInputContent->getRecordsInCone(iView, pfAngles1, pfAngles2, fRadius, viRecordIndices, viOffsets,
+												 n);
+	};
+
+	inline void getCell(int iView, float fAngle1, float fAngle2, DAFFQuad& qIndices) const
+	{
+		m_pInputContent->getCell(iView, fAngle1, fAngle2, qIndices);
+	};
+
+	inline void transformAnglesD2O(float fAlpha, float fBeta, float& fAzimuth, float& fElevation) const
+	{
+		m_pInputContent->transformAnglesD2O(fAlpha, fBeta, fAzimuth, fElevation);
+	};
+
+	inline void transformAnglesO2D(float fAzimuth, float fElevation, float& fAlpha, float& fBeta) const
+	{
+		m_pInputContent->transformAnglesO2D(fAzimuth, fElevation, fAlpha, fBeta);
+	};
+
+  private:
+	DAFFTransformerMS2Bands* m_pParent;
+	const DAFFContent* m_pInputContent;
+	DAFFPropertiesImpl m_oProps;
+};
+
+//! Appends the interpolation of the input values at a frequency to a matrix row (constant beyond the support)
+static void addInterpolation(const std::vector<double>& vdInput, double dFrequency, bool bLog,
+							 std::vector<int>& viColumns, std::vector<float>& vfWeights)
+{
+	int n = (int)vdInput.size();
+	int j = (int)(std::upper_bound(vdInput.begin(), vdInput.end(), dFrequency) - vdInput.begin()) - 1;
+	if (j < 0 || j >= n - 1) {
+		viColumns.push_back(std::min(std::max(j, 0), n - 1));
+		vfWeights.push_back(1.0f);
+		return;
+	}
+
+	// The DC coefficient of DFT spectra is interpolated linearly
+	double t;
+	if (bLog && (vdInput[j] > 0))
+		t = std::log(dFrequency / vdInput[j]) / std::log(vdInput[j + 1] / vdInput[j]);
+	else
+		t = (dFrequency - vdInput[j]) / (vdInput[j + 1] - vdInput[j]);
+
+	viColumns.push_back(j);
+	vfWeights.push_back((float)(1 - t));
+	viColumns.push_back(j + 1);
+	vfWeights.push_back((float)t);
+}
+
+//! Band edges at the geometric means of neighbouring frequencies, outer edges mirrored (one octave for n = 1)
+static void getBandEdges(const std::vector<double>& vdFrequencies, std::vector<double>& vdEdges)
+{
+	int n = (int)vdFrequencies.size();
+	vdEdges.resize(n + 1);
+	for (int i = 1; i < n; i++)
+		vdEdges[i] = std::sqrt(vdFrequencies[i - 1] * vdFrequencies[i]);
+	vdEdges[0] = (n > 1 ? vdFrequencies[0] * vdFrequencies[0] / vdEdges[1] : vdFrequencies[0] / std::sqrt(2.0));
+	vdEdges[n] = (n > 1 ? vdFrequencies[n - 1] * vdFrequencies[n - 1] / vdEdges[n - 1]
+						: vdFrequencies[0] * std::sqrt(2.0));
+}
+
+DAFFTransformerMS2Bands::DAFFTransformerMS2Bands()
+	: m_pInputContent(NULL), m_pInputContentMS(NULL), m_pInputContentDFT(NULL), m_pOutputContent(NULL),
+	  m_iMode(DAFF_REMAP_LOG), m_iNumThreads(0), m_bLazy(false), m_pCache(new DAFFRecordCache), m_pfBuf(NULL),
+	  m_iInputSize(0), m_iElementSize(0), m_fOverallMagnitudePeak(0), m_bPeakKnown(false)
+{
+}
+
+DAFFTransformerMS2Bands::DAFFTransformerMS2Bands(const DAFFContentMS* pInputContent,
+												 const std::vector<float>& vfFrequencies, int iMode, bool bTransform)
+	: m_pInputContent(NULL), m_pInputContentMS(NULL), m_pInputContentDFT(NULL), m_pOutputContent(NULL),
+	  m_vfFrequencies(vfFrequencies), m_iMode(iMode), m_iNumThreads(0), m_bLazy(false),
+	  m_pCache(new DAFFRecordCache), m_pfBuf(NULL), m_iInputSize(0), m_iElementSize(0), m_fOverallMagnitudePeak(0),
+	  m_bPeakKnown(false)
+{
+	assert(!m_vfFrequencies.empty());
+	setInputContent(pInputContent, bTransform);
+}
+
+DAFFTransformerMS2Bands::DAFFTransformerMS2Bands(const DAFFContentDFT* pInputContent,
+												 const std::vector<float>& vfFrequencies, int iMode, bool bTransform)
+	: m_pInputContent(NULL), m_pInputContentMS(NULL), m_pInputContentDFT(NULL), m_pOutputContent(NULL),
+	  m_vfFrequencies(vfFrequencies), m_iMode(iMode), m_iNumThreads(0), m_bLazy(false),
+	  m_pCache(new DAFFRecordCache), m_pfBuf(NULL), m_iInputSize(0), m_iElementSize(0), m_fOverallMagnitudePeak(0),
+	  m_bPeakKnown(false)
+{
+	assert(!m_vfFrequencies.empty());
+	setInputContent(pInputContent, bTransform);
+}
+
+DAFFTransformerMS2Bands::~DAFFTransformerMS2Bands()
+{
+	clear();
+	delete m_pCache;
+}
+
+void DAFFTransformerMS2Bands::setInputContent(const DAFFContentMS* pInputContent, bool bTransform)
+{
+	// The output content delegates to the input content
+	clear();
+	m_pInputContent = pInputContent;
+	m_pInputContentMS = pInputContent;
+	m_pInputContentDFT = NULL;
+	if (bTransform)
+		transform();
+}
+
+void DAFFTransformerMS2Bands::setInputContent(const DAFFContentDFT* pInputContent, bool bTransform)
+{
+	clear();
+	m_pInputContent = pInputContent;
+	m_pInputContentMS = NULL;
+	m_pInputContentDFT = pInputContent;
+	if (bTransform)
+		transform();
+}
+
+DAFFContentMS* DAFFTransformerMS2Bands::getOutputContent() const
+{
+	return m_pOutputContent;
+}
+
+const std::vector<float>& DAFFTransformerMS2Bands::getFrequencies() const
+{
+	return m_vfFrequencies;
+}
+
+void DAFFTransformerMS2Bands::setFrequencies(const std::vector<float>& vfFrequencies, bool bTransform)
+{
+	assert(!vfFrequencies.empty());
+
+	// The output content refers to the frequencies
+	clear();
+	m_vfFrequencies = vfFrequencies;
+	if (bTransform)
+		transform();
+}
+
+int DAFFTransformerMS2Bands::getMode() const
+{
+	return m_iMode;
+}
+
+void DAFFTransformerMS2Bands::setMode(int iMode, bool bTransform)
+{
+	assert((iMode == DAFF_REMAP_LINEAR) || (iMode == DAFF_REMAP_LOG) || (iMode == DAFF_REMAP_BANDS));
+	m_iMode = iMode;
+	if (bTransform)
+		transform();
+}
+
+int DAFFTransformerMS2Bands::getNumThreads() const
+{
+	return m_iNumThreads;
+}
+
+void DAFFTransformerMS2Bands::setNumThreads(int iNumThreads)
+{
+	m_iNumThreads = (iNumThreads > 0 ? iNumThreads : 0);
+}
+
+bool DAFFTransformerMS2Bands::isLazy() const
+{
+	return m_bLazy;
+}
+
+void DAFFTransformerMS2Bands::setLazy(bool bLazy, bool bTransform)
+{
+	m_bLazy = bLazy;
+	if (bTransform)
+		transform();
+}
+
+size_t DAFFTransformerMS2Bands::getLazyCacheSize() const
+{
+	std::lock_guard<std::mutex> lock(m_mxCache);
+	return m_pCache->getMaxSize();
+}
+
+void DAFFTransformerMS2Bands::setLazyCacheSize(size_t nMaxBytes)
+{
+	std::lock_guard<std::mutex> lock(m_mxCache);
+	m_pCache->setMaxSize(nMaxBytes);
+}
+
+void DAFFTransformerMS2Bands::getMatrix(std::vector<int>& viRowBegin, std::vector<int>& viColumns,
+										std::vector<float>& vfWeights) const
+{
+	viRowBegin = m_viRowBegin;
+	viColumns = m_viColumns;
+	vfWeights = m_vfWeights;
+}
+
+size_t DAFFTransformerMS2Bands::getMemoryFootprint() const
+{
+	size_t nBytes = (m_vfFrequencies.capacity() + m_vfScratch.capacity() + m_vfWeights.capacity()) * sizeof(float) +
+					(m_viRowBegin.capacity() + m_viColumns.capacity()) * sizeof(int);
+	if (m_pInputContent && m_pfBuf)
+		nBytes += (size_t)m_pInputContent->getProperties()->getNumberOfRecords() *
+				  m_pInputContent->getProperties()->getNumberOfChannels() * m_iElementSize * sizeof(float);
+
+	std::lock_guard<std::mutex> lock(m_mxCache);
+	return nBytes + m_pCache->getSize();
+}
+
+void DAFFTransformerMS2Bands::clear()
+{
+	delete m_pOutputContent;
+	m_pOutputContent = NULL;
+
+	DAFF::free_aligned16(m_pfBuf);
+	m_pfBuf = NULL;
+
+	std::vector<float>().swap(m_vfScratch);
+	m_viRowBegin.clear();
+	m_viColumns.clear();
+	m_vfWeights.clear();
+
+	m_pCache->clear();
+	m_bPeakKnown = false;
+}
+
+void DAFFTransformerMS2Bands::transform()
+{
+	// Discard previous magnitudes
+	clear();
+
+	m_fOverallMagnitudePeak = 0;
+
+	if (!m_pInputContent || m_vfFrequencies.empty())
+		return;
+
+	m_iInputSize = (m_pInputContentMS ? m_pInputContentMS->getNumFrequencies() : m_pInputContentDFT->getNumDFTCoeffs());
+	if (m_iInputSize <= 0)
+		return;
+
+	m_pOutputContent = new DAFFContentMSBandsRealization(this, m_pInputContent);
+	m_iElementSize = (int)m_vfFrequencies.size();
+	initMatrix();
+
+	// Lazy: magnitudes are computed on first access
+	if (m_bLazy) {
+		m_vfScratch.resize(2 * (size_t)m_iInputSize);
+		return;
+	}
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int iNumRecordChannels = iRecords * iChannels;
+	m_pfBuf = static_cast<float*>(DAFF::malloc_aligned16((size_t)iNumRecordChannels * m_iElementSize * sizeof(float)));
+
+	// Distribute the record channels over several threads, each transforming a range
+	int iNumThreads = m_iNumThreads;
+	if (iNumThreads <= 0) {
+		const uint64_t ui64MinValuesPerThread = 1 << 16;
+		uint64_t ui64NumValues = (uint64_t)iNumRecordChannels * (m_iInputSize + m_vfWeights.size());
+		uint64_t ui64MaxThreads = std::max(ui64NumValues / ui64MinValuesPerThread, (uint64_t)1);
+		iNumThreads = (int)std::min((uint64_t)std::max(std::thread::hardware_concurrency(), 1u), ui64MaxThreads);
+	}
+
+	std::vector<std::thread> vThreads;
+	int iChunk = (iNumRecordChannels + iNumThreads - 1) / iNumThreads;
+	std::vector<float> vfPeaks(iNumThreads, 0.0f);
+	for (int i = 1; i * iChunk < iNumRecordChannels; i++) {
+		int iBegin = i * iChunk;
+		int iEnd = std::min(iBegin + iChunk, iNumRecordChannels);
+		try {
+			vThreads.push_back(std::thread(&DAFFTransformerMS2Bands::transformRange, this, iBegin, iEnd, &vfPeaks[i]));
+		} catch (const std::system_error&) {
+			transformRange(iBegin, iEnd, &vfPeaks[i]);  // No more threads available
+		}
+	}
+
+	transformRange(0, std::min(iChunk, iNumRecordChannels), &vfPeaks[0]);
+
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	for (size_t i = 0; i < vfPeaks.size(); i++)
+		m_fOverallMagnitudePeak = (std::max)(m_fOverallMagnitudePeak, vfPeaks[i]);
+	m_bPeakKnown = true;
+}
+
+void DAFFTransformerMS2Bands::initMatrix()
+{
+	// Input support: the frequencies of magnitude spectra or the bins of DFT spectra
+	std::vector<double> vdInput(m_iInputSize);
+	if (m_pInputContentMS) {
+		const std::vector<float>& vfInput = m_pInputContentMS->getFrequencies();
+		for (int j = 0; j < m_iInputSize; j++)
+			vdInput[j] = vfInput[j];
+	} else {
+		double dBinWidth = m_pInputContentDFT->getFrequencyBandwidth();
+		for (int j = 0; j < m_iInputSize; j++)
+			vdInput[j] = j * dBinWidth;
+	}
+
+	std::vector<double> vdTarget(m_vfFrequencies.begin(), m_vfFrequencies.end());
+	std::vector<double> vdTargetEdges, vdInputEdges;
+	if (m_iMode == DAFF_REMAP_BANDS) {
+		getBandEdges(vdTarget, vdTargetEdges);
+
+		// Input bands: the bins of DFT spectra reach half the bin width to each side
+		if (m_pInputContentMS) {
+			getBandEdges(vdInput, vdInputEdges);
+		} else {
+			vdInputEdges.resize(m_iInputSize + 1);
+			double dBinWidth = m_pInputContentDFT->getFrequencyBandwidth();
+			for (int j = 0; j <= m_iInputSize; j++)
+				vdInputEdges[j] = std::max(j - 0.5, 0.0) * dBinWidth;
+		}
+	}
+
+	m_viRowBegin.resize(m_iElementSize + 1);
+	for (int i = 0; i < m_iElementSize; i++) {
+		m_viRowBegin[i] = (int)m_viColumns.size();
+		if (m_iMode != DAFF_REMAP_BANDS) {
+			addInterpolation(vdInput, vdTarget[i], (m_iMode == DAFF_REMAP_LOG), m_viColumns, m_vfWeights);
+			continue;
+		}
+
+		// Overlap of the input bands with the target band
+		double dLower = vdTargetEdges[i], dUpper = vdTargetEdges[i + 1];
+		int iFirst = (int)(std::upper_bound(vdInputEdges.begin(), vdInputEdges.end(), dLower) - vdInputEdges.begin());
+		double dTotal = 0;
+		for (int j = std::max(iFirst - 1, 0); (j < m_iInputSize) && (vdInputEdges[j] < dUpper); j++) {
+			double dOverlap = std::min(vdInputEdges[j + 1], dUpper) - std::max(vdInputEdges[j], dLower);
+			if (dOverlap <= 0)
+				continue;
+			m_viColumns.push_back(j);
+			m_vfWeights.push_back((float)dOverlap);
+			dTotal += dOverlap;
+		}
+
+		if (m_viColumns.size() - m_viRowBegin[i] < 2) {
+			m_viColumns.resize(m_viRowBegin[i]);
+			m_vfWeights.resize(m_viRowBegin[i]);
+			addInterpolation(vdInput, vdTarget[i], true, m_viColumns, m_vfWeights);
+		} else {
+			for (size_t j = m_viRowBegin[i]; j < m_vfWeights.size(); j++)
+				m_vfWeights[j] = (float)(m_vfWeights[j] / dTotal);
+		}
+	}
+	m_viRowBegin[m_iElementSize] = (int)m_viColumns.size();
+}
+
+float DAFFTransformerMS2Bands::transformMagnitudes(int iRecordIndex, int iChannel, float* pfInput,
+												   float* pfDest) const
+{
+	int iError;
+	if (m_pInputContentMS) {
+		iError = m_pInputContentMS->getMagnitudes(iRecordIndex, iChannel, pfInput);
+	} else {
+		// Magnitudes of the DFT coefficients (in place)
+		iError = m_pInputContentDFT->getDFTCoeffs(iRecordIndex, iChannel, pfInput);
+		for (int k = 0; k < m_iInputSize; k++)
+			pfInput[k] = std::sqrt(pfInput[2 * k] * pfInput[2 * k] + pfInput[2 * k + 1] * pfInput[2 * k + 1]);
+	}
+	if (iError != DAFF_NO_ERROR)
+		memset(pfInput, 0, m_iInputSize * sizeof(float));
+
+	bool bEnergetic = (m_iMode == DAFF_REMAP_BANDS);
+	float fPeak = 0;
+	for (int i = 0; i < m_iElementSize; i++) {
+		float fSum = 0;
+		if (bEnergetic) {
+			for (int j = m_viRowBegin[i]; j < m_viRowBegin[i + 1]; j++)
+				fSum += m_vfWeights[j] * pfInput[m_viColumns[j]] * pfInput[m_viColumns[j]];
+			fSum = std::sqrt(fSum);
+		} else {
+			for (int j = m_viRowBegin[i]; j < m_viRowBegin[i + 1]; j++)
+				fSum += m_vfWeights[j] * pfInput[m_viColumns[j]];
+		}
+
+		pfDest[i] = fSum;
+		fPeak = (std::max)(fPeak, fSum);
+	}
+
+	return fPeak;
+}
+
+void DAFFTransformerMS2Bands::transformRange(int iBegin, int iEnd, float* pfPeak)
+{
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	std::vector<float> vfInput(2 * (size_t)m_iInputSize);
+
+	float fPeak = 0;
+	for (int n = iBegin; n < iEnd; n++)
+		fPeak = (std::max)(fPeak, transformMagnitudes(n / iChannels, n % iChannels, &vfInput[0],
+													  m_pfBuf + (size_t)n * m_iElementSize));
+
+	*pfPeak = fPeak;
+}
+
+std::unique_lock<std::mutex> DAFFTransformerMS2Bands::lockCache() const
+{
+	if (m_bLazy)
+		return std::unique_lock<std::mutex>(m_mxCache);
+	return std::unique_lock<std::mutex>();
+}
+
+const float* DAFFTransformerMS2Bands::getMagnitudesPtrLocked(int iRecordIndex, int iChannel) const
+{
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+	int64_t iKey = (int64_t)iRecordIndex * iChannels + iChannel;
+	if (!m_bLazy)
+		return m_pfBuf + iKey * m_iElementSize;
+
+	float* pfData = static_cast<float*>(m_pCache->find(iKey));
+	DAFF_INSTRUMENT_COUNT(pfData ? DAFF_COUNTER_TRANSFORMER_CACHE_HITS : DAFF_COUNTER_TRANSFORMER_CACHE_MISSES, 1);
+	if (pfData)
+		return pfData;
+
+	pfData = static_cast<float*>(m_pCache->insert(iKey, m_iElementSize * sizeof(float)));
+	if (pfData == NULL)
+		return NULL;
+
+	// The scratch buffer is guarded by the cache lock
+	transformMagnitudes(iRecordIndex, iChannel, &m_vfScratch[0], pfData);
+
+	return pfData;
+}
+
+float DAFFTransformerMS2Bands::getOverallMagnitudeMaximum() const
+{
+	std::unique_lock<std::mutex> lock = lockCache();
+
+	// Lazy: all records have to be transformed once (without caching them)
+	if (!m_bPeakKnown && m_pOutputContent) {
+		int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+		int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+		std::vector<float> vfMagnitudes(m_iElementSize);
+
+		float fPeak = 0;
+		for (int n = 0; n < iRecords * iChannels; n++)
+			fPeak = (std::max)(fPeak, transformMagnitudes(n / iChannels, n % iChannels,
+														  &m_vfScratch[0], &vfMagnitudes[0]));
+
+		m_fOverallMagnitudePeak = fPeak;
+		m_bPeakKnown = true;
+	}
+
+	return m_fOverallMagnitudePeak;
+}
+
+int DAFFTransformerMS2Bands::getMagnitudes(int iRecordIndex, int iChannel, float* pfDest) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert((iChannel >= 0) && (iChannel < iChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords) || (iChannel < 0) || (iChannel >= iChannels))
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getMagnitudesPtrLocked(iRecordIndex, iChannel);
+	if (!pfData)
+		return DAFF_MODAL_ERROR;
+
+	memcpy(pfDest, pfData, m_iElementSize * sizeof(float));
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerMS2Bands::addMagnitudes(int iRecordIndex, int iChannel, float* pfDest, float fGain) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert((iChannel >= 0) && (iChannel < iChannels));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords) || (iChannel < 0) || (iChannel >= iChannels))
+		return DAFF_INVALID_INDEX;
+
+	if (pfDest == NULL)
+		return DAFF_NO_ERROR;
+
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getMagnitudesPtrLocked(iRecordIndex, iChannel);
+	if (!pfData)
+		return DAFF_MODAL_ERROR;
+
+	for (int i = 0; i < m_iElementSize; i++)
+		pfDest[i] += pfData[i] * fGain;
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerMS2Bands::getRecord(int iRecordIndex, float** ppfChannelDest) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return DAFF_INVALID_INDEX;
+
+	assert(ppfChannelDest != 0);
+	std::unique_lock<std::mutex> lock = lockCache();
+	for (int c = 0; c < iChannels; c++) {
+		if (!ppfChannelDest[c])
+			continue;
+
+		const float* pfData = getMagnitudesPtrLocked(iRecordIndex, c);
+		if (!pfData)
+			return DAFF_MODAL_ERROR;
+
+		memcpy(ppfChannelDest[c], pfData, m_iElementSize * sizeof(float));
+	}
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerMS2Bands::getRecordInterleaved(int iRecordIndex, float* pfDest, int iStride) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert(iStride >= iChannels);
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords))
+		return DAFF_INVALID_INDEX;
+	if (iStride < iChannels)
+		return DAFF_MODAL_ERROR;
+
+	assert(pfDest != 0);
+	std::unique_lock<std::mutex> lock = lockCache();
+	for (int c = 0; c < iChannels; c++) {
+		const float* pfData = getMagnitudesPtrLocked(iRecordIndex, c);
+		if (!pfData)
+			return DAFF_MODAL_ERROR;
+
+		for (int i = 0; i < m_iElementSize; i++)
+			pfDest[i * iStride + c] = pfData[i];
+	}
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerMS2Bands::getMagnitude(int iRecordIndex, int iChannel, int iFreqIndex, float& fMag) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iRecordIndex >= 0) && (iRecordIndex < iRecords));
+	assert((iChannel >= 0) && (iChannel < iChannels));
+	assert((iFreqIndex >= 0) && (iFreqIndex < m_iElementSize));
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords) || (iChannel < 0) || (iChannel >= iChannels) ||
+		(iFreqIndex < 0) || (iFreqIndex >= m_iElementSize))
+		return DAFF_INVALID_INDEX;
+
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getMagnitudesPtrLocked(iRecordIndex, iChannel);
+	if (!pfData)
+		return DAFF_MODAL_ERROR;
+
+	fMag = pfData[iFreqIndex];
+	return DAFF_NO_ERROR;
+}
+
+int DAFFTransformerMS2Bands::getMagnitudeSlice(int iChannel, int iFreqIndex, float* pfDest) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	assert((iChannel >= 0) && (iChannel < iChannels));
+	assert((iFreqIndex >= 0) && (iFreqIndex < m_iElementSize));
+
+	if ((iChannel < 0) || (iChannel >= iChannels) || (iFreqIndex < 0) || (iFreqIndex >= m_iElementSize))
+		return DAFF_INVALID_INDEX;
+
+	assert(pfDest != 0);
+	std::unique_lock<std::mutex> lock = lockCache();
+	for (int i = 0; i < iRecords; i++) {
+		const float* pfData = getMagnitudesPtrLocked(i, iChannel);
+		if (!pfData)
+			return DAFF_MODAL_ERROR;
+
+		pfDest[i] = pfData[iFreqIndex];
+	}
+	return DAFF_NO_ERROR;
+}
+
+const float* DAFFTransformerMS2Bands::getMagnitudesPtr(int iRecordIndex, int iChannel) const
+{
+	if (!m_pOutputContent)
+		return NULL;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords) || (iChannel < 0) || (iChannel >= iChannels))
+		return NULL;
+
+	std::unique_lock<std::mutex> lock = lockCache();
+	return getMagnitudesPtrLocked(iRecordIndex, iChannel);
+}
+
+int DAFFTransformerMS2Bands::getRecordStatistics(int iRecordIndex, int iChannel, DAFFRecordStatistics& oStats) const
+{
+	if (!m_pOutputContent)
+		return DAFF_MODAL_ERROR;
+
+	int iRecords = m_pInputContent->getProperties()->getNumberOfRecords();
+	int iChannels = m_pInputContent->getProperties()->getNumberOfChannels();
+
+	if ((iRecordIndex < 0) || (iRecordIndex >= iRecords) || (iChannel < 0) || (iChannel >= iChannels))
+		return DAFF_INVALID_INDEX;
+
+	std::unique_lock<std::mutex> lock = lockCache();
+	const float* pfData = getMagnitudesPtrLocked(iRecordIndex, iChannel);
+	if (!pfData)
+		return DAFF_MODAL_ERROR;
+
+	// Same definitions as for stored magnitude spectra (see DAFFContentMS::getRecordStatistics)
+	double dEnergy = 0;
+	oStats.fPeak = 0;
+	for (int i = 0; i < m_iElementSize; i++) {
+		oStats.fPeak = (std::max)(oStats.fPeak, pfData[i]);
+		dEnergy += (double)pfData[i] * pfData[i];
+	}
+	oStats.fEnergy = (float)dEnergy;
+	oStats.fRMS = (float)std::sqrt(dEnergy / m_iElementSize);
+
+	oStats.iOnset = -1;
+	for (int i = 0; (i < m_iElementSize) && (oStats.fPeak > 0); i++) {
+		if (pfData[i] >= 0.1f * oStats.fPeak) {
+			oStats.iOnset = i;
+			break;
+		}
+	}
+
+	return DAFF_NO_ERROR;
+}
@@ -7,6 +7,8 @@
 #include <cstring>
 #include <iomanip>
 
+#include "DAFFSIMD.h"
+
 // Define necessary roundf for Microsoft compilers
 #ifdef _MSC_VER
 #define roundf(x) (x < 0 ? ceil((x) - 0.5f) : floor((x) + 0.5f));
@@ -144,6 +146,14 @@ std::string DAFFUtils::StrError(int iErrorcode)
 		return "Metadata type unkown (valid: bool, int, double, string)";
 	case DAFF_INVALID_INDEX:
 		return "Invalid index";
+	case DAFF_FILE_CHECKSUM_MISMATCH:
+		return "File corrupted (checksum mismatch)";
+	case DAFF_OPEN_CANCELLED:
+		return "Opening cancelled";
+	case DAFF_DEVICE_ERROR:
+		return "GPU device error";
+	case DAFF_FETCH_CANCELLED:
+		return "Fetch cancelled";
 	case DAFF_FILE_INVALID_MAIN_PARAMETER:
 		return "Invalid main header parameter (num channels, etc. )";
 	case DAFF_FILE_INVALID:
@@ -229,6 +239,42 @@ std::string DAFFUtils::StrQuantizationType(int iQuantizationType)
 		return "24-bit signed integer";
 	case DAFF_FLOAT32:
 		return "32-bit floating point";
+	case DAFF_FLOAT16:
+		return "16-bit floating point";
+	case DAFF_BFLOAT16:
+		return "16-bit brain floating point";
+	case DAFF_INT16_BFP:
+		return "16-bit block floating point";
+
+	default:
+		return "Invalid";
+	}
+}
+
+std::string DAFFUtils::StrSymmetry(int iSymmetry)
+{
+	switch (iSymmetry) {
+	case DAFF_SYMMETRY_NONE:
+		return "none";
+	case DAFF_SYMMETRY_AXIAL:
+		return "axial";
+	case DAFF_SYMMETRY_MIRROR:
+		return "mirror";
+
+	default:
+		return "Invalid";
+	}
+}
+
+std::string DAFFUtils::StrRecordOrder(int iRecordOrder)
+{
+	switch (iRecordOrder) {
+	case DAFF_RECORD_ORDER_INDEX:
+		return "record index";
+	case DAFF_RECORD_ORDER_MORTON:
+		return "Morton curve";
+	case DAFF_RECORD_ORDER_HILBERT:
+		return "Hilbert curve";
 
 	default:
 		return "Invalid";
@@ -246,6 +292,14 @@ void DAFFUtils::NormalizeDirection(int iView, float fAngle1In, float fAngle2In,
 		 *  - At poles (beta=0&deg;|beta=180&deg;) default: alpha = 0
 		 */
 
+		// Fast path for the common ranges (same results)
+		if (DAFF::is_direction_dsc_in_range(fAngle1In, fAngle2In)) {
+			fAngle1Out = fAngle1In;
+			fAngle2Out = fAngle2In;
+			DAFF::normalize_direction_dsc(fAngle1Out, fAngle2Out);
+			return;
+		}
+
 		float fAlpha = fAngle1In;
 		float fBeta = fmodf(fAngle2In, 360.0f);
 
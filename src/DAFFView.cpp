@@ -0,0 +1,185 @@
+#include <DAFFView.h>
+
+#include <DAFFContent.h>
+#include <DAFFProperties.h>
+
+#include <algorithm>
+#include <cassert>
+
+DAFFView::DAFFView(const DAFFContent* pContent) : m_pContent(pContent)
+{
+	assert(pContent != NULL);
+
+	DAFFOrientationYPR o;
+	m_pContent->getProperties()->getDefaultOrientation(o);
+	m_tTrans.setOrientation(o);
+}
+
+DAFFView::DAFFView(const DAFFContent* pContent, const DAFFOrientationYPR& o) : m_pContent(pContent), m_tTrans(o)
+{
+	assert(pContent != NULL);
+}
+
+const DAFFContent* DAFFView::getContent() const
+{
+	return m_pContent;
+}
+
+void DAFFView::getOrientation(DAFFOrientationYPR& o) const
+{
+	m_tTrans.getOrientation(o);
+}
+
+void DAFFView::setOrientation(const DAFFOrientationYPR& o)
+{
+	m_tTrans.setOrientation(o);
+}
+
+int DAFFView::getRecordCoords(int iRecordIndex, int iView, float& fAngle1Deg, float& fAngle2Deg) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	if (iView == DAFF_DATA_VIEW)
+		return m_pContent->getRecordCoords(iRecordIndex, DAFF_DATA_VIEW, fAngle1Deg, fAngle2Deg);
+
+	float fAlpha, fBeta;
+	int iError = m_pContent->getRecordCoords(iRecordIndex, DAFF_DATA_VIEW, fAlpha, fBeta);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	m_tTrans.transformDSC2OSC(fAlpha, fBeta, fAngle1Deg, fAngle2Deg);
+	return DAFF_NO_ERROR;
+}
+
+void DAFFView::getNearestNeighbour(int iView, float fAngle1Deg, float fAngle2Deg, int& iRecordIndex) const
+{
+	bool bDummy;
+	getNearestNeighbour(iView, fAngle1Deg, fAngle2Deg, iRecordIndex, bDummy);
+}
+
+void DAFFView::getNearestNeighbour(int iView, float fAngle1Deg, float fAngle2Deg, int& iRecordIndex,
+								   bool& bOutOfBounds) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	float fAlpha = fAngle1Deg;
+	float fBeta = fAngle2Deg;
+	if (iView == DAFF_OBJECT_VIEW)
+		m_tTrans.transformOSC2DSC(fAngle1Deg, fAngle2Deg, fAlpha, fBeta);
+
+	m_pContent->getNearestNeighbour(DAFF_DATA_VIEW, fAlpha, fBeta, iRecordIndex, bOutOfBounds);
+}
+
+void DAFFView::getNearestNeighbours(int iView, const float* pfAngles1Deg, const float* pfAngles2Deg,
+									int* piRecordIndices, bool* pbOutOfBounds, size_t n) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	if (iView == DAFF_DATA_VIEW) {
+		m_pContent->getNearestNeighbours(DAFF_DATA_VIEW, pfAngles1Deg, pfAngles2Deg, piRecordIndices, pbOutOfBounds,
+										 n);
+		return;
+	}
+
+	// Object view directions are transformed block-wise into the DSC
+	const size_t BLOCK_SIZE = 256;
+	float pfAlpha[BLOCK_SIZE];
+	float pfBeta[BLOCK_SIZE];
+
+	for (size_t i = 0; i < n; i += BLOCK_SIZE) {
+		size_t m = std::min(BLOCK_SIZE, n - i);
+		m_tTrans.transformOSC2DSC(pfAngles1Deg + i, pfAngles2Deg + i, pfAlpha, pfBeta, m);
+		m_pContent->getNearestNeighbours(DAFF_DATA_VIEW, pfAlpha, pfBeta, piRecordIndices + i,
+										 pbOutOfBounds ? pbOutOfBounds + i : NULL, m);
+	}
+}
+
+int DAFFView::getKNearestNeighbours(int iView, float fAngle1Deg, float fAngle2Deg, int k, int* piRecordIndices,
+									float* pfDistancesDeg) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	float fAlpha = fAngle1Deg;
+	float fBeta = fAngle2Deg;
+	if (iView == DAFF_OBJECT_VIEW)
+		m_tTrans.transformOSC2DSC(fAngle1Deg, fAngle2Deg, fAlpha, fBeta);
+
+	return m_pContent->getKNearestNeighbours(DAFF_DATA_VIEW, fAlpha, fBeta, k, piRecordIndices, pfDistancesDeg);
+}
+
+int DAFFView::getKNearestNeighbours(int iView, const float* pfAngles1Deg, const float* pfAngles2Deg, int k,
+									int* piRecordIndices, float* pfDistancesDeg, size_t n) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	if (iView == DAFF_DATA_VIEW)
+		return m_pContent->getKNearestNeighbours(DAFF_DATA_VIEW, pfAngles1Deg, pfAngles2Deg, k, piRecordIndices,
+												 pfDistancesDeg, n);
+
+	// Object view directions are transformed block-wise into the DSC
+	const size_t BLOCK_SIZE = 256;
+	float pfAlpha[BLOCK_SIZE];
+	float pfBeta[BLOCK_SIZE];
+
+	for (size_t i = 0; i < n; i += BLOCK_SIZE) {
+		size_t m = std::min(BLOCK_SIZE, n - i);
+		m_tTrans.transformOSC2DSC(pfAngles1Deg + i, pfAngles2Deg + i, pfAlpha, pfBeta, m);
+		m_pContent->getKNearestNeighbours(DAFF_DATA_VIEW, pfAlpha, pfBeta, k, piRecordIndices + i * k,
+										  pfDistancesDeg ? pfDistancesDeg + i * k : NULL, m);
+	}
+
+	return std::max(std::min(k, m_pContent->getProperties()->getNumberOfRecords()), 0);
+}
+
+int DAFFView::getRecordsInCone(int iView, float fAngle1Deg, float fAngle2Deg, float fRadiusDeg,
+							   std::vector<int>& viRecordIndices) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	float fAlpha = fAngle1Deg;
+	float fBeta = fAngle2Deg;
+	if (iView == DAFF_OBJECT_VIEW)
+		m_tTrans.transformOSC2DSC(fAngle1Deg, fAngle2Deg, fAlpha, fBeta);
+
+	return m_pContent->getRecordsInCone(DAFF_DATA_VIEW, fAlpha, fBeta, fRadiusDeg, viRecordIndices);
+}
+
+int DAFFView::getRecordsInCone(int iView, const float* pfAngles1Deg, const float* pfAngles2Deg, float fRadiusDeg,
+							   std::vector<int>& viRecordIndices, std::vector<int>& viOffsets, size_t n) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	if (iView == DAFF_DATA_VIEW)
+		return m_pContent->getRecordsInCone(DAFF_DATA_VIEW, pfAngles1Deg, pfAngles2Deg, fRadiusDeg, viRecordIndices,
+											viOffsets, n);
+
+	// Object view directions are transformed into the DSC at once
+	std::vector<float> vfAlpha(n), vfBeta(n);
+	if (n > 0)
+		m_tTrans.transformOSC2DSC(pfAngles1Deg, pfAngles2Deg, &vfAlpha[0], &vfBeta[0], n);
+
+	return m_pContent->getRecordsInCone(DAFF_DATA_VIEW, vfAlpha.data(), vfBeta.data(), fRadiusDeg, viRecordIndices,
+										viOffsets, n);
+}
+
+void DAFFView::getCell(int iView, float fAngle1Deg, float fAngle2Deg, DAFFQuad& qIndices) const
+{
+	assert((iView == DAFF_DATA_VIEW) || (iView == DAFF_OBJECT_VIEW));
+
+	float fAlpha = fAngle1Deg;
+	float fBeta = fAngle2Deg;
+	if (iView == DAFF_OBJECT_VIEW)
+		m_tTrans.transformOSC2DSC(fAngle1Deg, fAngle2Deg, fAlpha, fBeta);
+
+	m_pContent->getCell(DAFF_DATA_VIEW, fAlpha, fBeta, qIndices);
+}
+
+void DAFFView::transformAnglesD2O(float fAlphaDeg, float fBetaDeg, float& fAzimuthDeg, float& fElevationDeg) const
+{
+	m_tTrans.transformDSC2OSC(fAlphaDeg, fBetaDeg, fAzimuthDeg, fElevationDeg);
+}
+
+void DAFFView::transformAnglesO2D(float fAzimuthDeg, float fElevationDeg, float& fAlphaDeg, float& fBetaDeg) const
+{
+	m_tTrans.transformOSC2DSC(fAzimuthDeg, fElevationDeg, fAlphaDeg, fBetaDeg);
+}
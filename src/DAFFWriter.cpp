@@ -0,0 +1,1571 @@
+// Use 64-bit off_t on 32-bit POSIX systems (must precede all system includes)
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include <DAFFWriter.h>
+
+#include <DAFFMetadata.h>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+#include "DAFFChecksum.h"
+#include "DAFFCompression.h"
+#include "DAFFHeader.h"
+#include "DAFFSphereIndex.h"
+#include "Utils.h"
+
+// Disable MSVC security warning for unsafe fopen
+#ifdef _MSC_VER
+#pragma warning(disable : 4996)
+#endif  // _MSC_VER
+
+//! Written file format version (1.7)
+static const int DAFF_WRITER_FILE_FORMAT_VERSION = 170;
+
+//! Chunk size for copying the temporary files into the DAFF file [Bytes]
+static const size_t DAFF_WRITER_COPY_BUFFER_SIZE = 1 << 16;
+
+//! Size of the checksummed segments of the checksum block [Bytes]
+static const int DAFF_WRITER_CHECKSUM_SEGMENT_SIZE = 1 << 20;
+
+//! Maximum number of resolution levels (step 128 of the coarsest level)
+static const int DAFF_WRITER_MAX_LEVELS = 8;
+
+//! Resolution of the record directions on the space-filling curves (per axis) [bits]
+static const int DAFF_WRITER_CURVE_BITS = 16;
+
+//! Rounds a position up to the next 16-byte boundary
+static inline uint64_t align16(uint64_t ui64Pos)
+{
+	return (ui64Pos + 15) & ~(uint64_t)15;
+}
+
+//! Rounds a position up to the next boundary of an alignment (power of two) [Bytes]
+static inline uint64_t alignTo(uint64_t ui64Pos, int iAlignment)
+{
+	return (ui64Pos + iAlignment - 1) & ~(uint64_t)(iAlignment - 1);
+}
+
+//! Quantizes an angle onto the space-filling curves (2^DAFF_WRITER_CURVE_BITS steps per 360 degrees, up to a limit)
+static inline uint32_t quantizeCurveCoord(float fAngleDeg, uint32_t uiMax)
+{
+	double dCoord = (double)fAngleDeg / 360.0 * (double)(1 << DAFF_WRITER_CURVE_BITS);
+	if (!(dCoord > 0.0))
+		return 0;
+	return (dCoord >= (double)uiMax ? uiMax : (uint32_t)dCoord);
+}
+
+//! Returns the position of a point on the Morton curve (Z-order, interleaved coordinate bits)
+static uint64_t getMortonKey(uint32_t x, uint32_t y)
+{
+	uint64_t ui64Key = 0;
+	for (int b = 0; b < DAFF_WRITER_CURVE_BITS; b++) {
+		ui64Key |= (uint64_t)((x >> b) & 1) << (2 * b + 1);
+		ui64Key |= (uint64_t)((y >> b) & 1) << (2 * b);
+	}
+	return ui64Key;
+}
+
+//! Returns the position of a point on the Hilbert curve over the square of 2^DAFF_WRITER_CURVE_BITS points per axis
+static uint64_t getHilbertKey(uint32_t x, uint32_t y)
+{
+	const uint32_t n = 1u << DAFF_WRITER_CURVE_BITS;
+	uint64_t ui64Key = 0;
+	for (uint32_t s = n / 2; s > 0; s /= 2) {
+		uint32_t rx = ((x & s) > 0 ? 1 : 0);
+		uint32_t ry = ((y & s) > 0 ? 1 : 0);
+		ui64Key += (uint64_t)s * s * ((3 * rx) ^ ry);
+
+		// Rotate the quadrant (the lower bits are mirrored, the consumed higher ones are ignored)
+		if (ry == 0) {
+			if (rx == 1) {
+				x = n - 1 - x;
+				y = n - 1 - y;
+			}
+			std::swap(x, y);
+		}
+	}
+	return ui64Key;
+}
+
+//! Hashes stored record channel data (64-bit FNV-1a, seeded with the size of the uncompressed data)
+static uint64_t hashPayload(const void* pData, size_t nBytes, uint64_t ui64DataSize)
+{
+	const unsigned char* pcData = (const unsigned char*)pData;
+	uint64_t ui64Hash = 14695981039346656037ULL ^ ui64DataSize;
+	for (size_t i = 0; i < nBytes; i++)
+		ui64Hash = (ui64Hash ^ pcData[i]) * 1099511628211ULL;
+	return ui64Hash;
+}
+
+//! Appends a 32-bit value in little endian
+static void appendInt32(std::vector<char>& vcDest, int32_t iValue)
+{
+	DAFF::le2se_4byte(&iValue, 1);
+	vcDest.insert(vcDest.end(), (const char*)&iValue, (const char*)&iValue + 4);
+}
+
+//! Appends a zero-terminated string
+static void appendString(std::vector<char>& vcDest, const std::string& sValue)
+{
+	vcDest.insert(vcDest.end(), sValue.c_str(), sValue.c_str() + sValue.length() + 1);
+}
+
+//! Serializes metadata in the format of DAFFMetadataImpl::load (NULL: no keys)
+static void appendMetadata(std::vector<char>& vcDest, const DAFFMetadata* pMetadata)
+{
+	std::vector<std::string> vsKeys;
+	if (pMetadata)
+		pMetadata->getKeys(vsKeys);
+
+	appendInt32(vcDest, (int32_t)vsKeys.size());
+	for (size_t i = 0; i < vsKeys.size(); i++) {
+		int iType = pMetadata->getKeyType(vsKeys[i]);
+		double dValue;
+
+		appendInt32(vcDest, iType);
+		appendString(vcDest, vsKeys[i]);
+		switch (iType) {
+		case DAFFMetadata::DAFF_BOOL:
+			appendInt32(vcDest, pMetadata->getKeyBool(vsKeys[i]) ? 1 : 0);
+			break;
+
+		case DAFFMetadata::DAFF_INT:
+			appendInt32(vcDest, pMetadata->getKeyInt(vsKeys[i]));
+			break;
+
+		case DAFFMetadata::DAFF_FLOAT:
+			dValue = pMetadata->getKeyFloat(vsKeys[i]);
+			DAFF::le2se_8byte(&dValue, 1);
+			vcDest.insert(vcDest.end(), (const char*)&dValue, (const char*)&dValue + 8);
+			break;
+
+		default:
+			appendString(vcDest, pMetadata->getKeyString(vsKeys[i]));
+			break;
+		}
+	}
+}
+
+DAFFWriter::DAFFWriter()
+	: m_iContentType(-1), m_iQuantization(DAFF_FLOAT32), m_iNumChannels(1), m_iElementsPerRecord(0),
+	  m_iTransformSize(0), m_fSamplerate(0), m_fZeroThresholdDB(-HUGE_VALF), m_bCompression(false),
+	  m_iDataAlignment(16), m_bDeduplication(false), m_bStatistics(false), m_bDirectionIndex(false),
+	  m_bChecksums(false), m_iNumLevels(1), m_iRecordOrder(DAFF_RECORD_ORDER_INDEX), m_iSymmetry(DAFF_SYMMETRY_NONE),
+	  m_iAlphaPoints(1), m_fAlphaStart(0), m_fAlphaEnd(360), m_iBetaPoints(1), m_fBetaStart(0), m_fBetaEnd(0),
+	  m_pMetadata(NULL), m_pFile(NULL), m_ui64DataOffset(0), m_ui64DataSize(0), m_ui64CompressedSize(0),
+	  m_pChunkFile(NULL), m_iNumChunks(0), m_pDescFile(NULL), m_pMetadataFile(NULL), m_pStatisticsFile(NULL),
+	  m_ui64RecordMetadataSize(0), m_iNumAppendedRecords(0), m_iNumRecordMetadata(0), m_iMinFilterOffset(0),
+	  m_iMaxEffectiveFilterLength(0), m_fMax(0), m_iNumSharedRecordChannels(0)
+{
+}
+
+DAFFWriter::~DAFFWriter()
+{
+	abort();
+}
+
+void DAFFWriter::setImpulseResponses(int iFilterLength, float fSamplerate)
+{
+	m_iContentType = DAFF_IMPULSE_RESPONSE;
+	m_iElementsPerRecord = iFilterLength;
+	m_fSamplerate = fSamplerate;
+}
+
+void DAFFWriter::setMagnitudeSpectra(const std::vector<float>& vfFrequencies)
+{
+	m_iContentType = DAFF_MAGNITUDE_SPECTRUM;
+	m_vfFrequencies = vfFrequencies;
+	m_iElementsPerRecord = (int)vfFrequencies.size();
+}
+
+void DAFFWriter::setPhaseSpectra(const std::vector<float>& vfFrequencies)
+{
+	m_iContentType = DAFF_PHASE_SPECTRUM;
+	m_vfFrequencies = vfFrequencies;
+	m_iElementsPerRecord = (int)vfFrequencies.size();
+}
+
+void DAFFWriter::setMagnitudePhaseSpectra(const std::vector<float>& vfFrequencies)
+{
+	m_iContentType = DAFF_MAGNITUDE_PHASE_SPECTRUM;
+	m_vfFrequencies = vfFrequencies;
+	m_iElementsPerRecord = (int)vfFrequencies.size();
+}
+
+void DAFFWriter::setDFTSpectra(int iTransformSize, float fSamplerate, bool bSymmetric)
+{
+	m_iContentType = DAFF_DFT_SPECTRUM;
+	m_iTransformSize = iTransformSize;
+	m_iElementsPerRecord = (bSymmetric ? iTransformSize / 2 + 1 : iTransformSize);
+	m_fSamplerate = fSamplerate;
+}
+
+int DAFFWriter::getContentType() const
+{
+	return m_iContentType;
+}
+
+int DAFFWriter::getRecordDataLength() const
+{
+	switch (m_iContentType) {
+	case DAFF_IMPULSE_RESPONSE:
+	case DAFF_MAGNITUDE_SPECTRUM:
+	case DAFF_PHASE_SPECTRUM:
+		return m_iElementsPerRecord;
+
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+	case DAFF_DFT_SPECTRUM:
+		return 2 * m_iElementsPerRecord;
+	}
+
+	return 0;
+}
+
+int DAFFWriter::getQuantization() const
+{
+	return m_iQuantization;
+}
+
+void DAFFWriter::setQuantization(int iQuantization)
+{
+	m_iQuantization = iQuantization;
+}
+
+int DAFFWriter::getNumChannels() const
+{
+	return m_iNumChannels;
+}
+
+void DAFFWriter::setNumChannels(int iNumChannels)
+{
+	m_iNumChannels = iNumChannels;
+}
+
+float DAFFWriter::getZeroThreshold() const
+{
+	return m_fZeroThresholdDB;
+}
+
+void DAFFWriter::setZeroThreshold(float fThresholdDB)
+{
+	m_fZeroThresholdDB = fThresholdDB;
+}
+
+bool DAFFWriter::getCompression() const
+{
+	return m_bCompression;
+}
+
+void DAFFWriter::setCompression(bool bEnabled)
+{
+	m_bCompression = bEnabled;
+}
+
+int DAFFWriter::getDataAlignment() const
+{
+	return m_iDataAlignment;
+}
+
+void DAFFWriter::setDataAlignment(int iAlignment)
+{
+	m_iDataAlignment = iAlignment;
+}
+
+bool DAFFWriter::getDeduplication() const
+{
+	return m_bDeduplication;
+}
+
+void DAFFWriter::setDeduplication(bool bEnabled)
+{
+	m_bDeduplication = bEnabled;
+}
+
+int DAFFWriter::getNumSharedRecordChannels() const
+{
+	return m_iNumSharedRecordChannels;
+}
+
+bool DAFFWriter::getStatistics() const
+{
+	return m_bStatistics;
+}
+
+void DAFFWriter::setStatistics(bool bEnabled)
+{
+	m_bStatistics = bEnabled;
+}
+
+bool DAFFWriter::getDirectionIndex() const
+{
+	return m_bDirectionIndex;
+}
+
+void DAFFWriter::setDirectionIndex(bool bEnabled)
+{
+	m_bDirectionIndex = bEnabled;
+}
+
+bool DAFFWriter::getChecksums() const
+{
+	return m_bChecksums;
+}
+
+void DAFFWriter::setChecksums(bool bEnabled)
+{
+	m_bChecksums = bEnabled;
+}
+
+int DAFFWriter::getNumLevels() const
+{
+	return m_iNumLevels;
+}
+
+void DAFFWriter::setNumLevels(int iNumLevels)
+{
+	m_iNumLevels = iNumLevels;
+}
+
+int DAFFWriter::getRecordOrder() const
+{
+	return m_iRecordOrder;
+}
+
+void DAFFWriter::setRecordOrder(int iRecordOrder)
+{
+	m_iRecordOrder = iRecordOrder;
+}
+
+void DAFFWriter::setGrid(int iAlphaPoints, float fAlphaStart, float fAlphaEnd, int iBetaPoints, float fBetaStart,
+						 float fBetaEnd)
+{
+	m_iAlphaPoints = iAlphaPoints;
+	m_fAlphaStart = fAlphaStart;
+	m_fAlphaEnd = fAlphaEnd;
+	m_iBetaPoints = iBetaPoints;
+	m_fBetaStart = fBetaStart;
+	m_fBetaEnd = fBetaEnd;
+	m_vfAlpha.clear();
+	m_vfBeta.clear();
+}
+
+int DAFFWriter::getSymmetry() const
+{
+	return m_iSymmetry;
+}
+
+void DAFFWriter::setSymmetry(int iSymmetry)
+{
+	m_iSymmetry = iSymmetry;
+}
+
+void DAFFWriter::getStoredAlphaGrid(int& iAlphaPoints, float& fAlphaEnd) const
+{
+	switch (m_iSymmetry) {
+	case DAFF_SYMMETRY_AXIAL:
+		iAlphaPoints = 1;  // Meridian alpha = 0
+		fAlphaEnd = 0;
+		break;
+
+	case DAFF_SYMMETRY_MIRROR:
+		iAlphaPoints = m_iAlphaPoints / 2 + 1;  // Alpha range 0-180
+		fAlphaEnd = 180;
+		break;
+
+	default:
+		iAlphaPoints = m_iAlphaPoints;
+		fAlphaEnd = m_fAlphaEnd;
+		break;
+	}
+}
+
+void DAFFWriter::setRecordDirections(const std::vector<float>& vfAlphaDeg, const std::vector<float>& vfBetaDeg)
+{
+	// Irregular grids span the whole sphere with a single point in each dimension
+	setGrid(1, 0, 360, 1, 0, 180);
+	m_vfAlpha = vfAlphaDeg;
+	m_vfBeta = vfBetaDeg;
+}
+
+int DAFFWriter::getNumRecords() const
+{
+	if (!m_vfAlpha.empty())
+		return (m_vfAlpha.size() == m_vfBeta.size() ? (int)m_vfAlpha.size() : 0);
+
+	int iAlphaPoints;
+	float fAlphaEnd;
+	getStoredAlphaGrid(iAlphaPoints, fAlphaEnd);
+	return getGridSize(iAlphaPoints);
+}
+
+int DAFFWriter::getGridSize(int iAlphaPoints) const
+{
+	if ((iAlphaPoints < 1) || (m_iBetaPoints < 1))
+		return 0;
+
+	// Poles are single records
+	int iPoles = (m_fBetaStart == 0.0f ? 1 : 0) + (m_fBetaEnd == 180.0f ? 1 : 0);
+	if (m_iBetaPoints == 1)
+		return (iPoles > 0 ? 1 : iAlphaPoints);
+
+	return iPoles + (m_iBetaPoints - iPoles) * iAlphaPoints;
+}
+
+int DAFFWriter::getRecordCoords(int iRecordIndex, float& fAlphaDeg, float& fBetaDeg) const
+{
+	if ((iRecordIndex < 0) || (iRecordIndex >= getNumRecords()))
+		return DAFF_INVALID_INDEX;
+
+	if (!m_vfAlpha.empty()) {
+		fAlphaDeg = m_vfAlpha[iRecordIndex];
+		fBetaDeg = m_vfBeta[iRecordIndex];
+		return DAFF_NO_ERROR;
+	}
+
+	int iAlphaPoints;
+	float fAlphaEnd;
+	getStoredAlphaGrid(iAlphaPoints, fAlphaEnd);
+	getGridCoords(iRecordIndex, iAlphaPoints, fAlphaEnd, fAlphaDeg, fBetaDeg);
+
+	return DAFF_NO_ERROR;
+}
+
+void DAFFWriter::getGridCoords(int iRecordIndex, int iAlphaPoints, float fAlphaEnd, float& fAlphaDeg,
+							   float& fBetaDeg) const
+{
+	// Resolutions and record order like DAFFReaderImpl::fixAngleRanges and getRecordCoords
+	float fAlphaSpan;
+	if (fAlphaEnd > m_fAlphaStart)
+		fAlphaSpan = fAlphaEnd - m_fAlphaStart;
+	else
+		fAlphaSpan = 360 - m_fAlphaStart + fAlphaEnd;
+
+	float fAlphaResolution = 0;
+	if (iAlphaPoints > 1) {
+		if (fAlphaSpan == 360)
+			fAlphaResolution = fAlphaSpan / iAlphaPoints;
+		else
+			fAlphaResolution = fAlphaSpan / (iAlphaPoints - 1);
+	}
+
+	float fBetaResolution = 0;
+	if (m_iBetaPoints > 1)
+		fBetaResolution = (m_fBetaEnd - m_fBetaStart) / (m_iBetaPoints - 1);
+
+	if (m_fBetaStart == 0.0f) {
+		if (iRecordIndex == 0) {  // South pole
+			fAlphaDeg = 0.0f;
+			fBetaDeg = 0.0f;
+		} else {
+			int iAlpha = (iRecordIndex - 1) % iAlphaPoints;
+			int iBeta = 1 + (iRecordIndex - 1) / iAlphaPoints;
+			fAlphaDeg = m_fAlphaStart + ((float)iAlpha * fAlphaResolution);
+			fBetaDeg = (float)iBeta * fBetaResolution;
+		}
+	} else {
+		int iAlpha = iRecordIndex % iAlphaPoints;
+		int iBeta = iRecordIndex / iAlphaPoints;
+		fAlphaDeg = m_fAlphaStart + ((float)iAlpha * fAlphaResolution);
+		fBetaDeg = m_fBetaStart + ((float)iBeta * fBetaResolution);
+	}
+}
+
+DAFFOrientationYPR DAFFWriter::getOrientation() const
+{
+	return m_oOrientation;
+}
+
+void DAFFWriter::setOrientation(const DAFFOrientationYPR& oOrientation)
+{
+	m_oOrientation = oOrientation;
+}
+
+void DAFFWriter::setMetadata(const DAFFMetadata* pMetadata)
+{
+	m_pMetadata = pMetadata;
+}
+
+int DAFFWriter::write(const std::string& sFilePath, DAFFWriterCallback* pCallback)
+{
+	if (pCallback == NULL)
+		return DAFF_MODAL_ERROR;
+
+	int iError = open(sFilePath);
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	int iNumRecords = getNumRecords();
+	int iLength = getRecordDataLength();
+	std::vector<float> vfData((size_t)m_iNumChannels * iLength);
+	std::vector<float*> vpfChannelData(m_iNumChannels);
+	for (int c = 0; c < m_iNumChannels; c++)
+		vpfChannelData[c] = &vfData[0] + (size_t)c * iLength;
+
+	for (int n = 0; n < iNumRecords; n++) {
+		int i = getNextRecordIndex();
+		float fAlpha, fBeta;
+		getRecordCoords(i, fAlpha, fBeta);
+		std::fill(vfData.begin(), vfData.end(), 0.0f);
+
+		iError = pCallback->getRecordData(i, fAlpha, fBeta, &vpfChannelData[0]);
+		if (iError == DAFF_NO_ERROR)
+			iError = appendRecord(&vpfChannelData[0], pCallback->getRecordMetadata(i));
+
+		if (iError != DAFF_NO_ERROR) {
+			abort();
+			return iError;
+		}
+	}
+
+	return close();
+}
+
+bool DAFFWriter::isOpen() const
+{
+	return (m_pFile != NULL);
+}
+
+int DAFFWriter::getNumAppendedRecords() const
+{
+	return m_iNumAppendedRecords;
+}
+
+int DAFFWriter::getNextRecordIndex() const
+{
+	if ((m_pFile == NULL) || (m_iNumAppendedRecords >= getNumRecords()))
+		return -1;
+
+	return (m_viAppendOrder.empty() ? m_iNumAppendedRecords : m_viAppendOrder[m_iNumAppendedRecords]);
+}
+
+int DAFFWriter::validate() const
+{
+	switch (m_iContentType) {
+	case DAFF_IMPULSE_RESPONSE:
+		if (!(m_fSamplerate >= 0.0f))
+			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+		break;
+
+	case DAFF_MAGNITUDE_SPECTRUM:
+	case DAFF_PHASE_SPECTRUM:
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		if (m_vfFrequencies.empty())
+			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+		break;
+
+	case DAFF_DFT_SPECTRUM:
+		if ((m_iTransformSize < 1) || !(m_fSamplerate >= 0.0f))
+			return DAFF_FILE_CONTENT_INVALID_PARAMETER;
+		break;
+
+	default:
+		return DAFF_MODAL_ERROR;
+	}
+
+	switch (m_iQuantization) {
+	case DAFF_INT16:
+	case DAFF_INT24:
+	case DAFF_INT16_BFP:
+		// Spectra are always stored as floats
+		if (m_iContentType != DAFF_IMPULSE_RESPONSE)
+			return DAFF_FILE_QUANTIZATION_UNKOWN;
+		break;
+
+	case DAFF_FLOAT16:
+	case DAFF_BFLOAT16:
+	case DAFF_FLOAT32:
+		break;
+
+	default:
+		return DAFF_FILE_QUANTIZATION_UNKOWN;
+	}
+
+	if ((m_iNumChannels < 1) || (m_iElementsPerRecord < 1))
+		return DAFF_FILE_INVALID_MAIN_PARAMETER;
+
+	if ((m_iDataAlignment != 16) && (m_iDataAlignment != 32) && (m_iDataAlignment != 64))
+		return DAFF_FILE_INVALID_MAIN_PARAMETER;
+
+	if ((m_iNumLevels < 1) || (m_iNumLevels > DAFF_WRITER_MAX_LEVELS))
+		return DAFF_FILE_INVALID_MAIN_PARAMETER;
+
+	if ((m_iRecordOrder < DAFF_RECORD_ORDER_INDEX) || (m_iRecordOrder > DAFF_RECORD_ORDER_HILBERT))
+		return DAFF_FILE_INVALID_MAIN_PARAMETER;
+
+	switch (m_iSymmetry) {
+	case DAFF_SYMMETRY_NONE:
+		break;
+
+	case DAFF_SYMMETRY_AXIAL:
+	case DAFF_SYMMETRY_MIRROR:
+		// Regular grids over the full alpha range only, mirroring requires the alpha points 0 and 180
+		if (!m_vfAlpha.empty())
+			return DAFF_FILE_INVALID_MAIN_PARAMETER;
+		if ((m_fAlphaStart != 0.0f) || (m_fAlphaEnd != 360.0f))
+			return DAFF_FILE_ALPHA_ANGLES_INVALID;
+		if ((m_iSymmetry == DAFF_SYMMETRY_MIRROR) && ((m_iAlphaPoints < 2) || (m_iAlphaPoints % 2 != 0)))
+			return DAFF_FILE_ALPHA_ANGLES_INVALID;
+		break;
+
+	default:
+		return DAFF_FILE_INVALID_MAIN_PARAMETER;
+	}
+
+	if (!m_vfAlpha.empty()) {
+		if (m_vfAlpha.size() != m_vfBeta.size())
+			return DAFF_FILE_INVALID_MAIN_PARAMETER;
+
+		for (size_t i = 0; i < m_vfAlpha.size(); i++) {
+			if (!(m_vfAlpha[i] >= 0.0f) || !(m_vfAlpha[i] < 360.0f))
+				return DAFF_FILE_ALPHA_ANGLES_INVALID;
+			if (!(m_vfBeta[i] >= 0.0f) || !(m_vfBeta[i] <= 180.0f))
+				return DAFF_FILE_BETA_ANGLES_INVALID;
+		}
+
+		return DAFF_NO_ERROR;
+	}
+
+	// Same checks as DAFFReaderImpl::loadMainHeader
+	if ((m_iAlphaPoints < 1) || !(m_fAlphaStart >= 0.0f) || !(m_fAlphaStart < 360.0f) || !(m_fAlphaEnd >= 0.0f) ||
+		!(m_fAlphaEnd <= 360.0f))
+		return DAFF_FILE_ALPHA_ANGLES_INVALID;
+
+	if ((m_iBetaPoints < 1) || !(m_fBetaStart <= m_fBetaEnd) || !(m_fBetaStart >= 0.0f) || !(m_fBetaEnd <= 180.0f))
+		return DAFF_FILE_BETA_ANGLES_INVALID;
+
+	// A single beta point can not span a range, several ones must
+	if ((m_iBetaPoints == 1) != (m_fBetaStart == m_fBetaEnd))
+		return DAFF_FILE_BETA_ANGLES_INVALID;
+
+	return DAFF_NO_ERROR;
+}
+
+bool DAFFWriter::hasStatistics() const
+{
+	return m_bStatistics && ((m_iContentType == DAFF_IMPULSE_RESPONSE) || (m_iContentType == DAFF_MAGNITUDE_SPECTRUM));
+}
+
+bool DAFFWriter::hasLevels() const
+{
+	return (m_iNumLevels > 1) && m_vfAlpha.empty() && (m_iSymmetry == DAFF_SYMMETRY_NONE);
+}
+
+bool DAFFWriter::hasRecordOrder() const
+{
+	return (m_iRecordOrder != DAFF_RECORD_ORDER_INDEX);
+}
+
+void DAFFWriter::getAppendOrder(std::vector<int>& viRecordIndices) const
+{
+	std::vector<int> viLevelRecordEnds;
+	computeAppendOrder(viRecordIndices, viLevelRecordEnds);
+}
+
+void DAFFWriter::computeAppendOrder(std::vector<int>& viRecordIndices, std::vector<int>& viLevelRecordEnds) const
+{
+	viRecordIndices.clear();
+	viLevelRecordEnds.clear();
+	int iNumRecords = getNumRecords();
+	if (!hasLevels()) {
+		for (int i = 0; i < iNumRecords; i++)
+			viRecordIndices.push_back(i);
+	} else {
+		computeLevels(viRecordIndices, viLevelRecordEnds);
+	}
+
+	if (!hasRecordOrder())
+		return;
+
+	// Order the records of each level along the curve, beta on the first half of the Hilbert square
+	const uint32_t uiMaxAlpha = (1u << DAFF_WRITER_CURVE_BITS) - 1;
+	const uint32_t uiMaxBeta = (1u << (DAFF_WRITER_CURVE_BITS - 1)) - 1;
+	std::vector<std::pair<uint64_t, int> > vKeys;
+	size_t nLevels = (viLevelRecordEnds.empty() ? 1 : viLevelRecordEnds.size());
+	int iBegin = 0;
+	for (size_t l = 0; l < nLevels; l++) {
+		int iEnd = (viLevelRecordEnds.empty() ? iNumRecords : viLevelRecordEnds[l]);
+		vKeys.clear();
+		for (int n = iBegin; n < iEnd; n++) {
+			float fAlpha = 0, fBeta = 0;
+			getRecordCoords(viRecordIndices[n], fAlpha, fBeta);
+			uint32_t x = quantizeCurveCoord(fBeta, uiMaxBeta);
+			uint32_t y = quantizeCurveCoord(fAlpha, uiMaxAlpha);
+			uint64_t ui64Key = (m_iRecordOrder == DAFF_RECORD_ORDER_MORTON ? getMortonKey(x, y) : getHilbertKey(x, y));
+			vKeys.push_back(std::make_pair(ui64Key, viRecordIndices[n]));
+		}
+
+		// Records at the same position keep the order of their indices
+		std::sort(vKeys.begin(), vKeys.end());
+		for (int n = iBegin; n < iEnd; n++)
+			viRecordIndices[n] = vKeys[n - iBegin].second;
+		iBegin = iEnd;
+	}
+}
+
+void DAFFWriter::initLevels()
+{
+	m_viAppendOrder.clear();
+	m_viLevelRecordEnds.clear();
+	m_vui64LevelDataEnds.clear();
+	if (hasLevels() || hasRecordOrder())
+		computeAppendOrder(m_viAppendOrder, m_viLevelRecordEnds);
+}
+
+void DAFFWriter::computeLevels(std::vector<int>& viRecordIndices, std::vector<int>& viLevelRecordEnds) const
+{
+	// Record order and poles like getGridCoords (a pole is a single record of its beta point)
+	int iNumRecords = getNumRecords();
+	bool bSouthPole = (m_fBetaStart == 0.0f);
+	bool bNorthPole = (m_fBetaEnd == 180.0f);
+	std::vector<std::vector<int> > vviLevels(m_iNumLevels);
+	for (int i = 0; i < iNumRecords; i++) {
+		int iAlpha, iBeta;
+		if (bSouthPole) {
+			iAlpha = (i == 0 ? 0 : (i - 1) % m_iAlphaPoints);
+			iBeta = (i == 0 ? 0 : 1 + (i - 1) / m_iAlphaPoints);
+		} else {
+			iAlpha = i % m_iAlphaPoints;
+			iBeta = i / m_iAlphaPoints;
+		}
+
+		// Coarsest level whose step divides both indices (the last one has step 1)
+		int iLevel = 0;
+		bool bPole = (bSouthPole && (iBeta == 0)) || (bNorthPole && (iBeta == m_iBetaPoints - 1));
+		if (!bPole) {
+			for (int iStep = 1 << (m_iNumLevels - 1); (iAlpha % iStep != 0) || (iBeta % iStep != 0); iStep /= 2)
+				iLevel++;
+		}
+
+		vviLevels[iLevel].push_back(i);
+	}
+
+	for (int l = 0; l < m_iNumLevels; l++) {
+		viRecordIndices.insert(viRecordIndices.end(), vviLevels[l].begin(), vviLevels[l].end());
+		viLevelRecordEnds.push_back((int)viRecordIndices.size());
+	}
+}
+
+int DAFFWriter::getNumFileBlocks() const
+{
+	// Main header, content header, record descriptors, data, metadata (and record directions or symmetry)
+	int iNumBlocks = ((m_vfAlpha.empty() && (m_iSymmetry == DAFF_SYMMETRY_NONE)) ? 5 : 6);
+
+	// Optional statistics, direction index, levels, record order and checksums
+	if (hasStatistics())
+		iNumBlocks++;
+	if (m_bDirectionIndex)
+		iNumBlocks++;
+	if (hasLevels())
+		iNumBlocks++;
+	if (hasRecordOrder())
+		iNumBlocks++;
+	if (m_bChecksums)
+		iNumBlocks++;
+
+	return iNumBlocks;
+}
+
+size_t DAFFWriter::getContentHeaderSize() const
+{
+	switch (m_iContentType) {
+	case DAFF_IMPULSE_RESPONSE:
+		return sizeof(DAFFContentHeaderIR);
+
+	case DAFF_MAGNITUDE_SPECTRUM:
+	case DAFF_PHASE_SPECTRUM:
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		// The reader expects the support frequencies at byte offset 8 for all spectra
+		return 8 + m_vfFrequencies.size() * sizeof(float);
+
+	case DAFF_DFT_SPECTRUM:
+		return sizeof(DAFFContentHeaderDFT);
+	}
+
+	return 0;
+}
+
+size_t DAFFWriter::getRecordDescSize() const
+{
+	if ((m_iContentType == DAFF_IMPULSE_RESPONSE) && (m_iQuantization == DAFF_INT16_BFP))
+		return sizeof(DAFFRecordChannelDescIRBFP);
+	if (m_iContentType == DAFF_IMPULSE_RESPONSE)
+		return sizeof(DAFFRecordChannelDescIR);
+
+	return sizeof(DAFFRecordChannelDescDefault);
+}
+
+int DAFFWriter::open(const std::string& sFilePath)
+{
+	if (m_pFile)
+		return DAFF_MODAL_ERROR;
+
+	int iError = validate();
+	if (iError != DAFF_NO_ERROR)
+		return iError;
+
+	// Deduplication compares new record channels with the stored ones, so the file is also read
+	m_pFile = fopen(sFilePath.c_str(), "w+b");
+	if (m_pFile == NULL)
+		return DAFF_FILE_NOT_FOUND;
+
+	// Record descriptors, record metadata and the chunk table are collected in temporary files
+	m_sFilePath = sFilePath;
+	m_pDescFile = tmpfile();
+	m_pMetadataFile = tmpfile();
+	if (m_bCompression)
+		m_pChunkFile = tmpfile();
+	if (hasStatistics())
+		m_pStatisticsFile = tmpfile();
+	if ((m_pDescFile == NULL) || (m_pMetadataFile == NULL) || (m_bCompression && (m_pChunkFile == NULL)) ||
+		(hasStatistics() && (m_pStatisticsFile == NULL))) {
+		abort();
+		return DAFF_FILE_NOT_FOUND;
+	}
+
+	m_ui64DataSize = 0;
+	m_ui64CompressedSize = (m_bCompression ? sizeof(DAFFCompressedDataHeader) : 0);
+	m_iNumChunks = 0;
+	m_ui64RecordMetadataSize = 0;
+	m_iNumAppendedRecords = 0;
+	m_iNumRecordMetadata = 0;
+	m_iMinFilterOffset = INT_MAX;
+	m_iMaxEffectiveFilterLength = 0;
+	m_fMax = 0;
+	m_iNumSharedRecordChannels = 0;
+	m_mPayloads.clear();
+	initLevels();
+
+	// Reserve the file header, the block table, the main header, the content header
+	// and the header of the compressed data block (written by close). The data block starts
+	// at a boundary of the data alignment, so that mapped record data is aligned in memory.
+	uint64_t ui64Pos = align16(sizeof(DAFFFileHeader) + getNumFileBlocks() * sizeof(DAFFFileBlockEntry));
+	ui64Pos = align16(ui64Pos + sizeof(DAFFMainHeader));
+	m_ui64DataOffset = alignTo(ui64Pos + getContentHeaderSize(), m_iDataAlignment);
+
+	std::vector<char> vcZeros((size_t)(m_ui64DataOffset + m_ui64CompressedSize), 0);
+	if (fwrite(&vcZeros[0], 1, vcZeros.size(), m_pFile) != vcZeros.size()) {
+		abort();
+		return DAFF_FILE_NOT_FOUND;
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFWriter::appendRecord(float** ppfChannelData, const DAFFMetadata* pMetadata)
+{
+	if ((m_pFile == NULL) || (m_iNumAppendedRecords >= getNumRecords()))
+		return DAFF_MODAL_ERROR;
+
+	int iLength = getRecordDataLength();
+
+	// Records ordered by levels: descriptors and statistics at the place of the record
+	if (!m_viAppendOrder.empty()) {
+		long iRecordPos = (long)m_viAppendOrder[m_iNumAppendedRecords] * m_iNumChannels;
+		if ((fseek(m_pDescFile, iRecordPos * (long)getRecordDescSize(), SEEK_SET) != 0) ||
+			(hasStatistics() &&
+			 (fseek(m_pStatisticsFile, iRecordPos * (long)sizeof(DAFFStatisticsEntry), SEEK_SET) != 0))) {
+			abort();
+			return DAFF_FILE_NOT_FOUND;
+		}
+	}
+
+	// Record metadata follows the global metadata (index 0)
+	int iMetadataIndex = -1;
+	if (pMetadata && !pMetadata->isEmpty()) {
+		std::vector<char> vcMetadata;
+		appendMetadata(vcMetadata, pMetadata);
+		if (fwrite(&vcMetadata[0], 1, vcMetadata.size(), m_pMetadataFile) != vcMetadata.size()) {
+			abort();
+			return DAFF_FILE_NOT_FOUND;
+		}
+
+		m_ui64RecordMetadataSize += vcMetadata.size();
+		iMetadataIndex = ++m_iNumRecordMetadata;
+	}
+
+	for (int c = 0; c < m_iNumChannels; c++) {
+		const float* pfData = ppfChannelData[c];
+		int iOffset = 0;
+		int iNumValues = iLength;
+		DAFFRecordChannelDescIR oDescIR;
+		DAFFRecordChannelDescDefault oDesc;
+
+		if (m_iContentType == DAFF_IMPULSE_RESPONSE) {
+			// Effective bounds, offset and length are multiples of the floats per data alignment
+			// (four by default, like daffv17_write), so that the effective data starts aligned
+			float fThreshold = (float)pow(10.0, m_fZeroThresholdDB / 20.0);
+			size_t nBegin, nEnd;
+			DAFF::bounds_float(pfData, iLength, fThreshold, nBegin, nEnd);
+
+			int iEffectiveLength = 0;
+			if (nEnd > 0) {
+				int iMask = m_iDataAlignment / 4 - 1;
+				iOffset = (int)nBegin & ~iMask;
+				iEffectiveLength = std::min(((int)nEnd - iOffset + iMask) & ~iMask, iLength - iOffset);
+				m_iMinFilterOffset = std::min(m_iMinFilterOffset, iOffset);
+				m_iMaxEffectiveFilterLength = std::max(m_iMaxEffectiveFilterLength, iEffectiveLength);
+			}
+
+			oDescIR.iMetaDataIndex = iMetadataIndex;
+			oDescIR.iLeadingZeros = iOffset;
+			oDescIR.iElementLength = iEffectiveLength;
+
+			pfData += iOffset;
+			iNumValues = iEffectiveLength;
+		} else {
+			oDesc.iMetaDataIndex = iMetadataIndex;
+
+			// Greatest magnitude for the content header
+			if (m_iContentType == DAFF_MAGNITUDE_SPECTRUM) {
+				m_fMax = std::max(m_fMax, DAFF::peak_float(pfData, iLength));
+			} else if (m_iContentType != DAFF_PHASE_SPECTRUM) {
+				for (int i = 0; i < iLength; i += 2)
+					m_fMax = std::max(m_fMax, DAFF::cabs(pfData[i], pfData[i + 1]));
+			}
+		}
+
+		// Conversion into the file format
+		size_t nBytes;
+		int iSampleSize;
+		float fScale = 1.0f;
+		switch (m_iQuantization) {
+		case DAFF_INT16:
+			iSampleSize = 2;
+			nBytes = (size_t)iNumValues * 2;
+			m_vcBuf.resize(nBytes + 1);
+			DAFF::stc_float_to_sint16((short*)&m_vcBuf[0], pfData, iNumValues);
+			break;
+
+		case DAFF_INT16_BFP: {
+			// The peak of the record channel is the full scale of its samples
+			float fPeak = DAFF::peak_float(pfData, iNumValues);
+			if (fPeak > 0)
+				fScale = fPeak;
+			m_vfStored.resize(std::max(iNumValues, 1));
+			for (int i = 0; i < iNumValues; i++)
+				m_vfStored[i] = pfData[i] / fScale;
+
+			iSampleSize = 2;
+			nBytes = (size_t)iNumValues * 2;
+			m_vcBuf.resize(nBytes + 1);
+			DAFF::stc_float_to_sint16((short*)&m_vcBuf[0], &m_vfStored[0], iNumValues);
+			break;
+		}
+
+		case DAFF_INT24:
+			iSampleSize = 3;
+			nBytes = (size_t)iNumValues * 3;
+			m_vcBuf.resize(nBytes + 1);
+			DAFF::stc_float_to_sint24(&m_vcBuf[0], pfData, iNumValues);
+			break;
+
+		case DAFF_FLOAT16:
+			iSampleSize = 2;
+			nBytes = (size_t)iNumValues * 2;
+			m_vcBuf.resize(nBytes + 1);
+			DAFF::stc_float_to_half((unsigned short*)&m_vcBuf[0], pfData, iNumValues);
+			break;
+
+		case DAFF_BFLOAT16:
+			iSampleSize = 2;
+			nBytes = (size_t)iNumValues * 2;
+			m_vcBuf.resize(nBytes + 1);
+			DAFF::stc_float_to_bfloat16((unsigned short*)&m_vcBuf[0], pfData, iNumValues);
+			break;
+
+		default:
+			iSampleSize = 4;
+			nBytes = (size_t)iNumValues * 4;
+			m_vcBuf.resize(nBytes + 1);
+			memcpy(&m_vcBuf[0], pfData, nBytes);
+			break;
+		}
+
+		// Statistics of the stored values, before the conversion into the file byte order
+		if (hasStatistics() && !writeStatistics(&m_vcBuf[0], iNumValues, iOffset, fScale)) {
+			abort();
+			return DAFF_FILE_NOT_FOUND;
+		}
+
+		if (iSampleSize == 2)
+			DAFF::le2se_2byte(&m_vcBuf[0], iNumValues);
+		else if (iSampleSize == 3)
+			DAFF::le2se_3byte(&m_vcBuf[0], iNumValues);
+		else
+			DAFF::le2se_4byte(&m_vcBuf[0], iNumValues);
+
+		// The descriptor follows the data, whose offset may be shared with an identical record channel
+		uint64_t ui64DataOffset;
+		bool bSuccess = writeRecordChannelData(&m_vcBuf[0], nBytes, iSampleSize, ui64DataOffset);
+		if (m_iQuantization == DAFF_INT16_BFP) {
+			DAFFRecordChannelDescIRBFP oDescBFP;
+			oDescBFP.oDesc = oDescIR;
+			oDescBFP.oDesc.ui64DataOffset = ui64DataOffset;
+			oDescBFP.fScale = fScale;
+			oDescBFP.fixEndianness();
+			bSuccess = bSuccess && (fwrite(&oDescBFP, sizeof(oDescBFP), 1, m_pDescFile) == 1);
+		} else if (m_iContentType == DAFF_IMPULSE_RESPONSE) {
+			oDescIR.ui64DataOffset = ui64DataOffset;
+			oDescIR.fixEndianness();
+			bSuccess = bSuccess && (fwrite(&oDescIR, sizeof(oDescIR), 1, m_pDescFile) == 1);
+		} else {
+			oDesc.ui64DataOffset = ui64DataOffset;
+			oDesc.fixEndianness();
+			bSuccess = bSuccess && (fwrite(&oDesc, sizeof(oDesc), 1, m_pDescFile) == 1);
+		}
+
+		if (!bSuccess) {
+			abort();
+			return DAFF_FILE_NOT_FOUND;
+		}
+	}
+
+	m_iNumAppendedRecords++;
+
+	// Data ends of the completed levels (levels without records end where the previous one does)
+	while ((m_vui64LevelDataEnds.size() < m_viLevelRecordEnds.size()) &&
+		   (m_viLevelRecordEnds[m_vui64LevelDataEnds.size()] <= m_iNumAppendedRecords))
+		m_vui64LevelDataEnds.push_back(m_ui64DataSize);
+
+	return DAFF_NO_ERROR;
+}
+
+int DAFFWriter::close()
+{
+	if (m_pFile == NULL)
+		return DAFF_MODAL_ERROR;
+
+	int iNumRecords = getNumRecords();
+	int iNumBlocks = getNumFileBlocks();
+	if (m_iNumAppendedRecords != iNumRecords) {
+		abort();
+		return DAFF_MODAL_ERROR;
+	}
+
+	// Block table, in the order of daffv17_write
+	std::vector<DAFFFileBlockEntry> vBlocks(iNumBlocks);
+	vBlocks[0].iID = FILEBLOCK_DAFF1_MAIN_HEADER_ID;
+	vBlocks[0].ui64Offset = align16(sizeof(DAFFFileHeader) + iNumBlocks * sizeof(DAFFFileBlockEntry));
+	vBlocks[0].ui64Size = sizeof(DAFFMainHeader);
+	vBlocks[1].iID = FILEBLOCK_DAFF1_CONTENT_HEADER_ID;
+	vBlocks[1].ui64Offset = align16(vBlocks[0].ui64Offset + vBlocks[0].ui64Size);
+	vBlocks[1].ui64Size = getContentHeaderSize();
+	vBlocks[3].iID = FILEBLOCK_DAFF1_DATA_ID;
+	vBlocks[3].ui64Offset = m_ui64DataOffset;
+	vBlocks[3].ui64Size = m_ui64DataSize;
+
+	// The chunk table completes the compressed data block
+	bool bSuccess = true;
+	DAFFCompressedDataHeader oCompressedHeader;
+	if (m_bCompression) {
+		oCompressedHeader.iNumChunks = m_iNumChunks;
+		oCompressedHeader.ui64DataSize = m_ui64DataSize;
+		oCompressedHeader.ui64ChunkTableOffset = m_ui64CompressedSize;
+		oCompressedHeader.fixEndianness();
+
+		uint64_t ui64ChunkTableSize = (uint64_t)m_iNumChunks * sizeof(DAFFCompressedChunkEntry);
+		bSuccess = copyFromFile(m_pChunkFile, ui64ChunkTableSize);
+
+		vBlocks[3].iID = FILEBLOCK_DAFF1_COMPRESSED_DATA_ID;
+		vBlocks[3].ui64Size = m_ui64CompressedSize + ui64ChunkTableSize;
+	}
+
+	// Record descriptors, record directions and metadata behind the data
+	uint64_t ui64Pos = vBlocks[3].ui64Offset + vBlocks[3].ui64Size;
+	bSuccess = bSuccess && writeBlock(NULL, 0, ui64Pos);  // Padding
+
+	vBlocks[2].iID = FILEBLOCK_DAFF1_RECORD_DESC_ID;
+	vBlocks[2].ui64Offset = ui64Pos;
+	vBlocks[2].ui64Size = (uint64_t)iNumRecords * m_iNumChannels * getRecordDescSize();
+	bSuccess = bSuccess && copyFromFile(m_pDescFile, vBlocks[2].ui64Size);
+	ui64Pos += vBlocks[2].ui64Size;
+	bSuccess = bSuccess && writeBlock(NULL, 0, ui64Pos);  // Padding
+
+	if (!m_vfAlpha.empty()) {
+		std::vector<DAFFRecordDirectionEntry> vDirections(iNumRecords);
+		for (int i = 0; i < iNumRecords; i++) {
+			vDirections[i].fAlpha = m_vfAlpha[i];
+			vDirections[i].fBeta = m_vfBeta[i];
+			vDirections[i].fixEndianness();
+		}
+
+		vBlocks[5].iID = FILEBLOCK_DAFF1_RECORD_DIRECTIONS_ID;
+		vBlocks[5].ui64Offset = ui64Pos;
+		vBlocks[5].ui64Size = vDirections.size() * sizeof(DAFFRecordDirectionEntry);
+		bSuccess = bSuccess && writeBlock(&vDirections[0], (size_t)vBlocks[5].ui64Size, ui64Pos);
+	} else if (m_iSymmetry != DAFF_SYMMETRY_NONE) {
+		DAFFSymmetryHeader oSymmetry;
+		oSymmetry.iSymmetry = m_iSymmetry;
+		oSymmetry.iAlphaPoints = m_iAlphaPoints;
+		oSymmetry.fixEndianness();
+
+		vBlocks[5].iID = FILEBLOCK_DAFF1_SYMMETRY_ID;
+		vBlocks[5].ui64Offset = ui64Pos;
+		vBlocks[5].ui64Size = sizeof(DAFFSymmetryHeader);
+		bSuccess = bSuccess && writeBlock(&oSymmetry, sizeof(DAFFSymmetryHeader), ui64Pos);
+	}
+
+	// Optional blocks behind the fixed ones
+	int iNextBlock = (m_vfAlpha.empty() && (m_iSymmetry == DAFF_SYMMETRY_NONE)) ? 5 : 6;
+	if (hasStatistics()) {
+		DAFFFileBlockEntry& oBlock = vBlocks[iNextBlock++];
+		oBlock.iID = FILEBLOCK_DAFF1_STATISTICS_ID;
+		oBlock.ui64Offset = ui64Pos;
+		oBlock.ui64Size = (uint64_t)iNumRecords * m_iNumChannels * sizeof(DAFFStatisticsEntry);
+		bSuccess = bSuccess && copyFromFile(m_pStatisticsFile, oBlock.ui64Size);
+		ui64Pos += oBlock.ui64Size;
+		bSuccess = bSuccess && writeBlock(NULL, 0, ui64Pos);  // Padding
+	}
+
+	if (m_bDirectionIndex) {
+		uint64_t ui64Size = 0;
+		DAFFFileBlockEntry& oBlock = vBlocks[iNextBlock++];
+		oBlock.iID = FILEBLOCK_DAFF1_DIRECTION_INDEX_ID;
+		oBlock.ui64Offset = ui64Pos;
+		bSuccess = bSuccess && writeDirectionIndex(ui64Pos, ui64Size);
+		oBlock.ui64Size = ui64Size;
+	}
+
+	if (hasLevels()) {
+		DAFFLevelHeader oHeader;
+		oHeader.iNumLevels = m_iNumLevels;
+		oHeader.iReserved = 0;
+		oHeader.fixEndianness();
+
+		std::vector<char> vcLevels((const char*)&oHeader, (const char*)&oHeader + sizeof(DAFFLevelHeader));
+		for (int l = 0; l < m_iNumLevels; l++) {
+			DAFFLevelEntry oEntry;
+			oEntry.iStep = 1 << (m_iNumLevels - 1 - l);
+			oEntry.ui64DataEnd = m_vui64LevelDataEnds[l];
+			oEntry.fixEndianness();
+			vcLevels.insert(vcLevels.end(), (const char*)&oEntry, (const char*)&oEntry + sizeof(DAFFLevelEntry));
+		}
+
+		DAFFFileBlockEntry& oBlock = vBlocks[iNextBlock++];
+		oBlock.iID = FILEBLOCK_DAFF1_LEVELS_ID;
+		oBlock.ui64Offset = ui64Pos;
+		oBlock.ui64Size = vcLevels.size();
+		bSuccess = bSuccess && writeBlock(&vcLevels[0], vcLevels.size(), ui64Pos);
+	}
+
+	if (hasRecordOrder()) {
+		DAFFRecordOrderHeader oHeader;
+		oHeader.iRecordOrder = m_iRecordOrder;
+		oHeader.iReserved = 0;
+		oHeader.fixEndianness();
+
+		DAFFFileBlockEntry& oBlock = vBlocks[iNextBlock++];
+		oBlock.iID = FILEBLOCK_DAFF1_RECORD_ORDER_ID;
+		oBlock.ui64Offset = ui64Pos;
+		oBlock.ui64Size = sizeof(DAFFRecordOrderHeader);
+		bSuccess = bSuccess && writeBlock(&oHeader, sizeof(DAFFRecordOrderHeader), ui64Pos);
+	}
+
+	// The global metadata is only required if there is any metadata
+	std::vector<char> vcMetadata;
+	if ((m_pMetadata && !m_pMetadata->isEmpty()) || (m_iNumRecordMetadata > 0))
+		appendMetadata(vcMetadata, m_pMetadata);
+
+	vBlocks[4].iID = FILEBLOCK_DAFF1_METADATA_ID;
+	vBlocks[4].ui64Offset = ui64Pos;
+	vBlocks[4].ui64Size = vcMetadata.size() + m_ui64RecordMetadataSize;
+	if (!vcMetadata.empty()) {
+		bSuccess = bSuccess && (fwrite(&vcMetadata[0], 1, vcMetadata.size(), m_pFile) == vcMetadata.size()) &&
+				   copyFromFile(m_pMetadataFile, m_ui64RecordMetadataSize);
+	}
+
+	// The checksum block is the last one, its size follows from the sizes of the others
+	int iChecksumBlock = -1;
+	if (m_bChecksums) {
+		ui64Pos += vBlocks[4].ui64Size;
+		bSuccess = bSuccess && writeBlock(NULL, 0, ui64Pos);  // Padding
+
+		uint64_t ui64NumSegments = 0;
+		for (int i = 0; i < iNumBlocks; i++)
+			ui64NumSegments += (vBlocks[i].ui64Size + DAFF_WRITER_CHECKSUM_SEGMENT_SIZE - 1) /
+							   DAFF_WRITER_CHECKSUM_SEGMENT_SIZE;
+
+		iChecksumBlock = iNextBlock++;
+		DAFFFileBlockEntry& oBlock = vBlocks[iChecksumBlock];
+		oBlock.iID = FILEBLOCK_DAFF1_CHECKSUMS_ID;
+		oBlock.ui64Offset = ui64Pos;
+		oBlock.ui64Size = sizeof(DAFFChecksumHeader) + ui64NumSegments * sizeof(uint32_t);
+	}
+
+	// Headers at the beginning of the file (and of the compressed data block)
+	std::vector<char> vcHeaders((size_t)m_ui64DataOffset, 0);
+	if (m_bCompression)
+		vcHeaders.insert(vcHeaders.end(), (const char*)&oCompressedHeader,
+						 (const char*)&oCompressedHeader + sizeof(DAFFCompressedDataHeader));
+
+	DAFFFileHeader oFileHeader;
+	oFileHeader.pcSignature[0] = 'F';
+	oFileHeader.pcSignature[1] = 'W';
+	oFileHeader.iFileFormatVersion = DAFF_WRITER_FILE_FORMAT_VERSION;
+	oFileHeader.iNumFileBlocks = iNumBlocks;
+	oFileHeader.fixEndianness();
+	memcpy(&vcHeaders[0], &oFileHeader, sizeof(DAFFFileHeader));
+
+	for (int i = 0; i < iNumBlocks; i++) {
+		DAFFFileBlockEntry oEntry = vBlocks[i];
+		oEntry.fixEndianness();
+		memcpy(&vcHeaders[sizeof(DAFFFileHeader) + i * sizeof(DAFFFileBlockEntry)], &oEntry, sizeof(oEntry));
+	}
+
+	// The main header describes the stored records
+	int iStoredAlphaPoints;
+	float fStoredAlphaEnd;
+	getStoredAlphaGrid(iStoredAlphaPoints, fStoredAlphaEnd);
+
+	DAFFMainHeader oMainHeader;
+	oMainHeader.iContentType = m_iContentType;
+	oMainHeader.iQuantization = m_iQuantization;
+	oMainHeader.iNumChannels = m_iNumChannels;
+	oMainHeader.iNumRecords = iNumRecords;
+	oMainHeader.iElementsPerRecord = m_iElementsPerRecord;
+	oMainHeader.iMetadataIndex = (vcMetadata.empty() ? -1 : 0);
+	oMainHeader.iAlphaPoints = iStoredAlphaPoints;
+	oMainHeader.fAlphaStart = m_fAlphaStart;
+	oMainHeader.fAlphaEnd = fStoredAlphaEnd;
+	oMainHeader.iBetaPoints = m_iBetaPoints;
+	oMainHeader.fBetaStart = m_fBetaStart;
+	oMainHeader.fBetaEnd = m_fBetaEnd;
+	oMainHeader.fOrientYaw = m_oOrientation.fYawAngleDeg;
+	oMainHeader.fOrientPitch = m_oOrientation.fPitchAngleDeg;
+	oMainHeader.fOrientRoll = m_oOrientation.fRollAngleDeg;
+	oMainHeader.fixEndianness();
+	memcpy(&vcHeaders[(size_t)vBlocks[0].ui64Offset], &oMainHeader, sizeof(DAFFMainHeader));
+
+	char* pContentHeader = &vcHeaders[(size_t)vBlocks[1].ui64Offset];
+	switch (m_iContentType) {
+	case DAFF_IMPULSE_RESPONSE: {
+		DAFFContentHeaderIR oHeader;
+		oHeader.fSamplerate = m_fSamplerate;
+		oHeader.iMinFilterOffset = (m_iMinFilterOffset == INT_MAX ? 0 : m_iMinFilterOffset);
+		oHeader.iMaxEffectiveFilterLength = m_iMaxEffectiveFilterLength;
+		oHeader.fixEndianness();
+		memcpy(pContentHeader, &oHeader, sizeof(oHeader));
+		break;
+	}
+
+	case DAFF_MAGNITUDE_SPECTRUM:
+	case DAFF_PHASE_SPECTRUM:
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM: {
+		// MS and MPS: maximum and number of frequencies, PS: number of frequencies and padding
+		int32_t piHeader[2] = { 0, (int32_t)m_vfFrequencies.size() };
+		if (m_iContentType == DAFF_PHASE_SPECTRUM)
+			std::swap(piHeader[0], piHeader[1]);
+		else
+			memcpy(&piHeader[0], &m_fMax, sizeof(float));
+		DAFF::le2se_4byte(piHeader, 2);
+		memcpy(pContentHeader, piHeader, sizeof(piHeader));
+
+		std::vector<float> vfFrequencies(m_vfFrequencies);
+		DAFF::le2se_4byte(&vfFrequencies[0], vfFrequencies.size());
+		memcpy(pContentHeader + 8, &vfFrequencies[0], vfFrequencies.size() * sizeof(float));
+		break;
+	}
+
+	case DAFF_DFT_SPECTRUM: {
+		DAFFContentHeaderDFT oHeader;
+		oHeader.iNumDFTCoeffs = m_iElementsPerRecord;
+		oHeader.iTransformSize = m_iTransformSize;
+		oHeader.fSamplerate = m_fSamplerate;
+		oHeader.fMax = m_fMax;
+		oHeader.fixEndianness();
+		memcpy(pContentHeader, &oHeader, sizeof(oHeader));
+		break;
+	}
+	}
+
+	bSuccess = bSuccess && (fseek(m_pFile, 0, SEEK_SET) == 0) &&
+			   (fwrite(&vcHeaders[0], 1, vcHeaders.size(), m_pFile) == vcHeaders.size());
+
+	if (m_bChecksums)
+		bSuccess = bSuccess && writeChecksums(vBlocks, iChecksumBlock, &vcHeaders[0]);
+
+	bSuccess = (fclose(m_pFile) == 0) && bSuccess;
+	m_pFile = NULL;
+	closeTempFiles();
+	if (!bSuccess) {
+		remove(m_sFilePath.c_str());
+		return DAFF_FILE_NOT_FOUND;
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+void DAFFWriter::abort()
+{
+	closeTempFiles();
+	if (m_pFile == NULL)
+		return;
+
+	fclose(m_pFile);
+	m_pFile = NULL;
+	remove(m_sFilePath.c_str());
+}
+
+void DAFFWriter::closeTempFiles()
+{
+	// Temporary files are removed when closed
+	if (m_pDescFile)
+		fclose(m_pDescFile);
+	if (m_pMetadataFile)
+		fclose(m_pMetadataFile);
+	if (m_pChunkFile)
+		fclose(m_pChunkFile);
+	if (m_pStatisticsFile)
+		fclose(m_pStatisticsFile);
+
+	m_pDescFile = NULL;
+	m_pMetadataFile = NULL;
+	m_pChunkFile = NULL;
+	m_pStatisticsFile = NULL;
+
+	// Release the payload index as well
+	PayloadMap().swap(m_mPayloads);
+}
+
+bool DAFFWriter::copyFromFile(FILE* pSource, uint64_t ui64Size)
+{
+	m_vcBuf.resize(DAFF_WRITER_COPY_BUFFER_SIZE);
+	rewind(pSource);
+
+	while (ui64Size > 0) {
+		size_t nBytes = (size_t)std::min(ui64Size, (uint64_t)m_vcBuf.size());
+		if ((fread(&m_vcBuf[0], 1, nBytes, pSource) != nBytes) || (fwrite(&m_vcBuf[0], 1, nBytes, m_pFile) != nBytes))
+			return false;
+		ui64Size -= nBytes;
+	}
+
+	return true;
+}
+
+bool DAFFWriter::writeBlock(const void* pData, size_t nBytes, uint64_t& ui64Pos, int iAlignment)
+{
+	static const char pcZeros[64] = { 0 };
+	size_t nPadding = (size_t)(alignTo(ui64Pos + nBytes, iAlignment) - (ui64Pos + nBytes));
+
+	if ((nBytes > 0) && (fwrite(pData, 1, nBytes, m_pFile) != nBytes))
+		return false;
+	if ((nPadding > 0) && (fwrite(pcZeros, 1, nPadding, m_pFile) != nPadding))
+		return false;
+
+	ui64Pos += nBytes + nPadding;
+	return true;
+}
+
+bool DAFFWriter::writeRecordChannelData(const void* pData, size_t nBytes, int iSampleSize, uint64_t& ui64DataOffset)
+{
+	// The stored bytes: the chunk if compressed, otherwise the data itself
+	PayloadEntry oEntry;
+	oEntry.ui64DataSize = nBytes;
+	oEntry.iMethod = DAFF::COMPRESSION_METHOD_NONE;
+	const void* pStored = pData;
+	if (m_bCompression && (nBytes > 0)) {
+		oEntry.iMethod = DAFF::compress_chunk(pData, nBytes, iSampleSize, m_vcChunk);
+		pStored = &m_vcChunk[0];
+		oEntry.ui64Size = m_vcChunk.size();
+		oEntry.ui64Offset = m_ui64DataOffset + m_ui64CompressedSize;
+	} else {
+		oEntry.ui64Size = nBytes;
+		oEntry.ui64Offset = m_ui64DataOffset + m_ui64DataSize;
+	}
+
+	uint64_t ui64Hash = 0;
+	if (m_bDeduplication && (nBytes > 0)) {
+		ui64Hash = hashPayload(pStored, (size_t)oEntry.ui64Size, nBytes);
+		if (!findPayload(ui64Hash, oEntry, pStored, ui64DataOffset))
+			return false;
+
+		if (ui64DataOffset != UINT64_MAX) {
+			m_iNumSharedRecordChannels++;
+			return true;
+		}
+	}
+
+	ui64DataOffset = m_ui64DataSize;
+	oEntry.ui64DataOffset = ui64DataOffset;
+	bool bSuccess;
+	if (m_bCompression)
+		bSuccess = writeChunk(oEntry);
+	else
+		bSuccess = writeBlock(pData, nBytes, m_ui64DataSize, m_iDataAlignment);
+
+	if (bSuccess && m_bDeduplication && (nBytes > 0))
+		m_mPayloads.insert(PayloadMap::value_type(ui64Hash, oEntry));
+
+	return bSuccess;
+}
+
+bool DAFFWriter::writeStatistics(const void* pData, int iNumValues, int iOffset, float fScale)
+{
+	// Stored values as the reader converts them
+	m_vfStored.resize(std::max(iNumValues, 1));
+	float* pfStored = &m_vfStored[0];
+	switch (m_iQuantization) {
+	case DAFF_INT16:
+		DAFF::stc_sint16_to_float(pfStored, (const short*)pData, iNumValues);
+		break;
+
+	case DAFF_INT16_BFP:
+		DAFF::stc_sint16_to_float(pfStored, (const short*)pData, iNumValues, 1, 1, fScale);
+		break;
+
+	case DAFF_INT24:
+		DAFF::stc_sint24_to_float(pfStored, pData, iNumValues);
+		break;
+
+	case DAFF_FLOAT16:
+		DAFF::stc_half_to_float(pfStored, (const unsigned short*)pData, iNumValues);
+		break;
+
+	case DAFF_BFLOAT16:
+		DAFF::stc_bfloat16_to_float(pfStored, (const unsigned short*)pData, iNumValues);
+		break;
+
+	default:
+		memcpy(pfStored, pData, (size_t)iNumValues * sizeof(float));
+		break;
+	}
+
+	// Like DAFFReaderImpl::scanStatistics, omitted values are zero
+	DAFFStatisticsEntry oEntry;
+	oEntry.fPeak = DAFF::peak_float(pfStored, iNumValues);
+	oEntry.fEnergy = (float)DAFF::energy_float(pfStored, iNumValues);
+	oEntry.iOnset = -1;
+	if (oEntry.fPeak > 0) {
+		float fThreshold = 0.1f * oEntry.fPeak;
+		for (int k = 0; k < iNumValues; k++) {
+			if (std::fabs(pfStored[k]) >= fThreshold) {
+				oEntry.iOnset = iOffset + k;
+				break;
+			}
+		}
+	}
+
+	oEntry.fixEndianness();
+	return (fwrite(&oEntry, sizeof(oEntry), 1, m_pStatisticsFile) == 1);
+}
+
+bool DAFFWriter::writeDirectionIndex(uint64_t& ui64Pos, uint64_t& ui64Size)
+{
+	// Directions of the full grid, as the reader determines them
+	int iNumRecords = (m_vfAlpha.empty() ? getGridSize(m_iAlphaPoints) : (int)m_vfAlpha.size());
+	std::vector<float> vfAlpha(m_vfAlpha), vfBeta(m_vfBeta);
+	if (m_vfAlpha.empty()) {
+		vfAlpha.resize(iNumRecords);
+		vfBeta.resize(iNumRecords);
+		for (int i = 0; i < iNumRecords; i++)
+			getGridCoords(i, m_iAlphaPoints, m_fAlphaEnd, vfAlpha[i], vfBeta[i]);
+	}
+
+	DAFFSphereIndex oIndex;
+	oIndex.init(vfAlpha.data(), vfBeta.data(), iNumRecords);
+
+	std::vector<DAFFDirectionIndexEntry> vEntries(iNumRecords);
+	for (int i = 0; i < iNumRecords; i++) {
+		int iIndex, iAxis;
+		oIndex.getNode(i, iIndex, iAxis);
+		vEntries[i].iRecordIndex = iIndex;
+		vEntries[i].iAxis = iAxis;
+		vEntries[i].fixEndianness();
+	}
+
+	ui64Size = vEntries.size() * sizeof(DAFFDirectionIndexEntry);
+	return writeBlock(vEntries.data(), (size_t)ui64Size, ui64Pos);
+}
+
+bool DAFFWriter::writeChecksums(const std::vector<DAFFFileBlockEntry>& vBlocks, int iBlock, const char* pHeaders)
+{
+	DAFFChecksumHeader oHeader;
+	oHeader.iNumFileBlocks = (int32_t)vBlocks.size();
+	oHeader.iSegmentSize = DAFF_WRITER_CHECKSUM_SEGMENT_SIZE;
+	oHeader.ui32HeaderChecksum =
+		DAFF::crc32c(pHeaders, sizeof(DAFFFileHeader) + vBlocks.size() * sizeof(DAFFFileBlockEntry));
+	oHeader.iReserved = 0;
+
+	// The blocks are read back segment by segment (the checksum block is still empty)
+	std::vector<uint32_t> vui32Checksums;
+	m_vcBuf.resize(DAFF_WRITER_CHECKSUM_SEGMENT_SIZE);
+	for (size_t i = 0; i < vBlocks.size(); i++) {
+		if ((int)i == iBlock)
+			continue;
+
+		if ((vBlocks[i].ui64Size > 0) && (fseek(m_pFile, (long)vBlocks[i].ui64Offset, SEEK_SET) != 0))
+			return false;
+
+		for (uint64_t ui64Done = 0; ui64Done < vBlocks[i].ui64Size; ui64Done += m_vcBuf.size()) {
+			size_t nBytes = (size_t)std::min(vBlocks[i].ui64Size - ui64Done, (uint64_t)m_vcBuf.size());
+			if (fread(&m_vcBuf[0], 1, nBytes, m_pFile) != nBytes)
+				return false;
+			vui32Checksums.push_back(DAFF::crc32c(&m_vcBuf[0], nBytes));
+		}
+	}
+
+	oHeader.fixEndianness();
+	DAFF::le2se_4byte(vui32Checksums.data(), vui32Checksums.size());
+
+	size_t nChecksumsSize = vui32Checksums.size() * sizeof(uint32_t);
+	if (sizeof(DAFFChecksumHeader) + nChecksumsSize != vBlocks[iBlock].ui64Size)
+		return false;
+
+	return (fseek(m_pFile, (long)vBlocks[iBlock].ui64Offset, SEEK_SET) == 0) &&
+		   (fwrite(&oHeader, sizeof(oHeader), 1, m_pFile) == 1) &&
+		   ((nChecksumsSize == 0) || (fwrite(vui32Checksums.data(), 1, nChecksumsSize, m_pFile) == nChecksumsSize));
+}
+
+bool DAFFWriter::findPayload(uint64_t ui64Hash, const PayloadEntry& oEntry, const void* pStored,
+							 uint64_t& ui64DataOffset)
+{
+	ui64DataOffset = UINT64_MAX;
+
+	// Hash collisions are ruled out by comparing with the bytes in the file
+	std::pair<PayloadMap::const_iterator, PayloadMap::const_iterator> range = m_mPayloads.equal_range(ui64Hash);
+	for (PayloadMap::const_iterator it = range.first; it != range.second; ++it) {
+		const PayloadEntry& oCandidate = it->second;
+		if ((oCandidate.ui64DataSize != oEntry.ui64DataSize) || (oCandidate.ui64Size != oEntry.ui64Size) ||
+			(oCandidate.iMethod != oEntry.iMethod))
+			continue;
+
+		m_vcCompare.resize((size_t)oCandidate.ui64Size);
+		if ((fseek(m_pFile, (long)oCandidate.ui64Offset, SEEK_SET) != 0) ||
+			(fread(&m_vcCompare[0], 1, m_vcCompare.size(), m_pFile) != m_vcCompare.size()))
+			return false;
+
+		if (memcmp(&m_vcCompare[0], pStored, m_vcCompare.size()) == 0) {
+			ui64DataOffset = oCandidate.ui64DataOffset;
+			break;
+		}
+	}
+
+	// Continue writing at the end
+	return (range.first == range.second) || (fseek(m_pFile, 0, SEEK_END) == 0);
+}
+
+bool DAFFWriter::writeChunk(const PayloadEntry& oEntry)
+{
+	// The uncompressed layout stays the same, only the compressed chunks are written
+	m_ui64DataSize = alignTo(m_ui64DataSize + oEntry.ui64DataSize, m_iDataAlignment);
+	if (oEntry.ui64DataSize == 0)
+		return true;
+
+	DAFFCompressedChunkEntry oChunk;
+	oChunk.ui64DataOffset = oEntry.ui64DataOffset;
+	oChunk.ui64DataSize = oEntry.ui64DataSize;
+	oChunk.ui64Offset = m_ui64CompressedSize;
+	oChunk.ui64Size = oEntry.ui64Size;
+	oChunk.iMethod = oEntry.iMethod;
+	m_ui64CompressedSize += oChunk.ui64Size;
+	m_iNumChunks++;
+	oChunk.fixEndianness();
+
+	return (fwrite(&m_vcChunk[0], 1, m_vcChunk.size(), m_pFile) == m_vcChunk.size()) &&
+		   (fwrite(&oChunk, sizeof(oChunk), 1, m_pChunkFile) == 1);
+}
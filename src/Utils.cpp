@@ -1,9 +1,17 @@
+// Use 64-bit off_t on 32-bit POSIX systems (must precede all system includes)
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
 #include "Utils.h"
 
 #include <DAFFUtils.h>
 
+#include "DAFFSIMD.h"
+
 #ifdef _MSC_VER
 // Microsoft Visual Studio compilers
+#include <intrin.h>
 #include <windows.h>
 #endif
 
@@ -19,6 +27,10 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
 namespace DAFF {
 // --= Angle conversion and normalization =--
 
@@ -70,10 +82,7 @@ float cabs(float Re, float Im)
 
 float carg(float Re, float Im)
 {
-	if (Re > 0)
-		return atan(Im / Re);
-	else
-		return PI_F + atan(Im / Re);
+	return scalar_carg(Re, Im);
 }
 
 // --= Endianess conversion functions =--
@@ -110,83 +119,189 @@ void (*le2se_3byte)(void* src, size_t count) = (iTest == 1 ? &noswap : &byteswap
 void (*le2se_4byte)(void* src, size_t count) = (iTest == 1 ? &noswap : &byteswap_4byte);
 void (*le2se_8byte)(void* src, size_t count) = (iTest == 1 ? &noswap : &byteswap_8byte);
 
-/**
- * [fwe 2009-05-02] This implementation is probably not the most efficient.
- *                  Maybe improve this sometime in the future...
- */
+bool is_little_endian()
+{
+	return (iTest == 1);
+}
 
-// Swap with temporary variable
-#define SWAP(i, j) \
-	tmp = p[i];    \
-	p[i] = p[j];   \
-	p[j] = tmp;
+// --= CPU features =--
 
-void byteswap_2byte(void* src, size_t count)
+bool cpu_supports_avx2()
 {
-	// In:  |  B1  |  B0  |
-	// Out: |  B0  |  B1  |
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+
+	// AVX and OSXSAVE, then YMM state enabled by the OS
+	__cpuid(info, 1);
+	if (((info[2] & (1 << 27)) == 0) || ((info[2] & (1 << 28)) == 0))
+		return false;
+	if ((_xgetbv(0) & 6) != 6)
+		return false;
+
+	__cpuidex(info, 7, 0);
+	return ((info[1] & (1 << 5)) != 0);
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	// May be called during static initialization
+	__builtin_cpu_init();
+	return (__builtin_cpu_supports("avx2") != 0);
+#else
+	return false;
+#endif
+}
 
-	char* p = (char*)src;
-	char tmp;
+bool cpu_supports_f16c()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	int info[4];
+	__cpuid(info, 1);
+	return ((info[2] & (1 << 29)) != 0);
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_cpu_init();
+	return (__builtin_cpu_supports("f16c") != 0);
+#else
+	return false;
+#endif
+}
 
-	for (size_t i = 0; i < count; i++) {
-		SWAP(0, 1);
+bool cpu_supports_sse42()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	int info[4];
+	__cpuid(info, 1);
+	return ((info[2] & (1 << 20)) != 0);
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_cpu_init();
+	return (__builtin_cpu_supports("sse4.2") != 0);
+#else
+	return false;
+#endif
+}
 
-		p = p + 2;
-	}
+// --= Byte order reversal =--
+
+
+// Byte order reversal kernels, selected once for the host CPU
+typedef void (*ByteswapKernel)(void*, const void*, size_t);
+
+static ByteswapKernel select_byteswap_2byte_kernel()
+{
+	if (simd_avx2_compiled() && cpu_supports_avx2())
+		return &simd_byteswap_2byte_avx2;
+#if defined(DAFF_SIMD_SSE2)
+	return &simd_byteswap_2byte_sse2;
+#elif defined(DAFF_SIMD_NEON)
+	return &simd_byteswap_2byte_neon;
+#else
+	return &scalar_byteswap_2byte;
+#endif
 }
 
-void byteswap_3byte(void* src, size_t count)
+static ByteswapKernel select_byteswap_3byte_kernel()
 {
-	// In:  |  B2  |  B1  |  B0  |
-	// Out: |  B0  |  B1  |  B2  |
+	if (simd_avx2_compiled() && cpu_supports_avx2())
+		return &simd_byteswap_3byte_avx2;
+#if defined(DAFF_SIMD_NEON)
+	return &simd_byteswap_3byte_neon;
+#else
+	return &scalar_byteswap_3byte;
+#endif
+}
 
-	char* p = (char*)src;
-	char tmp;
+static ByteswapKernel select_byteswap_4byte_kernel()
+{
+	if (simd_avx2_compiled() && cpu_supports_avx2())
+		return &simd_byteswap_4byte_avx2;
+#if defined(DAFF_SIMD_SSE2)
+	return &simd_byteswap_4byte_sse2;
+#elif defined(DAFF_SIMD_NEON)
+	return &simd_byteswap_4byte_neon;
+#else
+	return &scalar_byteswap_4byte;
+#endif
+}
 
-	for (size_t i = 0; i < count; i++) {
-		SWAP(0, 2);
+static ByteswapKernel select_byteswap_8byte_kernel()
+{
+	if (simd_avx2_compiled() && cpu_supports_avx2())
+		return &simd_byteswap_8byte_avx2;
+#if defined(DAFF_SIMD_SSE2)
+	return &simd_byteswap_8byte_sse2;
+#elif defined(DAFF_SIMD_NEON)
+	return &simd_byteswap_8byte_neon;
+#else
+	return &scalar_byteswap_8byte;
+#endif
+}
 
-		p = p + 3;
-	}
+static ByteswapKernel byteswap_2byte_kernel = select_byteswap_2byte_kernel();
+static ByteswapKernel byteswap_3byte_kernel = select_byteswap_3byte_kernel();
+static ByteswapKernel byteswap_4byte_kernel = select_byteswap_4byte_kernel();
+static ByteswapKernel byteswap_8byte_kernel = select_byteswap_8byte_kernel();
+
+void byteswap_2byte(void* src, size_t count)
+{
+	byteswap_2byte_kernel(src, src, count);
+}
+
+void byteswap_3byte(void* src, size_t count)
+{
+	byteswap_3byte_kernel(src, src, count);
 }
 
 void byteswap_4byte(void* src, size_t count)
 {
-	// In:  |  B3  |  B2  |  B1  |  B0  |
-	// Out: |  B0  |  B1  |  B2  |  B3  |
+	byteswap_4byte_kernel(src, src, count);
+}
 
-	char* p = (char*)src;
-	char tmp;
+void byteswap_8byte(void* src, size_t count)
+{
+	byteswap_8byte_kernel(src, src, count);
+}
 
-	for (size_t i = 0; i < count; i++) {
-		SWAP(0, 3);
-		SWAP(1, 2);
+// Do nothing
+void noswap(void*, size_t) {}
 
-		p = p + 4;
-	}
+// Copy without conversion (in place: nothing to do)
+static void nocopyswap(void* dest, const void* src, size_t nBytes)
+{
+	if (dest != src)
+		memcpy(dest, src, nBytes);
 }
 
-void byteswap_8byte(void* src, size_t count)
+void le2se_copy_2byte(void* dest, const void* src, size_t count)
 {
-	// In:  |  B7  |  B6  |  B5  |  B4  |  B3  |  B2  |  B1  |  B0  |
-	// Out: |  B0  |  B1  |  B2  |  B3  |  B4  |  B5  |  B6  |  B7  |
-
-	char* p = (char*)src;
-	char tmp;
+	if (iTest == 1)
+		nocopyswap(dest, src, 2 * count);
+	else
+		byteswap_2byte_kernel(dest, src, count);
+}
 
-	for (size_t i = 0; i < count; i++) {
-		SWAP(0, 7);
-		SWAP(1, 6);
-		SWAP(2, 5);
-		SWAP(3, 4);
+void le2se_copy_3byte(void* dest, const void* src, size_t count)
+{
+	if (iTest == 1)
+		nocopyswap(dest, src, 3 * count);
+	else
+		byteswap_3byte_kernel(dest, src, count);
+}
 
-		p = p + 8;
-	}
+void le2se_copy_4byte(void* dest, const void* src, size_t count)
+{
+	if (iTest == 1)
+		nocopyswap(dest, src, 4 * count);
+	else
+		byteswap_4byte_kernel(dest, src, count);
 }
 
-// Do nothing
-void noswap(void*, size_t) {}
+void le2se_copy_8byte(void* dest, const void* src, size_t count)
+{
+	if (iTest == 1)
+		nocopyswap(dest, src, 8 * count);
+	else
+		byteswap_8byte_kernel(dest, src, count);
+}
 
 // --= Memory (de)allocation =--
 
@@ -216,12 +331,144 @@ void free_aligned16(void* ptr)
 #endif
 }
 
+void* malloc_aligned32(size_t bytes)
+{
+#ifdef WIN32
+	return _aligned_malloc(bytes, 32);
+#elif __APPLE__
+	void* ptr = NULL;
+	if (posix_memalign(&ptr, 32, bytes) != 0)
+		return NULL;
+	return ptr;
+#else
+	return memalign(32, bytes);
+#endif
+}
+
+void free_aligned32(void* ptr)
+{
+#ifdef WIN32
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+void* malloc_aligned64(size_t bytes)
+{
+#ifdef WIN32
+	return _aligned_malloc(bytes, 64);
+#elif __APPLE__
+	void* ptr = NULL;
+	if (posix_memalign(&ptr, 64, bytes) != 0)
+		return NULL;
+	return ptr;
+#else
+	return memalign(64, bytes);
+#endif
+}
+
+void free_aligned64(void* ptr)
+{
+#ifdef WIN32
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+void* malloc_arena(size_t bytes)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	const size_t nHugePageSize = 2 << 20;
+	if (bytes >= nHugePageSize) {
+		void* ptr = NULL;
+		if (posix_memalign(&ptr, nHugePageSize, bytes) != 0)
+			return NULL;
+		madvise(ptr, bytes, MADV_HUGEPAGE);  // Only a hint, errors are irrelevant
+		return ptr;
+	}
+#endif
+	return malloc_aligned64(bytes);
+}
+
+void free_arena(void* ptr)
+{
+	free_aligned64(ptr);
+}
+
 // --= Sample type conversion =--
 
 
+// Unit stride conversion kernels, selected once for the host CPU
+typedef void (*STCSint16Kernel)(float*, const short*, size_t, float, bool);
+typedef void (*STCSint24Kernel)(float*, const unsigned char*, size_t, float, bool);
+
+static STCSint16Kernel select_stc_sint16_kernel()
+{
+	if (simd_avx2_compiled() && cpu_supports_avx2())
+		return &simd_sint16_to_float_avx2;
+#if defined(DAFF_SIMD_SSE2)
+	return &simd_sint16_to_float_sse2;
+#elif defined(DAFF_SIMD_NEON)
+	return &simd_sint16_to_float_neon;
+#else
+	return &scalar_sint16_to_float;
+#endif
+}
+
+static STCSint24Kernel select_stc_sint24_kernel()
+{
+	if (simd_avx2_compiled() && cpu_supports_avx2())
+		return &simd_sint24_to_float_avx2;
+#if defined(DAFF_SIMD_NEON)
+	return &simd_sint24_to_float_neon;
+#else
+	return &scalar_sint24_to_float;
+#endif
+}
+
+typedef void (*STCFloat16Kernel)(float*, const unsigned short*, size_t, float, bool);
+
+static STCFloat16Kernel select_stc_half_kernel()
+{
+	if (simd_avx2_compiled() && cpu_supports_avx2() && cpu_supports_f16c())
+		return &simd_half_to_float_f16c;
+#if defined(DAFF_SIMD_SSE2)
+	return &simd_half_to_float_sse2;
+#elif defined(DAFF_SIMD_NEON)
+	return &simd_half_to_float_neon;
+#else
+	return &scalar_half_to_float;
+#endif
+}
+
+static STCFloat16Kernel select_stc_bfloat16_kernel()
+{
+	if (simd_avx2_compiled() && cpu_supports_avx2())
+		return &simd_bfloat16_to_float_avx2;
+#if defined(DAFF_SIMD_SSE2)
+	return &simd_bfloat16_to_float_sse2;
+#elif defined(DAFF_SIMD_NEON)
+	return &simd_bfloat16_to_float_neon;
+#else
+	return &scalar_bfloat16_to_float;
+#endif
+}
+
+static STCSint16Kernel stc_sint16_unit = select_stc_sint16_kernel();
+static STCSint24Kernel stc_sint24_unit = select_stc_sint24_kernel();
+static STCFloat16Kernel stc_half_unit = select_stc_half_kernel();
+static STCFloat16Kernel stc_bfloat16_unit = select_stc_bfloat16_kernel();
+
 void stc_sint16_to_float(float* dest, const short* src, size_t count, int input_stride, int output_stride, float gain)
 {
 	float c = gain / 32767.0F;
+	if ((input_stride == 1) && (output_stride == 1)) {
+		stc_sint16_unit(dest, src, count, c, false);
+		return;
+	}
+
 	for (size_t i = 0; i < count; i++)
 		dest[i * output_stride] = (float)src[i * input_stride] * c;
 }
@@ -230,6 +477,11 @@ void stc_sint16_to_float_add(float* dest, const short* src, size_t count, int in
 							 float gain)
 {
 	float c = gain / 32767.0F;
+	if ((input_stride == 1) && (output_stride == 1)) {
+		stc_sint16_unit(dest, src, count, c, true);
+		return;
+	}
+
 	for (size_t i = 0; i < count; i++)
 		dest[i * output_stride] += (float)src[i * input_stride] * c;
 }
@@ -245,6 +497,11 @@ void stc_sint24_to_float(float* dest, const void* src, size_t count, int input_s
 
 	float c = gain / 8388607.0F;
 
+	if ((iTest == 1) && (input_stride == 1) && (output_stride == 1)) {
+		stc_sint24_unit(dest, p, count, c, false);
+		return;
+	}
+
 	if (iTest != 1) {
 		for (size_t i = 0; i < count; i++) {
 			// Big endian
@@ -294,6 +551,11 @@ void stc_sint24_to_float_add(float* dest, const void* src, size_t count, int inp
 
 	float c = gain / 8388607.0F;
 
+	if ((iTest == 1) && (input_stride == 1) && (output_stride == 1)) {
+		stc_sint24_unit(dest, p, count, c, true);
+		return;
+	}
+
 	if (iTest != 1) {
 		for (size_t i = 0; i < count; i++) {
 			// Big endian
@@ -331,6 +593,636 @@ void stc_sint24_to_float_add(float* dest, const void* src, size_t count, int inp
 	}
 }
 
+//! Rounds half away from zero and saturates to [-iMax-1, iMax] (NaN: 0)
+static inline int quantize_float(float x, int iMax)
+{
+	float y = x * (float)iMax;
+	if (y != y)
+		return 0;
+	if (y >= (float)iMax)
+		return iMax;
+	if (y <= (float)(-iMax - 1))
+		return -iMax - 1;
+	return (int)(y < 0 ? y - 0.5F : y + 0.5F);
+}
+
+void stc_float_to_sint16(short* dest, const float* src, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		dest[i] = (short)quantize_float(src[i], 32767);
+}
+
+void stc_float_to_sint24(void* dest, const float* src, size_t count)
+{
+	unsigned char* p = (unsigned char*)dest;
+	for (size_t i = 0; i < count; i++) {
+		int x = quantize_float(src[i], 8388607);
+
+		// Byte order of the system, like the data after le2se_3byte
+		if (iTest == 1) {
+			p[0] = (unsigned char)(x & 0xFF);
+			p[1] = (unsigned char)((x >> 8) & 0xFF);
+			p[2] = (unsigned char)((x >> 16) & 0xFF);
+		} else {
+			p[0] = (unsigned char)((x >> 16) & 0xFF);
+			p[1] = (unsigned char)((x >> 8) & 0xFF);
+			p[2] = (unsigned char)(x & 0xFF);
+		}
+		p += 3;
+	}
+}
+
+// 16-bit floats are stored in the byte order of the system (after le2se_2byte), no endianness cases
+
+void stc_half_to_float(float* dest, const unsigned short* src, size_t count, int input_stride, int output_stride,
+					   float gain)
+{
+	if ((input_stride == 1) && (output_stride == 1)) {
+		stc_half_unit(dest, src, count, gain, false);
+		return;
+	}
+
+	for (size_t i = 0; i < count; i++)
+		dest[i * output_stride] = sample_half(src[i * input_stride]) * gain;
+}
+
+void stc_half_to_float_add(float* dest, const unsigned short* src, size_t count, int input_stride, int output_stride,
+						   float gain)
+{
+	if ((input_stride == 1) && (output_stride == 1)) {
+		stc_half_unit(dest, src, count, gain, true);
+		return;
+	}
+
+	for (size_t i = 0; i < count; i++)
+		dest[i * output_stride] += sample_half(src[i * input_stride]) * gain;
+}
+
+void stc_bfloat16_to_float(float* dest, const unsigned short* src, size_t count, int input_stride,
+						   int output_stride, float gain)
+{
+	if ((input_stride == 1) && (output_stride == 1)) {
+		stc_bfloat16_unit(dest, src, count, gain, false);
+		return;
+	}
+
+	for (size_t i = 0; i < count; i++)
+		dest[i * output_stride] = sample_bfloat16(src[i * input_stride]) * gain;
+}
+
+void stc_bfloat16_to_float_add(float* dest, const unsigned short* src, size_t count, int input_stride,
+							   int output_stride, float gain)
+{
+	if ((input_stride == 1) && (output_stride == 1)) {
+		stc_bfloat16_unit(dest, src, count, gain, true);
+		return;
+	}
+
+	for (size_t i = 0; i < count; i++)
+		dest[i * output_stride] += sample_bfloat16(src[i * input_stride]) * gain;
+}
+
+void stc_float_to_half(unsigned short* dest, const float* src, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		unsigned int u;
+		memcpy(&u, &src[i], sizeof(float));
+		unsigned int sign = (u >> 16) & 0x8000;
+		u &= 0x7FFFFFFF;
+
+		unsigned int h;
+		if (u >= 0x47800000) {
+			// Overflow becomes infinity, NaN stays a (quiet) NaN
+			h = (u > 0x7F800000 ? 0x7E00 : 0x7C00);
+		} else if (u < 0x38800000) {
+			// Subnormal or zero: adding 0.5 rounds at the last half precision digit (to nearest even)
+			float f;
+			memcpy(&f, &u, sizeof(float));
+			f += 0.5F;
+			memcpy(&u, &f, sizeof(float));
+			h = u - 0x3F000000;
+		} else {
+			// Normal: rebias the exponent and round the mantissa to nearest even
+			h = (u + 0xC8000FFF + ((u >> 13) & 1)) >> 13;
+		}
+
+		dest[i] = (unsigned short)(h | sign);
+	}
+}
+
+void stc_float_to_bfloat16(unsigned short* dest, const float* src, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		unsigned int u;
+		memcpy(&u, &src[i], sizeof(float));
+
+		// NaN stays a (quiet) NaN, everything else is rounded to nearest even
+		if ((u & 0x7FFFFFFF) > 0x7F800000)
+			dest[i] = (unsigned short)((u >> 16) | 0x0040);
+		else
+			dest[i] = (unsigned short)((u + 0x7FFF + ((u >> 16) & 1)) >> 16);
+	}
+}
+
+// Fixed-point output kernels (24-bit samples use the scalar code)
+typedef void (*STCQ15Sint16Kernel)(int16_t*, const int16_t*, size_t, float, bool);
+typedef void (*STCQ15FloatKernel)(int16_t*, const float*, size_t, float, bool);
+typedef void (*STCQ31Sint16Kernel)(int32_t*, const int16_t*, size_t, double, bool);
+typedef void (*STCQ31FloatKernel)(int32_t*, const float*, size_t, double, bool);
+
+#if defined(DAFF_SIMD_SSE2)
+static const STCQ15Sint16Kernel stc_sint16_q15_unit = &simd_sint16_to_q15_sse2;
+static const STCQ15FloatKernel stc_float_q15_unit = &simd_float_to_q15_sse2;
+static const STCQ31Sint16Kernel stc_sint16_q31_unit = &simd_sint16_to_q31_sse2;
+static const STCQ31FloatKernel stc_float_q31_unit = &simd_float_to_q31_sse2;
+#elif defined(DAFF_SIMD_NEON)
+static const STCQ15Sint16Kernel stc_sint16_q15_unit = &simd_sint16_to_q15_neon;
+static const STCQ15FloatKernel stc_float_q15_unit = &simd_float_to_q15_neon;
+static const STCQ31Sint16Kernel stc_sint16_q31_unit = &simd_sint16_to_q31_neon;
+static const STCQ31FloatKernel stc_float_q31_unit = &simd_float_to_q31_neon;
+#else
+static const STCQ15Sint16Kernel stc_sint16_q15_unit = &scalar_sint16_to_q15;
+static const STCQ15FloatKernel stc_float_q15_unit = &scalar_float_to_q15;
+static const STCQ31Sint16Kernel stc_sint16_q31_unit = &scalar_sint16_to_q31;
+static const STCQ31FloatKernel stc_float_q31_unit = &scalar_float_to_q31;
+#endif
+
+//! Runs a 24-bit kernel on little endian samples (big endian systems swap blocks of samples on the stack)
+template <class T, class C>
+static void stc_sint24_to_fixed(T* dest, const void* src, size_t count, C c, bool add,
+								void (*kernel)(T*, const unsigned char*, size_t, C, bool))
+{
+	const unsigned char* p = (const unsigned char*)src;
+	if (iTest == 1) {
+		kernel(dest, p, count, c, add);
+		return;
+	}
+
+	unsigned char pBlock[3 * 256];
+	for (size_t i = 0; i < count; i += 256) {
+		size_t n = (count - i < 256 ? count - i : 256);
+		scalar_byteswap_3byte(pBlock, p + 3 * i, n);
+		kernel(dest + i, pBlock, n, c, add);
+	}
+}
+
+void stc_sint16_to_q15(int16_t* dest, const int16_t* src, size_t count, float gain)
+{
+	if (gain == 1)
+		memcpy(dest, src, count * sizeof(int16_t));
+	else
+		stc_sint16_q15_unit(dest, src, count, gain, false);
+}
+
+void stc_sint16_to_q15_add(int16_t* dest, const int16_t* src, size_t count, float gain)
+{
+	stc_sint16_q15_unit(dest, src, count, gain, true);
+}
+
+void stc_sint24_to_q15(int16_t* dest, const void* src, size_t count, float gain)
+{
+	stc_sint24_to_fixed(dest, src, count, gain * (32767.0F / 8388607.0F), false, &scalar_sint24_to_q15);
+}
+
+void stc_sint24_to_q15_add(int16_t* dest, const void* src, size_t count, float gain)
+{
+	stc_sint24_to_fixed(dest, src, count, gain * (32767.0F / 8388607.0F), true, &scalar_sint24_to_q15);
+}
+
+void stc_float_to_q15(int16_t* dest, const float* src, size_t count, float gain)
+{
+	stc_float_q15_unit(dest, src, count, gain * 32767.0F, false);
+}
+
+void stc_float_to_q15_add(int16_t* dest, const float* src, size_t count, float gain)
+{
+	stc_float_q15_unit(dest, src, count, gain * 32767.0F, true);
+}
+
+void stc_sint16_to_q31(int32_t* dest, const int16_t* src, size_t count, float gain)
+{
+	stc_sint16_q31_unit(dest, src, count, gain * (2147483647.0 / 32767.0), false);
+}
+
+void stc_sint16_to_q31_add(int32_t* dest, const int16_t* src, size_t count, float gain)
+{
+	stc_sint16_q31_unit(dest, src, count, gain * (2147483647.0 / 32767.0), true);
+}
+
+void stc_sint24_to_q31(int32_t* dest, const void* src, size_t count, float gain)
+{
+	stc_sint24_to_fixed(dest, src, count, gain * (2147483647.0 / 8388607.0), false, &scalar_sint24_to_q31);
+}
+
+void stc_sint24_to_q31_add(int32_t* dest, const void* src, size_t count, float gain)
+{
+	stc_sint24_to_fixed(dest, src, count, gain * (2147483647.0 / 8388607.0), true, &scalar_sint24_to_q31);
+}
+
+void stc_float_to_q31(int32_t* dest, const float* src, size_t count, float gain)
+{
+	stc_float_q31_unit(dest, src, count, gain * 2147483647.0, false);
+}
+
+void stc_float_to_q31_add(int32_t* dest, const float* src, size_t count, float gain)
+{
+	stc_float_q31_unit(dest, src, count, gain * 2147483647.0, true);
+}
+
+void stc_float_to_fixed_point(int16_t* dest_q15, int32_t* dest_q31, const float* src, size_t count, float gain,
+							  bool add)
+{
+	if (dest_q15)
+		stc_float_q15_unit(dest_q15, src, count, gain * 32767.0F, add);
+	else
+		stc_float_q31_unit(dest_q31, src, count, gain * 2147483647.0, add);
+}
+
+// --= Peak values =--
+
+//! Greatest bit pattern of the absolute values below a limit (positive floats are ordered like their bit patterns)
+static inline unsigned short max_abs_float16(const unsigned short* src, size_t count, unsigned short limit)
+{
+	unsigned short iMax = 0;
+	for (size_t i = 0; i < count; i++) {
+		unsigned short x = (unsigned short)(src[i] & 0x7FFF);
+		iMax = ((x > iMax) && (x <= limit) ? x : iMax);
+	}
+	return iMax;
+}
+
+static inline int max_abs_sint16(const short* src, size_t count)
+{
+#if defined(DAFF_SIMD_SSE2)
+	return simd_max_abs_sint16_sse2(src, count);
+#elif defined(DAFF_SIMD_NEON)
+	return simd_max_abs_sint16_neon(src, count);
+#else
+	return scalar_max_abs_sint16(src, count);
+#endif
+}
+
+static inline float max_abs_float(const float* src, size_t count)
+{
+#if defined(DAFF_SIMD_SSE2)
+	return simd_max_abs_float_sse2(src, count);
+#elif defined(DAFF_SIMD_NEON)
+	return simd_max_abs_float_neon(src, count);
+#else
+	return scalar_max_abs_float(src, count);
+#endif
+}
+
+float peak_sint16(const short* src, size_t count)
+{
+	return (float)max_abs_sint16(src, count) * (1 / 32767.0F);
+}
+
+float peak_sint24(const void* src, size_t count)
+{
+	if (iTest == 1)
+		return (float)scalar_max_abs_sint24((const unsigned char*)src, count) * (1 / 8388607.0F);
+
+	// Big endian: Use the regular conversion
+	const unsigned char* p = (const unsigned char*)src;
+	float pfBuf[256];
+	float fPeak = 0;
+	for (size_t i = 0; i < count; i += 256) {
+		size_t n = (count - i < 256 ? count - i : 256);
+		stc_sint24_to_float(pfBuf, p + 3 * i, n);
+		float fMax = max_abs_float(pfBuf, n);
+		fPeak = (fMax > fPeak ? fMax : fPeak);
+	}
+	return fPeak;
+}
+
+float peak_float(const float* src, size_t count)
+{
+	return max_abs_float(src, count);
+}
+
+float peak_half(const unsigned short* src, size_t count)
+{
+	return sample_half(max_abs_float16(src, count, 0x7C00));
+}
+
+float peak_bfloat16(const unsigned short* src, size_t count)
+{
+	return sample_bfloat16(max_abs_float16(src, count, 0x7F80));
+}
+
+float bounds_float(const float* src, size_t count, float threshold, size_t& begin, size_t& end)
+{
+#if defined(DAFF_SIMD_SSE2)
+	return simd_bounds_float_sse2(src, count, threshold, begin, end);
+#elif defined(DAFF_SIMD_NEON)
+	return simd_bounds_float_neon(src, count, threshold, begin, end);
+#else
+	return scalar_bounds_float(src, count, threshold, begin, end);
+#endif
+}
+
+double energy_float(const float* src, size_t count)
+{
+#if defined(DAFF_SIMD_SSE2)
+	return simd_energy_float_sse2(src, count);
+#elif defined(DAFF_SIMD_NEON)
+	return simd_energy_float_neon(src, count);
+#else
+	return scalar_energy_float(src, count);
+#endif
+}
+
+void minmax_float(const float* src, size_t count, float& fMin, float& fMax)
+{
+#if defined(DAFF_SIMD_SSE2)
+	simd_minmax_float<VecSSE2>(src, count, fMin, fMax);
+#elif defined(DAFF_SIMD_NEON)
+	simd_minmax_float<VecNEON>(src, count, fMin, fMax);
+#else
+	scalar_minmax_float(src, count, fMin, fMax);
+#endif
+}
+
+// --= Vector operations =--
+
+void mul_float(float* dest, const float* src, size_t count)
+{
+#if defined(DAFF_SIMD_SSE2)
+	simd_mul_float<VecSSE2>(dest, src, count);
+#elif defined(DAFF_SIMD_NEON)
+	simd_mul_float<VecNEON>(dest, src, count);
+#else
+	scalar_mul_float(dest, src, count);
+#endif
+}
+
+void sub_float(float* dest, const float* a, const float* b, size_t count)
+{
+#if defined(DAFF_SIMD_SSE2)
+	simd_sub_float<VecSSE2>(dest, a, b, count);
+#elif defined(DAFF_SIMD_NEON)
+	simd_sub_float<VecNEON>(dest, a, b, count);
+#else
+	scalar_sub_float(dest, a, b, count);
+#endif
+}
+
+void ratio_float(float* dest, const float* a, const float* b, float floor, size_t count)
+{
+#if defined(DAFF_SIMD_SSE2)
+	simd_ratio_float<VecSSE2>(dest, a, b, floor, count);
+#elif defined(DAFF_SIMD_NEON)
+	simd_ratio_float<VecNEON>(dest, a, b, floor, count);
+#else
+	scalar_ratio_float(dest, a, b, floor, count);
+#endif
+}
+
+void blend_float(float* dest, const float* const* src, const float* gain, int n, size_t count)
+{
+#if defined(DAFF_SIMD_SSE2)
+	simd_blend_float<VecSSE2>(dest, src, gain, n, count);
+#elif defined(DAFF_SIMD_NEON)
+	simd_blend_float<VecNEON>(dest, src, gain, n, count);
+#else
+	scalar_blend_float(dest, src, gain, n, 0, count);
+#endif
+}
+
+void crossfade_float(float* dest, const float* a, const float* b, size_t count, float t0, float dt, bool cosine)
+{
+#if defined(DAFF_SIMD_SSE2)
+	simd_crossfade_float<VecSSE2>(dest, a, b, count, t0, dt, cosine);
+#elif defined(DAFF_SIMD_NEON)
+	simd_crossfade_float<VecNEON>(dest, a, b, count, t0, dt, cosine);
+#else
+	scalar_crossfade_float(dest, a, b, 0, count, t0, dt, cosine);
+#endif
+}
+
+float dot_float(const float* a, const float* b, size_t count)
+{
+#if defined(DAFF_SIMD_SSE2)
+	return simd_dot_float<VecSSE2>(a, b, count);
+#elif defined(DAFF_SIMD_NEON)
+	return simd_dot_float<VecNEON>(a, b, count);
+#else
+	return scalar_dot_float(a, b, count);
+#endif
+}
+
+void sqmac_float(float* dest, const float* src, float w, size_t count)
+{
+#if defined(DAFF_SIMD_SSE2)
+	simd_sqmac_float<VecSSE2>(dest, src, w, count);
+#elif defined(DAFF_SIMD_NEON)
+	simd_sqmac_float<VecNEON>(dest, src, w, count);
+#else
+	scalar_sqmac_float(dest, src, w, count);
+#endif
+}
+
+template <class C>
+static size_t select_float_kernel(int* dest, const float* src, float value, size_t count)
+{
+#if defined(DAFF_SIMD_SSE2)
+	return simd_select_float<VecSSE2, C>(dest, src, value, count);
+#elif defined(DAFF_SIMD_NEON)
+	return simd_select_float<VecNEON, C>(dest, src, value, count);
+#else
+	return scalar_select_float<C>(dest, src, value, 0, count);
+#endif
+}
+
+size_t select_float(int* dest, const float* src, float value, int op, size_t count)
+{
+	switch (op) {
+	case DAFF_EQ:
+		return select_float_kernel<CmpEQ>(dest, src, value, count);
+	case DAFF_NE:
+		return select_float_kernel<CmpNE>(dest, src, value, count);
+	case DAFF_LT:
+		return select_float_kernel<CmpLT>(dest, src, value, count);
+	case DAFF_LE:
+		return select_float_kernel<CmpLE>(dest, src, value, count);
+	case DAFF_GT:
+		return select_float_kernel<CmpGT>(dest, src, value, count);
+	case DAFF_GE:
+		return select_float_kernel<CmpGE>(dest, src, value, count);
+	default:
+		return 0;
+	}
+}
+
+// --= Complex values =--
+
+// Kernels for interleaved pairs, selected once for the host CPU
+typedef void (*Cart2PolarKernel)(float*, const float*, size_t);
+typedef void (*Polar2CartKernel)(float*, const float*, const float*, size_t);
+typedef void (*CMacKernel)(float*, const float*, const float*, size_t);
+typedef void (*DeinterleaveKernel)(float*, float*, const float*, size_t);
+typedef void (*ConjMirrorKernel)(float*, const float*, size_t);
+
+static Cart2PolarKernel select_cart2polar_kernel()
+{
+	if (simd_avx2_compiled() && cpu_supports_avx2())
+		return &simd_cart2polar_float_avx2;
+#if defined(DAFF_SIMD_SSE2)
+	return &simd_cart2polar_float<VecSSE2>;
+#elif defined(DAFF_SIMD_NEON)
+	return &simd_cart2polar_float<VecNEON>;
+#else
+	return &scalar_cart2polar_float;
+#endif
+}
+
+static Polar2CartKernel select_polar2cart_kernel()
+{
+	if (simd_avx2_compiled() && cpu_supports_avx2())
+		return &simd_polar2cart_float_avx2;
+#if defined(DAFF_SIMD_SSE2)
+	return &simd_polar2cart_float<VecSSE2>;
+#elif defined(DAFF_SIMD_NEON)
+	return &simd_polar2cart_float<VecNEON>;
+#else
+	return &scalar_polar2cart_float;
+#endif
+}
+
+static CMacKernel select_cmac_kernel()
+{
+	if (simd_avx2_compiled() && cpu_supports_avx2())
+		return &simd_cmac_float_avx2;
+#if defined(DAFF_SIMD_SSE2)
+	return &simd_cmac_float<VecSSE2>;
+#elif defined(DAFF_SIMD_NEON)
+	return &simd_cmac_float<VecNEON>;
+#else
+	return &scalar_cmac_float;
+#endif
+}
+
+static DeinterleaveKernel select_deinterleave_kernel()
+{
+	if (simd_avx2_compiled() && cpu_supports_avx2())
+		return &simd_deinterleave_float_avx2;
+#if defined(DAFF_SIMD_SSE2)
+	return &simd_deinterleave_float<VecSSE2>;
+#elif defined(DAFF_SIMD_NEON)
+	return &simd_deinterleave_float<VecNEON>;
+#else
+	return &scalar_deinterleave_float;
+#endif
+}
+
+static ConjMirrorKernel select_conj_mirror_kernel()
+{
+	if (simd_avx2_compiled() && cpu_supports_avx2())
+		return &simd_conj_mirror_float_avx2;
+#if defined(DAFF_SIMD_SSE2)
+	return &simd_conj_mirror_float<VecSSE2>;
+#elif defined(DAFF_SIMD_NEON)
+	return &simd_conj_mirror_float<VecNEON>;
+#else
+	return &scalar_conj_mirror_float;
+#endif
+}
+
+static Cart2PolarKernel cart2polar_kernel = select_cart2polar_kernel();
+static Polar2CartKernel polar2cart_kernel = select_polar2cart_kernel();
+static CMacKernel cmac_kernel = select_cmac_kernel();
+static DeinterleaveKernel deinterleave_kernel = select_deinterleave_kernel();
+static ConjMirrorKernel conj_mirror_kernel = select_conj_mirror_kernel();
+
+void cart2polar_float(float* dest, const float* src, size_t count)
+{
+	cart2polar_kernel(dest, src, count);
+}
+
+void polar2cart_float(float* dest, const float* mag, const float* phase, size_t count)
+{
+	polar2cart_kernel(dest, mag, phase, count);
+}
+
+void cmac_float(float* dest, const float* a, const float* b, size_t count)
+{
+	cmac_kernel(dest, a, b, count);
+}
+
+void csqmac_float(float* dest, const float* src, float w, size_t count)
+{
+#if defined(DAFF_SIMD_SSE2)
+	simd_csqmac_float<VecSSE2>(dest, src, w, count);
+#elif defined(DAFF_SIMD_NEON)
+	simd_csqmac_float<VecNEON>(dest, src, w, count);
+#else
+	scalar_csqmac_float(dest, src, w, count);
+#endif
+}
+
+void deinterleave_float(float* even, float* odd, const float* src, size_t count)
+{
+	deinterleave_kernel(even, odd, src, count);
+}
+
+void conj_mirror_float(float* dest, const float* src, size_t count)
+{
+	conj_mirror_kernel(dest, src, count);
+}
+
+// Spherical harmonics kernel, selected once for the host CPU
+typedef void (*SHBasisKernel)(float*, const float*, int, const float*, const float*, size_t);
+
+static SHBasisKernel select_sh_basis_kernel()
+{
+	if (simd_avx2_compiled() && cpu_supports_avx2())
+		return &simd_sh_basis_avx2;
+#if defined(DAFF_SIMD_SSE2)
+	return &simd_sh_basis<VecSSE2>;
+#elif defined(DAFF_SIMD_NEON)
+	return &simd_sh_basis<VecNEON>;
+#else
+	return &scalar_sh_basis;
+#endif
+}
+
+static SHBasisKernel sh_basis_kernel = select_sh_basis_kernel();
+
+void sh_basis_float(float* dest, const float* rec, int order, const float* alpha, const float* beta, size_t n)
+{
+	sh_basis_kernel(dest, rec, order, alpha, beta, n);
+}
+
+// Direction normalization kernel, selected once for the host CPU
+typedef void (*NormalizeDirectionsKernel)(float*, float*, size_t);
+
+static NormalizeDirectionsKernel select_normalize_directions_kernel()
+{
+	if (simd_avx2_compiled() && cpu_supports_avx2())
+		return &simd_normalize_directions_dsc_avx2;
+#if defined(DAFF_SIMD_SSE2)
+	return &simd_normalize_directions_dsc<VecSSE2>;
+#elif defined(DAFF_SIMD_NEON)
+	return &simd_normalize_directions_dsc<VecNEON>;
+#else
+	return &scalar_normalize_directions_dsc;
+#endif
+}
+
+static NormalizeDirectionsKernel normalize_directions_kernel = select_normalize_directions_kernel();
+
+void normalize_directions_dsc(float* alpha, float* beta, size_t count)
+{
+	normalize_directions_kernel(alpha, beta, count);
+
+	// The kernels leave directions outside their ranges as they are (normalized directions are within)
+	for (size_t i = 0; i < count; i++)
+		if (!is_direction_dsc_in_range(alpha[i], beta[i]))
+			DAFFUtils::NormalizeDirection(DAFF_DATA_VIEW, alpha[i], beta[i], alpha[i], beta[i]);
+}
+
+
 
 // --= File system functions =--
 
@@ -347,7 +1239,7 @@ int64_t getFileSize(const std::string& sFilename)
 		return -1;
 	return (int64_t)statinfo.st_size;
 #else
-	// TODO: 64-bit support
+	// Note: 64-bit st_size also on 32-bit systems (_FILE_OFFSET_BITS)
 	struct stat statinfo;
 	if (stat(sFilename.c_str(), &statinfo) != 0)
 		return -1;
@@ -355,4 +1247,29 @@ int64_t getFileSize(const std::string& sFilename)
 #endif
 }
 
+int64_t getFileModTime(const std::string& sFilename)
+{
+	if (sFilename.empty())
+		return -1;
+
+#ifdef _MSC_VER
+	// Microsoft Visual Studio compilers (seconds)
+	struct _stat64 statinfo;
+	if (_stat64(sFilename.c_str(), &statinfo) != 0)
+		return -1;
+	return (int64_t)statinfo.st_mtime * 1000000000;
+#else
+	struct stat statinfo;
+	if (stat(sFilename.c_str(), &statinfo) != 0)
+		return -1;
+#if defined(__APPLE__)
+	return (int64_t)statinfo.st_mtimespec.tv_sec * 1000000000 + statinfo.st_mtimespec.tv_nsec;
+#elif defined(__linux__)
+	return (int64_t)statinfo.st_mtim.tv_sec * 1000000000 + statinfo.st_mtim.tv_nsec;
+#else
+	return (int64_t)statinfo.st_mtime * 1000000000;
+#endif
+#endif
+}
+
 }  // namespace DAFF
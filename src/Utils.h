@@ -19,6 +19,8 @@ namespace DAFF {
 // --= Complex number conversion =--
 
 float cabs(float Re, float Im);
+
+//! Phase in radians within [-pi/2, 3pi/2)
 float carg(float Re, float Im);
 
 // degrees
@@ -26,6 +28,9 @@ float anglef_proj_0_360_DEG(float alpha);
 float anglef_mindiff_0_360_DEG(float alpha, float beta);
 float anglef_mindiff_abs_0_360_DEG(float alpha, float beta);
 
+//! Normalizes directions in data spherical coordinates like DAFFUtils::NormalizeDirection (in place, vectorized)
+void normalize_directions_dsc(float* alpha, float* beta, size_t count);
+
 // radiants
 float anglef_proj_0_2PI(float alpha);
 float anglef_mindiff_0_2PI(float alpha, float beta);
@@ -44,12 +49,50 @@ extern void (*le2se_3byte)(void* src, size_t count);
 extern void (*le2se_4byte)(void* src, size_t count);
 extern void (*le2se_8byte)(void* src, size_t count);
 
+/*
+ *  Fused copy and conversion of count values from src (little endian) into dest (system
+ *  endianess), vectorized. On little endian systems this is a plain copy. dest may equal
+ *  src (in place conversion), otherwise the ranges must not overlap.
+ */
+
+void le2se_copy_2byte(void* dest, const void* src, size_t count);
+void le2se_copy_3byte(void* dest, const void* src, size_t count);
+void le2se_copy_4byte(void* dest, const void* src, size_t count);
+void le2se_copy_8byte(void* dest, const void* src, size_t count);
+
+//! Returns true if the system is little endian (no conversion of DAFF file data required)
+bool is_little_endian();
+
+// --= CPU features =--
+
+//! Returns true if the CPU and the operating system support AVX2 instructions
+bool cpu_supports_avx2();
+
+//! Returns true if the CPU supports F16C instructions (half precision conversion)
+bool cpu_supports_f16c();
+
+//! Returns true if the CPU supports SSE 4.2 instructions (CRC-32C)
+bool cpu_supports_sse42();
+
 // --= Memory (de)allocation =--
 
 // Allocate/free memory on with a 16-byte boundary
 void* malloc_aligned16(size_t bytes);
 void free_aligned16(void* ptr);
 
+// Allocate/free memory on a 32-byte boundary
+void* malloc_aligned32(size_t bytes);
+void free_aligned32(void* ptr);
+
+// Allocate/free memory on a 64-byte boundary (cache line, AVX-512)
+void* malloc_aligned64(size_t bytes);
+void free_aligned64(void* ptr);
+
+// Allocate/free a large block on a 64-byte boundary, blocks of 2 MB and more on a 2 MB boundary
+// with a hint to back them with huge pages (Linux transparent huge pages, no-op elsewhere)
+void* malloc_arena(size_t bytes);
+void free_arena(void* ptr);
+
 // --= Sample type conversion =--
 
 //! Convert signed integer 16-Bit -> single precision floating point (32-Bit)
@@ -64,12 +107,152 @@ void stc_sint24_to_float(float* dest, const void* src, size_t count, int input_s
 void stc_sint24_to_float_add(float* dest, const void* src, size_t count, int input_stride = 1, int output_stride = 1,
 							 float gain = 1);
 
+//! Convert single precision floating point -> signed integer 16-Bit (rounded, saturated)
+void stc_float_to_sint16(short* dest, const float* src, size_t count);
+
+//! Convert single precision floating point -> signed integer 24-Bit (rounded, saturated, 3 bytes per sample)
+void stc_float_to_sint24(void* dest, const float* src, size_t count);
+
+//! Convert half precision floating point (IEEE 754 binary16) -> single precision floating point (32-Bit)
+void stc_half_to_float(float* dest, const unsigned short* src, size_t count, int input_stride = 1,
+					   int output_stride = 1, float gain = 1);
+void stc_half_to_float_add(float* dest, const unsigned short* src, size_t count, int input_stride = 1,
+						   int output_stride = 1, float gain = 1);
+
+//! Convert bfloat16 (upper half of a single precision float) -> single precision floating point (32-Bit)
+void stc_bfloat16_to_float(float* dest, const unsigned short* src, size_t count, int input_stride = 1,
+						   int output_stride = 1, float gain = 1);
+void stc_bfloat16_to_float_add(float* dest, const unsigned short* src, size_t count, int input_stride = 1,
+							   int output_stride = 1, float gain = 1);
+
+//! Convert single precision floating point -> half precision floating point (rounded to nearest even)
+void stc_float_to_half(unsigned short* dest, const float* src, size_t count);
+
+//! Convert single precision floating point -> bfloat16 (rounded to nearest even)
+void stc_float_to_bfloat16(unsigned short* dest, const float* src, size_t count);
+
+// Fixed-point conversions deliver the values of the float conversions above times gain and full scale
+// (32767 for Q15 and 2147483647 for Q31 like the integer quantizations), rounded to nearest even and
+// saturated (NaN: 0). The add variants accumulate with saturation (unit stride, system byte order).
+
+//! Convert signed integer 16-Bit -> Q15 fixed point (a copy for unit gain)
+void stc_sint16_to_q15(int16_t* dest, const int16_t* src, size_t count, float gain = 1);
+void stc_sint16_to_q15_add(int16_t* dest, const int16_t* src, size_t count, float gain = 1);
+
+//! Convert signed integer 24-Bit -> Q15 fixed point
+void stc_sint24_to_q15(int16_t* dest, const void* src, size_t count, float gain = 1);
+void stc_sint24_to_q15_add(int16_t* dest, const void* src, size_t count, float gain = 1);
+
+//! Convert single precision floating point -> Q15 fixed point
+void stc_float_to_q15(int16_t* dest, const float* src, size_t count, float gain = 1);
+void stc_float_to_q15_add(int16_t* dest, const float* src, size_t count, float gain = 1);
+
+//! Convert signed integer 16-Bit -> Q31 fixed point
+void stc_sint16_to_q31(int32_t* dest, const int16_t* src, size_t count, float gain = 1);
+void stc_sint16_to_q31_add(int32_t* dest, const int16_t* src, size_t count, float gain = 1);
+
+//! Convert signed integer 24-Bit -> Q31 fixed point
+void stc_sint24_to_q31(int32_t* dest, const void* src, size_t count, float gain = 1);
+void stc_sint24_to_q31_add(int32_t* dest, const void* src, size_t count, float gain = 1);
+
+//! Convert single precision floating point -> Q31 fixed point
+void stc_float_to_q31(int32_t* dest, const float* src, size_t count, float gain = 1);
+void stc_float_to_q31_add(int32_t* dest, const float* src, size_t count, float gain = 1);
+
+//! Convert single precision floating point -> Q15 or Q31 fixed point (the other destination is NULL)
+void stc_float_to_fixed_point(int16_t* dest_q15, int32_t* dest_q31, const float* src, size_t count, float gain,
+							  bool add);
+
+// --= Peak values =--
+
+//! Maximum absolute value of signed integer 16-Bit samples, scaled like the conversion to float
+float peak_sint16(const short* src, size_t count);
+
+//! Maximum absolute value of signed integer 24-Bit samples, scaled like the conversion to float
+float peak_sint24(const void* src, size_t count);
+
+//! Maximum absolute value of single precision floating point samples
+float peak_float(const float* src, size_t count);
+
+//! Maximum absolute value of half precision floating point samples (NaNs are ignored)
+float peak_half(const unsigned short* src, size_t count);
+
+//! Maximum absolute value of bfloat16 samples (NaNs are ignored)
+float peak_bfloat16(const unsigned short* src, size_t count);
+
+//! Peak value and range [begin, end) of the samples with an absolute value above the threshold (empty: 0, 0)
+float bounds_float(const float* src, size_t count, float threshold, size_t& begin, size_t& end);
+
+//! Sum of the squared single precision floating point samples (energy), accumulated in double precision
+double energy_float(const float* src, size_t count);
+
+//! Minimum and maximum of single precision floating point samples, combined with the values of fMin and fMax passed in
+void minmax_float(const float* src, size_t count, float& fMin, float& fMax);
+
+// --= Vector operations =--
+
+//! Element-wise product of single precision floating point samples, dest = dest * src
+void mul_float(float* dest, const float* src, size_t count);
+
+//! Element-wise difference of single precision floating point samples, dest = a - b (may be in place)
+void sub_float(float* dest, const float* a, const float* b, size_t count);
+
+//! Element-wise ratio of single precision floating point samples, dest = max(a, floor) / max(b, floor)
+void ratio_float(float* dest, const float* a, const float* b, float floor, size_t count);
+
+//! Weighted sum of n single precision floating point vectors, dest = gain[0] * src[0] + ... (zero for n = 0)
+void blend_float(float* dest, const float* const* src, const float* gain, int n, size_t count);
+
+//! Crossfade from a to b, dest[i] = a[i] + w(t0 + i*dt) * (b[i] - a[i]), ramp w(t) = t or sin^2(90 deg * t)
+void crossfade_float(float* dest, const float* a, const float* b, size_t count, float t0, float dt, bool cosine);
+
+//! Dot product a[0] * b[0] + ... + a[count-1] * b[count-1]
+float dot_float(const float* a, const float* b, size_t count);
+
+//! Weighted squares accumulation of single precision floating point samples, dest[i] = dest[i] + w * src[i]^2
+void sqmac_float(float* dest, const float* src, float w, size_t count);
+
+//! Indices of the values satisfying a comparison with a value (one of #DAFF_COMPARISONS, NaN never does)
+/**
+ * Writes the ascending indices into dest (capacity: count) and returns their number
+ * (0 for invalid operators).
+ */
+size_t select_float(int* dest, const float* src, float value, int op, size_t count);
+
+// --= Complex values =--
+
+//! Polar form of count interleaved complex values, dest = (|z0|, carg(z0), |z1|, ...) (may be in place)
+void cart2polar_float(float* dest, const float* src, size_t count);
+
+//! Interleaved cartesian form of count complex values, dest = (mag[0] cos(phase[0]), mag[0] sin(phase[0]), ...)
+void polar2cart_float(float* dest, const float* mag, const float* phase, size_t count);
+
+//! Complex multiply-accumulate of count interleaved complex values, dest[i] = dest[i] + a[i] * b[i]
+void cmac_float(float* dest, const float* a, const float* b, size_t count);
+
+//! Weighted squared magnitudes of count interleaved complex values, dest[i] = dest[i] + w * |src_i|^2
+void csqmac_float(float* dest, const float* src, float w, size_t count);
+
+//! Splits count interleaved pairs, even = (src[0], src[2], ...), odd = (src[1], src[3], ...) (either may be NULL)
+void deinterleave_float(float* even, float* odd, const float* src, size_t count);
+
+//! Conjugates of count interleaved complex values in reverse order, dest[i] = conj(src[count - 1 - i]) (not in place)
+void conj_mirror_float(float* dest, const float* src, size_t count);
+
+// --= Spherical harmonics =--
+
+//! Real spherical harmonics of n directions (DSC, degrees), dest[i * (order+1)^2 + k] (rec: DAFF::sh_recurrence)
+void sh_basis_float(float* dest, const float* rec, int order, const float* alpha, const float* beta, size_t n);
+
 
 // --= File system functions =--
 
 //! Gre einer Datei in Bytes zurckgeben (Gibt im Fehlerfall -1 zurck)
 int64_t getFileSize(const std::string& sFilename);
 
+//! Modification time of a file [ns since the epoch, resolution of the file system] (-1 on errors)
+int64_t getFileModTime(const std::string& sFilename);
+
 
 }  // namespace DAFF
 
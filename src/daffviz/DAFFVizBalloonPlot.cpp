@@ -5,6 +5,10 @@
 #include <DAFF.h>
 
 #include <algorithm>
+#include <limits>
+#include <system_error>
+#include <thread>
+#include <vector>
 
 #include <assert.h>
 #include <vtkActor.h>
@@ -16,6 +20,7 @@
 #include <vtkFloatArray.h>
 #include <vtkFollower.h>
 #include <vtkHedgeHog.h>
+#include <vtkLODActor.h>
 #include <vtkLine.h>
 #include <vtkPointData.h>
 #include <vtkPoints.h>
@@ -29,47 +34,311 @@
 #include <vtkSmartPointer.h>
 #include <vtkTransform.h>
 #include <vtkVectorText.h>
-#include <vtkWarpScalar.h>
 #include <vtkWindowedSincPolyDataFilter.h>
 
 
 namespace DAFFViz {
-BalloonPlot::BalloonPlot(SGNode* pParentNode, const DAFFContent* pContent)
-	: SGNode(pParentNode), m_pContent(pContent), m_iFrequency(0), m_iNumFrequencies(0), m_iScaling(SCALING_DECIBEL),
-	  m_dMin(0.0), m_dMax(1.0), m_iChannel(0), m_bWarp(true), m_bNormalize(false), m_bNormalizeFreqsIndiv(false),
-	  m_bUseCustomRange(false), m_bUsePhaseAsColor(false)
+
+//! Minimum number of records cached per thread
+static const int BALLOON_CACHE_MIN_RECORDS_PER_THREAD = 1024;
+
+//! Minimum number of records of grids that get coarser levels of detail (about a 2 degree grid)
+static const int BALLOON_LOD_MIN_RECORDS = 16384;
+
+//! Coarsest level of detail (every 8th ring and azimuth)
+static const int BALLOON_LOD_MAX_STEP = 8;
+
+//! Surface grid of a balloon (records: south pole, rings of azimuth points from south to north, north pole)
+struct BalloonPlotGrid {
+	int iNumPoints;     //!@ Number of records
+	int iAziPoints;     //!@ Number of azimuth points of a ring
+	int iBodyEleRings;  //!@ Index of the last body ring (rings without the poles)
+	int iBodyOffset;    //!@ Index of the first record of the body
+	bool bSouthPole;    //!@ South pole record present
+	bool bNorthPole;    //!@ North pole record present
+	bool bAzimuthWrap;  //!@ Rings are closed
+};
+
+//! Creates the faces of a grid using every iStep-th ring and azimuth point (the last ones are always used)
+static vtkSmartPointer<vtkCellArray> createGridCells(const BalloonPlotGrid& oGrid, int iStep)
 {
-	init();
+	vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+	vtkIdType quadface[4];
+	vtkIdType triangleface[3];
+
+	std::vector<int> viAzi;
+	for (int j = 0; j < oGrid.iAziPoints; j += iStep)
+		viAzi.push_back(j);
+	if (!oGrid.bAzimuthWrap && (viAzi.back() != oGrid.iAziPoints - 1))
+		viAzi.push_back(oGrid.iAziPoints - 1);
+
+	std::vector<int> viRings;
+	for (int i = 0; i <= oGrid.iBodyEleRings; i += iStep)
+		viRings.push_back(i);
+	if (!viRings.empty() && (viRings.back() != oGrid.iBodyEleRings))
+		viRings.push_back(oGrid.iBodyEleRings);
+
+	int iAziCount = (int)(oGrid.bAzimuthWrap ? viAzi.size() : viAzi.size() - 1);
+	const int iAziPoints = oGrid.iAziPoints;
+	const int iBodyOffset = oGrid.iBodyOffset;
+	const int iNumPoints = oGrid.iNumPoints;
+
+	if (oGrid.bSouthPole) {
+		/*
+		 *  If there is a south pole, this has index 0.
+		 *  The next record, one elevation step above has then index 1.
+		 */
+
+		for (int j = 0; j < iAziCount; j++) {
+			triangleface[0] = 0;
+			triangleface[1] = iBodyOffset + viAzi[j];
+			triangleface[2] = iBodyOffset + viAzi[(j + 1) % viAzi.size()];
+
+			for (int k = 0; k < 3; k++)
+				assert((triangleface[k] >= 0) && (triangleface[k] < iNumPoints));
+
+			cells->InsertNextCell(3, triangleface);
+		}
+	};
+
+	// Body
+	for (int i = 0; i + 1 < (int)viRings.size(); i++) {
+		for (int j = 0; j < iAziCount; j++) {
+			quadface[0] = iBodyOffset + viRings[i] * iAziPoints + viAzi[j];
+			quadface[1] = iBodyOffset + viRings[i] * iAziPoints + viAzi[(j + 1) % viAzi.size()];
+			quadface[2] = iBodyOffset + viRings[i + 1] * iAziPoints + viAzi[(j + 1) % viAzi.size()];
+			quadface[3] = iBodyOffset + viRings[i + 1] * iAziPoints + viAzi[j];
+
+			for (int k = 0; k < 4; k++)
+				assert((quadface[k] >= 0) && (quadface[k] < iNumPoints));
+
+			cells->InsertNextCell(4, quadface);
+		}
+	}
+
+	// North pole
+
+	if (oGrid.bNorthPole) {
+		/*
+		 *  If there is a north pole, this has the last index.
+		 *  The next record, one elevation step above has then index 1.
+		 */
+
+		for (int j = 0; j < iAziCount; j++) {
+			triangleface[0] = iNumPoints - 1;
+			triangleface[1] = iBodyOffset + oGrid.iBodyEleRings * iAziPoints + viAzi[j];
+			triangleface[2] = iBodyOffset + oGrid.iBodyEleRings * iAziPoints + viAzi[(j + 1) % viAzi.size()];
+
+			for (int k = 0; k < 3; k++)
+				assert((triangleface[k] >= 0) && (triangleface[k] < iNumPoints));
+
+			cells->InsertNextCell(3, triangleface);
+		}
+	}
+
+	return cells;
 }
 
-BalloonPlot::BalloonPlot(const DAFFContent* pContent)
-	: SGNode(), m_pContent(pContent), m_iFrequency(0), m_iNumFrequencies(0), m_iScaling(SCALING_DECIBEL), m_dMin(0.0),
-	  m_dMax(1.0), m_iChannel(0), m_bWarp(true), m_bNormalize(false), m_bNormalizeFreqsIndiv(false),
-	  m_bUseCustomRange(false), m_bUsePhaseAsColor(false)
+//! Records around a probe direction (data view) and their bilinear weights
+/**
+ * Grids that cannot be interpolated (irregular grids) give the nearest record with weight 1.
+ */
+static void getProbeWeights(const DAFFContent* pContent, float fAlphaDeg, float fBetaDeg, int* piIndices,
+							float* pfWeights)
 {
-	init();
+	DAFFInterpolator oInterpolator(pContent);
+	DAFFQuad qIndices;
+	if (oInterpolator.getWeights(DAFF_DATA_VIEW, fAlphaDeg, fBetaDeg, qIndices, pfWeights) == DAFF_NO_ERROR) {
+		piIndices[0] = qIndices.iIndex1;
+		piIndices[1] = qIndices.iIndex2;
+		piIndices[2] = qIndices.iIndex3;
+		piIndices[3] = qIndices.iIndex4;
+		return;
+	}
+
+	pContent->getNearestNeighbour(DAFF_DATA_VIEW, fAlphaDeg, fBetaDeg, piIndices[0]);
+	pfWeights[0] = 1.0f;
+	for (int i = 1; i < 4; i++) {
+		piIndices[i] = piIndices[0];
+		pfWeights[i] = 0.0f;
+	}
 }
 
-BalloonPlot::~BalloonPlot()
+//! Spectra of a channel, cached by several threads (each caches a range of records)
+struct BalloonPlotCacheJob {
+	const DAFFContentDFT* pContentDFT;  //!@ DFT content (or NULL)
+	const DAFFContentMS* pContentMS;    //!@ Magnitude spectrum content (or NULL)
+	const DAFFContentMPS* pContentMPS;  //!@ Magnitude-phase spectrum content (or NULL)
+	int iChannel;                       //!@ Cached channel
+	int iNumRecords;                    //!@ Number of records
+	int iNumFrequencies;                //!@ Number of frequencies
+	float* pfMagnitudes;                //!@ Magnitudes [frequency][record]
+	float* pfPhases;                    //!@ Phases [frequency][record] (NULL for magnitude spectra)
+};
+
+//! Phase of a DFT coefficient
+static float DFTPhase(float fReal, float fImag)
 {
-	RemoveActor(m_pPlotActor);
-	RemoveActor(m_pLabel);
-	RemoveActor(m_pProbe);
+	float fPhase;
+	if (fReal != 0.0) {
+		fPhase = atan(fImag / fReal);
+		if (fReal < 0.0)
+			if (fImag < 0.0)
+				fPhase -= DAFF::PI_F;
+			else
+				fPhase += DAFF::PI_F;
+	} else {
+		if (fImag < 0.0)
+			fPhase = -DAFF::HALF_PI_F;
+		else
+			fPhase = DAFF::HALF_PI_F;
+	}
+	return fPhase;
+}
+
+//! Caches the spectra of the records [iFirstRecord, iLastRecord) of a job (one call per record and channel)
+static void cacheRecords(const BalloonPlotCacheJob* pJob, int iFirstRecord, int iLastRecord)
+{
+	const int N = pJob->iNumRecords;
+	std::vector<float> vfBuffer(2 * pJob->iNumFrequencies);
+	float* pfBuffer = &vfBuffer[0];
+
+	for (int i = iFirstRecord; i < iLastRecord; i++) {
+		int iError;
+		if (pJob->pContentDFT)
+			iError = pJob->pContentDFT->getDFTCoeffs(i, pJob->iChannel, pfBuffer);
+		else if (pJob->pContentMS)
+			iError = pJob->pContentMS->getMagnitudes(i, pJob->iChannel, pfBuffer);
+		else
+			iError = pJob->pContentMPS->getCoefficientsMP(i, pJob->iChannel, pfBuffer);
+
+		// Records that can not be read are shown with zero magnitude
+		if (iError != DAFF_NO_ERROR)
+			std::fill(vfBuffer.begin(), vfBuffer.end(), 0.0f);
+
+		for (int k = 0; k < pJob->iNumFrequencies; k++) {
+			if (pJob->pContentDFT) {
+				float fReal = pfBuffer[2 * k];
+				float fImag = pfBuffer[2 * k + 1];
+				pJob->pfMagnitudes[(size_t)k * N + i] = sqrt(fReal * fReal + fImag * fImag);
+				pJob->pfPhases[(size_t)k * N + i] = DFTPhase(fReal, fImag);
+			} else if (pJob->pContentMS) {
+				pJob->pfMagnitudes[(size_t)k * N + i] = pfBuffer[k];
+			} else {
+				pJob->pfMagnitudes[(size_t)k * N + i] = pfBuffer[2 * k];
+				pJob->pfPhases[(size_t)k * N + i] = pfBuffer[2 * k + 1];
+			}
+		}
+	}
 }
 
-void BalloonPlot::init()
+//! Converts an orientation (phi, theta) into cartesian coordinates (x,y,z)
+static void sph2cart(double phi, double theta, double& x, double& y, double& z)
+{
+	x = -sin((theta + 90) * DAFF::PI_F / 180.0) * sin(phi * DAFF::PI_F / 180.0);
+	y = -cos((theta + 90) * DAFF::PI_F / 180.0);
+	z = -sin((theta + 90) * DAFF::PI_F / 180.0) * cos(phi * DAFF::PI_F / 180.0);
+}
+
+//! Caches the magnitudes and phases of all frequencies of a channel [frequency][record] and the maxima per frequency
+static void cacheSpectra(const DAFFContent* pContent, int iChannel, int iNumFrequencies,
+						 std::vector<float>& vfMagnitudes, std::vector<float>& vfPhases,
+						 std::vector<float>& vfMagnitudeMaxima)
+{
+	const int iContentType = pContent->getProperties()->getContentType();
+	const int iNumRecords = pContent->getProperties()->getNumberOfRecords();
+	const size_t nValues = (size_t)iNumFrequencies * iNumRecords;
+
+	if ((iContentType != DAFF_DFT_SPECTRUM) && (iContentType != DAFF_MAGNITUDE_SPECTRUM) &&
+		(iContentType != DAFF_MAGNITUDE_PHASE_SPECTRUM)) {
+		vfMagnitudes.clear();
+		vfPhases.clear();
+		vfMagnitudeMaxima.clear();
+		return;
+	}
+
+	vfMagnitudes.resize(nValues);
+	vfPhases.resize(iContentType == DAFF_MAGNITUDE_SPECTRUM ? 0 : nValues);
+	if (nValues == 0)
+		return;
+
+	BalloonPlotCacheJob oJob;
+	oJob.pContentDFT = NULL;
+	oJob.pContentMS = NULL;
+	oJob.pContentMPS = NULL;
+	switch (iContentType) {
+	case DAFF_DFT_SPECTRUM:
+		oJob.pContentDFT = dynamic_cast<const DAFFContentDFT*>(pContent);
+		break;
+
+	case DAFF_MAGNITUDE_SPECTRUM:
+		oJob.pContentMS = dynamic_cast<const DAFFContentMS*>(pContent);
+		break;
+
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		oJob.pContentMPS = dynamic_cast<const DAFFContentMPS*>(pContent);
+		break;
+	}
+	oJob.iChannel = iChannel;
+	oJob.iNumRecords = iNumRecords;
+	oJob.iNumFrequencies = iNumFrequencies;
+	oJob.pfMagnitudes = &vfMagnitudes[0];
+	oJob.pfPhases = (vfPhases.empty() ? NULL : &vfPhases[0]);
+
+	// Read access to the content from several threads is safe, each thread caches a range of records
+	int iNumThreads = (int)std::max(std::thread::hardware_concurrency(), 1u);
+	iNumThreads = std::max(std::min(iNumThreads, iNumRecords / BALLOON_CACHE_MIN_RECORDS_PER_THREAD), 1);
+	int iRecordsPerThread = (iNumRecords + iNumThreads - 1) / iNumThreads;
+
+	// The calling thread caches the first range
+	std::vector<std::thread> vThreads;
+	int iFirstRecord = iRecordsPerThread;
+	try {
+		for (; iFirstRecord < iNumRecords; iFirstRecord += iRecordsPerThread)
+			vThreads.push_back(std::thread(&cacheRecords, &oJob, iFirstRecord,
+										   std::min(iFirstRecord + iRecordsPerThread, iNumRecords)));
+	} catch (const std::system_error&) {
+		// Not enough threads available, cache the remaining records here
+	}
+
+	cacheRecords(&oJob, 0, std::min(iRecordsPerThread, iNumRecords));
+	if (iFirstRecord < iNumRecords)
+		cacheRecords(&oJob, iFirstRecord, iNumRecords);
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	vfMagnitudeMaxima.assign(iNumFrequencies, std::numeric_limits<float>::min());
+	for (int k = 0; k < iNumFrequencies; k++) {
+		const float* pfMagnitudes = &vfMagnitudes[(size_t)k * iNumRecords];
+		for (int i = 0; i < iNumRecords; i++)
+			if (pfMagnitudes[i] > vfMagnitudeMaxima[k])
+				vfMagnitudeMaxima[k] = pfMagnitudes[i];
+	}
+}
+
+BalloonPlotGeometry::BalloonPlotGeometry(const DAFFContent* pContent, int iChannel)
+	: m_pContent(pContent), m_iChannel(iChannel), m_iNumFrequencies(0), m_fOverallMagnitudeMaximum(0.0f)
 {
 	const DAFFProperties* pProps = m_pContent->getProperties();
 
 	switch (pProps->getContentType()) {
 	case DAFF_DFT_SPECTRUM:
 		m_iNumFrequencies = dynamic_cast<const DAFFContentDFT*>(m_pContent)->getNumDFTCoeffs();
+		m_fOverallMagnitudeMaximum = dynamic_cast<const DAFFContentDFT*>(m_pContent)->getOverallMagnitudeMaximum();
 		break;
 
 	case DAFF_MAGNITUDE_SPECTRUM:
+		m_iNumFrequencies = dynamic_cast<const DAFFContentMS*>(m_pContent)->getNumFrequencies();
+		m_fOverallMagnitudeMaximum = dynamic_cast<const DAFFContentMS*>(m_pContent)->getOverallMagnitudeMaximum();
+		break;
+
 	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		m_iNumFrequencies = dynamic_cast<const DAFFContentMPS*>(m_pContent)->getNumFrequencies();
+		m_fOverallMagnitudeMaximum = dynamic_cast<const DAFFContentMPS*>(m_pContent)->getOverallMagnitudeMaximum();
+		break;
+
 	case DAFF_PHASE_SPECTRUM:
-		m_iNumFrequencies = dynamic_cast<const DAFFContentMS*>(m_pContent)->getNumFrequencies();
+		m_iNumFrequencies = dynamic_cast<const DAFFContentPS*>(m_pContent)->getNumFrequencies();
 		break;
 	}
 
@@ -80,7 +349,7 @@ void BalloonPlot::init()
 
 	// --= Sphere grid =--
 
-	vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+	m_pPoints = vtkSmartPointer<vtkPoints>::New();
 	m_pNormals = vtkSmartPointer<vtkDoubleArray>::New();
 	m_pNormals->SetNumberOfComponents(3);
 	for (int i = 0; i < pProps->getNumberOfRecords(); i++) {
@@ -91,7 +360,7 @@ void BalloonPlot::init()
 		// Compute Cartesian points
 		double x, y, z;
 		sph2cart(phi, theta, x, y, z);
-		points->InsertPoint(i, x, y, z);
+		m_pPoints->InsertPoint(i, x, y, z);
 		double n[3] = {-x, -y, -z};  // define flipped normals for warping
 		m_pNormals->InsertNextTuple(n);
 	}
@@ -99,8 +368,7 @@ void BalloonPlot::init()
 
 	// --= Faces =--
 
-	vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
-	vtkIdType quadface[4];
+	m_pCells = vtkSmartPointer<vtkCellArray>::New();
 	vtkIdType triangleface[3];
 
 	int iNumPoints = pProps->getNumberOfRecords();
@@ -108,7 +376,6 @@ void BalloonPlot::init()
 	int iElePoints = pProps->getBetaPoints();
 
 	int iBodyEleRings = iElePoints - 1;
-	int iAziCount = (bAzimuthWrap ? iAziPoints : iAziPoints - 1);
 	if (bSouthPole)
 		iBodyEleRings--;
 	if (bNorthPole)
@@ -123,7 +390,7 @@ void BalloonPlot::init()
 			// we will not plot a single point
 		} else {
 			// add a point at center
-			points->InsertPoint(iNumPoints, 0, 0, 0);
+			m_pPoints->InsertPoint(iNumPoints, 0, 0, 0);
 
 			for (int i = 0; i < iNumPoints; i++) {
 				triangleface[0] = i;
@@ -133,83 +400,145 @@ void BalloonPlot::init()
 				for (int k = 0; k < 3; k++)
 					assert((triangleface[k] >= 0) && (triangleface[k] < iNumPoints + 1));
 
-				cells->InsertNextCell(3, triangleface);
+				m_pCells->InsertNextCell(3, triangleface);
 			}
 		}
 	} else {
 		// draw surfaces
-		if (bSouthPole) {
-			/*
-			 *  If there is a south pole, this has index 0.
-			 *  The next record, one elevation step above has then index 1.
-			 */
-
-			iBodyOffset = 1;
-			for (int j = 0; j < iAziCount; j++) {
-				triangleface[0] = 0;
-				triangleface[1] = iBodyOffset + j;
-				triangleface[2] = iBodyOffset + (j + 1) % iAziPoints;
-
-				for (int k = 0; k < 3; k++)
-					assert((triangleface[k] >= 0) && (triangleface[k] < iNumPoints));
+		BalloonPlotGrid oGrid = {iNumPoints, iAziPoints, iBodyEleRings, iBodyOffset,
+								 bSouthPole, bNorthPole, bAzimuthWrap};
+		m_pCells = createGridCells(oGrid, 1);
+
+		// Dense grids get coarser levels of detail for interactive rendering
+		if (iNumPoints >= BALLOON_LOD_MIN_RECORDS)
+			for (int iStep = 2; iStep <= BALLOON_LOD_MAX_STEP; iStep *= 2)
+				m_vpLODCells.push_back(createGridCells(oGrid, iStep));
+	}
 
-				cells->InsertNextCell(3, triangleface);
-			}
-		};
+	// --= Spectra =--
 
-		// Body
-		for (int i = 0; i < iBodyEleRings; i++) {
-			for (int j = 0; j < iAziCount; j++) {
-				quadface[0] = iBodyOffset + i * iAziPoints + j;
-				quadface[1] = iBodyOffset + i * iAziPoints + (j + 1) % iAziPoints;
-				quadface[2] = iBodyOffset + (i + 1) * iAziPoints + (j + 1) % iAziPoints;
-				quadface[3] = iBodyOffset + (i + 1) * iAziPoints + j;
+	cacheSpectra(m_pContent, m_iChannel, m_iNumFrequencies, m_vfMagnitudes, m_vfPhases, m_vfMagnitudeMaxima);
+}
 
-				for (int k = 0; k < 4; k++)
-					assert((quadface[k] >= 0) && (quadface[k] < iNumPoints));
+BalloonPlotGeometry::~BalloonPlotGeometry() {}
 
-				cells->InsertNextCell(4, quadface);
-			}
-		}
+const DAFFContent* BalloonPlotGeometry::GetContent() const
+{
+	return m_pContent;
+}
 
-		// North pole
+BalloonPlot::BalloonPlot(SGNode* pParentNode, const DAFFContent* pContent)
+	: SGNode(pParentNode), m_pContent(pContent), m_iFrequency(0), m_iNumFrequencies(0), m_iScaling(SCALING_DECIBEL),
+	  m_dMin(0.0), m_dMax(1.0), m_iChannel(0), m_bWarp(true), m_bNormalize(false), m_bNormalizeFreqsIndiv(false),
+	  m_bUseCustomRange(false), m_bUsePhaseAsColor(false), m_fOverallMagnitudeMaximum(0.0f), m_iCacheChannel(-1)
+{
+	BalloonPlotGeometry oGeometry(pContent, m_iChannel);
+	init(oGeometry);
+}
 
-		if (bNorthPole) {
-			/*
-			 *  If there is a north pole, this has the last index.
-			 *  The next record, one elevation step above has then index 1.
-			 */
+BalloonPlot::BalloonPlot(const DAFFContent* pContent)
+	: SGNode(), m_pContent(pContent), m_iFrequency(0), m_iNumFrequencies(0), m_iScaling(SCALING_DECIBEL), m_dMin(0.0),
+	  m_dMax(1.0), m_iChannel(0), m_bWarp(true), m_bNormalize(false), m_bNormalizeFreqsIndiv(false),
+	  m_bUseCustomRange(false), m_bUsePhaseAsColor(false), m_fOverallMagnitudeMaximum(0.0f), m_iCacheChannel(-1)
+{
+	BalloonPlotGeometry oGeometry(pContent, m_iChannel);
+	init(oGeometry);
+}
 
-			for (int j = 0; j < iAziCount; j++) {
-				triangleface[0] = iNumPoints - 1;
-				triangleface[1] = iBodyOffset + iBodyEleRings * iAziPoints + j;
-				triangleface[2] = iBodyOffset + iBodyEleRings * iAziPoints + (j + 1) % iAziPoints;
+BalloonPlot::BalloonPlot(SGNode* pParentNode, BalloonPlotGeometry& oGeometry)
+	: SGNode(pParentNode), m_pContent(oGeometry.GetContent()), m_iFrequency(0), m_iNumFrequencies(0),
+	  m_iScaling(SCALING_DECIBEL), m_dMin(0.0), m_dMax(1.0), m_iChannel(0), m_bWarp(true), m_bNormalize(false),
+	  m_bNormalizeFreqsIndiv(false), m_bUseCustomRange(false), m_bUsePhaseAsColor(false),
+	  m_fOverallMagnitudeMaximum(0.0f), m_iCacheChannel(-1)
+{
+	init(oGeometry);
+}
 
-				for (int k = 0; k < 3; k++)
-					assert((triangleface[k] >= 0) && (triangleface[k] < pProps->getNumberOfRecords()));
+BalloonPlot::~BalloonPlot()
+{
+	// The phases reference the cache, release them in case the pipeline outlives the node
+	if (m_pPhases)
+		m_pPhases->Initialize();
 
-				cells->InsertNextCell(3, triangleface);
-			}
-		}
-	}
+	RemoveActor(m_pPlotActor);
+	RemoveActor(m_pLabel);
+	RemoveActor(m_pProbe);
+}
 
+void BalloonPlot::init(BalloonPlotGeometry& oGeometry)
+{
+	// Take over the geometry (leaves it empty)
+	m_pContent = oGeometry.m_pContent;
+	m_iNumFrequencies = oGeometry.m_iNumFrequencies;
+	m_fOverallMagnitudeMaximum = oGeometry.m_fOverallMagnitudeMaximum;
+	m_pNormals = oGeometry.m_pNormals;
+	vtkSmartPointer<vtkPoints> points = oGeometry.m_pPoints;
+	vtkSmartPointer<vtkCellArray> cells = oGeometry.m_pCells;
+	std::vector<vtkSmartPointer<vtkCellArray> > vpLODCells;
+	vpLODCells.swap(oGeometry.m_vpLODCells);
+	m_iChannel = m_iCacheChannel = oGeometry.m_iChannel;
+	m_vfMagnitudes.swap(oGeometry.m_vfMagnitudes);
+	m_vfPhases.swap(oGeometry.m_vfPhases);
+	m_vfMagnitudeMaxima.swap(oGeometry.m_vfMagnitudeMaxima);
+	oGeometry.m_pPoints = NULL;
+	oGeometry.m_pNormals = NULL;
+	oGeometry.m_pCells = NULL;
+
+	int iNumPoints = m_pContent->getProperties()->getNumberOfRecords();
 
 	// --= VTK stuff =--
 	m_pPlotPolydata = vtkSmartPointer<vtkPolyData>::New();
 	m_pPlotPolydata->SetPoints(points);
 	m_pPlotPolydata->SetPolys(cells);
 
-	// Set scalars of polydata
-	SetScalars();
+	// Scalar arrays, allocated once and updated in place
+	m_pMagnitudes = vtkSmartPointer<vtkFloatArray>::New();
+	m_pMagnitudes->SetName("magnitudes");
+	m_pMagnitudes->SetNumberOfTuples(iNumPoints);
+	m_pPhases = vtkSmartPointer<vtkFloatArray>::New();
+	m_pPhases->SetName("phases");
+	m_pPhases->SetNumberOfTuples(iNumPoints);
+	m_pPhases->FillComponent(0, 0.0);
+	m_pPlotPolydata->GetPointData()->AddArray(m_pMagnitudes);
+	m_pPlotPolydata->GetPointData()->AddArray(m_pPhases);
 	m_pPlotPolydata->GetPointData()->SetActiveScalars("magnitudes");
 
-	// Warp sphere
-	m_pWarp = vtkSmartPointer<vtkWarpScalar>::New();
-	m_pWarp->SetInputData(m_pPlotPolydata);
-	m_pWarp->UseNormalOff();
+	// Warped sphere: points scaled in place by the magnitudes, with the flipped normals for shading
+	m_pWarpedPoints = vtkSmartPointer<vtkPoints>::New();
+	m_pWarpedPoints->DeepCopy(points);
+	m_pWarpedPolydata = vtkSmartPointer<vtkPolyData>::New();
+	m_pWarpedPolydata->SetPoints(m_pWarpedPoints);
+	m_pWarpedPolydata->SetPolys(cells);
+	m_pWarpedPolydata->GetPointData()->ShallowCopy(m_pPlotPolydata->GetPointData());
+	m_pWarpedPolydata->GetPointData()->SetNormals(m_pNormals);
+
+	// Set scalars of polydata
+	SetScalars();
 
+	// Colors are looked up in a texture of the color map by the GPU instead of computed per point
 	m_pMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
 	m_pMapper->SetScalarModeToUsePointFieldData();
+	m_pMapper->InterpolateScalarsBeforeMappingOn();
+
+	// Levels of detail share the points, the warped points and the scalar arrays (updated in place) with the plot
+	for (size_t i = 0; i < vpLODCells.size(); i++) {
+		vtkSmartPointer<vtkPolyData> pLODPolydata = vtkSmartPointer<vtkPolyData>::New();
+		pLODPolydata->SetPoints(points);
+		pLODPolydata->SetPolys(vpLODCells[i]);
+		pLODPolydata->GetPointData()->ShallowCopy(m_pPlotPolydata->GetPointData());
+		m_vpLODPolydata.push_back(pLODPolydata);
+
+		vtkSmartPointer<vtkPolyData> pLODWarpedPolydata = vtkSmartPointer<vtkPolyData>::New();
+		pLODWarpedPolydata->SetPoints(m_pWarpedPoints);
+		pLODWarpedPolydata->SetPolys(vpLODCells[i]);
+		pLODWarpedPolydata->GetPointData()->ShallowCopy(m_pWarpedPolydata->GetPointData());
+		m_vpLODWarpedPolydata.push_back(pLODWarpedPolydata);
+
+		vtkSmartPointer<vtkPolyDataMapper> pLODMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+		pLODMapper->SetScalarModeToUsePointFieldData();
+		pLODMapper->InterpolateScalarsBeforeMappingOn();
+		m_vpLODMappers.push_back(pLODMapper);
+	}
 
 	if (m_bWarp)
 		EnableWarp();
@@ -218,7 +547,15 @@ void BalloonPlot::init()
 
 	SetUsePhaseAsColor(m_bUsePhaseAsColor);
 
-	m_pPlotActor = vtkSmartPointer<vtkActor>::New();
+	if (m_vpLODMappers.empty()) {
+		m_pPlotActor = vtkSmartPointer<vtkActor>::New();
+	} else {
+		// The LOD actor renders the finest level that fits into the frame time (still renders use the full grid)
+		vtkSmartPointer<vtkLODActor> pLODActor = vtkSmartPointer<vtkLODActor>::New();
+		for (size_t i = 0; i < m_vpLODMappers.size(); i++)
+			pLODActor->AddLODMapper(m_vpLODMappers[i]);
+		m_pPlotActor = pLODActor;
+	}
 	m_pPlotActor->SetMapper(m_pMapper);
 
 	m_pPlotActor->GetProperty()->SetInterpolationToGouraud();
@@ -272,6 +609,22 @@ void BalloonPlot::init()
 	AddActor(m_pLabel);
 }
 
+size_t BalloonPlot::GetMemoryFootprint() const
+{
+	// VTK reports the data object sizes in KiB
+	size_t nBytes = SGNode::GetMemoryFootprint();
+	if (m_pPlotPolydata)
+		nBytes += (size_t)m_pPlotPolydata->GetActualMemorySize() * 1024;
+	if (m_pWarpedPoints)
+		nBytes += (size_t)m_pWarpedPoints->GetData()->GetActualMemorySize() * 1024;
+	for (size_t i = 0; i < m_vpLODPolydata.size(); i++) {
+		// The levels of detail share points, warped points and scalars with the plot, but have own faces
+		nBytes += (size_t)m_vpLODPolydata[i]->GetPolys()->GetActualMemorySize() * 1024;
+	}
+	nBytes += (m_vfMagnitudes.capacity() + m_vfPhases.capacity() + m_vfMagnitudeMaxima.capacity()) * sizeof(float);
+	return nBytes;
+}
+
 void BalloonPlot::UpdateProbe()
 {
 	if (!m_pProbe)
@@ -356,22 +709,30 @@ void BalloonPlot::UpdateProbe()
 	m_pProbe->SetUserTransform(transform);
 	m_pLabel->SetUserTransform(transform);
 
-	// update label
+	// update label, interpolated between the records around the probe (only the selected frequency is read)
 	assert(m_pContent != 0);
-	double val = 0;
-	int i;
-	m_pContent->getNearestNeighbour(DAFF_DATA_VIEW, m_dProbeAlpha, m_dProbeBeta, i);
+	int piIndices[4];
+	float pfWeights[4];
+	getProbeWeights(m_pContent, m_dProbeAlpha, m_dProbeBeta, piIndices, pfWeights);
+
 	std::ostringstream s;
 	const DAFFContentDFT* pContentDFT = NULL;
 	const DAFFContentMS* pContentMS = NULL;
 	const DAFFContentMPS* pContentMPS = NULL;
 
-	float fMag, fPhase, fReal, fImag;
+	float fMag = 0.0f, fPhase = 0.0f, fReal = 0.0f, fImag = 0.0f, fSin = 0.0f, fCos = 0.0f;
+	float fValue1, fValue2;
 
 	switch (m_pContent->getProperties()->getContentType()) {
 	case DAFF_DFT_SPECTRUM:
 		pContentDFT = dynamic_cast<const DAFFContentDFT*>(m_pContent);
-		pContentDFT->getDFTCoeff(i, m_iChannel, m_iFrequency, fReal, fImag);
+		for (int i = 0; i < 4; i++) {
+			if ((pfWeights[i] == 0.0f) ||
+				(pContentDFT->getDFTCoeff(piIndices[i], m_iChannel, m_iFrequency, fValue1, fValue2) != DAFF_NO_ERROR))
+				continue;
+			fReal += pfWeights[i] * fValue1;
+			fImag += pfWeights[i] * fValue2;
+		}
 		fMag = sqrt(fReal * fReal + fImag * fImag);
 		if (fReal != 0.0) {
 			fPhase = atan(fImag / fReal);
@@ -395,7 +756,10 @@ void BalloonPlot::UpdateProbe()
 
 	case DAFF_MAGNITUDE_SPECTRUM:
 		pContentMS = dynamic_cast<const DAFFContentMS*>(m_pContent);
-		pContentMS->getMagnitude(i, m_iChannel, m_iFrequency, fMag);
+		for (int i = 0; i < 4; i++)
+			if ((pfWeights[i] != 0.0f) &&
+				(pContentMS->getMagnitude(piIndices[i], m_iChannel, m_iFrequency, fValue1) == DAFF_NO_ERROR))
+				fMag += pfWeights[i] * fValue1;
 		if (m_iScaling == SCALING_DECIBEL) {
 			fMag = FactorToDecibel(fMag);
 			s << fMag << "db";
@@ -404,9 +768,18 @@ void BalloonPlot::UpdateProbe()
 		break;
 
 	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		// Phases are averaged on the unit circle, so that they do not jump where they wrap around
 		pContentMPS = dynamic_cast<const DAFFContentMPS*>(m_pContent);
-		pContentMPS->getMagnitude(i, m_iChannel, m_iFrequency, fMag);
-		pContentMPS->getPhase(i, m_iChannel, m_iFrequency, fPhase);
+		for (int i = 0; i < 4; i++) {
+			if ((pfWeights[i] == 0.0f) ||
+				(pContentMPS->getMagnitude(piIndices[i], m_iChannel, m_iFrequency, fValue1) != DAFF_NO_ERROR) ||
+				(pContentMPS->getPhase(piIndices[i], m_iChannel, m_iFrequency, fValue2) != DAFF_NO_ERROR))
+				continue;
+			fMag += pfWeights[i] * fValue1;
+			fSin += pfWeights[i] * sin(fValue2);
+			fCos += pfWeights[i] * cos(fValue2);
+		}
+		fPhase = atan2(fSin, fCos);
 		if (m_iScaling == SCALING_DECIBEL) {
 			fMag = FactorToDecibel(fMag);
 			s << "Mag: " << fMag << "db, Phase: " << fPhase;
@@ -434,7 +807,7 @@ void BalloonPlot::SetProbeVisible(bool bVisible)
 void BalloonPlot::SetSelectedFrequency(int iFreq)
 {
 	m_iFrequency = iFreq;
-	SetScalars();
+	SetDirty();
 
 	return;
 }
@@ -447,7 +820,7 @@ int BalloonPlot::GetSelectedFrequency() const
 void BalloonPlot::SetScaling(int iScaling)
 {
 	m_iScaling = iScaling;
-	SetScalars();
+	SetDirty();
 
 	return;
 }
@@ -469,13 +842,13 @@ void BalloonPlot::SetRange(double dMin, double dMax)
 		m_dMin = DecibelToFactor(dMin);
 		m_dMax = DecibelToFactor(dMax);
 	}
-	SetScalars();
+	SetDirty();
 }
 
 void BalloonPlot::SetUseCustomRange(bool bChecked)
 {
 	m_bUseCustomRange = bChecked;
-	SetScalars();
+	SetDirty();
 }
 
 double BalloonPlot::GetRangeMin() const
@@ -497,28 +870,47 @@ double BalloonPlot::GetRangeMax() const
 
 void BalloonPlot::EnableWarp()
 {
-	m_pPlotPolydata->GetPointData()->SetNormals(m_pNormals);
-	m_pMapper->SetInputConnection(m_pWarp->GetOutputPort());
 	m_bWarp = true;
+	SetDirty();
+	m_pMapper->SetInputData(m_pWarpedPolydata);
+	for (size_t i = 0; i < m_vpLODMappers.size(); i++)
+		m_vpLODMappers[i]->SetInputData(m_vpLODWarpedPolydata[i]);
 }
 
 void BalloonPlot::DisableWarp()
 {
-	m_pPlotPolydata->GetPointData()->SetNormals(0);
 	m_pMapper->SetInputData(m_pPlotPolydata);
+	for (size_t i = 0; i < m_vpLODMappers.size(); i++)
+		m_vpLODMappers[i]->SetInputData(m_vpLODPolydata[i]);
 	m_bWarp = false;
 }
 
+void BalloonPlot::UpdateWarp()
+{
+	// Same as moving the unit sphere points along the flipped normals by the (inverted) scalars:
+	// p + (1 - m) * (-p) = m * p
+	vtkPoints* pPoints = m_pPlotPolydata->GetPoints();
+	const float* pfScalars = m_pMagnitudes->GetPointer(0);
+	const vtkIdType iNumPoints = pPoints->GetNumberOfPoints();
+	double p[3];
+	for (vtkIdType i = 0; i < iNumPoints; i++) {
+		pPoints->GetPoint(i, p);
+		double dFactor = 1.0 - pfScalars[i];
+		m_pWarpedPoints->SetPoint(i, dFactor * p[0], dFactor * p[1], dFactor * p[2]);
+	}
+	m_pWarpedPoints->Modified();
+}
+
 void BalloonPlot::SetNormalize(bool bChecked)
 {
 	m_bNormalize = bChecked;
-	SetScalars();
+	SetDirty();
 }
 
 void BalloonPlot::SetNormalizeFrequenciesIndividually(bool bChecked)
 {
 	m_bNormalizeFreqsIndiv = bChecked;
-	SetScalars();
+	SetDirty();
 }
 
 void BalloonPlot::SetScalars()
@@ -527,141 +919,71 @@ void BalloonPlot::SetScalars()
 	assert(m_pContent != NULL);
 	assert(m_dMin < m_dMax);
 
-	const DAFFContentDFT* pContentDFT = NULL;
-	const DAFFContentMS* pContentMS = NULL;
-	const DAFFContentMPS* pContentMPS = NULL;
-
-	switch (m_pContent->getProperties()->getContentType()) {
-	case DAFF_DFT_SPECTRUM:
-		pContentDFT = dynamic_cast<const DAFFContentDFT*>(m_pContent);
-		break;
-
-	case DAFF_MAGNITUDE_SPECTRUM:
-		pContentMS = dynamic_cast<const DAFFContentMS*>(m_pContent);
-		break;
-
-	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
-		pContentMPS = dynamic_cast<const DAFFContentMPS*>(m_pContent);
-		break;
-	}
-
-	vtkSmartPointer<vtkFloatArray> pMagArray = vtkSmartPointer<vtkFloatArray>::New();
+	if (m_iCacheChannel != m_iChannel)
+		UpdateCache();
 
-	pMagArray->SetName("magnitudes");
-	vtkSmartPointer<vtkFloatArray> pPhArray = vtkSmartPointer<vtkFloatArray>::New();
-	pPhArray->SetName("phases");
+	const int iContentType = m_pContent->getProperties()->getContentType();
+	const int iNumRecords = m_pContent->getProperties()->getNumberOfRecords();
+	const float* pfMagnitudes = (m_vfMagnitudes.empty() ? NULL : &m_vfMagnitudes[(size_t)m_iFrequency * iNumRecords]);
+	float* pfScalars = m_pMagnitudes->GetPointer(0);
 
 	float fMag = 0.0f;
-	float fPhase = 0.0f;
 	float fAbsoluteMax = 0.0f;
 	double dMax = 1.0f;
 
 	// get the normalization range
-	if (pContentDFT) {
+	if (iContentType == DAFF_DFT_SPECTRUM) {
 		if (m_iScaling == SCALING_DECIBEL) {
 			if (m_bNormalizeFreqsIndiv)
 				fAbsoluteMax = getMagnitudeMaximum();
 			else
-				fAbsoluteMax = pContentDFT->getOverallMagnitudeMaximum();
+				fAbsoluteMax = m_fOverallMagnitudeMaximum;
 		} else {
 			if (m_bNormalizeFreqsIndiv)
 				dMax = getMagnitudeMaximum();
 			else
-				dMax = pContentDFT->getOverallMagnitudeMaximum();
+				dMax = m_fOverallMagnitudeMaximum;
 		}
 
-	} else if (pContentMS) {
-		if (m_bNormalizeFreqsIndiv)
-			dMax = getMagnitudeMaximum();
-		else
-			dMax = pContentMS->getOverallMagnitudeMaximum();
-	} else if (pContentMPS) {
+	} else if ((iContentType == DAFF_MAGNITUDE_SPECTRUM) || (iContentType == DAFF_MAGNITUDE_PHASE_SPECTRUM)) {
 		if (m_bNormalizeFreqsIndiv)
 			dMax = getMagnitudeMaximum();
 		else
-			dMax = pContentMPS->getOverallMagnitudeMaximum();
+			dMax = m_fOverallMagnitudeMaximum;
 	}
 
-	for (int i = 0; i < m_pContent->getProperties()->getNumberOfRecords(); i++) {
-		// Get the magnitude value
-
-		if (pContentDFT)  // ----------------
-		{
-			float fReal, fImag;
-			pContentDFT->getDFTCoeff(i, m_iChannel, m_iFrequency, fReal, fImag);
-			fMag = sqrt(fReal * fReal + fImag * fImag);
-			if (fReal != 0.0) {
-				fPhase = atan(fImag / fReal);
-				if (fReal < 0.0)
-					if (fImag < 0.0)
-						fPhase -= DAFF::PI_F;
-					else
-						fPhase += DAFF::PI_F;
-			} else {
-				if (fImag < 0.0)
-					fPhase = -DAFF::HALF_PI_F;
-				else
-					fPhase = DAFF::HALF_PI_F;
-			}
-
-			// Check weather decibel scaling is activated
-			if (m_iScaling == SCALING_DECIBEL) {
-				assert(fAbsoluteMax != NULL);
-				fMag = FactorToDecibel(fMag / fAbsoluteMax);
-
-				float DECIBEL_LOWER;
-				float DECIBEL_UPPER;
-
-				// Decibel boundaries
-				// float DECIBEL_DELTA = 30; // FIXME: should not be hard coded -> GUI
-				if (m_bUseCustomRange) {
-					DECIBEL_LOWER = FactorToDecibel(m_dMin);
-					DECIBEL_UPPER = FactorToDecibel(m_dMax);
-				} else {
-					DECIBEL_LOWER = FactorToDecibel(0.0);
-					DECIBEL_UPPER = FactorToDecibel(fAbsoluteMax);
-				}
-
-				// Limit the lower boundary
-				fMag = std::max(fMag, DECIBEL_LOWER);
-				fMag = std::min(fMag, DECIBEL_UPPER);
+	// Decibel boundaries
+	// float DECIBEL_DELTA = 30; // FIXME: should not be hard coded -> GUI
+	float DECIBEL_LOWER;
+	float DECIBEL_UPPER;
+	if (m_bUseCustomRange) {
+		DECIBEL_LOWER = FactorToDecibel(m_dMin);
+		DECIBEL_UPPER = FactorToDecibel(m_dMax);
+	} else {
+		DECIBEL_LOWER = FactorToDecibel(0.0);
+		DECIBEL_UPPER = FactorToDecibel(fAbsoluteMax);
+	}
 
-				// Normalize the range into the interval [0,1]
-				fMag = 1 / (DECIBEL_UPPER - DECIBEL_LOWER) * fMag + DECIBEL_LOWER / (DECIBEL_LOWER - DECIBEL_UPPER);
-			} else {
-				if (m_bNormalize || m_bNormalizeFreqsIndiv) {
-					assert(dMax != NULL && fMag <= dMax);
-					// Normalize the range into the interval [0, 1]
-					fMag = fMag / dMax;
-				} else if (m_bUseCustomRange) {
-					fMag = std::max(fMag, m_dMin);
-					fMag = std::min(fMag, m_dMax);
-					// Normalize the range into the interval [0,1]
-					fMag = (fMag - m_dMin) / (m_dMax - m_dMin);
-				}
-			}
+	// Magnitude spectra are also normalized individually per frequency, magnitude-phase spectra only overall
+	bool bNormalize = m_bNormalize || ((iContentType != DAFF_MAGNITUDE_PHASE_SPECTRUM) && m_bNormalizeFreqsIndiv);
 
-		} else if (pContentMS)  // ----------------
-		{
-			pContentMS->getMagnitude(i, m_iChannel, m_iFrequency, fMag);
+	for (int i = 0; i < iNumRecords; i++) {
+		// Get the magnitude value
+		fMag = (pfMagnitudes ? pfMagnitudes[i] : 0.0f);
 
-			if (m_bNormalize || m_bNormalizeFreqsIndiv) {
-				assert(dMax != NULL && fMag <= dMax);
-				// Normalize the range into the interval [0, 1]
-				fMag = fMag / dMax;
-			} else if (m_bUseCustomRange) {
-				fMag = std::max(fMag, m_dMin);
-				fMag = std::min(fMag, m_dMax);
-				// Normalize the range into the interval [0,1]
-				fMag = (fMag - m_dMin) / (m_dMax - m_dMin);
-			}
-		}
+		// Check weather decibel scaling is activated (DFT spectra only)
+		if ((iContentType == DAFF_DFT_SPECTRUM) && (m_iScaling == SCALING_DECIBEL)) {
+			assert(fAbsoluteMax != NULL);
+			fMag = FactorToDecibel(fMag / fAbsoluteMax);
 
-		else if (pContentMPS) {
-			pContentMPS->getMagnitude(i, m_iChannel, m_iFrequency, fMag);
-			pContentMPS->getPhase(i, m_iChannel, m_iFrequency, fPhase);
+			// Limit the lower boundary
+			fMag = std::max(fMag, DECIBEL_LOWER);
+			fMag = std::min(fMag, DECIBEL_UPPER);
 
-			if (m_bNormalize) {
+			// Normalize the range into the interval [0,1]
+			fMag = 1 / (DECIBEL_UPPER - DECIBEL_LOWER) * fMag + DECIBEL_LOWER / (DECIBEL_LOWER - DECIBEL_UPPER);
+		} else if (pfMagnitudes) {
+			if (bNormalize) {
 				assert(dMax != NULL && fMag <= dMax);
 				// Normalize the range into the interval [0, 1]
 				fMag = fMag / dMax;
@@ -674,24 +996,32 @@ void BalloonPlot::SetScalars()
 		}
 
 		// Store (inverted) value into scalars array
-		pMagArray->InsertNextTuple1(1.0 - fMag);
-		pPhArray->InsertNextTuple1(fPhase);
+		pfScalars[i] = 1.0 - fMag;
 	}
+	m_pMagnitudes->Modified();
+
+	if (m_bWarp)
+		UpdateWarp();
 
-	// Assign scalars to points
-	// m_pPlotPolydata->GetPointData()->SetScalars(pMagArray);
-	m_pPlotPolydata->GetPointData()->AddArray(pMagArray);
-	m_pPlotPolydata->GetPointData()->AddArray(pPhArray);
+	// Phases are referenced in the cache (not copied, VTK does not free them), phase-less content keeps zeros
+	if (!m_vfPhases.empty()) {
+		m_pPhases->SetArray(&m_vfPhases[(size_t)m_iFrequency * iNumRecords], iNumRecords, 1);
+		m_pPhases->Modified();
+	}
 
 	UpdateProbe();
 	return;
 }
 
-void BalloonPlot::sph2cart(double phi, double theta, double& x, double& y, double& z)
+void BalloonPlot::OnUpdate()
 {
-	x = -sin((theta + 90) * DAFF::PI_F / 180.0) * sin(phi * DAFF::PI_F / 180.0);
-	y = -cos((theta + 90) * DAFF::PI_F / 180.0);
-	z = -sin((theta + 90) * DAFF::PI_F / 180.0) * cos(phi * DAFF::PI_F / 180.0);
+	SetScalars();
+}
+
+void BalloonPlot::UpdateCache()
+{
+	m_iCacheChannel = m_iChannel;
+	cacheSpectra(m_pContent, m_iChannel, m_iNumFrequencies, m_vfMagnitudes, m_vfPhases, m_vfMagnitudeMaxima);
 }
 
 float BalloonPlot::FactorToDecibel(float x) const
@@ -714,56 +1044,17 @@ float BalloonPlot::getMagnitudeMaximum() const
 {
 	assert(m_iFrequency >= 0 && m_iFrequency < m_iNumFrequencies);
 	assert(m_pContent != NULL);
-	assert(m_dMin < m_dMax);
-
-	const DAFFContentDFT* pContentDFT = NULL;
-	const DAFFContentMS* pContentMS = NULL;
-	const DAFFContentMPS* pContentMPS = NULL;
-
-	switch (m_pContent->getProperties()->getContentType()) {
-	case DAFF_DFT_SPECTRUM:
-		pContentDFT = dynamic_cast<const DAFFContentDFT*>(m_pContent);
-		break;
-
-	case DAFF_MAGNITUDE_SPECTRUM:
-		pContentMS = dynamic_cast<const DAFFContentMS*>(m_pContent);
-		break;
-
-	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
-		pContentMPS = dynamic_cast<const DAFFContentMPS*>(m_pContent);
-		break;
-	}
-
-	float fMax = std::numeric_limits<float>::min();
-	float fMag;
-	if (pContentDFT) {
-		float fReal, fImag;
-		for (int i = 0; i < pContentDFT->getNumDFTCoeffs(); i++) {
-			pContentDFT->getDFTCoeff(i, m_iChannel, m_iFrequency, fReal, fImag);
-			fMag = std::sqrtf(std::powf(fReal, 2) + std::powf(fImag, 2));
-			if (fMag > fMax)
-				fMax = fMag;
-		}
-	} else if (pContentMS) {
-		for (int i = 0; i < pContentMS->getProperties()->getNumberOfRecords(); i++) {
-			pContentMS->getMagnitude(i, m_iChannel, m_iFrequency, fMag);
-			if (fMag > fMax)
-				fMax = fMag;
-		}
-	} else if (pContentMPS) {
-		for (int i = 0; i < pContentMPS->getProperties()->getNumberOfRecords(); i++) {
-			pContentMPS->getMagnitude(i, m_iChannel, m_iFrequency, fMag);
-			if (fMag > fMax)
-				fMax = fMag;
-		}
-	}
 
-	return fMax;
+	if (m_vfMagnitudeMaxima.empty())
+		return std::numeric_limits<float>::min();
+	return m_vfMagnitudeMaxima[m_iFrequency];
 }
 
 void BalloonPlot::SetScalarVisibility(bool bVisible)
 {
 	m_pMapper->SetScalarVisibility(bVisible);
+	for (size_t i = 0; i < m_vpLODMappers.size(); i++)
+		m_vpLODMappers[i]->SetScalarVisibility(bVisible);
 }
 
 int BalloonPlot::GetScalarVisibility()
@@ -784,7 +1075,7 @@ void BalloonPlot::SetDisplayMode(int iMode)
 void BalloonPlot::SetChannel(int iChannel)
 {
 	m_iChannel = iChannel;
-	SetScalars();
+	SetDirty();
 }
 
 int BalloonPlot::GetChannel()
@@ -801,9 +1092,17 @@ void BalloonPlot::SetUsePhaseAsColor(bool bUse)
 		colors->AddRGBPoint(0, 1, 1, 1);
 		colors->AddRGBPoint(DAFF::PI_F, 1, 0, 0);
 		m_pMapper->SetLookupTable(colors);
+		for (size_t i = 0; i < m_vpLODMappers.size(); i++) {
+			m_vpLODMappers[i]->SelectColorArray("phases");
+			m_vpLODMappers[i]->SetLookupTable(colors);
+		}
 	} else {
 		m_pMapper->SelectColorArray("magnitudes");
 		m_pMapper->SetLookupTable(0);
+		for (size_t i = 0; i < m_vpLODMappers.size(); i++) {
+			m_vpLODMappers[i]->SelectColorArray("magnitudes");
+			m_vpLODMappers[i]->SetLookupTable(0);
+		}
 	}
 	m_bUsePhaseAsColor = bUse;
 }
@@ -5,6 +5,8 @@
 #include <DAFF.h>
 
 #include <algorithm>
+#include <system_error>
+#include <thread>
 
 #include <assert.h>
 #include <vtkActor.h>
@@ -17,6 +19,7 @@
 #include <vtkHedgeHog.h>
 #include <vtkLine.h>
 #include <vtkLookupTable.h>
+#include <vtkMatrix4x4.h>
 #include <vtkPointData.h>
 #include <vtkPoints.h>
 #include <vtkPolyData.h>
@@ -24,36 +27,349 @@
 #include <vtkPolyDataNormals.h>
 #include <vtkPolyLine.h>
 #include <vtkProperty.h>
+#include <vtkRenderer.h>
 #include <vtkScalarBarActor.h>
 #include <vtkVectorText.h>
 #include <vtkWarpScalar.h>
 #include <vtkWindowedSincPolyDataFilter.h>
 
 namespace DAFFViz {
+
+//! Minimum number of columns (records) of the scalars computed per thread
+static const int CARPET_MIN_COLUMNS_PER_THREAD = 16;
+
+//! Number of steps the time axis is sampled with to find the visible time window
+static const int CARPET_TIME_WINDOW_STEPS = 64;
+
+//! Limits of the time resolution set from the visible part of the plot
+static const int CARPET_MIN_TIME_RESOLUTION = 64;
+static const int CARPET_MAX_TIME_RESOLUTION = 8192;
+
+//! Records around a probe direction (data view) and their bilinear weights
+/**
+ * Grids that cannot be interpolated (irregular grids) give the nearest record with weight 1.
+ */
+static void getProbeWeights(const DAFFContent* pContent, float fAlphaDeg, float fBetaDeg, int* piIndices,
+							float* pfWeights)
+{
+	DAFFInterpolator oInterpolator(pContent);
+	DAFFQuad qIndices;
+	if (oInterpolator.getWeights(DAFF_DATA_VIEW, fAlphaDeg, fBetaDeg, qIndices, pfWeights) == DAFF_NO_ERROR) {
+		piIndices[0] = qIndices.iIndex1;
+		piIndices[1] = qIndices.iIndex2;
+		piIndices[2] = qIndices.iIndex3;
+		piIndices[3] = qIndices.iIndex4;
+		return;
+	}
+
+	pContent->getNearestNeighbour(DAFF_DATA_VIEW, fAlphaDeg, fBetaDeg, piIndices[0]);
+	pfWeights[0] = 1.0f;
+	for (int i = 1; i < 4; i++) {
+		piIndices[i] = piIndices[0];
+		pfWeights[i] = 0.0f;
+	}
+}
+
+//! Time axis of a carpet plot (rows of the grid)
+struct CarpetTimeAxis {
+	int iFirstSample;  //!@ First sample of the time window
+	int iNumSamples;   //!@ Number of samples of the time window
+	int iNumBins;      //!@ Number of envelope bins, two rows each (0: not decimated, one row per sample)
+	int iNumRows;      //!@ Number of rows
+};
+
+//! Scalars of a carpet plot, computed by several threads (each computes a range of columns)
+struct CarpetPlotScalarJob {
+	const DAFFContentIR* pContentIR;  //!@ Content
+	int iFixedAngle;                  //!@ Fixed angle (CarpetPlot::ALPHA_FIXED | CarpetPlot::BETA_FIXED)
+	float fAngle;                     //!@ Selected angle
+	int iChannel;                     //!@ Channel
+	int iScaling;                     //!@ Scaling (CarpetPlot::SCALING_LINEAR | CarpetPlot::SCALING_DECIBEL)
+	float fMin, fMax;                 //!@ Data range (linear factors)
+	CarpetTimeAxis oTimeAxis;         //!@ Time axis
+	float* pfScalars;                 //!@ Scalars [column][row]
+};
+
+//! Converts a linear value into decibel
+static double factorToDecibel(double x)
+{
+	assert(x >= 0);
+	// Lower boundary is -100 dB
+	if (x <= 0.0000000001)
+		return -100;
+	return 10 * log(x) / log((double)10);
+}
+
+//! Returns the number of columns of a carpet plot (points of the angle that is not fixed)
+static int getCarpetColumns(const DAFFContentIR* pContentIR, int iFixedAngle)
+{
+	// The rows at alpha 0 and 360 degree are both present
+	if (iFixedAngle == CarpetPlot::BETA_FIXED)
+		return pContentIR->getProperties()->getAlphaPoints() + 1;
+	else
+		return pContentIR->getProperties()->getBetaPoints();
+}
+
+//! Returns the time axis of a time window, decimated to a time resolution if the window is long
+static CarpetTimeAxis getCarpetTimeAxis(const DAFFContentIR* pContentIR, int iFirstSample, int iNumSamples,
+										int iTimeResolution)
+{
+	const int iFilterLength = pContentIR->getFilterLength();
+
+	CarpetTimeAxis oAxis;
+	oAxis.iFirstSample = std::min(std::max(iFirstSample, 0), iFilterLength - 1);
+	oAxis.iNumSamples = iFilterLength - oAxis.iFirstSample;
+	if (iNumSamples > 0)
+		oAxis.iNumSamples = std::min(iNumSamples, oAxis.iNumSamples);
+
+	// The envelope has two rows per bin, so it only pays off for more than two samples per bin
+	if ((iTimeResolution > 0) && (oAxis.iNumSamples > 2 * iTimeResolution)) {
+		oAxis.iNumBins = iTimeResolution;
+		oAxis.iNumRows = 2 * iTimeResolution;
+	} else {
+		oAxis.iNumBins = 0;
+		oAxis.iNumRows = oAxis.iNumSamples;
+	}
+	return oAxis;
+}
+
+//! Returns the time of a row [samples] (minimum and maximum of a bin at a quarter and three quarters of it)
+static double getCarpetRowTime(const CarpetTimeAxis& oAxis, int iRow)
+{
+	if (oAxis.iNumBins == 0)
+		return oAxis.iFirstSample + iRow;
+
+	int k = iRow / 2;
+	double dBegin = oAxis.iFirstSample + (double)((int64_t)k * oAxis.iNumSamples / oAxis.iNumBins);
+	double dEnd = oAxis.iFirstSample + (double)((int64_t)(k + 1) * oAxis.iNumSamples / oAxis.iNumBins);
+	return dBegin + (iRow % 2 == 0 ? 0.25 : 0.75) * (dEnd - dBegin);
+}
+
+//! Computes the scalars of the columns [iFirstColumn, iLastColumn) of a job
+static void computeColumns(const CarpetPlotScalarJob* pJob, int iFirstColumn, int iLastColumn)
+{
+	const DAFFContentIR* pContentIR = pJob->pContentIR;
+	const CarpetTimeAxis& oAxis = pJob->oTimeAxis;
+	std::vector<float> vCoeffs(pContentIR->getFilterLength());
+	std::vector<float> vEnvelope(2 * oAxis.iNumBins);
+	if (oAxis.iNumBins > 0)
+		vCoeffs.resize(oAxis.iNumRows);
+
+	int iNumPoints;
+	float fStart, fRange;
+	if (pJob->iFixedAngle == CarpetPlot::BETA_FIXED) {
+		iNumPoints = pContentIR->getProperties()->getAlphaPoints();
+		fStart = pContentIR->getProperties()->getAlphaStart();
+		fRange = pContentIR->getProperties()->getAlphaEnd() - fStart;
+	} else {
+		iNumPoints = pContentIR->getProperties()->getBetaPoints();
+		fStart = pContentIR->getProperties()->getBetaStart();
+		fRange = pContentIR->getProperties()->getBetaEnd() - fStart;
+	}
+
+	// Decibel boundaries
+	float DECIBEL_LOWER = -100;
+	if (pJob->fMin >= 0)
+		DECIBEL_LOWER = factorToDecibel(pJob->fMin);
+	float DECIBEL_UPPER = factorToDecibel(pJob->fMax);
+
+	for (int i = iFirstColumn; i < iLastColumn; i++) {
+		int index = 0;
+		float fColumnAngle = (float)i / (float)iNumPoints * fRange + fStart;
+		if (pJob->iFixedAngle == CarpetPlot::BETA_FIXED)
+			pContentIR->getNearestNeighbour(DAFF_DATA_VIEW, fColumnAngle, pJob->fAngle, index);
+		else
+			pContentIR->getNearestNeighbour(DAFF_DATA_VIEW, pJob->fAngle, fColumnAngle, index);
+
+		// Pull filter coefficients of the time window, or their envelope (minimum and maximum of each bin)
+		const float* pfRows = &vCoeffs[0];
+		if (oAxis.iNumBins > 0) {
+			pContentIR->getFilterEnvelope(index, pJob->iChannel, oAxis.iFirstSample, oAxis.iNumSamples, oAxis.iNumBins,
+										  &vEnvelope[0], &vEnvelope[oAxis.iNumBins]);
+			for (int k = 0; k < oAxis.iNumBins; k++) {
+				vCoeffs[2 * k] = vEnvelope[k];
+				vCoeffs[2 * k + 1] = vEnvelope[oAxis.iNumBins + k];
+			}
+		} else {
+			pContentIR->getFilterCoeffs(index, pJob->iChannel, &vCoeffs[0]);
+			pfRows += oAxis.iFirstSample;
+		}
+
+		float* pfColumn = pJob->pfScalars + (size_t)i * oAxis.iNumRows;
+		for (int j = 0; j < oAxis.iNumRows; j++) {
+			float coeff = pfRows[j];
+
+			// Check weather decibel scaling is activated
+			if (pJob->iScaling == CarpetPlot::SCALING_DECIBEL) {
+				// CAVE: we take absolut value instead of square
+				coeff = (float)factorToDecibel((double)fabs(coeff));
+
+				// Normalize the range into the interval [0,1]
+				// Limit the boundaries
+				coeff = std::max(coeff, DECIBEL_LOWER);
+				coeff = std::min(coeff, DECIBEL_UPPER);
+				// clamp to [0 1]
+				coeff = 1.0 / (DECIBEL_UPPER - DECIBEL_LOWER) * coeff + DECIBEL_LOWER / (DECIBEL_LOWER - DECIBEL_UPPER);
+			} else {
+				// Limit the boundaries
+				coeff = std::max(coeff, pJob->fMin);
+				coeff = std::min(coeff, pJob->fMax);
+				// clamp to [0 1]
+				coeff = (coeff - pJob->fMin) / (pJob->fMax - pJob->fMin);
+			}
+			// store value in array
+			pfColumn[j] = coeff;
+		}
+	}
+}
+
+//! Creates the scalars of a carpet plot, the columns (records) are computed in parallel
+static vtkSmartPointer<vtkFloatArray> createCarpetScalars(const CarpetPlotScalarJob& oJobSettings)
+{
+	CarpetPlotScalarJob oJob = oJobSettings;
+	const int iNumColumns = getCarpetColumns(oJob.pContentIR, oJob.iFixedAngle);
+
+	vtkSmartPointer<vtkFloatArray> pIRWarpArray = vtkSmartPointer<vtkFloatArray>::New();
+	pIRWarpArray->SetName("DAFFIRWarpData");
+	pIRWarpArray->SetNumberOfTuples((vtkIdType)iNumColumns * oJob.oTimeAxis.iNumRows);
+	oJob.pfScalars = pIRWarpArray->GetPointer(0);
+
+	// Read access to the content from several threads is safe, each thread computes a range of columns
+	int iNumThreads = (int)std::max(std::thread::hardware_concurrency(), 1u);
+	iNumThreads = std::max(std::min(iNumThreads, iNumColumns / CARPET_MIN_COLUMNS_PER_THREAD), 1);
+	int iColumnsPerThread = (iNumColumns + iNumThreads - 1) / iNumThreads;
+
+	// The calling thread computes the first range
+	std::vector<std::thread> vThreads;
+	int iFirstColumn = iColumnsPerThread;
+	try {
+		for (; iFirstColumn < iNumColumns; iFirstColumn += iColumnsPerThread)
+			vThreads.push_back(std::thread(&computeColumns, &oJob, iFirstColumn,
+										   std::min(iFirstColumn + iColumnsPerThread, iNumColumns)));
+	} catch (const std::system_error&) {
+		// Not enough threads available, compute the remaining columns here
+	}
+
+	computeColumns(&oJob, 0, std::min(iColumnsPerThread, iNumColumns));
+	if (iFirstColumn < iNumColumns)
+		computeColumns(&oJob, iFirstColumn, iNumColumns);
+	for (size_t i = 0; i < vThreads.size(); i++)
+		vThreads[i].join();
+
+	return pIRWarpArray;
+}
+
+//! Creates the grid points and faces of a carpet plot
+static void createCarpetMesh(const DAFFContentIR* pContentIR, int iFixedAngle, const CarpetTimeAxis& oTimeAxis,
+							 vtkSmartPointer<vtkPoints>& points, vtkSmartPointer<vtkCellArray>& cells)
+{
+	const DAFFProperties* pProps = pContentIR->getProperties();
+
+	// --= carpet grid points and faces =--
+
+	int iNumPointsX, iIndexMaxX;
+	if (iFixedAngle == CarpetPlot::BETA_FIXED) {
+		iNumPointsX = pProps->getAlphaPoints();
+		if (pProps->coversFullAlphaRange())
+			iIndexMaxX = iNumPointsX + 1;  // when we cover full sphere, the last row equals the first one
+		else
+			iIndexMaxX = iNumPointsX;
+	} else {
+		iNumPointsX = pProps->getBetaPoints();
+		iIndexMaxX = iNumPointsX;
+	}
+
+	int iNumPointsY = oTimeAxis.iNumRows;
+	double dFilterLength = pContentIR->getFilterLength();
+
+	vtkIdType quadface[4];
+	points = vtkSmartPointer<vtkPoints>::New();
+	cells = vtkSmartPointer<vtkCellArray>::New();
+	for (int i = 0; i < iIndexMaxX; i++) {
+		for (int j = 0; j < iNumPointsY; j++) {
+			if ((i != iIndexMaxX - 1) && (j != iNumPointsY - 1)) {  // every time except from first and last row/column
+				quadface[0] = (i + 1) * iNumPointsY + j + 1;
+				quadface[1] = (i + 1) * iNumPointsY + j;
+				quadface[2] = (i)*iNumPointsY + j;
+				quadface[3] = (i)*iNumPointsY + j + 1;
+				for (int k = 0; k < 4; k++)
+					assert((quadface[k] >= 0) && (quadface[k] < iIndexMaxX * iNumPointsY));
+				cells->InsertNextCell(4, quadface);
+			}
+			vtkIdType iPointiD = i * iNumPointsY + j;
+			double dX = 2.0f * double(i) / double(iNumPointsX) - 1.0f;
+			double dY = 2.0f * getCarpetRowTime(oTimeAxis, j) / dFilterLength - 1.0f;
+			double dZ = 0.0f;
+			points->InsertPoint(iPointiD, dX, dY, dZ);
+		}
+	}
+}
+
+CarpetPlotGeometry::CarpetPlotGeometry(const DAFFContentIR* pContentIR, int iScaling, int iChannel, int iTimeResolution)
+	: m_pContentIR(pContentIR), m_iScaling(iScaling), m_iChannel(iChannel), m_iTimeResolution(iTimeResolution)
+{
+	if (m_pContentIR == nullptr)
+		return;
+
+	CarpetTimeAxis oTimeAxis = getCarpetTimeAxis(m_pContentIR, 0, 0, m_iTimeResolution);
+	createCarpetMesh(m_pContentIR, CarpetPlot::BETA_FIXED, oTimeAxis, m_pPoints, m_pCells);
+
+	// Default settings of a plot (selected angle 0, data range [-1, 1])
+	CarpetPlotScalarJob oJob = {m_pContentIR, CarpetPlot::BETA_FIXED, 0.0f, m_iChannel, m_iScaling, -1.0f, 1.0f,
+								oTimeAxis, NULL};
+	m_pScalars = createCarpetScalars(oJob);
+}
+
+CarpetPlotGeometry::~CarpetPlotGeometry() {}
+
+const DAFFContentIR* CarpetPlotGeometry::GetContent() const
+{
+	return m_pContentIR;
+}
+
 CarpetPlot::CarpetPlot(const DAFFContentIR* pContentIR)
 	: SGNode(), m_pContentIR(pContentIR), m_fAngle(0.0f), m_iScaling(SCALING_LINEAR), m_dMin(-1.0), m_dMax(1.0),
 	  m_iFixedAngle(0), m_pCarpetPolyData(0), m_pCarpetMapper(0), m_pWarp(0), m_pCarpetActor(0), m_iChannel(0),
-	  m_bWarp(true), m_pProbe(0), m_pLabel(0), m_dProbeX(0), m_dProbeY(0)
+	  m_iTimeResolution(DEFAULT_TIME_RESOLUTION), m_iFirstSample(0), m_iNumSamples(0), m_bWarp(true),
+	  m_bMeshDirty(false), m_pProbe(0), m_pLabel(0), m_dProbeX(0), m_dProbeY(0)
+{
+	CarpetPlotGeometry oGeometry(pContentIR, m_iScaling, m_iChannel, m_iTimeResolution);
+	Init(oGeometry);
+}
+
+CarpetPlot::CarpetPlot(SGNode* pParent, CarpetPlotGeometry& oGeometry)
+	: SGNode(pParent), m_pContentIR(oGeometry.GetContent()), m_fAngle(0.0f), m_iScaling(oGeometry.m_iScaling),
+	  m_dMin(-1.0), m_dMax(1.0), m_iFixedAngle(BETA_FIXED), m_pCarpetPolyData(0), m_pCarpetMapper(0), m_pWarp(0),
+	  m_pCarpetActor(0), m_iChannel(oGeometry.m_iChannel), m_iTimeResolution(oGeometry.m_iTimeResolution),
+	  m_iFirstSample(0), m_iNumSamples(0), m_bWarp(true), m_bMeshDirty(false), m_pProbe(0), m_pLabel(0), m_dProbeX(0),
+	  m_dProbeY(0)
 {
-	Init();
+	Init(oGeometry);
 }
 
 CarpetPlot::CarpetPlot(SGNode* pParent, const DAFFContentIR* pContentIR)
 	: SGNode(pParent), m_pContentIR(pContentIR), m_fAngle(0.0f), m_iScaling(SCALING_LINEAR), m_dMin(-1.0), m_dMax(1.0),
 	  m_iFixedAngle(0), m_pCarpetPolyData(0), m_pCarpetMapper(0), m_pWarp(0), m_pCarpetActor(0), m_iChannel(0),
-	  m_bWarp(true), m_pProbe(0), m_pLabel(0), m_dProbeX(0), m_dProbeY(0)
+	  m_iTimeResolution(DEFAULT_TIME_RESOLUTION), m_iFirstSample(0), m_iNumSamples(0), m_bWarp(true),
+	  m_bMeshDirty(false), m_pProbe(0), m_pLabel(0), m_dProbeX(0), m_dProbeY(0)
 {
-	Init();
+	CarpetPlotGeometry oGeometry(pContentIR, m_iScaling, m_iChannel, m_iTimeResolution);
+	Init(oGeometry);
 }
 
-void CarpetPlot::Init()
+void CarpetPlot::Init(CarpetPlotGeometry& oGeometry)
 {
 	if (m_pContentIR == nullptr)
 		return;
 
-	// Carpet mesh
+	// Carpet mesh, taken over from the geometry (leaves it empty)
 	m_pCarpetPolyData = vtkSmartPointer<vtkPolyData>::New();
-	InitCarpetMesh();
+	m_pCarpetPolyData->SetPoints(oGeometry.m_pPoints);
+	m_pCarpetPolyData->SetPolys(oGeometry.m_pCells);
+	m_pCarpetPolyData->GetPointData()->SetScalars(oGeometry.m_pScalars);
+	oGeometry.m_pPoints = NULL;
+	oGeometry.m_pCells = NULL;
+	oGeometry.m_pScalars = NULL;
 
 	// Carpet mapper
 	m_pCarpetMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
@@ -152,45 +468,10 @@ CarpetPlot::~CarpetPlot()
 
 void CarpetPlot::InitCarpetMesh()
 {
-	const DAFFProperties* pProps = m_pContentIR->getProperties();
-
-	// --= carpet grid points and faces =--
-
-	int iNumPointsX, iIndexMaxX;
-	if (m_iFixedAngle == BETA_FIXED) {
-		iNumPointsX = pProps->getAlphaPoints();
-		if (pProps->coversFullAlphaRange())
-			iIndexMaxX = iNumPointsX + 1;  // when we cover full sphere, the last row equals the first one
-		else
-			iIndexMaxX = iNumPointsX;
-	} else {
-		iNumPointsX = pProps->getBetaPoints();
-		iIndexMaxX = iNumPointsX;
-	}
-
-	int iNumPointsY = m_pContentIR->getFilterLength();
-
-	vtkIdType quadface[4];
-	vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
-	vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
-	for (int i = 0; i < iIndexMaxX; i++) {
-		for (int j = 0; j < iNumPointsY; j++) {
-			if ((i != iIndexMaxX - 1) && (j != iNumPointsY - 1)) {  // every time except from first and last row/column
-				quadface[0] = (i + 1) * iNumPointsY + j + 1;
-				quadface[1] = (i + 1) * iNumPointsY + j;
-				quadface[2] = (i)*iNumPointsY + j;
-				quadface[3] = (i)*iNumPointsY + j + 1;
-				for (int k = 0; k < 4; k++)
-					assert((quadface[k] >= 0) && (quadface[k] < iIndexMaxX * iNumPointsY));
-				cells->InsertNextCell(4, quadface);
-			}
-			vtkIdType iPointiD = i * iNumPointsY + j;
-			double dX = 2.0f * double(i) / double(iNumPointsX) - 1.0f;
-			double dY = 2.0f * double(j) / double(iNumPointsY) - 1.0f;
-			double dZ = 0.0f;
-			points->InsertPoint(iPointiD, dX, dY, dZ);
-		}
-	}
+	vtkSmartPointer<vtkPoints> points;
+	vtkSmartPointer<vtkCellArray> cells;
+	CarpetTimeAxis oTimeAxis = getCarpetTimeAxis(m_pContentIR, m_iFirstSample, m_iNumSamples, m_iTimeResolution);
+	createCarpetMesh(m_pContentIR, m_iFixedAngle, oTimeAxis, points, cells);
 
 	m_pCarpetPolyData->SetPoints(points);
 	m_pCarpetPolyData->SetPolys(cells);
@@ -198,6 +479,28 @@ void CarpetPlot::InitCarpetMesh()
 	SetScalars();
 }
 
+void CarpetPlot::OnUpdate()
+{
+	// A new mesh comes with new scalars
+	if (m_bMeshDirty) {
+		m_bMeshDirty = false;
+		InitCarpetMesh();
+	} else {
+		SetScalars();
+	}
+}
+
+size_t CarpetPlot::GetMemoryFootprint() const
+{
+	// VTK reports the data object sizes in KiB
+	size_t nBytes = SGNode::GetMemoryFootprint();
+	if (m_pCarpetPolyData)
+		nBytes += (size_t)m_pCarpetPolyData->GetActualMemorySize() * 1024;
+	if (m_pWarp && m_pWarp->GetPolyDataOutput())
+		nBytes += (size_t)m_pWarp->GetPolyDataOutput()->GetActualMemorySize() * 1024;
+	return nBytes;
+}
+
 void CarpetPlot::UpdateProbe()
 {
 	if (!m_pProbe)
@@ -205,31 +508,40 @@ void CarpetPlot::UpdateProbe()
 
 	// Apply new transformation
 	assert(m_pContentIR != 0);
-	double val = 0;
-	int i;
+	int piIndices[4];
+	float pfWeights[4];
 	std::ostringstream s;
-	float fMag;
-	int iOffs = 0, iLen = m_pContentIR->getFilterLength();
-	float* pBuf = 0;
+	float fMag = 0.0f;
+	int iLen = m_pContentIR->getFilterLength();
 	float dPosX = 0, dPosY = 0, dPosZ = 0;  // X := not fixed angle, Y := time
 	dPosY = 2 * m_dProbeY / iLen - 1;
 	if (m_iScaling == SCALING_LINEAR)  // else dPosZ=0
 		dPosZ = (m_dMin) / (m_dMax - m_dMin);
 	if (m_iFixedAngle == BETA_FIXED) {
 		dPosX = 2 * m_dProbeX / m_pContentIR->getProperties()->getBetaSpan() - 1;
-		m_pContentIR->getNearestNeighbour(DAFF_DATA_VIEW, m_dProbeX, m_fAngle, i);
+		getProbeWeights(m_pContentIR, m_dProbeX, m_fAngle, piIndices, pfWeights);
 	} else {
 		dPosX = 2 * m_dProbeX / m_pContentIR->getProperties()->getAlphaSpan() - 1;
-		m_pContentIR->getNearestNeighbour(DAFF_DATA_VIEW, m_fAngle, m_dProbeX, i);
+		getProbeWeights(m_pContentIR, m_fAngle, m_dProbeX, piIndices, pfWeights);
 	}
 
 	m_pProbe->SetPosition(dPosX, dPosZ, dPosY);
 	m_pLabel->SetPosition(dPosX, dPosZ + 1.01, dPosY);
 
-	// update label
-	pBuf = new float[iLen];
-	m_pContentIR->getFilterCoeffs(i, m_iChannel, pBuf);
-	fMag = pBuf[(int)m_dProbeY];
+	// update label, interpolated between the records around the probe and the two samples around
+	// the probe time (only these coefficients are read)
+	float fTime = std::min(std::max((float)m_dProbeY, 0.0f), (float)(iLen - 1));
+	int iSample1 = (int)fTime;
+	int iSample2 = std::min(iSample1 + 1, iLen - 1);
+	float fFrac = fTime - (float)iSample1;
+	for (int i = 0; i < 4; i++) {
+		float fCoeff1, fCoeff2;
+		if ((pfWeights[i] == 0.0f) ||
+			(m_pContentIR->getFilterCoeff(piIndices[i], m_iChannel, iSample1, fCoeff1) != DAFF_NO_ERROR) ||
+			(m_pContentIR->getFilterCoeff(piIndices[i], m_iChannel, iSample2, fCoeff2) != DAFF_NO_ERROR))
+			continue;
+		fMag += pfWeights[i] * ((1.0f - fFrac) * fCoeff1 + fFrac * fCoeff2);
+	}
 
 	if (m_iScaling == SCALING_DECIBEL || false) {
 		fMag = factor2decibel((double)fabs(fMag));
@@ -257,7 +569,7 @@ void CarpetPlot::SetProbeVisible(bool bVisible)
 void CarpetPlot::SetSelectedAngle(float fAngle)
 {
 	m_fAngle = fAngle;
-	SetScalars();
+	SetDirty();
 
 	return;
 }
@@ -270,7 +582,7 @@ float CarpetPlot::GetSelectedAngle() const
 void CarpetPlot::SetScaling(int iScaling)
 {
 	m_iScaling = iScaling;
-	SetScalars();
+	SetDirty();
 
 	return;
 }
@@ -284,7 +596,8 @@ void CarpetPlot::SetFixedAngle(int iFixedAngle)
 {
 	m_iFixedAngle = iFixedAngle;
 
-	InitCarpetMesh();
+	m_bMeshDirty = true;
+	SetDirty();
 }
 
 int CarpetPlot::getFixedAngle()
@@ -292,6 +605,110 @@ int CarpetPlot::getFixedAngle()
 	return m_iFixedAngle;
 }
 
+int CarpetPlot::GetTimeResolution() const
+{
+	return m_iTimeResolution;
+}
+
+void CarpetPlot::SetTimeResolution(int iNumBins)
+{
+	m_iTimeResolution = iNumBins;
+
+	m_bMeshDirty = true;
+	SetDirty();
+}
+
+void CarpetPlot::GetTimeWindow(int& iFirstSample, int& iNumSamples) const
+{
+	CarpetTimeAxis oTimeAxis = getCarpetTimeAxis(m_pContentIR, m_iFirstSample, m_iNumSamples, m_iTimeResolution);
+	iFirstSample = oTimeAxis.iFirstSample;
+	iNumSamples = oTimeAxis.iNumSamples;
+}
+
+void CarpetPlot::SetTimeWindow(int iFirstSample, int iNumSamples)
+{
+	m_iFirstSample = iFirstSample;
+	m_iNumSamples = iNumSamples;
+
+	m_bMeshDirty = true;
+	SetDirty();
+}
+
+bool CarpetPlot::UpdateTimeWindow(vtkRenderer* pRenderer)
+{
+	if ((m_pContentIR == NULL) || (pRenderer == NULL))
+		return false;
+
+	const int* piSize = pRenderer->GetSize();
+	if ((piSize[0] <= 0) || (piSize[1] <= 0))
+		return false;
+
+	// Carpet coordinates (x: angle, y: time, both [-1, 1]) to world coordinates
+	vtkSmartPointer<vtkMatrix4x4> pMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+	GetWorldMatrix(pMatrix);
+	vtkMatrix4x4::Multiply4x4(pMatrix, m_pCarpetActor->GetMatrix(), pMatrix);
+
+	// Sample the time axis along both edges and the center, the visible steps give the time window
+	// and the longest visible line its extent on the screen
+	int iFirstStep = CARPET_TIME_WINDOW_STEPS, iLastStep = -1;
+	double dMaxPixels = 0;
+	for (int l = -1; l <= 1; l++) {
+		double pdLast[2] = {0, 0};
+		bool bLastVisible = false;
+		double dPixels = 0;
+		for (int k = 0; k <= CARPET_TIME_WINDOW_STEPS; k++) {
+			double pdCarpet[4] = {(double)l, 2.0 * k / CARPET_TIME_WINDOW_STEPS - 1.0, 0.0, 1.0};
+			double pdWorld[4];
+			pMatrix->MultiplyPoint(pdCarpet, pdWorld);
+			pRenderer->SetWorldPoint(pdWorld);
+			pRenderer->WorldToDisplay();
+			const double* pdDisplay = pRenderer->GetDisplayPoint();
+
+			bool bVisible = (pdDisplay[0] >= 0) && (pdDisplay[0] <= piSize[0]) && (pdDisplay[1] >= 0) &&
+							(pdDisplay[1] <= piSize[1]) && (pdDisplay[2] >= -1) && (pdDisplay[2] <= 1);
+			if (bVisible) {
+				iFirstStep = std::min(iFirstStep, k);
+				iLastStep = std::max(iLastStep, k);
+				if (bLastVisible)
+					dPixels += std::sqrt((pdDisplay[0] - pdLast[0]) * (pdDisplay[0] - pdLast[0]) +
+										 (pdDisplay[1] - pdLast[1]) * (pdDisplay[1] - pdLast[1]));
+			}
+			pdLast[0] = pdDisplay[0];
+			pdLast[1] = pdDisplay[1];
+			bLastVisible = bVisible;
+		}
+		dMaxPixels = std::max(dMaxPixels, dPixels);
+	}
+
+	// Plot is out of sight
+	if (iLastStep < 0)
+		return false;
+
+	// Extend by one step, the samples between the last visible and the first hidden step may be visible
+	const int iFilterLength = m_pContentIR->getFilterLength();
+	iFirstStep = std::max(iFirstStep - 1, 0);
+	iLastStep = std::min(iLastStep + 1, CARPET_TIME_WINDOW_STEPS);
+	int iFirstSample = (int)((int64_t)iFirstStep * iFilterLength / CARPET_TIME_WINDOW_STEPS);
+	int iEndSample = (int)((int64_t)iLastStep * iFilterLength / CARPET_TIME_WINDOW_STEPS);
+	int iNumSamples = (iEndSample < iFilterLength ? iEndSample - iFirstSample : 0);
+
+	// Resolution in powers of two, so that small camera movements do not rebuild the plot
+	int iTimeResolution = CARPET_MIN_TIME_RESOLUTION;
+	while ((iTimeResolution < dMaxPixels) && (iTimeResolution < CARPET_MAX_TIME_RESOLUTION))
+		iTimeResolution *= 2;
+
+	if ((iFirstSample == m_iFirstSample) && (iNumSamples == m_iNumSamples) && (iTimeResolution == m_iTimeResolution))
+		return false;
+
+	m_iFirstSample = iFirstSample;
+	m_iNumSamples = iNumSamples;
+	m_iTimeResolution = iTimeResolution;
+	m_bMeshDirty = true;
+	SetDirty();
+
+	return true;
+}
+
 void CarpetPlot::SetRange(double dMin, double dMax)
 {
 	assert(m_pContentIR != NULL);
@@ -304,7 +721,7 @@ void CarpetPlot::SetRange(double dMin, double dMax)
 		m_dMin = decibel2factor(dMin);
 		m_dMax = decibel2factor(dMax);
 	}
-	SetScalars();
+	SetDirty();
 }
 
 void CarpetPlot::SetScalarVisibility(bool bVisible)
@@ -377,96 +794,10 @@ void CarpetPlot::SetScalars()
 	assert(m_pContentIR != NULL);
 	assert(m_dMin < m_dMax);
 
-	vtkSmartPointer<vtkFloatArray> pIRWarpArray = vtkSmartPointer<vtkFloatArray>::New();
-	pIRWarpArray->SetName("DAFFIRWarpData");
-	std::vector<float> vCoeffs(m_pContentIR->getFilterLength());
-	if (m_iFixedAngle == BETA_FIXED) {
-		int iNumPoints = m_pContentIR->getProperties()->getAlphaPoints();
-		float fStart = m_pContentIR->getProperties()->getAlphaStart();
-		float fRange = m_pContentIR->getProperties()->getAlphaEnd() - fStart;
-		for (int i = 0; i <= iNumPoints; i++) {
-			// Pull filter coefficients
-			int index = 0;
-			m_pContentIR->getNearestNeighbour(DAFF_DATA_VIEW, (float)i / (float)iNumPoints * fRange + fStart, m_fAngle,
-											  index);
-			m_pContentIR->getFilterCoeffs(index, m_iChannel, &vCoeffs[0]);
-			float coeff = 0.0f;
-			for (int j = 0; j < m_pContentIR->getFilterLength(); j++) {
-				coeff = vCoeffs[j];
-
-				// Check weather decibel scaling is activated
-				if (m_iScaling == SCALING_DECIBEL) {
-					// CAVE: we take absolut value instead of square
-					coeff = (float)factor2decibel((double)fabs(coeff));
-
-					// Decibel boundaries
-					float DECIBEL_LOWER = -100;
-					if (m_dMin >= 0)
-						DECIBEL_LOWER = factor2decibel(m_dMin);
-					float DECIBEL_UPPER = factor2decibel(m_dMax);
-
-					// Normalize the range into the interval [0,1]
-					// Limit the boundaries
-					coeff = std::max(coeff, DECIBEL_LOWER);
-					coeff = std::min(coeff, DECIBEL_UPPER);
-					// clamp to [0 1]
-					coeff =
-						1.0 / (DECIBEL_UPPER - DECIBEL_LOWER) * coeff + DECIBEL_LOWER / (DECIBEL_LOWER - DECIBEL_UPPER);
-				} else {
-					// Limit the boundaries
-					coeff = std::max(coeff, m_dMin);
-					coeff = std::min(coeff, m_dMax);
-					// clamp to [0 1]
-					coeff = (coeff - m_dMin) / (m_dMax - m_dMin);
-				}
-				// store value in array
-				pIRWarpArray->InsertNextTuple1(coeff);
-			}
-		}
-	} else {
-		int iNumPoints = m_pContentIR->getProperties()->getBetaPoints();
-		float fStart = m_pContentIR->getProperties()->getBetaStart();
-		float fRange = m_pContentIR->getProperties()->getBetaEnd() - fStart;
-		for (int i = 0; i < m_pContentIR->getProperties()->getBetaPoints(); i++) {
-			// Pull filter coefficients
-			int index = 0;
-			m_pContentIR->getNearestNeighbour(DAFF_DATA_VIEW, m_fAngle, (float)i / (float)iNumPoints * fRange + fStart,
-											  index);
-			m_pContentIR->getFilterCoeffs(index, m_iChannel, &vCoeffs[0]);
-			float coeff = 0.0f;
-			for (int j = 0; j < m_pContentIR->getFilterLength(); j++) {
-				coeff = vCoeffs[j];
-
-				// Check weather decibel scaling is activated
-				if (m_iScaling == SCALING_DECIBEL) {
-					// CAVE: we take absolut value instead of square
-					coeff = (float)factor2decibel((double)fabs(coeff));
-
-					// Decibel boundaries
-					float DECIBEL_LOWER = -100;
-					if (m_dMin >= 0)
-						DECIBEL_LOWER = factor2decibel(m_dMin);
-					float DECIBEL_UPPER = factor2decibel(m_dMax);
-
-					// Normalize the range into the interval [0,1]
-					// Limit the boundaries
-					coeff = std::max(coeff, DECIBEL_LOWER);
-					coeff = std::min(coeff, DECIBEL_UPPER);
-					// clamp to [0 1]
-					coeff =
-						1.0 / (DECIBEL_UPPER - DECIBEL_LOWER) * coeff + DECIBEL_LOWER / (DECIBEL_LOWER - DECIBEL_UPPER);
-				} else {
-					// Limit the boundaries
-					coeff = std::max(coeff, m_dMin);
-					coeff = std::min(coeff, m_dMax);
-					// clamp to [0 1]
-					coeff = (coeff - m_dMin) / (m_dMax - m_dMin);
-				}
-				// store value in array
-				pIRWarpArray->InsertNextTuple1(coeff);
-			}
-		}
-	}
+	CarpetTimeAxis oTimeAxis = getCarpetTimeAxis(m_pContentIR, m_iFirstSample, m_iNumSamples, m_iTimeResolution);
+	CarpetPlotScalarJob oJob = {m_pContentIR, m_iFixedAngle, m_fAngle, m_iChannel, m_iScaling, m_dMin, m_dMax,
+								oTimeAxis, NULL};
+	vtkSmartPointer<vtkFloatArray> pIRWarpArray = createCarpetScalars(oJob);
 
 	// Assign scalars to points
 	m_pCarpetPolyData->GetPointData()->SetScalars(pIRWarpArray);
@@ -480,11 +811,7 @@ void CarpetPlot::SetScalars()
 
 double CarpetPlot::factor2decibel(double x) const
 {
-	assert(x >= 0);
-	// Lower boundary is -100 dB
-	if (x <= 0.0000000001)
-		return -100;
-	return 10 * log(x) / log((double)10);
+	return factorToDecibel(x);
 }
 
 double CarpetPlot::decibel2factor(double x) const
@@ -505,7 +832,7 @@ void CarpetPlot::SetDisplayMode(int iMode)
 void CarpetPlot::SetChannel(int iChannel)
 {
 	m_iChannel = iChannel;
-	SetScalars();
+	SetDirty();
 }
 
 int CarpetPlot::GetChannel()
@@ -1,5 +1,6 @@
 #include <daffviz/DAFFViz.h>
 #include <daffviz/DAFFVizCartesianCoordinateAssistant.h>
+#include <daffviz/DAFFVizGeometryCache.h>
 #include <daffviz/DAFFVizGlobalLock.h>
 
 #include <sstream>
@@ -17,7 +18,6 @@
 #include <vtkPolyLine.h>
 #include <vtkPolygon.h>
 #include <vtkProperty.h>
-#include <vtkVectorText.h>
 
 namespace DAFFViz {
 
@@ -137,7 +137,7 @@ void CartesianCoordinateAssistant::UpdateAxes()
 
 void CartesianCoordinateAssistant::UpdateGrid()
 {
-	// TODO: is it sufficient to delete the actor or do i have to delete polyline/cells/polydata as well?
+	// The smart pointers release the tick data, the label texts are shared with the cache
 	bool bWasVisible = GetGridVisible();
 	for (int i = 0; i < (int)m_pGrid.size(); i++) {
 		RemoveActor(m_pGrid.at(i));
@@ -154,7 +154,6 @@ void CartesianCoordinateAssistant::UpdateGrid()
 	vtkSmartPointer<vtkActor> actor;
 	vtkSmartPointer<vtkPolyDataMapper> mapper;
 	vtkSmartPointer<vtkLine> line;
-	vtkSmartPointer<vtkVectorText> pLabel;
 
 	// X-Axe
 	double min = ceil(m_dMinX / m_dResolutionX) * m_dResolutionX;   // inner gridline
@@ -178,10 +177,7 @@ void CartesianCoordinateAssistant::UpdateGrid()
 		// label
 		std::ostringstream s;
 		s << f;
-		pLabel = vtkSmartPointer<vtkVectorText>::New();
-		pLabel->SetText(s.str().c_str());
-		mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-		mapper->SetInputConnection(pLabel->GetOutputPort());
+		mapper = GeometryCache::GetMapper(GeometryCache::GetText(s.str()));
 
 		actor = vtkSmartPointer<vtkActor>::New();  // vtkFollower::New();
 		actor->SetMapper(mapper);
@@ -233,10 +229,7 @@ void CartesianCoordinateAssistant::UpdateGrid()
 		// label
 		std::ostringstream s;
 		s << f;
-		pLabel = vtkSmartPointer<vtkVectorText>::New();
-		pLabel->SetText(s.str().c_str());
-		mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-		mapper->SetInputConnection(pLabel->GetOutputPort());
+		mapper = GeometryCache::GetMapper(GeometryCache::GetText(s.str()));
 
 		actor = vtkSmartPointer<vtkActor>::New();  // vtkFollower::New();
 		actor->SetMapper(mapper);
@@ -288,10 +281,7 @@ void CartesianCoordinateAssistant::UpdateGrid()
 		// label
 		std::ostringstream s;
 		s << f;
-		pLabel = vtkSmartPointer<vtkVectorText>::New();
-		pLabel->SetText(s.str().c_str());
-		mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-		mapper->SetInputConnection(pLabel->GetOutputPort());
+		mapper = GeometryCache::GetMapper(GeometryCache::GetText(s.str()));
 
 		actor = vtkSmartPointer<vtkActor>::New();  // vtkFollower::New();
 		actor->SetMapper(mapper);
@@ -0,0 +1,224 @@
+#include <daffviz/DAFFVizGeometryCache.h>
+
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+#include <vtkCellArray.h>
+#include <vtkLine.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkPolyLine.h>
+#include <vtkSphereSource.h>
+#include <vtkVectorText.h>
+
+namespace DAFFViz {
+
+static const double PI_D = std::acos(-1.0);
+
+typedef std::map<std::string, vtkSmartPointer<vtkPolyData> > GeometryMap;
+typedef std::map<vtkPolyData*, vtkSmartPointer<vtkPolyDataMapper> > MapperMap;
+
+static std::mutex g_oGeometryCacheMutex;
+static GeometryMap g_mGeometries;
+static MapperMap g_mMappers;
+
+// Key of a parameter set (full double precision, so that different parameters never collide)
+static std::string makeKey(const char* pszType, double d1, double d2 = 0, double d3 = 0)
+{
+	std::ostringstream ss;
+	ss.precision(17);
+	ss << pszType << ":" << d1 << ":" << d2 << ":" << d3;
+	return ss.str();
+}
+
+// Unconnected polyline through the points
+static vtkSmartPointer<vtkPolyData> makePolyline(vtkSmartPointer<vtkPoints> pPoints)
+{
+	int iNumPoints = (int)pPoints->GetNumberOfPoints();
+	vtkSmartPointer<vtkPolyLine> pPolyline = vtkSmartPointer<vtkPolyLine>::New();
+	pPolyline->GetPointIds()->SetNumberOfIds(iNumPoints);
+	for (int i = 0; i < iNumPoints; i++)
+		pPolyline->GetPointIds()->SetId(i, i);
+
+	vtkSmartPointer<vtkCellArray> pCells = vtkSmartPointer<vtkCellArray>::New();
+	pCells->InsertNextCell(pPolyline);
+
+	vtkSmartPointer<vtkPolyData> pData = vtkSmartPointer<vtkPolyData>::New();
+	pData->SetPoints(pPoints);
+	pData->SetLines(pCells);
+	return pData;
+}
+
+// Looks up a cached data set (the mutex must be held)
+static vtkSmartPointer<vtkPolyData> lookup(const std::string& sKey)
+{
+	GeometryMap::const_iterator cit = g_mGeometries.find(sKey);
+	return (cit != g_mGeometries.end()) ? cit->second : vtkSmartPointer<vtkPolyData>();
+}
+
+vtkSmartPointer<vtkPolyData> GeometryCache::GetSphere(double dRadius, int iPhiResolution, int iThetaResolution)
+{
+	std::string sKey = makeKey("sphere", dRadius, iPhiResolution, iThetaResolution);
+	std::lock_guard<std::mutex> oLock(g_oGeometryCacheMutex);
+	vtkSmartPointer<vtkPolyData> pData = lookup(sKey);
+	if (pData)
+		return pData;
+
+	vtkSmartPointer<vtkSphereSource> pSource = vtkSmartPointer<vtkSphereSource>::New();
+	pSource->SetRadius(dRadius);
+	pSource->SetPhiResolution(iPhiResolution);
+	pSource->SetThetaResolution(iThetaResolution);
+	pSource->Update();
+
+	// Detach the output from the source pipeline
+	pData = vtkSmartPointer<vtkPolyData>::New();
+	pData->ShallowCopy(pSource->GetOutput());
+
+	g_mGeometries[sKey] = pData;
+	return pData;
+}
+
+vtkSmartPointer<vtkPolyData> GeometryCache::GetCircle(double dRadius, int iNumPoints)
+{
+	std::string sKey = makeKey("circle", dRadius, iNumPoints);
+	std::lock_guard<std::mutex> oLock(g_oGeometryCacheMutex);
+	vtkSmartPointer<vtkPolyData> pData = lookup(sKey);
+	if (pData)
+		return pData;
+
+	vtkSmartPointer<vtkPoints> pPoints = vtkSmartPointer<vtkPoints>::New();
+	pPoints->SetNumberOfPoints(iNumPoints);
+	for (int i = 0; i < iNumPoints; i++) {
+		// The last point closes the circle
+		double dAngleRad = (iNumPoints > 1) ? i * 2 * PI_D / (iNumPoints - 1) : 0;
+		pPoints->SetPoint(i, sin(dAngleRad) * dRadius, 0, -cos(dAngleRad) * dRadius);
+	}
+
+	pData = makePolyline(pPoints);
+	g_mGeometries[sKey] = pData;
+	return pData;
+}
+
+vtkSmartPointer<vtkPolyData> GeometryCache::GetMeridian(double dAzimuthDeg, int iResolution)
+{
+	std::string sKey = makeKey("meridian", dAzimuthDeg, iResolution);
+	std::lock_guard<std::mutex> oLock(g_oGeometryCacheMutex);
+	vtkSmartPointer<vtkPolyData> pData = lookup(sKey);
+	if (pData)
+		return pData;
+
+	double dAzimuthRad = dAzimuthDeg * PI_D / 180.0;
+	double dSinAzimuth = sin(dAzimuthRad);
+	double dCosAzimuth = cos(dAzimuthRad);
+
+	vtkSmartPointer<vtkPoints> pPoints = vtkSmartPointer<vtkPoints>::New();
+	pPoints->SetNumberOfPoints(iResolution + 1);
+	for (int i = 0; i < iResolution + 1; i++) {
+		double dAngleRad = i * PI_D / iResolution;
+		pPoints->SetPoint(i, dSinAzimuth * sin(dAngleRad), -cos(dAngleRad), dCosAzimuth * sin(dAngleRad));
+	}
+
+	pData = makePolyline(pPoints);
+	g_mGeometries[sKey] = pData;
+	return pData;
+}
+
+vtkSmartPointer<vtkPolyData> GeometryCache::GetGrid(int iCellsX, int iCellsZ)
+{
+	std::string sKey = makeKey("grid", iCellsX, iCellsZ);
+	std::lock_guard<std::mutex> oLock(g_oGeometryCacheMutex);
+	vtkSmartPointer<vtkPolyData> pData = lookup(sKey);
+	if (pData)
+		return pData;
+
+	vtkSmartPointer<vtkPoints> pPoints = vtkSmartPointer<vtkPoints>::New();
+	vtkSmartPointer<vtkCellArray> pCells = vtkSmartPointer<vtkCellArray>::New();
+	vtkSmartPointer<vtkLine> pLine = vtkSmartPointer<vtkLine>::New();
+
+	// X direction lines
+	int k = 0;
+	for (int i = 0; i <= iCellsX; i++) {
+		pPoints->InsertPoint(k++, i / (double)iCellsX, 0, 0);
+		pPoints->InsertPoint(k++, i / (double)iCellsX, 0, 1);
+		pLine->GetPointIds()->SetId(0, k - 2);
+		pLine->GetPointIds()->SetId(1, k - 1);
+		pCells->InsertNextCell(pLine);
+	}
+
+	// Z direction lines
+	for (int i = 0; i <= iCellsZ; i++) {
+		pPoints->InsertPoint(k++, 0, 0, i / (double)iCellsZ);
+		pPoints->InsertPoint(k++, 1, 0, i / (double)iCellsZ);
+		pLine->GetPointIds()->SetId(0, k - 2);
+		pLine->GetPointIds()->SetId(1, k - 1);
+		pCells->InsertNextCell(pLine);
+	}
+
+	pData = vtkSmartPointer<vtkPolyData>::New();
+	pData->SetPoints(pPoints);
+	pData->SetLines(pCells);
+
+	g_mGeometries[sKey] = pData;
+	return pData;
+}
+
+vtkSmartPointer<vtkPolyData> GeometryCache::GetText(const std::string& sText)
+{
+	std::string sKey = "text:" + sText;
+	std::lock_guard<std::mutex> oLock(g_oGeometryCacheMutex);
+	vtkSmartPointer<vtkPolyData> pData = lookup(sKey);
+	if (pData)
+		return pData;
+
+	vtkSmartPointer<vtkVectorText> pText = vtkSmartPointer<vtkVectorText>::New();
+	pText->SetText(sText.c_str());
+	pText->Update();
+
+	pData = vtkSmartPointer<vtkPolyData>::New();
+	pData->ShallowCopy(pText->GetOutput());
+
+	g_mGeometries[sKey] = pData;
+	return pData;
+}
+
+vtkSmartPointer<vtkPolyDataMapper> GeometryCache::GetMapper(vtkPolyData* pData)
+{
+	std::lock_guard<std::mutex> oLock(g_oGeometryCacheMutex);
+	MapperMap::const_iterator cit = g_mMappers.find(pData);
+	if (cit != g_mMappers.end())
+		return cit->second;
+
+	// The mapper references its input, which keeps the key valid
+	vtkSmartPointer<vtkPolyDataMapper> pMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+	pMapper->SetInputData(pData);
+	g_mMappers[pData] = pMapper;
+	return pMapper;
+}
+
+void GeometryCache::Clear()
+{
+	std::lock_guard<std::mutex> oLock(g_oGeometryCacheMutex);
+	g_mMappers.clear();
+	g_mGeometries.clear();
+}
+
+int GeometryCache::GetNumEntries()
+{
+	std::lock_guard<std::mutex> oLock(g_oGeometryCacheMutex);
+	return (int)g_mGeometries.size();
+}
+
+size_t GeometryCache::GetMemoryFootprint()
+{
+	// VTK reports the data object sizes in KiB
+	std::lock_guard<std::mutex> oLock(g_oGeometryCacheMutex);
+	size_t nBytes = 0;
+	for (GeometryMap::const_iterator cit = g_mGeometries.begin(); cit != g_mGeometries.end(); ++cit)
+		nBytes += (size_t)cit->second->GetActualMemorySize() * 1024;
+	return nBytes;
+}
+
+}  // namespace DAFFViz
@@ -1,16 +1,11 @@
+#include <daffviz/DAFFVizGeometryCache.h>
 #include <daffviz/DAFFVizGlobalLock.h>
 #include <daffviz/DAFFVizGrid.h>
 
 #include <vtkActor.h>
-#include <vtkCellArray.h>
-#include <vtkDataSetMapper.h>
-#include <vtkLine.h>
-#include <vtkPoints.h>
 #include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
-#include <vtkPolygon.h>
 #include <vtkProperty.h>
-#include <vtkUnstructuredGrid.h>
 
 namespace DAFFViz {
 
@@ -44,43 +39,9 @@ Grid::~Grid()
 
 void Grid::init()
 {
-	// Points
-	vtkSmartPointer<vtkPoints> pGridPoints = vtkSmartPointer<vtkPoints>::New();
-
-	// Grids
-	vtkSmartPointer<vtkUnstructuredGrid> pGrid = vtkSmartPointer<vtkUnstructuredGrid>::New();
-
-	pGrid->SetPoints(pGridPoints);
-	pGrid->Allocate(m_iCellsX + m_iCellsZ + 2, 1);
-
-	// Helper
-	vtkSmartPointer<vtkLine> pLine = vtkSmartPointer<vtkLine>::New();
-
-	// Create grid
-	int k = 0;
-	int subk = 0;
-
-	// X direction lines
-	for (int i = 0; i <= m_iCellsX; i++) {
-		pGridPoints->InsertPoint(k++, i / (double)m_iCellsX, 0, 0);
-		pGridPoints->InsertPoint(k++, i / (double)m_iCellsX, 0, 1);
-		pLine->GetPointIds()->SetId(0, k - 2);
-		pLine->GetPointIds()->SetId(1, k - 1);
-		pGrid->InsertNextCell(pLine->GetCellType(), pLine->GetPointIds());
-	}
-
-	// Z direction lines
-	for (int i = 0; i <= m_iCellsZ; i++) {
-		pGridPoints->InsertPoint(k++, 0, 0, i / (double)m_iCellsZ);
-		pGridPoints->InsertPoint(k++, 1, 0, i / (double)m_iCellsZ);
-		pLine->GetPointIds()->SetId(0, k - 2);
-		pLine->GetPointIds()->SetId(1, k - 1);
-		pGrid->InsertNextCell(pLine->GetCellType(), pLine->GetPointIds());
-	}
-
-	// Grid actor
-	vtkSmartPointer<vtkDataSetMapper> pGridMapper = vtkSmartPointer<vtkDataSetMapper>::New();
-	pGridMapper->SetInputData(pGrid);
+	// Grid actor (the lines are shared with all grids of the same cells)
+	vtkSmartPointer<vtkPolyData> pGrid = GeometryCache::GetGrid(m_iCellsX, m_iCellsZ);
+	vtkSmartPointer<vtkPolyDataMapper> pGridMapper = GeometryCache::GetMapper(pGrid);
 
 	m_pActorGrid = vtkSmartPointer<vtkActor>::New();
 	m_pActorGrid->SetMapper(pGridMapper);
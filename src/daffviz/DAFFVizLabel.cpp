@@ -1,11 +1,12 @@
+#include <daffviz/DAFFVizGeometryCache.h>
 #include <daffviz/DAFFVizGlobalLock.h>
 #include <daffviz/DAFFVizLabel.h>
 
 #include <vtkCamera.h>
 #include <vtkFollower.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkProperty.h>
-#include <vtkVectorText.h>
 
 namespace DAFFViz {
 
@@ -35,11 +36,7 @@ Label::~Label()
 
 void Label::init()
 {
-	m_pLabelText = vtkSmartPointer<vtkVectorText>::New();
-	m_pLabelText->SetText(m_sText.c_str());
-
-	m_pMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-	m_pMapper->SetInputConnection(m_pLabelText->GetOutputPort());
+	m_pMapper = GeometryCache::GetMapper(GeometryCache::GetText(m_sText));
 
 	m_pFollower = vtkSmartPointer<vtkFollower>::New();
 	m_pFollower->SetMapper(m_pMapper);
@@ -97,11 +94,19 @@ bool Label::IsVisible() const
 
 void Label::SetText(const std::string& s)
 {
+	m_sText = s;
+	m_pMapper = GeometryCache::GetMapper(GeometryCache::GetText(m_sText));
+
 	DAFFVIZ_LOCK_VTK;
-	m_pLabelText->SetText(s.c_str());
+	m_pFollower->SetMapper(m_pMapper);
 	DAFFVIZ_UNLOCK_VTK;
 }
 
+std::string Label::GetText() const
+{
+	return m_sText;
+}
+
 void Label::OnSetFollowerCamera(vtkSmartPointer<vtkCamera> pCamera)
 {
 	// DAFFVIZ_LOCK_VTK;
@@ -15,7 +15,7 @@
 #include <vtkTransform.h>
 
 namespace DAFFViz {
-SGNode::SGNode(DAFFViz::SGNode* pParentNode) : m_pParentNode(NULL)
+SGNode::SGNode(DAFFViz::SGNode* pParentNode) : m_pParentNode(NULL), m_bDirty(false), m_bSubtreeDirty(false)
 {
 	m_pNodeAssembly = vtkSmartPointer<vtkAssembly>::New();
 
@@ -160,6 +160,11 @@ bool SGNode::AddChildNode(DAFFViz::SGNode* pChild)
 	m_pNodeAssembly->AddPart(pChild->m_pNodeAssembly);
 	DAFFVIZ_UNLOCK_VTK;
 
+	// Pending changes of the subtree are applied from the new root on
+	if (pChild->m_bSubtreeDirty)
+		for (SGNode* pNode = this; pNode && !pNode->m_bSubtreeDirty; pNode = pNode->m_pParentNode)
+			pNode->m_bSubtreeDirty = true;
+
 	return true;
 }
 
@@ -200,6 +205,21 @@ bool SGNode::RemoveChildNodes(const std::vector<DAFFViz::SGNode*>& vpChildren)
 	return bResult;
 }
 
+size_t SGNode::GetMemoryFootprint() const
+{
+	size_t nBytes = 0;
+	for (std::vector<DAFFViz::SGNode*>::const_iterator cit = m_vpChildNodes.begin(); cit != m_vpChildNodes.end(); ++cit)
+		nBytes += (*cit)->GetMemoryFootprint();
+	return nBytes;
+}
+
+void SGNode::GetWorldMatrix(vtkMatrix4x4* pMatrix) const
+{
+	pMatrix->DeepCopy(m_pNodeAssembly->GetMatrix());
+	for (const DAFFViz::SGNode* pNode = m_pParentNode; pNode != NULL; pNode = pNode->m_pParentNode)
+		vtkMatrix4x4::Multiply4x4(pNode->m_pNodeAssembly->GetMatrix(), pMatrix, pMatrix);
+}
+
 void SGNode::GetPosition(double& x, double& y, double& z) const
 {
 	double* data = m_pNodeAssembly->GetPosition();
@@ -498,6 +518,39 @@ void SGNode::SetVisible(bool bVisible)
 	DAFFVIZ_UNLOCK_VTK;
 }
 
+void SGNode::Update()
+{
+	if (!m_bSubtreeDirty)
+		return;
+
+	// Flags are reset first, so that nodes may mark themselves dirty again for the next update
+	m_bSubtreeDirty = false;
+	if (m_bDirty) {
+		m_bDirty = false;
+		OnUpdate();
+	}
+
+	for (std::vector<SGNode*>::const_iterator cit = m_vpChildNodes.begin(); cit != m_vpChildNodes.end(); ++cit)
+		(*cit)->Update();
+}
+
+bool SGNode::IsDirty() const
+{
+	return m_bSubtreeDirty;
+}
+
+void SGNode::SetDirty()
+{
+	m_bDirty = true;
+
+	// Mark the path to the root, up to the first node that is already marked
+	m_bSubtreeDirty = true;
+	for (SGNode* pNode = m_pParentNode; pNode && !pNode->m_bSubtreeDirty; pNode = pNode->m_pParentNode)
+		pNode->m_bSubtreeDirty = true;
+}
+
+void SGNode::OnUpdate() {}
+
 void SGNode::AddActor(vtkSmartPointer<vtkActor> pActor)
 {
 	assert(pActor != NULL);
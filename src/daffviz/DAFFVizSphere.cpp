@@ -1,38 +1,33 @@
+#include <daffviz/DAFFVizGeometryCache.h>
 #include <daffviz/DAFFVizGlobalLock.h>
 #include <daffviz/DAFFVizSphere.h>
 
 #include <vtkActor.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkProperty.h>
-#include <vtkSphereSource.h>
-
-#include "vtkPolyDataNormals.h"
 
 namespace DAFFViz {
 
-Sphere::Sphere() : SGNode(), m_pSource(NULL), m_pMapper(NULL), m_pActor(NULL)
+// Defaults of vtkSphereSource
+Sphere::Sphere()
+	: SGNode(), m_pMapper(NULL), m_pActor(NULL), m_dRadius(0.5), m_iPhiResolution(8), m_iThetaResolution(8)
 {
 	init();
 }
 
 Sphere::Sphere(double dRadius, int iPhiResolution, int iThetaResolution)
-	: SGNode(), m_pSource(NULL), m_pMapper(NULL), m_pActor(NULL)
+	: SGNode(), m_pMapper(NULL), m_pActor(NULL), m_dRadius(dRadius), m_iPhiResolution(iPhiResolution),
+	  m_iThetaResolution(iThetaResolution)
 {
 	init();
-	m_pSource->SetRadius(dRadius);
-	m_pSource->SetPhiResolution(iPhiResolution);
-	m_pSource->SetThetaResolution(iThetaResolution);
-	m_pSource->Update();
 }
 
 Sphere::Sphere(DAFFViz::SGNode* pParentNode, double dRadius, int iPhiResolution, int iThetaResolution)
-	: SGNode(pParentNode), m_pSource(NULL), m_pMapper(NULL), m_pActor(NULL)
+	: SGNode(pParentNode), m_pMapper(NULL), m_pActor(NULL), m_dRadius(dRadius), m_iPhiResolution(iPhiResolution),
+	  m_iThetaResolution(iThetaResolution)
 {
 	init();
-	m_pSource->SetRadius(dRadius);
-	m_pSource->SetPhiResolution(iPhiResolution);
-	m_pSource->SetThetaResolution(iThetaResolution);
-	m_pSource->Update();
 }
 
 Sphere::~Sphere()
@@ -42,13 +37,8 @@ Sphere::~Sphere()
 
 void Sphere::init()
 {
-	m_pSource = vtkSmartPointer<vtkSphereSource>::New();
-
-	m_pMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-	m_pMapper->SetInputConnection(m_pSource->GetOutputPort());
-
 	m_pActor = vtkSmartPointer<vtkActor>::New();
-	m_pActor->SetMapper(m_pMapper);
+	UpdateGeometry();
 
 	m_pActor->GetProperty()->SetDiffuse(0.9);
 	m_pActor->GetProperty()->SetAmbient(0.4);
@@ -56,37 +46,49 @@ void Sphere::init()
 	AddActor(m_pActor);
 }
 
+void Sphere::UpdateGeometry()
+{
+	m_pMapper = GeometryCache::GetMapper(GeometryCache::GetSphere(m_dRadius, m_iPhiResolution, m_iThetaResolution));
+
+	DAFFVIZ_LOCK_VTK;
+	m_pActor->SetMapper(m_pMapper);
+	DAFFVIZ_UNLOCK_VTK;
+}
+
 
 // --= object related methods =--
 
 double Sphere::GetRadius() const
 {
-	return m_pSource->GetRadius();
+	return m_dRadius;
 }
 
 void Sphere::SetRadius(double dRadius)
 {
-	m_pSource->SetRadius(dRadius);
+	m_dRadius = dRadius;
+	UpdateGeometry();
 }
 
 void Sphere::SetPhiResolution(int iResolution)
 {
-	m_pSource->SetPhiResolution(iResolution);
+	m_iPhiResolution = iResolution;
+	UpdateGeometry();
 }
 
 void Sphere::SetThetaResolution(int iResolution)
 {
-	m_pSource->SetThetaResolution(iResolution);
+	m_iThetaResolution = iResolution;
+	UpdateGeometry();
 }
 
 int Sphere::GetPhiResolution() const
 {
-	return m_pSource->GetPhiResolution();
+	return m_iPhiResolution;
 }
 
 int Sphere::GetThetaResolution() const
 {
-	return m_pSource->GetThetaResolution();
+	return m_iThetaResolution;
 }
 
 
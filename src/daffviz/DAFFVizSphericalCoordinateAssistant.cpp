@@ -1,4 +1,5 @@
 #include <daffviz/DAFFViz.h>
+#include <daffviz/DAFFVizGeometryCache.h>
 #include <daffviz/DAFFVizGlobalLock.h>
 #include <daffviz/DAFFVizSphericalCoordinateAssistant.h>
 
@@ -18,7 +19,6 @@
 #include <vtkProperty.h>
 #include <vtkSmartPointer.h>
 #include <vtkSphereSource.h>
-#include <vtkVectorText.h>
 
 namespace DAFFViz {
 static float PI_F = std::acos(-1.0f);
@@ -58,124 +58,23 @@ void SphericalCoordinateAssistant::init()
 	sphereaxis->SetColor(0.5, 0.5, 0.5);
 	sphereaxis->SetAlpha(0.9);
 
-	// Meridians and Equator
+	// Meridians and Equator (shared geometry)
 	int res = 18 * 3;
 
-	vtkSmartPointer<vtkPoints> prime_meridian = vtkSmartPointer<vtkPoints>::New();
-	vtkSmartPointer<vtkPoints> meridian90 = vtkSmartPointer<vtkPoints>::New();
-	vtkSmartPointer<vtkPoints> meridian180 = vtkSmartPointer<vtkPoints>::New();
-	vtkSmartPointer<vtkPoints> meridian270 = vtkSmartPointer<vtkPoints>::New();
-
-	prime_meridian->SetNumberOfPoints(res + 1);
-	meridian90->SetNumberOfPoints(res + 1);
-	meridian180->SetNumberOfPoints(res + 1);
-	meridian270->SetNumberOfPoints(res + 1);
+	// Prime meridian and the 90, 180 and 270 degree meridians
+	for (int i = 0; i < 4; i++) {
+		vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+		actor->SetMapper(GeometryCache::GetMapper(GeometryCache::GetMeridian(i * 90.0, res)));
 
-	vtkSmartPointer<vtkPolyLine> polyline = vtkSmartPointer<vtkPolyLine>::New();
-	polyline->GetPointIds()->SetNumberOfIds(res + 1);
+		actor->GetProperty()->SetOpacity(i == 0 ? 0.4 : 0.2);
 
-	float fAngleRad;
-	for (int i = 0; i < res + 1; i++) {
-		fAngleRad = i * PI_F / res;
-		prime_meridian->InsertPoint(i, 0, -cos(fAngleRad), sin(fAngleRad));
-		meridian90->InsertPoint(i, sin(fAngleRad), -cos(fAngleRad), 0);
-		meridian180->InsertPoint(i, 0, -cos(fAngleRad), -sin(fAngleRad));
-		meridian270->InsertPoint(i, -sin(fAngleRad), -cos(fAngleRad), 0);
-		polyline->GetPointIds()->SetId(i, i);
+		AddActor(actor);
+		m_pMeridians.push_back(actor);
 	}
 
-	// Prime meridian
-	vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
-	cells->InsertNextCell(polyline);
-
-	vtkSmartPointer<vtkPolyData> polydata = vtkSmartPointer<vtkPolyData>::New();
-	polydata->SetPoints(prime_meridian);
-	polydata->SetLines(cells);
-
-	vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-	mapper->SetInputData(polydata);
-
-	vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
-	actor->SetMapper(mapper);
-
-	actor->GetProperty()->SetOpacity(0.4);
-
-	AddActor(actor);
-	m_pMeridians.push_back(actor);
-
-	// 90 degree meridian
-	polydata = vtkSmartPointer<vtkPolyData>::New();
-	polydata->SetPoints(meridian90);
-	polydata->SetLines(cells);
-
-	mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-	mapper->SetInputData(polydata);
-
-	actor = vtkSmartPointer<vtkActor>::New();
-	actor->SetMapper(mapper);
-
-	actor->GetProperty()->SetOpacity(0.2);
-
-	AddActor(actor);
-	m_pMeridians.push_back(actor);
-
-	// 180 degree meridian
-	polydata = vtkSmartPointer<vtkPolyData>::New();
-	polydata->SetPoints(meridian180);
-	polydata->SetLines(cells);
-
-	mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-	mapper->SetInputData(polydata);
-
-	actor = vtkSmartPointer<vtkActor>::New();
-	actor->SetMapper(mapper);
-
-	actor->GetProperty()->SetOpacity(0.2);
-
-	AddActor(actor);
-	m_pMeridians.push_back(actor);
-
-	// 270 degree meridian
-	polydata = vtkSmartPointer<vtkPolyData>::New();
-	polydata->SetPoints(meridian270);
-	polydata->SetLines(cells);
-
-	mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-	mapper->SetInputData(polydata);
-
-	actor = vtkSmartPointer<vtkActor>::New();
-	actor->SetMapper(mapper);
-
-	actor->GetProperty()->SetOpacity(0.2);
-
-	AddActor(actor);
-	m_pMeridians.push_back(actor);
-
 	// Equator
-	vtkSmartPointer<vtkPoints> equator = vtkSmartPointer<vtkPoints>::New();
-	equator->SetNumberOfPoints(2 * res);
-
-	polyline = vtkSmartPointer<vtkPolyLine>::New();
-	polyline->GetPointIds()->SetNumberOfIds(2 * res);
-
-	for (int i = 0; i < 2 * res; i++) {
-		fAngleRad = i * 2 * PI_F / (2 * res - 1);
-		equator->InsertPoint(i, sin(fAngleRad), 0, -cos(fAngleRad));
-		polyline->GetPointIds()->SetId(i, i);
-	}
-
-	cells = vtkSmartPointer<vtkCellArray>::New();
-	cells->InsertNextCell(polyline);
-
-	polydata = vtkSmartPointer<vtkPolyData>::New();
-	polydata->SetPoints(equator);
-	polydata->SetLines(cells);
-
-	mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-	mapper->SetInputData(polydata);
-
 	m_pEquator = vtkSmartPointer<vtkActor>::New();
-	m_pEquator->SetMapper(mapper);
+	m_pEquator->SetMapper(GeometryCache::GetMapper(GeometryCache::GetCircle(1.0, 2 * res)));
 
 	m_pEquator->GetProperty()->SetOpacity(0.4);
 
@@ -190,7 +89,7 @@ void SphericalCoordinateAssistant::init()
 	m_pSphere->SetPhiResolution(res);
 
 	// Create a mapper and actor
-	mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+	vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
 	mapper->SetInputData(m_pSphere->GetOutput());
 
 	m_pReferenceActor = vtkSmartPointer<vtkActor>::New();
@@ -243,59 +142,33 @@ void SphericalCoordinateAssistant::UpdateGrid()
 	bool bWasVisible = GetGridVisible();
 	int res = 18 * 3;
 	float fAngleRad;
-	// Delete old Grid
-	// TODO: is it sufficient to delete the actor or do i have to delete polyline/cells/polydata as well?
+	// Delete old Grid (the smart pointers release the data, circles and labels are shared with the cache)
 	for (int i = 0; i < (int)m_pGrid.size(); i++) {
 		RemoveActor(m_pGrid.at(i));
-		m_pGrid.at(i)->GetMapper()->GetInput()->Delete();
 	}
 	m_pGrid.clear();
 	for (int i = 0; i < (int)m_pCircles.size(); i++) {
 		RemoveActor(m_pCircles.at(i));
-		m_pCircles.at(i)->GetMapper()->GetInput()->Delete();
 	}
 	m_pCircles.clear();
 	for (int i = 0; i < (int)m_pLabels.size(); i++) {
 		RemoveActor(m_pLabels.at(i));
-		// m_pLabels.at(i)->GetMapper()->GetInput()->Delete();
 	}
 	m_pLabels.clear();
 
 	// create new grid
 	vtkSmartPointer<vtkCellArray> cells;
 	vtkSmartPointer<vtkPolyData> polydata;
-	vtkSmartPointer<vtkPolyLine> polyline;
 	vtkSmartPointer<vtkFollower> actor;
 	vtkSmartPointer<vtkPolyDataMapper> mapper;
-	vtkSmartPointer<vtkVectorText> pLabel;
 
 	double min = ceil(m_dMin / m_dPrecision) * m_dPrecision;   // inner gridline
 	double max = floor(m_dMax / m_dPrecision) * m_dPrecision;  // outter gridline
 	// int gridRes = (max-min)/m_dPrecision; // total number of gridlines
 	for (double f = min; f <= m_dMax; f += m_dPrecision) {
-		vtkSmartPointer<vtkPoints> gridLine = vtkSmartPointer<vtkPoints>::New();
-		gridLine->SetNumberOfPoints(2 * res);
-
-		polyline = vtkSmartPointer<vtkPolyLine>::New();
-		polyline->GetPointIds()->SetNumberOfIds(2 * res);
-
 		double factor = (f - m_dMin) / (m_dMax - m_dMin);
 
-		for (int i = 0; i < 2 * res; i++) {
-			fAngleRad = i * 2 * PI_F / (2 * res - 1);
-			gridLine->InsertPoint(i, sin(fAngleRad) * factor, 0, -cos(fAngleRad) * factor);
-			polyline->GetPointIds()->SetId(i, i);
-		}
-
-		cells = vtkSmartPointer<vtkCellArray>::New();
-		cells->InsertNextCell(polyline);
-
-		polydata = vtkSmartPointer<vtkPolyData>::New();
-		polydata->SetPoints(gridLine);
-		polydata->SetLines(cells);
-
-		mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-		mapper->SetInputData(polydata);
+		mapper = GeometryCache::GetMapper(GeometryCache::GetCircle(factor, 2 * res));
 
 		actor = vtkSmartPointer<vtkFollower>::New();
 		actor->SetMapper(mapper);
@@ -310,13 +183,9 @@ void SphericalCoordinateAssistant::UpdateGrid()
 		m_pCircles.push_back(actor);
 
 		// label
-		pLabel = vtkSmartPointer<vtkVectorText>::New();
 		std::ostringstream s;
 		s << f;
-		pLabel->SetText(s.str().c_str());
-
-		mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-		mapper->SetInputConnection(pLabel->GetOutputPort());
+		mapper = GeometryCache::GetMapper(GeometryCache::GetText(s.str()));
 
 		actor = vtkSmartPointer<vtkFollower>::New();
 		actor->SetMapper(mapper);
@@ -34,18 +34,23 @@ void SphericalDirectionIndicator::SetDirectionDeg(double dPhiDeg, double dThetaD
 {
 	m_dPhiDeg = dPhiDeg;
 	m_dThetaDeg = dThetaDeg;
-	UpdateOrientation();
+	SetDirty();
 }
 
 void SphericalDirectionIndicator::SetDirectionPhiDeg(double dPhiDeg)
 {
 	m_dPhiDeg = dPhiDeg;
-	UpdateOrientation();
+	SetDirty();
 }
 
 void SphericalDirectionIndicator::SetDirectionThetaDeg(double dThetaDeg)
 {
 	m_dThetaDeg = dThetaDeg;
+	SetDirty();
+}
+
+void SphericalDirectionIndicator::OnUpdate()
+{
 	UpdateOrientation();
 }
 
@@ -0,0 +1,156 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016 Institute of Technical Acoustics, RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+// Reproducible synthetic DAFF files and statistics helpers shared by the benchmarks
+
+#ifndef DAFF_BENCHMARK_DATA_
+#define DAFF_BENCHMARK_DATA_
+
+#include <DAFF.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+
+//! Deterministic pseudo-random generator (identical sequences on every platform)
+class Random {
+public:
+	inline Random(unsigned int uiSeed) : m_uiState(uiSeed) {};
+
+	//! Uniform value in [0, 1)
+	inline float next()
+	{
+		m_uiState = m_uiState * 1664525u + 1013904223u;
+		return (float)(m_uiState >> 8) / 16777216.0f;
+	};
+
+	//! Uniform integer in [0, iMax)
+	inline int nextInt(int iMax) { return std::min((int)(next() * iMax), iMax - 1); };
+
+private:
+	unsigned int m_uiState;
+};
+
+//! Configuration of a synthetic file
+struct Config {
+	int iContentType;    //!@ Content type
+	int iQuantization;   //!@ Quantization
+	float fResolution;   //!@ Grid resolution [degrees]
+	int iNumChannels;    //!@ Number of channels
+	int iLength;         //!@ Filter length, number of frequencies or DFT transform size
+	bool bCompression;   //!@ Compressed record data (default: false)
+};
+
+inline const char* QuantizationName(int iQuantization)
+{
+	switch (iQuantization) {
+	case DAFF_INT16: return "int16";
+	case DAFF_INT24: return "int24";
+	case DAFF_FLOAT32: return "float32";
+	case DAFF_FLOAT16: return "float16";
+	case DAFF_BFLOAT16: return "bfloat16";
+	case DAFF_INT16_BFP: return "int16_bfp";
+	}
+	return "unknown";
+}
+
+inline int NumGridPoints(float fResolution, int& iAlphaPoints, int& iBetaPoints)
+{
+	iAlphaPoints = (int)floor(360.0f / fResolution + 0.5f);
+	iBetaPoints = (int)floor(180.0f / fResolution + 0.5f) + 1;
+	return iAlphaPoints * (iBetaPoints - 2) + 2;
+}
+
+//! Writer callback delivering deterministic synthetic record data
+class SyntheticData : public DAFFWriterCallback {
+public:
+	inline SyntheticData(const Config& oConfig, int iElementsPerRecord)
+		: m_oConfig(oConfig), m_iElementsPerRecord(iElementsPerRecord) {};
+
+	int getRecordData(int iRecordIndex, float, float, float** ppfChannelData)
+	{
+		for (int c = 0; c < m_oConfig.iNumChannels; c++) {
+			Random oRandom(7919u * (unsigned int)iRecordIndex + 104729u * (unsigned int)c + 1u);
+			float* pfData = ppfChannelData[c];
+
+			if (m_oConfig.iContentType == DAFF_IMPULSE_RESPONSE) {
+				// Decaying noise, keeps the integer quantizations in range
+				for (int i = 0; i < m_iElementsPerRecord; i++)
+					pfData[i] = 0.9f * (2 * oRandom.next() - 1) * exp(-4.0f * i / m_iElementsPerRecord);
+			} else if (m_oConfig.iContentType == DAFF_MAGNITUDE_SPECTRUM) {
+				for (int i = 0; i < m_iElementsPerRecord; i++)
+					pfData[i] = 0.05f + oRandom.next();
+			} else {
+				// Interleaved complex coefficients, real-valued at DC and Nyquist
+				for (int i = 0; i < m_iElementsPerRecord; i++) {
+					pfData[2 * i + 0] = 2 * oRandom.next() - 1;
+					pfData[2 * i + 1] = 2 * oRandom.next() - 1;
+				}
+				pfData[1] = 0;
+				pfData[2 * m_iElementsPerRecord - 1] = 0;
+			}
+		}
+		return DAFF_NO_ERROR;
+	};
+
+private:
+	Config m_oConfig;          //!@ File configuration
+	int m_iElementsPerRecord;  //!@ Values (complex coefficients for DFT) per channel
+};
+
+inline std::string FileName(const std::string& sDirectory, const Config& oConfig)
+{
+	char buf[256];
+	snprintf(buf, sizeof(buf), "benchmark_%s_%gdeg_%dch_%d_%s%s.daff",
+			 DAFFUtils::StrShortContentType(oConfig.iContentType).c_str(), oConfig.fResolution, oConfig.iNumChannels,
+			 oConfig.iLength, QuantizationName(oConfig.iQuantization), oConfig.bCompression ? "_compressed" : "");
+	return sDirectory.empty() ? std::string(buf) : sDirectory + "/" + buf;
+}
+
+inline int WriteFile(const std::string& sFilePath, const Config& oConfig)
+{
+	DAFFWriter oWriter;
+	int iElementsPerRecord = oConfig.iLength;
+
+	if (oConfig.iContentType == DAFF_IMPULSE_RESPONSE) {
+		oWriter.setImpulseResponses(oConfig.iLength, 44100);
+	} else if (oConfig.iContentType == DAFF_MAGNITUDE_SPECTRUM) {
+		// Logarithmically spaced frequencies from 20 Hz to 20 kHz
+		std::vector<float> vfFrequencies(oConfig.iLength);
+		for (int i = 0; i < oConfig.iLength; i++)
+			vfFrequencies[i] = 20.0f * pow(1000.0f, (float)i / std::max(oConfig.iLength - 1, 1));
+		oWriter.setMagnitudeSpectra(vfFrequencies);
+	} else {
+		oWriter.setDFTSpectra(oConfig.iLength, 44100, true);
+		iElementsPerRecord = oConfig.iLength / 2 + 1;
+	}
+
+	int iAlphaPoints, iBetaPoints;
+	NumGridPoints(oConfig.fResolution, iAlphaPoints, iBetaPoints);
+	oWriter.setNumChannels(oConfig.iNumChannels);
+	oWriter.setQuantization(oConfig.iQuantization);
+	oWriter.setCompression(oConfig.bCompression);
+	oWriter.setGrid(iAlphaPoints, 0, 360, iBetaPoints, 0, 180);
+
+	SyntheticData oData(oConfig, iElementsPerRecord);
+	return oWriter.write(sFilePath, &oData);
+}
+
+inline double Percentile(const std::vector<double>& vdSorted, double dFraction)
+{
+	size_t n = (size_t)floor(dFraction * (vdSorted.size() - 1) + 0.5);
+	return vdSorted[std::min(n, vdSorted.size() - 1)];
+}
+
+#endif  // DAFF_BENCHMARK_DATA_
@@ -0,0 +1,223 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016 Institute of Technical Acoustics, RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+/*
+ * Native baseline of the cross-language binding benchmark
+ *
+ * Writes the workload file (HRIR-like impulse responses, 5 degree grid, 2 channels, 256 taps)
+ * and runs the binding workload directly on the C++ API:
+ *
+ *   open               Open and close the file (-p times)
+ *   nearest_neighbour  Nearest neighbour queries in the object view (-n queries)
+ *   record             Fetches of all channels of a record (-r fetches)
+ *
+ * Every operation runs in the variants the bindings offer: one call per item ('call'),
+ * batch calls over the query pool ('batch') and borrowed record data without copies
+ * ('zerocopy'). The directions and record indices are a pool of 4096 pseudo-random
+ * queries, which every binding driver regenerates with the same generator (see the
+ * Random class of BenchmarkData.h and the drivers in the binding directories).
+ *
+ * The results are written as CSV lines 'binding,operation,variant,calls,ns_per_call,checksum',
+ * the format of all binding drivers. The checksums (sum of the record indices or of the first
+ * coefficient of the fetched records) confirm that the drivers run the same workload.
+ * tests/benchmark/binding_benchmark.py runs the baseline along with the drivers of the
+ * available bindings and reports the per-call overhead of every binding over the baseline.
+ *
+ * Usage: BindingBenchmark [-o file] [-n queries] [-r fetches] [-p opens] [-w] [-q]
+ *
+ *   -o  Workload file (default: benchmark file name in the working directory)
+ *   -n  Number of nearest neighbour queries (default: 1000000)
+ *   -r  Number of record fetches (default: 100000)
+ *   -p  Number of file openings (default: 50)
+ *   -w  Only write the workload file
+ *   -q  Quick run (100000 queries, 10000 fetches, 10 openings)
+ */
+
+#include <DAFF.h>
+
+#include "BenchmarkData.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static const int NUM_QUERIES = 4096;  // Size of the query pool (also the batch size)
+
+//! Query pool, identical in all binding drivers
+struct Queries {
+	std::vector<float> vfAzimuth;    //!@ Object view azimuths [degrees]
+	std::vector<float> vfElevation;  //!@ Object view elevations [degrees]
+	std::vector<int> viRecord;       //!@ Record indices
+
+	Queries(int iNumRecords)
+	{
+		Random oRandom(12345u);
+		for (int i = 0; i < NUM_QUERIES; i++) {
+			vfAzimuth.push_back(360 * oRandom.next() - 180);
+			vfElevation.push_back(180 * oRandom.next() - 90);
+			viRecord.push_back(oRandom.nextInt(iNumRecords));
+		}
+	};
+};
+
+static double ElapsedNs(Clock::time_point t0)
+{
+	return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+}
+
+static void PrintResult(const char* pszOperation, const char* pszVariant, long lCalls, double dNs, double dChecksum)
+{
+	printf("native,%s,%s,%ld,%.2f,%.6f\n", pszOperation, pszVariant, lCalls, dNs / std::max(lCalls, 1L), dChecksum);
+}
+
+static int RunWorkload(const std::string& sFilePath, long lQueries, long lFetches, long lOpens)
+{
+	DAFFReader* pReader = DAFFReader::create();
+
+	Clock::time_point t0 = Clock::now();
+	for (long i = 0; i < lOpens; i++) {
+		int iError = pReader->openFile(sFilePath);
+		if (iError != DAFF_NO_ERROR) {
+			fprintf(stderr, "Error: Reading '%s' failed: %s\n", sFilePath.c_str(), DAFFUtils::StrError(iError).c_str());
+			delete pReader;
+			return iError;
+		}
+		pReader->closeFile();
+	}
+	PrintResult("open", "call", lOpens, ElapsedNs(t0), 0);
+
+	int iError = pReader->openFile(sFilePath);
+	if (iError != DAFF_NO_ERROR) {
+		delete pReader;
+		return iError;
+	}
+
+	const DAFFContentIR* pContent = dynamic_cast<const DAFFContentIR*>(pReader->getContent());
+	int iNumChannels = pContent->getProperties()->getNumberOfChannels();
+	int iFilterLength = pContent->getFilterLength();
+	Queries oQueries(pContent->getProperties()->getNumberOfRecords());
+
+	// Nearest neighbours, one call per direction and batches of the query pool
+	double dChecksum = 0;
+	t0 = Clock::now();
+	for (long i = 0; i < lQueries; i++) {
+		int j = (int)(i & (NUM_QUERIES - 1));
+		int iRecordIndex;
+		pContent->getNearestNeighbour(DAFF_OBJECT_VIEW, oQueries.vfAzimuth[j], oQueries.vfElevation[j], iRecordIndex);
+		dChecksum += iRecordIndex;
+	}
+	PrintResult("nearest_neighbour", "call", lQueries, ElapsedNs(t0), dChecksum);
+
+	std::vector<int> viIndices(NUM_QUERIES);
+	dChecksum = 0;
+	t0 = Clock::now();
+	for (long i = 0; i < lQueries; i += NUM_QUERIES) {
+		int n = (int)std::min((long)NUM_QUERIES, lQueries - i);
+		pContent->getNearestNeighbours(DAFF_OBJECT_VIEW, &oQueries.vfAzimuth[0], &oQueries.vfElevation[0],
+									   &viIndices[0], NULL, n);
+		for (int j = 0; j < n; j++)
+			dChecksum += viIndices[j];
+	}
+	PrintResult("nearest_neighbour", "batch", lQueries, ElapsedNs(t0), dChecksum);
+
+	// Record fetches, all channels into one buffer (like the record arrays of the bindings)
+	std::vector<float> vfRecord((size_t)iNumChannels * iFilterLength);
+	dChecksum = 0;
+	t0 = Clock::now();
+	for (long i = 0; i < lFetches; i++) {
+		int iRecordIndex = oQueries.viRecord[i & (NUM_QUERIES - 1)];
+		for (int c = 0; c < iNumChannels; c++)
+			pContent->getFilterCoeffs(iRecordIndex, c, &vfRecord[(size_t)c * iFilterLength]);
+		dChecksum += vfRecord[0];
+	}
+	PrintResult("record", "call", lFetches, ElapsedNs(t0), dChecksum);
+
+	dChecksum = 0;
+	t0 = Clock::now();
+	for (long i = 0; i < lFetches; i++) {
+		int iRecordIndex = oQueries.viRecord[i & (NUM_QUERIES - 1)];
+		for (int c = 0; c < iNumChannels; c++) {
+			int iOffset, iLength;
+			const float* pfCoeffs = pContent->getEffectiveFilterCoeffsPtr(iRecordIndex, c, iOffset, iLength);
+			if ((c == 0) && pfCoeffs && (iOffset == 0) && (iLength > 0))
+				dChecksum += pfCoeffs[0];
+		}
+	}
+	PrintResult("record", "zerocopy", lFetches, ElapsedNs(t0), dChecksum);
+
+	pReader->closeFile();
+	delete pReader;
+
+	return DAFF_NO_ERROR;
+}
+
+static void PrintUsage()
+{
+	fprintf(stderr, "Usage: BindingBenchmark [-o file] [-n queries] [-r fetches] [-p opens] [-w] [-q]\n");
+}
+
+int main(int argc, char* argv[])
+{
+	// HRIR-like impulse responses, as queried by the applications of the bindings
+	Config oConfig = { DAFF_IMPULSE_RESPONSE, DAFF_FLOAT32, 5, 2, 256, false };
+
+	std::string sFilePath = FileName("", oConfig);
+	long lQueries = 1000000;
+	long lFetches = 100000;
+	long lOpens = 50;
+	bool bWriteOnly = false;
+
+	for (int i = 1; i < argc; i++) {
+		if ((strcmp(argv[i], "-o") == 0) && (i + 1 < argc))
+			sFilePath = argv[++i];
+		else if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+			lQueries = atol(argv[++i]);
+		else if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+			lFetches = atol(argv[++i]);
+		else if ((strcmp(argv[i], "-p") == 0) && (i + 1 < argc))
+			lOpens = atol(argv[++i]);
+		else if (strcmp(argv[i], "-w") == 0)
+			bWriteOnly = true;
+		else if (strcmp(argv[i], "-q") == 0) {
+			lQueries = 100000;
+			lFetches = 10000;
+			lOpens = 10;
+		} else {
+			PrintUsage();
+			return 255;
+		}
+	}
+
+	if ((lQueries < 0) || (lFetches < 0) || (lOpens < 1)) {
+		PrintUsage();
+		return 255;
+	}
+
+	int iError = WriteFile(sFilePath, oConfig);
+	if (iError != DAFF_NO_ERROR) {
+		fprintf(stderr, "Error: Writing '%s' failed: %s\n", sFilePath.c_str(), DAFFUtils::StrError(iError).c_str());
+		return 255;
+	}
+
+	if (bWriteOnly)
+		return 0;
+
+	printf("binding,operation,variant,calls,ns_per_call,checksum\n");
+	return (RunWorkload(sFilePath, lQueries, lFetches, lOpens) == DAFF_NO_ERROR) ? 0 : 255;
+}
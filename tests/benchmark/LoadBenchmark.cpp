@@ -0,0 +1,335 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016 Institute of Technical Acoustics, RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+/*
+ * Open/load-time benchmark with a breakdown into the load phases (see DAFFLoadStats)
+ *
+ * Every file of the corpus is opened in several modes (default, mapped, lazy, decode and
+ * borrowed deserialization of a buffer). The first open of a mode is cold: On Linux the
+ * file is evicted from the page cache before (posix_fadvise), on other platforms it is
+ * only the first open in the process. It is followed by warm opens, of which the
+ * medians of the phase times are reported. Without file arguments, a synthetic corpus
+ * is generated.
+ *
+ * Usage: LoadBenchmark [-f text|csv|json] [-n warm runs] [-d directory] [-k] [files...]
+ *
+ *   -f  Output format (default: text)
+ *   -n  Number of warm opens per file and mode (default: 20)
+ *   -d  Directory for the generated files (default: working directory)
+ *   -k  Keep the generated files
+ */
+
+#include <DAFF.h>
+
+#include "BenchmarkData.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+//! Open mode of a benchmark run
+struct Mode {
+	const char* pszName;  //!@ Name of the mode
+	int iOpenFlags;       //!@ Open flags (see DAFF_OPEN_FLAGS)
+	bool bMemory;         //!@ Deserialize a buffer holding the file (borrowed) instead of opening it
+};
+
+static const Mode g_aModes[] = {
+	{ "default", DAFF_OPEN_DEFAULT, false }, { "mapped", DAFF_OPEN_MAPPED, false },
+	{ "lazy", DAFF_OPEN_LAZY, false },       { "decode", DAFF_OPEN_DECODE, false },
+	{ "memory", DAFF_OPEN_DEFAULT, true },
+};
+
+//! Result of the cold or warm opens of a file in a mode
+struct Result {
+	std::string sFile;     //!@ File path
+	std::string sMode;     //!@ Open mode
+	bool bCold;            //!@ Cold open (single run)
+	bool bEvicted;         //!@ File has been evicted from the page cache before the cold open
+	int iRuns;             //!@ Number of runs
+	uint64_t ui64Size;     //!@ File size [Bytes]
+	DAFFLoadStats oStats;  //!@ Load statistics (medians of the phases for warm opens)
+};
+
+//! Drops the file from the page cache (returns false if not supported)
+static bool EvictFile(const std::string& sFilePath)
+{
+#if defined(__linux__) && defined(POSIX_FADV_DONTNEED)
+	int fd = open(sFilePath.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	// Dirty pages (e.g. of a just written file) can not be dropped
+	fdatasync(fd);
+	bool bEvicted = (posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0);
+	close(fd);
+	return bEvicted;
+#else
+	(void)sFilePath;
+	return false;
+#endif
+}
+
+static bool ReadFile(const std::string& sFilePath, std::vector<char>& vcBuffer)
+{
+	FILE* pFile = fopen(sFilePath.c_str(), "rb");
+	if (pFile == NULL)
+		return false;
+
+	fseek(pFile, 0, SEEK_END);
+	long lSize = ftell(pFile);
+	fseek(pFile, 0, SEEK_SET);
+
+	// Over-allocated, so that the buffer can be aligned for borrowing
+	vcBuffer.resize((size_t)std::max(lSize, 0L) + 64);
+	bool bSuccess = (lSize >= 0) && (fread(&vcBuffer[0], 1, (size_t)lSize, pFile) == (size_t)lSize);
+	fclose(pFile);
+	return bSuccess;
+}
+
+//! Opens the file once and delivers the load statistics
+static int OpenOnce(const std::string& sFilePath, const Mode& oMode, const char* pBuffer, size_t nSize,
+					DAFFLoadStats& oStats)
+{
+	DAFFReader* pReader = DAFFReader::create();
+
+	int iError;
+	if (oMode.bMemory)
+		iError = pReader->deserialize(pBuffer, nSize, true);
+	else
+		iError = pReader->openFile(sFilePath, oMode.iOpenFlags);
+
+	pReader->getLoadStats(oStats);
+	pReader->closeFile();
+	delete pReader;
+
+	return iError;
+}
+
+//! Median of a phase over all runs
+static double Median(const std::vector<DAFFLoadStats>& vStats, double DAFFLoadStats::*pdPhase)
+{
+	std::vector<double> vdValues;
+	for (size_t i = 0; i < vStats.size(); i++)
+		vdValues.push_back(vStats[i].*pdPhase);
+	std::sort(vdValues.begin(), vdValues.end());
+	return Percentile(vdValues, 0.5);
+}
+
+static int RunFile(const std::string& sFilePath, int iWarmRuns, std::vector<Result>& vResults)
+{
+	std::vector<char> vcFile;
+	if (!ReadFile(sFilePath, vcFile)) {
+		fprintf(stderr, "Error: Reading '%s' failed\n", sFilePath.c_str());
+		return DAFF_FILE_NOT_FOUND;
+	}
+
+	size_t nSize = vcFile.size() - 64;
+	char* pBuffer = &vcFile[0] + (64 - ((uintptr_t)&vcFile[0]) % 64) % 64;
+	memmove(pBuffer, &vcFile[0], nSize);
+
+	for (size_t m = 0; m < sizeof(g_aModes) / sizeof(g_aModes[0]); m++) {
+		const Mode& oMode = g_aModes[m];
+
+		Result oResult;
+		oResult.sFile = sFilePath;
+		oResult.sMode = oMode.pszName;
+		oResult.ui64Size = nSize;
+
+		// Cold (the buffer of the memory mode is in memory anyway)
+		oResult.bCold = true;
+		oResult.bEvicted = !oMode.bMemory && EvictFile(sFilePath);
+		oResult.iRuns = 1;
+		int iError = OpenOnce(sFilePath, oMode, pBuffer, nSize, oResult.oStats);
+		if (iError != DAFF_NO_ERROR) {
+			fprintf(stderr, "Error: Opening '%s' (%s) failed: %s\n", sFilePath.c_str(), oMode.pszName,
+					DAFFUtils::StrError(iError).c_str());
+			return iError;
+		}
+		vResults.push_back(oResult);
+
+		// Warm
+		std::vector<DAFFLoadStats> vStats(iWarmRuns);
+		for (int i = 0; i < iWarmRuns; i++)
+			OpenOnce(sFilePath, oMode, pBuffer, nSize, vStats[i]);
+
+		oResult.bCold = false;
+		oResult.bEvicted = false;
+		oResult.iRuns = iWarmRuns;
+		oResult.oStats.dOpenTime = Median(vStats, &DAFFLoadStats::dOpenTime);
+		oResult.oStats.dHeaderTime = Median(vStats, &DAFFLoadStats::dHeaderTime);
+		oResult.oStats.dRecordDescriptorTime = Median(vStats, &DAFFLoadStats::dRecordDescriptorTime);
+		oResult.oStats.dRecordDataTime = Median(vStats, &DAFFLoadStats::dRecordDataTime);
+		oResult.oStats.dMetadataTime = Median(vStats, &DAFFLoadStats::dMetadataTime);
+		oResult.oStats.dAuxiliaryTime = Median(vStats, &DAFFLoadStats::dAuxiliaryTime);
+		oResult.oStats.dGridTime = Median(vStats, &DAFFLoadStats::dGridTime);
+		oResult.oStats.dDecodeTime = Median(vStats, &DAFFLoadStats::dDecodeTime);
+		oResult.oStats.dTruncateTime = Median(vStats, &DAFFLoadStats::dTruncateTime);
+		oResult.oStats.dTotalTime = Median(vStats, &DAFFLoadStats::dTotalTime);
+		vResults.push_back(oResult);
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+static const char* PHASE_COLUMNS = "open_us,header_us,descriptor_us,data_us,metadata_us,auxiliary_us,grid_us,"
+								   "decode_us,truncate_us,total_us";
+
+static void PrintText(const std::vector<Result>& vResults)
+{
+	printf("%-48s %-8s %-5s %5s %11s %9s %9s %9s %9s %9s %9s %9s %9s %9s %10s %9s\n", "file", "mode", "run", "runs",
+		   "bytes", "open", "header", "desc", "data", "metadata", "aux", "grid", "decode", "truncate", "total",
+		   "GB/s");
+	for (size_t i = 0; i < vResults.size(); i++) {
+		const Result& r = vResults[i];
+		const DAFFLoadStats& s = r.oStats;
+		double dGBPerSecond = (s.dTotalTime > 0) ? r.ui64Size / s.dTotalTime * 1e-9 : 0;
+		printf("%-48s %-8s %-5s %5d %11llu %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f %10.1f %9.3f\n",
+			   r.sFile.c_str(), r.sMode.c_str(), r.bCold ? (r.bEvicted ? "cold" : "first") : "warm", r.iRuns,
+			   (unsigned long long)r.ui64Size, s.dOpenTime * 1e6, s.dHeaderTime * 1e6, s.dRecordDescriptorTime * 1e6,
+			   s.dRecordDataTime * 1e6, s.dMetadataTime * 1e6, s.dAuxiliaryTime * 1e6, s.dGridTime * 1e6,
+			   s.dDecodeTime * 1e6, s.dTruncateTime * 1e6, s.dTotalTime * 1e6, dGBPerSecond);
+	}
+	printf("\nTimes in microseconds (warm: medians), run 'first': cold, but not evicted from the page cache\n");
+}
+
+static void PrintCSV(const std::vector<Result>& vResults)
+{
+	printf("file,mode,run,evicted,runs,bytes,descriptor_bytes,data_bytes,metadata_bytes,borrowed,%s\n",
+		   PHASE_COLUMNS);
+	for (size_t i = 0; i < vResults.size(); i++) {
+		const Result& r = vResults[i];
+		const DAFFLoadStats& s = r.oStats;
+		printf("%s,%s,%s,%d,%d,%llu,%llu,%llu,%llu,%d,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n",
+			   r.sFile.c_str(), r.sMode.c_str(), r.bCold ? "cold" : "warm", r.bEvicted ? 1 : 0, r.iRuns,
+			   (unsigned long long)r.ui64Size, (unsigned long long)s.ui64RecordDescriptorBytes,
+			   (unsigned long long)s.ui64RecordDataBytes, (unsigned long long)s.ui64MetadataBytes, s.bBorrowed ? 1 : 0,
+			   s.dOpenTime * 1e6, s.dHeaderTime * 1e6, s.dRecordDescriptorTime * 1e6, s.dRecordDataTime * 1e6,
+			   s.dMetadataTime * 1e6, s.dAuxiliaryTime * 1e6, s.dGridTime * 1e6, s.dDecodeTime * 1e6,
+			   s.dTruncateTime * 1e6, s.dTotalTime * 1e6);
+	}
+}
+
+static void PrintJSON(const std::vector<Result>& vResults)
+{
+	DAFFVersion oVersion;
+	DAFFUtils::getLibraryVersion(oVersion);
+
+	printf("{\n  \"library_version\": \"%s\",\n  \"results\": [\n", oVersion.sVersion.c_str());
+	for (size_t i = 0; i < vResults.size(); i++) {
+		const Result& r = vResults[i];
+		const DAFFLoadStats& s = r.oStats;
+		printf("    { \"file\": \"%s\", \"mode\": \"%s\", \"run\": \"%s\", \"evicted\": %s, \"runs\": %d, "
+			   "\"bytes\": %llu, \"descriptor_bytes\": %llu, \"data_bytes\": %llu, \"metadata_bytes\": %llu, "
+			   "\"borrowed\": %s, \"open_us\": %.2f, \"header_us\": %.2f, \"descriptor_us\": %.2f, \"data_us\": %.2f, "
+			   "\"metadata_us\": %.2f, \"auxiliary_us\": %.2f, \"grid_us\": %.2f, \"decode_us\": %.2f, "
+			   "\"truncate_us\": %.2f, \"total_us\": %.2f }%s\n",
+			   r.sFile.c_str(), r.sMode.c_str(), r.bCold ? "cold" : "warm", r.bEvicted ? "true" : "false", r.iRuns,
+			   (unsigned long long)r.ui64Size, (unsigned long long)s.ui64RecordDescriptorBytes,
+			   (unsigned long long)s.ui64RecordDataBytes, (unsigned long long)s.ui64MetadataBytes,
+			   s.bBorrowed ? "true" : "false", s.dOpenTime * 1e6, s.dHeaderTime * 1e6, s.dRecordDescriptorTime * 1e6,
+			   s.dRecordDataTime * 1e6, s.dMetadataTime * 1e6, s.dAuxiliaryTime * 1e6, s.dGridTime * 1e6,
+			   s.dDecodeTime * 1e6, s.dTruncateTime * 1e6, s.dTotalTime * 1e6, (i + 1 < vResults.size()) ? "," : "");
+	}
+	printf("  ]\n}\n");
+}
+
+static void PrintUsage()
+{
+	fprintf(stderr, "Usage: LoadBenchmark [-f text|csv|json] [-n warm runs] [-d directory] [-k] [files...]\n");
+}
+
+int main(int argc, char* argv[])
+{
+	std::string sFormat = "text";
+	std::string sDirectory;
+	bool bKeepFiles = false;
+	int iWarmRuns = 20;
+	std::vector<std::string> vsFiles;
+
+	for (int i = 1; i < argc; i++) {
+		if ((strcmp(argv[i], "-f") == 0) && (i + 1 < argc))
+			sFormat = argv[++i];
+		else if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+			iWarmRuns = std::max(atoi(argv[++i]), 1);
+		else if ((strcmp(argv[i], "-d") == 0) && (i + 1 < argc))
+			sDirectory = argv[++i];
+		else if (strcmp(argv[i], "-k") == 0)
+			bKeepFiles = true;
+		else if (argv[i][0] == '-') {
+			PrintUsage();
+			return 255;
+		} else
+			vsFiles.push_back(argv[i]);
+	}
+
+	if ((sFormat != "text") && (sFormat != "csv") && (sFormat != "json")) {
+		PrintUsage();
+		return 255;
+	}
+
+	// Synthetic corpus (small and large grids, integer, float and compressed data)
+	static const Config aConfigs[] = {
+		{ DAFF_IMPULSE_RESPONSE, DAFF_INT16, 5, 2, 256, false },
+		{ DAFF_IMPULSE_RESPONSE, DAFF_FLOAT32, 2, 2, 256, false },
+		{ DAFF_IMPULSE_RESPONSE, DAFF_FLOAT32, 2, 2, 256, true },
+		{ DAFF_IMPULSE_RESPONSE, DAFF_INT24, 1, 1, 128, false },
+		{ DAFF_MAGNITUDE_SPECTRUM, DAFF_FLOAT32, 1, 2, 31, false },
+		{ DAFF_DFT_SPECTRUM, DAFF_FLOAT32, 2, 2, 512, false },
+	};
+
+	std::vector<std::string> vsGenerated;
+	if (vsFiles.empty()) {
+		for (size_t i = 0; i < sizeof(aConfigs) / sizeof(aConfigs[0]); i++) {
+			std::string sFilePath = FileName(sDirectory, aConfigs[i]);
+			int iError = WriteFile(sFilePath, aConfigs[i]);
+			if (iError != DAFF_NO_ERROR) {
+				fprintf(stderr, "Error: Writing '%s' failed: %s\n", sFilePath.c_str(),
+						DAFFUtils::StrError(iError).c_str());
+				return 255;
+			}
+			vsGenerated.push_back(sFilePath);
+		}
+		vsFiles = vsGenerated;
+	}
+
+	std::vector<Result> vResults;
+	int iError = DAFF_NO_ERROR;
+	for (size_t i = 0; (i < vsFiles.size()) && (iError == DAFF_NO_ERROR); i++)
+		iError = RunFile(vsFiles[i], iWarmRuns, vResults);
+
+	if (!bKeepFiles)
+		for (size_t i = 0; i < vsGenerated.size(); i++)
+			remove(vsGenerated[i].c_str());
+
+	if (iError != DAFF_NO_ERROR)
+		return 255;
+
+	if (sFormat == "csv")
+		PrintCSV(vResults);
+	else if (sFormat == "json")
+		PrintJSON(vResults);
+	else
+		PrintText(vResults);
+
+	return 0;
+}
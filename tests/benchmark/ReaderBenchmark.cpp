@@ -0,0 +1,462 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016 Institute of Technical Acoustics, RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+/*
+ * Micro-benchmark of the reader hot paths
+ *
+ * Synthetic DAFF files are generated with fixed seeds for a set of grid resolutions,
+ * channel counts, filter lengths and quantizations. Every benchmark runs its operation
+ * in batches over a fixed, pseudo-random query sequence and reports the mean time per
+ * call, the percentiles of the per-batch call times and the throughput of the data
+ * delivered to the destination buffer. Use the csv or json output for diffs between
+ * releases.
+ *
+ * Usage: ReaderBenchmark [-f text|csv|json] [-t seconds] [-d directory] [-k] [-q]
+ *
+ *   -f  Output format (default: text)
+ *   -t  Minimum measurement time per benchmark [s] (default: 0.25)
+ *   -d  Directory for the generated files (default: working directory)
+ *   -k  Keep the generated files
+ *   -q  Quick run (small configurations only)
+ */
+
+#include <DAFF.h>
+
+#include "BenchmarkData.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static const int NUM_QUERIES = 4096;  // Length of the query sequences (power of two)
+static const int BATCH_SIZE = 64;     // Calls per timed batch
+static const int MIN_BATCHES = 64;    // Minimum number of timed batches
+
+//! Result of a single benchmark
+struct Result {
+	std::string sName;    //!@ Benchmark name
+	Config oConfig;       //!@ File configuration
+	int iNumRecords;      //!@ Number of records of the file
+	long lNumCalls;       //!@ Number of timed calls
+	double dMeanNs;       //!@ Mean time per call [ns]
+	double dP50Ns;        //!@ Median of the per-batch time per call [ns]
+	double dP90Ns;        //!@ 90th percentile of the per-batch time per call [ns]
+	double dP99Ns;        //!@ 99th percentile of the per-batch time per call [ns]
+	double dGBPerSecond;  //!@ Destination throughput [GB/s] (0: not applicable)
+};
+
+static double g_dMinSeconds = 0.25;  // Minimum measurement time per benchmark
+static volatile float g_fSink = 0;   // Defeats the elimination of unused results
+
+//! Times an operation and fills in the statistics of the result
+/**
+ * The operation is a functor with a member 'float operator()(int iCall)', its return
+ * values are accumulated into a volatile sink.
+ */
+template <class TOperation>
+static void Measure(TOperation& oOperation, size_t nBytesPerCall, Result& oResult)
+{
+	float fSink = 0;
+
+	// Warm up caches and branch predictors
+	for (int i = 0; i < NUM_QUERIES; i++)
+		fSink += oOperation(i);
+
+	std::vector<double> vdBatchNs;
+	double dTotalNs = 0;
+	int iCall = 0;
+	Clock::time_point tEnd =
+		Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(g_dMinSeconds));
+
+	while ((vdBatchNs.size() < (size_t)MIN_BATCHES) || (Clock::now() < tEnd)) {
+		Clock::time_point t0 = Clock::now();
+		for (int i = 0; i < BATCH_SIZE; i++)
+			fSink += oOperation(iCall++);
+		Clock::time_point t1 = Clock::now();
+
+		double dNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+		dTotalNs += dNs;
+		vdBatchNs.push_back(dNs / BATCH_SIZE);
+	}
+
+	g_fSink = g_fSink + fSink;
+
+	std::sort(vdBatchNs.begin(), vdBatchNs.end());
+	oResult.lNumCalls = (long)vdBatchNs.size() * BATCH_SIZE;
+	oResult.dMeanNs = dTotalNs / oResult.lNumCalls;
+	oResult.dP50Ns = Percentile(vdBatchNs, 0.50);
+	oResult.dP90Ns = Percentile(vdBatchNs, 0.90);
+	oResult.dP99Ns = Percentile(vdBatchNs, 0.99);
+	oResult.dGBPerSecond = (nBytesPerCall > 0) ? (double)nBytesPerCall / oResult.dMeanNs : 0;
+}
+
+//! Fixed query sequences (directions and record/channel pairs)
+struct Queries {
+	std::vector<float> vfAngle1;  //!@ Azimuth/alpha angles [degrees]
+	std::vector<float> vfAngle2;  //!@ Elevation/beta angles [degrees]
+	std::vector<int> viRecord;    //!@ Record indices
+	std::vector<int> viChannel;   //!@ Channel indices
+
+	Queries(int iView, int iNumRecords, int iNumChannels)
+	{
+		Random oRandom(12345u);
+		for (int i = 0; i < NUM_QUERIES; i++) {
+			if (iView == DAFF_OBJECT_VIEW) {
+				vfAngle1.push_back(360 * oRandom.next() - 180);
+				vfAngle2.push_back(180 * oRandom.next() - 90);
+			} else {
+				vfAngle1.push_back(360 * oRandom.next());
+				vfAngle2.push_back(180 * oRandom.next());
+			}
+			viRecord.push_back(oRandom.nextInt(iNumRecords));
+			viChannel.push_back(oRandom.nextInt(iNumChannels));
+		}
+	};
+};
+
+class NearestNeighbourOp {
+public:
+	inline NearestNeighbourOp(const DAFFContent* pContent, int iView, const Queries& oQueries)
+		: m_pContent(pContent), m_iView(iView), m_oQueries(oQueries) {};
+
+	inline float operator()(int iCall)
+	{
+		int i = iCall & (NUM_QUERIES - 1);
+		int iRecordIndex;
+		m_pContent->getNearestNeighbour(m_iView, m_oQueries.vfAngle1[i], m_oQueries.vfAngle2[i], iRecordIndex);
+		return (float)iRecordIndex;
+	};
+
+private:
+	const DAFFContent* m_pContent;  //!@ Content
+	int m_iView;                    //!@ View
+	const Queries& m_oQueries;      //!@ Query sequence
+};
+
+class CellOp {
+public:
+	inline CellOp(const DAFFContent* pContent, int iView, const Queries& oQueries)
+		: m_pContent(pContent), m_iView(iView), m_oQueries(oQueries) {};
+
+	inline float operator()(int iCall)
+	{
+		int i = iCall & (NUM_QUERIES - 1);
+		DAFFQuad qIndices;
+		m_pContent->getCell(m_iView, m_oQueries.vfAngle1[i], m_oQueries.vfAngle2[i], qIndices);
+		return (float)qIndices.iIndex1;
+	};
+
+private:
+	const DAFFContent* m_pContent;  //!@ Content
+	int m_iView;                    //!@ View
+	const Queries& m_oQueries;      //!@ Query sequence
+};
+
+class SCTransformOp {
+public:
+	inline SCTransformOp(bool bObjectToData, const Queries& oQueries)
+		: m_bObjectToData(bObjectToData), m_oQueries(oQueries)
+	{
+		m_oTransform.setOrientation(DAFFOrientationYPR(30, 15, -10));
+	};
+
+	inline float operator()(int iCall)
+	{
+		int i = iCall & (NUM_QUERIES - 1);
+		float fOut1, fOut2;
+		if (m_bObjectToData)
+			m_oTransform.transformOSC2DSC(m_oQueries.vfAngle1[i], m_oQueries.vfAngle2[i], fOut1, fOut2);
+		else
+			m_oTransform.transformDSC2OSC(m_oQueries.vfAngle1[i], m_oQueries.vfAngle2[i], fOut1, fOut2);
+		return fOut1 + fOut2;
+	};
+
+private:
+	bool m_bObjectToData;          //!@ Direction of the transformation
+	const Queries& m_oQueries;     //!@ Query sequence
+	DAFFSCTransform m_oTransform;  //!@ Transformation
+};
+
+//! Record data fetch (getFilterCoeffs, getMagnitudes or getDFTCoeffs)
+class FetchOp {
+public:
+	inline FetchOp(const DAFFContent* pContent, int iNumValues, const Queries& oQueries)
+		: m_oQueries(oQueries), m_vfDest(iNumValues)
+	{
+		// Dispatch on the content type, the reader implements all content interfaces
+		int iContentType = pContent->getProperties()->getContentType();
+		m_pIR = (iContentType == DAFF_IMPULSE_RESPONSE) ? dynamic_cast<const DAFFContentIR*>(pContent) : NULL;
+		m_pMS = (iContentType == DAFF_MAGNITUDE_SPECTRUM) ? dynamic_cast<const DAFFContentMS*>(pContent) : NULL;
+		m_pDFT = (iContentType == DAFF_DFT_SPECTRUM) ? dynamic_cast<const DAFFContentDFT*>(pContent) : NULL;
+	};
+
+	inline float operator()(int iCall)
+	{
+		int i = iCall & (NUM_QUERIES - 1);
+		if (m_pIR)
+			m_pIR->getFilterCoeffs(m_oQueries.viRecord[i], m_oQueries.viChannel[i], &m_vfDest[0]);
+		else if (m_pMS)
+			m_pMS->getMagnitudes(m_oQueries.viRecord[i], m_oQueries.viChannel[i], &m_vfDest[0]);
+		else
+			m_pDFT->getDFTCoeffs(m_oQueries.viRecord[i], m_oQueries.viChannel[i], &m_vfDest[0]);
+		return m_vfDest[i % m_vfDest.size()];
+	};
+
+private:
+	const DAFFContentIR* m_pIR;    //!@ Impulse response content (or NULL)
+	const DAFFContentMS* m_pMS;    //!@ Magnitude spectrum content (or NULL)
+	const DAFFContentDFT* m_pDFT;  //!@ DFT spectrum content (or NULL)
+	const Queries& m_oQueries;     //!@ Query sequence
+	std::vector<float> m_vfDest;   //!@ Destination buffer
+};
+
+static int RunConfig(const std::string& sDirectory, bool bKeepFiles, const Config& oConfig, bool bGridBenchmarks,
+					 std::vector<Result>& vResults)
+{
+	std::string sFilePath = FileName(sDirectory, oConfig);
+	int iError = WriteFile(sFilePath, oConfig);
+	if (iError != DAFF_NO_ERROR) {
+		fprintf(stderr, "Error: Writing '%s' failed: %s\n", sFilePath.c_str(), DAFFUtils::StrError(iError).c_str());
+		return iError;
+	}
+
+	DAFFReader* pReader = DAFFReader::create();
+	iError = pReader->openFile(sFilePath);
+	if (iError != DAFF_NO_ERROR) {
+		fprintf(stderr, "Error: Reading '%s' failed: %s\n", sFilePath.c_str(), DAFFUtils::StrError(iError).c_str());
+		delete pReader;
+		return iError;
+	}
+
+	const DAFFContent* pContent = pReader->getContent();
+	Queries oDataQueries(DAFF_DATA_VIEW, pContent->getProperties()->getNumberOfRecords(), oConfig.iNumChannels);
+	Queries oObjectQueries(DAFF_OBJECT_VIEW, pContent->getProperties()->getNumberOfRecords(), oConfig.iNumChannels);
+
+	Result oResult;
+	oResult.oConfig = oConfig;
+	oResult.iNumRecords = pContent->getProperties()->getNumberOfRecords();
+
+	if (bGridBenchmarks) {
+		NearestNeighbourOp oNNData(pContent, DAFF_DATA_VIEW, oDataQueries);
+		oResult.sName = "getNearestNeighbour_dsc";
+		Measure(oNNData, 0, oResult);
+		vResults.push_back(oResult);
+
+		NearestNeighbourOp oNNObject(pContent, DAFF_OBJECT_VIEW, oObjectQueries);
+		oResult.sName = "getNearestNeighbour_osc";
+		Measure(oNNObject, 0, oResult);
+		vResults.push_back(oResult);
+
+		CellOp oCellData(pContent, DAFF_DATA_VIEW, oDataQueries);
+		oResult.sName = "getCell_dsc";
+		Measure(oCellData, 0, oResult);
+		vResults.push_back(oResult);
+
+		CellOp oCellObject(pContent, DAFF_OBJECT_VIEW, oObjectQueries);
+		oResult.sName = "getCell_osc";
+		Measure(oCellObject, 0, oResult);
+		vResults.push_back(oResult);
+	}
+
+	int iNumValues = oConfig.iLength;
+	if (oConfig.iContentType == DAFF_IMPULSE_RESPONSE)
+		oResult.sName = "getFilterCoeffs";
+	else if (oConfig.iContentType == DAFF_MAGNITUDE_SPECTRUM)
+		oResult.sName = "getMagnitudes";
+	else {
+		oResult.sName = "getDFTCoeffs";
+		iNumValues = 2 * dynamic_cast<const DAFFContentDFT*>(pContent)->getNumDFTCoeffs();
+	}
+
+	FetchOp oFetch(pContent, iNumValues, oDataQueries);
+	Measure(oFetch, iNumValues * sizeof(float), oResult);
+	vResults.push_back(oResult);
+
+	pReader->closeFile();
+	delete pReader;
+
+	if (!bKeepFiles)
+		remove(sFilePath.c_str());
+
+	return DAFF_NO_ERROR;
+}
+
+static void RunTransforms(std::vector<Result>& vResults)
+{
+	Queries oDataQueries(DAFF_DATA_VIEW, 1, 1);
+	Queries oObjectQueries(DAFF_OBJECT_VIEW, 1, 1);
+
+	Result oResult;
+	Config oConfig = { -1, -1, 0, 0, 0, false };
+	oResult.oConfig = oConfig;
+	oResult.iNumRecords = 0;
+
+	SCTransformOp oO2D(true, oObjectQueries);
+	oResult.sName = "DAFFSCTransform_osc2dsc";
+	Measure(oO2D, 0, oResult);
+	vResults.push_back(oResult);
+
+	SCTransformOp oD2O(false, oDataQueries);
+	oResult.sName = "DAFFSCTransform_dsc2osc";
+	Measure(oD2O, 0, oResult);
+	vResults.push_back(oResult);
+}
+
+static std::string ContentName(const Config& oConfig)
+{
+	return (oConfig.iContentType < 0) ? std::string("-") : DAFFUtils::StrShortContentType(oConfig.iContentType);
+}
+
+static void PrintText(const std::vector<Result>& vResults)
+{
+	printf("%-26s %-4s %-8s %6s %3s %6s %8s %10s %10s %10s %10s %8s\n", "benchmark", "type", "quant", "grid", "ch",
+		   "length", "records", "ns/call", "p50", "p90", "p99", "GB/s");
+	for (size_t i = 0; i < vResults.size(); i++) {
+		const Result& r = vResults[i];
+		const char* pszQuant = (r.oConfig.iQuantization < 0) ? "-" : QuantizationName(r.oConfig.iQuantization);
+		printf("%-26s %-4s %-8s %6g %3d %6d %8d %10.1f %10.1f %10.1f %10.1f %8.3f\n", r.sName.c_str(),
+			   ContentName(r.oConfig).c_str(), pszQuant, r.oConfig.fResolution, r.oConfig.iNumChannels,
+			   r.oConfig.iLength, r.iNumRecords, r.dMeanNs, r.dP50Ns, r.dP90Ns, r.dP99Ns, r.dGBPerSecond);
+	}
+}
+
+static void PrintCSV(const std::vector<Result>& vResults)
+{
+	printf("benchmark,content,quantization,grid_deg,channels,length,records,calls,ns_per_call,p50_ns,p90_ns,p99_ns,"
+		   "gb_per_s\n");
+	for (size_t i = 0; i < vResults.size(); i++) {
+		const Result& r = vResults[i];
+		const char* pszQuant = (r.oConfig.iQuantization < 0) ? "" : QuantizationName(r.oConfig.iQuantization);
+		std::string sContent = (r.oConfig.iContentType < 0) ? "" : ContentName(r.oConfig);
+		printf("%s,%s,%s,%g,%d,%d,%d,%ld,%.2f,%.2f,%.2f,%.2f,%.4f\n", r.sName.c_str(), sContent.c_str(), pszQuant,
+			   r.oConfig.fResolution, r.oConfig.iNumChannels, r.oConfig.iLength, r.iNumRecords, r.lNumCalls,
+			   r.dMeanNs, r.dP50Ns, r.dP90Ns, r.dP99Ns, r.dGBPerSecond);
+	}
+}
+
+static void PrintJSON(const std::vector<Result>& vResults)
+{
+	DAFFVersion oVersion;
+	DAFFUtils::getLibraryVersion(oVersion);
+
+	printf("{\n  \"library_version\": \"%s\",\n  \"min_seconds\": %g,\n  \"batch_size\": %d,\n  \"results\": [\n",
+		   oVersion.sVersion.c_str(), g_dMinSeconds, BATCH_SIZE);
+	for (size_t i = 0; i < vResults.size(); i++) {
+		const Result& r = vResults[i];
+		const char* pszQuant = (r.oConfig.iQuantization < 0) ? "" : QuantizationName(r.oConfig.iQuantization);
+		std::string sContent = (r.oConfig.iContentType < 0) ? "" : ContentName(r.oConfig);
+		printf("    { \"benchmark\": \"%s\", \"content\": \"%s\", \"quantization\": \"%s\", \"grid_deg\": %g, "
+			   "\"channels\": %d, \"length\": %d, \"records\": %d, \"calls\": %ld, \"ns_per_call\": %.2f, "
+			   "\"p50_ns\": %.2f, \"p90_ns\": %.2f, \"p99_ns\": %.2f, \"gb_per_s\": %.4f }%s\n",
+			   r.sName.c_str(), sContent.c_str(), pszQuant, r.oConfig.fResolution, r.oConfig.iNumChannels,
+			   r.oConfig.iLength, r.iNumRecords, r.lNumCalls, r.dMeanNs, r.dP50Ns, r.dP90Ns, r.dP99Ns,
+			   r.dGBPerSecond, (i + 1 < vResults.size()) ? "," : "");
+	}
+	printf("  ]\n}\n");
+}
+
+static void PrintUsage()
+{
+	fprintf(stderr, "Usage: ReaderBenchmark [-f text|csv|json] [-t seconds] [-d directory] [-k] [-q]\n");
+}
+
+int main(int argc, char* argv[])
+{
+	std::string sFormat = "text";
+	std::string sDirectory;
+	bool bKeepFiles = false;
+	bool bQuick = false;
+
+	for (int i = 1; i < argc; i++) {
+		if ((strcmp(argv[i], "-f") == 0) && (i + 1 < argc))
+			sFormat = argv[++i];
+		else if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc))
+			g_dMinSeconds = atof(argv[++i]);
+		else if ((strcmp(argv[i], "-d") == 0) && (i + 1 < argc))
+			sDirectory = argv[++i];
+		else if (strcmp(argv[i], "-k") == 0)
+			bKeepFiles = true;
+		else if (strcmp(argv[i], "-q") == 0)
+			bQuick = true;
+		else {
+			PrintUsage();
+			return 255;
+		}
+	}
+
+	if ((sFormat != "text") && (sFormat != "csv") && (sFormat != "json")) {
+		PrintUsage();
+		return 255;
+	}
+
+	// Impulse responses: grid resolution, channels and filter length, every one in all integer/float quantizations
+	static const Config aIRConfigs[] = {
+		{ DAFF_IMPULSE_RESPONSE, DAFF_FLOAT32, 5, 1, 128, false },
+		{ DAFF_IMPULSE_RESPONSE, DAFF_FLOAT32, 5, 2, 256, false },
+		{ DAFF_IMPULSE_RESPONSE, DAFF_FLOAT32, 5, 2, 1024, false },
+		{ DAFF_IMPULSE_RESPONSE, DAFF_FLOAT32, 2, 2, 256, false },
+		{ DAFF_IMPULSE_RESPONSE, DAFF_FLOAT32, 1, 1, 128, false },
+	};
+	static const int aiQuantizations[] = { DAFF_INT16, DAFF_INT24, DAFF_FLOAT32 };
+
+	// Spectra: grid resolution, channels and number of frequencies/transform size
+	static const Config aSpectrumConfigs[] = {
+		{ DAFF_MAGNITUDE_SPECTRUM, DAFF_FLOAT32, 5, 2, 31, false },
+		{ DAFF_MAGNITUDE_SPECTRUM, DAFF_FLOAT32, 1, 2, 31, false },
+		{ DAFF_DFT_SPECTRUM, DAFF_FLOAT32, 5, 2, 512, false },
+		{ DAFF_DFT_SPECTRUM, DAFF_FLOAT32, 2, 2, 256, false },
+	};
+
+	int iNumIRConfigs = bQuick ? 2 : (int)(sizeof(aIRConfigs) / sizeof(aIRConfigs[0]));
+	int iNumSpectrumConfigs = bQuick ? 1 : (int)(sizeof(aSpectrumConfigs) / sizeof(aSpectrumConfigs[0]));
+
+	std::vector<Result> vResults;
+	RunTransforms(vResults);
+
+	for (int i = 0; i < iNumIRConfigs; i++) {
+		for (int j = 0; j < 3; j++) {
+			Config oConfig = aIRConfigs[i];
+			oConfig.iQuantization = aiQuantizations[j];
+
+			// Grid lookups do not depend on the data, measure them once per grid
+			bool bGridBenchmarks = (oConfig.iQuantization == DAFF_FLOAT32);
+			for (int k = 0; k < i; k++)
+				if (aIRConfigs[k].fResolution == oConfig.fResolution)
+					bGridBenchmarks = false;
+
+			if (RunConfig(sDirectory, bKeepFiles, oConfig, bGridBenchmarks, vResults) != DAFF_NO_ERROR)
+				return 255;
+		}
+	}
+
+	for (int i = 0; i < iNumSpectrumConfigs; i++)
+		if (RunConfig(sDirectory, bKeepFiles, aSpectrumConfigs[i], false, vResults) != DAFF_NO_ERROR)
+			return 255;
+
+	if (sFormat == "csv")
+		PrintCSV(vResults);
+	else if (sFormat == "json")
+		PrintJSON(vResults);
+	else
+		PrintText(vResults);
+
+	return 0;
+}
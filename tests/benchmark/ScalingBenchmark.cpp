@@ -0,0 +1,528 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016 Institute of Technical Acoustics, RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+/*
+ * Multithreaded scaling benchmark of shared readers
+ *
+ * A synthetic DFT file is queried by 1, 2, 4, ... threads with a mixed, pseudo-random
+ * sequence of getNearestNeighbour (object view), getCell (object view), interpolated
+ * fetches (getCell and the weighted sum of the four cell records with addDFTCoeffs) and
+ * plain getDFTCoeffs calls. Every thread count runs twice: all threads on one shared
+ * reader and every thread on its own reader of the same file. The threads are released
+ * at the same time and stop after the measurement time.
+ *
+ * Reported are the throughput of all threads, the speedup over a single thread of the
+ * same mode, the percentiles of the per-call latency (every call is timed, the clock
+ * overhead is included) and, on Linux if perf events are permitted, the last-level cache
+ * references and misses per call of the measured threads.
+ *
+ * Usage: ScalingBenchmark [-f text|csv|json] [-t seconds] [-n threads] [-d directory] [-k] [-q]
+ *
+ *   -f  Output format (default: text)
+ *   -t  Measurement time per run [s] (default: 0.5)
+ *   -n  Maximum number of threads (default: hardware concurrency)
+ *   -d  Directory for the generated file (default: working directory)
+ *   -k  Keep the generated file
+ *   -q  Quick run (small file)
+ */
+
+#include <DAFF.h>
+
+#include "BenchmarkData.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static const int NUM_QUERIES = 4096;  // Length of the query sequences per thread (power of two)
+static const int NUM_OPS = 4;         // Number of operations in the mix
+
+static const char* g_apszOpNames[NUM_OPS] = { "getNearestNeighbour", "getCell", "interpolated", "getDFTCoeffs" };
+
+static double g_dSeconds = 0.5;     // Measurement time per run
+static volatile float g_fSink = 0;  // Defeats the elimination of unused results
+
+//! Result of a thread count and mode
+struct Result {
+	std::string sMode;         //!@ Mode (shared or private readers)
+	int iNumThreads;           //!@ Number of threads
+	long lNumCalls;            //!@ Number of calls of all threads
+	double dSeconds;           //!@ Wall time of the measurement [s]
+	double dCallsPerSecond;    //!@ Throughput of all threads [calls/s]
+	double dSpeedup;           //!@ Throughput relative to a single thread of the same mode
+	double dP50Ns;             //!@ Median latency of the calls [ns]
+	double dP99Ns;             //!@ 99th percentile of the call latencies [ns]
+	double dP999Ns;            //!@ 99.9th percentile of the call latencies [ns]
+	double dCacheRefsPerCall;  //!@ Cache references per call (-1: not available)
+	double dCacheMissPerCall;  //!@ Cache misses per call (-1: not available)
+};
+
+//! Hardware cache counters of the calling thread (perf events, Linux only)
+class CacheCounters {
+public:
+	inline CacheCounters() : m_iRefsFD(OpenCounter(false)), m_iMissFD(OpenCounter(true)) {};
+
+	inline ~CacheCounters()
+	{
+#ifdef __linux__
+		if (m_iRefsFD >= 0)
+			close(m_iRefsFD);
+		if (m_iMissFD >= 0)
+			close(m_iMissFD);
+#endif
+	};
+
+	//! Counters could be opened?
+	inline bool available() const { return (m_iRefsFD >= 0) && (m_iMissFD >= 0); };
+
+	inline void start()
+	{
+#ifdef __linux__
+		if (!available())
+			return;
+		ioctl(m_iRefsFD, PERF_EVENT_IOC_RESET, 0);
+		ioctl(m_iMissFD, PERF_EVENT_IOC_RESET, 0);
+		ioctl(m_iRefsFD, PERF_EVENT_IOC_ENABLE, 0);
+		ioctl(m_iMissFD, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+	};
+
+	inline void stop(uint64_t& ui64Refs, uint64_t& ui64Misses)
+	{
+		ui64Refs = ui64Misses = 0;
+#ifdef __linux__
+		if (!available())
+			return;
+		ioctl(m_iRefsFD, PERF_EVENT_IOC_DISABLE, 0);
+		ioctl(m_iMissFD, PERF_EVENT_IOC_DISABLE, 0);
+		if (read(m_iRefsFD, &ui64Refs, sizeof(ui64Refs)) != (ssize_t)sizeof(ui64Refs))
+			ui64Refs = 0;
+		if (read(m_iMissFD, &ui64Misses, sizeof(ui64Misses)) != (ssize_t)sizeof(ui64Misses))
+			ui64Misses = 0;
+#endif
+	};
+
+private:
+	int m_iRefsFD;  //!@ Perf event of the cache references (-1: not available)
+	int m_iMissFD;  //!@ Perf event of the cache misses (-1: not available)
+
+	//! Opens a disabled user space counter of the calling thread (cache references or misses)
+	static int OpenCounter(bool bMisses)
+	{
+#ifdef __linux__
+		struct perf_event_attr oAttr;
+		memset(&oAttr, 0, sizeof(oAttr));
+		oAttr.type = PERF_TYPE_HARDWARE;
+		oAttr.size = sizeof(oAttr);
+		oAttr.config = bMisses ? PERF_COUNT_HW_CACHE_MISSES : PERF_COUNT_HW_CACHE_REFERENCES;
+		oAttr.disabled = 1;
+		oAttr.exclude_kernel = 1;
+		oAttr.exclude_hv = 1;
+		return (int)syscall(__NR_perf_event_open, &oAttr, 0, -1, -1, 0);
+#else
+		(void)bMisses;
+		return -1;
+#endif
+	};
+};
+
+//! Fixed mixed query sequence of a thread
+struct Queries {
+	std::vector<int> viOp;        //!@ Operations
+	std::vector<float> vfAngle1;  //!@ Azimuth angles [degrees]
+	std::vector<float> vfAngle2;  //!@ Elevation angles [degrees]
+	std::vector<int> viRecord;    //!@ Record indices
+	std::vector<int> viChannel;   //!@ Channel indices
+
+	Queries(unsigned int uiSeed, int iNumRecords, int iNumChannels)
+	{
+		Random oRandom(uiSeed);
+		for (int i = 0; i < NUM_QUERIES; i++) {
+			viOp.push_back(oRandom.nextInt(NUM_OPS));
+			vfAngle1.push_back(360 * oRandom.next() - 180);
+			vfAngle2.push_back(180 * oRandom.next() - 90);
+			viRecord.push_back(oRandom.nextInt(iNumRecords));
+			viChannel.push_back(oRandom.nextInt(iNumChannels));
+		}
+	};
+};
+
+//! Measurements of a single thread
+struct ThreadResult {
+	long lNumCalls;                  //!@ Number of calls
+	std::vector<float> vfLatencyNs;  //!@ Latencies of the calls [ns]
+	bool bCounters;                  //!@ Cache counters available
+	uint64_t ui64CacheRefs;          //!@ Cache references
+	uint64_t ui64CacheMisses;        //!@ Cache misses
+	float fSink;                     //!@ Accumulated results
+	int iError;                      //!@ First error of the calls
+};
+
+//! State shared by the threads of a run
+struct RunState {
+	std::atomic<int> iReady;  //!@ Number of threads waiting for the start
+	std::atomic<bool> bGo;    //!@ Start signal
+	Clock::time_point tEnd;   //!@ End of the measurement (set before the start signal)
+};
+
+//! Keeps the first error
+static inline void Check(int iResult, int& iError)
+{
+	if ((iResult != DAFF_NO_ERROR) && (iError == DAFF_NO_ERROR))
+		iError = iResult;
+}
+
+static float Call(const DAFFContent* pContent, const DAFFContentDFT* pDFT, const Queries& oQueries, int i,
+				  float* pfDest, int iNumValues, int& iError)
+{
+	int iRecordIndex;
+	DAFFQuad qIndices;
+	int iChannel = oQueries.viChannel[i];
+
+	switch (oQueries.viOp[i]) {
+	case 0:
+		pContent->getNearestNeighbour(DAFF_OBJECT_VIEW, oQueries.vfAngle1[i], oQueries.vfAngle2[i], iRecordIndex);
+		return (float)iRecordIndex;
+
+	case 1:
+		pContent->getCell(DAFF_OBJECT_VIEW, oQueries.vfAngle1[i], oQueries.vfAngle2[i], qIndices);
+		return (float)qIndices.iIndex1;
+
+	case 2:
+		// Equal weights, the cost does not depend on the weights
+		pContent->getCell(DAFF_OBJECT_VIEW, oQueries.vfAngle1[i], oQueries.vfAngle2[i], qIndices);
+		memset(pfDest, 0, iNumValues * sizeof(float));
+		Check(pDFT->addDFTCoeffs(qIndices.iIndex1, iChannel, pfDest, 0.25f), iError);
+		Check(pDFT->addDFTCoeffs(qIndices.iIndex2, iChannel, pfDest, 0.25f), iError);
+		Check(pDFT->addDFTCoeffs(qIndices.iIndex3, iChannel, pfDest, 0.25f), iError);
+		Check(pDFT->addDFTCoeffs(qIndices.iIndex4, iChannel, pfDest, 0.25f), iError);
+		return pfDest[i % iNumValues];
+
+	default:
+		Check(pDFT->getDFTCoeffs(oQueries.viRecord[i], iChannel, pfDest), iError);
+		return pfDest[i % iNumValues];
+	}
+}
+
+static void Worker(const DAFFContentDFT* pDFT, int iThread, RunState* pState, ThreadResult* pResult)
+{
+	// The reader implements all content interfaces
+	const DAFFContent* pContent = dynamic_cast<const DAFFContent*>(pDFT);
+	const DAFFProperties* pProps = pContent->getProperties();
+	Queries oQueries(12345u + 7919u * (unsigned int)iThread, pProps->getNumberOfRecords(),
+					 pProps->getNumberOfChannels());
+	int iNumValues = 2 * pDFT->getNumDFTCoeffs();
+	std::vector<float> vfDest(iNumValues);
+
+	pResult->lNumCalls = 0;
+	pResult->fSink = 0;
+	pResult->iError = DAFF_NO_ERROR;
+	pResult->vfLatencyNs.reserve(1 << 20);
+
+	// Warm up caches and branch predictors
+	for (int i = 0; i < NUM_QUERIES; i++)
+		pResult->fSink += Call(pContent, pDFT, oQueries, i, &vfDest[0], iNumValues, pResult->iError);
+
+	CacheCounters oCounters;
+	pResult->bCounters = oCounters.available();
+
+	pState->iReady++;
+	while (!pState->bGo.load())
+		std::this_thread::yield();
+
+	oCounters.start();
+	long lCall = 0;
+	Clock::time_point t0 = Clock::now();
+	while (t0 < pState->tEnd) {
+		int i = (int)(lCall++ & (NUM_QUERIES - 1));
+		pResult->fSink += Call(pContent, pDFT, oQueries, i, &vfDest[0], iNumValues, pResult->iError);
+		Clock::time_point t1 = Clock::now();
+		pResult->vfLatencyNs.push_back((float)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+		t0 = t1;
+	}
+	oCounters.stop(pResult->ui64CacheRefs, pResult->ui64CacheMisses);
+	pResult->lNumCalls = lCall;
+}
+
+static int RunThreads(const std::vector<const DAFFContentDFT*>& vpContents, const std::string& sMode,
+					  Result& oResult)
+{
+	int iNumThreads = (int)vpContents.size();
+	std::vector<ThreadResult> vThreadResults(iNumThreads);
+	RunState oState;
+	oState.iReady = 0;
+	oState.bGo = false;
+
+	std::vector<std::thread> vThreads;
+	for (int i = 0; i < iNumThreads; i++)
+		vThreads.push_back(std::thread(Worker, vpContents[i], i, &oState, &vThreadResults[i]));
+
+	while (oState.iReady.load() < iNumThreads)
+		std::this_thread::yield();
+
+	Clock::time_point tStart = Clock::now();
+	oState.tEnd = tStart + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(g_dSeconds));
+	oState.bGo = true;
+
+	for (int i = 0; i < iNumThreads; i++)
+		vThreads[i].join();
+	Clock::time_point tStop = Clock::now();
+
+	std::vector<double> vdLatencies;
+	bool bCounters = true;
+	uint64_t ui64Refs = 0, ui64Misses = 0;
+	float fSink = 0;
+	oResult.lNumCalls = 0;
+	for (int i = 0; i < iNumThreads; i++) {
+		const ThreadResult& r = vThreadResults[i];
+		if (r.iError != DAFF_NO_ERROR) {
+			fprintf(stderr, "Error: Query failed: %s\n", DAFFUtils::StrError(r.iError).c_str());
+			return r.iError;
+		}
+		oResult.lNumCalls += r.lNumCalls;
+		vdLatencies.insert(vdLatencies.end(), r.vfLatencyNs.begin(), r.vfLatencyNs.end());
+		bCounters &= r.bCounters;
+		ui64Refs += r.ui64CacheRefs;
+		ui64Misses += r.ui64CacheMisses;
+		fSink += r.fSink;
+	}
+	std::sort(vdLatencies.begin(), vdLatencies.end());
+
+	oResult.sMode = sMode;
+	oResult.iNumThreads = iNumThreads;
+	oResult.dSeconds = std::chrono::duration<double>(tStop - tStart).count();
+	oResult.dCallsPerSecond = oResult.lNumCalls / oResult.dSeconds;
+	oResult.dSpeedup = 1;
+	oResult.dP50Ns = vdLatencies.empty() ? 0 : Percentile(vdLatencies, 0.50);
+	oResult.dP99Ns = vdLatencies.empty() ? 0 : Percentile(vdLatencies, 0.99);
+	oResult.dP999Ns = vdLatencies.empty() ? 0 : Percentile(vdLatencies, 0.999);
+	bool bPerCall = bCounters && (oResult.lNumCalls > 0);
+	oResult.dCacheRefsPerCall = bPerCall ? (double)ui64Refs / oResult.lNumCalls : -1;
+	oResult.dCacheMissPerCall = bPerCall ? (double)ui64Misses / oResult.lNumCalls : -1;
+
+	g_fSink = g_fSink + fSink;
+
+	return DAFF_NO_ERROR;
+}
+
+static const DAFFContentDFT* OpenReader(const std::string& sFilePath, std::vector<DAFFReader*>& vpReaders)
+{
+	DAFFReader* pReader = DAFFReader::create();
+	int iError = pReader->openFile(sFilePath);
+	if (iError != DAFF_NO_ERROR) {
+		fprintf(stderr, "Error: Reading '%s' failed: %s\n", sFilePath.c_str(), DAFFUtils::StrError(iError).c_str());
+		delete pReader;
+		return NULL;
+	}
+
+	// A little rotation, so that the object view queries transform their directions
+	pReader->getProperties()->setOrientation(DAFFOrientationYPR(30, 15, -10));
+	vpReaders.push_back(pReader);
+	return dynamic_cast<const DAFFContentDFT*>(pReader->getContent());
+}
+
+static void CloseReaders(std::vector<DAFFReader*>& vpReaders)
+{
+	for (size_t i = 0; i < vpReaders.size(); i++) {
+		vpReaders[i]->closeFile();
+		delete vpReaders[i];
+	}
+	vpReaders.clear();
+}
+
+static int RunScaling(const std::string& sFilePath, int iMaxThreads, std::vector<Result>& vResults)
+{
+	std::vector<int> viThreadCounts;
+	for (int n = 1; n < iMaxThreads; n *= 2)
+		viThreadCounts.push_back(n);
+	viThreadCounts.push_back(iMaxThreads);
+
+	for (int m = 0; m < 2; m++) {
+		bool bShared = (m == 0);
+		double dSingleThroughput = 0;
+
+		for (size_t i = 0; i < viThreadCounts.size(); i++) {
+			int iNumThreads = viThreadCounts[i];
+
+			// Shared: one reader for all threads, private: a reader per thread (opened before the start)
+			std::vector<DAFFReader*> vpReaders;
+			std::vector<const DAFFContentDFT*> vpContents;
+			for (int t = 0; t < iNumThreads; t++) {
+				const DAFFContentDFT* pDFT = (bShared && (t > 0)) ? vpContents[0] : OpenReader(sFilePath, vpReaders);
+				if (pDFT == NULL) {
+					CloseReaders(vpReaders);
+					return DAFF_FILE_CORRUPTED;
+				}
+				vpContents.push_back(pDFT);
+			}
+
+			Result oResult;
+			int iError = RunThreads(vpContents, bShared ? "shared" : "private", oResult);
+			CloseReaders(vpReaders);
+			if (iError != DAFF_NO_ERROR)
+				return iError;
+
+			if (iNumThreads == 1)
+				dSingleThroughput = oResult.dCallsPerSecond;
+			oResult.dSpeedup = (dSingleThroughput > 0) ? oResult.dCallsPerSecond / dSingleThroughput : 0;
+			vResults.push_back(oResult);
+		}
+	}
+
+	return DAFF_NO_ERROR;
+}
+
+static void PrintText(const Config& oConfig, int iNumRecords, const std::vector<Result>& vResults)
+{
+	printf("File: %s, %g deg grid, %d records, %d channels, transform size %d\n",
+		   DAFFUtils::StrShortContentType(oConfig.iContentType).c_str(), oConfig.fResolution, iNumRecords,
+		   oConfig.iNumChannels, oConfig.iLength);
+	printf("Mix: %s, %s, %s, %s (object view, equal shares)\n\n", g_apszOpNames[0], g_apszOpNames[1],
+		   g_apszOpNames[2], g_apszOpNames[3]);
+
+	printf("%-8s %7s %12s %14s %8s %10s %10s %10s %11s %11s\n", "mode", "threads", "calls", "calls/s", "speedup",
+		   "p50 ns", "p99 ns", "p99.9 ns", "refs/call", "miss/call");
+	for (size_t i = 0; i < vResults.size(); i++) {
+		const Result& r = vResults[i];
+		printf("%-8s %7d %12ld %14.0f %8.2f %10.0f %10.0f %10.0f", r.sMode.c_str(), r.iNumThreads, r.lNumCalls,
+			   r.dCallsPerSecond, r.dSpeedup, r.dP50Ns, r.dP99Ns, r.dP999Ns);
+		if (r.dCacheRefsPerCall < 0)
+			printf(" %11s %11s\n", "n/a", "n/a");
+		else
+			printf(" %11.2f %11.2f\n", r.dCacheRefsPerCall, r.dCacheMissPerCall);
+	}
+}
+
+static void PrintCSV(const std::vector<Result>& vResults)
+{
+	printf("mode,threads,calls,seconds,calls_per_s,speedup,p50_ns,p99_ns,p999_ns,cache_refs_per_call,"
+		   "cache_misses_per_call\n");
+	for (size_t i = 0; i < vResults.size(); i++) {
+		const Result& r = vResults[i];
+		printf("%s,%d,%ld,%.4f,%.1f,%.3f,%.1f,%.1f,%.1f,%.3f,%.3f\n", r.sMode.c_str(), r.iNumThreads, r.lNumCalls,
+			   r.dSeconds, r.dCallsPerSecond, r.dSpeedup, r.dP50Ns, r.dP99Ns, r.dP999Ns, r.dCacheRefsPerCall,
+			   r.dCacheMissPerCall);
+	}
+}
+
+static void PrintJSON(const Config& oConfig, int iNumRecords, const std::vector<Result>& vResults)
+{
+	DAFFVersion oVersion;
+	DAFFUtils::getLibraryVersion(oVersion);
+
+	printf("{\n  \"library_version\": \"%s\",\n  \"seconds\": %g,\n  \"grid_deg\": %g,\n  \"records\": %d,\n"
+		   "  \"channels\": %d,\n  \"transform_size\": %d,\n  \"results\": [\n",
+		   oVersion.sVersion.c_str(), g_dSeconds, oConfig.fResolution, iNumRecords, oConfig.iNumChannels,
+		   oConfig.iLength);
+	for (size_t i = 0; i < vResults.size(); i++) {
+		const Result& r = vResults[i];
+		printf("    { \"mode\": \"%s\", \"threads\": %d, \"calls\": %ld, \"seconds\": %.4f, \"calls_per_s\": %.1f, "
+			   "\"speedup\": %.3f, \"p50_ns\": %.1f, \"p99_ns\": %.1f, \"p999_ns\": %.1f, "
+			   "\"cache_refs_per_call\": %.3f, \"cache_misses_per_call\": %.3f }%s\n",
+			   r.sMode.c_str(), r.iNumThreads, r.lNumCalls, r.dSeconds, r.dCallsPerSecond, r.dSpeedup, r.dP50Ns,
+			   r.dP99Ns, r.dP999Ns, r.dCacheRefsPerCall, r.dCacheMissPerCall, (i + 1 < vResults.size()) ? "," : "");
+	}
+	printf("  ]\n}\n");
+}
+
+static void PrintUsage()
+{
+	fprintf(stderr, "Usage: ScalingBenchmark [-f text|csv|json] [-t seconds] [-n threads] [-d directory] [-k] [-q]\n");
+}
+
+int main(int argc, char* argv[])
+{
+	std::string sFormat = "text";
+	std::string sDirectory;
+	bool bKeepFiles = false;
+	bool bQuick = false;
+	int iMaxThreads = (int)std::thread::hardware_concurrency();
+
+	for (int i = 1; i < argc; i++) {
+		if ((strcmp(argv[i], "-f") == 0) && (i + 1 < argc))
+			sFormat = argv[++i];
+		else if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc))
+			g_dSeconds = atof(argv[++i]);
+		else if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+			iMaxThreads = atoi(argv[++i]);
+		else if ((strcmp(argv[i], "-d") == 0) && (i + 1 < argc))
+			sDirectory = argv[++i];
+		else if (strcmp(argv[i], "-k") == 0)
+			bKeepFiles = true;
+		else if (strcmp(argv[i], "-q") == 0)
+			bQuick = true;
+		else {
+			PrintUsage();
+			return 255;
+		}
+	}
+
+	if ((sFormat != "text") && (sFormat != "csv") && (sFormat != "json")) {
+		PrintUsage();
+		return 255;
+	}
+
+	iMaxThreads = std::max(iMaxThreads, 1);
+
+	// HRTF-like DFT file (the quick file fits into the caches)
+	Config oConfig = { DAFF_DFT_SPECTRUM, DAFF_FLOAT32, 2, 2, 512, false };
+	if (bQuick) {
+		oConfig.fResolution = 5;
+		oConfig.iLength = 256;
+	}
+
+	std::string sFilePath = FileName(sDirectory, oConfig);
+	int iError = WriteFile(sFilePath, oConfig);
+	if (iError != DAFF_NO_ERROR) {
+		fprintf(stderr, "Error: Writing '%s' failed: %s\n", sFilePath.c_str(), DAFFUtils::StrError(iError).c_str());
+		return 255;
+	}
+
+	int iAlphaPoints, iBetaPoints;
+	int iNumRecords = NumGridPoints(oConfig.fResolution, iAlphaPoints, iBetaPoints);
+
+	std::vector<Result> vResults;
+	iError = RunScaling(sFilePath, iMaxThreads, vResults);
+
+	if (!bKeepFiles)
+		remove(sFilePath.c_str());
+
+	if (iError != DAFF_NO_ERROR)
+		return 255;
+
+	if (sFormat == "csv")
+		PrintCSV(vResults);
+	else if (sFormat == "json")
+		PrintJSON(oConfig, iNumRecords, vResults);
+	else
+		PrintText(oConfig, iNumRecords, vResults);
+
+	return 0;
+}
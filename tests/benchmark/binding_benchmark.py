@@ -0,0 +1,260 @@
+# Cross-language binding benchmark
+#
+# Runs the workload of the native baseline (BindingBenchmark.cpp: file openings,
+# nearest neighbour queries and record fetches) from every available binding and
+# reports the per-call overhead of each binding over the C++ API. The drivers live
+# next to the bindings:
+#
+#   python  bindings/python/daff_benchmark.py (daffCppInterface on the PYTHONPATH)
+#   go      bindings/go/benchmark/main.go (go run, libdaff_c of the build directory)
+#   rust    bindings/rust/examples/binding_benchmark.rs (cargo run --release)
+#   csharp  bindings/csharp/DAFFBenchmark.csproj (dotnet run, libDAFFCSWrapper)
+#   matlab  bindings/matlab/DAFFBenchmark.m (matlab -batch, DAFFv17 mex on the path)
+#
+# Bindings whose toolchain or library is not available are skipped. The overhead
+# compares every result with the native result of the same variant (single calls,
+# batches, zero-copy), or with the native single calls if the baseline has no such
+# variant. The checksums confirm that all drivers ran the same queries.
+#
+# Usage: python binding_benchmark.py [-b build] [-l bindings] [-q] [-k] [--csv]
+#                                    [--python-path dir] [--matlab-path dir]
+
+import argparse
+import csv
+import io
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+BINDINGS = ["python", "go", "rust", "csharp", "matlab"]
+FIELDS = ["binding", "operation", "variant", "calls", "ns_per_call", "checksum"]
+
+
+def find_native(build_dir):
+    """Path of the BindingBenchmark executable in a build or install directory"""
+    for sub in ["tests/benchmark", "tests/benchmark/Release", "bin", "."]:
+        for name in ["BindingBenchmark", "BindingBenchmark.exe"]:
+            path = os.path.join(build_dir, sub, name)
+            if os.path.isfile(path):
+                return path
+    return None
+
+
+def library_env(build_dir, extra_dirs=()):
+    """Environment with the shared libraries of the build on the search paths"""
+    env = dict(os.environ)
+    dirs = [build_dir] + list(extra_dirs)
+    for var in ["LD_LIBRARY_PATH", "DYLD_LIBRARY_PATH", "PATH"]:
+        env[var] = os.pathsep.join(dirs + ([env[var]] if env.get(var) else []))
+    return env
+
+
+def driver(binding, args, arguments):
+    """Command, working directory and environment of a driver (None if unavailable)"""
+    build_dir = args.build_dir
+    if binding == "python":
+        env = dict(os.environ)
+        if args.python_path:
+            paths = [args.python_path]
+            if env.get("PYTHONPATH"):
+                paths.append(env["PYTHONPATH"])
+            env["PYTHONPATH"] = os.pathsep.join(paths)
+        script = os.path.join(ROOT, "bindings", "python", "daff_benchmark.py")
+        return [sys.executable, script] + arguments, ROOT, env
+
+    if binding == "go":
+        if not shutil.which("go"):
+            return None
+        env = library_env(build_dir)
+        env["CGO_LDFLAGS"] = "-L" + build_dir
+        command = ["go", "run", "./benchmark"] + arguments
+        return command, os.path.join(ROOT, "bindings", "go"), env
+
+    if binding == "rust":
+        if not shutil.which("cargo"):
+            return None
+        env = library_env(build_dir)
+        env["RUSTFLAGS"] = (env.get("RUSTFLAGS", "") + " -L " + build_dir).strip()
+        command = ["cargo", "run", "-q", "--release", "--example", "binding_benchmark"]
+        return command + ["--"] + arguments, os.path.join(ROOT, "bindings", "rust"), env
+
+    if binding == "csharp":
+        if not shutil.which("dotnet"):
+            return None
+        env = library_env(build_dir, [os.path.join(build_dir, "bindings", "csharp")])
+        project = os.path.join(ROOT, "bindings", "csharp", "DAFFBenchmark.csproj")
+        command = ["dotnet", "run", "-c", "Release", "--project", project, "--"]
+        return command + arguments, ROOT, env
+
+    if binding == "matlab":
+        if not shutil.which("matlab"):
+            return None
+        paths = [os.path.join(ROOT, "bindings", "matlab")]
+        if args.matlab_path:
+            paths.append(args.matlab_path)
+        statement = "addpath(%s); DAFFBenchmark('%s', %s, %s, %s)" % (
+            ", ".join("'%s'" % p for p in paths),
+            *arguments,
+        )
+        return ["matlab", "-batch", statement], ROOT, library_env(build_dir)
+
+    return None
+
+
+def parse_results(output):
+    """Result rows of the CSV output of a driver (other lines are ignored)"""
+    rows = []
+    for row in csv.reader(io.StringIO(output)):
+        if len(row) != len(FIELDS) or row[0] == "binding":
+            continue
+        try:
+            rows.append(
+                {
+                    "binding": row[0],
+                    "operation": row[1],
+                    "variant": row[2],
+                    "calls": int(row[3]),
+                    "ns_per_call": float(row[4]),
+                    "checksum": float(row[5]),
+                }
+            )
+        except ValueError:
+            continue
+    return rows
+
+
+def run(command, cwd, env):
+    """Runs a driver, returns its result rows or an error message"""
+    try:
+        process = subprocess.run(
+            command, cwd=cwd, env=env, capture_output=True, text=True
+        )
+    except OSError as error:
+        return None, str(error)
+    if process.returncode != 0:
+        lines = (process.stderr or process.stdout).strip().splitlines()
+        return None, lines[-1] if lines else "exit code %d" % process.returncode
+    return parse_results(process.stdout), None
+
+
+def baseline(native, row):
+    """Native result of the variant of a row (else of the native single calls)"""
+    for variant in [row["variant"], "call"]:
+        for candidate in native:
+            if (
+                candidate["operation"] == row["operation"]
+                and candidate["variant"] == variant
+            ):
+                return candidate
+    return None
+
+
+def checksum_ok(native, row):
+    for candidate in native:
+        if candidate["operation"] == row["operation"]:
+            reference = candidate["checksum"]
+            tolerance = 1e-6 * max(1.0, abs(reference))
+            return abs(row["checksum"] - reference) <= tolerance
+    return False
+
+
+def report(rows, native, as_csv):
+    header = ["binding", "operation", "variant", "calls", "ns_per_call"]
+    header += ["native_ns", "overhead_ns", "ratio", "checksum"]
+    table = []
+    for row in rows:
+        reference = baseline(native, row)
+        native_ns = reference["ns_per_call"] if reference else float("nan")
+        ratio = row["ns_per_call"] / native_ns if native_ns > 0 else float("nan")
+        table.append(
+            [
+                row["binding"],
+                row["operation"],
+                row["variant"],
+                row["calls"],
+                row["ns_per_call"],
+                native_ns,
+                row["ns_per_call"] - native_ns,
+                ratio,
+                "ok" if checksum_ok(native, row) else "MISMATCH",
+            ]
+        )
+
+    if as_csv:
+        writer = csv.writer(sys.stdout, lineterminator="\n")
+        writer.writerow(header)
+        for line in table:
+            values = ["%.2f" % value for value in line[4:7]] + ["%.3f" % line[7]]
+            writer.writerow(line[:4] + values + [line[8]])
+        return
+
+    print("%-8s %-18s %-9s %8s %12s %12s %12s %8s  %s" % tuple(header))
+    for line in table:
+        print("%-8s %-18s %-9s %8d %12.1f %12.1f %12.1f %8.2f  %s" % tuple(line))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Per-call overhead of the DAFF bindings over the C++ API"
+    )
+    parser.add_argument(
+        "-b", "--build-dir", default="build", help="CMake build directory"
+    )
+    parser.add_argument(
+        "-l", "--bindings", default=",".join(BINDINGS), help="Comma-separated list"
+    )
+    parser.add_argument(
+        "-q", "--quick", action="store_true", help="A tenth of the workload"
+    )
+    parser.add_argument(
+        "-k", "--keep", action="store_true", help="Keep the workload file"
+    )
+    parser.add_argument("--csv", action="store_true", help="CSV output")
+    parser.add_argument("--python-path", help="Directory of daffCppInterface")
+    parser.add_argument("--matlab-path", help="Directory of the DAFFv17 mex")
+    args = parser.parse_args()
+    args.build_dir = os.path.abspath(args.build_dir)
+
+    native_executable = find_native(args.build_dir)
+    if not native_executable:
+        sys.stderr.write("Error: BindingBenchmark not found in '%s'\n" % args.build_dir)
+        return 255
+
+    counts = ["100000", "10000", "10"] if args.quick else ["1000000", "100000", "50"]
+    work_dir = tempfile.mkdtemp(prefix="daff_binding_benchmark_")
+    path = os.path.join(work_dir, "binding_benchmark.ir.daff")
+
+    command = [native_executable, "-o", path]
+    command += ["-n", counts[0], "-r", counts[1], "-p", counts[2]]
+    native, error = run(command, ROOT, library_env(args.build_dir))
+    if native is None:
+        sys.stderr.write("Error: Native baseline failed: %s\n" % error)
+        shutil.rmtree(work_dir, ignore_errors=True)
+        return 255
+
+    rows = list(native)
+    for binding in [b.strip() for b in args.bindings.split(",") if b.strip()]:
+        invocation = driver(binding, args, [path] + counts)
+        if invocation is None:
+            sys.stderr.write("Skipped %s: not available\n" % binding)
+            continue
+        results, error = run(*invocation)
+        if results is None:
+            sys.stderr.write("Skipped %s: %s\n" % (binding, error))
+            continue
+        rows.extend(results)
+
+    report(rows, native, args.csv)
+
+    if args.keep:
+        sys.stderr.write("Workload file: %s\n" % path)
+    else:
+        shutil.rmtree(work_dir, ignore_errors=True)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
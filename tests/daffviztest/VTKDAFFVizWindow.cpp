@@ -55,6 +55,7 @@ VTKDAFFVizWindow::VTKDAFFVizWindow()
 	m_bDestroyInProgress = false;
 
 	m_pCamera = m_pRenderer->GetActiveCamera();
+	m_pSceneRootNode = NULL;
 
 	m_pInteractor = vtkSmartPointer<vtkRenderWindowInteractor>::New();
 	m_pInteractor->SetRenderWindow(m_pRenderWindow);
@@ -85,6 +86,8 @@ VTKDAFFVizWindow::~VTKDAFFVizWindow()
 
 void VTKDAFFVizWindow::Start()
 {
+	if (m_pSceneRootNode)
+		m_pSceneRootNode->Update();
 	m_pRenderWindow->Render();
 	// m_pRenderWindow->Start();
 	m_pInteractor->Start();
@@ -346,6 +349,8 @@ void VTKDAFFVizWindow::RenderInternal()
 	// Try lock agains scene graph nodes (if root node appended to frame)
 	DAFFVIZ_LOCK_VTK;
 
+	if (m_pSceneRootNode)
+		m_pSceneRootNode->Update();
 	m_pRenderWindow->Render();
 
 	// Unlock agains scene graph nodes (if root node appended to frame)
@@ -52,7 +52,7 @@ int main(int iNumArgs, char** args)
 	fclose(hDAFFFile);
 
 	// Now load as DAFF file using the deserializer ( instead of openFile() )
-	int ec = r->deserialize(pDAFFDataBuffer);
+	int ec = r->deserialize(pDAFFDataBuffer, nBytes);
 	if (ec != 0) {
 		cerr << "Error: " << DAFFUtils::StrError(ec) << endl;
 		return 255;
@@ -60,6 +60,27 @@ int main(int iNumArgs, char** args)
 
 	cout << r->toString() << endl;
 
+	// Once more without copying, the buffer is kept alive until the reader is deleted
+	DAFFReader* rb = DAFFReader::create();
+	ec = rb->deserialize(pDAFFDataBuffer, nBytes, true);
+	if (ec != 0) {
+		cerr << "Error: " << DAFFUtils::StrError(ec) << endl;
+		return 255;
+	}
+
+	if (rb->toString() != r->toString()) {
+		cerr << "Error: borrowed and copied content differ" << endl;
+		return 255;
+	}
+
+	// Truncated buffers must be rejected
+	rb->closeFile();
+	if (rb->deserialize(pDAFFDataBuffer, nBytes / 2, true) == DAFF_NO_ERROR) {
+		cerr << "Error: truncated buffer was accepted" << endl;
+		return 255;
+	}
+
+	delete rb;
 	delete r;
 
 	return 0;
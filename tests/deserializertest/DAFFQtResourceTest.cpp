@@ -30,7 +30,7 @@ int main(int argc, char* argv[])
 
 	DAFFReader* pReader = DAFFReader::create();
 
-	int iErr = pReader->deserialize(oDAFFContentRaw.data());
+	int iErr = pReader->deserialize(oDAFFContentRaw.constData(), (size_t)oDAFFContentRaw.size());
 	if (iErr == DAFF_NO_ERROR)
 		std::cout << pReader->toString() << std::endl;
 	else
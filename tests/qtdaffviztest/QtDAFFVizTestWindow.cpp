@@ -118,6 +118,7 @@ void QtDAFFVizTestWindow::on_actionOpen_triggered()
 void QtDAFFVizTestWindow::on_lineEditFrequency_returnPressed()
 {
 	balloonPlot->SetSelectedFrequency(ui->lineEditFrequency->text().toInt());
+	node->Update();
 	this->ui->vtkWidgetBalloon->update();
 	/*ui->textBrowser_2->clear();
 	ui->textBrowser_2->append("\n current frequency index: ");
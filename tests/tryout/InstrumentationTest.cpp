@@ -0,0 +1,89 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+#include <DAFF.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class TestSink : public DAFFInstrumentationSink {
+  public:
+	vector<string> vsScopes;
+
+	void onTraceScope(const char* pszScope, double dDuration)
+	{
+		vsScopes.push_back(pszScope);
+		cout << "  scope " << pszScope << ": " << dDuration * 1e6 << " us" << endl;
+	}
+};
+
+int main(int argc, char* argv[])
+{
+	if (!DAFFInstrumentation::isEnabled()) {
+		cout << "Instrumentation disabled (build with OPENDAFF_WITH_INSTRUMENTATION=ON)" << endl;
+		return 0;
+	}
+
+	string sFilePath = (argc > 1 ? argv[1] : "test_ir.daff");
+
+	TestSink oSink;
+	DAFFInstrumentation::setSink(&oSink);
+	DAFFInstrumentation::resetCounters();
+
+	DAFFReader* r = DAFFReader::create();
+	int ec = r->openFile(sFilePath);
+	if (ec != 0) {
+		cerr << "Error: " << DAFFUtils::StrError(ec) << endl;
+		cerr << "Run daff_write_test.m first to create the daff files." << endl;
+		delete r;
+		return ec;
+	}
+
+	// The load must have been traced, the total last
+	if (oSink.vsScopes.empty() || oSink.vsScopes.back() != "load") {
+		cerr << "Load scopes missing" << endl;
+		delete r;
+		return 1;
+	}
+
+	DAFFContent* c = r->getContent();
+	int iRecordIndex;
+	bool bOutOfBounds;
+	for (int i = 0; i < 36; i++)
+		c->getNearestNeighbour(DAFF_OBJECT_VIEW, float(i * 10), 0.0f, iRecordIndex, bOutOfBounds);
+
+	uint64_t pui64Values[DAFF_NUM_COUNTERS];
+	DAFFInstrumentation::getCounters(pui64Values);
+	for (int i = 0; i < DAFF_NUM_COUNTERS; i++)
+		cout << DAFFInstrumentation::getCounterName(i) << ": " << pui64Values[i] << endl;
+
+	if (pui64Values[DAFF_COUNTER_NEAREST_NEIGHBOUR] != 36) {
+		cerr << "Incorrect number of nearest neighbour lookups" << endl;
+		delete r;
+		return 1;
+	}
+
+	DAFFInstrumentation::resetCounters();
+	if (DAFFInstrumentation::getCounter(DAFF_COUNTER_NEAREST_NEIGHBOUR) != 0) {
+		cerr << "Counters not reset" << endl;
+		delete r;
+		return 1;
+	}
+
+	DAFFInstrumentation::setSink(NULL);
+	delete r;
+
+	cout << "OK" << endl;
+	return 0;
+}
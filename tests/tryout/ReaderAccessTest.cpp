@@ -0,0 +1,436 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+// Accesses files of all content types through shared segments, with channel selections and
+// regions and compares the records against a reader that has loaded the whole file
+
+#include <DAFF.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <math.h>
+
+using namespace std;
+
+static const int NUM_CHANNELS = 3;
+static const int NUM_VALUES = 24;
+static const string SHARED_NAME = "DAFFReaderAccessTest";
+
+//! Content types of the test files
+static const int CONTENT_TYPES[] = {DAFF_IMPULSE_RESPONSE, DAFF_MAGNITUDE_SPECTRUM, DAFF_PHASE_SPECTRUM,
+									DAFF_MAGNITUDE_PHASE_SPECTRUM, DAFF_DFT_SPECTRUM};
+static const int NUM_CONTENT_TYPES = sizeof(CONTENT_TYPES) / sizeof(int);
+
+//! Open flags every file is accessed with
+static const int OPEN_FLAGS[] = {DAFF_OPEN_DEFAULT, DAFF_OPEN_MAPPED, DAFF_OPEN_LAZY, DAFF_OPEN_DECODE};
+static const int NUM_OPEN_FLAGS = sizeof(OPEN_FLAGS) / sizeof(int);
+
+//! Positive values that differ for every direction, channel and value index
+class AccessCallback : public DAFFWriterCallback {
+  public:
+	int iLength;  //!@ Number of values per channel
+
+	inline AccessCallback(int iRecordDataLength) : iLength(iRecordDataLength) {};
+
+	int getRecordData(int, float fAlphaDeg, float fBetaDeg, float** ppfChannelData)
+	{
+		for (int c = 0; c < NUM_CHANNELS; c++)
+			for (int k = 0; k < iLength; k++)
+				ppfChannelData[c][k] = 0.5f + 0.2f * cosf(0.3f * k + 0.02f * fAlphaDeg) +
+									   0.1f * sinf(0.05f * fBetaDeg) + 0.05f * c;
+		return DAFF_NO_ERROR;
+	}
+};
+
+static string getFilePath(int iContentType)
+{
+	return "access_" + DAFFUtils::StrShortContentType(iContentType) + ".daff";
+}
+
+static bool writeFile(int iContentType)
+{
+	vector<float> vfFrequencies;
+	for (int k = 0; k < NUM_VALUES; k++)
+		vfFrequencies.push_back(20.0f * powf(2.0f, k / 2.0f));
+
+	DAFFWriter w;
+	switch (iContentType) {
+	case DAFF_IMPULSE_RESPONSE:
+		w.setImpulseResponses(NUM_VALUES, 44100);
+		w.setQuantization(DAFF_INT16);
+		break;
+	case DAFF_MAGNITUDE_SPECTRUM:
+		w.setMagnitudeSpectra(vfFrequencies);
+		break;
+	case DAFF_PHASE_SPECTRUM:
+		w.setPhaseSpectra(vfFrequencies);
+		break;
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		w.setMagnitudePhaseSpectra(vfFrequencies);
+		break;
+	case DAFF_DFT_SPECTRUM:
+		w.setDFTSpectra(2 * (NUM_VALUES - 1), 44100);
+		break;
+	}
+	w.setNumChannels(NUM_CHANNELS);
+	w.setGrid(24, 0, 360, 13, 0, 180);
+
+	AccessCallback oCallback(w.getRecordDataLength());
+	int ec = w.write(getFilePath(iContentType), &oCallback);
+	if (ec != DAFF_NO_ERROR)
+		cerr << "Writing " << getFilePath(iContentType) << " failed: " << DAFFUtils::StrError(ec) << endl;
+	return (ec == DAFF_NO_ERROR);
+}
+
+//! Number of float values per channel (magnitude-phase pairs and complex values interleaved)
+static int getRecordLength(const DAFFReader* pReader)
+{
+	DAFFContent* pContent = pReader->getContent();
+	switch (pReader->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		return dynamic_cast<DAFFContentIR*>(pContent)->getFilterLength();
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return dynamic_cast<DAFFContentMS*>(pContent)->getNumFrequencies();
+	case DAFF_PHASE_SPECTRUM:
+		return dynamic_cast<DAFFContentPS*>(pContent)->getNumFrequencies();
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		return 2 * dynamic_cast<DAFFContentMPS*>(pContent)->getNumFrequencies();
+	case DAFF_DFT_SPECTRUM:
+		return 2 * dynamic_cast<DAFFContentDFT*>(pContent)->getNumDFTCoeffs();
+	}
+	return 0;
+}
+
+static int getChannelData(const DAFFReader* pReader, int iRecordIndex, int iChannel, float* pfDest)
+{
+	DAFFContent* pContent = pReader->getContent();
+	switch (pReader->getContentType()) {
+	case DAFF_IMPULSE_RESPONSE:
+		return dynamic_cast<DAFFContentIR*>(pContent)->getFilterCoeffs(iRecordIndex, iChannel, pfDest);
+	case DAFF_MAGNITUDE_SPECTRUM:
+		return dynamic_cast<DAFFContentMS*>(pContent)->getMagnitudes(iRecordIndex, iChannel, pfDest);
+	case DAFF_PHASE_SPECTRUM:
+		return dynamic_cast<DAFFContentPS*>(pContent)->getPhases(iRecordIndex, iChannel, pfDest);
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		return dynamic_cast<DAFFContentMPS*>(pContent)->getCoefficientsMP(iRecordIndex, iChannel, pfDest);
+	case DAFF_DFT_SPECTRUM:
+		return dynamic_cast<DAFFContentDFT*>(pContent)->getDFTCoeffs(iRecordIndex, iChannel, pfDest);
+	}
+	return DAFF_MODAL_ERROR;
+}
+
+//! Compares the loaded records of a reader with the records of the whole file
+/**
+ * viRecords and viChannels map the loaded records and channels to those of the file (empty: same indices).
+ */
+static bool compareRecords(const DAFFReader* pFull, const DAFFReader* pReader, const vector<int>& viRecords,
+						   const vector<int>& viChannels, const string& sCase)
+{
+	const DAFFProperties* pFullProps = pFull->getContent()->getProperties();
+	const DAFFProperties* pProps = pReader->getContent()->getProperties();
+	int iNumRecords = (viRecords.empty() ? pFullProps->getNumberOfRecords() : (int)viRecords.size());
+	int iNumChannels = (viChannels.empty() ? pFullProps->getNumberOfChannels() : (int)viChannels.size());
+	int iLength = getRecordLength(pFull);
+	if ((pReader->getContentType() != pFull->getContentType()) || (pProps->getNumberOfRecords() != iNumRecords) ||
+		(pProps->getNumberOfChannels() != iNumChannels) || (getRecordLength(pReader) != iLength)) {
+		cerr << sCase << ": " << pProps->getNumberOfRecords() << " records and " << pProps->getNumberOfChannels()
+			 << " channels, expected " << iNumRecords << " and " << iNumChannels << endl;
+		return false;
+	}
+
+	vector<float> vfExpected(iLength), vfActual(iLength);
+	for (int i = 0; i < iNumRecords; i++) {
+		int iFullRecord = (viRecords.empty() ? i : viRecords[i]);
+		float fAlpha, fBeta, fFullAlpha, fFullBeta;
+		pReader->getContent()->getRecordCoords(i, DAFF_DATA_VIEW, fAlpha, fBeta);
+		pFull->getContent()->getRecordCoords(iFullRecord, DAFF_DATA_VIEW, fFullAlpha, fFullBeta);
+		if ((fabsf(fAlpha - fFullAlpha) > 1e-3f) || (fabsf(fBeta - fFullBeta) > 1e-3f)) {
+			cerr << sCase << ": record " << i << " at (" << fAlpha << ", " << fBeta << "), expected (" << fFullAlpha
+				 << ", " << fFullBeta << ")" << endl;
+			return false;
+		}
+
+		for (int c = 0; c < iNumChannels; c++) {
+			int ec = getChannelData(pFull, iFullRecord, (viChannels.empty() ? c : viChannels[c]), &vfExpected[0]);
+			if (ec == DAFF_NO_ERROR)
+				ec = getChannelData(pReader, i, c, &vfActual[0]);
+			if (ec != DAFF_NO_ERROR) {
+				cerr << sCase << ": reading record " << i << " channel " << c << " failed: " << DAFFUtils::StrError(ec)
+					 << endl;
+				return false;
+			}
+			if (vfActual != vfExpected) {
+				cerr << sCase << ": data of record " << i << " channel " << c << " differs" << endl;
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+//! Describes a content type and open flags in error messages
+static string getCase(int iContentType, int iOpenFlags)
+{
+	return DAFFUtils::StrShortContentType(iContentType) + " (flags " + to_string(iOpenFlags) + ")";
+}
+
+//! Readers attached to a segment access the same records as the publisher
+static bool testSharedMemory(const DAFFReader* pFull, int iContentType)
+{
+	bool bMatch = true;
+	for (int f = 0; bMatch && (f < NUM_OPEN_FLAGS); f++) {
+		string sCase = getCase(iContentType, OPEN_FLAGS[f]) + ", shared";
+		DAFFReader* pPublisher = DAFFReader::create();
+		DAFFReader* pReader = DAFFReader::create();
+
+		int ec = pPublisher->openFile(getFilePath(iContentType), OPEN_FLAGS[f]);
+		if (ec == DAFF_NO_ERROR)
+			ec = pPublisher->publishShared(SHARED_NAME);
+		if (ec == DAFF_NO_ERROR)
+			ec = pReader->attachShared(SHARED_NAME);
+		if (ec != DAFF_NO_ERROR) {
+			cerr << sCase << ": publishing or attaching failed: " << DAFFUtils::StrError(ec) << endl;
+			bMatch = false;
+		}
+
+		// A second segment of the same name is refused
+		DAFFReader* pSecond = DAFFReader::create();
+		if (bMatch && (pSecond->openFile(getFilePath(iContentType)) == DAFF_NO_ERROR) &&
+			(pSecond->publishShared(SHARED_NAME) != DAFF_MODAL_ERROR)) {
+			cerr << sCase << ": name of the segment published twice" << endl;
+			bMatch = false;
+		}
+		delete pSecond;
+
+		bMatch = bMatch && compareRecords(pFull, pReader, vector<int>(), vector<int>(), sCase);
+
+		// Attached readers stay valid after the publisher has closed the file
+		pPublisher->closeFile();
+		bMatch = bMatch && compareRecords(pFull, pReader, vector<int>(), vector<int>(), sCase + " after closing");
+
+		delete pReader;
+		delete pPublisher;
+	}
+	return bMatch;
+}
+
+//! Readers with a channel selection hold the selected channels in the given order
+static bool testChannelSelection(const DAFFReader* pFull, int iContentType)
+{
+	vector<vector<int> > vviSelections(3);
+	vviSelections[0].push_back(2);
+	vviSelections[0].push_back(0);
+	vviSelections[1].push_back(1);
+	vviSelections[2].push_back(1);
+	vviSelections[2].push_back(1);
+
+	bool bMatch = true;
+	for (int f = 0; bMatch && (f < NUM_OPEN_FLAGS); f++) {
+		string sCase = getCase(iContentType, OPEN_FLAGS[f]) + ", channels";
+		DAFFReader* pReader = DAFFReader::create();
+		for (size_t n = 0; bMatch && (n < vviSelections.size()); n++) {
+			pReader->setChannelSelection(vviSelections[n]);
+			int ec = pReader->openFile(getFilePath(iContentType), OPEN_FLAGS[f]);
+			if (ec != DAFF_NO_ERROR) {
+				cerr << sCase << ": opening failed: " << DAFFUtils::StrError(ec) << endl;
+				bMatch = false;
+			}
+			bMatch = bMatch && compareRecords(pFull, pReader, vector<int>(), vviSelections[n], sCase);
+
+			// The segment of a selection would not describe the file
+			if (bMatch && (pReader->publishShared(SHARED_NAME) != DAFF_MODAL_ERROR)) {
+				cerr << sCase << ": selection published" << endl;
+				bMatch = false;
+			}
+			pReader->closeFile();
+		}
+
+		// Channel that does not exist
+		pReader->setChannelSelection(vector<int>(1, NUM_CHANNELS));
+		int ec = pReader->openFile(getFilePath(iContentType), OPEN_FLAGS[f]);
+		if (bMatch && (ec != DAFF_INVALID_INDEX)) {
+			cerr << sCase << ": invalid channel selected: " << DAFFUtils::StrError(ec) << endl;
+			bMatch = false;
+		}
+		delete pReader;
+
+		// Attached readers can select channels
+		DAFFReader* pPublisher = DAFFReader::create();
+		pReader = DAFFReader::create();
+		pReader->setChannelSelection(vviSelections[0]);
+		ec = pPublisher->openFile(getFilePath(iContentType), OPEN_FLAGS[f]);
+		if (ec == DAFF_NO_ERROR)
+			ec = pPublisher->publishShared(SHARED_NAME);
+		if (ec == DAFF_NO_ERROR)
+			ec = pReader->attachShared(SHARED_NAME);
+		if (bMatch && (ec != DAFF_NO_ERROR)) {
+			cerr << sCase << ": publishing or attaching failed: " << DAFFUtils::StrError(ec) << endl;
+			bMatch = false;
+		}
+		bMatch = bMatch && compareRecords(pFull, pReader, vector<int>(), vviSelections[0], sCase + ", shared");
+		delete pReader;
+		delete pPublisher;
+	}
+	return bMatch;
+}
+
+//! Records of the whole file in a region, found independently of the reader
+static vector<int> getExpectedRecords(const DAFFReader* pFull, const DAFFRegion& oRegion)
+{
+	const float fDeg = 3.14159265f / 180;
+	vector<int> viRecords;
+	for (int i = 0; i < pFull->getContent()->getProperties()->getNumberOfRecords(); i++) {
+		float fAlpha, fBeta, fAzimuth, fElevation;
+		pFull->getContent()->getRecordCoords(i, DAFF_DATA_VIEW, fAlpha, fBeta);
+		pFull->getContent()->getRecordCoords(i, DAFF_OBJECT_VIEW, fAzimuth, fElevation);
+		float fCos = cosf(fElevation * fDeg) * cosf(oRegion.fConeElevation * fDeg) *
+						 cosf((fAzimuth - oRegion.fConeAzimuth) * fDeg) +
+					 sinf(fElevation * fDeg) * sinf(oRegion.fConeElevation * fDeg);
+		float fDistance = acosf(max(-1.0f, min(1.0f, fCos))) / fDeg;
+
+		if (((oRegion.iType == DAFF_REGION_BETA_RANGE) && (fBeta > oRegion.fBetaStart - 1e-3f) &&
+			 (fBeta < oRegion.fBetaEnd + 1e-3f)) ||
+			((oRegion.iType == DAFF_REGION_CONE) && (fDistance <= oRegion.fConeAngle)) ||
+			((oRegion.iType == DAFF_REGION_RECORDS) &&
+			 (find(oRegion.viRecords.begin(), oRegion.viRecords.end(), i) != oRegion.viRecords.end())))
+			viRecords.push_back(i);
+	}
+	return viRecords;
+}
+
+//! Compares the records of a reader opened or attached with a region against the whole file
+static bool compareRegion(const DAFFReader* pFull, const DAFFReader* pReader, const DAFFRegion& oRegion,
+						  const string& sCase)
+{
+	vector<int> viRecords = pReader->getRegionRecords();
+	vector<int> viSorted = viRecords;
+	sort(viSorted.begin(), viSorted.end());
+	if (viSorted != getExpectedRecords(pFull, oRegion)) {
+		cerr << sCase << ": " << viRecords.size() << " records in the region, expected "
+			 << getExpectedRecords(pFull, oRegion).size() << endl;
+		return false;
+	}
+	return compareRecords(pFull, pReader, viRecords, vector<int>(), sCase);
+}
+
+//! Readers with a region hold the records of the region
+static bool testRegion(const DAFFReader* pFull, int iContentType)
+{
+	vector<DAFFRegion> voRegions(3);
+	voRegions[0].iType = DAFF_REGION_BETA_RANGE;
+	voRegions[0].fBetaStart = 30;
+	voRegions[0].fBetaEnd = 90;
+	voRegions[1].iType = DAFF_REGION_CONE;
+	voRegions[1].fConeAzimuth = 30;
+	voRegions[1].fConeElevation = 10;
+	voRegions[1].fConeAngle = 42;
+	voRegions[2].iType = DAFF_REGION_RECORDS;
+	voRegions[2].viRecords.push_back(100);
+	voRegions[2].viRecords.push_back(5);
+	voRegions[2].viRecords.push_back(17);
+
+	// Regions without records or with a record that does not exist
+	vector<DAFFRegion> voInvalidRegions(2);
+	voInvalidRegions[0].iType = DAFF_REGION_BETA_RANGE;
+	voInvalidRegions[0].fBetaStart = 31;
+	voInvalidRegions[0].fBetaEnd = 44;
+	voInvalidRegions[1].iType = DAFF_REGION_RECORDS;
+	voInvalidRegions[1].viRecords.push_back(100000);
+
+	bool bMatch = true;
+	for (int f = 0; bMatch && (f < NUM_OPEN_FLAGS); f++) {
+		DAFFReader* pReader = DAFFReader::create();
+		for (size_t n = 0; bMatch && (n < voRegions.size()); n++) {
+			string sCase = getCase(iContentType, OPEN_FLAGS[f]) + ", region " + to_string(voRegions[n].iType);
+			pReader->setRegion(voRegions[n]);
+			int ec = pReader->openFile(getFilePath(iContentType), OPEN_FLAGS[f]);
+			if (ec != DAFF_NO_ERROR) {
+				cerr << sCase << ": opening failed: " << DAFFUtils::StrError(ec) << endl;
+				bMatch = false;
+			}
+			bMatch = bMatch && compareRegion(pFull, pReader, voRegions[n], sCase);
+
+			if (bMatch && (pReader->publishShared(SHARED_NAME) != DAFF_MODAL_ERROR)) {
+				cerr << sCase << ": region published" << endl;
+				bMatch = false;
+			}
+			pReader->closeFile();
+		}
+
+		for (size_t n = 0; bMatch && (n < voInvalidRegions.size()); n++) {
+			pReader->setRegion(voInvalidRegions[n]);
+			int ec = pReader->openFile(getFilePath(iContentType), OPEN_FLAGS[f]);
+			if (ec != DAFF_INVALID_INDEX) {
+				cerr << getCase(iContentType, OPEN_FLAGS[f]) << ": invalid region " << n
+					 << " accepted: " << DAFFUtils::StrError(ec) << endl;
+				bMatch = false;
+			}
+		}
+		delete pReader;
+
+		// Attached readers can select regions
+		string sCase = getCase(iContentType, OPEN_FLAGS[f]) + ", region, shared";
+		DAFFReader* pPublisher = DAFFReader::create();
+		pReader = DAFFReader::create();
+		pReader->setRegion(voRegions[1]);
+		int ec = pPublisher->openFile(getFilePath(iContentType), OPEN_FLAGS[f]);
+		if (ec == DAFF_NO_ERROR)
+			ec = pPublisher->publishShared(SHARED_NAME);
+		if (ec == DAFF_NO_ERROR)
+			ec = pReader->attachShared(SHARED_NAME);
+		if (bMatch && (ec != DAFF_NO_ERROR)) {
+			cerr << sCase << ": publishing or attaching failed: " << DAFFUtils::StrError(ec) << endl;
+			bMatch = false;
+		}
+		bMatch = bMatch && compareRegion(pFull, pReader, voRegions[1], sCase);
+		delete pReader;
+		delete pPublisher;
+	}
+	return bMatch;
+}
+
+int main()
+{
+	int iFailures = 0;
+	for (int t = 0; t < NUM_CONTENT_TYPES; t++) {
+		int iContentType = CONTENT_TYPES[t];
+		DAFFReader* pFull = DAFFReader::create();
+		int ec = DAFF_NO_ERROR;
+		if (!writeFile(iContentType) || ((ec = pFull->openFile(getFilePath(iContentType))) != DAFF_NO_ERROR)) {
+			cerr << "Opening " << getFilePath(iContentType) << " failed: " << DAFFUtils::StrError(ec) << endl;
+			delete pFull;
+			return 1;
+		}
+
+		string sContentType = DAFFUtils::StrShortContentType(iContentType);
+		if (testSharedMemory(pFull, iContentType))
+			cout << sContentType << " shared memory OK" << endl;
+		else
+			iFailures++;
+
+		if (testChannelSelection(pFull, iContentType))
+			cout << sContentType << " channel selection OK" << endl;
+		else
+			iFailures++;
+
+		if (testRegion(pFull, iContentType))
+			cout << sContentType << " region OK" << endl;
+		else
+			iFailures++;
+
+		delete pFull;
+	}
+
+	return iFailures;
+}
@@ -127,6 +127,26 @@ int main()
 
 	r->closeFile();
 
+	// check asynchronous opening
+	{
+		int ec = r->openFileAsync("test_ir.daff");
+		if (ec == DAFF_NO_ERROR)
+			ec = r->waitForOpen();
+		if (ec != DAFF_NO_ERROR || !r->isFileOpened()) {
+			cerr << "Asynchronous opening failed: " << DAFFUtils::StrError(ec) << endl;
+			exit(1);
+		}
+
+		if (r->getContentType() == DAFF_IMPULSE_RESPONSE)
+			cout << "Asynchronous opening OK" << endl;
+		else {
+			cerr << "Incorrect content type after asynchronous opening" << endl;
+			exit(1);
+		}
+	}
+
+	r->closeFile();
+
 	delete r;
 
 	return 0;
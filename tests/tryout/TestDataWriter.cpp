@@ -0,0 +1,194 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+// Writes the test files of the bindings (bindings/c/testdata) into a directory:
+// every content type in every quantization it supports, on a 30 degree grid with
+// 2 channels of 16 values. Value 4 is 0.25 (left) and 0.5 (right), values 5 and 6
+// hold alpha/360 and beta/180 of each record. The files of the impulse responses in
+// INT16, FLOAT16, BFLOAT16 and INT16_BFP have no metadata, all others carry global
+// metadata with channel labels.
+//
+// Usage: TestDataWriter <directory>
+
+#include <DAFF.h>
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static const int NUM_CHANNELS = 2;
+static const int NUM_VALUES = 16;
+
+//! Global metadata of the test files (one key of every type and the channel labels)
+class TestMetadata : public DAFFMetadata {
+  public:
+	inline TestMetadata()
+	{
+		m_msStrings["DESCRIPTION"] = "OpenDAFF binding test file";
+		m_msStrings["LABEL_CHANNEL_1"] = "Left";
+		m_msStrings["LABEL_CHANNEL_2"] = "Right";
+	};
+
+	bool isEmpty() const { return false; };
+	bool hasKey(const string& sKey) const { return (getKeyType(sKey) != -1); };
+
+	void getKeys(vector<string>& vsKeyList) const
+	{
+		vsKeyList.clear();
+		vsKeyList.push_back("DESCRIPTION");
+		vsKeyList.push_back("LABEL_CHANNEL_1");
+		vsKeyList.push_back("LABEL_CHANNEL_2");
+		vsKeyList.push_back("REFERENCE");
+		vsKeyList.push_back("NUM_SOURCES");
+		vsKeyList.push_back("DISTANCE");
+	};
+
+	int getKeyType(const string& sKey) const
+	{
+		if (m_msStrings.count(sKey))
+			return DAFF_STRING;
+		if (sKey == "REFERENCE")
+			return DAFF_BOOL;
+		if (sKey == "NUM_SOURCES")
+			return DAFF_INT;
+		if (sKey == "DISTANCE")
+			return DAFF_FLOAT;
+		return -1;
+	};
+
+	string getKeyString(const string& sKey) const
+	{
+		map<string, string>::const_iterator it = m_msStrings.find(sKey);
+		return (it != m_msStrings.end() ? it->second : "");
+	};
+
+	const char* getKeyStringPtr(const string& sKey) const
+	{
+		map<string, string>::const_iterator it = m_msStrings.find(sKey);
+		return (it != m_msStrings.end() ? it->second.c_str() : NULL);
+	};
+
+	bool getKeyBool(const string& sKey) const { return (sKey == "REFERENCE"); };
+	int getKeyInt(const string& sKey) const { return (sKey == "NUM_SOURCES" ? 1 : 0); };
+	double getKeyFloat(const string& sKey) const { return (sKey == "DISTANCE" ? 1.5 : getKeyInt(sKey)); };
+	string toString() const { return "Test metadata"; };
+
+  private:
+	map<string, string> m_msStrings;  //!@ String keys
+};
+
+//! Impulse at value 4, the direction of the record in the values 5 and 6 (zero otherwise)
+class TestDataCallback : public DAFFWriterCallback {
+  public:
+	int getRecordData(int, float fAlphaDeg, float fBetaDeg, float** ppfChannelData)
+	{
+		for (int c = 0; c < NUM_CHANNELS; c++) {
+			ppfChannelData[c][4] = 0.25f * (c + 1);
+			ppfChannelData[c][5] = fAlphaDeg / 360;
+			ppfChannelData[c][6] = fBetaDeg / 180;
+		}
+		return DAFF_NO_ERROR;
+	}
+};
+
+//! Name of a quantization in the file names (as reported by the Python binding)
+static string getQuantizationName(int iQuantization)
+{
+	switch (iQuantization) {
+	case DAFF_INT16:
+		return "int16";
+	case DAFF_INT24:
+		return "int24";
+	case DAFF_FLOAT32:
+		return "float32";
+	case DAFF_FLOAT16:
+		return "float16";
+	case DAFF_BFLOAT16:
+		return "bfloat16";
+	case DAFF_INT16_BFP:
+		return "int16_bfp";
+	}
+	return "invalid";
+}
+
+static bool writeFile(const string& sDirectory, int iContentType, int iQuantization, bool bMetadata)
+{
+	vector<float> vfFrequencies;
+	for (int k = 0; k < NUM_VALUES; k++)
+		vfFrequencies.push_back(1000.0f * (k + 1));
+
+	DAFFWriter w;
+	switch (iContentType) {
+	case DAFF_IMPULSE_RESPONSE:
+		w.setImpulseResponses(NUM_VALUES, 44100);
+		break;
+	case DAFF_MAGNITUDE_SPECTRUM:
+		w.setMagnitudeSpectra(vfFrequencies);
+		break;
+	case DAFF_PHASE_SPECTRUM:
+		w.setPhaseSpectra(vfFrequencies);
+		break;
+	case DAFF_MAGNITUDE_PHASE_SPECTRUM:
+		w.setMagnitudePhaseSpectra(vfFrequencies);
+		break;
+	case DAFF_DFT_SPECTRUM:
+		w.setDFTSpectra(2 * (NUM_VALUES - 1), 44100);
+		break;
+	}
+	w.setNumChannels(NUM_CHANNELS);
+	w.setQuantization(iQuantization);
+	w.setGrid(12, 0, 360, 7, 0, 180);
+
+	TestMetadata oMetadata;
+	if (bMetadata)
+		w.setMetadata(&oMetadata);
+
+	string sFilePath = sDirectory + "/" + DAFFUtils::StrShortContentType(iContentType) + "_" +
+					   getQuantizationName(iQuantization) + ".daff";
+
+	TestDataCallback oCallback;
+	int ec = w.write(sFilePath, &oCallback);
+	if (ec != DAFF_NO_ERROR)
+		cerr << "Writing " << sFilePath << " failed: " << DAFFUtils::StrError(ec) << endl;
+	else
+		cout << sFilePath << endl;
+	return (ec == DAFF_NO_ERROR);
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2) {
+		cerr << "Usage: TestDataWriter <directory>" << endl;
+		return 1;
+	}
+	string sDirectory = argv[1];
+
+	// Impulse responses of the Go and Rust tests
+	bool bSuccess = writeFile(sDirectory, DAFF_IMPULSE_RESPONSE, DAFF_INT16, false) &&
+					writeFile(sDirectory, DAFF_IMPULSE_RESPONSE, DAFF_FLOAT16, false) &&
+					writeFile(sDirectory, DAFF_IMPULSE_RESPONSE, DAFF_BFLOAT16, false) &&
+					writeFile(sDirectory, DAFF_IMPULSE_RESPONSE, DAFF_INT16_BFP, false) &&
+					writeFile(sDirectory, DAFF_IMPULSE_RESPONSE, DAFF_INT24, true) &&
+					writeFile(sDirectory, DAFF_IMPULSE_RESPONSE, DAFF_FLOAT32, true);
+
+	// Spectra in the floating-point quantizations
+	static const int SPECTRA[] = {DAFF_MAGNITUDE_SPECTRUM, DAFF_PHASE_SPECTRUM, DAFF_MAGNITUDE_PHASE_SPECTRUM,
+								  DAFF_DFT_SPECTRUM};
+	static const int QUANTIZATIONS[] = {DAFF_FLOAT32, DAFF_FLOAT16, DAFF_BFLOAT16};
+	for (int t = 0; bSuccess && (t < 4); t++)
+		for (int q = 0; bSuccess && (q < 3); q++)
+			bSuccess = writeFile(sDirectory, SPECTRA[t], QUANTIZATIONS[q], true);
+
+	return (bSuccess ? 0 : 1);
+}
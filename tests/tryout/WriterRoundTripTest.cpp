@@ -0,0 +1,532 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016-2018 Institute of Technical Acoustics (ITA), RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+// Writes the optional file features with DAFFWriter, compares them against a plain
+// INT16 reference file and checks that corrupted blocks are rejected
+
+#include <DAFF.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <math.h>
+
+// Two quantization steps of INT16
+#define EPSILON (2.0f / 32767)
+
+using namespace std;
+
+static const string REFERENCE_FILE = "roundtrip_reference.daff";
+static const string AXIAL_REFERENCE_FILE = "roundtrip_reference_axial.daff";
+static const int NUM_CHANNELS = 2;
+static const int FILTER_LENGTH = 64;
+
+//! Open flags every file is compared with
+static const int OPEN_FLAGS[] = {DAFF_OPEN_DEFAULT, DAFF_OPEN_MAPPED, DAFF_OPEN_LAZY, DAFF_OPEN_DECODE};
+static const int NUM_OPEN_FLAGS = sizeof(OPEN_FLAGS) / sizeof(int);
+
+//! Impulse responses that are mirror symmetric at the plane alpha = 0/180 (with reversed channels)
+class RoundTripCallback : public DAFFWriterCallback {
+  public:
+	bool bAxial;  //!@ Impulse responses do not depend on alpha (rotational symmetry)
+
+	inline RoundTripCallback() : bAxial(false) {};
+
+	int getRecordData(int, float fAlphaDeg, float fBetaDeg, float** ppfChannelData)
+	{
+		float fAlpha = fAlphaDeg * 3.14159265f / 180;
+		float fCos = (bAxial ? 1 : cosf(fAlpha));
+		float fSin = (bAxial ? 0 : sinf(fAlpha));
+		for (int c = 0; c < NUM_CHANNELS; c++) {
+			float fSide = (c == 0 ? 1.0f : -1.0f);
+			for (int k = 8; k < FILTER_LENGTH - 8; k++)
+				ppfChannelData[c][k] = 0.4f * cosf(0.3f * k + 0.01f * fBetaDeg) * (0.6f + 0.2f * fCos) +
+									   0.2f * fSide * fSin * sinf(0.7f * k);
+		}
+		return DAFF_NO_ERROR;
+	}
+};
+
+//! Configures the content and the grid of the reference file
+static void configureWriter(DAFFWriter& w)
+{
+	w.setImpulseResponses(FILTER_LENGTH, 44100);
+	w.setQuantization(DAFF_INT16);
+	w.setNumChannels(NUM_CHANNELS);
+	w.setGrid(36, 0, 360, 19, 0, 180);
+}
+
+static bool writeFile(DAFFWriter& w, const string& sFilePath, bool bAxial = false)
+{
+	RoundTripCallback oCallback;
+	oCallback.bAxial = bAxial;
+	int ec = w.write(sFilePath, &oCallback);
+	if (ec != DAFF_NO_ERROR)
+		cerr << "Writing " << sFilePath << " failed: " << DAFFUtils::StrError(ec) << endl;
+	return (ec == DAFF_NO_ERROR);
+}
+
+//! Compares all records of a file with the reference (by direction, the record indices may differ)
+static bool compareFile(const string& sReference, const string& sFilePath, int iOpenFlags)
+{
+	DAFFReader* pReference = DAFFReader::create();
+	DAFFReader* pReader = DAFFReader::create();
+
+	int ec = pReference->openFile(sReference);
+	if (ec == DAFF_NO_ERROR)
+		ec = pReader->openFile(sFilePath, iOpenFlags);
+	if (ec != DAFF_NO_ERROR) {
+		cerr << "Opening " << sFilePath << " (flags " << iOpenFlags << ") failed: " << DAFFUtils::StrError(ec) << endl;
+		delete pReference;
+		delete pReader;
+		return false;
+	}
+
+	const DAFFContentIR* x = dynamic_cast<const DAFFContentIR*>(pReference->getContent());
+	const DAFFContentIR* y = dynamic_cast<const DAFFContentIR*>(pReader->getContent());
+	int iNumRecords = x->getProperties()->getNumberOfRecords();
+	bool bMatch = (y != NULL) && (y->getProperties()->getNumberOfRecords() == iNumRecords) &&
+				  (y->getProperties()->getNumberOfChannels() == NUM_CHANNELS) &&
+				  (y->getFilterLength() == FILTER_LENGTH);
+
+	vector<float> vfExpected(FILTER_LENGTH), vfActual(FILTER_LENGTH);
+	for (int i = 0; bMatch && (i < iNumRecords); i++) {
+		float fAlpha, fBeta, fAlphaFound, fBetaFound;
+		int iRecordIndex;
+		bool bOutOfBounds;
+		x->getRecordCoords(i, DAFF_DATA_VIEW, fAlpha, fBeta);
+		y->getNearestNeighbour(DAFF_DATA_VIEW, fAlpha, fBeta, iRecordIndex, bOutOfBounds);
+		y->getRecordCoords(iRecordIndex, DAFF_DATA_VIEW, fAlphaFound, fBetaFound);
+
+		// Alpha is arbitrary at the poles
+		float fAlphaDiff = fabsf(fAlpha - fAlphaFound);
+		bool bPole = (fBeta < EPSILON) || (fBeta > 180 - EPSILON);
+		if (!bPole && (fAlphaDiff > 1e-3f) && (fabsf(fAlphaDiff - 360) > 1e-3f))
+			bMatch = false;
+		if (fabsf(fBeta - fBetaFound) > 1e-3f)
+			bMatch = false;
+
+		for (int c = 0; bMatch && (c < NUM_CHANNELS); c++) {
+			x->getFilterCoeffs(i, c, &vfExpected[0]);
+			if (y->getFilterCoeffs(iRecordIndex, c, &vfActual[0]) != DAFF_NO_ERROR)
+				bMatch = false;
+			for (int k = 0; k < FILTER_LENGTH; k++)
+				if (fabsf(vfExpected[k] - vfActual[k]) > EPSILON)
+					bMatch = false;
+		}
+
+		if (!bMatch)
+			cerr << "Record " << i << " (A" << fAlpha << " B" << fBeta << ") does not match" << endl;
+	}
+
+	if (!bMatch)
+		cerr << sFilePath << " (flags " << iOpenFlags << ") does not match the reference" << endl;
+
+	delete pReference;
+	delete pReader;
+	return bMatch;
+}
+
+static bool compareFile(const string& sFilePath, const string& sReference = REFERENCE_FILE)
+{
+	for (int f = 0; f < NUM_OPEN_FLAGS; f++)
+		if (!compareFile(sReference, sFilePath, OPEN_FLAGS[f]))
+			return false;
+	return true;
+}
+
+//! Copies a file and overwrites bytes of a file block of the copy
+/**
+ * \param [in] iBlockID		ID of the file block (first block of that ID)
+ * \param [in] ui64Offset	Position within the file block [Bytes]
+ */
+static bool corruptFile(const string& sFilePath, const string& sCorruptedPath, int iBlockID, uint64_t ui64Offset,
+						const void* pData, size_t nSize)
+{
+	ifstream in(sFilePath.c_str(), ios::binary);
+	vector<char> vcFile((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+
+	// Little endian file header (signature, version, number of blocks) and block entries (ID, offset, size)
+	const size_t nHeaderSize = 10, nEntrySize = 20;
+	int32_t iNumBlocks = 0;
+	if (vcFile.size() >= nHeaderSize)
+		memcpy(&iNumBlocks, &vcFile[6], 4);
+
+	for (int i = 0; i < iNumBlocks; i++) {
+		size_t nEntry = nHeaderSize + i * nEntrySize;
+		int32_t iID;
+		uint64_t ui64BlockOffset, ui64BlockSize;
+		memcpy(&iID, &vcFile[nEntry], 4);
+		memcpy(&ui64BlockOffset, &vcFile[nEntry + 4], 8);
+		memcpy(&ui64BlockSize, &vcFile[nEntry + 12], 8);
+		if ((iID != iBlockID) || (ui64Offset + nSize > ui64BlockSize))
+			continue;
+
+		memcpy(&vcFile[(size_t)(ui64BlockOffset + ui64Offset)], pData, nSize);
+		ofstream out(sCorruptedPath.c_str(), ios::binary);
+		out.write(&vcFile[0], vcFile.size());
+		return out.good();
+	}
+
+	cerr << "File block " << iBlockID << " not found in " << sFilePath << endl;
+	return false;
+}
+
+//! Checks that opening a file fails with an error (with all open flags)
+static bool expectError(const string& sFilePath, int iExpectedError, int iExtraFlags = 0)
+{
+	DAFFReader* pReader = DAFFReader::create();
+	bool bExpected = true;
+	for (int f = 0; bExpected && (f < NUM_OPEN_FLAGS); f++) {
+		int ec = pReader->openFile(sFilePath, OPEN_FLAGS[f] | iExtraFlags);
+		if (ec != iExpectedError) {
+			cerr << "Opening " << sFilePath << " (flags " << (OPEN_FLAGS[f] | iExtraFlags)
+				 << ") returned: " << DAFFUtils::StrError(ec) << endl;
+			bExpected = false;
+		}
+		pReader->closeFile();
+	}
+
+	delete pReader;
+	return bExpected;
+}
+
+//! Irregular grid (record directions block) with the directions of the reference grid in reverse order
+static bool testIrregularGrid()
+{
+	DAFFWriter oGrid;
+	configureWriter(oGrid);
+
+	vector<float> vfAlpha, vfBeta;
+	for (int i = oGrid.getNumRecords() - 1; i >= 0; i--) {
+		float fAlpha, fBeta;
+		oGrid.getRecordCoords(i, fAlpha, fBeta);
+		vfAlpha.push_back(fAlpha < 360 ? fAlpha : 0);
+		vfBeta.push_back(fBeta);
+	}
+
+	DAFFWriter w;
+	configureWriter(w);
+	w.setRecordDirections(vfAlpha, vfBeta);
+	if (!writeFile(w, "roundtrip_irregular.daff") || !compareFile("roundtrip_irregular.daff"))
+		return false;
+
+	DAFFReader* pReader = DAFFReader::create();
+	bool bRegular = (pReader->openFile("roundtrip_irregular.daff") != DAFF_NO_ERROR) ||
+					pReader->getContent()->getProperties()->isRegularGrid();
+	delete pReader;
+	if (bRegular) {
+		cerr << "Irregular grid not recognized" << endl;
+		return false;
+	}
+
+	// Beta out of range
+	float fBeta = 200;
+	return corruptFile("roundtrip_irregular.daff", "roundtrip_irregular_corrupted.daff",
+					   0x0007 /* record directions */, 4, &fBeta, sizeof(float)) &&
+		   expectError("roundtrip_irregular_corrupted.daff", DAFF_FILE_CORRUPTED);
+}
+
+//! Compressed data block
+static bool testCompression()
+{
+	DAFFWriter w;
+	configureWriter(w);
+	w.setCompression(true);
+	if (!writeFile(w, "roundtrip_compressed.daff") || !compareFile("roundtrip_compressed.daff"))
+		return false;
+
+	// Size of the uncompressed data far beyond the record channels (must be rejected before the allocation)
+	uint64_t ui64DataSize = (uint64_t)1 << 30;
+	return corruptFile("roundtrip_compressed.daff", "roundtrip_compressed_corrupted.daff",
+					   0x0008 /* compressed data */, 4, &ui64DataSize, sizeof(uint64_t)) &&
+		   expectError("roundtrip_compressed_corrupted.daff", DAFF_FILE_CORRUPTED);
+}
+
+//! Record channels aligned to cache lines
+static bool testAlignment()
+{
+	DAFFWriter w;
+	configureWriter(w);
+	w.setDataAlignment(64);
+	if (!writeFile(w, "roundtrip_aligned.daff") || !compareFile("roundtrip_aligned.daff"))
+		return false;
+
+	for (int f = 0; f < 2; f++) {
+		DAFFReader* pReader = DAFFReader::create();
+		int ec = pReader->openFile("roundtrip_aligned.daff", (f == 0 ? DAFF_OPEN_DEFAULT : DAFF_OPEN_MAPPED));
+		int iAlignment = (ec == DAFF_NO_ERROR ? pReader->getDataAlignment() : 0);
+		delete pReader;
+		if (iAlignment < 64) {
+			cerr << "Record data aligned to " << iAlignment << " Bytes only" << endl;
+			return false;
+		}
+	}
+
+	// Data offset of the first record channel behind the data block
+	uint64_t ui64DataOffset = (uint64_t)1 << 40;
+	return corruptFile("roundtrip_aligned.daff", "roundtrip_aligned_corrupted.daff", 0x0003 /* record descriptors */,
+					   4, &ui64DataOffset, sizeof(uint64_t)) &&
+		   expectError("roundtrip_aligned_corrupted.daff", DAFF_FILE_CORRUPTED);
+}
+
+//! Deduplicated record channels (the impulse responses of a rotationally symmetric source repeat along alpha)
+static bool testDeduplication()
+{
+	DAFFWriter w;
+	configureWriter(w);
+	w.setDeduplication(true);
+	if (!writeFile(w, "roundtrip_deduplicated.daff", true) ||
+		!compareFile("roundtrip_deduplicated.daff", AXIAL_REFERENCE_FILE))
+		return false;
+
+	DAFFReader* pReader = DAFFReader::create();
+	int ec = pReader->openFile("roundtrip_deduplicated.daff");
+	int iNumShared = (ec == DAFF_NO_ERROR ? pReader->getNumSharedRecordChannels() : 0);
+	delete pReader;
+	if (iNumShared == 0) {
+		cerr << "No shared record channels" << endl;
+		return false;
+	}
+
+	// Length of the (shared) first record channel beyond the data block
+	int32_t iElementLength = 1 << 20;
+	return corruptFile("roundtrip_deduplicated.daff", "roundtrip_deduplicated_corrupted.daff",
+					   0x0003 /* record descriptors */, 16, &iElementLength, sizeof(int32_t)) &&
+		   expectError("roundtrip_deduplicated_corrupted.daff", DAFF_FILE_CORRUPTED);
+}
+
+//! Symmetric grids (only the unique records are stored)
+static bool testSymmetry()
+{
+	DAFFWriter w;
+	configureWriter(w);
+	w.setSymmetry(DAFF_SYMMETRY_MIRROR);
+	if (!writeFile(w, "roundtrip_mirror.daff") || !compareFile("roundtrip_mirror.daff"))
+		return false;
+
+	w.setSymmetry(DAFF_SYMMETRY_AXIAL);
+	if (!writeFile(w, "roundtrip_axial.daff", true) || !compareFile("roundtrip_axial.daff", AXIAL_REFERENCE_FILE))
+		return false;
+
+	DAFFReader* pReader = DAFFReader::create();
+	bool bSymmetric = (pReader->openFile("roundtrip_mirror.daff") == DAFF_NO_ERROR) &&
+					  (pReader->getSymmetry() == DAFF_SYMMETRY_MIRROR) &&
+					  (pReader->getNumStoredRecords() < pReader->getContent()->getProperties()->getNumberOfRecords());
+	delete pReader;
+	if (!bSymmetric) {
+		cerr << "Mirror symmetry not recognized" << endl;
+		return false;
+	}
+
+	// Odd number of alpha points of the full grid
+	int32_t iAlphaPoints = 35;
+	return corruptFile("roundtrip_mirror.daff", "roundtrip_mirror_corrupted.daff", 0x0009 /* symmetry */, 4,
+					   &iAlphaPoints, sizeof(int32_t)) &&
+		   expectError("roundtrip_mirror_corrupted.daff", DAFF_FILE_CORRUPTED);
+}
+
+//! Checksums of the file blocks (verified on open, lazily loaded data on first access)
+static bool testChecksums()
+{
+	DAFFWriter w;
+	configureWriter(w);
+	w.setChecksums(true);
+	if (!writeFile(w, "roundtrip_checksums.daff") || !compareFile("roundtrip_checksums.daff"))
+		return false;
+
+	DAFFReader* pReader = DAFFReader::create();
+	bool bVerified = (pReader->openFile("roundtrip_checksums.daff", DAFF_OPEN_VERIFY) == DAFF_NO_ERROR) &&
+					 pReader->hasChecksums();
+	delete pReader;
+	if (!bVerified) {
+		cerr << "Checksums not verified" << endl;
+		return false;
+	}
+
+	// A modified sample is only detected with verification
+	int16_t iSample = 0x1234;
+	if (!corruptFile("roundtrip_checksums.daff", "roundtrip_checksums_corrupted.daff", 0x0004 /* data */, 0, &iSample,
+					 sizeof(int16_t)) ||
+		!expectError("roundtrip_checksums_corrupted.daff", DAFF_NO_ERROR))
+		return false;
+
+	pReader = DAFFReader::create();
+	bool bDetected = true;
+	for (int f = 0; bDetected && (f < NUM_OPEN_FLAGS); f++) {
+		int ec = pReader->openFile("roundtrip_checksums_corrupted.daff", OPEN_FLAGS[f] | DAFF_OPEN_VERIFY);
+		int iExpectedError = DAFF_FILE_CHECKSUM_MISMATCH;
+
+		// Lazily loaded record channels are verified when they are read (the access fails)
+		if ((ec == DAFF_NO_ERROR) && (OPEN_FLAGS[f] & DAFF_OPEN_LAZY)) {
+			iExpectedError = DAFF_FILE_CORRUPTED;
+			const DAFFContentIR* x = dynamic_cast<const DAFFContentIR*>(pReader->getContent());
+			vector<float> vfCoeffs(FILTER_LENGTH);
+			for (int i = 0; (ec == DAFF_NO_ERROR) && (i < x->getProperties()->getNumberOfRecords()); i++)
+				for (int c = 0; (ec == DAFF_NO_ERROR) && (c < NUM_CHANNELS); c++)
+					ec = x->getFilterCoeffs(i, c, &vfCoeffs[0]);
+		}
+
+		if (ec != iExpectedError) {
+			cerr << "Corrupted data (flags " << OPEN_FLAGS[f] << ") not detected: " << DAFFUtils::StrError(ec) << endl;
+			bDetected = false;
+		}
+		pReader->closeFile();
+	}
+
+	delete pReader;
+	return bDetected;
+}
+
+//! Resolution levels (record data of coarse subgrids first, also streamed)
+static bool testLevels()
+{
+	DAFFWriter w;
+	configureWriter(w);
+	w.setNumLevels(3);
+	if (!writeFile(w, "roundtrip_levels.daff") || !compareFile("roundtrip_levels.daff") ||
+		!compareFile(REFERENCE_FILE, "roundtrip_levels.daff", DAFF_OPEN_STREAM))
+		return false;
+
+	DAFFReader* pReader = DAFFReader::create();
+	int ec = pReader->openFile("roundtrip_levels.daff");
+	int iNumLevels = (ec == DAFF_NO_ERROR ? pReader->getNumLevels() : 0);
+	delete pReader;
+	if (iNumLevels != 3) {
+		cerr << "Expected 3 levels, found " << iNumLevels << endl;
+		return false;
+	}
+
+	// Step of the coarsest level zero
+	int32_t iStep = 0;
+	return corruptFile("roundtrip_levels.daff", "roundtrip_levels_corrupted.daff", 0x000C /* levels */, 8, &iStep,
+					   sizeof(int32_t)) &&
+		   expectError("roundtrip_levels_corrupted.daff", DAFF_FILE_CORRUPTED);
+}
+
+//! Block floating point impulse responses (16-Bit samples with a scale per record channel)
+static bool testBlockFloatingPoint()
+{
+	DAFFWriter w;
+	configureWriter(w);
+	w.setQuantization(DAFF_INT16_BFP);
+	if (!writeFile(w, "roundtrip_bfp.daff") || !compareFile("roundtrip_bfp.daff"))
+		return false;
+
+	DAFFReader* pReader = DAFFReader::create();
+	int ec = pReader->openFile("roundtrip_bfp.daff");
+	bool bBFP = (ec == DAFF_NO_ERROR) && (pReader->getProperties()->getQuantization() == DAFF_INT16_BFP) &&
+				(pReader->getRecordChannelScale(0, 0) > 0);
+	delete pReader;
+	if (!bBFP) {
+		cerr << "Block floating point quantization not recognized" << endl;
+		return false;
+	}
+
+	// Negative scale of the first record channel
+	float fScale = -1;
+	return corruptFile("roundtrip_bfp.daff", "roundtrip_bfp_corrupted.daff", 0x0003 /* record descriptors */, 20,
+					   &fScale, sizeof(float)) &&
+		   expectError("roundtrip_bfp_corrupted.daff", DAFF_FILE_CORRUPTED);
+}
+
+//! Record data along a space-filling curve (with and without levels)
+static bool testRecordOrder()
+{
+	DAFFWriter w;
+	configureWriter(w);
+	w.setRecordOrder(DAFF_RECORD_ORDER_HILBERT);
+	if (!writeFile(w, "roundtrip_hilbert.daff") || !compareFile("roundtrip_hilbert.daff"))
+		return false;
+
+	w.setRecordOrder(DAFF_RECORD_ORDER_MORTON);
+	w.setNumLevels(3);
+	if (!writeFile(w, "roundtrip_morton_levels.daff") || !compareFile("roundtrip_morton_levels.daff"))
+		return false;
+
+	DAFFReader* pReader = DAFFReader::create();
+	int ec = pReader->openFile("roundtrip_hilbert.daff");
+	int iRecordOrder = (ec == DAFF_NO_ERROR ? pReader->getRecordOrder() : DAFF_RECORD_ORDER_INDEX);
+	delete pReader;
+	if (iRecordOrder != DAFF_RECORD_ORDER_HILBERT) {
+		cerr << "Hilbert record order not recognized" << endl;
+		return false;
+	}
+
+	// Unknown record order
+	int32_t iOrder = 7;
+	return corruptFile("roundtrip_hilbert.daff", "roundtrip_hilbert_corrupted.daff", 0x000D /* record order */, 0,
+					   &iOrder, sizeof(int32_t)) &&
+		   expectError("roundtrip_hilbert_corrupted.daff", DAFF_FILE_CORRUPTED);
+}
+
+int main()
+{
+	DAFFWriter w;
+	configureWriter(w);
+	if (!writeFile(w, REFERENCE_FILE) || !compareFile(REFERENCE_FILE))
+		return 1;
+	if (!writeFile(w, AXIAL_REFERENCE_FILE, true) || !compareFile(AXIAL_REFERENCE_FILE, AXIAL_REFERENCE_FILE))
+		return 1;
+
+	int iFailures = 0;
+	if (testIrregularGrid())
+		cout << "Irregular grid OK" << endl;
+	else
+		iFailures++;
+
+	if (testCompression())
+		cout << "Compression OK" << endl;
+	else
+		iFailures++;
+
+	if (testAlignment())
+		cout << "Alignment OK" << endl;
+	else
+		iFailures++;
+
+	if (testDeduplication())
+		cout << "Deduplication OK" << endl;
+	else
+		iFailures++;
+
+	if (testSymmetry())
+		cout << "Symmetry OK" << endl;
+	else
+		iFailures++;
+
+	if (testChecksums())
+		cout << "Checksums OK" << endl;
+	else
+		iFailures++;
+
+	if (testLevels())
+		cout << "Levels OK" << endl;
+	else
+		iFailures++;
+
+	if (testBlockFloatingPoint())
+		cout << "Block floating point OK" << endl;
+	else
+		iFailures++;
+
+	if (testRecordOrder())
+		cout << "Record order OK" << endl;
+	else
+		iFailures++;
+
+	return iFailures;
+}
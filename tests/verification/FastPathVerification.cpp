@@ -0,0 +1,565 @@
+/*
+ * -------------------------------------------------------------------------------------
+ *
+ *  OpenDAFF - A free, open source software package for directional audio data
+ *  Copyright 2016 Institute of Technical Acoustics, RWTH Aachen University
+ *  OpenDAFF is distributed under the Apache License Version 2.0.
+ *
+ *  ------------------------------------------------------------------------------------
+ *
+ */
+
+/*
+ * Accuracy versus speed of the fast paths
+ *
+ * Every single precision fast path of the library is compared against a double precision
+ * reference on the same pseudo-random queries (uniform directions on the sphere):
+ *
+ *   osc2dsc, dsc2osc  Batch DAFFSCTransform (SIMD, polynomial trigonometry)
+ *                     against the double precision transform of every direction
+ *   nn_scalar         getNearestNeighbour in the object view
+ *   nn_batch          getNearestNeighbours in the object view (batch transform)
+ *   lut_1, lut_0.25   DAFFDirectionLUT in the object view (1 and 0.25 degree tables)
+ *                     against the double precision transform and a data view lookup
+ *   mps               getCoefficientsMP (SIMD hypot/atan2) against the double precision
+ *                     magnitudes and phases of getDFTCoeffs
+ *
+ * The set covers the grids and orientations of the verification files, and any files
+ * given on the command line. Reported are the maximum angular error of the transforms
+ * (great-circle distance) or the phases, the maximum relative error of the magnitudes,
+ * the record index mismatches per million queries and the speedup over the reference.
+ * A mismatch is accepted if the fast record is also the reference result of a direction
+ * within the transform tolerance (for the lookup tables: around the table node the query
+ * rounds to), all others count as hard mismatches and fail the path. The exit code is 0 if all paths
+ * pass.
+ *
+ * Usage: FastPathVerification [-f text|csv|json] [-n queries] [-d directory] [-k] [-q] [files...]
+ *
+ *   -f  Output format (default: text)
+ *   -n  Number of queries per grid and orientation (default: 65536)
+ *   -d  Directory for the generated files (default: working directory)
+ *   -k  Keep the generated files
+ *   -q  Quick run (coarse grids and fewer orientations only)
+ */
+
+#include <DAFF.h>
+
+#include "../benchmark/BenchmarkData.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+static const double PI_D = 3.14159265358979323846;
+static const int NUM_REPEATS = 3;                // Timed repetitions (the fastest counts)
+static const double TRANSFORM_TOLERANCE = 1e-3;  // Tolerance of the transforms [degrees]
+static const double MAGNITUDE_TOLERANCE = 1e-5;  // Relative tolerance of the magnitudes
+static const double PHASE_TOLERANCE = 1e-3;      // Tolerance of the phases [degrees]
+
+static volatile float g_fSink = 0;  // Defeats the elimination of unused results
+
+//! Result of a fast path on a file and orientation
+struct Result {
+	std::string sPath;             //!@ Fast path
+	std::string sFile;             //!@ File (grid)
+	std::string sOrientation;      //!@ Orientation (yaw-pitch-roll)
+	long lQueries;                 //!@ Number of queries (directions or coefficients)
+	double dMaxErrorDeg;           //!@ Maximum angular or phase error [degrees] (-1: not applicable)
+	double dMaxRelError;           //!@ Maximum relative magnitude error (-1: not applicable)
+	double dMismatchesPerMillion;  //!@ Record index mismatches per million queries (-1: not applicable)
+	long lHardMismatches;          //!@ Mismatches outside of the tolerance
+	double dSpeedup;               //!@ Reference time divided by the fast path time
+	bool bPass;                    //!@ Within the tolerances
+};
+
+//! Query directions
+struct Queries {
+	std::vector<float> vfAzimuth;    //!@ Object view azimuths [degrees]
+	std::vector<float> vfElevation;  //!@ Object view elevations [degrees]
+
+	Queries(int iNumQueries)
+	{
+		Random oRandom(4711u);
+		for (int i = 0; i < iNumQueries; i++) {
+			// Uniform on the sphere
+			vfAzimuth.push_back(360 * oRandom.next() - 180);
+			vfElevation.push_back((float)(asin(2 * oRandom.next() - 1.0) * 180 / PI_D));
+		}
+	};
+};
+
+static double Seconds(Clock::time_point t0, Clock::time_point t1)
+{
+	return std::chrono::duration<double>(t1 - t0).count();
+}
+
+//! Great-circle distance of two directions given by their polar angles from the same pole [degrees]
+static double Distance(double dAzimuth1Deg, double dPolar1Deg, double dAzimuth2Deg, double dPolar2Deg)
+{
+	double a1 = dAzimuth1Deg * PI_D / 180, p1 = dPolar1Deg * PI_D / 180;
+	double a2 = dAzimuth2Deg * PI_D / 180, p2 = dPolar2Deg * PI_D / 180;
+	double x1 = sin(p1) * cos(a1), y1 = sin(p1) * sin(a1), z1 = cos(p1);
+	double x2 = sin(p2) * cos(a2), y2 = sin(p2) * sin(a2), z2 = cos(p2);
+	double cx = y1 * z2 - z1 * y2, cy = z1 * x2 - x1 * z2, cz = x1 * y2 - y1 * x2;
+	return atan2(sqrt(cx * cx + cy * cy + cz * cz), x1 * x2 + y1 * y2 + z1 * z2) * 180 / PI_D;
+}
+
+//! Reference nearest neighbour of an object view direction (double precision transform, data view lookup)
+static int ReferenceRecord(const DAFFContent* pContent, const DAFFSCTransform& oTransform, double dAzimuthDeg,
+						   double dElevationDeg)
+{
+	double dAlpha, dBeta;
+	oTransform.transformOSC2DSC(dAzimuthDeg, dElevationDeg, dAlpha, dBeta);
+	int iRecordIndex;
+	pContent->getNearestNeighbour(DAFF_DATA_VIEW, (float)dAlpha, (float)dBeta, iRecordIndex);
+	return iRecordIndex;
+}
+
+//! Accepts a mismatch if the record is the reference result of a direction within the tolerance
+static bool IsWithinTolerance(const DAFFContent* pContent, const DAFFSCTransform& oTransform, float fAzimuthDeg,
+							  float fElevationDeg, int iRecordIndex, double dToleranceDeg)
+{
+	// Lattice of 5 x 5 directions around the query
+	for (int i = -2; i <= 2; i++) {
+		for (int j = -2; j <= 2; j++) {
+			double dAzimuth = fAzimuthDeg + i * dToleranceDeg / 2;
+			double dElevation = std::max(-90.0, std::min(90.0, fElevationDeg + j * dToleranceDeg / 2));
+			if (ReferenceRecord(pContent, oTransform, dAzimuth, dElevation) == iRecordIndex)
+				return true;
+		}
+	}
+	return false;
+}
+
+//! Accepts a lookup table mismatch if the record is the reference result of the table node of the query
+static bool IsTableNodeRecord(const DAFFContent* pContent, const DAFFSCTransform& oTransform, float fAzimuthDeg,
+							  float fElevationDeg, int iRecordIndex, float fStep1Deg, float fStep2Deg)
+{
+	// Object view tables start at -180 degrees azimuth and -90 degrees elevation
+	double dAzimuth = -180 + floor((fAzimuthDeg + 180) / fStep1Deg + 0.5) * fStep1Deg;
+	double dElevation = std::min(90.0, -90 + floor((fElevationDeg + 90) / fStep2Deg + 0.5) * fStep2Deg);
+	return IsWithinTolerance(pContent, oTransform, (float)dAzimuth, (float)dElevation, iRecordIndex,
+							 TRANSFORM_TOLERANCE);
+}
+
+//! Fast batch transforms against the double precision transform of every direction
+static void VerifyTransform(const DAFFOrientationYPR& oOrient, const std::string& sOrient, const Queries& oQueries,
+							bool bObjectToData, std::vector<Result>& vResults)
+{
+	DAFFSCTransform oTransform(oOrient);
+	size_t n = oQueries.vfAzimuth.size();
+
+	// Inputs of the direction, data view inputs are the reference transforms of the object view directions
+	std::vector<float> vfIn1(n), vfIn2(n);
+	for (size_t i = 0; i < n; i++) {
+		if (bObjectToData) {
+			vfIn1[i] = oQueries.vfAzimuth[i];
+			vfIn2[i] = oQueries.vfElevation[i];
+		} else {
+			double dAlpha, dBeta;
+			oTransform.transformOSC2DSC((double)oQueries.vfAzimuth[i], (double)oQueries.vfElevation[i], dAlpha, dBeta);
+			vfIn1[i] = (float)dAlpha;
+			vfIn2[i] = (float)dBeta;
+		}
+	}
+
+	std::vector<double> vdRef1(n), vdRef2(n);
+	std::vector<float> vfOut1(n), vfOut2(n);
+	double dRefSeconds = 1e30, dFastSeconds = 1e30;
+	for (int r = 0; r < NUM_REPEATS; r++) {
+		Clock::time_point t0 = Clock::now();
+		for (size_t i = 0; i < n; i++) {
+			if (bObjectToData)
+				oTransform.transformOSC2DSC((double)vfIn1[i], (double)vfIn2[i], vdRef1[i], vdRef2[i]);
+			else
+				oTransform.transformDSC2OSC((double)vfIn1[i], (double)vfIn2[i], vdRef1[i], vdRef2[i]);
+		}
+		Clock::time_point t1 = Clock::now();
+		if (bObjectToData)
+			oTransform.transformOSC2DSC(&vfIn1[0], &vfIn2[0], &vfOut1[0], &vfOut2[0], n);
+		else
+			oTransform.transformDSC2OSC(&vfIn1[0], &vfIn2[0], &vfOut1[0], &vfOut2[0], n);
+		Clock::time_point t2 = Clock::now();
+
+		dRefSeconds = std::min(dRefSeconds, Seconds(t0, t1));
+		dFastSeconds = std::min(dFastSeconds, Seconds(t1, t2));
+		g_fSink = g_fSink + (float)vdRef1[n - 1] + vfOut1[n - 1];
+	}
+
+	// Object view elevations are latitudes, data view betas polar angles from the south pole
+	double dMaxError = 0;
+	for (size_t i = 0; i < n; i++) {
+		double dError;
+		if (bObjectToData)
+			dError = Distance(vdRef1[i], vdRef2[i], vfOut1[i], vfOut2[i]);
+		else
+			dError = Distance(vdRef1[i], 90 - vdRef2[i], vfOut1[i], 90 - vfOut2[i]);
+		dMaxError = std::max(dMaxError, dError);
+	}
+
+	Result oResult;
+	oResult.sPath = bObjectToData ? "osc2dsc" : "dsc2osc";
+	oResult.sFile = "-";
+	oResult.sOrientation = sOrient;
+	oResult.lQueries = (long)n;
+	oResult.dMaxErrorDeg = dMaxError;
+	oResult.dMaxRelError = -1;
+	oResult.dMismatchesPerMillion = -1;
+	oResult.lHardMismatches = 0;
+	oResult.dSpeedup = dRefSeconds / std::max(dFastSeconds, 1e-9);
+	oResult.bPass = (dMaxError <= TRANSFORM_TOLERANCE);
+	vResults.push_back(oResult);
+}
+
+//! Counts the mismatches of fast record indices and fills in the result (table steps 0: no lookup table)
+static void CountMismatches(const DAFFContent* pContent, const DAFFSCTransform& oTransform, const Queries& oQueries,
+							const std::vector<int>& viRef, const std::vector<int>& viFast, float fStep1Deg,
+							float fStep2Deg, Result& oResult)
+{
+	long lMismatches = 0;
+	oResult.lHardMismatches = 0;
+	for (size_t i = 0; i < viRef.size(); i++) {
+		if (viFast[i] == viRef[i])
+			continue;
+		lMismatches++;
+		if (fStep1Deg > 0) {
+			if (!IsTableNodeRecord(pContent, oTransform, oQueries.vfAzimuth[i], oQueries.vfElevation[i], viFast[i],
+								   fStep1Deg, fStep2Deg))
+				oResult.lHardMismatches++;
+		} else if (!IsWithinTolerance(pContent, oTransform, oQueries.vfAzimuth[i], oQueries.vfElevation[i],
+									  viFast[i], TRANSFORM_TOLERANCE))
+			oResult.lHardMismatches++;
+	}
+	oResult.lQueries = (long)viRef.size();
+	oResult.dMismatchesPerMillion = 1e6 * lMismatches / std::max((double)viRef.size(), 1.0);
+	oResult.bPass = (oResult.lHardMismatches == 0);
+}
+
+//! Nearest neighbour fast paths in the object view against the double precision reference
+static void VerifyNearestNeighbours(DAFFReader* pReader, const std::string& sFile, const DAFFOrientationYPR& oOrient,
+									const std::string& sOrient, const Queries& oQueries, std::vector<Result>& vResults)
+{
+	pReader->getProperties()->setOrientation(oOrient);
+	const DAFFContent* pContent = pReader->getContent();
+	DAFFSCTransform oTransform(oOrient);
+	size_t n = oQueries.vfAzimuth.size();
+	const float* pfAzimuth = &oQueries.vfAzimuth[0];
+	const float* pfElevation = &oQueries.vfElevation[0];
+
+	std::vector<int> viRef(n), viFast(n);
+	double dRefSeconds = 1e30;
+	for (int r = 0; r < NUM_REPEATS; r++) {
+		Clock::time_point t0 = Clock::now();
+		for (size_t i = 0; i < n; i++)
+			viRef[i] = ReferenceRecord(pContent, oTransform, pfAzimuth[i], pfElevation[i]);
+		dRefSeconds = std::min(dRefSeconds, Seconds(t0, Clock::now()));
+	}
+
+	Result oResult;
+	oResult.sFile = sFile;
+	oResult.sOrientation = sOrient;
+	oResult.dMaxErrorDeg = -1;
+	oResult.dMaxRelError = -1;
+
+	// Scalar object view lookups
+	double dFastSeconds = 1e30;
+	for (int r = 0; r < NUM_REPEATS; r++) {
+		Clock::time_point t0 = Clock::now();
+		for (size_t i = 0; i < n; i++)
+			pContent->getNearestNeighbour(DAFF_OBJECT_VIEW, pfAzimuth[i], pfElevation[i], viFast[i]);
+		dFastSeconds = std::min(dFastSeconds, Seconds(t0, Clock::now()));
+	}
+	oResult.sPath = "nn_scalar";
+	oResult.dSpeedup = dRefSeconds / std::max(dFastSeconds, 1e-9);
+	CountMismatches(pContent, oTransform, oQueries, viRef, viFast, 0, 0, oResult);
+	vResults.push_back(oResult);
+
+	// Batch object view lookups
+	dFastSeconds = 1e30;
+	for (int r = 0; r < NUM_REPEATS; r++) {
+		Clock::time_point t0 = Clock::now();
+		pContent->getNearestNeighbours(DAFF_OBJECT_VIEW, pfAzimuth, pfElevation, &viFast[0], NULL, n);
+		dFastSeconds = std::min(dFastSeconds, Seconds(t0, Clock::now()));
+	}
+	oResult.sPath = "nn_batch";
+	oResult.dSpeedup = dRefSeconds / std::max(dFastSeconds, 1e-9);
+	CountMismatches(pContent, oTransform, oQueries, viRef, viFast, 0, 0, oResult);
+	vResults.push_back(oResult);
+
+	// Lookup tables (the table rounds to its nodes)
+	static const float afSteps[] = { 1.0f, 0.25f };
+	for (int s = 0; s < 2; s++) {
+		DAFFDirectionLUT oLUT(pContent, DAFF_OBJECT_VIEW, afSteps[s]);
+		float fStep1, fStep2;
+		oLUT.getResolution(fStep1, fStep2);
+
+		dFastSeconds = 1e30;
+		for (int r = 0; r < NUM_REPEATS; r++) {
+			Clock::time_point t0 = Clock::now();
+			oLUT.lookup(pfAzimuth, pfElevation, &viFast[0], NULL, n);
+			dFastSeconds = std::min(dFastSeconds, Seconds(t0, Clock::now()));
+		}
+		oResult.sPath = (s == 0) ? "lut_1" : "lut_0.25";
+		oResult.dSpeedup = dRefSeconds / std::max(dFastSeconds, 1e-9);
+		CountMismatches(pContent, oTransform, oQueries, viRef, viFast, fStep1, fStep2, oResult);
+		vResults.push_back(oResult);
+	}
+}
+
+//! Polar form of the DFT coefficients against the double precision magnitudes and phases
+static void VerifyPolarForm(DAFFReader* pReader, const std::string& sFile, std::vector<Result>& vResults)
+{
+	const DAFFContentDFT* pDFT = dynamic_cast<const DAFFContentDFT*>(pReader->getContent());
+	if (pDFT == NULL)
+		return;
+
+	int iNumRecords = pReader->getProperties()->getNumberOfRecords();
+	int iNumChannels = pReader->getProperties()->getNumberOfChannels();
+	int iNumValues = 2 * pDFT->getNumDFTCoeffs();
+	std::vector<float> vfCartesian(iNumValues), vfPolar(iNumValues);
+	std::vector<double> vdRef(iNumValues);
+
+	double dRefSeconds = 0, dFastSeconds = 0;
+	double dMaxRelError = 0, dMaxPhaseError = 0;
+	for (int iRecord = 0; iRecord < iNumRecords; iRecord++) {
+		for (int c = 0; c < iNumChannels; c++) {
+			// Both include the fetch of the coefficients
+			Clock::time_point t0 = Clock::now();
+			pDFT->getDFTCoeffs(iRecord, c, &vfCartesian[0]);
+			for (int i = 0; i < iNumValues; i += 2) {
+				vdRef[i] = hypot((double)vfCartesian[i], (double)vfCartesian[i + 1]);
+				vdRef[i + 1] = atan2((double)vfCartesian[i + 1], (double)vfCartesian[i]);
+			}
+			Clock::time_point t1 = Clock::now();
+			pDFT->getCoefficientsMP(iRecord, c, &vfPolar[0]);
+			Clock::time_point t2 = Clock::now();
+
+			dRefSeconds += Seconds(t0, t1);
+			dFastSeconds += Seconds(t1, t2);
+
+			for (int i = 0; i < iNumValues; i += 2) {
+				double dMag = vdRef[i];
+				if (dMag == 0)
+					continue;
+				dMaxRelError = std::max(dMaxRelError, fabs(vfPolar[i] - dMag) / dMag);
+
+				// Phase difference wrapped to [-180, 180) degrees (the phase conventions differ by full turns)
+				double dDiff = fmod((vfPolar[i + 1] - vdRef[i + 1]) * 180 / PI_D + 540.0, 360.0) - 180;
+				dMaxPhaseError = std::max(dMaxPhaseError, fabs(dDiff));
+			}
+		}
+	}
+
+	Result oResult;
+	oResult.sPath = "mps";
+	oResult.sFile = sFile;
+	oResult.sOrientation = "-";
+	oResult.lQueries = (long)iNumRecords * iNumChannels * (iNumValues / 2);
+	oResult.dMaxErrorDeg = dMaxPhaseError;
+	oResult.dMaxRelError = dMaxRelError;
+	oResult.dMismatchesPerMillion = -1;
+	oResult.lHardMismatches = 0;
+	oResult.dSpeedup = dRefSeconds / std::max(dFastSeconds, 1e-9);
+	oResult.bPass = (dMaxRelError <= MAGNITUDE_TOLERANCE) && (dMaxPhaseError <= PHASE_TOLERANCE);
+	vResults.push_back(oResult);
+}
+
+static std::string OrientationName(const DAFFOrientationYPR& oOrient)
+{
+	char buf[64];
+	snprintf(buf, sizeof(buf), "%g/%g/%g", oOrient.fYawAngleDeg, oOrient.fPitchAngleDeg, oOrient.fRollAngleDeg);
+	return buf;
+}
+
+static std::string BaseName(const std::string& sFilePath)
+{
+	size_t iPos = sFilePath.find_last_of("/\\");
+	return (iPos == std::string::npos) ? sFilePath : sFilePath.substr(iPos + 1);
+}
+
+static std::string Value(double dValue, const char* pszFormat)
+{
+	if (dValue < 0)
+		return "-";
+	char buf[64];
+	snprintf(buf, sizeof(buf), pszFormat, dValue);
+	return buf;
+}
+
+static void PrintText(const std::vector<Result>& vResults)
+{
+	printf("%-10s %-44s %-12s %9s %12s %12s %10s %6s %8s %5s\n", "path", "file", "orientation", "queries",
+		   "max err deg", "max rel err", "mism/1M", "hard", "speedup", "pass");
+	for (size_t i = 0; i < vResults.size(); i++) {
+		const Result& r = vResults[i];
+		printf("%-10s %-44s %-12s %9ld %12s %12s %10s %6ld %8.2f %5s\n", r.sPath.c_str(), r.sFile.c_str(),
+			   r.sOrientation.c_str(), r.lQueries, Value(r.dMaxErrorDeg, "%.3e").c_str(),
+			   Value(r.dMaxRelError, "%.3e").c_str(), Value(r.dMismatchesPerMillion, "%.1f").c_str(),
+			   r.lHardMismatches, r.dSpeedup, r.bPass ? "yes" : "NO");
+	}
+}
+
+static void PrintCSV(const std::vector<Result>& vResults)
+{
+	printf("path,file,orientation,queries,max_error_deg,max_rel_error,mismatches_per_million,hard_mismatches,"
+		   "speedup,pass\n");
+	for (size_t i = 0; i < vResults.size(); i++) {
+		const Result& r = vResults[i];
+		printf("%s,%s,%s,%ld,%.6e,%.6e,%.3f,%ld,%.3f,%d\n", r.sPath.c_str(), r.sFile.c_str(), r.sOrientation.c_str(),
+			   r.lQueries, r.dMaxErrorDeg, r.dMaxRelError, r.dMismatchesPerMillion, r.lHardMismatches, r.dSpeedup,
+			   r.bPass ? 1 : 0);
+	}
+}
+
+static void PrintJSON(const std::vector<Result>& vResults)
+{
+	DAFFVersion oVersion;
+	DAFFUtils::getLibraryVersion(oVersion);
+
+	printf("{\n  \"library_version\": \"%s\",\n  \"results\": [\n", oVersion.sVersion.c_str());
+	for (size_t i = 0; i < vResults.size(); i++) {
+		const Result& r = vResults[i];
+		printf("    { \"path\": \"%s\", \"file\": \"%s\", \"orientation\": \"%s\", \"queries\": %ld, "
+			   "\"max_error_deg\": %.6e, \"max_rel_error\": %.6e, \"mismatches_per_million\": %.3f, "
+			   "\"hard_mismatches\": %ld, \"speedup\": %.3f, \"pass\": %s }%s\n",
+			   r.sPath.c_str(), r.sFile.c_str(), r.sOrientation.c_str(), r.lQueries, r.dMaxErrorDeg, r.dMaxRelError,
+			   r.dMismatchesPerMillion, r.lHardMismatches, r.dSpeedup, r.bPass ? "true" : "false",
+			   (i + 1 < vResults.size()) ? "," : "");
+	}
+	printf("  ]\n}\n");
+}
+
+static void PrintUsage()
+{
+	fprintf(stderr,
+			"Usage: FastPathVerification [-f text|csv|json] [-n queries] [-d directory] [-k] [-q] [files...]\n");
+}
+
+int main(int argc, char* argv[])
+{
+	std::string sFormat = "text";
+	std::string sDirectory;
+	bool bKeepFiles = false;
+	bool bQuick = false;
+	int iNumQueries = 1 << 16;
+	std::vector<std::string> vsFiles;
+
+	for (int i = 1; i < argc; i++) {
+		if ((strcmp(argv[i], "-f") == 0) && (i + 1 < argc))
+			sFormat = argv[++i];
+		else if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+			iNumQueries = std::max(atoi(argv[++i]), 1);
+		else if ((strcmp(argv[i], "-d") == 0) && (i + 1 < argc))
+			sDirectory = argv[++i];
+		else if (strcmp(argv[i], "-k") == 0)
+			bKeepFiles = true;
+		else if (strcmp(argv[i], "-q") == 0)
+			bQuick = true;
+		else if (argv[i][0] == '-') {
+			PrintUsage();
+			return 255;
+		} else
+			vsFiles.push_back(argv[i]);
+	}
+
+	if ((sFormat != "text") && (sFormat != "csv") && (sFormat != "json")) {
+		PrintUsage();
+		return 255;
+	}
+
+	// Grids of the verification files (short spectra, the lookups do not depend on the data),
+	// the last file is an HRTF-like spectrum for the polar form
+	static const Config aConfigs[] = {
+		{ DAFF_DFT_SPECTRUM, DAFF_FLOAT32, 30, 1, 8, false }, { DAFF_DFT_SPECTRUM, DAFF_FLOAT32, 15, 1, 8, false },
+		{ DAFF_DFT_SPECTRUM, DAFF_FLOAT32, 10, 1, 8, false }, { DAFF_DFT_SPECTRUM, DAFF_FLOAT32, 5, 2, 512, false },
+		{ DAFF_DFT_SPECTRUM, DAFF_FLOAT32, 2, 1, 8, false },  { DAFF_DFT_SPECTRUM, DAFF_FLOAT32, 1, 1, 8, false },
+	};
+
+	// Orientations of the verification files (yaw-pitch-roll), plus oblique ones
+	static const DAFFOrientationYPR aOrientations[] = {
+		DAFFOrientationYPR(0, 0, 0),     DAFFOrientationYPR(90, 0, 0),    DAFFOrientationYPR(-90, 0, 0),
+		DAFFOrientationYPR(180, 0, 0),   DAFFOrientationYPR(0, 90, 0),    DAFFOrientationYPR(0, -90, 0),
+		DAFFOrientationYPR(0, 0, 90),    DAFFOrientationYPR(0, 0, 180),   DAFFOrientationYPR(30, 15, -10),
+		DAFFOrientationYPR(45, 45, 45),  DAFFOrientationYPR(-120, 60, 30), DAFFOrientationYPR(0.5f, 89.5f, -0.5f),
+	};
+
+	// Quick: 10 and 5 degree grids, the first orientations
+	int iFirstConfig = bQuick ? 2 : 0;
+	int iEndConfig = bQuick ? 4 : (int)(sizeof(aConfigs) / sizeof(aConfigs[0]));
+	int iNumOrientations = bQuick ? 4 : (int)(sizeof(aOrientations) / sizeof(aOrientations[0]));
+
+	std::vector<std::string> vsGenerated;
+	if (vsFiles.empty()) {
+		for (int i = iFirstConfig; i < iEndConfig; i++) {
+			std::string sFilePath = FileName(sDirectory, aConfigs[i]);
+			int iError = WriteFile(sFilePath, aConfigs[i]);
+			if (iError != DAFF_NO_ERROR) {
+				fprintf(stderr, "Error: Writing '%s' failed: %s\n", sFilePath.c_str(),
+						DAFFUtils::StrError(iError).c_str());
+				return 255;
+			}
+			vsGenerated.push_back(sFilePath);
+		}
+		vsFiles = vsGenerated;
+	}
+
+	Queries oQueries(iNumQueries);
+	std::vector<Result> vResults;
+
+	for (int o = 0; o < iNumOrientations; o++) {
+		std::string sOrient = OrientationName(aOrientations[o]);
+		VerifyTransform(aOrientations[o], sOrient, oQueries, true, vResults);
+		VerifyTransform(aOrientations[o], sOrient, oQueries, false, vResults);
+	}
+
+	int iError = DAFF_NO_ERROR;
+	for (size_t f = 0; (f < vsFiles.size()) && (iError == DAFF_NO_ERROR); f++) {
+		DAFFReader* pReader = DAFFReader::create();
+		iError = pReader->openFile(vsFiles[f]);
+		if (iError != DAFF_NO_ERROR) {
+			fprintf(stderr, "Error: Reading '%s' failed: %s\n", vsFiles[f].c_str(),
+					DAFFUtils::StrError(iError).c_str());
+			delete pReader;
+			break;
+		}
+
+		std::string sFile = BaseName(vsFiles[f]);
+		for (int o = 0; o < iNumOrientations; o++)
+			VerifyNearestNeighbours(pReader, sFile, aOrientations[o], OrientationName(aOrientations[o]), oQueries,
+									vResults);
+		VerifyPolarForm(pReader, sFile, vResults);
+
+		pReader->closeFile();
+		delete pReader;
+	}
+
+	if (!bKeepFiles)
+		for (size_t i = 0; i < vsGenerated.size(); i++)
+			remove(vsGenerated[i].c_str());
+
+	if (iError != DAFF_NO_ERROR)
+		return 255;
+
+	if (sFormat == "csv")
+		PrintCSV(vResults);
+	else if (sFormat == "json")
+		PrintJSON(vResults);
+	else
+		PrintText(vResults);
+
+	for (size_t i = 0; i < vResults.size(); i++)
+		if (!vResults[i].bPass)
+			return 1;
+
+	return 0;
+}